@@ -0,0 +1,554 @@
+/**
+ * Benchmark of the containers of src/classes against their standard library counterparts,
+ * over a matrix of sizes and key distributions. Every container runs the workloads that fit
+ * it: insert every key, look every key up, iterate over the whole container and erase every
+ * key. Every row reports the median time of a few repetitions, the millions of operations
+ * per second, the heap bytes per element the container holds after the inserts and the
+ * heap allocations per operation, and with --counters on the hardware events per operation
+ * where the system offers them. The containers memory_usage() measures also report their
+ * footprint per element, split into payload, node overhead, control and slack, and print it
+ * to stderr. The results go to stdout or a file as JSON or CSV.
+ *
+ * usage: algoplus_bench [--sizes 1000,100000] [--dists random,sequential,zipf]
+ *        [--containers a,b] [--reps N] [--counters on|off] [--format json|csv] [--out path]
+ */
+
+#ifdef __cplusplus
+#include "../src/classes/disjoint_set/disjoint_set.h"
+#include "../src/classes/hash_table/flat_hash_table.h"
+#include "../src/classes/hash_table/hash_table.h"
+#include "../src/classes/heap/d_ary_heap.h"
+#include "../src/classes/heap/min_heap.h"
+#include "../src/classes/heap/pairing_heap.h"
+#include "../src/classes/list/skip_list.h"
+#include "../src/classes/tree/avl_tree.h"
+#include "../src/classes/tree/fenwick_tree.h"
+#include "../src/classes/tree/red_black_tree.h"
+#include "../src/classes/tree/rope.h"
+#include "../src/classes/tree/segment_tree.h"
+#include "../src/classes/tree/segment_tree_iterative.h"
+#include "../src/classes/tree/splay_tree.h"
+#include "../src/classes/tree/trie.h"
+#include "../src/helpers/alloc_tracker.h"
+#include "../src/helpers/memory_usage.h"
+#include "../src/helpers/perf_counters.h"
+#include "../src/helpers/timer.h"
+#include "../third_party/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <queue>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#endif
+
+// every heap allocation of the program reports to the trackers of its thread
+ALGOPLUS_DEFINE_ALLOCATION_HOOKS();
+
+namespace {
+struct result {
+    std::string container, family, workload, distribution;
+    size_t n;
+    double time_ms, mops_per_s, bytes_per_elem, allocs_per_op;
+    std::map<std::string, double> counters;
+    // the footprint per element after the inserts, for the measurable containers
+    std::optional<std::map<std::string, double>> footprint;
+};
+
+struct options {
+    std::vector<size_t> sizes = {1000, 100000, 1000000};
+    std::vector<std::string> dists = {"random", "sequential", "zipf"};
+    std::vector<std::string> names;
+    size_t reps = 5;
+    bool counters = false;
+    std::string format = "json", out;
+};
+
+/**
+ * @brief the n keys of the distribution dist: uniform 64 bit keys, 0..n - 1 in order, or
+ * ranks with probability proportional to 1 / rank(so with repeats) spread over 64 bits
+ */
+std::vector<uint64_t> generate(const std::string& dist, size_t n) {
+    std::mt19937_64 rng(n);
+    std::vector<uint64_t> v(n);
+    if (dist == "random") {
+        for (auto& x : v) {
+            x = rng();
+        }
+    } else if (dist == "sequential") {
+        for (size_t i = 0; i < n; i++) {
+            v[i] = i;
+        }
+    } else if (dist == "zipf") {
+        size_t m = std::max<size_t>(1, std::min<size_t>(n, 1 << 20));
+        std::vector<double> cdf(m);
+        double sum = 0;
+        for (size_t r = 0; r < m; r++) {
+            sum += 1.0 / double(r + 1);
+            cdf[r] = sum;
+        }
+        std::uniform_real_distribution<double> u(0, sum);
+        for (auto& x : v) {
+            x = uint64_t(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin()) *
+                0x9E3779B97F4A7C15ull;
+        }
+    } else {
+        throw std::invalid_argument("unknown distribution " + dist);
+    }
+    return v;
+}
+
+/**
+ * @brief the lowercase word of a key, for the trie and the string sets
+ */
+std::string word(uint64_t key) {
+    std::string s;
+    do {
+        s += char('a' + key % 26);
+        key /= 26;
+    } while (key != 0);
+    return s;
+}
+
+/**
+ * @brief the workloads of a container: make builds an empty one for n keys, and insert,
+ * lookup, iterate and erase run one operation, nullptr for the workloads it does not have.
+ * lookup and iterate return a value that goes through do_not_optimize.
+ */
+template <typename Make, typename Insert, typename Lookup, typename Iterate, typename Erase>
+struct suite {
+    std::string name, family;
+    Make make;
+    Insert insert;
+    Lookup lookup;
+    Iterate iterate;
+    Erase erase;
+};
+
+template <typename Make, typename Insert, typename Lookup, typename Iterate, typename Erase>
+auto make_suite(std::string name, std::string family, Make make, Insert insert, Lookup lookup,
+                Iterate iterate, Erase erase) {
+    return suite<Make, Insert, Lookup, Iterate, Erase>{
+        std::move(name), std::move(family), make, insert, lookup, iterate, erase};
+}
+
+double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+template <typename S, typename K>
+void bench(const S& s, const std::string& dist, const std::vector<K>& keys,
+           const std::vector<K>& probes, const options& opt, std::vector<result>& results) {
+    if (!opt.names.empty() &&
+        std::find(opt.names.begin(), opt.names.end(), s.name) == opt.names.end()) {
+        return;
+    }
+    constexpr bool has_lookup = !std::is_null_pointer_v<decltype(s.lookup)>;
+    constexpr bool has_iterate = !std::is_null_pointer_v<decltype(s.iterate)>;
+    constexpr bool has_erase = !std::is_null_pointer_v<decltype(s.erase)>;
+    const size_t n = keys.size();
+    const size_t reps = std::max<size_t>(1, std::min(opt.reps, (size_t(1) << 24) / n));
+    // the times of every repetition of a workload, the allocations and the hardware counts
+    // of the last one
+    struct measured {
+        std::vector<double> ms;
+        ALLOC::alloc_stats allocs;
+        PERF::sample counts;
+    };
+    measured insert, lookup, iterate, erase;
+    std::optional<PERF::counters> pmu;
+    if (opt.counters) {
+        pmu.emplace();
+    }
+    double bytes = 0;
+    std::optional<std::map<std::string, double>> footprint;
+    auto timed = [&](measured& m, auto&& work) {
+        double ms;
+        {
+            ALLOC::tracker t;
+            if (pmu) {
+                pmu->start();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            work();
+            ms = since(start);
+            if (pmu) {
+                pmu->stop();
+                m.counts = pmu->read();
+            }
+            t.add_operations(n);
+            m.allocs = t.stats();
+        }
+        m.ms.push_back(ms);
+    };
+    for (size_t r = 0; r < reps; r++) {
+        ALLOC::tracker held;
+        auto c = s.make(n);
+        timed(insert, [&]() {
+            for (const K& k : keys) {
+                s.insert(c, k);
+            }
+        });
+        size_t elements = n;
+        if constexpr (requires { c.size(); }) {
+            elements = std::max<size_t>(1, c.size());
+        }
+        bytes = double(held.stats().live_bytes()) / double(elements);
+        if constexpr (MEMORY::measurable<decltype(c)>) {
+            if (r + 1 == reps) {
+                const MEMORY::footprint f = MEMORY::memory_usage(c);
+                const double d = double(elements);
+                footprint = {{"bytes_per_elem", f.per_element(elements)},
+                             {"payload", double(f.payload) / d},
+                             {"node_overhead", double(f.node_overhead) / d},
+                             {"control", double(f.control) / d},
+                             {"slack", double(f.slack) / d}};
+                MEMORY::print(std::cerr, s.name + ' ' + dist + ' ' + std::to_string(n), f,
+                              elements);
+            }
+        }
+        if constexpr (has_lookup) {
+            timed(lookup, [&]() {
+                for (const K& k : probes) {
+                    TIMER::do_not_optimize(s.lookup(c, k));
+                }
+            });
+        }
+        if constexpr (has_iterate) {
+            timed(iterate, [&]() { TIMER::do_not_optimize(s.iterate(c)); });
+        }
+        if constexpr (has_erase) {
+            timed(erase, [&]() {
+                for (const K& k : probes) {
+                    s.erase(c, k);
+                }
+            });
+        }
+    }
+    auto row = [&](const std::string& workload, const measured& m) {
+        const double ms = median(m.ms);
+        result r{s.name, s.family, workload, dist, n, ms, ms > 0 ? double(n) / ms / 1e3 : 0.0,
+                 bytes, m.allocs.allocations_per_op(), {}, footprint};
+        for (size_t e = 0; e < PERF::EVENTS; e++) {
+            if (m.counts.valid[e]) {
+                r.counters[PERF::event_name(PERF::event(e))] = m.counts.values[e] / double(n);
+            }
+        }
+        if (m.counts.ipc() > 0) {
+            r.counters["ipc"] = m.counts.ipc();
+        }
+        results.push_back(std::move(r));
+        std::cerr << s.name << ' ' << workload << ' ' << dist << ' ' << n << ": " << ms
+                  << " ms\n";
+    };
+    row("insert", insert);
+    if constexpr (has_lookup) {
+        row("lookup", lookup);
+    }
+    if constexpr (has_iterate) {
+        row("iterate", iterate);
+    }
+    if constexpr (has_erase) {
+        row("erase", erase);
+    }
+}
+
+template <typename C> uint64_t sum_keys(C& c) {
+    uint64_t sum = 0;
+    for (const auto& x : c) {
+        if constexpr (requires { x.first; }) {
+            sum += x.first;
+        } else {
+            sum += x;
+        }
+    }
+    return sum;
+}
+
+void run(const std::string& dist, size_t n, const options& opt, std::vector<result>& results) {
+    const std::vector<uint64_t> keys = generate(dist, n);
+    std::vector<uint64_t> probes = keys;
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(n + 1));
+    using u64 = uint64_t;
+
+    // the maps of keys to values, and the ordered sets of keys
+    bench(make_suite(
+              "hash_table", "map", [](size_t) { return hash_table<u64, u64>(); },
+              [](auto& c, u64 k) { c.insert(k, k); }, [](auto& c, u64 k) { return c.contains(k); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.remove(k); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "flat_hash_table", "map", [](size_t) { return flat_hash_table<u64, u64>(); },
+              [](auto& c, u64 k) { c.insert(k, k); }, [](auto& c, u64 k) { return c.contains(k); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.remove(k); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "std::unordered_map", "map", [](size_t) { return std::unordered_map<u64, u64>(); },
+              [](auto& c, u64 k) { c.emplace(k, k); },
+              [](auto& c, u64 k) { return c.find(k) != c.end(); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.erase(k); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "avl_tree", "ordered_set", [](size_t) { return avl_tree<u64>(); },
+              [](auto& c, u64 k) { c.insert(k); }, [](auto& c, u64 k) { return c.search(k); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.remove(k); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "red_black_tree", "ordered_set", [](size_t) { return red_black_tree<u64>(); },
+              [](auto& c, u64 k) { c.insert(k); }, [](auto& c, u64 k) { return c.search(k); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.remove(k); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "splay_tree", "ordered_set", [](size_t) { return splay_tree<u64>(); },
+              [](auto& c, u64 k) { c.insert(k); }, [](auto& c, u64 k) { return c.search(k); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.remove(k); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "skip_list", "ordered_set", [](size_t) { return skip_list<u64>(16, 0.5); },
+              [](auto& c, u64 k) { c.insert(k); }, [](auto& c, u64 k) { return c.search(k); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.remove(k); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "std::set", "ordered_set", [](size_t) { return std::set<u64>(); },
+              [](auto& c, u64 k) { c.insert(k); },
+              [](auto& c, u64 k) { return c.find(k) != c.end(); },
+              [](auto& c) { return sum_keys(c); }, [](auto& c, u64 k) { c.erase(k); }),
+          dist, keys, probes, opt, results);
+
+    // the priority queues, erase pops the minimum once per key
+    bench(make_suite(
+              "min_heap", "heap", [](size_t m) { return min_heap<u64>(m); },
+              [](auto& c, u64 k) { c.insert(k); }, nullptr, nullptr,
+              [](auto& c, u64) { c._min(); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "d_ary_heap", "heap", [](size_t) { return d_ary_heap<u64>(); },
+              [](auto& c, u64 k) { c.push(k); }, nullptr, nullptr,
+              [](auto& c, u64) { c.pop(); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "pairing_heap", "heap", [](size_t m) { return pairing_heap<u64>(m); },
+              [](auto& c, u64 k) { c.push(uint32_t(c.size()), k); }, nullptr, nullptr,
+              [](auto& c, u64) { c.pop(); }),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "std::priority_queue", "heap",
+              [](size_t) { return std::priority_queue<u64, std::vector<u64>, std::greater<>>(); },
+              [](auto& c, u64 k) { c.push(k); }, nullptr, nullptr,
+              [](auto& c, u64) { c.pop(); }),
+          dist, keys, probes, opt, results);
+
+    // the disjoint sets of 0..n - 1: insert joins the next element with the one of its key,
+    // lookup asks if two elements are in the same set
+    auto dsu_make = [](size_t m) { return std::make_pair(dsu(int64_t(m)), int64_t(0)); };
+    bench(make_suite(
+              "dsu", "disjoint_set", dsu_make,
+              [n](auto& c, u64 k) { c.first.join(c.second++, int64_t(k % n)); },
+              [n](auto& c, u64 k) { return c.first.same(int64_t(k % n), int64_t((k >> 32) % n)); },
+              nullptr, nullptr),
+          dist, keys, probes, opt, results);
+    auto compact_make = [](size_t m) { return std::make_pair(compact_dsu<>(uint32_t(m)), 0u); };
+    bench(make_suite(
+              "compact_dsu", "disjoint_set", compact_make,
+              [n](auto& c, u64 k) { c.first.join(c.second++, uint32_t(k % n)); },
+              [n](auto& c, u64 k) {
+                  return c.first.same(uint32_t(k % n), uint32_t((k >> 32) % n));
+              },
+              nullptr, nullptr),
+          dist, keys, probes, opt, results);
+
+    // the sums over 0..n - 1: insert adds to a point, lookup sums a range
+    auto lo = [n](u64 k) { return int(k % n); };
+    auto hi = [n](u64 k) { return int(std::max(k % n, (k >> 32) % n)); };
+    bench(make_suite(
+              "segment_tree", "range_sum",
+              [](size_t m) { return segment_tree(std::vector<int>(m, 0)); },
+              [lo](auto& c, u64 k) { c.update(lo(k), int(k & 0xff)); },
+              [lo, hi](auto& c, u64 k) { return c.sum(lo(k), hi(k)); }, nullptr, nullptr),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "seg_tree", "range_sum",
+              [](size_t m) { return seg_tree<int64_t>(std::vector<int64_t>(m, 0)); },
+              [lo](auto& c, u64 k) { c.update(lo(k), int64_t(k & 0xff)); },
+              [lo, hi](auto& c, u64 k) { return c.sum(lo(k), hi(k)); }, nullptr, nullptr),
+          dist, keys, probes, opt, results);
+    bench(make_suite(
+              "fenwick_tree", "range_sum",
+              [](size_t m) { return fenwick_tree<int64_t>(std::vector<int64_t>(m, 0)); },
+              [lo](auto& c, u64 k) { c.update(lo(k), int64_t(k & 0xff)); },
+              [lo, hi](auto& c, u64 k) { return c.sum(lo(k), hi(k)); }, nullptr, nullptr),
+          dist, keys, probes, opt, results);
+
+    // the sets of words
+    std::vector<std::string> words(n), probe_words(n);
+    for (size_t i = 0; i < n; i++) {
+        words[i] = word(keys[i]);
+        probe_words[i] = word(probes[i]);
+    }
+    bench(make_suite(
+              "trie", "string_set", [](size_t) { return trie(); },
+              [](auto& c, const std::string& k) { c.insert(k); },
+              [](auto& c, const std::string& k) { return c.search(k); }, nullptr,
+              [](auto& c, const std::string& k) { c.remove(k); }),
+          dist, words, probe_words, opt, results);
+    bench(make_suite(
+              "std::unordered_set<string>", "string_set",
+              [](size_t) { return std::unordered_set<std::string>(); },
+              [](auto& c, const std::string& k) { c.insert(k); },
+              [](auto& c, const std::string& k) { return c.count(k) != 0; }, nullptr,
+              [](auto& c, const std::string& k) { c.erase(k); }),
+          dist, words, probe_words, opt, results);
+
+    // the texts: insert puts 8 characters at the position of the key, lookup reads one
+    // character, iterate visits the whole text and erase takes 8 characters out again
+    auto text_iterate = [](const auto& c) {
+        uint64_t sum = 0;
+        for (std::string_view chunk : c.chunks()) {
+            sum += chunk.size();
+        }
+        return sum;
+    };
+    bench(make_suite(
+              "rope", "text", [](size_t) { return rope(); },
+              [](auto& c, u64 k) { c.insert(k % (c.size() + 1), "abcdefgh"); },
+              [](auto& c, u64 k) { return c.char_at(k % c.size()); }, text_iterate,
+              [](auto& c, u64 k) { c.erase(k % (c.size() - 7), 8); }),
+          dist, keys, probes, opt, results);
+    // every insert into the string moves its tail, so it only runs on the smaller sizes
+    if (n > (1 << 17)) {
+        return;
+    }
+    bench(make_suite(
+              "std::string", "text", [](size_t) { return std::string(); },
+              [](auto& c, u64 k) { c.insert(k % (c.size() + 1), "abcdefgh"); },
+              [](auto& c, u64 k) { return c[k % c.size()]; },
+              [](const auto& c) {
+                  uint64_t sum = 0;
+                  for (char x : c) {
+                      sum += uint8_t(x);
+                  }
+                  return sum;
+              },
+              [](auto& c, u64 k) { c.erase(k % (c.size() - 7), 8); }),
+          dist, keys, probes, opt, results);
+}
+
+std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> parts;
+    std::stringstream in(s);
+    for (std::string part; std::getline(in, part, ',');) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+options parse(int argc, char** argv) {
+    options opt;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i], value = argv[i + 1];
+        if (flag == "--sizes") {
+            opt.sizes.clear();
+            for (const auto& x : split(value)) {
+                opt.sizes.push_back(std::stoull(x));
+            }
+        } else if (flag == "--dists") {
+            opt.dists = split(value);
+        } else if (flag == "--containers") {
+            opt.names = split(value);
+        } else if (flag == "--reps") {
+            opt.reps = std::stoull(value);
+        } else if (flag == "--counters") {
+            opt.counters = value == "on";
+        } else if (flag == "--format") {
+            opt.format = value;
+        } else if (flag == "--out") {
+            opt.out = value;
+        } else {
+            throw std::invalid_argument("unknown flag " + flag);
+        }
+    }
+    return opt;
+}
+
+void write(std::ostream& out, const std::vector<result>& results, const std::string& format) {
+    if (format == "json") {
+        nlohmann::json rows = nlohmann::json::array();
+        for (const result& r : results) {
+            rows.push_back({{"container", r.container},
+                            {"family", r.family},
+                            {"workload", r.workload},
+                            {"distribution", r.distribution},
+                            {"n", r.n},
+                            {"time_ms", r.time_ms},
+                            {"mops_per_s", r.mops_per_s},
+                            {"bytes_per_elem", r.bytes_per_elem},
+                            {"allocs_per_op", r.allocs_per_op}});
+            if (!r.counters.empty()) {
+                rows.back()["counters"] = r.counters;
+            }
+            if (r.footprint) {
+                rows.back()["footprint"] = *r.footprint;
+            }
+        }
+        out << rows.dump(2) << '\n';
+        return;
+    }
+    const std::vector<std::string> parts = {"bytes_per_elem", "payload", "node_overhead",
+                                            "control", "slack"};
+    out << "container,family,workload,distribution,n,time_ms,mops_per_s,bytes_per_elem,"
+           "allocs_per_op";
+    for (const std::string& p : parts) {
+        out << ",footprint_" << p;
+    }
+    out << '\n';
+    for (const result& r : results) {
+        out << r.container << ',' << r.family << ',' << r.workload << ',' << r.distribution
+            << ',' << r.n << ',' << r.time_ms << ',' << r.mops_per_s << ',' << r.bytes_per_elem
+            << ',' << r.allocs_per_op;
+        // the columns stay empty for the containers memory_usage does not measure
+        for (const std::string& p : parts) {
+            out << ',';
+            if (r.footprint) {
+                out << r.footprint->at(p);
+            }
+        }
+        out << '\n';
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    options opt = parse(argc, argv);
+    std::vector<result> results;
+    for (const std::string& dist : opt.dists) {
+        for (size_t n : opt.sizes) {
+            if (n != 0) {
+                run(dist, n, opt, results);
+            }
+        }
+    }
+    if (opt.out.empty()) {
+        write(std::cout, results, opt.format);
+    } else {
+        std::ofstream file(opt.out);
+        write(file, results, opt.format);
+    }
+    return 0;
+}
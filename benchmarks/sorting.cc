@@ -0,0 +1,380 @@
+/**
+ * Benchmark of every sorter of src/algorithms/sorting over a matrix of sizes, element types
+ * and input distributions. Every run reports the median time of a few repetitions, the
+ * throughput, the comparisons and moves(counted on a wrapped element type, for the
+ * comparison sorts), the peak heap memory allocated by the sort, and whether the output
+ * is the sorted input. The results go to stdout or a file as CSV or JSON.
+ *
+ * usage: sorting_benchmark [--sizes 1000,100000] [--types int32,int64,double]
+ *        [--dists random,sorted,reversed,few_unique,organ_pipe,zipf] [--sorters a,b]
+ *        [--threads N] [--reps N] [--format csv|json] [--out path]
+ */
+
+#ifdef __cplusplus
+#include "../src/algorithms/sorting/bubble_sort.h"
+#include "../src/algorithms/sorting/bucket_sort.h"
+#include "../src/algorithms/sorting/counting_sort.h"
+#include "../src/algorithms/sorting/heap_sort.h"
+#include "../src/algorithms/sorting/insertion_sort.h"
+#include "../src/algorithms/sorting/merge_sort.h"
+#include "../src/algorithms/sorting/quick_sort.h"
+#include "../src/algorithms/sorting/radix_sort.h"
+#include "../src/algorithms/sorting/selection_sort.h"
+#include "../third_party/json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#endif
+
+// heap accounting: every allocation carries its size in a header, so the live and the
+// peak bytes are known at any time
+namespace {
+std::atomic<size_t> live_bytes{0}, peak_bytes{0};
+constexpr size_t header = alignof(std::max_align_t);
+
+void* tracked_alloc(size_t n) {
+    void* p = std::malloc(n + header);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(p) = n;
+    size_t now = live_bytes.fetch_add(n, std::memory_order_relaxed) + n;
+    for (size_t peak = peak_bytes.load(std::memory_order_relaxed);
+         now > peak && !peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed);) {
+    }
+    return static_cast<char*>(p) + header;
+}
+
+void tracked_free(void* p) {
+    if (!p) {
+        return;
+    }
+    void* base = static_cast<char*>(p) - header;
+    live_bytes.fetch_sub(*static_cast<size_t*>(base), std::memory_order_relaxed);
+    std::free(base);
+}
+} // namespace
+
+void* operator new(size_t n) { return tracked_alloc(n); }
+void* operator new[](size_t n) { return tracked_alloc(n); }
+void operator delete(void* p) noexcept { tracked_free(p); }
+void operator delete[](void* p) noexcept { tracked_free(p); }
+void operator delete(void* p, size_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, size_t) noexcept { tracked_free(p); }
+
+namespace {
+std::atomic<uint64_t> comparisons{0}, moves{0};
+
+/**
+ * @brief a value that counts its comparisons and its copies and moves
+ */
+template <typename T> struct counted {
+    T v{};
+
+    counted() = default;
+    explicit counted(T x) : v(x) {}
+    counted(const counted& o) : v(o.v) { moves.fetch_add(1, std::memory_order_relaxed); }
+    counted(counted&& o) noexcept : v(o.v) { moves.fetch_add(1, std::memory_order_relaxed); }
+    counted& operator=(const counted& o) {
+        v = o.v;
+        moves.fetch_add(1, std::memory_order_relaxed);
+        return *this;
+    }
+    counted& operator=(counted&& o) noexcept {
+        v = o.v;
+        moves.fetch_add(1, std::memory_order_relaxed);
+        return *this;
+    }
+
+    friend bool operator<(const counted& a, const counted& b) {
+        comparisons.fetch_add(1, std::memory_order_relaxed);
+        return a.v < b.v;
+    }
+    friend bool operator>(const counted& a, const counted& b) { return b < a; }
+    friend bool operator<=(const counted& a, const counted& b) { return !(b < a); }
+    friend bool operator>=(const counted& a, const counted& b) { return !(a < b); }
+    friend bool operator==(const counted& a, const counted& b) { return a.v == b.v; }
+};
+
+/**
+ * @brief a sorter: run sorts a vector of T, and count the same vector of counted<T> if the
+ * sorter only compares, max_n is the largest input it is run on
+ */
+template <typename T> struct sorter {
+    std::string name;
+    size_t max_n;
+    std::function<void(std::vector<T>&)> run;
+    std::function<void(std::vector<counted<T>>&)> count;
+};
+
+template <typename T, bool Comparison, typename F>
+sorter<T> make_sorter(std::string name, size_t max_n, F f) {
+    sorter<T> s{std::move(name), max_n, f, nullptr};
+    if constexpr (Comparison) {
+        s.count = f;
+    }
+    return s;
+}
+
+template <typename T> std::vector<sorter<T>> sorters(size_t threads) {
+    constexpr size_t quadratic = 1 << 13, any = SIZE_MAX;
+    std::vector<sorter<T>> s = {
+        make_sorter<T, true>("bubble_sort", quadratic, [](auto& v) { bubble_sort(v); }),
+        make_sorter<T, true>("selection_sort", quadratic, [](auto& v) { selection_sort(v); }),
+        make_sorter<T, true>("insertion_sort", quadratic, [](auto& v) { insertion_sort(v); }),
+        make_sorter<T, true>("heap_sort", any,
+                             [](auto& v) { heap_sort(v.begin(), v.end()); }),
+        make_sorter<T, true>("merge_sort", any,
+                             [](auto& v) { merge_sort(v.begin(), v.end()); }),
+        make_sorter<T, true>("parallel_merge_sort", any, [threads](auto& v) {
+            merge_sort(v.begin(), v.end(), std::less<>(), threads);
+        }),
+        make_sorter<T, true>("quick_sort", any,
+                             [](auto& v) { quick_sort(v.begin(), v.end()); }),
+        make_sorter<T, true>("parallel_quick_sort", any, [threads](auto& v) {
+            quick_sort(v.begin(), v.end(), std::less<>(), threads);
+        }),
+        make_sorter<T, true>("bucket_sort", any, [](auto& v) { bucket_sort(v); }),
+        make_sorter<T, true>("parallel_bucket_sort", any,
+                             [threads](auto& v) { bucket_sort(v, threads); }),
+        make_sorter<T, false>("radix_sort", any,
+                              [](auto& v) { radix_sort(v.begin(), v.end()); }),
+        make_sorter<T, false>("parallel_radix_sort", any, [threads](auto& v) {
+            radix_sort(v.begin(), v.end(), std::identity(), threads);
+        }),
+        make_sorter<T, true>("std::sort", any,
+                             [](auto& v) { std::sort(v.begin(), v.end()); }),
+        make_sorter<T, true>("std::stable_sort", any,
+                             [](auto& v) { std::stable_sort(v.begin(), v.end()); }),
+    };
+    if constexpr (std::is_integral_v<T>) {
+        s.push_back(make_sorter<T, false>("counting_sort", any, [](auto& v) { counting_sort(v); }));
+    }
+    return s;
+}
+
+/**
+ * @brief the input of size n of the distribution dist
+ */
+template <typename T> std::vector<T> generate(const std::string& dist, size_t n) {
+    std::mt19937_64 rng(n);
+    std::vector<T> v(n);
+    if (dist == "random") {
+        for (auto& x : v) {
+            if constexpr (std::is_integral_v<T>) {
+                x = T(rng());
+            } else {
+                x = T(std::uniform_real_distribution<double>(-1e9, 1e9)(rng));
+            }
+        }
+    } else if (dist == "sorted" || dist == "reversed") {
+        for (size_t i = 0; i < n; i++) {
+            v[i] = T(dist == "sorted" ? i : n - i);
+        }
+    } else if (dist == "few_unique") {
+        for (auto& x : v) {
+            x = T(rng() % 16);
+        }
+    } else if (dist == "organ_pipe") {
+        for (size_t i = 0; i < n; i++) {
+            v[i] = T(i < n / 2 ? i : n - i);
+        }
+    } else if (dist == "zipf") {
+        // ranks 1..m with probability proportional to 1 / rank
+        size_t m = std::max<size_t>(1, std::min<size_t>(n, 1 << 20));
+        std::vector<double> cdf(m);
+        double sum = 0;
+        for (size_t r = 0; r < m; r++) {
+            sum += 1.0 / double(r + 1);
+            cdf[r] = sum;
+        }
+        std::uniform_real_distribution<double> u(0, sum);
+        for (auto& x : v) {
+            x = T(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin());
+        }
+    } else {
+        throw std::invalid_argument("unknown distribution " + dist);
+    }
+    return v;
+}
+
+struct result {
+    std::string sorter, type, distribution;
+    size_t n, threads;
+    double time_ms, melems_per_s;
+    int64_t comparisons, moves;
+    size_t peak_bytes;
+    bool sorted;
+};
+
+struct options {
+    std::vector<size_t> sizes = {1000, 100000, 1000000};
+    std::vector<std::string> types = {"int32", "int64", "double"};
+    std::vector<std::string> dists = {"random",     "sorted",     "reversed",
+                                      "few_unique", "organ_pipe", "zipf"};
+    std::vector<std::string> names;
+    size_t threads = 0;
+    size_t reps = 5;
+    std::string format = "csv", out;
+};
+
+template <typename T>
+void bench(const std::string& type, const options& opt, std::vector<result>& results) {
+    size_t threads = PARALLEL::resolve_threads(opt.threads, SIZE_MAX);
+    for (const sorter<T>& s : sorters<T>(threads)) {
+        if (!opt.names.empty() &&
+            std::find(opt.names.begin(), opt.names.end(), s.name) == opt.names.end()) {
+            continue;
+        }
+        for (const std::string& dist : opt.dists) {
+            for (size_t n : opt.sizes) {
+                if (n > s.max_n) {
+                    continue;
+                }
+                std::vector<T> input = generate<T>(dist, n), want = input;
+                std::sort(want.begin(), want.end());
+                size_t reps = std::max<size_t>(1, std::min(opt.reps, (size_t(1) << 24) / n));
+                std::vector<double> times;
+                size_t peak = 0;
+                bool sorted = true;
+                for (size_t r = 0; r < reps; r++) {
+                    std::vector<T> v = input;
+                    size_t base = live_bytes.load();
+                    peak_bytes.store(base);
+                    auto start = std::chrono::steady_clock::now();
+                    s.run(v);
+                    auto end = std::chrono::steady_clock::now();
+                    peak = std::max(peak, peak_bytes.load() - base);
+                    times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+                    sorted = sorted && v == want;
+                }
+                std::sort(times.begin(), times.end());
+                double ms = times[times.size() / 2];
+                int64_t cmp = -1, mv = -1;
+                if (s.count) {
+                    std::vector<counted<T>> c;
+                    c.reserve(n);
+                    for (const T& x : input) {
+                        c.emplace_back(x);
+                    }
+                    comparisons = 0;
+                    moves = 0;
+                    s.count(c);
+                    cmp = int64_t(comparisons.load());
+                    mv = int64_t(moves.load());
+                }
+                results.push_back({s.name, type, dist, n, threads, ms,
+                                   ms > 0 ? double(n) / ms / 1e3 : 0.0, cmp, mv, peak, sorted});
+                std::cerr << s.name << ' ' << type << ' ' << dist << ' ' << n << ": " << ms
+                          << " ms" << (sorted ? "" : " NOT SORTED") << '\n';
+            }
+        }
+    }
+}
+
+std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> parts;
+    std::stringstream in(s);
+    for (std::string part; std::getline(in, part, ',');) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+options parse(int argc, char** argv) {
+    options opt;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i], value = argv[i + 1];
+        if (flag == "--sizes") {
+            opt.sizes.clear();
+            for (const auto& x : split(value)) {
+                opt.sizes.push_back(std::stoull(x));
+            }
+        } else if (flag == "--types") {
+            opt.types = split(value);
+        } else if (flag == "--dists") {
+            opt.dists = split(value);
+        } else if (flag == "--sorters") {
+            opt.names = split(value);
+        } else if (flag == "--threads") {
+            opt.threads = std::stoull(value);
+        } else if (flag == "--reps") {
+            opt.reps = std::stoull(value);
+        } else if (flag == "--format") {
+            opt.format = value;
+        } else if (flag == "--out") {
+            opt.out = value;
+        } else {
+            throw std::invalid_argument("unknown flag " + flag);
+        }
+    }
+    return opt;
+}
+
+void write(std::ostream& out, const std::vector<result>& results, const std::string& format) {
+    if (format == "json") {
+        nlohmann::json rows = nlohmann::json::array();
+        for (const result& r : results) {
+            rows.push_back({{"sorter", r.sorter},
+                            {"type", r.type},
+                            {"distribution", r.distribution},
+                            {"n", r.n},
+                            {"threads", r.threads},
+                            {"time_ms", r.time_ms},
+                            {"melems_per_s", r.melems_per_s},
+                            {"comparisons", r.comparisons},
+                            {"moves", r.moves},
+                            {"peak_bytes", r.peak_bytes},
+                            {"sorted", r.sorted}});
+        }
+        out << rows.dump(2) << '\n';
+        return;
+    }
+    out << "sorter,type,distribution,n,threads,time_ms,melems_per_s,comparisons,moves,"
+           "peak_bytes,sorted\n";
+    for (const result& r : results) {
+        out << r.sorter << ',' << r.type << ',' << r.distribution << ',' << r.n << ','
+            << r.threads << ',' << r.time_ms << ',' << r.melems_per_s << ',' << r.comparisons
+            << ',' << r.moves << ',' << r.peak_bytes << ',' << (r.sorted ? "true" : "false")
+            << '\n';
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    options opt = parse(argc, argv);
+    std::vector<result> results;
+    for (const std::string& type : opt.types) {
+        if (type == "int32") {
+            bench<int32_t>(type, opt, results);
+        } else if (type == "int64") {
+            bench<int64_t>(type, opt, results);
+        } else if (type == "double") {
+            bench<double>(type, opt, results);
+        } else {
+            std::cerr << "unknown type " << type << '\n';
+            return 1;
+        }
+    }
+    if (opt.out.empty()) {
+        write(std::cout, results, opt.format);
+    } else {
+        std::ofstream file(opt.out);
+        write(file, results, opt.format);
+    }
+    bool all_sorted = std::all_of(results.begin(), results.end(),
+                                  [](const result& r) { return r.sorted; });
+    return all_sorted ? 0 : 1;
+}
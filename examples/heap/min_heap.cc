@@ -10,6 +10,6 @@ int main() {
     m.insert('d');
     m.insert('e');
     std::cout << m.min() << '\n';
-    m.remove(m.min());
+    m._min();
     std::cout << m.min() << '\n';
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #ifndef FIB_H
 #define FIB_H
 
+#include "../math/big_uint.h"
+
 #ifdef __cplusplus
 #include <cstdint>
 #include <iostream>
 #include <math.h>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
@@ -14,7 +18,7 @@
  * @param n upper boumd
  * @return int64_t returns the total fibonacci numbers till n
  */
-int64_t fibonacci(int64_t n) {
+inline int64_t fibonacci(int64_t n) {
     if (n <= 1) {
         return n;
     }
@@ -27,7 +31,7 @@ int64_t fibonacci(int64_t n) {
  * @param n upper boumd
  * @return int64_t returns the total fibonacci numbers till n
  */
-int64_t fibonacci_dp(int64_t n) {
+inline int64_t fibonacci_dp(int64_t n) {
     std::vector<int64_t> dp(n + 2);
     dp[0] = 0;
     dp[1] = 1;
@@ -43,7 +47,7 @@ int64_t fibonacci_dp(int64_t n) {
  * @param n upper boumd
  * @return int64_t returns the total fibonacci numbers till n
  */
-int64_t fibonacci_bottom_up(int64_t n) {
+inline int64_t fibonacci_bottom_up(int64_t n) {
     int64_t a = 0, b = 1, c = 0;
     if (n == 0) {
         return 0;
@@ -62,8 +66,95 @@ int64_t fibonacci_bottom_up(int64_t n) {
  * @param n upper boumd
  * @return int64_t returns the total fibonacci numbers till n
  */
-int64_t fibonacci_binet(int64_t n) {
+inline int64_t fibonacci_binet(int64_t n) {
     double phi = (std::sqrt(5) + 1) / 2;
     return (int64_t)std::round(std::pow(phi, n) / sqrt(5));
 }
+
+/**
+ * @brief fibonacci with fast doubling function, usable in constant expressions
+ * F(2k) = F(k)(2F(k + 1) - F(k)) and F(2k + 1) = F(k)^2 + F(k + 1)^2, so the bits of n
+ * from the most significant give F(n) in O(log(n)) steps.
+ * @param n the index, 0 <= n <= 92(F(93) does not fit in int64_t)
+ * @return int64_t F(n)
+ * Throws std::out_of_range if n is negative or larger than 92.
+ */
+constexpr int64_t fibonacci_doubling(int64_t n) {
+    if (n < 0 || n > 92) {
+        throw std::out_of_range("fibonacci_doubling: n must be in [0, 92]");
+    }
+    // (F(k), F(k + 1)) for the prefix k of the bits of n, the intermediate values are at
+    // most F(93) < 2^64
+    uint64_t a = 0, b = 1;
+    for (int bit = 6; bit >= 0; bit--) {
+        uint64_t c = a * (2 * b - a), d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return int64_t(a);
+}
+
+/**
+ * @brief fibonacci modulo m function, usable in constant expressions
+ * @param n the index
+ * @param m the modulus, m >= 1
+ * @return uint64_t F(n) mod m, in O(log(n)) multiplications modulo m
+ * Throws std::invalid_argument if m is 0.
+ */
+constexpr uint64_t fib_mod(uint64_t n, uint64_t m) {
+    if (m == 0) {
+        throw std::invalid_argument("fib_mod: the modulus must be positive");
+    }
+    auto mul = [m](uint64_t x, uint64_t y) {
+        return uint64_t((unsigned __int128)x * y % m);
+    };
+    uint64_t a = 0, b = 1 % m;
+    for (int bit = 63; bit >= 0; bit--) {
+        // 2b - a mod m, without overflow nor a negative value
+        uint64_t twice = b >= m - b ? b - (m - b) : b + b;
+        uint64_t c = mul(a, twice >= a ? twice - a : twice + (m - a));
+        uint64_t x = mul(a, a), y = mul(b, b);
+        uint64_t d = x >= m - y ? x - (m - y) : x + y;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c >= m - d ? c - (m - d) : c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+/**
+ * @brief fibonacci with arbitrary precision function
+ * @param n the index
+ * @return big_uint F(n) exactly, by fast doubling over big_uint, so the cost is that of a
+ * few products of numbers of about 0.69 n bits.
+ */
+inline big_uint fibonacci_big(uint64_t n) {
+    big_uint a(0), b(1);
+    int top = 63;
+    while (top >= 0 && ((n >> top) & 1) == 0) {
+        top--;
+    }
+    for (int bit = top; bit >= 0; bit--) {
+        // 2F(k + 1) - F(k) >= 0 since F(k + 1) >= F(k)
+        big_uint c = a * ((b << 1) - a);
+        big_uint d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = std::move(d);
+            b = c + a;
+        } else {
+            a = std::move(c);
+            b = std::move(d);
+        }
+    }
+    return a;
+}
 #endif
@@ -1,31 +1,259 @@
 #ifndef KADANE_H
 #define KADANE_H
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
 #include <climits>
 #include <cstdint>
 #include <iostream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #endif
 
+/**
+ * @brief a maximum sum subarray: its sum and its first and last index(inclusive)
+ * @tparam S the type of the sum, int64_t for integers and double for floating point
+ */
+template <typename S> struct max_subarray {
+    S sum;
+    size_t start;
+    size_t end;
+
+    bool operator==(const max_subarray&) const = default;
+};
+
+/**
+ * @brief a maximum sum submatrix: its sum and its corners, top left and bottom right
+ * (inclusive)
+ */
+template <typename S> struct max_submatrix {
+    S sum;
+    size_t top;
+    size_t left;
+    size_t bottom;
+    size_t right;
+
+    bool operator==(const max_submatrix&) const = default;
+};
+
+namespace _kadane_utils {
+template <typename T>
+using sum_t = std::conditional_t<std::is_floating_point_v<T>, double, int64_t>;
+
+// Kadane over a nonempty range, the first maximum from the left
+template <typename S, typename T> max_subarray<S> scan(std::span<const T> a) {
+    max_subarray<S> best{S(a[0]), 0, 0};
+    S cur = 0;
+    for (size_t i = 0, start = 0; i < a.size(); i++) {
+        cur += S(a[i]);
+        if (cur > best.sum) {
+            best = {cur, start, i};
+        }
+        if (cur < 0) {
+            cur = 0;
+            start = i + 1;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief what the merge of two neighbouring ranges needs to know about each: the total,
+ * the best prefix(ending at prefix_end), the best suffix(starting at suffix_start) and
+ * the best subarray
+ */
+template <typename S> struct summary {
+    S total;
+    S prefix;
+    size_t prefix_end;
+    S suffix;
+    size_t suffix_start;
+    max_subarray<S> best;
+};
+
+template <typename S, typename T> summary<S> summarize(std::span<const T> a, size_t offset) {
+    summary<S> s{0, S(a[0]), offset, 0, 0, scan<S>(a)};
+    for (size_t i = 0; i < a.size(); i++) {
+        s.total += S(a[i]);
+        if (s.total > s.prefix) {
+            s.prefix = s.total;
+            s.prefix_end = offset + i;
+        }
+    }
+    s.suffix = S(a[a.size() - 1]);
+    s.suffix_start = offset + a.size() - 1;
+    S acc = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        acc += S(a[i]);
+        if (acc > s.suffix) {
+            s.suffix = acc;
+            s.suffix_start = offset + i;
+        }
+    }
+    s.best.start += offset;
+    s.best.end += offset;
+    return s;
+}
+
+// l is the range right before r
+template <typename S> summary<S> merge(const summary<S>& l, const summary<S>& r) {
+    summary<S> s = l;
+    s.total = l.total + r.total;
+    if (l.total + r.prefix > l.prefix) {
+        s.prefix = l.total + r.prefix;
+        s.prefix_end = r.prefix_end;
+    }
+    s.suffix = r.suffix;
+    s.suffix_start = r.suffix_start;
+    if (r.total + l.suffix > r.suffix) {
+        s.suffix = r.total + l.suffix;
+        s.suffix_start = l.suffix_start;
+    }
+    if (l.suffix + r.prefix > s.best.sum) {
+        s.best = {l.suffix + r.prefix, l.suffix_start, r.prefix_end};
+    }
+    if (r.best.sum > s.best.sum) {
+        s.best = r.best;
+    }
+    return s;
+}
+} // namespace _kadane_utils
+
 /**
  * @brief kadane's algorithm
  * @details Computes the maximum continuous subarray sum of an array
  * @param arr input array
  * @return int64_t max contiguous sum of the array
  */
-int64_t kadane(std::vector<int> arr) {
-    int64_t mmax = INT_MIN, temp = 0;
-    for (int64_t i = 0; i < arr.size(); i++) {
-        temp += arr[i];
-        if (temp > mmax) {
-            mmax = temp;
+inline int64_t kadane(const std::vector<int>& arr) {
+    if (arr.empty()) {
+        return INT_MIN;
+    }
+    return _kadane_utils::scan<int64_t>(std::span<const int>(arr)).sum;
+}
+
+/**
+ * @brief kadane subarray function
+ * @param a the values, at least one
+ * @return max_subarray the maximum sum of a nonempty contiguous subarray and its bounds,
+ * the first such subarray to end. In O(n).
+ * Throws std::invalid_argument if a is empty.
+ */
+template <typename T>
+max_subarray<_kadane_utils::sum_t<T>> kadane_subarray(std::span<const T> a) {
+    if (a.empty()) {
+        throw std::invalid_argument("kadane_subarray: empty array");
+    }
+    return _kadane_utils::scan<_kadane_utils::sum_t<T>>(a);
+}
+
+/**
+ * @brief parallel kadane function
+ * Every thread summarizes a contiguous part of the array(total, best prefix, best suffix,
+ * best subarray) and the summaries are merged from left to right: the best subarray of two
+ * neighbouring parts is the best of either or the best suffix of the left one followed by
+ * the best prefix of the right one.
+ * @param a the values, at least one
+ * @param threads number of threads(0 means every hardware thread). Default = 0
+ * @return max_subarray the maximum sum of a nonempty contiguous subarray and the bounds of
+ * one subarray that has it.
+ * Throws std::invalid_argument if a is empty.
+ */
+template <typename T>
+max_subarray<_kadane_utils::sum_t<T>> kadane_parallel(std::span<const T> a, size_t threads = 0) {
+    namespace utils = _kadane_utils;
+    using S = utils::sum_t<T>;
+    if (a.empty()) {
+        throw std::invalid_argument("kadane_parallel: empty array");
+    }
+    threads = PARALLEL::resolve_threads(threads, a.size() / (1 << 16) + 1);
+    if (threads == 1) {
+        return utils::scan<S>(a);
+    }
+    std::vector<utils::summary<S>> parts(threads);
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            size_t b = a.size() * t / threads, e = a.size() * (t + 1) / threads;
+            parts[t] = utils::summarize<S>(a.subspan(b, e - b), b);
         }
-        if (temp < 0) {
-            temp = 0;
+    });
+    utils::summary<S> all = parts[0];
+    for (size_t t = 1; t < threads; t++) {
+        all = utils::merge(all, parts[t]);
+    }
+    return all.best;
+}
+
+/**
+ * @brief maximum sum submatrix function
+ * Column compression: for every pair of first and last row the columns are summed over
+ * those rows, one row at a time so the update vectorizes, and Kadane finds the best range
+ * of columns. The rows and the columns are swapped first if there are more rows, so this
+ * takes O(min(r, c)^2 max(r, c)) time and O(max(r, c)) memory per thread. The first rows
+ * are shared between the threads dynamically, as the later ones have less work.
+ * @param grid the values, a rectangle of at least one row and one column
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return max_submatrix the maximum sum of a nonempty submatrix and the corners of one
+ * submatrix that has it, the same one for any number of threads.
+ * Throws std::invalid_argument if the grid is empty or its rows have different sizes.
+ */
+template <typename T>
+max_submatrix<_kadane_utils::sum_t<T>> maximum_submatrix(const std::vector<std::vector<T>>& grid,
+                                                          size_t threads = 1) {
+    namespace utils = _kadane_utils;
+    using S = utils::sum_t<T>;
+    if (grid.empty() || grid[0].empty()) {
+        throw std::invalid_argument("maximum_submatrix: empty grid");
+    }
+    size_t r = grid.size(), c = grid[0].size();
+    for (const std::vector<T>& row : grid) {
+        if (row.size() != c) {
+            throw std::invalid_argument("maximum_submatrix: the rows have different sizes");
         }
     }
-    return mmax;
+    // h x w, row major, h <= w
+    bool swapped = r > c;
+    size_t h = swapped ? c : r, w = swapped ? r : c;
+    std::vector<S> flat(h * w);
+    for (size_t i = 0; i < r; i++) {
+        for (size_t j = 0; j < c; j++) {
+            flat[swapped ? j * w + i : i * w + j] = S(grid[i][j]);
+        }
+    }
+    threads = PARALLEL::resolve_threads(threads, h);
+    std::vector<max_submatrix<S>> best(threads);
+    std::vector<char> found(threads, 0);
+    PARALLEL::parallel_for_dynamic(0, h, threads, [&](size_t top, size_t tid) {
+        std::vector<S> acc(w, 0);
+        for (size_t bottom = top; bottom < h; bottom++) {
+            const S* row = flat.data() + bottom * w;
+            for (size_t j = 0; j < w; j++) {
+                acc[j] += row[j];
+            }
+            max_subarray<S> s = utils::scan<S>(std::span<const S>(acc));
+            // every thread takes its first rows in increasing order
+            if (!found[tid] || s.sum > best[tid].sum) {
+                best[tid] = {s.sum, top, s.start, bottom, s.end};
+                found[tid] = 1;
+            }
+        }
+    });
+    max_submatrix<S> out = best[0];
+    bool any = found[0];
+    for (size_t t = 1; t < threads; t++) {
+        if (found[t] && (!any || best[t].sum > out.sum ||
+                         (best[t].sum == out.sum && best[t].top < out.top))) {
+            out = best[t];
+            any = true;
+        }
+    }
+    if (swapped) {
+        out = {out.sum, out.left, out.top, out.right, out.bottom};
+    }
+    return out;
 }
 
 #endif
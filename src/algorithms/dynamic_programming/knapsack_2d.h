@@ -1,39 +1,141 @@
 #ifndef KNAPSACK_H
 #define KNAPSACK_H
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 #endif
 
+namespace _knapsack_utils {
+// capacities per thread below which a row is updated by one thread
+constexpr size_t parallel_grain = size_t(1) << 16;
+
 /**
- * @brief knapsack 0/1 function
- * @param v the passed vector
- * @param capacity the capacity of the knapsack
- * @return int: the maximum value you can collect with a knapsack of the passed
- * capacity
+ * @brief the last row of the 0/1 knapsack table of the items [lo, hi): row[c] is the
+ * largest value of a subset of weight at most c, for c in [0, capacity]. One array is
+ * updated in place from capacity down, or, with more than one thread, every item fills a
+ * second array from the first one, split in ranges of capacity, and the two are swapped.
  */
-int knapsack(std::vector<std::pair<int, int>>& v, int capacity) {
-    if (capacity == 0) {
-        return 0;
+inline std::vector<int64_t> row(const std::vector<std::pair<int, int>>& v, size_t lo,
+                                size_t hi, size_t capacity, size_t threads) {
+    std::vector<int64_t> cur(capacity + 1, 0);
+    threads = PARALLEL::resolve_threads(threads, capacity / parallel_grain + 1);
+    if (threads == 1) {
+        for (size_t i = lo; i < hi; i++) {
+            size_t w = size_t(v[i].first);
+            int64_t value = v[i].second;
+            for (size_t c = capacity + 1; c-- > w;) {
+                cur[c] = std::max(cur[c], cur[c - w] + value);
+            }
+        }
+        return cur;
     }
+    std::vector<int64_t> next(capacity + 1);
+    for (size_t i = lo; i < hi; i++) {
+        size_t w = size_t(v[i].first);
+        int64_t value = v[i].second;
+        PARALLEL::parallel_for(0, capacity + 1, threads, [&](size_t a, size_t b, size_t) {
+            for (size_t c = a; c < b; c++) {
+                next[c] = c >= w ? std::max(cur[c], cur[c - w] + value) : cur[c];
+            }
+        });
+        cur.swap(next);
+    }
+    return cur;
+}
 
-    int n = int(v.size());
-    std::vector<std::vector<int>> dp(n + 1, std::vector<int>(capacity + 1));
+inline void check(const std::vector<std::pair<int, int>>& v) {
+    for (const auto& [w, value] : v) {
+        if (w < 0) {
+            throw std::invalid_argument("knapsack: negative weight");
+        }
+    }
+}
 
-    for (int i = 1; i <= n; i++) {
-        for (int j = 0; j <= capacity; j++) {
-            dp[i][j] = dp[i - 1][j];
-            if (i == 0 || j == 0) {
-                dp[i][j] = 0;
-            } else if (v[i - 1].first <= j) {
-                dp[i][j] = std::max(dp[i - 1][j], v[i - 1].second + dp[i - 1][j - v[i - 1].first]);
+/**
+ * @brief the items of an optimal subset of [lo, hi) of weight at most capacity, by divide
+ * and conquer(as Hirschberg for LCS): the best split of the capacity between the two
+ * halves comes from the last rows of both, so only O(capacity) memory is live at a time,
+ * and the total work is about twice the one of the value alone.
+ */
+inline void choose(const std::vector<std::pair<int, int>>& v, size_t lo, size_t hi,
+                   size_t capacity, size_t threads, std::vector<size_t>& out) {
+    if (hi - lo == 1) {
+        if (size_t(v[lo].first) <= capacity && v[lo].second > 0) {
+            out.push_back(lo);
+        }
+        return;
+    }
+    if (lo == hi) {
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2, split = 0;
+    {
+        std::vector<int64_t> f = row(v, lo, mid, capacity, threads);
+        std::vector<int64_t> g = row(v, mid, hi, capacity, threads);
+        for (size_t c = 1; c <= capacity; c++) {
+            if (f[c] + g[capacity - c] > f[split] + g[capacity - split]) {
+                split = c;
             }
         }
     }
+    choose(v, lo, mid, split, threads, out);
+    choose(v, mid, hi, capacity - split, threads, out);
+}
+} // namespace _knapsack_utils
+
+/**
+ * @brief knapsack 0/1 max value function
+ * @param v the (weight, value) pairs of the items, the weights are non negative
+ * @param capacity the capacity of the knapsack
+ * @param threads number of threads over the capacities(0 means every hardware thread).
+ * Default = 1
+ * @return int64_t the maximum value you can collect with a knapsack of the passed
+ * capacity, in O(n * capacity) time and O(capacity) memory.
+ * Throws std::invalid_argument if a weight is negative.
+ */
+inline int64_t knapsack_max_value(const std::vector<std::pair<int, int>>& v, size_t capacity,
+                                  size_t threads = 1) {
+    _knapsack_utils::check(v);
+    return _knapsack_utils::row(v, 0, v.size(), capacity, threads).back();
+}
+
+/**
+ * @brief knapsack 0/1 items function
+ * @param v the (weight, value) pairs of the items, the weights are non negative
+ * @param capacity the capacity of the knapsack
+ * @param threads number of threads over the capacities(0 means every hardware thread).
+ * Default = 1
+ * @return std::vector<size_t> the indexes of the items of a subset of maximum value, in
+ * increasing order, in O(n * capacity) time and O(capacity) memory.
+ * Throws std::invalid_argument if a weight is negative.
+ */
+inline std::vector<size_t> knapsack_items(const std::vector<std::pair<int, int>>& v,
+                                          size_t capacity, size_t threads = 1) {
+    _knapsack_utils::check(v);
+    std::vector<size_t> out;
+    _knapsack_utils::choose(v, 0, v.size(), capacity, threads, out);
+    return out;
+}
 
-    return dp[n][capacity];
+/**
+ * @brief knapsack 0/1 function
+ * @param v the passed vector
+ * @param capacity the capacity of the knapsack
+ * @return int: the maximum value you can collect with a knapsack of the passed
+ * capacity
+ */
+inline int knapsack(const std::vector<std::pair<int, int>>& v, int capacity) {
+    if (capacity <= 0) {
+        return 0;
+    }
+    return int(knapsack_max_value(v, size_t(capacity)));
 }
 
 #endif
@@ -2,12 +2,291 @@
 #define LCS_H
 
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <iostream>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #endif
 
+namespace _lcs_utils {
+// below this many cells a subproblem is solved with the quadratic table
+constexpr size_t base_cells = size_t(1) << 16;
+// up to this many distinct symbols in a pattern the masks are stored densely
+constexpr size_t dense_symbols = 64;
+
+/**
+ * @brief the match masks of a pattern, 64 positions per word: for every symbol a list of
+ * (block, mask) entries in block order, linked through next, so the memory is O(n) for any
+ * alphabet and the symbols that do not occur in the pattern have no entry.
+ */
+struct pattern_masks {
+    struct entry {
+        size_t block;
+        uint64_t mask;
+        int32_t next;
+        // in the first entry of a symbol only: its last entry while building, then the row
+        // of the symbol in dense
+        int32_t aux;
+    };
+    std::vector<entry> entries;
+    // head[s] is the first entry of s, -1 if s is not in the pattern. Shared by the calls
+    // of one lcs, every call restores the symbols it set.
+    std::vector<int32_t>& head;
+    std::vector<uint32_t> used;
+    // the masks of every block for every symbol of the pattern, when there are few symbols
+    std::vector<uint64_t> dense;
+
+    explicit pattern_masks(std::vector<int32_t>& head_) : head(head_) {}
+
+    template <typename Get> void build(size_t n, Get&& at) {
+        for (size_t i = 0; i < n; i++) {
+            uint32_t s = at(i);
+            int32_t e = int32_t(entries.size());
+            if (head[s] < 0) {
+                head[s] = e;
+                used.push_back(s);
+                entries.push_back({i / 64, 0, -1, e});
+            } else if (entries[entries[head[s]].aux].block != i / 64) {
+                entries[entries[head[s]].aux].next = e;
+                entries[head[s]].aux = e;
+                entries.push_back({i / 64, 0, -1, -1});
+            }
+            entries[entries[head[s]].aux].mask |= uint64_t(1) << (i % 64);
+        }
+        // a small alphabet has matches in almost every block, a dense table is faster
+        if (used.size() <= dense_symbols) {
+            const size_t blocks = (n + 63) / 64;
+            dense.assign(used.size() * blocks, 0);
+            for (size_t r = 0; r < used.size(); r++) {
+                entry& first = entries[head[used[r]]];
+                first.aux = int32_t(r);
+                for (int32_t e = head[used[r]]; e >= 0; e = entries[e].next) {
+                    dense[r * blocks + entries[e].block] = entries[e].mask;
+                }
+            }
+        }
+    }
+
+    ~pattern_masks() {
+        for (uint32_t s : used) {
+            head[s] = -1;
+        }
+    }
+};
+
+/**
+ * @brief the last row of the LCS table of a pattern and a text, bit-parallel(Allison and
+ * Dix, Hyyro): bit j of the result is 0 when L[j + 1] = L[j] + 1, so the LCS of the text and
+ * the first j characters of the pattern is the number of 0 bits below j. A text symbol only
+ * touches the blocks between its first and last match in the pattern and the carry out of
+ * them, the others are skipped.
+ */
+template <typename GetP, typename GetT>
+std::vector<uint64_t> row(size_t np, GetP&& p, size_t nt, GetT&& t, std::vector<int32_t>& head) {
+    pattern_masks pm(head);
+    pm.build(np, p);
+    const size_t blocks = (np + 63) / 64;
+    std::vector<uint64_t> v(blocks, ~uint64_t(0));
+    // V' = (V + (V & M)) | (V & ~M), the addition carries across the blocks
+    auto step = [&](size_t b, uint64_t m, uint64_t& carry) {
+        uint64_t x = v[b], s = x + (x & m), c1 = s < x;
+        s += carry;
+        carry = c1 | (s < carry);
+        v[b] = s | (x & ~m);
+    };
+    if (!pm.dense.empty()) {
+        for (size_t i = 0; i < nt; i++) {
+            int32_t e = head[t(i)];
+            if (e < 0) {
+                continue;
+            }
+            const uint64_t* m = pm.dense.data() + size_t(pm.entries[e].aux) * blocks;
+            uint64_t carry = 0;
+            for (size_t b = 0; b < blocks; b++) {
+                step(b, m[b], carry);
+            }
+        }
+        return v;
+    }
+    for (size_t i = 0; i < nt; i++) {
+        int32_t e = head[t(i)];
+        if (e < 0) {
+            continue;
+        }
+        uint64_t carry = 0;
+        for (size_t b = pm.entries[e].block; b < blocks; b++) {
+            uint64_t m = 0;
+            if (e >= 0 && pm.entries[e].block == b) {
+                m = pm.entries[e].mask;
+                e = pm.entries[e].next;
+            } else if (carry == 0) {
+                if (e < 0) {
+                    break;
+                }
+                b = pm.entries[e].block - 1;
+                continue;
+            }
+            step(b, m, carry);
+        }
+    }
+    return v;
+}
+
+// the number of 0 bits of v below j for every j in [0, n]
+inline std::vector<uint32_t> prefix_zeros(const std::vector<uint64_t>& v, size_t n) {
+    std::vector<uint32_t> z(n + 1, 0);
+    for (size_t j = 0; j < n; j++) {
+        z[j + 1] = z[j] + uint32_t(((v[j / 64] >> (j % 64)) & 1) == 0);
+    }
+    return z;
+}
+
+/**
+ * @brief Hirschberg: the matched pairs of an LCS of a[alo, ahi) and b[blo, bhi), in order.
+ * a is split in half, the split point of b comes from the last rows of the two halves(the
+ * second one on the reversed strings), so only O(n + m) memory is live at any time.
+ */
+class hirschberg {
+  public:
+    hirschberg(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, size_t sigma)
+        : _a(a), _b(b), _head(sigma, -1) {}
+
+    std::vector<std::pair<size_t, size_t>> run() {
+        _solve(0, _a.size(), 0, _b.size());
+        return std::move(_out);
+    }
+
+  private:
+    const std::vector<uint32_t>& _a;
+    const std::vector<uint32_t>& _b;
+    std::vector<int32_t> _head;
+    std::vector<std::pair<size_t, size_t>> _out;
+
+    void _solve(size_t alo, size_t ahi, size_t blo, size_t bhi) {
+        // the common prefix and suffix are always part of an LCS
+        while (alo < ahi && blo < bhi && _a[alo] == _b[blo]) {
+            _out.push_back({alo++, blo++});
+        }
+        size_t suffix = 0;
+        while (alo < ahi - suffix && blo < bhi - suffix &&
+               _a[ahi - suffix - 1] == _b[bhi - suffix - 1]) {
+            suffix++;
+        }
+        ahi -= suffix;
+        bhi -= suffix;
+        if (alo < ahi && blo < bhi) {
+            if ((ahi - alo + 1) * (bhi - blo + 1) <= base_cells || ahi - alo == 1) {
+                _table(alo, ahi, blo, bhi);
+            } else {
+                _split(alo, ahi, blo, bhi);
+            }
+        }
+        for (size_t k = 0; k < suffix; k++) {
+            _out.push_back({ahi + k, bhi + k});
+        }
+    }
+
+    void _split(size_t alo, size_t ahi, size_t blo, size_t bhi) {
+        size_t mid = alo + (ahi - alo) / 2, nb = bhi - blo;
+        std::vector<uint32_t> f = prefix_zeros(
+            row(nb, [&](size_t j) { return _b[blo + j]; }, mid - alo,
+                [&](size_t i) { return _a[alo + i]; }, _head),
+            nb);
+        std::vector<uint32_t> g = prefix_zeros(
+            row(nb, [&](size_t j) { return _b[bhi - 1 - j]; }, ahi - mid,
+                [&](size_t i) { return _a[ahi - 1 - i]; }, _head),
+            nb);
+        size_t best = 0;
+        for (size_t j = 1; j <= nb; j++) {
+            if (f[j] + g[nb - j] > f[best] + g[nb - best]) {
+                best = j;
+            }
+        }
+        f = {};
+        g = {};
+        _solve(alo, mid, blo, blo + best);
+        _solve(mid, ahi, blo + best, bhi);
+    }
+
+    // the quadratic table and its traceback, for the small subproblems
+    void _table(size_t alo, size_t ahi, size_t blo, size_t bhi) {
+        size_t n = ahi - alo, m = bhi - blo, w = m + 1;
+        std::vector<uint32_t> L((n + 1) * w, 0);
+        for (size_t i = 1; i <= n; i++) {
+            for (size_t j = 1; j <= m; j++) {
+                L[i * w + j] = _a[alo + i - 1] == _b[blo + j - 1]
+                                   ? L[(i - 1) * w + j - 1] + 1
+                                   : std::max(L[(i - 1) * w + j], L[i * w + j - 1]);
+            }
+        }
+        size_t first = _out.size();
+        for (size_t i = n, j = m; i > 0 && j > 0;) {
+            if (_a[alo + i - 1] == _b[blo + j - 1]) {
+                _out.push_back({alo + i - 1, blo + j - 1});
+                i--;
+                j--;
+            } else if (L[(i - 1) * w + j] >= L[i * w + j - 1]) {
+                i--;
+            } else {
+                j--;
+            }
+        }
+        std::reverse(_out.begin() + first, _out.end());
+    }
+};
+
+inline std::vector<uint32_t> bytes(std::string_view s) {
+    std::vector<uint32_t> ids(s.size());
+    for (size_t i = 0; i < s.size(); i++) {
+        ids[i] = static_cast<unsigned char>(s[i]);
+    }
+    return ids;
+}
+
+// the symbols of a and b renamed to [0, sigma) through a hash map
+template <typename T>
+size_t rename(std::span<const T> a, std::span<const T> b, std::vector<uint32_t>& ia,
+              std::vector<uint32_t>& ib) {
+    std::unordered_map<T, uint32_t> id;
+    id.reserve(a.size() + b.size());
+    auto of = [&](const T& x) { return id.try_emplace(x, uint32_t(id.size())).first->second; };
+    ia.resize(a.size());
+    ib.resize(b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ia[i] = of(a[i]);
+    }
+    for (size_t i = 0; i < b.size(); i++) {
+        ib[i] = of(b[i]);
+    }
+    return id.size();
+}
+} // namespace _lcs_utils
+
+/**
+ * @brief longest common subsequence length function
+ * @details bit-parallel, O(n * m / 64) time and O(min(n, m)) memory
+ * @param a first input string
+ * @param b second input string
+ * @return size_t the length of the longest common subsequence of a and b
+ */
+inline size_t lcs_length(std::string_view a, std::string_view b) {
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+    }
+    // the shorter string is the pattern, the bit vector has one bit per character of it
+    std::vector<int32_t> head(256, -1);
+    std::vector<uint64_t> v = _lcs_utils::row(
+        b.size(), [&](size_t j) { return uint32_t(static_cast<unsigned char>(b[j])); },
+        a.size(), [&](size_t i) { return uint32_t(static_cast<unsigned char>(a[i])); }, head);
+    return _lcs_utils::prefix_zeros(v, b.size()).back();
+}
+
 /**
  * @brief longest common subsequence function
  * @details computes the longest common subsequence of 2 strings
@@ -15,41 +294,140 @@
  * @param b second input string
  * @return int64_t the longest common subsequence of a to b
  */
-int64_t lcs(const std::string a, const std::string b) {
-    int64_t m = a.length(), n = b.length();
-    std::vector<std::vector<int64_t>> res(m + 1, std::vector<int64_t>(n + 1));
-    std::vector<std::vector<int64_t>> trace(20, std::vector<int64_t>(20));
+inline int64_t lcs(const std::string& a, const std::string& b) {
+    return int64_t(lcs_length(a, b));
+}
 
-    for (int64_t i = 0; i < m + 1; i++) {
-        for (int64_t j = 0; j < n + 1; j++) {
-            res[i][j] = 0;
-            trace[i][j] = 0;
-        }
+/**
+ * @brief longest common subsequence pairs function
+ * @details Hirschberg's divide and conquer over bit-parallel rows: O(n * m / 64) time and
+ * O(n + m) memory, so inputs of millions of elements fit
+ * @param a first sequence
+ * @param b second sequence
+ * @return std::vector<std::pair<size_t, size_t>> the (index in a, index in b) pairs of a
+ * longest common subsequence, in increasing order
+ */
+template <typename T>
+std::vector<std::pair<size_t, size_t>> lcs_pairs(std::span<const T> a, std::span<const T> b) {
+    std::vector<uint32_t> ia, ib;
+    size_t sigma = _lcs_utils::rename(a, b, ia, ib);
+    return _lcs_utils::hirschberg(ia, ib, sigma).run();
+}
+
+/**
+ * @brief longest common subsequence string function
+ * @param a first input string
+ * @param b second input string
+ * @return std::string a longest common subsequence of a and b, in O(n + m) memory
+ */
+inline std::string lcs_string(std::string_view a, std::string_view b) {
+    std::vector<uint32_t> ia = _lcs_utils::bytes(a), ib = _lcs_utils::bytes(b);
+    std::string s;
+    for (auto [i, j] : _lcs_utils::hirschberg(ia, ib, 256).run()) {
+        s.push_back(a[i]);
     }
+    return s;
+}
 
-    for (int64_t i = 0; i < m + 1; ++i) {
-        for (int64_t j = 0; j < n + 1; ++j) {
-            if (i == 0 || j == 0) {
-                res[i][j] = 0;
-                trace[i][j] = 0;
-            }
+/**
+ * @brief the kind of a line of a diff
+ */
+enum class diff_op { equal, remove, insert };
 
-            else if (a[i - 1] == b[j - 1]) {
-                res[i][j] = 1 + res[i - 1][j - 1];
-                trace[i][j] = 1;
+/**
+ * @brief one line of a diff: a is its index in the old sequence and b in the new one, for
+ * a remove b is where it would have been in the new one and the other way around
+ */
+struct diff_edit {
+    diff_op op;
+    size_t a;
+    size_t b;
 
-            } else {
-                if (res[i - 1][j] > res[i][j - 1]) {
-                    res[i][j] = res[i - 1][j];
-                    trace[i][j] = 2;
-                } else {
-                    res[i][j] = res[i][j - 1];
-                    trace[i][j] = 3;
-                }
+    bool operator==(const diff_edit&) const = default;
+};
+
+/**
+ * @brief diff function
+ * @param a the old sequence
+ * @param b the new sequence
+ * @return std::vector<diff_edit> the shortest edit script from a to b made of removals and
+ * insertions(the complement of a longest common subsequence), in order, the removals first
+ * between two equal lines
+ */
+template <typename T>
+std::vector<diff_edit> lcs_diff(std::span<const T> a, std::span<const T> b) {
+    std::vector<diff_edit> edits;
+    size_t i = 0, j = 0;
+    auto gap = [&](size_t ia, size_t jb) {
+        for (; i < ia; i++) {
+            edits.push_back({diff_op::remove, i, j});
+        }
+        for (; j < jb; j++) {
+            edits.push_back({diff_op::insert, i, j});
+        }
+    };
+    for (auto [x, y] : lcs_pairs(a, b)) {
+        gap(x, y);
+        edits.push_back({diff_op::equal, i++, j++});
+    }
+    gap(a.size(), b.size());
+    return edits;
+}
+
+/**
+ * @brief unified diff function
+ * @param a the lines of the old file
+ * @param b the lines of the new file
+ * @param context the number of equal lines kept around every change. Default = 3
+ * @return std::string the changes in the unified diff format(the "@@ -l,s +l,s @@" hunks,
+ * without the file headers), empty if a and b are equal
+ */
+inline std::string unified_diff(const std::vector<std::string>& a,
+                                const std::vector<std::string>& b, size_t context = 3) {
+    std::vector<diff_edit> e = lcs_diff(std::span<const std::string>(a),
+                                        std::span<const std::string>(b));
+    std::string out;
+    for (size_t k = 0; k < e.size();) {
+        if (e[k].op == diff_op::equal) {
+            k++;
+            continue;
+        }
+        // a hunk runs until more than 2 * context equal lines separate two changes
+        size_t lo = k - std::min(k, context), hi = k;
+        for (size_t equal = 0; hi < e.size() && equal <= 2 * context; hi++) {
+            equal = e[hi].op == diff_op::equal ? equal + 1 : 0;
+        }
+        while (hi > k && e[hi - 1].op == diff_op::equal) {
+            hi--;
+        }
+        size_t end = std::min(e.size(), hi + context);
+        size_t na = 0, nb = 0;
+        for (size_t x = lo; x < end; x++) {
+            na += e[x].op != diff_op::insert;
+            nb += e[x].op != diff_op::remove;
+        }
+        // as diff -u: an empty range starts at the line before it, a length of 1 is omitted
+        auto range = [](size_t first, size_t count) {
+            std::string r = std::to_string(first + (count > 0));
+            return count == 1 ? r : r + "," + std::to_string(count);
+        };
+        out += "@@ -" + range(e[lo].a, na) + " +" + range(e[lo].b, nb) + " @@\n";
+        for (size_t x = lo; x < end; x++) {
+            switch (e[x].op) {
+            case diff_op::equal:
+                out += " " + a[e[x].a] + "\n";
+                break;
+            case diff_op::remove:
+                out += "-" + a[e[x].a] + "\n";
+                break;
+            case diff_op::insert:
+                out += "+" + b[e[x].b] + "\n";
+                break;
             }
         }
+        k = end;
     }
-    return res[m][n];
+    return out;
 }
 
 #endif
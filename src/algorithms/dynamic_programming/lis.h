@@ -2,18 +2,147 @@
 #define LIS_H
 
 #ifdef __cplusplus
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <iostream>
+#include <span>
 #include <vector>
 #endif
 
+/**
+ * @brief lis stream class
+ * Longest increasing subsequence of a sequence that arrives one element at a time
+ * (patience sorting): tails[k] is the element that ends the increasing subsequences of
+ * length k + 1 and has the smallest last element, every new element replaces the first
+ * tail it does not follow, found by binary search, and keeps a link to the tail before
+ * it. A push takes O(log(L)) and the subsequence is read back through the links in O(L),
+ * L the current length. The elements and their links are kept, O(n) memory.
+ * @tparam T the type of the elements
+ * @tparam Compare comp(a, b) is true when b may follow a in the subsequence, std::less
+ * for strictly increasing, std::less_equal for non decreasing
+ */
+template <typename T, typename Compare = std::less<T>> class lis_stream {
+  public:
+    /**
+     * @brief Construct a new lis stream object
+     * @param comp the order of the subsequence. Default = Compare()
+     */
+    explicit lis_stream(Compare comp = Compare()) : _comp(comp) {}
+
+    /**
+     * @brief push function
+     * @param x the next element
+     * @return size_t the length of the longest increasing subsequence that ends at x.
+     */
+    size_t push(const T& x) {
+        auto it = std::lower_bound(_tails.begin(), _tails.end(), x,
+                                   [&](size_t t, const T& v) { return _comp(_values[t], v); });
+        size_t k = size_t(it - _tails.begin()), i = _values.size();
+        _values.push_back(x);
+        _prev.push_back(k == 0 ? npos : _tails[k - 1]);
+        if (it == _tails.end()) {
+            _tails.push_back(i);
+        } else {
+            *it = i;
+        }
+        return k + 1;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of elements pushed.
+     */
+    size_t size() const { return _values.size(); }
+
+    /**
+     * @brief length function
+     * @return size_t the length of the longest increasing subsequence so far.
+     */
+    size_t length() const { return _tails.size(); }
+
+    /**
+     * @brief indices function
+     * @return std::vector<size_t> the positions of the elements of a longest increasing
+     * subsequence so far, in increasing order.
+     */
+    std::vector<size_t> indices() const {
+        std::vector<size_t> out(_tails.size());
+        size_t i = _tails.empty() ? npos : _tails.back();
+        for (size_t k = out.size(); k-- > 0; i = _prev[i]) {
+            out[k] = i;
+        }
+        return out;
+    }
+
+    /**
+     * @brief sequence function
+     * @return std::vector<T> the elements of a longest increasing subsequence so far.
+     */
+    std::vector<T> sequence() const {
+        std::vector<T> out;
+        out.reserve(_tails.size());
+        for (size_t i : indices()) {
+            out.push_back(_values[i]);
+        }
+        return out;
+    }
+
+    /**
+     * @brief clear function
+     * Starts a new sequence.
+     */
+    void clear() {
+        _values.clear();
+        _prev.clear();
+        _tails.clear();
+    }
+
+  private:
+    static constexpr size_t npos = size_t(-1);
+    Compare _comp;
+    std::vector<T> _values;
+    // the element before every element in the longest subsequence that ends at it
+    std::vector<size_t> _prev;
+    std::vector<size_t> _tails;
+};
+
+/**
+ * @brief Longest increasing subsequence indices function
+ * @param arr input array
+ * @param comp comp(a, b) is true when b may follow a. Default = std::less
+ * @return std::vector<size_t> the positions of the elements of a longest increasing
+ * subsequence, in increasing order, in O(n log(n))
+ */
+template <typename T, typename Compare = std::less<T>>
+std::vector<size_t> lis_indices(std::span<const T> arr, Compare comp = Compare()) {
+    // the same as lis_stream but the elements are not copied
+    std::vector<size_t> tails, prev(arr.size());
+    for (size_t i = 0; i < arr.size(); i++) {
+        auto it = std::lower_bound(tails.begin(), tails.end(), i,
+                                   [&](size_t t, size_t j) { return comp(arr[t], arr[j]); });
+        prev[i] = it == tails.begin() ? size_t(-1) : *(it - 1);
+        if (it == tails.end()) {
+            tails.push_back(i);
+        } else {
+            *it = i;
+        }
+    }
+    std::vector<size_t> out(tails.size());
+    size_t i = tails.empty() ? 0 : tails.back();
+    for (size_t k = out.size(); k-- > 0; i = prev[i]) {
+        out[k] = i;
+    }
+    return out;
+}
+
 /**
  * @brief Longest increasing subsequence function
  * @details computes the longest increasing subsequence of the passed array
  * @param arr input array
  * @return int64_t the size of the longest increasing subsequence
  */
-template <typename T> int64_t lis(std::vector<T> arr) {
+template <typename T> int64_t lis(const std::vector<T>& arr) {
     std::vector<T> ans;
     int64_t n = arr.size();
     for (int64_t i = 0; i < n; i++) {
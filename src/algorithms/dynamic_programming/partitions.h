@@ -1,13 +1,20 @@
 #ifndef PARTITIONS_H
 #define PARTITIONS_H
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
 #include <vector>
 #endif
 
-void iterate(long long n, std::vector<std::vector<long long>>& ans,
-             std::vector<long long> prefix = {}) {
+inline void iterate(long long n, std::vector<std::vector<long long>>& ans,
+                    std::vector<long long> prefix = {}) {
     if (n == 0) {
         ans.push_back(prefix);
     } else {
@@ -21,9 +28,193 @@ void iterate(long long n, std::vector<std::vector<long long>>& ans,
     }
 }
 
-std::vector<std::vector<long long>> partitions(long long n) {
+/**
+ * @brief partition generator class
+ * The partitions of n into parts of at most max_part, one at a time and in place: a
+ * partition is its parts in non increasing order, they come in increasing lexicographic
+ * order from 1 + 1 + ... + 1, and the successor increases the rightmost part that can grow
+ * and refills the rest with ones, in the buffer of the current one. No allocation happens
+ * after the constructor.
+ */
+class partition_generator {
+  public:
+    /**
+     * @brief Construct a new partition generator object, on the first partition
+     * @param n the number to partition, non negative
+     * @param max_part the largest part allowed, n if negative. Default = -1
+     * Throws std::invalid_argument if n is negative, or max_part is 0 for n > 0.
+     */
+    explicit partition_generator(long long n, long long max_part = -1)
+        : _max(max_part < 0 ? n : max_part) {
+        if (n < 0 || (n > 0 && _max == 0)) {
+            throw std::invalid_argument("partition_generator: no partition");
+        }
+        _parts.reserve(size_t(n));
+        _parts.assign(size_t(n), 1);
+    }
+
+    /**
+     * @brief current function
+     * @return std::span<const long long> the parts of the current partition, valid until
+     * the next call to next().
+     */
+    std::span<const long long> current() const { return _parts; }
+
+    /**
+     * @brief next function
+     * @return true if the generator moved to the next partition, false if the current one
+     * was the last(then it is left as it is).
+     */
+    bool next() {
+        long long rest = 0;
+        for (size_t i = _parts.size(); i-- > 0;) {
+            long long bound = i == 0 ? _max : _parts[i - 1];
+            if (rest >= 1 && _parts[i] < bound) {
+                _parts[i]++;
+                _parts.resize(i + 1);
+                _parts.insert(_parts.end(), size_t(rest - 1), 1);
+                return true;
+            }
+            rest += _parts[i];
+        }
+        return false;
+    }
+
+    /**
+     * @brief the iterator of a generator, it moves the generator
+     */
+    class iterator {
+      public:
+        using value_type = std::span<const long long>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(partition_generator* g) : _g(g) {}
+        value_type operator*() const { return _g->current(); }
+        iterator& operator++() {
+            if (!_g->next()) {
+                _g = nullptr;
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return _g == nullptr; }
+
+      private:
+        partition_generator* _g{nullptr};
+    };
+
+    /**
+     * @brief begin function
+     * @return iterator from the current partition to the last one.
+     */
+    iterator begin() { return iterator(this); }
+
+    /**
+     * @brief end function
+     * @return std::default_sentinel_t the end of the partitions.
+     */
+    std::default_sentinel_t end() const { return {}; }
+
+  private:
+    long long _max;
+    std::vector<long long> _parts;
+};
+
+/**
+ * @brief for each partition function
+ * @param n the number to partition
+ * @param f called with the parts of every partition, as std::span<const long long>, in the
+ * order of partition_generator
+ */
+template <typename F> void for_each_partition(long long n, F&& f) {
+    partition_generator g(n);
+    do {
+        f(g.current());
+    } while (g.next());
+}
+
+/**
+ * @brief parallel for each partition function
+ * @details the partitions are split by their largest part, the partitions of n whose
+ * largest part is k are k followed by the partitions of n - k into parts of at most k, and
+ * the threads take the next largest part from a shared counter
+ * @param n the number to partition
+ * @param threads number of threads(0 means every hardware thread)
+ * @param f called as f(parts, tid) with every partition, from the threads in any order,
+ * tid is in [0, threads)
+ */
+template <typename F> void parallel_for_each_partition(long long n, size_t threads, F&& f) {
+    if (n <= 0) {
+        for_each_partition(n, [&](std::span<const long long> p) { f(p, size_t(0)); });
+        return;
+    }
+    threads = PARALLEL::resolve_threads(threads, size_t(n));
+    std::vector<std::vector<long long>> buffers(threads);
+    // the largest parts from n down, the small ones that have the most partitions last
+    PARALLEL::parallel_for_dynamic(0, size_t(n), threads, [&](size_t i, size_t tid) {
+        long long k = n - (long long)i;
+        std::vector<long long>& parts = buffers[tid];
+        partition_generator rest(n - k, k);
+        do {
+            std::span<const long long> tail = rest.current();
+            parts.assign(1, k);
+            parts.insert(parts.end(), tail.begin(), tail.end());
+            f(std::span<const long long>(parts), tid);
+        } while (rest.next());
+    });
+}
+
+/**
+ * @brief partition count function
+ * @details Euler's pentagonal number theorem, p(n) = sum over k >= 1 of (-1)^(k + 1)
+ * (p(n - k(3k - 1) / 2) + p(n - k(3k + 1) / 2)), in O(n sqrt(n)) and O(n) memory
+ * @param n the number to partition
+ * @param mod the modulus, below 2^63, or 0 for the exact count. Default = 0
+ * @return uint64_t the number of partitions of n, modulo mod.
+ * Throws std::overflow_error for the exact count of n > 416, which does not fit 64 bits.
+ */
+inline uint64_t partition_count(size_t n, uint64_t mod = 0) {
+    if (mod == 0 && n > 416) {
+        throw std::overflow_error("partition_count: p(n) does not fit 64 bits");
+    }
+    // the exact counts are computed modulo 2^64 by the wrap around of uint64_t, which is
+    // exact since every p(m) of the recurrence fits
+    const bool exact = mod == 0;
+    auto add = [&](uint64_t a, uint64_t b) {
+        return exact ? a + b : (a + b >= mod ? a + b - mod : a + b);
+    };
+    auto sub = [&](uint64_t a, uint64_t b) {
+        return exact ? a - b : (a >= b ? a - b : a + mod - b);
+    };
+    std::vector<uint64_t> p(n + 1, 0);
+    p[0] = exact ? 1 : 1 % mod;
+    for (size_t m = 1; m <= n; m++) {
+        uint64_t sum = 0;
+        for (size_t k = 1;; k++) {
+            size_t g1 = k * (3 * k - 1) / 2, g2 = k * (3 * k + 1) / 2;
+            if (g1 > m) {
+                break;
+            }
+            uint64_t term = g2 <= m ? add(p[m - g1], p[m - g2]) : p[m - g1];
+            sum = k % 2 ? add(sum, term) : sub(sum, term);
+        }
+        p[m] = sum;
+    }
+    return p[n];
+}
+
+/**
+ * @brief partitions function
+ * @param n the number to partition
+ * @return std::vector<std::vector<long long>> every partition of n, in the order of
+ * partition_generator. Their number grows exponentially, use partition_generator or
+ * for_each_partition to look at them without storing them.
+ */
+inline std::vector<std::vector<long long>> partitions(long long n) {
     std::vector<std::vector<long long>> ans;
-    iterate(n, ans);
+    for_each_partition(
+        n, [&](std::span<const long long> p) { ans.emplace_back(p.begin(), p.end()); });
     return ans;
 }
 
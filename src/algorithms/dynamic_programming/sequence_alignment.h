@@ -0,0 +1,91 @@
+#ifndef SEQUENCE_ALIGNMENT_H
+#define SEQUENCE_ALIGNMENT_H
+
+#include "wavefront.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+/**
+ * @brief the scores of an alignment with a linear gap penalty: every pair of equal
+ * characters adds match, every pair of different ones adds mismatch and every character
+ * aligned to nothing adds gap(usually negative).
+ */
+struct alignment_scoring {
+    int64_t match = 1;
+    int64_t mismatch = -1;
+    int64_t gap = -1;
+};
+
+/**
+ * @brief global alignment score function(Needleman and Wunsch)
+ * @param a the first sequence
+ * @param b the second sequence
+ * @param scoring the scores. Default = +1, -1, -1
+ * @param opt the tile size and the number of threads of the wavefront. Default = 1 thread
+ * @return int64_t the best score of an alignment of the whole of a with the whole of b, in
+ * O(|a| |b|) time and O(|a| + |b|) memory.
+ */
+inline int64_t global_alignment_score(std::string_view a, std::string_view b,
+                                      const alignment_scoring& scoring = {},
+                                      const wavefront_options& opt = {}) {
+    auto edge = [&](size_t i, size_t j) { return int64_t(i + j) * scoring.gap; };
+    auto cell = [&](size_t i, size_t j, int64_t n, int64_t w, int64_t nw) {
+        int64_t diagonal = nw + (a[i - 1] == b[j - 1] ? scoring.match : scoring.mismatch);
+        return std::max(diagonal, std::max(n, w) + scoring.gap);
+    };
+    return wavefront_rolling<int64_t>(a.size(), b.size(), edge, cell, opt).last_row.back();
+}
+
+/**
+ * @brief local alignment score function(Smith and Waterman)
+ * @param a the first sequence
+ * @param b the second sequence
+ * @param scoring the scores. Default = +1, -1, -1
+ * @param opt the tile size and the number of threads of the wavefront. Default = 1 thread
+ * @return int64_t the best score of an alignment of a substring of a with a substring of
+ * b(0 for the empty ones), in O(|a| |b|) time and O(|a| + |b|) memory.
+ */
+inline int64_t local_alignment_score(std::string_view a, std::string_view b,
+                                     const alignment_scoring& scoring = {},
+                                     const wavefront_options& opt = {}) {
+    // the cells of a row are never computed at once, so every row keeps its own maximum
+    std::vector<int64_t> row_best(a.size() + 1, 0);
+    auto edge = [](size_t, size_t) { return int64_t(0); };
+    auto cell = [&](size_t i, size_t j, int64_t n, int64_t w, int64_t nw) {
+        int64_t diagonal = nw + (a[i - 1] == b[j - 1] ? scoring.match : scoring.mismatch);
+        int64_t v = std::max({int64_t(0), diagonal, std::max(n, w) + scoring.gap});
+        row_best[i] = std::max(row_best[i], v);
+        return v;
+    };
+    wavefront_rolling<int64_t>(a.size(), b.size(), edge, cell, opt);
+    return *std::max_element(row_best.begin(), row_best.end());
+}
+
+/**
+ * @brief global alignment scores of one query to many candidates
+ * @param query the sequence the candidates are aligned to
+ * @param candidates the sequences
+ * @param scoring the scores. Default = +1, -1, -1
+ * @param threads number of threads(0 means every hardware thread), every alignment runs
+ * on one thread. Default = 1
+ * @return std::vector<int64_t> the global alignment score of every candidate.
+ */
+inline std::vector<int64_t> global_alignment_scores(std::string_view query,
+                                                    std::span<const std::string> candidates,
+                                                    const alignment_scoring& scoring = {},
+                                                    size_t threads = 1) {
+    std::vector<int64_t> out(candidates.size());
+    PARALLEL::parallel_for_dynamic(0, candidates.size(), threads, [&](size_t i, size_t) {
+        out[i] = global_alignment_score(query, candidates[i], scoring);
+    });
+    return out;
+}
+
+#endif
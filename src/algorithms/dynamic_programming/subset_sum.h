@@ -2,39 +2,104 @@
 #define SUBSET_SUM_H
 
 #ifdef __cplusplus
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #endif
 
+namespace _subset_sum_utils {
+/**
+ * @brief the sums in [0, B] reachable by subsets of v, as a bitset of 64 bit words: every
+ * element is added to all the sums at once by bits |= bits << x, in O(B / 64) words
+ */
+inline std::vector<uint64_t> reachable(const std::vector<int>& v, size_t B) {
+    const size_t words = B / 64 + 1;
+    std::vector<uint64_t> bits(words, 0);
+    bits[0] = 1;
+    size_t top = 0;
+    for (int x : v) {
+        if (x < 0) {
+            throw std::invalid_argument("subset_sum: negative element");
+        }
+        if (size_t(x) > B || x == 0) {
+            continue;
+        }
+        // the words above the largest sum so far plus x are still 0
+        top = std::min(B, top + size_t(x));
+        const size_t q = size_t(x) / 64, r = size_t(x) % 64;
+        // from the top down, so every word reads the words below it before they change
+        for (size_t i = top / 64; i >= q; i--) {
+            uint64_t shifted = bits[i - q] << r;
+            if (r != 0 && i > q) {
+                shifted |= bits[i - q - 1] >> (64 - r);
+            }
+            bits[i] |= shifted;
+            if (i == 0) {
+                break;
+            }
+        }
+    }
+    // the sums above B that the last word may hold
+    if ((B + 1) % 64 != 0) {
+        bits.back() &= (uint64_t(1) << ((B + 1) % 64)) - 1;
+    }
+    return bits;
+}
+} // namespace _subset_sum_utils
+
 /**
  * @brief subset sum function
- * @details Returns the number of subsets you can create with sum of B
- * @param v: the passed vector
+ * @details Returns the number of subsets you can create with sum of B, in O(n * B) time and
+ * O(B) memory
+ * @param v: the passed vector, of non negative elements
  * @param B: the sum
  * @returns: int, the total number of subsets you can create
  */
-int subset_sum(std::vector<int>& v, int B) {
-    if (int(v.size()) == 0) {
+inline int subset_sum(const std::vector<int>& v, int B) {
+    if (int(v.size()) == 0 || B < 0) {
         return 0;
     }
-    int n = int(v.size());
-    std::vector<std::vector<int>> dp(n + 1, std::vector<int>(B + 1, 0));
-    for (int i = 0; i <= n; i++) {
-        dp[i][0] = 1;
+    // dp[j] is the number of subsets of the elements so far whose sum is j, it is updated
+    // from B down so that every element is used at most once
+    std::vector<int> dp(B + 1, 0);
+    dp[0] = 1;
+    for (int x : v) {
+        for (int j = B; j >= x && j >= 0; j--) {
+            dp[j] += dp[j - x];
+        }
     }
+    return dp[B];
+}
 
-    for (int i = 1; i <= n; i++) {
-        for (int j = 0; j <= B; j++) {
-            dp[i][j] = dp[i - 1][j];
-
-            if (j - v[i - 1] >= 0) {
-                dp[i][j] += dp[i - 1][j - v[i - 1]];
-            }
-        }
+/**
+ * @brief subset sums function
+ * @param v: the passed vector, of non negative elements
+ * @param B: the largest sum of interest
+ * @returns: std::vector<bool>, element j is true if a subset of v sums to j, for j in
+ * [0, B], in O(n * B / 64) time and B / 8 bytes of memory.
+ * Throws std::invalid_argument if an element is negative.
+ */
+inline std::vector<bool> subset_sums(const std::vector<int>& v, size_t B) {
+    std::vector<uint64_t> bits = _subset_sum_utils::reachable(v, B);
+    std::vector<bool> out(B + 1);
+    for (size_t j = 0; j <= B; j++) {
+        out[j] = (bits[j / 64] >> (j % 64)) & 1;
     }
+    return out;
+}
 
-    return dp[n][B];
+/**
+ * @brief subset sum exists function
+ * @param v: the passed vector, of non negative elements
+ * @param B: the sum
+ * @returns: true if a subset of v sums to B(the empty one sums to 0), in O(n * B / 64).
+ * Throws std::invalid_argument if an element is negative.
+ */
+inline bool subset_sum_exists(const std::vector<int>& v, size_t B) {
+    return (_subset_sum_utils::reachable(v, B)[B / 64] >> (B % 64)) & 1;
 }
 
 #endif
@@ -0,0 +1,160 @@
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include "../../helpers/parallel.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#endif
+
+/**
+ * @brief the options of the wavefront DP engine
+ * tile: the side of the square tiles the table is cut in, a tile of 256 x 256 cells of 4
+ * bytes and its edges stay in L2. Default = 256
+ * threads: number of threads(0 means every hardware thread). Default = 1
+ */
+struct wavefront_options {
+    size_t tile = 256;
+    size_t threads = 1;
+};
+
+/**
+ * @brief the last row(cols + 1 values) and the last column(rows + 1 values) of a table
+ */
+template <typename T> struct wavefront_edges {
+    std::vector<T> last_row;
+    std::vector<T> last_column;
+};
+
+namespace _wavefront_utils {
+/**
+ * @brief fills the table (rows + 1) x (cols + 1) tile by tile, the tiles of an
+ * anti-diagonal have no dependency between them and run at once. bottom and right start
+ * as row 0 and column 0 and hold, for every column and every row, the last cell computed
+ * there, so a tile reads its north edge from bottom and its west edge from right. The
+ * north west corner of a tile is overwritten by its neighbours of the previous diagonal,
+ * so every tile saves the one of the next tile to its right before it starts, in a buffer
+ * per parity of the diagonal. If table is not null every cell is stored in it as well.
+ */
+template <typename T, typename E, typename F>
+void fill(size_t rows, size_t cols, E& edge, F& cell, const wavefront_options& opt,
+          std::vector<T>& bottom, std::vector<T>& right, T* table) {
+    if (opt.tile == 0) {
+        throw std::invalid_argument("wavefront: the tile size must be positive");
+    }
+    bottom.resize(cols + 1);
+    right.resize(rows + 1);
+    for (size_t j = 0; j <= cols; j++) {
+        bottom[j] = edge(size_t(0), j);
+    }
+    for (size_t i = 0; i <= rows; i++) {
+        right[i] = edge(i, size_t(0));
+    }
+    if (table != nullptr) {
+        for (size_t j = 0; j <= cols; j++) {
+            table[j] = bottom[j];
+        }
+        for (size_t i = 0; i <= rows; i++) {
+            table[i * (cols + 1)] = right[i];
+        }
+    }
+    if (rows == 0 || cols == 0) {
+        bottom[0] = edge(rows, size_t(0));
+        right[0] = edge(size_t(0), cols);
+        return;
+    }
+    const size_t t = opt.tile;
+    const size_t tile_rows = (rows + t - 1) / t, tile_cols = (cols + t - 1) / t;
+    // corner[parity][tj]: the north west corner of the tile of column tj on the next
+    // diagonal of that parity
+    std::vector<T> corner[2] = {std::vector<T>(tile_cols + 1), std::vector<T>(tile_cols + 1)};
+    auto run = [&](size_t ti, size_t tj, size_t d) {
+        size_t r0 = 1 + ti * t, r1 = std::min(rows, r0 + t - 1);
+        size_t c0 = 1 + tj * t, c1 = std::min(cols, c0 + t - 1);
+        corner[d & 1][tj + 1] = bottom[c1];
+        T nw_first = tj == 0 ? edge(r0 - 1, size_t(0)) : corner[(d + 1) & 1][tj];
+        for (size_t i = r0; i <= r1; i++) {
+            T w = right[i], nw = nw_first;
+            T* out = table != nullptr ? table + i * (cols + 1) : nullptr;
+            for (size_t j = c0; j <= c1; j++) {
+                T n = bottom[j];
+                T v = cell(i, j, n, w, nw);
+                bottom[j] = v;
+                if (out != nullptr) {
+                    out[j] = v;
+                }
+                nw = n;
+                w = v;
+            }
+            nw_first = right[i];
+            right[i] = w;
+        }
+    };
+    for (size_t d = 0; d + 1 < tile_rows + tile_cols; d++) {
+        size_t lo = d >= tile_cols ? d - tile_cols + 1 : 0, hi = std::min(d, tile_rows - 1);
+        size_t threads = PARALLEL::resolve_threads(opt.threads, hi - lo + 1);
+        if (threads == 1) {
+            for (size_t ti = lo; ti <= hi; ti++) {
+                run(ti, d - ti, d);
+            }
+            continue;
+        }
+        PARALLEL::parallel_for_dynamic(lo, hi + 1, threads,
+                                       [&](size_t ti, size_t) { run(ti, d - ti, d); });
+    }
+    // the first cells of the last row and of the last column are on the edges
+    bottom[0] = edge(rows, size_t(0));
+    right[0] = edge(size_t(0), cols);
+}
+} // namespace _wavefront_utils
+
+/**
+ * @brief wavefront table function: a DP over a (rows + 1) x (cols + 1) table where every
+ * cell depends on the ones to its north, west and north west, filled in square tiles
+ * scheduled by anti-diagonals, so the tiles of a diagonal run on several threads. Two
+ * cells of the same row or of the same column are never computed at once, so the
+ * recurrence may update state indexed by the row or by the column without locking.
+ * @param rows the number of rows after row 0
+ * @param cols the number of columns after column 0
+ * @param edge called as edge(i, j) -> T for the cells of row 0 and of column 0
+ * @param cell called as cell(i, j, north, west, north_west) -> T for 1 <= i <= rows and
+ * 1 <= j <= cols
+ * @param opt the tile size and the number of threads
+ * @return std::vector<T> the table, row major: cell (i, j) is at i * (cols + 1) + j.
+ * Throws std::invalid_argument if the tile size is 0.
+ */
+template <typename T, typename E, typename F>
+std::vector<T> wavefront_table(size_t rows, size_t cols, E&& edge, F&& cell,
+                               const wavefront_options& opt = {}) {
+    std::vector<T> table((rows + 1) * (cols + 1));
+    std::vector<T> bottom, right;
+    _wavefront_utils::fill<T>(rows, cols, edge, cell, opt, bottom, right, table.data());
+    return table;
+}
+
+/**
+ * @brief wavefront rolling function: the same DP as wavefront_table, keeping only one
+ * value per row and per column, so it takes O(rows + cols) memory.
+ * @param rows the number of rows after row 0
+ * @param cols the number of columns after column 0
+ * @param edge called as edge(i, j) -> T for the cells of row 0 and of column 0
+ * @param cell called as cell(i, j, north, west, north_west) -> T for 1 <= i <= rows and
+ * 1 <= j <= cols
+ * @param opt the tile size and the number of threads
+ * @return wavefront_edges<T> the last row and the last column of the table, the last cell
+ * is last_row.back().
+ * Throws std::invalid_argument if the tile size is 0.
+ */
+template <typename T, typename E, typename F>
+wavefront_edges<T> wavefront_rolling(size_t rows, size_t cols, E&& edge, F&& cell,
+                                     const wavefront_options& opt = {}) {
+    wavefront_edges<T> out;
+    _wavefront_utils::fill<T>(rows, cols, edge, cell, opt, out.last_row, out.last_column,
+                              nullptr);
+    return out;
+}
+
+#endif
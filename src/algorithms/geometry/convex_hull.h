@@ -1,11 +1,19 @@
 #ifndef CONVEX_HULL_H
 #define CONVEX_HULL_H
 
+#include "../../helpers/parallel.h"
+
 #include <cmath>
 #ifdef __cplusplus
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <span>
 #include <stack>
+#include <utility>
 #include <vector>
 #endif
 
@@ -19,10 +27,11 @@ namespace helpers {
  * @return 1: if it's counter clockwise
  * @return 0: otherwise
  */
-int orientation(const std::pair<int, int> a, const std::pair<int, int> b,
-                const std::pair<int, int> c) {
-    double v = a.first * (b.second - c.second) + b.first * (c.second - a.second) +
-               c.first * (a.second - b.second);
+inline int orientation(const std::pair<int, int> a, const std::pair<int, int> b,
+                       const std::pair<int, int> c) {
+    // exact: the differences take 33 bits and their products 66
+    __int128 v = (__int128)(int64_t(b.first) - a.first) * (int64_t(c.second) - a.second) -
+                 (__int128)(int64_t(b.second) - a.second) * (int64_t(c.first) - a.first);
     if (v < 0) {
         return -1;
     }
@@ -33,8 +42,8 @@ int orientation(const std::pair<int, int> a, const std::pair<int, int> b,
 }
 }; // namespace helpers
 
-std::vector<std::pair<int, int>> graham_scan(std::vector<std::pair<int, int>> points,
-                                             bool include_first_twice = true) {
+inline std::vector<std::pair<int, int>> graham_scan(std::vector<std::pair<int, int>> points,
+                                                    bool include_first_twice = true) {
     // find the leftmost and downmost point
     std::pair<int, int> p0 = *min_element(
         points.begin(), points.end(), [](std::pair<int, int> a, std::pair<int, int> b) {
@@ -46,10 +55,12 @@ std::vector<std::pair<int, int>> graham_scan(std::vector<std::pair<int, int>> po
               [&](const std::pair<int, int> a, const std::pair<int, int> b) {
                   int ori = helpers::orientation(p0, a, b);
                   if (ori == 0) {
-                      return (p0.first - a.first) * (p0.first - a.first) +
-                                 (p0.second - a.second) * (p0.second - a.second) <
-                             (p0.first - b.first) * (p0.first - b.first) +
-                                 (p0.second - b.second) * (p0.second - b.second);
+                      // on the same ray the order of the distances is the order of |dx| + |dy|
+                      auto d = [&](const std::pair<int, int> q) {
+                          return std::abs(int64_t(q.first) - p0.first) +
+                                 std::abs(int64_t(q.second) - p0.second);
+                      };
+                      return d(a) < d(b);
                   }
                   return ori > 0;
               });
@@ -68,4 +79,401 @@ std::vector<std::pair<int, int>> graham_scan(std::vector<std::pair<int, int>> po
     return s;
 }
 
+/**
+ * @brief a point of the hull algorithms below, whose coordinates are in [-2^62, 2^62] so
+ * that every predicate is exact in 128 bit arithmetic
+ */
+using hull_point = std::pair<int64_t, int64_t>;
+
+namespace _convex_hull_utils {
+/**
+ * @brief the cross product of b - a and c - a, exact: > 0 if a, b, c turn counter
+ * clockwise, < 0 if they turn clockwise, 0 if they are collinear
+ */
+inline __int128 cross(const hull_point& a, const hull_point& b, const hull_point& c) {
+    return ((__int128)b.first - a.first) * ((__int128)c.second - a.second) -
+           ((__int128)b.second - a.second) * ((__int128)c.first - a.first);
+}
+
+// the L1 distance orders the collinear points on a ray from a
+inline __int128 reach(const hull_point& a, const hull_point& b) {
+    __int128 dx = (__int128)b.first - a.first, dy = (__int128)b.second - a.second;
+    return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
+
+/**
+ * @brief Andrew's monotone chain on points sorted by (x, y) without duplicates
+ */
+inline std::vector<hull_point> chain(std::span<const hull_point> p) {
+    size_t n = p.size();
+    if (n <= 2) {
+        return std::vector<hull_point>(p.begin(), p.end());
+    }
+    std::vector<hull_point> h(2 * n);
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        while (k >= 2 && cross(h[k - 2], h[k - 1], p[i]) <= 0) {
+            k--;
+        }
+        h[k++] = p[i];
+    }
+    for (size_t i = n - 1, lower = k + 1; i-- > 0;) {
+        while (k >= lower && cross(h[k - 2], h[k - 1], p[i]) <= 0) {
+            k--;
+        }
+        h[k++] = p[i];
+    }
+    h.resize(k - 1);
+    return h;
+}
+
+inline std::vector<hull_point> sorted_chain(std::vector<hull_point> p, size_t threads) {
+    PARALLEL::parallel_sort(p.begin(), p.end(), std::less<hull_point>(), threads);
+    p.erase(std::unique(p.begin(), p.end()), p.end());
+    return chain(p);
+}
+
+/**
+ * @brief the vertex q of the convex polygon h(counter clockwise, no collinear vertices)
+ * such that no vertex is to the right of p -> q, the farthest one if several, for p
+ * outside of h or one of its vertices. A binary search over the edges(Sunday) finds it for
+ * a point outside and a local walk settles the degenerate cases.
+ */
+inline size_t tangent(const std::vector<hull_point>& h, const hull_point& p) {
+    const size_t n = h.size();
+    if (n <= 2) {
+        size_t best = 0;
+        if (n == 2 && (h[0] == p || (h[1] != p && (cross(p, h[0], h[1]) < 0 ||
+                                                   (cross(p, h[0], h[1]) == 0 &&
+                                                    reach(p, h[1]) > reach(p, h[0])))))) {
+            best = 1;
+        }
+        return best;
+    }
+    auto at = [&](size_t i) -> const hull_point& { return h[i % n]; };
+    // the polygon on the left of p -> h[i] means h[i + 1] and h[i - 1] are not to its right
+    auto down = [&](size_t i, size_t j) { return cross(p, at(j), at(i)) < 0; };
+    auto up = [&](size_t i, size_t j) { return cross(p, at(j), at(i)) > 0; };
+    size_t c = 0;
+    if (!(down(0, 1) && !up(0, n - 1))) {
+        size_t a = 0, b = n;
+        for (int steps = 0; b - a > 1 && steps < 128; steps++) {
+            c = (a + b) / 2;
+            bool dn_c = down(c, c + 1);
+            if (dn_c && !up(c, c - 1)) {
+                break;
+            }
+            bool up_a = up(a, a + 1);
+            if (up_a) {
+                if (dn_c || up(c, a)) {
+                    b = c;
+                } else {
+                    a = c;
+                }
+            } else {
+                if (!dn_c) {
+                    a = c;
+                } else if (down(c, a)) {
+                    b = c;
+                } else {
+                    a = c;
+                }
+            }
+        }
+    }
+    // the walk: forward while the next vertex is to the right(or farther on the line),
+    // then backward while the previous one is to the right
+    for (size_t guard = 0; guard < 2 * n; guard++) {
+        const hull_point &q = at(c), &next = at(c + 1), &prev = at(c + n - 1);
+        __int128 f = cross(p, q, next), b = cross(p, q, prev);
+        if (q == p || f < 0 || (f == 0 && reach(p, next) > reach(p, q))) {
+            c = (c + 1) % n;
+        } else if (b < 0 || (b == 0 && prev != p && reach(p, prev) > reach(p, q))) {
+            c = (c + n - 1) % n;
+        } else {
+            break;
+        }
+    }
+    return c;
+}
+
+/**
+ * @brief the hull of the group hulls by Jarvis' march with one tangent per group, nothing
+ * if it has more than max_size vertices
+ */
+inline std::vector<hull_point> wrap(const std::vector<std::vector<hull_point>>& groups,
+                                    size_t max_size) {
+    hull_point start = groups[0][0];
+    for (const std::vector<hull_point>& g : groups) {
+        start = std::min(start, g[0]);
+    }
+    std::vector<hull_point> out = {start};
+    hull_point p = start;
+    while (out.size() <= max_size) {
+        hull_point best = p;
+        for (const std::vector<hull_point>& g : groups) {
+            const hull_point& q = g[tangent(g, p)];
+            if (q == p) {
+                continue;
+            }
+            __int128 turn = best == p ? -1 : cross(p, best, q);
+            if (turn < 0 || (turn == 0 && reach(p, q) > reach(p, best))) {
+                best = q;
+            }
+        }
+        if (best == start || best == p) {
+            return out;
+        }
+        out.push_back(best);
+        p = best;
+    }
+    return {};
+}
+
+/**
+ * @brief the vertices of the convex hull of the extreme points of the points in eight
+ * directions, or nothing if they are less than three
+ */
+inline std::vector<hull_point> octagon(std::span<const hull_point> points, size_t threads) {
+    // the extremes of x, y, x + y and x - y, both ways, of every part
+    threads = PARALLEL::resolve_threads(threads, points.size() / (1 << 16) + 1);
+    std::vector<std::array<hull_point, 8>> parts(threads);
+    std::vector<char> used(threads, 0);
+    auto better = [](const hull_point& a, const hull_point& b, int d) {
+        __int128 ka, kb;
+        switch (d / 2) {
+        case 0:
+            ka = a.first, kb = b.first;
+            break;
+        case 1:
+            ka = a.second, kb = b.second;
+            break;
+        case 2:
+            ka = (__int128)a.first + a.second, kb = (__int128)b.first + b.second;
+            break;
+        default:
+            ka = (__int128)a.first - a.second, kb = (__int128)b.first - b.second;
+        }
+        return d % 2 == 0 ? ka < kb : ka > kb;
+    };
+    PARALLEL::parallel_for(0, points.size(), threads, [&](size_t lo, size_t hi, size_t tid) {
+        std::array<hull_point, 8>& e = parts[tid];
+        e.fill(points[lo]);
+        for (size_t i = lo + 1; i < hi; i++) {
+            for (int d = 0; d < 8; d++) {
+                if (better(points[i], e[d], d)) {
+                    e[d] = points[i];
+                }
+            }
+        }
+        used[tid] = 1;
+    });
+    std::vector<hull_point> extremes;
+    for (size_t t = 0; t < threads; t++) {
+        if (used[t]) {
+            extremes.insert(extremes.end(), parts[t].begin(), parts[t].end());
+        }
+    }
+    std::sort(extremes.begin(), extremes.end());
+    extremes.erase(std::unique(extremes.begin(), extremes.end()), extremes.end());
+    std::vector<hull_point> h = chain(extremes);
+    return h.size() >= 3 ? h : std::vector<hull_point>();
+}
+} // namespace _convex_hull_utils
+
+/**
+ * @brief akl toussaint filter function
+ * The points strictly inside the convex polygon of the extreme points in eight directions
+ * (x, y, x + y and x - y, both ways) are not on the hull. On spread out inputs that drops
+ * most of them in one pass, before any sort.
+ * @param points the points
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return std::vector<hull_point> the points that can be on the hull, in their order.
+ */
+inline std::vector<hull_point> akl_toussaint_filter(std::span<const hull_point> points,
+                                                    size_t threads = 1) {
+    namespace utils = _convex_hull_utils;
+    std::vector<hull_point> oct = utils::octagon(points, threads);
+    if (oct.empty()) {
+        return std::vector<hull_point>(points.begin(), points.end());
+    }
+    threads = PARALLEL::resolve_threads(threads, points.size() / (1 << 16) + 1);
+    std::vector<std::vector<hull_point>> parts(threads);
+    PARALLEL::parallel_for(0, points.size(), threads, [&](size_t lo, size_t hi, size_t tid) {
+        for (size_t i = lo; i < hi; i++) {
+            bool inside = true;
+            for (size_t k = 0; k < oct.size() && inside; k++) {
+                inside = utils::cross(oct[k], oct[(k + 1) % oct.size()], points[i]) > 0;
+            }
+            if (!inside) {
+                parts[tid].push_back(points[i]);
+            }
+        }
+    });
+    std::vector<hull_point> out;
+    for (const std::vector<hull_point>& part : parts) {
+        out.insert(out.end(), part.begin(), part.end());
+    }
+    return out;
+}
+
+/**
+ * @brief monotone chain function(Andrew)
+ * The points are sorted by (x, y), on several threads, and the lower and the upper hull
+ * are built by one scan each, in O(n log(n)).
+ * @param points the points
+ * @param threads number of threads of the sort(0 means every hardware thread). Default = 1
+ * @return std::vector<hull_point> the vertices of the convex hull counter clockwise from
+ * the smallest (x, y), without collinear points or repeats.
+ */
+inline std::vector<hull_point> monotone_chain(std::span<const hull_point> points,
+                                              size_t threads = 1) {
+    return _convex_hull_utils::sorted_chain(std::vector<hull_point>(points.begin(), points.end()),
+                                            threads);
+}
+
+/**
+ * @brief chan hull function(Chan 1996)
+ * The points are cut in groups of m, the hull of every group is built by the monotone
+ * chain(on several threads) and Jarvis' march wraps the groups with a binary search for
+ * the tangent of every group, stopping after m vertices, with m = 2^(2^t) for t = 1, 2,
+ * ... until the hull closes, so it takes O(n log(h)) for a hull of h vertices.
+ * @param points the points
+ * @param threads number of threads of the group hulls(0 means every hardware thread).
+ * Default = 1
+ * @return std::vector<hull_point> the vertices of the convex hull counter clockwise from
+ * the smallest (x, y), without collinear points or repeats, the same as monotone_chain.
+ */
+inline std::vector<hull_point> chan_hull(std::span<const hull_point> points, size_t threads = 1) {
+    namespace utils = _convex_hull_utils;
+    const size_t n = points.size();
+    if (n == 0) {
+        return {};
+    }
+    for (unsigned t = 1;; t++) {
+        size_t m = t >= 6 ? n : std::min(n, size_t(1) << (size_t(1) << t));
+        size_t count = (n + m - 1) / m;
+        std::vector<std::vector<hull_point>> groups(count);
+        PARALLEL::parallel_for_dynamic(0, count, threads, [&](size_t g, size_t) {
+            std::span<const hull_point> part = points.subspan(g * m, std::min(m, n - g * m));
+            groups[g] = utils::sorted_chain(std::vector<hull_point>(part.begin(), part.end()), 1);
+        });
+        std::vector<hull_point> h = utils::wrap(groups, m);
+        if (!h.empty()) {
+            return h;
+        }
+    }
+}
+
+/**
+ * @brief convex hull function
+ * akl_toussaint_filter and then monotone_chain on the points left, the fastest way for
+ * large inputs.
+ * @param points the points
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return std::vector<hull_point> the vertices of the convex hull counter clockwise from
+ * the smallest (x, y), without collinear points or repeats.
+ */
+inline std::vector<hull_point> convex_hull(std::span<const hull_point> points,
+                                           size_t threads = 1) {
+    return _convex_hull_utils::sorted_chain(akl_toussaint_filter(points, threads), threads);
+}
+
+/**
+ * @brief online hull class
+ * Convex hull of a stream of points: the lower and the upper hull are kept in ordered maps
+ * from x to y, a new point outside is inserted and its neighbours that are no longer on the
+ * hull are erased, so an insertion costs O(log(h)) amortized and the memory is O(h).
+ */
+class online_hull {
+  public:
+    /**
+     * @brief insert function
+     * @param p the new point
+     * @return true if p is now a vertex of the hull
+     */
+    bool insert(const hull_point& p) {
+        bool lower = _insert(_lower, p.first, p.second);
+        bool upper = _insert(_upper, p.first, -p.second);
+        if (lower || upper) {
+            _count++;
+        }
+        return lower || upper;
+    }
+
+    /**
+     * @brief contains function
+     * @param p a point
+     * @return true if p is inside the hull or on its boundary
+     */
+    bool contains(const hull_point& p) const {
+        return _above(_lower, p.first, p.second) && _above(_upper, p.first, -p.second);
+    }
+
+    /**
+     * @brief empty function
+     * @return true if no point was inserted
+     */
+    bool empty() const { return _lower.empty(); }
+
+    /**
+     * @brief hull function
+     * @return std::vector<hull_point> the vertices of the hull counter clockwise from the
+     * smallest (x, y), without collinear points or repeats, as monotone_chain.
+     */
+    std::vector<hull_point> hull() const {
+        std::vector<hull_point> out;
+        for (auto [x, y] : _lower) {
+            out.push_back({x, y});
+        }
+        for (auto it = _upper.rbegin(); it != _upper.rend(); ++it) {
+            hull_point q = {it->first, -it->second};
+            if (q != out.back() && q != out.front()) {
+                out.push_back(q);
+            }
+        }
+        return out;
+    }
+
+  private:
+    // the lower hull of the points and the lower hull of their mirror images(x, -y)
+    std::map<int64_t, int64_t> _lower;
+    std::map<int64_t, int64_t> _upper;
+    size_t _count{0};
+
+    using chain_t = std::map<int64_t, int64_t>;
+
+    // true if (x, y) is above or on the lower chain h
+    static bool _above(const chain_t& h, int64_t x, int64_t y) {
+        if (h.empty() || x < h.begin()->first || x > h.rbegin()->first) {
+            return false;
+        }
+        auto r = h.lower_bound(x);
+        if (r->first == x) {
+            return y >= r->second;
+        }
+        auto l = std::prev(r);
+        return _convex_hull_utils::cross({l->first, l->second}, {r->first, r->second}, {x, y}) >= 0;
+    }
+
+    static bool _insert(chain_t& h, int64_t x, int64_t y) {
+        using _convex_hull_utils::cross;
+        if (_above(h, x, y)) {
+            return false;
+        }
+        auto it = h.insert_or_assign(x, y).first;
+        auto point = [](chain_t::const_iterator i) { return hull_point{i->first, i->second}; };
+        // the vertices to the right that now lie above the segment from the new one
+        while (std::next(it) != h.end() && std::next(std::next(it)) != h.end() &&
+               cross(point(it), point(std::next(it)), point(std::next(std::next(it)))) <= 0) {
+            h.erase(std::next(it));
+        }
+        while (it != h.begin() && std::prev(it) != h.begin() &&
+               cross(point(std::prev(std::prev(it))), point(std::prev(it)), point(it)) <= 0) {
+            h.erase(std::prev(it));
+        }
+        return true;
+    }
+};
+
 #endif
@@ -0,0 +1,208 @@
+#ifndef BIG_UINT_H
+#define BIG_UINT_H
+
+#include "multiply.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+/**
+ * @brief big uint class
+ * Arbitrary precision unsigned integer, stored as limbs in base 2^32 with the least
+ * significant first and no leading zero limb(0 has no limb). The products go through
+ * multiply_limbs.
+ */
+class big_uint {
+  public:
+    /**
+     * @brief Construct a new big uint object
+     * @param v: the value. Default = 0
+     */
+    big_uint(uint64_t v = 0) {
+        for (; v != 0; v >>= 32) {
+            _limbs.push_back(uint32_t(v));
+        }
+    }
+
+    /**
+     * @brief Construct a new big uint object from its decimal digits
+     * @param decimal: the digits, at least one.
+     * Throws std::invalid_argument if decimal is empty or has a character that is not a
+     * digit.
+     */
+    explicit big_uint(std::string_view decimal) {
+        if (decimal.empty()) {
+            throw std::invalid_argument("big_uint: no digits");
+        }
+        for (char c : decimal) {
+            if (c < '0' || c > '9') {
+                throw std::invalid_argument("big_uint: not a digit");
+            }
+            _mul_add(10, uint32_t(c - '0'));
+        }
+    }
+
+    /**
+     * @brief limbs function
+     * @return std::span<const uint32_t> the limbs, the least significant first.
+     */
+    std::span<const uint32_t> limbs() const { return _limbs; }
+
+    /**
+     * @brief bits function
+     * @return size_t the number of bits of the value, 0 for 0.
+     */
+    size_t bits() const {
+        return _limbs.empty() ? 0
+                              : 32 * _limbs.size() - size_t(std::countl_zero(_limbs.back()));
+    }
+
+    /**
+     * @brief to_string function
+     * @return std::string the decimal digits of the value.
+     */
+    std::string to_string() const {
+        if (_limbs.empty()) {
+            return "0";
+        }
+        // repeated division by 10^9, the remainders are 9 digits each
+        std::vector<uint32_t> q = _limbs;
+        std::vector<uint32_t> chunks;
+        while (!q.empty()) {
+            uint64_t r = 0;
+            for (size_t i = q.size(); i-- > 0;) {
+                uint64_t cur = (r << 32) | q[i];
+                q[i] = uint32_t(cur / 1000000000);
+                r = cur % 1000000000;
+            }
+            chunks.push_back(uint32_t(r));
+            while (!q.empty() && q.back() == 0) {
+                q.pop_back();
+            }
+        }
+        std::string s = std::to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            std::string part = std::to_string(chunks[i]);
+            s.append(9 - part.size(), '0');
+            s += part;
+        }
+        return s;
+    }
+
+    big_uint& operator+=(const big_uint& o) {
+        _limbs.resize(std::max(_limbs.size(), o._limbs.size()) + 1, 0);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < _limbs.size(); i++) {
+            uint64_t t = uint64_t(_limbs[i]) + (i < o._limbs.size() ? o._limbs[i] : 0) + carry;
+            _limbs[i] = uint32_t(t);
+            carry = t >> 32;
+            if (carry == 0 && i >= o._limbs.size()) {
+                break;
+            }
+        }
+        _trim();
+        return *this;
+    }
+
+    /**
+     * @brief operator -=
+     * Throws std::underflow_error if o is larger.
+     */
+    big_uint& operator-=(const big_uint& o) {
+        if (*this < o) {
+            throw std::underflow_error("big_uint: negative difference");
+        }
+        int64_t borrow = 0;
+        for (size_t i = 0; i < _limbs.size(); i++) {
+            int64_t t = int64_t(_limbs[i]) - (i < o._limbs.size() ? o._limbs[i] : 0) - borrow;
+            borrow = t < 0;
+            _limbs[i] = uint32_t(t + (borrow << 32));
+            if (borrow == 0 && i >= o._limbs.size()) {
+                break;
+            }
+        }
+        _trim();
+        return *this;
+    }
+
+    big_uint& operator*=(const big_uint& o) {
+        _limbs = multiply_limbs(_limbs, o._limbs);
+        _trim();
+        return *this;
+    }
+
+    big_uint& operator<<=(size_t shift) {
+        if (_limbs.empty()) {
+            return *this;
+        }
+        size_t words = shift / 32, r = shift % 32;
+        _limbs.resize(_limbs.size() + words + 1, 0);
+        for (size_t i = _limbs.size(); i-- > 0;) {
+            uint64_t hi = i >= words ? uint64_t(_limbs[i - words]) << r : 0;
+            uint64_t lo = r != 0 && i >= words + 1 ? _limbs[i - words - 1] >> (32 - r) : 0;
+            _limbs[i] = uint32_t(hi | lo);
+        }
+        _trim();
+        return *this;
+    }
+
+    friend big_uint operator+(big_uint a, const big_uint& b) { return a += b; }
+    friend big_uint operator-(big_uint a, const big_uint& b) { return a -= b; }
+    friend big_uint operator*(const big_uint& a, const big_uint& b) {
+        big_uint c;
+        c._limbs = multiply_limbs(a._limbs, b._limbs);
+        c._trim();
+        return c;
+    }
+    friend big_uint operator<<(big_uint a, size_t shift) { return a <<= shift; }
+
+    friend bool operator==(const big_uint& a, const big_uint& b) = default;
+    friend std::strong_ordering operator<=>(const big_uint& a, const big_uint& b) {
+        if (a._limbs.size() != b._limbs.size()) {
+            return a._limbs.size() <=> b._limbs.size();
+        }
+        for (size_t i = a._limbs.size(); i-- > 0;) {
+            if (a._limbs[i] != b._limbs[i]) {
+                return a._limbs[i] <=> b._limbs[i];
+            }
+        }
+        return std::strong_ordering::equal;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const big_uint& v) {
+        return out << v.to_string();
+    }
+
+  private:
+    std::vector<uint32_t> _limbs;
+
+    void _trim() {
+        while (!_limbs.empty() && _limbs.back() == 0) {
+            _limbs.pop_back();
+        }
+    }
+
+    void _mul_add(uint32_t m, uint32_t a) {
+        uint64_t carry = a;
+        for (uint32_t& limb : _limbs) {
+            uint64_t t = uint64_t(limb) * m + carry;
+            limb = uint32_t(t);
+            carry = t >> 32;
+        }
+        if (carry != 0) {
+            _limbs.push_back(uint32_t(carry));
+        }
+    }
+};
+
+#endif
@@ -1,29 +1,429 @@
 #pragma once
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
-/*
- * @brief mul: multiplies two 2D vectors
- * @brief x: The first passed 2D vector
- * @brief y: the second passed 2D vector
- * @return: A 2d vector with x.size() x y[0].size() dimensions
+namespace _gemm_utils {
+// the register tile of the micro kernel and the blocks of A(mc x kc) and B(kc x nc) that
+// stay in L2 and L3 once packed
+constexpr size_t tile_rows = 4;
+constexpr size_t tile_cols = 16;
+constexpr size_t mc = 64;
+constexpr size_t kc = 256;
+constexpr size_t nc = 2048;
+
+/**
+ * @brief packs the rows [i0, i0 + rows) and columns [k0, k0 + depth) of A(lda columns)
+ * in panels of tile_rows rows, column after column, padded with zeros
+ */
+template <typename T>
+void pack_a(const T* a, size_t lda, size_t i0, size_t rows, size_t k0, size_t depth, T* out) {
+    for (size_t r = 0; r < rows; r += tile_rows) {
+        for (size_t k = 0; k < depth; k++) {
+            for (size_t t = 0; t < tile_rows; t++) {
+                *out++ = r + t < rows ? a[(i0 + r + t) * lda + k0 + k] : T(0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief packs the rows [k0, k0 + depth) and columns [j0, j0 + cols) of B(ldb columns) in
+ * panels of tile_cols columns, row after row, padded with zeros
+ */
+template <typename T>
+void pack_b(const T* b, size_t ldb, size_t k0, size_t depth, size_t j0, size_t cols, T* out) {
+    for (size_t c = 0; c < cols; c += tile_cols) {
+        for (size_t k = 0; k < depth; k++) {
+            const T* row = b + (k0 + k) * ldb + j0 + c;
+            for (size_t t = 0; t < tile_cols; t++) {
+                *out++ = c + t < cols ? row[t] : T(0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief C[rows x cols] += the product of a packed A panel and a packed B panel, the
+ * tile_rows x tile_cols accumulators are registers
+ */
+template <typename T>
+void micro_kernel(const T* a, const T* b, size_t depth, T* c, size_t ldc, size_t rows,
+                  size_t cols) {
+    T acc[tile_rows][tile_cols] = {};
+    for (size_t k = 0; k < depth; k++) {
+        const T* bk = b + k * tile_cols;
+#pragma GCC unroll 8
+        for (size_t r = 0; r < tile_rows; r++) {
+            T x = a[k * tile_rows + r];
+#pragma GCC unroll 16
+            for (size_t t = 0; t < tile_cols; t++) {
+                acc[r][t] += x * bk[t];
+            }
+        }
+    }
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t t = 0; t < cols; t++) {
+            c[r * ldc + t] += acc[r][t];
+        }
+    }
+}
+
+/**
+ * @brief C(n x p) += A(n x m) B(m x p), all row major and contiguous(Goto): for every
+ * block of B, packed once and shared, the blocks of rows of A are packed and multiplied on
+ * several threads, every thread writes its own rows of C.
+ */
+template <typename T>
+void gemm(const T* a, const T* b, T* c, size_t n, size_t m, size_t p, size_t threads) {
+    if (n == 0 || m == 0 || p == 0) {
+        return;
+    }
+    const size_t row_blocks = (n + mc - 1) / mc;
+    threads = PARALLEL::resolve_threads(threads, row_blocks);
+    std::vector<T> packed_b(kc * ((std::min(nc, p) + tile_cols - 1) / tile_cols * tile_cols));
+    std::vector<std::vector<T>> packed_a(threads, std::vector<T>(mc * kc));
+    for (size_t j0 = 0; j0 < p; j0 += nc) {
+        size_t cols = std::min(nc, p - j0);
+        for (size_t k0 = 0; k0 < m; k0 += kc) {
+            size_t depth = std::min(kc, m - k0);
+            pack_b(b, p, k0, depth, j0, cols, packed_b.data());
+            PARALLEL::parallel_for(0, row_blocks, threads, [&](size_t lo, size_t hi, size_t tid) {
+                T* pa = packed_a[tid].data();
+                for (size_t blk = lo; blk < hi; blk++) {
+                    size_t i0 = blk * mc, rows = std::min(mc, n - i0);
+                    pack_a(a, m, i0, rows, k0, depth, pa);
+                    for (size_t jc = 0; jc < cols; jc += tile_cols) {
+                        const T* pb = packed_b.data() + jc * depth;
+                        for (size_t ic = 0; ic < rows; ic += tile_rows) {
+                            micro_kernel(pa + ic * depth, pb, depth, c + (i0 + ic) * p + j0 + jc,
+                                         p, std::min(tile_rows, rows - ic),
+                                         std::min(tile_cols, cols - jc));
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+} // namespace _gemm_utils
+
+/**
+ * @brief multiply function: the product of two matrices, as a blocked GEMM(see
+ * _gemm_utils::gemm) on contiguous copies of them
+ * @param x: the first matrix, n x m
+ * @param y: the second matrix, m x p
+ * @param threads: number of threads(0 means every hardware thread). Default = 1
+ * @return std::vector<std::vector<T>> x y, n x p
  */
 template <typename T>
 std::vector<std::vector<T>> multiply(std::vector<std::vector<T>> const& x,
-                                     std::vector<std::vector<T>> const& y) {
-    assert(x[0].size() == y.size());
-    std::vector<std::vector<T>> out(x.size(), std::vector<T>(y[0].size()));
-
-    for (size_t i = 0; i < x.size(); i++) {
-        for (size_t j = 0; j < y[0].size(); j++) {
-            for (size_t k = 0; k < x[0].size(); k++) {
-                out[i][j] = x[i][k] * y[k][j];
+                                     std::vector<std::vector<T>> const& y, size_t threads = 1) {
+    assert(!x.empty() && x[0].size() == y.size());
+    size_t n = x.size(), m = y.size(), p = m == 0 ? 0 : y[0].size();
+    std::vector<T> a(n * m), b(m * p), c(n * p, T(0));
+    for (size_t i = 0; i < n; i++) {
+        std::copy(x[i].begin(), x[i].end(), a.begin() + i * m);
+    }
+    for (size_t k = 0; k < m; k++) {
+        std::copy(y[k].begin(), y[k].end(), b.begin() + k * p);
+    }
+    _gemm_utils::gemm(a.data(), b.data(), c.data(), n, m, p, threads);
+    std::vector<std::vector<T>> out(n);
+    for (size_t i = 0; i < n; i++) {
+        out[i].assign(c.begin() + i * p, c.begin() + (i + 1) * p);
+    }
+    return out;
+}
+
+namespace _multiply_utils {
+// below this many limbs in the shorter operand the schoolbook product is faster
+constexpr size_t karatsuba_threshold = 32;
+// from this many limbs in the shorter operand the NTT product is faster than Karatsuba
+constexpr size_t ntt_threshold = 1024;
+// the largest NTT of the three primes, so a product of at most 2^23 limbs
+constexpr size_t ntt_max_length = size_t(1) << 23;
+
+template <uint32_t P> constexpr uint32_t pow_mod(uint32_t a, uint64_t e) {
+    uint64_t r = 1, x = a;
+    for (; e != 0; e >>= 1) {
+        if (e & 1) {
+            r = r * x % P;
+        }
+        x = x * x % P;
+    }
+    return uint32_t(r);
+}
+
+/**
+ * @brief number theoretic transform modulo the prime P with the primitive root G, in
+ * place, a.size() a power of two at most 2^23(every P here is c 2^23 + 1 or more)
+ */
+template <uint32_t P, uint32_t G> void ntt(std::vector<uint32_t>& a, bool inverse) {
+    const size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+    // roots[k] = w^k for the root w of order n, the smaller levels take every n / len one
+    std::vector<uint32_t> roots(std::max<size_t>(1, n / 2));
+    uint32_t w = pow_mod<P>(G, (P - 1) / n);
+    if (inverse) {
+        w = pow_mod<P>(w, P - 2);
+    }
+    roots[0] = 1;
+    for (size_t k = 1; k < roots.size(); k++) {
+        roots[k] = uint32_t(uint64_t(roots[k - 1]) * w % P);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2, stride = n / len;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t k = 0; k < half; k++) {
+                uint32_t u = a[i + k];
+                uint32_t v = uint32_t(uint64_t(a[i + k + half]) * roots[k * stride] % P);
+                a[i + k] = u + v >= P ? u + v - P : u + v;
+                a[i + k + half] = u >= v ? u - v : u + P - v;
             }
         }
     }
+    if (inverse) {
+        uint64_t inv_n = pow_mod<P>(uint32_t(n), P - 2);
+        for (uint32_t& x : a) {
+            x = uint32_t(x * inv_n % P);
+        }
+    }
+}
+
+/**
+ * @brief the cyclic convolution of a and b modulo P, of length n(a power of two)
+ */
+template <uint32_t P, uint32_t G>
+std::vector<uint32_t> convolve(std::span<const uint32_t> a, std::span<const uint32_t> b,
+                               size_t n) {
+    std::vector<uint32_t> fa(n, 0), fb(n, 0);
+    for (size_t i = 0; i < a.size(); i++) {
+        fa[i] = a[i] % P;
+    }
+    for (size_t i = 0; i < b.size(); i++) {
+        fb[i] = b[i] % P;
+    }
+    ntt<P, G>(fa, false);
+    ntt<P, G>(fb, false);
+    for (size_t i = 0; i < n; i++) {
+        fa[i] = uint32_t(uint64_t(fa[i]) * fb[i] % P);
+    }
+    ntt<P, G>(fa, true);
+    return fa;
+}
+
+constexpr uint32_t p1 = 998244353, p2 = 167772161, p3 = 469762049;
+
+/**
+ * @brief out[0, a.size() + b.size()) = a * b by NTT: every coefficient of the product of
+ * the limbs as polynomials is below min(|a|, |b|) 2^64 <= 2^86, so it is found exactly
+ * from its residues modulo three primes whose product is above 2^86(Garner), and the
+ * coefficients are added together with their carries.
+ */
+inline void ntt_product(std::span<const uint32_t> a, std::span<const uint32_t> b, uint32_t* out) {
+    size_t len = a.size() + b.size() - 1, n = 1;
+    while (n < len) {
+        n <<= 1;
+    }
+    std::vector<uint32_t> r1 = convolve<p1, 3>(a, b, n);
+    std::vector<uint32_t> r2 = convolve<p2, 3>(a, b, n);
+    std::vector<uint32_t> r3 = convolve<p3, 3>(a, b, n);
+    constexpr uint64_t inv_p1_mod_p2 = pow_mod<p2>(p1 % p2, p2 - 2);
+    constexpr uint64_t p1p2_mod_p3 = uint64_t(p1) * p2 % p3;
+    constexpr uint64_t inv_p1p2_mod_p3 = pow_mod<p3>(uint32_t(p1p2_mod_p3), p3 - 2);
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < a.size() + b.size(); i++) {
+        unsigned __int128 cur = carry;
+        if (i < len) {
+            // x = r1 + p1 t2 + p1 p2 t3
+            uint64_t t2 = (uint64_t(r2[i]) + p2 - r1[i] % p2) % p2 * inv_p1_mod_p2 % p2;
+            uint64_t x12 = r1[i] + uint64_t(p1) * t2;
+            uint64_t t3 = (uint64_t(r3[i]) + p3 - x12 % p3) % p3 * inv_p1p2_mod_p3 % p3;
+            cur += x12 + (unsigned __int128)(uint64_t(p1) * p2) * t3;
+        }
+        out[i] = uint32_t(cur);
+        carry = cur >> 32;
+    }
+}
+
+// out[0, a.size() + b.size()) = a * b, out starts zeroed
+inline void schoolbook(std::span<const uint32_t> a, std::span<const uint32_t> b, uint32_t* out) {
+    for (size_t i = 0; i < a.size(); i++) {
+        uint64_t carry = 0, x = a[i];
+        if (x == 0) {
+            continue;
+        }
+        for (size_t j = 0; j < b.size(); j++) {
+            // at most (2^32 - 1)^2 + 2 (2^32 - 1) < 2^64
+            uint64_t t = x * b[j] + out[i + j] + carry;
+            out[i + j] = uint32_t(t);
+            carry = t >> 32;
+        }
+        out[i + b.size()] = uint32_t(carry);
+    }
+}
+
+// out += x, the carry runs into out[x.size(), n)
+inline void add_into(uint32_t* out, size_t n, std::span<const uint32_t> x) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < x.size(); i++) {
+        uint64_t t = uint64_t(out[i]) + x[i] + carry;
+        out[i] = uint32_t(t);
+        carry = t >> 32;
+    }
+    for (; carry != 0 && i < n; i++) {
+        uint64_t t = uint64_t(out[i]) + carry;
+        out[i] = uint32_t(t);
+        carry = t >> 32;
+    }
+}
+
+// out -= x, out >= x
+inline void sub_into(std::vector<uint32_t>& out, std::span<const uint32_t> x) {
+    int64_t borrow = 0;
+    size_t i = 0;
+    for (; i < x.size(); i++) {
+        int64_t t = int64_t(out[i]) - x[i] - borrow;
+        borrow = t < 0;
+        out[i] = uint32_t(t + (borrow << 32));
+    }
+    for (; borrow != 0 && i < out.size(); i++) {
+        int64_t t = int64_t(out[i]) - borrow;
+        borrow = t < 0;
+        out[i] = uint32_t(t + (borrow << 32));
+    }
+}
 
+inline std::vector<uint32_t> sum(std::span<const uint32_t> a, std::span<const uint32_t> b) {
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+    }
+    std::vector<uint32_t> out(a.begin(), a.end());
+    out.push_back(0);
+    add_into(out.data(), out.size(), b);
+    return out;
+}
+
+// out[0, a.size() + b.size()) = a * b, out starts zeroed
+inline void karatsuba(std::span<const uint32_t> a, std::span<const uint32_t> b, uint32_t* out) {
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+    }
+    if (b.size() < karatsuba_threshold) {
+        schoolbook(a, b, out);
+        return;
+    }
+    if (b.size() >= ntt_threshold && a.size() + b.size() <= ntt_max_length) {
+        ntt_product(a, b, out);
+        return;
+    }
+    if (2 * b.size() <= a.size()) {
+        // unbalanced: a is cut in pieces of the size of b
+        std::vector<uint32_t> part(2 * b.size());
+        for (size_t i = 0; i < a.size(); i += b.size()) {
+            std::span<const uint32_t> piece = a.subspan(i, std::min(b.size(), a.size() - i));
+            std::fill(part.begin(), part.end(), 0);
+            karatsuba(piece, b, part.data());
+            add_into(out + i, a.size() + b.size() - i,
+                     std::span<const uint32_t>(part.data(), piece.size() + b.size()));
+        }
+        return;
+    }
+    // a = a1 B^m + a0, b = b1 B^m + b0, b.size() > m
+    size_t m = a.size() / 2;
+    std::span<const uint32_t> a0 = a.first(m), a1 = a.subspan(m), b0 = b.first(m),
+                              b1 = b.subspan(m);
+    std::vector<uint32_t> z0(2 * m, 0), z2(a1.size() + b1.size(), 0);
+    karatsuba(a0, b0, z0.data());
+    karatsuba(a1, b1, z2.data());
+    std::vector<uint32_t> sa = sum(a0, a1), sb = sum(b0, b1);
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    std::vector<uint32_t> z1(sa.size() + sb.size(), 0);
+    karatsuba(sa, sb, z1.data());
+    sub_into(z1, z0);
+    sub_into(z1, z2);
+    while (!z1.empty() && z1.back() == 0) {
+        z1.pop_back();
+    }
+    size_t n = a.size() + b.size();
+    add_into(out, n, z0);
+    add_into(out + m, n - m, z1);
+    add_into(out + 2 * m, n - 2 * m, z2);
+}
+} // namespace _multiply_utils
+
+/**
+ * @brief multiply limbs function: the product of two unsigned integers in base 2^32, by
+ * the schoolbook product while one of them has less than 32 limbs, by Karatsuba,
+ * O(n^1.585), while one has less than 1024 and by NTT over three primes, O(n log(n)),
+ * above that
+ * @param a: the limbs of the first integer, the least significant first
+ * @param b: the limbs of the second integer, the least significant first
+ * @return std::vector<uint32_t> the a.size() + b.size() limbs of the product, the least
+ * significant first(the most significant may be 0)
+ */
+inline std::vector<uint32_t> multiply_limbs(std::span<const uint32_t> a,
+                                            std::span<const uint32_t> b) {
+    std::vector<uint32_t> out(a.size() + b.size(), 0);
+    _multiply_utils::karatsuba(a, b, out.data());
+    return out;
+}
+
+/**
+ * @brief multiply polynomials modulo 998244353 function
+ * @param a: the coefficients of the first polynomial, the constant first
+ * @param b: the coefficients of the second polynomial, the constant first
+ * @return std::vector<uint32_t> the a.size() + b.size() - 1 coefficients of the product
+ * modulo 998244353(none if a or b is empty), by the schoolbook product for small
+ * polynomials and by NTT for the others.
+ * Throws std::length_error if the product has more than 2^23 coefficients.
+ */
+inline std::vector<uint32_t> multiply_polynomials_mod(std::span<const uint32_t> a,
+                                                      std::span<const uint32_t> b) {
+    namespace utils = _multiply_utils;
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    size_t len = a.size() + b.size() - 1;
+    if (len > utils::ntt_max_length) {
+        throw std::length_error("multiply_polynomials_mod: the product is too long");
+    }
+    if (std::min(a.size(), b.size()) < 64) {
+        std::vector<uint64_t> acc(len, 0);
+        for (size_t i = 0; i < a.size(); i++) {
+            for (size_t j = 0; j < b.size(); j++) {
+                acc[i + j] = (acc[i + j] + uint64_t(a[i] % utils::p1) * (b[j] % utils::p1)) %
+                             utils::p1;
+            }
+        }
+        return std::vector<uint32_t>(acc.begin(), acc.end());
+    }
+    size_t n = 1;
+    while (n < len) {
+        n <<= 1;
+    }
+    std::vector<uint32_t> out = utils::convolve<utils::p1, 3>(a, b, n);
+    out.resize(len);
     return out;
 }
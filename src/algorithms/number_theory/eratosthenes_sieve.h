@@ -1,9 +1,19 @@
 #ifndef ERATOSTHENES_SIEVE_H
 #define ERATOSTHENES_SIEVE_H
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <array>
 #include <assert.h>
+#include <bit>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
@@ -13,9 +23,11 @@
  * @param n upper bound
  * @return std::vector<bool> if arr[i] = 1 then i is prime
  */
-std::vector<bool> soe(int64_t n) {
+inline std::vector<bool> soe(int64_t n) {
     assert(n != 0);
     std::vector<bool> prime(n + 1, true);
+    prime[0] = false;
+    prime[1] = false;
     for (int64_t p = 2; p * p <= n; ++p) {
         if (prime[p]) {
             for (int64_t i = p * p; i <= n; i += p) {
@@ -26,4 +38,375 @@ std::vector<bool> soe(int64_t n) {
     return prime;
 }
 
+namespace _eratosthenes_sieve_utils {
+// a segment holds 2^18 odd numbers in 32 KiB, the size of a L1 data cache
+constexpr uint64_t segment_bits = uint64_t(1) << 18;
+constexpr uint64_t segment_words = segment_bits / 64;
+// the ranges end at most here, so that p * p and the offsets do not overflow
+constexpr uint64_t max_bound = uint64_t(1) << 62;
+
+inline uint64_t isqrt(uint64_t n) {
+    uint64_t r = uint64_t(std::sqrt(double(n)));
+    while (r * r > n) {
+        r--;
+    }
+    while ((r + 1) * (r + 1) <= n) {
+        r++;
+    }
+    return r;
+}
+
+/**
+ * @brief the odd primes p with p * p < hi, by a plain odd only sieve
+ */
+inline std::vector<uint32_t> base_primes(uint64_t hi) {
+    uint64_t limit = hi > 0 ? isqrt(hi - 1) : 0;
+    std::vector<uint32_t> primes;
+    if (limit < 3) {
+        return primes;
+    }
+    // composite[k] for 2k + 1
+    std::vector<char> composite(limit / 2 + 1, 0);
+    for (uint64_t k = 1; k <= limit / 2; k++) {
+        if (composite[k]) {
+            continue;
+        }
+        uint64_t p = 2 * k + 1;
+        primes.push_back(uint32_t(p));
+        for (uint64_t j = p * p / 2; j <= limit / 2; j += p) {
+            composite[j] = 1;
+        }
+    }
+    return primes;
+}
+
+/**
+ * @brief segmented sieve walker: the odd numbers of [lo, hi) are sieved one segment at a
+ * time, bit k of a segment is its first number plus 2k. The primes below the segment size
+ * keep the offset of their next multiple from one segment to the next, the larger ones hit
+ * a segment at most once and wait in a ring of buckets, one per segment ahead(Oliveira e
+ * Silva), so a segment costs its multiples, not the number of base primes.
+ */
+class walker {
+  public:
+    walker(uint64_t lo, uint64_t hi, const std::vector<uint32_t>& primes)
+        : _base(std::max<uint64_t>(lo, 1) | 1), _hi(hi), _primes(primes) {
+        _small = size_t(std::lower_bound(_primes.begin(), _primes.end(), uint32_t(segment_bits)) -
+                        _primes.begin());
+        _offsets.resize(_small);
+        for (size_t i = 0; i < _small; i++) {
+            _offsets[i] = _first_offset(_primes[i]);
+        }
+        _next_large = _small;
+        uint64_t largest = _primes.empty() ? 0 : _primes.back();
+        _ring.resize(largest / segment_bits + 2);
+    }
+
+    /**
+     * @brief sieves the next segment into words(segment_words words)
+     * @return the number of numbers of the segment(0 once the range is done), its first
+     * number is base.
+     */
+    uint64_t next(std::vector<uint64_t>& words, uint64_t& base) {
+        if (_base >= _hi) {
+            return 0;
+        }
+        base = _base;
+        uint64_t bits = std::min(segment_bits, (_hi - _base + 1) / 2);
+        words.assign(segment_words, ~uint64_t(0));
+        if (bits < segment_bits) {
+            for (uint64_t k = bits; k < segment_bits; k++) {
+                words[k / 64] &= ~(uint64_t(1) << (k % 64));
+            }
+        }
+        if (_base == 1) {
+            words[0] &= ~uint64_t(1);
+        }
+        for (size_t i = 0; i < _small; i++) {
+            uint64_t k = _offsets[i];
+            for (uint64_t p = _primes[i]; k < segment_bits; k += p) {
+                words[k / 64] &= ~(uint64_t(1) << (k % 64));
+            }
+            _offsets[i] = k - segment_bits;
+        }
+        // the large primes whose square is in this segment join the ring
+        uint64_t end = _base + 2 * segment_bits;
+        for (; _next_large < _primes.size() &&
+               uint64_t(_primes[_next_large]) * _primes[_next_large] < end;
+             _next_large++) {
+            uint32_t p = _primes[_next_large];
+            uint64_t k = _first_offset(p);
+            _ring[(_segment + k / segment_bits) % _ring.size()].push_back(
+                {p, uint32_t(k % segment_bits)});
+        }
+        std::vector<std::pair<uint32_t, uint32_t>>& bucket = _ring[_segment % _ring.size()];
+        for (auto [p, k] : bucket) {
+            words[k / 64] &= ~(uint64_t(1) << (k % 64));
+            uint64_t next = uint64_t(k) + p;
+            _ring[(_segment + next / segment_bits) % _ring.size()].push_back(
+                {p, uint32_t(next % segment_bits)});
+        }
+        bucket.clear();
+        _segment++;
+        _base = end;
+        return bits;
+    }
+
+  private:
+    uint64_t _base;
+    uint64_t _hi;
+    const std::vector<uint32_t>& _primes;
+    size_t _small;
+    size_t _next_large;
+    uint64_t _segment{0};
+    std::vector<uint64_t> _offsets;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> _ring;
+
+    // the offset from _base of the first odd multiple of p that is at least p * p
+    uint64_t _first_offset(uint64_t p) const {
+        uint64_t start = std::max(p * p, (_base + p - 1) / p * p);
+        if (start % 2 == 0) {
+            start += p;
+        }
+        return (start - _base) / 2;
+    }
+};
+
+/**
+ * @brief runs f(walker&, tid) for every thread, on contiguous parts of [lo, hi) made of
+ * whole segments
+ */
+template <typename F> void for_each_part(uint64_t lo, uint64_t hi, size_t threads, F&& f) {
+    if (hi > max_bound) {
+        throw std::invalid_argument("primes: the range must end at most at 2^62");
+    }
+    std::vector<uint32_t> primes = base_primes(hi);
+    uint64_t first = std::max<uint64_t>(lo, 1) | 1;
+    uint64_t segments = first < hi ? ((hi - first + 1) / 2 + segment_bits - 1) / segment_bits : 0;
+    threads = PARALLEL::resolve_threads(threads, segments / 4 + 1);
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t a, size_t b, size_t) {
+        for (size_t t = a; t < b; t++) {
+            uint64_t s0 = segments * t / threads, s1 = segments * (t + 1) / threads;
+            walker w(first + 2 * segment_bits * s0,
+                     std::min(hi, first + 2 * segment_bits * s1), primes);
+            f(w, t);
+        }
+    });
+}
+
+inline bool has_two(uint64_t lo, uint64_t hi) { return lo <= 2 && 2 < hi; }
+} // namespace _eratosthenes_sieve_utils
+
+/**
+ * @brief count primes function
+ * Segmented sieve of the odd numbers, one bit each, in segments of 32 KiB sieved on
+ * several threads, so [0, 10^12) takes O(sqrt(hi)) memory per thread.
+ * @param lo the first number of the range
+ * @param hi the number right after the range, at most 2^62
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return uint64_t the number of primes in [lo, hi).
+ * Throws std::invalid_argument if hi > 2^62.
+ */
+inline uint64_t count_primes(uint64_t lo, uint64_t hi, size_t threads = 1) {
+    namespace utils = _eratosthenes_sieve_utils;
+    std::vector<uint64_t> counts(PARALLEL::resolve_threads(threads, SIZE_MAX), 0);
+    utils::for_each_part(lo, hi, threads, [&](utils::walker& w, size_t tid) {
+        std::vector<uint64_t> words;
+        uint64_t base;
+        while (w.next(words, base) != 0) {
+            for (uint64_t x : words) {
+                counts[tid] += uint64_t(std::popcount(x));
+            }
+        }
+    });
+    uint64_t total = utils::has_two(lo, hi);
+    for (uint64_t c : counts) {
+        total += c;
+    }
+    return total;
+}
+
+/**
+ * @brief primes in range function
+ * @param lo the first number of the range
+ * @param hi the number right after the range, at most 2^62
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return std::vector<uint64_t> the primes of [lo, hi) in increasing order, by the
+ * segmented sieve of count_primes.
+ * Throws std::invalid_argument if hi > 2^62.
+ */
+inline std::vector<uint64_t> primes_in_range(uint64_t lo, uint64_t hi, size_t threads = 1) {
+    namespace utils = _eratosthenes_sieve_utils;
+    std::vector<std::vector<uint64_t>> parts(PARALLEL::resolve_threads(threads, SIZE_MAX));
+    utils::for_each_part(lo, hi, threads, [&](utils::walker& w, size_t tid) {
+        std::vector<uint64_t> words;
+        uint64_t base;
+        while (w.next(words, base) != 0) {
+            for (uint64_t i = 0; i < utils::segment_words; i++) {
+                for (uint64_t x = words[i]; x != 0; x &= x - 1) {
+                    parts[tid].push_back(base + 2 * (64 * i + uint64_t(std::countr_zero(x))));
+                }
+            }
+        }
+    });
+    std::vector<uint64_t> out;
+    if (utils::has_two(lo, hi)) {
+        out.push_back(2);
+    }
+    for (const std::vector<uint64_t>& part : parts) {
+        out.insert(out.end(), part.begin(), part.end());
+    }
+    return out;
+}
+
+/**
+ * @brief prime generator class
+ * The primes of [lo, hi) in increasing order, one segment of the sieve of count_primes at
+ * a time, so the whole range is never held in memory.
+ */
+class prime_generator {
+  public:
+    /**
+     * @brief Construct a new prime generator object
+     * @param lo the first number of the range
+     * @param hi the number right after the range, at most 2^62
+     * Throws std::invalid_argument if hi > 2^62.
+     */
+    prime_generator(uint64_t lo, uint64_t hi)
+        : _two(_eratosthenes_sieve_utils::has_two(lo, hi)),
+          _primes(_checked_base_primes(hi)), _walker(lo, hi, _primes) {}
+
+    prime_generator(const prime_generator&) = delete;
+    prime_generator& operator=(const prime_generator&) = delete;
+
+    /**
+     * @brief next function
+     * @return std::optional<uint64_t> the next prime of the range, nothing once they are
+     * all done.
+     */
+    std::optional<uint64_t> next() {
+        if (_two) {
+            _two = false;
+            return 2;
+        }
+        while (true) {
+            for (; _word < _words.size(); _word++) {
+                if (_words[_word] != 0) {
+                    uint64_t bit = uint64_t(std::countr_zero(_words[_word]));
+                    _words[_word] &= _words[_word] - 1;
+                    return _base + 2 * (64 * _word + bit);
+                }
+            }
+            if (_walker.next(_words, _base) == 0) {
+                return std::nullopt;
+            }
+            _word = 0;
+        }
+    }
+
+  private:
+    bool _two;
+    std::vector<uint32_t> _primes;
+    _eratosthenes_sieve_utils::walker _walker;
+    std::vector<uint64_t> _words;
+    uint64_t _base{0};
+    size_t _word{0};
+
+    static std::vector<uint32_t> _checked_base_primes(uint64_t hi) {
+        if (hi > _eratosthenes_sieve_utils::max_bound) {
+            throw std::invalid_argument("primes: the range must end at most at 2^62");
+        }
+        return _eratosthenes_sieve_utils::base_primes(hi);
+    }
+};
+
+/**
+ * @brief for each prime function
+ * @param lo the first number of the range
+ * @param hi the number right after the range, at most 2^62
+ * @param f called with every prime of [lo, hi) in increasing order
+ */
+template <typename F> void for_each_prime(uint64_t lo, uint64_t hi, F&& f) {
+    prime_generator g(lo, hi);
+    for (std::optional<uint64_t> p = g.next(); p; p = g.next()) {
+        f(*p);
+    }
+}
+
+/**
+ * @brief static sieve class
+ * The primes up to N sieved in a constant expression, one bit per odd number: a static
+ * constexpr static_sieve is in the read only data of the program, so the small primes of a
+ * trial division or of a factorization cost no allocation and no work at startup. A sieve up
+ * to a few 10^5 builds within the default limits of constant evaluation of the compilers, the
+ * segmented sieve of count_primes is for larger ranges.
+ * @tparam N the largest number of the sieve
+ */
+template <uint64_t N> class static_sieve {
+  public:
+    constexpr static_sieve() {
+        // 1 is not a prime
+        _composite[0] = N >= 1 ? 1 : 0;
+        for (uint64_t p = 3; p * p <= N; p += 2) {
+            if (_test(p / 2)) {
+                continue;
+            }
+            for (uint64_t k = p * p / 2; k < ODDS; k += p) {
+                _composite[k / 64] |= uint64_t(1) << (k % 64);
+            }
+        }
+        _count = N >= 2 ? 1 : 0;
+        for (uint64_t w : _composite) {
+            _count -= uint64_t(std::popcount(w));
+        }
+        _count += ODDS;
+    }
+
+    /**
+     * @brief is_prime function
+     * @param n a number, at most N
+     * @return true if n is a prime
+     * Throws std::out_of_range if n > N.
+     */
+    constexpr bool is_prime(uint64_t n) const {
+        if (n > N) {
+            throw std::out_of_range("static_sieve::is_prime: the number is past the sieve");
+        }
+        return n == 2 || (n % 2 == 1 && !_test(n / 2));
+    }
+
+    /**
+     * @brief count function
+     * @return uint64_t the number of primes up to N
+     */
+    constexpr uint64_t count() const { return _count; }
+
+  private:
+    // bit k stands for 2k + 1
+    static constexpr uint64_t ODDS = (N + 1) / 2;
+
+    std::array<uint64_t, ODDS / 64 + 1> _composite{};
+    uint64_t _count{0};
+
+    constexpr bool _test(uint64_t k) const { return (_composite[k / 64] >> (k % 64)) & 1; }
+};
+
+/**
+ * @brief small primes function
+ * @return std::array<uint32_t, static_sieve<N>().count()> the primes up to N in increasing
+ * order, computed at compile time when assigned to a constexpr variable
+ */
+template <uint64_t N> constexpr auto small_primes() {
+    static_assert(N <= UINT32_MAX, "small primes are at most 2^32 - 1");
+    constexpr static_sieve<N> sieve;
+    std::array<uint32_t, sieve.count()> out{};
+    size_t i = 0;
+    for (uint64_t n = 2; n <= N && i < out.size(); n++) {
+        if (sieve.is_prime(n)) {
+            out[i++] = uint32_t(n);
+        }
+    }
+    return out;
+}
+
 #endif
@@ -0,0 +1,175 @@
+#ifndef FACTORIZATION_H
+#define FACTORIZATION_H
+
+#include "../../helpers/parallel.h"
+#include "gcd.h"
+#include "montgomery.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+#endif
+
+namespace _factorization_utils {
+constexpr uint32_t small_primes[] = {2,  3,  5,  7,  11, 13, 17, 19, 23, 29, 31, 37, 41,
+                                     43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97};
+
+/**
+ * @brief Pollard's rho with Brent's cycle detection on x -> x^2 + c in Montgomery form:
+ * the differences are multiplied together and their gcd with n is taken once every 128
+ * steps, and the last block is walked again one step at a time if that gcd is n.
+ * @return uint64_t a nontrivial divisor of the odd composite n, or n if this c fails.
+ */
+inline uint64_t brent(uint64_t n, uint64_t c) {
+    const montgomery mg(n);
+    const uint64_t mc = mg.to(c);
+    auto f = [&](uint64_t x) {
+        uint64_t y = mg.mul(x, x);
+        return y >= n - mc ? y - (n - mc) : y + mc;
+    };
+    const uint64_t m = 128;
+    uint64_t y = mg.to(2), x = y, ys = y, q = mg.to(1), g = 1;
+    for (uint64_t r = 1; g == 1; r <<= 1) {
+        x = y;
+        for (uint64_t i = 0; i < r; i++) {
+            y = f(y);
+        }
+        for (uint64_t k = 0; k < r && g == 1; k += m) {
+            ys = y;
+            for (uint64_t i = 0; i < m && i < r - k; i++) {
+                y = f(y);
+                q = mg.mul(q, x > y ? x - y : y - x);
+            }
+            g = _gcd_utils::binary(q, n);
+        }
+    }
+    if (g == n) {
+        do {
+            ys = f(ys);
+            g = _gcd_utils::binary(x > ys ? x - ys : ys - x, n);
+        } while (g == 1);
+    }
+    return g;
+}
+
+inline void split(uint64_t n, std::vector<uint64_t>& out);
+} // namespace _factorization_utils
+
+/**
+ * @brief miller rabin function
+ * Deterministic for every 64 bit number with the seven bases of Jim Sinclair, the
+ * exponentiations in Montgomery form.
+ * @param n the number
+ * @return true if n is prime
+ */
+inline bool miller_rabin(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint32_t p : _factorization_utils::small_primes) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+    if (n < 97 * 97) {
+        return true;
+    }
+    const montgomery mg(n);
+    uint64_t d = n - 1;
+    int s = __builtin_ctzll(d);
+    d >>= s;
+    const uint64_t one = mg.to(1), minus_one = mg.to(n - 1);
+    for (uint64_t a : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL}) {
+        a %= n;
+        if (a == 0) {
+            continue;
+        }
+        uint64_t x = mg.pow(mg.to(a), d);
+        if (x == one || x == minus_one) {
+            continue;
+        }
+        bool witness = true;
+        for (int i = 1; i < s && witness; i++) {
+            x = mg.mul(x, x);
+            witness = x != minus_one;
+        }
+        if (witness) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief pollard rho function
+ * @param n an odd composite number
+ * @return uint64_t a nontrivial divisor of n, by Pollard's rho with Brent's cycle detection
+ * (the polynomial x^2 + c for c = 1, 2, ... until one splits n).
+ */
+inline uint64_t pollard_rho(uint64_t n) {
+    for (uint64_t c = 1;; c++) {
+        uint64_t d = _factorization_utils::brent(n, c);
+        if (d != n) {
+            return d;
+        }
+    }
+}
+
+inline void _factorization_utils::split(uint64_t n, std::vector<uint64_t>& out) {
+    if (n == 1) {
+        return;
+    }
+    if (miller_rabin(n)) {
+        out.push_back(n);
+        return;
+    }
+    uint64_t d = pollard_rho(n);
+    split(d, out);
+    split(n / d, out);
+}
+
+/**
+ * @brief factorize function
+ * Trial division by the primes below 100, then Miller-Rabin on what is left and
+ * Pollard's rho until every factor is prime, about O(n^(1/4)) products for the hardest
+ * numbers(two primes of 32 bits).
+ * @param n the number, n >= 1
+ * @return std::vector<uint64_t> the prime factors of n with their multiplicity, in
+ * increasing order(none for 1 and 0).
+ */
+inline std::vector<uint64_t> factorize(uint64_t n) {
+    std::vector<uint64_t> out;
+    if (n == 0) {
+        return out;
+    }
+    for (uint32_t p : _factorization_utils::small_primes) {
+        while (n % p == 0) {
+            out.push_back(p);
+            n /= p;
+        }
+    }
+    _factorization_utils::split(n, out);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+/**
+ * @brief factorize all function
+ * @param values the numbers
+ * @param threads number of threads(0 means every hardware thread), the numbers are
+ * shared dynamically as their cost varies a lot. Default = 1
+ * @return std::vector<std::vector<uint64_t>> the prime factors of every number, as
+ * factorize returns them.
+ */
+inline std::vector<std::vector<uint64_t>> factorize_all(std::span<const uint64_t> values,
+                                                        size_t threads = 1) {
+    std::vector<std::vector<uint64_t>> out(values.size());
+    PARALLEL::parallel_for_dynamic(0, values.size(), threads,
+                                   [&](size_t i, size_t) { out[i] = factorize(values[i]); });
+    return out;
+}
+
+#endif
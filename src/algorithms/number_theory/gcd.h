@@ -1,44 +1,53 @@
 #ifndef GCD_H
 #define GCD_H
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <iostream>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 #endif
 
+namespace _gcd_utils {
 /**
- * @brief binary gcd function
- *
- * @param a first number
- * @param b second number
- * @return int64_t the greatest common divisor of a and b
+ * @brief Stein's algorithm on unsigned 64 bit numbers
  */
-int64_t binary_gcd(const int64_t a, const int64_t b) {
-    if (a == b) {
-        return a;
-    }
-    if (a == 0) {
-        return b;
-    }
-    if (b == 0) {
-        return a;
+inline uint64_t binary(uint64_t u, uint64_t v) {
+    if (u == 0 || v == 0) {
+        return u | v;
     }
-
-    if (~a & 1) {
-        if (~b & 1) {
-            return binary_gcd(a >> 1, b >> 1) << 1;
-        } else {
-            return binary_gcd(a >> 1, b);
+    int shift = __builtin_ctzll(u | v);
+    u >>= __builtin_ctzll(u);
+    do {
+        v >>= __builtin_ctzll(v);
+        if (u > v) {
+            std::swap(u, v);
         }
-    }
-    if (~b & 1) {
-        return binary_gcd(a, b >> 1);
-    }
+        v -= u;
+    } while (v != 0);
+    return u << shift;
+}
+} // namespace _gcd_utils
 
-    if (a > b) {
-        return binary_gcd((a - b) >> 1, b);
-    }
-    return binary_gcd((b - a) >> 1, a);
+/**
+ * @brief binary gcd function
+ * Stein's algorithm without recursion: the common power of two is counted once with
+ * __builtin_ctzll and every subtraction is followed by the removal of all its trailing
+ * zeros at once, so there are O(log(a) + log(b)) steps of a few instructions.
+ * @param a first number
+ * @param b second number
+ * @return int64_t the greatest common divisor of a and b(of their absolute values)
+ */
+inline int64_t binary_gcd(const int64_t a, const int64_t b) {
+    uint64_t u = a < 0 ? 0 - uint64_t(a) : uint64_t(a);
+    uint64_t v = b < 0 ? 0 - uint64_t(b) : uint64_t(b);
+    return int64_t(_gcd_utils::binary(u, v));
 }
 
 /**
@@ -48,15 +57,64 @@ int64_t binary_gcd(const int64_t a, const int64_t b) {
  * @param b second number
  * @return int64_t the greatest common divisor of a and b
  */
-int64_t euclidean_gcd(int64_t a, int64_t b) {
+inline int64_t euclidean_gcd(int64_t a, int64_t b) {
+    // the remainders replace the repeated subtractions, with the same result
     while (a > 0 && b > 0) {
         if (a > b) {
-            a = a - b;
+            a %= b;
         } else {
-            b = b - a;
+            b %= a;
         }
     }
     return (a + b);
 }
 
+/**
+ * @brief gcd of an array function
+ * @param values the numbers
+ * @param threads number of threads(0 means every hardware thread), every thread reduces a
+ * contiguous part and stops as soon as its gcd is 1. Default = 1
+ * @return int64_t the greatest common divisor of all the values(of their absolute
+ * values), 0 for an empty array.
+ */
+inline int64_t gcd_all(std::span<const int64_t> values, size_t threads = 1) {
+    threads = PARALLEL::resolve_threads(threads, values.size() / 4096 + 1);
+    std::vector<int64_t> parts(threads, 0);
+    PARALLEL::parallel_for(0, values.size(), threads, [&](size_t lo, size_t hi, size_t tid) {
+        int64_t g = 0;
+        for (size_t i = lo; i < hi && g != 1; i++) {
+            g = binary_gcd(g, values[i]);
+        }
+        parts[tid] = g;
+    });
+    int64_t g = 0;
+    for (int64_t part : parts) {
+        g = binary_gcd(g, part);
+    }
+    return g;
+}
+
+/**
+ * @brief gcd of pairs function
+ * @param a the first numbers
+ * @param b the second numbers, as many as a
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return std::vector<int64_t> the greatest common divisor of a[i] and b[i] for every i.
+ * Throws std::invalid_argument if a and b have different sizes.
+ */
+inline std::vector<int64_t> gcd_pairs(std::span<const int64_t> a, std::span<const int64_t> b,
+                                      size_t threads = 1) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("gcd_pairs: the arrays have different sizes");
+    }
+    std::vector<int64_t> out(a.size());
+    threads = PARALLEL::resolve_threads(threads, a.size() / 4096 + 1);
+    PARALLEL::parallel_for(0, a.size(), threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            out[i] = binary_gcd(a[i], b[i]);
+        }
+    });
+    return out;
+}
+
 #endif
@@ -1,33 +1,129 @@
 #ifndef MERSENNE_PRIMES_H
 #define MERSENNE_PRIMES_H
 
+#include "../../helpers/parallel.h"
+#include "../math/multiply.h"
+#include "eratosthenes_sieve.h"
+
 #ifdef __cplusplus
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #endif
 
-namespace helpers {
+namespace _mersenne_primes_utils {
 /**
- * @brief eratosthenes sieve function(sieve of eratosthenes)
- *
- * @param n upper bound
- * @return std::vector<bool> if arr[i] = 1 then i is prime
+ * @brief x mod 2^p - 1 of a number of any size, as p bits in limbs limbs: 2^p = 1 modulo
+ * 2^p - 1, so the bits above p are added back at the bottom(shift and add), until it fits
+ * in p bits, and 2^p - 1 itself is 0.
+ */
+inline std::vector<uint32_t> reduce(std::vector<uint32_t> x, uint32_t p, size_t limbs) {
+    const uint32_t top_bits = p % 32;
+    const uint32_t top_mask = top_bits == 0 ? ~uint32_t(0) : (uint32_t(1) << top_bits) - 1;
+    while (x.size() > limbs || (x.size() == limbs && (x[limbs - 1] & ~top_mask) != 0)) {
+        // high = x >> p, x = x mod 2^p
+        std::vector<uint32_t> high(x.size() - limbs + 1, 0);
+        size_t word = p / 32;
+        for (size_t i = 0; i < high.size(); i++) {
+            uint64_t lo = word + i < x.size() ? x[word + i] : 0;
+            uint64_t hi = word + i + 1 < x.size() ? x[word + i + 1] : 0;
+            high[i] = uint32_t(((hi << 32) | lo) >> top_bits);
+        }
+        x.resize(limbs);
+        x[limbs - 1] &= top_mask;
+        x.push_back(0);
+        _multiply_utils::add_into(x.data(), x.size(), high);
+        while (x.size() > limbs && x.back() == 0) {
+            x.pop_back();
+        }
+    }
+    x.resize(limbs, 0);
+    bool all_ones = x[limbs - 1] == top_mask;
+    for (size_t i = 0; all_ones && i + 1 < limbs; i++) {
+        all_ones = x[i] == ~uint32_t(0);
+    }
+    if (all_ones) {
+        std::fill(x.begin(), x.end(), 0);
+    }
+    return x;
+}
+
+/**
+ * @brief x - 2 mod 2^p - 1, for x < 2^p - 1
+ */
+inline void minus_two(std::vector<uint32_t>& x, uint32_t p) {
+    if (x[0] >= 2 || std::any_of(x.begin() + 1, x.end(), [](uint32_t v) { return v != 0; })) {
+        int64_t borrow = 2;
+        for (size_t i = 0; borrow != 0; i++) {
+            int64_t t = int64_t(x[i]) - borrow;
+            borrow = t < 0;
+            x[i] = uint32_t(t + (borrow << 32));
+        }
+        return;
+    }
+    // x + 2^p - 1 - 2 = x + 2^p - 3
+    uint64_t low = x[0];
+    std::fill(x.begin(), x.end(), ~uint32_t(0));
+    if (p % 32 != 0) {
+        x.back() = (uint32_t(1) << (p % 32)) - 1;
+    }
+    x[0] = uint32_t(low + uint64_t(x[0]) - 2);
+}
+} // namespace _mersenne_primes_utils
+
+/**
+ * @brief lucas lehmer function
+ * s = 4, s = s^2 - 2 mod 2^p - 1 repeated p - 2 times, 2^p - 1 is prime when s = 0. The
+ * squares use multiply_limbs(Karatsuba) and the reduction modulo 2^p - 1 is a shift and an
+ * add, so the test takes p - 2 squarings of p bits.
+ * @param p the exponent
+ * @return true if 2^p - 1 is prime
+ */
+inline bool lucas_lehmer(uint32_t p) {
+    namespace utils = _mersenne_primes_utils;
+    if (p == 2) {
+        return true;
+    }
+    // 2^ab - 1 is divided by 2^a - 1
+    if (p < 2 || count_primes(p, uint64_t(p) + 1) == 0) {
+        return false;
+    }
+    const size_t limbs = (size_t(p) + 31) / 32;
+    std::vector<uint32_t> s(limbs, 0);
+    s[0] = 4;
+    for (uint32_t i = 0; i + 2 < p; i++) {
+        s = utils::reduce(multiply_limbs(s, s), p, limbs);
+        utils::minus_two(s, p);
+    }
+    return std::all_of(s.begin(), s.end(), [](uint32_t v) { return v == 0; });
+}
+
+/**
+ * @brief mersenne exponents function
+ * @param max_exponent the largest exponent tested
+ * @param threads number of threads(0 means every hardware thread), the exponents are
+ * shared dynamically, the largest first. Default = 1
+ * @return std::vector<uint32_t> the exponents p <= max_exponent for which 2^p - 1 is
+ * prime, in increasing order.
  */
-std::vector<bool> soe(int64_t n) {
-    assert(n != 0);
-    std::vector<bool> prime(n + 1, true);
-    for (int64_t p = 2; p * p <= n; ++p) {
-        if (prime[p]) {
-            for (int64_t i = p * p; i <= n; i += p) {
-                prime[i] = false;
-            }
+inline std::vector<uint32_t> mersenne_exponents(uint32_t max_exponent, size_t threads = 1) {
+    std::vector<uint64_t> candidates = primes_in_range(0, uint64_t(max_exponent) + 1);
+    std::vector<char> prime(candidates.size(), 0);
+    size_t n = candidates.size();
+    PARALLEL::parallel_for_dynamic(0, n, threads, [&](size_t i, size_t) {
+        prime[n - 1 - i] = lucas_lehmer(uint32_t(candidates[n - 1 - i]));
+    });
+    std::vector<uint32_t> out;
+    for (size_t i = 0; i < n; i++) {
+        if (prime[i]) {
+            out.push_back(uint32_t(candidates[i]));
         }
     }
-    return prime;
+    return out;
 }
-} // namespace helpers
 
 /**
  * @brief mersenne prime function
@@ -35,13 +131,11 @@ std::vector<bool> soe(int64_t n) {
  * @param n the upper bound
  * @return std::vector<int> the total mersenne primes till the upper bound n
  */
-std::vector<int64_t> mersenne(int64_t n) {
-    std::vector<bool> prime = helpers::soe(n + 1);
+inline std::vector<int64_t> mersenne(int64_t n) {
     std::vector<int64_t> elements;
 
-    for (int k = 2; ((1LL << k) - 1) <= n; k++) {
-        int64_t val = (1LL << k) - 1;
-        if (val <= n && prime[val]) {
+    for (int k = 2; k < 63 && ((1LL << k) - 1) <= n; k++) {
+        if (lucas_lehmer(uint32_t(k))) {
             elements.push_back(k);
         }
     }
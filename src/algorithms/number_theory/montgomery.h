@@ -0,0 +1,141 @@
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <stdexcept>
+#endif
+
+/**
+ * @brief montgomery class
+ * Arithmetic modulo an odd n < 2^64 in Montgomery form(x is kept as x 2^64 mod n): a
+ * product is one 128 bit multiplication and a reduction by two more multiplications and
+ * no division(REDC). The values passed to and returned by mul and pow are in Montgomery
+ * form, to and from convert.
+ */
+class montgomery {
+  public:
+    /**
+     * @brief Construct a new montgomery object
+     * @param n the modulus, odd
+     * Throws std::invalid_argument if n is even.
+     */
+    constexpr explicit montgomery(uint64_t n) : _n(n) {
+        if (n % 2 == 0) {
+            throw std::invalid_argument("montgomery: the modulus must be odd");
+        }
+        // Newton: every step doubles the number of correct low bits of n^-1 mod 2^64
+        _inv = n;
+        for (int i = 0; i < 5; i++) {
+            _inv *= 2 - n * _inv;
+        }
+        uint64_t r = (0 - n) % n;
+        _r2 = uint64_t((unsigned __int128)r * r % n);
+    }
+
+    /**
+     * @brief modulus function
+     * @return uint64_t n.
+     */
+    constexpr uint64_t modulus() const { return _n; }
+
+    /**
+     * @brief to function
+     * @param x a number
+     * @return uint64_t x in Montgomery form.
+     */
+    constexpr uint64_t to(uint64_t x) const { return mul(x % _n, _r2); }
+
+    /**
+     * @brief from function
+     * @param x a number in Montgomery form
+     * @return uint64_t the number it stands for, in [0, n).
+     */
+    constexpr uint64_t from(uint64_t x) const { return reduce(x); }
+
+    /**
+     * @brief reduce function
+     * @param t a number below n 2^64
+     * @return uint64_t t 2^-64 mod n, in [0, n)
+     */
+    constexpr uint64_t reduce(unsigned __int128 t) const {
+        // t - q n is a multiple of 2^64, so its high word is the result up to one n
+        uint64_t q = uint64_t(t) * _inv;
+        uint64_t hi = uint64_t(t >> 64), qn = uint64_t(((unsigned __int128)q * _n) >> 64);
+        return hi >= qn ? hi - qn : hi + (_n - qn);
+    }
+
+    /**
+     * @brief mul function
+     * @param a a number in Montgomery form
+     * @param b a number in Montgomery form
+     * @return uint64_t a b in Montgomery form.
+     */
+    constexpr uint64_t mul(uint64_t a, uint64_t b) const {
+        return reduce((unsigned __int128)a * b);
+    }
+
+    /**
+     * @brief pow function
+     * @param a a number in Montgomery form
+     * @param e the exponent
+     * @return uint64_t a^e in Montgomery form.
+     */
+    constexpr uint64_t pow(uint64_t a, uint64_t e) const {
+        uint64_t r = to(1);
+        for (; e != 0; e >>= 1) {
+            if (e & 1) {
+                r = mul(r, a);
+            }
+            a = mul(a, a);
+        }
+        return r;
+    }
+
+  private:
+    uint64_t _n;
+    uint64_t _inv{0};
+    uint64_t _r2{0};
+};
+
+/**
+ * @brief modular multiplication function
+ * @param a first number
+ * @param b second number
+ * @param m the modulus, m >= 1
+ * @return uint64_t a b mod m, through a 128 bit product.
+ */
+constexpr uint64_t mod_mul(uint64_t a, uint64_t b, uint64_t m) {
+    return uint64_t((unsigned __int128)a * b % m);
+}
+
+/**
+ * @brief modular exponentiation function
+ * @param a the base
+ * @param e the exponent
+ * @param m the modulus, m >= 1
+ * @return uint64_t a^e mod m, in Montgomery form when m is odd.
+ * Throws std::invalid_argument if m is 0.
+ */
+constexpr uint64_t mod_pow(uint64_t a, uint64_t e, uint64_t m) {
+    if (m == 0) {
+        throw std::invalid_argument("mod_pow: the modulus must be positive");
+    }
+    if (m == 1) {
+        return 0;
+    }
+    if (m % 2 == 1) {
+        montgomery mg(m);
+        return mg.from(mg.pow(mg.to(a), e));
+    }
+    uint64_t r = 1;
+    for (a %= m; e != 0; e >>= 1) {
+        if (e & 1) {
+            r = mod_mul(r, a, m);
+        }
+        a = mod_mul(a, a, m);
+    }
+    return r;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef RMQ_LINEAR_H
+#define RMQ_LINEAR_H
+
+#include "../../helpers/parallel.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief linear RMQ struct for range query minimum(or maximum) in O(n) space
+ * The values are cut into blocks of 64. Inside a block, mask[i] has a bit for every
+ * index of the block that is on the monotonic stack of the block after pushing i, so
+ * the answer for [l, i] is the lowest bit of mask[i] at or above l, one count trailing
+ * zeros. Across blocks, a sparse table over the block minima answers the whole blocks,
+ * it has n / 64 * log(n / 64) entries of 32 bits. In total about 9.6 bytes per value
+ * next to the values themselves, and every query is O(1). Same interface as RMQ:
+ * queries are half open and ties go to the largest index.
+ */
+template <typename T, bool maximum_mode = false> struct linear_RMQ {
+    static constexpr size_t BLOCK = 64;
+
+    size_t n = 0;
+    std::vector<T> values;
+
+    /**
+     * @brief constructor of linear RMQ struct
+     * @param _values: the values, move them in to avoid the copy
+     * @param threads: number of worker threads for the build(0 means every hardware
+     * thread). Default = 1
+     */
+    linear_RMQ(std::vector<T> _values = {}, size_t threads = 1) {
+        if (!_values.empty()) {
+            build(std::move(_values), threads);
+        }
+    }
+
+    // Note: when `values[a] == values[b]`, returns b, like RMQ.
+    size_t better_index(size_t a, size_t b) const {
+        return _better(values[a], values[b]) ? a : b;
+    }
+
+    /**
+     * @brief build function, the blocks are built in parallel and so is every level of the
+     * sparse table
+     * @param _values: the values
+     * @param threads: number of worker threads(0 means every hardware thread). Default = 1
+     * Throws std::length_error if there are more than 2^32 blocks.
+     */
+    void build(std::vector<T> _values, size_t threads = 1) {
+        values = std::move(_values);
+        n = values.size();
+        size_t blocks = (n + BLOCK - 1) / BLOCK;
+        if (blocks > size_t(UINT32_MAX)) {
+            throw std::length_error("linear_RMQ: too many values");
+        }
+        _mask.assign(n, 0);
+        _block_best.assign(blocks, 0);
+        PARALLEL::parallel_for(0, blocks, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t b = lo; b < hi; b++) {
+                _build_block(b);
+            }
+        });
+        _table.assign(blocks == 0 ? 0 : std::bit_width(blocks), {});
+        if (blocks == 0) {
+            return;
+        }
+        _table[0].resize(blocks);
+        for (size_t b = 0; b < blocks; b++) {
+            _table[0][b] = uint32_t(b);
+        }
+        for (size_t k = 1; k < _table.size(); k++) {
+            size_t half = size_t(1) << (k - 1), len = blocks - (size_t(1) << k) + 1;
+            _table[k].resize(len);
+            PARALLEL::parallel_for(0, len, threads, [&](size_t lo, size_t hi, size_t) {
+                for (size_t i = lo; i < hi; i++) {
+                    _table[k][i] = _better_block(_table[k - 1][i], _table[k - 1][i + half]);
+                }
+            });
+        }
+    }
+
+    // Note: breaks ties by choosing the largest index.
+    size_t query_index(size_t a, size_t b) const {
+        assert(a < b && b <= n);
+        size_t l = a, r = b - 1, bl = l / BLOCK, br = r / BLOCK;
+        if (bl == br) {
+            return _in_block(l, r);
+        }
+        size_t best = _in_block(l, bl * BLOCK + BLOCK - 1);
+        if (bl + 1 < br) {
+            size_t level = std::bit_width(br - bl - 1) - 1;
+            uint32_t x = _better_block(_table[level][bl + 1],
+                                       _table[level][br - (size_t(1) << level)]);
+            best = better_index(best, _block_best[x]);
+        }
+        return better_index(best, _in_block(br * BLOCK, r));
+    }
+
+    T query_value(size_t a, size_t b) const { return values[query_index(a, b)]; }
+
+  private:
+    std::vector<uint64_t> _mask;
+    // the answer of every whole block
+    std::vector<size_t> _block_best;
+    // _table[k][i] is the block with the best value among the blocks [i, i + 2^k)
+    std::vector<std::vector<uint32_t>> _table;
+
+    static bool _better(const T& x, const T& y) { return maximum_mode ? y < x : x < y; }
+
+    uint32_t _better_block(uint32_t a, uint32_t b) const {
+        return _better(values[_block_best[a]], values[_block_best[b]]) ? a : b;
+    }
+
+    void _build_block(size_t b) {
+        size_t base = b * BLOCK, end = std::min(n, base + BLOCK);
+        uint64_t stack = 0;
+        for (size_t i = base; i < end; i++) {
+            // equal values leave the stack too, so ties go to the largest index
+            while (stack && !_better(values[base + std::bit_width(stack) - 1], values[i])) {
+                stack &= ~(uint64_t(1) << (std::bit_width(stack) - 1));
+            }
+            stack |= uint64_t(1) << (i - base);
+            _mask[i] = stack;
+        }
+        _block_best[b] = base + std::countr_zero(stack);
+    }
+
+    // the answer for [l, r] inside one block
+    size_t _in_block(size_t l, size_t r) const {
+        size_t base = l / BLOCK * BLOCK;
+        return base + std::countr_zero(_mask[r] & (~uint64_t(0) << (l - base)));
+    }
+};
+
+#endif
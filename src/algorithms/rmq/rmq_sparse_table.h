@@ -2,6 +2,8 @@
 #define RMQ_SEGMENT_TREE_H
 
 #ifdef __cplusplus
+#include <array>
+#include <bit>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -69,4 +71,41 @@ template <typename T, bool maximum_mode = false> struct RMQ {
     T query_value(int a, int b) const { return values[query_index(a, b)]; }
 };
 
+/**
+ * @brief static RMQ struct
+ * The sparse table of RMQ over a fixed array of N values, built in a constant expression:
+ * a static constexpr static_rmq of a constant table is in the read only data, with no
+ * allocation and no build at startup. Queries and ties are those of RMQ.
+ */
+template <typename T, size_t N, bool maximum_mode = false> struct static_rmq {
+    static constexpr size_t levels = std::bit_width(N);
+
+    std::array<T, N> values;
+    std::array<std::array<int, N>, levels> range_low{};
+
+    constexpr explicit static_rmq(const std::array<T, N>& _values) : values(_values) {
+        for (int i = 0; i < int(N); i++)
+            range_low[0][i] = i;
+
+        for (int k = 1; k < int(levels); k++)
+            for (int i = 0; i <= int(N) - (1 << k); i++)
+                range_low[k][i] =
+                    better_index(range_low[k - 1][i], range_low[k - 1][i + (1 << (k - 1))]);
+    }
+
+    // Note: when `values[a] == values[b]`, returns b, as RMQ does.
+    constexpr int better_index(int a, int b) const {
+        return (maximum_mode ? values[b] < values[a] : values[a] < values[b]) ? a : b;
+    }
+
+    // the index of the minimum of [a, b), breaking ties by choosing the largest index.
+    constexpr int query_index(int a, int b) const {
+        assert(0 <= a && a < b && b <= int(N));
+        int level = std::bit_width(unsigned(b - a)) - 1;
+        return better_index(range_low[level][a], range_low[level][b - (1 << level)]);
+    }
+
+    constexpr T query_value(int a, int b) const { return values[query_index(a, b)]; }
+};
+
 #endif
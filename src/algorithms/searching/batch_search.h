@@ -0,0 +1,83 @@
+#ifndef BATCH_SEARCH_H
+#define BATCH_SEARCH_H
+
+#include "binary_search.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief the number of queries batch_lower_bound interleaves by default
+ */
+inline constexpr size_t batch_search_group = 32;
+
+/**
+ * @brief batched lower bound search function
+ *
+ * @param arr The sorted values
+ * @param keys The elements we want to search
+ * @param group The number of searches that are interleaved. Default = batch_search_group
+ * @return std::vector<size_t> for every key, the index of the first element of arr that is
+ * not less than it, arr.size() if there is none
+ * @details The branchless search does the same number of steps for every key, so the keys
+ * are searched group at a time in lockstep: every step moves all the searches of the group
+ * one level down and prefetches the next middle of each, so a search waits for its cache
+ * miss while the others of the group are stepped, and up to group misses are in flight
+ * at once instead of one. This pays off when arr does not fit in the cache.
+ */
+template <typename T>
+std::vector<size_t> batch_lower_bound(std::span<const T> arr,
+                                      std::span<const std::type_identity_t<T>> keys,
+                                      size_t group = batch_search_group) {
+    std::vector<size_t> out(keys.size(), 0);
+    if (arr.empty()) {
+        return out;
+    }
+    group = std::max<size_t>(1, group);
+    std::vector<const T*> base(group);
+    for (size_t k0 = 0; k0 < keys.size(); k0 += group) {
+        size_t g = std::min(group, keys.size() - k0);
+        const T* q = keys.data() + k0;
+        std::fill(base.begin(), base.begin() + g, arr.data());
+        for (size_t n = arr.size(); n > 1;) {
+            size_t half = n / 2, next = (n - half) / 2;
+            for (size_t i = 0; i < g; i++) {
+                base[i] = base[i][half] < q[i] ? base[i] + half : base[i];
+                _binary_search_utils::prefetch(base[i] + next);
+            }
+            n -= half;
+        }
+        for (size_t i = 0; i < g; i++) {
+            out[k0 + i] = size_t(base[i] - arr.data()) + (*base[i] < q[i]);
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief batched binary search function
+ *
+ * @param arr The sorted values
+ * @param keys The elements we want to search
+ * @param group The number of searches that are interleaved. Default = batch_search_group
+ * @return std::vector<int64_t> for every key, its index in arr, -1 if it is not there
+ */
+template <typename T>
+std::vector<int64_t> batch_search(std::span<const T> arr,
+                                  std::span<const std::type_identity_t<T>> keys,
+                                  size_t group = batch_search_group) {
+    std::vector<size_t> pos = batch_lower_bound(arr, keys, group);
+    std::vector<int64_t> out(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        out[i] = pos[i] < arr.size() && arr[pos[i]] == keys[i] ? int64_t(pos[i]) : -1;
+    }
+    return out;
+}
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef BFS_H
 #define BFS_H
 
+#include "../../classes/graph/csr_graph.h"
+#include "graph_search.h"
+
 #ifdef __cplusplus
 #include <cstdint>
 #include <queue>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -48,4 +52,83 @@ template <typename T> bool bfs(std::unordered_map<T, std::vector<T>>& adj, T sta
     return false; // Not found
 }
 
+/**
+ * @brief Breadth First Search (BFS) over the dense ids of a graph
+ *
+ * @param g The input graph, a csr_graph or any adjacency_range
+ * @param sources The starting vertex ids, all at depth 0(ids out of range are ignored)
+ * @param visit Called with every vertex id in bfs order and its depth, exactly once per
+ * vertex, the search stops as soon as it returns false
+ * @param opt The depth limit and the workspace to reuse. Default = no limit, local buffers
+ * @return true if visit stopped the search
+ * @return false if every vertex within the depth limit was visited
+ */
+template <adjacency_range G, graph_visitor F>
+bool bfs(const G& g, std::span<const uint32_t> sources, F&& visit,
+         graph_search_options opt = {}) {
+    graph_workspace local;
+    graph_workspace& ws = opt.workspace ? *opt.workspace : local;
+    ws.begin(g.size());
+    std::vector<uint32_t>& q = ws.frontier();
+    for (uint32_t s : sources) {
+        if (s < g.size() && ws.try_visit(s)) {
+            if (!visit(s, size_t(0))) {
+                return true;
+            }
+            q.push_back(s);
+        }
+    }
+    // q[head, level_end) holds the vertices at depth
+    size_t head = 0, level_end = q.size();
+    for (size_t depth = 0; head < level_end && depth < opt.max_depth; depth++) {
+        for (; head < level_end; head++) {
+            for (uint32_t v : _graph_search_utils::neighbors(g, q[head])) {
+                if (ws.try_visit(v)) {
+                    if (!visit(v, depth + 1)) {
+                        return true;
+                    }
+                    q.push_back(v);
+                }
+            }
+        }
+        level_end = q.size();
+    }
+    return false;
+}
+
+/**
+ * @brief Breadth First Search (BFS) over the dense ids of a graph from one vertex
+ *
+ * @param g The input graph, a csr_graph or any adjacency_range
+ * @param start The starting vertex id
+ * @param visit Called with every vertex id in bfs order and its depth, the search stops
+ * as soon as it returns false
+ * @param opt The depth limit and the workspace to reuse. Default = no limit, local buffers
+ * @return true if visit stopped the search
+ * @return false otherwise
+ */
+template <adjacency_range G, graph_visitor F>
+bool bfs(const G& g, uint32_t start, F&& visit, graph_search_options opt = {}) {
+    return bfs(g, std::span<const uint32_t>(&start, 1), std::forward<F>(visit), opt);
+}
+
+/**
+ * @brief Breadth First Search (BFS) algorithm on a graph snapshot
+ *
+ * @param g The input graph(see graph<T>::csr_view())
+ * @param start The starting node
+ * @param key The key to search for
+ * @param opt The depth limit and the workspace to reuse. Default = no limit, local buffers
+ * @return true if the key is reachable from start within opt.max_depth arcs
+ * @return false otherwise
+ */
+template <typename T>
+bool bfs(const csr_graph<T>& g, const T& start, const T& key, graph_search_options opt = {}) {
+    uint32_t s = g.id(start), t = g.id(key);
+    if (s == csr_graph<T>::npos || t == csr_graph<T>::npos) {
+        return false;
+    }
+    return bfs(g, s, [t](uint32_t u, size_t) { return u != t; }, opt);
+}
+
 #endif
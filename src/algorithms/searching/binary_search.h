@@ -2,8 +2,12 @@
 #define BINARY_SEARCH_H
 
 #ifdef __cplusplus
+#include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <span>
+#include <type_traits>
 #include <vector>
 #endif
 
@@ -17,7 +21,8 @@
  * @return int64_t The index of the element in the vector, if it doesn't exist
  * then it returns -1
  */
-template <typename T> int64_t bin_search(std::vector<T> arr, int64_t left, int64_t right, T x) {
+template <typename T>
+int64_t bin_search(const std::vector<T>& arr, int64_t left, int64_t right, T x) {
     while (left <= right) {
         int64_t mid = left + (right - left) / 2;
         if (arr[mid] == x) {
@@ -41,7 +46,8 @@ template <typename T> int64_t bin_search(std::vector<T> arr, int64_t left, int64
  * @param x The element we want to search
  * @return int64_t The index of the first element that is not less than x
  */
-template <typename T> int64_t lower_bound(std::vector<T> arr, int64_t left, int64_t right, T x) {
+template <typename T>
+int64_t lower_bound(const std::vector<T>& arr, int64_t left, int64_t right, T x) {
     int64_t result = right, mid = 0;
     --right;
 
@@ -67,7 +73,8 @@ template <typename T> int64_t lower_bound(std::vector<T> arr, int64_t left, int6
  * @param x The element we want to search
  * @return int64_t The index of the first element that is greater than x
  */
-template <typename T> int64_t upper_bound(std::vector<T> arr, int64_t left, int64_t right, T x) {
+template <typename T>
+int64_t upper_bound(const std::vector<T>& arr, int64_t left, int64_t right, T x) {
     int64_t result = right, mid = 0;
     --right;
 
@@ -84,4 +91,177 @@ template <typename T> int64_t upper_bound(std::vector<T> arr, int64_t left, int6
     return result;
 }
 
+namespace _binary_search_utils {
+inline void prefetch(const void* p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+} // namespace _binary_search_utils
+
+/**
+ * @brief branchless lower bound search function
+ *
+ * @param arr The sorted values, a span so nothing is copied
+ * @param x The element we want to search
+ * @return size_t The index of the first element that is not less than x, arr.size() if
+ * there is none
+ * @details The range halves every step without a branch on the comparison, which
+ * compiles to a conditional move, so the search never mispredicts, and the middles of
+ * both halves are prefetched because one of them is the next middle.
+ */
+template <typename T>
+size_t branchless_lower_bound(std::span<const T> arr, const std::type_identity_t<T>& x) {
+    if (arr.empty()) {
+        return 0;
+    }
+    const T* base = arr.data();
+    for (size_t n = arr.size(); n > 1;) {
+        size_t half = n / 2;
+        _binary_search_utils::prefetch(base + half / 2);
+        _binary_search_utils::prefetch(base + half + half / 2);
+        base = base[half] < x ? base + half : base;
+        n -= half;
+    }
+    return size_t(base - arr.data()) + (*base < x);
+}
+
+/**
+ * @brief lower bound search function
+ *
+ * @param arr The sorted values, a span so nothing is copied
+ * @param x The element we want to search
+ * @return size_t The index of the first element that is not less than x
+ */
+template <typename T>
+size_t lower_bound(std::span<const T> arr, const std::type_identity_t<T>& x) {
+    return branchless_lower_bound(arr, x);
+}
+
+/**
+ * @brief upper bound search function
+ *
+ * @param arr The sorted values, a span so nothing is copied
+ * @param x The element we want to search
+ * @return size_t The index of the first element that is greater than x
+ */
+template <typename T>
+size_t upper_bound(std::span<const T> arr, const std::type_identity_t<T>& x) {
+    if (arr.empty()) {
+        return 0;
+    }
+    const T* base = arr.data();
+    for (size_t n = arr.size(); n > 1;) {
+        size_t half = n / 2;
+        base = x < base[half] ? base : base + half;
+        n -= half;
+    }
+    return size_t(base - arr.data()) + !(x < *base);
+}
+
+/**
+ * @brief binary search function
+ *
+ * @param arr The sorted values, a span so nothing is copied
+ * @param x The element we want to search
+ * @return int64_t The index of the element in the span, if it doesn't exist then it
+ * returns -1
+ */
+template <typename T>
+int64_t bin_search(std::span<const T> arr, const std::type_identity_t<T>& x) {
+    size_t i = branchless_lower_bound(arr, x);
+    return i < arr.size() && arr[i] == x ? int64_t(i) : -1;
+}
+
+/**
+ * @brief the span searches on a whole vector, which is not copied
+ */
+template <typename T> size_t lower_bound(const std::vector<T>& arr, const T& x) {
+    return lower_bound(std::span<const T>(arr), x);
+}
+template <typename T> size_t upper_bound(const std::vector<T>& arr, const T& x) {
+    return upper_bound(std::span<const T>(arr), x);
+}
+template <typename T> int64_t bin_search(const std::vector<T>& arr, const T& x) {
+    return bin_search(std::span<const T>(arr), x);
+}
+
+/**
+ * @brief eytzinger index class
+ * A copy of sorted values in the Eytzinger(breadth first) order of their implicit binary
+ * search tree: the root at 1 and the children of k at 2k and 2k + 1. A search goes down
+ * one array from the front, so the first levels stay in cache, the 16 descendants four
+ * levels down share a cache line or two that are prefetched ahead, and the step is a
+ * branchless 2k + (b[k] < x), whatever the size of the data.
+ * @tparam T the type of the values.
+ */
+template <typename T> class eytzinger_index {
+  public:
+    /**
+     * @brief Construct a new eytzinger index object
+     * @param sorted: the values, sorted in ascending order.
+     */
+    explicit eytzinger_index(std::span<const T> sorted)
+        : _tree(sorted.size() + 1), _rank(sorted.size() + 1) {
+        size_t i = 0;
+        _build(sorted, i, 1);
+        // the past the end answer, where a search that finds nothing lands
+        _rank[0] = sorted.size();
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of values.
+     */
+    size_t size() const { return _tree.size() - 1; }
+
+    /**
+     * @brief lower_bound function
+     * @param x: the value to search.
+     * @return size_t the index in the sorted values of the first one that is not less than
+     * x, size() if there is none.
+     */
+    size_t lower_bound(const T& x) const {
+        size_t n = size(), k = 1;
+        while (k <= n) {
+            _binary_search_utils::prefetch(_tree.data() + std::min(16 * k, n));
+            k = 2 * k + (_tree[k] < x);
+        }
+        // k went right after the last left turn, drop those right turns and that left one
+        k >>= std::countr_one(k) + 1;
+        return _rank[k];
+    }
+
+    /**
+     * @brief contains function
+     * @param x: the value to search.
+     * @return true if x is one of the values.
+     */
+    bool contains(const T& x) const {
+        size_t n = size(), k = 1;
+        while (k <= n) {
+            k = 2 * k + (_tree[k] < x);
+        }
+        k >>= std::countr_one(k) + 1;
+        return k != 0 && !(x < _tree[k]);
+    }
+
+  private:
+    std::vector<T> _tree;
+    // _rank[k]: the index in the sorted values of _tree[k]
+    std::vector<size_t> _rank;
+
+    // in order traversal of the tree, filled with the sorted values from the smallest
+    void _build(std::span<const T> sorted, size_t& i, size_t k) {
+        if (k < _tree.size()) {
+            _build(sorted, i, 2 * k);
+            _rank[k] = i;
+            _tree[k] = sorted[i++];
+            _build(sorted, i, 2 * k + 1);
+        }
+    }
+};
+
 #endif
@@ -1,8 +1,15 @@
 #ifndef DFS_H
 #define DFS_H
 
+#include "../../classes/graph/csr_graph.h"
+#include "../../classes/stack/stack_list.h"
+#include "graph_search.h"
+
 #ifdef __cplusplus
-#include <stack>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -23,7 +30,7 @@ template <typename T> T dfs(std::unordered_map<T, std::vector<T>>& adj, T start,
     }
 
     std::unordered_set<T> visited;
-    std::stack<T> s;
+    stack_list<T> s;
     s.push(start);
     while (!s.empty()) {
         auto current = s.top();
@@ -42,4 +49,110 @@ template <typename T> T dfs(std::unordered_map<T, std::vector<T>>& adj, T start,
     return false;
 }
 
+/**
+ * @brief Depth First Search (DFS) over the dense ids of a graph
+ *
+ * @param g The input graph, a csr_graph or any adjacency_range
+ * @param sources The starting vertex ids, searched one after the other(ids out of range
+ * are ignored)
+ * @param visit Called with every vertex id in dfs(recursive) order and the depth it is
+ * first reached at, once per vertex, the search stops as soon as it returns false
+ * @param opt The depth limit and the workspace to reuse. Default = no limit, local buffers
+ * @return true if visit stopped the search
+ * @return false if every vertex within the depth limit was visited
+ * @details With a depth limit a vertex that is reached again by a shorter path than before
+ * is expanded again, so every vertex within max_depth arcs of a source is visited, as it
+ * would be by bfs.
+ */
+template <adjacency_range G, graph_visitor F>
+bool dfs(const G& g, std::span<const uint32_t> sources, F&& visit,
+         graph_search_options opt = {}) {
+    using range = decltype(_graph_search_utils::neighbors(g, uint32_t(0)));
+    struct frame {
+        std::ranges::iterator_t<range> it;
+        std::ranges::sentinel_t<range> end;
+    };
+    graph_workspace local;
+    graph_workspace& ws = opt.workspace ? *opt.workspace : local;
+    ws.begin(g.size());
+    // the smallest depth every visited vertex was expanded at
+    std::vector<int64_t>& reached = ws.in();
+    bool limited = opt.max_depth != std::numeric_limits<size_t>::max();
+    std::vector<frame> st;
+    auto expand = [&](uint32_t u, size_t depth) {
+        reached[u] = int64_t(depth);
+        if (depth < opt.max_depth) {
+            range r = _graph_search_utils::neighbors(g, u);
+            st.push_back({std::ranges::begin(r), std::ranges::end(r)});
+        }
+    };
+    for (uint32_t s : sources) {
+        if (s >= g.size()) {
+            continue;
+        }
+        if (ws.try_visit(s)) {
+            if (!visit(s, size_t(0))) {
+                return true;
+            }
+        } else if (!limited || reached[s] == 0) {
+            continue;
+        }
+        expand(s, 0);
+        while (!st.empty()) {
+            frame& f = st.back();
+            if (f.it == f.end) {
+                st.pop_back();
+                continue;
+            }
+            uint32_t v = static_cast<uint32_t>(*f.it);
+            ++f.it;
+            size_t depth = st.size();
+            if (ws.try_visit(v)) {
+                if (!visit(v, depth)) {
+                    return true;
+                }
+            } else if (!limited || reached[v] <= int64_t(depth)) {
+                continue;
+            }
+            expand(v, depth);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Depth First Search (DFS) over the dense ids of a graph from one vertex
+ *
+ * @param g The input graph, a csr_graph or any adjacency_range
+ * @param start The starting vertex id
+ * @param visit Called with every vertex id in dfs order and its depth, the search stops
+ * as soon as it returns false
+ * @param opt The depth limit and the workspace to reuse. Default = no limit, local buffers
+ * @return true if visit stopped the search
+ * @return false otherwise
+ */
+template <adjacency_range G, graph_visitor F>
+bool dfs(const G& g, uint32_t start, F&& visit, graph_search_options opt = {}) {
+    return dfs(g, std::span<const uint32_t>(&start, 1), std::forward<F>(visit), opt);
+}
+
+/**
+ * @brief Depth First Search (DFS) algorithm on a graph snapshot
+ *
+ * @param g The input graph(see graph<T>::csr_view())
+ * @param start The starting node
+ * @param key The key to search for
+ * @param opt The depth limit and the workspace to reuse. Default = no limit, local buffers
+ * @return true if the key is reachable from start within opt.max_depth arcs
+ * @return false otherwise
+ */
+template <typename T>
+bool dfs(const csr_graph<T>& g, const T& start, const T& key, graph_search_options opt = {}) {
+    uint32_t s = g.id(start), t = g.id(key);
+    if (s == csr_graph<T>::npos || t == csr_graph<T>::npos) {
+        return false;
+    }
+    return dfs(g, s, [t](uint32_t u, size_t) { return u != t; }, opt);
+}
+
 #endif
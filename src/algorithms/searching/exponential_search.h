@@ -8,14 +8,17 @@
 
 /**
  * @brief exponential search function
- * @param arr input array
+ * @param arr input array, sorted, taken by reference so it is not copied
  * @param key the element we want to search
  * @return int64_t index of the key in the array if it exists, otherwise returns
  * -1
  */
-template <typename T> int64_t exponential_search(std::vector<T> arr, T key) {
+template <typename T> int64_t exponential_search(const std::vector<T>& arr, T key) {
+    if (arr.empty()) {
+        return -1;
+    }
     if (arr[0] == key) {
-        return true;
+        return 0;
     }
     int64_t i = 1, n = arr.size();
     while (i < n && arr[i] < key) {
@@ -0,0 +1,65 @@
+#ifndef GRAPH_SEARCH_H
+#define GRAPH_SEARCH_H
+
+#include "../../classes/graph/vertex_index.h"
+
+#ifdef __cplusplus
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#endif
+
+namespace _graph_search_utils {
+/**
+ * @brief the out-neighbors of u: g.neighbors(u) for graph snapshots, g[u] for adjacency
+ * lists indexed by vertex id
+ */
+template <typename G>
+    requires requires(const G& g, uint32_t u) { g.neighbors(u); }
+decltype(auto) neighbors(const G& g, uint32_t u) {
+    return g.neighbors(u);
+}
+
+template <typename G>
+    requires(!requires(const G& g, uint32_t u) { g.neighbors(u); } &&
+             requires(const G& g, uint32_t u) { g[u]; })
+decltype(auto) neighbors(const G& g, uint32_t u) {
+    return g[u];
+}
+} // namespace _graph_search_utils
+
+/**
+ * @brief a graph whose vertices are the dense ids [0, g.size()) and whose out-neighbors of
+ * u are a range of ids, either g.neighbors(u)(csr_graph) or g[u](vector of vectors)
+ */
+template <typename G>
+concept adjacency_range = requires(const G& g, uint32_t u) {
+    { g.size() } -> std::convertible_to<size_t>;
+    requires std::ranges::input_range<decltype(_graph_search_utils::neighbors(g, u))>;
+    requires std::ranges::borrowed_range<decltype(_graph_search_utils::neighbors(g, u))>;
+    requires std::convertible_to<
+        std::ranges::range_value_t<decltype(_graph_search_utils::neighbors(g, u))>, uint32_t>;
+};
+
+/**
+ * @brief a visitor of bfs/dfs, called with a vertex id and its depth, the search stops
+ * as soon as it returns false
+ */
+template <typename F>
+concept graph_visitor = std::predicate<F&, uint32_t, size_t>;
+
+/**
+ * @brief graph_search_options struct
+ * max_depth: vertices deeper than this are neither visited nor expanded(the sources are
+ * at depth 0). Default = no limit.
+ * workspace: scratch buffers reused across searches so that repeated searches of a hot
+ * path do not allocate, a local one is used if it is null. Default = nullptr
+ */
+struct graph_search_options {
+    size_t max_depth = std::numeric_limits<size_t>::max();
+    graph_workspace* workspace = nullptr;
+};
+
+#endif
@@ -17,6 +17,8 @@
  * are uniformly distributed and works best when this assumption holds. On
  * average, its complexity is O(log(log(n))), but in the worst case, it can
  * become O(n).
+ * learned_index fits a line per segment of the keys instead, so it keeps a
+ * bounded error on keys that are not uniform.
  *
  * @tparam Iterator The type of iterator for the container.
  * @tparam T The type of the object (key) to be searched.
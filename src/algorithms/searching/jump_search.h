@@ -10,11 +10,14 @@
 
 /**
  * @brief jump search function
- * @param arr input array
+ * @param arr input array, sorted, taken by reference so it is not copied
  * @param key the element we want to search
  * @return int64_t index of key in the array if it exists, otherwise returns -1
  */
-template <typename T> int64_t jump_search(std::vector<T> arr, T key) {
+template <typename T> int64_t jump_search(const std::vector<T>& arr, T key) {
+    if (arr.empty()) {
+        return -1;
+    }
     int64_t n = arr.size(), step = sqrt(arr.size()), prev = 0;
     while (arr[std::min(step, n) - 1] < key) {
         prev = step;
@@ -0,0 +1,325 @@
+#ifndef LEARNED_INDEX_H
+#define LEARNED_INDEX_H
+
+#include "../../helpers/memory_usage.h"
+#include "binary_search.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace _learned_index_utils {
+template <typename T> constexpr size_t KEYS_PER_LINE = std::max<size_t>(1, 64 / sizeof(T));
+
+/**
+ * @brief b - a as a double, for a <= b, computed in the unsigned type of integer keys so
+ * that large timestamps keep their low bits
+ */
+template <typename T> double distance(const T& a, const T& b) {
+    if constexpr (std::is_integral_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        // wrapped back to U, narrow types would subtract as int and go negative
+        return double(U(U(b) - U(a)));
+    } else {
+        return double(b - a);
+    }
+}
+
+/**
+ * @brief lower bound in keys[a, b] when every key before a is less than x: the window
+ * doubles from a, so an answer d past a costs O(log d)
+ */
+template <typename T> size_t gallop_right(std::span<const T> keys, size_t a, size_t b, const T& x) {
+    size_t step = 1;
+    while (a + step < b && keys[a + step - 1] < x) {
+        a += step;
+        step *= 2;
+    }
+    const size_t e = std::min(a + step, b);
+    return a + branchless_lower_bound(keys.subspan(a, e - a), x);
+}
+
+/**
+ * @brief lower bound in keys[a, b] when keys[b] is not less than x, or b is the end
+ */
+template <typename T> size_t gallop_left(std::span<const T> keys, size_t a, size_t b, const T& x) {
+    size_t step = 1;
+    while (b - a > step && !(keys[b - step] < x)) {
+        b -= step;
+        step *= 2;
+    }
+    const size_t s = b - std::min(step, b - a);
+    return s + branchless_lower_bound(keys.subspan(s, b - s), x);
+}
+} // namespace _learned_index_utils
+
+/**
+ * @brief learned index class
+ * An index of sorted keys that learns where they are instead of comparing them
+ * (Ferragina and Vinciguerra, the PGM-index): the keys are cut in segments, each a line
+ * that predicts the position of its keys within epsilon, fitted in one pass by a shrinking
+ * cone of slopes(FITing-tree). The first keys of the segments are indexed the same way with
+ * a smaller error, level after level, up to a single segment. A lookup descends the levels,
+ * and on each one evaluates a line and searches the 2 * epsilon + 2 keys around the
+ * prediction with the branchless binary search, so a lookup in the keys costs one or two
+ * cache misses while the levels, a few bytes per segment, stay in cache. Unlike
+ * interpolation_search, the lines follow the distribution of the keys piece by piece, and
+ * smooth keys such as timestamps take few segments. Repeated keys are fine, a lookup
+ * gallops past a long run of them.
+ * The index keeps a view of the keys, not a copy: they must outlive it and not change,
+ * except for keys appended at the end, which extend() indexes without a full rebuild.
+ * @tparam T the type of the keys, an arithmetic type.
+ */
+template <typename T> class learned_index {
+    static_assert(std::is_arithmetic_v<T>, "learned_index needs arithmetic keys");
+
+  public:
+    /**
+     * @brief Construct a new learned index object
+     * @param sorted the keys, sorted in ascending order
+     * @param epsilon the largest error of a prediction in the keys. Default = 32
+     * @param recursive_epsilon the largest error in the levels above. Default = 4
+     * Throws std::invalid_argument if the keys are not sorted.
+     */
+    explicit learned_index(std::span<const T> sorted, size_t epsilon = 32,
+                           size_t recursive_epsilon = 4)
+        : _data(sorted), _epsilon(epsilon), _recursive_epsilon(recursive_epsilon) {
+        _refit(0);
+    }
+
+    /**
+     * @brief lower_bound function
+     * @param x the value to search
+     * @return size_t the index of the first key that is not less than x, size() if there is
+     * none
+     */
+    size_t lower_bound(const T& x) const {
+        if (_data.empty()) {
+            return 0;
+        }
+        size_t s = 0;
+        for (size_t l = _levels.size(); l-- > 0;) {
+            const std::span<const T> below = _below(l);
+            const size_t i = _search(l, s, below, x);
+            if (l == 0) {
+                return i;
+            }
+            // the last segment of the level below whose first key is not past x
+            s = i < below.size() && !(x < below[i]) ? i : (i == 0 ? 0 : i - 1);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief find function
+     * @param x the value to search
+     * @return int64_t the index of the first key equal to x, -1 if there is none
+     */
+    int64_t find(const T& x) const {
+        const size_t i = lower_bound(x);
+        return i < _data.size() && _data[i] == x ? int64_t(i) : -1;
+    }
+
+    /**
+     * @brief contains function
+     * @param x the value to search
+     * @return true if x is one of the keys
+     */
+    bool contains(const T& x) const { return find(x) != -1; }
+
+    /**
+     * @brief extend function
+     * Indexes the keys appended since the index was built: only the last segment of every
+     * level is fitted again, with the new keys, in O(new keys + levels).
+     * @param sorted the same keys with more at the end, sorted, possibly moved(a vector that
+     * grew)
+     * Throws std::invalid_argument if there are fewer keys or the new ones are not sorted.
+     */
+    void extend(std::span<const T> sorted) {
+        if (sorted.size() < _data.size()) {
+            throw std::invalid_argument("learned_index::extend: keys can only be appended");
+        }
+        // checked before anything changes, so the index stays usable if they are not sorted
+        for (size_t i = std::max<size_t>(_data.size(), 1); i < sorted.size(); i++) {
+            if (sorted[i] < sorted[i - 1]) {
+                throw std::invalid_argument("learned_index::extend: the keys are not sorted");
+            }
+        }
+        _data = sorted;
+        const size_t segments = _levels[0].models.size();
+        _refit(segments == 0 ? 0 : segments - 1);
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of keys
+     */
+    size_t size() const { return _data.size(); }
+
+    /**
+     * @brief segments function
+     * @return size_t the number of lines over the keys
+     */
+    size_t segments() const { return _levels.empty() ? 0 : _levels[0].keys.size(); }
+
+    /**
+     * @brief height function
+     * @return size_t the number of levels, a lookup evaluates one line per level
+     */
+    size_t height() const { return _levels.size(); }
+
+    /**
+     * @brief epsilon function
+     * @return size_t the largest error of a prediction in the keys
+     */
+    size_t epsilon() const { return _epsilon; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the levels, overhead since the keys are not copied
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        for (const level& lv : _levels) {
+            f += MEMORY::as_overhead(MEMORY::heap_usage(lv.keys));
+            f += MEMORY::as_overhead(MEMORY::heap_usage(lv.models));
+        }
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_levels));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    // the line of a segment: position start + slope * (x - its first key) in the level below
+    struct model {
+        double slope;
+        size_t start;
+    };
+
+    // the segments of a level: their first keys and their lines
+    struct level {
+        std::vector<T> keys;
+        std::vector<model> models;
+    };
+
+    std::span<const T> _data;
+    size_t _epsilon;
+    size_t _recursive_epsilon;
+    // _levels[0] over the keys, _levels[l] over the first keys of _levels[l - 1]
+    std::vector<level> _levels;
+
+    // the keys that the segments of level l predict
+    std::span<const T> _below(size_t l) const {
+        return l == 0 ? _data : std::span<const T>(_levels[l - 1].keys);
+    }
+
+    size_t _error(size_t l) const { return l == 0 ? _epsilon : _recursive_epsilon; }
+
+    /**
+     * @brief the lower bound of x in the keys below level l, with segment s of level l.
+     * The answer is between the start of s and that of the next segment, whose first key is
+     * past x, and within the error of the prediction but for the runs of a repeated key.
+     */
+    size_t _search(size_t l, size_t s, std::span<const T> below, const T& x) const {
+        namespace utils = _learned_index_utils;
+        const level& lv = _levels[l];
+        const size_t first = lv.models[s].start;
+        const size_t last = s + 1 < lv.models.size() ? lv.models[s + 1].start : below.size();
+        const T& key = lv.keys[s];
+        const double dx = key < x ? utils::distance(key, x) : 0.0;
+        const double guess = double(first) + lv.models[s].slope * dx;
+        const size_t p = guess >= double(last) ? last : size_t(guess);
+        const size_t err = _error(l);
+        const size_t lo = p - std::min(p - first, err);
+        const size_t hi = std::min(last, p + err + 2);
+        // the lines of the window are fetched at once rather than one per step of the search
+        for (size_t j = lo; j < hi; j += utils::KEYS_PER_LINE<T>) {
+            _binary_search_utils::prefetch(below.data() + j);
+        }
+        _binary_search_utils::prefetch(below.data() + hi - 1);
+        const size_t i = lo + branchless_lower_bound(below.subspan(lo, hi - lo), x);
+        if (i == hi && hi < last) {
+            return utils::gallop_right(below, hi, last, x);
+        }
+        if (i == lo && lo > first && !(below[lo - 1] < x)) {
+            return utils::gallop_left(below, first, lo - 1, x);
+        }
+        return i;
+    }
+
+    /**
+     * @brief fits the segments of level l again from segment from, and the levels above
+     * from the segment that holds it, adding or dropping levels until the top one has a
+     * single segment
+     */
+    void _refit(size_t from) {
+        for (size_t l = 0;; l++) {
+            if (l == _levels.size()) {
+                _levels.emplace_back();
+                from = 0;
+            }
+            _fit(l, from);
+            if (_levels[l].keys.size() <= 1) {
+                _levels.resize(l + 1);
+                return;
+            }
+            // the segment of level l + 1 that holds the first entry that changed
+            if (l + 1 < _levels.size()) {
+                const std::vector<model>& up = _levels[l + 1].models;
+                auto it = std::upper_bound(up.begin(), up.end(), from,
+                                           [](size_t i, const model& m) { return i < m.start; });
+                from = size_t(it - up.begin()) - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief fits the lines of level l over the keys below it, from the first key of its
+     * segment from: a segment starts at a key, and every next distinct key narrows the cone
+     * of slopes that keep the positions so far within the error. When the cone is empty the
+     * key starts the next segment, which takes the middle slope of the cone.
+     */
+    void _fit(size_t l, size_t from) {
+        level& lv = _levels[l];
+        const std::span<const T> below = _below(l);
+        const double err = double(_error(l));
+        size_t i = from < lv.models.size() ? lv.models[from].start : 0;
+        lv.keys.resize(std::min(from, lv.keys.size()));
+        lv.models.resize(lv.keys.size());
+        const size_t n = below.size();
+        while (i < n) {
+            const size_t start = i;
+            const T key = below[i];
+            double low = 0, high = std::numeric_limits<double>::infinity();
+            for (i++; i < n; i++) {
+                if (below[i] < below[i - 1]) {
+                    throw std::invalid_argument("learned_index: the keys are not sorted");
+                }
+                if (below[i] == below[i - 1]) {
+                    continue;
+                }
+                const double dx = _learned_index_utils::distance(key, below[i]);
+                const double dy = double(i - start);
+                const double lo = std::max(low, (dy - err) / dx);
+                const double hi = std::min(high, (dy + err) / dx);
+                if (lo > hi) {
+                    break;
+                }
+                low = lo;
+                high = hi;
+            }
+            lv.keys.push_back(key);
+            lv.models.push_back({std::isinf(high) ? 0.0 : (low + high) / 2, start});
+        }
+    }
+};
+
+#endif
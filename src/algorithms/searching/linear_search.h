@@ -1,11 +1,215 @@
 #ifndef LINEAR_SEARCH_H
 #define LINEAR_SEARCH_H
 
+#include "../../helpers/cpu_features.h"
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <span>
+#include <type_traits>
 #include <vector>
 #endif
 
+namespace _linear_search_utils {
+// the values of a chunk a thread scans at a time
+constexpr size_t chunk = 1 << 16;
+// values per step of the portable scan
+constexpr size_t block = 64;
+
+template <typename T>
+constexpr bool simd_type = (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                           std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/**
+ * @brief the index of the first value of p[i, n) equal to key, n if there is none
+ * @details a branch free test of every block of 64 values, which the compiler vectorizes,
+ * skips the blocks without a match.
+ */
+template <typename T> size_t next_scalar(const T* p, size_t n, size_t i, T key) {
+    for (; i + block <= n; i += block) {
+        bool any = false;
+        for (size_t j = 0; j < block; j++) {
+            any |= p[i + j] == key;
+        }
+        if (any) {
+            break;
+        }
+    }
+    for (; i < n; i++) {
+        if (p[i] == key) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#if defined(ALGOPLUS_X86_DISPATCH)
+template <typename T> ALGOPLUS_TARGET("avx2") __m256i broadcast(const T& key) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_castps_si256(_mm256_set1_ps(key));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm256_castpd_si256(_mm256_set1_pd(key));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm256_set1_epi8(char(key));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm256_set1_epi16(short(key));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm256_set1_epi32(int(key));
+    } else {
+        return _mm256_set1_epi64x((long long)(key));
+    }
+}
+
+/**
+ * @brief the bytes of the 32 bytes at p that belong to values equal to key, every lane that
+ * matches sets all the bits of its bytes
+ */
+template <typename T> ALGOPLUS_TARGET("avx2") uint32_t match(const T* p, __m256i k) {
+    if constexpr (std::is_same_v<T, float>) {
+        __m256 eq = _mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_castsi256_ps(k), _CMP_EQ_OQ);
+        return uint32_t(_mm256_movemask_epi8(_mm256_castps_si256(eq)));
+    } else if constexpr (std::is_same_v<T, double>) {
+        __m256d eq = _mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_castsi256_pd(k), _CMP_EQ_OQ);
+        return uint32_t(_mm256_movemask_epi8(_mm256_castpd_si256(eq)));
+    } else {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        if constexpr (sizeof(T) == 1) {
+            return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, k)));
+        } else if constexpr (sizeof(T) == 2) {
+            return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, k)));
+        } else if constexpr (sizeof(T) == 4) {
+            return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi32(v, k)));
+        } else {
+            return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi64(v, k)));
+        }
+    }
+}
+
+/**
+ * @brief next_scalar with AVX2: 32 bytes are compared per instruction and four vectors are
+ * tested per branch
+ */
+template <typename T>
+ALGOPLUS_TARGET("avx2") size_t next_avx2(const T* p, size_t n, size_t i, T key) {
+    constexpr size_t L = 32 / sizeof(T);
+    const __m256i k = broadcast(key);
+    for (; i + 4 * L <= n; i += 4 * L) {
+        uint32_t masks[4] = {match(p + i, k), match(p + i + L, k), match(p + i + 2 * L, k),
+                             match(p + i + 3 * L, k)};
+        if ((masks[0] | masks[1] | masks[2] | masks[3]) == 0) {
+            continue;
+        }
+        for (size_t v = 0; v < 4; v++) {
+            if (masks[v] != 0) {
+                return i + v * L + size_t(std::countr_zero(masks[v])) / sizeof(T);
+            }
+        }
+    }
+    for (; i + L <= n; i += L) {
+        if (uint32_t m = match(p + i, k); m != 0) {
+            return i + size_t(std::countr_zero(m)) / sizeof(T);
+        }
+    }
+    for (; i < n; i++) {
+        if (p[i] == key) {
+            return i;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief the lanes of the 64 bytes at p whose value is key, one bit per lane
+ */
+template <typename T>
+ALGOPLUS_TARGET("avx512f,avx512bw") uint64_t match512(const T* p, const T& key) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm512_cmp_ps_mask(_mm512_loadu_ps(p), _mm512_set1_ps(key), _CMP_EQ_OQ);
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm512_cmp_pd_mask(_mm512_loadu_pd(p), _mm512_set1_pd(key), _CMP_EQ_OQ);
+    } else {
+        __m512i v = _mm512_loadu_si512(p);
+        if constexpr (sizeof(T) == 1) {
+            return _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(char(key)));
+        } else if constexpr (sizeof(T) == 2) {
+            return _mm512_cmpeq_epi16_mask(v, _mm512_set1_epi16(short(key)));
+        } else if constexpr (sizeof(T) == 4) {
+            return _mm512_cmpeq_epi32_mask(v, _mm512_set1_epi32(int(key)));
+        } else {
+            return _mm512_cmpeq_epi64_mask(v, _mm512_set1_epi64((long long)(key)));
+        }
+    }
+}
+
+/**
+ * @brief next_scalar with AVX-512: the compares give a mask of lanes, two vectors per branch
+ */
+template <typename T>
+ALGOPLUS_TARGET("avx512f,avx512bw") size_t next_avx512(const T* p, size_t n, size_t i, T key) {
+    constexpr size_t L = 64 / sizeof(T);
+    for (; i + 2 * L <= n; i += 2 * L) {
+        uint64_t m0 = match512(p + i, key), m1 = match512(p + i + L, key);
+        if ((m0 | m1) == 0) {
+            continue;
+        }
+        return m0 != 0 ? i + size_t(std::countr_zero(m0)) : i + L + size_t(std::countr_zero(m1));
+    }
+    for (; i < n; i++) {
+        if (p[i] == key) {
+            return i;
+        }
+    }
+    return n;
+}
+#endif
+
+/**
+ * @brief the versions of next_scalar, selected by SIMD::active()
+ */
+template <typename T> const SIMD::kernels<size_t(const T*, size_t, size_t, T)>& finder() {
+    static const SIMD::kernels<size_t(const T*, size_t, size_t, T)> k{
+        .scalar = &next_scalar<T>,
+#if defined(ALGOPLUS_X86_DISPATCH)
+        .avx2 = &next_avx2<T>,
+        .avx512 = &next_avx512<T>,
+#endif
+    };
+    return k;
+}
+
+/**
+ * @brief calls found(i) for the indices i of p[0, n) whose value is key, in order, until
+ * found returns false
+ * @return bool false if found stopped the scan.
+ * @details the kernel of the instruction set of the cpu finds the matches one after the
+ * other.
+ */
+template <typename T, typename F> bool scan(const T* p, size_t n, const T& key, F&& found) {
+    if constexpr (simd_type<T>) {
+        auto next = finder<T>().get();
+        for (size_t i = next(p, n, 0, key); i < n; i = next(p, n, i + 1, key)) {
+            if (!found(i)) {
+                return false;
+            }
+        }
+        return true;
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            if (p[i] == key && !found(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+} // namespace _linear_search_utils
+
 /**
  * @brief linear search function
  * @param arr input array
@@ -13,9 +217,73 @@
  * @return true if key exists in the array
  * @return false otherwise
  */
-template <typename T> bool linear_search(std::vector<T> arr, T key) {
+template <typename T> bool linear_search(const std::vector<T>& arr, T key) {
     return std::find_if(arr.begin(), arr.end(), [key](const auto& x) { return x == key; }) !=
            arr.end();
 }
 
+/**
+ * @brief linear find function
+ * @param arr the values, a span so nothing is copied
+ * @param key the element we want to search
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return int64_t the index of the first value equal to key, -1 if there is none
+ * @details the values are compared 32 or 64 bytes at a time on a cpu with AVX2 or AVX-512.
+ * With threads > 1 the threads take chunks of 65536 values in order, and skip the chunks that
+ * start after a match that is already found.
+ */
+template <typename T>
+int64_t linear_find(std::span<const T> arr, const std::type_identity_t<T>& key,
+                    size_t threads = 1) {
+    namespace utils = _linear_search_utils;
+    size_t chunks = (arr.size() + utils::chunk - 1) / utils::chunk;
+    threads = PARALLEL::resolve_threads(threads, chunks);
+    std::atomic<size_t> first{arr.size()};
+    PARALLEL::parallel_for_dynamic(0, chunks, threads, [&](size_t c, size_t) {
+        size_t lo = c * utils::chunk, n = std::min(utils::chunk, arr.size() - lo);
+        if (lo >= first.load(std::memory_order_relaxed)) {
+            return;
+        }
+        utils::scan(arr.data() + lo, n, key, [&](size_t i) {
+            size_t at = lo + i, cur = first.load(std::memory_order_relaxed);
+            while (at < cur && !first.compare_exchange_weak(cur, at)) {
+            }
+            return false;
+        });
+    });
+    size_t i = first.load();
+    return i < arr.size() ? int64_t(i) : -1;
+}
+
+/**
+ * @brief linear find all function
+ * @param arr the values, a span so nothing is copied
+ * @param key the element we want to search
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return std::vector<size_t> the indices of all the values equal to key, in order
+ * @details every thread scans a contiguous part of the values into its own list, and the
+ * lists are joined in order.
+ */
+template <typename T>
+std::vector<size_t> linear_find_all(std::span<const T> arr, const std::type_identity_t<T>& key,
+                                    size_t threads = 1) {
+    namespace utils = _linear_search_utils;
+    threads = PARALLEL::resolve_threads(threads, arr.size() / utils::chunk + 1);
+    std::vector<std::vector<size_t>> found(threads);
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            size_t a = arr.size() * t / threads, b = arr.size() * (t + 1) / threads;
+            utils::scan(arr.data() + a, b - a, key, [&](size_t i) {
+                found[t].push_back(a + i);
+                return true;
+            });
+        }
+    });
+    std::vector<size_t> all = std::move(found[0]);
+    for (size_t t = 1; t < threads; t++) {
+        all.insert(all.end(), found[t].begin(), found[t].end());
+    }
+    return all;
+}
+
 #endif
@@ -1,38 +1,105 @@
 #ifndef BUCKET_SORT_H
 #define BUCKET_SORT_H
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <random>
+#include <utility>
 #include <vector>
 #endif
 
+namespace _bucket_sort_utils {
+// inputs shorter than this are sorted directly
+constexpr size_t direct = 4096;
+// the most splitters, and the number of samples per splitter
+constexpr size_t max_splitters = 255;
+constexpr size_t oversampling = 16;
+
+/**
+ * @brief the bucket of x: with the splitters s sorted and distinct, 2i holds the values
+ * between s[i - 1] and s[i] and 2i + 1 the values equal to s[i], so a splitter that is
+ * repeated a lot gets a bucket of its own that needs no sorting.
+ */
+template <typename T> size_t classify(const std::vector<T>& s, const T& x) {
+    size_t i = size_t(std::lower_bound(s.begin(), s.end(), x) - s.begin());
+    return 2 * i + (i < s.size() && !(x < s[i]));
+}
+} // namespace _bucket_sort_utils
+
 /**
  * @brief bucket sort function
  * @param arr input array
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @details A samplesort: the splitters of the buckets are picked from a sorted random
+ * sample of the values, so the buckets hold about as many values whatever their
+ * distribution is, and the values equal to a splitter get a bucket of their own, so many
+ * copies of one value do not make one bucket huge. The values are counted and moved to
+ * their buckets by every thread on its own chunk, and the buckets are then sorted by the
+ * threads in parallel. It works for every type with operator<.
  */
-template <typename T> void bucket_sort(std::vector<T>& arr) {
-    if (std::is_same_v<T, int> || std::is_same_v<T, int64_t>) {
+template <typename T> void bucket_sort(std::vector<T>& arr, size_t threads = 1) {
+    namespace utils = _bucket_sort_utils;
+    size_t n = arr.size();
+    if (n <= utils::direct) {
         std::sort(arr.begin(), arr.end());
         return;
     }
-    std::vector<float> buckets[arr.size()];
-    for (int64_t i = 0; i < arr.size(); i++) {
-        int64_t index = arr.size() * arr[i];
-        buckets[index].push_back(arr[i]);
+    size_t k = std::min(utils::max_splitters, n / utils::direct);
+    std::vector<T> sample;
+    sample.reserve(k * utils::oversampling);
+    std::mt19937_64 rng(n);
+    for (size_t i = 0; i < k * utils::oversampling; i++) {
+        sample.push_back(arr[rng() % n]);
     }
-
-    for (int64_t i = 0; i < arr.size(); i++) {
-        std::sort(buckets[i].begin(), buckets[i].end());
+    std::sort(sample.begin(), sample.end());
+    std::vector<T> splitters;
+    for (size_t i = 1; i <= k; i++) {
+        const T& s = sample[i * utils::oversampling - 1];
+        if (splitters.empty() || splitters.back() < s) {
+            splitters.push_back(s);
+        }
     }
-
-    int64_t index = 0;
-    for (int64_t i = 0; i < arr.size(); i++) {
-        for (int64_t j = 0; j < buckets[i].size(); j++) {
-            arr[index++] = buckets[i][j];
+    size_t buckets = 2 * splitters.size() + 1;
+    threads = PARALLEL::resolve_threads(threads, n / utils::direct);
+    std::vector<size_t> bound(threads + 1);
+    for (size_t t = 0; t <= threads; t++) {
+        bound[t] = n * t / threads;
+    }
+    // count[t][b]: the values of the chunk t in the bucket b, then where the next one goes
+    std::vector<std::vector<size_t>> count(threads, std::vector<size_t>(buckets, 0));
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            for (size_t i = bound[t]; i < bound[t + 1]; i++) {
+                count[t][utils::classify(splitters, arr[i])]++;
+            }
+        }
+    });
+    std::vector<size_t> start(buckets + 1, 0);
+    for (size_t b = 0, sum = 0; b < buckets; b++) {
+        start[b] = sum;
+        for (size_t t = 0; t < threads; t++) {
+            sum += std::exchange(count[t][b], sum);
         }
     }
+    start[buckets] = n;
+    std::vector<T> out(n);
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            for (size_t i = bound[t]; i < bound[t + 1]; i++) {
+                out[count[t][utils::classify(splitters, arr[i])]++] = std::move(arr[i]);
+            }
+        }
+    });
+    // the even buckets hold ranges of values, the odd ones copies of a splitter
+    PARALLEL::parallel_for_dynamic(0, splitters.size() + 1, threads, [&](size_t i, size_t) {
+        std::sort(out.begin() + start[2 * i], out.begin() + start[2 * i + 1]);
+    });
+    arr.swap(out);
 }
 
 #endif
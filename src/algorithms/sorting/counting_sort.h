@@ -1,40 +1,63 @@
 #ifndef ALGOPLUS_COUNTING_SORT_H
 #define ALGOPLUS_COUNTING_SORT_H
 
+#include "radix_sort.h"
+
 #ifdef __cplusplus
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 #endif
 
+/**
+ * @brief the largest key range counting_sort counts by default, larger ranges are radix
+ * sorted
+ */
+inline constexpr size_t counting_sort_max_range = size_t(1) << 24;
+
 /**
  * @brief Performs counting sort on a vector of elements.
- * @tparam T The type of elements in the vector.
+ * @tparam T The type of elements in the vector, an integer type.
  * @param arr The vector to be sorted.
+ * @param max_range the largest range of keys that is counted. Default =
+ * counting_sort_max_range
+ * @details The occurrences of every key between the smallest and the largest are counted,
+ * and the keys are written back in order, so the sort takes O(n + range) time and memory.
+ * If the range of the keys is larger than max_range or than 4 times the size of the vector,
+ * the counts would cost more than the keys, and the vector is radix sorted instead, so one
+ * outlier never allocates a huge count array.
  */
-template <typename T> void counting_sort(std::vector<T>& arr) {
-    T maxElement = std::max(0, *max_element(arr.begin(), arr.end()));
-    std::vector<T> count(maxElement + 1, 0);
-    std::vector<T> output(arr.size());
-
-    // Store count of each element
-    for (int64_t i = 0; i < arr.size(); i++) {
-        count[arr[i]]++;
+template <typename T>
+void counting_sort(std::vector<T>& arr, size_t max_range = counting_sort_max_range) {
+    static_assert(std::is_integral_v<T>, "counting_sort needs integer keys");
+    if (arr.size() < 2) {
+        return;
     }
-
-    // Change count[i] so that count[i] now contains actual position of this
-    // element in output array
-    for (int64_t i = 1; i <= maxElement; i++) {
-        count[i] += count[i - 1];
+    auto [lo, hi] = std::minmax_element(arr.begin(), arr.end());
+    T minElement = *lo;
+    // the range less one as an unsigned number, it does not overflow even for the whole type
+    using U = std::make_unsigned_t<T>;
+    uint64_t span = uint64_t(U(U(*hi) - U(minElement)));
+    if (span >= max_range || span >= 4 * uint64_t(arr.size()) + 1024) {
+        radix_sort(arr.begin(), arr.end());
+        return;
     }
+    size_t range = size_t(span) + 1;
+    std::vector<size_t> count(range, 0);
 
-    // Build the output array
-    for (int64_t i = arr.size() - 1; i >= 0; i--) {
-        output[count[arr[i]] - 1] = arr[i];
-        count[arr[i]]--;
+    // Store count of each element
+    for (const T& x : arr) {
+        count[U(U(x) - U(minElement))]++;
     }
 
-    arr = output;
+    // Write every key as many times as it occurs
+    size_t index = 0;
+    for (size_t k = 0; k < range; k++) {
+        std::fill_n(arr.begin() + index, count[k], T(U(minElement) + U(k)));
+        index += count[k];
+    }
 }
 
 #endif // ALGOPLUS_COUNTING_SORT_H
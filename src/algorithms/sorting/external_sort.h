@@ -0,0 +1,379 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include "merge_sort.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief the options of external_sort
+ * run_bytes: bytes of values sorted in memory per run, two runs are held at once.
+ * buffer_bytes: bytes of every read or write buffer of the merge, two per run.
+ * fan_in: the most runs merged at once, more runs are merged in several passes.
+ * threads: threads of the in memory sort(0 means every hardware thread).
+ * temp_dir: the directory of the run files, they are removed when the sort ends.
+ */
+struct external_sort_options {
+    size_t run_bytes = size_t(1) << 28;
+    size_t buffer_bytes = size_t(1) << 20;
+    size_t fan_in = 128;
+    size_t threads = 0;
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+};
+
+namespace _external_sort_utils {
+/**
+ * @brief reads up to n values of in into buf
+ * @return size_t the number of values read.
+ * Throws std::runtime_error if the input ends inside a value.
+ */
+template <typename T> size_t read(std::istream& in, T* buf, size_t n) {
+    in.read(reinterpret_cast<char*>(buf), std::streamsize(n * sizeof(T)));
+    size_t bytes = size_t(in.gcount());
+    if (bytes % sizeof(T) != 0) {
+        throw std::runtime_error("external_sort: the input ends inside a value");
+    }
+    return bytes / sizeof(T);
+}
+
+template <typename T> void write(std::ostream& out, const T* buf, size_t n) {
+    out.write(reinterpret_cast<const char*>(buf), std::streamsize(n * sizeof(T)));
+    if (!out) {
+        throw std::runtime_error("external_sort: can't write the output");
+    }
+}
+
+/**
+ * @brief the run files of a sort, removed with it
+ */
+class run_files {
+  public:
+    explicit run_files(std::filesystem::path dir) : _dir(std::move(dir)) {
+        _token = std::to_string(std::random_device{}());
+    }
+
+    run_files(const run_files&) = delete;
+    run_files& operator=(const run_files&) = delete;
+
+    ~run_files() {
+        std::error_code ec;
+        for (const auto& p : _paths) {
+            std::filesystem::remove(p, ec);
+        }
+    }
+
+    std::filesystem::path create() {
+        _paths.push_back(_dir / ("algoplus_sort_" + _token + "_" + std::to_string(_next++)));
+        return _paths.back();
+    }
+
+    void remove(const std::filesystem::path& p) {
+        std::error_code ec;
+        std::filesystem::remove(p, ec);
+        _paths.erase(std::find(_paths.begin(), _paths.end(), p));
+    }
+
+  private:
+    std::filesystem::path _dir;
+    std::string _token;
+    size_t _next{0};
+    std::vector<std::filesystem::path> _paths;
+};
+
+/**
+ * @brief sequential reader of a run file with two buffers: the next block is read by a
+ * background task while the current one is merged.
+ */
+template <typename T> class run_reader {
+  public:
+    run_reader(const std::filesystem::path& p, size_t block)
+        : _in(p, std::ios::binary), _cur(block), _next(block) {
+        if (!_in) {
+            throw std::runtime_error("external_sort: can't open run " + p.string());
+        }
+        _size = read(_in, _cur.data(), block);
+        _prefetch();
+    }
+
+    // the background read refers to the reader
+    run_reader(const run_reader&) = delete;
+    run_reader& operator=(const run_reader&) = delete;
+
+    bool done() const { return _pos == _size; }
+    const T& head() const { return _cur[_pos]; }
+
+    void pop() {
+        if (++_pos == _size && _size > 0) {
+            _size = _pending.get();
+            std::swap(_cur, _next);
+            _pos = 0;
+            _prefetch();
+        }
+    }
+
+  private:
+    std::ifstream _in;
+    std::vector<T> _cur, _next;
+    size_t _pos{0}, _size{0};
+    std::future<size_t> _pending;
+
+    void _prefetch() {
+        if (_size == 0) {
+            return;
+        }
+        _pending = std::async(std::launch::async,
+                              [this] { return read(_in, _next.data(), _next.size()); });
+    }
+};
+
+/**
+ * @brief buffered writer that hands full buffers to a background task, so the merge goes
+ * on while the previous buffer is written
+ */
+template <typename T> class block_writer {
+  public:
+    block_writer(std::ostream& out, size_t block) : _out(out), _cur(block), _next(block) {}
+
+    ~block_writer() {
+        if (_pending.valid()) {
+            _pending.wait();
+        }
+    }
+
+    void push(const T& x) {
+        _cur[_size++] = x;
+        if (_size == _cur.size()) {
+            _flush();
+        }
+    }
+
+    void finish() {
+        _flush();
+        if (_pending.valid()) {
+            _pending.get();
+        }
+    }
+
+  private:
+    std::ostream& _out;
+    std::vector<T> _cur, _next;
+    size_t _size{0};
+    std::future<void> _pending;
+
+    void _flush() {
+        if (_pending.valid()) {
+            _pending.get();
+        }
+        std::swap(_cur, _next);
+        size_t n = std::exchange(_size, 0);
+        _pending = std::async(std::launch::async, [this, n] { write(_out, _next.data(), n); });
+    }
+};
+
+/**
+ * @brief loser tree of k players: every inner node keeps the loser of the match played
+ * there and _tree[0] the overall winner, so replacing the winner replays only the
+ * log2(k) matches on its path to the root.
+ */
+template <typename Beats> class loser_tree {
+  public:
+    loser_tree(size_t k, Beats beats) : _k(k), _tree(std::max<size_t>(k, 1)), _beats(beats) {
+        _tree[0] = _play(1);
+    }
+
+    size_t winner() const { return _tree[0]; }
+
+    // the winner has a new value, it plays again from its leaf
+    void replay() {
+        size_t w = _tree[0];
+        for (size_t node = (w + _k) / 2; node > 0; node /= 2) {
+            if (_beats(_tree[node], w)) {
+                std::swap(_tree[node], w);
+            }
+        }
+        _tree[0] = w;
+    }
+
+  private:
+    size_t _k;
+    std::vector<size_t> _tree;
+    Beats _beats;
+
+    size_t _play(size_t node) {
+        if (node >= _k) {
+            return node - _k;
+        }
+        size_t a = _play(2 * node), b = _play(2 * node + 1);
+        if (_beats(a, b)) {
+            _tree[node] = b;
+            return a;
+        }
+        _tree[node] = a;
+        return b;
+    }
+};
+
+/**
+ * @brief k-way merge of the runs into out. A run beats another if it is not done and its
+ * head comes first, the earlier run on ties, so the merge is stable.
+ */
+template <typename T, typename Compare>
+size_t merge(const std::vector<std::filesystem::path>& runs, std::ostream& out, Compare& comp,
+             size_t block) {
+    std::deque<run_reader<T>> readers;
+    for (const auto& p : runs) {
+        readers.emplace_back(p, block);
+    }
+    auto beats = [&](size_t a, size_t b) {
+        if (readers[a].done() || readers[b].done()) {
+            return !readers[a].done() || (readers[b].done() && a < b);
+        }
+        if (comp(readers[a].head(), readers[b].head())) {
+            return true;
+        }
+        return !comp(readers[b].head(), readers[a].head()) && a < b;
+    };
+    loser_tree<decltype(beats)> tree(readers.size(), beats);
+    block_writer<T> writer(out, block);
+    size_t n = 0;
+    for (size_t w = tree.winner(); !readers[w].done(); w = tree.winner()) {
+        writer.push(readers[w].head());
+        readers[w].pop();
+        tree.replay();
+        n++;
+    }
+    writer.finish();
+    return n;
+}
+} // namespace _external_sort_utils
+
+/**
+ * @brief sorts the values of a binary stream that may not fit in memory
+ * @tparam T the type of the values, trivially copyable, stored back to back.
+ * @param in the input, read till its end.
+ * @param out the output, it gets the sorted values.
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ * @param opt the sizes of the buffers, the threads and the directory of the runs.
+ * @details an external merge sort: runs of run_bytes are read, sorted in memory by
+ * merge_sort on opt.threads threads and written to run files by a background task while the
+ * next run is read and sorted. The runs are then merged through a loser tree by fan_in at
+ * a time, the readers prefetching their next block and the writer writing in the
+ * background, until a single merge writes out. An input that fits in one run never goes
+ * to disk. The sort is stable.
+ * @return size_t the number of values sorted.
+ * Throws std::runtime_error if a run file can not be written or read, or if the input ends
+ * inside a value, std::invalid_argument if a size of opt is too small.
+ */
+template <typename T, typename Compare = std::less<>>
+size_t external_sort(std::istream& in, std::ostream& out, Compare comp = Compare(),
+                     const external_sort_options& opt = {}) {
+    static_assert(std::is_trivially_copyable_v<T>, "external_sort needs trivially copyable T");
+    namespace utils = _external_sort_utils;
+    size_t run = opt.run_bytes / sizeof(T), block = opt.buffer_bytes / sizeof(T);
+    if (run == 0 || block == 0 || opt.fan_in < 2) {
+        throw std::invalid_argument("external_sort: runs and buffers need a value, fan_in 2");
+    }
+    utils::run_files files(opt.temp_dir);
+    std::vector<std::filesystem::path> runs;
+    std::vector<T> buf(run), spill(run);
+    std::future<void> pending;
+    size_t total = 0;
+    for (;;) {
+        size_t n = utils::read(in, buf.data(), run);
+        if (n == 0) {
+            break;
+        }
+        total += n;
+        merge_sort(buf.begin(), buf.begin() + n, comp, opt.threads);
+        if (runs.empty() && n < run) {
+            // all of it was one run
+            utils::write(out, buf.data(), n);
+            return total;
+        }
+        if (pending.valid()) {
+            pending.get();
+        }
+        std::swap(buf, spill);
+        runs.push_back(files.create());
+        pending = std::async(std::launch::async, [&spill, n, p = runs.back()] {
+            std::ofstream file(p, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("external_sort: can't create run " + p.string());
+            }
+            utils::write(file, spill.data(), n);
+        });
+    }
+    if (pending.valid()) {
+        pending.get();
+    }
+    buf = {};
+    spill = {};
+    while (runs.size() > opt.fan_in) {
+        std::vector<std::filesystem::path> next;
+        for (size_t i = 0; i < runs.size(); i += opt.fan_in) {
+            std::vector<std::filesystem::path> group(
+                runs.begin() + i, runs.begin() + std::min(runs.size(), i + opt.fan_in));
+            if (group.size() == 1) {
+                next.push_back(group[0]);
+                continue;
+            }
+            next.push_back(files.create());
+            std::ofstream file(next.back(), std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("external_sort: can't create run " +
+                                         next.back().string());
+            }
+            utils::merge<T>(group, file, comp, block);
+            for (const auto& p : group) {
+                files.remove(p);
+            }
+        }
+        runs = std::move(next);
+    }
+    if (!runs.empty()) {
+        utils::merge<T>(runs, out, comp, block);
+    }
+    return total;
+}
+
+/**
+ * @brief sorts the values of a binary file that may not fit in memory into another file
+ * @tparam T the type of the values, trivially copyable, stored back to back.
+ * @param input the path of the input file.
+ * @param output the path of the output file, it may not be the input.
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ * @param opt the sizes of the buffers, the threads and the directory of the runs.
+ * @return size_t the number of values sorted.
+ * Throws std::runtime_error if a file can not be opened, see external_sort above.
+ */
+template <typename T, typename Compare = std::less<>>
+size_t external_sort(const std::filesystem::path& input, const std::filesystem::path& output,
+                     Compare comp = Compare(), const external_sort_options& opt = {}) {
+    std::ifstream in(input, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("external_sort: can't open " + input.string());
+    }
+    std::ofstream out(output, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("external_sort: can't open " + output.string());
+    }
+    return external_sort<T>(in, out, comp, opt);
+}
+
+#endif // EXTERNAL_SORT_H
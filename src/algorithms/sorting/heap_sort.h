@@ -3,7 +3,10 @@
 
 #ifdef __cplusplus
 #include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <utility>
 #include <vector>
 #endif
 
@@ -38,20 +41,51 @@ template <typename T> static void heapify_method(std::vector<T>& arr, int64_t n,
 }
 
 /**
- * @brief heap sort function
- * @param arr input array
+ * @brief sift down of a max heap of the n values at first, without recursion
+ * @param first random access iterator to the root of the heap
+ * @param n the size of the heap
+ * @param parent the index whose value moves down
+ * @param comp strict weak ordering, the largest value is at the root
  */
-template <typename T> void heap_sort(std::vector<T>& arr) {
-    int64_t n = arr.size();
-    // heapify the array at first
-    for (int64_t i = n / 2 - 1; i >= 0; i--) {
-        heapify_method(arr, n, i);
+template <typename Iter, typename Compare>
+void heap_sift_down(Iter first, size_t n, size_t parent, Compare& comp) {
+    auto x = std::move(first[parent]);
+    for (size_t child = 2 * parent + 1; child < n; child = 2 * parent + 1) {
+        if (child + 1 < n && comp(first[child], first[child + 1])) {
+            child++;
+        }
+        if (!comp(x, first[child])) {
+            break;
+        }
+        first[parent] = std::move(first[child]);
+        parent = child;
     }
-    for (int64_t i = n - 1; i >= 0; i--) {
-        std::swap(arr[0], arr[i]);
+    first[parent] = std::move(x);
+}
 
-        heapify_method(arr, i, 0);
+/**
+ * @brief heap sort function
+ * @param first random access iterator to the first element
+ * @param last random access iterator one past the last element
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ * Sorts in place in O(n log(n)) in every case, with no recursion and no extra memory.
+ */
+template <typename Iter, typename Compare = std::less<>>
+void heap_sort(Iter first, Iter last, Compare comp = Compare()) {
+    size_t n = static_cast<size_t>(last - first);
+    for (size_t i = n / 2; i-- > 0;) {
+        heap_sift_down(first, n, i, comp);
+    }
+    for (size_t i = n; i-- > 1;) {
+        std::swap(first[0], first[i]);
+        heap_sift_down(first, i, 0, comp);
     }
 }
 
+/**
+ * @brief heap sort function
+ * @param arr input array
+ */
+template <typename T> void heap_sort(std::vector<T>& arr) { heap_sort(arr.begin(), arr.end()); }
+
 #endif
@@ -4,6 +4,7 @@
 #ifdef __cplusplus
 #include <cstdint>
 #include <iostream>
+#include <utility>
 #include <vector>
 #endif
 
@@ -12,12 +13,13 @@
  * @param arr input array
  */
 template <typename T> void insertion_sort(std::vector<T>& arr) {
-    for (int64_t i = 1; i < arr.size(); i++) {
+    for (int64_t i = 1; i < int64_t(arr.size()); i++) {
+        T key = std::move(arr[i]);
         int64_t j = i - 1;
-        for (; j >= 0 && arr[j] > arr[i]; j--) {
-            arr[j + 1] = arr[j];
+        for (; j >= 0 && arr[j] > key; j--) {
+            arr[j + 1] = std::move(arr[j]);
         }
-        arr[j + 1] = arr[i];
+        arr[j + 1] = std::move(key);
     }
 }
 
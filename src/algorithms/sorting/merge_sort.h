@@ -1,29 +1,158 @@
 #ifndef MERGE_SORT_H
 #define MERGE_SORT_H
 
-#include <algorithm> // Required for std::inplace_merge
+#include "../../helpers/parallel.h"
+#include "../../helpers/trace.h"
+#include "sorting_network.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+namespace _merge_sort_utils {
+// runs this short are sorted with insertion sort
+constexpr size_t cutoff = 32;
+// merges shorter than this are not split between threads
+constexpr size_t parallel_merge_min = 1 << 14;
+
+/**
+ * @brief stable insertion sort of [a, a + n), or a sorting network for integers, whose
+ * equal values cannot be told apart
+ */
+template <typename A, typename Compare> void insertion(A a, size_t n, Compare& comp) {
+    if constexpr (_sorting_network_utils::network_sortable<A, Compare> &&
+                  std::is_integral_v<typename std::iterator_traits<A>::value_type>) {
+        network_sort(a, a + n);
+        return;
+    }
+    for (size_t i = 1; i < n; i++) {
+        auto x = std::move(a[i]);
+        size_t j = i;
+        for (; j > 0 && comp(x, a[j - 1]); j--) {
+            a[j] = std::move(a[j - 1]);
+        }
+        a[j] = std::move(x);
+    }
+}
+
+/**
+ * @brief co-rank of k: the number of values of a that are among the first k of the
+ * stable merge of a(n1 values) and b(n2 values), a wins the ties.
+ */
+template <typename A, typename Compare>
+size_t co_rank(size_t k, A a, size_t n1, A b, size_t n2, Compare& comp) {
+    size_t lo = k > n2 ? k - n2 : 0, hi = std::min(k, n1);
+    // the smallest i where a[i] comes after b[k - i - 1], so a[0, i) and b[0, k - i) are
+    // the first k of the merge
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2, j = k - i;
+        if (j == 0 || comp(b[j - 1], a[i])) {
+            hi = i;
+        } else {
+            lo = i + 1;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief stable merge of the sorted halves src[0, mid) and src[mid, n) into dst, split by
+ * co-rank in contiguous parts of the output that threads merge on their own.
+ */
+template <typename A, typename B, typename Compare>
+void merge(A src, size_t mid, size_t n, B dst, Compare& comp, size_t threads) {
+    auto mv = [](auto it) { return std::make_move_iterator(it); };
+    size_t parts = std::min(threads, n / parallel_merge_min + 1);
+    PARALLEL::parallel_for(0, parts, parts, [&](size_t lo, size_t hi, size_t) {
+        for (size_t p = lo; p < hi; p++) {
+            size_t k0 = n * p / parts, k1 = n * (p + 1) / parts;
+            size_t i0 = co_rank(k0, src, mid, src + mid, n - mid, comp);
+            size_t i1 = co_rank(k1, src, mid, src + mid, n - mid, comp);
+            size_t j0 = k0 - i0, j1 = k1 - i1;
+            std::merge(mv(src + i0), mv(src + i1), mv(src + mid + j0), mv(src + mid + j1),
+                       dst + k0, comp);
+        }
+    });
+}
+
+/**
+ * @brief sorts the n values of src, the result ends up in dst if to_dst and in src
+ * otherwise. The halves are sorted into the other buffer of the two, so every level of
+ * the recursion merges from one buffer into the other and nothing is copied back.
+ */
+template <typename A, typename B, typename Compare>
+void sort(A src, B dst, size_t n, bool to_dst, Compare& comp, size_t threads) {
+    if (n <= cutoff) {
+        insertion(src, n, comp);
+        if (to_dst) {
+            std::move(src, src + n, dst);
+        }
+        return;
+    }
+    size_t mid = n / 2;
+    if (threads > 1) {
+        size_t left = threads / 2;
+        std::thread worker([&] { sort(src, dst, mid, !to_dst, comp, left); });
+        sort(src + mid, dst + mid, n - mid, !to_dst, comp, threads - left);
+        worker.join();
+    } else {
+        sort(src, dst, mid, !to_dst, comp, 1);
+        sort(src + mid, dst + mid, n - mid, !to_dst, comp, 1);
+    }
+    if (to_dst) {
+        merge(src, mid, n, dst, comp, threads);
+    } else {
+        merge(dst, mid, n, src, comp, threads);
+    }
+}
+} // namespace _merge_sort_utils
+
 /**
  * @brief Performs a merge sort on a range of elements.
  * @param begin An iterator to the beginning of the range to be sorted.
  * @param end An iterator to the end of the range to be sorted.
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ * @param threads number of threads(0 means every hardware thread). Default = 1
  * @details This function sorts the elements in the range [begin, end) into
- * ascending order. The sort is performed in-place. It divides the range into
- * two halves, recursively sorts each half, and then merges the two sorted
- * halves together. The function requires that the range of elements is sortable
- * by the criteria used in std::inplace_merge.
+ * ascending order, and it is stable: equal elements keep their order. It uses one
+ * scratch buffer of the size of the range, allocated once, and the two halves of every
+ * range are sorted into the other buffer and merged back, with runs of up to 32 elements
+ * sorted by insertion sort. With more than one thread the halves are sorted by different
+ * threads and the big merges are split between them by co-ranking, so every thread
+ * merges its own equal part of the output.
  * Merge sort performs in O(n log (n)) in the best, average, and worst case.
  */
-template <typename Iter> void merge_sort(Iter begin, Iter end) {
-    if (end - begin > 1) {
-        Iter mid = begin + (end - begin) / 2; // Assumes Random Access Iterator
-        merge_sort(begin, mid);
-        merge_sort(mid, end);
-        std::inplace_merge(begin, mid,
-                           end); // Elements must be comparable and move-assignable
+template <typename Iter, typename Compare = std::less<>>
+void merge_sort(Iter begin, Iter end, Compare comp = Compare(), size_t threads = 1) {
+    ALGOPLUS_TRACE_SPAN("merge_sort");
+    size_t n = static_cast<size_t>(end - begin); // Assumes Random Access Iterator
+    if (n < 2) {
+        return;
     }
+    if (n <= _merge_sort_utils::cutoff) {
+        _merge_sort_utils::insertion(begin, n, comp);
+        return;
+    }
+    threads = PARALLEL::resolve_threads(threads, n / (4 * _merge_sort_utils::cutoff) + 1);
+    using T = typename std::iterator_traits<Iter>::value_type;
+    std::vector<T> scratch(std::make_move_iterator(begin), std::make_move_iterator(end));
+    _merge_sort_utils::sort(scratch.begin(), begin, n, true, comp, threads);
+}
+
+/**
+ * @brief merge sort on every hardware thread, same as merge_sort(begin, end, comp, 0)
+ * @param begin An iterator to the beginning of the range to be sorted.
+ * @param end An iterator to the end of the range to be sorted.
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ */
+template <typename Iter, typename Compare = std::less<>>
+void parallel_merge_sort(Iter begin, Iter end, Compare comp = Compare()) {
+    merge_sort(begin, end, comp, 0);
 }
 
 #endif // MERGE_SORT_H
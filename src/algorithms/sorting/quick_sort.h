@@ -1,75 +1,308 @@
 #ifndef ALGOPLUS_QUICK_SORT_H
 #define ALGOPLUS_QUICK_SORT_H
 
+#include "../../helpers/parallel.h"
+#include "../../helpers/trace.h"
+#include "heap_sort.h"
+#include "sorting_network.h"
+
 #include <algorithm> // For std::partition and std::swap
-#include <iterator>  // For std::iterator_traits
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator> // For std::iterator_traits
+#include <thread>
+#include <vector>
 
 /**
  * @brief Finds and returns the median of three elements of a container.
  * @param a An iterator pointing to the first element.
  * @param b An iterator pointing to the second element.
  * @param c An iterator pointing to the third element.
+ * @param comp strict weak ordering. Default = std::less<>
  * @details This function takes iterators to three elements in a container,
  * compares these elements, and returns an iterator pointing to the median
  * value. The function doesn't mutate the original elements.
  * @return An iterator pointing to the median of the three input element.
  */
-template <typename Iter> Iter median_of_three(Iter a, Iter b, Iter c) {
-    if (*a < *b) {
-        if (*b < *c)
+template <typename Iter, typename Compare = std::less<>>
+Iter median_of_three(Iter a, Iter b, Iter c, Compare comp = Compare()) {
+    if (comp(*a, *b)) {
+        if (comp(*b, *c))
             return b;
-        else if (*a < *c)
+        else if (comp(*a, *c))
             return c;
         else
             return a;
     } else {
-        if (*a < *c)
+        if (comp(*a, *c))
             return a;
-        else if (*b < *c)
+        else if (comp(*b, *c))
             return c;
         else
             return b;
     }
 }
 
+namespace _quick_sort_utils {
+// ranges this short are sorted with insertion sort
+constexpr size_t cutoff = 24;
+// values per block of the block partition, the offsets fit in a byte
+constexpr size_t block = 64;
+// ranges shorter than this are sorted by one thread
+constexpr size_t parallel_min = 1 << 15;
+
+template <typename Iter, typename Compare> void insertion(Iter first, Iter last, Compare& comp) {
+    for (Iter i = first + (first != last); i < last; ++i) {
+        auto x = std::move(*i);
+        Iter j = i;
+        for (; j > first && comp(x, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(x);
+    }
+}
+
+/**
+ * @brief block partition(BlockQuicksort) of [first, last) by left(x): the values with
+ * left(x) end up before the others. The values of a block of B from each end are first
+ * tested without branches, only writing down the offsets of the misplaced ones, and then
+ * the misplaced ones are swapped in pairs, so the comparisons never mispredict. The rest,
+ * shorter than two blocks, is left to std::partition.
+ * @return Iter the first value without left(x).
+ */
+template <typename Iter, typename Left> Iter block_partition(Iter first, Iter last, Left left) {
+    unsigned char off_l[block], off_r[block];
+    size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+    // [.., first) are all on the left side, [last, ..) on the right one
+    while (size_t(last - first) > 2 * block) {
+        if (num_l == 0) {
+            start_l = 0;
+            for (size_t i = 0; i < block; i++) {
+                off_l[num_l] = static_cast<unsigned char>(i);
+                num_l += !left(first[i]);
+            }
+        }
+        if (num_r == 0) {
+            start_r = 0;
+            for (size_t i = 0; i < block; i++) {
+                off_r[num_r] = static_cast<unsigned char>(i + 1);
+                num_r += left(*(last - (i + 1)));
+            }
+        }
+        size_t num = std::min(num_l, num_r);
+        for (size_t i = 0; i < num; i++) {
+            std::iter_swap(first + off_l[start_l + i], last - off_r[start_r + i]);
+        }
+        num_l -= num;
+        num_r -= num;
+        start_l += num;
+        start_r += num;
+        if (num_l == 0) {
+            first += block;
+        }
+        if (num_r == 0) {
+            last -= block;
+        }
+    }
+    return std::partition(first, last, left);
+}
+
+/**
+ * @brief partitions [first, last) around a pivot, picked from the median of three (of three
+ * medians of three for long ranges), and moves it to its place.
+ * @param equal_left true when the value before first is not less than the pivot, then it
+ * is equal to it and so are all the values that are not greater, so they go left and
+ * the left side needs no sorting.
+ * @return std::pair<Iter, Iter> the end of the left side to sort and the start of the
+ * right side, the pivot and the equal values are in between.
+ */
+template <typename Iter, typename Compare>
+std::pair<Iter, Iter> partition(Iter first, Iter last, Iter pred, bool has_pred,
+                                Compare& comp) {
+    size_t n = size_t(last - first);
+    Iter mid = first + n / 2;
+    Iter p;
+    if (n > 128) {
+        size_t s = n / 8;
+        p = median_of_three(median_of_three(first, first + s, first + 2 * s, comp),
+                            median_of_three(mid - s, mid, mid + s, comp),
+                            median_of_three(last - 1 - 2 * s, last - 1 - s, last - 1, comp), comp);
+    } else {
+        p = median_of_three(first, mid, last - 1, comp);
+    }
+    std::iter_swap(first, p);
+    auto& pivot = *first;
+    if (has_pred && !comp(*pred, pivot)) {
+        Iter split = block_partition(first + 1, last,
+                                     [&](const auto& x) { return !comp(pivot, x); });
+        std::iter_swap(first, split - 1);
+        return {first, split};
+    }
+    Iter split =
+        block_partition(first + 1, last, [&](const auto& x) { return comp(x, pivot); });
+    std::iter_swap(first, split - 1);
+    return {split - 1, split};
+}
+
+/**
+ * @brief parallel partition of [first, last) by left(x) on threads threads: every thread
+ * partitions a contiguous chunk, and then the values of the right side that are before the
+ * final split are swapped with the values of the left side that are after it, the swaps
+ * being split evenly between the threads.
+ */
+template <typename Iter, typename Left>
+Iter parallel_partition(Iter first, Iter last, Left left, size_t threads) {
+    size_t n = size_t(last - first);
+    std::vector<size_t> bound(threads + 1), split(threads);
+    for (size_t t = 0; t <= threads; t++) {
+        bound[t] = n * t / threads;
+    }
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            split[t] = size_t(block_partition(first + bound[t], first + bound[t + 1], left) -
+                              first);
+        }
+    });
+    size_t total = 0;
+    for (size_t t = 0; t < threads; t++) {
+        total += split[t] - bound[t];
+    }
+    // the misplaced runs: right values in [0, total) and left values in [total, n), both
+    // as many
+    struct run {
+        size_t begin, end;
+    };
+    std::vector<run> wrong_r, wrong_l;
+    for (size_t t = 0; t < threads; t++) {
+        if (split[t] < total) {
+            wrong_r.push_back({split[t], std::min(bound[t + 1], total)});
+        }
+        if (split[t] > total) {
+            wrong_l.push_back({std::max(bound[t], total), split[t]});
+        }
+    }
+    size_t misplaced = 0;
+    for (const run& r : wrong_r) {
+        misplaced += r.end - r.begin;
+    }
+    // the position of the k-th misplaced value of runs
+    auto locate = [](const std::vector<run>& runs, size_t k, size_t& index) {
+        index = 0;
+        while (k >= runs[index].end - runs[index].begin) {
+            k -= runs[index].end - runs[index].begin;
+            index++;
+        }
+        return runs[index].begin + k;
+    };
+    size_t parts = std::min(threads, misplaced / parallel_min + 1);
+    PARALLEL::parallel_for(0, parts, parts, [&](size_t lo, size_t hi, size_t) {
+        for (size_t p = lo; p < hi; p++) {
+            size_t k0 = misplaced * p / parts, k1 = misplaced * (p + 1) / parts;
+            if (k0 == k1) {
+                continue;
+            }
+            size_t ir, il;
+            size_t a = locate(wrong_r, k0, ir), b = locate(wrong_l, k0, il);
+            for (size_t k = k0; k < k1; k++) {
+                if (a == wrong_r[ir].end) {
+                    a = wrong_r[++ir].begin;
+                }
+                if (b == wrong_l[il].end) {
+                    b = wrong_l[++il].begin;
+                }
+                std::iter_swap(first + a++, first + b++);
+            }
+        }
+    });
+    return first + total;
+}
+
+/**
+ * @brief introsort of [first, last): quicksort with a block partition, insertion sort for
+ * short ranges and heap sort once depth partitions are used up, so it is O(n log(n)) on
+ * every input. The shorter side is sorted first and the longer one by the loop, so the
+ * stack holds O(log(n)) frames. With threads > 1 the two sides of a long range are sorted
+ * by different threads and the partition itself is split between them.
+ */
+template <typename Iter, typename Compare>
+void introsort(Iter first, Iter last, Iter pred, bool has_pred, size_t depth, Compare& comp,
+               size_t threads) {
+    // the ranges a sorting network sorts are left to it, it is faster than insertion sort
+    constexpr bool network = _sorting_network_utils::network_sortable<Iter, Compare>;
+    while (size_t(last - first) > (network ? network_sort_max : cutoff)) {
+        if (depth == 0) {
+            heap_sort(first, last, comp);
+            return;
+        }
+        depth--;
+        std::pair<Iter, Iter> cut;
+        if (threads > 1 && size_t(last - first) >= parallel_min) {
+            Iter mid = first + (last - first) / 2;
+            std::iter_swap(first, median_of_three(first, mid, last - 1, comp));
+            auto& pivot = *first;
+            Iter split = parallel_partition(
+                first + 1, last, [&](const auto& x) { return comp(x, pivot); }, threads);
+            std::iter_swap(first, split - 1);
+            cut = {split - 1, split};
+        } else {
+            cut = partition(first, last, pred, has_pred, comp);
+        }
+        if (threads > 1 && size_t(last - first) >= parallel_min) {
+            size_t left = threads / 2;
+            std::thread worker(
+                [&, left] { introsort(first, cut.first, pred, has_pred, depth, comp, left); });
+            introsort(cut.second, last, cut.second - 1, true, depth, comp, threads - left);
+            worker.join();
+            return;
+        }
+        if (cut.first - first < last - cut.second) {
+            introsort(first, cut.first, pred, has_pred, depth, comp, 1);
+            pred = cut.second - 1;
+            has_pred = true;
+            first = cut.second;
+        } else {
+            introsort(cut.second, last, cut.second - 1, true, depth, comp, 1);
+            last = cut.first;
+        }
+    }
+    if constexpr (network) {
+        network_sort(first, last);
+    } else {
+        insertion(first, last, comp);
+    }
+}
+} // namespace _quick_sort_utils
+
 /**
  * @brief Sorts a range of elements using the Quick Sort algorithm
  * @param begin An iterator to the beginning of the range to be sorted.
  * @param end An iterator to the end of the range to be sorted.
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ * @param threads number of threads(0 means every hardware thread). Default = 1
  * @details The implementation requires that the iterator type `Iter` supports
  * Random Access to enable efficient partitioning and element swapping. The
  * elements in the range must be move-assignable and should support comparison
- * with the '<' operator. If these requirements are not met, the behavior of the
+ * with comp. If these requirements are not met, the behavior of the
  * function is undefined. This function sorts the elements in the range [begin,
- * end) into ascending order. The sort is performed in-place. Its performance is
- * generally O(n log n) on average, though worst-case performance is O(n^2)
+ * end) into ascending order. The sort is performed in-place. It is an introsort:
+ * the pivot is a median of three(or of nine for long ranges), the partition is
+ * branchless(BlockQuicksort), ranges of up to 24 elements go to insertion sort, runs of
+ * equal elements are put aside in one pass, and after 2 log2(n) levels a range goes to
+ * heap sort, so its performance is O(n log n) in the worst case too. With AVX2 and the
+ * default comparison, the ranges of up to 64 int32_t, float, int64_t or double values go
+ * to a vector sorting network(network_sort) instead of insertion sort.
  */
-template <typename Iter> void quick_sort(Iter begin, Iter end) {
-    auto distance = std::distance(begin, end);
-    if (distance <= 1) {
+template <typename Iter, typename Compare = std::less<>>
+void quick_sort(Iter begin, Iter end, Compare comp = Compare(), size_t threads = 1) {
+    ALGOPLUS_TRACE_SPAN("quick_sort");
+    size_t n = static_cast<size_t>(std::distance(begin, end));
+    if (n <= 1) {
         return;
     }
-
-    // choose the pivot as median of first, middle and last element
-    Iter mid = begin + distance / 2;
-    Iter pivot_pos = median_of_three(begin, mid, end - 1);
-    auto pivot = *pivot_pos;
-
-    // swap pivot to start
-    std::swap(*begin, *pivot_pos);
-
-    Iter middle1 =
-        std::partition(begin + 1, end, [pivot](const auto& elem) { return elem < pivot; });
-
-    Iter middle2 =
-        std::partition(middle1, end, [pivot](const auto& elem) { return !(pivot < elem); });
-
-    // swap pivot to its final place
-    std::swap(*begin, *(middle1 - 1));
-
-    // recursively apply quick_sort to partitions
-    quick_sort(begin, middle1 - 1);
-    quick_sort(middle2, end);
+    threads = PARALLEL::resolve_threads(threads, n / _quick_sort_utils::parallel_min + 1);
+    _quick_sort_utils::introsort(begin, end, begin, false, 2 * size_t(std::bit_width(n)), comp,
+                                 threads);
 }
 
 #endif // QUICK_SORT_H
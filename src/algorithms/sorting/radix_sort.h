@@ -1,67 +1,218 @@
 #ifndef RADIX_SORT_H
 #define RADIX_SORT_H
 
+#include "../../helpers/parallel.h"
+#include "sorting_network.h"
+
 #ifdef __cplusplus
-#include <algorithm>
-#include <cmath>
+#include <array>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #endif
 
-namespace {
+namespace _radix_sort_utils {
+// bits per digit, every pass sorts by one byte of the key
+constexpr size_t digit_bits = 8;
+constexpr size_t buckets = size_t(1) << digit_bits;
+// ranges shorter than this are sorted by one thread
+constexpr size_t parallel_min = 1 << 16;
+
 /**
- * @brief Perform counting sort for a given vector of elements using a specific
- * radix.
- *
- * @details
- * This function implements the counting sort algorithm for a given vector of
- * elements using a specific radix. It sorts the elements based on their digits
- * at the specified radix position.
- *
- * @tparam T The data type of the elements in the vector.
- * @param arr The vector to be sorted.
- * @param exp The radix position to consider (e.g., 1 for units digit, 10 for
- * tens digit, etc.).
+ * @brief the unsigned type of the same size as the key K
  */
-template <typename T> void countingSortForRadix(std::vector<T>& arr, int exp) {
-    int64_t n = arr.size();
-    std::vector<T> output(n);
-    std::vector<int> count(10, 0);
+template <typename K>
+using unsigned_key =
+    std::conditional_t<std::is_floating_point_v<K>,
+                       std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>,
+                       std::make_unsigned_t<std::conditional_t<std::is_floating_point_v<K>,
+                                                               int, K>>>;
 
-    for (int64_t i = 0; i < n; i++) {
-        count[(arr[i] / exp) % 10]++;
+/**
+ * @brief maps k to an unsigned value of the same order: the sign bit of a signed integer
+ * is flipped, and a float has all its bits flipped if it is negative and only the sign bit
+ * otherwise, so -0.0 comes right before 0.0 and the NaNs end up at the two ends.
+ */
+template <typename K> unsigned_key<K> to_unsigned(K k) {
+    using U = unsigned_key<K>;
+    constexpr U sign = U(1) << (8 * sizeof(U) - 1);
+    if constexpr (std::is_floating_point_v<K>) {
+        U u = std::bit_cast<U>(k);
+        return (u & sign) ? U(~u) : U(u | sign);
+    } else if constexpr (std::is_signed_v<K>) {
+        return U(k) ^ sign;
+    } else {
+        return k;
     }
+}
 
-    for (int64_t i = 1; i < 10; i++) {
-        count[i] += count[i - 1];
+using histogram = std::array<size_t, buckets>;
+
+/**
+ * @brief the histograms of every digit of the keys of [src, src + n)
+ */
+template <typename S, typename Key, size_t P>
+void count(S src, size_t n, Key& key, std::array<histogram, P>& hist) {
+    for (size_t i = 0; i < n; i++) {
+        auto u = to_unsigned(std::invoke(key, src[i]));
+        for (size_t p = 0; p < P; p++) {
+            hist[p][(u >> (p * digit_bits)) & (buckets - 1)]++;
+        }
     }
+}
 
-    for (int64_t i = n - 1; i >= 0; i--) {
-        output[count[(arr[i] / exp) % 10] - 1] = arr[i];
-        count[(arr[i] / exp) % 10]--;
+/**
+ * @brief moves the values of [src, src + n) to dst, in the order of their digit at shift,
+ * offset[d] is where the next value with digit d goes. The values with equal digits keep
+ * their order, so the sort is stable.
+ */
+template <typename S, typename D, typename Key>
+void scatter(S src, size_t n, D dst, Key& key, size_t shift, histogram& offset) {
+    for (size_t i = 0; i < n; i++) {
+        size_t d = (to_unsigned(std::invoke(key, src[i])) >> shift) & (buckets - 1);
+        dst[offset[d]++] = std::move(src[i]);
     }
+}
 
-    arr = output;
+/**
+ * @brief LSD radix sort of [first, first + n) by key, one pass per byte of the key from
+ * the lowest, between the range and the scratch buffer. The histograms of all the bytes
+ * are counted in one read, and the bytes that are the same for every key are skipped.
+ * With threads > 1 every thread counts and scatters its own contiguous chunk, and the
+ * offsets of a chunk start after the values of the same digit of the chunks before it.
+ */
+template <typename Iter, typename Key>
+void sort(Iter first, size_t n, Key& key, size_t threads) {
+    using T = typename std::iterator_traits<Iter>::value_type;
+    using U = decltype(to_unsigned(std::invoke(key, *first)));
+    constexpr size_t P = sizeof(U);
+    std::vector<size_t> bound(threads + 1);
+    for (size_t t = 0; t <= threads; t++) {
+        bound[t] = n * t / threads;
+    }
+    // hist[t] holds the histograms of the chunk of the thread t
+    std::vector<std::array<histogram, P>> hist(threads, std::array<histogram, P>{});
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            count(first + bound[t], bound[t + 1] - bound[t], key, hist[t]);
+        }
+    });
+    U u0 = to_unsigned(std::invoke(key, *first));
+    std::vector<size_t> passes;
+    for (size_t p = 0; p < P; p++) {
+        size_t d0 = (u0 >> (p * digit_bits)) & (buckets - 1), same = 0;
+        for (size_t t = 0; t < threads; t++) {
+            same += hist[t][p][d0];
+        }
+        if (same != n) {
+            passes.push_back(p);
+        }
+    }
+    if (passes.empty()) {
+        return;
+    }
+    std::vector<T> scratch(n);
+    std::vector<histogram> offset(threads);
+    bool in_scratch = false;
+    for (size_t k = 0; k < passes.size(); k++) {
+        size_t p = passes[k], shift = p * digit_bits;
+        if (k > 0 && threads > 1) {
+            // the chunks hold other values after a scatter, so they are counted again
+            PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+                for (size_t t = lo; t < hi; t++) {
+                    hist[t][p].fill(0);
+                    auto count_digit = [&](auto src) {
+                        for (size_t i = bound[t]; i < bound[t + 1]; i++) {
+                            size_t d = (to_unsigned(std::invoke(key, src[i])) >> shift) &
+                                       (buckets - 1);
+                            hist[t][p][d]++;
+                        }
+                    };
+                    in_scratch ? count_digit(scratch.begin()) : count_digit(first);
+                }
+            });
+        }
+        size_t sum = 0;
+        for (size_t d = 0; d < buckets; d++) {
+            for (size_t t = 0; t < threads; t++) {
+                offset[t][d] = sum;
+                sum += hist[t][p][d];
+            }
+        }
+        PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t t = lo; t < hi; t++) {
+                size_t m = bound[t + 1] - bound[t];
+                if (in_scratch) {
+                    scatter(scratch.begin() + bound[t], m, first, key, shift, offset[t]);
+                } else {
+                    scatter(first + bound[t], m, scratch.begin(), key, shift, offset[t]);
+                }
+            }
+        });
+        in_scratch = !in_scratch;
+    }
+    if (in_scratch) {
+        std::move(scratch.begin(), scratch.end(), first);
+    }
 }
-} // namespace
+} // namespace _radix_sort_utils
 
 /**
- * @brief Perform radix sort on a given vector of elements.
+ * @brief Perform radix sort on a range of elements.
  *
  * @details
- * This function implements the radix sort algorithm on a given vector of
- * elements. It sorts the elements based on their digits from least significant
- * to most significant.
+ * This function implements a least significant digit radix sort: the keys are
+ * mapped to unsigned integers of the same order, and the elements are sorted
+ * one byte at a time from the lowest, with a counting sort that moves them
+ * between the range and one scratch buffer. The histograms of every byte are
+ * counted in a single pass, and the bytes that every key shares are skipped,
+ * so small keys in a wide type cost only the passes they need. The sort is
+ * stable and takes O(n * sizeof(key)) time.
  *
- * @tparam T The data type of the elements in the vector.
+ * @tparam Iter a random access iterator.
+ * @tparam Key a projection from the elements to an integer or a floating point key.
+ * @param first An iterator to the beginning of the range to be sorted.
+ * @param last An iterator to the end of the range to be sorted.
+ * @param key the projection to sort by. Default = std::identity
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Signed integers and floats are in their natural order, -0.0 comes before 0.0.
+ * The elements must be default constructible and move assignable.
+ */
+template <typename Iter, typename Key = std::identity>
+void radix_sort(Iter first, Iter last, Key key = Key(), size_t threads = 1) {
+    using K = std::remove_cvref_t<decltype(std::invoke(key, *first))>;
+    static_assert((std::is_integral_v<K> && !std::is_same_v<K, bool>) ||
+                      (std::is_floating_point_v<K> && (sizeof(K) == 4 || sizeof(K) == 8)),
+                  "radix_sort needs an integer, float or double key");
+    size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n < 2) {
+        return;
+    }
+    // a few integers sorted by themselves are done by one network instead of the passes
+    if constexpr (std::is_same_v<Key, std::identity> && std::is_integral_v<K> &&
+                  _sorting_network_utils::network_type<Iter>) {
+        if (n <= network_sort_max) {
+            network_sort(first, last);
+            return;
+        }
+    }
+    threads = PARALLEL::resolve_threads(threads, n / _radix_sort_utils::parallel_min + 1);
+    _radix_sort_utils::sort(first, n, key, threads);
+}
+
+/**
+ * @brief Perform radix sort on a given vector of elements.
+ *
+ * @tparam T The data type of the elements in the vector, an integer or a floating point.
  * @param arr The vector to be sorted.
  */
 template <typename T> void radix_sort(std::vector<T>& arr) {
-    T maxElement = *max_element(arr.begin(), arr.end());
-
-    for (int exp = 1; maxElement / exp > 0; exp *= 10) {
-        countingSortForRadix(arr, exp);
-    }
+    radix_sort(arr.begin(), arr.end());
 }
 
 #endif // RADIX_SORT_H
@@ -3,7 +3,13 @@
 
 #ifdef __cplusplus
 #include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
@@ -11,10 +17,13 @@
  * @brief scheduling function
  * @details Returns the maximum jobs that can be completed in a schedule with
  * pairs (x, y) indicating the starting and ending time
- * @param intervals: the passed schedule(vector<pair<int, int> >)
+ * @param intervals: the passed schedule(vector<pair<int, int> >), sorted in place by ending time
  * @return int: the total amount of jobs that can be completed
  */
-int scheduling(std::vector<std::pair<int, int>>& intervals) {
+inline int scheduling(std::vector<std::pair<int, int>>& intervals) {
+    if (intervals.empty()) {
+        return 0;
+    }
     std::sort(intervals.begin(), intervals.end(),
               [&](const std::pair<int, int>& a, const std::pair<int, int>& b) {
                   if (a.second == b.second) {
@@ -37,4 +46,205 @@ int scheduling(std::vector<std::pair<int, int>>& intervals) {
     return count_valid;
 }
 
+namespace _scheduling_utils {
+/**
+ * @brief the indices of the jobs ordered by ending time, then by starting time. The ending
+ * times are copied next to the indices so that the sort does not chase them.
+ */
+template <typename T> std::vector<size_t> by_end(std::span<const std::pair<T, T>> jobs) {
+    std::vector<std::pair<T, size_t>> keys(jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        keys[i] = {jobs[i].second, i};
+    }
+    std::sort(keys.begin(), keys.end(), [&](const auto& a, const auto& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        return jobs[a.second].first < jobs[b.second].first;
+    });
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        order[i] = keys[i].second;
+    }
+    return order;
+}
+} // namespace _scheduling_utils
+
+/**
+ * @brief interval scheduler class
+ * The streaming form of the greedy interval scheduling: jobs are offered in order of ending
+ * time, and a job is kept if it starts no earlier than the last kept job ends, which keeps
+ * the most jobs that do not overlap. Jobs are half open, one may start when another ends.
+ * Nothing is stored but the last ending time, so a sorted input is never copied.
+ * @tparam T the type of the times.
+ */
+template <typename T> class interval_scheduler {
+  public:
+    /**
+     * @brief offer function
+     * @param start the starting time of the job
+     * @param end the ending time of the job, no earlier than that of the previous offer
+     * @return true if the job is kept
+     */
+    bool offer(const T& start, const T& end) {
+        if (_count > 0 && start < _end) {
+            return false;
+        }
+        _end = end;
+        _count++;
+        return true;
+    }
+
+    /**
+     * @brief count function
+     * @return size_t the number of jobs kept
+     */
+    size_t count() const { return _count; }
+
+    /**
+     * @brief clear function
+     */
+    void clear() { _count = 0; }
+
+  private:
+    T _end{};
+    size_t _count{0};
+};
+
+/**
+ * @brief interval scheduling function
+ * @param jobs the (start, end) pairs of the jobs, left untouched
+ * @return std::vector<size_t> the indices of a largest set of jobs that do not overlap, in
+ * order of ending time
+ */
+template <typename T>
+std::vector<size_t> interval_scheduling(std::span<const std::pair<T, T>> jobs) {
+    std::vector<size_t> kept;
+    interval_scheduler<T> s;
+    for (size_t i : _scheduling_utils::by_end(jobs)) {
+        if (s.offer(jobs[i].first, jobs[i].second)) {
+            kept.push_back(i);
+        }
+    }
+    return kept;
+}
+
+/**
+ * @brief sorted interval scheduling function
+ * @param jobs the (start, end) pairs of the jobs, sorted by ending time
+ * @return std::vector<size_t> the indices of a largest set of jobs that do not overlap
+ * Throws std::invalid_argument if the jobs are not sorted.
+ */
+template <typename T>
+std::vector<size_t> sorted_interval_scheduling(std::span<const std::pair<T, T>> jobs) {
+    std::vector<size_t> kept;
+    interval_scheduler<T> s;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (i > 0 && jobs[i].second < jobs[i - 1].second) {
+            throw std::invalid_argument("sorted_interval_scheduling: jobs are not sorted");
+        }
+        if (s.offer(jobs[i].first, jobs[i].second)) {
+            kept.push_back(i);
+        }
+    }
+    return kept;
+}
+
+/**
+ * @brief the result of weighted_interval_scheduling
+ * weight: the total weight of the jobs, jobs: their indices in order of ending time.
+ */
+template <typename W> struct weighted_schedule {
+    W weight{};
+    std::vector<size_t> jobs;
+};
+
+/**
+ * @brief weighted interval scheduling function
+ * @param jobs the (start, end) pairs of the jobs
+ * @param weights the weight of every job
+ * @return weighted_schedule<W> a set of jobs that do not overlap with the largest total weight
+ * @details the jobs are sorted by ending time, best[j] is the best weight of the j first
+ * ones: the best of best[j - 1] and of the weight of job j plus best[p], p being the number of
+ * jobs that end before job j starts, found by binary search. O(n log(n)) time, O(n) space.
+ * Throws std::invalid_argument if there is not one weight per job.
+ */
+template <typename T, typename W>
+weighted_schedule<W> weighted_interval_scheduling(std::span<const std::pair<T, T>> jobs,
+                                                  std::span<const W> weights) {
+    if (jobs.size() != weights.size()) {
+        throw std::invalid_argument("weighted_interval_scheduling: one weight per job");
+    }
+    const size_t n = jobs.size();
+    const std::vector<size_t> order = _scheduling_utils::by_end(jobs);
+    std::vector<T> ends(n);
+    for (size_t j = 0; j < n; j++) {
+        ends[j] = jobs[order[j]].second;
+    }
+    std::vector<W> best(n + 1, W{});
+    std::vector<size_t> previous(n);
+    for (size_t j = 0; j < n; j++) {
+        const auto& [start, end] = jobs[order[j]];
+        // the jobs before j that end no later than it starts
+        previous[j] = size_t(std::upper_bound(ends.begin(), ends.begin() + j, start) -
+                             ends.begin());
+        best[j + 1] = std::max(best[j], weights[order[j]] + best[previous[j]]);
+    }
+    weighted_schedule<W> out;
+    out.weight = best[n];
+    for (size_t j = n; j > 0;) {
+        if (best[j] == best[j - 1]) {
+            j--;
+        } else {
+            out.jobs.push_back(order[j - 1]);
+            j = previous[j - 1];
+        }
+    }
+    std::reverse(out.jobs.begin(), out.jobs.end());
+    return out;
+}
+
+/**
+ * @brief the result of interval_partitioning
+ * machines: the number of machines, machine: the machine of every job, in [0, machines).
+ */
+struct machine_assignment {
+    size_t machines{0};
+    std::vector<size_t> machine;
+};
+
+/**
+ * @brief interval partitioning function
+ * @param jobs the (start, end) pairs of the jobs
+ * @return machine_assignment the fewest machines that run every job, no two overlapping jobs
+ * on the same machine, which is the largest number of jobs running at once
+ * @details the jobs are taken in order of starting time, a min heap holds the machines by the
+ * ending time of their last job, and a job goes to the machine that frees first if it is free
+ * by then, else to a new one. O(n log(n)).
+ */
+template <typename T>
+machine_assignment interval_partitioning(std::span<const std::pair<T, T>> jobs) {
+    std::vector<std::pair<T, size_t>> starts(jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        starts[i] = {jobs[i].first, i};
+    }
+    std::sort(starts.begin(), starts.end());
+    machine_assignment out;
+    out.machine.resize(jobs.size());
+    using busy = std::pair<T, size_t>;
+    std::priority_queue<busy, std::vector<busy>, std::greater<busy>> free_at;
+    for (const auto& [start, i] : starts) {
+        size_t m;
+        if (!free_at.empty() && !(start < free_at.top().first)) {
+            m = free_at.top().second;
+            free_at.pop();
+        } else {
+            m = out.machines++;
+        }
+        out.machine[i] = m;
+        free_at.emplace(jobs[i].second, m);
+    }
+    return out;
+}
+
 #endif
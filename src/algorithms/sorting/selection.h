@@ -0,0 +1,249 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include "../../helpers/parallel.h"
+#include "heap_sort.h"
+#include "quick_sort.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#endif
+
+namespace _selection_utils {
+// the values of a stream are tested against the threshold of the heap this many at a time
+constexpr size_t block = 16;
+
+/**
+ * @brief heap select of [first, last) around nth: the nth + 1 first values go to a max
+ * heap, and every later value that is less than the root replaces it, so the root ends up
+ * the value of rank nth and is swapped there. O(n log(n)) in the worst case.
+ */
+template <typename Iter, typename Compare>
+void heap_select(Iter first, Iter nth, Iter last, Compare& comp) {
+    size_t k = size_t(nth - first) + 1;
+    for (size_t i = k / 2; i-- > 0;) {
+        heap_sift_down(first, k, i, comp);
+    }
+    for (Iter i = nth + 1; i < last; ++i) {
+        if (comp(*i, *first)) {
+            std::iter_swap(i, first);
+            heap_sift_down(first, k, 0, comp);
+        }
+    }
+    std::iter_swap(first, nth);
+}
+} // namespace _selection_utils
+
+/**
+ * @brief introselect: reorders [first, last) so that nth holds the value it would hold if
+ * the range was sorted, with no greater value before it and no smaller one after it.
+ * @param first An iterator to the beginning of the range.
+ * @param nth An iterator to the position to select, in [first, last).
+ * @param last An iterator to the end of the range.
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ * @details quickselect with the partition of quick_sort(median of three or of nine,
+ * branchless block partition, runs of equal values put aside), only the side holding nth
+ * is partitioned again. After 2 log2(n) partitions it switches to a heap select, so it is
+ * O(n) on average and O(n log(n)) in the worst case.
+ */
+template <typename Iter, typename Compare = std::less<>>
+void quick_select(Iter first, Iter nth, Iter last, Compare comp = Compare()) {
+    if (last - first < 2 || nth == last) {
+        return;
+    }
+    namespace qs = _quick_sort_utils;
+    size_t depth = 2 * size_t(std::bit_width(size_t(last - first)));
+    Iter pred = first;
+    bool has_pred = false;
+    while (size_t(last - first) > qs::cutoff) {
+        if (depth-- == 0) {
+            _selection_utils::heap_select(first, nth, last, comp);
+            return;
+        }
+        auto [left, right] = qs::partition(first, last, pred, has_pred, comp);
+        if (nth < left) {
+            last = left;
+        } else if (nth >= right) {
+            pred = right - 1;
+            has_pred = true;
+            first = right;
+        } else {
+            return;
+        }
+    }
+    qs::insertion(first, last, comp);
+}
+
+/**
+ * @brief sorts the middle - first smallest values of [first, last) into [first, middle),
+ * the others end up in [middle, last) in no order
+ * @param first An iterator to the beginning of the range.
+ * @param middle An iterator to the end of the part to sort.
+ * @param last An iterator to the end of the range.
+ * @param comp strict weak ordering, as for std::sort. Default = std::less<>
+ * @param threads number of threads of the sort(0 means every hardware thread). Default = 1
+ * @details quick_select splits the range at middle in O(n), and quick_sort sorts the
+ * first part, so it takes O(n + k log(k)) for k = middle - first.
+ */
+template <typename Iter, typename Compare = std::less<>>
+void partial_quick_sort(Iter first, Iter middle, Iter last, Compare comp = Compare(),
+                        size_t threads = 1) {
+    if (first == middle) {
+        return;
+    }
+    quick_select(first, middle - 1, last, comp);
+    quick_sort(first, middle - 1, comp, threads);
+}
+
+/**
+ * @brief top_k_heap class
+ * Keeps the k largest values(by comp) of a stream in a min heap, whose root is the
+ * threshold a value must beat to get in. Ranges are tested against the threshold a block
+ * at a time with a branch free loop, which vectorizes for arithmetic values, and only the
+ * blocks that hold a value beating it go through the heap.
+ * @tparam T the type of the values.
+ * @tparam Compare strict weak ordering, larger values are kept. Default = std::less<>
+ */
+template <typename T, typename Compare = std::less<>> class top_k_heap {
+  public:
+    /**
+     * @brief Construct a new top k heap object
+     * @param k the number of values to keep
+     * @param comp strict weak ordering. Default = Compare()
+     */
+    explicit top_k_heap(size_t k, Compare comp = Compare()) : _k(k), _comp(comp) {
+        _heap.reserve(k);
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of values kept, at most k.
+     */
+    size_t size() const { return _heap.size(); }
+
+    /**
+     * @brief capacity function
+     * @return size_t k.
+     */
+    size_t capacity() const { return _k; }
+
+    /**
+     * @brief threshold function, the heap must not be empty
+     * @return const T& the smallest value kept.
+     */
+    const T& threshold() const { return _heap.front(); }
+
+    /**
+     * @brief push function
+     * @param x the value, it is kept if there is room or if it beats the threshold.
+     */
+    void push(const T& x) {
+        if (_heap.size() < _k) {
+            _heap.push_back(x);
+            std::push_heap(_heap.begin(), _heap.end(), _inverse());
+        } else if (_k > 0 && _comp(_heap.front(), x)) {
+            _heap.front() = x;
+            auto inv = _inverse();
+            heap_sift_down(_heap.begin(), _heap.size(), 0, inv);
+        }
+    }
+
+    /**
+     * @brief push function
+     * @param first An iterator to the beginning of the values.
+     * @param last An iterator to the end of the values.
+     */
+    template <typename Iter> void push(Iter first, Iter last) {
+        while (first != last && _heap.size() < _k) {
+            push(*first++);
+        }
+        if constexpr (std::random_access_iterator<Iter>) {
+            constexpr size_t B = _selection_utils::block;
+            for (; _k > 0 && last - first >= std::ptrdiff_t(B); first += B) {
+                const T& t = _heap.front();
+                bool any = false;
+                for (size_t j = 0; j < B; j++) {
+                    any |= _comp(t, first[j]);
+                }
+                if (any) {
+                    for (size_t j = 0; j < B; j++) {
+                        push(first[j]);
+                    }
+                }
+            }
+        }
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
+    /**
+     * @brief merge function
+     * @param h another heap, its values are pushed to this one.
+     */
+    void merge(const top_k_heap& h) { push(h._heap.begin(), h._heap.end()); }
+
+    /**
+     * @brief sorted function
+     * @return std::vector<T> the values kept, from the largest to the smallest.
+     */
+    std::vector<T> sorted() const {
+        std::vector<T> v = _heap;
+        std::sort_heap(v.begin(), v.end(), _inverse());
+        return v;
+    }
+
+  private:
+    size_t _k;
+    Compare _comp;
+    std::vector<T> _heap;
+
+    auto _inverse() const {
+        return [this](const T& a, const T& b) { return _comp(b, a); };
+    }
+};
+
+/**
+ * @brief the k largest values of a range
+ * @param first An iterator to the beginning of the range.
+ * @param last An iterator to the end of the range.
+ * @param k the number of values.
+ * @param comp strict weak ordering, larger values are returned. Default = std::less<>
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @details for a small k every thread streams its own chunk through a top_k_heap and the
+ * heaps are merged in the end, in O(n + k log(k) log(n)) on random input. A large k is
+ * selected with quick_select on a copy instead, in O(n + k log(k)).
+ * @return std::vector<T> the min(k, n) largest values, from the largest to the smallest.
+ */
+template <typename Iter, typename Compare = std::less<>>
+auto top_k(Iter first, Iter last, size_t k, Compare comp = Compare(), size_t threads = 1) {
+    using T = typename std::iterator_traits<Iter>::value_type;
+    size_t n = static_cast<size_t>(std::distance(first, last));
+    k = std::min(k, n);
+    if (k * 16 > n) {
+        std::vector<T> v(first, last);
+        auto greater = [&](const T& a, const T& b) { return comp(b, a); };
+        partial_quick_sort(v.begin(), v.begin() + k, v.end(), greater);
+        v.resize(k);
+        return v;
+    }
+    threads = PARALLEL::resolve_threads(threads, n / (1 << 16) + 1);
+    std::vector<top_k_heap<T, Compare>> heaps(threads, top_k_heap<T, Compare>(k, comp));
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            heaps[t].push(first + n * t / threads, first + n * (t + 1) / threads);
+        }
+    });
+    for (size_t t = 1; t < threads; t++) {
+        heaps[0].merge(heaps[t]);
+    }
+    return heaps[0].sorted();
+}
+
+#endif // SELECTION_H
@@ -0,0 +1,287 @@
+#ifndef SORTING_NETWORK_H
+#define SORTING_NETWORK_H
+
+#include "../../helpers/parallel.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief the longest range network_sort sorts with a sorting network
+ */
+inline constexpr size_t network_sort_max = 64;
+
+namespace _sorting_network_utils {
+// the values are padded with the largest value of their type up to the size of the network
+template <typename T> constexpr T sentinel() {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::numeric_limits<T>::infinity();
+    } else {
+        return std::numeric_limits<T>::max();
+    }
+}
+
+#if defined(__AVX2__)
+/**
+ * @brief the AVX2 operations of the network on a type: lanes values per vector, the
+ * elementwise min and max, the vector with the lanes i and i ^ j swapped, and
+ * take_min(base, j, k), the mask of the lanes that keep the min in the step(k, j) of a
+ * vector whose first value is the base-th one.
+ */
+template <typename T> struct simd {
+    static constexpr bool enabled = false;
+};
+
+template <> struct simd<int32_t> {
+    static constexpr bool enabled = true;
+    static constexpr size_t lanes = 8;
+    using V = __m256i;
+    static V load(const int32_t* p) { return _mm256_load_si256(reinterpret_cast<const V*>(p)); }
+    static void store(int32_t* p, V v) { _mm256_store_si256(reinterpret_cast<V*>(p), v); }
+    static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    static V max(V a, V b) { return _mm256_max_epi32(a, b); }
+    static V swap(V v, size_t j) {
+        __m256 f = _mm256_castsi256_ps(v);
+        if (j == 1) {
+            return _mm256_castps_si256(_mm256_permute_ps(f, 0xB1));
+        }
+        if (j == 2) {
+            return _mm256_castps_si256(_mm256_permute_ps(f, 0x4E));
+        }
+        return _mm256_permute2x128_si256(v, v, 1);
+    }
+    static V blend(V a, V b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+    static __m256i take_min(size_t base, size_t j, size_t k) {
+        __m256i i = _mm256_add_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                     _mm256_set1_epi32(int32_t(base)));
+        __m256i zero = _mm256_setzero_si256();
+        __m256i low = _mm256_cmpeq_epi32(_mm256_and_si256(i, _mm256_set1_epi32(int32_t(j))), zero);
+        __m256i up = _mm256_cmpeq_epi32(_mm256_and_si256(i, _mm256_set1_epi32(int32_t(k))), zero);
+        return _mm256_cmpeq_epi32(low, up);
+    }
+};
+
+template <> struct simd<float> {
+    static constexpr bool enabled = true;
+    static constexpr size_t lanes = 8;
+    using V = __m256;
+    static V load(const float* p) { return _mm256_load_ps(p); }
+    static void store(float* p, V v) { _mm256_store_ps(p, v); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V swap(V v, size_t j) {
+        if (j == 1) {
+            return _mm256_permute_ps(v, 0xB1);
+        }
+        if (j == 2) {
+            return _mm256_permute_ps(v, 0x4E);
+        }
+        return _mm256_permute2f128_ps(v, v, 1);
+    }
+    static V blend(V a, V b, __m256i mask) {
+        return _mm256_blendv_ps(a, b, _mm256_castsi256_ps(mask));
+    }
+    static __m256i take_min(size_t base, size_t j, size_t k) {
+        return simd<int32_t>::take_min(base, j, k);
+    }
+};
+
+template <> struct simd<int64_t> {
+    static constexpr bool enabled = true;
+    static constexpr size_t lanes = 4;
+    using V = __m256i;
+    static V load(const int64_t* p) { return _mm256_load_si256(reinterpret_cast<const V*>(p)); }
+    static void store(int64_t* p, V v) { _mm256_store_si256(reinterpret_cast<V*>(p), v); }
+    static V min(V a, V b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static V max(V a, V b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    static V swap(V v, size_t j) {
+        return j == 1 ? _mm256_permute4x64_epi64(v, 0xB1) : _mm256_permute4x64_epi64(v, 0x4E);
+    }
+    static V blend(V a, V b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+    static __m256i take_min(size_t base, size_t j, size_t k) {
+        __m256i i = _mm256_add_epi64(_mm256_setr_epi64x(0, 1, 2, 3),
+                                     _mm256_set1_epi64x(int64_t(base)));
+        __m256i zero = _mm256_setzero_si256();
+        __m256i low =
+            _mm256_cmpeq_epi64(_mm256_and_si256(i, _mm256_set1_epi64x(int64_t(j))), zero);
+        __m256i up = _mm256_cmpeq_epi64(_mm256_and_si256(i, _mm256_set1_epi64x(int64_t(k))), zero);
+        return _mm256_cmpeq_epi64(low, up);
+    }
+};
+
+template <> struct simd<double> {
+    static constexpr bool enabled = true;
+    static constexpr size_t lanes = 4;
+    using V = __m256d;
+    static V load(const double* p) { return _mm256_load_pd(p); }
+    static void store(double* p, V v) { _mm256_store_pd(p, v); }
+    static V min(V a, V b) { return _mm256_min_pd(a, b); }
+    static V max(V a, V b) { return _mm256_max_pd(a, b); }
+    static V swap(V v, size_t j) {
+        return j == 1 ? _mm256_permute_pd(v, 0x5) : _mm256_permute2f128_pd(v, v, 1);
+    }
+    static V blend(V a, V b, __m256i mask) {
+        return _mm256_blendv_pd(a, b, _mm256_castsi256_pd(mask));
+    }
+    static __m256i take_min(size_t base, size_t j, size_t k) {
+        return simd<int64_t>::take_min(base, j, k);
+    }
+};
+
+/**
+ * @brief bitonic sort of the R vectors of v, R a power of two. The steps whose pairs are
+ * lanes j apart with j < lanes swap the lanes inside every vector and blend the min and
+ * the max, the others take the min and the max of two whole vectors.
+ */
+template <typename S, size_t R> void bitonic(typename S::V* v) {
+    constexpr size_t L = S::lanes, N = L * R;
+    for (size_t k = 2; k <= N; k *= 2) {
+        for (size_t j = k / 2; j > 0; j /= 2) {
+            if (j >= L) {
+                size_t d = j / L;
+                for (size_t r = 0; r < R; r++) {
+                    if (r & d) {
+                        continue;
+                    }
+                    auto lo = S::min(v[r], v[r + d]), hi = S::max(v[r], v[r + d]);
+                    bool up = ((r * L) & k) == 0;
+                    v[r] = up ? lo : hi;
+                    v[r + d] = up ? hi : lo;
+                }
+            } else {
+                for (size_t r = 0; r < R; r++) {
+                    auto w = S::swap(v[r], j);
+                    v[r] = S::blend(S::max(v[r], w), S::min(v[r], w), S::take_min(r * L, j, k));
+                }
+            }
+        }
+    }
+}
+
+template <typename T, size_t R> void simd_sort(T* buf) {
+    using S = simd<T>;
+    typename S::V v[R];
+    for (size_t r = 0; r < R; r++) {
+        v[r] = S::load(buf + r * S::lanes);
+    }
+    bitonic<S, R>(v);
+    for (size_t r = 0; r < R; r++) {
+        S::store(buf + r * S::lanes, v[r]);
+    }
+}
+
+/**
+ * @brief sorts a[0, n), n <= network_sort_max, with the smallest network that holds it:
+ * the values are copied to an aligned buffer padded with sentinels, sorted there and
+ * copied back.
+ */
+template <typename T> void sort(T* a, size_t n) {
+    constexpr size_t L = simd<T>::lanes;
+    alignas(32) T buf[network_sort_max];
+    size_t r = std::bit_ceil((n + L - 1) / L);
+    std::copy(a, a + n, buf);
+    std::fill(buf + n, buf + r * L, sentinel<T>());
+    switch (r) {
+    case 1:
+        simd_sort<T, 1>(buf);
+        break;
+    case 2:
+        simd_sort<T, 2>(buf);
+        break;
+    case 4:
+        simd_sort<T, 4>(buf);
+        break;
+    case 8:
+        simd_sort<T, 8>(buf);
+        break;
+    default:
+        if constexpr (L == 4) {
+            simd_sort<T, 16>(buf);
+        }
+    }
+    std::copy(buf, buf + n, a);
+}
+#endif
+
+/**
+ * @brief true when the values of Iter have a vector network: AVX2 is enabled and they are
+ * contiguous int32_t, float, int64_t or double
+ */
+template <typename Iter>
+constexpr bool network_type = [] {
+#if defined(__AVX2__)
+    using T = typename std::iterator_traits<Iter>::value_type;
+    return std::contiguous_iterator<Iter> && simd<T>::enabled;
+#else
+    return false;
+#endif
+}();
+
+/**
+ * @brief true when [Iter, Iter) sorted by Compare can go to the networks: the values
+ * have a network and Compare is operator<
+ */
+template <typename Iter, typename Compare>
+constexpr bool network_sortable =
+    network_type<Iter> &&
+    (std::is_same_v<Compare, std::less<>> ||
+     std::is_same_v<Compare, std::less<typename std::iterator_traits<Iter>::value_type>>);
+} // namespace _sorting_network_utils
+
+/**
+ * @brief sorts a short range with a bitonic sorting network
+ * @param first An iterator to the beginning of the range to be sorted.
+ * @param last An iterator to the end of the range to be sorted.
+ * @details The network does the same compare exchanges whatever the values are, so it
+ * never mispredicts a branch. With AVX2 the contiguous int32_t, float, int64_t and double
+ * ranges of up to network_sort_max values are sorted in vector registers, 8 or 4 values
+ * per register, and the other ranges go to std::sort. The sort is not stable, and the
+ * floating point values must not be NaN.
+ */
+template <typename Iter> void network_sort(Iter first, Iter last) {
+#if defined(__AVX2__)
+    if constexpr (_sorting_network_utils::network_type<Iter>) {
+        size_t n = static_cast<size_t>(last - first);
+        if (n <= network_sort_max) {
+            if (n > 1) {
+                _sorting_network_utils::sort(std::to_address(first), n);
+            }
+            return;
+        }
+    }
+#endif
+    std::sort(first, last);
+}
+
+/**
+ * @brief sorts every list of lists, many short lists on threads threads
+ * @param lists the lists to sort.
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @details every thread sorts a contiguous chunk of the lists with network_sort, so the
+ * short ones cost a single network each.
+ */
+template <typename T>
+void network_sort_each(std::vector<std::vector<T>>& lists, size_t threads = 1) {
+    threads = PARALLEL::resolve_threads(threads, lists.size() / 1024 + 1);
+    PARALLEL::parallel_for(0, lists.size(), threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            network_sort(lists[i].begin(), lists[i].end());
+        }
+    });
+}
+
+#endif // SORTING_NETWORK_H
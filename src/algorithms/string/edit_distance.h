@@ -1,50 +1,239 @@
 #ifndef MIN_DISTANCE_H
 #define MIN_DISTANCE_H
 
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <iostream>
+#include <limits>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #endif
 
+namespace _edit_distance_utils {
+constexpr size_t word = 64;
+constexpr uint64_t high = uint64_t(1) << 63;
+
 /**
- * @brief edit distance function
- * @param word1 first string
- * @param word2 second string
- * @return int64_t the minimum steps to make word1 equal to word2(i.e. the
- * distance of word1 and word2)
+ * @brief one column of one block of 64 rows(Myers, with the global distance boundary of
+ * Hyyro): pv and mv hold the +1 and -1 vertical deltas of the rows, eq the rows whose
+ * character matches the text character, hin the horizontal delta above the block.
+ * @return int the horizontal delta below the block.
+ */
+inline int advance(uint64_t& pv, uint64_t& mv, uint64_t eq, int hin) {
+    uint64_t xv = eq | mv;
+    if (hin < 0) {
+        eq |= 1;
+    }
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv), mh = pv & xh;
+    int hout = (ph & high) ? 1 : (mh & high) ? -1 : 0;
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0) {
+        mh |= 1;
+    } else if (hin > 0) {
+        ph |= 1;
+    }
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+
+/**
+ * @brief the rows [lo, 64) of a block, for lo < 64
+ */
+inline uint64_t rows_from(size_t lo) { return ~uint64_t(0) << lo; }
+} // namespace _edit_distance_utils
+
+/**
+ * @brief myers pattern class
+ * A query compiled for bit-parallel Levenshtein distance(Myers 1999, Hyyro 2003): the
+ * column of the DP table is kept as bit vectors of +1/-1 vertical deltas, 64 rows per
+ * machine word, so a character of the text costs about 15 word operations per 64
+ * characters of the query instead of 64 cell updates. With a maximum distance k only the
+ * diagonal band of the cells that can lie on a path of cost <= k is computed, and the
+ * scan stops as soon as every cell of the band is known to exceed k.
  */
-int64_t min_dist(const std::string word1, const std::string word2) {
-    if (word1.size() == 0 && word2.size() == 0) {
-        return 0;
+class myers_pattern {
+  public:
+    /**
+     * @brief Construct a new myers pattern object
+     * @param query the string the others are compared to
+     */
+    explicit myers_pattern(std::string_view query)
+        : _m(query.size()), _blocks((query.size() + 63) / 64), _peq(256 * _blocks, 0) {
+        for (size_t i = 0; i < _m; i++) {
+            _peq[size_t(static_cast<unsigned char>(query[i])) * _blocks + i / 64] |=
+                uint64_t(1) << (i % 64);
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the length of the query.
+     */
+    size_t size() const { return _m; }
+
+    /**
+     * @brief distance function
+     * @param text the string compared to the query
+     * @return size_t the edit distance(insertions, deletions and substitutions) of the
+     * query and text.
+     */
+    size_t distance(std::string_view text) const {
+        return distance(text, std::max(_m, text.size()));
+    }
+
+    /**
+     * @brief distance function with a cutoff
+     * @param text the string compared to the query
+     * @param max_distance the largest distance of interest
+     * @return size_t the edit distance of the query and text if it is at most max_distance,
+     * max_distance + 1 otherwise.
+     */
+    size_t distance(std::string_view text, size_t max_distance) const {
+        size_t n = text.size(), k = std::min(max_distance, std::max(_m, n));
+        if ((_m > n ? _m - n : n - _m) > k) {
+            return max_distance + 1;
+        }
+        if (_m == 0 || n == 0) {
+            return std::max(_m, n);
+        }
+        size_t d = _blocks == 1 ? _single(text, k) : _banded(text, k);
+        return d > k ? max_distance + 1 : d;
     }
-    if (word1.size() == 0 && word2.size() != 0) {
-        return word2.size();
+
+  private:
+    size_t _m;
+    size_t _blocks;
+    // _peq[c * _blocks + b] has a bit for every row of block b whose character is c
+    std::vector<uint64_t> _peq;
+
+    uint64_t _eq(char c, size_t b) const {
+        return _peq[size_t(static_cast<unsigned char>(c)) * _blocks + b];
+    }
+
+    // the first row of the band at column j: rows i with |i - j| + |(m - i) - (n - j)| <= k,
+    // the others cannot lie on a path of cost <= k
+    static int64_t _band_lo(int64_t j, int64_t c, int64_t k) {
+        int64_t x = c - k;
+        return j + (x >= 0 ? (x + 1) / 2 : -((-x) / 2));
     }
-    if (word1.size() != 0 && word2.size() == 0) {
-        return word1.size();
+
+    static int64_t _band_hi(int64_t j, int64_t c, int64_t k) {
+        int64_t x = c + k;
+        return j + (x >= 0 ? x / 2 : -((-x + 1) / 2));
     }
-    int n = word1.size(), w = word2.size();
-    std::vector<std::vector<int>> dp(n + 1, std::vector<int>(w + 1));
-    for (int i = 0; i <= n; i++) {
-        dp[i][0] = i;
+
+    // D[m][n] from the score at the bottom row of the last block and its padding rows
+    size_t _result(uint64_t pv, uint64_t mv, int64_t score) const {
+        size_t used = _m - (_blocks - 1) * 64;
+        if (used < 64) {
+            uint64_t pad = _edit_distance_utils::rows_from(used);
+            score -= std::popcount(pv & pad) - std::popcount(mv & pad);
+        }
+        return size_t(score);
     }
 
-    for (int i = 0; i <= w; i++) {
-        dp[0][i] = i;
+    size_t _single(std::string_view text, size_t k) const {
+        int64_t n = int64_t(text.size()), c = int64_t(_m) - n;
+        uint64_t pv = ~uint64_t(0), mv = 0;
+        int64_t score = 64;
+        for (int64_t j = 1; j <= n; j++) {
+            score += _edit_distance_utils::advance(pv, mv, _eq(text[j - 1], 0), 1);
+            // every cell of the band is at least the score less the +1 deltas below it
+            int64_t lo = std::max<int64_t>(1, _band_lo(j, c, int64_t(k)));
+            int64_t bound = score - std::popcount(pv & _edit_distance_utils::rows_from(lo - 1));
+            if (bound > int64_t(k)) {
+                return k + 1;
+            }
+        }
+        return _result(pv, mv, score);
     }
-    for (int i = 1; i <= n; i++) {
-        for (int j = 1; j <= w; j++) {
-            if (word1[i - 1] == word2[j - 1]) {
-                dp[i][j] = dp[i - 1][j - 1];
-            } else {
-                dp[i][j] = std::min(dp[i - 1][j - 1], std::min(dp[i - 1][j], dp[i][j - 1])) + 1;
+
+    size_t _banded(std::string_view text, size_t k) const {
+        namespace utils = _edit_distance_utils;
+        int64_t n = int64_t(text.size()), m = int64_t(_m), c = m - n, K = int64_t(k);
+        std::vector<uint64_t> pv(_blocks), mv(_blocks);
+        std::vector<int64_t> score(_blocks);
+        int64_t first = 0, last = -1;
+        for (int64_t j = 1; j <= n; j++) {
+            int64_t lo = std::max<int64_t>(1, _band_lo(j, c, K));
+            int64_t hi = std::min<int64_t>(m, _band_hi(j, c, K));
+            // the blocks that enter the band start from an upper bound of their cells that
+            // is a valid column, +1 deltas below the bottom of the block above(or below
+            // D[i][j - 1] <= i + j - 1 if there is none), their cells are outside the band
+            // so far
+            for (int64_t b = (hi - 1) / 64; last < b;) {
+                last++;
+                pv[last] = ~uint64_t(0);
+                mv[last] = 0;
+                score[last] = (last > first ? score[last - 1] : last * 64 + j - 1) + 64;
+            }
+            // the blocks above the band are dropped, the first one left gets a +1 delta
+            // above it, an upper bound of the row it cannot see anymore
+            first = std::max(first, (lo - 1) / 64);
+            int hin = 1;
+            int64_t bound = std::numeric_limits<int64_t>::max();
+            for (int64_t b = first; b <= last; b++) {
+                hin = utils::advance(pv[b], mv[b], _eq(text[j - 1], size_t(b)), hin);
+                score[b] += hin;
+                size_t top = size_t(std::max<int64_t>(0, lo - 1 - b * 64));
+                if (top < 64) {
+                    int64_t below = std::popcount(pv[b] & utils::rows_from(top));
+                    bound = std::min(bound, score[b] - below);
+                }
+            }
+            if (bound > K) {
+                return k + 1;
             }
         }
+        return _result(pv[last], mv[last], score[last]);
     }
+};
 
-    return dp[n][w];
+/**
+ * @brief edit distances of one query to many candidates
+ * @param query the string the candidates are compared to
+ * @param candidates the strings
+ * @param max_distance the largest distance of interest, the candidates beyond it are
+ * rejected as soon as their band exceeds it. Default = no limit
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return std::vector<size_t> the distance of every candidate, max_distance + 1 for the
+ * ones farther than max_distance.
+ */
+inline std::vector<size_t>
+edit_distances(std::string_view query, std::span<const std::string> candidates,
+               size_t max_distance = std::numeric_limits<size_t>::max(), size_t threads = 1) {
+    myers_pattern p(query);
+    std::vector<size_t> out(candidates.size());
+    threads = PARALLEL::resolve_threads(threads, candidates.size() / 1024 + 1);
+    PARALLEL::parallel_for(0, candidates.size(), threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            out[i] = p.distance(candidates[i], max_distance);
+        }
+    });
+    return out;
+}
+
+/**
+ * @brief edit distance function
+ * @param word1 first string
+ * @param word2 second string
+ * @return int64_t the minimum steps to make word1 equal to word2(i.e. the
+ * distance of word1 and word2)
+ */
+inline int64_t min_dist(const std::string& word1, const std::string& word2) {
+    // the shorter string is the pattern, it needs fewer blocks
+    const std::string& a = word1.size() <= word2.size() ? word1 : word2;
+    const std::string& b = word1.size() <= word2.size() ? word2 : word1;
+    return int64_t(myers_pattern(a).distance(b));
 }
 
 #endif
@@ -1,9 +1,17 @@
 #ifndef ALGOPLUS_REGEX_PATTERNS_H
 #define ALGOPLUS_REGEX_PATTERNS_H
 
+#include "../../classes/tree/aho_corasick.h"
+#include "substring_search.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <concepts>
+#include <ranges>
 #include <regex>
 #include <string>
+#include <string_view>
+#include <vector>
 #endif
 
 /**
@@ -21,19 +29,210 @@
  * @param pattern The regex pattern to search for.
  * @param newstr The word to replace the matched patterns with.
  */
-void find_and_replace_regex(std::string& target, const std::string pattern,
-                            const std::string newstr) {
+inline void find_and_replace_regex(std::string& target, const std::string pattern,
+                                   const std::string newstr) {
     std::regex regex_pattern(pattern);
     target = std::regex_replace(target, regex_pattern, newstr);
 }
 
+namespace _find_and_replace_utils {
+// calls found(at) with the matches of pattern in text, from left to right and without
+// overlaps
+template <typename F> void matches(std::string_view text, std::string_view pattern, F&& found) {
+    if (pattern.empty()) {
+        return;
+    }
+    substring_searcher m{std::string(pattern)};
+    for (size_t at = m.find(text); at != substring_searcher::npos;
+         at = m.find(text, at + pattern.size())) {
+        found(at);
+    }
+}
+} // namespace _find_and_replace_utils
+
+/**
+ * @brief a range of (pattern, replacement) pairs, such as a std::map or a vector of pairs
+ */
+template <typename R>
+concept replacement_range =
+    std::ranges::input_range<R> && requires(std::ranges::range_reference_t<R> p) {
+        std::string(p.first);
+        std::string(p.second);
+    };
+
+/**
+ * @brief replace all function, writing to a callback
+ * @details the matches are found in one pass with substring_searcher, from left to right
+ * and without overlaps, and the output is written in pieces as they are known, so it
+ * never has to be held in memory
+ * @param text the input text
+ * @param pattern the substring to replace, an empty pattern replaces nothing
+ * @param replacement the substring that replaces every match
+ * @param write called with the consecutive pieces of the output, as std::string_view
+ */
+template <typename W>
+    requires std::invocable<W&, std::string_view>
+void replace_all(std::string_view text, std::string_view pattern, std::string_view replacement,
+                 W&& write) {
+    size_t done = 0;
+    _find_and_replace_utils::matches(text, pattern, [&](size_t at) {
+        write(text.substr(done, at - done));
+        write(replacement);
+        done = at + pattern.size();
+    });
+    write(text.substr(done));
+}
+
+/**
+ * @brief replace all function
+ * @param text the input text
+ * @param pattern the substring to replace, an empty pattern replaces nothing
+ * @param replacement the substring that replaces every match
+ * @return std::string text with every match of pattern, from left to right and without
+ * overlaps, replaced, built in one buffer of the exact size.
+ */
+inline std::string replace_all(std::string_view text, std::string_view pattern,
+                               std::string_view replacement) {
+    std::vector<size_t> at;
+    _find_and_replace_utils::matches(text, pattern, [&](size_t i) { at.push_back(i); });
+    std::string out;
+    out.reserve(text.size() - at.size() * pattern.size() + at.size() * replacement.size());
+    size_t done = 0;
+    for (size_t i : at) {
+        out.append(text, done, i - done);
+        out.append(replacement);
+        done = i + pattern.size();
+    }
+    out.append(text, done);
+    return out;
+}
+
+/**
+ * @brief string replacer class
+ * Many patterns and their replacements compiled once into an aho_corasick automaton, so
+ * a text is rewritten in one pass whatever the number of patterns. Where matches overlap
+ * the leftmost one wins, and the longest among the ones that start at the same position.
+ */
+class string_replacer {
+  public:
+    /**
+     * @brief Construct a new string replacer object
+     * @param replacements the (pattern, replacement) pairs.
+     * Throws std::invalid_argument if a pattern is empty.
+     */
+    template <replacement_range R> explicit string_replacer(const R& replacements) {
+        std::vector<std::string> patterns;
+        for (const auto& [pattern, replacement] : replacements) {
+            patterns.emplace_back(pattern);
+            _replacement.emplace_back(replacement);
+            _longest = std::max(_longest, patterns.back().size());
+        }
+        _ac = aho_corasick(patterns);
+    }
+
+    /**
+     * @brief replace function, writing to a callback
+     * @param text the input text
+     * @param write called with the consecutive pieces of the output, as std::string_view
+     */
+    template <typename W>
+        requires std::invocable<W&, std::string_view>
+    void replace(std::string_view text, W&& write) const {
+        size_t done = 0;
+        _matches(text, [&](size_t start, size_t id) {
+            write(text.substr(done, start - done));
+            write(std::string_view(_replacement[id]));
+            done = start + _ac.length(id);
+        });
+        write(text.substr(done));
+    }
+
+    /**
+     * @brief replace function
+     * @param text the input text
+     * @return std::string text with the matches replaced, built in one buffer of the exact
+     * size.
+     */
+    std::string replace(std::string_view text) const {
+        std::vector<std::pair<size_t, size_t>> chosen;
+        size_t size = text.size();
+        _matches(text, [&](size_t start, size_t id) {
+            chosen.push_back({start, id});
+            size = size - _ac.length(id) + _replacement[id].size();
+        });
+        std::string out;
+        out.reserve(size);
+        size_t done = 0;
+        for (auto [start, id] : chosen) {
+            out.append(text, done, start - done);
+            out.append(_replacement[id]);
+            done = start + _ac.length(id);
+        }
+        out.append(text, done);
+        return out;
+    }
+
+  private:
+    aho_corasick _ac;
+    std::vector<std::string> _replacement;
+    size_t _longest{0};
+
+    // calls chosen(start, id) with the matches that are replaced, in order. The matches
+    // come from the automaton by their end, a pending match is chosen once no match that
+    // is still unseen can start before it, that is once the scan is _longest bytes past
+    // its start.
+    template <typename F> void _matches(std::string_view text, F&& chosen) const {
+        struct match {
+            size_t start, length, id;
+        };
+        std::vector<match> pending;
+        size_t cursor = 0;
+        // end is the position of the scan, npos once it is over
+        auto resolve = [&](size_t end) {
+            while (!pending.empty()) {
+                auto best = std::min_element(
+                    pending.begin(), pending.end(), [](const match& a, const match& b) {
+                        return a.start != b.start ? a.start < b.start : a.length > b.length;
+                    });
+                if (end != std::string_view::npos && end < best->start + _longest) {
+                    return;
+                }
+                chosen(best->start, best->id);
+                cursor = best->start + best->length;
+                std::erase_if(pending, [&](const match& m) { return m.start < cursor; });
+            }
+        };
+        _ac.scan(text, 0, [&](size_t id, size_t end) {
+            resolve(end);
+            size_t start = end - _ac.length(id);
+            if (start >= cursor) {
+                pending.push_back({start, _ac.length(id), id});
+            }
+            return true;
+        });
+        resolve(std::string_view::npos);
+    }
+};
+
+/**
+ * @brief replace all function for many patterns
+ * @param text the input text
+ * @param replacements the (pattern, replacement) pairs
+ * @return std::string text with the matches replaced as string_replacer does, a
+ * string_replacer saves the build of the automaton when many texts use the same patterns.
+ */
+template <replacement_range R>
+std::string replace_all(std::string_view text, const R& replacements) {
+    return string_replacer(replacements).replace(text);
+}
+
 /**
  * @brief Finds all occurrences of a given substring in a string and replaces
  * them with a new substring.
  * @details
  * This function searches for all occurrences of the specified `oldStr` in the
- * input `str` and replaces them with the `newStr`. The replacement is done
- * in-place, meaning the original `str` is modified.
+ * input `str` and replaces them with the `newStr`. The matches are found in one
+ * pass and the result is built once, see replace_all.
  * @note This function should be used for non-complex patterns as it does not
  * support regular expressions. For complex pattern matching and replacement,
  * consider using find_and_replace_regex that supports regular expressions.
@@ -41,12 +240,9 @@ void find_and_replace_regex(std::string& target, const std::string pattern,
  * @param oldStr The substring to be replaced.
  * @param newStr The substring to replace `oldStr`.
  */
-void find_and_replace(std::string& str, const std::string pattern, const std::string newstr) {
-    std::string::size_type pos = 0u;
-    while ((pos = str.find(pattern, pos)) != std::string::npos) {
-        str.replace(pos, pattern.length(), newstr);
-        pos += newstr.length();
-    }
+inline void find_and_replace(std::string& str, const std::string pattern,
+                             const std::string newstr) {
+    str = replace_all(str, pattern, newstr);
 }
 
 #endif // ALGOPLUS_REGEX_PATTERNS_H
@@ -2,16 +2,21 @@
 #define KMP_H
 
 #ifdef __cplusplus
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #endif
 
 namespace helper_array {
-std::vector<int> get_array(std::string& pattern) {
+inline std::vector<int> get_array(const std::string& pattern) {
     std::vector<int> failure(pattern.size() + 1);
     failure[0] = -1;
-    for (int i = 0, j = -1; i < pattern.size(); i++) {
+    for (int i = 0, j = -1; i < int(pattern.size()); i++) {
         while (j != -1 && pattern[j] != pattern[i]) {
             j = failure[j];
         }
@@ -21,6 +26,215 @@ std::vector<int> get_array(std::string& pattern) {
 }
 }; // namespace helper_array
 
+/**
+ * @brief kmp_matcher class
+ * A pattern compiled once for the knuth morris pratt algorithm: the failure table is built
+ * in the constructor and every search only reads it, so one matcher can be shared by any
+ * number of searches and threads. Matches may overlap.
+ */
+class kmp_matcher {
+  public:
+    /**
+     * @brief returned by find when there is no match
+     */
+    static constexpr size_t npos = std::string_view::npos;
+
+    /**
+     * @brief Construct a new kmp matcher object
+     * @param pattern the pattern we want to search for
+     */
+    explicit kmp_matcher(std::string pattern)
+        : _pattern(std::move(pattern)), _failure(_pattern.size() + 1, 0) {
+        // _failure[i] is the length of the longest proper border of the first i characters
+        for (size_t i = 1, k = 0; i < _pattern.size(); i++) {
+            while (k > 0 && _pattern[k] != _pattern[i]) {
+                k = _failure[k];
+            }
+            if (_pattern[k] == _pattern[i]) {
+                k++;
+            }
+            _failure[i + 1] = uint32_t(k);
+        }
+    }
+
+    /**
+     * @brief pattern function
+     * @return const std::string& the pattern.
+     */
+    const std::string& pattern() const { return _pattern; }
+
+    /**
+     * @brief scan function, the step every search is built on
+     * @param text the next characters of the text
+     * @param state the number of characters of the pattern matched by the end of the
+     * previous characters, 0 at the start of a text
+     * @param found called with the position in text right after every match, the scan
+     * stops as soon as it returns false
+     * @return size_t the state at the end of text(or right after the match that stopped
+     * the scan), to carry into the next characters
+     * @details while nothing is matched the scan jumps to the next occurrence of the first
+     * character of the pattern with memchr, so on a text where it is rare the scan runs at
+     * memchr speed instead of one character per step.
+     */
+    template <typename F> size_t scan(std::string_view text, size_t state, F&& found) const {
+        const size_t m = _pattern.size();
+        const char* p = text.data();
+        const size_t n = text.size();
+        if (m == 0) {
+            for (size_t j = 1; j <= n; j++) {
+                if (!found(j)) {
+                    break;
+                }
+            }
+            return 0;
+        }
+        size_t k = state;
+        for (size_t j = 0; j < n;) {
+            if (k == 0) {
+                const void* hit = std::memchr(p + j, static_cast<unsigned char>(_pattern[0]),
+                                              n - j);
+                if (hit == nullptr) {
+                    return 0;
+                }
+                j = size_t(static_cast<const char*>(hit) - p) + 1;
+                k = 1;
+            } else {
+                char c = p[j++];
+                while (k > 0 && _pattern[k] != c) {
+                    k = _failure[k];
+                }
+                if (_pattern[k] == c) {
+                    k++;
+                }
+            }
+            if (k == m) {
+                k = _failure[m];
+                if (!found(j)) {
+                    return k;
+                }
+            }
+        }
+        return k;
+    }
+
+    /**
+     * @brief find function
+     * @param text the text we want to search
+     * @param pos the position the search starts at. Default = 0
+     * @return size_t the position of the first match at or after pos, npos if there is none
+     */
+    size_t find(std::string_view text, size_t pos = 0) const {
+        if (pos > text.size()) {
+            return npos;
+        }
+        if (_pattern.empty()) {
+            return pos;
+        }
+        size_t at = npos;
+        scan(text.substr(pos), 0, [&](size_t end) {
+            at = pos + end - _pattern.size();
+            return false;
+        });
+        return at;
+    }
+
+    /**
+     * @brief find_all function
+     * @param text the text we want to search
+     * @return std::vector<size_t> the positions of all the matches, in order. An empty
+     * pattern matches at every position, text.size() included.
+     */
+    std::vector<size_t> find_all(std::string_view text) const {
+        std::vector<size_t> matches;
+        if (_pattern.empty()) {
+            matches.push_back(0);
+        }
+        scan(text, 0, [&](size_t end) {
+            matches.push_back(end - _pattern.size());
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief contains function
+     * @param text the text we want to search
+     * @return true if the pattern occurs in text
+     * @return false otherwise
+     */
+    bool contains(std::string_view text) const { return find(text) != npos; }
+
+  private:
+    std::string _pattern;
+    std::vector<uint32_t> _failure;
+};
+
+/**
+ * @brief kmp_stream class
+ * Searches a text that arrives in successive chunks(reads from a socket, windows of a
+ * mapped file, ...) without keeping any of it: the only state carried across chunks is the
+ * number of pattern characters matched so far, so matches that straddle a chunk boundary
+ * are found and every match is reported by its offset in the whole stream. The matcher
+ * must outlive the stream.
+ */
+class kmp_stream {
+  public:
+    /**
+     * @brief Construct a new kmp stream object
+     * @param matcher the compiled pattern, it must not be empty
+     */
+    explicit kmp_stream(const kmp_matcher& matcher) : _matcher(matcher) {
+        if (matcher.pattern().empty()) {
+            throw std::invalid_argument("kmp_stream: the pattern is empty");
+        }
+    }
+
+    /**
+     * @brief feed function
+     * @param chunk the next characters of the stream
+     * @param found called with the stream offset of every match that ends in chunk
+     */
+    template <typename F> void feed(std::string_view chunk, F&& found) {
+        const size_t base = _offset, m = _matcher.pattern().size();
+        _state = _matcher.scan(chunk, _state, [&](size_t end) {
+            found(base + end - m);
+            return true;
+        });
+        _offset += chunk.size();
+    }
+
+    /**
+     * @brief feed function
+     * @param chunk the next characters of the stream
+     * @return std::vector<size_t> the stream offsets of the matches that end in chunk
+     */
+    std::vector<size_t> feed(std::string_view chunk) {
+        std::vector<size_t> matches;
+        feed(chunk, [&](size_t at) { matches.push_back(at); });
+        return matches;
+    }
+
+    /**
+     * @brief offset function
+     * @return size_t the number of characters fed since the stream started.
+     */
+    size_t offset() const { return _offset; }
+
+    /**
+     * @brief reset function
+     * Starts a new stream.
+     */
+    void reset() {
+        _state = 0;
+        _offset = 0;
+    }
+
+  private:
+    const kmp_matcher& _matcher;
+    size_t _state{0};
+    size_t _offset{0};
+};
+
 /**
  * @brief knuth morris pratt algorithm
  *
@@ -29,16 +243,8 @@ std::vector<int> get_array(std::string& pattern) {
  * @return true if pattern exists in the text
  * @return false otherwise
  */
-bool kmp(std::string pattern, std::string text) {
-    std::vector<int> failure = helper_array::get_array(pattern);
-    for (int j = 0, k = 0; j < text.size(); j++) {
-        while (k != -1 && pattern[k] != text[j]) {
-            k = failure[k];
-        }
-        if (++k == pattern.size())
-            return true;
-    }
-    return false;
+inline bool kmp(const std::string& pattern, const std::string& text) {
+    return kmp_matcher(pattern).contains(text);
 }
 
 #endif
@@ -2,8 +2,14 @@
 #define PALINDROME_H
 
 #ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #endif
 
 /**
@@ -13,9 +19,9 @@
  * @return true if str is palindrome
  * @return false otherwise
  */
-bool is_palindrome(const std::string str) {
+inline bool is_palindrome(std::string_view str) {
     int64_t _size = str.size();
-    for (int i = 0; i < _size / 2; i++) {
+    for (int64_t i = 0; i < _size / 2; i++) {
         if (str[i] != str[_size - i - 1]) {
             return false;
         }
@@ -23,4 +29,274 @@ bool is_palindrome(const std::string str) {
     return true;
 }
 
+/**
+ * @brief manacher class
+ * The radii of the longest palindromes at all the 2n - 1 centers of a string in O(n)
+ * (Manacher): a palindrome is mirrored inside the largest palindrome that contains it, so
+ * every center starts from the radius of its mirror and the right end of the rightmost
+ * palindrome only moves forward. Then a substring is tested in O(1), the longest
+ * palindrome and the number of palindromic substrings are found with one more pass. 8
+ * bytes per character.
+ */
+class manacher {
+  public:
+    /**
+     * @brief Construct a new manacher object
+     * @param text: the string, it is not kept.
+     * Throws std::length_error if the text is longer than 2^31 - 1 bytes.
+     */
+    inline explicit manacher(std::string_view text) {
+        if (text.size() > size_t(INT32_MAX)) {
+            throw std::length_error("manacher: the text is too long");
+        }
+        int32_t n = int32_t(text.size());
+        _odd.assign(n, 0);
+        _even.assign(n, 0);
+        // _odd[i]: the palindromes [i - k + 1, i + k) for k <= _odd[i]
+        for (int32_t i = 0, l = 0, r = -1; i < n; i++) {
+            int32_t k = i > r ? 1 : std::min(_odd[l + r - i], r - i + 1);
+            while (i - k >= 0 && i + k < n && text[i - k] == text[i + k]) {
+                k++;
+            }
+            _odd[i] = k;
+            if (i + k - 1 > r) {
+                l = i - k + 1;
+                r = i + k - 1;
+            }
+        }
+        // _even[i]: the palindromes [i - k, i + k) for k <= _even[i]
+        for (int32_t i = 0, l = 0, r = -1; i < n; i++) {
+            int32_t k = i > r ? 0 : std::min(_even[l + r - i + 1], r - i + 1);
+            while (i - k - 1 >= 0 && i + k < n && text[i - k - 1] == text[i + k]) {
+                k++;
+            }
+            _even[i] = k;
+            if (i + k - 1 > r) {
+                l = i - k;
+                r = i + k - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the length of the string.
+     */
+    inline size_t size() const { return _odd.size(); }
+
+    /**
+     * @brief odd radius function
+     * @param i: a position.
+     * @return size_t k, the longest odd palindrome centered at i is [i - k + 1, i + k).
+     */
+    inline size_t odd_radius(size_t i) const { return size_t(_odd[i]); }
+
+    /**
+     * @brief even radius function
+     * @param i: a position.
+     * @return size_t k, the longest even palindrome centered right before i is
+     * [i - k, i + k).
+     */
+    inline size_t even_radius(size_t i) const { return size_t(_even[i]); }
+
+    /**
+     * @brief is palindrome function
+     * @param l: the first position of the substring.
+     * @param r: the position right after its end, l <= r <= size().
+     * @return true if the substring [l, r) is a palindrome, in O(1).
+     */
+    inline bool is_palindrome(size_t l, size_t r) const {
+        size_t len = r - l;
+        if (len <= 1) {
+            return true;
+        }
+        size_t mid = l + len / 2;
+        return len % 2 ? size_t(_odd[mid]) * 2 - 1 >= len : size_t(_even[mid]) * 2 >= len;
+    }
+
+    /**
+     * @brief longest function
+     * @return std::pair<size_t, size_t> the start and the length of the leftmost longest
+     * palindromic substring, (0, 0) for an empty string.
+     */
+    inline std::pair<size_t, size_t> longest() const {
+        size_t start = 0, len = 0;
+        for (size_t i = 0; i < size(); i++) {
+            size_t odd = size_t(_odd[i]) * 2 - 1, even = size_t(_even[i]) * 2;
+            // a later center with the same length starts later, so only longer ones win
+            if (odd > len) {
+                start = i + 1 - _odd[i];
+                len = odd;
+            }
+            if (even > len) {
+                start = i - _even[i];
+                len = even;
+            }
+        }
+        return {start, len};
+    }
+
+    /**
+     * @brief count function
+     * @return uint64_t the number of palindromic substrings, counted once per position.
+     */
+    inline uint64_t count() const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < size(); i++) {
+            total += uint64_t(_odd[i]) + uint64_t(_even[i]);
+        }
+        return total;
+    }
+
+  private:
+    std::vector<int32_t> _odd;
+    std::vector<int32_t> _even;
+};
+
+/**
+ * @brief longest palindrome function
+ * @param text: the passed string.
+ * @return std::string_view the leftmost longest palindromic substring of text, in O(n).
+ */
+inline std::string_view longest_palindrome(std::string_view text) {
+    auto [start, len] = manacher(text).longest();
+    return text.substr(start, len);
+}
+
+/**
+ * @brief count palindromes function
+ * @param text: the passed string.
+ * @return uint64_t the number of palindromic substrings of text, counted once per
+ * position, in O(n).
+ */
+inline uint64_t count_palindromes(std::string_view text) { return manacher(text).count(); }
+
+/**
+ * @brief eertree class
+ * Palindromic tree(Rubinchik and Shur): one node for every distinct palindromic substring,
+ * with the edge c from the node of p to the node of cpc and a suffix link to its longest
+ * proper palindromic suffix. The string is appended one character at a time, in amortized
+ * O(1) per character plus the walk over the children of a node(at most the alphabet), and a
+ * string of length n has at most n distinct palindromes, so the tree has at most n + 2
+ * nodes.
+ */
+class eertree {
+  public:
+    /**
+     * @brief Construct a new eertree object
+     * @param text: the first characters. Default = empty.
+     */
+    inline explicit eertree(std::string_view text = {}) {
+        // the roots: node 0 of length -1(so that a character alone extends it), node 1 is
+        // the empty palindrome, whose suffix link goes to node 0
+        _nodes.push_back({-1, 0, -1, -1, 0, 0, 0});
+        _nodes.push_back({0, 0, -1, -1, 0, 0, 0});
+        _text.reserve(text.size());
+        for (char c : text) {
+            push_back(c);
+        }
+    }
+
+    /**
+     * @brief push_back function
+     * @param c: the next character of the string.
+     * Throws std::length_error past 2^31 - 1 characters.
+     */
+    inline void push_back(char c) {
+        if (_text.size() >= size_t(INT32_MAX)) {
+            throw std::length_error("eertree: the string is too long");
+        }
+        _text.push_back(c);
+        int32_t i = int32_t(_text.size()) - 1;
+        int32_t v = _suffix_with(_last, i);
+        int32_t u = _child(v, c);
+        if (u < 0) {
+            u = int32_t(_nodes.size());
+            int32_t len = _nodes[v].length + 2;
+            int32_t link = len == 1 ? 1 : _child(_suffix_with(_nodes[v].link, i), c);
+            _nodes.push_back({len, link, -1, _nodes[v].child, c, uint32_t(i), 0});
+            _nodes[v].child = u;
+        }
+        _nodes[u].ends++;
+        _last = u;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of distinct palindromic substrings.
+     */
+    inline size_t size() const { return _nodes.size() - 2; }
+
+    /**
+     * @brief distinct function
+     * @return std::vector<std::pair<size_t, size_t>> the start of the first occurrence and
+     * the length of every distinct palindromic substring, in the order they appear.
+     */
+    inline std::vector<std::pair<size_t, size_t>> distinct() const {
+        std::vector<std::pair<size_t, size_t>> out;
+        out.reserve(size());
+        for (size_t u = 2; u < _nodes.size(); u++) {
+            size_t len = size_t(_nodes[u].length);
+            out.push_back({_nodes[u].first_end + 1 - len, len});
+        }
+        return out;
+    }
+
+    /**
+     * @brief occurrences function
+     * @return std::vector<uint64_t> the number of occurrences of every distinct palindrome,
+     * in the order of distinct().
+     */
+    inline std::vector<uint64_t> occurrences() const {
+        std::vector<uint64_t> count(_nodes.size());
+        for (size_t u = 0; u < _nodes.size(); u++) {
+            count[u] = _nodes[u].ends;
+        }
+        // a palindrome occurs wherever one that has it as a suffix ends, the nodes are
+        // created after their suffix links so the reverse order pushes the counts down
+        for (size_t u = _nodes.size() - 1; u >= 2; u--) {
+            count[size_t(_nodes[u].link)] += count[u];
+        }
+        return std::vector<uint64_t>(count.begin() + 2, count.end());
+    }
+
+  private:
+    struct node {
+        int32_t length;
+        int32_t link;
+        // the first child, the others follow through sibling
+        int32_t child;
+        int32_t sibling;
+        // the character of the edge from the parent
+        char c;
+        uint32_t first_end;
+        // the positions where this is the longest palindromic suffix
+        uint64_t ends;
+    };
+    std::vector<node> _nodes;
+    std::string _text;
+    int32_t _last{1};
+
+    int32_t _child(int32_t v, char c) const {
+        for (int32_t u = _nodes[v].child; u >= 0; u = _nodes[u].sibling) {
+            if (_nodes[u].c == c) {
+                return u;
+            }
+        }
+        return -1;
+    }
+
+    // the longest palindromic suffix along the links from v that extends to end at i
+    int32_t _suffix_with(int32_t v, int32_t i) const {
+        while (true) {
+            int32_t j = i - 1 - _nodes[v].length;
+            // node 0 always stops the walk, j = i for it
+            if (j >= 0 && _text[j] == _text[i]) {
+                return v;
+            }
+            v = _nodes[v].link;
+        }
+    }
+};
+
 #endif
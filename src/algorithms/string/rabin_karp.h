@@ -1,58 +1,397 @@
 #ifndef RABIN_KARP_H
 #define RABIN_KARP_H
 
+#include "../../helpers/fast_hash.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #endif
 
-namespace {
-const int base = 26;
-const int modulus = 1e9 + 7;
+namespace _rabin_karp_utils {
+// the hashes are taken modulo the mersenne prime 2^61 - 1
+constexpr uint64_t modulus = (uint64_t(1) << 61) - 1;
+// windows hashed side by side by window_hashes
+constexpr size_t lanes = 4;
+// windows hashed at a time by the scan of rabin_karp_set
+constexpr size_t block = 512;
 
 /**
- * @brief Computes the hash value of a substring within a given string.
- * @param str The input string.
- * @param start The starting index of the substring.
- * @param end The ending index of the substring.
- * @return The computed hash value of the substring.
+ * @brief x mod 2^61 - 1 for x < 2^63
  */
-size_t compute_hash(const std::string& str, size_t start, size_t end) {
-    size_t curr_mod = 1;
-    size_t hash_value = 0;
-    for (size_t i = start; i < end; i++) {
-        hash_value = (hash_value + (size_t(str[end - i - 1]) * curr_mod) % modulus) % modulus;
-        curr_mod = (curr_mod * base) % modulus;
-    }
-    return hash_value;
+inline uint64_t reduce(uint64_t x) {
+    x = (x & modulus) + (x >> 61);
+    return x >= modulus ? x - modulus : x;
 }
 
 /**
- * @brief Check if two substrings have a collision
- *
- * This function compares two substrings from two given strings to check if they
- * have a collision. A collision occurs if the characters in the corresponding
- * positions of the substrings are not equal.
- *
- * @param str1 The first string
- * @param start1 The starting position of the first substring in str1
- * @param str2 The second string
- * @param start2 The starting position of the second substring in str2
- * @param length The length of the substrings to compare
- * @return true if the substrings have a collision, false otherwise
- * @note This function assumes str1 and str2 are valid strings with lengths
- * greater than or equal to start1 + length and start2 + length respectively.
+ * @brief a value congruent to a * b mod 2^61 - 1 and less than 2^62, for a, b < 2^61 - 1,
+ * with one 64 x 64 -> 128 bit product and no division
+ */
+inline uint64_t mul_lazy(uint64_t a, uint64_t b) {
+    unsigned __int128 p = (unsigned __int128)a * b;
+    return (uint64_t(p) & modulus) + uint64_t(p >> 61);
+}
+
+/**
+ * @brief a * b mod 2^61 - 1 for a, b < 2^61 - 1
+ */
+inline uint64_t mul(uint64_t a, uint64_t b) { return reduce(mul_lazy(a, b)); }
+
+/**
+ * @brief the base of the polynomial hash for a seed, in [256, 2^61 - 1)
  */
-bool check_collision(const std::string& str1, size_t start1, const std::string& str2, size_t start2,
-                     size_t length) {
-    for (size_t i = 0; i < length; ++i) {
-        if (str1[start1 + i] != str2[start2 + i]) {
-            return false;
+inline uint64_t base_of(uint64_t seed) {
+    // splitmix64
+    return 256 + HASHING::mix(seed + HASHING::GOLDEN) % (modulus - 256);
+}
+} // namespace _rabin_karp_utils
+
+/**
+ * @brief rolling hash class
+ * Polynomial hash of the windows of a fixed length, h(s) = s[0] B^(L-1) + ... + s[L-1]
+ * modulo the mersenne prime 2^61 - 1, where the base B comes from a seed. Two different
+ * windows collide with probability about L / 2^61 over the choice of the base(the small
+ * moduli of 32 bit hashes collide every few billion windows). Rolling the window one byte
+ * costs one multiplication: the contribution of the byte that leaves is read from a table.
+ */
+class rolling_hash {
+  public:
+    /**
+     * @brief Construct a new rolling hash object
+     * @param window the length of the windows, at least 1
+     * @param seed picks the base of the hash, a random seed keeps adversarial inputs from
+     * forcing collisions. Default = 0
+     */
+    explicit rolling_hash(size_t window, uint64_t seed = 0)
+        : _window(window), _base(_rabin_karp_utils::base_of(seed)) {
+        if (window == 0) {
+            throw std::invalid_argument("rolling_hash: the window is empty");
+        }
+        namespace utils = _rabin_karp_utils;
+        uint64_t top = 1;
+        for (size_t i = 0; i < window; i++) {
+            top = utils::mul(top, _base);
+        }
+        // modulus - c B^L, added when the byte c leaves the window
+        for (size_t c = 0; c < 256; c++) {
+            _leave[c] = utils::modulus - utils::mul(c, top);
         }
     }
-    return true;
-}
-} // namespace
+
+    /**
+     * @brief window function
+     * @return size_t the length of the windows.
+     */
+    size_t window() const { return _window; }
+
+    /**
+     * @brief hash function
+     * @param s a string of any length
+     * @return uint64_t the hash of s(the hash of a window for s.size() == window()).
+     */
+    uint64_t hash(std::string_view s) const {
+        uint64_t h = 0;
+        for (char c : s) {
+            h = _rabin_karp_utils::reduce(_rabin_karp_utils::mul_lazy(h, _base) + _byte(c));
+        }
+        return h;
+    }
+
+    /**
+     * @brief roll function
+     * @param h the hash of a window
+     * @param out the first byte of the window
+     * @param in the byte right after the window
+     * @return uint64_t the hash of the window moved one byte to the right.
+     */
+    uint64_t roll(uint64_t h, char out, char in) const {
+        // less than 2^62 + 2 * 2^61, a single reduction is enough
+        return _rabin_karp_utils::reduce(_rabin_karp_utils::mul_lazy(h, _base) + _byte(in) +
+                                         _leave[_byte(out)]);
+    }
+
+    /**
+     * @brief window_hashes function
+     * @param text the text
+     * @param first the first window, it starts at text[first]
+     * @param count the number of windows, first + count + window() - 1 <= text.size()
+     * @param out the hashes of the windows
+     * @details a roll depends on the previous one, so the chain of multiplications limits a
+     * single rolling hash. The windows are split in 4 parts that are rolled side by side in
+     * one loop, the 4 chains are independent and overlap in the pipeline.
+     */
+    void window_hashes(std::string_view text, size_t first, size_t count, uint64_t* out) const {
+        constexpr size_t K = _rabin_karp_utils::lanes;
+        const char* p = text.data() + first;
+        size_t part = count / K, i = 0;
+        if (part > 1) {
+            uint64_t h[K];
+            for (size_t k = 0; k < K; k++) {
+                h[k] = out[k * part] = hash(std::string_view(p + k * part, _window));
+            }
+            for (size_t j = 1; j < part; j++) {
+                for (size_t k = 0; k < K; k++) {
+                    size_t at = k * part + j;
+                    h[k] = out[at] = roll(h[k], p[at - 1], p[at + _window - 1]);
+                }
+            }
+            i = K * part;
+        }
+        // the windows the parts leave over, and all of them for a short text
+        for (; i < count; i++) {
+            out[i] = i == 0 ? hash(std::string_view(p, _window))
+                            : roll(out[i - 1], p[i - 1], p[i + _window - 1]);
+        }
+    }
+
+    /**
+     * @brief window_hashes function
+     * @param text the text
+     * @return std::vector<uint64_t> the hash of every window of text, text.size() -
+     * window() + 1 of them(none if text is shorter than a window).
+     */
+    std::vector<uint64_t> window_hashes(std::string_view text) const {
+        if (text.size() < _window) {
+            return {};
+        }
+        std::vector<uint64_t> out(text.size() - _window + 1);
+        window_hashes(text, 0, out.size(), out.data());
+        return out;
+    }
+
+  private:
+    size_t _window;
+    uint64_t _base;
+    uint64_t _leave[256];
+
+    static uint64_t _byte(char c) { return static_cast<unsigned char>(c); }
+};
+
+/**
+ * @brief a match of rabin_karp_set: the id of the pattern(its index in the constructor)
+ * and the position it starts at
+ */
+struct rabin_karp_match {
+    size_t pattern;
+    size_t position;
+
+    bool operator==(const rabin_karp_match&) const = default;
+};
+
+/**
+ * @brief rabin karp set class
+ * Many patterns of the same length matched in one pass: the text is hashed with a
+ * rolling_hash, every window hash is tested against a bitmap of the pattern hashes and
+ * looked up in an open addressing table of them if its bit is set, only the windows whose
+ * hash is there are compared byte by byte. A pass costs about the same for one pattern or
+ * a hundred thousand. Useful to find the known shingles of a document.
+ */
+class rabin_karp_set {
+  public:
+    /**
+     * @brief Construct a new rabin karp set object
+     * @param patterns the patterns, all of the same length, at least 1. The id of a pattern is
+     * its index, duplicates are reported under each id.
+     * @param seed picks the base of the hash. Default = 0
+     * Throws std::invalid_argument if the patterns are empty or their lengths differ.
+     */
+    explicit rabin_karp_set(const std::vector<std::string>& patterns, uint64_t seed = 0)
+        : _hash(patterns.empty() || patterns[0].empty() ? 1 : patterns[0].size(), seed) {
+        if (patterns.empty() || patterns[0].empty()) {
+            throw std::invalid_argument("rabin_karp_set: no patterns or an empty pattern");
+        }
+        size_t slots = std::bit_ceil(std::max<size_t>(16, 2 * patterns.size()));
+        _shift = 64 - std::countr_zero(slots);
+        _slots.assign(slots, _entry{});
+        size_t bits = std::bit_ceil(std::max<size_t>(512, 64 * patterns.size()));
+        _filter_shift = 64 - std::countr_zero(bits);
+        _filter.assign(bits / 64, 0);
+        _next.assign(patterns.size(), -1);
+        _patterns.reserve(patterns.size() * window());
+        for (size_t id = 0; id < patterns.size(); id++) {
+            if (patterns[id].size() != window()) {
+                throw std::invalid_argument("rabin_karp_set: the patterns differ in length");
+            }
+            _patterns += patterns[id];
+            uint64_t h = _hash.hash(patterns[id]);
+            _insert(h, int32_t(id));
+            _filter[_bit(h) / 64] |= uint64_t(1) << (_bit(h) % 64);
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of patterns.
+     */
+    size_t size() const { return _next.size(); }
+
+    /**
+     * @brief window function
+     * @return size_t the length of the patterns.
+     */
+    size_t window() const { return _hash.window(); }
+
+    /**
+     * @brief hasher function
+     * @return const rolling_hash& the hash of the windows.
+     */
+    const rolling_hash& hasher() const { return _hash; }
+
+    /**
+     * @brief find function
+     * @param window a string of window() bytes
+     * @return int64_t the id of the first pattern equal to window, -1 if there is none.
+     */
+    int64_t find(std::string_view window) const {
+        if (window.size() != this->window()) {
+            return -1;
+        }
+        return _lookup(_hash.hash(window), window.data());
+    }
+
+    /**
+     * @brief scan function
+     * @param text the text
+     * @param found called with the pattern id and the position of every match in order,
+     * the scan stops as soon as it returns false
+     */
+    template <typename F> void scan(std::string_view text, F&& found) const {
+        if (text.size() < window()) {
+            return;
+        }
+        // the windows are hashed a block at a time by window_hashes, and the filter words of
+        // a block are prefetched ahead of their tests
+        constexpr size_t B = _rabin_karp_utils::block, ahead = 8;
+        uint64_t h[B];
+        size_t n = text.size() - window() + 1;
+        for (size_t lo = 0; lo < n; lo += B) {
+            size_t m = std::min(B, n - lo);
+            _hash.window_hashes(text, lo, m, h);
+            for (size_t i = 0; i < std::min(ahead, m); i++) {
+                __builtin_prefetch(&_filter[_bit(h[i]) / 64]);
+            }
+            for (size_t i = 0; i < m; i++) {
+                if (i + ahead < m) {
+                    __builtin_prefetch(&_filter[_bit(h[i + ahead]) / 64]);
+                }
+                if (!_maybe(h[i])) {
+                    continue;
+                }
+                const char* w = text.data() + lo + i;
+                for (int32_t id = _lookup(h[i], w); id >= 0; id = _next_equal(id, w)) {
+                    if (!found(size_t(id), lo + i)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief find_all function
+     * @param text the text
+     * @return std::vector<rabin_karp_match> every match, by position and then by id.
+     */
+    std::vector<rabin_karp_match> find_all(std::string_view text) const {
+        std::vector<rabin_karp_match> matches;
+        scan(text, [&](size_t id, size_t at) {
+            matches.push_back({id, at});
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief find_all function, on precomputed window hashes
+     * @param text the text
+     * @param hashes the hash of every window of text, as returned by
+     * hasher().window_hashes(text)
+     * @return std::vector<rabin_karp_match> every match, by position and then by id.
+     */
+    std::vector<rabin_karp_match> find_all(std::string_view text,
+                                           const std::vector<uint64_t>& hashes) const {
+        std::vector<rabin_karp_match> matches;
+        for (size_t i = 0; i < hashes.size(); i++) {
+            const char* w = text.data() + i;
+            if (!_maybe(hashes[i])) {
+                continue;
+            }
+            for (int32_t id = _lookup(hashes[i], w); id >= 0; id = _next_equal(id, w)) {
+                matches.push_back({size_t(id), i});
+            }
+        }
+        return matches;
+    }
+
+  private:
+    rolling_hash _hash;
+    int _shift;
+    // open addressing on the hashes, head is the first id of the patterns of the hash
+    struct _entry {
+        uint64_t key{0};
+        int32_t head{-1};
+    };
+    std::vector<_entry> _slots;
+    // one bit per hash in a bitmap 64 times larger than the patterns: most windows miss it
+    // and skip the probe, whose branches would be mispredicted at the load of the table
+    std::vector<uint64_t> _filter;
+    int _filter_shift;
+    // the next pattern of the same hash, in id order
+    std::vector<int32_t> _next;
+    std::string _patterns;
+
+    size_t _slot(uint64_t h) const { return size_t((h * 0x9e3779b97f4a7c15ull) >> _shift); }
+
+    size_t _bit(uint64_t h) const { return size_t((h * 0xd6e8feb86659fd93ull) >> _filter_shift); }
+
+    bool _maybe(uint64_t h) const { return (_filter[_bit(h) / 64] >> (_bit(h) % 64)) & 1; }
+
+    bool _equal(int32_t id, const char* w) const {
+        return std::memcmp(_patterns.data() + size_t(id) * window(), w, window()) == 0;
+    }
+
+    void _insert(uint64_t h, int32_t id) {
+        size_t mask = _slots.size() - 1, s = _slot(h);
+        while (_slots[s].head >= 0 && _slots[s].key != h) {
+            s = (s + 1) & mask;
+        }
+        if (_slots[s].head < 0) {
+            _slots[s] = {h, id};
+            return;
+        }
+        int32_t last = _slots[s].head;
+        while (_next[last] >= 0) {
+            last = _next[last];
+        }
+        _next[last] = id;
+    }
+
+    // the first pattern equal to the window w of hash h, -1 if none
+    int32_t _lookup(uint64_t h, const char* w) const {
+        size_t mask = _slots.size() - 1;
+        for (size_t s = _slot(h); _slots[s].head >= 0; s = (s + 1) & mask) {
+            if (_slots[s].key == h) {
+                int32_t id = _slots[s].head;
+                return _equal(id, w) ? id : _next_equal(id, w);
+            }
+        }
+        return -1;
+    }
+
+    // the next pattern after id with the same hash equal to the window w, -1 if none
+    int32_t _next_equal(int32_t id, const char* w) const {
+        for (id = _next[id]; id >= 0 && !_equal(id, w); id = _next[id]) {
+        }
+        return id;
+    }
+};
 
 /**
  * @brief Executes the Rabin-Karp algorithm to search for occurrences of a
@@ -67,47 +406,19 @@ bool check_collision(const std::string& str1, size_t start1, const std::string&
  * @return A vector of starting indices of all occurrences of the pattern in the
  * text. If none were found the vector is empty.
  */
-std::vector<size_t> rabin_karp(const std::string& text, const std::string& pattern) {
+inline std::vector<size_t> rabin_karp(const std::string& text, const std::string& pattern) {
     std::vector<size_t> result;
-    size_t pattern_length = pattern.length();
-    size_t text_length = text.length();
-
-    if (pattern_length == 0) { // if pattern is empty, it can be found at every
-                               // index including the end of the text
-        for (size_t i = 0; i <= text_length; i++) {
+    if (pattern.empty()) { // if pattern is empty, it can be found at every
+                           // index including the end of the text
+        for (size_t i = 0; i <= text.size(); i++) {
             result.push_back(i);
         }
         return result;
     }
-
-    if (text_length < pattern_length) { // if text is shorter than pattern,
-                                        // pattern can not be found
-        return result;
-    }
-
-    // calculate the hash of the pattern and the hash of the first pattern_length
-    // characters of the text
-    size_t pattern_hash = compute_hash(pattern, 0, pattern_length);
-    size_t text_hash = compute_hash(text, 0, pattern_length);
-
-    // the highest power used in the hash calculation of the pattern
-    size_t power = 1;
-    for (int i = 0; i < pattern_length - 1; ++i)
-        power = (power * base) % modulus;
-
-    for (size_t i = 0; i <= text_length - pattern_length; ++i) {
-        if (pattern_hash == text_hash && check_collision(text, i, pattern, 0, pattern_length)) {
-            result.push_back(i);
-        }
-
-        if (i < text_length - pattern_length) {
-            text_hash =
-                (base * (text_hash - ((size_t)text[i] * power % modulus) + modulus) % modulus +
-                 (size_t)text[i + pattern_length]) %
-                modulus;
-        }
-    }
-
+    rabin_karp_set(std::vector<std::string>{pattern}).scan(text, [&](size_t, size_t at) {
+        result.push_back(at);
+        return true;
+    });
     return result;
 }
 
@@ -1,20 +1,30 @@
 #ifndef STRING_HASHING_H
 #define STRING_HASHING_H
 
+#include "../../helpers/parallel.h"
+#include "rabin_karp.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <numeric>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #endif
 
 /**
  * @brief string hasher class
  * @details very useful for fast insert/search for strings as it
- * uses the builtin hash function
+ * uses the hash of the library(HASHING::hash_string)
  */
 class string_hasher {
   private:
-    std::unordered_map<size_t, int> hash_table;
+    std::unordered_map<size_t, int, HASHING::hasher<size_t>> hash_table;
 
   public:
     explicit string_hasher() noexcept {}
@@ -24,7 +34,7 @@ class string_hasher {
      * @param str the passed string
      */
     void insert(const std::string str) noexcept {
-        size_t hashed = std::hash<std::string>{}(str);
+        size_t hashed = HASHING::hash_string(str);
         hash_table[hashed] = 1;
     }
 
@@ -35,7 +45,7 @@ class string_hasher {
      * @return false otherwise
      */
     bool search(const std::string str) noexcept {
-        size_t hashed = std::hash<std::string>{}(str);
+        size_t hashed = HASHING::hash_string(str);
         return hash_table[hashed] != 0;
     }
 
@@ -46,4 +56,224 @@ class string_hasher {
     unsigned long long size() { return hash_table.size(); }
 };
 
+namespace _string_hashing_utils {
+// the powers B^0..B^n of the base of a seed
+inline std::vector<uint64_t> powers(size_t n, uint64_t seed) {
+    uint64_t base = _rabin_karp_utils::base_of(seed);
+    std::vector<uint64_t> pw(n + 1);
+    pw[0] = 1;
+    for (size_t i = 0; i < n; i++) {
+        pw[i + 1] = _rabin_karp_utils::mul(pw[i], base);
+    }
+    return pw;
+}
+
+// the prefix hashes of s into out[0..s.size()]
+inline void prefixes(std::string_view s, uint64_t base, uint64_t* out) {
+    uint64_t h = 0;
+    out[0] = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        h = _rabin_karp_utils::reduce(_rabin_karp_utils::mul_lazy(h, base) +
+                                      static_cast<unsigned char>(s[i]));
+        out[i + 1] = h;
+    }
+}
+
+// the hash of [l, r) from the prefix hashes p and the powers pw
+inline uint64_t range(const uint64_t* p, const uint64_t* pw, size_t l, size_t r) {
+    namespace utils = _rabin_karp_utils;
+    // p[r] - p[l] B^(r - l), the product is less than 2^62 so the sum fits
+    return utils::reduce(p[r] + 2 * utils::modulus - utils::mul_lazy(p[l], pw[r - l]));
+}
+} // namespace _string_hashing_utils
+
+/**
+ * @brief prefix hash class
+ * The polynomial hashes of all the prefixes of a string modulo the mersenne prime 2^61 - 1
+ * (the hash of rolling_hash, with the same seed the two agree), and the powers of the
+ * base, so the hash of any substring takes O(1): h(s[l, r)) = h(s[0, r)) - h(s[0, l)) B^(r - l).
+ * Two different substrings collide with probability about n / 2^61. 16 bytes per character.
+ */
+class prefix_hash {
+  public:
+    /**
+     * @brief Construct a new prefix hash object
+     * @param text the string, it is not kept
+     * @param seed picks the base of the hash. Default = 0
+     */
+    explicit prefix_hash(std::string_view text, uint64_t seed = 0)
+        : _prefix(text.size() + 1), _pow(_string_hashing_utils::powers(text.size(), seed)) {
+        _string_hashing_utils::prefixes(text, _rabin_karp_utils::base_of(seed), _prefix.data());
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the length of the string.
+     */
+    size_t size() const { return _prefix.size() - 1; }
+
+    /**
+     * @brief hash function
+     * @return uint64_t the hash of the whole string.
+     */
+    uint64_t hash() const { return _prefix.back(); }
+
+    /**
+     * @brief substring hash function
+     * @param l the first position of the substring
+     * @param r the position right after its end, l <= r <= size()
+     * @return uint64_t the hash of the substring [l, r), in O(1).
+     */
+    uint64_t substring_hash(size_t l, size_t r) const {
+        return _string_hashing_utils::range(_prefix.data(), _pow.data(), l, r);
+    }
+
+    /**
+     * @brief equal function
+     * @param i the start of a substring
+     * @param j the start of another substring
+     * @param length their length, i + length and j + length are at most size()
+     * @return true if the two substrings have the same hash(so are equal with high
+     * probability)
+     */
+    bool equal(size_t i, size_t j, size_t length) const {
+        return substring_hash(i, i + length) == substring_hash(j, j + length);
+    }
+
+    /**
+     * @brief common prefix function
+     * @param i the start of a suffix
+     * @param j the start of another suffix
+     * @return size_t the length of the longest common prefix of the two suffixes, by binary
+     * search on the hashes in O(log(n)).
+     */
+    size_t common_prefix(size_t i, size_t j) const {
+        size_t lo = 0, hi = size() - std::max(i, j);
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo + 1) / 2;
+            if (equal(i, j, mid)) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        return lo;
+    }
+
+  private:
+    std::vector<uint64_t> _prefix;
+    std::vector<uint64_t> _pow;
+};
+
+/**
+ * @brief prefix hash set class
+ * The prefix hashes of many strings in one array, with one table of powers for all of
+ * them, built in parallel. Substrings of different strings can be compared in O(1).
+ */
+class prefix_hash_set {
+  public:
+    /**
+     * @brief Construct a new prefix hash set object
+     * @param strings the strings, they are not kept
+     * @param seed picks the base of the hash. Default = 0
+     * @param threads number of threads(0 means every hardware thread). Default = 1
+     */
+    explicit prefix_hash_set(std::span<const std::string> strings, uint64_t seed = 0,
+                             size_t threads = 1)
+        : _start(strings.size() + 1, 0) {
+        size_t longest = 0;
+        for (size_t i = 0; i < strings.size(); i++) {
+            _start[i + 1] = _start[i] + strings[i].size() + 1;
+            longest = std::max(longest, strings[i].size());
+        }
+        _pow = _string_hashing_utils::powers(longest, seed);
+        _prefix.resize(_start.back());
+        uint64_t base = _rabin_karp_utils::base_of(seed);
+        threads = PARALLEL::resolve_threads(threads, _prefix.size() / (1 << 16) + 1);
+        PARALLEL::parallel_for_dynamic(0, strings.size(), threads, [&](size_t i, size_t) {
+            _string_hashing_utils::prefixes(strings[i], base, _prefix.data() + _start[i]);
+        });
+    }
+
+    /**
+     * @brief count function
+     * @return size_t the number of strings.
+     */
+    size_t count() const { return _start.size() - 1; }
+
+    /**
+     * @brief size function
+     * @param s a string index
+     * @return size_t the length of the string s.
+     */
+    size_t size(size_t s) const { return _start[s + 1] - _start[s] - 1; }
+
+    /**
+     * @brief hash function
+     * @param s a string index
+     * @return uint64_t the hash of the whole string s.
+     */
+    uint64_t hash(size_t s) const { return _prefix[_start[s + 1] - 1]; }
+
+    /**
+     * @brief substring hash function
+     * @param s a string index
+     * @param l the first position of the substring
+     * @param r the position right after its end, l <= r <= size(s)
+     * @return uint64_t the hash of the substring [l, r) of the string s, in O(1).
+     */
+    uint64_t substring_hash(size_t s, size_t l, size_t r) const {
+        return _string_hashing_utils::range(_prefix.data() + _start[s], _pow.data(), l, r);
+    }
+
+  private:
+    // the prefix hashes of the string s are _prefix[_start[s], _start[s + 1])
+    std::vector<size_t> _start;
+    std::vector<uint64_t> _prefix;
+    std::vector<uint64_t> _pow;
+};
+
+/**
+ * @brief unique strings function
+ * @param strings the strings
+ * @param seed picks the base of the hash. Default = 0
+ * @param threads number of threads of the hashing(0 means every hardware thread). Default = 1
+ * @return std::vector<size_t> the index of the first occurrence of every distinct string,
+ * in increasing order. The strings are grouped by hash and the strings that share a hash
+ * are compared, so a collision never merges two different strings.
+ */
+inline std::vector<size_t> unique_strings(std::span<const std::string> strings,
+                                          uint64_t seed = 0, size_t threads = 1) {
+    size_t n = strings.size();
+    std::vector<std::pair<uint64_t, size_t>> keyed(n);
+    rolling_hash h(1, seed);
+    threads = PARALLEL::resolve_threads(threads, n / 4096 + 1);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            keyed[i] = {h.hash(strings[i]), i};
+        }
+    });
+    std::sort(keyed.begin(), keyed.end());
+    std::vector<size_t> first;
+    for (size_t a = 0, b; a < n; a = b) {
+        // a run of equal hashes, almost always of equal strings
+        for (b = a + 1; b < n && keyed[b].first == keyed[a].first; b++) {
+        }
+        // every string of the run is compared to the distinct ones met so far in it
+        size_t reps = first.size();
+        for (size_t x = a; x < b; x++) {
+            const std::string& sx = strings[keyed[x].second];
+            bool seen = false;
+            for (size_t y = reps; y < first.size() && !seen; y++) {
+                seen = strings[first[y]] == sx;
+            }
+            if (!seen) {
+                first.push_back(keyed[x].second);
+            }
+        }
+    }
+    std::sort(first.begin(), first.end());
+    return first;
+}
+
 #endif
@@ -0,0 +1,322 @@
+#ifndef SUBSTRING_SEARCH_H
+#define SUBSTRING_SEARCH_H
+
+#include "../../helpers/cpu_features.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+namespace _substring_search_utils {
+// the positions the filter tests per step
+constexpr size_t width = 32;
+
+/**
+ * @brief the filter: from i on, the first step of width positions where the first and the
+ * last byte of the pattern(of m bytes) both match somewhere, every such position sets its
+ * bit in mask. At the end of the text it returns the position it stopped at, with mask 0.
+ */
+using filter_kernel = size_t(const char* t, size_t n, size_t i, char first, char last, size_t m,
+                             uint32_t& mask);
+
+// without vectors nothing is filtered and Two-Way searches the whole text
+inline size_t filter_scalar(const char*, size_t, size_t i, char, char, size_t, uint32_t& mask) {
+    mask = 0;
+    return i;
+}
+
+#if defined(ALGOPLUS_X86_DISPATCH)
+// the positions of the 16 at p where the first and the last byte match
+ALGOPLUS_TARGET("sse2") inline uint32_t match16(const char* p, __m128i f, __m128i l, size_t m) {
+    __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), f);
+    __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + m - 1)), l);
+    return uint32_t(_mm_movemask_epi8(_mm_and_si128(a, b)));
+}
+
+ALGOPLUS_TARGET("sse2")
+inline size_t filter_sse2(const char* t, size_t n, size_t i, char first, char last, size_t m,
+                          uint32_t& mask) {
+    const __m128i f = _mm_set1_epi8(first), l = _mm_set1_epi8(last);
+    for (; i + m - 1 + width <= n; i += width) {
+        mask = match16(t + i, f, l, m) | match16(t + i + 16, f, l, m) << 16;
+        if (mask != 0) {
+            return i;
+        }
+    }
+    mask = 0;
+    return i;
+}
+
+ALGOPLUS_TARGET("avx2")
+inline size_t filter_avx2(const char* t, size_t n, size_t i, char first, char last, size_t m,
+                          uint32_t& mask) {
+    const __m256i f = _mm256_set1_epi8(first), l = _mm256_set1_epi8(last);
+    for (; i + m - 1 + width <= n; i += width) {
+        const char* p = t + i;
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), f);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + m - 1)), l);
+        mask = uint32_t(_mm256_movemask_epi8(_mm256_and_si256(a, b)));
+        if (mask != 0) {
+            return i;
+        }
+    }
+    mask = 0;
+    return i;
+}
+#endif
+
+inline const SIMD::kernels<filter_kernel>& filters() {
+    static const SIMD::kernels<filter_kernel> k{
+        .scalar = &filter_scalar,
+#if defined(ALGOPLUS_X86_DISPATCH)
+        .sse2 = &filter_sse2,
+        .avx2 = &filter_avx2,
+#endif
+    };
+    return k;
+}
+
+// the filter gives up once verifying its candidates has cost this many bytes per byte
+// scanned, and Two-Way takes over
+constexpr size_t verify_ratio = 16;
+constexpr size_t verify_slack = 4096;
+} // namespace _substring_search_utils
+
+/**
+ * @brief substring searcher class
+ * A pattern compiled for substring search. The text is scanned with a SIMD filter(Mula):
+ * the first and the last byte of the pattern are compared at 32 positions per step, with the
+ * SSE2 or AVX2 kernel the cpu runs, and only the positions where both match are verified.
+ * When the verifications cost too much(a text and a pattern made of a few repeated bytes)
+ * the rest of the text is searched with the Two-Way algorithm(Crochemore and Perrin), which
+ * takes O(n) time and O(1) memory on any input, so the search is linear in the worst case.
+ * Without SSE2 or AVX2, or with SIMD::isa::scalar forced, every search is Two-Way.
+ */
+class substring_searcher {
+  public:
+    /**
+     * @brief returned by find when there is no match
+     */
+    static constexpr size_t npos = std::string_view::npos;
+
+    /**
+     * @brief Construct a new substring searcher object
+     * @param pattern the pattern we want to search for
+     */
+    explicit substring_searcher(std::string pattern) : _pattern(std::move(pattern)) {
+        _factorize();
+    }
+
+    /**
+     * @brief pattern function
+     * @return const std::string& the pattern.
+     */
+    const std::string& pattern() const { return _pattern; }
+
+    /**
+     * @brief scan function
+     * @param text the text we want to search
+     * @param found called with the position of every match, overlapping ones included, in
+     * order, the scan stops as soon as it returns false
+     */
+    template <typename F> void scan(std::string_view text, F&& found) const {
+        _scan(text, 0, found);
+    }
+
+    /**
+     * @brief find function
+     * @param text the text we want to search
+     * @param pos the position the search starts at. Default = 0
+     * @return size_t the position of the first match at or after pos, npos if there is none
+     */
+    size_t find(std::string_view text, size_t pos = 0) const {
+        if (pos > text.size()) {
+            return npos;
+        }
+        size_t at = npos;
+        _scan(text, pos, [&](size_t i) {
+            at = i;
+            return false;
+        });
+        return at;
+    }
+
+    /**
+     * @brief find_all function
+     * @param text the text we want to search
+     * @return std::vector<size_t> the positions of all the matches, overlapping ones
+     * included, in order. An empty pattern matches at every position, text.size() included.
+     */
+    std::vector<size_t> find_all(std::string_view text) const {
+        std::vector<size_t> matches;
+        _scan(text, 0, [&](size_t i) {
+            matches.push_back(i);
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief contains function
+     * @param text the text we want to search
+     * @return true if the pattern occurs in text
+     */
+    bool contains(std::string_view text) const { return find(text) != npos; }
+
+  private:
+    std::string _pattern;
+    // the critical factorization of Two-Way: the pattern is u v with |u| = _split, _period
+    // is the period of the pattern when _periodic, a lower bound of it otherwise
+    size_t _split{0};
+    size_t _period{1};
+    bool _periodic{false};
+
+    // the end of the maximal suffix of the pattern for an order of the bytes(-1 based, as
+    // in the paper) and its period
+    std::pair<int64_t, size_t> _maximal_suffix(bool reversed) const {
+        const unsigned char* x = reinterpret_cast<const unsigned char*>(_pattern.data());
+        int64_t m = int64_t(_pattern.size()), ms = -1, j = 0, k = 1, p = 1;
+        while (j + k < m) {
+            unsigned char a = x[ms + k], b = x[j + k];
+            if (a == b) {
+                if (k == p) {
+                    j += p;
+                    k = 1;
+                } else {
+                    k++;
+                }
+            } else if (reversed ? a < b : a > b) {
+                j += k;
+                k = 1;
+                p = j - ms;
+            } else {
+                ms = j++;
+                k = p = 1;
+            }
+        }
+        return {ms, size_t(p)};
+    }
+
+    void _factorize() {
+        size_t m = _pattern.size();
+        if (m == 0) {
+            return;
+        }
+        auto [ms1, p1] = _maximal_suffix(false);
+        auto [ms2, p2] = _maximal_suffix(true);
+        // the later of the two maximal suffixes is a critical factorization
+        int64_t ms = ms1 >= ms2 ? ms1 : ms2;
+        size_t p = ms1 >= ms2 ? p1 : p2;
+        _split = size_t(ms + 1);
+        _periodic = _split + p <= m &&
+                    std::memcmp(_pattern.data(), _pattern.data() + p, _split) == 0;
+        _period = _periodic ? p : std::max(_split, m - _split) + 1;
+    }
+
+    // Two-Way from pos to the end of text, reports every match
+    template <typename F> bool _two_way(std::string_view text, size_t pos, F& found) const {
+        const char* x = _pattern.data();
+        const char* t = text.data();
+        size_t m = _pattern.size(), n = text.size();
+        // the first mem bytes at the current position are known to match
+        size_t mem = 0;
+        for (size_t h = pos; h + m <= n;) {
+            size_t k = std::max(_split, mem);
+            while (k < m && x[k] == t[h + k]) {
+                k++;
+            }
+            if (k < m) {
+                h += k - _split + 1;
+                mem = 0;
+                continue;
+            }
+            for (k = _split; k > mem && x[k - 1] == t[h + k - 1]; k--) {
+            }
+            if (k <= mem && !found(h)) {
+                return false;
+            }
+            h += _period;
+            mem = _periodic ? m - _period : 0;
+        }
+        return true;
+    }
+
+    template <typename F> void _scan(std::string_view text, size_t pos, F&& found) const {
+        const size_t m = _pattern.size(), n = text.size();
+        if (m == 0) {
+            for (size_t i = pos; i <= n && found(i); i++) {
+            }
+            return;
+        }
+        if (m > n) {
+            return;
+        }
+        const char* t = text.data();
+        if (m == 1) {
+            for (size_t i = pos; i < n; i++) {
+                const void* hit = std::memchr(t + i, _pattern[0], n - i);
+                if (hit == nullptr) {
+                    return;
+                }
+                i = size_t(static_cast<const char*>(hit) - t);
+                if (!found(i)) {
+                    return;
+                }
+            }
+            return;
+        }
+        size_t i = pos;
+        namespace utils = _substring_search_utils;
+        const auto filter = utils::filters().get();
+        const char* middle = _pattern.data() + 1;
+        size_t work = 0;
+        for (uint32_t mask;;) {
+            i = filter(t, n, i, _pattern[0], _pattern[m - 1], m, mask);
+            if (mask == 0) {
+                break;
+            }
+            for (; mask != 0; mask &= mask - 1) {
+                size_t at = i + size_t(std::countr_zero(mask));
+                work += m;
+                if (std::memcmp(t + at + 1, middle, m - 2) == 0 && !found(at)) {
+                    return;
+                }
+            }
+            i += utils::width;
+            if (work > utils::verify_ratio * (i - pos) + utils::verify_slack) {
+                break;
+            }
+        }
+        _two_way(text, i, found);
+    }
+};
+
+/**
+ * @brief substring find function
+ * @param text the text we want to search
+ * @param pattern the pattern we want to search for
+ * @param pos the position the search starts at. Default = 0
+ * @return size_t the position of the first match at or after pos, npos if there is none
+ */
+inline size_t substring_find(std::string_view text, std::string_view pattern, size_t pos = 0) {
+    return substring_searcher(std::string(pattern)).find(text, pos);
+}
+
+/**
+ * @brief substring find all function
+ * @param text the text we want to search
+ * @param pattern the pattern we want to search for
+ * @return std::vector<size_t> the positions of all the matches, overlapping ones included
+ */
+inline std::vector<size_t> substring_find_all(std::string_view text, std::string_view pattern) {
+    return substring_searcher(std::string(pattern)).find_all(text);
+}
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef SUFFIX_ARRAY_H
+#define SUFFIX_ARRAY_H
+
+#include "../../helpers/parallel.h"
+#include "../rmq/rmq_linear.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+namespace _suffix_array_utils {
+/**
+ * @brief SA-IS(Nong, Zhang and Chan): the suffix array of s, whose values are in
+ * [0, upper], in O(n). The leftmost S-type suffixes(LMS) are sorted by induced sorting from
+ * their substrings, the substrings are named by rank and, if two share a name, the
+ * suffix array of the names is built recursively, on at most half of the text.
+ */
+inline std::vector<int32_t> sa_is(const std::vector<int32_t>& s, int32_t upper) {
+    int32_t n = int32_t(s.size());
+    if (n == 0) {
+        return {};
+    }
+    if (n == 1) {
+        return {0};
+    }
+    if (n == 2) {
+        return s[0] < s[1] ? std::vector<int32_t>{0, 1} : std::vector<int32_t>{1, 0};
+    }
+    std::vector<int32_t> sa(n);
+    // true for the S-type suffixes, the ones smaller than the next suffix
+    std::vector<uint8_t> ls(n, 0);
+    for (int32_t i = n - 2; i >= 0; i--) {
+        ls[i] = s[i] == s[i + 1] ? ls[i + 1] : s[i] < s[i + 1];
+    }
+    // the start of the S part and of the L part of the bucket of every value
+    std::vector<int32_t> sum_l(upper + 1, 0), sum_s(upper + 1, 0);
+    for (int32_t i = 0; i < n; i++) {
+        if (!ls[i]) {
+            sum_s[s[i]]++;
+        } else {
+            sum_l[s[i] + 1]++;
+        }
+    }
+    for (int32_t i = 0; i <= upper; i++) {
+        sum_s[i] += sum_l[i];
+        if (i < upper) {
+            sum_l[i + 1] += sum_s[i];
+        }
+    }
+    std::vector<int32_t> buf(upper + 1);
+    auto induce = [&](const std::vector<int32_t>& lms) {
+        std::fill(sa.begin(), sa.end(), -1);
+        std::copy(sum_s.begin(), sum_s.end(), buf.begin());
+        for (int32_t d : lms) {
+            if (d != n) {
+                sa[buf[s[d]]++] = d;
+            }
+        }
+        std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+        sa[buf[s[n - 1]]++] = n - 1;
+        for (int32_t i = 0; i < n; i++) {
+            int32_t v = sa[i];
+            if (v >= 1 && !ls[v - 1]) {
+                sa[buf[s[v - 1]]++] = v - 1;
+            }
+        }
+        std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+        for (int32_t i = n - 1; i >= 0; i--) {
+            int32_t v = sa[i];
+            if (v >= 1 && ls[v - 1]) {
+                sa[--buf[s[v - 1] + 1]] = v - 1;
+            }
+        }
+    };
+
+    std::vector<int32_t> lms_map(n + 1, -1), lms;
+    int32_t m = 0;
+    for (int32_t i = 1; i < n; i++) {
+        if (!ls[i - 1] && ls[i]) {
+            lms_map[i] = m++;
+        }
+    }
+    lms.reserve(m);
+    for (int32_t i = 1; i < n; i++) {
+        if (!ls[i - 1] && ls[i]) {
+            lms.push_back(i);
+        }
+    }
+    induce(lms);
+    if (m == 0) {
+        return sa;
+    }
+    std::vector<int32_t> sorted_lms;
+    sorted_lms.reserve(m);
+    for (int32_t v : sa) {
+        if (lms_map[v] != -1) {
+            sorted_lms.push_back(v);
+        }
+    }
+    // names the LMS substrings, equal substrings get the same name
+    std::vector<int32_t> rec_s(m);
+    int32_t rec_upper = 0;
+    rec_s[lms_map[sorted_lms[0]]] = 0;
+    for (int32_t i = 1; i < m; i++) {
+        int32_t l = sorted_lms[i - 1], r = sorted_lms[i];
+        int32_t end_l = lms_map[l] + 1 < m ? lms[lms_map[l] + 1] : n;
+        int32_t end_r = lms_map[r] + 1 < m ? lms[lms_map[r] + 1] : n;
+        bool same = true;
+        if (end_l - l != end_r - r) {
+            same = false;
+        } else {
+            while (l < end_l && s[l] == s[r]) {
+                l++;
+                r++;
+            }
+            if (l == n || s[l] != s[r]) {
+                same = false;
+            }
+        }
+        if (!same) {
+            rec_upper++;
+        }
+        rec_s[lms_map[sorted_lms[i]]] = rec_upper;
+    }
+    std::vector<int32_t> rec_sa = sa_is(rec_s, rec_upper);
+    for (int32_t i = 0; i < m; i++) {
+        sorted_lms[i] = lms[rec_sa[i]];
+    }
+    induce(sorted_lms);
+    return sa;
+}
+} // namespace _suffix_array_utils
+
+/**
+ * @brief suffix array class
+ * Full text index of a string: the suffix array(SA-IS, O(n)), its inverse, the LCP array
+ * (Kasai, in parallel) and a linear_RMQ over the LCP array, so the longest
+ * common prefix of any two suffixes takes O(1) and a substring is counted in
+ * O(m log(n)) without looking at the text outside the matches. About 13 bytes per
+ * character next to the text.
+ */
+class suffix_array {
+  public:
+    /**
+     * @brief Construct a new suffix array object
+     * @param text the text, move it in to avoid the copy
+     * @param threads number of threads of the LCP and RMQ builds(0 means every hardware
+     * thread). Default = 1
+     * Throws std::length_error if the text is longer than 2^31 - 1 bytes.
+     */
+    explicit suffix_array(std::string text, size_t threads = 1) : _text(std::move(text)) {
+        if (_text.size() > size_t(INT32_MAX) - 1) {
+            throw std::length_error("suffix_array: the text is too long");
+        }
+        size_t n = _text.size();
+        std::vector<int32_t> s(n);
+        for (size_t i = 0; i < n; i++) {
+            s[i] = static_cast<unsigned char>(_text[i]);
+        }
+        _sa = _suffix_array_utils::sa_is(s, 255);
+        _rank.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            _rank[_sa[i]] = int32_t(i);
+        }
+        _lcp.build(_build_lcp(threads), threads);
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the length of the text.
+     */
+    size_t size() const { return _text.size(); }
+
+    /**
+     * @brief text function
+     * @return const std::string& the text.
+     */
+    const std::string& text() const { return _text; }
+
+    /**
+     * @brief sa function
+     * @return std::span<const int32_t> the start of every suffix, in sorted order.
+     */
+    std::span<const int32_t> sa() const { return _sa; }
+
+    /**
+     * @brief rank function
+     * @return std::span<const int32_t> the position of every suffix in sa().
+     */
+    std::span<const int32_t> rank() const { return _rank; }
+
+    /**
+     * @brief lcp function
+     * @return std::span<const int32_t> lcp()[i] is the length of the longest common prefix
+     * of the suffixes sa()[i - 1] and sa()[i], lcp()[0] = 0.
+     */
+    std::span<const int32_t> lcp() const { return _lcp.values; }
+
+    /**
+     * @brief longest common extension function
+     * @param i the start of a suffix
+     * @param j the start of another suffix
+     * @return size_t the length of the longest common prefix of the suffixes at i and j, in
+     * O(1).
+     */
+    size_t lce(size_t i, size_t j) const {
+        if (i == j) {
+            return size() - i;
+        }
+        auto [a, b] = std::minmax(_rank[i], _rank[j]);
+        return size_t(_lcp.query_value(size_t(a) + 1, size_t(b) + 1));
+    }
+
+    /**
+     * @brief range function
+     * @param pattern the substring we want to search
+     * @return std::pair<size_t, size_t> the half open range of sa() holding the suffixes
+     * that start with pattern, found by two binary searches.
+     */
+    std::pair<size_t, size_t> range(std::string_view pattern) const {
+        std::string_view t(_text);
+        // the suffix at sa[i] compared to pattern, on the first pattern.size() bytes
+        auto cmp = [&](size_t i) {
+            return t.substr(size_t(_sa[i])).compare(0, pattern.size(), pattern);
+        };
+        size_t lo = 0, hi = size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (cmp(mid) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        size_t first = lo;
+        hi = size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (cmp(mid) <= 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return {first, lo};
+    }
+
+    /**
+     * @brief count function
+     * @param pattern the substring we want to search
+     * @return size_t the number of occurrences of pattern in the text.
+     */
+    size_t count(std::string_view pattern) const {
+        auto [lo, hi] = range(pattern);
+        return hi - lo;
+    }
+
+    /**
+     * @brief contains function
+     * @param pattern the substring we want to search
+     * @return true if pattern occurs in the text.
+     */
+    bool contains(std::string_view pattern) const { return count(pattern) > 0; }
+
+    /**
+     * @brief locate function
+     * @param pattern the substring we want to search
+     * @return std::vector<size_t> the positions of all the occurrences of pattern, sorted.
+     */
+    std::vector<size_t> locate(std::string_view pattern) const {
+        auto [lo, hi] = range(pattern);
+        std::vector<size_t> at(_sa.begin() + lo, _sa.begin() + hi);
+        std::sort(at.begin(), at.end());
+        return at;
+    }
+
+  private:
+    std::string _text;
+    std::vector<int32_t> _sa;
+    std::vector<int32_t> _rank;
+    linear_RMQ<int32_t> _lcp;
+
+    // Kasai: plcp[i] is the lcp of the suffix at i and the one before it in sorted
+    // order, and plcp[i + 1] >= plcp[i] - 1, so a scan of the text does O(n) comparisons.
+    // Every thread scans a part of the text, and starts it from 0.
+    std::vector<int32_t> _build_lcp(size_t threads) {
+        size_t n = size();
+        std::vector<int32_t> plcp(n, 0);
+        threads = PARALLEL::resolve_threads(threads, n / (1 << 16) + 1);
+        PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t t = lo; t < hi; t++) {
+                size_t a = n * t / threads, b = n * (t + 1) / threads, l = 0;
+                for (size_t i = a; i < b; i++) {
+                    int32_t r = _rank[i];
+                    if (r == 0) {
+                        l = 0;
+                        continue;
+                    }
+                    size_t j = size_t(_sa[r - 1]);
+                    while (i + l < n && j + l < n && _text[i + l] == _text[j + l]) {
+                        l++;
+                    }
+                    plcp[i] = int32_t(l);
+                    l = l > 0 ? l - 1 : 0;
+                }
+            }
+        });
+        std::vector<int32_t> lcp(n, 0);
+        for (size_t r = 1; r < n; r++) {
+            lcp[r] = plcp[_sa[r]];
+        }
+        return lcp;
+    }
+};
+
+#endif
@@ -0,0 +1,612 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "../../helpers/fast_hash.h"
+#include "../../helpers/node_pool.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief the limits of a cache, it evicts until both hold
+ * @param entries: the largest number of entries.
+ * @param bytes: the largest sum of the weights of the entries.
+ */
+struct cache_limits {
+    size_t entries{SIZE_MAX};
+    size_t bytes{SIZE_MAX};
+};
+
+/**
+ * @brief counters of a cache, returned by stats()
+ * @param hits: the lookups that found their key.
+ * @param misses: the lookups that did not.
+ * @param evictions: the entries removed to make room.
+ * @param size: the number of entries.
+ * @param bytes: the sum of the weights of the entries.
+ */
+struct cache_stats {
+    size_t hits{0};
+    size_t misses{0};
+    size_t evictions{0};
+    size_t size{0};
+    size_t bytes{0};
+};
+
+/**
+ * @brief default weight of an entry of a cache
+ * The size of the key and the value, plus the elements of the ones that are contiguous
+ * containers(std::string, std::vector).
+ */
+template <typename K, typename V> struct cache_weigher {
+    size_t operator()(const K& key, const V& value) const {
+        return sizeof(K) + sizeof(V) + _heap(key) + _heap(value);
+    }
+
+  private:
+    template <typename X> static size_t _heap(const X& x) {
+        if constexpr (requires { x.data(); x.size(); }) {
+            return x.size() * sizeof(*x.data());
+        } else {
+            return 0;
+        }
+    }
+};
+
+/**
+ * @brief least recently used eviction policy
+ * The entries are in a list from the most to the least recently used, the list links
+ * are members of the entries.
+ */
+struct lru_policy {
+    struct hook {
+        void* prev{nullptr};
+        void* next{nullptr};
+    };
+
+    template <typename Entry> class state {
+      public:
+        state() = default;
+        state(const state&) = delete;
+        state& operator=(const state&) = delete;
+        state(state&& s) noexcept
+            : _head(std::exchange(s._head, nullptr)), _tail(std::exchange(s._tail, nullptr)) {}
+        state& operator=(state&& s) noexcept {
+            _head = std::exchange(s._head, nullptr);
+            _tail = std::exchange(s._tail, nullptr);
+            return *this;
+        }
+
+        void insert(Entry* e) {
+            e->prev = nullptr;
+            e->next = _head;
+            (_head ? static_cast<Entry*>(_head)->prev : _tail) = e;
+            _head = e;
+        }
+
+        void touch(Entry* e) {
+            if (e != _head) {
+                remove(e);
+                insert(e);
+            }
+        }
+
+        void remove(Entry* e) {
+            (e->prev ? static_cast<Entry*>(e->prev)->next : _head) = e->next;
+            (e->next ? static_cast<Entry*>(e->next)->prev : _tail) = e->prev;
+        }
+
+        void evict(Entry* e) { remove(e); }
+
+        // the least recently used entry other than keep
+        Entry* victim(const Entry* keep) const {
+            Entry* e = static_cast<Entry*>(_tail);
+            return e == keep ? static_cast<Entry*>(e->prev) : e;
+        }
+
+        void clear() { _head = _tail = nullptr; }
+
+        // calls f on the entries from the most to the least recently used
+        template <typename F> void for_each(F f) const {
+            for (void* e = _head; e != nullptr; e = static_cast<Entry*>(e)->next) {
+                f(static_cast<Entry*>(e));
+            }
+        }
+
+      private:
+        void* _head{nullptr};
+        void* _tail{nullptr};
+    };
+};
+
+/**
+ * @brief least frequently used eviction policy, with dynamic aging
+ * Like frequency_list: the entries are in one bucket per priority, in the order they
+ * reached it, and the priority of an entry is the number of its hits plus the priority
+ * of the last evicted entry when it was inserted, so entries that were popular long ago
+ * do not stay forever. Ties are broken by least recent use. Every operation is O(1).
+ */
+struct lfu_policy {
+    struct bucket;
+
+    struct hook {
+        void* prev{nullptr};
+        void* next{nullptr};
+        bucket* b{nullptr};
+    };
+
+    struct bucket {
+        int64_t priority;
+        bucket* lower{nullptr};
+        bucket* higher{nullptr};
+        void* head{nullptr};
+        void* tail{nullptr};
+        explicit bucket(int64_t priority) : priority(priority) {}
+    };
+
+    template <typename Entry> class state {
+      public:
+        state() = default;
+        state(const state&) = delete;
+        state& operator=(const state&) = delete;
+        state(state&& s) noexcept
+            : _buckets(std::move(s._buckets)), _low(std::exchange(s._low, nullptr)),
+              _high(std::exchange(s._high, nullptr)), _age(std::exchange(s._age, 0)) {}
+        state& operator=(state&& s) noexcept {
+            _buckets = std::move(s._buckets);
+            _low = std::exchange(s._low, nullptr);
+            _high = std::exchange(s._high, nullptr);
+            _age = std::exchange(s._age, 0);
+            return *this;
+        }
+
+        void insert(Entry* e) {
+            // only the bottom bucket or two can be below the age, so the walk is short
+            int64_t priority = _age + 1;
+            bucket* b = nullptr;
+            for (bucket* h = _low; h && h->priority < priority; h = h->higher) {
+                b = h;
+            }
+            _attach(e, _above(b, priority));
+        }
+
+        void touch(Entry* e) {
+            bucket* target = _above(e->b, e->b->priority + 1);
+            remove(e);
+            _attach(e, target);
+        }
+
+        void remove(Entry* e) {
+            bucket* b = e->b;
+            (e->prev ? static_cast<Entry*>(e->prev)->next : b->head) = e->next;
+            (e->next ? static_cast<Entry*>(e->next)->prev : b->tail) = e->prev;
+            if (b->head == nullptr) {
+                (b->lower ? b->lower->higher : _low) = b->higher;
+                (b->higher ? b->higher->lower : _high) = b->lower;
+                _buckets.destroy(b);
+            }
+        }
+
+        // the age becomes the priority of the evicted entry
+        void evict(Entry* e) {
+            _age = e->b->priority;
+            remove(e);
+        }
+
+        // the oldest entry of the lowest priority other than keep
+        Entry* victim(const Entry* keep) const {
+            Entry* e = static_cast<Entry*>(_low->head);
+            if (e != keep) {
+                return e;
+            }
+            return static_cast<Entry*>(e->next ? e->next : _low->higher->head);
+        }
+
+        void clear() {
+            _buckets.clear(_high, [](bucket* b, auto visit) { visit(b->lower); });
+            _low = _high = nullptr;
+        }
+
+        // the buckets, the state itself is counted with the cache
+        MEMORY::footprint memory_usage() const { return _buckets.memory_usage(0); }
+
+        // calls f on the entries from the highest priority to the lowest
+        template <typename F> void for_each(F f) const {
+            for (bucket* b = _high; b != nullptr; b = b->lower) {
+                for (void* e = b->head; e != nullptr; e = static_cast<Entry*>(e)->next) {
+                    f(static_cast<Entry*>(e));
+                }
+            }
+        }
+
+      private:
+        node_pool<bucket> _buckets;
+        bucket* _low{nullptr};
+        bucket* _high{nullptr};
+        int64_t _age{0};
+
+        // the bucket of priority right above b(nullptr for the bottom), created if needed
+        bucket* _above(bucket* b, int64_t priority) {
+            bucket* h = b ? b->higher : _low;
+            if (h && h->priority == priority) {
+                return h;
+            }
+            bucket* nb = _buckets.create(priority);
+            nb->lower = b;
+            nb->higher = h;
+            (b ? b->higher : _low) = nb;
+            (h ? h->lower : _high) = nb;
+            return nb;
+        }
+
+        void _attach(Entry* e, bucket* b) {
+            e->b = b;
+            e->next = nullptr;
+            e->prev = b->tail;
+            (b->tail ? static_cast<Entry*>(b->tail)->next : b->head) = e;
+            b->tail = e;
+        }
+    };
+};
+
+/**
+ * @brief cache class
+ * Key value cache with O(1) get and put and a limit in entries, in bytes or both. Every
+ * entry is one node of a node_pool that holds the key, the value, the links of the
+ * eviction policy and the link of its chain in the hash index, so an insertion costs one
+ * node and nothing else: the index is an array of chain heads that doubles when it gets
+ * full. Use lru_cache or lfu_cache, and sharded_cache to share one between threads.
+ * @tparam K the type of the keys.
+ * @tparam V the type of the values.
+ * @tparam Policy lru_policy or lfu_policy.
+ * @tparam Hash the hash of the keys. Default = HASHING::hasher<K>
+ * @tparam Weigher the weight of an entry for the limit in bytes. Default = cache_weigher
+ */
+template <typename K, typename V, typename Policy, typename Hash = HASHING::hasher<K>,
+          typename Weigher = cache_weigher<K, V>>
+class basic_cache {
+  public:
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+
+    /**
+     * @brief Construct a new cache object
+     * @param limits: the largest number of entries and weight.
+     * @param hash: the hash of the keys.
+     * @param weigher: the weight of an entry.
+     */
+    explicit basic_cache(cache_limits limits = {}, Hash hash = Hash(),
+                         Weigher weigher = Weigher())
+        : _limits(limits), _hash(std::move(hash)), _weigher(std::move(weigher)) {}
+
+    /**
+     * @brief Construct a new cache object
+     * @param entries: the largest number of entries.
+     */
+    explicit basic_cache(size_t entries) : basic_cache(cache_limits{entries, SIZE_MAX}) {}
+
+    basic_cache(const basic_cache&) = delete;
+    basic_cache& operator=(const basic_cache&) = delete;
+
+    /**
+     * @brief Move constructor for cache class
+     * @param c the cache we want to move, it is left empty
+     */
+    basic_cache(basic_cache&& c) noexcept
+        : _limits(c._limits), _hash(std::move(c._hash)), _weigher(std::move(c._weigher)),
+          _pool(std::move(c._pool)), _policy(std::move(c._policy)),
+          _buckets(std::move(c._buckets)), _stats(std::exchange(c._stats, {})) {
+        c._buckets.clear();
+    }
+
+    /**
+     * @brief Move assignment for cache class
+     * @param c the cache we want to move, it is left empty
+     * @return basic_cache&
+     */
+    basic_cache& operator=(basic_cache&& c) noexcept {
+        if (this != &c) {
+            clear();
+            _limits = c._limits;
+            _hash = std::move(c._hash);
+            _weigher = std::move(c._weigher);
+            _pool = std::move(c._pool);
+            _policy = std::move(c._policy);
+            _buckets = std::move(c._buckets);
+            c._buckets.clear();
+            _stats = std::exchange(c._stats, {});
+        }
+        return *this;
+    }
+
+    ~basic_cache() { clear(); }
+
+    /**
+     * @brief get function
+     * Counts a hit or a miss, and a hit makes the entry more recent or more frequent.
+     * @param key: the key.
+     * @return std::optional<V> a copy of the value, std::nullopt on a miss.
+     */
+    std::optional<V> get(const K& key) {
+        V* v = find(key);
+        if (v == nullptr) {
+            return std::nullopt;
+        }
+        return *v;
+    }
+
+    /**
+     * @brief find function
+     * Same as get, without the copy.
+     * @param key: the key.
+     * @return V* the value, valid until the entry is evicted or erased, nullptr on a miss.
+     */
+    V* find(const K& key) {
+        entry* e = _find(key, _hash_of(key));
+        if (e == nullptr) {
+            _stats.misses++;
+            return nullptr;
+        }
+        _stats.hits++;
+        _policy.touch(e);
+        return &e->value;
+    }
+
+    /**
+     * @brief contains function
+     * @param key: the key.
+     * @return true if the key is cached, it counts as neither a hit nor a use.
+     */
+    bool contains(const K& key) const { return _find(key, _hash_of(key)) != nullptr; }
+
+    /**
+     * @brief put function
+     * Inserts or replaces the value of a key, as a use of the key, and evicts until the
+     * limits hold.
+     * @param key: the key.
+     * @param value: the value.
+     * @return true if the entry was stored, false if it alone weighs more than the limit.
+     */
+    bool put(K key, V value) {
+        size_t h = _hash_of(key);
+        size_t bytes = _weigher(key, value);
+        entry* e = _find(key, h);
+        if (bytes > _limits.bytes || _limits.entries == 0) {
+            if (e) {
+                _remove(e);
+            }
+            return false;
+        }
+        if (e) {
+            _stats.bytes += bytes - e->bytes;
+            e->value = std::move(value);
+            e->bytes = bytes;
+            _policy.touch(e);
+            // the entry fits alone, so it is never evicted to make room for itself
+            while (_stats.bytes > _limits.bytes) {
+                _evict(_policy.victim(e));
+            }
+            return true;
+        }
+        // room is made first so that a new entry of lfu_cache starts above the evicted ones
+        while (_stats.size >= _limits.entries || _stats.bytes > _limits.bytes - bytes) {
+            _evict(_policy.victim(nullptr));
+        }
+        e = _pool.create(std::move(key), std::move(value), h, bytes);
+        _link(e);
+        _policy.insert(e);
+        _stats.size++;
+        _stats.bytes += bytes;
+        return true;
+    }
+
+    /**
+     * @brief erase function
+     * @param key: the key.
+     * @return true if the key was cached.
+     */
+    bool erase(const K& key) {
+        entry* e = _find(key, _hash_of(key));
+        if (e == nullptr) {
+            return false;
+        }
+        _remove(e);
+        return true;
+    }
+
+    /**
+     * @brief clear function
+     * Removes every entry, the counters of hits, misses and evictions are kept.
+     */
+    void clear() {
+        for (entry* head : _buckets) {
+            while (head != nullptr) {
+                entry* next = head->chain;
+                _pool.destroy(head);
+                head = next;
+            }
+        }
+        _pool.clear(nullptr, [](entry*, auto) {});
+        _policy.clear();
+        std::fill(_buckets.begin(), _buckets.end(), nullptr);
+        _stats.size = _stats.bytes = 0;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of entries.
+     */
+    size_t size() const { return _stats.size; }
+
+    /**
+     * @brief empty function
+     * @return true if the cache has no entries.
+     */
+    bool empty() const { return _stats.size == 0; }
+
+    /**
+     * @brief bytes function
+     * @return size_t the sum of the weights of the entries.
+     */
+    size_t bytes() const { return _stats.bytes; }
+
+    /**
+     * @brief limits function
+     * @return cache_limits the limits of the cache.
+     */
+    cache_limits limits() const { return _limits; }
+
+    /**
+     * @brief stats function
+     * @return cache_stats the counters of the cache.
+     */
+    cache_stats stats() const { return _stats; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the keys and values with the heap memory they own, the links,
+     * hashes and weights of the entries with the buckets of the policy, the cache with its
+     * index and the slab table of its pool, and the free slots of the pool.
+     */
+    MEMORY::footprint memory_usage() const {
+        size_t owned = 0;
+        if constexpr (MEMORY::may_own_heap_v<K> || MEMORY::may_own_heap_v<V>) {
+            _policy.for_each([&](const entry* e) {
+                owned += MEMORY::heap_bytes(e->key) + MEMORY::heap_bytes(e->value);
+            });
+        }
+        MEMORY::footprint f = _pool.memory_usage(sizeof(K) + sizeof(V), owned);
+        if constexpr (requires { _policy.memory_usage(); }) {
+            MEMORY::footprint policy = _policy.memory_usage();
+            f.node_overhead += policy.total() - policy.slack;
+            f.slack += policy.slack;
+        }
+        MEMORY::footprint index = MEMORY::memory_usage(_buckets);
+        f.control += sizeof(*this) + index.total() - index.slack - sizeof(_buckets);
+        f.slack += index.slack;
+        return f;
+    }
+
+    /**
+     * @brief keys function
+     * @return vector<K> the keys from the last to be evicted to the first.
+     */
+    std::vector<K> keys() const {
+        std::vector<K> v;
+        v.reserve(size());
+        _policy.for_each([&](const entry* e) { v.push_back(e->key); });
+        return v;
+    }
+
+  private:
+    struct entry : Policy::hook {
+        K key;
+        V value;
+        size_t hash;
+        size_t bytes;
+        entry* chain{nullptr};
+        entry(K key, V value, size_t hash, size_t bytes)
+            : key(std::move(key)), value(std::move(value)), hash(hash), bytes(bytes) {}
+    };
+
+    cache_limits _limits;
+    Hash _hash;
+    Weigher _weigher;
+    node_pool<entry> _pool;
+    typename Policy::template state<entry> _policy;
+    // the heads of the chains of the index, a power of two of them
+    std::vector<entry*> _buckets;
+    cache_stats _stats;
+
+    size_t _hash_of(const K& key) const { return size_t(HASHING::hash_of(_hash, key)); }
+
+    size_t _slot(size_t h) const {
+        int bits = std::countr_zero(_buckets.size());
+        return size_t(uint64_t(h) * 0x9E3779B97F4A7C15ull >> (64 - bits));
+    }
+
+    entry* _find(const K& key, size_t h) const {
+        if (_buckets.empty()) {
+            return nullptr;
+        }
+        for (entry* e = _buckets[_slot(h)]; e != nullptr; e = e->chain) {
+            if (e->hash == h && e->key == key) {
+                return e;
+            }
+        }
+        return nullptr;
+    }
+
+    void _link(entry* e) {
+        if (_stats.size >= _buckets.size()) {
+            _grow();
+        }
+        entry*& head = _buckets[_slot(e->hash)];
+        e->chain = head;
+        head = e;
+    }
+
+    void _grow() {
+        std::vector<entry*> old(std::max<size_t>(16, 2 * _buckets.size()), nullptr);
+        old.swap(_buckets);
+        for (entry* head : old) {
+            while (head != nullptr) {
+                entry* next = head->chain;
+                entry*& slot = _buckets[_slot(head->hash)];
+                head->chain = slot;
+                slot = head;
+                head = next;
+            }
+        }
+    }
+
+    // takes e out of the index and the counters
+    void _unlink(entry* e) {
+        entry** link = &_buckets[_slot(e->hash)];
+        while (*link != e) {
+            link = &(*link)->chain;
+        }
+        *link = e->chain;
+        _stats.size--;
+        _stats.bytes -= e->bytes;
+    }
+
+    void _evict(entry* e) {
+        _unlink(e);
+        _policy.evict(e);
+        _pool.destroy(e);
+        _stats.evictions++;
+    }
+
+    void _remove(entry* e) {
+        _unlink(e);
+        _policy.remove(e);
+        _pool.destroy(e);
+    }
+};
+
+/**
+ * @brief least recently used cache
+ */
+template <typename K, typename V, typename Hash = HASHING::hasher<K>,
+          typename Weigher = cache_weigher<K, V>>
+using lru_cache = basic_cache<K, V, lru_policy, Hash, Weigher>;
+
+/**
+ * @brief least frequently used cache, with dynamic aging
+ */
+template <typename K, typename V, typename Hash = HASHING::hasher<K>,
+          typename Weigher = cache_weigher<K, V>>
+using lfu_cache = basic_cache<K, V, lfu_policy, Hash, Weigher>;
+
+#endif
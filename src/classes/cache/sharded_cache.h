@@ -0,0 +1,179 @@
+#ifndef SHARDED_CACHE_H
+#define SHARDED_CACHE_H
+
+#include "cache.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#endif
+
+/**
+ * @brief sharded cache class
+ * A cache that many threads share: the keys are spread over shards by their hash, and
+ * every shard is a cache with its own limits(an equal part of the total), its own mutex
+ * and its own counters, so threads that use different shards never wait for each other.
+ * The shards are on their own cache lines.
+ * @tparam Cache the cache of every shard, lru_cache or lfu_cache.
+ */
+template <typename Cache> class sharded_cache {
+  public:
+    using key_type = typename Cache::key_type;
+    using mapped_type = typename Cache::mapped_type;
+
+    /**
+     * @brief Construct a new sharded cache object
+     * @param limits: the limits of the whole cache, every shard gets an equal part.
+     * @param shards: the number of shards. Default = 16
+     * Throws std::invalid_argument if shards is 0.
+     */
+    explicit sharded_cache(cache_limits limits = {}, size_t shards = 16) : _count(shards) {
+        if (shards == 0) {
+            throw std::invalid_argument("sharded_cache: needs at least one shard");
+        }
+        cache_limits part{_part(limits.entries), _part(limits.bytes)};
+        _shards = std::make_unique<_shard[]>(shards);
+        for (size_t i = 0; i < shards; i++) {
+            _shards[i].cache = Cache(part);
+        }
+    }
+
+    /**
+     * @brief get function
+     * @param key: the key.
+     * @return std::optional<V> a copy of the value, std::nullopt on a miss.
+     */
+    std::optional<mapped_type> get(const key_type& key) {
+        _shard& s = _of(key);
+        std::lock_guard lock(s.mutex);
+        return s.cache.get(key);
+    }
+
+    /**
+     * @brief put function
+     * @param key: the key.
+     * @param value: the value.
+     * @return true if the entry was stored, false if it alone weighs more than a shard holds.
+     */
+    bool put(key_type key, mapped_type value) {
+        _shard& s = _of(key);
+        std::lock_guard lock(s.mutex);
+        return s.cache.put(std::move(key), std::move(value));
+    }
+
+    /**
+     * @brief erase function
+     * @param key: the key.
+     * @return true if the key was cached.
+     */
+    bool erase(const key_type& key) {
+        _shard& s = _of(key);
+        std::lock_guard lock(s.mutex);
+        return s.cache.erase(key);
+    }
+
+    /**
+     * @brief contains function
+     * @param key: the key.
+     * @return true if the key is cached, it counts as neither a hit nor a use.
+     */
+    bool contains(const key_type& key) {
+        _shard& s = _of(key);
+        std::lock_guard lock(s.mutex);
+        return s.cache.contains(key);
+    }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        for (size_t i = 0; i < _count; i++) {
+            std::lock_guard lock(_shards[i].mutex);
+            _shards[i].cache.clear();
+        }
+    }
+
+    /**
+     * @brief shards function
+     * @return size_t the number of shards.
+     */
+    size_t shards() const { return _count; }
+
+    /**
+     * @brief stats function
+     * @param shard: the index of a shard.
+     * @return cache_stats the counters of the shard.
+     */
+    cache_stats stats(size_t shard) {
+        std::lock_guard lock(_shards[shard].mutex);
+        return _shards[shard].cache.stats();
+    }
+
+    /**
+     * @brief stats function
+     * @return cache_stats the counters of every shard added up, every shard is read under
+     * its own lock so the sum is not one snapshot while threads use the cache.
+     */
+    cache_stats stats() {
+        cache_stats total;
+        for (size_t i = 0; i < _count; i++) {
+            cache_stats s = stats(i);
+            total.hits += s.hits;
+            total.misses += s.misses;
+            total.evictions += s.evictions;
+            total.size += s.size;
+            total.bytes += s.bytes;
+        }
+        return total;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of entries.
+     */
+    size_t size() { return stats().size; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the footprints of the shards, each taken under its own lock,
+     * with the table and the locks of the shards.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        for (size_t i = 0; i < _count; i++) {
+            std::lock_guard lock(_shards[i].mutex);
+            f += _shards[i].cache.memory_usage();
+            f.control += sizeof(_shard) - sizeof(Cache);
+        }
+        f.control += sizeof(*this) + MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+  private:
+    struct alignas(64) _shard {
+        mutable std::mutex mutex;
+        Cache cache;
+    };
+
+    size_t _count;
+    std::unique_ptr<_shard[]> _shards;
+    typename Cache::hasher _hash;
+
+    size_t _part(size_t limit) const {
+        return limit == SIZE_MAX ? SIZE_MAX : std::max<size_t>(1, limit / _count);
+    }
+
+    _shard& _of(const key_type& key) {
+        // the high bits pick the shard, the cache of the shard uses them in its index too
+        // so they are mixed again first
+        uint64_t h = HASHING::hash_of(_hash, key) * 0xD6E8FEB86659FD93ull;
+        return _shards[size_t((h >> 32) % _count)];
+    }
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef CONCURRENT_DISJOINT_SET_H
+#define CONCURRENT_DISJOINT_SET_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#endif
+
+/**
+ * @brief concurrent disjoint set class
+ * Lock-free union-find over the elements [0, n): every method can be called from any
+ * thread. The parents are atomic words, join links the root with the larger index
+ * under the other with a compare-and-swap and retries if another thread linked one of
+ * the roots first, find points every element it walks to its grandparent with
+ * compare-and-swaps that may fail harmlessly(path splitting). Since roots only ever
+ * point to smaller indexes, the root of a set is always its smallest element.
+ */
+class concurrent_dsu {
+  public:
+    /**
+     * @brief Construct a new concurrent_dsu object, every element is its own set
+     * @param n number of elements
+     */
+    inline explicit concurrent_dsu(uint32_t n)
+        : _parent(std::make_unique<std::atomic<uint32_t>[]>(n)), _n(n), _sets(n) {
+        for (uint32_t i = 0; i < n; i++) {
+            _parent[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief find function
+     *
+     * @param i the element we want to search
+     * @return uint32_t the root of the set it exists in, its smallest element as long as
+     * no join is running on the same set
+     */
+    inline uint32_t find(uint32_t i) {
+        for (;;) {
+            uint32_t p = _parent[i].load(std::memory_order_acquire);
+            if (p == i) {
+                return i;
+            }
+            uint32_t gp = _parent[p].load(std::memory_order_acquire);
+            if (p != gp) {
+                uint32_t expected = p;
+                _parent[i].compare_exchange_weak(expected, gp, std::memory_order_release,
+                                                 std::memory_order_relaxed);
+            }
+            i = p;
+        }
+    }
+
+    /**
+     * @brief join function
+     *
+     * @param i first element
+     * @param j second element
+     * union of i and j
+     * @return true if i and j were in different sets
+     */
+    inline bool join(uint32_t i, uint32_t j) {
+        for (;;) {
+            i = find(i);
+            j = find(j);
+            if (i == j) {
+                return false;
+            }
+            if (i < j) {
+                std::swap(i, j);
+            }
+            uint32_t expected = i;
+            if (_parent[i].compare_exchange_strong(expected, j, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed)) {
+                _sets.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief same function
+     *
+     * @param i first element
+     * @param j second element
+     * @return true if i and j exist in the same set, exact for the joins that completed
+     * before the call
+     */
+    inline bool same(uint32_t i, uint32_t j) {
+        for (;;) {
+            i = find(i);
+            j = find(j);
+            if (i == j) {
+                return true;
+            }
+            // i may have been linked under j's set after find returned it
+            if (_parent[i].load(std::memory_order_acquire) == i) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return uint32_t the number of elements
+     */
+    inline uint32_t size() const { return _n; }
+
+    /**
+     * @brief sets function
+     * @return uint32_t the number of disjoint sets, stale while joins are running
+     */
+    inline uint32_t sets() const { return _sets.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the parent words and the set with the header of their array
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.payload = size_t(_n) * sizeof(std::atomic<uint32_t>);
+        f.control = sizeof(*this) + (_n > 0 ? MEMORY::ALLOCATION_OVERHEAD : 0);
+        return f;
+    }
+
+  private:
+    std::unique_ptr<std::atomic<uint32_t>[]> _parent;
+    uint32_t _n;
+    std::atomic<uint32_t> _sets;
+};
+
+#endif
@@ -1,8 +1,13 @@
 #ifndef DISJOINT_SET_H
 #define DISJOINT_SET_H
 
+#include "../../helpers/memory_usage.h"
+
 #ifdef __cplusplus
+#include <algorithm>
 #include <cstdint>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
@@ -17,6 +22,8 @@ class dsu {
     std::vector<int64_t> ssize;
     std::vector<int64_t> max_el;
     std::vector<int64_t> min_el;
+    // circular list of the members of every set, spliced on join
+    std::vector<int64_t> next;
 
   public:
     /**
@@ -41,6 +48,10 @@ class dsu {
         for (int64_t i = 0; i < n; i++) {
             ssize[i] = 1;
         }
+        next.resize(n);
+        for (int64_t i = 0; i < n; i++) {
+            next[i] = i;
+        }
     }
 
     /**
@@ -82,6 +93,8 @@ class dsu {
         ssize[y] += ssize[x];
         max_el[y] = std::max(max_el[x], max_el[y]);
         min_el[y] = std::min(min_el[x], min_el[y]);
+        // swapping the successors of two members of different cycles joins the cycles
+        std::swap(next[x], next[y]);
     }
 
     /**
@@ -99,6 +112,13 @@ class dsu {
         return false;
     }
 
+    /**
+     * @brief get function
+     *
+     * @param i the object that we want to search for
+     * @return std::vector<int64_t> the minimum, the maximum and the size of the set that
+     * i exists in
+     */
     inline std::vector<int64_t> get(int64_t i) {
         std::vector<int64_t> ans;
         ans.push_back(get_min(i));
@@ -130,6 +150,327 @@ class dsu {
      * @return int64_t the minimum element
      */
     inline int64_t get_min(int64_t i) { return min_el[find(i)]; }
+
+    /**
+     * @brief for_each_member function
+     * Visits the members of the set that i exists in, in O(size) and without allocating.
+     *
+     * @param i the object that we want to search for
+     * @param fn callable invoked as fn(int64_t) once per member, starting with i
+     */
+    template <typename F> inline void for_each_member(int64_t i, F&& fn) const {
+        int64_t j = i;
+        do {
+            fn(j);
+            j = next[j];
+        } while (j != i);
+    }
+
+    /**
+     * @brief members function
+     *
+     * @param i the object that we want to search for
+     * @return std::vector<int64_t> the members of the set that i exists in
+     */
+    /**
+     * @brief memory_usage function
+     *
+     * @return MEMORY::footprint the parents, the depths, sizes, bounds and member lists of
+     * the elements, the set with the headers of its arrays, and the spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(p);
+        for (const auto* v : {&depth, &ssize, &max_el, &min_el, &next}) {
+            f += MEMORY::as_overhead(MEMORY::heap_usage(*v));
+        }
+        f.control += sizeof(*this);
+        return f;
+    }
+
+    inline std::vector<int64_t> members(int64_t i) {
+        std::vector<int64_t> ans;
+        ans.reserve(ssize[find(i)]);
+        for_each_member(i, [&](int64_t j) { ans.push_back(j); });
+        return ans;
+    }
+};
+
+namespace _dsu_utils {
+/**
+ * @brief the compact layouts store minus the size of a set in an int32_t
+ */
+inline uint32_t checked(uint32_t n) {
+    if (n > uint32_t(INT32_MAX)) {
+        throw std::length_error("dsu: more than 2^31 - 1 elements");
+    }
+    return n;
+}
+} // namespace _dsu_utils
+
+/**
+ * @brief compact disjoint set class
+ * Union by size with path compression in one 32-bit word per element: a non negative
+ * word is the parent, a root stores minus the size of its set. That is 4 bytes per
+ * element instead of the 40 of dsu, for up to 2^31 - 1 elements.
+ * @tparam TrackBounds also keep the minimum and maximum element of every set(8 more
+ * bytes per element). Default = false
+ */
+template <bool TrackBounds = false> class compact_dsu {
+  public:
+    /**
+     * @brief Construct a new compact_dsu object, every element is its own set
+     *
+     * @param n number of elements
+     */
+    inline explicit compact_dsu(uint32_t n) : _p(_dsu_utils::checked(n), -1), _sets(n) {
+        if constexpr (TrackBounds) {
+            _min.resize(n);
+            _max.resize(n);
+            for (uint32_t i = 0; i < n; i++) {
+                _min[i] = _max[i] = i;
+            }
+        }
+    }
+
+    /**
+     * @brief find function
+     *
+     * @param i the element we want to search
+     * @return uint32_t the root of the set it exists in
+     */
+    inline uint32_t find(uint32_t i) {
+        uint32_t root = i;
+        while (_p[root] >= 0) {
+            root = static_cast<uint32_t>(_p[root]);
+        }
+        while (_p[i] >= 0 && static_cast<uint32_t>(_p[i]) != root) {
+            uint32_t next = static_cast<uint32_t>(_p[i]);
+            _p[i] = static_cast<int32_t>(root);
+            i = next;
+        }
+        return root;
+    }
+
+    /**
+     * @brief join function
+     *
+     * @param i first element
+     * @param j second element
+     * union of i and j
+     * @return true if i and j were in different sets
+     */
+    inline bool join(uint32_t i, uint32_t j) {
+        uint32_t x = find(i), y = find(j);
+        if (x == y) {
+            return false;
+        }
+        // the larger set(more negative word) becomes the root
+        if (_p[x] < _p[y]) {
+            std::swap(x, y);
+        }
+        _p[y] += _p[x];
+        _p[x] = static_cast<int32_t>(y);
+        if constexpr (TrackBounds) {
+            _min[y] = std::min(_min[x], _min[y]);
+            _max[y] = std::max(_max[x], _max[y]);
+        }
+        _sets--;
+        return true;
+    }
+
+    /**
+     * @brief same function
+     *
+     * @param i first element
+     * @param j second element
+     * @return true if i and j exist in the same set
+     */
+    inline bool same(uint32_t i, uint32_t j) { return find(i) == find(j); }
+
+    /**
+     * @brief size function
+     *
+     * @param i element we are looking for
+     * @return uint32_t the size of the set that i exists in
+     */
+    inline uint32_t size(uint32_t i) { return static_cast<uint32_t>(-_p[find(i)]); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the parent or size words, the bounds of the sets, the set
+     * with the headers of its arrays, and the spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_p);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_min));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_max));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+    /**
+     * @brief sets function
+     * @return uint32_t the number of disjoint sets
+     */
+    inline uint32_t sets() const { return _sets; }
+
+    /**
+     * @brief get the maximum element of the set that i exists in
+     *
+     * @param i the object that we want to search for
+     * @return uint32_t the maximum element
+     */
+    inline uint32_t get_max(uint32_t i)
+        requires TrackBounds
+    {
+        return _max[find(i)];
+    }
+
+    /**
+     * @brief get the minimum element of the set that i exists in
+     *
+     * @param i the object that we want to search for
+     * @return uint32_t the minimum element
+     */
+    inline uint32_t get_min(uint32_t i)
+        requires TrackBounds
+    {
+        return _min[find(i)];
+    }
+
+  private:
+    std::vector<int32_t> _p;
+    std::vector<uint32_t> _min, _max;
+    uint32_t _sets;
+};
+
+/**
+ * @brief disjoint set with rollback
+ * Union by size without path compression, so every join can be undone in O(1) and
+ * find stays O(log n). Joins are recorded on a stack: take a snapshot() before a batch
+ * of joins and rollback() to it afterwards, as offline dynamic connectivity(divide and
+ * conquer over time) does.
+ */
+class rollback_dsu {
+  public:
+    /**
+     * @brief Construct a new rollback_dsu object, every element is its own set
+     *
+     * @param n number of elements
+     */
+    inline explicit rollback_dsu(uint32_t n) : _p(_dsu_utils::checked(n), -1), _sets(n) {}
+
+    /**
+     * @brief find function
+     *
+     * @param i the element we want to search
+     * @return uint32_t the root of the set it exists in
+     */
+    inline uint32_t find(uint32_t i) const {
+        while (_p[i] >= 0) {
+            i = static_cast<uint32_t>(_p[i]);
+        }
+        return i;
+    }
+
+    /**
+     * @brief join function
+     *
+     * @param i first element
+     * @param j second element
+     * union of i and j, recorded for rollback() if the sets were different
+     * @return true if i and j were in different sets
+     */
+    inline bool join(uint32_t i, uint32_t j) {
+        uint32_t x = find(i), y = find(j);
+        if (x == y) {
+            return false;
+        }
+        if (_p[x] < _p[y]) {
+            std::swap(x, y);
+        }
+        _history.push_back({x, _p[x]});
+        _p[y] += _p[x];
+        _p[x] = static_cast<int32_t>(y);
+        _sets--;
+        return true;
+    }
+
+    /**
+     * @brief same function
+     *
+     * @param i first element
+     * @param j second element
+     * @return true if i and j exist in the same set
+     */
+    inline bool same(uint32_t i, uint32_t j) const { return find(i) == find(j); }
+
+    /**
+     * @brief size function
+     *
+     * @param i element we are looking for
+     * @return uint32_t the size of the set that i exists in
+     */
+    inline uint32_t size(uint32_t i) const { return static_cast<uint32_t>(-_p[find(i)]); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the parent or size words, the history of the joins, the set
+     * with the headers of its arrays, and the spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_p);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_history));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+    /**
+     * @brief sets function
+     * @return uint32_t the number of disjoint sets
+     */
+    inline uint32_t sets() const { return _sets; }
+
+    /**
+     * @brief snapshot function
+     * @return size_t the number of recorded joins, pass it to rollback() to come back to
+     * the current state
+     */
+    inline size_t snapshot() const { return _history.size(); }
+
+    /**
+     * @brief undo function
+     * Reverts the last recorded join.
+     * @return false if there was none
+     */
+    inline bool undo() {
+        if (_history.empty()) {
+            return false;
+        }
+        auto [x, word] = _history.back();
+        _history.pop_back();
+        _p[_p[x]] -= word;
+        _p[x] = word;
+        _sets++;
+        return true;
+    }
+
+    /**
+     * @brief rollback function
+     * Reverts every join recorded after snapshot.
+     * @param snapshot a value returned by snapshot().
+     */
+    inline void rollback(size_t snapshot) {
+        while (_history.size() > snapshot) {
+            undo();
+        }
+    }
+
+  private:
+    std::vector<int32_t> _p;
+    // the linked root and its word(minus its size) before the join
+    std::vector<std::pair<uint32_t, int32_t>> _history;
+    uint32_t _sets;
 };
 
 #endif
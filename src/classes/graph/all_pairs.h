@@ -0,0 +1,224 @@
+#ifndef ALL_PAIRS_H
+#define ALL_PAIRS_H
+
+#include "../../helpers/parallel.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief all pairs shortest path distances, indexed by dense vertex id
+ * @param n: number of vertices.
+ * @param dist: row-major n x n matrix, dist[u * n + v] is the distance from u to v and
+ * infinity if v is unreachable.
+ * @param negative_cycle: true if the graph has a negative cycle, the distances are then
+ * meaningless.
+ */
+struct distance_matrix {
+    size_t n{0};
+    std::vector<double> dist;
+    bool negative_cycle{false};
+
+    /**
+     * @brief at function
+     * @returns double the distance from u to v.
+     */
+    double at(uint32_t u, uint32_t v) const { return dist[static_cast<size_t>(u) * n + v]; }
+};
+
+namespace _all_pairs_utils {
+constexpr size_t block = 64;
+
+/**
+ * @brief c[i][j] = min(c[i][j], a[i][k] + b[k][j]) for one block x block tile, k is the
+ * outer loop so the same kernel is valid when c aliases a or b(Floyd-Warshall order).
+ */
+inline void min_plus(double* c, const double* a, const double* b, size_t stride) {
+    const double inf = std::numeric_limits<double>::infinity();
+    for (size_t k = 0; k < block; k++) {
+        const double* bk = b + k * stride;
+        for (size_t i = 0; i < block; i++) {
+            const double aik = a[i * stride + k];
+            if (aik == inf) {
+                continue;
+            }
+            double* ci = c + i * stride;
+#if defined(__AVX2__)
+            const __m256d va = _mm256_set1_pd(aik);
+            for (size_t j = 0; j < block; j += 4) {
+                __m256d sum = _mm256_add_pd(va, _mm256_loadu_pd(bk + j));
+                _mm256_storeu_pd(ci + j, _mm256_min_pd(_mm256_loadu_pd(ci + j), sum));
+            }
+#else
+            for (size_t j = 0; j < block; j++) {
+                double x = aik + bk[j];
+                ci[j] = x < ci[j] ? x : ci[j];
+            }
+#endif
+        }
+    }
+}
+} // namespace _all_pairs_utils
+
+/**
+ * @brief floyd_warshall function
+ * Cache-blocked Floyd-Warshall on a flat matrix padded to 64 x 64 tiles. For every
+ * block of k the diagonal tile is closed first, then the tiles of its row and column,
+ * then every other tile, the last two steps spread over threads. The tile kernel uses
+ * AVX2 when the compiler targets it. O(V^3) time and O(V^2) memory, meant for dense
+ * graphs(see johnson() for sparse ones). Negative weights are allowed.
+ * @param g: the snapshot(see weighted_graph<T>::csr_view()).
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @returns distance_matrix the distances between every pair of vertices.
+ */
+template <typename T> distance_matrix floyd_warshall(const csr_graph<T>& g, size_t threads = 0) {
+    using _all_pairs_utils::block;
+    const double inf = std::numeric_limits<double>::infinity();
+    const size_t n = g.size();
+    const size_t blocks = (n + block - 1) / block, stride = blocks * block;
+    std::vector<double> d(stride * stride, inf);
+    for (size_t u = 0; u < stride; u++) {
+        d[u * stride + u] = 0;
+    }
+    for (size_t u = 0; u < n; u++) {
+        for (size_t e = g.offsets()[u]; e < g.offsets()[u + 1]; e++) {
+            double& x = d[u * stride + g.targets()[e]];
+            x = std::min(x, g.weight(e));
+        }
+    }
+
+    auto tile = [&](size_t i, size_t j) { return d.data() + (i * stride + j) * block; };
+    for (size_t kb = 0; kb < blocks; kb++) {
+        _all_pairs_utils::min_plus(tile(kb, kb), tile(kb, kb), tile(kb, kb), stride);
+        PARALLEL::parallel_for(0, 2 * blocks, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t x = lo; x < hi; x++) {
+                size_t j = x >> 1;
+                if (j == kb) {
+                    continue;
+                }
+                if (x & 1) {
+                    _all_pairs_utils::min_plus(tile(j, kb), tile(j, kb), tile(kb, kb), stride);
+                } else {
+                    _all_pairs_utils::min_plus(tile(kb, j), tile(kb, kb), tile(kb, j), stride);
+                }
+            }
+        });
+        PARALLEL::parallel_for(0, blocks * blocks, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t x = lo; x < hi; x++) {
+                size_t i = x / blocks, j = x % blocks;
+                if (i != kb && j != kb) {
+                    _all_pairs_utils::min_plus(tile(i, j), tile(i, kb), tile(kb, j), stride);
+                }
+            }
+        });
+    }
+
+    distance_matrix result;
+    result.n = n;
+    result.dist.resize(n * n);
+    for (size_t u = 0; u < n; u++) {
+        std::copy(d.begin() + u * stride, d.begin() + u * stride + n,
+                  result.dist.begin() + u * n);
+        result.negative_cycle |= d[u * stride + u] < 0;
+    }
+    return result;
+}
+
+/**
+ * @brief johnson function
+ * Johnson's algorithm for sparse graphs: bellman-ford(queue based) from a virtual
+ * source gives potentials that make every arc weight non negative, then one dijkstra
+ * runs from every vertex, the sources spread over threads. O(V E log V) time.
+ * @param g: the snapshot(see weighted_graph<T>::csr_view()).
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @returns distance_matrix the distances between every pair of vertices.
+ */
+template <typename T> distance_matrix johnson(const csr_graph<T>& g, size_t threads = 0) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const size_t n = g.size();
+    const std::vector<size_t>& offsets = g.offsets();
+    const std::vector<uint32_t>& targets = g.targets();
+    distance_matrix result;
+    result.n = n;
+
+    // potentials, every vertex starts at 0 as if linked from a virtual source
+    std::vector<double> h(n, 0);
+    std::vector<uint32_t> relaxed(n, 0);
+    std::vector<uint8_t> queued(n, 1);
+    std::queue<uint32_t> q;
+    for (uint32_t u = 0; u < n; u++) {
+        q.push(u);
+    }
+    while (!q.empty()) {
+        uint32_t u = q.front();
+        q.pop();
+        queued[u] = 0;
+        for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+            uint32_t v = targets[e];
+            if (h[u] + g.weight(e) < h[v]) {
+                h[v] = h[u] + g.weight(e);
+                if (++relaxed[v] > n) {
+                    result.negative_cycle = true;
+                    result.dist.assign(n * n, -inf);
+                    return result;
+                }
+                if (!queued[v]) {
+                    queued[v] = 1;
+                    q.push(v);
+                }
+            }
+        }
+    }
+    std::vector<double> w(targets.size());
+    for (size_t u = 0; u < n; u++) {
+        for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+            w[e] = std::max(0.0, g.weight(e) + h[u] - h[targets[e]]);
+        }
+    }
+
+    result.dist.assign(n * n, inf);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        std::vector<std::pair<double, uint32_t>> heap;
+        for (size_t s = lo; s < hi; s++) {
+            double* row = result.dist.data() + s * n;
+            row[s] = 0;
+            heap.assign(1, {0, static_cast<uint32_t>(s)});
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+                auto [d, u] = heap.back();
+                heap.pop_back();
+                if (d > row[u]) {
+                    continue;
+                }
+                for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                    uint32_t v = targets[e];
+                    if (d + w[e] < row[v]) {
+                        row[v] = d + w[e];
+                        heap.push_back({row[v], v});
+                        std::push_heap(heap.begin(), heap.end(), std::greater<>());
+                    }
+                }
+            }
+            for (size_t v = 0; v < n; v++) {
+                if (row[v] != inf) {
+                    row[v] += h[v] - h[s];
+                }
+            }
+        }
+    });
+    return result;
+}
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef BELLMAN_FORD_H
+#define BELLMAN_FORD_H
+
+#include "../../helpers/parallel.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#endif
+
+/**
+ * @brief bellman-ford engine
+ * spfa: queue based, only vertices whose distance changed are relaxed again and the
+ * run stops as soon as the queue is empty.
+ * parallel: synchronous rounds over the csr arrays, the vertices changed in the last
+ * round relax their arcs on worker threads with atomic-min updates.
+ */
+enum class bellman_ford_mode { spfa, parallel };
+
+/**
+ * @brief result of bellman_ford(), indexed by dense vertex id
+ * @param dist: distance from the source, infinity for unreachable vertices and
+ * -infinity for vertices reachable from a negative cycle.
+ * @param negative_cycle: true if a negative cycle is reachable from the source.
+ */
+struct bellman_ford_result {
+    std::vector<double> dist;
+    bool negative_cycle{false};
+};
+
+namespace _bellman_ford_utils {
+inline bool atomic_min(double& x, double value) {
+    std::atomic_ref<double> ref(x);
+    double current = ref.load(std::memory_order_relaxed);
+    while (value < current) {
+        if (ref.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief sets every vertex reachable from the marked ones to -infinity
+ */
+template <typename T>
+void poison(const csr_graph<T>& g, std::vector<uint32_t> st, std::vector<double>& dist) {
+    const double ninf = -std::numeric_limits<double>::infinity();
+    for (uint32_t u : st) {
+        dist[u] = ninf;
+    }
+    while (!st.empty()) {
+        uint32_t u = st.back();
+        st.pop_back();
+        for (uint32_t v : g.neighbors(u)) {
+            if (dist[v] != ninf) {
+                dist[v] = ninf;
+                st.push_back(v);
+            }
+        }
+    }
+}
+
+/**
+ * @brief spfa with path lengths: a vertex whose shortest walk reaches n arcs lies
+ * behind a negative cycle, it is poisoned and never relaxed again, so the remaining
+ * cycles are still found before the queue drains.
+ */
+template <typename T> bellman_ford_result spfa(const csr_graph<T>& g, uint32_t s) {
+    const size_t n = g.size();
+    const double ninf = -std::numeric_limits<double>::infinity();
+    bellman_ford_result r;
+    r.dist.assign(n, std::numeric_limits<double>::infinity());
+    std::vector<uint32_t> length(n, 0), q(1, s);
+    std::vector<uint8_t> queued(n, 0);
+    r.dist[s] = 0;
+    queued[s] = 1;
+    // q is a ring buffer, at most n vertices are queued at once
+    q.resize(n);
+    size_t head = 0, count = 1;
+    while (count > 0) {
+        uint32_t u = q[head];
+        head = head + 1 == n ? 0 : head + 1;
+        count--;
+        queued[u] = 0;
+        if (r.dist[u] == ninf) {
+            continue;
+        }
+        for (size_t e = g.offsets()[u]; e < g.offsets()[u + 1]; e++) {
+            uint32_t v = g.targets()[e];
+            double nd = r.dist[u] + g.weight(e);
+            if (nd >= r.dist[v]) {
+                continue;
+            }
+            r.dist[v] = nd;
+            length[v] = length[u] + 1;
+            if (length[v] >= n) {
+                r.negative_cycle = true;
+                poison(g, {v}, r.dist);
+            } else if (!queued[v]) {
+                queued[v] = 1;
+                q[(head + count) % n] = v;
+                count++;
+            }
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief rounds of parallel relaxation, after n - 1 rounds every vertex that still
+ * improves lies behind a negative cycle
+ */
+template <typename T>
+bellman_ford_result parallel(const csr_graph<T>& g, uint32_t s, size_t threads) {
+    const size_t n = g.size();
+    const std::vector<size_t>& offsets = g.offsets();
+    const std::vector<uint32_t>& targets = g.targets();
+    bellman_ford_result r;
+    r.dist.assign(n, std::numeric_limits<double>::infinity());
+    r.dist[s] = 0;
+    std::vector<uint8_t> active(n, 0), next(n, 0);
+    active[s] = 1;
+    std::vector<uint8_t> changed(PARALLEL::resolve_threads(threads, n), 0);
+
+    for (size_t round = 0;; round++) {
+        std::fill(changed.begin(), changed.end(), 0);
+        PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t tid) {
+            for (size_t u = lo; u < hi; u++) {
+                if (!active[u]) {
+                    continue;
+                }
+                active[u] = 0;
+                double du = std::atomic_ref<double>(r.dist[u]).load(std::memory_order_relaxed);
+                for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                    uint32_t v = targets[e];
+                    if (atomic_min(r.dist[v], du + g.weight(e))) {
+                        std::atomic_ref<uint8_t>(next[v]).store(1, std::memory_order_relaxed);
+                        changed[tid] = 1;
+                    }
+                }
+            }
+        });
+        bool any = false;
+        for (uint8_t c : changed) {
+            any |= c != 0;
+        }
+        if (!any) {
+            break;
+        }
+        if (round + 1 >= n) {
+            std::vector<uint32_t> marked;
+            for (uint32_t v = 0; v < n; v++) {
+                if (next[v]) {
+                    marked.push_back(v);
+                }
+            }
+            r.negative_cycle = true;
+            poison(g, marked, r.dist);
+            break;
+        }
+        active.swap(next);
+    }
+    return r;
+}
+} // namespace _bellman_ford_utils
+
+/**
+ * @brief bellman_ford function
+ * Single source shortest paths with negative weights. O(V E) in the worst case, spfa
+ * is usually much faster since it stops once nothing changes.
+ * @param g: the snapshot(see weighted_graph<T>::csr_view()).
+ * @param s: dense id of the source.
+ * @param mode: spfa or parallel rounds.
+ * @param threads: number of worker threads of the parallel mode(0 means every hardware
+ * thread).
+ * @returns bellman_ford_result the dense distances and whether a negative cycle was found.
+ */
+template <typename T>
+bellman_ford_result bellman_ford(const csr_graph<T>& g, uint32_t s,
+                                 bellman_ford_mode mode = bellman_ford_mode::spfa,
+                                 size_t threads = 0) {
+    if (s >= g.size()) {
+        return {};
+    }
+    if (mode == bellman_ford_mode::spfa) {
+        return _bellman_ford_utils::spfa(g, s);
+    }
+    return _bellman_ford_utils::parallel(g, s, threads);
+}
+
+#endif
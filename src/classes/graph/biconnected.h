@@ -0,0 +1,454 @@
+#ifndef BICONNECTED_H
+#define BICONNECTED_H
+
+#include "../../helpers/parallel.h"
+#include "../stack/stack_list.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief result of biconnected_components(), every vertex is a dense id
+ * @param arc_component: biconnected component of every arc of the snapshot(csr order),
+ * both arcs of an undirected edge share it and self loops hold csr_graph<T>::npos.
+ * Components are numbered in order of their first arc.
+ * @param count: number of biconnected components.
+ * @param bridges: edges whose removal disconnects their endpoints, as (u, v) with u < v,
+ * sorted.
+ * @param articulation_points: vertices whose removal increases the number of connected
+ * components, sorted.
+ */
+struct biconnected_result {
+    std::vector<uint32_t> arc_component;
+    size_t count{0};
+    std::vector<std::pair<uint32_t, uint32_t>> bridges;
+    std::vector<uint32_t> articulation_points;
+};
+
+namespace _biconnected_utils {
+constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief undirected multigraph under a snapshot, every edge has an id and both of its
+ * arcs carry it. edge_arc maps an edge back to one arc of the snapshot, self loops are
+ * left out.
+ */
+struct edge_graph {
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> targets, edge;
+    std::vector<size_t> edge_arc;
+};
+
+template <typename T> edge_graph build(const csr_graph<T>& g, size_t threads) {
+    const size_t n = g.size();
+    const std::vector<size_t>& offsets = g.offsets();
+    const std::vector<uint32_t>& targets = g.targets();
+    edge_graph h;
+    if (g.directed()) {
+        // every arc is an edge, stored once at each endpoint
+        h.offsets.assign(n + 1, 0);
+        for (uint32_t u = 0; u < n; u++) {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                if (targets[e] != u) {
+                    h.offsets[u + 1]++;
+                    h.offsets[targets[e] + 1]++;
+                }
+            }
+        }
+        for (size_t u = 0; u < n; u++) {
+            h.offsets[u + 1] += h.offsets[u];
+        }
+        h.targets.resize(h.offsets[n]);
+        h.edge.resize(h.offsets[n]);
+        std::vector<size_t> fill(h.offsets.begin(), h.offsets.end() - 1);
+        for (uint32_t u = 0; u < n; u++) {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                uint32_t v = targets[e];
+                if (v == u) {
+                    continue;
+                }
+                uint32_t id = static_cast<uint32_t>(h.edge_arc.size());
+                h.edge_arc.push_back(e);
+                h.targets[fill[u]] = v, h.edge[fill[u]++] = id;
+                h.targets[fill[v]] = u, h.edge[fill[v]++] = id;
+            }
+        }
+        return h;
+    }
+
+    // undirected snapshots already hold both arcs, the k-th arc u -> v pairs with the
+    // k-th arc v -> u
+    struct key {
+        uint32_t a, b;
+        size_t e;
+        bool operator<(const key& o) const {
+            return a != o.a ? a < o.a : (b != o.b ? b < o.b : e < o.e);
+        }
+    };
+    std::vector<key> up, down;
+    for (uint32_t u = 0; u < n; u++) {
+        for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+            uint32_t v = targets[e];
+            if (u < v) {
+                up.push_back({u, v, e});
+            } else if (v < u) {
+                down.push_back({v, u, e});
+            }
+        }
+    }
+    PARALLEL::parallel_sort(up.begin(), up.end(), std::less<key>(), threads);
+    PARALLEL::parallel_sort(down.begin(), down.end(), std::less<key>(), threads);
+    h.offsets = offsets;
+    h.targets = targets;
+    h.edge.assign(targets.size(), npos);
+    for (size_t i = 0; i < up.size() && i < down.size(); i++) {
+        uint32_t id = static_cast<uint32_t>(h.edge_arc.size());
+        h.edge_arc.push_back(up[i].e);
+        h.edge[up[i].e] = h.edge[down[i].e] = id;
+    }
+    return h;
+}
+
+/**
+ * @brief hopcroft-tarjan with an explicit stack of frames and a stack of edges, every
+ * root of the snapshot is visited. Returns the component of every edge.
+ */
+inline std::vector<uint32_t> serial(const edge_graph& h, size_t n) {
+    std::vector<uint32_t> comp(h.edge_arc.size(), npos);
+    std::vector<uint32_t> in(n, npos), low(n, 0);
+    stack_list<uint32_t> edges;
+    struct frame {
+        uint32_t u, parent_edge;
+        size_t e;
+    };
+    stack_list<frame> st;
+    uint32_t timer = 0, count = 0;
+    for (uint32_t r = 0; r < n; r++) {
+        if (in[r] != npos) {
+            continue;
+        }
+        in[r] = low[r] = timer++;
+        st.push({r, npos, h.offsets[r]});
+        while (!st.empty()) {
+            frame& f = st.top();
+            uint32_t u = f.u;
+            if (f.e < h.offsets[u + 1]) {
+                size_t e = f.e++;
+                uint32_t v = h.targets[e], id = h.edge[e];
+                if (id == npos || id == f.parent_edge) {
+                    continue;
+                }
+                if (in[v] == npos) {
+                    edges.push(id);
+                    in[v] = low[v] = timer++;
+                    st.push({v, id, h.offsets[v]});
+                } else if (in[v] < in[u]) {
+                    edges.push(id);
+                    low[u] = std::min(low[u], in[v]);
+                }
+                continue;
+            }
+            uint32_t pe = f.parent_edge;
+            st.pop();
+            if (st.empty()) {
+                continue;
+            }
+            uint32_t p = st.top().u;
+            low[p] = std::min(low[p], low[u]);
+            if (low[u] >= in[p]) {
+                uint32_t x;
+                do {
+                    x = edges.top();
+                    edges.pop();
+                    comp[x] = count;
+                } while (x != pe);
+                count++;
+            }
+        }
+    }
+    return comp;
+}
+
+inline uint32_t find(std::vector<uint32_t>& parent, uint32_t x) {
+    while (true) {
+        uint32_t p = std::atomic_ref<uint32_t>(parent[x]).load(std::memory_order_relaxed);
+        if (p == x) {
+            return x;
+        }
+        uint32_t gp = std::atomic_ref<uint32_t>(parent[p]).load(std::memory_order_relaxed);
+        // path halving, losing the race only skips the shortcut
+        std::atomic_ref<uint32_t>(parent[x]).compare_exchange_weak(p, gp,
+                                                                   std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+inline void unite(std::vector<uint32_t>& parent, uint32_t a, uint32_t b) {
+    while (true) {
+        a = find(parent, a), b = find(parent, b);
+        if (a == b) {
+            return;
+        }
+        if (a < b) {
+            std::swap(a, b);
+        }
+        uint32_t expected = a;
+        if (std::atomic_ref<uint32_t>(parent[a]).compare_exchange_strong(
+                expected, b, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief tarjan-vishkin: a bfs spanning forest, preorder numbers and subtree sizes by
+ * levels, then two rules link tree edges(named by their child vertex) that share a
+ * biconnected component in a concurrent union-find. Every non-tree edge joins the
+ * tree edge of its endpoint with the larger preorder number.
+ */
+inline std::vector<uint32_t> tarjan_vishkin(const edge_graph& h, size_t n, size_t threads) {
+    std::vector<uint32_t> parent(n, npos), parent_edge(n, npos);
+    std::vector<std::vector<uint32_t>> levels;
+    std::vector<uint32_t> roots;
+    for (uint32_t r = 0; r < n; r++) {
+        if (parent[r] != npos) {
+            continue;
+        }
+        parent[r] = r;
+        roots.push_back(r);
+        std::vector<uint32_t> frontier = {r};
+        for (size_t d = 0; !frontier.empty(); d++) {
+            if (levels.size() <= d) {
+                levels.emplace_back();
+            }
+            levels[d].insert(levels[d].end(), frontier.begin(), frontier.end());
+            const size_t t = PARALLEL::resolve_threads(threads, frontier.size());
+            std::vector<std::vector<uint32_t>> next(t);
+            PARALLEL::parallel_for(0, frontier.size(), t, [&](size_t lo, size_t hi, size_t tid) {
+                for (size_t i = lo; i < hi; i++) {
+                    uint32_t u = frontier[i];
+                    for (size_t e = h.offsets[u]; e < h.offsets[u + 1]; e++) {
+                        uint32_t v = h.targets[e];
+                        uint32_t expected = npos;
+                        if (h.edge[e] != npos &&
+                            std::atomic_ref<uint32_t>(parent[v]).compare_exchange_strong(
+                                expected, u, std::memory_order_relaxed)) {
+                            parent_edge[v] = h.edge[e];
+                            next[tid].push_back(v);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for (std::vector<uint32_t>& part : next) {
+                frontier.insert(frontier.end(), part.begin(), part.end());
+            }
+        }
+    }
+
+    // children csr, then subtree sizes bottom up and preorder numbers top down
+    std::vector<size_t> child_at(n + 1, 0);
+    for (uint32_t v = 0; v < n; v++) {
+        if (parent[v] != v) {
+            child_at[parent[v] + 1]++;
+        }
+    }
+    for (size_t u = 0; u < n; u++) {
+        child_at[u + 1] += child_at[u];
+    }
+    std::vector<uint32_t> children(child_at[n]);
+    std::vector<size_t> fill(child_at.begin(), child_at.end() - 1);
+    for (uint32_t v = 0; v < n; v++) {
+        if (parent[v] != v) {
+            children[fill[parent[v]]++] = v;
+        }
+    }
+    std::vector<uint32_t> size(n, 1), pre(n, 0), low(n), high(n);
+    for (size_t d = levels.size(); d-- > 0;) {
+        const std::vector<uint32_t>& level = levels[d];
+        PARALLEL::parallel_for(0, level.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                uint32_t u = level[i];
+                for (size_t c = child_at[u]; c < child_at[u + 1]; c++) {
+                    size[u] += size[children[c]];
+                }
+            }
+        });
+    }
+    uint32_t next_pre = 0;
+    for (uint32_t r : roots) {
+        pre[r] = next_pre;
+        next_pre += size[r];
+    }
+    for (const std::vector<uint32_t>& level : levels) {
+        PARALLEL::parallel_for(0, level.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                uint32_t u = level[i], at = pre[u] + 1;
+                for (size_t c = child_at[u]; c < child_at[u + 1]; c++) {
+                    pre[children[c]] = at;
+                    at += size[children[c]];
+                }
+            }
+        });
+    }
+
+    // lowest and highest preorder number reachable from a subtree by one non-tree edge
+    auto tree_edge = [&](uint32_t u, uint32_t v, uint32_t id) {
+        return parent_edge[v] == id || parent_edge[u] == id;
+    };
+    for (size_t d = levels.size(); d-- > 0;) {
+        const std::vector<uint32_t>& level = levels[d];
+        PARALLEL::parallel_for(0, level.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                uint32_t u = level[i], l = pre[u], r = pre[u];
+                for (size_t e = h.offsets[u]; e < h.offsets[u + 1]; e++) {
+                    uint32_t v = h.targets[e];
+                    if (h.edge[e] != npos && !tree_edge(u, v, h.edge[e])) {
+                        l = std::min(l, pre[v]);
+                        r = std::max(r, pre[v]);
+                    }
+                }
+                for (size_t c = child_at[u]; c < child_at[u + 1]; c++) {
+                    l = std::min(l, low[children[c]]);
+                    r = std::max(r, high[children[c]]);
+                }
+                low[u] = l, high[u] = r;
+            }
+        });
+    }
+
+    std::vector<uint32_t> link(n);
+    for (uint32_t v = 0; v < n; v++) {
+        link[v] = v;
+    }
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t x = lo; x < hi; x++) {
+            uint32_t u = static_cast<uint32_t>(x);
+            for (size_t e = h.offsets[u]; e < h.offsets[u + 1]; e++) {
+                uint32_t v = h.targets[e], id = h.edge[e];
+                if (id == npos) {
+                    continue;
+                }
+                if (parent_edge[v] == id) {
+                    // tree edge u -> v, joins the tree edge above u unless v's subtree
+                    // stays inside u's subtree and never climbs above u
+                    if (parent[u] != u &&
+                        (low[v] < pre[u] || high[v] >= pre[u] + size[u])) {
+                        unite(link, u, v);
+                    }
+                } else if (!tree_edge(u, v, id) && pre[u] < pre[v] &&
+                           pre[u] + size[u] <= pre[v]) {
+                    unite(link, u, v);
+                }
+            }
+        }
+    });
+
+    std::vector<uint32_t> comp(h.edge_arc.size(), npos);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t x = lo; x < hi; x++) {
+            uint32_t u = static_cast<uint32_t>(x);
+            for (size_t e = h.offsets[u]; e < h.offsets[u + 1]; e++) {
+                uint32_t v = h.targets[e], id = h.edge[e];
+                if (id == npos) {
+                    continue;
+                }
+                if (parent_edge[v] == id || (!tree_edge(u, v, id) && pre[u] < pre[v])) {
+                    comp[id] = find(link, v);
+                }
+            }
+        }
+    });
+    return comp;
+}
+} // namespace _biconnected_utils
+
+/**
+ * @brief biconnected_components function
+ * Splits the edges into biconnected components and derives the bridges(components with
+ * a single edge) and articulation points(vertices touching more than one component).
+ * Every connected component is covered and no recursion is used. Directions of
+ * directed snapshots are ignored, parallel edges are never bridges.
+ * @param g: the snapshot(see graph<T>::csr_view()).
+ * @param threads: 1 runs an iterative hopcroft-tarjan, anything else the
+ * tarjan-vishkin algorithm on that many threads(0 means every hardware thread).
+ * @returns biconnected_result the component of every arc, the bridges and the
+ * articulation points.
+ */
+template <typename T>
+biconnected_result biconnected_components(const csr_graph<T>& g, size_t threads = 1) {
+    using namespace _biconnected_utils;
+    const size_t n = g.size();
+    edge_graph h = build(g, threads);
+    std::vector<uint32_t> comp =
+        threads == 1 ? serial(h, n) : tarjan_vishkin(h, n, threads);
+
+    // dense ids in order of the first arc, and the edge count of every component
+    biconnected_result r;
+    std::vector<uint32_t> rename(std::max(n, h.edge_arc.size()), npos), sizes;
+    std::vector<uint32_t> first_edge;
+    std::vector<std::pair<size_t, uint32_t>> order(h.edge_arc.size());
+    for (size_t id = 0; id < h.edge_arc.size(); id++) {
+        order[id] = {h.edge_arc[id], static_cast<uint32_t>(id)};
+    }
+    std::sort(order.begin(), order.end());
+    for (auto [arc, id] : order) {
+        uint32_t& c = rename[comp[id]];
+        if (c == npos) {
+            c = static_cast<uint32_t>(sizes.size());
+            sizes.push_back(0);
+            first_edge.push_back(id);
+        }
+        sizes[c]++;
+    }
+    r.count = sizes.size();
+    for (uint32_t& c : comp) {
+        c = rename[c];
+    }
+
+    r.arc_component.assign(g.arcs(), npos);
+    for (uint32_t u = 0; u < n; u++) {
+        for (size_t e = h.offsets[u]; e < h.offsets[u + 1]; e++) {
+            if (h.edge[e] != npos) {
+                size_t arc = g.directed() ? h.edge_arc[h.edge[e]] : e;
+                r.arc_component[arc] = comp[h.edge[e]];
+            }
+        }
+    }
+    for (size_t c = 0; c < r.count; c++) {
+        if (sizes[c] == 1) {
+            size_t arc = h.edge_arc[first_edge[c]];
+            uint32_t u = static_cast<uint32_t>(
+                std::upper_bound(g.offsets().begin(), g.offsets().end(), arc) -
+                g.offsets().begin() - 1);
+            uint32_t v = g.targets()[arc];
+            r.bridges.push_back({std::min(u, v), std::max(u, v)});
+        }
+    }
+    std::sort(r.bridges.begin(), r.bridges.end());
+    for (uint32_t u = 0; u < n; u++) {
+        uint32_t seen = npos;
+        for (size_t e = h.offsets[u]; e < h.offsets[u + 1]; e++) {
+            if (h.edge[e] == npos) {
+                continue;
+            }
+            uint32_t c = comp[h.edge[e]];
+            if (seen != npos && c != seen) {
+                r.articulation_points.push_back(u);
+                break;
+            }
+            seen = c;
+        }
+    }
+    return r;
+}
+
+#endif
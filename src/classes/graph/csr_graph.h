@@ -0,0 +1,516 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "../heap/indexed_heap.h"
+#include "../stack/stack_list.h"
+#include "flow_network.h"
+#include "tarjan.h"
+#include "vertex_index.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief Immutable compressed-sparse-row snapshot of a graph.
+ * Vertices are interned to dense uint32_t ids, the neighbors of vertex u are stored
+ * contiguously in targets()[offsets()[u] .. offsets()[u + 1]) and, for weighted graphs,
+ * the weight of every arc sits at the same position in weights().
+ * Build it with graph<T>::freeze() / weighted_graph<T>::freeze(), the snapshot shares
+ * the dense ids of the graph it was taken from.
+ */
+template <typename T> class csr_graph {
+  public:
+    /**
+     * @brief id returned when a vertex is not part of the snapshot
+     */
+    static constexpr uint32_t npos = vertex_index<T>::npos;
+
+    /**
+     * @brief Construct an empty csr_graph object
+     */
+    csr_graph() : _offsets(1, 0), _ids(std::make_shared<const vertex_index<T>>()) {}
+
+    /**
+     * @brief Construct a new csr_graph object from an id-indexed adjacency list.
+     * @param ids: the interning table of the graph, snapshot ids are the same ids.
+     * @param adj: adj[u] holds either the neighbor ids of u or (neighbor id, weight) pairs.
+     * @param directed: true if the graph is directed.
+     */
+    template <typename E>
+    csr_graph(const vertex_index<T>& ids, const std::vector<std::vector<E>>& adj, bool directed)
+        : _ids(std::make_shared<const vertex_index<T>>(ids)), _directed(directed),
+          _weighted(!std::is_same_v<E, uint32_t>) {
+        _offsets.assign(adj.size() + 1, 0);
+        for (size_t u = 0; u < adj.size(); u++) {
+            _offsets[u + 1] = _offsets[u] + adj[u].size();
+        }
+        _targets.reserve(_offsets.back());
+        if (_weighted) {
+            _weights.reserve(_offsets.back());
+        }
+        for (const std::vector<E>& neighbors : adj) {
+            for (const E& e : neighbors) {
+                if constexpr (std::is_same_v<E, uint32_t>) {
+                    _targets.push_back(e);
+                } else {
+                    _targets.push_back(e.first);
+                    _weights.push_back(static_cast<double>(e.second));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Construct a new csr_graph object from already built csr arrays.
+     * @param ids: the interning table, vertex u owns targets[offsets[u], offsets[u + 1]).
+     * @param offsets: ids.size() + 1 arc offsets.
+     * @param targets: the target id of every arc.
+     * @param weights: the weight of every arc, empty for an unweighted snapshot.
+     * @param directed: true if the graph is directed.
+     */
+    csr_graph(vertex_index<T> ids, std::vector<size_t> offsets, std::vector<uint32_t> targets,
+              std::vector<double> weights, bool directed)
+        : _offsets(std::move(offsets)), _targets(std::move(targets)),
+          _weights(std::move(weights)),
+          _ids(std::make_shared<const vertex_index<T>>(std::move(ids))), _directed(directed),
+          _weighted(!_weights.empty()) {
+        assert(_offsets.size() == _ids->size() + 1 && _offsets.back() == _targets.size());
+        assert(_weights.empty() || _weights.size() == _targets.size());
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of vertices of the snapshot.
+     */
+    size_t size() const { return _ids->size(); }
+
+    /**
+     * @brief empty function
+     * @returns true if the snapshot has no vertices.
+     */
+    bool empty() const { return _ids->size() == 0; }
+
+    /**
+     * @brief arcs function
+     * @returns size_t the number of stored arcs(undirected edges are stored twice).
+     */
+    size_t arcs() const { return _targets.size(); }
+
+    /**
+     * @brief directed function
+     * @returns true if the snapshot was taken from a directed graph.
+     */
+    bool directed() const { return _directed; }
+
+    /**
+     * @brief weighted function
+     * @returns true if the snapshot was taken from a weighted graph.
+     */
+    bool weighted() const { return _weighted; }
+
+    /**
+     * @brief id function
+     * @param key: the vertex we want to look up.
+     * @returns uint32_t the dense id of key, or npos if key is not in the snapshot.
+     */
+    uint32_t id(const T& key) const { return _ids->id(key); }
+
+    /**
+     * @brief vertex function
+     * @param u: a dense vertex id.
+     * @returns const T& the vertex with id u.
+     */
+    const T& vertex(uint32_t u) const { return _ids->vertex(u); }
+
+    /**
+     * @brief degree function
+     * @param u: a dense vertex id.
+     * @returns size_t the out-degree of u.
+     */
+    size_t degree(uint32_t u) const { return _offsets[u + 1] - _offsets[u]; }
+
+    /**
+     * @brief neighbors function
+     * @param u: a dense vertex id.
+     * @returns std::span<const uint32_t> the ids of the out-neighbors of u.
+     */
+    std::span<const uint32_t> neighbors(uint32_t u) const {
+        return {_targets.data() + _offsets[u], degree(u)};
+    }
+
+    /**
+     * @brief weight function
+     * @param e: an arc index in [0, arcs()).
+     * @returns double the weight of the arc(1 for unweighted snapshots).
+     */
+    double weight(size_t e) const { return _weighted ? _weights[e] : 1.0; }
+
+    /**
+     * @brief raw access to the offset array(size() + 1 entries).
+     */
+    const std::vector<size_t>& offsets() const { return _offsets; }
+
+    /**
+     * @brief raw access to the contiguous neighbor array.
+     */
+    const std::vector<uint32_t>& targets() const { return _targets; }
+
+    /**
+     * @brief raw access to the contiguous weight array(empty for unweighted snapshots).
+     */
+    const std::vector<double>& weights() const { return _weights; }
+
+    /**
+     * @brief raw access to the id -> vertex table.
+     */
+    const std::vector<T>& vertices() const { return _ids->vertices(); }
+
+    /**
+     * @brief transpose function
+     * @returns csr_graph<T> the snapshot with every arc reversed(same ids and weights).
+     * For undirected snapshots this is a copy of the snapshot.
+     */
+    csr_graph<T> transpose() const;
+
+    /**
+     * @brief dfs function
+     * @param start: starting node of the dfs.
+     * @returns vector<T>, the path of the dfs.
+     */
+    std::vector<T> dfs(const T& start) const;
+
+    /**
+     * @brief bfs function
+     * @param start: starting node of the bfs.
+     * @returns vector<T>, the path of the bfs.
+     */
+    std::vector<T> bfs(const T& start) const;
+
+    /**
+     * @brief connected_components function.
+     * @returns the connected components(islands) of the graph.
+     */
+    int64_t connected_components() const;
+
+    /**
+     *@brief scc(strongly connected components) function.
+     *@returns int64_t the number of scc's in the graph using tarjan's algorithm.
+     */
+    int64_t scc() const { return static_cast<int64_t>(scc_labels().count); }
+
+    /**
+     *@brief scc_labels function.
+     *@returns component_labels the scc of every vertex, computed with an iterative
+     *tarjan(see parallel_scc() for the multi-threaded version).
+     */
+    component_labels scc_labels() const {
+        return tarjan_scc(
+            static_cast<uint32_t>(size()), [this](uint32_t u) { return degree(u); },
+            [this](uint32_t u, size_t i) { return _targets[_offsets[u] + i]; });
+    }
+
+    /**
+     *@brief bridge function.
+     *@param start: starting point of search for the bridges.
+     *@returns vector<vector<T>> the bridges of the graph.
+     */
+    std::vector<std::vector<T>> bridge(const T& start) const;
+
+    /**
+     * @brief shortest_path function.
+     * @param start: starting node.
+     * @param end: ending node.
+     * @returns double, the total cost of the path or -1 if end is unreachable.
+     * @tparam Heap priority queue over dense ids with the interface of indexed_heap,
+     * radix_heap needs integer weights. Default = indexed_heap<double>
+     */
+    template <typename Heap = indexed_heap<double>>
+    double shortest_path(const T& start, const T& end) const;
+
+    /**
+     * @brief prim function.
+     * @param start: starting node.
+     * @returns int64_t, the total cost of the minimum spanning tree of the component of
+     * start.
+     * @tparam Heap priority queue over dense ids with the interface of indexed_heap, the
+     * keys are not monotone so radix_heap can't be used. Default = indexed_heap<double>
+     */
+    template <typename Heap = indexed_heap<double>> int64_t prim(const T& start) const;
+
+    /**
+     *@brief maximum flow function(dinic on the snapshot's arcs, weights are capacities)
+     *@param start: the source.
+     *@param end: the sink.
+     *@returns double: the maximum flow from start to end
+     */
+    double max_flow(const T& start, const T& end) const {
+        return min_cut(start, end).value;
+    }
+
+    /**
+     *@brief min_cut function
+     *@param start: the source.
+     *@param end: the sink.
+     *@param algo: dinic or push_relabel.
+     *@returns flow_result the maximum flow value and the source side of a minimum cut
+     *indexed by dense id, an empty result if start or end does not exist.
+     */
+    flow_result min_cut(const T& start, const T& end,
+                        flow_algorithm algo = flow_algorithm::dinic) const {
+        uint32_t s = id(start), t = id(end);
+        if (s == npos || t == npos) {
+            return {};
+        }
+        return flow_network(static_cast<uint32_t>(size()), _offsets, _targets, _weights)
+            .solve(s, t, algo);
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the arcs and their weights, the offsets and the vertex tables as
+     * node overhead, the object with the headers of the arrays, the control block of the
+     * shared tables, and the spare capacity. A transpose shares the tables, each counts them.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_targets) + MEMORY::heap_usage(_weights);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_offsets));
+        f += MEMORY::as_overhead(_ids->memory_usage());
+        f.control += sizeof(*this) + MEMORY::SHARED_CONTROL + MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+  private:
+    /**
+     * @param _offsets: prefix sums of the out-degrees.
+     * @param _targets: neighbor ids of every vertex, stored back to back.
+     * @param _weights: arc weights aligned with _targets.
+     * @param _ids: vertex <-> id tables, shared between a snapshot and its transpose.
+     */
+    std::vector<size_t> _offsets;
+    std::vector<uint32_t> _targets;
+    std::vector<double> _weights;
+    std::shared_ptr<const vertex_index<T>> _ids;
+    bool _directed{false};
+    bool _weighted{false};
+
+    /**
+     * @brief helper that floods every vertex reachable from s and marks it in visited
+     */
+    void _flood(uint32_t s, std::vector<uint8_t>& visited) const {
+        stack_list<uint32_t> st;
+        st.push(s);
+        visited[s] = 1;
+        while (!st.empty()) {
+            uint32_t u = st.top();
+            st.pop();
+            for (uint32_t v : neighbors(u)) {
+                if (!visited[v]) {
+                    visited[v] = 1;
+                    st.push(v);
+                }
+            }
+        }
+    }
+};
+
+template <typename T> csr_graph<T> csr_graph<T>::transpose() const {
+    csr_graph<T> t;
+    t._ids = _ids;
+    t._directed = _directed;
+    t._weighted = _weighted;
+    const size_t n = size();
+    t._offsets.assign(n + 1, 0);
+    for (uint32_t v : _targets) {
+        t._offsets[v + 1]++;
+    }
+    for (size_t u = 0; u < n; u++) {
+        t._offsets[u + 1] += t._offsets[u];
+    }
+    t._targets.resize(_targets.size());
+    if (_weighted) {
+        t._weights.resize(_weights.size());
+    }
+    std::vector<size_t> fill(t._offsets.begin(), t._offsets.end() - 1);
+    for (uint32_t u = 0; u < n; u++) {
+        for (size_t e = _offsets[u]; e < _offsets[u + 1]; e++) {
+            size_t pos = fill[_targets[e]]++;
+            t._targets[pos] = u;
+            if (_weighted) {
+                t._weights[pos] = _weights[e];
+            }
+        }
+    }
+    return t;
+}
+
+template <typename T> std::vector<T> csr_graph<T>::dfs(const T& start) const {
+    std::vector<T> path;
+    uint32_t s = id(start);
+    if (s == npos) {
+        return path;
+    }
+    std::vector<uint8_t> visited(size(), 0);
+    stack_list<uint32_t> st;
+    st.push(s);
+    visited[s] = 1;
+    while (!st.empty()) {
+        uint32_t u = st.top();
+        st.pop();
+        path.push_back(vertex(u));
+        for (uint32_t v : neighbors(u)) {
+            if (!visited[v]) {
+                visited[v] = 1;
+                st.push(v);
+            }
+        }
+    }
+    return path;
+}
+
+template <typename T> std::vector<T> csr_graph<T>::bfs(const T& start) const {
+    std::vector<T> path;
+    uint32_t s = id(start);
+    if (s == npos) {
+        return path;
+    }
+    std::vector<uint8_t> visited(size(), 0);
+    std::vector<uint32_t> q = {s};
+    visited[s] = 1;
+    for (size_t head = 0; head < q.size(); head++) {
+        uint32_t u = q[head];
+        path.push_back(vertex(u));
+        for (uint32_t v : neighbors(u)) {
+            if (!visited[v]) {
+                visited[v] = 1;
+                q.push_back(v);
+            }
+        }
+    }
+    return path;
+}
+
+template <typename T> int64_t csr_graph<T>::connected_components() const {
+    std::vector<uint8_t> visited(size(), 0);
+    int64_t cc = 0;
+    for (uint32_t u = 0; u < size(); u++) {
+        if (!visited[u]) {
+            _flood(u, visited);
+            cc++;
+        }
+    }
+    return cc;
+}
+
+template <typename T> std::vector<std::vector<T>> csr_graph<T>::bridge(const T& start) const {
+    std::vector<std::vector<T>> bridges;
+    uint32_t s = id(start);
+    if (s == npos) {
+        return bridges;
+    }
+    std::vector<uint8_t> visited(size(), 0);
+    std::vector<int64_t> in(size(), 0), low(size(), 0);
+    int64_t timer = 0;
+
+    // frame: vertex, parent, next arc to look at
+    struct frame {
+        uint32_t u, parent;
+        size_t e;
+    };
+    stack_list<frame> st;
+    st.push({s, npos, _offsets[s]});
+    visited[s] = 1;
+    in[s] = low[s] = timer++;
+    while (!st.empty()) {
+        frame& f = st.top();
+        if (f.e < _offsets[f.u + 1]) {
+            uint32_t v = _targets[f.e++];
+            if (v == f.parent) {
+                continue;
+            }
+            if (!visited[v]) {
+                visited[v] = 1;
+                in[v] = low[v] = timer++;
+                st.push({v, f.u, _offsets[v]});
+            } else {
+                low[f.u] = std::min(low[f.u], low[v]);
+            }
+        } else {
+            uint32_t v = f.u, u = f.parent;
+            st.pop();
+            if (u != npos) {
+                if (low[v] > in[u]) {
+                    bridges.push_back({vertex(v), vertex(u)});
+                }
+                low[u] = std::min(low[u], low[v]);
+            }
+        }
+    }
+    return bridges;
+}
+
+template <typename T>
+template <typename Heap>
+double csr_graph<T>::shortest_path(const T& start, const T& end) const {
+    using key_type = typename Heap::key_type;
+    uint32_t s = id(start), t = id(end);
+    if (s == npos || t == npos) {
+        return -1;
+    }
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> dist(size(), inf);
+    dist[s] = 0;
+    Heap pq(size());
+    pq.push(s, key_type(0));
+    while (!pq.empty()) {
+        uint32_t u = pq.pop();
+        if (u == t) {
+            break;
+        }
+        const double d = dist[u];
+        for (size_t e = _offsets[u]; e < _offsets[u + 1]; e++) {
+            uint32_t v = _targets[e];
+            if (d + weight(e) < dist[v]) {
+                dist[v] = d + weight(e);
+                pq.push(v, static_cast<key_type>(dist[v]));
+            }
+        }
+    }
+    return dist[t] != inf ? dist[t] : -1;
+}
+
+template <typename T> template <typename Heap> int64_t csr_graph<T>::prim(const T& start) const {
+    using key_type = typename Heap::key_type;
+    uint32_t s = id(start);
+    if (s == npos) {
+        return 0;
+    }
+    std::vector<uint8_t> visited(size(), 0);
+    // key of a vertex: the lightest arc joining it to the tree
+    Heap pq(size());
+    pq.push(s, key_type(0));
+    double cost = 0;
+    while (!pq.empty()) {
+        cost += pq.top_key();
+        uint32_t u = pq.pop();
+        visited[u] = 1;
+        for (size_t e = _offsets[u]; e < _offsets[u + 1]; e++) {
+            if (!visited[_targets[e]]) {
+                pq.push(_targets[e], static_cast<key_type>(weight(e)));
+            }
+        }
+    }
+    return static_cast<int64_t>(cost);
+}
+
+#endif
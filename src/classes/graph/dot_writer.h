@@ -0,0 +1,173 @@
+#ifndef DOT_WRITER_H
+#define DOT_WRITER_H
+
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief which vertices write_dot() keeps
+ * all: every vertex.
+ * uniform: max_vertices vertices picked uniformly at random.
+ * ego: the vertices within radius hops of seed(following the arcs), breadth first,
+ * at most max_vertices of them.
+ */
+enum class dot_sampling { all, uniform, ego };
+
+/**
+ * @brief options of write_dot()
+ * @param sampling: all, uniform or ego.
+ * @param max_vertices: upper bound on the vertices written, 0 means no bound.
+ * @param seed: the center of the ego network.
+ * @param radius: hops around seed kept by the ego sampling.
+ * @param random_seed: seed of the uniform sampling.
+ * @param weights: write arc weights as edge labels(weighted snapshots only).
+ */
+template <typename T> struct dot_options {
+    dot_sampling sampling{dot_sampling::all};
+    size_t max_vertices{0};
+    std::optional<T> seed;
+    size_t radius{1};
+    uint32_t random_seed{0};
+    bool weights{true};
+};
+
+namespace _dot_utils {
+template <typename T> void write_name(std::ostream& out, const T& key) {
+    out << '"';
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        for (char c : std::string_view(key)) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+    } else {
+        out << key;
+    }
+    out << '"';
+}
+
+template <typename T>
+std::vector<uint8_t> select(const csr_graph<T>& g, const dot_options<T>& opt) {
+    const size_t n = g.size();
+    const size_t limit = opt.max_vertices == 0 ? n : std::min(n, opt.max_vertices);
+    std::vector<uint8_t> keep(n, 0);
+    if (opt.sampling == dot_sampling::ego) {
+        uint32_t s = opt.seed ? g.id(*opt.seed) : csr_graph<T>::npos;
+        if (s == csr_graph<T>::npos || limit == 0) {
+            return keep;
+        }
+        std::vector<uint32_t> q = {s};
+        keep[s] = 1;
+        size_t level_end = 1;
+        for (size_t head = 0, depth = 0; head < q.size() && q.size() < limit; head++) {
+            if (head == level_end) {
+                depth++, level_end = q.size();
+            }
+            if (depth >= opt.radius) {
+                break;
+            }
+            for (uint32_t v : g.neighbors(q[head])) {
+                if (!keep[v] && q.size() < limit) {
+                    keep[v] = 1;
+                    q.push_back(v);
+                }
+            }
+        }
+    } else if (opt.sampling == dot_sampling::uniform && limit < n) {
+        std::vector<uint32_t> ids(n);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::mt19937 rng(opt.random_seed);
+        for (size_t i = 0; i < limit; i++) {
+            std::swap(ids[i], ids[i + rng() % (n - i)]);
+            keep[ids[i]] = 1;
+        }
+    } else {
+        std::fill(keep.begin(), keep.begin() + limit, 1);
+    }
+    return keep;
+}
+} // namespace _dot_utils
+
+/**
+ * @brief write_dot function
+ * Streams the snapshot in graphviz DOT format: every kept vertex, then every arc
+ * between two kept vertices(undirected edges once), so no intermediate string is built.
+ * @param out: the stream to write to.
+ * @param g: the snapshot(see graph<T>::csr_view()).
+ * @param opt: sampling and labels.
+ * @returns size_t the number of arcs written.
+ */
+template <typename T>
+size_t write_dot(std::ostream& out, const csr_graph<T>& g, const dot_options<T>& opt = {}) {
+    std::vector<uint8_t> keep = _dot_utils::select(g, opt);
+    const char* arrow = g.directed() ? " -> " : " -- ";
+    out << (g.directed() ? "digraph" : "graph") << " G {\n";
+    for (uint32_t u = 0; u < g.size(); u++) {
+        if (keep[u]) {
+            out << "    ";
+            _dot_utils::write_name(out, g.vertex(u));
+            out << ";\n";
+        }
+    }
+    size_t written = 0;
+    for (uint32_t u = 0; u < g.size(); u++) {
+        if (!keep[u]) {
+            continue;
+        }
+        bool skip_loop = false;
+        for (size_t e = g.offsets()[u]; e < g.offsets()[u + 1]; e++) {
+            uint32_t v = g.targets()[e];
+            // undirected snapshots store every edge twice, self loops next to each other
+            if (!keep[v] || (!g.directed() && v < u)) {
+                continue;
+            }
+            if (!g.directed() && v == u) {
+                skip_loop = !skip_loop;
+                if (!skip_loop) {
+                    continue;
+                }
+            }
+            out << "    ";
+            _dot_utils::write_name(out, g.vertex(u));
+            out << arrow;
+            _dot_utils::write_name(out, g.vertex(v));
+            if (opt.weights && g.weighted()) {
+                out << " [label=" << g.weight(e) << ']';
+            }
+            out << ";\n";
+            written++;
+        }
+    }
+    out << "}\n";
+    return written;
+}
+
+/**
+ * @brief render_dot function
+ * Runs graphviz on a DOT file from a background thread, the caller is never blocked.
+ * @param path: the DOT file.
+ * @param format: the output format passed to dot -T, the image is written next to path.
+ * @returns std::future<int> the exit status of the dot command.
+ */
+inline std::future<int> render_dot(const std::string& path, const std::string& format = "svg") {
+    std::string command = "dot -T" + format + " \"" + path + "\" -o \"" + path + "." + format +
+                          "\"";
+    return std::async(std::launch::async, [command]() { return std::system(command.c_str()); });
+}
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef EDGE_LIST_H
+#define EDGE_LIST_H
+
+#include "../../helpers/mapped_file.h"
+#include "../../helpers/parallel.h"
+#include "csr_graph.h"
+#include "vertex_index.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief on-disk layout of an edge list
+ * text: one edge per line, "u v" or "u v w" separated by spaces, tabs or commas. Empty
+ * lines and lines starting with '#' or '%' are skipped, extra columns are ignored.
+ * binary: packed native-endian records of (T u, T v) followed by a double w when the
+ * list is weighted, T must be an integral type.
+ */
+enum class edge_list_format { text, binary };
+
+/**
+ * @brief options of load_edge_list() / parse_edge_list()
+ * @param format: text or binary records.
+ * @param directed: false stores every edge in both directions.
+ * @param weighted: every record carries a weight.
+ * @param dedup: keep only one arc per (u, v), the one with the smallest weight.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ */
+struct edge_list_options {
+    edge_list_format format{edge_list_format::text};
+    bool directed{false};
+    bool weighted{false};
+    bool dedup{false};
+    size_t threads{0};
+};
+
+namespace _edge_list_utils {
+/**
+ * @brief the records of one chunk of the input
+ */
+template <typename T> struct chunk {
+    std::vector<T> ends;
+    std::vector<double> weights;
+    std::string error;
+};
+
+inline bool is_separator(char c) { return c == ' ' || c == '\t' || c == ',' || c == '\r'; }
+
+/**
+ * @brief next separator-delimited token in [p, end) that does not cross the line
+ */
+inline std::string_view token(const char*& p, const char* end) {
+    while (p < end && is_separator(*p)) {
+        p++;
+    }
+    const char* b = p;
+    while (p < end && *p != '\n' && !is_separator(*p)) {
+        p++;
+    }
+    return {b, static_cast<size_t>(p - b)};
+}
+
+template <typename T> bool parse_vertex(std::string_view tok, T& out) {
+    if constexpr (std::is_integral_v<T>) {
+        auto [ptr, ec] = std::from_chars(tok.data(), tok.data() + tok.size(), out);
+        return ec == std::errc() && ptr == tok.data() + tok.size();
+    } else {
+        out = T(tok);
+        return !tok.empty();
+    }
+}
+
+inline bool parse_weight(std::string_view tok, double& out) {
+    auto [ptr, ec] = std::from_chars(tok.data(), tok.data() + tok.size(), out);
+    return ec == std::errc() && ptr == tok.data() + tok.size();
+}
+
+/**
+ * @brief moves a chunk boundary forward to the start of the next line
+ */
+inline size_t align_to_line(std::string_view data, size_t pos) {
+    if (pos == 0 || pos >= data.size()) {
+        return std::min(pos, data.size());
+    }
+    size_t nl = data.find('\n', pos - 1);
+    return nl == std::string_view::npos ? data.size() : nl + 1;
+}
+
+template <typename T>
+void parse_text(std::string_view data, bool weighted, chunk<T>& out) {
+    const char *p = data.data(), *end = data.data() + data.size();
+    while (p < end) {
+        const char* line = p;
+        std::string_view a = token(p, end);
+        if (!a.empty() && a[0] != '#' && a[0] != '%') {
+            std::string_view b = token(p, end);
+            T u, v;
+            double w = 1;
+            if (!parse_vertex(a, u) || !parse_vertex(b, v) ||
+                (weighted && !parse_weight(token(p, end), w))) {
+                const char* eol = std::find(line, end, '\n');
+                out.error = "Malformed edge list line: " + std::string(line, eol);
+                return;
+            }
+            out.ends.push_back(u);
+            out.ends.push_back(v);
+            if (weighted) {
+                out.weights.push_back(w);
+            }
+        }
+        p = std::find(p, end, '\n');
+        if (p < end) {
+            p++;
+        }
+    }
+}
+
+template <typename T>
+void parse_binary(std::string_view data, size_t first, size_t last, bool weighted,
+                  chunk<T>& out) {
+    const size_t record = 2 * sizeof(T) + (weighted ? sizeof(double) : 0);
+    out.ends.resize(2 * (last - first));
+    if (weighted) {
+        out.weights.resize(last - first);
+    }
+    for (size_t r = first; r < last; r++) {
+        const char* p = data.data() + r * record;
+        std::memcpy(&out.ends[2 * (r - first)], p, 2 * sizeof(T));
+        if (weighted) {
+            std::memcpy(&out.weights[r - first], p + 2 * sizeof(T), sizeof(double));
+        }
+    }
+}
+} // namespace _edge_list_utils
+
+/**
+ * @brief parse_edge_list function
+ * Builds a csr_graph straight from an edge list without going through add_edge: the
+ * input is parsed in parallel chunks, vertices are interned in input order(so ids
+ * follow the first appearance of every vertex), degrees are counted and arcs are
+ * scattered in parallel, and every neighbor list is then sorted by target id.
+ * @param data: the whole edge list.
+ * @param opt: format, direction, weights, duplicate removal and thread count.
+ * @returns csr_graph<T> the snapshot. Throws std::invalid_argument on malformed input.
+ */
+template <typename T>
+csr_graph<T> parse_edge_list(std::string_view data, const edge_list_options& opt = {}) {
+    static_assert(std::is_integral_v<T> || std::is_constructible_v<T, std::string_view>,
+                  "edge list vertices must be integral or constructible from a string");
+    const size_t threads = PARALLEL::resolve_threads(opt.threads, PARALLEL::hardware_threads());
+    std::vector<_edge_list_utils::chunk<T>> chunks(threads);
+
+    if (opt.format == edge_list_format::binary) {
+        if constexpr (std::is_integral_v<T>) {
+            const size_t record = 2 * sizeof(T) + (opt.weighted ? sizeof(double) : 0);
+            if (data.size() % record != 0) {
+                throw std::invalid_argument("Binary edge list size is not a multiple of the "
+                                            "record size");
+            }
+            const size_t records = data.size() / record;
+            PARALLEL::parallel_for(0, records, threads, [&](size_t lo, size_t hi, size_t tid) {
+                _edge_list_utils::parse_binary(data, lo, hi, opt.weighted, chunks[tid]);
+            });
+        } else {
+            throw std::invalid_argument("Binary edge lists need an integral vertex type");
+        }
+    } else {
+        // every chunk starts at the first line that begins inside its byte range
+        PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t t = lo; t < hi; t++) {
+                size_t b = _edge_list_utils::align_to_line(data, data.size() * t / threads);
+                size_t e = _edge_list_utils::align_to_line(data, data.size() * (t + 1) / threads);
+                if (b < e) {
+                    _edge_list_utils::parse_text(data.substr(b, e - b), opt.weighted, chunks[t]);
+                }
+            }
+        });
+    }
+    for (const _edge_list_utils::chunk<T>& c : chunks) {
+        if (!c.error.empty()) {
+            throw std::invalid_argument(c.error);
+        }
+    }
+
+    // interning has to follow the input order to give deterministic ids
+    size_t edges = 0;
+    for (const _edge_list_utils::chunk<T>& c : chunks) {
+        edges += c.ends.size() / 2;
+    }
+    vertex_index<T> ids;
+    std::vector<uint32_t> ends;
+    std::vector<double> weights;
+    ends.reserve(2 * edges);
+    if (opt.weighted) {
+        weights.reserve(edges);
+    }
+    for (_edge_list_utils::chunk<T>& c : chunks) {
+        for (const T& x : c.ends) {
+            ends.push_back(ids.intern(x));
+        }
+        weights.insert(weights.end(), c.weights.begin(), c.weights.end());
+        c = {};
+    }
+
+    const size_t n = ids.size();
+    std::vector<size_t> offsets(n + 1, 0);
+    auto bump = [](size_t& x) {
+        return std::atomic_ref<size_t>(x).fetch_add(1, std::memory_order_relaxed);
+    };
+    PARALLEL::parallel_for(0, edges, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            bump(offsets[ends[2 * i] + 1]);
+            if (!opt.directed) {
+                bump(offsets[ends[2 * i + 1] + 1]);
+            }
+        }
+    });
+    for (size_t u = 0; u < n; u++) {
+        offsets[u + 1] += offsets[u];
+    }
+
+    // arcs land in their segment in any order, sorting the segments makes it deterministic
+    std::vector<std::pair<uint32_t, double>> arcs(offsets.back());
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    PARALLEL::parallel_for(0, edges, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            uint32_t u = ends[2 * i], v = ends[2 * i + 1];
+            double w = opt.weighted ? weights[i] : 1.0;
+            arcs[bump(cursor[u])] = {v, w};
+            if (!opt.directed) {
+                arcs[bump(cursor[v])] = {u, w};
+            }
+        }
+    });
+    std::vector<uint32_t>().swap(ends);
+    std::vector<double>().swap(weights);
+
+    std::vector<size_t> kept(n + 1, 0);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            auto b = arcs.begin() + offsets[u], e = arcs.begin() + offsets[u + 1];
+            std::sort(b, e);
+            if (opt.dedup) {
+                e = std::unique(b, e, [](const std::pair<uint32_t, double>& x,
+                                         const std::pair<uint32_t, double>& y) {
+                    return x.first == y.first;
+                });
+            }
+            kept[u + 1] = static_cast<size_t>(e - b);
+        }
+    });
+    for (size_t u = 0; u < n; u++) {
+        kept[u + 1] += kept[u];
+    }
+
+    std::vector<uint32_t> targets(kept.back());
+    std::vector<double> arc_weights(opt.weighted ? kept.back() : 0);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            for (size_t i = 0; i < kept[u + 1] - kept[u]; i++) {
+                targets[kept[u] + i] = arcs[offsets[u] + i].first;
+                if (opt.weighted) {
+                    arc_weights[kept[u] + i] = arcs[offsets[u] + i].second;
+                }
+            }
+        }
+    });
+    return csr_graph<T>(std::move(ids), std::move(kept), std::move(targets),
+                        std::move(arc_weights), opt.directed);
+}
+
+/**
+ * @brief load_edge_list function
+ * Memory maps path and builds its csr_graph with parse_edge_list().
+ * @param path: the edge list file.
+ * @param opt: format, direction, weights, duplicate removal and thread count.
+ * @returns csr_graph<T> the snapshot. Throws std::runtime_error if the file can not be
+ * read and std::invalid_argument on malformed input.
+ */
+template <typename T>
+csr_graph<T> load_edge_list(const std::string& path, const edge_list_options& opt = {}) {
+    mapped_file file(path);
+    return parse_edge_list<T>(file.view(), opt);
+}
+
+#endif
@@ -0,0 +1,339 @@
+#ifndef FLOW_NETWORK_H
+#define FLOW_NETWORK_H
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#endif
+
+/**
+ * @brief max flow engine used by flow_network::solve()
+ * dinic: blocking flows on the bfs level graph, O(V^2 E).
+ * push_relabel: highest-label push-relabel with the gap heuristic and periodic global
+ * relabeling, O(V^2 sqrt(E)).
+ */
+enum class flow_algorithm { dinic, push_relabel };
+
+/**
+ * @brief result of a max flow computation, indexed by dense vertex id
+ * @param value: the value of the maximum flow.
+ * @param source_side: 1 for the vertices on the source side of a minimum cut(the ones
+ * that can not reach the sink in the residual network), 0 for the others.
+ */
+struct flow_result {
+    double value{0};
+    std::vector<uint8_t> source_side;
+};
+
+/**
+ * @brief flow_network class
+ * Residual network stored as one flat arc array grouped by tail vertex: every input arc
+ * u -> v becomes a forward arc of u and a reverse arc of v with zero capacity, and each
+ * arc knows the index of its partner. The capacities are restored before every solve(),
+ * so one network can be solved many times for different terminals.
+ */
+class flow_network {
+  public:
+    /**
+     * @brief Construct a new flow_network object from csr arrays
+     * @param n: number of vertices.
+     * @param offsets: n + 1 offsets, the arcs of u are [offsets[u], offsets[u + 1]).
+     * @param targets: the head of every arc.
+     * @param capacities: the capacity of every arc, empty means every capacity is 1.
+     */
+    flow_network(uint32_t n, const std::vector<size_t>& offsets,
+                 const std::vector<uint32_t>& targets, const std::vector<double>& capacities)
+        : _offsets(n + 1, 0) {
+        for (uint32_t u = 0; u < n; u++) {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                if (targets[e] != u) {
+                    _offsets[u + 1]++;
+                    _offsets[targets[e] + 1]++;
+                }
+            }
+        }
+        for (uint32_t u = 0; u < n; u++) {
+            _offsets[u + 1] += _offsets[u];
+        }
+        const size_t m = _offsets.back();
+        _to.resize(m);
+        _rev.resize(m);
+        _capacity.assign(m, 0);
+        std::vector<size_t> fill(_offsets.begin(), _offsets.end() - 1);
+        for (uint32_t u = 0; u < n; u++) {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                uint32_t v = targets[e];
+                if (v == u) {
+                    continue;
+                }
+                size_t a = fill[u]++, b = fill[v]++;
+                _to[a] = v, _rev[a] = b, _capacity[a] = capacities.empty() ? 1.0 : capacities[e];
+                _to[b] = u, _rev[b] = a;
+            }
+        }
+        _cap = _capacity;
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of vertices.
+     */
+    size_t size() const { return _offsets.size() - 1; }
+
+    /**
+     * @brief arcs function
+     * @returns size_t the number of residual arcs(twice the number of input arcs).
+     */
+    size_t arcs() const { return _to.size(); }
+
+    /**
+     * @brief solve function
+     * @param s: the dense id of the source.
+     * @param t: the dense id of the sink.
+     * @param algo: the max flow engine.
+     * @returns flow_result the flow value and the source side of a minimum cut.
+     */
+    flow_result solve(uint32_t s, uint32_t t, flow_algorithm algo = flow_algorithm::dinic) {
+        flow_result result;
+        _cap = _capacity;
+        if (s != t) {
+            result.value = algo == flow_algorithm::dinic ? _dinic(s, t) : _push_relabel(s, t);
+        }
+        result.source_side = _source_side(t);
+        return result;
+    }
+
+    /**
+     * @brief flow function
+     * @param e: a residual arc index.
+     * @returns double the flow on arc e after the last solve().
+     */
+    double flow(size_t e) const { return std::max(0.0, _capacity[e] - _cap[e]); }
+
+  private:
+    /**
+     * @param _offsets: the residual arcs of u are [_offsets[u], _offsets[u + 1]).
+     * @param _to: head of every residual arc.
+     * @param _rev: index of the partner arc.
+     * @param _capacity: original capacities.
+     * @param _cap: residual capacities of the last solve().
+     */
+    std::vector<size_t> _offsets;
+    std::vector<uint32_t> _to;
+    std::vector<size_t> _rev;
+    std::vector<double> _capacity;
+    std::vector<double> _cap;
+
+    /**
+     * @brief bfs from t over reversed residual arcs, dist[u] is the residual distance
+     * from u to t, or n if t is unreachable from u
+     */
+    std::vector<uint32_t> _distance_to(uint32_t t) const {
+        const uint32_t n = static_cast<uint32_t>(size());
+        std::vector<uint32_t> dist(n, n);
+        std::vector<uint32_t> q = {t};
+        dist[t] = 0;
+        for (size_t head = 0; head < q.size(); head++) {
+            uint32_t v = q[head];
+            for (size_t e = _offsets[v]; e < _offsets[v + 1]; e++) {
+                uint32_t u = _to[e];
+                if (dist[u] == n && _cap[_rev[e]] > 0) {
+                    dist[u] = dist[v] + 1;
+                    q.push_back(u);
+                }
+            }
+        }
+        return dist;
+    }
+
+    std::vector<uint8_t> _source_side(uint32_t t) const {
+        const uint32_t n = static_cast<uint32_t>(size());
+        std::vector<uint32_t> dist = _distance_to(t);
+        std::vector<uint8_t> side(n);
+        for (uint32_t u = 0; u < n; u++) {
+            side[u] = dist[u] == n;
+        }
+        return side;
+    }
+
+    double _dinic(uint32_t s, uint32_t t);
+    double _push_relabel(uint32_t s, uint32_t t);
+};
+
+inline double flow_network::_dinic(uint32_t s, uint32_t t) {
+    const uint32_t n = static_cast<uint32_t>(size());
+    std::vector<int64_t> level(n);
+    std::vector<size_t> it(n);
+    std::vector<uint32_t> q;
+    std::vector<size_t> path;
+    double total = 0;
+    while (true) {
+        std::fill(level.begin(), level.end(), -1);
+        level[s] = 0;
+        q.assign(1, s);
+        for (size_t head = 0; head < q.size() && level[t] == -1; head++) {
+            uint32_t u = q[head];
+            for (size_t e = _offsets[u]; e < _offsets[u + 1]; e++) {
+                if (_cap[e] > 0 && level[_to[e]] == -1) {
+                    level[_to[e]] = level[u] + 1;
+                    q.push_back(_to[e]);
+                }
+            }
+        }
+        if (level[t] == -1) {
+            break;
+        }
+
+        // blocking flow with an explicit path and current-arc pointers
+        std::copy(_offsets.begin(), _offsets.end() - 1, it.begin());
+        path.clear();
+        uint32_t u = s;
+        while (true) {
+            if (u == t) {
+                double push = std::numeric_limits<double>::infinity();
+                for (size_t e : path) {
+                    push = std::min(push, _cap[e]);
+                }
+                size_t keep = path.size();
+                for (size_t k = 0; k < path.size(); k++) {
+                    _cap[path[k]] -= push;
+                    _cap[_rev[path[k]]] += push;
+                    if (_cap[path[k]] <= 0 && keep == path.size()) {
+                        keep = k;
+                    }
+                }
+                total += push;
+                path.resize(keep);
+                u = path.empty() ? s : _to[path.back()];
+                continue;
+            }
+            size_t& e = it[u];
+            while (e < _offsets[u + 1] && !(_cap[e] > 0 && level[_to[e]] == level[u] + 1)) {
+                e++;
+            }
+            if (e < _offsets[u + 1]) {
+                path.push_back(e);
+                u = _to[e];
+                continue;
+            }
+            // dead end: nothing useful leaves u in this phase
+            if (u == s) {
+                break;
+            }
+            level[u] = -1;
+            path.pop_back();
+            u = path.empty() ? s : _to[path.back()];
+            it[u]++;
+        }
+    }
+    return total;
+}
+
+inline double flow_network::_push_relabel(uint32_t s, uint32_t t) {
+    const uint32_t n = static_cast<uint32_t>(size());
+    std::vector<double> excess(n, 0);
+    std::vector<uint32_t> height;
+    std::vector<size_t> it(_offsets.begin(), _offsets.end() - 1);
+    std::vector<std::vector<uint32_t>> active(n);
+    std::vector<uint32_t> count(n + 1, 0);
+    int64_t highest = -1;
+    size_t relabels = 0;
+
+    auto activate = [&](uint32_t v) {
+        if (v != s && v != t && height[v] < n) {
+            active[height[v]].push_back(v);
+            highest = std::max<int64_t>(highest, height[v]);
+        }
+    };
+    // exact distances to t, vertices that can not reach t are parked at height n
+    auto global_relabel = [&]() {
+        height = _distance_to(t);
+        height[s] = n;
+        std::fill(count.begin(), count.end(), 0);
+        for (std::vector<uint32_t>& bucket : active) {
+            bucket.clear();
+        }
+        highest = -1;
+        for (uint32_t v = 0; v < n; v++) {
+            count[height[v]]++;
+            it[v] = _offsets[v];
+            if (excess[v] > 0) {
+                activate(v);
+            }
+        }
+    };
+
+    for (size_t e = _offsets[s]; e < _offsets[s + 1]; e++) {
+        double push = _cap[e];
+        if (push > 0) {
+            _cap[e] = 0;
+            _cap[_rev[e]] += push;
+            excess[_to[e]] += push;
+            excess[s] -= push;
+        }
+    }
+    global_relabel();
+
+    while (highest >= 0) {
+        if (active[highest].empty()) {
+            highest--;
+            continue;
+        }
+        uint32_t u = active[highest].back();
+        active[highest].pop_back();
+        if (height[u] != highest || excess[u] <= 0) {
+            continue;
+        }
+        // discharge u
+        while (excess[u] > 0 && height[u] < n) {
+            size_t& e = it[u];
+            if (e == _offsets[u + 1]) {
+                uint32_t old = height[u], lowest = 2 * n;
+                for (size_t a = _offsets[u]; a < _offsets[u + 1]; a++) {
+                    if (_cap[a] > 0) {
+                        lowest = std::min(lowest, height[_to[a]] + 1);
+                    }
+                }
+                count[old]--;
+                if (count[old] == 0) {
+                    // gap: nothing above old can reach t anymore
+                    for (uint32_t v = 0; v < n; v++) {
+                        if (height[v] > old && height[v] < n) {
+                            count[height[v]]--;
+                            height[v] = n;
+                            count[n]++;
+                        }
+                    }
+                    lowest = n;
+                }
+                height[u] = std::min(lowest, n);
+                count[height[u]]++;
+                e = _offsets[u];
+                if (++relabels % (n + 1) == 0) {
+                    global_relabel();
+                    break;
+                }
+                continue;
+            }
+            uint32_t v = _to[e];
+            if (_cap[e] > 0 && height[u] == height[v] + 1) {
+                double push = std::min(excess[u], _cap[e]);
+                bool was_idle = excess[v] <= 0;
+                _cap[e] -= push;
+                _cap[_rev[e]] += push;
+                excess[u] -= push;
+                excess[v] += push;
+                if (was_idle) {
+                    activate(v);
+                }
+            } else {
+                e++;
+            }
+        }
+    }
+    return excess[t];
+}
+
+#endif
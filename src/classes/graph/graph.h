@@ -1,6 +1,17 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "all_pairs.h"
+#include "bellman_ford.h"
+#include "biconnected.h"
+#include "csr_graph.h"
+#include "dot_writer.h"
+#include "parallel_scc.h"
+#include "shortest_path_query.h"
+#include "spanning_forest.h"
+#include "sssp.h"
+#include "traversal.h"
+#include "vertex_index.h"
 #include <cfloat>
 #ifdef ENABLE_GRAPH_VISUALIZATION
 #include "../../visualization/graph_visual/graph_visualization.h"
@@ -13,22 +24,48 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
-#include <stack>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #endif
 
+/**
+ * @brief edge direction policies of graph and weighted_graph
+ * runtime_direction: picked by the "directed"/"undirected" constructor argument.
+ * directed_edges, undirected_edges: fixed at compile time, the constructors take no type
+ * and every direction check is a constant.
+ */
+struct runtime_direction {};
+struct directed_edges {
+    static constexpr bool directed = true;
+};
+struct undirected_edges {
+    static constexpr bool directed = false;
+};
+
+template <typename T, typename Direction = runtime_direction> class graph;
+template <typename T, typename Direction = runtime_direction> class weighted_graph;
+
+/**
+ * @brief graphs with the direction fixed at compile time
+ */
+template <typename T> using directed_graph = graph<T, directed_edges>;
+template <typename T> using undirected_graph = graph<T, undirected_edges>;
+template <typename T> using directed_weighted_graph = weighted_graph<T, directed_edges>;
+template <typename T> using undirected_weighted_graph = weighted_graph<T, undirected_edges>;
+
 /**
  *
  * @brief Class for Unweighted Graph
  *
  */
-template <typename T> class graph {
+template <typename T, typename Direction> class graph {
   public:
     /**
      * @brief Constructor for the unweighted graph.
@@ -36,32 +73,42 @@ template <typename T> class graph {
      * @param __adj: vector<pair<T,vector<T>>, you can pass a vector of pairs to
      * construct the graph without doing multiple add_edge.
      */
-    graph(std::string _type, std::vector<std::pair<T, std::vector<T>>> _adj = {}) {
+    graph(std::string _type, std::vector<std::pair<T, std::vector<T>>> _adj = {})
+        requires std::is_same_v<Direction, runtime_direction>
+    {
         try {
             if (_type == "directed" || _type == "undirected") {
-                this->_type = _type;
+                this->_directed = _type == "directed";
             } else {
                 throw std::invalid_argument("Can't recognize the type of graph");
             }
-            if (!_adj.empty()) {
-                for (size_t i = 0; i < _adj.size(); i++) {
-                    for (T& neigh : _adj[i].second) {
-                        this->add_edge(_adj[i].first, neigh);
-                    }
-                }
-            }
+            _add_all(_adj);
         } catch (std::invalid_argument& e) {
             std::cerr << e.what() << '\n';
             return;
         }
     }
 
+    /**
+     * @brief Constructor for graphs whose direction is fixed by the policy
+     * (see directed_graph and undirected_graph).
+     * @param __adj: vector<pair<T,vector<T>>, you can pass a vector of pairs to
+     * construct the graph without doing multiple add_edge.
+     */
+    explicit graph(std::vector<std::pair<T, std::vector<T>>> _adj = {})
+        requires(!std::is_same_v<Direction, runtime_direction>)
+    {
+        _add_all(_adj);
+    }
+
     /**
      * @brief Construct a new graph object
      *
      * @param g the graph we want to copy
      */
-    graph(const graph& g) : adj(g.adj), _elements(g._elements), _type(g._type) {}
+    graph(const graph& g)
+        : adj(g.adj), _elements(g._elements), _ids(g._ids), _directed(g._directed),
+          _csr(g._csr) {}
 
     /**
      * @brief operator = for the graph class
@@ -72,7 +119,9 @@ template <typename T> class graph {
     graph& operator=(const graph& g) {
         adj = g.adj;
         _elements = g._elements;
-        _type = g._type;
+        _ids = g._ids;
+        _directed = g._directed;
+        _csr = g._csr;
         return *this;
     }
 
@@ -87,14 +136,12 @@ template <typename T> class graph {
      * @param v: second node
      */
     void add_edge(T u, T v) {
-        if (_type == "undirected") {
-            adj[u].push_back(v);
-            adj[v].push_back(u);
-        } else {
-            adj[u].push_back(v);
+        uint32_t a = _intern(u), b = _intern(v);
+        adj[a].push_back(b);
+        if (!_is_directed()) {
+            adj[b].push_back(a);
         }
-        _elements.insert(u);
-        _elements.insert(v);
+        _csr.reset();
     }
 
     /**
@@ -105,15 +152,11 @@ template <typename T> class graph {
         false if a direct edge from start to end does not exist.
         */
     bool has_edge(T start, T end) {
-        if (_elements.find(start) == _elements.end()) {
+        uint32_t s = _ids.id(start), e = _ids.id(end);
+        if (s == vertex_index<T>::npos || e == vertex_index<T>::npos) {
             return false;
         }
-        for (T& x : adj[start]) {
-            if (x == end) {
-                return true;
-            }
-        }
-        return false;
+        return std::find(adj[s].begin(), adj[s].end(), e) != adj[s].end();
     }
 
     /**
@@ -122,7 +165,9 @@ template <typename T> class graph {
      */
     void clear() {
         _elements.clear();
+        _ids.clear();
         adj.clear();
+        _csr.reset();
     }
 
     /**
@@ -178,18 +223,40 @@ template <typename T> class graph {
     /**
      *@brief bridge function.
      *@param start: starting point of search for the bridges.
-     *@returns vector<vector<T>> the bridges of the graph.
+     *@returns vector<vector<T>> the bridges reachable from start, found without
+     *recursion(see biconnected_components() for every component).
      */
 
     std::vector<std::vector<T>> bridge(T start);
 
+    /**
+     *@brief biconnected_components function.
+     *@param threads: 1 for an iterative hopcroft-tarjan, otherwise tarjan-vishkin on that
+     *many threads(0 means every hardware thread).
+     *@returns biconnected_result the biconnected component of every arc, the bridges and
+     *the articulation points of every connected component, indexed by the dense ids of
+     *csr_view().
+     */
+    biconnected_result biconnected_components(size_t threads = 1) {
+        return ::biconnected_components(csr_view(), threads);
+    }
+
     /**
      *@brief scc(strongly connected components) function.
-     *@returns int64_t the number of scc's in the graph using kosaraju's
+     *@returns int64_t the number of scc's in the graph using tarjan's
      *algorithm.
      */
     int64_t scc();
 
+    /**
+     *@brief scc_labels function.
+     *@param threads: 1 runs an iterative tarjan, any other value runs parallel_scc() on
+     *csr_view() with that many threads(0 means every hardware thread).
+     *@returns component_labels the scc of every vertex indexed by the dense ids of
+     *csr_view(), and the scc count.
+     */
+    component_labels scc_labels(size_t threads = 1);
+
     /**
      *@brief connected function.
      *@returns true if a graph is connected.
@@ -204,6 +271,71 @@ template <typename T> class graph {
      */
     int eulerian();
 
+    /**
+     * @brief freeze function
+     * @returns csr_graph<T> an immutable compressed-sparse-row snapshot of the graph.
+     * Later add_edge calls do not affect the returned snapshot.
+     */
+    csr_graph<T> freeze() const { return csr_graph<T>(_ids, adj, _is_directed()); }
+
+    /**
+     * @brief csr_view function
+     * @returns const csr_graph<T>& a cached snapshot of the graph, rebuilt only after
+     * the graph has been modified. The reference is invalidated by add_edge and clear.
+     */
+    const csr_graph<T>& csr_view() const {
+        if (_csr == nullptr) {
+            _csr = std::make_shared<const csr_graph<T>>(freeze());
+        }
+        return *_csr;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the vertices and the arcs, the nodes of the vertex set, the
+     * headers of the adjacency lists, the vertex tables and the cached csr snapshot as node
+     * overhead, the object with the headers of the arrays and the bucket table, the spare
+     * capacity and the scratch buffers of the traversals as slack
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_elements);
+        f.node_overhead += adj.size() * sizeof(adj[0]);
+        f.slack += (adj.capacity() - adj.size()) * sizeof(adj[0]);
+        f.control += adj.capacity() > 0 ? MEMORY::ALLOCATION_OVERHEAD : 0;
+        for (const auto& arcs : adj) {
+            f += MEMORY::heap_usage(arcs);
+        }
+        f += MEMORY::as_overhead(_ids.memory_usage());
+        if (_csr != nullptr) {
+            f += MEMORY::as_overhead(_csr->memory_usage());
+            f.control += MEMORY::SHARED_CONTROL + MEMORY::ALLOCATION_OVERHEAD;
+        }
+        f += _ws.memory_usage();
+        f.control += sizeof(*this) - sizeof(_ids) - sizeof(_ws);
+        return f;
+    }
+
+    /**
+     * @brief traverse function
+     * @param start: the first vertex.
+     * @param order: bfs or dfs(see traversal_order).
+     * @returns lazy_traversal<T> a traversal over csr_view() that expands vertices only
+     * when they are requested. Invalidated by add_edge and clear like csr_view().
+     */
+    lazy_traversal<T> traverse(T start, traversal_order order = traversal_order::bfs) const {
+        return lazy_traversal<T>(csr_view(), start, order);
+    }
+
+    /**
+     * @brief write_dot function
+     * @param out: the stream the DOT text is written to, edge by edge.
+     * @param opt: vertex sampling(all, uniform or ego network) and labels.
+     * @returns size_t the number of arcs written(see render_dot() to draw the file).
+     */
+    size_t write_dot(std::ostream& out, const dot_options<T>& opt = {}) const {
+        return ::write_dot(out, csr_view(), opt);
+    }
+
     /**
      * @brief visualize function.
      * @returns .dot file that can be previewed in vscode with graphviz.
@@ -214,7 +346,7 @@ template <typename T> class graph {
      * @brief operator << for the graph class.
      * @returns ostream &out for std::cout.
      */
-    friend std::ostream& operator<<(std::ostream& out, graph<T>& g) {
+    friend std::ostream& operator<<(std::ostream& out, graph& g) {
         out << '{';
 
         std::vector<T> elements = g.topological_sort();
@@ -227,188 +359,187 @@ template <typename T> class graph {
 
   private:
     /**
-     * @param adj: adjacency list for the graph.
+     * @param adj: adjacency list for the graph, indexed by dense vertex id.
      * @param __elements: set of the total elements of the graph.
-     * @param __type: the type of the graph, either "directed" or "undirected".
+     * @param _ids: interning table between vertices and their dense ids.
+     * @param _directed: direction chosen at runtime, unused by the fixed policies.
+     * @param _csr: cached csr snapshot returned by csr_view().
+     * @param _ws: scratch buffers reused by the traversals.
      */
-    std::unordered_map<T, std::vector<T>> adj;
+    std::vector<std::vector<uint32_t>> adj;
     std::unordered_set<T> _elements;
-    std::string _type;
-
-    /**
-     *@brief helper function for bridge detection algorithm.
-     */
-    void dfs_bridge(T start, T parent, int64_t& time, std::unordered_map<T, bool>& visited,
-                    std::unordered_map<T, int64_t>& in, std::unordered_map<T, int64_t>& out,
-                    std::vector<std::vector<T>>& bridges) {
-        visited[start] = true;
-        in[start] = out[start] = time++;
-        for (T& x : adj[start]) {
-            if (x != parent) {
-                if (visited.find(x) == visited.end()) {
-                    dfs_bridge(x, start, time, visited, in, out, bridges);
-                    if (out[x] > in[start]) {
-                        bridges.push_back({x, start});
-                    }
-                }
-                out[start] = std::min(out[start], out[x]);
+    vertex_index<T> _ids;
+    bool _directed{false};
+    mutable std::shared_ptr<const csr_graph<T>> _csr;
+    graph_workspace _ws;
+
+    /**
+     * @brief direction of the graph, a constant for the fixed policies so that the
+     * branches on it fold away.
+     */
+    bool _is_directed() const {
+        if constexpr (std::is_same_v<Direction, runtime_direction>) {
+            return _directed;
+        } else {
+            return Direction::directed;
+        }
+    }
+
+    void _add_all(std::vector<std::pair<T, std::vector<T>>>& _adj) {
+        for (size_t i = 0; i < _adj.size(); i++) {
+            for (T& neigh : _adj[i].second) {
+                this->add_edge(_adj[i].first, neigh);
             }
         }
     }
 
     /**
-     * @brief helper dfs function for kosaraju's scc
+     * @brief interns key and allocates its adjacency list the first time it is seen.
      */
-    void dfs_scc(T start, std::unordered_map<T, bool>& visited, std::stack<T>& s) {
-        visited[start] = true;
-        for (auto& x : adj[start]) {
-            if (visited.find(x) == visited.end()) {
-                dfs_scc(x, visited, s);
-            }
+    uint32_t _intern(const T& key) {
+        uint32_t u = _ids.intern(key);
+        if (u == adj.size()) {
+            adj.emplace_back();
+            _elements.insert(key);
         }
-
-        s.push(start);
+        return u;
     }
+
+
 };
 
-template <typename T> size_t graph<T>::size() {
+template <typename T, typename Direction> size_t graph<T, Direction>::size() {
     return _elements.size();
 }
 
-template <typename T> std::vector<T> graph<T>::dfs(T start) {
+template <typename T, typename Direction> std::vector<T> graph<T, Direction>::dfs(T start) {
     std::vector<T> path;
-    if (this->empty() || _elements.find(start) == _elements.end()) {
+    uint32_t s = _ids.id(start);
+    if (this->empty() || s == vertex_index<T>::npos) {
         return path;
     }
-    std::stack<T> s;
-    std::unordered_map<T, bool> visited;
-    s.push(start);
-    visited[start] = true;
-    while (!s.empty()) {
-        T current = s.top();
-        path.push_back(current);
-        s.pop();
-        for (T& x : adj[current]) {
-            if (visited.find(x) == visited.end()) {
-                s.push(x);
-                visited[x] = true;
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& st = _ws.frontier();
+    st.push_back(s);
+    _ws.visit(s);
+    while (!st.empty()) {
+        uint32_t current = st.back();
+        path.push_back(_ids.vertex(current));
+        st.pop_back();
+        for (uint32_t x : adj[current]) {
+            if (_ws.try_visit(x)) {
+                st.push_back(x);
             }
         }
     }
     return path;
 }
 
-template <typename T> std::vector<T> graph<T>::bfs(T start) {
+template <typename T, typename Direction> std::vector<T> graph<T, Direction>::bfs(T start) {
     std::vector<T> path;
-    if (this->empty() || _elements.find(start) == _elements.end()) {
+    uint32_t s = _ids.id(start);
+    if (this->empty() || s == vertex_index<T>::npos) {
         return path;
     }
-    std::queue<T> q;
-    std::unordered_map<T, bool> visited;
-    q.push(start);
-    visited[start] = true;
-    while (!q.empty()) {
-        int64_t size = q.size();
-        for (int64_t i = 0; i < size; i++) {
-            T current = q.front();
-            path.push_back(current);
-            q.pop();
-            for (T& x : adj[current]) {
-                if (visited.find(x) == visited.end()) {
-                    q.push(x);
-                    visited[x] = true;
-                }
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& q = _ws.frontier();
+    q.push_back(s);
+    _ws.visit(s);
+    for (size_t head = 0; head < q.size(); head++) {
+        uint32_t current = q[head];
+        path.push_back(_ids.vertex(current));
+        for (uint32_t x : adj[current]) {
+            if (_ws.try_visit(x)) {
+                q.push_back(x);
             }
         }
     }
     return path;
 }
 
-template <typename T> int64_t graph<T>::connected_components() {
-    auto explore = [&](std::unordered_map<T, bool>& visited, T element) -> void {
-        std::queue<T> q;
-        q.push(element);
-        visited[element] = true;
-        while (!q.empty()) {
-            T current = q.front();
-            q.pop();
-            for (T& x : adj[current]) {
-                if (visited.find(x) == visited.end()) {
-                    q.push(x);
-                    visited[x] = true;
+template <typename T, typename Direction> int64_t graph<T, Direction>::connected_components() {
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& q = _ws.frontier();
+    auto explore = [&](uint32_t element) -> void {
+        q.assign(1, element);
+        _ws.visit(element);
+        for (size_t head = 0; head < q.size(); head++) {
+            for (uint32_t x : adj[q[head]]) {
+                if (_ws.try_visit(x)) {
+                    q.push_back(x);
                 }
             }
         }
     };
-    size_t n = _elements.size();
     int64_t cc = 0;
-    std::unordered_map<T, bool> visited;
-    for (T x : _elements) {
-        if (visited.find(x) == visited.end()) {
-            explore(visited, x);
+    for (const T& x : _elements) {
+        uint32_t u = _ids.id(x);
+        if (!_ws.visited(u)) {
+            explore(u);
             cc++;
         }
     }
     return cc;
 }
 
-template <typename T> bool graph<T>::cycle() {
-    std::unordered_map<T, int> indeg;
-    std::queue<T> q;
+template <typename T, typename Direction> bool graph<T, Direction>::cycle() {
+    _ws.begin(adj.size());
+    std::vector<int64_t>& indeg = _ws.in();
+    std::fill(indeg.begin(), indeg.end(), 0);
+    std::vector<uint32_t>& q = _ws.frontier();
     size_t visited = 0;
 
-    for (T x : _elements) {
-        for (T& y : adj[x]) {
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        for (uint32_t y : adj[x]) {
             indeg[y]++;
         }
     }
 
-    for (T x : _elements) {
+    for (uint32_t x = 0; x < adj.size(); x++) {
         if (indeg[x] == 0) {
-            q.push(x);
+            q.push_back(x);
         }
     }
 
-    while (!q.empty()) {
-        T current = q.front();
-        q.pop();
+    for (size_t head = 0; head < q.size(); head++) {
         visited++;
-        for (T& x : adj[current]) {
+        for (uint32_t x : adj[q[head]]) {
             if (--indeg[x] == 0) {
-                q.push(x);
+                q.push_back(x);
             }
         }
     }
     return visited == 0;
 }
 
-template <typename T> std::vector<T> graph<T>::topological_sort() {
+template <typename T, typename Direction> std::vector<T> graph<T, Direction>::topological_sort() {
     std::vector<T> top_sort;
-    std::unordered_map<T, bool> visited;
-    std::unordered_map<T, int64_t> indeg;
-    for (T x : _elements) {
-        for (T& y : adj[x]) {
+    _ws.begin(adj.size());
+    std::vector<int64_t>& indeg = _ws.in();
+    std::fill(indeg.begin(), indeg.end(), 0);
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        for (uint32_t y : adj[x]) {
             indeg[y]++;
         }
     }
 
-    std::queue<T> q;
-    for (T x : _elements) {
-        if (indeg[x] == 0) {
-            q.push(x);
-            visited[x] = true;
+    std::vector<uint32_t>& q = _ws.frontier();
+    for (const T& x : _elements) {
+        uint32_t u = _ids.id(x);
+        if (indeg[u] == 0) {
+            q.push_back(u);
+            _ws.visit(u);
         }
     }
 
-    while (!q.empty()) {
-        T current = q.front();
-        q.pop();
-        top_sort.push_back(current);
-        for (T& x : adj[current]) {
-            if (visited.find(x) == visited.end()) {
+    for (size_t head = 0; head < q.size(); head++) {
+        uint32_t current = q[head];
+        top_sort.push_back(_ids.vertex(current));
+        for (uint32_t x : adj[current]) {
+            if (!_ws.visited(x)) {
                 if (--indeg[x] == 0) {
-                    q.push(x);
-                    visited[x] = true;
+                    q.push_back(x);
+                    _ws.visit(x);
                 }
             }
         }
@@ -417,27 +548,28 @@ template <typename T> std::vector<T> graph<T>::topological_sort() {
     return top_sort;
 }
 
-template <typename T> bool graph<T>::bipartite() {
-    std::unordered_map<T, int> color;
-    std::queue<std::pair<T, int>> q;
-
-    for (T x : _elements) {
-        if (color.find(x) == color.end()) {
-            q.push({x, 0});
-            color[x] = 0;
-            while (!q.empty()) {
-                std::pair<T, int> current = q.front();
-                q.pop();
-                T v = current.first;
-                int col = current.second;
-                for (T& x : adj[v]) {
-                    if (color.find(x) != color.end() && color[x] == col) {
-                        return false;
-                    }
-                    if (color.find(x) == color.end()) {
-                        color[x] = (col) ? 0 : 1;
-                        q.push({x, color[x]});
-                    }
+template <typename T, typename Direction> bool graph<T, Direction>::bipartite() {
+    _ws.begin(adj.size());
+    std::vector<int64_t>& color = _ws.in();
+    std::vector<uint32_t>& q = _ws.frontier();
+
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        if (_ws.visited(x)) {
+            continue;
+        }
+        q.assign(1, x);
+        _ws.visit(x);
+        color[x] = 0;
+        for (size_t head = 0; head < q.size(); head++) {
+            uint32_t v = q[head];
+            int64_t col = color[v];
+            for (uint32_t y : adj[v]) {
+                if (_ws.visited(y) && color[y] == col) {
+                    return false;
+                }
+                if (_ws.try_visit(y)) {
+                    color[y] = (col) ? 0 : 1;
+                    q.push_back(y);
                 }
             }
         }
@@ -445,115 +577,66 @@ template <typename T> bool graph<T>::bipartite() {
     return true;
 }
 
-template <typename T> std::vector<std::vector<T>> graph<T>::bridge(T start) {
-    int64_t timer = 0;
-    std::vector<std::vector<T>> bridges;
-    std::unordered_map<T, bool> visited;
-    std::unordered_map<T, int64_t> in, out;
-    for (T x : _elements) {
-        in[x] = 0;
-        out[x] = 0;
-    }
-    dfs_bridge(start, -1, timer, visited, in, out, bridges);
-    return bridges;
+template <typename T, typename Direction>
+std::vector<std::vector<T>> graph<T, Direction>::bridge(T start) {
+    return csr_view().bridge(start);
 }
 
-template <typename T> bool graph<T>::connected() {
-    std::unordered_map<T, bool> visited;
-    bool check = 0;
-    T start;
-    for (auto& ele : adj) {
-        if (adj[ele.first].size() != 0) {
-            start = ele.first;
-            check = 1;
+template <typename T, typename Direction> bool graph<T, Direction>::connected() {
+    uint32_t start = vertex_index<T>::npos;
+    for (uint32_t u = 0; u < adj.size(); u++) {
+        if (adj[u].size() != 0) {
+            start = u;
             break;
         }
     }
-    if (!check) {
+    if (start == vertex_index<T>::npos) {
         return false;
     }
-    std::stack<T> s;
-    s.push(start);
-    visited[start] = true;
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& s = _ws.frontier();
+    s.push_back(start);
+    _ws.visit(start);
     while (!s.empty()) {
-        T current = s.top();
-        s.pop();
-        for (T& x : adj[current]) {
-            if (visited.find(x) == visited.end()) {
-                visited[x] = true;
-                s.push(x);
+        uint32_t current = s.back();
+        s.pop_back();
+        for (uint32_t x : adj[current]) {
+            if (_ws.try_visit(x)) {
+                s.push_back(x);
             }
         }
     }
 
-    for (T x : _elements) {
-        if (visited.find(x) == visited.end() && adj[x].size() > 0) {
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        if (!_ws.visited(x) && adj[x].size() > 0) {
             return false;
         }
     }
     return true;
 }
 
-template <typename T> int64_t graph<T>::scc() {
-    if (this->size() == 0) {
-        return 0;
-    }
-
-    std::unordered_map<T, bool> visited;
-    std::stack<T> s;
-
-    for (const T& x : _elements) {
-        if (visited.find(x) == visited.end()) {
-            dfs_scc(x, visited, s);
-        }
-    }
+template <typename T, typename Direction> int64_t graph<T, Direction>::scc() {
+    return static_cast<int64_t>(scc_labels().count);
+}
 
-    std::unordered_map<T, std::vector<T>> new_adj;
-    for (const T& x : _elements) {
-        for (const auto& neigh : adj[x]) {
-            new_adj[neigh].push_back(x);
-        }
+template <typename T, typename Direction>
+component_labels graph<T, Direction>::scc_labels(size_t threads) {
+    if (threads != 1) {
+        return parallel_scc(csr_view(), threads);
     }
-
-    int64_t scc = 0;
-    visited.clear();
-
-    auto dfs_new = [&](T start) -> void {
-        std::stack<T> _s;
-        _s.push(start);
-        visited[start] = true;
-        while (!_s.empty()) {
-            T current = _s.top();
-            _s.pop();
-            for (auto& x : new_adj[current]) {
-                if (visited.find(x) == visited.end()) {
-                    _s.push(x);
-                    visited[x] = true;
-                }
-            }
-        }
-    };
-
-    while (!s.empty()) {
-        T current = s.top();
-        s.pop();
-        if (visited.find(current) == visited.end()) {
-            dfs_new(current);
-            scc++;
-        }
-    }
-
-    return scc;
+    return tarjan_scc(
+        static_cast<uint32_t>(adj.size()), [this](uint32_t u) { return adj[u].size(); },
+        [this](uint32_t u, size_t i) { return adj[u][i]; });
 }
 
-template <typename T> int graph<T>::eulerian() {
+template <typename T, typename Direction> int graph<T, Direction>::eulerian() {
     if (this->connected() == false) {
         return false;
     }
 
     int64_t odd = 0;
-    for (auto& el : adj) {
-        if (adj[el.first].size() & 1) {
+    for (auto& neighbors : adj) {
+        if (neighbors.size() & 1) {
             odd++;
         }
     }
@@ -565,51 +648,26 @@ template <typename T> int graph<T>::eulerian() {
 }
 
 #ifdef ENABLE_GRAPH_VISUALIZATION
-template <typename T> void graph<T>::visualize() {
+template <typename T, typename Direction> void graph<T, Direction>::visualize() {
     std::string s;
-    if (_type == "directed") {
-        if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
-            for (auto& [element, neighbors] : adj) {
-                for (T& x : neighbors) {
-                    s += element;
-                    s += "->";
-                    s += x;
-                    s += '\n';
-                }
-            }
+    auto name = [&](uint32_t u) -> std::string {
+        if constexpr (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
+            return std::string() + _ids.vertex(u);
         } else {
-            for (auto& [element, neighbors] : adj) {
-                for (T& x : neighbors) {
-                    s += std::to_string(element);
-                    s += "->";
-                    s += std::to_string(x);
-                    s += '\n';
-                }
-            }
+            return std::to_string(_ids.vertex(u));
         }
-    } else {
-        if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
-            for (auto& [element, neighbors] : adj) {
-                for (T& x : neighbors) {
-                    s += element;
-                    s += "--";
-                    s += x;
-                    s += '\n';
-                }
-            }
-        } else {
-            for (auto& [element, neighbors] : adj) {
-                for (T& x : neighbors) {
-                    s += std::to_string(element);
-                    s += "--";
-                    s += std::to_string(x);
-                    s += '\n';
-                }
-            }
+    };
+    const std::string arrow = (_is_directed()) ? "->" : "--";
+    for (uint32_t element = 0; element < adj.size(); element++) {
+        for (uint32_t x : adj[element]) {
+            s += name(element);
+            s += arrow;
+            s += name(x);
+            s += '\n';
         }
     }
     s += '\n';
-    if (_type == "directed") {
+    if (_is_directed()) {
         digraph_visualization::visualize(s);
     } else {
         graph_visualization::visualize(s);
@@ -620,7 +678,7 @@ template <typename T> void graph<T>::visualize() {
 /**
  * @brief class for weighted graph
  */
-template <typename T> class weighted_graph {
+template <typename T, typename Direction> class weighted_graph {
   public:
     /**
      * @brief Constructor for weighted graph.
@@ -628,30 +686,41 @@ template <typename T> class weighted_graph {
      * @param __adj: vector<pair<pair<T,T>, int64_t>>, you can pass a vector of
      * pairs to construct the graph without doing multiple add_edge.
      */
-    weighted_graph(std::string _type, std::vector<std::pair<std::pair<T, T>, int64_t>> _adj = {}) {
+    weighted_graph(std::string _type, std::vector<std::pair<std::pair<T, T>, int64_t>> _adj = {})
+        requires std::is_same_v<Direction, runtime_direction>
+    {
         try {
             if (_type == "directed" || _type == "undirected") {
-                this->_type = _type;
+                this->_directed = _type == "directed";
             } else {
                 throw std::invalid_argument("Can't recognize the type of graph");
             }
-            if (!_adj.empty()) {
-                for (size_t i = 0; i < _adj.size(); i++) {
-                    this->add_edge(_adj[i].first.first, _adj[i].first.second, _adj[i].second);
-                }
-            }
+            _add_all(_adj);
         } catch (std::invalid_argument& e) {
             std::cerr << e.what() << '\n';
             return;
         }
     }
 
+    /**
+     * @brief Constructor for weighted graphs whose direction is fixed by the policy
+     * (see directed_weighted_graph and undirected_weighted_graph).
+     * @param __adj: vector<pair<pair<T,T>, int64_t>>, you can pass a vector of
+     * pairs to construct the graph without doing multiple add_edge.
+     */
+    explicit weighted_graph(std::vector<std::pair<std::pair<T, T>, int64_t>> _adj = {})
+        requires(!std::is_same_v<Direction, runtime_direction>)
+    {
+        _add_all(_adj);
+    }
+
     /**
      * @brief Copy constructor for weighted graph class
      * @param g the graph we want to copy
      */
     explicit weighted_graph(const weighted_graph& g)
-        : adj(g.adj), _elements(g._elements), _type(g._type) {}
+        : adj(g.adj), _directed(g._directed), _elements(g._elements), _ids(g._ids), _csr(g._csr),
+          _negative(g._negative) {}
 
     /**
      * @brief operator = for weighted graph class
@@ -661,7 +730,11 @@ template <typename T> class weighted_graph {
     weighted_graph& operator=(const weighted_graph& g) {
         adj = g.adj;
         _elements = g._elements;
-        _type = g._type;
+        _ids = g._ids;
+        _directed = g._directed;
+        _csr = g._csr;
+        _negative = g._negative;
+        _query.reset();
         return *this;
     }
 
@@ -678,14 +751,13 @@ template <typename T> class weighted_graph {
      * @param w: weight between u and v.
      */
     void add_edge(T u, T v, int64_t w) {
-        if (_type == "undirected") {
-            adj[u].push_back(std::make_pair(v, w));
-            adj[v].push_back(std::make_pair(u, w));
-        } else if (_type == "directed") {
-            adj[u].push_back(std::make_pair(v, w));
+        uint32_t a = _intern(u), b = _intern(v);
+        adj[a].push_back(std::make_pair(b, w));
+        if (!_is_directed()) {
+            adj[b].push_back(std::make_pair(a, w));
         }
-        _elements.insert(u);
-        _elements.insert(v);
+        _negative |= w < 0;
+        _invalidate();
     }
 
     /**
@@ -695,11 +767,12 @@ template <typename T> class weighted_graph {
      *@returns true if a direct edge from start to end exists.
      */
     bool has_edge(T start, T end) {
-        if (_elements.find(start) == _elements.end()) {
+        uint32_t s = _ids.id(start), e = _ids.id(end);
+        if (s == vertex_index<T>::npos || e == vertex_index<T>::npos) {
             return false;
         }
-        for (std::pair<T, double>& x : adj[start]) {
-            if (x.first == end) {
+        for (std::pair<uint32_t, double>& x : adj[s]) {
+            if (x.first == e) {
                 return true;
             }
         }
@@ -712,7 +785,10 @@ template <typename T> class weighted_graph {
      */
     void clear() {
         _elements.clear();
+        _ids.clear();
         adj.clear();
+        _negative = false;
+        _invalidate();
     }
     /**
      * @brief empty function.
@@ -748,6 +824,16 @@ template <typename T> class weighted_graph {
      */
     double shortest_path(T start, T end);
 
+    /**
+     * @brief sssp function.
+     * @param start: starting node.
+     * @param opt: thread count, delta-stepping bucket width and whether to build the
+     * shortest path tree(see sssp_options).
+     * @returns sssp_tree the distance and parent arrays indexed by the dense ids of
+     * csr_view(), empty arrays if start does not exist.
+     */
+    sssp_tree sssp(T start, const sssp_options& opt = {});
+
     /**
      * @brief connected_components function.
      * @returns the connected componenets(islands) of the graph.
@@ -773,6 +859,16 @@ template <typename T> class weighted_graph {
      */
     int64_t prim(T start);
 
+    /**
+     * @brief minimum_spanning_forest function.
+     * @param algo: kruskal(parallel sort + dsu) or boruvka(see mst_algorithm).
+     * @param threads: number of worker threads(0 means every hardware thread).
+     * @returns vector<tuple<T, T, double>>, the edges of a minimum spanning forest of the
+     * graph(one tree per connected component, edge directions are ignored).
+     */
+    std::vector<std::tuple<T, T, double>>
+    minimum_spanning_forest(mst_algorithm algo = mst_algorithm::kruskal, size_t threads = 1);
+
     /**
      * @brief bipartite function.
      * @returns true if the graph is bipartite.
@@ -782,16 +878,38 @@ template <typename T> class weighted_graph {
     /**
      *@brief bridge function.
      *@param start: starting point of search for the bridges.
-     *@returns vector<vector<T>> the bridges of the graph.
+     *@returns vector<vector<T>> the bridges reachable from start, found without
+     *recursion(see biconnected_components() for every component).
      */
     std::vector<std::vector<T>> bridge(T start);
 
+    /**
+     *@brief biconnected_components function.
+     *@param threads: 1 for an iterative hopcroft-tarjan, otherwise tarjan-vishkin on that
+     *many threads(0 means every hardware thread).
+     *@returns biconnected_result the biconnected component of every arc, the bridges and
+     *the articulation points of every connected component, indexed by the dense ids of
+     *csr_view().
+     */
+    biconnected_result biconnected_components(size_t threads = 1) {
+        return ::biconnected_components(csr_view(), threads);
+    }
+
     /**
      *@brief scc(strongly connected components) function.
      *@returns int64_t the total scc's of the graph.
      */
     int64_t scc();
 
+    /**
+     *@brief scc_labels function.
+     *@param threads: 1 runs an iterative tarjan, any other value runs parallel_scc() on
+     *csr_view() with that many threads(0 means every hardware thread).
+     *@returns component_labels the scc of every vertex indexed by the dense ids of
+     *csr_view(), and the scc count.
+     */
+    component_labels scc_labels(size_t threads = 1);
+
     /**
      *@brief connected function.
      *@returns true if a graph is connected.
@@ -812,13 +930,124 @@ template <typename T> class weighted_graph {
      */
     std::unordered_map<T, double> bellman_ford(T start);
 
+    /**
+     *@brief bellman_ford function.
+     *@param start: the source.
+     *@param mode: spfa or parallel relaxation rounds(see bellman_ford_mode).
+     *@param threads: number of worker threads of the parallel mode(0 means every hardware
+     *thread).
+     *@returns bellman_ford_result the distances indexed by the dense ids of csr_view(),
+     *-infinity behind negative cycles. Empty if start does not exist.
+     */
+    bellman_ford_result bellman_ford(T start, bellman_ford_mode mode, size_t threads = 1) {
+        const csr_graph<T>& c = csr_view();
+        uint32_t s = c.id(start);
+        if (s == csr_graph<T>::npos) {
+            return {};
+        }
+        return ::bellman_ford(c, s, mode, threads);
+    }
+
+    /**
+     *@brief all_pairs_shortest_paths function.
+     *@param threads: number of worker threads(0 means every hardware thread).
+     *@returns distance_matrix the distance between every pair of vertices, indexed by the
+     *dense ids of csr_view(). Dense graphs use the blocked floyd_warshall(), sparse ones
+     *use johnson().
+     */
+    distance_matrix all_pairs_shortest_paths(size_t threads = 1) {
+        const csr_graph<T>& c = csr_view();
+        if (c.arcs() * 16 >= c.size() * c.size()) {
+            return floyd_warshall(c, threads);
+        }
+        return johnson(c, threads);
+    }
+
     /**
      *@brief maximum flow function
      *@details Returns the maximum flow from a starting node 's' to an ending
-     *node(sink) 't'
-     *@returns int: the maximum flow from 's' to 't'
+     *node(sink) 't', edge weights are the capacities.
+     *@returns double: the maximum flow from 's' to 't'
      */
-    int max_flow(T start, T end);
+    double max_flow(T start, T end) { return csr_view().max_flow(start, end); }
+
+    /**
+     *@brief min_cut function
+     *@param start: the source.
+     *@param end: the sink.
+     *@param algo: dinic or push_relabel(see flow_network).
+     *@returns flow_result the maximum flow value and the source side of a minimum cut
+     *indexed by the dense ids of csr_view().
+     */
+    flow_result min_cut(T start, T end, flow_algorithm algo = flow_algorithm::dinic) {
+        return csr_view().min_cut(start, end, algo);
+    }
+
+    /**
+     * @brief freeze function
+     * @returns csr_graph<T> an immutable compressed-sparse-row snapshot of the graph.
+     * Later add_edge calls do not affect the returned snapshot.
+     */
+    csr_graph<T> freeze() const { return csr_graph<T>(_ids, adj, _is_directed()); }
+
+    /**
+     * @brief csr_view function
+     * @returns const csr_graph<T>& a cached snapshot of the graph, rebuilt only after
+     * the graph has been modified. The reference is invalidated by add_edge and clear.
+     */
+    const csr_graph<T>& csr_view() const {
+        if (_csr == nullptr) {
+            _csr = std::make_shared<const csr_graph<T>>(freeze());
+        }
+        return *_csr;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the vertices and the arcs, the nodes of the vertex set, the
+     * headers of the adjacency lists, the vertex tables and the cached csr snapshot as node
+     * overhead, the object with the headers of the arrays and the bucket table, the spare
+     * capacity and the scratch buffers of the traversals as slack.
+     * The buffers of shortest_path are left out
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_elements);
+        f.node_overhead += adj.size() * sizeof(adj[0]);
+        f.slack += (adj.capacity() - adj.size()) * sizeof(adj[0]);
+        f.control += adj.capacity() > 0 ? MEMORY::ALLOCATION_OVERHEAD : 0;
+        for (const auto& arcs : adj) {
+            f += MEMORY::heap_usage(arcs);
+        }
+        f += MEMORY::as_overhead(_ids.memory_usage());
+        if (_csr != nullptr) {
+            f += MEMORY::as_overhead(_csr->memory_usage());
+            f.control += MEMORY::SHARED_CONTROL + MEMORY::ALLOCATION_OVERHEAD;
+        }
+        f += _ws.memory_usage();
+        f.control += sizeof(*this) - sizeof(_ids) - sizeof(_ws);
+        return f;
+    }
+
+    /**
+     * @brief traverse function
+     * @param start: the first vertex.
+     * @param order: bfs or dfs(see traversal_order).
+     * @returns lazy_traversal<T> a traversal over csr_view() that expands vertices only
+     * when they are requested. Invalidated by add_edge and clear like csr_view().
+     */
+    lazy_traversal<T> traverse(T start, traversal_order order = traversal_order::bfs) const {
+        return lazy_traversal<T>(csr_view(), start, order);
+    }
+
+    /**
+     * @brief write_dot function
+     * @param out: the stream the DOT text is written to, edge by edge.
+     * @param opt: vertex sampling(all, uniform or ego network) and labels.
+     * @returns size_t the number of arcs written(see render_dot() to draw the file).
+     */
+    size_t write_dot(std::ostream& out, const dot_options<T>& opt = {}) const {
+        return ::write_dot(out, csr_view(), opt);
+    }
 
     /**
      *@brief visualize function.
@@ -830,7 +1059,7 @@ template <typename T> class weighted_graph {
      * @brief << operator for the weighted graph class.
      * @returns ostream &out for std::cout.
      */
-    friend std::ostream& operator<<(std::ostream& out, weighted_graph<T>& g) {
+    friend std::ostream& operator<<(std::ostream& out, weighted_graph& g) {
         out << '{';
         std::vector<T> elements = g.topological_sort();
         for (T& x : elements) {
@@ -842,250 +1071,276 @@ template <typename T> class weighted_graph {
 
   private:
     /**
-     * @param adj: adjacency list for the graph.
-     * @param __type: type of the graph, either "directed" or "undirected".
+     * @param adj: adjacency list for the graph, indexed by dense vertex id.
+     * @param _directed: direction chosen at runtime, unused by the fixed policies.
      * @param __elements: set of total elements of the graph.
+     * @param _ids: interning table between vertices and their dense ids.
+     * @param _csr: cached csr snapshot returned by csr_view().
+     * @param _ws: scratch buffers reused by the traversals.
+     * @param _negative: true if any edge has a negative weight.
+     * @param _query: point to point search over _csr reused by shortest_path.
      */
-    std::unordered_map<T, std::vector<std::pair<T, double>>> adj;
-    std::string _type;
+    std::vector<std::vector<std::pair<uint32_t, double>>> adj;
+    bool _directed{false};
     std::unordered_set<T> _elements;
+    vertex_index<T> _ids;
+    mutable std::shared_ptr<const csr_graph<T>> _csr;
+    graph_workspace _ws;
+    bool _negative{false};
+    std::unique_ptr<shortest_path_query<T>> _query;
 
     /**
-     *@brief helper function for bridge detection algorithm.
+     * @brief drops the cached snapshot and everything built on top of it.
      */
-    void dfs_bridge(T start, T parent, int64_t& time, std::unordered_map<T, bool>& visited,
-                    std::unordered_map<T, int64_t>& in, std::unordered_map<T, int64_t>& out,
-                    std::vector<std::vector<T>>& bridges) {
-        visited[start] = true;
-        in[start] = out[start] = time++;
-        for (std::pair<T, double>& x : adj[start]) {
-            if (x.first != parent) {
-                if (visited.find(x.first) == visited.end()) {
-                    dfs_bridge(x.first, start, time, visited, in, out, bridges);
-                    if (out[x.first] > in[start]) {
-                        bridges.push_back({x.first, start});
-                    }
-                }
-                out[start] = std::min(out[start], out[x.first]);
-            }
-        }
+    void _invalidate() {
+        _query.reset();
+        _csr.reset();
     }
 
     /**
-     * @brief helper dfs function for kosaraju's scc
+     * @brief direction of the graph, a constant for the fixed policies.
      */
-    void dfs_scc(T start, std::unordered_map<T, bool>& visited, std::stack<T>& s) {
-        visited[start] = true;
-        for (auto& x : adj[start]) {
-            if (visited.find(x.first) == visited.end()) {
-                dfs_scc(x.first, visited, s);
-            }
+    bool _is_directed() const {
+        if constexpr (std::is_same_v<Direction, runtime_direction>) {
+            return _directed;
+        } else {
+            return Direction::directed;
+        }
+    }
+
+    void _add_all(std::vector<std::pair<std::pair<T, T>, int64_t>>& _adj) {
+        for (size_t i = 0; i < _adj.size(); i++) {
+            this->add_edge(_adj[i].first.first, _adj[i].first.second, _adj[i].second);
         }
+    }
 
-        s.push(start);
+    /**
+     * @brief interns key and allocates its adjacency list the first time it is seen.
+     */
+    uint32_t _intern(const T& key) {
+        uint32_t u = _ids.intern(key);
+        if (u == adj.size()) {
+            adj.emplace_back();
+            _elements.insert(key);
+        }
+        return u;
     }
+
+
 };
 
-template <typename T> size_t weighted_graph<T>::size() {
+template <typename T, typename Direction> size_t weighted_graph<T, Direction>::size() {
     return _elements.size();
 }
 
-template <typename T> double weighted_graph<T>::shortest_path(T start, T end) {
-    if (_elements.find(start) == _elements.end()) {
+template <typename T, typename Direction>
+double weighted_graph<T, Direction>::shortest_path(T start, T end) {
+    uint32_t s = _ids.id(start), t = _ids.id(end);
+    if (s == vertex_index<T>::npos) {
         std::cout << "Element: " << start << " is not found in the Graph" << '\n';
         return -1;
     }
-    if (_elements.find(end) == _elements.end()) {
+    if (t == vertex_index<T>::npos) {
         std::cout << "Element: " << end << " is not found in the Graph" << '\n';
         return -1;
     }
 
-    if (!cycle() && _type == "directed") {
+    // without negative weights dijkstra is exact on every graph, so skip the cycle check
+    // and the O(V) setup with the reusable bidirectional search
+    if (!_negative) {
+        if (_query == nullptr) {
+            _query = std::make_unique<shortest_path_query<T>>(csr_view());
+        }
+        return _query->distance_id(s, t);
+    }
+
+    const double inf = std::numeric_limits<int64_t>::max();
+    std::vector<double> dist(adj.size(), inf);
+    dist[s] = 0;
+    if (!cycle() && _is_directed()) {
         std::vector<T> top_sort = topological_sort();
-        std::reverse(top_sort.begin(), top_sort.end());
-        std::stack<T> s;
-        std::unordered_map<T, double> dist;
-        for (auto& x : _elements) {
-            dist[x] = std::numeric_limits<int64_t>::max();
-        }
-        dist[start] = 0;
-        while (!top_sort.empty()) {
-            auto current = top_sort.back();
-            top_sort.pop_back();
-            if (dist[current] != std::numeric_limits<int64_t>::max()) {
-                for (std::pair<T, double>& x : adj[current]) {
+        std::vector<uint32_t> order;
+        order.reserve(top_sort.size());
+        for (auto it = top_sort.rbegin(); it != top_sort.rend(); it++) {
+            order.push_back(_ids.id(*it));
+        }
+        while (!order.empty()) {
+            uint32_t current = order.back();
+            order.pop_back();
+            if (dist[current] != inf) {
+                for (std::pair<uint32_t, double>& x : adj[current]) {
                     if (dist[x.first] > dist[current] + x.second) {
                         dist[x.first] = dist[current] + x.second;
-                        top_sort.push_back(x.first);
+                        order.push_back(x.first);
                     }
                 }
             }
         }
-        return (dist[end] != std::numeric_limits<int64_t>::max()) ? dist[end] : -1;
+        return (dist[t] != inf) ? dist[t] : -1;
     } else {
-        std::unordered_map<T, double> dist;
-        for (auto& x : _elements) {
-            dist[x] = std::numeric_limits<int64_t>::max();
-        }
-        std::priority_queue<std::pair<double, T>, std::vector<std::pair<double, T>>,
-                            std::greater<std::pair<double, T>>>
-            pq;
-        pq.push(std::make_pair(0, start));
-        dist[start] = 0;
+        // a vertex whose distance drops after it was popped(negative arcs) is pushed again
+        indexed_heap<double> pq(adj.size());
+        pq.push(s, 0);
         while (!pq.empty()) {
-            T currentNode = pq.top().second;
-            double currentDist = pq.top().first;
-            pq.pop();
-            for (std::pair<T, double>& edge : adj[currentNode]) {
+            uint32_t currentNode = pq.pop();
+            double currentDist = dist[currentNode];
+            for (std::pair<uint32_t, double>& edge : adj[currentNode]) {
                 if (currentDist + edge.second < dist[edge.first]) {
                     dist[edge.first] = currentDist + edge.second;
-                    pq.push(std::make_pair(dist[edge.first], edge.first));
+                    pq.push(edge.first, dist[edge.first]);
                 }
             }
         }
-        return (dist[end] != std::numeric_limits<int64_t>::max()) ? dist[end] : -1;
+        return (dist[t] != inf) ? dist[t] : -1;
     }
     return -1;
 }
 
-template <typename T> std::vector<T> weighted_graph<T>::dfs(T start) {
+template <typename T, typename Direction>
+sssp_tree weighted_graph<T, Direction>::sssp(T start, const sssp_options& opt) {
+    uint32_t s = _ids.id(start);
+    if (s == vertex_index<T>::npos) {
+        std::cout << "Element: " << start << " is not found in the Graph" << '\n';
+        return {};
+    }
+    return ::sssp(csr_view(), s, opt);
+}
+
+template <typename T, typename Direction>
+std::vector<T> weighted_graph<T, Direction>::dfs(T start) {
 
     std::vector<T> path;
-    if (this->empty() || _elements.find(start) == _elements.end()) {
+    uint32_t s = _ids.id(start);
+    if (this->empty() || s == vertex_index<T>::npos) {
         return path;
     }
-    std::stack<T> s;
-    std::unordered_map<T, bool> visited;
-    s.push(start);
-    visited[start] = true;
-    while (!s.empty()) {
-        int64_t size = s.size();
-        for (int64_t i = 0; i < size; i++) {
-            T current = s.top();
-            path.push_back(current);
-            s.pop();
-            for (std::pair<T, double>& x : adj[current]) {
-                if (visited.find(x.first) == visited.end()) {
-                    s.push(x.first);
-                    visited[x.first] = true;
-                }
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& st = _ws.frontier();
+    st.push_back(s);
+    _ws.visit(s);
+    while (!st.empty()) {
+        uint32_t current = st.back();
+        path.push_back(_ids.vertex(current));
+        st.pop_back();
+        for (std::pair<uint32_t, double>& x : adj[current]) {
+            if (_ws.try_visit(x.first)) {
+                st.push_back(x.first);
             }
         }
     }
     return path;
 }
 
-template <typename T> std::vector<T> weighted_graph<T>::bfs(T start) {
+template <typename T, typename Direction>
+std::vector<T> weighted_graph<T, Direction>::bfs(T start) {
     std::vector<T> path;
-    if (this->empty() || _elements.find(start) == _elements.end()) {
+    uint32_t s = _ids.id(start);
+    if (this->empty() || s == vertex_index<T>::npos) {
         return path;
     }
-    std::queue<T> q;
-    std::unordered_map<T, bool> visited;
-    q.push(start);
-    visited[start] = true;
-    while (!q.empty()) {
-        int64_t size = q.size();
-        for (int64_t i = 0; i < size; i++) {
-            T current = q.front();
-            path.push_back(current);
-            q.pop();
-            for (std::pair<T, double>& x : adj[current]) {
-                if (visited.find(x.first) == visited.end()) {
-                    q.push(x.first);
-                    visited[x.first] = true;
-                }
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& q = _ws.frontier();
+    q.push_back(s);
+    _ws.visit(s);
+    for (size_t head = 0; head < q.size(); head++) {
+        uint32_t current = q[head];
+        path.push_back(_ids.vertex(current));
+        for (std::pair<uint32_t, double>& x : adj[current]) {
+            if (_ws.try_visit(x.first)) {
+                q.push_back(x.first);
             }
         }
     }
     return path;
 }
 
-template <typename T> int64_t weighted_graph<T>::connected_components() {
-    auto explore = [&](std::unordered_map<T, bool>& visited, T element) -> void {
-        std::stack<T> s;
-        s.push(element);
-        visited[element] = true;
+template <typename T, typename Direction>
+int64_t weighted_graph<T, Direction>::connected_components() {
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& s = _ws.frontier();
+    auto explore = [&](uint32_t element) -> void {
+        s.assign(1, element);
+        _ws.visit(element);
         while (!s.empty()) {
-            T current = s.top();
-            s.pop();
-            for (std::pair<T, double>& x : adj[current]) {
-                if (visited.find(x.first) == visited.end()) {
-                    s.push(x.first);
-                    visited[x.first] = true;
+            uint32_t current = s.back();
+            s.pop_back();
+            for (std::pair<uint32_t, double>& x : adj[current]) {
+                if (_ws.try_visit(x.first)) {
+                    s.push_back(x.first);
                 }
             }
         }
     };
-    size_t n = _elements.size();
     int64_t cc = 0;
-    std::unordered_map<T, bool> visited;
-    for (T x : _elements) {
-        if (visited.find(x) == visited.end()) {
-            explore(visited, x);
+    for (const T& x : _elements) {
+        uint32_t u = _ids.id(x);
+        if (!_ws.visited(u)) {
+            explore(u);
             cc++;
         }
     }
     return cc;
 }
 
-template <typename T> bool weighted_graph<T>::cycle() {
-    std::unordered_map<T, int> indeg;
-    std::queue<T> q;
+template <typename T, typename Direction> bool weighted_graph<T, Direction>::cycle() {
+    _ws.begin(adj.size());
+    std::vector<int64_t>& indeg = _ws.in();
+    std::fill(indeg.begin(), indeg.end(), 0);
+    std::vector<uint32_t>& q = _ws.frontier();
     size_t visited = 0;
 
-    for (T x : _elements) {
-        for (std::pair<T, double>& y : adj[x]) {
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        for (std::pair<uint32_t, double>& y : adj[x]) {
             indeg[y.first]++;
         }
     }
 
-    for (T x : _elements) {
+    for (uint32_t x = 0; x < adj.size(); x++) {
         if (indeg[x] == 0) {
-            q.push(x);
+            q.push_back(x);
         }
     }
 
-    while (!q.empty()) {
-        T current = q.front();
-        q.pop();
+    for (size_t head = 0; head < q.size(); head++) {
         visited++;
-        for (std::pair<T, double>& x : adj[current]) {
+        for (std::pair<uint32_t, double>& x : adj[q[head]]) {
             if (--indeg[x.first] == 0) {
-                q.push(x.first);
+                q.push_back(x.first);
             }
         }
     }
     return visited == 0;
 }
 
-template <typename T> std::vector<T> weighted_graph<T>::topological_sort() {
+template <typename T, typename Direction>
+std::vector<T> weighted_graph<T, Direction>::topological_sort() {
     std::vector<T> top_sort;
-    std::unordered_map<T, bool> visited;
-    std::unordered_map<T, int64_t> indeg;
-    for (T x : _elements) {
-        for (std::pair<T, double>& y : adj[x]) {
+    _ws.begin(adj.size());
+    std::vector<int64_t>& indeg = _ws.in();
+    std::fill(indeg.begin(), indeg.end(), 0);
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        for (std::pair<uint32_t, double>& y : adj[x]) {
             indeg[y.first]++;
         }
     }
 
-    std::queue<T> q;
-    for (T x : _elements) {
-        if (indeg[x] == 0) {
-            q.push(x);
-            visited[x] = true;
+    std::vector<uint32_t>& q = _ws.frontier();
+    for (const T& x : _elements) {
+        uint32_t u = _ids.id(x);
+        if (indeg[u] == 0) {
+            q.push_back(u);
+            _ws.visit(u);
         }
     }
 
-    while (!q.empty()) {
-        T current = q.front();
-        q.pop();
-        top_sort.push_back(current);
-        for (std::pair<T, double>& x : adj[current]) {
-            if (visited.find(x.first) == visited.end()) {
+    for (size_t head = 0; head < q.size(); head++) {
+        uint32_t current = q[head];
+        top_sort.push_back(_ids.vertex(current));
+        for (std::pair<uint32_t, double>& x : adj[current]) {
+            if (!_ws.visited(x.first)) {
                 if (--indeg[x.first] == 0) {
-                    q.push(x.first);
-                    visited[x.first] = true;
+                    q.push_back(x.first);
+                    _ws.visit(x.first);
                 }
             }
         }
@@ -1094,52 +1349,64 @@ template <typename T> std::vector<T> weighted_graph<T>::topological_sort() {
     return top_sort;
 }
 
-template <typename T> int64_t weighted_graph<T>::prim(T _temp) {
-    std::priority_queue<std::pair<T, int64_t>, std::vector<std::pair<T, int64_t>>,
-                        std::greater<std::pair<T, int64_t>>>
-        q;
-    std::unordered_map<T, bool> visited;
-    int64_t cost = 0;
-    q.push(std::make_pair(0, _temp));
+template <typename T, typename Direction> int64_t weighted_graph<T, Direction>::prim(T _temp) {
+    uint32_t s = _ids.id(_temp);
+    if (s == vertex_index<T>::npos) {
+        return 0;
+    }
+    // key of a vertex: the lightest edge joining it to the tree
+    indexed_heap<double> q(adj.size());
+    _ws.begin(adj.size());
+    double cost = 0;
+    q.push(s, 0);
     while (!q.empty()) {
-        std::pair<T, int64_t> current = q.top();
-        q.pop();
-        _temp = current.first;
-        if (visited.find(_temp) != visited.end()) {
-            continue;
-        }
-        cost += current.second;
-        visited[_temp] = true;
-        for (std::pair<T, double>& x : adj[current.first]) {
-            if (visited.find(x.first) == visited.end()) {
-                q.push(x);
+        cost += q.top_key();
+        uint32_t current = q.pop();
+        _ws.visit(current);
+        for (std::pair<uint32_t, double>& x : adj[current]) {
+            if (!_ws.visited(x.first)) {
+                q.push(x.first, x.second);
             }
         }
     }
-    return cost;
+    return static_cast<int64_t>(cost);
 }
 
-template <typename T> bool weighted_graph<T>::bipartite() {
-    std::unordered_map<T, int> color;
-    std::queue<std::pair<T, int>> q;
-
-    for (T x : _elements) {
-        if (color.find(x) == color.end()) {
-            q.push({x, 0});
-            color[x] = 0;
-            while (!q.empty()) {
-                std::pair<T, int> current = q.front();
-                q.pop();
-                T v = current.first;
-                int col = current.second;
-                for (std::pair<T, double>& x : adj[v]) {
-                    if (color.find(x.first) != color.end() && color[x.first] == col) {
-                        return false;
-                    }
-                    if (color.find(x.first) == color.end()) {
-                        color[x.first] = (col) ? 0 : 1;
-                        q.push({x.first, color[x.first]});
-                    }
+template <typename T, typename Direction>
+std::vector<std::tuple<T, T, double>>
+weighted_graph<T, Direction>::minimum_spanning_forest(mst_algorithm algo, size_t threads) {
+    const csr_graph<T>& c = csr_view();
+    spanning_forest forest = ::minimum_spanning_forest(c, algo, threads);
+    std::vector<std::tuple<T, T, double>> edges;
+    edges.reserve(forest.edges.size());
+    for (const forest_edge& e : forest.edges) {
+        edges.emplace_back(c.vertex(e.u), c.vertex(e.v), e.w);
+    }
+    return edges;
+}
+
+template <typename T, typename Direction> bool weighted_graph<T, Direction>::bipartite() {
+    _ws.begin(adj.size());
+    std::vector<int64_t>& color = _ws.in();
+    std::vector<uint32_t>& q = _ws.frontier();
+
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        if (_ws.visited(x)) {
+            continue;
+        }
+        q.assign(1, x);
+        _ws.visit(x);
+        color[x] = 0;
+        for (size_t head = 0; head < q.size(); head++) {
+            uint32_t v = q[head];
+            int64_t col = color[v];
+            for (std::pair<uint32_t, double>& y : adj[v]) {
+                if (_ws.visited(y.first) && color[y.first] == col) {
+                    return false;
+                }
+                if (_ws.try_visit(y.first)) {
+                    color[y.first] = (col) ? 0 : 1;
+                    q.push_back(y.first);
                 }
             }
         }
@@ -1147,115 +1414,66 @@ template <typename T> bool weighted_graph<T>::bipartite() {
     return true;
 }
 
-template <typename T> std::vector<std::vector<T>> weighted_graph<T>::bridge(T start) {
-    int64_t timer = 0;
-    std::vector<std::vector<T>> bridges;
-    std::unordered_map<T, bool> visited;
-    std::unordered_map<T, int64_t> in, out;
-    for (T x : _elements) {
-        in[x] = 0;
-        out[x] = 0;
-    }
-    dfs_bridge(start, -1, timer, visited, in, out, bridges);
-    return bridges;
+template <typename T, typename Direction>
+std::vector<std::vector<T>> weighted_graph<T, Direction>::bridge(T start) {
+    return csr_view().bridge(start);
 }
 
-template <typename T> int64_t weighted_graph<T>::scc() {
-    if (this->size() == 0) {
-        return 0;
-    }
-
-    std::unordered_map<T, bool> visited;
-    std::stack<T> s;
-
-    for (const T& x : _elements) {
-        if (visited.find(x) == visited.end()) {
-            dfs_scc(x, visited, s);
-        }
-    }
-
-    std::unordered_map<T, std::vector<T>> new_adj;
-    for (const T& x : _elements) {
-        for (const auto& neigh : adj[x]) {
-            new_adj[neigh.first].push_back(x);
-        }
-    }
-
-    int64_t scc = 0;
-    visited.clear();
-
-    auto dfs_new = [&](T start) -> void {
-        std::stack<T> _s;
-        _s.push(start);
-        visited[start] = true;
-        while (!_s.empty()) {
-            T current = _s.top();
-            _s.pop();
-            for (auto& x : new_adj[current]) {
-                if (visited.find(x) == visited.end()) {
-                    _s.push(x);
-                    visited[x] = true;
-                }
-            }
-        }
-    };
+template <typename T, typename Direction> int64_t weighted_graph<T, Direction>::scc() {
+    return static_cast<int64_t>(scc_labels().count);
+}
 
-    while (!s.empty()) {
-        T current = s.top();
-        s.pop();
-        if (visited.find(current) == visited.end()) {
-            dfs_new(current);
-            scc++;
-        }
+template <typename T, typename Direction>
+component_labels weighted_graph<T, Direction>::scc_labels(size_t threads) {
+    if (threads != 1) {
+        return parallel_scc(csr_view(), threads);
     }
-
-    return scc;
+    return tarjan_scc(
+        static_cast<uint32_t>(adj.size()), [this](uint32_t u) { return adj[u].size(); },
+        [this](uint32_t u, size_t i) { return adj[u][i].first; });
 }
 
-template <typename T> bool weighted_graph<T>::connected() {
-    std::unordered_map<T, bool> visited;
-    bool check = 0;
-    T start;
-    for (auto& ele : adj) {
-        if (adj[ele.first].size() != 0) {
-            start = ele.first;
-            check = 1;
+template <typename T, typename Direction> bool weighted_graph<T, Direction>::connected() {
+    uint32_t start = vertex_index<T>::npos;
+    for (uint32_t u = 0; u < adj.size(); u++) {
+        if (adj[u].size() != 0) {
+            start = u;
             break;
         }
     }
-    if (!check) {
+    if (start == vertex_index<T>::npos) {
         return false;
     }
-    std::stack<T> s;
-    s.push(start);
-    visited[start] = true;
+    _ws.begin(adj.size());
+    std::vector<uint32_t>& s = _ws.frontier();
+    s.push_back(start);
+    _ws.visit(start);
     while (!s.empty()) {
-        T current = s.top();
-        s.pop();
-        for (std::pair<T, double>& x : adj[current]) {
-            if (visited.find(x.first) == visited.end()) {
-                visited[x.first] = true;
-                s.push(x.first);
+        uint32_t current = s.back();
+        s.pop_back();
+        for (std::pair<uint32_t, double>& x : adj[current]) {
+            if (_ws.try_visit(x.first)) {
+                s.push_back(x.first);
             }
         }
     }
 
-    for (T x : _elements) {
-        if (visited.find(x) == visited.end() && adj[x].size() > 0) {
+    for (uint32_t x = 0; x < adj.size(); x++) {
+        if (!_ws.visited(x) && adj[x].size() > 0) {
             return false;
         }
     }
     return true;
 }
 
-template <typename T> int weighted_graph<T>::eulerian() {
+template <typename T, typename Direction> int weighted_graph<T, Direction>::eulerian() {
     if (this->connected() == false) {
         return false;
     }
 
     int odd = 0;
-    for (auto& el : adj) {
-        if (adj[el.first].size() & 1) {
+    for (auto& neighbors : adj) {
+        if (neighbors.size() & 1) {
             odd++;
         }
     }
@@ -1267,115 +1485,48 @@ template <typename T> int weighted_graph<T>::eulerian() {
     return (odd) ? 1 : 2;
 }
 
-template <typename T> std::unordered_map<T, double> weighted_graph<T>::bellman_ford(T start) {
-    std::unordered_map<T, double> dist;
-    // Initialize the distance to all nodes to be infinity
-    // except for the starting node which is zero.
-    for (auto it : adj) {
-        dist[it.first] = std::numeric_limits<double>::infinity();
-    }
-    dist[start] = 0;
-
-    // Get number of vertices present in the graph
-    int v = adj.size();
-
-    // For each vertex, apply relaxation for all the edges
-    for (int i = 0; i < v - 1; i++) {
-        for (const auto j : adj) {
-            for (const auto edge : adj[j.first]) {
-                if (dist[j.first] + edge.second < dist[edge.first]) {
-                    dist[edge.first] = dist[j.first] + edge.second;
-                }
-            }
-        }
+template <typename T, typename Direction>
+std::unordered_map<T, double> weighted_graph<T, Direction>::bellman_ford(T start) {
+    std::unordered_map<T, double> result;
+    const csr_graph<T>& c = csr_view();
+    uint32_t s = c.id(start);
+    if (s == csr_graph<T>::npos) {
+        return result;
     }
-
-    // Run algorithm a second time to detect which nodes are part
-    // of a negative cycle. A negative cycle has occurred if we
-    // can find a better path beyond the optimal solution.
-    for (int i = 0; i < v - 1; i++) {
-        for (const auto j : adj) {
-            for (const auto edge : adj[j.first]) {
-                if (dist[j.first] + edge.second < dist[edge.first]) {
-                    dist[edge.first] = -std::numeric_limits<double>::infinity();
-                }
-            }
-        }
+    std::vector<double> dist = ::bellman_ford(c, s).dist;
+    result.reserve(dist.size());
+    for (uint32_t j = 0; j < dist.size(); j++) {
+        result[c.vertex(j)] = dist[j];
     }
-
-    // Return the array containing the shortest distance to every node
-    return dist;
+    return result;
 }
 
 #ifdef ENABLE_GRAPH_VISUALIZATION
-template <typename T> void weighted_graph<T>::visualize() {
+template <typename T, typename Direction> void weighted_graph<T, Direction>::visualize() {
     std::string s;
-    if (_type == "directed") {
-        if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
-            for (auto& [element, neighbors] : adj) {
-                for (std::pair<T, double>& x : neighbors) {
-                    if (x.first == element) {
-                        continue;
-                    }
-                    s += element;
-                    s += "->";
-                    s += x.first;
-                    s += "[label=";
-                    s += std::to_string(x.second);
-                    s += "]";
-                    s += '\n';
-                }
-            }
+    auto name = [&](uint32_t u) -> std::string {
+        if constexpr (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
+            return std::string() + _ids.vertex(u);
         } else {
-            for (auto& [element, neighbors] : adj) {
-                for (std::pair<T, double>& x : neighbors) {
-                    if (x.first == element) {
-                        continue;
-                    }
-                    s += std::to_string(element);
-                    s += "->";
-                    s += std::to_string(x.first);
-                    s += "[label=";
-                    s += std::to_string(x.second);
-                    s += "]";
-                    s += '\n';
-                }
-            }
+            return std::to_string(_ids.vertex(u));
         }
-    } else {
-        if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
-            for (auto& [element, neighbors] : adj) {
-                for (std::pair<T, double>& x : neighbors) {
-                    if (x.first == element) {
-                        continue;
-                    }
-                    s += element;
-                    s += "--";
-                    s += x.first;
-                    s += "[label=";
-                    s += std::to_string(x.second);
-                    s += "]";
-                    s += '\n';
-                }
-            }
-        } else {
-            for (auto& [element, neighbors] : adj) {
-                for (std::pair<T, double>& x : neighbors) {
-                    if (x.first == element) {
-                        continue;
-                    }
-                    s += std::to_string(element);
-                    s += "--";
-                    s += std::to_string(x.first);
-                    s += "[label=";
-                    s += std::to_string(x.second);
-                    s += "]";
-                    s += '\n';
-                }
+    };
+    const std::string arrow = (_is_directed()) ? "->" : "--";
+    for (uint32_t element = 0; element < adj.size(); element++) {
+        for (std::pair<uint32_t, double>& x : adj[element]) {
+            if (x.first == element) {
+                continue;
             }
+            s += name(element);
+            s += arrow;
+            s += name(x.first);
+            s += "[label=";
+            s += std::to_string(x.second);
+            s += "]";
+            s += '\n';
         }
     }
-    if (_type == "directed") {
+    if (_is_directed()) {
         digraph_visualization::visualize(s);
     } else {
         graph_visualization::visualize(s);
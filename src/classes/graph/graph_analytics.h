@@ -0,0 +1,299 @@
+#ifndef GRAPH_ANALYTICS_H
+#define GRAPH_ANALYTICS_H
+
+#include "../../helpers/parallel.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief options of pagerank()
+ * @param damping: probability of following an arc instead of jumping to a random vertex.
+ * @param tolerance: the iteration stops once the L1 change of the ranks is below it.
+ * @param max_iterations: upper bound on the number of iterations.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ */
+struct pagerank_options {
+    double damping{0.85};
+    double tolerance{1e-9};
+    size_t max_iterations{100};
+    size_t threads{0};
+};
+
+namespace _analytics_utils {
+/**
+ * @brief csr arrays of the simple undirected graph under g: directions dropped, self
+ * loops and parallel arcs removed, every list sorted
+ */
+struct simple_graph {
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> targets;
+
+    size_t degree(uint32_t u) const { return offsets[u + 1] - offsets[u]; }
+};
+
+template <typename T> simple_graph simplify(const csr_graph<T>& g, size_t threads) {
+    const size_t n = g.size();
+    simple_graph s;
+    s.offsets.assign(n + 1, 0);
+    std::vector<uint32_t> raw;
+    std::vector<size_t> start(n + 1, 0);
+    for (uint32_t u = 0; u < n; u++) {
+        start[u + 1] = start[u] + g.degree(u);
+    }
+    if (g.directed()) {
+        csr_graph<T> t = g.transpose();
+        for (uint32_t u = 0; u < n; u++) {
+            start[u + 1] += t.offsets()[u + 1];
+        }
+        raw.resize(start[n]);
+        PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t u = lo; u < hi; u++) {
+                std::span<const uint32_t> out = g.neighbors(u), in = t.neighbors(u);
+                std::copy(in.begin(), in.end(),
+                          std::copy(out.begin(), out.end(), raw.begin() + start[u]));
+            }
+        });
+    } else {
+        raw = g.targets();
+    }
+    std::vector<size_t> kept(n + 1, 0);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            auto first = raw.begin() + start[u], last = raw.begin() + start[u + 1];
+            std::sort(first, last);
+            last = std::unique(first, last);
+            last = std::remove(first, last, static_cast<uint32_t>(u));
+            kept[u + 1] = static_cast<size_t>(last - first);
+        }
+    });
+    for (size_t u = 0; u < n; u++) {
+        s.offsets[u + 1] = s.offsets[u] + kept[u + 1];
+    }
+    s.targets.resize(s.offsets[n]);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            std::copy_n(raw.begin() + start[u], kept[u + 1], s.targets.begin() + s.offsets[u]);
+        }
+    });
+    return s;
+}
+
+/**
+ * @brief size of the intersection of two sorted lists without duplicates. With AVX2
+ * blocks of 8 are compared against every rotation of the other block.
+ */
+inline size_t intersect(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+    size_t i = 0, j = 0, count = 0;
+#if defined(__AVX2__)
+    const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i eq = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+        }
+        count += static_cast<size_t>(
+            __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(eq))));
+        uint32_t amax = a[i + 7], bmax = b[j + 7];
+        i += amax <= bmax ? 8 : 0;
+        j += bmax <= amax ? 8 : 0;
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            count++, i++, j++;
+        }
+    }
+    return count;
+}
+} // namespace _analytics_utils
+
+/**
+ * @brief pagerank function
+ * Pull based power iteration: every vertex sums the contributions of its in-neighbors,
+ * so each iteration is one sparse matrix vector product without atomics. The rank of
+ * vertices without out-arcs is spread over every vertex. Undirected snapshots use every
+ * edge in both directions.
+ * @param g: the snapshot(see graph<T>::csr_view()).
+ * @param opt: damping, tolerance, iteration limit and threads.
+ * @returns vector<double> the rank of every dense id, the ranks sum to 1.
+ */
+template <typename T>
+std::vector<double> pagerank(const csr_graph<T>& g, const pagerank_options& opt = {}) {
+    const size_t n = g.size();
+    if (n == 0) {
+        return {};
+    }
+    csr_graph<T> transposed;
+    if (g.directed()) {
+        transposed = g.transpose();
+    }
+    const csr_graph<T>& in = g.directed() ? transposed : g;
+    const size_t threads = PARALLEL::resolve_threads(opt.threads, n);
+    std::vector<double> rank(n, 1.0 / n), next(n, 0), contrib(n, 0);
+    std::vector<double> dangling(threads), change(threads);
+
+    for (size_t it = 0; it < opt.max_iterations; it++) {
+        std::fill(dangling.begin(), dangling.end(), 0);
+        std::fill(change.begin(), change.end(), 0);
+        PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t tid) {
+            for (size_t u = lo; u < hi; u++) {
+                size_t d = g.degree(u);
+                contrib[u] = d ? rank[u] / d : 0;
+                dangling[tid] += d ? 0 : rank[u];
+            }
+        });
+        double lost = 0;
+        for (double x : dangling) {
+            lost += x;
+        }
+        const double base = (1 - opt.damping + opt.damping * lost) / n;
+        PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t tid) {
+            for (size_t v = lo; v < hi; v++) {
+                double sum = 0;
+                for (uint32_t u : in.neighbors(v)) {
+                    sum += contrib[u];
+                }
+                next[v] = base + opt.damping * sum;
+                change[tid] += std::abs(next[v] - rank[v]);
+            }
+        });
+        rank.swap(next);
+        double total = 0;
+        for (double x : change) {
+            total += x;
+        }
+        if (total < opt.tolerance) {
+            break;
+        }
+    }
+    return rank;
+}
+
+/**
+ * @brief triangle_count function
+ * Every edge is oriented from the endpoint with the lower(degree, id) to the higher
+ * one, which bounds every list by O(sqrt(E)), then each triangle is counted once by
+ * intersecting the sorted lists of both endpoints of every oriented edge. Directions,
+ * self loops and parallel edges are ignored.
+ * @param g: the snapshot(see graph<T>::csr_view()).
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @returns size_t the number of triangles.
+ */
+template <typename T> size_t triangle_count(const csr_graph<T>& g, size_t threads = 0) {
+    const size_t n = g.size();
+    _analytics_utils::simple_graph s = _analytics_utils::simplify(g, threads);
+    auto before = [&](uint32_t u, uint32_t v) {
+        size_t du = s.degree(u), dv = s.degree(v);
+        return du < dv || (du == dv && u < v);
+    };
+    std::vector<size_t> offsets(n + 1, 0);
+    for (uint32_t u = 0; u < n; u++) {
+        size_t k = 0;
+        for (size_t e = s.offsets[u]; e < s.offsets[u + 1]; e++) {
+            k += before(u, s.targets[e]);
+        }
+        offsets[u + 1] = offsets[u] + k;
+    }
+    std::vector<uint32_t> targets(offsets[n]);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            size_t k = offsets[u];
+            for (size_t e = s.offsets[u]; e < s.offsets[u + 1]; e++) {
+                if (before(static_cast<uint32_t>(u), s.targets[e])) {
+                    targets[k++] = s.targets[e];
+                }
+            }
+        }
+    });
+
+    std::vector<size_t> found(PARALLEL::resolve_threads(threads, n), 0);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t tid) {
+        size_t local = 0;
+        for (size_t u = lo; u < hi; u++) {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                uint32_t v = targets[e];
+                local += _analytics_utils::intersect(targets.data() + offsets[u],
+                                                     offsets[u + 1] - offsets[u],
+                                                     targets.data() + offsets[v],
+                                                     offsets[v + 1] - offsets[v]);
+            }
+        }
+        found[tid] = local;
+    });
+    size_t total = 0;
+    for (size_t x : found) {
+        total += x;
+    }
+    return total;
+}
+
+/**
+ * @brief core_numbers function
+ * k-core decomposition with the bucket queue of Batagelj and Zaversnik: the vertex
+ * with the smallest remaining degree is peeled repeatedly in O(V + E). Directions, self
+ * loops and parallel edges are ignored.
+ * @param g: the snapshot(see graph<T>::csr_view()).
+ * @returns vector<uint32_t> the core number of every dense id, the largest k such that
+ * the vertex belongs to a subgraph where every vertex has degree at least k.
+ */
+template <typename T> std::vector<uint32_t> core_numbers(const csr_graph<T>& g) {
+    const size_t n = g.size();
+    _analytics_utils::simple_graph s = _analytics_utils::simplify(g, 1);
+    std::vector<uint32_t> degree(n), position(n), order(n);
+    uint32_t max_degree = 0;
+    for (uint32_t u = 0; u < n; u++) {
+        degree[u] = static_cast<uint32_t>(s.degree(u));
+        max_degree = std::max(max_degree, degree[u]);
+    }
+    // bucket[d] is the first position of the vertices with degree d in order
+    std::vector<uint32_t> bucket(max_degree + 2, 0);
+    for (uint32_t u = 0; u < n; u++) {
+        bucket[degree[u] + 1]++;
+    }
+    for (size_t d = 0; d <= max_degree; d++) {
+        bucket[d + 1] += bucket[d];
+    }
+    std::vector<uint32_t> fill(bucket.begin(), bucket.end() - 1);
+    for (uint32_t u = 0; u < n; u++) {
+        position[u] = fill[degree[u]]++;
+        order[position[u]] = u;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint32_t u = order[i];
+        for (size_t e = s.offsets[u]; e < s.offsets[u + 1]; e++) {
+            uint32_t v = s.targets[e];
+            if (degree[v] > degree[u]) {
+                // swap v with the first vertex of its bucket, then shrink the bucket
+                uint32_t dv = degree[v], first = bucket[dv], w = order[first];
+                if (w != v) {
+                    std::swap(order[first], order[position[v]]);
+                    position[w] = position[v];
+                    position[v] = first;
+                }
+                bucket[dv]++;
+                degree[v]--;
+            }
+        }
+    }
+    return degree;
+}
+
+#endif
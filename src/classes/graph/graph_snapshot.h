@@ -0,0 +1,286 @@
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include "csr_graph.h"
+#include "edge_list.h"
+#include "vertex_index.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief fixed size header at the start of a snapshot file
+ * The file is native-endian, every section starts at a multiple of 8 bytes:
+ * offsets(uint64_t[vertices + 1]), targets(uint32_t[arcs]), weights(double[arcs], only
+ * if weighted), then the vertex dictionary: T[vertices] for trivially copyable types, or
+ * uint64_t[vertices + 1] offsets followed by the characters for std::string.
+ */
+struct snapshot_header {
+    static constexpr uint32_t MAGIC = 0x53475041; // "APGS" read as little endian
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic{MAGIC};
+    uint32_t version{VERSION};
+    uint32_t flags{0};
+    uint32_t key_size{0};
+    uint64_t vertices{0};
+    uint64_t arcs{0};
+    uint64_t offsets_at{0};
+    uint64_t targets_at{0};
+    uint64_t weights_at{0};
+    uint64_t keys_at{0};
+    uint64_t size{0};
+
+    static constexpr uint32_t DIRECTED = 1;
+    static constexpr uint32_t WEIGHTED = 2;
+    static constexpr uint32_t STRING_KEYS = 4;
+};
+
+namespace _snapshot_utils {
+template <typename T> constexpr bool string_key = std::is_same_v<T, std::string>;
+
+/**
+ * @brief key_size stored in the header, 0 for string keys
+ */
+template <typename T> constexpr uint32_t key_size() {
+    if constexpr (string_key<T>) {
+        return 0;
+    } else {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "snapshots need std::string or trivially copyable vertices");
+        return sizeof(T);
+    }
+}
+
+inline uint64_t align(uint64_t x) { return (x + 7) & ~uint64_t(7); }
+
+inline void write(std::ofstream& out, const void* data, size_t bytes) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+
+inline void pad(std::ofstream& out, uint64_t written) {
+    static const char zeros[8] = {};
+    write(out, zeros, align(written) - written);
+}
+} // namespace _snapshot_utils
+
+/**
+ * @brief save_snapshot function
+ * Writes g in the binary snapshot format, see snapshot_view to read it back.
+ * @param g: the snapshot(see graph<T>::csr_view()).
+ * @param path: the output file, overwritten.
+ * Throws std::runtime_error if the file can not be written.
+ */
+template <typename T> void save_snapshot(const csr_graph<T>& g, const std::string& path) {
+    using namespace _snapshot_utils;
+    snapshot_header h;
+    h.flags = (g.directed() ? snapshot_header::DIRECTED : 0) |
+              (g.weighted() ? snapshot_header::WEIGHTED : 0) |
+              (string_key<T> ? snapshot_header::STRING_KEYS : 0);
+    h.key_size = key_size<T>();
+    h.vertices = g.size();
+    h.arcs = g.arcs();
+    h.offsets_at = align(sizeof(snapshot_header));
+    h.targets_at = h.offsets_at + 8 * (h.vertices + 1);
+    h.weights_at = align(h.targets_at + 4 * h.arcs);
+    h.keys_at = h.weights_at + (g.weighted() ? 8 * h.arcs : 0);
+
+    std::vector<uint64_t> key_offsets;
+    if constexpr (string_key<T>) {
+        key_offsets.assign(1, 0);
+        for (const std::string& key : g.vertices()) {
+            key_offsets.push_back(key_offsets.back() + key.size());
+        }
+        h.size = h.keys_at + 8 * key_offsets.size() + key_offsets.back();
+    } else {
+        h.size = h.keys_at + sizeof(T) * h.vertices;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Can't open file " + path);
+    }
+    write(out, &h, sizeof(h));
+    pad(out, sizeof(h));
+    std::vector<uint64_t> offsets(g.offsets().begin(), g.offsets().end());
+    write(out, offsets.data(), 8 * offsets.size());
+    write(out, g.targets().data(), 4 * h.arcs);
+    pad(out, h.targets_at + 4 * h.arcs);
+    if (g.weighted()) {
+        write(out, g.weights().data(), 8 * h.arcs);
+    }
+    if constexpr (string_key<T>) {
+        write(out, key_offsets.data(), 8 * key_offsets.size());
+        for (const std::string& key : g.vertices()) {
+            write(out, key.data(), key.size());
+        }
+    } else {
+        write(out, g.vertices().data(), sizeof(T) * h.vertices);
+    }
+    if (!out.flush()) {
+        throw std::runtime_error("Can't write file " + path);
+    }
+}
+
+/**
+ * @brief snapshot_view class
+ * Maps a file written by save_snapshot and reads the csr arrays in place, nothing is
+ * parsed or copied. The header is validated on construction, vertex lookups by key
+ * need to_csr() since the dictionary is only stored in id order.
+ */
+template <typename T> class snapshot_view {
+  public:
+    /**
+     * @brief Construct a new snapshot_view object
+     * @param path: the snapshot file.
+     * Throws std::runtime_error if the file can not be read, has a different version,
+     * was written for another vertex type or is truncated.
+     */
+    explicit snapshot_view(const std::string& path) : _file(path) {
+        std::string_view data = _file.view();
+        if (data.size() < sizeof(snapshot_header)) {
+            throw std::runtime_error("Snapshot " + path + " is truncated");
+        }
+        std::memcpy(&_h, data.data(), sizeof(_h));
+        if (_h.magic != snapshot_header::MAGIC) {
+            throw std::runtime_error(path + " is not a graph snapshot");
+        }
+        if (_h.version != snapshot_header::VERSION) {
+            throw std::runtime_error("Snapshot " + path + " has unsupported version " +
+                                     std::to_string(_h.version));
+        }
+        bool strings = (_h.flags & snapshot_header::STRING_KEYS) != 0;
+        if (strings != _snapshot_utils::string_key<T> ||
+            _h.key_size != _snapshot_utils::key_size<T>()) {
+            throw std::runtime_error("Snapshot " + path + " was written for another vertex type");
+        }
+        if (_h.size != data.size()) {
+            throw std::runtime_error("Snapshot " + path + " is truncated");
+        }
+        _base = data.data();
+        if (_h.keys_at > _h.size || offsets().back() != _h.arcs) {
+            throw std::runtime_error("Snapshot " + path + " is corrupted");
+        }
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of vertices.
+     */
+    size_t size() const { return _h.vertices; }
+
+    /**
+     * @brief arcs function
+     * @returns size_t the number of stored arcs.
+     */
+    size_t arcs() const { return _h.arcs; }
+
+    /**
+     * @brief directed function
+     * @returns true if the snapshot was taken from a directed graph.
+     */
+    bool directed() const { return _h.flags & snapshot_header::DIRECTED; }
+
+    /**
+     * @brief weighted function
+     * @returns true if the snapshot stores arc weights.
+     */
+    bool weighted() const { return _h.flags & snapshot_header::WEIGHTED; }
+
+    /**
+     * @brief offsets function
+     * @returns span the csr offsets, size() + 1 entries.
+     */
+    std::span<const uint64_t> offsets() const {
+        return {_at<uint64_t>(_h.offsets_at), size() + 1};
+    }
+
+    /**
+     * @brief targets function
+     * @returns span the target dense id of every arc.
+     */
+    std::span<const uint32_t> targets() const { return {_at<uint32_t>(_h.targets_at), arcs()}; }
+
+    /**
+     * @brief weights function
+     * @returns span the weight of every arc, empty if the snapshot is unweighted.
+     */
+    std::span<const double> weights() const {
+        return {_at<double>(_h.weights_at), weighted() ? arcs() : 0};
+    }
+
+    /**
+     * @brief neighbors function
+     * @param u: a dense id.
+     * @returns span the dense ids of the out-neighbors of u.
+     */
+    std::span<const uint32_t> neighbors(uint32_t u) const {
+        std::span<const uint64_t> o = offsets();
+        return targets().subspan(o[u], o[u + 1] - o[u]);
+    }
+
+    /**
+     * @brief vertex function
+     * @param u: a dense id.
+     * @returns T the vertex with dense id u.
+     */
+    T vertex(uint32_t u) const {
+        if constexpr (_snapshot_utils::string_key<T>) {
+            const uint64_t* o = _at<uint64_t>(_h.keys_at);
+            const char* chars = _base + _h.keys_at + 8 * (size() + 1);
+            return std::string(chars + o[u], o[u + 1] - o[u]);
+        } else {
+            T key;
+            std::memcpy(&key, _base + _h.keys_at + sizeof(T) * u, sizeof(T));
+            return key;
+        }
+    }
+
+    /**
+     * @brief to_csr function
+     * Copies the arrays in bulk and rebuilds the vertex index.
+     * @returns csr_graph<T> the snapshot as an in-memory csr_graph.
+     */
+    csr_graph<T> to_csr() const {
+        vertex_index<T> ids;
+        ids.reserve(size());
+        for (uint32_t u = 0; u < size(); u++) {
+            ids.intern(vertex(u));
+        }
+        std::span<const uint64_t> o = offsets();
+        std::span<const uint32_t> t = targets();
+        std::span<const double> w = weights();
+        return csr_graph<T>(std::move(ids), std::vector<size_t>(o.begin(), o.end()),
+                            std::vector<uint32_t>(t.begin(), t.end()),
+                            std::vector<double>(w.begin(), w.end()), directed());
+    }
+
+  private:
+    mapped_file _file;
+    snapshot_header _h;
+    const char* _base{nullptr};
+
+    template <typename U> const U* _at(uint64_t pos) const {
+        return reinterpret_cast<const U*>(_base + pos);
+    }
+};
+
+/**
+ * @brief load_snapshot function
+ * @param path: a file written by save_snapshot.
+ * @returns csr_graph<T> the stored snapshot. Throws std::runtime_error like snapshot_view.
+ */
+template <typename T> csr_graph<T> load_snapshot(const std::string& path) {
+    return snapshot_view<T>(path).to_csr();
+}
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef INCREMENTAL_DAG_H
+#define INCREMENTAL_DAG_H
+
+#include "vertex_index.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#endif
+
+/**
+ * @brief what incremental_dag::add_edge does with an edge that closes a cycle
+ * reject: the edge is not inserted and the graph stays acyclic.
+ * flag: the edge is inserted, cycle() becomes true and the order is no longer kept.
+ */
+enum class cycle_policy { reject, flag };
+
+/**
+ * @brief incremental_dag class
+ * Directed graph that keeps a topological order while edges are added, with the
+ * Pearce-Kelly algorithm: an edge u -> v that already agrees with the order costs O(1),
+ * otherwise only the vertices whose position lies between v and u are searched(forward
+ * from v, backward from u) and the two visited sets swap their positions. A cycle is
+ * found exactly when the forward search reaches u.
+ */
+template <typename T> class incremental_dag {
+  public:
+    /**
+     * @brief Construct a new incremental_dag object
+     * @param policy: what to do with edges that close a cycle.
+     */
+    explicit incremental_dag(cycle_policy policy = cycle_policy::reject) : _policy(policy) {}
+
+    /**
+     * @brief add_vertex function
+     * @param u: the vertex, added at the end of the order if it does not exist.
+     */
+    void add_vertex(const T& u) { _intern(u); }
+
+    /**
+     * @brief add_edge function
+     * @param u: first node.
+     * @param v: second node.
+     * @returns true if the graph is still acyclic after the call. With
+     * cycle_policy::reject a false return means the edge was not inserted.
+     */
+    bool add_edge(const T& u, const T& v);
+
+    /**
+     * @brief has_edge function
+     * @returns true if a direct edge from start to end exists.
+     */
+    bool has_edge(const T& start, const T& end) const {
+        uint32_t s = _ids.id(start), e = _ids.id(end);
+        if (s == vertex_index<T>::npos || e == vertex_index<T>::npos) {
+            return false;
+        }
+        return std::find(_out[s].begin(), _out[s].end(), e) != _out[s].end();
+    }
+
+    /**
+     * @brief cycle function
+     * @returns true if a cycle was inserted(only possible with cycle_policy::flag).
+     */
+    bool cycle() const { return _cyclic; }
+
+    /**
+     * @brief topological_sort function
+     * @returns vector<T> the maintained topological order in O(V), empty if the graph
+     * has a cycle.
+     */
+    std::vector<T> topological_sort() const {
+        std::vector<T> order;
+        if (_cyclic) {
+            return order;
+        }
+        order.reserve(_at.size());
+        for (uint32_t u : _at) {
+            order.push_back(_ids.vertex(u));
+        }
+        return order;
+    }
+
+    /**
+     * @brief position function
+     * @param u: the vertex.
+     * @returns int64_t the position of u in the topological order, -1 if u does not
+     * exist. Every edge goes from a lower to a higher position.
+     */
+    int64_t position(const T& u) const {
+        uint32_t x = _ids.id(u);
+        return x == vertex_index<T>::npos ? -1 : static_cast<int64_t>(_ord[x]);
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of vertices.
+     */
+    size_t size() const { return _at.size(); }
+
+    /**
+     * @brief empty function
+     * @returns true if the graph has no vertices.
+     */
+    bool empty() const { return _at.empty(); }
+
+    /**
+     * @brief clear function
+     * Removes every vertex and edge.
+     */
+    void clear() {
+        _ids.clear();
+        _out.clear();
+        _in.clear();
+        _ord.clear();
+        _at.clear();
+        _cyclic = false;
+    }
+
+  private:
+    /**
+     * @param _ids: interning table between vertices and their dense ids.
+     * @param _out, _in: adjacency lists in both directions, indexed by dense id.
+     * @param _ord: position of every vertex in the order.
+     * @param _at: the vertex at every position.
+     * @param _ws: visited marks of the bounded searches.
+     */
+    cycle_policy _policy;
+    bool _cyclic{false};
+    vertex_index<T> _ids;
+    std::vector<std::vector<uint32_t>> _out, _in;
+    std::vector<uint32_t> _ord, _at;
+    graph_workspace _ws;
+    std::vector<uint32_t> _forward, _backward, _slots;
+
+    uint32_t _intern(const T& key) {
+        uint32_t u = _ids.intern(key);
+        if (u == _out.size()) {
+            _out.emplace_back();
+            _in.emplace_back();
+            _ord.push_back(static_cast<uint32_t>(_at.size()));
+            _at.push_back(u);
+        }
+        return u;
+    }
+
+    void _insert(uint32_t a, uint32_t b) {
+        _out[a].push_back(b);
+        _in[b].push_back(a);
+    }
+
+    /**
+     * @brief forward search from b over the vertices placed before a, returns false as
+     * soon as it reaches a
+     */
+    bool _search_forward(uint32_t b, uint32_t a) {
+        std::vector<uint32_t>& st = _ws.frontier();
+        _forward.clear();
+        st.assign(1, b);
+        _ws.visit(b);
+        while (!st.empty()) {
+            uint32_t w = st.back();
+            st.pop_back();
+            _forward.push_back(w);
+            for (uint32_t x : _out[w]) {
+                if (x == a) {
+                    return false;
+                }
+                if (_ord[x] < _ord[a] && _ws.try_visit(x)) {
+                    st.push_back(x);
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief backward search from a over the vertices placed after b
+     */
+    void _search_backward(uint32_t a, uint32_t b) {
+        std::vector<uint32_t>& st = _ws.frontier();
+        _backward.clear();
+        st.assign(1, a);
+        _ws.visit(a);
+        while (!st.empty()) {
+            uint32_t w = st.back();
+            st.pop_back();
+            _backward.push_back(w);
+            for (uint32_t x : _in[w]) {
+                if (_ord[x] > _ord[b] && _ws.try_visit(x)) {
+                    st.push_back(x);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief puts the backward set in front of the forward set, reusing their positions
+     */
+    void _reorder() {
+        auto by_position = [this](uint32_t x, uint32_t y) { return _ord[x] < _ord[y]; };
+        std::sort(_forward.begin(), _forward.end(), by_position);
+        std::sort(_backward.begin(), _backward.end(), by_position);
+        _slots.clear();
+        for (uint32_t w : _backward) {
+            _slots.push_back(_ord[w]);
+        }
+        for (uint32_t w : _forward) {
+            _slots.push_back(_ord[w]);
+        }
+        std::sort(_slots.begin(), _slots.end());
+        size_t k = 0;
+        for (std::vector<uint32_t>* part : {&_backward, &_forward}) {
+            for (uint32_t w : *part) {
+                _ord[w] = _slots[k++];
+                _at[_ord[w]] = w;
+            }
+        }
+    }
+};
+
+template <typename T> bool incremental_dag<T>::add_edge(const T& u, const T& v) {
+    uint32_t a = _intern(u), b = _intern(v);
+    if (_cyclic) {
+        _insert(a, b);
+        return false;
+    }
+    if (_ord[a] < _ord[b]) {
+        _insert(a, b);
+        return true;
+    }
+    _ws.begin(_at.size());
+    if (a == b || !_search_forward(b, a)) {
+        if (_policy == cycle_policy::flag) {
+            _insert(a, b);
+            _cyclic = true;
+        }
+        return false;
+    }
+    _search_backward(a, b);
+    _reorder();
+    _insert(a, b);
+    return true;
+}
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef PARALLEL_BFS_H
+#define PARALLEL_BFS_H
+
+#include "../../helpers/parallel.h"
+#include "../../helpers/trace.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#endif
+
+/**
+ * @brief result of a breadth first search over a csr_graph, indexed by dense vertex id
+ * @param depth: hop distance from the source, -1 for unreachable vertices.
+ * @param parent: parent in the bfs tree, the source is its own parent and unreachable
+ * vertices hold csr_graph<T>::npos.
+ * @param order: the reached vertex ids level by level(the order inside a level is
+ * unspecified when more than one thread is used).
+ */
+struct bfs_tree {
+    std::vector<int64_t> depth;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> order;
+};
+
+/**
+ * @brief direction-optimizing breadth first search(Beamer et al.) over a csr_graph.
+ * Small frontiers are expanded top-down from a queue, large frontiers bottom-up from a
+ * bitmap: every unvisited vertex scans its in-neighbors and stops at the first one that
+ * is in the frontier. Both steps are split across threads. The engine keeps a reference
+ * to the snapshot and lazily builds its transpose for directed graphs, so run() can be
+ * called many times for different sources.
+ */
+template <typename T> class direction_optimizing_bfs {
+  public:
+    /**
+     * @brief Construct a new direction_optimizing_bfs object
+     * @param g: the snapshot to search, it must outlive the engine.
+     * @param threads: number of worker threads(0 means every hardware thread).
+     * @param alpha: switch to bottom-up when frontier arcs > unexplored arcs / alpha.
+     * @param beta: switch back to top-down when frontier size < vertices / beta.
+     */
+    explicit direction_optimizing_bfs(const csr_graph<T>& g, size_t threads = 0,
+                                      double alpha = 15.0, double beta = 18.0)
+        : _g(g), _threads(PARALLEL::resolve_threads(threads, PARALLEL::hardware_threads())),
+          _alpha(alpha), _beta(beta) {}
+
+    /**
+     * @brief run function
+     * @param start: the source vertex.
+     * @returns bfs_tree the depth and parent arrays, empty arrays if start does not exist.
+     */
+    bfs_tree run(const T& start) {
+        uint32_t s = _g.id(start);
+        if (s == csr_graph<T>::npos) {
+            return {};
+        }
+        return run_id(s);
+    }
+
+    /**
+     * @brief run_id function
+     * @param s: the dense id of the source vertex.
+     * @returns bfs_tree the depth and parent arrays.
+     */
+    bfs_tree run_id(uint32_t s);
+
+  private:
+    const csr_graph<T>& _g;
+    std::unique_ptr<csr_graph<T>> _transposed;
+    size_t _threads;
+    double _alpha, _beta;
+
+    /**
+     * @brief in-neighbors used by the bottom-up step
+     */
+    const csr_graph<T>& _in() {
+        if (!_g.directed()) {
+            return _g;
+        }
+        if (_transposed == nullptr) {
+            _transposed = std::make_unique<csr_graph<T>>(_g.transpose());
+        }
+        return *_transposed;
+    }
+
+    /**
+     * @brief sets the bits of the frontier ids in a zeroed bitmap
+     */
+    void _to_bitmap(const std::vector<uint32_t>& frontier, std::vector<uint64_t>& bitmap) {
+        PARALLEL::parallel_for(0, bitmap.size(), _threads, [&](size_t lo, size_t hi, size_t) {
+            std::fill(bitmap.begin() + lo, bitmap.begin() + hi, 0);
+        });
+        PARALLEL::parallel_for(0, frontier.size(), _threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                std::atomic_ref<uint64_t>(bitmap[frontier[i] >> 6])
+                    .fetch_or(uint64_t(1) << (frontier[i] & 63), std::memory_order_relaxed);
+            }
+        });
+    }
+};
+
+template <typename T> bfs_tree direction_optimizing_bfs<T>::run_id(uint32_t s) {
+    ALGOPLUS_TRACE_SPAN("direction_optimizing_bfs");
+    const size_t n = _g.size();
+    const uint32_t npos = csr_graph<T>::npos;
+    bfs_tree tree;
+    tree.depth.assign(n, -1);
+    tree.parent.assign(n, npos);
+    tree.order.reserve(n);
+    tree.depth[s] = 0;
+    tree.parent[s] = s;
+
+    std::vector<uint32_t> frontier = {s};
+    std::vector<std::vector<uint32_t>> local(_threads);
+    std::vector<size_t> local_arcs(_threads);
+    std::vector<uint64_t> bitmap;
+    bool bottom_up = false;
+    size_t frontier_arcs = _g.degree(s);
+    size_t unexplored_arcs = _g.arcs() - frontier_arcs;
+
+    for (int64_t d = 0; !frontier.empty(); d++) {
+        ALGOPLUS_TRACE_SPAN("bfs level");
+        ALGOPLUS_TRACE_COUNTER("bfs frontier", frontier.size());
+        tree.order.insert(tree.order.end(), frontier.begin(), frontier.end());
+        if (!bottom_up && frontier_arcs > unexplored_arcs / _alpha) {
+            bottom_up = true;
+        } else if (bottom_up && frontier.size() < n / _beta) {
+            bottom_up = false;
+        }
+        for (size_t t = 0; t < _threads; t++) {
+            local[t].clear();
+            local_arcs[t] = 0;
+        }
+
+        if (!bottom_up) {
+            PARALLEL::parallel_for(
+                0, frontier.size(), _threads, [&](size_t lo, size_t hi, size_t tid) {
+                    for (size_t i = lo; i < hi; i++) {
+                        uint32_t u = frontier[i];
+                        for (uint32_t v : _g.neighbors(u)) {
+                            std::atomic_ref<uint32_t> p(tree.parent[v]);
+                            uint32_t expected = npos;
+                            if (p.load(std::memory_order_relaxed) == npos &&
+                                p.compare_exchange_strong(expected, u,
+                                                          std::memory_order_relaxed)) {
+                                tree.depth[v] = d + 1;
+                                local[tid].push_back(v);
+                                local_arcs[tid] += _g.degree(v);
+                            }
+                        }
+                    }
+                });
+        } else {
+            const csr_graph<T>& in = _in();
+            bitmap.resize((n + 63) / 64);
+            _to_bitmap(frontier, bitmap);
+            // every thread owns whole words of vertices, so no two threads write the same
+            // parent/depth entry
+            PARALLEL::parallel_for(
+                0, bitmap.size(), _threads, [&](size_t lo, size_t hi, size_t tid) {
+                    size_t v_end = std::min(n, hi * 64);
+                    for (size_t v = lo * 64; v < v_end; v++) {
+                        if (tree.parent[v] != npos) {
+                            continue;
+                        }
+                        for (uint32_t u : in.neighbors(static_cast<uint32_t>(v))) {
+                            if (bitmap[u >> 6] >> (u & 63) & 1) {
+                                tree.parent[v] = u;
+                                tree.depth[v] = d + 1;
+                                local[tid].push_back(static_cast<uint32_t>(v));
+                                local_arcs[tid] += _g.degree(static_cast<uint32_t>(v));
+                                break;
+                            }
+                        }
+                    }
+                });
+        }
+
+        frontier.clear();
+        frontier_arcs = 0;
+        for (size_t t = 0; t < _threads; t++) {
+            frontier.insert(frontier.end(), local[t].begin(), local[t].end());
+            frontier_arcs += local_arcs[t];
+        }
+        unexplored_arcs -= std::min(unexplored_arcs, frontier_arcs);
+    }
+    return tree;
+}
+
+/**
+ * @brief parallel_bfs function
+ * @param g: the snapshot to search(see graph<T>::csr_view()).
+ * @param start: the source vertex.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @returns bfs_tree the depth and parent arrays indexed by dense vertex id.
+ */
+template <typename T>
+bfs_tree parallel_bfs(const csr_graph<T>& g, const T& start, size_t threads = 0) {
+    return direction_optimizing_bfs<T>(g, threads).run(start);
+}
+
+#endif
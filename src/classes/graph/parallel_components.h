@@ -0,0 +1,58 @@
+#ifndef PARALLEL_COMPONENTS_H
+#define PARALLEL_COMPONENTS_H
+
+#include "../../helpers/parallel.h"
+#include "../disjoint_set/concurrent_disjoint_set.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <vector>
+#endif
+
+/**
+ * @brief parallel_connected_components function
+ * Every thread joins the ends of its share of the arcs in one lock-free union-find, so
+ * each arc is looked at once, then every vertex is labeled with the root of its set.
+ * Arcs are followed in both directions, so for directed graphs this returns the weakly
+ * connected components.
+ * @param g: the snapshot to label(see graph<T>::csr_view()).
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @returns component_labels the component id of every vertex and the component count.
+ */
+template <typename T>
+component_labels parallel_connected_components(const csr_graph<T>& g, size_t threads = 0) {
+    const size_t n = g.size();
+    component_labels result;
+    std::vector<uint32_t>& comp = result.component;
+    comp.resize(n);
+    concurrent_dsu d(static_cast<uint32_t>(n));
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            for (uint32_t v : g.neighbors(static_cast<uint32_t>(u))) {
+                d.join(static_cast<uint32_t>(u), v);
+            }
+        }
+    });
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t v = lo; v < hi; v++) {
+            comp[v] = d.find(static_cast<uint32_t>(v));
+        }
+    });
+
+    // every label is now the smallest id of its component, relabel to [0, count)
+    std::vector<uint32_t> dense(n, csr_graph<T>::npos);
+    for (size_t v = 0; v < n; v++) {
+        if (comp[v] == v) {
+            dense[v] = static_cast<uint32_t>(result.count++);
+        }
+    }
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t v = lo; v < hi; v++) {
+            comp[v] = dense[comp[v]];
+        }
+    });
+    return result;
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef PARALLEL_SCC_H
+#define PARALLEL_SCC_H
+
+#include "../../helpers/parallel.h"
+#include "csr_graph.h"
+#include "tarjan.h"
+
+#ifdef __cplusplus
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#endif
+
+namespace _parallel_scc_utils {
+/**
+ * @brief raises x to value if value is larger, returns true if x changed
+ */
+inline bool atomic_max(uint32_t& x, uint32_t value) {
+    std::atomic_ref<uint32_t> ref(x);
+    uint32_t current = ref.load(std::memory_order_relaxed);
+    while (value > current) {
+        if (ref.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint32_t load(uint32_t& x) {
+    return std::atomic_ref<uint32_t>(x).load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief peels every vertex without active in-arcs or out-arcs, repeatedly, each one is
+ * an scc of its own. Long chains and the acyclic parts of a graph go away here.
+ */
+template <typename T>
+void trim(const csr_graph<T>& g, const csr_graph<T>& t, size_t threads,
+          std::vector<uint32_t>& comp, uint32_t& next) {
+    const size_t n = g.size();
+    std::vector<uint32_t> in(n), out(n);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            out[u] = static_cast<uint32_t>(g.degree(static_cast<uint32_t>(u)));
+            in[u] = static_cast<uint32_t>(t.degree(static_cast<uint32_t>(u)));
+        }
+    });
+    std::vector<uint32_t> q;
+    for (uint32_t u = 0; u < n; u++) {
+        if (in[u] == 0 || out[u] == 0) {
+            comp[u] = next++;
+            q.push_back(u);
+        }
+    }
+    for (size_t head = 0; head < q.size(); head++) {
+        uint32_t u = q[head];
+        for (uint32_t v : g.neighbors(u)) {
+            if (comp[v] == _tarjan_utils::npos && --in[v] == 0) {
+                comp[v] = next++;
+                q.push_back(v);
+            }
+        }
+        for (uint32_t v : t.neighbors(u)) {
+            if (comp[v] == _tarjan_utils::npos && --out[v] == 0) {
+                comp[v] = next++;
+                q.push_back(v);
+            }
+        }
+    }
+}
+} // namespace _parallel_scc_utils
+
+/**
+ * @brief parallel_scc function
+ * Strongly connected components with trimming followed by rounds of the coloring
+ * algorithm(Orzan): the largest id that reaches a vertex is propagated forward with an
+ * atomic max, every vertex that kept its own id is the root of an scc, and the scc is
+ * the part of its color class that reaches it backward. The backward searches of
+ * different roots touch disjoint color classes, so they run in parallel. When a round
+ * peels less than 1/64 of the remaining vertices the rest is finished with tarjan.
+ * @param g: the snapshot to label(see graph<T>::csr_view()).
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @returns component_labels the scc of every vertex and the scc count, the same labels
+ * as csr_graph<T>::scc_labels().
+ */
+template <typename T>
+component_labels parallel_scc(const csr_graph<T>& g, size_t threads = 0) {
+    const uint32_t npos = _tarjan_utils::npos;
+    const uint32_t n = static_cast<uint32_t>(g.size());
+    threads = PARALLEL::resolve_threads(threads, PARALLEL::hardware_threads());
+    const csr_graph<T> t = g.transpose();
+    component_labels result;
+    std::vector<uint32_t>& comp = result.component;
+    comp.assign(n, npos);
+    uint32_t next = 0;
+    _parallel_scc_utils::trim(g, t, threads, comp, next);
+
+    std::vector<uint32_t> remaining;
+    for (uint32_t u = 0; u < n; u++) {
+        if (comp[u] == npos) {
+            remaining.push_back(u);
+        }
+    }
+    std::vector<uint32_t> color(n);
+    std::vector<uint8_t> active(n, 0);
+    for (uint32_t u : remaining) {
+        active[u] = 1;
+    }
+    std::vector<std::vector<uint32_t>> local(threads);
+
+    while (!remaining.empty()) {
+        if (remaining.size() < 1024) {
+            break;
+        }
+        PARALLEL::parallel_for(0, remaining.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                color[remaining[i]] = remaining[i];
+            }
+        });
+        // every thread drains its own worklist, so the colors reach their fixpoint
+        // within a single parallel step
+        PARALLEL::parallel_for(
+            0, remaining.size(), threads, [&](size_t lo, size_t hi, size_t tid) {
+                std::vector<uint32_t>& st = local[tid];
+                st.assign(remaining.begin() + lo, remaining.begin() + hi);
+                while (!st.empty()) {
+                    uint32_t u = st.back();
+                    st.pop_back();
+                    uint32_t c = _parallel_scc_utils::load(color[u]);
+                    for (uint32_t v : g.neighbors(u)) {
+                        if (active[v] && _parallel_scc_utils::atomic_max(color[v], c)) {
+                            st.push_back(v);
+                        }
+                    }
+                }
+            });
+
+        std::vector<uint32_t> roots;
+        for (uint32_t u : remaining) {
+            if (color[u] == u) {
+                roots.push_back(u);
+            }
+        }
+        const uint32_t base = next;
+        next += static_cast<uint32_t>(roots.size());
+        PARALLEL::parallel_for(0, roots.size(), threads, [&](size_t lo, size_t hi, size_t tid) {
+            std::vector<uint32_t>& st = local[tid];
+            for (size_t i = lo; i < hi; i++) {
+                uint32_t r = roots[i];
+                comp[r] = base + static_cast<uint32_t>(i);
+                st.assign(1, r);
+                while (!st.empty()) {
+                    uint32_t u = st.back();
+                    st.pop_back();
+                    for (uint32_t v : t.neighbors(u)) {
+                        if (active[v] && color[v] == r && comp[v] == npos) {
+                            comp[v] = comp[r];
+                            st.push_back(v);
+                        }
+                    }
+                }
+            }
+        });
+
+        size_t before = remaining.size();
+        size_t kept = 0;
+        for (uint32_t u : remaining) {
+            if (comp[u] == npos) {
+                remaining[kept++] = u;
+            } else {
+                active[u] = 0;
+            }
+        }
+        remaining.resize(kept);
+        if (before - kept < before / 64) {
+            break;
+        }
+    }
+
+    if (!remaining.empty()) {
+        _tarjan_utils::tarjan(
+            n, [&g](uint32_t u) { return g.degree(u); },
+            [&g](uint32_t u, size_t i) { return g.neighbors(u)[i]; }, active.data(), comp, next);
+    }
+    _tarjan_utils::relabel(comp, next);
+    result.count = next;
+    return result;
+}
+
+#endif
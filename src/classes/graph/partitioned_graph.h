@@ -0,0 +1,460 @@
+#ifndef PARTITIONED_GRAPH_H
+#define PARTITIONED_GRAPH_H
+
+#include "../../helpers/parallel.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief how partitioned_graph assigns vertices to shards
+ * hash: a multiplicative hash of the dense id, no locality at all but perfectly
+ * balanced and computable by every node without communication.
+ * greedy: linear deterministic greedy streaming partitioning(Stanton and Kliot), every
+ * vertex joins the shard that holds most of its neighbors, weighted by how full the
+ * shard is. Much smaller edge cuts on graphs with locality.
+ */
+enum class partition_method { hash, greedy };
+
+/**
+ * @brief one shard of a partitioned_graph
+ * Owned vertices have local ids [0, owned), ghost vertices(neighbors owned by other
+ * shards) follow them. Only the arcs of owned vertices are stored.
+ * @param owned: number of vertices owned by the shard.
+ * @param global: the global dense id of every local vertex, owned first.
+ * @param ghost_owner: the shard owning every ghost, ghost_owner[i] is for local id
+ * owned + i.
+ * @param offsets, targets, weights: csr arrays over the owned vertices, targets are local
+ * ids and weights is empty for unweighted graphs.
+ */
+struct graph_shard {
+    uint32_t owned{0};
+    std::vector<uint32_t> global;
+    std::vector<uint32_t> ghost_owner;
+    std::vector<size_t> offsets{0};
+    std::vector<uint32_t> targets;
+    std::vector<double> weights;
+
+    /**
+     * @brief ghosts function
+     * @returns size_t the number of ghost vertices.
+     */
+    size_t ghosts() const { return global.size() - owned; }
+};
+
+/**
+ * @brief a message between shards, vertex is a global dense id
+ */
+struct shard_message {
+    uint32_t vertex;
+    double value;
+};
+
+/**
+ * @brief transport used by the partitioned traversals to move messages between shards.
+ * The traversals run in supersteps: during a step every shard calls send() for the
+ * messages it produced, then deliver() acts as the barrier and receive() returns what
+ * was sent to a shard during the previous step. An implementation can move the batches
+ * over sockets or MPI, local_transport keeps them in memory.
+ */
+class shard_transport {
+  public:
+    virtual ~shard_transport() = default;
+
+    /**
+     * @brief send function
+     * @param from: the sending shard.
+     * @param to: the receiving shard.
+     * @param batch: the messages, may be called concurrently by different shards.
+     */
+    virtual void send(size_t from, size_t to, std::vector<shard_message>&& batch) = 0;
+
+    /**
+     * @brief deliver function
+     * Barrier at the end of a superstep.
+     * @returns size_t the number of messages delivered to all shards.
+     */
+    virtual size_t deliver() = 0;
+
+    /**
+     * @brief receive function
+     * @param shard: the receiving shard.
+     * @returns vector<shard_message> the messages delivered to shard by the last deliver().
+     */
+    virtual std::vector<shard_message> receive(size_t shard) = 0;
+};
+
+/**
+ * @brief in-memory shard_transport, each destination has a mailbox guarded by a mutex
+ */
+class local_transport : public shard_transport {
+  public:
+    /**
+     * @brief Construct a new local_transport object
+     * @param shards: the number of shards.
+     */
+    explicit local_transport(size_t shards)
+        : _locks(shards), _outbox(shards), _inbox(shards) {}
+
+    void send(size_t, size_t to, std::vector<shard_message>&& batch) override {
+        std::lock_guard<std::mutex> lock(_locks[to]);
+        std::vector<shard_message>& box = _outbox[to];
+        box.insert(box.end(), batch.begin(), batch.end());
+    }
+
+    size_t deliver() override {
+        size_t total = 0;
+        for (size_t s = 0; s < _outbox.size(); s++) {
+            _inbox[s].swap(_outbox[s]);
+            _outbox[s].clear();
+            total += _inbox[s].size();
+        }
+        _messages += total;
+        return total;
+    }
+
+    std::vector<shard_message> receive(size_t shard) override {
+        return std::move(_inbox[shard]);
+    }
+
+    /**
+     * @brief messages function
+     * @returns size_t the total number of messages that went through the transport.
+     */
+    size_t messages() const { return _messages; }
+
+  private:
+    std::vector<std::mutex> _locks;
+    std::vector<std::vector<shard_message>> _outbox;
+    std::vector<std::vector<shard_message>> _inbox;
+    size_t _messages{0};
+};
+
+/**
+ * @brief partitioned_graph class
+ * Splits a csr_graph into shards with ghost tables at the boundaries and runs bfs and
+ * sssp as message passing programs over a shard_transport, one superstep at a time.
+ * The shards are self contained(local csr arrays plus the global ids of their local
+ * vertices), so each one can live on a different node. The object keeps a reference to
+ * the snapshot for vertex lookups.
+ */
+template <typename T> class partitioned_graph {
+  public:
+    /**
+     * @brief Construct a new partitioned_graph object
+     * @param g: the snapshot to split, it must outlive the object.
+     * @param shards: the number of shards.
+     * @param method: hash or greedy partitioning.
+     */
+    partitioned_graph(const csr_graph<T>& g, size_t shards,
+                      partition_method method = partition_method::hash);
+
+    /**
+     * @brief shards function
+     * @returns size_t the number of shards.
+     */
+    size_t shards() const { return _shards.size(); }
+
+    /**
+     * @brief shard function
+     * @returns const graph_shard& the shard with index i.
+     */
+    const graph_shard& shard(size_t i) const { return _shards[i]; }
+
+    /**
+     * @brief owner function
+     * @param u: a global dense id.
+     * @returns uint32_t the shard owning u.
+     */
+    uint32_t owner(uint32_t u) const { return _owner[u]; }
+
+    /**
+     * @brief edge_cut function
+     * @returns size_t the number of arcs whose ends live on different shards.
+     */
+    size_t edge_cut() const {
+        size_t cut = 0;
+        for (const graph_shard& s : _shards) {
+            for (uint32_t v : s.targets) {
+                cut += v >= s.owned;
+            }
+        }
+        return cut;
+    }
+
+    /**
+     * @brief bfs function
+     * Level synchronous: every superstep expands one level inside every shard and sends
+     * the ghosts it reached to their owners.
+     * @param start: the source vertex.
+     * @param transport: moves the frontiers between shards.
+     * @param threads: number of worker threads running the shards(0 means every hardware
+     * thread).
+     * @returns vector<int64_t> hop distance of every global dense id, -1 if unreachable.
+     */
+    std::vector<int64_t> bfs(const T& start, shard_transport& transport, size_t threads = 1);
+
+    /**
+     * @brief sssp function
+     * Every superstep runs dijkstra inside each shard from the vertices whose distance
+     * improved, and sends the improved ghost distances to their owners, until no shard
+     * improves anything. Arc weights must be non negative.
+     * @param start: the source vertex.
+     * @param transport: moves the distance updates between shards.
+     * @param threads: number of worker threads running the shards(0 means every hardware
+     * thread).
+     * @returns vector<double> distance of every global dense id, infinity if unreachable.
+     */
+    std::vector<double> sssp(const T& start, shard_transport& transport, size_t threads = 1);
+
+  private:
+    const csr_graph<T>& _g;
+    std::vector<graph_shard> _shards;
+    std::vector<uint32_t> _owner;
+    std::vector<uint32_t> _local;
+
+    /**
+     * @brief sends the batches of one shard, one per destination
+     */
+    void _flush(size_t from, std::vector<std::vector<shard_message>>& out,
+                shard_transport& transport) const {
+        for (size_t to = 0; to < out.size(); to++) {
+            if (!out[to].empty()) {
+                transport.send(from, to, std::move(out[to]));
+                out[to].clear();
+            }
+        }
+    }
+};
+
+template <typename T>
+partitioned_graph<T>::partitioned_graph(const csr_graph<T>& g, size_t shards,
+                                        partition_method method)
+    : _g(g), _shards(std::max<size_t>(shards, 1)), _owner(g.size()), _local(g.size()) {
+    const size_t k = _shards.size(), n = g.size();
+    if (method == partition_method::hash) {
+        for (size_t u = 0; u < n; u++) {
+            _owner[u] = static_cast<uint32_t>((u * 0x9E3779B97F4A7C15ull >> 32) % k);
+        }
+    } else {
+        const double capacity = static_cast<double>((n + k - 1) / k) * 1.05;
+        std::vector<size_t> load(k, 0), hits(k, 0);
+        std::vector<uint8_t> placed(n, 0);
+        for (uint32_t u = 0; u < n; u++) {
+            for (uint32_t v : g.neighbors(u)) {
+                if (placed[v]) {
+                    hits[_owner[v]]++;
+                }
+            }
+            size_t best = 0;
+            double best_score = -1;
+            for (size_t p = 0; p < k; p++) {
+                double score = hits[p] * (1.0 - load[p] / capacity);
+                if (load[p] + 1 > capacity) {
+                    score = -0.5;
+                }
+                if (score > best_score || (score == best_score && load[p] < load[best])) {
+                    best = p, best_score = score;
+                }
+                hits[p] = 0;
+            }
+            _owner[u] = static_cast<uint32_t>(best);
+            placed[u] = 1;
+            load[best]++;
+        }
+    }
+
+    for (uint32_t u = 0; u < n; u++) {
+        graph_shard& s = _shards[_owner[u]];
+        _local[u] = s.owned++;
+        s.global.push_back(u);
+    }
+    // ghosts get their local ids in order of first appearance inside each shard
+    std::vector<uint32_t> ghost_id(n, csr_graph<T>::npos);
+    for (size_t p = 0; p < k; p++) {
+        graph_shard& s = _shards[p];
+        s.offsets.assign(s.owned + 1, 0);
+        for (uint32_t i = 0; i < s.owned; i++) {
+            uint32_t u = s.global[i];
+            for (size_t e = g.offsets()[u]; e < g.offsets()[u + 1]; e++) {
+                uint32_t v = g.targets()[e];
+                uint32_t local = _local[v];
+                if (_owner[v] != p) {
+                    if (ghost_id[v] == csr_graph<T>::npos) {
+                        ghost_id[v] = static_cast<uint32_t>(s.global.size());
+                        s.global.push_back(v);
+                        s.ghost_owner.push_back(_owner[v]);
+                    }
+                    local = ghost_id[v];
+                }
+                s.targets.push_back(local);
+                if (g.weighted()) {
+                    s.weights.push_back(g.weight(e));
+                }
+            }
+            s.offsets[i + 1] = s.targets.size();
+        }
+        for (size_t i = s.owned; i < s.global.size(); i++) {
+            ghost_id[s.global[i]] = csr_graph<T>::npos;
+        }
+    }
+}
+
+template <typename T>
+std::vector<int64_t> partitioned_graph<T>::bfs(const T& start, shard_transport& transport,
+                                               size_t threads) {
+    const size_t k = _shards.size();
+    std::vector<int64_t> depth(_g.size(), -1);
+    uint32_t s = _g.id(start);
+    if (s == csr_graph<T>::npos) {
+        return depth;
+    }
+    // per shard state, indexed by local id of the owned vertices
+    std::vector<std::vector<int64_t>> local_depth(k);
+    std::vector<std::vector<uint32_t>> frontier(k);
+    for (size_t p = 0; p < k; p++) {
+        local_depth[p].assign(_shards[p].owned, -1);
+    }
+    local_depth[_owner[s]][_local[s]] = 0;
+    frontier[_owner[s]].push_back(_local[s]);
+
+    for (int64_t d = 0;; d++) {
+        PARALLEL::parallel_for(0, k, threads, [&](size_t lo, size_t hi, size_t) {
+            std::vector<std::vector<shard_message>> out(k);
+            for (size_t p = lo; p < hi; p++) {
+                const graph_shard& sh = _shards[p];
+                std::vector<uint32_t> next;
+                for (uint32_t u : frontier[p]) {
+                    for (size_t e = sh.offsets[u]; e < sh.offsets[u + 1]; e++) {
+                        uint32_t v = sh.targets[e];
+                        if (v >= sh.owned) {
+                            out[sh.ghost_owner[v - sh.owned]].push_back(
+                                {sh.global[v], static_cast<double>(d + 1)});
+                        } else if (local_depth[p][v] == -1) {
+                            local_depth[p][v] = d + 1;
+                            next.push_back(v);
+                        }
+                    }
+                }
+                frontier[p].swap(next);
+                _flush(p, out, transport);
+            }
+        });
+        transport.deliver();
+        bool active = false;
+        for (size_t p = 0; p < k; p++) {
+            for (const shard_message& m : transport.receive(p)) {
+                uint32_t v = _local[m.vertex];
+                if (local_depth[p][v] == -1) {
+                    local_depth[p][v] = static_cast<int64_t>(m.value);
+                    frontier[p].push_back(v);
+                }
+            }
+            active |= !frontier[p].empty();
+        }
+        if (!active) {
+            break;
+        }
+    }
+
+    for (size_t p = 0; p < k; p++) {
+        for (uint32_t i = 0; i < _shards[p].owned; i++) {
+            depth[_shards[p].global[i]] = local_depth[p][i];
+        }
+    }
+    return depth;
+}
+
+template <typename T>
+std::vector<double> partitioned_graph<T>::sssp(const T& start, shard_transport& transport,
+                                               size_t threads) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const size_t k = _shards.size();
+    std::vector<double> dist(_g.size(), inf);
+    uint32_t s = _g.id(start);
+    if (s == csr_graph<T>::npos) {
+        return dist;
+    }
+    // local distances cover owned vertices and ghosts, a ghost only holds the best
+    // distance this shard already sent for it
+    using entry = std::pair<double, uint32_t>;
+    std::vector<std::vector<double>> local(k);
+    std::vector<std::vector<entry>> heaps(k);
+    for (size_t p = 0; p < k; p++) {
+        local[p].assign(_shards[p].global.size(), inf);
+    }
+    local[_owner[s]][_local[s]] = 0;
+    heaps[_owner[s]].push_back({0, _local[s]});
+
+    while (true) {
+        PARALLEL::parallel_for(0, k, threads, [&](size_t lo, size_t hi, size_t) {
+            std::vector<std::vector<shard_message>> out(k);
+            for (size_t p = lo; p < hi; p++) {
+                const graph_shard& sh = _shards[p];
+                std::vector<double>& d = local[p];
+                std::vector<entry>& heap = heaps[p];
+                std::vector<uint32_t> improved_ghosts;
+                while (!heap.empty()) {
+                    std::pop_heap(heap.begin(), heap.end(), std::greater<entry>());
+                    auto [du, u] = heap.back();
+                    heap.pop_back();
+                    if (du > d[u]) {
+                        continue;
+                    }
+                    for (size_t e = sh.offsets[u]; e < sh.offsets[u + 1]; e++) {
+                        uint32_t v = sh.targets[e];
+                        double nd = du + (sh.weights.empty() ? 1.0 : sh.weights[e]);
+                        if (nd < d[v]) {
+                            if (v >= sh.owned) {
+                                d[v] = nd;
+                                improved_ghosts.push_back(v);
+                            } else {
+                                d[v] = nd;
+                                heap.push_back({nd, v});
+                                std::push_heap(heap.begin(), heap.end(), std::greater<entry>());
+                            }
+                        }
+                    }
+                }
+                std::sort(improved_ghosts.begin(), improved_ghosts.end());
+                improved_ghosts.erase(std::unique(improved_ghosts.begin(), improved_ghosts.end()),
+                                      improved_ghosts.end());
+                for (uint32_t v : improved_ghosts) {
+                    out[sh.ghost_owner[v - sh.owned]].push_back({sh.global[v], d[v]});
+                }
+                _flush(p, out, transport);
+            }
+        });
+        if (transport.deliver() == 0) {
+            break;
+        }
+        for (size_t p = 0; p < k; p++) {
+            for (const shard_message& m : transport.receive(p)) {
+                uint32_t v = _local[m.vertex];
+                if (m.value < local[p][v]) {
+                    local[p][v] = m.value;
+                    heaps[p].push_back({m.value, v});
+                    std::push_heap(heaps[p].begin(), heaps[p].end(), std::greater<entry>());
+                }
+            }
+        }
+    }
+
+    for (size_t p = 0; p < k; p++) {
+        for (uint32_t i = 0; i < _shards[p].owned; i++) {
+            dist[_shards[p].global[i]] = local[p][i];
+        }
+    }
+    return dist;
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef SHORTEST_PATH_QUERY_H
+#define SHORTEST_PATH_QUERY_H
+
+#include "../heap/indexed_heap.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief point to point shortest path queries over a csr_graph.
+ * Runs a bidirectional dijkstra that stops as soon as the best meeting distance is no
+ * larger than the sum of the two heap tops. Distances, parents and heaps are kept
+ * between queries, and only the vertices touched by the last query are reset, so a
+ * query costs nothing proportional to the size of the graph. Arc weights must be non
+ * negative. The object keeps a reference to the snapshot, which must outlive it.
+ */
+template <typename T> class shortest_path_query {
+  public:
+    static constexpr uint32_t npos = csr_graph<T>::npos;
+
+    /**
+     * @brief Construct a new shortest_path_query object
+     * @param g: the snapshot to search(see weighted_graph<T>::csr_view()).
+     */
+    explicit shortest_path_query(const csr_graph<T>& g) : _g(g) {
+        const double inf = std::numeric_limits<double>::infinity();
+        for (_side& side : _sides) {
+            side.dist.assign(g.size(), inf);
+            side.parent.assign(g.size(), npos);
+            side.heap.resize(g.size());
+        }
+    }
+
+    /**
+     * @brief distance function
+     * @param start: starting node.
+     * @param end: ending node.
+     * @returns double the cost of the shortest path, -1 if end is unreachable or one of
+     * the nodes does not exist.
+     */
+    double distance(const T& start, const T& end) {
+        uint32_t s = _g.id(start), t = _g.id(end);
+        if (s == npos || t == npos) {
+            _reset();
+            return -1;
+        }
+        return distance_id(s, t);
+    }
+
+    /**
+     * @brief distance_id function
+     * @param s: the dense id of the starting node.
+     * @param t: the dense id of the ending node.
+     * @returns double the cost of the shortest path, -1 if t is unreachable.
+     */
+    double distance_id(uint32_t s, uint32_t t);
+
+    /**
+     * @brief path function
+     * @returns std::vector<T> the vertices of the shortest path found by the last query,
+     * from start to end, empty if there was none.
+     */
+    std::vector<T> path() const {
+        std::vector<T> result;
+        if (_meet == npos) {
+            return result;
+        }
+        for (uint32_t u = _meet; u != npos; u = _sides[0].parent[u]) {
+            result.push_back(_g.vertex(u));
+        }
+        std::reverse(result.begin(), result.end());
+        for (uint32_t u = _sides[1].parent[_meet]; u != npos; u = _sides[1].parent[u]) {
+            result.push_back(_g.vertex(u));
+        }
+        return result;
+    }
+
+  private:
+    /**
+     * @brief state of one direction of the search
+     * @param dist: tentative distances, infinity outside touched.
+     * @param parent: predecessor towards the root of this side, npos outside touched.
+     * @param touched: vertices whose dist or parent were written by the last query.
+     * @param heap: vertices keyed by distance, each one at most once.
+     */
+    struct _side {
+        std::vector<double> dist;
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> touched;
+        indexed_heap<double> heap;
+    };
+
+    const csr_graph<T>& _g;
+    std::unique_ptr<csr_graph<T>> _transposed;
+    _side _sides[2];
+    uint32_t _meet{npos};
+
+    /**
+     * @brief arcs followed by the backward search
+     */
+    const csr_graph<T>& _in() {
+        if (!_g.directed()) {
+            return _g;
+        }
+        if (_transposed == nullptr) {
+            _transposed = std::make_unique<csr_graph<T>>(_g.transpose());
+        }
+        return *_transposed;
+    }
+
+    void _reset() {
+        const double inf = std::numeric_limits<double>::infinity();
+        for (_side& side : _sides) {
+            for (uint32_t v : side.touched) {
+                side.dist[v] = inf;
+                side.parent[v] = npos;
+            }
+            side.touched.clear();
+            side.heap.clear();
+        }
+        _meet = npos;
+    }
+
+    static void _push(_side& side, double d, uint32_t v) { side.heap.push(v, d); }
+};
+
+template <typename T> double shortest_path_query<T>::distance_id(uint32_t s, uint32_t t) {
+    const double inf = std::numeric_limits<double>::infinity();
+    _reset();
+    if (s == t) {
+        _sides[0].dist[s] = 0;
+        _sides[0].touched.push_back(s);
+        _meet = s;
+        return 0;
+    }
+    const csr_graph<T>* graphs[2] = {&_g, &_in()};
+    uint32_t roots[2] = {s, t};
+    for (int k = 0; k < 2; k++) {
+        _sides[k].dist[roots[k]] = 0;
+        _sides[k].touched.push_back(roots[k]);
+        _push(_sides[k], 0, roots[k]);
+    }
+
+    double best = inf;
+    while (!_sides[0].heap.empty() && !_sides[1].heap.empty()) {
+        if (_sides[0].heap.top_key() + _sides[1].heap.top_key() >= best) {
+            break;
+        }
+        // expand the side with the smaller heap, the other side only answers lookups
+        int k = _sides[0].heap.size() <= _sides[1].heap.size() ? 0 : 1;
+        _side &side = _sides[k], &other = _sides[1 - k];
+        uint32_t u = side.heap.pop();
+        const double d = side.dist[u];
+        const csr_graph<T>& g = *graphs[k];
+        const std::vector<size_t>& offsets = g.offsets();
+        const std::vector<uint32_t>& targets = g.targets();
+        for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+            uint32_t v = targets[e];
+            double nd = d + g.weight(e);
+            if (nd < side.dist[v]) {
+                if (side.dist[v] == inf) {
+                    side.touched.push_back(v);
+                }
+                side.dist[v] = nd;
+                side.parent[v] = u;
+                _push(side, nd, v);
+            }
+            if (other.dist[v] != inf && nd + other.dist[v] < best) {
+                best = nd + other.dist[v];
+                _meet = v;
+            }
+        }
+    }
+    return best != inf ? best : -1;
+}
+
+#endif
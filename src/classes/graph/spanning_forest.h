@@ -0,0 +1,191 @@
+#ifndef SPANNING_FOREST_H
+#define SPANNING_FOREST_H
+
+#include "../../helpers/parallel.h"
+#include "../disjoint_set/disjoint_set.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#endif
+
+/**
+ * @brief minimum spanning forest engine
+ * kruskal: parallel sort of the edges, then one pass with compact_dsu.
+ * boruvka: rounds in which every component picks its lightest outgoing edge in
+ * parallel, edges inside a component are filtered out after every round.
+ */
+enum class mst_algorithm { kruskal, boruvka };
+
+/**
+ * @brief an edge of a spanning forest, u and v are dense vertex ids
+ */
+struct forest_edge {
+    uint32_t u, v;
+    double w;
+};
+
+/**
+ * @brief result of minimum_spanning_forest()
+ * @param edges: the edges of the forest, one spanning tree per connected component.
+ * @param weight: the total weight of the edges.
+ */
+struct spanning_forest {
+    std::vector<forest_edge> edges;
+    double weight{0};
+};
+
+namespace _spanning_forest_utils {
+/**
+ * @brief every edge of g once(self loops dropped). Undirected snapshots keep the
+ * copy with u < v, directed ones keep every arc and the direction is ignored.
+ */
+template <typename T> std::vector<forest_edge> edge_list(const csr_graph<T>& g, size_t threads) {
+    const size_t n = g.size();
+    const std::vector<size_t>& offsets = g.offsets();
+    const std::vector<uint32_t>& targets = g.targets();
+    auto keep = [&](uint32_t u, uint32_t v) { return g.directed() ? u != v : u < v; };
+    std::vector<size_t> count(n + 1, 0);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                count[u + 1] += keep(static_cast<uint32_t>(u), targets[e]);
+            }
+        }
+    });
+    for (size_t u = 0; u < n; u++) {
+        count[u + 1] += count[u];
+    }
+    std::vector<forest_edge> edges(count.back());
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t u = lo; u < hi; u++) {
+            size_t k = count[u];
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                if (keep(static_cast<uint32_t>(u), targets[e])) {
+                    edges[k++] = {static_cast<uint32_t>(u), targets[e], g.weight(e)};
+                }
+            }
+        }
+    });
+    return edges;
+}
+
+/**
+ * @brief total order on the edges, ties on the weight are broken by position so that
+ * boruvka never closes a cycle
+ */
+inline bool lighter(const std::vector<forest_edge>& edges, size_t a, size_t b) {
+    return edges[a].w < edges[b].w || (edges[a].w == edges[b].w && a < b);
+}
+
+inline spanning_forest kruskal(std::vector<forest_edge> edges, size_t n, size_t threads) {
+    PARALLEL::parallel_sort(
+        edges.begin(), edges.end(),
+        [](const forest_edge& a, const forest_edge& b) {
+            if (a.w != b.w) {
+                return a.w < b.w;
+            }
+            return a.u != b.u ? a.u < b.u : a.v < b.v;
+        },
+        threads);
+    spanning_forest forest;
+    compact_dsu<> d(static_cast<uint32_t>(n));
+    for (const forest_edge& e : edges) {
+        if (forest.edges.size() + 1 >= n) {
+            break;
+        }
+        if (!d.same(e.u, e.v)) {
+            d.join(e.u, e.v);
+            forest.edges.push_back(e);
+            forest.weight += e.w;
+        }
+    }
+    return forest;
+}
+
+inline spanning_forest boruvka(std::vector<forest_edge> edges, size_t n, size_t threads) {
+    const size_t none = std::numeric_limits<size_t>::max();
+    spanning_forest forest;
+    compact_dsu<> d(static_cast<uint32_t>(n));
+    std::vector<uint32_t> comp(n);
+    std::vector<size_t> best(n, none);
+    for (size_t u = 0; u < n; u++) {
+        comp[u] = static_cast<uint32_t>(u);
+    }
+
+    auto offer = [&](uint32_t c, size_t e) {
+        std::atomic_ref<size_t> ref(best[c]);
+        size_t current = ref.load(std::memory_order_relaxed);
+        while (current == none || lighter(edges, e, current)) {
+            if (ref.compare_exchange_weak(current, e, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    };
+
+    while (!edges.empty()) {
+        PARALLEL::parallel_for(0, edges.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t e = lo; e < hi; e++) {
+                offer(comp[edges[e].u], e);
+                offer(comp[edges[e].v], e);
+            }
+        });
+        // the chosen edges form a forest over the components, dsu only skips the edges
+        // picked by both of their endpoints
+        for (size_t c = 0; c < n; c++) {
+            if (best[c] == none) {
+                continue;
+            }
+            const forest_edge& e = edges[best[c]];
+            if (!d.same(e.u, e.v)) {
+                d.join(e.u, e.v);
+                forest.edges.push_back(e);
+                forest.weight += e.w;
+            }
+            best[c] = none;
+        }
+        for (size_t u = 0; u < n; u++) {
+            comp[u] = d.find(static_cast<uint32_t>(u));
+        }
+
+        std::vector<uint8_t> inside(edges.size());
+        PARALLEL::parallel_for(0, edges.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t e = lo; e < hi; e++) {
+                inside[e] = comp[edges[e].u] == comp[edges[e].v];
+            }
+        });
+        size_t kept = 0;
+        for (size_t e = 0; e < edges.size(); e++) {
+            if (!inside[e]) {
+                edges[kept++] = edges[e];
+            }
+        }
+        edges.resize(kept);
+    }
+    return forest;
+}
+} // namespace _spanning_forest_utils
+
+/**
+ * @brief minimum_spanning_forest function
+ * Edge directions of directed snapshots are ignored.
+ * @param g: the snapshot(see weighted_graph<T>::csr_view()).
+ * @param algo: kruskal or boruvka.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @returns spanning_forest the edges of a minimum spanning forest and their total weight.
+ */
+template <typename T>
+spanning_forest minimum_spanning_forest(const csr_graph<T>& g,
+                                        mst_algorithm algo = mst_algorithm::kruskal,
+                                        size_t threads = 0) {
+    std::vector<forest_edge> edges = _spanning_forest_utils::edge_list(g, threads);
+    if (algo == mst_algorithm::kruskal) {
+        return _spanning_forest_utils::kruskal(std::move(edges), g.size(), threads);
+    }
+    return _spanning_forest_utils::boruvka(std::move(edges), g.size(), threads);
+}
+
+#endif
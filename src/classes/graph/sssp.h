@@ -0,0 +1,221 @@
+#ifndef SSSP_H
+#define SSSP_H
+
+#include "../../helpers/parallel.h"
+#include "../heap/indexed_heap.h"
+#include "csr_graph.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief result of a single source shortest paths run, indexed by dense vertex id
+ * @param dist: distance from the source, infinity for unreachable vertices.
+ * @param parent: parent in the shortest path tree, the source is its own parent and
+ * unreachable vertices hold csr_graph<T>::npos. Empty if parents were not requested.
+ */
+struct sssp_tree {
+    std::vector<double> dist;
+    std::vector<uint32_t> parent;
+};
+
+/**
+ * @brief options of sssp()
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @param delta: bucket width of delta-stepping, 0 picks the mean arc weight. With
+ * threads == 1 and delta == 0 a serial dijkstra is used instead.
+ * @param parents: also build the shortest path tree.
+ */
+struct sssp_options {
+    size_t threads{1};
+    double delta{0};
+    bool parents{true};
+};
+
+namespace _sssp_utils {
+/**
+ * @brief lowers x to value if value is smaller, returns true if x changed
+ */
+inline bool atomic_min(double& x, double value) {
+    std::atomic_ref<double> ref(x);
+    double current = ref.load(std::memory_order_relaxed);
+    while (value < current) {
+        if (ref.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief rebuilds the parent of every reached vertex from the final distances with a
+ * bfs over the tight arcs(dist[u] + w == dist[v]), so zero weight cycles never
+ * produce a cyclic tree.
+ */
+template <typename T>
+std::vector<uint32_t> tight_tree(const csr_graph<T>& g, uint32_t s,
+                                 const std::vector<double>& dist) {
+    const std::vector<size_t>& offsets = g.offsets();
+    const std::vector<uint32_t>& targets = g.targets();
+    std::vector<uint32_t> parent(g.size(), csr_graph<T>::npos);
+    std::vector<uint32_t> q = {s};
+    parent[s] = s;
+    for (size_t head = 0; head < q.size(); head++) {
+        uint32_t u = q[head];
+        for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+            uint32_t v = targets[e];
+            if (parent[v] == csr_graph<T>::npos && dist[u] + g.weight(e) == dist[v]) {
+                parent[v] = u;
+                q.push_back(v);
+            }
+        }
+    }
+    return parent;
+}
+
+/**
+ * @brief serial dijkstra with decrease-key, every vertex is in the heap at most once
+ */
+template <typename Heap, typename T>
+sssp_tree dijkstra(const csr_graph<T>& g, uint32_t s, bool parents) {
+    using key_type = typename Heap::key_type;
+    const std::vector<size_t>& offsets = g.offsets();
+    const std::vector<uint32_t>& targets = g.targets();
+    sssp_tree tree;
+    tree.dist.assign(g.size(), std::numeric_limits<double>::infinity());
+    if (parents) {
+        tree.parent.assign(g.size(), csr_graph<T>::npos);
+        tree.parent[s] = s;
+    }
+    Heap pq(g.size());
+    tree.dist[s] = 0;
+    pq.push(s, key_type(0));
+    while (!pq.empty()) {
+        uint32_t u = pq.pop();
+        const double d = tree.dist[u];
+        for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+            uint32_t v = targets[e];
+            double nd = d + g.weight(e);
+            if (nd < tree.dist[v]) {
+                tree.dist[v] = nd;
+                if (parents) {
+                    tree.parent[v] = u;
+                }
+                pq.push(v, static_cast<key_type>(nd));
+            }
+        }
+    }
+    return tree;
+}
+
+/**
+ * @brief parallel delta-stepping(Meyer and Sanders), bucketed as in the GAP benchmark
+ * suite: every thread keeps its own buckets and the threads agree on the smallest non
+ * empty one after every step. Vertices whose distance dropped below the current bucket
+ * since they were pushed are skipped.
+ */
+template <typename T>
+std::vector<double> delta_stepping(const csr_graph<T>& g, uint32_t s, double delta,
+                                   size_t threads) {
+    const std::vector<size_t>& offsets = g.offsets();
+    const std::vector<uint32_t>& targets = g.targets();
+    const size_t n = g.size();
+    threads = PARALLEL::resolve_threads(threads, PARALLEL::hardware_threads());
+    std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+    dist[s] = 0;
+
+    std::vector<std::vector<std::vector<uint32_t>>> bins(threads);
+    std::vector<uint32_t> frontier = {s};
+    size_t curr = 0;
+    while (!frontier.empty()) {
+        const double lower = delta * static_cast<double>(curr);
+        PARALLEL::parallel_for(
+            0, frontier.size(), threads, [&](size_t lo, size_t hi, size_t tid) {
+                std::vector<std::vector<uint32_t>>& local = bins[tid];
+                for (size_t i = lo; i < hi; i++) {
+                    uint32_t u = frontier[i];
+                    double du = std::atomic_ref<double>(dist[u]).load(std::memory_order_relaxed);
+                    if (du < lower) {
+                        continue;
+                    }
+                    for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                        uint32_t v = targets[e];
+                        double nd = du + g.weight(e);
+                        if (_sssp_utils::atomic_min(dist[v], nd)) {
+                            size_t b = std::max(curr, static_cast<size_t>(nd / delta));
+                            if (b >= local.size()) {
+                                local.resize(b + 1);
+                            }
+                            local[b].push_back(v);
+                        }
+                    }
+                }
+            });
+
+        size_t next = std::numeric_limits<size_t>::max();
+        for (std::vector<std::vector<uint32_t>>& local : bins) {
+            for (size_t b = curr; b < local.size() && b < next; b++) {
+                if (!local[b].empty()) {
+                    next = b;
+                    break;
+                }
+            }
+        }
+        frontier.clear();
+        if (next == std::numeric_limits<size_t>::max()) {
+            break;
+        }
+        for (std::vector<std::vector<uint32_t>>& local : bins) {
+            if (next < local.size()) {
+                frontier.insert(frontier.end(), local[next].begin(), local[next].end());
+                local[next].clear();
+            }
+        }
+        curr = next;
+    }
+    return dist;
+}
+} // namespace _sssp_utils
+
+/**
+ * @brief sssp function
+ * Distances from one source to every vertex. Arc weights must be non negative(see
+ * bellman_ford otherwise).
+ * @param g: the snapshot to search(see weighted_graph<T>::csr_view()).
+ * @param s: the dense id of the source vertex.
+ * @param opt: thread count, delta-stepping bucket width and whether to build parents.
+ * @returns sssp_tree the distance and parent arrays.
+ * @tparam Heap priority queue of the serial dijkstra, indexed_heap or pairing_heap for
+ * any weights, radix_heap for integer weights(the distances are truncated to its keys).
+ * Default = indexed_heap<double>
+ */
+template <typename Heap = indexed_heap<double>, typename T>
+sssp_tree sssp(const csr_graph<T>& g, uint32_t s, const sssp_options& opt = {}) {
+    if (opt.threads == 1 && opt.delta == 0) {
+        return _sssp_utils::dijkstra<Heap>(g, s, opt.parents);
+    }
+    double delta = opt.delta;
+    if (delta <= 0) {
+        double total = 0;
+        for (size_t e = 0; e < g.arcs(); e++) {
+            total += g.weight(e);
+        }
+        delta = (g.arcs() && total > 0) ? total / g.arcs() : 1.0;
+    }
+    sssp_tree tree;
+    tree.dist = _sssp_utils::delta_stepping(g, s, delta, opt.threads);
+    if (opt.parents) {
+        tree.parent = _sssp_utils::tight_tree(g, s, tree.dist);
+    }
+    return tree;
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef TARJAN_H
+#define TARJAN_H
+
+#include "../stack/stack_list.h"
+#include "vertex_index.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#endif
+
+namespace _tarjan_utils {
+constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief iterative tarjan over dense ids, the explicit call stack keeps the position in
+ * the neighbor list of every open vertex so arbitrarily long paths never recurse.
+ * @param n: number of vertices.
+ * @param degree: degree(u) returns the out-degree of u.
+ * @param target: target(u, i) returns the id of the i-th out-neighbor of u.
+ * @param active: if not null only vertices with active[u] != 0 take part.
+ * @param comp: receives a label for every active vertex, labels start at next.
+ * @param next: the next free label, advanced once per component.
+ */
+template <typename D, typename F>
+void tarjan(uint32_t n, D&& degree, F&& target, const uint8_t* active,
+            std::vector<uint32_t>& comp, uint32_t& next) {
+    std::vector<uint32_t> index(n, npos), low(n, 0);
+    std::vector<uint8_t> on_stack(n, 0);
+    stack_list<uint32_t> s;
+    stack_list<std::pair<uint32_t, size_t>> call;
+    uint32_t counter = 0;
+
+    auto open = [&](uint32_t v) {
+        index[v] = low[v] = counter++;
+        s.push(v);
+        on_stack[v] = 1;
+        call.push({v, 0});
+    };
+
+    for (uint32_t r = 0; r < n; r++) {
+        if (index[r] != npos || (active != nullptr && !active[r])) {
+            continue;
+        }
+        open(r);
+        while (!call.empty()) {
+            uint32_t v = call.top().first;
+            size_t& i = call.top().second;
+            if (i < degree(v)) {
+                uint32_t w = target(v, i++);
+                if (active != nullptr && !active[w]) {
+                    continue;
+                }
+                if (index[w] == npos) {
+                    open(w);
+                } else if (on_stack[w]) {
+                    low[v] = std::min(low[v], index[w]);
+                }
+                continue;
+            }
+            call.pop();
+            if (!call.empty()) {
+                uint32_t p = call.top().first;
+                low[p] = std::min(low[p], low[v]);
+            }
+            if (low[v] == index[v]) {
+                uint32_t w;
+                do {
+                    w = s.top();
+                    s.pop();
+                    on_stack[w] = 0;
+                    comp[w] = next;
+                } while (w != v);
+                next++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief renames labels in [0, count) so they follow the smallest vertex of each class
+ */
+inline void relabel(std::vector<uint32_t>& comp, size_t count) {
+    std::vector<uint32_t> dense(count, npos);
+    uint32_t next = 0;
+    for (uint32_t& c : comp) {
+        if (dense[c] == npos) {
+            dense[c] = next++;
+        }
+        c = dense[c];
+    }
+}
+} // namespace _tarjan_utils
+
+/**
+ * @brief tarjan_scc function
+ * Strongly connected components of an id-indexed graph with an iterative tarjan.
+ * @param n: number of vertices.
+ * @param degree: degree(u) returns the out-degree of u.
+ * @param target: target(u, i) returns the id of the i-th out-neighbor of u.
+ * @returns component_labels the component of every vertex and the component count.
+ */
+template <typename D, typename F>
+component_labels tarjan_scc(uint32_t n, D&& degree, F&& target) {
+    component_labels result;
+    result.component.assign(n, 0);
+    uint32_t next = 0;
+    _tarjan_utils::tarjan(n, degree, target, nullptr, result.component, next);
+    _tarjan_utils::relabel(result.component, next);
+    result.count = next;
+    return result;
+}
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef TRAVERSAL_H
+#define TRAVERSAL_H
+
+#include "csr_graph.h"
+#include "vertex_index.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+#endif
+
+/**
+ * @brief visit order of lazy_traversal
+ * bfs: the order of bfs().
+ * dfs: depth first with an explicit stack of frames, a vertex is yielded when it is
+ * discovered and finished once every vertex below it is finished(the recursive order,
+ * unlike dfs() which pushes every neighbor at once).
+ */
+enum class traversal_order { bfs, dfs };
+
+/**
+ * @brief lazy_traversal class
+ * Walks a snapshot one vertex at a time: nothing is expanded until the caller asks for
+ * the next vertex, so stopping early costs only what was visited. Usable as a range
+ * in a range-for loop or through next(). Optional callbacks fire when a vertex is
+ * discovered and when it is finished.
+ * The visited set is epoch-stamped, so restart() reuses every buffer. The snapshot must
+ * outlive the traversal.
+ */
+template <typename T> class lazy_traversal {
+  public:
+    using callback = std::function<void(uint32_t)>;
+
+    /**
+     * @brief Construct a new lazy_traversal object
+     * @param g: the snapshot(see graph<T>::csr_view()).
+     * @param start: the first vertex, the traversal is empty if it does not exist.
+     * @param order: bfs or dfs.
+     */
+    lazy_traversal(const csr_graph<T>& g, const T& start,
+                   traversal_order order = traversal_order::bfs)
+        : _g(g), _order(order) {
+        restart(start);
+    }
+
+    /**
+     * @brief on_discover function
+     * @param f: called with the dense id of every vertex when it is first reached.
+     * @returns lazy_traversal& *this.
+     */
+    lazy_traversal& on_discover(callback f) {
+        _discover = std::move(f);
+        return *this;
+    }
+
+    /**
+     * @brief on_finish function
+     * @param f: called with the dense id of every vertex once all of its arcs were
+     * scanned(dfs: once its whole subtree is finished).
+     * @returns lazy_traversal& *this.
+     */
+    lazy_traversal& on_finish(callback f) {
+        _finish = std::move(f);
+        return *this;
+    }
+
+    /**
+     * @brief restart function
+     * Starts over from another vertex, keeping the callbacks and the buffers.
+     * @param start: the first vertex.
+     */
+    void restart(const T& start) {
+        _ws.begin(_g.size());
+        _stack.clear();
+        _head = 0;
+        _current = csr_graph<T>::npos;
+        _root = _g.id(start);
+    }
+
+    /**
+     * @brief next function
+     * @returns true if another vertex was reached, current() then holds it.
+     */
+    bool next() {
+        if (_root != csr_graph<T>::npos) {
+            uint32_t s = _root;
+            _root = csr_graph<T>::npos;
+            _reach(s);
+            if (_order == traversal_order::bfs) {
+                _ws.frontier().push_back(s);
+                _head = 1;
+            } else {
+                _stack.push_back({s, _g.offsets()[s]});
+            }
+            _current = s;
+            return true;
+        }
+        return _order == traversal_order::bfs ? _next_bfs() : _next_dfs();
+    }
+
+    /**
+     * @brief current function
+     * @returns uint32_t the dense id of the last vertex returned by next().
+     */
+    uint32_t current() const { return _current; }
+
+    /**
+     * @brief depth function
+     * @returns size_t the depth of current() in the dfs tree(dfs only).
+     */
+    size_t depth() const { return _stack.empty() ? 0 : _stack.size() - 1; }
+
+    /**
+     * @brief input iterator over the vertices, each increment calls next()
+     */
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(lazy_traversal* t) : _t(t) { _advance(); }
+
+        const T& operator*() const { return _t->_g.vertex(_t->_current); }
+        iterator& operator++() {
+            _advance();
+            return *this;
+        }
+        void operator++(int) { _advance(); }
+        bool operator==(std::default_sentinel_t) const { return _t == nullptr; }
+
+      private:
+        lazy_traversal* _t{nullptr};
+
+        void _advance() {
+            if (!_t->next()) {
+                _t = nullptr;
+            }
+        }
+    };
+
+    /**
+     * @brief begin function
+     * @returns iterator positioned on the next vertex of the traversal.
+     */
+    iterator begin() { return iterator(this); }
+
+    std::default_sentinel_t end() const { return {}; }
+
+  private:
+    struct frame {
+        uint32_t u;
+        size_t e;
+    };
+
+    const csr_graph<T>& _g;
+    traversal_order _order;
+    graph_workspace _ws;
+    std::vector<frame> _stack;
+    size_t _head{0};
+    uint32_t _root{csr_graph<T>::npos};
+    uint32_t _current{csr_graph<T>::npos};
+    callback _discover, _finish;
+
+    void _reach(uint32_t u) {
+        _ws.visit(u);
+        if (_discover) {
+            _discover(u);
+        }
+    }
+
+    bool _next_bfs() {
+        if (_current == csr_graph<T>::npos) {
+            return false;
+        }
+        // the arcs of the previous vertex are only scanned now
+        std::vector<uint32_t>& q = _ws.frontier();
+        for (uint32_t v : _g.neighbors(_current)) {
+            if (!_ws.visited(v)) {
+                _reach(v);
+                q.push_back(v);
+            }
+        }
+        if (_finish) {
+            _finish(_current);
+        }
+        if (_head >= q.size()) {
+            _current = csr_graph<T>::npos;
+            return false;
+        }
+        _current = q[_head++];
+        return true;
+    }
+
+    bool _next_dfs() {
+        while (!_stack.empty()) {
+            frame& f = _stack.back();
+            if (f.e < _g.offsets()[f.u + 1]) {
+                uint32_t v = _g.targets()[f.e++];
+                if (!_ws.visited(v)) {
+                    _reach(v);
+                    _stack.push_back({v, _g.offsets()[v]});
+                    _current = v;
+                    return true;
+                }
+                continue;
+            }
+            uint32_t u = f.u;
+            _stack.pop_back();
+            if (_finish) {
+                _finish(u);
+            }
+        }
+        _current = csr_graph<T>::npos;
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef VERTEX_INDEX_H
+#define VERTEX_INDEX_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#endif
+
+/**
+ * @brief vertex_index class
+ * Interns vertices of type T to dense uint32_t ids in insertion order so that graph
+ * algorithms can keep their per-vertex state in flat arrays.
+ */
+template <typename T> class vertex_index {
+  public:
+    /**
+     * @brief id returned for vertices that are not interned
+     */
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief intern function
+     * @param key: the vertex we want to intern.
+     * @returns uint32_t the id of key, a new one is assigned if key was not interned.
+     */
+    uint32_t intern(const T& key) {
+        auto [it, inserted] = _ids.try_emplace(key, static_cast<uint32_t>(_vertices.size()));
+        if (inserted) {
+            _vertices.push_back(key);
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief id function
+     * @param key: the vertex we want to look up.
+     * @returns uint32_t the id of key or npos if key is not interned.
+     */
+    uint32_t id(const T& key) const {
+        auto it = _ids.find(key);
+        return it == _ids.end() ? npos : it->second;
+    }
+
+    /**
+     * @brief contains function
+     * @param key: the vertex we want to look up.
+     * @returns true if key is interned.
+     */
+    bool contains(const T& key) const { return _ids.find(key) != _ids.end(); }
+
+    /**
+     * @brief vertex function
+     * @param u: a dense vertex id.
+     * @returns const T& the vertex with id u.
+     */
+    const T& vertex(uint32_t u) const { return _vertices[u]; }
+
+    /**
+     * @brief vertices function
+     * @returns const vector<T>& the id -> vertex table.
+     */
+    const std::vector<T>& vertices() const { return _vertices; }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of interned vertices.
+     */
+    size_t size() const { return _vertices.size(); }
+
+    /**
+     * @brief reserve function
+     * @param n: the number of vertices we expect to intern.
+     */
+    void reserve(size_t n) {
+        _ids.reserve(n);
+        _vertices.reserve(n);
+    }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        _ids.clear();
+        _vertices.clear();
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the vertices, the table from vertex to id as node overhead, the
+     * object with the headers of the arrays and the bucket table, and the spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_vertices);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_ids));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    std::unordered_map<T, uint32_t> _ids;
+    std::vector<T> _vertices;
+};
+
+/**
+ * @brief graph_workspace class
+ * Scratch buffers shared by the traversals of one graph so that repeated calls do
+ * not allocate. The visited set is epoch-stamped: begin() starts a new traversal
+ * without touching the array, it is only wiped when the epoch counter wraps.
+ */
+class graph_workspace {
+  public:
+    /**
+     * @brief begin function
+     * Starts a new traversal over n vertices: marks every vertex as not visited,
+     * empties the frontier and sizes the timestamp arrays(their contents are left
+     * unspecified).
+     * @param n: the number of vertices of the graph.
+     */
+    void begin(size_t n) {
+        if (_mark.size() < n) {
+            _mark.resize(n, 0);
+        }
+        if (++_epoch == 0) {
+            std::fill(_mark.begin(), _mark.end(), 0);
+            _epoch = 1;
+        }
+        _frontier.clear();
+        _in.resize(n);
+        _out.resize(n);
+    }
+
+    /**
+     * @brief visited function
+     * @returns true if u was visited in the current traversal.
+     */
+    bool visited(uint32_t u) const { return _mark[u] == _epoch; }
+
+    /**
+     * @brief visit function
+     * marks u as visited in the current traversal.
+     */
+    void visit(uint32_t u) { _mark[u] = _epoch; }
+
+    /**
+     * @brief try_visit function
+     * @returns true if u was not visited before this call(and marks it).
+     */
+    bool try_visit(uint32_t u) {
+        if (_mark[u] == _epoch) {
+            return false;
+        }
+        _mark[u] = _epoch;
+        return true;
+    }
+
+    /**
+     * @brief reusable stack/queue buffer of vertex ids.
+     */
+    std::vector<uint32_t>& frontier() { return _frontier; }
+
+    /**
+     * @brief reusable per-vertex entry timestamps(or any int64_t label).
+     */
+    std::vector<int64_t>& in() { return _in; }
+
+    /**
+     * @brief reusable per-vertex exit/low timestamps(or any int64_t label).
+     */
+    std::vector<int64_t>& out() { return _out; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the buffers as slack, they hold no element between two traversals,
+     * and the object with the headers of the buffers
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.control = sizeof(*this);
+        auto add = [&](const auto& v) {
+            MEMORY::footprint b = MEMORY::heap_usage(v);
+            f.control += b.control;
+            f.slack += b.payload + b.node_overhead + b.slack;
+        };
+        add(_mark);
+        add(_frontier);
+        add(_in);
+        add(_out);
+        return f;
+    }
+
+  private:
+    std::vector<uint32_t> _mark;
+    uint32_t _epoch{0};
+    std::vector<uint32_t> _frontier;
+    std::vector<int64_t> _in;
+    std::vector<int64_t> _out;
+};
+
+/**
+ * @brief result of a components labeling(connected or strongly connected), indexed by
+ * dense vertex id
+ * @param component: component id of every vertex, ids are in [0, count) and follow
+ * the smallest vertex id of each component.
+ * @param count: the number of components.
+ */
+struct component_labels {
+    std::vector<uint32_t> component;
+    size_t count{0};
+};
+
+#endif
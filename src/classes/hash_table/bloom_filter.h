@@ -0,0 +1,483 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include "../../helpers/cpu_features.h"
+#include "../../helpers/fast_hash.h"
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#endif
+
+namespace _bloom_filter_utils {
+/**
+ * @brief x scaled from [0, 2^32) to [0, n), without a division
+ */
+inline size_t reduce(uint32_t x, size_t n) { return size_t((uint64_t(x) * n) >> 32); }
+
+inline void prefetch(const void* p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+inline void check_rate(double fpr, const char* name) {
+    if (!(fpr > 0 && fpr < 1)) {
+        throw std::invalid_argument(std::string(name) +
+                                    ": the false positive rate must be in (0, 1)");
+    }
+}
+
+// the words of a block of the blocked filter, and the odd multipliers that pick one bit of
+// every word from the same 32 bits of hash(split block Bloom filter of Impala and Parquet)
+constexpr size_t WORDS = 8;
+constexpr uint32_t SALT[WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                  0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+inline void block_insert_scalar(uint32_t* block, uint32_t h) {
+    for (size_t i = 0; i < WORDS; i++) {
+        block[i] |= uint32_t(1) << ((h * SALT[i]) >> 27);
+    }
+}
+
+inline bool block_contains_scalar(const uint32_t* block, uint32_t h) {
+    bool all = true;
+    for (size_t i = 0; i < WORDS; i++) {
+        all &= (block[i] >> ((h * SALT[i]) >> 27)) & 1;
+    }
+    return all;
+}
+
+#if defined(ALGOPLUS_X86_DISPATCH)
+ALGOPLUS_TARGET("avx2") inline __m256i block_mask(uint32_t h) {
+    const __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(SALT));
+    const __m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(int(h)), salt), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), bit);
+}
+
+ALGOPLUS_TARGET("avx2") inline void block_insert_avx2(uint32_t* block, uint32_t h) {
+    __m256i* p = reinterpret_cast<__m256i*>(block);
+    _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), block_mask(h)));
+}
+
+ALGOPLUS_TARGET("avx2") inline bool block_contains_avx2(const uint32_t* block, uint32_t h) {
+    // testc is 1 when every bit of the mask is set in the block
+    return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block)),
+                              block_mask(h));
+}
+#endif
+
+inline const SIMD::kernels<void(uint32_t*, uint32_t)>& block_inserts() {
+    static const SIMD::kernels<void(uint32_t*, uint32_t)> k{
+        .scalar = &block_insert_scalar,
+#if defined(ALGOPLUS_X86_DISPATCH)
+        .avx2 = &block_insert_avx2,
+#endif
+    };
+    return k;
+}
+
+inline const SIMD::kernels<bool(const uint32_t*, uint32_t)>& block_lookups() {
+    static const SIMD::kernels<bool(const uint32_t*, uint32_t)> k{
+        .scalar = &block_contains_scalar,
+#if defined(ALGOPLUS_X86_DISPATCH)
+        .avx2 = &block_contains_avx2,
+#endif
+    };
+    return k;
+}
+} // namespace _bloom_filter_utils
+
+/**
+ * @brief bloom bits per key function
+ * @param fpr the false positive rate we want, in (0, 1)
+ * @return double the bits per key of the smallest Bloom filter with that rate, -ln(fpr) /
+ * ln(2)^2
+ */
+inline double bloom_bits_per_key(double fpr) {
+    _bloom_filter_utils::check_rate(fpr, "bloom_bits_per_key");
+    return -std::log(fpr) / (std::log(2.0) * std::log(2.0));
+}
+
+/**
+ * @brief bloom hashes function
+ * @param bits_per_key the bits of the filter per key
+ * @return size_t the number of hashes that gives the lowest false positive rate,
+ * bits_per_key * ln(2) rounded, from 1 to 30
+ */
+inline size_t bloom_hashes(double bits_per_key) {
+    return size_t(std::clamp(std::round(bits_per_key * std::log(2.0)), 1.0, 30.0));
+}
+
+/**
+ * @brief bloom false positive rate function
+ * @param bits the bits of the filter
+ * @param keys the number of keys inserted
+ * @param hashes the number of hashes per key
+ * @return double the expected false positive rate, (1 - e^(-hashes * keys / bits))^hashes
+ */
+inline double bloom_false_positive_rate(size_t bits, size_t keys, size_t hashes) {
+    if (bits == 0) {
+        return 1;
+    }
+    const double k = double(hashes);
+    return std::pow(1 - std::exp(-k * double(keys) / double(bits)), k);
+}
+
+/**
+ * @brief blocked bloom false positive rate function
+ * @param blocks the blocks of 256 bits of the filter
+ * @param keys the number of keys inserted
+ * @return double the expected false positive rate of blocked_bloom_filter: the keys of a
+ * block follow a Poisson law, and a block that holds j keys answers yes for another key with
+ * probability (1 - (31/32)^j)^8
+ */
+inline double blocked_bloom_false_positive_rate(size_t blocks, size_t keys) {
+    if (blocks == 0) {
+        return 1;
+    }
+    const double lambda = double(keys) / double(blocks);
+    const size_t last = size_t(lambda + 12 * std::sqrt(lambda) + 12);
+    double p = std::exp(-lambda), rate = 0;
+    for (size_t j = 0; j <= last; j++) {
+        rate += p * std::pow(1 - std::pow(31.0 / 32.0, double(j)), 8.0);
+        p *= lambda / double(j + 1);
+    }
+    return rate;
+}
+
+/**
+ * @brief blocked bloom blocks function
+ * @param keys the number of keys we expect
+ * @param fpr the false positive rate we want, in (0, 1)
+ * @return size_t the fewest blocks of 256 bits whose blocked_bloom_false_positive_rate for
+ * keys keys is at most fpr
+ */
+inline size_t blocked_bloom_blocks(size_t keys, double fpr) {
+    _bloom_filter_utils::check_rate(fpr, "blocked_bloom_blocks");
+    // the blocked filter needs a few more bits than the classic one
+    size_t lo = std::max<size_t>(1, size_t(double(keys) * bloom_bits_per_key(fpr) / 256));
+    size_t hi = lo;
+    while (blocked_bloom_false_positive_rate(hi, keys) > fpr) {
+        lo = hi + 1;
+        hi *= 2;
+    }
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (blocked_bloom_false_positive_rate(mid, keys) > fpr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return hi;
+}
+
+/**
+ * @brief bloom filter class
+ * Approximate set of keys: contains never misses a key that was inserted and says yes for
+ * another key with a small probability. The hashes bits of a key are picked by double hashing
+ * from one 64 bit hash, so a lookup touches up to hashes cache lines, see blocked_bloom_filter
+ * for one. Keys can not be removed.
+ * @tparam Key the type of the keys.
+ * @tparam Hash the hash function of the keys. Default = HASHING::hasher<Key>
+ */
+template <typename Key, typename Hash = HASHING::hasher<Key>> class bloom_filter {
+  public:
+    /**
+     * @brief Construct a new bloom filter object
+     * @param expected the number of keys we expect.
+     * @param fpr the false positive rate we want once they are inserted. Default = 0.01
+     * @param hash the hash function. Default = Hash()
+     * Throws std::invalid_argument if fpr is not in (0, 1).
+     */
+    explicit bloom_filter(size_t expected, double fpr = 0.01, const Hash& hash = Hash())
+        : _hash(hash) {
+        const double per_key = bloom_bits_per_key(fpr);
+        _bits = std::max<size_t>(64, size_t(std::ceil(double(expected) * per_key)));
+        _bits = (_bits + 63) / 64 * 64;
+        _hashes = uint32_t(bloom_hashes(per_key));
+        _words.assign(_bits / 64, 0);
+    }
+
+    /**
+     * @brief build function
+     * @param keys the keys, sized for them.
+     * @param fpr the false positive rate we want. Default = 0.01
+     * @return bloom_filter the filter of keys
+     */
+    static bloom_filter build(std::span<const Key> keys, double fpr = 0.01) {
+        bloom_filter f(keys.size(), fpr);
+        f.insert(keys.begin(), keys.end());
+        return f;
+    }
+
+    /**
+     * @brief insert function
+     * @param key the key to insert
+     */
+    void insert(const Key& key) {
+        _probe(key, [&](size_t bit) {
+            _words[bit / 64] |= uint64_t(1) << (bit % 64);
+            return true;
+        });
+        _size++;
+    }
+
+    /**
+     * @brief insert function
+     * @param first the first of the keys to insert
+     * @param last the end of the keys
+     */
+    template <typename It> void insert(It first, It last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    /**
+     * @brief contains function
+     * @param key the key to search
+     * @return true if key may have been inserted, false if it surely was not
+     */
+    bool contains(const Key& key) const {
+        return _probe(key, [&](size_t bit) { return (_words[bit / 64] >> (bit % 64)) & 1; });
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of keys inserted
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief bits function
+     * @return size_t the bits of the filter
+     */
+    size_t bits() const { return _bits; }
+
+    /**
+     * @brief hashes function
+     * @return size_t the bits set per key
+     */
+    size_t hashes() const { return _hashes; }
+
+    /**
+     * @brief false_positive_rate function
+     * @return double the expected false positive rate with the keys inserted so far
+     */
+    double false_positive_rate() const {
+        return bloom_false_positive_rate(_bits, _size, _hashes);
+    }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        std::fill(_words.begin(), _words.end(), 0);
+        _size = 0;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bytes of the filter, its bits are overhead since it keeps
+     * no key
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::as_overhead(MEMORY::heap_usage(_words));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    Hash _hash;
+    size_t _bits;
+    uint32_t _hashes;
+    size_t _size{0};
+    std::vector<uint64_t> _words;
+
+    // calls f with the bits of key until it returns false
+    template <typename F> bool _probe(const Key& key, F&& f) const {
+        const uint64_t h = HASHING::hash_of(_hash, key);
+        uint32_t a = uint32_t(h), b = uint32_t(h >> 32) | 1;
+        for (uint32_t i = 0; i < _hashes; i++, a += b) {
+            if (!f(_bloom_filter_utils::reduce(a, _bits))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief blocked bloom filter class
+ * Bloom filter whose keys each set 8 bits in one block of 256 bits, one bit in each of its 8
+ * words(split block Bloom filter). The blocks are aligned, so a lookup reads one cache line,
+ * and the 8 bits are set or tested with a few AVX2 instructions on a cpu that has them. It
+ * needs a few more bits per key than bloom_filter for the same false positive rate, which
+ * blocked_bloom_blocks accounts for. Keys can not be removed.
+ * @tparam Key the type of the keys.
+ * @tparam Hash the hash function of the keys. Default = HASHING::hasher<Key>
+ */
+template <typename Key, typename Hash = HASHING::hasher<Key>> class blocked_bloom_filter {
+  public:
+    /**
+     * @brief Construct a new blocked bloom filter object
+     * @param expected the number of keys we expect.
+     * @param fpr the false positive rate we want once they are inserted. Default = 0.01
+     * @param hash the hash function. Default = Hash()
+     * Throws std::invalid_argument if fpr is not in (0, 1).
+     */
+    explicit blocked_bloom_filter(size_t expected, double fpr = 0.01, const Hash& hash = Hash())
+        : _hash(hash), _blocks(blocked_bloom_blocks(expected, fpr)) {}
+
+    /**
+     * @brief build function
+     * @param keys the keys, sized for them.
+     * @param fpr the false positive rate we want. Default = 0.01
+     * @return blocked_bloom_filter the filter of keys
+     */
+    static blocked_bloom_filter build(std::span<const Key> keys, double fpr = 0.01) {
+        blocked_bloom_filter f(keys.size(), fpr);
+        f.insert(keys.begin(), keys.end());
+        return f;
+    }
+
+    /**
+     * @brief insert function
+     * @param key the key to insert
+     */
+    void insert(const Key& key) {
+        const uint64_t h = _mix(key);
+        _bloom_filter_utils::block_inserts().get()(_block(h)->word, uint32_t(h));
+        _size++;
+    }
+
+    /**
+     * @brief insert function
+     * The keys are hashed a group ahead and their blocks prefetched, so the cache misses of a
+     * group overlap.
+     * @param first the first of the keys to insert
+     * @param last the end of the keys
+     */
+    template <typename It> void insert(It first, It last) {
+        auto set = _bloom_filter_utils::block_inserts().get();
+        _grouped(first, last, [&](uint64_t h, size_t) {
+            set(_block(h)->word, uint32_t(h));
+            _size++;
+        });
+    }
+
+    /**
+     * @brief contains function
+     * @param key the key to search
+     * @return true if key may have been inserted, false if it surely was not
+     */
+    bool contains(const Key& key) const {
+        const uint64_t h = _mix(key);
+        return _bloom_filter_utils::block_lookups().get()(_block(h)->word, uint32_t(h));
+    }
+
+    /**
+     * @brief contains function
+     * @param keys the keys to search
+     * @return std::vector<bool> contains of every key, their blocks are prefetched a group
+     * ahead
+     */
+    std::vector<bool> contains(std::span<const Key> keys) const {
+        std::vector<bool> out(keys.size());
+        auto test = _bloom_filter_utils::block_lookups().get();
+        _grouped(keys.begin(), keys.end(),
+                 [&](uint64_t h, size_t i) { out[i] = test(_block(h)->word, uint32_t(h)); });
+        return out;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of keys inserted
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief blocks function
+     * @return size_t the blocks of 256 bits of the filter
+     */
+    size_t blocks() const { return _blocks.size(); }
+
+    /**
+     * @brief false_positive_rate function
+     * @return double the expected false positive rate with the keys inserted so far
+     */
+    double false_positive_rate() const {
+        return blocked_bloom_false_positive_rate(_blocks.size(), _size);
+    }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        std::fill(_blocks.begin(), _blocks.end(), block{});
+        _size = 0;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bytes of the filter, its bits are overhead since it keeps
+     * no key
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::as_overhead(MEMORY::heap_usage(_blocks));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    struct alignas(32) block {
+        uint32_t word[_bloom_filter_utils::WORDS]{};
+    };
+
+    static constexpr size_t GROUP = 16;
+
+    Hash _hash;
+    std::vector<block> _blocks;
+    size_t _size{0};
+
+    uint64_t _mix(const Key& key) const {
+        return HASHING::hash_of(_hash, key);
+    }
+
+    // the high 32 bits of the hash pick the block, the low 32 bits its 8 bits
+    block* _block(uint64_t h) {
+        return &_blocks[_bloom_filter_utils::reduce(uint32_t(h >> 32), _blocks.size())];
+    }
+
+    const block* _block(uint64_t h) const {
+        return &_blocks[_bloom_filter_utils::reduce(uint32_t(h >> 32), _blocks.size())];
+    }
+
+    // calls f(hash, index) for every key, GROUP at a time once their blocks are prefetched
+    template <typename It, typename F> void _grouped(It first, It last, F&& f) const {
+        uint64_t h[GROUP];
+        for (size_t base = 0; first != last; base += GROUP) {
+            size_t g = 0;
+            for (; g < GROUP && first != last; ++g, ++first) {
+                h[g] = _mix(*first);
+                _bloom_filter_utils::prefetch(_block(h[g]));
+            }
+            for (size_t i = 0; i < g; i++) {
+                f(h[i], base + i);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef CONCURRENT_HASH_TABLE_H
+#define CONCURRENT_HASH_TABLE_H
+
+#include "flat_hash_table.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+#endif
+
+/**
+ * @class concurrent_hash_table
+ * @tparam KeyType Type of the keys in the hash table.
+ * @tparam ValueType Type of the values in the hash table.
+ * @tparam Hash Hash function of the keys. Default = HASHING::hasher<KeyType>
+ *
+ * @brief Thread safe hash table with the API of hash_table.
+ * @details
+ * The keys are striped over a power of two number of shards by the high bits of their
+ * hash. Every shard is a flat_hash_table behind its own reader-writer lock on its own
+ * cache line, so readers never block each other and writers only contend when they
+ * hit the same shard. Every method can be called concurrently, the functors passed to
+ * upsert(), visit() and for_each() run under the shard lock and must not call back
+ * into the table.
+ */
+template <typename KeyType, typename ValueType, typename Hash = HASHING::hasher<KeyType>>
+class concurrent_hash_table {
+  public:
+    /**
+     * @brief Construct a new concurrent hash table object
+     *
+     * @param shards the number of lock stripes, rounded up to a power of two. A few
+     * times the number of threads keeps contention low. Default = 64
+     */
+    inline explicit concurrent_hash_table(size_t shards = 64)
+        : _bits(std::bit_width(std::bit_ceil(std::max<size_t>(shards, 1))) - 1),
+          _shards(size_t(1) << _bits) {}
+
+    /**
+     * @brief Inserts a key-value pair into the hash table.
+     * @details
+     * If a pair with the same key already exists, it updates the value.
+     * @param key The key to insert.
+     * @param value The value to insert.
+     */
+    inline void insert(const KeyType& key, const ValueType& value) {
+        _shard& s = _shard_of(key);
+        std::unique_lock lock(s.mutex);
+        s.table.insert(key, value);
+    }
+
+    /**
+     * @brief upsert function
+     * Updates the value of key in place, a default constructed value is inserted first
+     * if the key does not exist. The read-modify-write is atomic.
+     * @param key The key to update.
+     * @param f callable invoked as f(ValueType&) under the lock of the shard.
+     * @return true if the key was inserted.
+     */
+    template <typename F> inline bool upsert(const KeyType& key, F&& f) {
+        _shard& s = _shard_of(key);
+        std::unique_lock lock(s.mutex);
+        ValueType* value = s.table.find(key);
+        bool inserted = value == nullptr;
+        if (inserted) {
+            s.table.insert(key, ValueType{});
+            value = s.table.find(key);
+        }
+        f(*value);
+        return inserted;
+    }
+
+    /**
+     * @brief Retrieves the value associated with the given key.
+     * @param key The key to retrieve the value for.
+     * @return A copy of the value associated with the given key, if it exists.
+     * Otherwise, returns std::nullopt.
+     */
+    inline std::optional<ValueType> retrieve(const KeyType& key) const {
+        const _shard& s = _shard_of(key);
+        std::shared_lock lock(s.mutex);
+        return s.table.retrieve(key);
+    }
+
+    /**
+     * @brief visit function
+     * Reads the value of key without copying it.
+     * @param key The key to look up.
+     * @param f callable invoked as f(const ValueType&) under the shared lock of the
+     * shard, only if the key exists.
+     * @return true if the key exists.
+     */
+    template <typename F> inline bool visit(const KeyType& key, F&& f) const {
+        const _shard& s = _shard_of(key);
+        std::shared_lock lock(s.mutex);
+        const ValueType* value = s.table.find(key);
+        if (value != nullptr) {
+            f(*value);
+        }
+        return value != nullptr;
+    }
+
+    /**
+     * @brief contains function
+     * @param key The key to look up.
+     * @return true if the key exists in the hash table.
+     */
+    inline bool contains(const KeyType& key) const {
+        const _shard& s = _shard_of(key);
+        std::shared_lock lock(s.mutex);
+        return s.table.contains(key);
+    }
+
+    /**
+     * @brief Removes the key-value pair associated with the given key from the
+     * hash table.
+     * @param key The key to remove.
+     */
+    inline void remove(const KeyType& key) {
+        _shard& s = _shard_of(key);
+        std::unique_lock lock(s.mutex);
+        s.table.remove(key);
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of pairs, each shard is counted under its lock so the
+     * total may be stale if writers are running.
+     */
+    inline size_t size() const {
+        size_t total = 0;
+        for (const _shard& s : _shards) {
+            std::shared_lock lock(s.mutex);
+            total += s.table.size();
+        }
+        return total;
+    }
+
+    /**
+     * @brief shards function
+     * @return size_t the number of lock stripes.
+     */
+    inline size_t shards() const { return _shards.size(); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the footprints of the shards, each taken under its shared
+     * lock, with the table and the locks of the shards.
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        for (const _shard& s : _shards) {
+            std::shared_lock lock(s.mutex);
+            f += s.table.memory_usage();
+            f.control += sizeof(_shard) - sizeof(s.table);
+        }
+        f.control += sizeof(*this) + MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+    /**
+     * @brief for_each function
+     * Visits every pair, one shard at a time under its shared lock.
+     * @param f callable invoked as f(const KeyType&, const ValueType&).
+     */
+    template <typename F> inline void for_each(F&& f) const {
+        for (const _shard& s : _shards) {
+            std::shared_lock lock(s.mutex);
+            for (const auto& pair : s.table) {
+                f(pair.first, pair.second);
+            }
+        }
+    }
+
+    /**
+     * @brief clear function
+     */
+    inline void clear() {
+        for (_shard& s : _shards) {
+            std::unique_lock lock(s.mutex);
+            s.table.clear();
+        }
+    }
+
+  private:
+    // one cache line per shard, so two locks never share a line
+    struct alignas(64) _shard {
+        mutable std::shared_mutex mutex;
+        flat_hash_table<KeyType, ValueType, Hash> table;
+    };
+
+    Hash hash;
+    size_t _bits;
+    std::vector<_shard> _shards;
+
+    size_t _index(const KeyType& key) const {
+        // the flat tables use the low bits of the same mixed hash
+        uint64_t h = HASHING::hash_of(hash, key);
+        return _bits == 0 ? 0 : static_cast<size_t>(h >> (64 - _bits));
+    }
+
+    _shard& _shard_of(const KeyType& key) { return _shards[_index(key)]; }
+
+    const _shard& _shard_of(const KeyType& key) const { return _shards[_index(key)]; }
+};
+
+#endif // CONCURRENT_HASH_TABLE_H
@@ -0,0 +1,272 @@
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include "bloom_filter.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief cuckoo false positive rate function
+ * @param fingerprint_bits the bits of a fingerprint
+ * @param load the fraction of the slots that hold a fingerprint. Default = 0.95
+ * @return double the expected false positive rate of a cuckoo_filter: a lookup compares 8
+ * slots, each holds a fingerprint with probability load that is the one of the key with
+ * probability 1 / (2^bits - 1)
+ */
+inline double cuckoo_false_positive_rate(size_t fingerprint_bits, double load = 0.95) {
+    const double values = std::ldexp(1.0, int(fingerprint_bits)) - 1;
+    return 1 - std::pow(1 - 1 / values, 8 * load);
+}
+
+/**
+ * @brief cuckoo filter class
+ * Approximate set of keys that also removes them(Fan, Andersen, Kaminsky and Mitzenmacher):
+ * every key keeps a fingerprint of its hash in one of two buckets of 4 slots, the second
+ * bucket is the first xor the hash of the fingerprint, so a fingerprint moves between its two
+ * buckets without the key. A lookup reads two buckets, and says yes for a key that was not
+ * inserted with probability cuckoo_false_positive_rate. An insert that finds both buckets
+ * full kicks fingerprints to their other bucket, and fails once 500 kicks are not enough,
+ * at about 95% of the slots full; the fingerprint kicked out last is kept aside, so no key
+ * that was inserted is ever lost. Only remove keys that were inserted: removing another key
+ * that shares a fingerprint removes that one instead.
+ * @tparam Key the type of the keys.
+ * @tparam Hash the hash function of the keys. Default = HASHING::hasher<Key>
+ * @tparam Fingerprint the unsigned type of the fingerprints, uint8_t for about 3% false
+ * positives, uint16_t for about 0.01%, uint32_t. Default = uint16_t
+ */
+template <typename Key, typename Hash = HASHING::hasher<Key>, typename Fingerprint = uint16_t>
+class cuckoo_filter {
+    static_assert(std::is_unsigned_v<Fingerprint>, "fingerprints must be unsigned");
+
+  public:
+    static constexpr size_t BUCKET = 4;
+    static constexpr size_t MAX_KICKS = 500;
+
+    /**
+     * @brief Construct a new cuckoo filter object
+     * @param capacity the number of keys we expect, the filter gets a power of two of
+     * buckets that holds them at 95% load at most.
+     * @param hash the hash function. Default = Hash()
+     */
+    explicit cuckoo_filter(size_t capacity, const Hash& hash = Hash()) : _hash(hash) {
+        size_t buckets = size_t(std::ceil(double(capacity) / (0.95 * BUCKET)));
+        _buckets = std::bit_ceil(std::max<size_t>(1, buckets));
+        _slots.assign(_buckets * BUCKET, 0);
+    }
+
+    /**
+     * @brief build function
+     * @param keys the keys, sized for them.
+     * @return cuckoo_filter the filter of keys
+     * Throws std::length_error if a key does not fit, which only a hash of poor quality
+     * causes at this load.
+     */
+    static cuckoo_filter build(std::span<const Key> keys) {
+        cuckoo_filter f(keys.size());
+        for (const Key& k : keys) {
+            if (!f.insert(k)) {
+                throw std::length_error("cuckoo_filter::build: the filter is full");
+            }
+        }
+        return f;
+    }
+
+    /**
+     * @brief insert function
+     * @param key the key to insert
+     * @return true if it was inserted, false if the filter is full
+     */
+    bool insert(const Key& key) {
+        if (_victim.used) {
+            return false;
+        }
+        auto [fp, i] = _locate(key);
+        _place(i, fp);
+        return true;
+    }
+
+    /**
+     * @brief contains function
+     * @param key the key to search
+     * @return true if key may have been inserted, false if it surely was not
+     */
+    bool contains(const Key& key) const {
+        auto [fp, i1] = _locate(key);
+        const size_t i2 = _alternate(i1, fp);
+        if (_victim.used && _victim.fp == fp && (_victim.bucket == i1 || _victim.bucket == i2)) {
+            return true;
+        }
+        return _has(i1, fp) || _has(i2, fp);
+    }
+
+    /**
+     * @brief remove function
+     * @param key a key that was inserted
+     * @return true if a fingerprint of key was removed
+     */
+    bool remove(const Key& key) {
+        auto [fp, i1] = _locate(key);
+        const size_t i2 = _alternate(i1, fp);
+        if (_victim.used && _victim.fp == fp && (_victim.bucket == i1 || _victim.bucket == i2)) {
+            _victim.used = false;
+            _size--;
+            return true;
+        }
+        if (!_erase(i1, fp) && !_erase(i2, fp)) {
+            return false;
+        }
+        _size--;
+        if (_victim.used) {
+            // a slot is free now, the fingerprint aside may fit again
+            _victim.used = false;
+            _size--;
+            _place(_victim.bucket, _victim.fp);
+        }
+        return true;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of keys in the filter
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief capacity function
+     * @return size_t the number of slots
+     */
+    size_t capacity() const { return _slots.size(); }
+
+    /**
+     * @brief load_factor function
+     * @return double the fraction of the slots that hold a fingerprint
+     */
+    double load_factor() const {
+        return double(_size - size_t(_victim.used)) / double(capacity());
+    }
+
+    /**
+     * @brief false_positive_rate function
+     * @return double the expected false positive rate at the current load
+     */
+    double false_positive_rate() const {
+        return cuckoo_false_positive_rate(8 * sizeof(Fingerprint), load_factor());
+    }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        std::fill(_slots.begin(), _slots.end(), Fingerprint(0));
+        _victim.used = false;
+        _size = 0;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bytes of the filter, its fingerprints are overhead since it
+     * keeps no key
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::as_overhead(MEMORY::heap_usage(_slots));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    struct victim {
+        bool used{false};
+        size_t bucket{0};
+        Fingerprint fp{0};
+    };
+
+    Hash _hash;
+    size_t _buckets;
+    size_t _size{0};
+    // BUCKET slots per bucket, 0 is an empty slot
+    std::vector<Fingerprint> _slots;
+    victim _victim;
+    uint64_t _state{0x9E3779B97F4A7C15ULL};
+
+    uint64_t _rng() {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return _state;
+    }
+
+    // the fingerprint of key, never 0, and its first bucket
+    std::pair<Fingerprint, size_t> _locate(const Key& key) const {
+        const uint64_t h = HASHING::hash_of(_hash, key);
+        constexpr uint64_t values = uint64_t(std::numeric_limits<Fingerprint>::max());
+        const Fingerprint fp = Fingerprint((h >> 32) % values + 1);
+        return {fp, size_t(h) & (_buckets - 1)};
+    }
+
+    size_t _alternate(size_t i, Fingerprint fp) const {
+        return (i ^ size_t(HASHING::mix(fp))) & (_buckets - 1);
+    }
+
+    bool _has(size_t i, Fingerprint fp) const {
+        const Fingerprint* b = &_slots[i * BUCKET];
+        bool any = false;
+        for (size_t s = 0; s < BUCKET; s++) {
+            any |= b[s] == fp;
+        }
+        return any;
+    }
+
+    bool _put(size_t i, Fingerprint fp) {
+        Fingerprint* b = &_slots[i * BUCKET];
+        for (size_t s = 0; s < BUCKET; s++) {
+            if (b[s] == 0) {
+                b[s] = fp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool _erase(size_t i, Fingerprint fp) {
+        Fingerprint* b = &_slots[i * BUCKET];
+        for (size_t s = 0; s < BUCKET; s++) {
+            if (b[s] == fp) {
+                b[s] = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // puts fp in bucket i or in its alternate, kicking fingerprints to their other bucket when
+    // both are full, the one kicked out last is kept aside
+    void _place(size_t i, Fingerprint fp) {
+        _size++;
+        if (_put(i, fp) || _put(_alternate(i, fp), fp)) {
+            return;
+        }
+        for (size_t kick = 0; kick < MAX_KICKS; kick++) {
+            Fingerprint& slot = _slots[i * BUCKET + (_rng() % BUCKET)];
+            std::swap(fp, slot);
+            i = _alternate(i, fp);
+            if (_put(i, fp)) {
+                return;
+            }
+        }
+        _victim = {true, i, fp};
+    }
+};
+
+#endif
@@ -0,0 +1,484 @@
+#ifndef FLAT_HASH_TABLE_H
+#define FLAT_HASH_TABLE_H
+
+#include "../../helpers/fast_hash.h"
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace _flat_hash_utils {
+/**
+ * @brief control byte of a slot: empty, deleted(a tombstone) or the low 7 bits of the
+ * hash of the key it holds
+ */
+constexpr int8_t EMPTY = -128;
+constexpr int8_t DELETED = -2;
+constexpr size_t GROUP = 16;
+
+/**
+ * @brief 16 control bytes compared at once, every mask has one bit per slot
+ */
+struct group {
+#if defined(__SSE2__)
+    __m128i ctrl;
+
+    explicit group(const int8_t* p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    uint32_t match(int8_t h2) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+    }
+
+    uint32_t match_empty() const { return match(EMPTY); }
+
+    // empty and deleted are the only negative bytes
+    uint32_t match_free() const { return static_cast<uint32_t>(_mm_movemask_epi8(ctrl)); }
+#else
+    int8_t ctrl[GROUP];
+
+    explicit group(const int8_t* p) { std::memcpy(ctrl, p, GROUP); }
+
+    uint32_t match(int8_t h2) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; i++) {
+            mask |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+        }
+        return mask;
+    }
+
+    uint32_t match_empty() const { return match(EMPTY); }
+
+    uint32_t match_free() const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; i++) {
+            mask |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+        }
+        return mask;
+    }
+#endif
+};
+} // namespace _flat_hash_utils
+
+/**
+ * @class flat_hash_table
+ * @tparam KeyType Type of the keys in the hash table.
+ * @tparam ValueType Type of the values in the hash table.
+ * @tparam Hash Hash function of the keys. Default = HASHING::hasher<KeyType>
+ *
+ * @brief Open addressing hash table with the API of hash_table.
+ * @details
+ * Pairs are stored inline in one flat array next to an array of one byte per slot,
+ * in the style of SwissTable: 7 bits of the hash of every key are kept in its control
+ * byte, and a lookup compares a group of 16 control bytes with one SIMD instruction
+ * (SSE2 if available) before touching any key. Groups are probed quadratically and the
+ * table grows once it is 7/8 full. Removals leave a tombstone only if the group has
+ * no empty slot. Iterators and references are invalidated by insertions.
+ */
+template <typename KeyType, typename ValueType, typename Hash = HASHING::hasher<KeyType>>
+class flat_hash_table {
+  public:
+    using value_type = std::pair<KeyType, ValueType>;
+
+    /**
+     * @brief Construct a new flat hash table object
+     *
+     * @param v the initializer vector
+     */
+    inline explicit flat_hash_table(std::vector<std::pair<KeyType, ValueType>> v = {}) {
+        reserve(v.size());
+        for (auto& x : v) {
+            this->insert(x.first, x.second);
+        }
+    }
+
+    /**
+     * @brief Copy constructor of the flat_hash_table
+     *
+     * @param h the hash table we want to copy
+     */
+    inline flat_hash_table(const flat_hash_table& h) : hash(h.hash) {
+        reserve(h.size());
+        for (const value_type& x : h) {
+            _insert_new(x.first, x.second);
+        }
+    }
+
+    inline flat_hash_table(flat_hash_table&& h) noexcept { _swap(h); }
+
+    /**
+     * @brief operator = for the flat_hash_table class
+     * @param h the hash table we want to copy
+     * @return flat_hash_table&
+     */
+    inline flat_hash_table& operator=(const flat_hash_table& h) {
+        if (this != &h) {
+            flat_hash_table copy(h);
+            _swap(copy);
+        }
+        return *this;
+    }
+
+    inline flat_hash_table& operator=(flat_hash_table&& h) noexcept {
+        if (this != &h) {
+            flat_hash_table empty;
+            _swap(empty);
+            _swap(h);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destroy the flat hash table object
+     */
+    inline ~flat_hash_table() { _release(); }
+
+    /**
+     * @brief Inserts a key-value pair into the hash table.
+     * @details
+     * If a pair with the same key already exists, it updates the value.
+     * @param key The key to insert.
+     * @param value The value to insert.
+     */
+    inline void insert(const KeyType& key, const ValueType& value) {
+        size_t i = _find(key);
+        if (i != npos) {
+            _slots[i].second = value;
+            return;
+        }
+        _insert_new(key, value);
+    }
+
+    /**
+     * @brief Retrieves the value associated with the given key.
+     * @param key The key to retrieve the value for.
+     * @return The value associated with the given key, if it exists. Otherwise,
+     * returns std::nullopt.
+     */
+    inline std::optional<ValueType> retrieve(const KeyType& key) const {
+        size_t i = _find(key);
+        if (i == npos) {
+            return std::nullopt;
+        }
+        return _slots[i].second;
+    }
+
+    /**
+     * @brief Looks up the value associated with the given key without copying it.
+     * @param key The key to look up.
+     * @return A pointer to the value, nullptr if the key does not exist. The pointer is
+     * invalidated by the next insertion.
+     */
+    inline ValueType* find(const KeyType& key) {
+        size_t i = _find(key);
+        return i == npos ? nullptr : &_slots[i].second;
+    }
+
+    inline const ValueType* find(const KeyType& key) const {
+        size_t i = _find(key);
+        return i == npos ? nullptr : &_slots[i].second;
+    }
+
+    /**
+     * @brief contains function
+     * @param key The key to look up.
+     * @return true if the key exists in the hash table.
+     */
+    inline bool contains(const KeyType& key) const { return _find(key) != npos; }
+
+    /**
+     * @brief Removes the key-value pair associated with the given key from the
+     * hash table.
+     * @param key The key to remove.
+     */
+    inline void remove(const KeyType& key) {
+        size_t i = _find(key);
+        if (i == npos) {
+            return;
+        }
+        std::destroy_at(_slots + i);
+        _size--;
+        // a probe only continues past a group without empty slots
+        if (_flat_hash_utils::group(_ctrl.data() + i / GROUP * GROUP).match_empty()) {
+            _ctrl[i] = _flat_hash_utils::EMPTY;
+        } else {
+            _ctrl[i] = _flat_hash_utils::DELETED;
+            _deleted++;
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of pairs in the hash table.
+     */
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief empty function
+     * @return true if the hash table has no pairs.
+     */
+    inline bool empty() const { return _size == 0; }
+
+    /**
+     * @brief capacity function
+     * @return size_t the number of slots.
+     */
+    inline size_t capacity() const { return _ctrl.size(); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the pairs, their control bytes, the table with the headers of
+     * its arrays, and the free and deleted slots with their control bytes.
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.payload = _size * sizeof(value_type);
+        if constexpr (MEMORY::may_own_heap_v<value_type>) {
+            for (size_t i = 0; i < capacity(); i++) {
+                if (_ctrl[i] >= 0) {
+                    f.payload += MEMORY::heap_bytes(_slots[i]);
+                }
+            }
+        }
+        f.node_overhead = _size * sizeof(int8_t);
+        f.slack = (capacity() - _size) * (sizeof(value_type) + sizeof(int8_t));
+        f.control = sizeof(*this) + (_slots != nullptr ? 2 * MEMORY::ALLOCATION_OVERHEAD : 0);
+        return f;
+    }
+
+    /**
+     * @brief reserve function
+     * @param n the number of pairs we expect, no rehash happens until there are more.
+     */
+    inline void reserve(size_t n) {
+        if (n == 0) {
+            return;
+        }
+        size_t slots = GROUP;
+        while (slots / 8 * 7 < n) {
+            slots *= 2;
+        }
+        if (slots > capacity()) {
+            _rehash(slots);
+        }
+    }
+
+    /**
+     * @brief clear function
+     * Removes every pair, the slots are kept.
+     */
+    inline void clear() {
+        for (size_t i = 0; i < capacity(); i++) {
+            if (_ctrl[i] >= 0) {
+                std::destroy_at(_slots + i);
+            }
+        }
+        std::fill(_ctrl.begin(), _ctrl.end(), _flat_hash_utils::EMPTY);
+        _size = _deleted = 0;
+    }
+
+    template <bool Const> class Iterator;
+
+    inline Iterator<false> begin() { return Iterator<false>(this, 0); }
+
+    inline Iterator<false> end() { return Iterator<false>(this, capacity()); }
+
+    inline Iterator<true> begin() const { return Iterator<true>(this, 0); }
+
+    inline Iterator<true> end() const { return Iterator<true>(this, capacity()); }
+
+    /**
+     * @brief << operator for flat_hash_table class
+     * @return std::ostream&
+     */
+    inline friend std::ostream& operator<<(std::ostream& out, const flat_hash_table& h) {
+        out << '[';
+        for (const value_type& pair : h) {
+            out << "{" << pair.first << ", " << pair.second << "} ";
+        }
+        out << ']';
+        return out;
+    }
+
+  private:
+    static constexpr size_t GROUP = _flat_hash_utils::GROUP;
+    static constexpr size_t npos = SIZE_MAX;
+
+    Hash hash;
+    std::vector<int8_t> _ctrl;
+    value_type* _slots{nullptr};
+    size_t _size{0};
+    size_t _deleted{0};
+
+    void _swap(flat_hash_table& h) noexcept {
+        std::swap(hash, h.hash);
+        _ctrl.swap(h._ctrl);
+        std::swap(_slots, h._slots);
+        std::swap(_size, h._size);
+        std::swap(_deleted, h._deleted);
+    }
+
+    void _release() {
+        if (_slots == nullptr) {
+            return;
+        }
+        clear();
+        std::allocator<value_type>().deallocate(_slots, capacity());
+        _slots = nullptr;
+        _ctrl.clear();
+    }
+
+    /**
+     * @brief calls f(group start) on the groups of the probe sequence of hash h until f
+     * returns true, quadratic steps over the groups visit each of them once
+     */
+    template <typename F> void _probe(uint64_t h, F&& f) const {
+        const size_t mask = capacity() / GROUP - 1;
+        size_t g = static_cast<size_t>(h >> 7) & mask;
+        for (size_t step = 1; !f(g * GROUP); step++) {
+            g = (g + step) & mask;
+        }
+    }
+
+    size_t _find(const KeyType& key) const {
+        if (_size == 0) {
+            return npos;
+        }
+        const uint64_t h = HASHING::hash_of(hash, key);
+        const int8_t h2 = static_cast<int8_t>(h & 0x7F);
+        size_t found = npos, groups = 0, total = capacity() / GROUP;
+        _probe(h, [&](size_t start) {
+            _flat_hash_utils::group grp(_ctrl.data() + start);
+            for (uint32_t m = grp.match(h2); m != 0; m &= m - 1) {
+                size_t i = start + std::countr_zero(m);
+                if (_slots[i].first == key) {
+                    found = i;
+                    return true;
+                }
+            }
+            return grp.match_empty() != 0 || ++groups == total;
+        });
+        return found;
+    }
+
+    /**
+     * @brief places a key that is not in the table
+     */
+    void _insert_new(const KeyType& key, const ValueType& value) {
+        if (capacity() == 0 || (_size + _deleted + 1) > capacity() / 8 * 7) {
+            // tombstones are purged in place unless the live pairs need more room
+            bool grow = _size + 1 > capacity() / 16 * 7;
+            _rehash(grow ? std::max(GROUP, 2 * capacity()) : capacity());
+        }
+        const uint64_t h = HASHING::hash_of(hash, key);
+        size_t i = _free_slot(h);
+        _deleted -= _ctrl[i] == _flat_hash_utils::DELETED;
+        std::construct_at(_slots + i, key, value);
+        _ctrl[i] = static_cast<int8_t>(h & 0x7F);
+        _size++;
+    }
+
+    size_t _free_slot(uint64_t h) const {
+        size_t slot = npos;
+        _probe(h, [&](size_t start) {
+            uint32_t m = _flat_hash_utils::group(_ctrl.data() + start).match_free();
+            if (m != 0) {
+                slot = start + std::countr_zero(m);
+            }
+            return m != 0;
+        });
+        return slot;
+    }
+
+    void _rehash(size_t slots) {
+        std::vector<int8_t> old_ctrl(slots, _flat_hash_utils::EMPTY);
+        value_type* old_slots = std::allocator<value_type>().allocate(slots);
+        old_ctrl.swap(_ctrl);
+        std::swap(old_slots, _slots);
+        for (size_t i = 0; i < old_ctrl.size(); i++) {
+            if (old_ctrl[i] >= 0) {
+                const uint64_t h = HASHING::hash_of(hash, old_slots[i].first);
+                size_t j = _free_slot(h);
+                std::construct_at(_slots + j, std::move(old_slots[i]));
+                _ctrl[j] = old_ctrl[i];
+                std::destroy_at(old_slots + i);
+            }
+        }
+        _deleted = 0;
+        if (old_slots != nullptr) {
+            std::allocator<value_type>().deallocate(old_slots, old_ctrl.size());
+        }
+    }
+};
+
+/**
+ * @brief Iterator class, visits the pairs in slot order
+ */
+template <typename KeyType, typename ValueType, typename Hash>
+template <bool Const>
+class flat_hash_table<KeyType, ValueType, Hash>::Iterator {
+  private:
+    using table = std::conditional_t<Const, const flat_hash_table, flat_hash_table>;
+    table* _table;
+    size_t _index;
+
+    void _skip() {
+        while (_index < _table->capacity() && _table->_ctrl[_index] < 0) {
+            _index++;
+        }
+    }
+
+  public:
+    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+    Iterator(table* t, size_t index) : _table(t), _index(index) { _skip(); }
+
+    /**
+     * @brief operator ++ for type Iterator
+     *
+     * @return Iterator&
+     */
+    Iterator& operator++() {
+        _index++;
+        _skip();
+        return *this;
+    }
+
+    /**
+     * @brief operator ++ for type Iterator
+     *
+     * @return Iterator
+     */
+    Iterator operator++(int) {
+        Iterator it = *this;
+        ++*(this);
+        return it;
+    }
+
+    bool operator==(const Iterator& it) const { return _index == it._index; }
+
+    bool operator!=(const Iterator& it) const { return _index != it._index; }
+
+    /**
+     * @brief operator * for Type Iterator
+     *
+     * @return the pair at the current slot
+     */
+    reference operator*() const { return _table->_slots[_index]; }
+};
+
+#endif // FLAT_HASH_TABLE_H
@@ -0,0 +1,379 @@
+#ifndef HASH_SNAPSHOT_H
+#define HASH_SNAPSHOT_H
+
+#include "../../helpers/mapped_file.h"
+#include "flat_hash_table.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief fixed size header at the start of a hash snapshot file
+ * The file is native-endian, every section starts at a multiple of 8 bytes:
+ * pilots(uint32_t[buckets]), keys(K[slots]), values(V[slots]). A key is found in one
+ * probe: its hash picks a bucket, the pilot of the bucket picks the slot.
+ */
+struct hash_snapshot_header {
+    static constexpr uint32_t MAGIC = 0x53485041; // "APHS" read as little endian
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic{MAGIC};
+    uint32_t version{VERSION};
+    uint32_t key_size{0};
+    uint32_t value_size{0};
+    uint64_t seed{0};
+    uint64_t count{0};
+    uint64_t slots{0};
+    uint64_t buckets{0};
+    uint64_t pilots_at{0};
+    uint64_t keys_at{0};
+    uint64_t values_at{0};
+    uint64_t size{0};
+};
+
+namespace _hash_snapshot_utils {
+// average number of keys per bucket, smaller buckets build faster but take more pilots
+static constexpr uint64_t BUCKET_KEYS = 4;
+// pilots with this bit set store the slot of a single key bucket directly
+static constexpr uint32_t DIRECT = uint32_t(1) << 31;
+static constexpr uint32_t MAX_PILOT = uint32_t(1) << 20;
+static constexpr uint64_t MAX_SEEDS = 16;
+static constexpr uint64_t GOLDEN = HASHING::GOLDEN;
+
+template <typename K, typename V> constexpr void check_types() {
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "hash snapshots need trivially copyable keys and values");
+    static_assert(std::has_unique_object_representations_v<K>,
+                  "hash snapshot keys are compared bytewise, they can't have padding");
+    static_assert(alignof(K) <= 8 && alignof(V) <= 8,
+                  "hash snapshot sections are only 8 byte aligned");
+}
+
+/**
+ * @brief hash of the bytes of a key, independent of std::hash so a snapshot can be
+ * read by another build
+ */
+inline uint64_t hash_bytes(const void* data, size_t bytes, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = HASHING::mix(seed + GOLDEN);
+    for (; bytes >= 8; p += 8, bytes -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = HASHING::mix(h ^ word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, bytes);
+    return HASHING::mix(h ^ tail);
+}
+
+inline uint64_t slot(uint64_t h, uint32_t pilot, uint64_t slots) {
+    if (pilot & DIRECT) {
+        return pilot & ~DIRECT;
+    }
+    return HASHING::mix(h ^ (pilot * GOLDEN)) % slots;
+}
+
+/**
+ * @brief finds a pilot for every bucket so the keys land on distinct slots, biggest
+ * buckets first while the table is still empty. Returns false if a bucket ran out of
+ * pilots, the caller retries with another seed.
+ */
+inline bool place(const std::vector<uint64_t>& hashes, uint64_t slots,
+                  std::vector<uint32_t>& pilots, std::vector<uint64_t>& slot_of) {
+    const size_t n = hashes.size(), buckets = pilots.size();
+    std::vector<size_t> start(buckets + 1, 0), items(n);
+    for (uint64_t h : hashes) {
+        start[h % buckets + 1]++;
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<size_t> fill(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < n; i++) {
+        items[fill[hashes[i] % buckets]++] = i;
+    }
+    std::vector<size_t> order(buckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return start[a + 1] - start[a] > start[b + 1] - start[b];
+    });
+
+    std::vector<bool> taken(slots, false);
+    std::vector<uint64_t> cand;
+    size_t next_free = 0;
+    for (size_t b : order) {
+        const size_t lo = start[b], hi = start[b + 1];
+        if (hi - lo == 0) {
+            break;
+        }
+        if (hi - lo == 1) {
+            while (taken[next_free]) {
+                next_free++;
+            }
+            taken[next_free] = true;
+            slot_of[items[lo]] = next_free;
+            pilots[b] = DIRECT | static_cast<uint32_t>(next_free);
+            continue;
+        }
+        bool placed = false;
+        for (uint32_t pilot = 0; pilot < MAX_PILOT && !placed; pilot++) {
+            cand.clear();
+            for (size_t j = lo; j < hi; j++) {
+                uint64_t s = slot(hashes[items[j]], pilot, slots);
+                if (taken[s] || std::find(cand.begin(), cand.end(), s) != cand.end()) {
+                    break;
+                }
+                cand.push_back(s);
+            }
+            if (cand.size() == hi - lo) {
+                for (size_t j = lo; j < hi; j++) {
+                    taken[cand[j - lo]] = true;
+                    slot_of[items[j]] = cand[j - lo];
+                }
+                pilots[b] = pilot;
+                placed = true;
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline uint64_t align(uint64_t x) { return (x + 7) & ~uint64_t(7); }
+
+inline void write(std::ofstream& out, const void* data, size_t bytes) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+
+inline void pad(std::ofstream& out, uint64_t written) {
+    static const char zeros[8] = {};
+    write(out, zeros, align(written) - written);
+}
+} // namespace _hash_snapshot_utils
+
+/**
+ * @brief save_hash_snapshot function
+ * Builds a perfect hash of a static set of pairs and writes it in the hash snapshot
+ * format, see hash_snapshot_view to query it. With load = 1 the hash is minimal: the
+ * file holds exactly one slot per pair. Smaller loads leave free slots, the pilots are
+ * found faster on big sets.
+ * @param pairs: the key-value pairs, every key must be distinct.
+ * @param path: the output file, overwritten.
+ * @param load: keys per slot, in (0, 1]. Default = 1
+ * Throws std::invalid_argument for duplicate keys or a bad load and std::runtime_error
+ * if the file can not be written(or, very unlikely, no seed gives a perfect hash).
+ */
+template <typename K, typename V>
+void save_hash_snapshot(const std::vector<std::pair<K, V>>& pairs, const std::string& path,
+                        double load = 1.0) {
+    using namespace _hash_snapshot_utils;
+    check_types<K, V>();
+    if (!(load > 0 && load <= 1)) {
+        throw std::invalid_argument("save_hash_snapshot: load must be in (0, 1]");
+    }
+    const uint64_t n = pairs.size();
+    const uint64_t slots = std::max<uint64_t>(n, std::ceil(n / load));
+    if (slots >= DIRECT) {
+        throw std::invalid_argument("save_hash_snapshot: too many keys");
+    }
+
+    hash_snapshot_header h;
+    h.key_size = sizeof(K);
+    h.value_size = sizeof(V);
+    h.count = n;
+    h.slots = slots;
+    h.buckets = std::max<uint64_t>(1, (n + BUCKET_KEYS - 1) / BUCKET_KEYS);
+    std::vector<uint64_t> hashes(n), slot_of(n);
+    std::vector<uint32_t> pilots(h.buckets, 0);
+    for (;; h.seed++) {
+        if (h.seed == MAX_SEEDS) {
+            throw std::runtime_error("save_hash_snapshot: no perfect hash found");
+        }
+        for (size_t i = 0; i < n; i++) {
+            hashes[i] = hash_bytes(&pairs[i].first, sizeof(K), h.seed);
+        }
+        if (h.seed == 0) {
+            // equal keys collide in every pilot, find them before searching
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(),
+                      [&](size_t a, size_t b) { return hashes[a] < hashes[b]; });
+            for (size_t i = 1; i < n; i++) {
+                size_t a = order[i - 1], b = order[i];
+                if (hashes[a] == hashes[b] &&
+                    std::memcmp(&pairs[a].first, &pairs[b].first, sizeof(K)) == 0) {
+                    throw std::invalid_argument("save_hash_snapshot: duplicate keys");
+                }
+            }
+        }
+        if (place(hashes, slots, pilots, slot_of)) {
+            break;
+        }
+    }
+
+    // free slots repeat the first key, which never hashes to them
+    std::vector<char> keys(sizeof(K) * slots), values(sizeof(V) * slots, 0);
+    for (uint64_t s = 0; n > 0 && s < slots; s++) {
+        std::memcpy(keys.data() + sizeof(K) * s, &pairs[0].first, sizeof(K));
+    }
+    for (size_t i = 0; i < n; i++) {
+        std::memcpy(keys.data() + sizeof(K) * slot_of[i], &pairs[i].first, sizeof(K));
+        std::memcpy(values.data() + sizeof(V) * slot_of[i], &pairs[i].second, sizeof(V));
+    }
+    h.pilots_at = align(sizeof(hash_snapshot_header));
+    h.keys_at = align(h.pilots_at + 4 * h.buckets);
+    h.values_at = align(h.keys_at + keys.size());
+    h.size = h.values_at + values.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Can't open file " + path);
+    }
+    write(out, &h, sizeof(h));
+    pad(out, sizeof(h));
+    write(out, pilots.data(), 4 * pilots.size());
+    pad(out, h.pilots_at + 4 * h.buckets);
+    write(out, keys.data(), keys.size());
+    pad(out, h.keys_at + keys.size());
+    write(out, values.data(), values.size());
+    if (!out.flush()) {
+        throw std::runtime_error("Can't write file " + path);
+    }
+}
+
+/**
+ * @brief save_hash_snapshot function
+ * Writes the pairs of a flat_hash_table, see save_hash_snapshot above.
+ */
+template <typename K, typename V, typename Hash>
+void save_hash_snapshot(const flat_hash_table<K, V, Hash>& table, const std::string& path,
+                        double load = 1.0) {
+    std::vector<std::pair<K, V>> pairs;
+    pairs.reserve(table.size());
+    for (const auto& pair : table) {
+        pairs.emplace_back(pair.first, pair.second);
+    }
+    save_hash_snapshot(pairs, path, load);
+}
+
+/**
+ * @brief hash_snapshot_view class
+ * Maps a file written by save_hash_snapshot and answers lookups in place: nothing is
+ * parsed or copied and a lookup touches one pilot, one key and one value. The mapping
+ * is read only, so worker processes opening the same file share one copy of it in the
+ * page cache. The header is validated on construction.
+ */
+template <typename K, typename V> class hash_snapshot_view {
+  public:
+    /**
+     * @brief Construct a new hash_snapshot_view object
+     * @param path: the snapshot file.
+     * Throws std::runtime_error if the file can not be read, has a different version,
+     * was written for other key or value types or is truncated.
+     */
+    explicit hash_snapshot_view(const std::string& path) : _file(path, file_access::random) {
+        _hash_snapshot_utils::check_types<K, V>();
+        std::string_view data = _file.view();
+        if (data.size() < sizeof(hash_snapshot_header)) {
+            throw std::runtime_error("Snapshot " + path + " is truncated");
+        }
+        std::memcpy(&_h, data.data(), sizeof(_h));
+        if (_h.magic != hash_snapshot_header::MAGIC) {
+            throw std::runtime_error(path + " is not a hash snapshot");
+        }
+        if (_h.version != hash_snapshot_header::VERSION) {
+            throw std::runtime_error("Snapshot " + path + " has unsupported version " +
+                                     std::to_string(_h.version));
+        }
+        if (_h.key_size != sizeof(K) || _h.value_size != sizeof(V)) {
+            throw std::runtime_error("Snapshot " + path + " was written for other types");
+        }
+        if (_h.size != data.size()) {
+            throw std::runtime_error("Snapshot " + path + " is truncated");
+        }
+        if (_h.buckets == 0 || _h.count > _h.slots ||
+            _h.values_at + sizeof(V) * _h.slots != _h.size) {
+            throw std::runtime_error("Snapshot " + path + " is corrupted");
+        }
+        _base = data.data();
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of stored pairs.
+     */
+    size_t size() const { return _h.count; }
+
+    /**
+     * @brief empty function
+     * @returns true if the snapshot holds no pairs.
+     */
+    bool empty() const { return _h.count == 0; }
+
+    /**
+     * @brief capacity function
+     * @returns size_t the number of slots, size() for a minimal perfect hash.
+     */
+    size_t capacity() const { return _h.slots; }
+
+    /**
+     * @brief find function
+     * @param key The key to look up.
+     * @return A pointer to the value inside the mapping, valid while the view lives, or
+     * nullptr if the key is not stored.
+     */
+    const V* find(const K& key) const {
+        if (_h.count == 0) {
+            return nullptr;
+        }
+        uint64_t h = _hash_snapshot_utils::hash_bytes(&key, sizeof(K), _h.seed);
+        uint32_t pilot;
+        std::memcpy(&pilot, _base + _h.pilots_at + 4 * (h % _h.buckets), 4);
+        uint64_t s = _hash_snapshot_utils::slot(h, pilot, _h.slots);
+        if (s >= _h.slots ||
+            std::memcmp(_base + _h.keys_at + sizeof(K) * s, &key, sizeof(K)) != 0) {
+            return nullptr;
+        }
+        return reinterpret_cast<const V*>(_base + _h.values_at) + s;
+    }
+
+    /**
+     * @brief contains function
+     * @param key The key to look up.
+     * @return true if the key is stored.
+     */
+    bool contains(const K& key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief Retrieves the value associated with the given key.
+     * @param key The key to retrieve the value for.
+     * @return A copy of the value, if the key is stored. Otherwise, returns std::nullopt.
+     */
+    std::optional<V> retrieve(const K& key) const {
+        const V* value = find(key);
+        if (value == nullptr) {
+            return std::nullopt;
+        }
+        return *value;
+    }
+
+  private:
+    mapped_file _file;
+    hash_snapshot_header _h;
+    const char* _base{nullptr};
+};
+
+#endif
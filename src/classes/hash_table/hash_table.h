@@ -1,21 +1,57 @@
 #ifndef HASH_TABLE_H
 #define HASH_TABLE_H
 
+#include "../../helpers/fast_hash.h"
+#include "../../helpers/memory_usage.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstdint>
 #include <functional>
 #include <iostream>
 #include <list>
+#include <memory_resource>
 #include <optional>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #endif
 
+/**
+ * @brief snapshot of the layout of a hash_table, returned by hash_table::stats()
+ * @param size: the number of pairs.
+ * @param buckets: the number of buckets(of the new array while rehashing).
+ * @param empty_buckets: buckets without any pair.
+ * @param load_factor: size / buckets.
+ * @param rehashing: true if an incremental rehash is in progress.
+ * @param occupancy: occupancy[k] is the number of buckets holding k pairs.
+ * @param probes: probes[k] is the number of pairs a lookup finds after k + 1 key
+ * comparisons.
+ * @param average_probes: mean number of key comparisons of a successful lookup.
+ * A good hash function keeps occupancy close to a Poisson distribution of mean
+ * load_factor, a long tail points to clustering keys.
+ */
+struct hash_table_stats {
+    size_t size{0};
+    size_t buckets{0};
+    size_t empty_buckets{0};
+    double load_factor{0};
+    bool rehashing{false};
+    std::vector<size_t> occupancy;
+    std::vector<size_t> probes;
+    double average_probes{0};
+};
+
 /**
  * @class hash_table
  * @tparam KeyType Type of the keys in the hash table.
  * @tparam ValueType Type of the values in the hash table.
+ * @tparam Hash Hash function of the keys, mixed unless it is HASHING::avalanching.
+ * Default = HASHING::hasher<KeyType>
  *
  * @brief A simple implementation of a hash table.
  * @details
@@ -25,21 +61,53 @@
  * hash table. Keys cannot be duplicate and an insertion of an existing key
  * leads to an update of the corresponding value.
  *
+ * Pairs are chained in a power of two array of buckets. Once the load factor would
+ * exceed max_load_factor() the table grows incrementally: a second array of twice the
+ * size is allocated and every following insertion or removal moves a few buckets to
+ * it, so no single operation pays for the whole rehash. Lookups check both arrays
+ * meanwhile. Pairs are never copied by a rehash, pointers returned by find() stay
+ * valid until the pair is removed. The buckets and the pairs come from a
+ * std::pmr::memory_resource.
+ *
  * The following are the class methods
  *
  * @note Use only types that can be hashed as the KeyType.
  */
-template <typename KeyType, typename ValueType> class hash_table {
+template <typename KeyType, typename ValueType, typename Hash = HASHING::hasher<KeyType>>
+class hash_table {
   public:
-    using BucketType = std::unordered_map<size_t, std::list<std::pair<KeyType, ValueType>>>;
+    using ListType = std::pmr::list<std::pair<KeyType, ValueType>>;
+    using BucketType = std::pmr::vector<ListType>;
+
+    /**
+     * @brief lookup keys compared as std::string_view: anything convertible to it when
+     * the keys are strings
+     */
+    template <typename Key>
+    static constexpr bool string_key = std::is_convertible_v<const KeyType&, std::string_view> &&
+                                       std::is_convertible_v<const Key&, std::string_view>;
+
+    /**
+     * @brief types usable as lookup keys: string keys(see string_key) or anything
+     * convertible to KeyType
+     */
+    template <typename Key>
+    static constexpr bool lookup_key =
+        string_key<Key> || std::is_convertible_v<const Key&, KeyType>;
 
     /**
      * @brief Construct a new hash table object
      *
      * @param v the initializer vector
+     * @param resource the memory resource of the buckets and the pairs. Default =
+     * std::pmr::get_default_resource()
      */
-    inline explicit hash_table(std::vector<std::pair<KeyType, ValueType>> v = {}) {
+    inline explicit hash_table(std::vector<std::pair<KeyType, ValueType>> v = {},
+                               std::pmr::memory_resource* resource =
+                                   std::pmr::get_default_resource())
+        : tables{BucketType(resource), BucketType(resource)} {
         if (!v.empty()) {
+            reserve(v.size());
             for (auto& x : v) {
                 this->insert(x.first, x.second);
             }
@@ -51,7 +119,9 @@ template <typename KeyType, typename ValueType> class hash_table {
      *
      * @param h the hash table we want to copy
      */
-    inline hash_table(const hash_table& h) : bucketList(h.bucketList), hash(h.hash) {}
+    inline hash_table(const hash_table& h)
+        : hash(h.hash), tables{h.tables[0], h.tables[1]}, count(h.count),
+          migrated(h.migrated), max_load(h.max_load) {}
 
     /**
      * @brief operator = for the hash_table class
@@ -59,18 +129,25 @@ template <typename KeyType, typename ValueType> class hash_table {
      * @return hash_table&
      */
     inline hash_table& operator=(const hash_table& h) {
-        if (&this == h) {
+        if (this == &h) {
             return *this;
         }
-        bucketList = h.bucketList;
         hash = h.hash;
+        tables[0] = h.tables[0];
+        tables[1] = h.tables[1];
+        count = h.count;
+        migrated = h.migrated;
+        max_load = h.max_load;
         return *this;
     }
 
     /**
      * @brief Destroy the hash table object
      */
-    inline ~hash_table() { bucketList.clear(); }
+    inline ~hash_table() {
+        tables[0].clear();
+        tables[1].clear();
+    }
 
     /**
      * @brief Inserts a key-value pair into the hash table.
@@ -81,14 +158,60 @@ template <typename KeyType, typename ValueType> class hash_table {
      * @param value The value to insert.
      */
     inline void insert(const KeyType& key, const ValueType& value) {
-        auto& list = bucketList[hash(key)];
-        for (auto& pair : list) {
-            if (pair.first == key) {
-                pair.second = value;
-                return;
+        _rehash_step(REHASH_STEP);
+        if (ValueType* found = find(key)) {
+            *found = value;
+            return;
+        }
+        _grow(count + 1);
+        size_t h = _hash(key);
+        BucketType& t = tables[_rehashing() ? 1 : 0];
+        t[h & (t.size() - 1)].emplace_back(key, value);
+        count++;
+    }
+
+    /**
+     * @brief Looks up the value associated with the given key without copying it.
+     * @details
+     * Never allocates, a miss leaves the table untouched. String keys can be looked up
+     * with any type convertible to std::string_view(e.g. std::string_view or const
+     * char*) without building a std::string.
+     * @param key The key to look up.
+     * @return A pointer to the value associated with the given key, nullptr if it does
+     * not exist. The pointer stays valid until the pair is removed.
+     */
+    template <typename Key = KeyType>
+        requires lookup_key<Key>
+    inline ValueType* find(const Key& key) {
+        const size_t h = _hash(key);
+        for (BucketType& t : tables) {
+            if (t.empty()) {
+                continue;
+            }
+            for (auto& pair : t[h & (t.size() - 1)]) {
+                if (_equal(pair.first, key)) {
+                    return &pair.second;
+                }
             }
         }
-        list.emplace_back(key, value);
+        return nullptr;
+    }
+
+    template <typename Key = KeyType>
+        requires lookup_key<Key>
+    inline const ValueType* find(const Key& key) const {
+        return const_cast<hash_table*>(this)->find(key);
+    }
+
+    /**
+     * @brief contains function
+     * @param key The key to look up(see find()).
+     * @return true if the key exists in the hash table.
+     */
+    template <typename Key = KeyType>
+        requires lookup_key<Key>
+    inline bool contains(const Key& key) const {
+        return find(key) != nullptr;
     }
 
     /**
@@ -97,14 +220,14 @@ template <typename KeyType, typename ValueType> class hash_table {
      * @return The value associated with the given key, if it exists. Otherwise,
      * returns std::nullopt.
      */
-    inline std::optional<ValueType> retrieve(const KeyType& key) {
-        auto& list = bucketList[hash(key)];
-        for (auto& pair : list) {
-            if (pair.first == key) {
-                return pair.second;
-            }
+    template <typename Key = KeyType>
+        requires lookup_key<Key>
+    inline std::optional<ValueType> retrieve(const Key& key) const {
+        const ValueType* value = find(key);
+        if (value == nullptr) {
+            return std::nullopt;
         }
-        return std::nullopt;
+        return *value;
     }
 
     /**
@@ -112,84 +235,334 @@ template <typename KeyType, typename ValueType> class hash_table {
      * hash table.
      * @details
      * This function removes the key-value pair associated with the given key from
-     * the hash table.
+     * the hash table. Nothing is allocated if the key does not exist.
      * @param key The key to remove.
      */
-    inline void remove(const KeyType& key) {
-        auto& list = bucketList[hash(key)];
-        list.remove_if([key](const auto& pair) { return pair.first == key; });
+    template <typename Key = KeyType>
+        requires lookup_key<Key>
+    inline void remove(const Key& key) {
+        _rehash_step(REHASH_STEP);
+        const size_t h = _hash(key);
+        for (BucketType& t : tables) {
+            if (t.empty()) {
+                continue;
+            }
+            ListType& list = t[h & (t.size() - 1)];
+            for (auto it = list.begin(); it != list.end(); it++) {
+                if (_equal(it->first, key)) {
+                    list.erase(it);
+                    count--;
+                    return;
+                }
+            }
+        }
     }
 
-    class Iterator;
+    /**
+     * @brief size function
+     * @return size_t the number of pairs in the hash table.
+     */
+    inline size_t size() const { return count; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the pairs, the links of their list nodes, the table with its
+     * bucket arrays(both while rehashing) and the headers of the nodes, and the spare capacity
+     * of the bucket arrays.
+     */
+    inline MEMORY::footprint memory_usage() const {
+        using pair = std::pair<KeyType, ValueType>;
+        MEMORY::footprint f;
+        f.control = sizeof(*this);
+        for (const BucketType& t : tables) {
+            f.control += t.size() * sizeof(ListType) +
+                         (t.capacity() > 0 ? MEMORY::ALLOCATION_OVERHEAD : 0);
+            f.slack += (t.capacity() - t.size()) * sizeof(ListType);
+            if constexpr (MEMORY::may_own_heap_v<pair>) {
+                for (const ListType& list : t) {
+                    for (const pair& p : list) {
+                        f.payload += MEMORY::heap_bytes(p);
+                    }
+                }
+            }
+        }
+        f.payload += count * sizeof(pair);
+        f.node_overhead = count * 2 * sizeof(void*);
+        f.control += count * MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+    /**
+     * @brief bucket_count function
+     * @return size_t the number of buckets(of the new array while rehashing).
+     */
+    inline size_t bucket_count() const { return tables[_rehashing() ? 1 : 0].size(); }
+
+    /**
+     * @brief resource function
+     * @return std::pmr::memory_resource* the resource the buckets and the pairs come from.
+     */
+    inline std::pmr::memory_resource* resource() const noexcept {
+        return tables[0].get_allocator().resource();
+    }
+
+    /**
+     * @brief load_factor function
+     * @return double the average number of pairs per bucket.
+     */
+    inline double load_factor() const {
+        return bucket_count() ? double(count) / bucket_count() : 0;
+    }
+
+    /**
+     * @brief max_load_factor function
+     * @return double the load factor that triggers a rehash.
+     */
+    inline double max_load_factor() const { return max_load; }
+
+    /**
+     * @brief max_load_factor function
+     * @param ml the load factor that triggers a rehash, larger values save memory and
+     * make the chains longer.
+     */
+    inline void max_load_factor(double ml) {
+        if (!(ml > 0)) {
+            throw std::invalid_argument("hash_table: max load factor must be positive");
+        }
+        max_load = ml;
+        if (count != 0) {
+            _grow(count);
+        }
+    }
+
+    /**
+     * @brief reserve function
+     * Sizes the table at once for n pairs, no rehash happens until there are more.
+     * @param n the number of pairs we expect.
+     */
+    inline void reserve(size_t n) { rehash(static_cast<size_t>(std::ceil(n / max_load))); }
 
-    inline Iterator begin() {
-        auto startIterator = bucketList.begin();
-        while (startIterator != bucketList.end() && startIterator->second.empty()) {
-            startIterator++;
+    /**
+     * @brief rehash function
+     * Finishes any incremental rehash and rebuilds the table at once with at least n
+     * buckets(and enough for the current pairs).
+     * @param n the minimum number of buckets.
+     */
+    inline void rehash(size_t n) {
+        _rehash_step(SIZE_MAX);
+        n = std::max(n, static_cast<size_t>(std::ceil(count / max_load)));
+        n = std::bit_ceil(std::max<size_t>(n, MIN_BUCKETS));
+        if (n != tables[0].size()) {
+            _start_rehash(n);
+            _rehash_step(SIZE_MAX);
         }
-        return Iterator(startIterator, bucketList.end());
     }
 
-    inline Iterator end() { return Iterator(bucketList.end(), bucketList.end()); }
+    /**
+     * @brief rehashing function
+     * @return true if an incremental rehash is in progress.
+     */
+    inline bool rehashing() const { return _rehashing(); }
+
+    /**
+     * @brief stats function
+     * Walks every bucket, O(size + buckets).
+     * @return hash_table_stats probe length and occupancy histograms.
+     */
+    inline hash_table_stats stats() const {
+        hash_table_stats s;
+        s.size = count;
+        s.buckets = bucket_count();
+        s.load_factor = load_factor();
+        s.rehashing = _rehashing();
+        size_t comparisons = 0;
+        for (size_t t = 0; t < 2; t++) {
+            for (const ListType& list : tables[t]) {
+                size_t k = list.size();
+                if (s.occupancy.size() <= k) {
+                    s.occupancy.resize(k + 1, 0);
+                }
+                s.occupancy[k]++;
+                s.empty_buckets += t == (_rehashing() ? 1 : 0) && k == 0;
+                // a lookup of a pair of the new array first scans its old bucket, the
+                // pairs of one new bucket all come from the same old one
+                size_t probe = 0;
+                if (t == 1 && k != 0) {
+                    const BucketType& old = tables[0];
+                    probe = old[_hash(list.front().first) & (old.size() - 1)].size();
+                }
+                for (size_t j = 0; j < k; j++) {
+                    probe++;
+                    if (s.probes.size() < probe) {
+                        s.probes.resize(probe, 0);
+                    }
+                    s.probes[probe - 1]++;
+                    comparisons += probe;
+                }
+            }
+        }
+        s.average_probes = count ? double(comparisons) / count : 0;
+        return s;
+    }
+
+    class Iterator;
+
+    inline Iterator begin() { return Iterator(this, 0, 0); }
+
+    inline Iterator end() { return Iterator(this, 2, 0); }
 
     /**
      * @brief << operator for hash_table class
      * @return std::ostream&
      */
-    inline friend std::ostream& operator<<(std::ostream& out, hash_table<KeyType, ValueType>& h) {
+    inline friend std::ostream& operator<<(std::ostream& out, hash_table& h) {
         out << '[';
-        for (auto& [key, list] : h.bucketList) {
-            for (auto& pair : h.bucketList[key]) {
-                out << "{" << pair.first << ", " << pair.second << "} ";
+        for (const BucketType& t : h.tables) {
+            for (const ListType& list : t) {
+                if (list.empty()) {
+                    continue;
+                }
+                for (auto& pair : list) {
+                    out << "{" << pair.first << ", " << pair.second << "} ";
+                }
+                out << '\n';
             }
-            out << '\n';
         }
         out << ']';
         return out;
     }
 
   private:
-    std::hash<KeyType> hash;
-    BucketType bucketList;
+    static constexpr size_t MIN_BUCKETS = 16;
+    // buckets moved by every insertion or removal while rehashing
+    static constexpr size_t REHASH_STEP = 4;
+
+    Hash hash;
+    // tables[1] is only allocated while rehashing, buckets of tables[0] below migrated
+    // are already moved. Both share one resource, which the lists of the buckets get from
+    // them, so splicing between the arrays moves no pair
+    BucketType tables[2];
+    size_t count{0};
+    size_t migrated{0};
+    double max_load{1.0};
+
+    bool _rehashing() const { return !tables[1].empty(); }
+
+    void _start_rehash(size_t buckets) {
+        tables[1].assign(buckets, ListType());
+        migrated = 0;
+    }
+
+    /**
+     * @brief moves up to steps non empty buckets(and ten times as many empty ones) to
+     * the new array, splicing the list nodes
+     */
+    void _rehash_step(size_t steps) {
+        if (!_rehashing()) {
+            return;
+        }
+        BucketType &from = tables[0], &to = tables[1];
+        size_t empty_visits = steps > SIZE_MAX / 10 ? SIZE_MAX : steps * 10;
+        for (; migrated < from.size() && steps > 0; migrated++) {
+            ListType& list = from[migrated];
+            if (list.empty()) {
+                if (--empty_visits == 0) {
+                    break;
+                }
+                continue;
+            }
+            while (!list.empty()) {
+                ListType& target = to[_hash(list.front().first) & (to.size() - 1)];
+                target.splice(target.end(), list, list.begin());
+            }
+            steps--;
+        }
+        if (migrated == from.size()) {
+            from.swap(to);
+            BucketType(to.get_allocator()).swap(to);
+            migrated = 0;
+        }
+    }
+
+    /**
+     * @brief starts a rehash if n pairs would exceed the max load factor
+     */
+    void _grow(size_t n) {
+        if (tables[0].empty()) {
+            size_t buckets = static_cast<size_t>(std::ceil(n / max_load));
+            tables[0].assign(std::bit_ceil(std::max(buckets, MIN_BUCKETS)), ListType());
+            return;
+        }
+        if (n <= bucket_count() * max_load) {
+            return;
+        }
+        // never three arrays at once: a pending rehash is finished first
+        _rehash_step(SIZE_MAX);
+        size_t buckets = tables[0].size() * 2;
+        while (n > buckets * max_load) {
+            buckets *= 2;
+        }
+        _start_rehash(buckets);
+    }
+
+    // a transparent hash of strings takes a std::string_view to the same hash, other lookup
+    // keys are converted to KeyType first
+    template <typename Key> size_t _hash(const Key& key) const {
+        if constexpr (std::is_same_v<Key, KeyType>) {
+            return size_t(HASHING::hash_of(hash, key));
+        } else if constexpr (string_key<Key> &&
+                             requires(const Hash& h) { h(std::string_view(key)); }) {
+            return size_t(HASHING::hash_of(hash, std::string_view(key)));
+        } else {
+            return size_t(HASHING::hash_of(hash, static_cast<KeyType>(key)));
+        }
+    }
+
+    template <typename Key> static bool _equal(const KeyType& stored, const Key& key) {
+        if constexpr (!std::is_same_v<Key, KeyType> && string_key<Key>) {
+            return std::string_view(stored) == std::string_view(key);
+        } else {
+            return stored == static_cast<const KeyType&>(key);
+        }
+    }
 };
 
 /**
  * @brief Iterator class
  */
-template <typename KeyType, typename ValueType> class hash_table<KeyType, ValueType>::Iterator {
+template <typename KeyType, typename ValueType, typename Hash>
+class hash_table<KeyType, ValueType, Hash>::Iterator {
   private:
-    using BucketIterator = typename BucketType::iterator;
-    using ListIterator = typename std::list<std::pair<KeyType, ValueType>>::iterator;
-    BucketIterator bucketIter, bucketEnd;
+    using ListIterator = typename ListType::iterator;
+    hash_table* table;
+    size_t array, bucket;
     ListIterator listIter;
-
-    std::unordered_map<size_t, std::list<std::pair<KeyType, ValueType>>> bucketList;
-    std::vector<size_t> key_values;
     int64_t index{};
 
-  public:
-    /**
-     * @brief Construct a new Iterator object
-     *
-     * @param bucket the bucket list
-     */
-    explicit Iterator(BucketIterator start, BucketIterator end)
-        : bucketIter(start), bucketEnd(end) {
-        if (bucketIter != bucketEnd) {
-            listIter = bucketIter->second.begin();
+    // moves to the first pair at or after (array, bucket)
+    void skip() {
+        for (; array < 2; array++, bucket = 0) {
+            BucketType& t = table->tables[array];
+            for (; bucket < t.size(); bucket++) {
+                if (!t[bucket].empty()) {
+                    listIter = t[bucket].begin();
+                    return;
+                }
+            }
         }
     }
 
+  public:
     /**
-     * @brief operator = for hash table iterator class
+     * @brief Construct a new Iterator object
      *
-     * @param bucket the bucket list
-     * @return Iterator&
+     * @param t the hash table
+     * @param array the bucket array(0, 1 or 2 for the end)
+     * @param bucket the first bucket to look at
      */
-    Iterator&
-    operator=(const std::unordered_map<size_t, std::list<std::pair<KeyType, ValueType>>>& bucket) {
-        this->bucketList = bucket;
-        return *(this);
+    explicit Iterator(hash_table* t, size_t array, size_t bucket)
+        : table(t), array(array), bucket(bucket) {
+        skip();
     }
 
     /**
@@ -198,12 +571,9 @@ template <typename KeyType, typename ValueType> class hash_table<KeyType, ValueT
      * @return Iterator&
      */
     Iterator& operator++() {
-        if (++listIter == bucketIter->second.end()) {
-            while (++bucketIter != bucketEnd && bucketIter->second.empty())
-                ;
-            if (bucketIter != bucketEnd) {
-                listIter = bucketIter->second.begin();
-            }
+        if (++listIter == table->tables[array][bucket].end()) {
+            bucket++;
+            skip();
         }
         return *this;
     }
@@ -246,20 +616,17 @@ template <typename KeyType, typename ValueType> class hash_table<KeyType, ValueT
      * @brief operator != for Type Iterator
      *
      * @param it the iterator we want to make the check
-     * @return true if the current list that exist in the index is not equal to
-     * the it.list that exist in the it.index
+     * @return true if the two iterators point to different pairs
      * @return false otherwise
      */
     bool operator!=(const Iterator& it) const {
-        return this->bucketIter != it.bucketIter ||
-               (bucketIter != bucketEnd && this->listIter != it.listIter);
+        return array != it.array || bucket != it.bucket || (array < 2 && listIter != it.listIter);
     }
 
     /**
      * @brief operator * for Type Iterator
      *
-     * @return std::list<std::pair<KeyType, ValueType>> the list of the current
-     * index
+     * @return std::pair<KeyType, ValueType>& the pair at the current position
      */
     std::pair<KeyType, ValueType>& operator*() { return *listIter; }
 };
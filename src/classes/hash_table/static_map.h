@@ -0,0 +1,274 @@
+#ifndef STATIC_MAP_H
+#define STATIC_MAP_H
+
+#include "../../helpers/fast_hash.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+namespace _static_map_utils {
+// average number of keys per bucket, fewer than in hash_snapshot: a constant expression
+// has a budget of operations, and smaller buckets find their pilots in fewer tries
+constexpr size_t BUCKET_KEYS = 2;
+// pilots with this bit set store the slot of a single key bucket directly
+constexpr uint32_t DIRECT = uint32_t(1) << 31;
+constexpr uint32_t MAX_PILOT = uint32_t(1) << 20;
+constexpr uint64_t MAX_SEEDS = 16;
+
+constexpr size_t buckets(size_t n) {
+    return std::max<size_t>(1, (n + BUCKET_KEYS - 1) / BUCKET_KEYS);
+}
+
+// the bucket of a hash, from its high bits
+constexpr size_t bucket(uint64_t h, size_t buckets) {
+    return size_t((static_cast<unsigned __int128>(h) * buckets) >> 64);
+}
+
+constexpr size_t slot(uint64_t h, uint32_t pilot, size_t slots) {
+    if (pilot & DIRECT) {
+        return pilot & ~DIRECT;
+    }
+    const uint64_t x = HASHING::mix(h ^ (pilot * HASHING::GOLDEN));
+    return size_t((static_cast<unsigned __int128>(x) * slots) >> 64);
+}
+
+/**
+ * @brief groups the keys by bucket with a counting sort: the keys of bucket b are
+ * items[start[b], start[b + 1])
+ */
+constexpr void group(const std::vector<uint64_t>& hashes, size_t m, std::vector<size_t>& start,
+                     std::vector<size_t>& items) {
+    start.assign(m + 1, 0);
+    items.resize(hashes.size());
+    for (uint64_t h : hashes) {
+        start[bucket(h, m) + 1]++;
+    }
+    for (size_t b = 0; b < m; b++) {
+        start[b + 1] += start[b];
+    }
+    std::vector<size_t> fill(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < hashes.size(); i++) {
+        items[fill[bucket(hashes[i], m)]++] = i;
+    }
+}
+
+/**
+ * @brief finds a pilot for every bucket so the keys land on distinct slots, biggest
+ * buckets first while the table is still empty(the search of hash_snapshot). The buffers
+ * only live during the build and the buckets are ordered by a counting sort, as a
+ * comparison sort costs more than the search in a constant expression. Returns false if a
+ * bucket ran out of pilots, the caller retries with another seed.
+ */
+constexpr bool place(const std::vector<uint64_t>& hashes, std::vector<uint32_t>& pilots,
+                     std::vector<size_t>& slot_of) {
+    const size_t n = hashes.size(), m = pilots.size();
+    std::vector<size_t> start, items;
+    group(hashes, m, start, items);
+    // the buckets by decreasing size
+    std::vector<size_t> by_size(n + 2, 0), order(m);
+    for (size_t b = 0; b < m; b++) {
+        by_size[n - (start[b + 1] - start[b]) + 1]++;
+    }
+    for (size_t k = 0; k <= n; k++) {
+        by_size[k + 1] += by_size[k];
+    }
+    for (size_t b = 0; b < m; b++) {
+        order[by_size[n - (start[b + 1] - start[b])]++] = b;
+    }
+
+    std::vector<char> taken(n, 0);
+    std::vector<size_t> cand;
+    size_t next_free = 0;
+    for (size_t b : order) {
+        const size_t lo = start[b], hi = start[b + 1];
+        if (hi - lo == 0) {
+            break;
+        }
+        if (hi - lo == 1) {
+            while (taken[next_free]) {
+                next_free++;
+            }
+            taken[next_free] = 1;
+            slot_of[items[lo]] = next_free;
+            pilots[b] = DIRECT | static_cast<uint32_t>(next_free);
+            continue;
+        }
+        bool placed = false;
+        for (uint32_t pilot = 0; pilot < MAX_PILOT && !placed; pilot++) {
+            cand.clear();
+            for (size_t j = lo; j < hi; j++) {
+                const size_t s = slot(hashes[items[j]], pilot, n);
+                if (taken[s] || std::find(cand.begin(), cand.end(), s) != cand.end()) {
+                    break;
+                }
+                cand.push_back(s);
+            }
+            if (cand.size() == hi - lo) {
+                for (size_t j = lo; j < hi; j++) {
+                    taken[cand[j - lo]] = 1;
+                    slot_of[items[j]] = cand[j - lo];
+                }
+                pilots[b] = pilot;
+                placed = true;
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace _static_map_utils
+
+/**
+ * @brief static map class
+ * An immutable map of N pairs known at compile time, such as a table of keywords, built in a
+ * constant expression: a static constexpr static_map is in the read only data of the program,
+ * with no allocation and nothing to build at startup. Its keys are placed by a minimal
+ * perfect hash, the pilots of hash_snapshot: the hash of a key picks a bucket of about 2 keys,
+ * the pilot of the bucket picks its slot among N, so a lookup is one hash, one pilot and one
+ * comparison, whether the key is there or not. A few thousand pairs build within the default
+ * limits of constant evaluation of the compilers, larger tables belong in a hash_snapshot.
+ * @tparam Key the type of the keys, compared with ==.
+ * @tparam Value the type of the values.
+ * @tparam N the number of pairs.
+ * @tparam Hash the hash function of the keys, usable in constant expressions to build the map
+ * at compile time. Default = HASHING::hasher<Key>
+ */
+template <typename Key, typename Value, size_t N, typename Hash = HASHING::hasher<Key>>
+class static_map {
+  public:
+    using value_type = std::pair<Key, Value>;
+    using const_iterator = typename std::array<value_type, N>::const_iterator;
+
+    /**
+     * @brief Construct a new static map object
+     * @param items the pairs, in any order
+     * @param hash the hash function. Default = Hash()
+     * Throws std::invalid_argument if two keys are equal, which fails to compile in a constant
+     * expression.
+     */
+    constexpr explicit static_map(const std::array<value_type, N>& items, const Hash& hash = Hash())
+        : _hash(hash) {
+        std::vector<uint64_t> keys(N), hashes(N);
+        std::vector<size_t> slot_of(N);
+        std::vector<uint32_t> pilots(BUCKETS, 0);
+        for (size_t i = 0; i < N; i++) {
+            keys[i] = HASHING::hash_of(_hash, items[i].first);
+        }
+        // equal keys collide with every seed, find them before searching
+        std::vector<size_t> start, grouped;
+        _static_map_utils::group(keys, BUCKETS, start, grouped);
+        for (size_t k = 0; k < BUCKETS; k++) {
+            for (size_t i = start[k]; i < start[k + 1]; i++) {
+                for (size_t j = start[k]; j < i; j++) {
+                    const size_t a = grouped[i], b = grouped[j];
+                    if (keys[a] == keys[b] && items[a].first == items[b].first) {
+                        throw std::invalid_argument("static_map: duplicate keys");
+                    }
+                }
+            }
+        }
+        for (;; _seed++) {
+            if (_seed == _static_map_utils::MAX_SEEDS) {
+                throw std::runtime_error("static_map: no perfect hash found");
+            }
+            for (size_t i = 0; i < N; i++) {
+                hashes[i] = HASHING::mix(keys[i], _seed);
+            }
+            if (_static_map_utils::place(hashes, pilots, slot_of)) {
+                break;
+            }
+        }
+        for (size_t b = 0; b < BUCKETS; b++) {
+            _pilots[b] = pilots[b];
+        }
+        for (size_t i = 0; i < N; i++) {
+            _items[slot_of[i]] = items[i];
+        }
+    }
+
+    /**
+     * @brief find function
+     * @param key the key
+     * @return const Value* the value of key, nullptr if key is not there
+     */
+    constexpr const Value* find(const Key& key) const {
+        if constexpr (N == 0) {
+            return nullptr;
+        } else {
+            const uint64_t h = HASHING::mix(HASHING::hash_of(_hash, key), _seed);
+            const size_t b = _static_map_utils::bucket(h, BUCKETS);
+            const value_type& e = _items[_static_map_utils::slot(h, _pilots[b], N)];
+            return e.first == key ? &e.second : nullptr;
+        }
+    }
+
+    /**
+     * @brief contains function
+     * @param key the key
+     * @return true if key is there
+     */
+    constexpr bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief at function
+     * @param key the key
+     * @return const Value& the value of key
+     * Throws std::out_of_range if key is not there.
+     */
+    constexpr const Value& at(const Key& key) const {
+        if (const Value* v = find(key)) {
+            return *v;
+        }
+        throw std::out_of_range("static_map::at: the key is not there");
+    }
+
+    /**
+     * @brief size function
+     * @return size_t N
+     */
+    constexpr size_t size() const { return N; }
+
+    /**
+     * @brief begin function
+     * @return const_iterator to the first pair, the pairs are in the order of their slots
+     */
+    constexpr const_iterator begin() const { return _items.begin(); }
+
+    /**
+     * @brief end function
+     * @return const_iterator past the last pair
+     */
+    constexpr const_iterator end() const { return _items.end(); }
+
+  private:
+    static constexpr size_t BUCKETS = _static_map_utils::buckets(N);
+
+    Hash _hash;
+    uint64_t _seed{0};
+    std::array<uint32_t, BUCKETS> _pilots{};
+    // the pair of slot s
+    std::array<value_type, N> _items{};
+};
+
+/**
+ * @brief make static map function
+ * @param items the pairs, a braced list: make_static_map<std::string_view, int>({{"if", 1}})
+ * @param hash the hash function. Default = Hash()
+ * @return static_map<Key, Value, N, Hash> the map of the pairs
+ */
+template <typename Key, typename Value, typename Hash = HASHING::hasher<Key>, size_t N>
+constexpr static_map<Key, Value, N, Hash> make_static_map(const std::pair<Key, Value> (&items)[N],
+                                                          const Hash& hash = Hash()) {
+    return static_map<Key, Value, N, Hash>(std::to_array(items), hash);
+}
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef D_ARY_HEAP_H
+#define D_ARY_HEAP_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief d-ary heap class
+ * Growable priority queue over a std::vector where every node has Arity children.
+ * A wider node makes the tree shallower and keeps the children of a node next to each
+ * other: with 4 or 8 children of 8 bytes a whole family fits in one cache line, so
+ * sift-down on big heaps takes about half the cache misses of a binary heap.
+ * @tparam T the type of the elements.
+ * @tparam Compare strict weak order, top() is the element that is not after any other
+ * (the smallest for std::less). Default = std::less<T>
+ * @tparam Arity the number of children of a node, at least 2. Default = 4
+ */
+template <typename T, typename Compare = std::less<T>, size_t Arity = 4> class d_ary_heap {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+  public:
+    using value_type = T;
+
+    /**
+     * @brief Construct a new empty d_ary_heap object
+     * @param cmp: the order of the elements.
+     */
+    explicit d_ary_heap(const Compare& cmp = Compare()) : _cmp(cmp) {}
+
+    /**
+     * @brief Construct a new d_ary_heap object from values in O(n)
+     * @param values: the elements, in any order.
+     * @param cmp: the order of the elements.
+     */
+    explicit d_ary_heap(std::vector<T> values, const Compare& cmp = Compare()) : _cmp(cmp) {
+        make_heap(std::move(values));
+    }
+
+    /**
+     * @brief make_heap function
+     * Replaces the elements with values and restores the heap bottom-up(Floyd), which
+     * is O(n) instead of the O(n log n) of n pushes.
+     * @param values: the new elements, in any order.
+     */
+    void make_heap(std::vector<T> values) {
+        _data = std::move(values);
+        if (_data.size() < 2) {
+            return;
+        }
+        for (size_t i = (_data.size() - 2) / Arity + 1; i-- > 0;) {
+            _sift_down(i);
+        }
+    }
+
+    /**
+     * @brief make_heap function
+     * @param first: iterator to the first new element.
+     * @param last: iterator past the last new element.
+     */
+    template <typename It> void make_heap(It first, It last) {
+        make_heap(std::vector<T>(first, last));
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of elements.
+     */
+    size_t size() const { return _data.size(); }
+
+    /**
+     * @brief memory_usage function
+     * @returns MEMORY::footprint the elements, the heap with the header of its array, and the
+     * spare capacity.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::memory_usage(_data);
+        f.control += sizeof(*this) - sizeof(_data);
+        return f;
+    }
+
+    /**
+     * @brief empty function
+     * @returns true if the heap has no elements.
+     */
+    bool empty() const { return _data.empty(); }
+
+    /**
+     * @brief reserve function
+     * @param n: the number of elements to make room for.
+     */
+    void reserve(size_t n) { _data.reserve(n); }
+
+    /**
+     * @brief clear function
+     * Removes every element, the memory is kept.
+     */
+    void clear() { _data.clear(); }
+
+    /**
+     * @brief top function
+     * @returns const T& the first element in the order of Compare.
+     * Throws std::out_of_range if the heap is empty.
+     */
+    const T& top() const {
+        if (_data.empty()) {
+            throw std::out_of_range("d_ary_heap::top: the heap is empty");
+        }
+        return _data.front();
+    }
+
+    /**
+     * @brief push function
+     * @param value: the element to insert.
+     */
+    void push(const T& value) {
+        _data.push_back(value);
+        _sift_up(_data.size() - 1);
+    }
+
+    /**
+     * @brief push function
+     * @param value: the element to insert.
+     */
+    void push(T&& value) {
+        _data.push_back(std::move(value));
+        _sift_up(_data.size() - 1);
+    }
+
+    /**
+     * @brief emplace function
+     * @param args: the arguments of the constructor of the new element.
+     */
+    template <typename... Args> void emplace(Args&&... args) {
+        _data.emplace_back(std::forward<Args>(args)...);
+        _sift_up(_data.size() - 1);
+    }
+
+    /**
+     * @brief pop function
+     * Removes top().
+     * @returns T the removed element.
+     * Throws std::out_of_range if the heap is empty.
+     */
+    T pop() {
+        if (_data.empty()) {
+            throw std::out_of_range("d_ary_heap::pop: the heap is empty");
+        }
+        T root = std::move(_data.front());
+        if (_data.size() > 1) {
+            _data.front() = std::move(_data.back());
+            _data.pop_back();
+            _sift_down(0);
+        } else {
+            _data.pop_back();
+        }
+        return root;
+    }
+
+    /**
+     * @brief data function
+     * @returns const std::vector<T>& the elements in heap order.
+     */
+    const std::vector<T>& data() const { return _data; }
+
+  private:
+    std::vector<T> _data;
+    Compare _cmp;
+
+    void _sift_up(size_t i) {
+        T x = std::move(_data[i]);
+        while (i > 0) {
+            size_t parent = (i - 1) / Arity;
+            if (!_cmp(x, _data[parent])) {
+                break;
+            }
+            _data[i] = std::move(_data[parent]);
+            i = parent;
+        }
+        _data[i] = std::move(x);
+    }
+
+    void _sift_down(size_t i) {
+        const size_t n = _data.size();
+        T x = std::move(_data[i]);
+        for (size_t first = Arity * i + 1; first < n; first = Arity * i + 1) {
+            size_t best = first;
+            const size_t last = first + Arity < n ? first + Arity : n;
+            for (size_t child = first + 1; child < last; child++) {
+                if (_cmp(_data[child], _data[best])) {
+                    best = child;
+                }
+            }
+            if (!_cmp(_data[best], x)) {
+                break;
+            }
+            _data[i] = std::move(_data[best]);
+            i = best;
+        }
+        _data[i] = std::move(x);
+    }
+};
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief indexed heap class
+ * Binary heap over dense ids in [0, n) with a position table, so an id is stored at
+ * most once and its key can be lowered in place(true decrease-key instead of pushing
+ * duplicates). clear() only resets the ids still in the heap, so the heap can serve
+ * many short searches over a large id range without O(n) work per search.
+ */
+template <typename Key = double, typename Compare = std::less<Key>> class indexed_heap {
+  public:
+    using key_type = Key;
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Construct a new indexed heap object
+     * @param n: the number of ids the heap can hold. Default = 0
+     */
+    explicit indexed_heap(size_t n = 0) : _pos(n, npos) {}
+
+    /**
+     * @brief resize function
+     * Grows the id range, the ids already in the heap stay there.
+     * @param n: the number of ids the heap can hold.
+     */
+    void resize(size_t n) {
+        if (_pos.size() < n) {
+            _pos.resize(n, npos);
+        }
+    }
+
+    /**
+     * @brief capacity function
+     * @returns size_t the size of the id range.
+     */
+    size_t capacity() const { return _pos.size(); }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of ids in the heap.
+     */
+    size_t size() const { return _heap.size(); }
+
+    /**
+     * @brief memory_usage function
+     * @returns MEMORY::footprint the keys, their ids and the positions of the ids, the heap
+     * with the headers of its arrays, and the spare capacity.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::memory_usage(_heap), pos = MEMORY::memory_usage(_pos);
+        const size_t ids = _heap.size() * (sizeof(std::pair<Key, uint32_t>) - sizeof(Key));
+        f.payload -= ids;
+        f.node_overhead = ids + pos.payload;
+        f.slack += pos.slack;
+        f.control += pos.control + sizeof(*this) - sizeof(_heap) - sizeof(_pos);
+        return f;
+    }
+
+    /**
+     * @brief empty function
+     * @returns true if the heap is empty.
+     */
+    bool empty() const { return _heap.empty(); }
+
+    /**
+     * @brief contains function
+     * @param id: the id we want to look up.
+     * @returns true if id is in the heap.
+     */
+    bool contains(uint32_t id) const { return _pos[id] != npos; }
+
+    /**
+     * @brief key function
+     * @param id: an id that is in the heap.
+     * @returns const Key& the current key of id.
+     */
+    const Key& key(uint32_t id) const { return _heap[_pos[id]].first; }
+
+    /**
+     * @brief top function
+     * @returns uint32_t the id with the smallest key.
+     */
+    uint32_t top() const { return _heap.front().second; }
+
+    /**
+     * @brief top_key function
+     * @returns const Key& the smallest key.
+     */
+    const Key& top_key() const { return _heap.front().first; }
+
+    /**
+     * @brief push function
+     * Inserts id, or lowers its key if it is already in the heap with a larger one.
+     * @param id: the id.
+     * @param key: the key of id.
+     * @returns true if id was inserted or its key lowered.
+     */
+    bool push(uint32_t id, const Key& key) {
+        if (_pos[id] == npos) {
+            _pos[id] = static_cast<uint32_t>(_heap.size());
+            _heap.emplace_back(key, id);
+            _sift_up(_pos[id]);
+            return true;
+        }
+        return decrease_key(id, key);
+    }
+
+    /**
+     * @brief decrease_key function
+     * @param id: an id that is in the heap.
+     * @param key: the new key, ignored if it is not smaller than the current one.
+     * @returns true if the key was lowered.
+     */
+    bool decrease_key(uint32_t id, const Key& key) {
+        size_t i = _pos[id];
+        if (!_less(key, _heap[i].first)) {
+            return false;
+        }
+        _heap[i].first = key;
+        _sift_up(i);
+        return true;
+    }
+
+    /**
+     * @brief pop function
+     * Removes the id with the smallest key.
+     * @returns uint32_t the removed id.
+     */
+    uint32_t pop() {
+        uint32_t id = _heap.front().second;
+        _pos[id] = npos;
+        if (_heap.size() > 1) {
+            _heap.front() = std::move(_heap.back());
+            _pos[_heap.front().second] = 0;
+            _heap.pop_back();
+            _sift_down(0);
+        } else {
+            _heap.pop_back();
+        }
+        return id;
+    }
+
+    /**
+     * @brief erase function
+     * Removes id from the heap in O(log n).
+     * @param id: the id to remove.
+     * @returns true if id was in the heap.
+     */
+    bool erase(uint32_t id) {
+        if (_pos[id] == npos) {
+            return false;
+        }
+        size_t i = _pos[id];
+        _pos[id] = npos;
+        if (i + 1 == _heap.size()) {
+            _heap.pop_back();
+            return true;
+        }
+        _heap[i] = std::move(_heap.back());
+        _heap.pop_back();
+        _pos[_heap[i].second] = static_cast<uint32_t>(i);
+        if (i > 0 && _less(_heap[i].first, _heap[(i - 1) / 2].first)) {
+            _sift_up(i);
+        } else {
+            _sift_down(i);
+        }
+        return true;
+    }
+
+    /**
+     * @brief clear function
+     * Empties the heap in O(size()), the id range and the memory are kept.
+     */
+    void clear() {
+        for (const auto& x : _heap) {
+            _pos[x.second] = npos;
+        }
+        _heap.clear();
+    }
+
+  private:
+    std::vector<std::pair<Key, uint32_t>> _heap;
+    std::vector<uint32_t> _pos;
+    Compare _less;
+
+    void _place(size_t i, std::pair<Key, uint32_t>&& x) {
+        _pos[x.second] = static_cast<uint32_t>(i);
+        _heap[i] = std::move(x);
+    }
+
+    void _sift_up(size_t i) {
+        std::pair<Key, uint32_t> x = std::move(_heap[i]);
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!_less(x.first, _heap[parent].first)) {
+                break;
+            }
+            _place(i, std::move(_heap[parent]));
+            i = parent;
+        }
+        _place(i, std::move(x));
+    }
+
+    void _sift_down(size_t i) {
+        const size_t n = _heap.size();
+        std::pair<Key, uint32_t> x = std::move(_heap[i]);
+        for (size_t child = 2 * i + 1; child < n; child = 2 * i + 1) {
+            if (child + 1 < n && _less(_heap[child + 1].first, _heap[child].first)) {
+                child++;
+            }
+            if (!_less(_heap[child].first, x.first)) {
+                break;
+            }
+            _place(i, std::move(_heap[child]));
+            i = child;
+        }
+        _place(i, std::move(x));
+    }
+};
+
+#endif
@@ -1,10 +1,15 @@
 #ifndef MIN_HEAP_H
 #define MIN_HEAP_H
+
+#include "../../helpers/archive.h"
+#include "../../helpers/memory_usage.h"
+
 #ifdef __cplusplus
-#include <climits>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 #endif
 
@@ -13,64 +18,94 @@
 
 /**
  * @brief min heap class
- *
+ * Binary min heap that grows as needed, see d_ary_heap.h for a heap with a comparator
+ * and a configurable arity.
  */
 template <typename T> class min_heap {
   private:
-    T* arr;
-    size_t max_size{};
-    size_t heap_size{0};
+    std::vector<T> arr;
 
   public:
     /**
      * @brief Construct a new min heap object
      *
-     * @param max_size : maximum size of the heap
+     * @param max_size : the number of elements to reserve room for, the heap grows past it
+     */
+    inline explicit min_heap(size_t max_size = 0) { arr.reserve(max_size); }
+
+    /**
+     * @brief size function
+     * Returns the number of elements in the heap
      */
-    inline explicit min_heap(size_t max_size) noexcept : arr(new T[max_size]) {
+    inline size_t size() const { return arr.size(); }
 
-        this->max_size = max_size;
+    /**
+     * @brief memory_usage function
+     * Returns the elements, the heap with the header of its array, and the spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const { return MEMORY::memory_usage(arr); }
+
+    /**
+     * @brief save_archive function
+     * Writes the array of the heap as a heap archive.
+     *
+     * @param path the output file, overwritten, throws std::runtime_error if it can not be
+     * written
+     */
+    inline void save_archive(const std::string& path) const {
+        archive_writer out(path, archive_kind::heap, _archive_utils::key_size<T>(), arr.size());
+        out.add_keys(arr);
+        out.finish();
     }
 
-    inline ~min_heap() noexcept { delete[] arr; }
+    /**
+     * @brief load_archive function
+     * Copies the array of a heap archive in bulk, it is a heap already.
+     *
+     * @param path a file written by save_archive, throws std::runtime_error like archive_view
+     */
+    static min_heap load_archive(const std::string& path) {
+        min_heap h;
+        h.arr = archive_view(path, archive_kind::heap, _archive_utils::key_size<T>()).keys<T>(0);
+        return h;
+    }
 
     /**
      * @brief parent function
      *
-     * @param i the element we want to find the parent
+     * @param i the position we want to find the parent
      */
-    inline T parent(T i) { return (i - 1) / 2; }
+    inline size_t parent(size_t i) const { return (i - 1) / 2; }
 
     /**
      * @brief __left function
      *
-     * @param i: the element we want to find the left
+     * @param i: the position we want to find the left
      */
-    inline T _left(T i) { return (2 * i + 1); }
+    inline size_t _left(size_t i) const { return (2 * i + 1); }
 
     /**
      * @brief __right function
      *
-     * @param i: the element we want to find the right
+     * @param i: the position we want to find the right
      */
-    inline T _right(T i) { return (2 * i + 2); }
+    inline size_t _right(size_t i) const { return (2 * i + 2); }
 
     /**
      * @brief __min function
-     * Returns the minimum with heapify
+     * Removes and returns the minimum with heapify, std::numeric_limits<T>::max() if the
+     * heap is empty
      */
     inline T _min() {
-        if (heap_size <= 0) {
-            return INT_MAX;
-        }
-        if (heap_size == 1) {
-            heap_size--;
-            return arr[0];
+        if (arr.empty()) {
+            return std::numeric_limits<T>::max();
         }
         T root = arr[0];
-        arr[0] = arr[heap_size - 1];
-        heap_size--;
-        heapify(0);
+        arr[0] = arr.back();
+        arr.pop_back();
+        if (!arr.empty()) {
+            heapify(0);
+        }
         return root;
     }
 
@@ -78,11 +113,20 @@ template <typename T> class min_heap {
      * @brief min function.
      * Returns the minimum of the heap(the first element)
      */
-    inline T min() { return arr[0]; }
+    inline T min() const { return arr[0]; }
 
-    inline void decrease_key(T i, T key) {
+    /**
+     * @brief decrease_key function
+     *
+     * @param i the position of the element
+     * @param key the new key, not larger than the current one
+     */
+    inline void decrease_key(size_t i, T key) {
+        if (i >= arr.size()) {
+            throw std::out_of_range("min_heap::decrease_key: position outside the heap");
+        }
         arr[i] = key;
-        while (i != 0 && arr[parent(i)] > arr[i]) {
+        while (i != 0 && arr[i] < arr[parent(i)]) {
             std::swap(arr[i], arr[parent(i)]);
             i = parent(i);
         }
@@ -94,52 +138,51 @@ template <typename T> class min_heap {
      * @param key the key to be inserted
      */
     inline void insert(T key) {
-        try {
-            if (heap_size == max_size) {
-                throw std::invalid_argument("Heap reached maximum size");
-            } else {
-                heap_size++;
-                size_t i = heap_size - 1;
-                arr[i] = key;
-                while (i != 0 && arr[parent(i)] > arr[i]) {
-                    std::swap(arr[i], arr[parent(i)]);
-                    i = parent(i);
-                }
-            }
-        } catch (std::invalid_argument& e) {
-            std::cerr << e.what() << '\n';
-            return;
-        }
+        arr.push_back(key);
+        decrease_key(arr.size() - 1, key);
     }
 
     /**
      * @brief remove function
      *
-     * @param key the key to be removed
+     * @param i the position of the element to be removed
      */
-    inline void remove(T key) {
-        decrease_key(key, INT_MIN);
-        _min();
+    inline void remove(size_t i) {
+        if (i >= arr.size()) {
+            throw std::out_of_range("min_heap::remove: position outside the heap");
+        }
+        T last = arr.back();
+        arr.pop_back();
+        if (i == arr.size()) {
+            return;
+        }
+        if (last < arr[i]) {
+            decrease_key(i, last);
+        } else {
+            arr[i] = last;
+            heapify(i);
+        }
     }
 
     /**
      * @brief heapify function
      *
-     * @param i the element we want to heapify from
+     * @param i the position we want to heapify from
      */
-    inline void heapify(T i) {
-        T left = _left(i);
-        T right = _right(i);
-        T minim = i;
-        if (left < heap_size && arr[left] < arr[i]) {
-            minim = left;
-        }
-        if (right < heap_size && arr[right] < arr[i]) {
-            minim = right;
-        }
-        if (minim != i) {
+    inline void heapify(size_t i) {
+        while (true) {
+            size_t left = _left(i), right = _right(i), minim = i;
+            if (left < arr.size() && arr[left] < arr[minim]) {
+                minim = left;
+            }
+            if (right < arr.size() && arr[right] < arr[minim]) {
+                minim = right;
+            }
+            if (minim == i) {
+                return;
+            }
             std::swap(arr[i], arr[minim]);
-            heapify(minim);
+            i = minim;
         }
     }
 };
@@ -0,0 +1,264 @@
+#ifndef MULTI_QUEUE_H
+#define MULTI_QUEUE_H
+
+#include "../../helpers/parallel.h"
+#include "d_ary_heap.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief options of multi_queue
+ * @param threads: the number of threads that will use the queue(0 means every hardware
+ * thread).
+ * @param queues_per_thread: c, the queue holds c * threads locked heaps. More heaps
+ * mean less contention and a looser order. Default = 2
+ * @param choices: a pop looks at the tops of this many random heaps and takes the
+ * best, 1 pops from a random heap. Default = 2
+ */
+struct multi_queue_options {
+    size_t threads{0};
+    size_t queues_per_thread{2};
+    size_t choices{2};
+};
+
+/**
+ * @brief throughput counters of a multi_queue
+ * @param pushes: the number of pushed elements.
+ * @param pops: the number of popped elements.
+ * @param empty_pops: pops that found every heap empty.
+ * @param contention: lock attempts that found the heap busy and moved on.
+ */
+struct multi_queue_stats {
+    uint64_t pushes{0};
+    uint64_t pops{0};
+    uint64_t empty_pops{0};
+    uint64_t contention{0};
+};
+
+/**
+ * @class multi_queue
+ * @tparam T the type of the elements.
+ * @tparam Compare strict weak order, pops prefer the elements that are not after the
+ * others(the smallest for std::less). Default = std::less<T>
+ *
+ * @brief Relaxed concurrent priority queue(MultiQueue, Rihani, Sanders and Dementiev).
+ * @details
+ * The elements are spread over c * P heaps, each one behind its own lock on its own
+ * cache line. A push goes to a random heap, a pop locks the best of a few random heaps,
+ * so threads rarely wait on each other. The order is relaxed: a pop returns one of the
+ * smallest O(c * P) elements in expectation instead of the smallest one, which is what
+ * label-correcting algorithms like delta-stepping or parallel A* tolerate. Locks are
+ * only taken with try_lock, a busy heap is skipped and counted as contention. With a
+ * single heap the queue is exact.
+ */
+template <typename T, typename Compare = std::less<T>> class multi_queue {
+  public:
+    /**
+     * @brief Construct a new multi queue object
+     * @param opt: the number of threads, heaps per thread and choices per pop.
+     * @param cmp: the order of the elements.
+     */
+    explicit multi_queue(multi_queue_options opt = {}, const Compare& cmp = Compare())
+        : _cmp(cmp), _choices(std::max<size_t>(opt.choices, 1)),
+          _queues(std::max<size_t>(opt.queues_per_thread, 1) *
+                  (opt.threads ? opt.threads : PARALLEL::hardware_threads())) {
+        for (_queue& q : _queues) {
+            q.heap = d_ary_heap<T, Compare>(cmp);
+        }
+    }
+
+    /**
+     * @brief push function
+     * @param value: the element to insert.
+     */
+    void push(T value) {
+        for (;;) {
+            _queue& q = _queues[_random() % _queues.size()];
+            std::unique_lock lock(q.mutex, std::try_to_lock);
+            if (lock.owns_lock()) {
+                q.heap.push(std::move(value));
+                q.pushes++;
+                _size.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            q.contention.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief try_pop function
+     * Removes the best top among choices random heaps.
+     * @param out: receives the removed element.
+     * @returns bool false if the queue was empty.
+     */
+    bool try_pop(T& out) {
+        while (_size.load(std::memory_order_relaxed) > 0) {
+            std::unique_lock<std::mutex> best;
+            _queue* from = nullptr;
+            for (size_t k = 0; k < _choices; k++) {
+                _queue& q = _queues[_random() % _queues.size()];
+                if (&q == from) {
+                    continue;
+                }
+                std::unique_lock lock(q.mutex, std::try_to_lock);
+                if (!lock.owns_lock()) {
+                    q.contention.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                if (q.heap.empty()) {
+                    continue;
+                }
+                if (from == nullptr || _cmp(q.heap.top(), from->heap.top())) {
+                    best = std::move(lock);
+                    from = &q;
+                }
+            }
+            if (from != nullptr) {
+                out = from->heap.pop();
+                from->pops++;
+                _size.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (_scan(out)) {
+                return true;
+            }
+        }
+        _empty_pops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief pop function
+     * @returns std::optional<T> the removed element, std::nullopt if the queue was empty.
+     */
+    std::optional<T> pop() {
+        T out;
+        if (try_pop(out)) {
+            return out;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of elements, stale if other threads are running.
+     */
+    size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief memory_usage function
+     * Takes the lock of every heap in turn.
+     * @returns MEMORY::footprint the elements, the heaps with their locks and counters, and
+     * the spare capacity of the heaps.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        for (const _queue& q : _queues) {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            f += q.heap.memory_usage();
+            f.control += sizeof(_queue) - sizeof(q.heap);
+        }
+        f.control += sizeof(*this) +
+                     (_queues.capacity() > 0 ? MEMORY::ALLOCATION_OVERHEAD : 0) +
+                     (_queues.capacity() - _queues.size()) * sizeof(_queue);
+        return f;
+    }
+
+    /**
+     * @brief empty function
+     * @returns true if the queue holds no elements.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief queues function
+     * @returns size_t the number of heaps.
+     */
+    size_t queues() const { return _queues.size(); }
+
+    /**
+     * @brief stats function
+     * @returns multi_queue_stats the counters since construction, every heap is counted
+     * under its lock.
+     */
+    multi_queue_stats stats() const {
+        multi_queue_stats s;
+        for (const _queue& q : _queues) {
+            std::lock_guard lock(q.mutex);
+            s.pushes += q.pushes;
+            s.pops += q.pops;
+            s.contention += q.contention.load(std::memory_order_relaxed);
+        }
+        s.empty_pops = _empty_pops.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief clear function
+     * Removes every element, the counters are kept.
+     */
+    void clear() {
+        for (_queue& q : _queues) {
+            std::lock_guard lock(q.mutex);
+            _size.fetch_sub(q.heap.size(), std::memory_order_relaxed);
+            q.heap.clear();
+        }
+    }
+
+  private:
+    // one cache line per heap, so two locks never share a line
+    struct alignas(64) _queue {
+        mutable std::mutex mutex;
+        d_ary_heap<T, Compare> heap;
+        uint64_t pushes{0};
+        uint64_t pops{0};
+        std::atomic<uint64_t> contention{0};
+    };
+
+    Compare _cmp;
+    size_t _choices;
+    std::vector<_queue> _queues;
+    std::atomic<size_t> _size{0};
+    std::atomic<uint64_t> _empty_pops{0};
+
+    /**
+     * @brief per thread xorshift generator, seeded from the thread id
+     */
+    static uint64_t _random() {
+        thread_local uint64_t state =
+            (std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9E3779B97F4A7C15ULL) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    /**
+     * @brief the random heaps were all empty or busy, waits for every heap in turn so a
+     * pop only fails when the queue is really empty
+     */
+    bool _scan(T& out) {
+        for (_queue& q : _queues) {
+            std::lock_guard lock(q.mutex);
+            if (!q.heap.empty()) {
+                out = q.heap.pop();
+                q.pops++;
+                _size.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief pairing heap class
+ * Priority queue over dense ids in [0, n) stored as a heap ordered multiway tree. push
+ * and decrease_key are O(1) amortized(a lowered id is cut from its parent and melded
+ * with the root), pop is O(log n) amortized with the two-pass pairing of the children
+ * of the root. The nodes live in one array indexed by id, nothing is allocated after
+ * resize(). It has the interface of indexed_heap and plugs into the same algorithms.
+ * @tparam Key the type of the keys. Default = double
+ * @tparam Compare strict weak order of the keys. Default = std::less<Key>
+ */
+template <typename Key = double, typename Compare = std::less<Key>> class pairing_heap {
+  public:
+    using key_type = Key;
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Construct a new pairing heap object
+     * @param n: the number of ids the heap can hold. Default = 0
+     */
+    explicit pairing_heap(size_t n = 0) : _nodes(n) {}
+
+    /**
+     * @brief resize function
+     * Grows the id range, the ids already in the heap stay there.
+     * @param n: the number of ids the heap can hold.
+     */
+    void resize(size_t n) {
+        if (_nodes.size() < n) {
+            _nodes.resize(n);
+        }
+    }
+
+    /**
+     * @brief capacity function
+     * @returns size_t the size of the id range.
+     */
+    size_t capacity() const { return _nodes.size(); }
+
+    /**
+     * @brief memory_usage function
+     * @returns MEMORY::footprint the keys in the heap, the links of their nodes, the heap with
+     * its scratch space, and the nodes of the ids out of the heap and the spare capacity.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.payload = _size * sizeof(Key);
+        f.node_overhead = _size * (sizeof(_node) - sizeof(Key));
+        f.slack = (_nodes.capacity() - _size) * sizeof(_node);
+        f.control = sizeof(*this) + MEMORY::memory_usage(_scratch).total() - sizeof(_scratch) +
+                    (_nodes.capacity() > 0 ? MEMORY::ALLOCATION_OVERHEAD : 0);
+        return f;
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of ids in the heap.
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief empty function
+     * @returns true if the heap is empty.
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief contains function
+     * @param id: the id we want to look up.
+     * @returns true if id is in the heap.
+     */
+    bool contains(uint32_t id) const { return _nodes[id].in; }
+
+    /**
+     * @brief key function
+     * @param id: an id that is in the heap.
+     * @returns const Key& the current key of id.
+     */
+    const Key& key(uint32_t id) const { return _nodes[id].key; }
+
+    /**
+     * @brief top function
+     * @returns uint32_t the id with the smallest key.
+     */
+    uint32_t top() const { return _root; }
+
+    /**
+     * @brief top_key function
+     * @returns const Key& the smallest key.
+     */
+    const Key& top_key() const { return _nodes[_root].key; }
+
+    /**
+     * @brief push function
+     * Inserts id, or lowers its key if it is already in the heap with a larger one.
+     * @param id: the id.
+     * @param key: the key of id.
+     * @returns true if id was inserted or its key lowered.
+     */
+    bool push(uint32_t id, const Key& key) {
+        if (_nodes[id].in) {
+            return decrease_key(id, key);
+        }
+        _nodes[id] = {key, npos, npos, npos, true};
+        _root = _meld(_root, id);
+        _size++;
+        return true;
+    }
+
+    /**
+     * @brief decrease_key function
+     * @param id: an id that is in the heap.
+     * @param key: the new key, ignored if it is not smaller than the current one.
+     * @returns true if the key was lowered.
+     */
+    bool decrease_key(uint32_t id, const Key& key) {
+        if (!_less(key, _nodes[id].key)) {
+            return false;
+        }
+        _nodes[id].key = key;
+        if (id != _root) {
+            _cut(id);
+            _root = _meld(_root, id);
+        }
+        return true;
+    }
+
+    /**
+     * @brief pop function
+     * Removes the id with the smallest key.
+     * @returns uint32_t the removed id.
+     */
+    uint32_t pop() {
+        uint32_t id = _root;
+        _nodes[id].in = false;
+        _root = _merge_pairs(_nodes[id].child);
+        _size--;
+        return id;
+    }
+
+    /**
+     * @brief clear function
+     * Empties the heap in O(size()), the id range and the memory are kept.
+     */
+    void clear() {
+        _scratch.clear();
+        if (_root != npos) {
+            _scratch.push_back(_root);
+        }
+        while (!_scratch.empty()) {
+            uint32_t u = _scratch.back();
+            _scratch.pop_back();
+            _nodes[u].in = false;
+            for (uint32_t c = _nodes[u].child; c != npos; c = _nodes[c].sibling) {
+                _scratch.push_back(c);
+            }
+        }
+        _root = npos;
+        _size = 0;
+    }
+
+  private:
+    /**
+     * @brief node of the tree
+     * @param prev: the parent for a first child, the left sibling otherwise.
+     */
+    struct _node {
+        Key key{};
+        uint32_t child{npos};
+        uint32_t sibling{npos};
+        uint32_t prev{npos};
+        bool in{false};
+    };
+
+    std::vector<_node> _nodes;
+    std::vector<uint32_t> _scratch;
+    uint32_t _root{npos};
+    size_t _size{0};
+    Compare _less;
+
+    /**
+     * @brief links two detached trees, the root with the larger key becomes the first
+     * child of the other
+     */
+    uint32_t _meld(uint32_t a, uint32_t b) {
+        if (a == npos) {
+            return b;
+        }
+        if (b == npos) {
+            return a;
+        }
+        if (_less(_nodes[b].key, _nodes[a].key)) {
+            std::swap(a, b);
+        }
+        _nodes[b].sibling = _nodes[a].child;
+        if (_nodes[a].child != npos) {
+            _nodes[_nodes[a].child].prev = b;
+        }
+        _nodes[b].prev = a;
+        _nodes[a].child = b;
+        return a;
+    }
+
+    void _cut(uint32_t id) {
+        _node& n = _nodes[id];
+        if (_nodes[n.prev].child == id) {
+            _nodes[n.prev].child = n.sibling;
+        } else {
+            _nodes[n.prev].sibling = n.sibling;
+        }
+        if (n.sibling != npos) {
+            _nodes[n.sibling].prev = n.prev;
+        }
+        n.sibling = n.prev = npos;
+    }
+
+    /**
+     * @brief two-pass pairing: melds the siblings in pairs from left to right, then the
+     * pairs from right to left
+     */
+    uint32_t _merge_pairs(uint32_t first) {
+        _scratch.clear();
+        for (uint32_t a = first; a != npos;) {
+            uint32_t b = _nodes[a].sibling;
+            uint32_t next = b != npos ? _nodes[b].sibling : npos;
+            _nodes[a].sibling = _nodes[a].prev = npos;
+            if (b != npos) {
+                _nodes[b].sibling = _nodes[b].prev = npos;
+            }
+            _scratch.push_back(_meld(a, b));
+            a = next;
+        }
+        uint32_t root = npos;
+        while (!_scratch.empty()) {
+            root = _meld(_scratch.back(), root);
+            _scratch.pop_back();
+        }
+        if (root != npos) {
+            _nodes[root].prev = npos;
+        }
+        return root;
+    }
+};
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief radix heap class
+ * Monotone priority queue over dense ids in [0, n) with unsigned integer keys: a key
+ * can never be pushed below the last popped one, which holds for dijkstra with non
+ * negative integer weights. The entries are kept in one bucket per bit of the key,
+ * bucket i holding the keys whose highest bit differing from the last popped key is
+ * i - 1, so push and decrease_key are O(1) and pop moves every entry O(log C) times
+ * overall without comparing keys against each other. It has the interface of
+ * indexed_heap and plugs into the same algorithms.
+ * @tparam Key unsigned integer type of the keys. Default = uint64_t
+ */
+template <typename Key = uint64_t> class radix_heap {
+    static_assert(std::is_unsigned_v<Key>, "radix_heap needs unsigned integer keys");
+
+  public:
+    using key_type = Key;
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Construct a new radix heap object
+     * @param n: the number of ids the heap can hold. Default = 0
+     */
+    explicit radix_heap(size_t n = 0) : _where(n) {}
+
+    /**
+     * @brief resize function
+     * Grows the id range, the ids already in the heap stay there.
+     * @param n: the number of ids the heap can hold.
+     */
+    void resize(size_t n) {
+        if (_where.size() < n) {
+            _where.resize(n);
+        }
+    }
+
+    /**
+     * @brief capacity function
+     * @returns size_t the size of the id range.
+     */
+    size_t capacity() const { return _where.size(); }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of ids in the heap.
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief memory_usage function
+     * @returns MEMORY::footprint the keys, their ids and the places of the ids, the heap with
+     * the headers of its arrays, and the spare capacity.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::memory_usage(_where);
+        f.node_overhead = f.payload + _size * (sizeof(_entry) - sizeof(Key));
+        f.payload = _size * sizeof(Key);
+        for (const auto& b : _buckets) {
+            f.slack += (b.capacity() - b.size()) * sizeof(_entry);
+            f.control += b.capacity() > 0 ? MEMORY::ALLOCATION_OVERHEAD : 0;
+        }
+        f.control += sizeof(*this) - sizeof(_where);
+        return f;
+    }
+
+    /**
+     * @brief empty function
+     * @returns true if the heap is empty.
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief contains function
+     * @param id: the id we want to look up.
+     * @returns true if id is in the heap.
+     */
+    bool contains(uint32_t id) const { return _where[id].bucket != npos; }
+
+    /**
+     * @brief key function
+     * @param id: an id that is in the heap.
+     * @returns Key the current key of id.
+     */
+    Key key(uint32_t id) const { return _buckets[_where[id].bucket][_where[id].index].key; }
+
+    /**
+     * @brief top function
+     * @returns uint32_t an id with the smallest key.
+     */
+    uint32_t top() const { return _min().id; }
+
+    /**
+     * @brief top_key function
+     * @returns Key the smallest key.
+     */
+    Key top_key() const { return _min().key; }
+
+    /**
+     * @brief push function
+     * Inserts id, or lowers its key if it is already in the heap with a larger one.
+     * @param id: the id.
+     * @param key: the key of id, not below the last popped key.
+     * @returns true if id was inserted or its key lowered.
+     * Throws std::invalid_argument if key is below the last popped key.
+     */
+    bool push(uint32_t id, Key key) {
+        if (contains(id)) {
+            return decrease_key(id, key);
+        }
+        if (key < _last) {
+            throw std::invalid_argument("radix_heap: key below the last popped key");
+        }
+        _insert(id, key);
+        _size++;
+        return true;
+    }
+
+    /**
+     * @brief decrease_key function
+     * @param id: an id that is in the heap.
+     * @param key: the new key, ignored if it is not smaller than the current one.
+     * @returns true if the key was lowered.
+     * Throws std::invalid_argument if key is below the last popped key.
+     */
+    bool decrease_key(uint32_t id, Key key) {
+        if (!(key < this->key(id))) {
+            return false;
+        }
+        if (key < _last) {
+            throw std::invalid_argument("radix_heap: key below the last popped key");
+        }
+        _unlink(id);
+        _insert(id, key);
+        return true;
+    }
+
+    /**
+     * @brief pop function
+     * Removes an id with the smallest key.
+     * @returns uint32_t the removed id.
+     */
+    uint32_t pop() {
+        if (_buckets[0].empty()) {
+            _redistribute();
+        }
+        uint32_t id = _buckets[0].back().id;
+        _buckets[0].pop_back();
+        _where[id].bucket = npos;
+        _size--;
+        return id;
+    }
+
+    /**
+     * @brief clear function
+     * Empties the heap in O(size()), the id range and the memory are kept.
+     */
+    void clear() {
+        for (std::vector<_entry>& bucket : _buckets) {
+            for (const _entry& e : bucket) {
+                _where[e.id].bucket = npos;
+            }
+            bucket.clear();
+        }
+        _size = 0;
+        _last = 0;
+    }
+
+  private:
+    static constexpr size_t BUCKETS = std::numeric_limits<Key>::digits + 1;
+
+    struct _entry {
+        Key key;
+        uint32_t id;
+    };
+
+    struct _slot {
+        uint32_t bucket{npos};
+        uint32_t index{0};
+    };
+
+    std::vector<_entry> _buckets[BUCKETS];
+    std::vector<_slot> _where;
+    size_t _size{0};
+    Key _last{0};
+
+    void _insert(uint32_t id, Key key) {
+        uint32_t b = static_cast<uint32_t>(std::bit_width(static_cast<Key>(key ^ _last)));
+        _where[id] = {b, static_cast<uint32_t>(_buckets[b].size())};
+        _buckets[b].push_back({key, id});
+    }
+
+    void _unlink(uint32_t id) {
+        std::vector<_entry>& bucket = _buckets[_where[id].bucket];
+        uint32_t i = _where[id].index;
+        bucket[i] = bucket.back();
+        _where[bucket[i].id].index = i;
+        bucket.pop_back();
+    }
+
+    /**
+     * @brief the first non empty bucket holds the smallest keys, bucket 0 only holds
+     * keys equal to the last popped one
+     */
+    const _entry& _min() const {
+        size_t b = 0;
+        while (_buckets[b].empty()) {
+            b++;
+        }
+        if (b == 0) {
+            return _buckets[0].back();
+        }
+        const _entry* best = &_buckets[b].front();
+        for (const _entry& e : _buckets[b]) {
+            best = e.key < best->key ? &e : best;
+        }
+        return *best;
+    }
+
+    /**
+     * @brief moves the first non empty bucket down once bucket 0 ran out, its minimum
+     * becomes the last popped key and every entry lands in a lower bucket
+     */
+    void _redistribute() {
+        size_t b = 1;
+        while (_buckets[b].empty()) {
+            b++;
+        }
+        std::vector<_entry> moved;
+        moved.swap(_buckets[b]);
+        _last = moved.front().key;
+        for (const _entry& e : moved) {
+            _last = e.key < _last ? e.key : _last;
+        }
+        for (const _entry& e : moved) {
+            _insert(e.id, e.key);
+        }
+        // keep the capacity of the emptied bucket
+        moved.clear();
+        _buckets[b].swap(moved);
+    }
+};
+
+#endif
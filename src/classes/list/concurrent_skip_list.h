@@ -0,0 +1,407 @@
+#ifndef CONCURRENT_SKIP_LIST_H
+#define CONCURRENT_SKIP_LIST_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief concurrent skip list class
+ * Lock-free ordered set in the style of Fraser and Herlihy: every node has a tower of
+ * atomic next pointers, and a node is removed by setting the low bit(the mark) of each
+ * of its next pointers top-down, the mark of level 0 deciding which remover wins. Any
+ * insert or remove that walks over a marked node unlinks it with a CAS before going on,
+ * so no thread ever waits for another one. search takes no locks and never writes to the
+ * list or retries: it walks over the marked nodes and reads the keys it meets.
+ * The removed nodes are reclaimed by epochs, like concurrent_red_black_tree: every
+ * operation announces the current epoch in a reader slot before it reads the head, a
+ * node is retired with a fresh epoch once it is unlinked from every level, and it is
+ * freed once no slot announces an epoch up to that one. A node that is removed while its
+ * insert is still linking the upper levels is retired by whichever of the two finishes
+ * last, after one more search unlinks it from the levels the insert reached.
+ * @tparam T the type of the elements, ordered by operator <.
+ */
+template <typename T> class concurrent_skip_list {
+  public:
+    static constexpr int MAX_LEVEL = 32;
+
+    /**
+     * @brief Construct a new concurrent skip list object
+     * @param v: the elements to insert.
+     * @param readers: the number of reader slots, at most this many operations run at
+     * once and further threads spin until a slot is free. Default = 64
+     */
+    explicit concurrent_skip_list(const std::vector<T>& v = {}, size_t readers = 64)
+        : _slots(std::make_unique<_slot[]>(std::max<size_t>(readers, 1))),
+          _readers(std::max<size_t>(readers, 1)) {
+        for (auto& h : _head) {
+            h.store(0, std::memory_order_relaxed);
+        }
+        for (const T& x : v) {
+            insert(x);
+        }
+    }
+
+    concurrent_skip_list(const concurrent_skip_list&) = delete;
+    concurrent_skip_list& operator=(const concurrent_skip_list&) = delete;
+
+    /**
+     * @brief Destructor for concurrent skip list class, no operation can outlive it
+     */
+    ~concurrent_skip_list() {
+        for (node* n = _ptr(_head[0].load()); n != nullptr;) {
+            node* next = _ptr(n->next()[0].load());
+            _free(n);
+            n = next;
+        }
+        for (size_t i = 0; i < _readers; i++) {
+            for (auto& [tag, n] : _slots[i].limbo) {
+                _free(n);
+            }
+        }
+    }
+
+    /**
+     * @brief insert function
+     * @param key: the key to insert.
+     * @returns true if the key was not in the list.
+     */
+    bool insert(const T& key) {
+        _guard g(this);
+        tower preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        int top = _random_level();
+        node* nn = nullptr;
+        for (;;) {
+            if (_find(key, preds, succs)) {
+                if (nn) {
+                    _free(nn);
+                }
+                return false;
+            }
+            if (nn == nullptr) {
+                nn = _make(key, top);
+            }
+            for (int l = 0; l <= top; l++) {
+                nn->next()[l].store(_bits(succs[l]), std::memory_order_relaxed);
+            }
+            uintptr_t expected = _bits(succs[0]);
+            if (preds[0][0].compare_exchange_strong(expected, _bits(nn))) {
+                break;
+            }
+        }
+        _size.fetch_add(1, std::memory_order_relaxed);
+        for (int l = 1; l <= top; l++) {
+            if (!_link(nn, l, key, preds, succs)) {
+                break;
+            }
+        }
+        if (nn->state.fetch_or(INSERTED) & REMOVED) {
+            // the remover left the node to us, it may be linked on the levels we reached
+            _find(key, preds, succs);
+            _retire(g.slot, nn);
+        }
+        return true;
+    }
+
+    /**
+     * @brief remove function
+     * @param key: the key to remove.
+     * @returns true if the key was in the list.
+     */
+    bool remove(const T& key) {
+        _guard g(this);
+        tower preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        if (!_find(key, preds, succs)) {
+            return false;
+        }
+        node* victim = succs[0];
+        for (int l = victim->top; l >= 1; l--) {
+            uintptr_t raw = victim->next()[l].load();
+            while (!_marked(raw) && !victim->next()[l].compare_exchange_weak(raw, raw | 1)) {
+            }
+        }
+        uintptr_t raw = victim->next()[0].load();
+        for (;;) {
+            if (_marked(raw)) {
+                return false;
+            }
+            if (victim->next()[0].compare_exchange_weak(raw, raw | 1)) {
+                break;
+            }
+        }
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        if (victim->state.fetch_or(REMOVED) & INSERTED) {
+            _find(key, preds, succs);
+            _retire(g.slot, victim);
+        }
+        return true;
+    }
+
+    /**
+     * @brief search function
+     * @param key: the key to search.
+     * @returns true if the key is in the list.
+     */
+    bool search(const T& key) const {
+        _guard g(this);
+        const std::atomic<uintptr_t>* pred = _head;
+        node* curr = nullptr;
+        for (int l = MAX_LEVEL - 1; l >= 0; l--) {
+            curr = _ptr(pred[l].load(std::memory_order_acquire));
+            while (curr != nullptr) {
+                uintptr_t succ = curr->next()[l].load(std::memory_order_acquire);
+                if (_marked(succ)) {
+                    curr = _ptr(succ);
+                } else if (curr->key < key) {
+                    pred = curr->next();
+                    curr = _ptr(succ);
+                } else {
+                    break;
+                }
+            }
+        }
+        return curr != nullptr && !(key < curr->key);
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of elements, exact once the operations running finish.
+     */
+    size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief memory_usage function
+     * Exact while no other thread uses the list, the removed nodes waiting for their readers
+     * are left out.
+     * @returns MEMORY::footprint: the elements, the towers and states of the nodes, the list
+     * with its reader slots, and the headers of the node blocks.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.control = sizeof(*this) + _readers * sizeof(_slot) + MEMORY::ALLOCATION_OVERHEAD;
+        for (size_t i = 0; i < _readers; i++) {
+            f.control += MEMORY::memory_usage(_slots[i].limbo).total() - sizeof(_slots[i].limbo);
+        }
+        for (node* n = _ptr(_head[0].load(std::memory_order_acquire)); n != nullptr;
+             n = _ptr(n->next()[0].load(std::memory_order_acquire))) {
+            f.payload += sizeof(T) + MEMORY::heap_bytes(n->key);
+            f.node_overhead += sizeof(node) - sizeof(T) + size_t(n->top + 1) * sizeof(uintptr_t);
+            f.control += MEMORY::ALLOCATION_OVERHEAD;
+        }
+        return f;
+    }
+
+    /**
+     * @brief empty function
+     * @returns true if the list has no elements.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief elements function
+     * @returns vector<T> the elements in order. Elements inserted or removed while it
+     * runs may or may not be in it.
+     */
+    std::vector<T> elements() const {
+        _guard g(this);
+        std::vector<T> v;
+        for (node* n = _ptr(_head[0].load()); n != nullptr;) {
+            uintptr_t next = n->next()[0].load(std::memory_order_acquire);
+            if (!_marked(next)) {
+                v.push_back(n->key);
+            }
+            n = _ptr(next);
+        }
+        return v;
+    }
+
+    /**
+     * @brief pending function
+     * @returns size_t the number of removed nodes that are not freed yet.
+     */
+    size_t pending() const { return _pending.load(std::memory_order_relaxed); }
+
+  private:
+    using tower = std::atomic<uintptr_t>*;
+
+    static constexpr uint8_t INSERTED = 1;
+    static constexpr uint8_t REMOVED = 2;
+    static constexpr uint64_t IDLE = UINT64_MAX;
+    // a slot frees its retired nodes once it holds this many
+    static constexpr size_t RECLAIM = 32;
+
+    /**
+     * @brief struct for the node
+     * The tower of top + 1 next pointers is allocated right after the node.
+     */
+    struct alignas(std::atomic<uintptr_t>) node {
+        T key;
+        int top;
+        std::atomic<uint8_t> state{0};
+        node(const T& key, int top) : key(key), top(top) {}
+        tower next() { return std::launder(reinterpret_cast<tower>(this + 1)); }
+    };
+
+    struct alignas(64) _slot {
+        std::atomic<uint64_t> epoch{IDLE};
+        // only touched by the thread that holds the slot
+        std::vector<std::pair<uint64_t, node*>> limbo;
+    };
+
+    // pins a slot for the lifetime of one operation
+    struct _guard {
+        _slot* slot;
+        explicit _guard(const concurrent_skip_list* l) : slot(l->_pin()) {}
+        _guard(const _guard&) = delete;
+        _guard& operator=(const _guard&) = delete;
+        ~_guard() { slot->epoch.store(IDLE, std::memory_order_seq_cst); }
+    };
+
+    std::atomic<uintptr_t> _head[MAX_LEVEL];
+    std::atomic<size_t> _size{0};
+    std::atomic<uint64_t> _epoch{0};
+    std::atomic<size_t> _pending{0};
+    std::unique_ptr<_slot[]> _slots;
+    size_t _readers;
+
+    static node* _ptr(uintptr_t x) { return reinterpret_cast<node*>(x & ~uintptr_t(1)); }
+
+    static bool _marked(uintptr_t x) { return x & 1; }
+
+    static uintptr_t _bits(node* n) { return reinterpret_cast<uintptr_t>(n); }
+
+    static node* _make(const T& key, int top) {
+        size_t bytes = sizeof(node) + size_t(top + 1) * sizeof(std::atomic<uintptr_t>);
+        void* p = ::operator new(bytes);
+        node* n;
+        try {
+            n = ::new (p) node(key, top);
+        } catch (...) {
+            ::operator delete(p);
+            throw;
+        }
+        for (int l = 0; l <= top; l++) {
+            ::new (static_cast<void*>(reinterpret_cast<tower>(n + 1) + l))
+                std::atomic<uintptr_t>(0);
+        }
+        return n;
+    }
+
+    static void _free(node* n) {
+        n->~node();
+        ::operator delete(static_cast<void*>(n));
+    }
+
+    // geometric with p = 1/2: the number of trailing zeros of a xorshift of the thread
+    static int _random_level() {
+        thread_local uint64_t state =
+            std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return std::countr_zero(state | (uint64_t(1) << (MAX_LEVEL - 1)));
+    }
+
+    _slot* _pin() const {
+        size_t i = std::hash<std::thread::id>()(std::this_thread::get_id()) % _readers;
+        for (size_t tries = 1;; tries++, i = (i + 1) % _readers) {
+            if (tries % _readers == 0) {
+                std::this_thread::yield();
+            }
+            uint64_t idle = IDLE;
+            uint64_t e = _epoch.load(std::memory_order_seq_cst);
+            if (_slots[i].epoch.compare_exchange_strong(idle, e, std::memory_order_seq_cst)) {
+                return &_slots[i];
+            }
+        }
+    }
+
+    // fills the predecessors and successors of key on every level and unlinks the marked
+    // nodes on the way, returns true if succs[0] holds key
+    bool _find(const T& key, tower* preds, node** succs) {
+    retry:
+        tower pred = _head;
+        for (int l = MAX_LEVEL - 1; l >= 0; l--) {
+            node* curr = _ptr(pred[l].load());
+            while (curr != nullptr) {
+                uintptr_t succ = curr->next()[l].load();
+                while (_marked(succ)) {
+                    uintptr_t expected = _bits(curr);
+                    if (!pred[l].compare_exchange_strong(expected, succ & ~uintptr_t(1))) {
+                        goto retry;
+                    }
+                    curr = _ptr(succ);
+                    if (curr == nullptr) {
+                        break;
+                    }
+                    succ = curr->next()[l].load();
+                }
+                if (curr == nullptr || !(curr->key < key)) {
+                    break;
+                }
+                pred = curr->next();
+                curr = _ptr(succ);
+            }
+            preds[l] = pred;
+            succs[l] = curr;
+        }
+        return succs[0] != nullptr && !(key < succs[0]->key);
+    }
+
+    // links nn on level l, returns false if nn is being removed
+    bool _link(node* nn, int l, const T& key, tower* preds, node** succs) {
+        for (;;) {
+            uintptr_t raw = nn->next()[l].load();
+            if (_marked(raw)) {
+                return false;
+            }
+            if (raw != _bits(succs[l]) &&
+                !nn->next()[l].compare_exchange_strong(raw, _bits(succs[l]))) {
+                continue;
+            }
+            uintptr_t expected = _bits(succs[l]);
+            if (preds[l][l].compare_exchange_strong(expected, _bits(nn))) {
+                return true;
+            }
+            _find(key, preds, succs);
+        }
+    }
+
+    void _retire(_slot* s, node* n) {
+        uint64_t tag = _epoch.fetch_add(1, std::memory_order_seq_cst);
+        s->limbo.emplace_back(tag, n);
+        _pending.fetch_add(1, std::memory_order_relaxed);
+        if (s->limbo.size() < RECLAIM) {
+            return;
+        }
+        uint64_t oldest = IDLE;
+        for (size_t i = 0; i < _readers; i++) {
+            oldest = std::min(oldest, _slots[i].epoch.load(std::memory_order_seq_cst));
+        }
+        size_t kept = 0;
+        for (auto& [t, x] : s->limbo) {
+            if (t < oldest) {
+                _free(x);
+            } else {
+                s->limbo[kept++] = {t, x};
+            }
+        }
+        _pending.fetch_sub(s->limbo.size() - kept, std::memory_order_relaxed);
+        s->limbo.resize(kept);
+    }
+};
+
+#endif
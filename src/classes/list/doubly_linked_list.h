@@ -1,6 +1,8 @@
 #ifndef DOUBLY_LINKED_LIST_H
 #define DOUBLY_LINKED_LIST_H
 
+#include "../../helpers/memory_usage.h"
+
 #ifdef ENABLE_LINKED_LIST_VISUALIZATION
 #include "../../visualization/list_visual/linked_list_visualization.h"
 #endif
@@ -63,6 +65,25 @@ template <typename T> class doubly_linked_list {
      */
     inline size_t size() { return _size; }
 
+    /**
+     * @brief memory_usage function
+     * Every node is a block of its own with the control block of make_shared.
+     * @returns MEMORY::footprint: the elements, the shared_ptr links of the nodes, the list,
+     * the control blocks and the headers of the blocks.
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.payload = _size * sizeof(T);
+        if constexpr (MEMORY::may_own_heap_v<T>) {
+            for (node* t = root.get(); t != nullptr; t = t->next.get()) {
+                f.payload += MEMORY::heap_bytes(t->val);
+            }
+        }
+        f.node_overhead = _size * (sizeof(node) - sizeof(T));
+        f.control = sizeof(*this) + _size * (MEMORY::SHARED_CONTROL + MEMORY::ALLOCATION_OVERHEAD);
+        return f;
+    }
+
     class Iterator;
 
     /**
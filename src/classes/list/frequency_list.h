@@ -1,6 +1,8 @@
 #ifndef FREQUENCY_LIST_H
 #define FREQUENCY_LIST_H
 
+#include "../../helpers/node_pool.h"
+
 #ifdef ENABLE_LINKED_LIST_VISUALIZATION
 #include "../../visualization/list_visual/linked_list_visualization.h"
 #endif
@@ -8,8 +10,11 @@
 #ifdef __cplusplus
 #include <cstdint>
 #include <iostream>
-#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #endif
 
@@ -27,7 +32,20 @@
  * list.
  *
  * This class should be used for, for example, tracking user choices, making
- * them more accessible for the user in the future, improving their experience.
+ * them more accessible for the user in the future, improving their experience,
+ * or for choosing the evictions of a cache(LFU).
+ *
+ * The elements are kept in buckets, one per priority, chained in order of
+ * priority, and every bucket keeps its elements in the order they reached it. A
+ * hash index finds the node of an element, so an access moves the node to the
+ * next bucket and every operation other than reset_frequency is O(1).
+ *
+ * The priority of an element is its frequency plus the age of the list, where
+ * the age is the priority of the last evicted element(dynamic aging): a new
+ * element starts right above the elements that are about to be evicted instead
+ * of below elements that were popular a long time ago and are not used anymore,
+ * and no frequency is ever reset. Until the first eviction the priority is the
+ * frequency.
  */
 template <typename T> class frequency_list {
   public:
@@ -41,9 +59,12 @@ template <typename T> class frequency_list {
      *
      * @tparam T The type of elements stored in the frequency_list.
      * @param data An optional initializer list of elements.
+     * @param resource The memory resource the nodes, the buckets and the index come from.
      */
-    inline explicit frequency_list(std::vector<T> data = {}) noexcept
-        : head(nullptr), tail(nullptr) {
+    inline explicit frequency_list(std::vector<T> data = {},
+                                   std::pmr::memory_resource* resource =
+                                       std::pmr::get_default_resource()) noexcept
+        : _nodes(resource), _buckets(resource), _index(resource) {
         if (!data.empty()) {
             for (const auto& item : data) {
                 this->push_back(item);
@@ -55,28 +76,59 @@ template <typename T> class frequency_list {
      * @brief Copy constructor for the frequency_list class.
      *
      * This constructor creates a new frequency_list object by copying the
-     * elements from another frequency_list object. The elements are copied in the
-     * same order as they appear in the original frequency_list object.
+     * elements from another frequency_list object. The elements are copied with
+     * their frequencies and in the same order as they appear in the original
+     * frequency_list object.
      *
      * @param list The frequency_list object to copy from.
      */
-    inline frequency_list(const frequency_list<T>& list) : head(nullptr), tail(nullptr), size(0) {
-        for (auto iter = list.head; iter != nullptr; iter = iter->next) {
-            this->push_back(iter->data);
+    inline frequency_list(const frequency_list<T>& list) { _copy(list); }
+
+    /**
+     * @brief Move constructor for the frequency_list class.
+     *
+     * @param list The frequency_list object to move from, it is left empty.
+     */
+    inline frequency_list(frequency_list<T>&& list) noexcept { _steal(list); }
+
+    /**
+     * @brief Copy assignment for the frequency_list class.
+     *
+     * @param list The frequency_list object to copy from.
+     * @return frequency_list&
+     */
+    inline frequency_list& operator=(const frequency_list<T>& list) {
+        if (this != &list) {
+            _release();
+            _copy(list);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment for the frequency_list class.
+     *
+     * @param list The frequency_list object to move from, it is left empty.
+     * @return frequency_list&
+     */
+    inline frequency_list& operator=(frequency_list<T>&& list) noexcept {
+        if (this != &list) {
+            _release();
+            _steal(list);
         }
+        return *this;
     }
 
+    inline ~frequency_list() { _release(); }
+
     class Iterator;
 
     /**
      * @brief Adds an element to the back of the frequency list.
      *
-     * This function adds an element to the back of the frequency list. If the
-     * frequency list is empty, it creates a new node with the given data and
-     * frequency of 1 and sets it as the head. If the element already exists in
-     * the frequency list, it increments its frequency. Otherwise, it creates a
-     * new node with the given data and frequency of 1, and appends it to the end
-     * of the frequency list.
+     * If the element already exists in the frequency list, it increments its
+     * frequency. Otherwise, it creates a new node with the given data and
+     * frequency of 1, behind the other new elements.
      *
      * @param data The data to be added to the frequency list.
      */
@@ -85,14 +137,24 @@ template <typename T> class frequency_list {
     /**
      * @brief Adds an element to the front of the frequency list.
      *
-     * If the frequency list is not empty, it updates the previous pointer
-     * of the current head node to the new node. Then
-     * it sets the new node as the new head of the frequency list.
+     * If the element already exists in the frequency list, it increments its
+     * frequency. Otherwise, it creates a new node with the given data and
+     * frequency of 1, in front of the other new elements.
      *
      * @param data The data to be added to the frequency list.
      */
     void push_front(T data);
 
+    /**
+     * @brief Counts an access to an element, in O(1).
+     *
+     * The element is added with a frequency of 1 if it is not in the list.
+     *
+     * @param key The element that was accessed.
+     * @return The frequency of the element after the access.
+     */
+    int64_t touch(const T& key);
+
     /**
      * @brief Searches for a given key in the frequency list.
      *
@@ -115,17 +177,31 @@ template <typename T> class frequency_list {
     int64_t get_frequency(T key);
 
     /**
-     * @brief Removes the first occurrence of a given key in the frequency list.
-     *
-     * If the key is found, it removes the corresponding node and updates the
-     * pointers. If the head node is the one to be removed, the head pointer is
-     * updated accordingly. If the node has a previous and/or next node, their
-     * pointers are updated to connect them together.
+     * @brief Removes a given key from the frequency list.
      *
      * @param key The key to be removed from the frequency list.
      */
     void erase(T key);
 
+    /**
+     * @brief Gets the element with the lowest priority without removing it.
+     *
+     * Among the elements with the lowest priority it is the one that reached it
+     * first, so ties are broken by least recent use.
+     *
+     * @return The element, or std::nullopt if the list is empty.
+     */
+    std::optional<T> least_frequent() const;
+
+    /**
+     * @brief Removes the element with the lowest priority, in O(1).
+     *
+     * The age of the list becomes the priority of the evicted element.
+     *
+     * @return The evicted element, or std::nullopt if the list is empty.
+     */
+    std::optional<T> evict_least_frequent();
+
     /**
      * @brief Resets the frequency of all nodes in the frequency list to 1.
      */
@@ -143,7 +219,50 @@ template <typename T> class frequency_list {
      *
      * @return Returns true if the frequency list is empty, false otherwise.
      */
-    bool empty() { return head == nullptr; }
+    bool empty() const { return _index.empty(); }
+
+    /**
+     * @brief Gets the number of elements of the frequency list.
+     *
+     * @return The number of elements.
+     */
+    size_t size() const { return _index.size(); }
+
+    /**
+     * @brief Gets the memory resource the nodes, the buckets and the index come from.
+     *
+     * @return The memory resource.
+     */
+    std::pmr::memory_resource* resource() const noexcept { return _nodes.resource(); }
+
+    /**
+     * @brief Gets the memory the frequency list holds.
+     *
+     * @return The elements, the links and frequencies of the nodes with the buckets and the
+     * index of the elements, the list and the slab tables of its pools, and the free slots of
+     * the pools.
+     */
+    MEMORY::footprint memory_usage() const {
+        size_t owned = 0;
+        if constexpr (MEMORY::may_own_heap_v<T>) {
+            for (const auto& [key, n] : _index) {
+                owned += MEMORY::heap_bytes(n->data);
+            }
+        }
+        MEMORY::footprint f = _nodes.memory_usage(sizeof(T), owned);
+        MEMORY::footprint buckets = _buckets.memory_usage(0);
+        f.node_overhead += buckets.node_overhead + MEMORY::memory_usage(_index).total();
+        f.slack += buckets.slack;
+        f.control += buckets.control + sizeof(*this) - sizeof(_index);
+        return f;
+    }
+
+    /**
+     * @brief Gets the age of the frequency list.
+     *
+     * @return The priority of the last evicted element, 0 before the first eviction.
+     */
+    int64_t age() const { return _age; }
 
     /**
      * @brief Get an iterator pointing to the beginning of the frequency list.
@@ -152,7 +271,7 @@ template <typename T> class frequency_list {
      *
      * @return An Iterator object pointing to the beginning of the frequency list.
      */
-    Iterator begin() { return Iterator(head); }
+    Iterator begin() { return Iterator(_high ? _high->head : nullptr); }
 
     /**
      * @brief Get an iterator pointing to the end of the frequency list.
@@ -185,58 +304,94 @@ template <typename T> class frequency_list {
      * @return The output stream.
      */
     friend std::ostream& operator<<(std::ostream& os, const frequency_list<T>& flist) {
-        auto iterator = flist.head;
-        while (iterator != nullptr) {
-            os << iterator->data << "(" << iterator->freq << ") ";
-            iterator = iterator->next;
+        for (bucket* b = flist._high; b != nullptr; b = b->lower) {
+            for (node* x = b->head; x != nullptr; x = x->next) {
+                os << x->data << "(" << x->freq << ") ";
+            }
         }
         return os;
     }
 
   private:
+    struct bucket;
+
     struct node {
         T data;
         int64_t freq;
-        std::shared_ptr<node> next;
-        std::weak_ptr<node> prev;
+        bucket* b{nullptr};
+        node* prev{nullptr};
+        node* next{nullptr};
 
-        node(T data, int64_t freq, std::weak_ptr<node> prev, std::shared_ptr<node> next)
-            : data(data), freq(freq), prev(prev), next(next) {}
+        node(T data, int64_t freq) : data(std::move(data)), freq(freq) {}
+    };
 
-        void add_freq() { freq++; }
-        void reset_freq() { freq = 1; }
+    /**
+     * @brief The elements of one priority, in the order they reached it.
+     */
+    struct bucket {
+        int64_t priority;
+        bucket* lower{nullptr};
+        bucket* higher{nullptr};
+        node* head{nullptr};
+        node* tail{nullptr};
+
+        explicit bucket(int64_t priority) : priority(priority) {}
     };
 
-    std::shared_ptr<node> head;
-    node* tail;
-    uint64_t size{0};
+    node_pool<node> _nodes;
+    node_pool<bucket> _buckets;
+    bucket* _low{nullptr};
+    bucket* _high{nullptr};
+    std::pmr::unordered_map<T, node*> _index;
+    int64_t _age{0};
+
+    /**
+     * @brief Gets the bucket of a priority right above a bucket, creating it if needed.
+     *
+     * @param b The bucket below, nullptr for the bottom of the list.
+     * @param priority The priority, higher than the one of b and not higher than
+     * the one of the bucket above b.
+     * @return The bucket.
+     */
+    bucket* _bucket_above(bucket* b, int64_t priority);
 
     /**
-     * @brief Updates the order of nodes in the frequency list based on their
-     * frequencies.
+     * @brief Unlinks a node from its bucket, and the bucket from the list if it becomes
+     * empty.
      *
-     * This function updates the order of nodes in the frequency list based on
-     * their frequencies. It compares each node with its adjacent node and swaps
-     * them if the frequency of the current node is less than the frequency of the
-     * next node. After swapping, it updates the current node to point to its
-     * previous node. If the previous node exists, it becomes the new current
-     * node. If the previous node does not exist, the traversal stops.
+     * @param x The node.
      */
-    void update_list_sequence();
+    void _detach(node* x);
 
     /**
-     * @brief Swaps the positions of two nodes in the frequency list.
+     * @brief Links a node in a bucket, at its back or its front.
      *
-     * If either of the nodes is null or they are not adjacent to each other, the
-     * function does nothing.
+     * @param x The node.
+     * @param b The bucket.
+     * @param front True to link it in front of the other nodes of the bucket.
+     */
+    void _attach(node* x, bucket* b, bool front);
+
+    /**
+     * @brief Adds a new element with a frequency of 1.
      *
-     * The function modifies the pointers of the adjacent nodes and updates the
-     * head if necessary.
+     * @param data The element.
+     * @param front True to put it in front of the other new elements.
+     */
+    void _add(T data, bool front);
+
+    /**
+     * @brief Moves a node to the next priority.
      *
-     * @param a The first node to be swapped.
-     * @param b The second node to be swapped.
+     * @param x The node.
      */
-    void swap_nodes(std::shared_ptr<node> a, std::shared_ptr<node> b);
+    void _increment(node* x);
+
+    void _copy(const frequency_list& list);
+
+    void _steal(frequency_list& list) noexcept;
+
+    void _release() noexcept;
 
     /**
      *
@@ -248,173 +403,214 @@ template <typename T> class frequency_list {
 };
 
 template <typename T>
-inline void frequency_list<T>::swap_nodes(std::shared_ptr<node> a, std::shared_ptr<node> b) {
-    if (a == nullptr || b == nullptr || a->next != b)
-        return;
-
-    // Attach b's next to a and a's prev to b
-    a->next = b->next;
-    b->prev = a->prev;
-
-    // If b's next exists, attach a to its prev
-    if (b->next)
-        b->next->prev = a;
-
-    // If a's prev exists(i.e., a is not the head), attach b to its next
-    if (a->prev.lock())
-        a->prev.lock()->next = b;
-
-    // Now, attach a to b's next and b to a's prev
-    b->next = a;
-    a->prev = b;
-
-    // If the node a was the head node, update the head to b
-    if (head == a)
-        head = b;
+inline typename frequency_list<T>::bucket* frequency_list<T>::_bucket_above(bucket* b,
+                                                                          int64_t priority) {
+    bucket* h = b ? b->higher : _low;
+    if (h && h->priority == priority) {
+        return h;
+    }
+    bucket* nb = _buckets.create(priority);
+    nb->lower = b;
+    nb->higher = h;
+    (b ? b->higher : _low) = nb;
+    (h ? h->lower : _high) = nb;
+    return nb;
 }
 
-template <typename T> inline void frequency_list<T>::update_list_sequence() {
-    auto current_node = head;
-
-    while (current_node != nullptr && current_node->next != nullptr) {
-        if (current_node->freq < current_node->next->freq) {
-            swap_nodes(current_node, current_node->next);
+template <typename T> inline void frequency_list<T>::_detach(node* x) {
+    bucket* b = x->b;
+    (x->prev ? x->prev->next : b->head) = x->next;
+    (x->next ? x->next->prev : b->tail) = x->prev;
+    x->prev = x->next = nullptr;
+    x->b = nullptr;
+    if (b->head == nullptr) {
+        (b->lower ? b->lower->higher : _low) = b->higher;
+        (b->higher ? b->higher->lower : _high) = b->lower;
+        _buckets.destroy(b);
+    }
+}
 
-            if (current_node->prev.lock())
-                current_node = current_node->prev.lock();
+template <typename T> inline void frequency_list<T>::_attach(node* x, bucket* b, bool front) {
+    x->b = b;
+    if (front) {
+        x->next = b->head;
+        (b->head ? b->head->prev : b->tail) = x;
+        b->head = x;
+    } else {
+        x->prev = b->tail;
+        (b->tail ? b->tail->next : b->head) = x;
+        b->tail = x;
+    }
+}
 
-        } else
-            current_node = current_node->next;
+template <typename T> inline void frequency_list<T>::_add(T data, bool front) {
+    // every priority is at least the age, so the new priority is at the bottom
+    int64_t priority = _age + 1;
+    bucket* below = _low && _low->priority < priority ? _low : nullptr;
+    node* x = _nodes.create(data, 1);
+    try {
+        _index.emplace(std::move(data), x);
+    } catch (...) {
+        _nodes.destroy(x);
+        throw;
     }
+    _attach(x, _bucket_above(below, priority), front);
 }
 
-template <typename T> inline void frequency_list<T>::reset_frequency() {
-    auto iterator = head;
+template <typename T> inline void frequency_list<T>::_increment(node* x) {
+    bucket* b = x->b;
+    bucket* target = _bucket_above(b, b->priority + 1);
+    _detach(x);
+    _attach(x, target, false);
+    x->freq++;
+}
 
-    while (iterator != nullptr) {
-        iterator->reset_freq();
-        iterator = iterator->next;
+template <typename T> inline void frequency_list<T>::reset_frequency() {
+    if (_low == nullptr) {
+        return;
+    }
+    // the buckets are put in front of the bottom one from the bottom up, so the order
+    // is kept
+    bucket* keep = _low;
+    keep->priority = _age + 1;
+    for (bucket* b = keep->higher; b != nullptr;) {
+        bucket* higher = b->higher;
+        for (node* x = b->head; x != nullptr; x = x->next) {
+            x->b = keep;
+        }
+        b->tail->next = keep->head;
+        keep->head->prev = b->tail;
+        keep->head = b->head;
+        _buckets.destroy(b);
+        b = higher;
+    }
+    keep->higher = nullptr;
+    _high = keep;
+    for (node* x = keep->head; x != nullptr; x = x->next) {
+        x->freq = 1;
     }
 }
 
 template <typename T> inline void frequency_list<T>::push_front(T data) {
-    auto Iterator = head;
-
-    // Iterating over the list to find if the same data is already present
-    while (Iterator != nullptr) {
-        if (Iterator->data == data) {
-            // if data is found, increase frequency and re-sort the list
-            Iterator->freq++;
-            update_list_sequence();
-            return;
-        }
-        Iterator = Iterator->next;
+    auto it = _index.find(data);
+    if (it != _index.end()) {
+        _increment(it->second);
+    } else {
+        _add(std::move(data), true);
     }
+}
 
-    // if data is not found in the list, add new node at front
-    auto new_node = std::make_shared<node>(data, 1, std::weak_ptr<node>(), head);
-
-    if (head != nullptr) {
-        head->prev = new_node;
+template <typename T> inline void frequency_list<T>::push_back(T data) {
+    auto it = _index.find(data);
+    if (it != _index.end()) {
+        _increment(it->second);
+    } else {
+        _add(std::move(data), false);
     }
+}
 
-    head = new_node;
-
-    size++;
+template <typename T> inline int64_t frequency_list<T>::touch(const T& key) {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        _add(key, false);
+        return 1;
+    }
+    _increment(it->second);
+    return it->second->freq;
 }
 
 template <typename T> inline void frequency_list<T>::erase(T key) {
-    auto iterator = head;
-
-    // special case: deleting the head node
-    if (head != nullptr && head->data == key) {
-        head = head->next;
-        if (head)
-            head->prev.reset();
-        size--;
+    auto it = _index.find(key);
+    if (it == _index.end()) {
         return;
     }
+    node* x = it->second;
+    _index.erase(it);
+    _detach(x);
+    _nodes.destroy(x);
+}
 
-    // iterate over the rest nodes
-    while (iterator != nullptr) {
-        if (iterator->data == key) {
-            // connect previous node and next node
-            if (auto sharedPrev = iterator->prev.lock()) {
-                sharedPrev->next = iterator->next;
-            }
-            if (iterator->next) {
-                iterator->next->prev = iterator->prev;
-            }
-            // deleting the node by falling out of scope
-            size--;
-            return;
-        }
-        iterator = iterator->next;
+template <typename T> inline std::optional<T> frequency_list<T>::least_frequent() const {
+    if (_low == nullptr) {
+        return std::nullopt;
     }
+    return _low->head->data;
 }
 
-template <typename T> inline int64_t frequency_list<T>::get_frequency(T key) {
-    auto iterator = head;
-
-    while (iterator != nullptr) {
-        if (iterator->data == key) {
-            return iterator->freq;
-        }
-
-        iterator = iterator->next;
+template <typename T> inline std::optional<T> frequency_list<T>::evict_least_frequent() {
+    if (_low == nullptr) {
+        return std::nullopt;
     }
+    node* x = _low->head;
+    _age = _low->priority;
+    std::optional<T> data(std::move(x->data));
+    _index.erase(*data);
+    _detach(x);
+    _nodes.destroy(x);
+    return data;
+}
 
-    return -1;
+template <typename T> inline int64_t frequency_list<T>::get_frequency(T key) {
+    auto it = _index.find(key);
+    return it == _index.end() ? -1 : it->second->freq;
 }
 
 template <typename T> inline bool frequency_list<T>::search(T key) {
-    auto iterator = head;
-
-    while (iterator != nullptr) {
-        if (iterator->data == key) {
-            iterator->add_freq();
-            update_list_sequence();
-            return true;
-        }
-
-        iterator = iterator->next;
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        return false;
     }
-
-    return false;
+    _increment(it->second);
+    return true;
 }
 
-template <typename T> inline void frequency_list<T>::push_back(T data) {
-    if (this->empty()) {
-        head = std::make_shared<node>(data, 1, std::weak_ptr<node>(), nullptr);
-        return;
+template <typename T> inline std::vector<std::pair<T, int64_t>> frequency_list<T>::elements() {
+    std::vector<std::pair<T, int64_t>> ans;
+    ans.reserve(size());
+    for (bucket* b = _high; b != nullptr; b = b->lower) {
+        for (node* x = b->head; x != nullptr; x = x->next) {
+            ans.push_back(std::make_pair(x->data, x->freq));
+        }
     }
+    return ans;
+}
 
-    auto iterator = head;
-    while (iterator) {
-        if (iterator->data == data) {
-            iterator->add_freq();
-            update_list_sequence();
-            return;
+template <typename T> inline void frequency_list<T>::_copy(const frequency_list& list) {
+    _age = list._age;
+    _index.reserve(list.size());
+    bucket* below = nullptr;
+    for (bucket* b = list._low; b != nullptr; b = b->higher) {
+        below = _bucket_above(below, b->priority);
+        for (node* x = b->head; x != nullptr; x = x->next) {
+            node* nx = _nodes.create(x->data, x->freq);
+            _attach(nx, below, false);
+            _index.emplace(x->data, nx);
         }
-        if (!iterator->next)
-            break;
-        iterator = iterator->next;
     }
+}
 
-    auto newNode = std::shared_ptr<node>(new node(data, 1, iterator, nullptr));
-    if (iterator)
-        iterator->next = newNode;
-    size++;
+template <typename T> inline void frequency_list<T>::_steal(frequency_list& list) noexcept {
+    _nodes = std::move(list._nodes);
+    _buckets = std::move(list._buckets);
+    _low = std::exchange(list._low, nullptr);
+    _high = std::exchange(list._high, nullptr);
+    _index = std::move(list._index);
+    list._index.clear();
+    _age = std::exchange(list._age, 0);
 }
 
-template <typename T> inline std::vector<std::pair<T, int64_t>> frequency_list<T>::elements() {
-    std::vector<std::pair<T, int64_t>> ans;
-    std::shared_ptr<node> root = head;
-    while (root) {
-        ans.push_back(std::make_pair(root->data, root->freq));
-        root = root->next;
-    }
-    return ans;
+template <typename T> inline void frequency_list<T>::_release() noexcept {
+    _index.clear();
+    // every node is reached from the one before it, across the buckets
+    _nodes.clear(_high ? _high->head : nullptr, [](node* x, auto visit) {
+        if (x->next) {
+            visit(x->next);
+        } else if (x->b->lower) {
+            visit(x->b->lower->head);
+        }
+    });
+    _buckets.clear(_high, [](bucket* b, auto visit) { visit(b->lower); });
+    _low = _high = nullptr;
 }
 
 template <typename T> inline std::string frequency_list<T>::generate() {
@@ -435,25 +631,21 @@ template <typename T> inline std::string frequency_list<T>::generate() {
             gen += '\n';
         }
 
-        std::shared_ptr<node> curr = head;
-        while (curr->next) {
-            gen += curr->data;
+        for (size_t i = 0; i + 1 < els.size(); i++) {
+            gen += els[i].first;
             gen += ":ref -> ";
-            gen += curr->next->data;
+            gen += els[i + 1].first;
             gen += ":data [arrowhead=vee, arrowtail=dot, dir=both];";
             gen += '\n';
 
-            gen += curr->next->data;
+            gen += els[i + 1].first;
             gen += ":data -> ";
-            gen += curr->data;
+            gen += els[i].first;
             gen += ":ref [arrowhead=vee, arrowtail=dot, dir=both];";
             gen += '\n';
-
-            curr = curr->next;
         }
     } else {
         for (auto& x : els) {
-            std::cout << std::to_string(x.first) << " " << std::to_string(x.second) << '\n';
             gen += std::to_string(x.first);
             gen += " [label=<{ ";
             gen += std::to_string(x.first);
@@ -463,21 +655,18 @@ template <typename T> inline std::string frequency_list<T>::generate() {
             gen += '\n';
         }
 
-        std::shared_ptr<node> curr = head;
-        while (curr->next) {
-            gen += std::to_string(curr->data);
+        for (size_t i = 0; i + 1 < els.size(); i++) {
+            gen += std::to_string(els[i].first);
             gen += ":ref -> ";
-            gen += std::to_string(curr->next->data);
+            gen += std::to_string(els[i + 1].first);
             gen += ":data [arrowhead=vee, arrowtail=dot, dir=both];";
             gen += '\n';
 
-            gen += std::to_string(curr->next->data);
+            gen += std::to_string(els[i + 1].first);
             gen += ":data -> ";
-            gen += std::to_string(curr->data);
+            gen += std::to_string(els[i].first);
             gen += ":ref [arrowhead=vee, arrowtail=dot, dir=both];";
             gen += '\n';
-
-            curr = curr->next;
         }
     }
     return gen;
@@ -492,7 +681,7 @@ template <typename T> inline void frequency_list<T>::visualize() {
 
 template <typename T> class frequency_list<T>::Iterator {
   private:
-    std::shared_ptr<node> current;
+    node* current;
 
   public:
     /**
@@ -500,18 +689,18 @@ template <typename T> class frequency_list<T>::Iterator {
      *
      * The Iterator class provides an iterator for traversing a linked list.
      */
-    explicit Iterator(const std::shared_ptr<node>& ptr) noexcept : current(ptr) {}
+    explicit Iterator(node* ptr) noexcept : current(ptr) {}
 
     /**
      * @brief Assignment operator for the Iterator class.
      *
-     * It assigns the value of the given shared pointer to the current node of the
+     * It assigns the value of the given pointer to the current node of the
      * iterator and returns a reference to the updated iterator.
      *
-     * @param ptr The shared pointer to assign.
+     * @param ptr The pointer to assign.
      * @return A reference to the updated iterator.
      */
-    Iterator& operator=(const std::shared_ptr<node>& ptr) {
+    Iterator& operator=(node* ptr) {
         current = ptr;
         return *this;
     }
@@ -527,7 +716,11 @@ template <typename T> class frequency_list<T>::Iterator {
      */
     Iterator& operator++() {
         if (current) {
-            current = current->next;
+            if (current->next) {
+                current = current->next;
+            } else {
+                current = current->b->lower ? current->b->lower->head : nullptr;
+            }
         }
         return *this;
     }
@@ -558,7 +751,11 @@ template <typename T> class frequency_list<T>::Iterator {
      */
     Iterator& operator--() {
         if (current) {
-            current = current->prev;
+            if (current->prev) {
+                current = current->prev;
+            } else {
+                current = current->b->higher ? current->b->higher->tail : nullptr;
+            }
         }
         return *(this);
     }
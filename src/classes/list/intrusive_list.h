@@ -0,0 +1,335 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#ifdef __cplusplus
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#endif
+
+/**
+ * @brief hook of intrusive_list
+ * Derive the objects from it to put them in an intrusive_list, and from one hook per Tag
+ * to put them in many lists at once. Copying an object does not copy its place in a list,
+ * and an object must be erased from its lists before it is destroyed.
+ * @tparam Tag tells the hooks of one object apart. Default = void
+ */
+template <typename Tag = void> class intrusive_list_hook {
+  public:
+    intrusive_list_hook() noexcept = default;
+    intrusive_list_hook(const intrusive_list_hook&) noexcept {}
+    intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept { return *this; }
+    ~intrusive_list_hook() { assert(!is_linked() && "destroyed while in an intrusive_list"); }
+
+    /**
+     * @brief is_linked function
+     * @return true if the object is in a list.
+     */
+    bool is_linked() const noexcept { return next != nullptr; }
+
+  private:
+    template <typename, typename> friend class intrusive_list;
+    intrusive_list_hook* prev{nullptr};
+    intrusive_list_hook* next{nullptr};
+};
+
+/**
+ * @brief intrusive doubly linked list class
+ * A list of objects that it does not own: the links are in the objects(their
+ * intrusive_list_hook), so inserting allocates nothing, and erasing an object, moving it
+ * to another list or splicing are O(1) from a reference to it. The list is circular around
+ * a hook of its own, so no operation checks for the ends.
+ * @tparam T the type of the objects, it derives from intrusive_list_hook<Tag>.
+ * @tparam Tag the hook of T the list uses. Default = void
+ */
+template <typename T, typename Tag = void> class intrusive_list {
+    using hook = intrusive_list_hook<Tag>;
+    static_assert(std::is_base_of_v<hook, T>, "T must derive from intrusive_list_hook<Tag>");
+
+    template <typename U> class basic_iterator;
+
+  public:
+    using iterator = basic_iterator<T>;
+    using const_iterator = basic_iterator<const T>;
+
+    /**
+     * @brief intrusive_list class constructor
+     */
+    intrusive_list() noexcept { _head.prev = _head.next = &_head; }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    /**
+     * @brief move constructor for the intrusive_list class
+     * @param l the list we want to move, it is left empty
+     */
+    intrusive_list(intrusive_list&& l) noexcept : intrusive_list() { _take(l); }
+
+    /**
+     * @brief move assignment for the intrusive_list class
+     * @param l the list we want to move, it is left empty
+     * @return intrusive_list&
+     */
+    intrusive_list& operator=(intrusive_list&& l) noexcept {
+        if (this != &l) {
+            clear();
+            _take(l);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief destructor, the objects are unlinked but not destroyed
+     */
+    ~intrusive_list() {
+        clear();
+        _head.prev = _head.next = nullptr;
+    }
+
+    /**
+     * @brief empty function
+     * @return true if the list is empty.
+     */
+    bool empty() const noexcept { return _size == 0; }
+
+    /**
+     * @brief size function
+     * @return size_t the size of the list.
+     */
+    size_t size() const noexcept { return _size; }
+
+    iterator begin() noexcept { return iterator(_head.next); }
+    iterator end() noexcept { return iterator(&_head); }
+    const_iterator begin() const noexcept { return const_iterator(_head.next); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<hook*>(&_head)); }
+
+    /**
+     * @brief front function
+     * @return T& the first object, the list must not be empty.
+     */
+    T& front() { return _object(_head.next); }
+
+    /**
+     * @brief back function
+     * @return T& the last object, the list must not be empty.
+     */
+    T& back() { return _object(_head.prev); }
+
+    /**
+     * @brief push_back function
+     * @param x: the object, it must not be in a list of this Tag.
+     */
+    void push_back(T& x) noexcept { _link(&_head, x); }
+
+    /**
+     * @brief push_front function
+     * @param x: the object, it must not be in a list of this Tag.
+     */
+    void push_front(T& x) noexcept { _link(_head.next, x); }
+
+    /**
+     * @brief insert function
+     * @param pos: the object is inserted before pos.
+     * @param x: the object, it must not be in a list of this Tag.
+     * @return iterator to x.
+     */
+    iterator insert(const_iterator pos, T& x) noexcept {
+        _link(pos._node, x);
+        return iterator(static_cast<hook*>(&x));
+    }
+
+    /**
+     * @brief pop_front function
+     * @return T& the object that was first, the list must not be empty.
+     */
+    T& pop_front() noexcept {
+        T& x = front();
+        erase(x);
+        return x;
+    }
+
+    /**
+     * @brief pop_back function
+     * @return T& the object that was last, the list must not be empty.
+     */
+    T& pop_back() noexcept {
+        T& x = back();
+        erase(x);
+        return x;
+    }
+
+    /**
+     * @brief erase function
+     * @param x: the object, it must be in this list.
+     */
+    void erase(T& x) noexcept {
+        hook* h = static_cast<hook*>(&x);
+        assert(h->is_linked());
+        h->prev->next = h->next;
+        h->next->prev = h->prev;
+        h->prev = h->next = nullptr;
+        _size--;
+    }
+
+    /**
+     * @brief erase function
+     * @param pos: iterator to the object.
+     * @return iterator to the object after it.
+     */
+    iterator erase(const_iterator pos) noexcept {
+        hook* next = pos._node->next;
+        erase(const_cast<T&>(*pos));
+        return iterator(next);
+    }
+
+    /**
+     * @brief iterator_to function
+     * @param x: the object, it must be in this list.
+     * @return iterator to x.
+     */
+    iterator iterator_to(T& x) noexcept { return iterator(static_cast<hook*>(&x)); }
+
+    /**
+     * @brief splice function
+     * Moves every object of l before pos, in O(1).
+     * @param pos: iterator of this list.
+     * @param l: the other list, it is left empty.
+     */
+    void splice(const_iterator pos, intrusive_list& l) noexcept {
+        if (&l == this || l.empty()) {
+            return;
+        }
+        hook* at = pos._node;
+        hook* first = l._head.next;
+        hook* last = l._head.prev;
+        first->prev = at->prev;
+        last->next = at;
+        at->prev->next = first;
+        at->prev = last;
+        _size += l._size;
+        l._head.prev = l._head.next = &l._head;
+        l._size = 0;
+    }
+
+    /**
+     * @brief splice function
+     * Moves one object from l before pos, in O(1).
+     * @param pos: iterator of this list.
+     * @param l: the list that has x, it may be this one.
+     * @param x: the object.
+     */
+    void splice(const_iterator pos, intrusive_list& l, T& x) noexcept {
+        if (pos._node == static_cast<hook*>(&x)) {
+            return;
+        }
+        l.erase(x);
+        _link(pos._node, x);
+    }
+
+    /**
+     * @brief clear function
+     * Unlinks every object, in O(n), the objects are not destroyed.
+     */
+    void clear() noexcept {
+        for (hook* h = _head.next; h != &_head;) {
+            hook* next = h->next;
+            h->prev = h->next = nullptr;
+            h = next;
+        }
+        _head.prev = _head.next = &_head;
+        _size = 0;
+    }
+
+    /**
+     *@brief << operator for the intrusive_list class.
+     */
+    friend std::ostream& operator<<(std::ostream& out, const intrusive_list& l) {
+        out << '{';
+        for (const T& x : l) {
+            out << x << ' ';
+        }
+        out << '}' << '\n';
+        return out;
+    }
+
+  private:
+    hook _head;
+    size_t _size{0};
+
+    static T& _object(hook* h) noexcept { return static_cast<T&>(*h); }
+
+    void _link(hook* at, T& x) noexcept {
+        hook* h = static_cast<hook*>(&x);
+        assert(!h->is_linked());
+        h->next = at;
+        h->prev = at->prev;
+        at->prev->next = h;
+        at->prev = h;
+        _size++;
+    }
+
+    void _take(intrusive_list& l) noexcept { splice(end(), l); }
+
+    /**
+     * @brief Iterator class
+     */
+    template <typename U> class basic_iterator {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::remove_const_t<U>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = U*;
+        using reference = U&;
+
+        basic_iterator() noexcept = default;
+
+        /**
+         * @brief an iterator converts to a const_iterator
+         */
+        operator basic_iterator<const U>() const noexcept
+            requires(!std::is_const_v<U>)
+        {
+            return basic_iterator<const U>(_node);
+        }
+
+        U& operator*() const noexcept { return _object(_node); }
+        U* operator->() const noexcept { return &_object(_node); }
+
+        basic_iterator& operator++() noexcept {
+            _node = _node->next;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            basic_iterator it = *this;
+            _node = _node->next;
+            return it;
+        }
+
+        basic_iterator& operator--() noexcept {
+            _node = _node->prev;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept {
+            basic_iterator it = *this;
+            _node = _node->prev;
+            return it;
+        }
+
+        bool operator==(const basic_iterator& it) const noexcept { return _node == it._node; }
+        bool operator!=(const basic_iterator& it) const noexcept { return _node != it._node; }
+
+      private:
+        friend class intrusive_list;
+        template <typename> friend class basic_iterator;
+        hook* _node{nullptr};
+        explicit basic_iterator(hook* node) noexcept : _node(node) {}
+    };
+};
+
+#endif
@@ -1,20 +1,25 @@
 #ifndef LINKED_LIST_H
 #define LINKED_LIST_H
 
+#include "../../helpers/node_pool.h"
+
 #ifdef ENABLE_LINKED_LIST_VISUALIZATION
 #include "../../visualization/list_visual/linked_list_visualization.h"
 #endif
 
 #ifdef __cplusplus
 #include <iostream>
-#include <memory>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #endif
 
 /**
  *@brief single linked list class
+ *The nodes come from a node_pool owned by the list, so consecutive pushes are
+ *next to each other in memory and a node costs its value and one pointer. For
+ *long scans use unrolled_linked_list, which keeps many values per node.
  */
 
 template <typename T> class linked_list {
@@ -23,9 +28,13 @@ template <typename T> class linked_list {
      *@brief linked_list class constructor
      *@param __elements: you can provide the constructor with a vector of elements
      *so you dont have to do multiple push backs yourself.
+     *@param resource: the memory resource the nodes come from. Default =
+     *std::pmr::get_default_resource()
      */
-    inline explicit linked_list(std::vector<T> _elements = {}) noexcept
-        : root(nullptr), tail(nullptr) {
+    inline explicit linked_list(std::vector<T> _elements = {},
+                                std::pmr::memory_resource* resource =
+                                    std::pmr::get_default_resource()) noexcept
+        : _pool(resource), root(nullptr), tail(nullptr) {
         if (!_elements.empty()) {
             for (T& x : _elements) {
                 this->push_back(x);
@@ -37,8 +46,17 @@ template <typename T> class linked_list {
      * @brief copy constructor for the linked_list class
      * @param l the list we want to copy
      */
-    inline explicit linked_list(const linked_list& l)
-        : root(l.root), tail(l.tail), _size(l._size) {}
+    inline explicit linked_list(const linked_list& l) : root(nullptr), tail(nullptr) {
+        _copy(l);
+    }
+
+    /**
+     * @brief move constructor for the linked_list class
+     * @param l the list we want to move, it is left empty
+     */
+    inline linked_list(linked_list&& l) noexcept
+        : _pool(std::move(l._pool)), root(std::exchange(l.root, nullptr)),
+          tail(std::exchange(l.tail, nullptr)), _size(std::exchange(l._size, 0)) {}
 
     /**
      * @brief operator = for linked list class
@@ -46,12 +64,31 @@ template <typename T> class linked_list {
      * @return linked_list&
      */
     inline linked_list& operator=(const linked_list& l) {
-        root = l.root;
-        tail = l.tail;
-        _size = l._size;
+        if (this != &l) {
+            _release();
+            _copy(l);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief move assignment for linked list class
+     * @param l the list we want to move, it is left empty
+     * @return linked_list&
+     */
+    inline linked_list& operator=(linked_list&& l) noexcept {
+        if (this != &l) {
+            _release();
+            _pool = std::move(l._pool);
+            root = std::exchange(l.root, nullptr);
+            tail = std::exchange(l.tail, nullptr);
+            _size = std::exchange(l._size, 0);
+        }
         return *this;
     }
 
+    inline ~linked_list() { _release(); }
+
     /**
      *@brief empty function.
      *Returns true if the list is empty.
@@ -64,6 +101,26 @@ template <typename T> class linked_list {
      */
     inline size_t size() { return _size; }
 
+    /**
+     *@brief resource function.
+     *Returns the memory resource the nodes come from.
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _pool.resource(); }
+
+    /**
+     * @brief memory_usage function
+     * @returns MEMORY::footprint: the elements, the links of the nodes, the list and the slab
+     * table of its pool, and the free slots of the pool.
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = _pool.memory_usage(
+            sizeof(T), MEMORY::owned(
+                           root, [](const node* n, auto visit) { visit(n->next); },
+                           [](const node* n) -> const T& { return n->val; }));
+        f.control += sizeof(*this);
+        return f;
+    }
+
     class Iterator;
 
     /**
@@ -127,10 +184,8 @@ template <typename T> class linked_list {
      */
     inline friend std::ostream& operator<<(std::ostream& out, linked_list<T>& l1) {
         out << '{';
-        std::shared_ptr<node> head = l1.root;
-        while (head) {
+        for (node* head = l1.root; head; head = head->next) {
             out << head->val << ' ';
-            head = head->next;
         }
         out << '}' << '\n';
         return out;
@@ -144,18 +199,32 @@ template <typename T> class linked_list {
      */
     struct node {
         T val;
-        std::shared_ptr<node> next;
+        node* next;
         node(T key = 0) : val(key), next(nullptr) {}
     };
-    std::shared_ptr<node> root;
-    std::shared_ptr<node> tail;
+    node_pool<node> _pool;
+    node* root;
+    node* tail;
     size_t _size{0};
 
     std::string generate();
+
+    void _copy(const linked_list& l) {
+        _pool.reserve(l._size);
+        for (node* t = l.root; t; t = t->next) {
+            push_back(t->val);
+        }
+    }
+
+    void _release() {
+        _pool.clear(root, [](node* n, auto visit) { visit(n->next); });
+        root = tail = nullptr;
+        _size = 0;
+    }
 };
 
 template <typename T> inline void linked_list<T>::push_back(T key) {
-    std::shared_ptr<node> p = std::make_shared<node>(key);
+    node* p = _pool.create(key);
     if (root == nullptr) {
         root = p;
     } else {
@@ -166,76 +235,55 @@ template <typename T> inline void linked_list<T>::push_back(T key) {
 }
 
 template <typename T> inline void linked_list<T>::push_front(T key) {
-    std::shared_ptr<node> p = std::make_shared<node>(key);
+    node* p = _pool.create(key);
     p->next = root;
     if (tail == nullptr) {
-        tail = root;
+        tail = p;
     }
     root = p;
     _size++;
 }
 
 template <typename T> inline void linked_list<T>::erase(T key) {
-    if (empty()) {
-        return;
-    }
-    std::shared_ptr<node> t = root;
-    std::shared_ptr<node> to_be_removed = nullptr;
-    while (t != tail && t->next->val != key) {
+    node* prev = nullptr;
+    node* t = root;
+    while (t && t->val != key) {
+        prev = t;
         t = t->next;
     }
-    if (t == tail) {
+    if (t == nullptr) {
         return;
     }
-    to_be_removed = t->next;
-    t->next = t->next->next;
-    to_be_removed.reset();
-    if (t->next == nullptr) {
-        tail = t;
-    }
-    if (root == tail) {
-        tail = nullptr;
+    (prev ? prev->next : root) = t->next;
+    if (t == tail) {
+        tail = prev;
     }
+    _pool.destroy(t);
     _size--;
 }
 
 template <typename T> inline bool linked_list<T>::search(T key) {
-    try {
-        if (empty()) {
-            return false;
-        } else {
-            std::shared_ptr<node> t = root;
-            while (t != tail && t->val != key) {
-                t = t->next;
-            }
-            if (t == tail || t == nullptr) {
-                return false;
-            }
+    for (node* t = root; t; t = t->next) {
+        if (t->val == key) {
             return true;
         }
-    } catch (std::invalid_argument& e) {
-        std::cerr << e.what() << '\n';
-        return false;
     }
+    return false;
 }
 
 template <typename T> inline std::vector<T> linked_list<T>::elements() {
     std::vector<T> _elements;
-
-    if (this->empty()) {
-        return _elements;
-    }
-    std::shared_ptr<node> head = root;
-    while (head) {
+    _elements.reserve(_size);
+    for (node* head = root; head; head = head->next) {
         _elements.push_back(head->val);
-        head = head->next;
     }
     return _elements;
 }
 
 template <typename T> inline void linked_list<T>::reverse() {
-    std::shared_ptr<node> current = root;
-    std::shared_ptr<node> prev{nullptr}, next{nullptr};
+    node* current = root;
+    node *prev{nullptr}, *next{nullptr};
+    tail = root;
 
     while (current != nullptr) {
         next = current->next;
@@ -262,8 +310,8 @@ template <typename T> inline std::string linked_list<T>::generate() {
             gen += '\n';
         }
 
-        std::shared_ptr<node> curr = root;
-        while (curr->next) {
+        node* curr = root;
+        while (curr && curr->next) {
             gen += curr->val;
             gen += ":ref -> ";
             gen += curr->next->val;
@@ -280,8 +328,8 @@ template <typename T> inline std::string linked_list<T>::generate() {
             gen += '\n';
         }
 
-        std::shared_ptr<node> curr = root;
-        while (curr->next) {
+        node* curr = root;
+        while (curr && curr->next) {
             gen += std::to_string(curr->val);
             gen += ":ref -> ";
             gen += std::to_string(curr->next->val);
@@ -305,7 +353,7 @@ template <typename T> inline void linked_list<T>::visualize() {
  */
 template <typename T> class linked_list<T>::Iterator {
   private:
-    std::shared_ptr<node> curr_root;
+    const node* curr_root;
 
   public:
     /**
@@ -313,15 +361,15 @@ template <typename T> class linked_list<T>::Iterator {
      *
      * @param l linked list type
      */
-    explicit Iterator(const std::shared_ptr<node>& l) noexcept : curr_root(l) {}
+    explicit Iterator(const node* l) noexcept : curr_root(l) {}
 
     /**
      * @brief = operator for Iterator type
      *
-     * @param current smart pointer of type node
+     * @param current pointer of type node
      * @return Iterator&
      */
-    Iterator& operator=(std::shared_ptr<node> current) {
+    Iterator& operator=(const node* current) {
         this->curr_root = current;
         return *(this);
     }
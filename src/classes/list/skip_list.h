@@ -1,46 +1,80 @@
 #ifndef SKIP_LIST_H
 #define SKIP_LIST_H
 
+#include "../../helpers/archive.h"
+#include "../../helpers/memory_usage.h"
+
 #ifdef LINKED_LIST_VISUALIZATION_H
 #include "../../visualization/list_visual/linked_list_visualization.h"
 #endif
 
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 #endif
 
 /**
  *@brief skip_list class.
+ *Every node is allocated in one piece with its tower of level + 1 next pointers, from an
+ *arena owned by the list that keeps a free list per tower height, so an insert costs one
+ *bump of the arena(or a pop of a free list) and no reference counts. The slabs of the arena
+ *come from a std::pmr::memory_resource. insert and remove
+ *keep the predecessors of every level in an array on the stack, and the levels are drawn
+ *from a xorshift generator: for PROB = 1/2^k the level is the number of trailing zeros of
+ *one draw divided by k, with no loop.
  */
 
 template <typename T> class skip_list {
   public:
+    /**
+     *@brief the largest MAX_LEVEL a skip list accepts plus one.
+     */
+    static constexpr int LEVEL_CAP = 32;
+
     /**
      *@brief skip_list constructor.
-     *@param __MAX_LEVEL: max height of the list.
+     *@param __MAX_LEVEL: max height of the list, smaller than LEVEL_CAP.
      *@param __PROB: probability of increasing the height each time(by default it
      *should be 0.5).
+     *@param resource: the memory resource the slabs come from. Default =
+     *std::pmr::get_default_resource()
      */
-    inline explicit skip_list(int MAX_LEVEL, float PROB) {
+    inline explicit skip_list(int MAX_LEVEL, float PROB,
+                              std::pmr::memory_resource* resource =
+                                  std::pmr::get_default_resource())
+        : _rng((0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(this)) | 1),
+          _resource(resource) {
+        std::fill(_head, _head + LEVEL_CAP, nullptr);
         try {
-            if (MAX_LEVEL < 5) {
-                MAX_LEVEL = MAX_LEVEL;
-                root = std::make_shared<node>(0, MAX_LEVEL);
-            } else {
+            if (MAX_LEVEL < 0 || MAX_LEVEL >= LEVEL_CAP) {
                 throw std::invalid_argument("Max level value is too high");
             }
-            if (PROB > 0.0 && PROB < 1.0) {
-                PROB = PROB;
-            } else if (PROB >= 1.0) {
+            if (PROB >= 1.0) {
                 throw std::invalid_argument("Probability value is greater or equal to 1");
             } else if (PROB <= 0.0) {
                 throw std::invalid_argument("Probability value is smaller or equal to 0");
             }
+            this->MAX_LEVEL = MAX_LEVEL;
+            this->PROB = PROB;
+            for (int k = 1; k < 32; k++) {
+                if (PROB == std::ldexp(1.0f, -k)) {
+                    _shift = k;
+                    break;
+                }
+            }
         } catch (std::invalid_argument& e) {
             std::cerr << e.what() << '\n';
             return;
@@ -48,12 +82,27 @@ template <typename T> class skip_list {
     }
 
     /**
-     * @brief Copy constructor for the skip_list class
+     * @brief Copy constructor for the skip_list class, it copies the towers as they are
      *
      * @param s
      */
     inline skip_list(const skip_list& s)
-        : level(s.level), PROB(s.PROB), MAX_LEVEL(s.MAX_LEVEL), root(s.root) {}
+        : MAX_LEVEL(s.MAX_LEVEL), PROB(s.PROB), _shift(s._shift), _rng(s._rng) {
+        std::fill(_head, _head + LEVEL_CAP, nullptr);
+        _copy(s);
+    }
+
+    /**
+     * @brief Move constructor for the skip_list class
+     *
+     * @param s the list we want to move, it is left empty
+     */
+    inline skip_list(skip_list&& s) noexcept
+        : MAX_LEVEL(s.MAX_LEVEL), PROB(s.PROB), _shift(s._shift), _rng(s._rng),
+          _resource(s._resource) {
+        std::fill(_head, _head + LEVEL_CAP, nullptr);
+        _steal(s);
+    }
 
     /**
      * @brief operator = for the skip_list class
@@ -61,49 +110,92 @@ template <typename T> class skip_list {
      * @return skip_list&
      */
     inline skip_list& operator=(const skip_list& s) {
-        level = s.level;
-        PROB = s.PROB;
-        MAX_LEVEL = s.MAX_LEVEL;
-        root = s.root;
+        if (this != &s) {
+            _release();
+            MAX_LEVEL = s.MAX_LEVEL;
+            PROB = s.PROB;
+            _shift = s._shift;
+            _copy(s);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief move assignment for the skip_list class
+     * @param s the list we want to move, it is left empty
+     * @return skip_list&
+     */
+    inline skip_list& operator=(skip_list&& s) noexcept {
+        if (this != &s) {
+            _release();
+            MAX_LEVEL = s.MAX_LEVEL;
+            PROB = s.PROB;
+            _shift = s._shift;
+            _steal(s);
+        }
         return *this;
     }
 
     /**
      * @brief Destroy the skip list object
      */
-    inline ~skip_list() noexcept {}
+    inline ~skip_list() noexcept { _release(); }
 
     /**
-     *@brief insert function.
-     *@param key: key to be inserted.
+     *@brief size function.
+     *@returns size_t the number of keys in the list.
      */
-    inline void insert(T key) {
-        std::shared_ptr<node> head = root;
-        std::vector<std::shared_ptr<node>> update(MAX_LEVEL + 1, nullptr);
+    inline size_t size() const { return _size; }
 
-        for (int i = level; i >= 0; i--) {
-            while (head->next[i] != nullptr && head->next[i]->key < key) {
-                head = head->next[i];
-            }
-            update[i] = head;
+    /**
+     *@brief resource function.
+     *@returns std::pmr::memory_resource* the resource the slabs come from.
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+    /**
+     *@brief memory_usage function.
+     *@returns MEMORY::footprint: the keys, the levels and towers of the nodes, the list with
+     *its slab table, and the room of the slabs no node uses(the free lists among it).
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        size_t live = 0;
+        for (node* x = _head[0]; x; x = x->next()[0]) {
+            live += (_bytes(x->top) + alignof(node) - 1) / alignof(node) * alignof(node);
+            f.payload += sizeof(T) + MEMORY::heap_bytes(x->key);
         }
+        // the slabs double from 1024 bytes up to 1 MiB, as _allocate makes them
+        size_t slabs = 0;
+        for (size_t i = 0, s = 0; i < _slabs.size(); i++) {
+            s = i + 1 == _slabs.size() ? _slab_size
+                                       : std::min<size_t>(std::max<size_t>(2 * s, 1024), 1 << 20);
+            slabs += s;
+        }
+        f.node_overhead = live - _size * sizeof(T);
+        f.slack = slabs - std::min(slabs, live);
+        f.control = sizeof(*this) + MEMORY::memory_usage(_slabs).total() - sizeof(_slabs) +
+                    _slabs.size() * MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
 
-        head = head->next[0];
-        if (!head || head->key != key) {
-            int lvl = rand_lvl();
-            if (lvl > level) {
-                for (int i = level + 1; i < lvl + 1; i++) {
-                    update[i] = root;
-                }
-                level = lvl;
-            }
+    /**
+     *@brief empty function.
+     *@returns true if the list has no keys.
+     */
+    inline bool empty() const { return _size == 0; }
 
-            std::shared_ptr<node> nn = std::make_shared<node>(key, lvl);
-            for (int i = 0; i <= lvl; i++) {
-                nn->next[i] = update[i]->next[i];
-                update[i]->next[i] = nn;
-            }
+    /**
+     *@brief insert function.
+     *@param key: key to be inserted.
+     */
+    inline void insert(T key) {
+        node** update[LEVEL_CAP];
+        node** x = _find(key, update);
+        if (x[0] && !(key < x[0]->key)) {
+            return;
         }
+        _link(std::move(key), update);
     }
 
     class Iterator;
@@ -113,7 +205,7 @@ template <typename T> class skip_list {
      *
      * @return Iterator
      */
-    inline Iterator begin() { return Iterator(root->next[0]); }
+    inline Iterator begin() { return Iterator(_head[0]); }
 
     /**
      * @brief pointer that points to the last element of the list
@@ -123,31 +215,125 @@ template <typename T> class skip_list {
     inline Iterator end() { return Iterator(nullptr); }
 
     /**
-     *@brief remove function.
-     *@param key: key to be removed(if exist).
+     *@brief lower_bound function.
+     *@param key: the key to look for.
+     *@returns Iterator to the first key >= key, end() if there is none.
      */
-    inline void remove(T key) {
-        std::shared_ptr<node> x = root;
-        std::vector<std::shared_ptr<node>> update(MAX_LEVEL + 1, nullptr);
+    inline Iterator lower_bound(const T& key) {
+        node** update[LEVEL_CAP];
+        return Iterator(_find(key, update)[0]);
+    }
 
-        for (int64_t i = level; i >= 0; i--) {
-            while (x->next[i] && x->next[i]->key < key) {
-                x = x->next[i];
+    /**
+     *@brief save_archive function.
+     *Writes the keys in order as a sorted_keys archive, which sorted_archive queries in place
+     *and load_archive turns back into a list.
+     *@param path: the output file, overwritten.
+     *Throws std::runtime_error if the file can not be written.
+     */
+    inline void save_archive(const std::string& path) const {
+        std::vector<T> keys;
+        keys.reserve(_size);
+        for (node* x = _head[0]; x; x = x->next()[0]) {
+            keys.push_back(x->key);
+        }
+        save_sorted_archive(keys, path);
+    }
+
+    /**
+     *@brief load_archive function.
+     *Links the keys of an archive in order in O(n), every tower gets a fresh level.
+     *@param path: a file written by save_archive.
+     *@param MAX_LEVEL: max height of the list, smaller than LEVEL_CAP.
+     *@param PROB: probability of increasing the height each time.
+     *@param resource: the memory resource the slabs come from. Default =
+     *std::pmr::get_default_resource()
+     *@returns skip_list the list.
+     *Throws std::runtime_error like archive_view, std::invalid_argument if the keys are not
+     *strictly increasing.
+     */
+    static skip_list load_archive(const std::string& path, int MAX_LEVEL, float PROB,
+                                std::pmr::memory_resource* resource =
+                                    std::pmr::get_default_resource()) {
+        skip_list s(MAX_LEVEL, PROB, resource);
+        sorted_archive<T> archive(path);
+        node** last[LEVEL_CAP];
+        std::fill(last, last + LEVEL_CAP, static_cast<node**>(s._head));
+        for (size_t i = 0; i < archive.size(); i++) {
+            T key(archive[i]);
+            if (i > 0 && !(archive[i - 1] < archive[i])) {
+                throw std::invalid_argument("skip_list::load_archive: keys are not sorted");
             }
-            update[i] = x;
+            int lvl = s.rand_lvl();
+            node* nn = s._make(std::move(key), lvl);
+            for (int j = 0; j <= lvl; j++) {
+                nn->next()[j] = nullptr;
+                last[j][j] = nn;
+                last[j] = nn->next();
+            }
+            s.level = std::max(s.level, lvl);
+            s._size++;
         }
+        return s;
+    }
 
-        x = x->next[0];
-        if (x && x->key == key) {
-            for (int64_t i = 0; i <= level; i++) {
-                if (update[i]->next[i] != x) {
-                    break;
-                }
-                update[i]->next[i] = x->next[i];
+    class range_view;
+
+    /**
+     *@brief range function.
+     *Seeks lo once and then walks level 0 until the keys pass hi.
+     *@param lo: the smallest key of the range.
+     *@param hi: the largest key of the range.
+     *@returns range_view over the keys of [lo, hi] in order, for range-based for loops.
+     */
+    inline range_view range(const T& lo, const T& hi) {
+        return range_view(lower_bound(lo).ptr, hi);
+    }
+
+    /**
+     *@brief insert_sorted_batch function.
+     *Inserts the keys in order with a finger search from the previous insertion: the
+     *search climbs from the predecessors of the previous key only as high as it needs
+     *and comes back down, so a sorted batch of k keys costs O(k log(n/k)). A key smaller
+     *than the one before it is searched from the head, so a mostly sorted batch works too.
+     *@param keys: the keys to insert.
+     *@returns size_t the number of keys that were not in the list.
+     */
+    inline size_t insert_sorted_batch(const std::vector<T>& keys) {
+        node** update[LEVEL_CAP];
+        size_t inserted = 0;
+        for (size_t k = 0; k < keys.size(); k++) {
+            const T& key = keys[k];
+            if (k == 0 || key < keys[k - 1]) {
+                _find(key, update);
+            } else {
+                _finger(key, update);
             }
-            while (level > 0 && root->next[level] == nullptr) {
+            if (update[0][0] && !(key < update[0][0]->key)) {
+                continue;
+            }
+            _link(key, update);
+            inserted++;
+        }
+        return inserted;
+    }
+
+    /**
+     *@brief remove function.
+     *@param key: key to be removed(if exist).
+     */
+    inline void remove(T key) {
+        node** update[LEVEL_CAP];
+        node* x = _find(key, update)[0];
+        if (x && !(key < x->key)) {
+            for (int i = 0; i <= x->top; i++) {
+                update[i][i] = x->next()[i];
+            }
+            while (level > 0 && _head[level] == nullptr) {
                 level--;
             }
+            _destroy(x);
+            _size--;
         }
     }
 
@@ -157,17 +343,13 @@ template <typename T> class skip_list {
      *@returns true if the key exists in the list.
      */
     inline bool search(T key) {
-        std::shared_ptr<node> x = root;
+        node* const* x = _head;
         for (int64_t i = level; i >= 0; i--) {
-            while (x->next[i] && x->next[i]->key < key) {
-                x = x->next[i];
+            while (x[i] && x[i]->key < key) {
+                x = x[i]->next();
             }
         }
-        x = x->next[0];
-        if (x && x->key == key) {
-            return true;
-        }
-        return false;
+        return x[0] && !(key < x[0]->key);
     }
 
     /**
@@ -186,14 +368,11 @@ template <typename T> class skip_list {
      *@brief operator << for skip_list<T> class.
      */
     inline friend std::ostream& operator<<(std::ostream& out, skip_list<T>& l) {
-        std::shared_ptr<node> root = l.root;
         out << "{";
         for (int i = 0; i <= l.level; i++) {
             out << i << ": ";
-            std::shared_ptr<node> curr = l.root->next[i];
-            while (curr != nullptr) {
+            for (node* curr = l._head[i]; curr != nullptr; curr = curr->next()[i]) {
                 out << curr->key << " ";
-                curr = curr->next[i];
             }
             out << '\n';
         }
@@ -204,34 +383,211 @@ template <typename T> class skip_list {
   private:
     int MAX_LEVEL{};
     float PROB{};
+    // PROB = 1/2^_shift, 0 if PROB is not a power of two
+    int _shift{0};
+    uint64_t _rng;
 
     /**
      * @brief struct for the node
      * @param key: the value of the node
-     * @param next: vector of pointers to the next
+     * @param top: the highest level of the node, the tower of top + 1 pointers to the next
+     * nodes is allocated right after it.
      */
-    struct node {
+    struct alignas(void*) node {
         T key;
-        std::vector<std::shared_ptr<node>> next;
-        node(T key, int level, void* value = nullptr) : key(key) {
-            for (int i = 0; i < level + 1; i++) {
-                next.push_back(nullptr);
-            }
-        }
+        int top;
+        node(T key, int top) : key(std::move(key)), top(top) {}
+        node** next() { return std::launder(reinterpret_cast<node**>(this + 1)); }
     };
 
+    static_assert(alignof(node) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "the arena of skip_list does not support over-aligned keys");
+
+    static size_t _bytes(int top) { return sizeof(node) + size_t(top + 1) * sizeof(node*); }
+
     int rand_lvl() {
-        float r = (float)rand() / RAND_MAX;
+        _rng ^= _rng << 13;
+        _rng ^= _rng >> 7;
+        _rng ^= _rng << 17;
+        if (_shift) {
+            return std::min(std::countr_zero(_rng) / _shift, MAX_LEVEL);
+        }
         int lvl = 0;
-        while (r < PROB && lvl < MAX_LEVEL) {
+        while (lvl < MAX_LEVEL && double(_rng >> 11) * 0x1.0p-53 < PROB) {
             lvl++;
-            r = (float)rand() / RAND_MAX;
+            _rng ^= _rng << 13;
+            _rng ^= _rng >> 7;
+            _rng ^= _rng << 17;
         }
         return lvl;
     }
 
     int level{0};
-    std::shared_ptr<node> root;
+    size_t _size{0};
+    // the tower of the head, _head[i] is the first node of level i
+    node* _head[LEVEL_CAP];
+
+    // a slab goes back to the resource it came from
+    struct _release_slab {
+        std::pmr::memory_resource* resource;
+        size_t size;
+        void operator()(std::byte* p) const noexcept {
+            resource->deallocate(p, size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        }
+    };
+
+    std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
+    // slabs of raw memory, the nodes are bumped out of the last one
+    std::pmr::vector<std::unique_ptr<std::byte[], _release_slab>> _slabs{_resource};
+    size_t _used{0}, _slab_size{0};
+    // the memory of the removed nodes by height, linked through their first bytes
+    void* _free[LEVEL_CAP]{};
+
+    // fills update[i] with the tower that points to the first key >= key on level i and
+    // returns update[0]
+    node** _find(const T& key, node*** update) {
+        node** x = _head;
+        for (int64_t i = level; i >= 0; i--) {
+            while (x[i] && x[i]->key < key) {
+                x = x[i]->next();
+            }
+            update[i] = x;
+        }
+        return x;
+    }
+
+    // links a new node with key after the towers of update
+    void _link(T key, node*** update) {
+        int lvl = rand_lvl();
+        if (lvl > level) {
+            for (int i = level + 1; i <= lvl; i++) {
+                update[i] = _head;
+            }
+            level = lvl;
+        }
+        node* nn = _make(std::move(key), lvl);
+        for (int i = 0; i <= lvl; i++) {
+            nn->next()[i] = update[i][i];
+            update[i][i] = nn;
+        }
+        _size++;
+    }
+
+    // the node of a tower, for towers other than _head
+    static node* _owner(node** x) { return reinterpret_cast<node*>(x) - 1; }
+
+    // moves update, filled for a key <= key, to key: climbs while the successor on the
+    // level is still smaller than key and walks down again from the furthest tower
+    void _finger(const T& key, node*** update) {
+        int i = 0;
+        while (i < level && update[i][i] && update[i][i]->key < key) {
+            i++;
+        }
+        node** x = update[i];
+        for (int j = i; j >= 0; j--) {
+            if (update[j] != _head && (x == _head || _owner(x)->key < _owner(update[j])->key)) {
+                x = update[j];
+            }
+            while (x[j] && x[j]->key < key) {
+                x = x[j]->next();
+            }
+            update[j] = x;
+        }
+    }
+
+    void* _allocate(int top) {
+        if (_free[top] != nullptr) {
+            void* p = _free[top];
+            _free[top] = *static_cast<void**>(p);
+            return p;
+        }
+        size_t bytes = _bytes(top);
+        if (_slabs.empty() || _used + bytes > _slab_size) {
+            _slab_size = std::min<size_t>(std::max<size_t>(2 * _slab_size, 1024), 1 << 20);
+            _slab_size = std::max(_slab_size, bytes);
+            // aligned like operator new, see the static_assert on node
+            auto* slab = static_cast<std::byte*>(
+                _resource->allocate(_slab_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__));
+            try {
+                _slabs.emplace_back(slab, _release_slab{_resource, _slab_size});
+            } catch (...) {
+                _resource->deallocate(slab, _slab_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+                throw;
+            }
+            _used = 0;
+        }
+        void* p = _slabs.back().get() + _used;
+        _used += (bytes + alignof(node) - 1) / alignof(node) * alignof(node);
+        return p;
+    }
+
+    node* _make(T key, int top) {
+        void* p = _allocate(top);
+        try {
+            return ::new (p) node(std::move(key), top);
+        } catch (...) {
+            _recycle(p, top);
+            throw;
+        }
+    }
+
+    void _destroy(node* x) {
+        int top = x->top;
+        x->~node();
+        _recycle(x, top);
+    }
+
+    void _recycle(void* p, int top) noexcept {
+        *static_cast<void**>(p) = _free[top];
+        _free[top] = p;
+    }
+
+    void _copy(const skip_list& s) {
+        node** last[LEVEL_CAP];
+        for (int i = 0; i < LEVEL_CAP; i++) {
+            last[i] = _head;
+        }
+        for (node* x = s._head[0]; x; x = x->next()[0]) {
+            node* nn = _make(x->key, x->top);
+            for (int i = 0; i <= x->top; i++) {
+                nn->next()[i] = nullptr;
+                last[i][i] = nn;
+                last[i] = nn->next();
+            }
+        }
+        level = s.level;
+        _size = s._size;
+    }
+
+    void _steal(skip_list& s) noexcept {
+        std::copy(s._head, s._head + LEVEL_CAP, _head);
+        std::fill(s._head, s._head + LEVEL_CAP, nullptr);
+        level = std::exchange(s.level, 0);
+        _size = std::exchange(s._size, 0);
+        _resource = s._resource;
+        _slabs = std::move(s._slabs);
+        s._slabs.clear();
+        _used = std::exchange(s._used, 0);
+        _slab_size = std::exchange(s._slab_size, 0);
+        std::copy(s._free, s._free + LEVEL_CAP, _free);
+        std::fill(s._free, s._free + LEVEL_CAP, nullptr);
+    }
+
+    void _release() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (node* x = _head[0]; x;) {
+                node* next = x->next()[0];
+                x->~node();
+                x = next;
+            }
+        }
+        std::fill(_head, _head + LEVEL_CAP, nullptr);
+        level = 0;
+        _size = 0;
+        _slabs.clear();
+        _used = _slab_size = 0;
+        std::fill(_free, _free + LEVEL_CAP, nullptr);
+    }
 
     std::string generate_node(std::string node_val, int levs) {
         std::string gen;
@@ -271,13 +627,12 @@ template <typename T> class skip_list {
         gen += "node [shape=record;]";
         gen += '\n';
         std::unordered_set<std::string> S;
-        int m_level = std::min(level, (int)root->next.size()); // See if this is a parameter
+        int m_level = level;
         gen += generate_node("root", m_level + 1);
         gen += generate_node("NULL", m_level + 1);
         gen += generate_edge("root", "NULL", m_level + 1);
         for (int i = m_level; i >= 0; i--) {
-            std::shared_ptr<node> head = root;
-            head = head->next[i];
+            node* head = _head[i];
             std::string prev_val = "root";
             std::string head_key;
             while (head) {
@@ -292,7 +647,7 @@ template <typename T> class skip_list {
                 }
                 gen += generate_edge(prev_val, head_key, i);
                 prev_val = head_key;
-                head = head->next[i];
+                head = head->next()[i];
             }
             gen += generate_edge(prev_val, "NULL", i);
         }
@@ -305,14 +660,16 @@ template <typename T> class skip_list {
  */
 template <typename T> class skip_list<T>::Iterator {
   private:
-    std::shared_ptr<node> ptr;
+    node* ptr;
+
+    friend class skip_list;
 
   public:
     /**
      * @brief Construct a new Iterator object
      * @param ptr: pointer to the node
      */
-    explicit Iterator(std::shared_ptr<node> ptr) noexcept : ptr(ptr) {}
+    explicit Iterator(node* ptr) noexcept : ptr(ptr) {}
 
     /**
      * @brief = operator for Iterator type*
@@ -320,7 +677,7 @@ template <typename T> class skip_list<T>::Iterator {
      * @param current  pointer to the node
      * @return Iterator&
      */
-    Iterator& operator=(std::shared_ptr<node> current) {
+    Iterator& operator=(node* current) {
         this->ptr = current;
         return *(this);
     }
@@ -332,7 +689,7 @@ template <typename T> class skip_list<T>::Iterator {
      */
     Iterator& operator++() {
         if (ptr != nullptr) {
-            ptr = ptr->next[0];
+            ptr = ptr->next()[0];
         }
         return *(this);
     }
@@ -364,4 +721,74 @@ template <typename T> class skip_list<T>::Iterator {
     T operator*() { return ptr->key; }
 };
 
+/**
+ * @brief range view class
+ * The keys of [lo, hi] of a skip list, its iterator stops at the first key > hi.
+ */
+template <typename T> class skip_list<T>::range_view {
+  private:
+    node* first;
+    T hi;
+
+    friend class skip_list;
+
+    range_view(node* first, const T& hi) : first(first), hi(hi) {}
+
+  public:
+    class iterator {
+      private:
+        node* ptr;
+        const T* hi;
+
+      public:
+        /**
+         * @brief Construct a new iterator object
+         * @param ptr: pointer to the node, nullptr for the end.
+         * @param hi: the largest key of the range.
+         */
+        iterator(node* ptr, const T* hi) noexcept
+            : ptr(ptr && *hi < ptr->key ? nullptr : ptr), hi(hi) {}
+
+        /**
+         * @brief operator ++
+         *
+         * @return iterator&
+         */
+        iterator& operator++() {
+            ptr = ptr->next()[0];
+            if (ptr && *hi < ptr->key) {
+                ptr = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief operator != for type iterator
+         *
+         * @param it the other iterator
+         * @return bool
+         */
+        bool operator!=(const iterator& it) const { return ptr != it.ptr; }
+
+        /**
+         * @brief operator * for type iterator
+         *
+         * @return const T& the key
+         */
+        const T& operator*() const { return ptr->key; }
+    };
+
+    /**
+     * @brief begin function
+     * @return iterator to the first key of the range.
+     */
+    iterator begin() const { return iterator(first, &hi); }
+
+    /**
+     * @brief end function
+     * @return iterator past the last key of the range.
+     */
+    iterator end() const { return iterator(nullptr, &hi); }
+};
+
 #endif
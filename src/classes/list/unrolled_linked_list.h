@@ -0,0 +1,407 @@
+#ifndef UNROLLED_LINKED_LIST_H
+#define UNROLLED_LINKED_LIST_H
+
+#include "../../helpers/node_pool.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief default chunk capacity of unrolled_linked_list
+ * As many values as fit in four cache lines next to the count and the next pointer, and
+ * at least 4.
+ */
+template <typename T>
+inline constexpr size_t unrolled_chunk_capacity =
+    std::max<size_t>(4, (4 * 64 - 2 * sizeof(void*)) / sizeof(T));
+
+/**
+ * @brief unrolled linked list class
+ * Single linked list that keeps up to K values per node(a chunk). The chunks are aligned
+ * to cache lines and come from a node_pool, so a scan reads K values in a row before it
+ * follows a pointer and the list costs about one pointer per K values. Same interface
+ * and semantics as linked_list: push_back is O(1), push_front is O(K) since it moves the
+ * values of the first chunk, and erase removes the first occurrence of a key
+ * and merges a chunk with the next one when both fit in one chunk, so every chunk but
+ * the last ones of a run of erases stays at least half full.
+ * @tparam T the type of the values, it must be default constructible.
+ * @tparam K the number of values per chunk. Default = unrolled_chunk_capacity<T>
+ */
+template <typename T, size_t K = unrolled_chunk_capacity<T>> class unrolled_linked_list {
+    static_assert(K > 0, "unrolled_linked_list needs room for at least one value per chunk");
+
+  public:
+    /**
+     *@brief unrolled_linked_list class constructor
+     *@param _elements: you can provide the constructor with a vector of elements
+     *so you dont have to do multiple push backs yourself.
+     */
+    inline explicit unrolled_linked_list(std::vector<T> _elements = {})
+        : root(nullptr), tail(nullptr) {
+        _pool.reserve((_elements.size() + K - 1) / K);
+        for (T& x : _elements) {
+            this->push_back(std::move(x));
+        }
+    }
+
+    /**
+     * @brief copy constructor for the unrolled_linked_list class
+     * @param l the list we want to copy
+     */
+    inline explicit unrolled_linked_list(const unrolled_linked_list& l)
+        : root(nullptr), tail(nullptr) {
+        _copy(l);
+    }
+
+    /**
+     * @brief move constructor for the unrolled_linked_list class
+     * @param l the list we want to move, it is left empty
+     */
+    inline unrolled_linked_list(unrolled_linked_list&& l) noexcept
+        : _pool(std::move(l._pool)), root(std::exchange(l.root, nullptr)),
+          tail(std::exchange(l.tail, nullptr)), _size(std::exchange(l._size, 0)) {}
+
+    /**
+     * @brief operator = for unrolled linked list class
+     * @param l the list we want to copy
+     * @return unrolled_linked_list&
+     */
+    inline unrolled_linked_list& operator=(const unrolled_linked_list& l) {
+        if (this != &l) {
+            _release();
+            _copy(l);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief move assignment for unrolled linked list class
+     * @param l the list we want to move, it is left empty
+     * @return unrolled_linked_list&
+     */
+    inline unrolled_linked_list& operator=(unrolled_linked_list&& l) noexcept {
+        if (this != &l) {
+            _release();
+            _pool = std::move(l._pool);
+            root = std::exchange(l.root, nullptr);
+            tail = std::exchange(l.tail, nullptr);
+            _size = std::exchange(l._size, 0);
+        }
+        return *this;
+    }
+
+    inline ~unrolled_linked_list() { _release(); }
+
+    /**
+     *@brief empty function.
+     *Returns true if the list is empty.
+     */
+    inline bool empty() const { return _size == 0; }
+
+    /**
+     *@brief size function.
+     *Returns the size of the list.
+     */
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief memory_usage function
+     * @returns MEMORY::footprint: the elements, the counts, links and padding of the chunks,
+     * the list and the slab table of its pool, and the empty places of the chunks and the free
+     * slots of the pool.
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = _pool.memory_usage(0);
+        const size_t unused = (_pool.size() * K - _size) * sizeof(T);
+        f.node_overhead -= _size * sizeof(T) + unused;
+        f.payload = _size * sizeof(T);
+        f.slack += unused;
+        if constexpr (MEMORY::may_own_heap_v<T>) {
+            for (const chunk* c = root; c != nullptr; c = c->next) {
+                f.payload +=
+                    MEMORY::payload(c->values, c->values + c->count) - c->count * sizeof(T);
+            }
+        }
+        f.control += sizeof(*this);
+        return f;
+    }
+
+    /**
+     *@brief chunks function.
+     *Returns the number of chunks of the list.
+     */
+    inline size_t chunks() const { return _pool.size(); }
+
+    class Iterator;
+
+    /**
+     * @brief pointer that points to begin
+     *
+     * @return Iterator
+     */
+    inline Iterator begin() const { return Iterator(root, 0); }
+
+    /**
+     * @brief pointer that points to end
+     *
+     * @return Iterator
+     */
+    inline Iterator end() const { return Iterator(nullptr, 0); }
+
+    /**
+     *@brief push_back function.
+     *@param key: the key to be pushed back.
+     */
+    void push_back(T key);
+
+    /**
+     *@brief push_front function.
+     *@param key: the key to be pushed in front.
+     */
+    void push_front(T key);
+
+    /**
+     *@brief erase function.
+     *@param key: the key to be erased, only its first occurrence is removed.
+     */
+    void erase(const T& key);
+
+    /**
+     *@brief search function.
+     *@param key: the key to be searched.
+     *@returns true if key exists in the list.
+     */
+    bool search(const T& key) const;
+
+    /**
+     *@brief elements function.
+     *@returns vector<T>: the elements of the list.
+     */
+    std::vector<T> elements() const;
+
+    /**
+     *@brief reverse function.
+     */
+    void reverse();
+
+    /**
+     *@brief << operator for the unrolled_linked_list class.
+     */
+    inline friend std::ostream& operator<<(std::ostream& out, const unrolled_linked_list& l1) {
+        out << '{';
+        for (const T& x : l1) {
+            out << x << ' ';
+        }
+        out << '}' << '\n';
+        return out;
+    }
+
+  private:
+    /**
+     * @brief struct for the chunk
+     * @param count: the number of values in the chunk, they are values[0, count).
+     * @param next: pointer to the next chunk.
+     * @param values: the values.
+     */
+    struct alignas(64) chunk {
+        size_t count{0};
+        chunk* next{nullptr};
+        T values[K];
+    };
+    node_pool<chunk> _pool;
+    chunk* root;
+    chunk* tail;
+    size_t _size{0};
+
+    void _copy(const unrolled_linked_list& l) {
+        _pool.reserve(l._pool.size());
+        for (chunk* c = l.root; c; c = c->next) {
+            chunk* nc = _pool.create(*c);
+            nc->next = nullptr;
+            (tail ? tail->next : root) = nc;
+            tail = nc;
+        }
+        _size = l._size;
+    }
+
+    void _release() {
+        _pool.clear(root, [](chunk* c, auto visit) { visit(c->next); });
+        root = tail = nullptr;
+        _size = 0;
+    }
+};
+
+template <typename T, size_t K> inline void unrolled_linked_list<T, K>::push_back(T key) {
+    if (tail == nullptr || tail->count == K) {
+        chunk* c = _pool.create();
+        (tail ? tail->next : root) = c;
+        tail = c;
+    }
+    tail->values[tail->count++] = std::move(key);
+    _size++;
+}
+
+template <typename T, size_t K> inline void unrolled_linked_list<T, K>::push_front(T key) {
+    if (root == nullptr || root->count == K) {
+        chunk* c = _pool.create();
+        c->next = root;
+        root = c;
+        if (tail == nullptr) {
+            tail = c;
+        }
+    }
+    std::move_backward(root->values, root->values + root->count,
+                       root->values + root->count + 1);
+    root->values[0] = std::move(key);
+    root->count++;
+    _size++;
+}
+
+template <typename T, size_t K> inline void unrolled_linked_list<T, K>::erase(const T& key) {
+    chunk* prev = nullptr;
+    for (chunk* c = root; c; prev = c, c = c->next) {
+        T* it = std::find(c->values, c->values + c->count, key);
+        if (it == c->values + c->count) {
+            continue;
+        }
+        std::move(it + 1, c->values + c->count, it);
+        c->count--;
+        _size--;
+        if (c->count == 0) {
+            (prev ? prev->next : root) = c->next;
+            if (c == tail) {
+                tail = prev;
+            }
+            _pool.destroy(c);
+            return;
+        }
+        chunk* n = c->next;
+        if (n && c->count + n->count <= K) {
+            std::move(n->values, n->values + n->count, c->values + c->count);
+            c->count += n->count;
+            c->next = n->next;
+            if (n == tail) {
+                tail = c;
+            }
+            _pool.destroy(n);
+        }
+        return;
+    }
+}
+
+template <typename T, size_t K>
+inline bool unrolled_linked_list<T, K>::search(const T& key) const {
+    for (chunk* c = root; c; c = c->next) {
+        if (std::find(c->values, c->values + c->count, key) != c->values + c->count) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, size_t K>
+inline std::vector<T> unrolled_linked_list<T, K>::elements() const {
+    std::vector<T> _elements;
+    _elements.reserve(_size);
+    for (chunk* c = root; c; c = c->next) {
+        _elements.insert(_elements.end(), c->values, c->values + c->count);
+    }
+    return _elements;
+}
+
+template <typename T, size_t K> inline void unrolled_linked_list<T, K>::reverse() {
+    chunk* current = root;
+    chunk *prev{nullptr}, *next{nullptr};
+    tail = root;
+
+    while (current != nullptr) {
+        std::reverse(current->values, current->values + current->count);
+        next = current->next;
+        current->next = prev;
+        prev = current;
+        current = next;
+    }
+    root = prev;
+}
+
+/**
+ * @brief Iterator class
+ */
+template <typename T, size_t K> class unrolled_linked_list<T, K>::Iterator {
+  private:
+    const chunk* curr_root;
+    size_t index;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    /**
+     * @brief Construct a new Iterator object
+     *
+     * @param c the chunk
+     * @param i the index in the chunk
+     */
+    explicit Iterator(const chunk* c = nullptr, size_t i = 0) noexcept
+        : curr_root(c), index(i) {}
+
+    /**
+     * @brief operator ++ for type Iterator
+     *
+     * @return Iterator&
+     */
+    Iterator& operator++() {
+        if (curr_root && ++index == curr_root->count) {
+            curr_root = curr_root->next;
+            index = 0;
+        }
+        return *(this);
+    }
+
+    /**
+     * @brief operator ++ for type Iterator
+     *
+     * @return Iterator
+     */
+    Iterator operator++(int) {
+        Iterator it = *this;
+        ++*(this);
+        return it;
+    }
+
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both point to the same value
+     */
+    bool operator==(const Iterator& it) const {
+        return curr_root == it.curr_root && index == it.index;
+    }
+
+    /**
+     * @brief operator != for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if they point to different values
+     */
+    bool operator!=(const Iterator& it) const { return !(*this == it); }
+
+    /**
+     * @brief operator * for type Iterator
+     *
+     * @return const T& the value
+     */
+    const T& operator*() const { return curr_root->values[index]; }
+};
+
+#endif
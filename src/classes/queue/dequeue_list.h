@@ -1,45 +1,59 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include "../../helpers/memory_usage.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
 /**
- * @brief dequeue list class
+ * @brief default block capacity of dequeue_list
+ * The largest power of two of values that fits in 4KB, and at least 16.
  */
-template <typename T> class dequeue_list {
-  private:
-    /**
-     * @brief struct for the node
-     * @param val: the value of the node
-     * @param next: pointer to the next node
-     * @param prev: pointer to the previous node
-     */
-    struct node {
-        T val;
-        std::shared_ptr<node> next;
-        std::shared_ptr<node> prev;
-        node(T key) : val(key), next(nullptr), prev(nullptr) {}
-    };
+template <typename T>
+inline constexpr size_t dequeue_block_capacity =
+    std::bit_floor(std::max<size_t>(16, 4096 / sizeof(T)));
 
-    std::shared_ptr<node> root;
-    std::shared_ptr<node> tail;
-    size_t _size{0};
+/**
+ * @brief dequeue list class
+ * The values are kept in blocks of B, and a circular map of pointers to the blocks is
+ * in the order of the values, so pushing or popping at either end is O(1)(the map doubles
+ * when it is full, which is amortized O(1)), and the i-th value is found in O(1) from the
+ * offset of the first value in the first block. The blocks that pops empty are kept for the
+ * next pushes instead of being freed, so a dequeue that stays around one size allocates
+ * nothing after it has reached it. Pushing or popping invalidates the iterators, but not
+ * the references to the other values. The blocks, the map and the list of the spare blocks
+ * come from a std::pmr::memory_resource.
+ * @tparam T the type of the values.
+ * @tparam B the number of values per block, a power of two. Default = dequeue_block_capacity
+ */
+template <typename T, size_t B = dequeue_block_capacity<T>> class dequeue_list {
+    static_assert(std::has_single_bit(B), "the block capacity must be a power of two");
 
   public:
     /**
      * @brief Construct a new dequeue list object
      *
      * @param v initializer vector
+     * @param resource the memory resource of the blocks and the map. Default =
+     * std::pmr::get_default_resource()
      */
-    inline explicit dequeue_list(std::vector<T> v = {}) noexcept : root(nullptr), tail(nullptr) {
-        if (!v.empty()) {
-            for (T& x : v) {
-                this->push_back(x);
-            }
+    inline explicit dequeue_list(std::vector<T> v = {},
+                                 std::pmr::memory_resource* resource =
+                                     std::pmr::get_default_resource())
+        : _resource(resource) {
+        for (T& x : v) {
+            this->push_back(std::move(x));
         }
     }
 
@@ -48,8 +62,18 @@ template <typename T> class dequeue_list {
      *
      * @param q the dequeue we want to copy
      */
-    inline explicit dequeue_list(const dequeue_list& q)
-        : root(q.root), tail(q.tail), _size(q._size) {}
+    inline explicit dequeue_list(const dequeue_list& q) {
+        for (const T& x : q) {
+            this->push_back(x);
+        }
+    }
+
+    /**
+     * @brief Move constructor for dequeue list class
+     *
+     * @param q the dequeue we want to move, it is left empty
+     */
+    inline dequeue_list(dequeue_list&& q) noexcept : _resource(q._resource) { _swap(q); }
 
     /**
      * @brief operator = for dequeue list class
@@ -57,27 +81,99 @@ template <typename T> class dequeue_list {
      * @return dequeue_list&
      */
     inline dequeue_list& operator=(const dequeue_list& q) {
-        root = q.root;
-        tail = q.tail;
-        _size = q._size;
+        if (this != &q) {
+            clear();
+            for (const T& x : q) {
+                this->push_back(x);
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief move assignment for dequeue list class
+     * @param q the dequeue we want to move, it is left empty
+     * @return dequeue_list&
+     */
+    inline dequeue_list& operator=(dequeue_list&& q) noexcept {
+        if (this != &q) {
+            dequeue_list tmp(std::move(q));
+            _swap(tmp);
+        }
         return *this;
     }
 
+    inline ~dequeue_list() {
+        clear();
+        shrink_to_fit();
+        if (_map != nullptr) {
+            _alloc_map().deallocate(_map, _map_cap);
+        }
+    }
+
     /**
      * @brief clear function
+     * The blocks are kept for the next pushes.
      */
     inline void clear() {
-        root = nullptr;
-        tail = nullptr;
-        _size = 0;
+        while (_size > 0) {
+            pop_back();
+        }
+        if (_blocks > 0) {
+            _spare.push_back(_map[_first]);
+            _blocks = 0;
+        }
+        _start = 0;
+    }
+
+    /**
+     * @brief shrink_to_fit function
+     * Frees the blocks that are kept for the next pushes.
+     */
+    inline void shrink_to_fit() {
+        for (T* b : _spare) {
+            _alloc().deallocate(b, B);
+        }
+        _spare.clear();
+        _spare.shrink_to_fit();
     }
 
     /**
      * @brief size functon
      *
-     * @return size_t the size of the stack
+     * @return size_t the size of the dequeue
      */
-    inline size_t size() { return _size; }
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief resource function
+     *
+     * @return std::pmr::memory_resource* the resource the blocks and the map come from
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+    /**
+     * @brief memory_usage function
+     *
+     * @return MEMORY::footprint the values, the dequeue with its map of blocks, and the empty
+     * places of the blocks, the spare blocks included
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.payload = MEMORY::payload(begin(), end());
+        f.slack = (_blocks + _spare.size()) * B * sizeof(T) - _size * sizeof(T);
+        f.control = sizeof(*this) + _map_cap * sizeof(T*) +
+                    MEMORY::memory_usage(_spare).total() - sizeof(_spare) +
+                    (_blocks + _spare.size() + (_map_cap > 0)) * MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+    /**
+     * @brief empty function
+     *
+     * @return true if the dequeue is empty
+     */
+    inline bool empty() const { return _size == 0; }
 
     /**
      * @brief push_back function
@@ -85,18 +181,13 @@ template <typename T> class dequeue_list {
      * @param key the key to be pushed back
      */
     inline void push_back(T key) {
-        std::shared_ptr<node> nn = std::make_shared<node>(key);
-        if (!root) {
-            root = nn;
-            tail = nn;
-            _size++;
-            return;
-        } else {
-            tail->next = nn;
-            nn->prev = tail;
-            tail = nn;
-            _size++;
+        if (_start + _size == _blocks * B) {
+            _reserve_map();
+            _map[(_first + _blocks) & (_map_cap - 1)] = _block();
+            _blocks++;
         }
+        std::construct_at(&_at(_size), std::move(key));
+        _size++;
     }
 
     /**
@@ -105,52 +196,87 @@ template <typename T> class dequeue_list {
      * @param key the key to be pushed front
      */
     inline void push_front(T key) {
-        std::shared_ptr<node> nn = std::make_shared<node>(key);
-        if (!root) {
-            root = nn;
-            tail = nn;
-            _size++;
-            return;
-        } else {
-            root->prev = nn;
-            nn->next = root;
-            root = nn;
-            _size++;
+        if (_start == 0) {
+            _reserve_map();
+            _first = (_first - 1) & (_map_cap - 1);
+            _map[_first] = _block();
+            _blocks++;
+            _start = B;
         }
+        std::construct_at(&_map[_first][_start - 1], std::move(key));
+        _start--;
+        _size++;
     }
 
     /**
-     * @brief top function
+     * @brief top function, the dequeue must not be empty
      *
-     * @return T the top of the dequeue
+     * @return T& the top of the dequeue
      */
-    inline T front() { return root->val; }
+    inline T& front() { return _at(0); }
+    inline const T& front() const { return _at(0); }
 
     /**
-     * @brief back function
+     * @brief back function, the dequeue must not be empty
      *
-     * @return T the back of the dequeue
+     * @return T& the back of the dequeue
      */
-    inline T back() { return tail->val; }
+    inline T& back() { return _at(_size - 1); }
+    inline const T& back() const { return _at(_size - 1); }
 
     /**
-     * @brief pop_front function
+     * @brief operator [], O(1)
+     *
+     * @param i the index, it must be less than size()
+     * @return T& the i-th value from the front
+     */
+    inline T& operator[](size_t i) { return _at(i); }
+    inline const T& operator[](size_t i) const { return _at(i); }
+
+    /**
+     * @brief at function, O(1)
+     *
+     * @param i the index
+     * @return T& the i-th value from the front
+     * Throws std::out_of_range if i is not less than size().
+     */
+    inline T& at(size_t i) {
+        if (i >= _size) {
+            throw std::out_of_range("dequeue_list: index out of range");
+        }
+        return _at(i);
+    }
+
+    /**
+     * @brief pop_front function, the dequeue must not be empty
      * removes the front from the dequeue
      */
     inline void pop_front() {
-        root = root->next;
-        root->prev = nullptr;
+        std::destroy_at(&_at(0));
+        _start++;
         _size--;
+        if (_start == B) {
+            _spare.push_back(_map[_first]);
+            _first = (_first + 1) & (_map_cap - 1);
+            _blocks--;
+            _start = 0;
+        }
     }
 
     /**
-     * @brief pop_back function
+     * @brief pop_back function, the dequeue must not be empty
      *removes the back from the queue
      */
     inline void pop_back() {
-        tail = tail->prev;
-        tail->next = nullptr;
+        std::destroy_at(&_at(_size - 1));
         _size--;
+        if (_start + _size <= (_blocks - 1) * B) {
+            _blocks--;
+            _spare.push_back(_map[(_first + _blocks) & (_map_cap - 1)]);
+            if (_blocks == 0) {
+                _start = 0;
+            }
+        }
     }
 
     class Iterator;
@@ -160,80 +286,184 @@ template <typename T> class dequeue_list {
      *
      * @return Iterator
      */
-    inline Iterator begin() { return Iterator(root); }
+    inline Iterator begin() const { return Iterator(this, 0); }
 
     /**
      * @brief pointer to the end of the dequeue
      *
      * @return Iterator
      */
-    inline Iterator end() { return Iterator(nullptr); }
+    inline Iterator end() const { return Iterator(this, _size); }
+
+  private:
+    // _map[_first] to _map[_first + _blocks - 1](mod _map_cap) are the blocks in use, the
+    // first value is _map[_first][_start]
+    T** _map{nullptr};
+    size_t _map_cap{0};
+    size_t _first{0};
+    size_t _blocks{0};
+    size_t _start{0};
+    size_t _size{0};
+    std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
+    std::pmr::vector<T*> _spare{_resource};
+
+    std::pmr::polymorphic_allocator<T> _alloc() const { return _resource; }
+    std::pmr::polymorphic_allocator<T*> _alloc_map() const { return _resource; }
+
+    T& _at(size_t i) const {
+        size_t j = _start + i;
+        return _map[(_first + j / B) & (_map_cap - 1)][j & (B - 1)];
+    }
+
+    T* _block() {
+        if (_spare.empty()) {
+            return _alloc().allocate(B);
+        }
+        T* b = _spare.back();
+        _spare.pop_back();
+        return b;
+    }
+
+    // makes room in the map for one more block, in the order of the values
+    void _reserve_map() {
+        if (_blocks < _map_cap) {
+            return;
+        }
+        size_t cap = std::max<size_t>(8, 2 * _map_cap);
+        T** map = _alloc_map().allocate(cap);
+        for (size_t i = 0; i < _blocks; i++) {
+            map[i] = _map[(_first + i) & (_map_cap - 1)];
+        }
+        if (_map != nullptr) {
+            _alloc_map().deallocate(_map, _map_cap);
+        }
+        _map = map;
+        _map_cap = cap;
+        _first = 0;
+    }
+
+    void _swap(dequeue_list& q) noexcept {
+        std::swap(_map, q._map);
+        std::swap(_map_cap, q._map_cap);
+        std::swap(_first, q._first);
+        std::swap(_blocks, q._blocks);
+        std::swap(_start, q._start);
+        std::swap(_size, q._size);
+        // the blocks go with their resource, the tables of the spare blocks may stay where
+        // they are, std::swap moves their pointers when the resources differ
+        std::swap(_resource, q._resource);
+        std::swap(_spare, q._spare);
+    }
 };
 
 /**
  * @brief Iterator class
  */
-template <typename T> class dequeue_list<T>::Iterator {
+template <typename T, size_t B> class dequeue_list<T, B>::Iterator {
   private:
-    std::shared_ptr<node> curr_root;
+    const dequeue_list* q;
+    size_t index;
 
   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
     /**
      * @brief Construct a new Iterator object
      *
      * @param q dequeue_list pointer
+     * @param i the index of the value
      */
-    explicit Iterator(const std::shared_ptr<node>& q) noexcept : curr_root(q) {}
+    explicit Iterator(const dequeue_list* q = nullptr, size_t i = 0) noexcept
+        : q(q), index(i) {}
 
     /**
-     * @brief = operator for Iterator type
+     * @brief operator ++ for type Iterator
      *
-     * @param current smart pointer of type node
      * @return Iterator&
      */
-    Iterator& operator=(std::shared_ptr<node> current) {
-        this->curr_root = current;
+    Iterator& operator++() {
+        index++;
         return *(this);
     }
 
     /**
      * @brief operator ++ for type Iterator
      *
+     * @return Iterator
+     */
+    Iterator operator++(int) {
+        Iterator it = *this;
+        ++*(this);
+        return it;
+    }
+
+    /**
+     * @brief operator -- for type Iterator
+     *
      * @return Iterator&
      */
-    Iterator& operator++() {
-        if (curr_root) {
-            curr_root = curr_root->next;
-        }
+    Iterator& operator--() {
+        index--;
         return *(this);
     }
 
     /**
-     * @brief operator ++ for type Iterator
+     * @brief operator -- for type Iterator
      *
      * @return Iterator
      */
-    Iterator operator++(int) {
+    Iterator operator--(int) {
         Iterator it = *this;
-        ++*(this);
+        --*(this);
         return it;
     }
 
+    Iterator& operator+=(difference_type n) {
+        index += n;
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) {
+        index -= n;
+        return *this;
+    }
+
+    Iterator operator+(difference_type n) const { return Iterator(q, index + n); }
+    Iterator operator-(difference_type n) const { return Iterator(q, index - n); }
+    difference_type operator-(const Iterator& it) const {
+        return difference_type(index) - difference_type(it.index);
+    }
+
+    T& operator[](difference_type n) const { return q->_at(index + n); }
+
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both point to the same value
+     */
+    bool operator==(const Iterator& it) const { return index == it.index; }
+
     /**
      * @brief operator != for type Iterator
      *
      * @param it const Iterator
-     * @return true if curr_root == it.curr_root
-     * @return false otherwise
+     * @return true if they point to different values
      */
-    bool operator!=(const Iterator& it) { return curr_root != it.curr_root; }
+    bool operator!=(const Iterator& it) const { return index != it.index; }
+
+    bool operator<(const Iterator& it) const { return index < it.index; }
 
     /**
      * @brief operator * for type Iterator
      *
-     * @return T the value of the node
+     * @return T& the value
      */
-    T operator*() { return curr_root->val; }
+    T& operator*() const { return q->_at(index); }
 };
 
 #endif
@@ -0,0 +1,412 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#endif
+
+/**
+ * @brief single producer single consumer ring buffer class
+ * Bounded lock-free queue for exactly one thread that pushes and one that pops. The values
+ * are kept in one array whose size is a power of two, the head(read by the consumer) and
+ * the tail(written by the producer) are on their own cache lines, and each side keeps a
+ * copy of the other's index that it reloads only when the buffer looks full or empty, so
+ * a push or a pop usually touches no shared cache line but the slot. push_n and pop_n move
+ * a batch with one release of the index.
+ * @tparam T the type of the values.
+ */
+template <typename T> class spsc_ring_buffer {
+  public:
+    /**
+     * @brief Construct a new spsc ring buffer object
+     * @param capacity: the capacity, it is rounded up to a power of two.
+     * Throws std::invalid_argument if capacity is 0.
+     */
+    explicit spsc_ring_buffer(size_t capacity)
+        : _mask(_round(capacity) - 1), _slots(new _slot[_mask + 1]) {}
+
+    spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+    spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+    ~spsc_ring_buffer() {
+        size_t head = _consumer.index.load(std::memory_order_relaxed);
+        size_t tail = _producer.index.load(std::memory_order_relaxed);
+        for (; head != tail; head++) {
+            std::destroy_at(_at(head));
+        }
+    }
+
+    /**
+     * @brief try_push function, only for the producer
+     * @param key: the value.
+     * @return true if it was pushed, false if the buffer is full.
+     */
+    bool try_push(T key) { return try_emplace(std::move(key)); }
+
+    /**
+     * @brief try_emplace function, only for the producer
+     * @param args: the arguments of the constructor of T.
+     * @return true if it was pushed, false if the buffer is full.
+     */
+    template <typename... Args> bool try_emplace(Args&&... args) {
+        size_t tail = _producer.index.load(std::memory_order_relaxed);
+        if (tail - _producer.cached > _mask) {
+            _producer.cached = _consumer.index.load(std::memory_order_acquire);
+            if (tail - _producer.cached > _mask) {
+                return false;
+            }
+        }
+        ::new (_slots[tail & _mask].data) T(std::forward<Args>(args)...);
+        _producer.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief push_n function, only for the producer
+     * @param first: iterator to the first of the values, they are moved.
+     * @param n: the number of values.
+     * @return size_t the number pushed, less than n if the buffer got full.
+     */
+    template <typename It> size_t push_n(It first, size_t n) {
+        size_t tail = _producer.index.load(std::memory_order_relaxed);
+        size_t room = _mask + 1 - (tail - _producer.cached);
+        if (room < n) {
+            _producer.cached = _consumer.index.load(std::memory_order_acquire);
+            room = _mask + 1 - (tail - _producer.cached);
+        }
+        n = std::min(n, room);
+        for (size_t i = 0; i < n; i++, ++first) {
+            ::new (_slots[(tail + i) & _mask].data) T(std::move(*first));
+        }
+        _producer.index.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief try_pop function, only for the consumer
+     * @return std::optional<T> the oldest value, std::nullopt if the buffer is empty.
+     */
+    std::optional<T> try_pop() {
+        size_t head = _consumer.index.load(std::memory_order_relaxed);
+        if (head == _consumer.cached) {
+            _consumer.cached = _producer.index.load(std::memory_order_acquire);
+            if (head == _consumer.cached) {
+                return std::nullopt;
+            }
+        }
+        T* p = _at(head);
+        std::optional<T> key(std::move(*p));
+        std::destroy_at(p);
+        _consumer.index.store(head + 1, std::memory_order_release);
+        return key;
+    }
+
+    /**
+     * @brief pop_n function, only for the consumer
+     * @param out: output iterator the values are moved to, oldest first.
+     * @param n: the largest number of values.
+     * @return size_t the number popped, less than n if the buffer got empty.
+     */
+    template <typename Out> size_t pop_n(Out out, size_t n) {
+        size_t head = _consumer.index.load(std::memory_order_relaxed);
+        if (_consumer.cached - head < n) {
+            _consumer.cached = _producer.index.load(std::memory_order_acquire);
+        }
+        n = std::min(n, _consumer.cached - head);
+        for (size_t i = 0; i < n; i++) {
+            T* p = _at(head + i);
+            *out = std::move(*p);
+            ++out;
+            std::destroy_at(p);
+        }
+        _consumer.index.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of values, exact only when no thread pushes or pops.
+     */
+    size_t size() const {
+        size_t head = _consumer.index.load(std::memory_order_acquire);
+        size_t tail = _producer.index.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    /**
+     * @brief empty function
+     * @return true if the buffer is empty, exact only when no thread pushes or pops.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief capacity function
+     * @return size_t the capacity.
+     */
+    size_t capacity() const { return _mask + 1; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the values but the heap memory they own, the buffer and the
+     * header of its array, and the empty slots. Exact only when no thread pushes or pops.
+     */
+    MEMORY::footprint memory_usage() const {
+        const size_t n = size();
+        MEMORY::footprint f;
+        f.payload = n * sizeof(T);
+        f.node_overhead = n * (sizeof(_slot) - sizeof(T));
+        f.slack = (capacity() - n) * sizeof(_slot);
+        f.control = sizeof(*this) + MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+  private:
+    struct _slot {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    // index is the side's own position, cached its last view of the other side's one
+    struct alignas(64) _side {
+        std::atomic<size_t> index{0};
+        size_t cached{0};
+    };
+
+    _side _producer;
+    _side _consumer;
+    const size_t _mask;
+    std::unique_ptr<_slot[]> _slots;
+
+    static size_t _round(size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("spsc_ring_buffer: capacity must be positive");
+        }
+        return std::bit_ceil(capacity);
+    }
+
+    T* _at(size_t i) const { return std::launder(reinterpret_cast<T*>(_slots[i & _mask].data)); }
+};
+
+/**
+ * @brief multiple producer multiple consumer ring buffer class
+ * Bounded lock-free queue for any number of threads(Vyukov's algorithm). Every slot has a
+ * sequence number that tells the lap it is free or full for, so a push claims a position
+ * with one compare and swap on the tail, writes the slot and publishes it through its
+ * sequence number, and producers and consumers only meet on the slots. The head and the
+ * tail are on their own cache lines, and so is every slot when T is small enough. push_n
+ * and pop_n claim a whole run of slots with one compare and swap.
+ * @tparam T the type of the values.
+ */
+template <typename T> class mpmc_ring_buffer {
+  public:
+    /**
+     * @brief Construct a new mpmc ring buffer object
+     * @param capacity: the capacity, it is rounded up to a power of two and at least 2.
+     * Throws std::invalid_argument if capacity is 0.
+     */
+    explicit mpmc_ring_buffer(size_t capacity)
+        : _mask(_round(capacity) - 1), _slots(new _slot[_mask + 1]) {
+        for (size_t i = 0; i <= _mask; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+    mpmc_ring_buffer& operator=(const mpmc_ring_buffer&) = delete;
+
+    ~mpmc_ring_buffer() {
+        size_t head = _head.index.load(std::memory_order_relaxed);
+        size_t tail = _tail.index.load(std::memory_order_relaxed);
+        for (; head != tail; head++) {
+            std::destroy_at(_at(head));
+        }
+    }
+
+    /**
+     * @brief try_push function
+     * @param key: the value.
+     * @return true if it was pushed, false if the buffer is full.
+     */
+    bool try_push(T key) { return try_emplace(std::move(key)); }
+
+    /**
+     * @brief try_emplace function
+     * @param args: the arguments of the constructor of T.
+     * @return true if it was pushed, false if the buffer is full.
+     */
+    template <typename... Args> bool try_emplace(Args&&... args) {
+        size_t pos;
+        if (_claim(_tail.index, 0, 1, pos) == 0) {
+            return false;
+        }
+        _slot& s = _slots[pos & _mask];
+        ::new (s.data) T(std::forward<Args>(args)...);
+        s.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief push_n function
+     * @param first: iterator to the first of the values, they are moved.
+     * @param n: the number of values.
+     * @return size_t the number pushed, less than n if the buffer got full.
+     */
+    template <typename It> size_t push_n(It first, size_t n) {
+        size_t pos;
+        n = _claim(_tail.index, 0, n, pos);
+        for (size_t i = 0; i < n; i++, ++first) {
+            _slot& s = _slots[(pos + i) & _mask];
+            ::new (s.data) T(std::move(*first));
+            s.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief try_pop function
+     * @return std::optional<T> the oldest value, std::nullopt if the buffer is empty.
+     */
+    std::optional<T> try_pop() {
+        size_t pos;
+        if (_claim(_head.index, 1, 1, pos) == 0) {
+            return std::nullopt;
+        }
+        T* p = _at(pos);
+        std::optional<T> key(std::move(*p));
+        _release(pos, p);
+        return key;
+    }
+
+    /**
+     * @brief pop_n function
+     * @param out: output iterator the values are moved to, oldest first.
+     * @param n: the largest number of values.
+     * @return size_t the number popped, less than n if the buffer got empty.
+     */
+    template <typename Out> size_t pop_n(Out out, size_t n) {
+        size_t pos;
+        n = _claim(_head.index, 1, n, pos);
+        for (size_t i = 0; i < n; i++) {
+            T* p = _at(pos + i);
+            *out = std::move(*p);
+            ++out;
+            _release(pos + i, p);
+        }
+        return n;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of values, exact only when no thread pushes or pops.
+     */
+    size_t size() const {
+        size_t head = _head.index.load(std::memory_order_acquire);
+        size_t tail = _tail.index.load(std::memory_order_acquire);
+        return tail > head ? std::min(tail - head, _mask + 1) : 0;
+    }
+
+    /**
+     * @brief empty function
+     * @return true if the buffer is empty, exact only when no thread pushes or pops.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief capacity function
+     * @return size_t the capacity.
+     */
+    size_t capacity() const { return _mask + 1; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the values but the heap memory they own, the sequence and padding
+     * of the slots, the buffer and the header of its array, and the empty slots. Exact only when no
+     * thread pushes or pops.
+     */
+    MEMORY::footprint memory_usage() const {
+        const size_t n = size();
+        MEMORY::footprint f;
+        f.payload = n * sizeof(T);
+        f.node_overhead = n * (sizeof(_slot) - sizeof(T));
+        f.slack = (capacity() - n) * sizeof(_slot);
+        f.control = sizeof(*this) + MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+  private:
+    struct alignas(std::max<size_t>(64, alignof(T))) _slot {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    struct alignas(64) _index {
+        std::atomic<size_t> index{0};
+    };
+
+    _index _head;
+    _index _tail;
+    const size_t _mask;
+    std::unique_ptr<_slot[]> _slots;
+
+    static size_t _round(size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("mpmc_ring_buffer: capacity must be positive");
+        }
+        return std::max<size_t>(2, std::bit_ceil(capacity));
+    }
+
+    T* _at(size_t i) const { return std::launder(reinterpret_cast<T*>(_slots[i & _mask].data)); }
+
+    void _release(size_t pos, T* p) {
+        std::destroy_at(p);
+        _slots[pos & _mask].sequence.store(pos + _mask + 1, std::memory_order_release);
+    }
+
+    // claims up to n positions from index, the slot of the position i is ready when its
+    // sequence is i + ahead(0 free for a producer, 1 full for a consumer). Once index moves
+    // past a run of ready slots, only the claimer can change them, so checking them and
+    // then moving index with one compare and swap is enough. Returns the number claimed,
+    // the first is pos.
+    size_t _claim(std::atomic<size_t>& index, size_t ahead, size_t n, size_t& pos) {
+        if (n == 0) {
+            return 0;
+        }
+        pos = index.load(std::memory_order_relaxed);
+        while (true) {
+            size_t ready = 0;
+            while (ready < n && ready <= _mask) {
+                const _slot& s = _slots[(pos + ready) & _mask];
+                if (s.sequence.load(std::memory_order_acquire) != pos + ready + ahead) {
+                    break;
+                }
+                ready++;
+            }
+            if (ready > 0) {
+                if (index.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+                    return ready;
+                }
+                continue;
+            }
+            size_t seq = _slots[pos & _mask].sequence.load(std::memory_order_acquire);
+            if (intptr_t(seq - (pos + ahead)) < 0) {
+                // the slot is from the previous lap: full for a producer, empty for a consumer
+                return 0;
+            }
+            pos = index.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif
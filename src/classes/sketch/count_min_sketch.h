@@ -0,0 +1,316 @@
+#ifndef COUNT_MIN_SKETCH_H
+#define COUNT_MIN_SKETCH_H
+
+#include "../../helpers/fast_hash.h"
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace _count_sketch_utils {
+/**
+ * @brief the column of row r for the hash h, by double hashing the two halves of h
+ */
+inline size_t column(uint64_t h, size_t r, size_t width) {
+    const uint32_t x = uint32_t(h) + uint32_t(r) * (uint32_t(h >> 32) | 1);
+    return size_t((uint64_t(x) * width) >> 32);
+}
+
+inline void check_shape(size_t width, size_t depth, const char* name) {
+    if (width == 0 || depth == 0) {
+        throw std::invalid_argument(std::string(name) + ": width and depth must be positive");
+    }
+}
+
+inline void check_error(double epsilon, double delta, const char* name) {
+    if (!(epsilon > 0 && epsilon < 1) || !(delta > 0 && delta < 1)) {
+        throw std::invalid_argument(std::string(name) + ": epsilon and delta must be in (0, 1)");
+    }
+}
+
+// adds the counters of b to a, one flat loop over both tables
+template <typename Counter> void add(Counter* __restrict a, const Counter* __restrict b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        a[i] += b[i];
+    }
+}
+} // namespace _count_sketch_utils
+
+/**
+ * @brief count min sketch class
+ * Approximate frequencies of the keys of a stream in depth rows of width counters
+ * (Cormode and Muthukrishnan): a key adds its count to one counter per row, and its estimate
+ * is the smallest of its counters. The estimate is never below the true frequency, and is
+ * above it by more than e / width times the total count with probability at most e^-depth.
+ * The memory does not depend on the number of distinct keys. The rows are one contiguous
+ * table, so two sketches of the same shape merge with one flat sum, and the sketches of
+ * threads or shards can be added together.
+ * @tparam Key the type of the keys.
+ * @tparam Hash the hash function of the keys. Default = HASHING::hasher<Key>
+ * @tparam Counter the unsigned type of the counters. Default = uint32_t
+ */
+template <typename Key, typename Hash = HASHING::hasher<Key>, typename Counter = uint32_t>
+class count_min_sketch {
+    static_assert(std::is_unsigned_v<Counter>, "counters must be unsigned");
+
+  public:
+    /**
+     * @brief Construct a new count min sketch object
+     * @param width the counters of a row
+     * @param depth the rows
+     * @param hash the hash function. Default = Hash()
+     */
+    count_min_sketch(size_t width, size_t depth, const Hash& hash = Hash())
+        : _hash(hash), _width(width), _depth(depth) {
+        _count_sketch_utils::check_shape(width, depth, "count_min_sketch");
+        _counters.assign(width * depth, 0);
+    }
+
+    /**
+     * @brief with_error function
+     * @param epsilon the error we accept, as a fraction of the total count, in (0, 1)
+     * @param delta the probability that an estimate is off by more, in (0, 1)
+     * @return count_min_sketch of width e / epsilon and depth ln(1 / delta)
+     */
+    static count_min_sketch with_error(double epsilon, double delta) {
+        _count_sketch_utils::check_error(epsilon, delta, "count_min_sketch::with_error");
+        return count_min_sketch(size_t(std::ceil(std::numbers::e / epsilon)),
+                                size_t(std::ceil(std::log(1 / delta))));
+    }
+
+    /**
+     * @brief add function
+     * @param key the key
+     * @param count the number of times key occurred. Default = 1
+     */
+    void add(const Key& key, Counter count = 1) {
+        const uint64_t h = _mix(key);
+        Counter* row = _counters.data();
+        for (size_t r = 0; r < _depth; r++, row += _width) {
+            row[_count_sketch_utils::column(h, r, _width)] += count;
+        }
+        _total += count;
+    }
+
+    /**
+     * @brief estimate function
+     * @param key the key
+     * @return Counter the estimated frequency of key, never below the true one
+     */
+    Counter estimate(const Key& key) const {
+        const uint64_t h = _mix(key);
+        const Counter* row = _counters.data();
+        Counter best = std::numeric_limits<Counter>::max();
+        for (size_t r = 0; r < _depth; r++, row += _width) {
+            best = std::min(best, row[_count_sketch_utils::column(h, r, _width)]);
+        }
+        return best;
+    }
+
+    /**
+     * @brief merge function
+     * Adds the counts of other, as if its stream had been added to this sketch.
+     * @param other a sketch of the same width and depth
+     * Throws std::invalid_argument if the shapes differ.
+     */
+    void merge(const count_min_sketch& other) {
+        if (other._width != _width || other._depth != _depth) {
+            throw std::invalid_argument("count_min_sketch::merge: the shapes differ");
+        }
+        _count_sketch_utils::add(_counters.data(), other._counters.data(), _counters.size());
+        _total += other._total;
+    }
+
+    /**
+     * @brief total function
+     * @return uint64_t the sum of the counts that were added
+     */
+    uint64_t total() const { return _total; }
+
+    /**
+     * @brief width function
+     * @return size_t the counters of a row
+     */
+    size_t width() const { return _width; }
+
+    /**
+     * @brief depth function
+     * @return size_t the rows
+     */
+    size_t depth() const { return _depth; }
+
+    /**
+     * @brief error_bound function
+     * @return double the error e * total / width that an estimate exceeds with probability at
+     * most e^-depth
+     */
+    double error_bound() const { return std::numbers::e * double(_total) / double(_width); }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        std::fill(_counters.begin(), _counters.end(), Counter(0));
+        _total = 0;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bytes of the sketch, its counters are overhead since it
+     * keeps no key
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::as_overhead(MEMORY::heap_usage(_counters));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    Hash _hash;
+    size_t _width;
+    size_t _depth;
+    uint64_t _total{0};
+    // row r is _counters[r * _width, (r + 1) * _width)
+    std::vector<Counter> _counters;
+
+    uint64_t _mix(const Key& key) const { return HASHING::hash_of(_hash, key); }
+};
+
+/**
+ * @brief count sketch class
+ * Approximate frequencies of the keys of a stream(Charikar, Chen and Farach-Colton): like
+ * count_min_sketch, but every row adds the count with a sign picked by the hash of the key,
+ * and the estimate is the median of the signed counters of the key. The estimate is unbiased
+ * and can be below the true frequency, its error depends on the sum of the squared
+ * frequencies instead of the total count, which is much smaller on skewed streams. Sketches
+ * of the same shape merge with one flat sum.
+ * @tparam Key the type of the keys.
+ * @tparam Hash the hash function of the keys. Default = HASHING::hasher<Key>
+ * @tparam Counter the signed type of the counters. Default = int32_t
+ */
+template <typename Key, typename Hash = HASHING::hasher<Key>, typename Counter = int32_t>
+class count_sketch {
+    static_assert(std::is_signed_v<Counter>, "counters must be signed");
+
+  public:
+    /**
+     * @brief Construct a new count sketch object
+     * @param width the counters of a row
+     * @param depth the rows, odd for a true median
+     * @param hash the hash function. Default = Hash()
+     */
+    count_sketch(size_t width, size_t depth, const Hash& hash = Hash())
+        : _hash(hash), _width(width), _depth(depth) {
+        _count_sketch_utils::check_shape(width, depth, "count_sketch");
+        _counters.assign(width * depth, 0);
+    }
+
+    /**
+     * @brief with_error function
+     * @param epsilon the error we accept, as a fraction of the euclidean norm of the
+     * frequencies, in (0, 1)
+     * @param delta the probability that an estimate is off by more, in (0, 1)
+     * @return count_sketch of width 3 / epsilon^2 and odd depth about ln(1 / delta)
+     */
+    static count_sketch with_error(double epsilon, double delta) {
+        _count_sketch_utils::check_error(epsilon, delta, "count_sketch::with_error");
+        const size_t depth = size_t(std::ceil(std::log(1 / delta)));
+        return count_sketch(size_t(std::ceil(3 / (epsilon * epsilon))), depth | 1);
+    }
+
+    /**
+     * @brief add function
+     * @param key the key
+     * @param count the number of times key occurred, negative to take them back. Default = 1
+     */
+    void add(const Key& key, Counter count = 1) {
+        const uint64_t h = _mix(key);
+        Counter* row = _counters.data();
+        for (size_t r = 0; r < _depth; r++, row += _width) {
+            row[_count_sketch_utils::column(h, r, _width)] += _sign(h, r) * count;
+        }
+    }
+
+    /**
+     * @brief estimate function
+     * @param key the key
+     * @return Counter the estimated frequency of key
+     */
+    Counter estimate(const Key& key) const {
+        const uint64_t h = _mix(key);
+        Counter small[64];
+        std::vector<Counter> large(_depth > 64 ? _depth : 0);
+        Counter* rows = _depth > 64 ? large.data() : small;
+        const Counter* row = _counters.data();
+        for (size_t r = 0; r < _depth; r++, row += _width) {
+            rows[r] = _sign(h, r) * row[_count_sketch_utils::column(h, r, _width)];
+        }
+        std::nth_element(rows, rows + _depth / 2, rows + _depth);
+        return rows[_depth / 2];
+    }
+
+    /**
+     * @brief merge function
+     * @param other a sketch of the same width and depth
+     * Throws std::invalid_argument if the shapes differ.
+     */
+    void merge(const count_sketch& other) {
+        if (other._width != _width || other._depth != _depth) {
+            throw std::invalid_argument("count_sketch::merge: the shapes differ");
+        }
+        _count_sketch_utils::add(_counters.data(), other._counters.data(), _counters.size());
+    }
+
+    /**
+     * @brief width function
+     * @return size_t the counters of a row
+     */
+    size_t width() const { return _width; }
+
+    /**
+     * @brief depth function
+     * @return size_t the rows
+     */
+    size_t depth() const { return _depth; }
+
+    /**
+     * @brief clear function
+     */
+    void clear() { std::fill(_counters.begin(), _counters.end(), Counter(0)); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bytes of the sketch, its counters are overhead since it
+     * keeps no key
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::as_overhead(MEMORY::heap_usage(_counters));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    Hash _hash;
+    size_t _width;
+    size_t _depth;
+    std::vector<Counter> _counters;
+
+    uint64_t _mix(const Key& key) const { return HASHING::hash_of(_hash, key); }
+
+    // the sign of row r, from a second hash of h and r
+    static Counter _sign(uint64_t h, size_t r) {
+        return Counter(((HASHING::mix(h + r) >> 63) << 1)) - 1;
+    }
+};
+
+#endif
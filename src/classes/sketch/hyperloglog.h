@@ -0,0 +1,277 @@
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include "../../helpers/fast_hash.h"
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#endif
+
+namespace _hyperloglog_utils {
+// the precision of the sparse entries, whatever the precision of the registers
+constexpr unsigned SPARSE_P = 25;
+
+/**
+ * @brief the sparse entry of the hash h: the first 25 bits of h, then the rank of the first
+ * set bit of the other 39 in 6 bits
+ */
+inline uint32_t encode(uint64_t h) {
+    const uint32_t index = uint32_t(h >> (64 - SPARSE_P));
+    const unsigned rank = std::min<unsigned>(std::countl_zero(h << SPARSE_P), 64 - SPARSE_P) + 1;
+    return (index << 6) | rank;
+}
+
+// sigma and tau of the estimator of Ertl, which needs no table of bias corrections
+inline double sigma(double x) {
+    if (x == 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1, z = x, previous;
+    do {
+        x *= x;
+        previous = z;
+        z += x * y;
+        y += y;
+    } while (z != previous);
+    return z;
+}
+
+inline double tau(double x) {
+    if (x == 0 || x == 1) {
+        return 0;
+    }
+    double y = 1, z = 1 - x, previous;
+    do {
+        x = std::sqrt(x);
+        previous = z;
+        y *= 0.5;
+        z -= (1 - x) * (1 - x) * y;
+    } while (z != previous);
+    return z / 3;
+}
+
+inline void max_registers(uint8_t* __restrict a, const uint8_t* __restrict b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        a[i] = std::max(a[i], b[i]);
+    }
+}
+} // namespace _hyperloglog_utils
+
+/**
+ * @brief hyperloglog class
+ * Approximate number of distinct keys of a stream in 2^precision registers of one byte, with
+ * a relative standard error of about 1.04 / sqrt(2^precision)(0.8% at the default
+ * precision 14, in 16KB). As in HyperLogLog++, the keys are hashed on 64 bits, so there is no
+ * correction for large counts, and a sketch starts sparse: it keeps a sorted list of entries
+ * of 25 bits of hash, nearly exact for small counts, until the list would take more bytes
+ * than the registers. The estimate of the registers is the improved estimator of Ertl,
+ * accurate at every cardinality without the empirical bias tables of HyperLogLog++. Sketches
+ * of the same precision merge by a maximum of the registers, so the sketches of threads or
+ * shards count the distinct keys of their union.
+ * @tparam Key the type of the keys.
+ * @tparam Hash the hash function of the keys. Default = HASHING::hasher<Key>
+ */
+template <typename Key, typename Hash = HASHING::hasher<Key>> class hyperloglog {
+  public:
+    /**
+     * @brief Construct a new hyperloglog object
+     * @param precision the log2 of the number of registers, from 4 to 18. Default = 14
+     * @param hash the hash function. Default = Hash()
+     */
+    explicit hyperloglog(unsigned precision = 14, const Hash& hash = Hash())
+        : _hash(hash), _p(precision) {
+        if (precision < 4 || precision > 18) {
+            throw std::invalid_argument("hyperloglog: the precision must be in [4, 18]");
+        }
+    }
+
+    /**
+     * @brief add function
+     * @param key the key
+     */
+    void add(const Key& key) { add_hash(HASHING::hash_of(_hash, key)); }
+
+    /**
+     * @brief add_hash function
+     * @param h a 64 bit hash of a key with its bits spread, for keys hashed by the caller
+     */
+    void add_hash(uint64_t h) {
+        if (!_dense) {
+            _buffer.push_back(_hyperloglog_utils::encode(h));
+            if (_buffer.size() >= _limit() / 4 + 16) {
+                _flush();
+            }
+            return;
+        }
+        const size_t i = size_t(h >> (64 - _p));
+        const unsigned rank = std::min<unsigned>(std::countl_zero(h << _p), 64 - _p) + 1;
+        _registers[i] = std::max(_registers[i], uint8_t(rank));
+    }
+
+    /**
+     * @brief estimate function
+     * @return double the estimated number of distinct keys that were added
+     */
+    double estimate() const {
+        if (!_dense) {
+            // linear counting over the 2^25 buckets of the sparse entries
+            std::vector<uint32_t> entries = _merged(_sparse, _buffer);
+            const double m = double(size_t(1) << _hyperloglog_utils::SPARSE_P);
+            return m * std::log(m / (m - double(entries.size())));
+        }
+        const size_t q = 64 - _p;
+        std::array<size_t, 66> histogram{};
+        for (uint8_t r : _registers) {
+            histogram[r]++;
+        }
+        const double m = double(_registers.size());
+        double z = m * _hyperloglog_utils::tau(1 - double(histogram[q + 1]) / m);
+        for (size_t k = q; k >= 1; k--) {
+            z = 0.5 * (z + double(histogram[k]));
+        }
+        z += m * _hyperloglog_utils::sigma(double(histogram[0]) / m);
+        return m * m / (2 * std::log(2.0) * z);
+    }
+
+    /**
+     * @brief merge function
+     * @param other a sketch of the same precision
+     * Throws std::invalid_argument if the precisions differ.
+     */
+    void merge(const hyperloglog& other) {
+        if (other._p != _p) {
+            throw std::invalid_argument("hyperloglog::merge: the precisions differ");
+        }
+        if (!_dense && !other._dense) {
+            _buffer.insert(_buffer.end(), other._sparse.begin(), other._sparse.end());
+            _buffer.insert(_buffer.end(), other._buffer.begin(), other._buffer.end());
+            _flush();
+            return;
+        }
+        _densify();
+        if (other._dense) {
+            _hyperloglog_utils::max_registers(_registers.data(), other._registers.data(),
+                                              _registers.size());
+        } else {
+            for (uint32_t e : _merged(other._sparse, other._buffer)) {
+                _add_entry(e);
+            }
+        }
+    }
+
+    /**
+     * @brief precision function
+     * @return unsigned the log2 of the number of registers
+     */
+    unsigned precision() const { return _p; }
+
+    /**
+     * @brief sparse function
+     * @return true if the sketch still keeps a list of entries instead of its registers
+     */
+    bool sparse() const { return !_dense; }
+
+    /**
+     * @brief relative_error function
+     * @return double the relative standard error of the estimate once the sketch is dense
+     */
+    double relative_error() const { return 1.04 / std::sqrt(double(size_t(1) << _p)); }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        _dense = false;
+        _registers = {};
+        _sparse.clear();
+        _buffer.clear();
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bytes of the sketch, its registers and entries are
+     * overhead since it keeps no key
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::as_overhead(MEMORY::heap_usage(_registers));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_sparse));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_buffer));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    Hash _hash;
+    unsigned _p;
+    bool _dense{false};
+    std::vector<uint8_t> _registers;
+    // sorted, one entry per index of 25 bits with its largest rank
+    std::vector<uint32_t> _sparse;
+    // entries added since the last flush, unsorted
+    std::vector<uint32_t> _buffer;
+
+    // the most entries of the sparse list, as many bytes as the registers
+    size_t _limit() const { return (size_t(1) << _p) / 4; }
+
+    // sorted entries of a and b, one per index with its largest rank
+    static std::vector<uint32_t> _merged(const std::vector<uint32_t>& a,
+                                         const std::vector<uint32_t>& b) {
+        std::vector<uint32_t> out(a);
+        out.insert(out.end(), b.begin(), b.end());
+        std::sort(out.begin(), out.end());
+        // the entries of an index are consecutive and the last has the largest rank
+        size_t n = 0;
+        for (size_t i = 0; i < out.size(); i++) {
+            if (i + 1 < out.size() && (out[i + 1] >> 6) == (out[i] >> 6)) {
+                continue;
+            }
+            out[n++] = out[i];
+        }
+        out.resize(n);
+        return out;
+    }
+
+    void _flush() {
+        _sparse = _merged(_sparse, _buffer);
+        _buffer.clear();
+        if (_sparse.size() > _limit()) {
+            _densify();
+        }
+    }
+
+    void _densify() {
+        if (_dense) {
+            return;
+        }
+        std::vector<uint32_t> entries = _merged(_sparse, _buffer);
+        _sparse = {};
+        _buffer = {};
+        _registers.assign(size_t(1) << _p, 0);
+        _dense = true;
+        for (uint32_t e : entries) {
+            _add_entry(e);
+        }
+    }
+
+    // the register and rank of a sparse entry: the bits of its index past the precision
+    // come first in the hash
+    void _add_entry(uint32_t e) {
+        const unsigned extra = _hyperloglog_utils::SPARSE_P - _p;
+        const uint32_t index = e >> 6, low = index & ((uint32_t(1) << extra) - 1);
+        const unsigned rank = low != 0 ? unsigned(std::countl_zero(low)) - (32 - extra) + 1
+                                       : extra + (e & 63);
+        uint8_t& r = _registers[index >> extra];
+        r = std::max(r, uint8_t(rank));
+    }
+};
+
+#endif
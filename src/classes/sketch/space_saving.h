@@ -0,0 +1,285 @@
+#ifndef SPACE_SAVING_H
+#define SPACE_SAVING_H
+
+#include "../../helpers/memory_usage.h"
+#include "../hash_table/flat_hash_table.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief space saving class
+ * The heavy hitters of a stream in k counters(Metwally, Agrawal and El Abbadi): a key that
+ * has a counter adds its count to it, another key takes the counter of the smallest count and
+ * adds to it, keeping that count as its error. Every key that occurs more than total / k
+ * times has a counter, and the count of a key is above its true frequency by at most its
+ * error, which is at most total / k. The counts, errors and keys are parallel arrays ordered
+ * by a binary min heap with a position table, and a flat_hash_table finds the counter of a
+ * key, so an update is O(log k) and weighted counts are fine. Summaries merge(Agarwal et al.,
+ * mergeable summaries): the sketches of threads or shards combine into one with the same
+ * guarantee for the union of their streams.
+ * @tparam Key the type of the keys.
+ * @tparam Hash the hash function of the keys. Default = HASHING::hasher<Key>
+ */
+template <typename Key, typename Hash = HASHING::hasher<Key>> class space_saving {
+  public:
+    /**
+     * @brief a key with its counter
+     * count is at least the true frequency of key, count - error at most.
+     */
+    struct entry {
+        Key key;
+        uint64_t count;
+        uint64_t error;
+    };
+
+    /**
+     * @brief Construct a new space saving object
+     * @param k the number of counters
+     * Throws std::invalid_argument if k is 0.
+     */
+    explicit space_saving(size_t k) : _k(k) {
+        if (k == 0) {
+            throw std::invalid_argument("space_saving: k must be positive");
+        }
+        _index.reserve(k);
+    }
+
+    /**
+     * @brief add function
+     * @param key the key
+     * @param count the number of times key occurred. Default = 1
+     */
+    void add(const Key& key, uint64_t count = 1) {
+        _total += count;
+        if (uint32_t* slot = _index.find(key)) {
+            _counts[*slot] += count;
+            _sift_down(_pos[*slot]);
+            return;
+        }
+        if (_keys.size() < _k) {
+            const uint32_t slot = uint32_t(_keys.size());
+            _keys.push_back(key);
+            _counts.push_back(count);
+            _errors.push_back(0);
+            _pos.push_back(slot);
+            _heap.push_back(slot);
+            _index.insert(key, slot);
+            _sift_up(slot);
+            return;
+        }
+        // the key takes the counter of the smallest count
+        const uint32_t slot = _heap.front();
+        _index.remove(_keys[slot]);
+        _keys[slot] = key;
+        _errors[slot] = _counts[slot];
+        _counts[slot] += count;
+        _index.insert(key, slot);
+        _sift_down(0);
+    }
+
+    /**
+     * @brief estimate function
+     * @param key the key
+     * @return uint64_t an upper bound of the frequency of key: its count if it has a counter,
+     * else the smallest count once the counters are all taken
+     */
+    uint64_t estimate(const Key& key) const {
+        if (const uint32_t* slot = _index.find(key)) {
+            return _counts[*slot];
+        }
+        return _floor();
+    }
+
+    /**
+     * @brief top function
+     * @param n the number of keys. Default = all of them
+     * @return std::vector<entry> the n keys with the largest counts, largest first
+     */
+    std::vector<entry> top(size_t n = SIZE_MAX) const {
+        std::vector<entry> out = _entries();
+        n = std::min(n, out.size());
+        std::partial_sort(out.begin(), out.begin() + n, out.end(), _larger);
+        out.resize(n);
+        return out;
+    }
+
+    /**
+     * @brief heavy_hitters function
+     * @param phi the fraction of the total count, in (0, 1]
+     * @return std::vector<entry> the keys whose count is above phi * total, largest first.
+     * Every key that occurs more than phi * total times is there when phi >= 1 / k, the keys
+     * with count - error above phi * total surely occur that often.
+     */
+    std::vector<entry> heavy_hitters(double phi) const {
+        if (!(phi > 0 && phi <= 1)) {
+            throw std::invalid_argument("space_saving::heavy_hitters: phi must be in (0, 1]");
+        }
+        std::vector<entry> out;
+        for (entry& e : _entries()) {
+            if (double(e.count) > phi * double(_total)) {
+                out.push_back(std::move(e));
+            }
+        }
+        std::sort(out.begin(), out.end(), _larger);
+        return out;
+    }
+
+    /**
+     * @brief merge function
+     * A key that is missing from one summary is counted there with its smallest count, as
+     * error, then the k largest counts are kept.
+     * @param other a summary of another part of the stream
+     */
+    void merge(const space_saving& other) {
+        const uint64_t mine = _floor(), theirs = other._floor();
+        std::vector<entry> all = _entries();
+        for (entry& e : all) {
+            if (const uint32_t* slot = other._index.find(e.key)) {
+                e.count += other._counts[*slot];
+                e.error += other._errors[*slot];
+            } else {
+                e.count += theirs;
+                e.error += theirs;
+            }
+        }
+        for (size_t s = 0; s < other._keys.size(); s++) {
+            if (!_index.contains(other._keys[s])) {
+                all.push_back({other._keys[s], other._counts[s] + mine, other._errors[s] + mine});
+            }
+        }
+        const size_t n = std::min(_k, all.size());
+        std::partial_sort(all.begin(), all.begin() + n, all.end(), _larger);
+        all.resize(n);
+        const uint64_t total = _total + other._total;
+        clear();
+        _total = total;
+        for (entry& e : all) {
+            const uint32_t slot = uint32_t(_keys.size());
+            _index.insert(e.key, slot);
+            _keys.push_back(std::move(e.key));
+            _counts.push_back(e.count);
+            _errors.push_back(e.error);
+            _pos.push_back(slot);
+            _heap.push_back(slot);
+        }
+        // largest first is the reverse of a min heap
+        std::reverse(_heap.begin(), _heap.end());
+        for (size_t i = 0; i < _heap.size(); i++) {
+            _pos[_heap[i]] = uint32_t(i);
+        }
+    }
+
+    /**
+     * @brief total function
+     * @return uint64_t the sum of the counts that were added
+     */
+    uint64_t total() const { return _total; }
+
+    /**
+     * @brief size function
+     * @return size_t the number of counters in use
+     */
+    size_t size() const { return _keys.size(); }
+
+    /**
+     * @brief capacity function
+     * @return size_t k, the number of counters
+     */
+    size_t capacity() const { return _k; }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        _keys.clear();
+        _counts.clear();
+        _errors.clear();
+        _heap.clear();
+        _pos.clear();
+        _index.clear();
+        _total = 0;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the keys are payload, the counts, errors, heap and index are
+     * node overhead
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_keys);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_counts));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_errors));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_heap));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_pos));
+        MEMORY::footprint index = _index.memory_usage();
+        index.control -= std::min(index.control, sizeof(_index));
+        f += MEMORY::as_overhead(index);
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    size_t _k;
+    uint64_t _total{0};
+    // the counter of slot s is _keys[s], _counts[s] and _errors[s]
+    std::vector<Key> _keys;
+    std::vector<uint64_t> _counts;
+    std::vector<uint64_t> _errors;
+    // the slots in a min heap of their counts, and the position of every slot in it
+    std::vector<uint32_t> _heap;
+    std::vector<uint32_t> _pos;
+    flat_hash_table<Key, uint32_t, Hash> _index;
+
+    static bool _larger(const entry& a, const entry& b) { return a.count > b.count; }
+
+    // the count a key without a counter may have
+    uint64_t _floor() const { return _keys.size() < _k ? 0 : _counts[_heap.front()]; }
+
+    std::vector<entry> _entries() const {
+        std::vector<entry> out;
+        out.reserve(_keys.size());
+        for (size_t s = 0; s < _keys.size(); s++) {
+            out.push_back({_keys[s], _counts[s], _errors[s]});
+        }
+        return out;
+    }
+
+    void _swap(size_t i, size_t j) {
+        std::swap(_heap[i], _heap[j]);
+        _pos[_heap[i]] = uint32_t(i);
+        _pos[_heap[j]] = uint32_t(j);
+    }
+
+    void _sift_up(size_t i) {
+        while (i > 0 && _counts[_heap[i]] < _counts[_heap[(i - 1) / 2]]) {
+            _swap(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void _sift_down(size_t i) {
+        const size_t n = _heap.size();
+        while (true) {
+            size_t smallest = i;
+            for (size_t c = 2 * i + 1; c <= 2 * i + 2 && c < n; c++) {
+                if (_counts[_heap[c]] < _counts[_heap[smallest]]) {
+                    smallest = c;
+                }
+            }
+            if (smallest == i) {
+                return;
+            }
+            _swap(i, smallest);
+            i = smallest;
+        }
+    }
+};
+
+#endif
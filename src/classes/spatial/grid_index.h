@@ -0,0 +1,191 @@
+#ifndef GRID_INDEX_H
+#define GRID_INDEX_H
+
+#include "../../helpers/fast_hash.h"
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#endif
+
+/**
+ * @brief grid index class
+ * Uniform grid over a set of points for fixed radius queries: every point goes to the cube
+ * of side cell that holds it, the points are sorted by cube so that every cube is a
+ * contiguous range, and a hash map takes the coordinates of a non empty cube to its range.
+ * A query of radius at most cell only looks at the 3^D cubes around the query point, so
+ * with about the same number of points per cube it costs O(3^D) hash lookups plus the
+ * points it scans, whatever the size of the set.
+ * @tparam D the number of dimensions
+ * @tparam T the type of the coordinates. Default = double
+ */
+template <size_t D, typename T = double> class grid_index {
+    static_assert(D > 0, "grid_index needs at least one dimension");
+
+  public:
+    using point = std::array<T, D>;
+    using cube = std::array<int64_t, D>;
+
+    /**
+     * @brief Construct a new grid index object
+     * @param points the points, their ids are their positions
+     * @param cell the side of the cubes, usually the radius of the queries
+     * Throws std::invalid_argument if cell is not positive and finite, std::length_error
+     * past 2^32 - 1 points.
+     */
+    grid_index(std::span<const point> points, T cell)
+        : _points(points.begin(), points.end()), _cell(cell) {
+        if (!(cell > T(0)) || !std::isfinite(double(cell))) {
+            throw std::invalid_argument("grid_index: the cell must be positive");
+        }
+        if (points.size() > size_t(UINT32_MAX)) {
+            throw std::length_error("grid_index: too many points");
+        }
+        std::vector<cube> cubes(points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            cubes[i] = cube_of(points[i]);
+        }
+        _ids.resize(points.size());
+        std::iota(_ids.begin(), _ids.end(), 0);
+        std::stable_sort(_ids.begin(), _ids.end(),
+                         [&](uint32_t a, uint32_t b) { return cubes[a] < cubes[b]; });
+        for (size_t i = 0; i < _ids.size();) {
+            size_t j = i;
+            while (j < _ids.size() && cubes[_ids[j]] == cubes[_ids[i]]) {
+                j++;
+            }
+            _cubes.emplace(cubes[_ids[i]], std::pair<uint32_t, uint32_t>(i, j));
+            i = j;
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of points.
+     */
+    size_t size() const { return _points.size(); }
+
+    /**
+     * @brief cell function
+     * @return T the side of the cubes.
+     */
+    T cell() const { return _cell; }
+
+    /**
+     * @brief cube of function
+     * @param p a point
+     * @return cube the coordinates of the cube that holds p.
+     */
+    cube cube_of(const point& p) const {
+        cube c;
+        for (size_t d = 0; d < D; d++) {
+            c[d] = int64_t(std::floor(p[d] / _cell));
+        }
+        return c;
+    }
+
+    /**
+     * @brief for each candidate function
+     * @param q the query point
+     * @param r the radius
+     * @param f called with the id of every point of the cubes that meet the cube around q of
+     * side 2r, a superset of the points at distance at most r, so that the caller can use its
+     * own distance test.
+     */
+    template <typename F> void for_each_candidate(const point& q, T r, F&& f) const {
+        cube lo = cube_of(q), hi = lo;
+        for (size_t d = 0; d < D; d++) {
+            point a = q, b = q;
+            a[d] -= r;
+            b[d] += r;
+            lo[d] = cube_of(a)[d];
+            hi[d] = cube_of(b)[d];
+        }
+        cube c = lo;
+        while (true) {
+            auto it = _cubes.find(c);
+            if (it != _cubes.end()) {
+                for (uint32_t i = it->second.first; i < it->second.second; i++) {
+                    f(size_t(_ids[i]));
+                }
+            }
+            // the next cube of the box, as an odometer
+            size_t d = 0;
+            while (d < D && c[d] == hi[d]) {
+                c[d] = lo[d];
+                d++;
+            }
+            if (d == D) {
+                return;
+            }
+            c[d]++;
+        }
+    }
+
+    /**
+     * @brief radius function
+     * @param q the query point
+     * @param r the radius
+     * @return std::vector<size_t> the ids of the points at distance at most r from q,
+     * sorted.
+     */
+    std::vector<size_t> radius(const point& q, T r) const {
+        std::vector<size_t> out;
+        if (!(r >= T(0))) {
+            return out;
+        }
+        for_each_candidate(q, r, [&](size_t i) {
+            T sum = T(0);
+            for (size_t d = 0; d < D; d++) {
+                T x = q[d] - _points[i][d];
+                sum += x * x;
+            }
+            if (sum <= r * r) {
+                out.push_back(i);
+            }
+        });
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the points, their ids sorted by cube and the table of the cubes as
+     * node overhead, the object with the headers of the arrays and the bucket table, and the
+     * spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_points);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_ids));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_cubes));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    struct cube_hash {
+        size_t operator()(const cube& c) const {
+            uint64_t h = 0;
+            for (int64_t x : c) {
+                h = HASHING::combine(h, uint64_t(x));
+            }
+            return size_t(h);
+        }
+    };
+
+    std::vector<point> _points;
+    T _cell;
+    // the ids sorted by cube, and the range of every cube in it
+    std::vector<uint32_t> _ids;
+    std::unordered_map<cube, std::pair<uint32_t, uint32_t>, cube_hash> _cubes;
+};
+
+#endif
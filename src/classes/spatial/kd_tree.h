@@ -0,0 +1,239 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief kd tree class
+ * Static k-d tree bulk loaded from a set of points: the points are reordered in one array
+ * so that every subtree is a contiguous range split at its median along the dimension of its
+ * widest spread, and only the split dimension of every node is stored next to them, so the
+ * tree holds no pointers, just a 32 bit id and a byte next to every point. The ranges of at
+ * most leaf_size points are scanned. Built in O(n log(n)), a query visits O(log(n)) nodes on
+ * spread out points.
+ * @tparam D the number of dimensions
+ * @tparam T the type of the coordinates. Default = double
+ */
+template <size_t D, typename T = double> class kd_tree {
+    static_assert(D > 0 && D < 256, "kd_tree needs 1 to 255 dimensions");
+
+  public:
+    using point = std::array<T, D>;
+    static constexpr size_t leaf_size = 16;
+
+    /**
+     * @brief Construct a new kd tree object
+     * @param points the points, their ids are their positions
+     * Throws std::length_error past 2^32 - 1 points.
+     */
+    explicit kd_tree(std::span<const point> points = {})
+        : _points(points.begin(), points.end()), _ids(points.size()), _dims(points.size()) {
+        if (points.size() > size_t(UINT32_MAX)) {
+            throw std::length_error("kd_tree: too many points");
+        }
+        std::iota(_ids.begin(), _ids.end(), 0);
+        _build(0, size());
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of points.
+     */
+    size_t size() const { return _points.size(); }
+
+    /**
+     * @brief empty function
+     * @return true if the tree has no points.
+     */
+    bool empty() const { return _points.empty(); }
+
+    /**
+     * @brief squared distance function
+     * @param a a point
+     * @param b another point
+     * @return T the squared euclidean distance of a and b.
+     */
+    static T distance2(const point& a, const point& b) {
+        T sum = T(0);
+        for (size_t d = 0; d < D; d++) {
+            T x = a[d] - b[d];
+            sum += x * x;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief nearest function
+     * @param q the query point
+     * @return size_t the id of the point closest to q, the smallest one on ties.
+     * Throws std::out_of_range if the tree is empty.
+     */
+    size_t nearest(const point& q) const {
+        if (empty()) {
+            throw std::out_of_range("kd_tree: nearest on an empty tree");
+        }
+        return nearest(q, 1)[0];
+    }
+
+    /**
+     * @brief k nearest neighbours function
+     * @param q the query point
+     * @param k the number of neighbours
+     * @return std::vector<size_t> the ids of the min(k, size()) points closest to q, by
+     * distance and then by id.
+     */
+    std::vector<size_t> nearest(const point& q, size_t k) const {
+        k = std::min(k, size());
+        std::vector<size_t> out;
+        if (k == 0) {
+            return out;
+        }
+        // a max heap of the best k so far, by (distance, id)
+        std::priority_queue<std::pair<T, uint32_t>> best;
+        _knn(0, size(), q, k, best);
+        out.resize(best.size());
+        for (size_t i = out.size(); i-- > 0; best.pop()) {
+            out[i] = best.top().second;
+        }
+        return out;
+    }
+
+    /**
+     * @brief radius function
+     * @param q the query point
+     * @param r the radius
+     * @return std::vector<size_t> the ids of the points at distance at most r from q,
+     * sorted.
+     */
+    std::vector<size_t> radius(const point& q, T r) const {
+        std::vector<size_t> out;
+        if (r >= T(0)) {
+            _radius(0, size(), q, r * r, out);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the points, their ids and the split dimensions as node overhead,
+     * the object with the headers of the arrays and their spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_points);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_ids));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_dims));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    std::vector<point> _points;
+    std::vector<uint32_t> _ids;
+    // the split dimension of the subtree whose median is at this position
+    std::vector<uint8_t> _dims;
+
+    void _build(size_t lo, size_t hi) {
+        while (hi - lo > leaf_size) {
+            point low = _points[lo], high = _points[lo];
+            for (size_t i = lo + 1; i < hi; i++) {
+                for (size_t d = 0; d < D; d++) {
+                    low[d] = std::min(low[d], _points[i][d]);
+                    high[d] = std::max(high[d], _points[i][d]);
+                }
+            }
+            size_t dim = 0;
+            for (size_t d = 1; d < D; d++) {
+                if (high[d] - low[d] > high[dim] - low[dim]) {
+                    dim = d;
+                }
+            }
+            // the points and their ids are moved together through a permutation of the range
+            size_t mid = lo + (hi - lo) / 2;
+            std::vector<uint32_t> order(hi - lo);
+            std::iota(order.begin(), order.end(), uint32_t(lo));
+            std::nth_element(order.begin(), order.begin() + (mid - lo), order.end(),
+                             [&](uint32_t a, uint32_t b) {
+                                 return _points[a][dim] < _points[b][dim];
+                             });
+            std::vector<point> points(hi - lo);
+            std::vector<uint32_t> ids(hi - lo);
+            for (size_t i = 0; i < order.size(); i++) {
+                points[i] = _points[order[i]];
+                ids[i] = _ids[order[i]];
+            }
+            std::copy(points.begin(), points.end(), _points.begin() + lo);
+            std::copy(ids.begin(), ids.end(), _ids.begin() + lo);
+            _dims[mid] = uint8_t(dim);
+            _build(lo, mid);
+            lo = mid + 1;
+        }
+    }
+
+    void _knn(size_t lo, size_t hi, const point& q, size_t k,
+              std::priority_queue<std::pair<T, uint32_t>>& best) const {
+        auto offer = [&](size_t i) {
+            std::pair<T, uint32_t> c = {distance2(q, _points[i]), _ids[i]};
+            if (best.size() < k) {
+                best.push(c);
+            } else if (c < best.top()) {
+                best.pop();
+                best.push(c);
+            }
+        };
+        while (hi - lo > leaf_size) {
+            size_t mid = lo + (hi - lo) / 2, dim = _dims[mid];
+            T diff = q[dim] - _points[mid][dim];
+            // the side of q first, the other one only if the split plane is close enough
+            size_t nlo = diff < T(0) ? lo : mid + 1, nhi = diff < T(0) ? mid : hi;
+            size_t flo = diff < T(0) ? mid + 1 : lo, fhi = diff < T(0) ? hi : mid;
+            _knn(nlo, nhi, q, k, best);
+            offer(mid);
+            if (best.size() == k && diff * diff > best.top().first) {
+                return;
+            }
+            lo = flo;
+            hi = fhi;
+        }
+        for (size_t i = lo; i < hi; i++) {
+            offer(i);
+        }
+    }
+
+    void _radius(size_t lo, size_t hi, const point& q, T r2, std::vector<size_t>& out) const {
+        while (hi - lo > leaf_size) {
+            size_t mid = lo + (hi - lo) / 2, dim = _dims[mid];
+            T diff = q[dim] - _points[mid][dim];
+            if (distance2(q, _points[mid]) <= r2) {
+                out.push_back(_ids[mid]);
+            }
+            if (diff * diff > r2) {
+                // the ball is on one side of the split plane
+                lo = diff < T(0) ? lo : mid + 1;
+                hi = diff < T(0) ? mid : hi;
+                continue;
+            }
+            _radius(lo, mid, q, r2, out);
+            lo = mid + 1;
+        }
+        for (size_t i = lo; i < hi; i++) {
+            if (distance2(q, _points[i]) <= r2) {
+                out.push_back(_ids[i]);
+            }
+        }
+    }
+};
+
+#endif
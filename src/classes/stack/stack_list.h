@@ -1,44 +1,60 @@
 #ifndef STACK_H
 #define STACK_H
 
+#include "../../helpers/memory_usage.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #endif
 
 /**
- * @brief stack_list class
+ * @brief default inline capacity of stack_list
+ * As many values as fit in 256 bytes, and at least 1.
  */
-template <typename T> class stack_list {
-  private:
-    /**
-     * @brief struct for the node
-     * @param val: the value of the node
-     * @param next: pointer to the next node
-     * @param prev: pointer to the previous node
-     */
-    struct node {
-        T val;
-        std::shared_ptr<node> next;
-        std::shared_ptr<node> prev;
-        node(T key) : val(key), next(nullptr), prev(nullptr) {}
-    };
+template <typename T>
+inline constexpr size_t stack_inline_capacity = std::max<size_t>(1, 256 / sizeof(T));
 
-    std::shared_ptr<node> root;
-    size_t _size{0};
+/**
+ * @brief stack_list class
+ * The values are kept in one array, from the bottom to the top, and the first N of them
+ * are in a buffer inside the stack, so a stack that never holds more than N values never
+ * allocates. When the array is full it doubles, so push is amortized O(1). Pushing may
+ * invalidate the references to the values when it grows the array. The arrays that do not fit
+ * inline come from a std::pmr::memory_resource.
+ * @tparam T the type of the values.
+ * @tparam N the number of values kept inline. Default = stack_inline_capacity<T>
+ */
+template <typename T, size_t N = stack_inline_capacity<T>> class stack_list {
+    static_assert(N > 0, "stack_list needs room for at least one inline value");
+    static constexpr bool _nothrow_move = std::is_nothrow_move_constructible_v<T>;
 
   public:
+    using Iterator = std::reverse_iterator<T*>;
+    using ConstIterator = std::reverse_iterator<const T*>;
+
     /**
      * @brief Construct a new stack list object
      *
      * @param v initializer vector
+     * @param resource the memory resource of the array once it outgrows the buffer. Default =
+     * std::pmr::get_default_resource()
      */
-    inline explicit stack_list(std::vector<T> v = {}) noexcept : root(nullptr) {
-        if (!v.empty()) {
-            for (T& x : v) {
-                this->push(x);
-            }
+    inline explicit stack_list(std::vector<T> v = {},
+                               std::pmr::memory_resource* resource =
+                                   std::pmr::get_default_resource())
+        : _resource(resource) {
+        reserve(v.size());
+        for (T& x : v) {
+            this->push(std::move(x));
         }
     }
 
@@ -46,7 +62,19 @@ template <typename T> class stack_list {
      * @brief Copy constructor for stack list class
      * @param s the stack we want to copy
      */
-    inline explicit stack_list(const stack_list& s) : root(s.root), _size(s._size) {}
+    inline explicit stack_list(const stack_list& s) {
+        reserve(s._size);
+        std::uninitialized_copy(s._data, s._data + s._size, _data);
+        _size = s._size;
+    }
+
+    /**
+     * @brief Move constructor for stack list class
+     * @param s the stack we want to move, it is left empty
+     */
+    inline stack_list(stack_list&& s) noexcept(_nothrow_move) : _resource(s._resource) {
+        _take(s);
+    }
 
     /**
      * @brief operator = for stack list class
@@ -54,16 +82,44 @@ template <typename T> class stack_list {
      * @return stack_list&
      */
     inline stack_list& operator=(const stack_list& s) {
-        root = s.root;
-        _size = s._size;
+        if (this != &s) {
+            clear();
+            reserve(s._size);
+            std::uninitialized_copy(s._data, s._data + s._size, _data);
+            _size = s._size;
+        }
         return *this;
     }
 
+    /**
+     * @brief move assignment for stack list class
+     * @param s the stack we want to move, it is left empty
+     * @return stack_list&
+     */
+    inline stack_list& operator=(stack_list&& s) noexcept(_nothrow_move) {
+        if (this != &s) {
+            _release();
+            _take(s);
+        }
+        return *this;
+    }
+
+    inline ~stack_list() { _release(); }
+
+    /**
+     * @brief resource function
+     *
+     * @return std::pmr::memory_resource* the resource the array comes from when it is not
+     * inline
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
     /**
      * @brief clear function
+     * The array is kept for the next pushes.
      */
     inline void clear() {
-        root = nullptr;
+        std::destroy(_data, _data + _size);
         _size = 0;
     }
 
@@ -72,125 +128,150 @@ template <typename T> class stack_list {
      *
      * @return size_t the size of the stack
      */
-    inline size_t size() { return _size; }
+    inline size_t size() const { return _size; }
 
     /**
-     * @brief push function
+     * @brief memory_usage function
      *
-     * @param key the key to be pushed
+     * @return MEMORY::footprint the values, the stack with its inline array, and the empty
+     * places of the array in use
      */
-    inline void push(T key) {
-        std::shared_ptr<node> nn = std::make_shared<node>(key);
-        if (!root) {
-            root = nn;
-            _size++;
-            return;
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.payload = MEMORY::payload(_data, _data + _size);
+        f.slack = (_cap - _size) * sizeof(T);
+        f.control = sizeof(*this);
+        if (_is_inline()) {
+            f.control -= _cap * sizeof(T);
         } else {
-            root->next = nn;
-            nn->prev = root;
-            root = nn;
-            _size++;
+            f.control += MEMORY::ALLOCATION_OVERHEAD;
         }
+        return f;
     }
 
     /**
-     * @brief top function
+     * @brief empty function
      *
-     * @return T the top of the stack
+     * @return true if the stack is empty
      */
-    inline T top() { return root->val; }
-
-    /**
-     * @brief pop function
-     * removes the top of the stack
-     */
-    inline void pop() {
-        root = root->prev;
-        root->next = nullptr;
-        _size--;
-    }
-
-    class Iterator;
+    inline bool empty() const { return _size == 0; }
 
     /**
-     * @brief pointer to the top of the stack
+     * @brief capacity function
      *
-     * @return Iterator
+     * @return size_t the number of values the stack holds before it grows
      */
-    inline Iterator begin() { return Iterator(root); }
+    inline size_t capacity() const { return _cap; }
 
     /**
-     * @brief pointer to the end of the stack
+     * @brief reserve function
      *
-     * @return Iterator
+     * @param n the number of values the stack should hold without growing
      */
-    inline Iterator end() { return Iterator(nullptr); }
-};
-
-/**
- * @brief Iterator class
- */
-template <typename T> class stack_list<T>::Iterator {
-  private:
-    std::shared_ptr<node> curr_root;
+    inline void reserve(size_t n) {
+        if (n > _cap) {
+            _grow(n);
+        }
+    }
 
-  public:
     /**
-     * @brief Construct a new Iterator object
+     * @brief push function
      *
-     * @param s stack_list pointer
+     * @param key the key to be pushed
      */
-    explicit Iterator(const std::shared_ptr<node>& s) noexcept : curr_root(s) {}
+    inline void push(T key) { emplace(std::move(key)); }
 
     /**
-     * @brief = operator for Iterator type
+     * @brief emplace function
      *
-     * @param current smart pointer of type node
-     * @return Iterator&
+     * @param args the arguments of the constructor of T
+     * @return T& the new top of the stack
      */
-    Iterator& operator=(std::shared_ptr<node> current) {
-        this->curr_root = current;
-        return *(this);
+    template <typename... Args> inline T& emplace(Args&&... args) {
+        if (_size == _cap) {
+            // the arguments may refer to a value of the stack, so they are used first
+            T key(std::forward<Args>(args)...);
+            _grow(2 * _cap);
+            return *std::construct_at(_data + _size++, std::move(key));
+        }
+        return *std::construct_at(_data + _size++, std::forward<Args>(args)...);
     }
 
     /**
-     * @brief operator ++ for type Iterator
+     * @brief top function, the stack must not be empty
      *
-     * @return Iterator&
+     * @return T& the top of the stack
      */
-    Iterator& operator++() {
-        if (curr_root) {
-            curr_root = curr_root->prev;
-        }
-        return *(this);
-    }
+    inline T& top() { return _data[_size - 1]; }
+    inline const T& top() const { return _data[_size - 1]; }
 
     /**
-     * @brief operator ++ for type Iterator
-     *
-     * @return Iterator
+     * @brief pop function, the stack must not be empty
+     * removes the top of the stack
      */
-    Iterator operator++(int) {
-        Iterator it = *this;
-        ++*(this);
-        return it;
-    }
+    inline void pop() { std::destroy_at(_data + --_size); }
 
     /**
-     * @brief operator != for type Iterator
+     * @brief pointer to the top of the stack, the iterators go from the top to the bottom
      *
-     * @param it const Iterator
-     * @return true if curr_root == it.curr_root
-     * @return false otherwise
+     * @return Iterator
      */
-    bool operator!=(const Iterator& it) { return curr_root != it.curr_root; }
+    inline Iterator begin() { return Iterator(_data + _size); }
+    inline ConstIterator begin() const { return ConstIterator(_data + _size); }
 
     /**
-     * @brief operator * for type Iterator
+     * @brief pointer to the end of the stack
      *
-     * @return T the value of the node
+     * @return Iterator
      */
-    T operator*() { return curr_root->val; }
+    inline Iterator end() { return Iterator(_data); }
+    inline ConstIterator end() const { return ConstIterator(_data); }
+
+  private:
+    alignas(T) unsigned char _inline[N * sizeof(T)];
+    T* _data{reinterpret_cast<T*>(_inline)};
+    size_t _size{0};
+    size_t _cap{N};
+    std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
+
+    std::pmr::polymorphic_allocator<T> _alloc() const { return _resource; }
+
+    bool _is_inline() const { return _data == reinterpret_cast<const T*>(_inline); }
+
+    void _grow(size_t cap) {
+        T* data = _alloc().allocate(cap);
+        std::uninitialized_move(_data, _data + _size, data);
+        std::destroy(_data, _data + _size);
+        if (!_is_inline()) {
+            _alloc().deallocate(_data, _cap);
+        }
+        _data = data;
+        _cap = cap;
+    }
+
+    void _release() {
+        clear();
+        if (!_is_inline()) {
+            _alloc().deallocate(_data, _cap);
+        }
+        _data = reinterpret_cast<T*>(_inline);
+        _cap = N;
+    }
+
+    // s must not own memory of this stack, this stack must be empty and inline
+    void _take(stack_list& s) {
+        if (s._is_inline()) {
+            std::uninitialized_move(s._data, s._data + s._size, _data);
+            _size = s._size;
+            s.clear();
+            return;
+        }
+        // the array goes back to the resource it came from
+        _resource = s._resource;
+        _data = std::exchange(s._data, reinterpret_cast<T*>(s._inline));
+        _size = std::exchange(s._size, 0);
+        _cap = std::exchange(s._cap, N);
+    }
 };
 
 #endif
@@ -1,10 +1,11 @@
 #ifndef TWOTHREEFOUR_TREE_H
 #define TWOTHREEFOUR_TREE_H
 
+#include "../../helpers/node_pool.h"
+
 #ifdef __cplusplus
 #include <algorithm>
 #include <iostream>
-#include <memory>
 #include <queue>
 #include <unordered_map>
 #include <vector>
@@ -25,15 +26,44 @@ template <typename T> class ttf_tree {
      */
     typedef struct node {
         std::vector<T> keys;
-        std::vector<std::shared_ptr<node>> children;
+        std::vector<node*> children;
         int numChildren;
         int index{};
-        node(std::vector<T> keys, std::vector<std::shared_ptr<node>> children, int numChildren)
+        node(std::vector<T> keys, std::vector<node*> children, int numChildren)
             : keys(keys), children(children), numChildren(numChildren) {}
     } node;
 
-    std::shared_ptr<node> root;
-    std::unordered_map<std::shared_ptr<node>, std::shared_ptr<node>> parent;
+    node_pool<node> _pool;
+    node* root{nullptr};
+    std::unordered_map<node*, node*> parent;
+
+    node* _copy(const node* t, node* p) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        node* nn = _pool.create(t->keys, std::vector<node*>(4, nullptr), t->numChildren);
+        nn->index = t->index;
+        parent[nn] = p;
+        for (size_t i = 0; i < t->children.size(); i++) {
+            nn->children[i] = _copy(t->children[i], nn);
+        }
+        return nn;
+    }
+
+    // the children of a split 4-node move to the two halves
+    void _adopt(node* p, int c, node* child) {
+        p->children[c] = child;
+        if (child != nullptr) {
+            parent[child] = p;
+            child->index = c;
+        }
+    }
+
+    // a split 4-node is replaced by new nodes, its slot can be handed out again
+    void _destroy(node* t) {
+        parent.erase(t);
+        _pool.destroy(t);
+    }
 
   public:
     /**
@@ -49,6 +79,40 @@ template <typename T> class ttf_tree {
         }
     }
 
+    /**
+     * @brief Copy constructor for 234-tree class
+     * @param t the tree we want to copy
+     */
+    explicit ttf_tree(const ttf_tree& t) { root = _copy(t.root, nullptr); }
+
+    /**
+     * @brief operator = for 234-tree class
+     * @param t the tree we want to copy
+     * @return ttf_tree&
+     */
+    ttf_tree& operator=(const ttf_tree& t) {
+        if (this != &t) {
+            clear();
+            root = _copy(t.root, nullptr);
+        }
+        return *this;
+    }
+
+    ~ttf_tree() { clear(); }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        _pool.clear(root, [](node* n, auto visit) {
+            for (node* c : n->children) {
+                visit(c);
+            }
+        });
+        root = nullptr;
+        parent.clear();
+    }
+
     /**
      * @brief search function
      * @param key the element we want to search
@@ -70,6 +134,13 @@ template <typename T> class ttf_tree {
      */
     std::vector<std::vector<std::vector<T>>> level_order() const;
 
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the keys, the nodes with their key and child vectors, the
+     * tree with its table of parents, and the spare room of the vectors and of the pool
+     */
+    MEMORY::footprint memory_usage() const;
+
     /**
      * @brief operator << for ttf_tree class
      */
@@ -93,15 +164,15 @@ template <typename T> class ttf_tree {
 };
 
 template <typename T> inline void ttf_tree<T>::insert(const T& key) {
-    std::vector<std::shared_ptr<node>> null_children(4, nullptr);
+    std::vector<node*> null_children(4, nullptr);
     if (root == nullptr) {
-        std::vector<int> keys = {key};
-        root = std::make_shared<node>(keys, null_children, 2);
+        std::vector<T> keys = {key};
+        root = _pool.create(keys, null_children, 2);
         root->index = 0;
         parent[root] = nullptr;
         return;
     } else {
-        std::shared_ptr<node> head = root;
+        node* head = root;
         while (head != nullptr) {
             if (head->numChildren == 2) { // case for 2-node
                 if (head->children[0] == nullptr && head->children[1] == nullptr) {
@@ -133,30 +204,31 @@ template <typename T> inline void ttf_tree<T>::insert(const T& key) {
                     head = head->children[2];
                 }
             } else { // case for 4-node
-                std::shared_ptr<node> parent_node = parent[head];
+                node* parent_node = parent[head];
                 if (parent_node == nullptr) {
                     if (head->numChildren == 2 || head->numChildren == 3) {
-                        std::shared_ptr<node> saved_root = head;
+                        node* saved_root = head;
                         std::vector<T> passed_keys = {saved_root->keys[1]};
-                        root = std::make_shared<node>(passed_keys, null_children, 2);
+                        root = _pool.create(passed_keys, null_children, 2);
                         passed_keys = {saved_root->keys[0]};
-                        root->children[0] = std::make_shared<node>(passed_keys, null_children, 2);
+                        root->children[0] = _pool.create(passed_keys, null_children, 2);
                         root->children[0]->index = 0;
                         parent[root->children[0]] = root;
                         passed_keys = {saved_root->keys[2]};
-                        root->children[1] = std::make_shared<node>(passed_keys, null_children, 2);
+                        root->children[1] = _pool.create(passed_keys, null_children, 2);
                         root->children[1]->index = 1;
                         parent[root->children[1]] = root;
+                        _destroy(saved_root);
                         head = root;
                     } else {
-                        std::shared_ptr<node> saved_root = head;
+                        node* saved_root = head;
                         std::vector<T> passed_keys = {saved_root->keys[1]};
-                        root = std::make_shared<node>(passed_keys, null_children, 2);
+                        root = _pool.create(passed_keys, null_children, 2);
                         passed_keys = {saved_root->keys[0]};
-                        root->children[0] = std::make_shared<node>(passed_keys, null_children, 2);
+                        root->children[0] = _pool.create(passed_keys, null_children, 2);
                         parent[root->children[0]] = root;
                         passed_keys = {saved_root->keys[2]};
-                        root->children[1] = std::make_shared<node>(passed_keys, null_children, 2);
+                        root->children[1] = _pool.create(passed_keys, null_children, 2);
                         parent[root->children[1]] = root;
                         root->children[0]->children[0] = saved_root->children[0];
                         parent[root->children[0]->children[0]] = root->children[0];
@@ -166,6 +238,7 @@ template <typename T> inline void ttf_tree<T>::insert(const T& key) {
                         parent[root->children[1]->children[0]] = root->children[1];
                         root->children[1]->children[1] = saved_root->children[3];
                         parent[root->children[1]->children[1]] = root->children[1];
+                        _destroy(saved_root);
                         head = root;
                     }
                 } else if (parent_node->numChildren == 2) {
@@ -180,14 +253,19 @@ template <typename T> inline void ttf_tree<T>::insert(const T& key) {
                     }
                     std::vector<T> passed_keys = {saved_keys[0]};
                     parent_node->children[curr_index] =
-                        std::make_shared<node>(passed_keys, null_children, 2);
+                        _pool.create(passed_keys, null_children, 2);
                     parent[parent_node->children[curr_index]] = parent_node;
                     parent_node->children[curr_index]->index = curr_index;
                     passed_keys = {saved_keys[2]};
                     parent_node->children[curr_index + 1] =
-                        std::make_shared<node>(passed_keys, null_children, 2);
+                        _pool.create(passed_keys, null_children, 2);
                     parent[parent_node->children[curr_index + 1]] = parent_node;
                     parent_node->children[curr_index + 1]->index = curr_index + 1;
+                    for (int c = 0; c < 2; c++) {
+                        _adopt(parent_node->children[curr_index], c, head->children[c]);
+                        _adopt(parent_node->children[curr_index + 1], c, head->children[c + 2]);
+                    }
+                    _destroy(head);
                     head = parent_node;
                 } else if (parent_node->numChildren == 3) {
                     int curr_index = head->index;
@@ -206,14 +284,19 @@ template <typename T> inline void ttf_tree<T>::insert(const T& key) {
                     }
                     std::vector<T> passed_keys = {saved_keys[0]};
                     parent_node->children[curr_index] =
-                        std::make_shared<node>(passed_keys, null_children, 2);
+                        _pool.create(passed_keys, null_children, 2);
                     parent_node->children[curr_index]->index = curr_index;
                     parent[parent_node->children[curr_index]] = parent_node;
                     passed_keys = {saved_keys[2]};
                     parent_node->children[curr_index + 1] =
-                        std::make_shared<node>(passed_keys, null_children, 2);
+                        _pool.create(passed_keys, null_children, 2);
                     parent[parent_node->children[curr_index + 1]] = parent_node;
                     parent_node->children[curr_index + 1]->index = curr_index + 1;
+                    for (int c = 0; c < 2; c++) {
+                        _adopt(parent_node->children[curr_index], c, head->children[c]);
+                        _adopt(parent_node->children[curr_index + 1], c, head->children[c + 2]);
+                    }
+                    _destroy(head);
                     if (key == parent_node->keys[0] || key == parent_node->keys[1] ||
                         key == parent_node->keys[2]) {
                         return;
@@ -232,15 +315,40 @@ template <typename T> inline void ttf_tree<T>::insert(const T& key) {
     }
 }
 
+template <typename T> inline MEMORY::footprint ttf_tree<T>::memory_usage() const {
+    MEMORY::footprint f = _pool.memory_usage(0);
+    std::vector<const node*> stack;
+    if (root != nullptr) {
+        stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        const node* n = stack.back();
+        stack.pop_back();
+        MEMORY::footprint keys = MEMORY::memory_usage(n->keys);
+        // the vector objects are in the slot, already counted
+        f.payload += keys.payload;
+        f.slack += keys.slack;
+        f.node_overhead += keys.control - sizeof(n->keys) +
+                           MEMORY::memory_usage(n->children).total() - sizeof(n->children);
+        for (const node* c : n->children) {
+            if (c != nullptr) {
+                stack.push_back(c);
+            }
+        }
+    }
+    f.control += sizeof(*this) + MEMORY::memory_usage(parent).total() - sizeof(parent);
+    return f;
+}
+
 template <typename T> inline bool ttf_tree<T>::search(const T& key) const {
-    std::shared_ptr<node> head = root;
+    node* head = root;
     while (head != nullptr) {
         if (head->numChildren == 2) { // case for 2-node
-            if (key == head->keys[0] || key == head->keys[1]) {
+            if (key == head->keys[0]) {
                 return true;
             } else if (key < head->keys[0]) {
                 head = head->children[0];
-            } else if (key > head->keys[1]) {
+            } else {
                 head = head->children[1];
             }
         } else if (head->numChildren == 3) { // case for 3-node
@@ -273,7 +381,7 @@ template <typename T> inline bool ttf_tree<T>::search(const T& key) const {
 template <typename T>
 inline std::vector<std::vector<std::vector<T>>> ttf_tree<T>::level_order() const {
     std::vector<std::vector<std::vector<T>>> level_ordered;
-    std::queue<std::shared_ptr<node>> q;
+    std::queue<node*> q;
     q.push(root);
     while (!q.empty()) {
         std::vector<std::vector<T>> line;
@@ -0,0 +1,378 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+/**
+ * @brief a match of aho_corasick: the id of the pattern(its index in the constructor) and
+ * the position the match starts at
+ */
+struct aho_corasick_match {
+    size_t pattern;
+    size_t position;
+
+    bool operator==(const aho_corasick_match&) const = default;
+};
+
+/**
+ * @brief aho corasick class
+ * Immutable automaton that finds every occurrence of many patterns in one pass over a
+ * text. The trie of the patterns is stored in a double array(as double_array_trie: state
+ * s moves on the byte c to t = base[s] + c + 1 when check[t] == s), the root has a dense
+ * table of all 256 bytes so that the scan never walks a failure chain there, every state
+ * has a failure link to its longest proper suffix in the trie and an output link to the
+ * nearest state along the failure chain where a pattern ends, so overlapping matches are
+ * reported without walking the failure chain.
+ */
+class aho_corasick {
+  public:
+    /**
+     * @brief Construct a new aho corasick object
+     * @param patterns: the patterns, the id of a pattern is its index. Duplicates are
+     * reported under each id.
+     * Throws std::invalid_argument if a pattern is empty and std::length_error if the
+     * arrays would outgrow int32 indexes.
+     */
+    inline explicit aho_corasick(const std::vector<std::string>& patterns = {}) {
+        _build(patterns);
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of patterns.
+     */
+    inline size_t size() const { return _length.size(); }
+
+    /**
+     * @brief states function
+     * @return size_t the number of states of the automaton, the root included.
+     */
+    inline size_t states() const { return _states; }
+
+    /**
+     * @brief bytes function
+     * @return size_t the memory used by the automaton.
+     */
+    inline size_t bytes() const {
+        return (_base.capacity() + _check.capacity() + _fail.capacity() + _out.capacity() +
+                _dict.capacity() + _next_id.capacity()) *
+                   sizeof(int32_t) +
+               _length.capacity() * sizeof(size_t) + sizeof(_root);
+    }
+
+    /**
+     * @brief length function
+     * @param id: a pattern id.
+     * @return size_t the length of the pattern.
+     */
+    inline size_t length(size_t id) const { return _length[id]; }
+
+    /**
+     * @brief scan function, the step every search is built on
+     * @param text: the next bytes of the text.
+     * @param state: the state at the end of the previous bytes, 0 at the start of a text.
+     * @param found: called with the pattern id and the position in text right after every
+     * match, the scan stops as soon as it returns false.
+     * @return int32_t the state at the end of text(or at the match that stopped the scan),
+     * to carry into the next bytes.
+     */
+    template <typename F> int32_t scan(std::string_view text, int32_t state, F&& found) const {
+        int32_t s = state;
+        for (size_t j = 0; j < text.size(); j++) {
+            int32_t c = int32_t(static_cast<unsigned char>(text[j])) + 1, t;
+            while (s != 0 && (t = _next(s, c)) < 0) {
+                s = _fail[s];
+            }
+            s = s == 0 ? _root[c - 1] : t;
+            for (int32_t u = _out[s] >= 0 ? s : _dict[s]; u >= 0; u = _dict[u]) {
+                for (int32_t id = _out[u]; id >= 0; id = _next_id[id]) {
+                    if (!found(size_t(id), j + 1)) {
+                        return s;
+                    }
+                }
+            }
+        }
+        return s;
+    }
+
+    /**
+     * @brief find_all function
+     * @param text: the text to search.
+     * @return vector<aho_corasick_match> every match, ordered by the position it ends at,
+     * the longest first for the matches that end at the same position.
+     */
+    inline std::vector<aho_corasick_match> find_all(std::string_view text) const {
+        std::vector<aho_corasick_match> matches;
+        scan(text, 0, [&](size_t id, size_t end) {
+            matches.push_back({id, end - _length[id]});
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief contains_any function
+     * @param text: the text to search.
+     * @return true if any pattern occurs in text.
+     */
+    inline bool contains_any(std::string_view text) const {
+        bool any = false;
+        scan(text, 0, [&](size_t, size_t) {
+            any = true;
+            return false;
+        });
+        return any;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the ids and lengths of the patterns, the transitions, failure and
+     * output links of the states as node overhead, the object with the dense root and the
+     * headers of the arrays, and their spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_next_id) + MEMORY::heap_usage(_length);
+        for (const std::vector<int32_t>* v : {&_base, &_check, &_fail, &_out, &_dict}) {
+            f += MEMORY::as_overhead(MEMORY::heap_usage(*v));
+        }
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    // the dense transitions of the root, 0 for the bytes that start no pattern
+    int32_t _root[256]{};
+    std::vector<int32_t> _base;
+    // the parent of every used cell, -1 for the free ones
+    std::vector<int32_t> _check;
+    std::vector<int32_t> _fail;
+    // the first pattern that ends at a state, -1 if none, more through _next_id
+    std::vector<int32_t> _out;
+    // the nearest state along the failure chain that has _out, -1 if none
+    std::vector<int32_t> _dict;
+    std::vector<int32_t> _next_id;
+    std::vector<size_t> _length;
+    size_t _states{0};
+
+    int32_t _next(int32_t s, int32_t c) const {
+        size_t t = size_t(_base[s] + c);
+        return t < _check.size() && _check[t] == s ? int32_t(t) : -1;
+    }
+
+    // the transition of the automaton from s on c, following the failure links
+    int32_t _go(int32_t s, int32_t c) const {
+        int32_t t;
+        while (s != 0 && (t = _next(s, c)) < 0) {
+            s = _fail[s];
+        }
+        return s == 0 ? _root[c - 1] : t;
+    }
+
+    void _grow(size_t n) {
+        if (n <= _check.size()) {
+            return;
+        }
+        if (n > size_t(INT32_MAX)) {
+            throw std::length_error("aho_corasick: too many states");
+        }
+        n = std::min(std::max(n, _check.size() * 2), size_t(INT32_MAX));
+        _base.resize(n, 0);
+        _check.resize(n, -1);
+        _fail.resize(n, 0);
+        _out.resize(n, -1);
+        _dict.resize(n, -1);
+    }
+
+    // the first fit base for codes, the search starts at the first cell that may be free
+    // and moves it forward once the cells it skipped are almost all used
+    int32_t _find_base(const std::vector<int32_t>& codes, size_t& first_free) {
+        size_t pos = std::max(first_free, size_t(codes[0])), used = 0;
+        bool moved = false;
+        for (;; pos++) {
+            _grow(pos + 1);
+            if (_check[pos] >= 0) {
+                used++;
+                continue;
+            }
+            if (!moved) {
+                first_free = pos;
+                moved = true;
+            }
+            size_t base = pos - size_t(codes[0]);
+            _grow(base + size_t(codes.back()) + 1);
+            bool fits = true;
+            for (int32_t c : codes) {
+                if (_check[base + size_t(c)] >= 0) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) {
+                if (used * 20 >= (pos - first_free + 1) * 19) {
+                    first_free = pos + 1;
+                }
+                return int32_t(base);
+            }
+        }
+    }
+
+    void _build(const std::vector<std::string>& patterns) {
+        if (patterns.size() > size_t(INT32_MAX)) {
+            throw std::length_error("aho_corasick: too many patterns");
+        }
+        std::vector<int32_t> order(patterns.size());
+        _length.resize(patterns.size());
+        _next_id.assign(patterns.size(), -1);
+        for (size_t i = 0; i < patterns.size(); i++) {
+            if (patterns[i].empty()) {
+                throw std::invalid_argument("aho_corasick: empty pattern");
+            }
+            order[i] = int32_t(i);
+            _length[i] = patterns[i].size();
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+            return patterns[a] < patterns[b];
+        });
+        auto code = [&](size_t i, size_t depth) {
+            return int32_t(static_cast<unsigned char>(patterns[order[i]][depth])) + 1;
+        };
+
+        // breadth first: the patterns order[lo, hi) share their first depth bytes and lead
+        // to state s, whose failure link is set already
+        struct item {
+            size_t lo, hi, depth;
+            int32_t s;
+        };
+        std::vector<item> queue = {{0, patterns.size(), 0, 0}};
+        std::vector<int32_t> codes;
+        std::vector<size_t> starts;
+        size_t first_free = 1;
+        _grow(257);
+        _check[0] = 0;
+        _states = 1;
+        for (size_t head = 0; head < queue.size(); head++) {
+            item it = queue[head];
+            // the patterns that end here come first in sorted order
+            size_t lo = it.lo;
+            int32_t* tail = &_out[it.s];
+            for (; lo < it.hi && patterns[order[lo]].size() == it.depth; lo++) {
+                *tail = order[lo];
+                tail = &_next_id[order[lo]];
+            }
+            if (lo == it.hi) {
+                continue;
+            }
+            codes.clear();
+            starts.clear();
+            for (size_t i = lo; i < it.hi; i++) {
+                int32_t c = code(i, it.depth);
+                if (codes.empty() || codes.back() != c) {
+                    codes.push_back(c);
+                    starts.push_back(i);
+                }
+            }
+            starts.push_back(it.hi);
+            int32_t base = _find_base(codes, first_free);
+            _base[it.s] = base;
+            for (size_t g = 0; g < codes.size(); g++) {
+                int32_t t = base + codes[g];
+                _check[t] = it.s;
+                if (it.s == 0) {
+                    _root[codes[g] - 1] = t;
+                } else {
+                    _fail[t] = _go(_fail[it.s], codes[g]);
+                }
+                queue.push_back({starts[g], starts[g + 1], it.depth + 1, t});
+            }
+            _states += codes.size();
+        }
+        // the failure link of a state is shallower, so it is done first in breadth first
+        // order, and so is its output link
+        for (size_t i = 1; i < queue.size(); i++) {
+            int32_t t = queue[i].s, f = _fail[t];
+            _dict[t] = _out[f] >= 0 ? f : _dict[f];
+        }
+        // the free cells past the last used one are not needed
+        size_t end = _check.size();
+        while (end > 1 && _check[end - 1] < 0) {
+            end--;
+        }
+        for (std::vector<int32_t>* v : {&_base, &_check, &_fail, &_out, &_dict}) {
+            v->resize(end);
+            v->shrink_to_fit();
+        }
+    }
+};
+
+/**
+ * @brief aho corasick stream class
+ * Matches the patterns of an automaton against a text that arrives in successive chunks,
+ * only the state of the automaton is carried across chunks, so matches that straddle a
+ * boundary are found and every match is reported by its offset in the whole stream. The
+ * automaton must outlive the stream.
+ */
+class aho_corasick_stream {
+  public:
+    /**
+     * @brief Construct a new aho corasick stream object
+     * @param automaton: the patterns to match.
+     */
+    inline explicit aho_corasick_stream(const aho_corasick& automaton) : _ac(automaton) {}
+
+    /**
+     * @brief feed function
+     * @param chunk: the next bytes of the stream.
+     * @param found: called with every match that ends in chunk, as an aho_corasick_match
+     * whose position is an offset in the whole stream.
+     */
+    template <typename F> void feed(std::string_view chunk, F&& found) {
+        const size_t base = _offset;
+        _state = _ac.scan(chunk, _state, [&](size_t id, size_t end) {
+            found(aho_corasick_match{id, base + end - _ac.length(id)});
+            return true;
+        });
+        _offset += chunk.size();
+    }
+
+    /**
+     * @brief feed function
+     * @param chunk: the next bytes of the stream.
+     * @return vector<aho_corasick_match> the matches that end in chunk.
+     */
+    inline std::vector<aho_corasick_match> feed(std::string_view chunk) {
+        std::vector<aho_corasick_match> matches;
+        feed(chunk, [&](const aho_corasick_match& m) { matches.push_back(m); });
+        return matches;
+    }
+
+    /**
+     * @brief offset function
+     * @return size_t the number of bytes fed since the stream started.
+     */
+    inline size_t offset() const { return _offset; }
+
+    /**
+     * @brief reset function
+     * Starts a new stream.
+     */
+    inline void reset() {
+        _state = 0;
+        _offset = 0;
+    }
+
+  private:
+    const aho_corasick& _ac;
+    int32_t _state{0};
+    size_t _offset{0};
+};
+
+#endif
@@ -1,20 +1,32 @@
 #ifndef AVL_TREE_H
 #define AVL_TREE_H
 
+#include "../../helpers/archive.h"
+#include "../../helpers/node_pool.h"
+#include "../../helpers/tree_path.h"
+#include "frozen_set.h"
+
 #ifdef ENABLE_TREE_VISUALIZATION
 #include "../../visualization/tree_visual/tree_visualization.h"
 #endif
 
 #ifdef __cplusplus
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <queue>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 #endif
 
 /**
  *@brief Class for AVL tree.
+ *Every node keeps its height and the size of its subtree. The trees that split from each
+ *other share one node pool, so split and join move no nodes, and such trees must not be
+ *modified from different threads at the same time.
  */
 template <typename T> class avl_tree {
   public:
@@ -22,8 +34,13 @@ template <typename T> class avl_tree {
      *@brief Contructor for AVL tree class.
      *@param __elements: you can directly pass a vector<T> so you don't have to do
      *insert multiple times.
+     *@param resource: the memory resource the nodes and their pool come from. Default =
+     *std::pmr::get_default_resource()
      */
-    inline explicit avl_tree(std::vector<T> _elements = {}) noexcept : root(nullptr) {
+    inline explicit avl_tree(std::vector<T> _elements = {},
+                             std::pmr::memory_resource* resource =
+                                 std::pmr::get_default_resource()) noexcept
+        : _resource(resource), root(nullptr) {
         if (!_elements.empty()) {
             for (T& x : _elements) {
                 this->insert(x);
@@ -35,7 +52,15 @@ template <typename T> class avl_tree {
      * @brief Copy constructor for avl tree class
      * @param a the tree we want to copy
      */
-    inline explicit avl_tree(const avl_tree& a) : root(a.root), _size(a._size) {}
+    inline explicit avl_tree(const avl_tree& a) : root(_copy(a.root)) {}
+
+    /**
+     * @brief Move constructor for avl tree class
+     * @param a the tree we want to move, it is left empty
+     */
+    inline avl_tree(avl_tree&& a) noexcept
+        : _resource(a._resource), _pool(std::move(a._pool)),
+          root(std::exchange(a.root, nullptr)) {}
 
     /**
      * @brief operator = for avl tree class
@@ -43,34 +68,168 @@ template <typename T> class avl_tree {
      * @return avl_tree&
      */
     inline avl_tree& operator=(const avl_tree& a) {
-        root = a.root;
-        _size = a._size;
+        if (this != &a) {
+            clear();
+            root = _copy(a.root);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief move assignment for avl tree class
+     * @param a the tree we want to move, it is left empty
+     * @return avl_tree&
+     */
+    inline avl_tree& operator=(avl_tree&& a) noexcept {
+        if (this != &a) {
+            clear();
+            _resource = a._resource;
+            _pool = std::move(a._pool);
+            root = std::exchange(a.root, nullptr);
+        }
         return *this;
     }
 
+    /**
+     * @brief from_sorted function
+     * Builds a perfectly balanced tree in O(n).
+     * @param sorted: the elements in non decreasing order, the duplicates are dropped
+     * like insert does.
+     * @return avl_tree the new tree
+     * Throws std::invalid_argument if the elements are not sorted.
+     */
+    static avl_tree from_sorted(const std::vector<T>& sorted) {
+        std::vector<T> keys;
+        keys.reserve(sorted.size());
+        for (const T& x : sorted) {
+            if (!keys.empty() && x < keys.back()) {
+                throw std::invalid_argument("avl_tree::from_sorted: elements are not sorted");
+            }
+            if (keys.empty() || keys.back() < x) {
+                keys.push_back(x);
+            }
+        }
+        avl_tree t;
+        t._nodes().reserve(keys.size());
+        t.root = t._build(keys, 0, keys.size());
+        return t;
+    }
+
+    /**
+     * @brief save_archive function
+     * Writes the elements in order as a sorted_keys archive, which sorted_archive queries in place
+     * and load_archive turns back into a tree.
+     * @param path: the output file, overwritten.
+     * Throws std::runtime_error if the file can not be written.
+     */
+    inline void save_archive(const std::string& path) const {
+        save_sorted_archive(inorder(), path);
+    }
+
+    /**
+     * @brief load_archive function
+     * Builds the tree of an archive with from_sorted in O(n), instead of n inserts.
+     * @param path: a file written by save_archive.
+     * @return avl_tree the tree
+     * Throws std::runtime_error like archive_view.
+     */
+    static avl_tree load_archive(const std::string& path) {
+        return from_sorted(sorted_archive<T>(path).keys());
+    }
+
+    /**
+     * @brief freeze function
+     * Copies the elements into an immutable implicit search tree, for the sets that are read
+     * far more often than they change.
+     * @param layout: the layout of the frozen tree. Default = frozen_layout::eytzinger
+     * @return frozen_set<T> the elements of the tree
+     */
+    frozen_set<T> freeze(frozen_layout layout = frozen_layout::eytzinger) const {
+        const std::vector<T> sorted = inorder();
+        return frozen_set<T>(sorted, layout);
+    }
+
+    /**
+     * @brief join function
+     * Appends every element of right in O(log n), right is left empty. O(|right|) instead
+     * if right shares its node pool with a third tree.
+     * @param right: a tree whose elements are all larger than the elements of this tree.
+     * Throws std::invalid_argument if they are not.
+     */
+    inline void join(avl_tree& right) {
+        if (&right == this || right.root == nullptr) {
+            return;
+        }
+        if (root != nullptr && !(_max(root)->info < _min(right.root)->info)) {
+            throw std::invalid_argument("avl_tree::join: the right tree has smaller elements");
+        }
+        node* r = _take(right);
+        node* mid = nullptr;
+        r = _detach_min(r, mid);
+        root = _join(root, mid, r);
+    }
+
+    /**
+     * @brief split function
+     * Moves the elements that are not smaller than key to a new tree in O(log n), the new
+     * tree shares the node pool of this one.
+     * @param key: the first key of the new tree.
+     * @return avl_tree the elements >= key
+     */
+    inline avl_tree split(const T& key) {
+        avl_tree right({}, _resource);
+        if (root == nullptr) {
+            return right;
+        }
+        node *l, *eq, *r;
+        _split(root, key, l, eq, r);
+        root = l;
+        right._pool = _pool;
+        right.root = eq ? _join(nullptr, eq, r) : r;
+        return right;
+    }
+
+    /**
+     * @brief merge function
+     * Moves every element of other to this tree in O(m log(n / m + 1)) for trees of sizes
+     * n and m <= n(splits and joins instead of m inserts), other is left empty.
+     * @param other: the tree we want to merge, its elements may interleave with ours.
+     */
+    inline void merge(avl_tree& other) {
+        if (&other == this || other.root == nullptr) {
+            return;
+        }
+        node* r = _take(other);
+        root = _union(root, r);
+    }
+
     /**
      * @brief Destroy the avl tree object
      *
      */
-    inline ~avl_tree() noexcept {}
+    inline ~avl_tree() noexcept { clear(); }
 
     /**
      *@brief insert function.
      *@param key: key to be inserted.
      */
-    inline void insert(T key) {
-        root = _insert(root, key);
-        _size++;
-    }
+    inline void insert(T key) { root = _insert(root, key); }
 
     /**
      *@brief clear function
      *Erase all the nodes from the tree.
      */
     inline void clear() {
+        if (_pool.use_count() == 1) {
+            _pool->clear(root, [](node* n, auto visit) {
+                visit(n->left);
+                visit(n->right);
+            });
+        } else if (_pool) {
+            // the other trees of the pool keep their nodes
+            _destroy(root);
+        }
         root = nullptr;
-        _size = 0;
-        return;
     }
 
     /**
@@ -94,9 +253,10 @@ template <typename T> class avl_tree {
      *
      * @return Iterator
      */
-    inline Iterator begin() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(0, ino);
+    inline Iterator begin() const {
+        tree_path<node> path(root);
+        path.first();
+        return Iterator(path);
     }
 
     /**
@@ -104,9 +264,83 @@ template <typename T> class avl_tree {
      *
      * @return Iterator
      */
-    inline Iterator end() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(ino.size(), ino);
+    inline Iterator end() const { return Iterator(tree_path<node>(root)); }
+
+    /**
+     * @brief rank function
+     * @param key: the key we want to rank.
+     * @return size_t the number of elements smaller than key, in O(log n).
+     */
+    inline size_t rank(const T& key) const { return _rank(key, false); }
+
+    /**
+     * @brief select function
+     * @param k: the position in sorted order, starting from 0.
+     * @return const T& the k-th smallest element, in O(log n).
+     * Throws std::out_of_range if k >= size().
+     */
+    inline const T& select(size_t k) const {
+        if (k >= count(root)) {
+            throw std::out_of_range("avl_tree::select: k is out of range");
+        }
+        node* t = root;
+        while (count(t->left) != k) {
+            if (k < count(t->left)) {
+                t = t->left;
+            } else {
+                k -= count(t->left) + 1;
+                t = t->right;
+            }
+        }
+        return t->info;
+    }
+
+    /**
+     * @brief lower_bound function
+     * @param key: the key we want to search.
+     * @return Iterator to the first element that is not smaller than key, end() if none.
+     */
+    inline Iterator lower_bound(const T& key) const {
+        tree_path<node> path(root);
+        path.seek([&](const node* t) { return !(t->info < key); });
+        return Iterator(path);
+    }
+
+    /**
+     * @brief upper_bound function
+     * @param key: the key we want to search.
+     * @return Iterator to the first element that is greater than key, end() if none.
+     */
+    inline Iterator upper_bound(const T& key) const {
+        tree_path<node> path(root);
+        path.seek([&](const node* t) { return key < t->info; });
+        return Iterator(path);
+    }
+
+    /**
+     * @brief range_count function
+     * @param lo: the smallest key of the range.
+     * @param hi: the largest key of the range.
+     * @return size_t the number of elements in [lo, hi], in O(log n).
+     */
+    inline size_t range_count(const T& lo, const T& hi) const {
+        if (hi < lo) {
+            return 0;
+        }
+        return _rank(hi, true) - _rank(lo, false);
+    }
+
+    /**
+     * @brief range function
+     * Visits the elements in [lo, hi] in order, in O(log n + k) for k elements.
+     * @param lo: the smallest key of the range.
+     * @param hi: the largest key of the range.
+     * @param visit: called with every element of the range.
+     */
+    template <typename Visit> void range(const T& lo, const T& hi, Visit visit) const {
+        for (Iterator it = lower_bound(lo); it != end() && !(hi < *it); ++it) {
+            visit(*it);
+        }
     }
 
     /**
@@ -114,7 +348,38 @@ template <typename T> class avl_tree {
      *
      * @return size_t the size of the tree
      */
-    inline size_t size() const { return _size; }
+    inline size_t size() const { return count(root); }
+
+    /**
+     * @brief resource function
+     *
+     * @return std::pmr::memory_resource* the resource the nodes come from
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the elements, the heights, sizes and links of the nodes, the
+     * tree and its pool, and the free slots of the pool. The trees split from each other share
+     * their pool, and each of them counts all of it.
+     */
+    MEMORY::footprint memory_usage() const {
+        size_t owned = MEMORY::owned(
+            root,
+            [](const node* n, auto visit) {
+                visit(n->left);
+                visit(n->right);
+            },
+            [](const node* n) -> const T& { return n->info; });
+        MEMORY::footprint f;
+        if (_pool) {
+            f = _pool->memory_usage(sizeof(T), owned);
+            f.control += sizeof(node_pool<node>) + MEMORY::SHARED_CONTROL +
+                         MEMORY::ALLOCATION_OVERHEAD;
+        }
+        f.control += sizeof(*this);
+        return f;
+    }
 
     /**
      *@brief remove function.
@@ -128,7 +393,7 @@ template <typename T> class avl_tree {
      */
     inline std::vector<T> inorder() const {
         std::vector<T> path;
-        _inorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); }, root);
+        _inorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
     /**
@@ -137,8 +402,7 @@ template <typename T> class avl_tree {
     */
     inline std::vector<T> preorder() const {
         std::vector<T> path;
-        _preorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                  root);
+        _preorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
     /**
@@ -147,8 +411,7 @@ template <typename T> class avl_tree {
      */
     inline std::vector<T> postorder() const {
         std::vector<T> path;
-        _postorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                   root);
+        _postorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -158,13 +421,13 @@ template <typename T> class avl_tree {
      */
     inline std::vector<std::vector<T>> level_order() {
         std::vector<std::vector<T>> path;
-        std::queue<std::shared_ptr<node>> q;
+        std::queue<node*> q;
         q.push(root);
         while (!q.empty()) {
             size_t size = q.size();
             std::vector<T> level;
             for (size_t i = 0; i < size; i++) {
-                std::shared_ptr<node> current = q.front();
+                node* current = q.front();
                 q.pop();
                 level.push_back(current->info);
                 if (current->left) {
@@ -211,69 +474,115 @@ template <typename T> class avl_tree {
      *@brief Struct for the node type pointer.
      *@param info: the value of the node.
      *@param height: height of each node.
+     *@param size: the number of nodes of its subtree.
      *@param left: pointer to the left.
      *@param right: pointer to the right.
      */
     typedef struct node {
         T info;
-        int64_t height{0};
-        std::shared_ptr<node> left;
-        std::shared_ptr<node> right;
+        int64_t height{1};
+        size_t size{1};
+        node* left;
+        node* right;
         node(T key) : info(key), left(nullptr), right(nullptr) {}
     } node;
 
-    std::shared_ptr<node> root;
-    size_t _size{};
+    // declared before root, the copy constructor fills root from the pool. Shared by
+    // the trees split from each other, created on the first insertion
+    std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
+    std::shared_ptr<node_pool<node>> _pool;
+    node* root{nullptr};
 
-    int64_t height(std::shared_ptr<node> root) {
-        if (root == nullptr)
-            return 0;
-        return 1 + std::max(height(root->left), height(root->right));
+    node_pool<node>& _nodes() {
+        if (!_pool) {
+            _pool = std::allocate_shared<node_pool<node>>(
+                std::pmr::polymorphic_allocator<node_pool<node>>(_resource), _resource);
+        }
+        return *_pool;
     }
 
-    std::shared_ptr<node> createNode(T info) {
-        std::shared_ptr<node> nn = std::make_shared<node>(info);
+    static int64_t height(node* root) { return root ? root->height : 0; }
+
+    static size_t count(node* root) { return root ? root->size : 0; }
+
+    // the number of elements smaller than key, or not greater than key if inclusive
+    size_t _rank(const T& key, bool inclusive) const {
+        size_t r = 0;
+        for (node* t = root; t != nullptr;) {
+            if (t->info < key || (inclusive && !(key < t->info))) {
+                r += count(t->left) + 1;
+                t = t->right;
+            } else {
+                t = t->left;
+            }
+        }
+        return r;
+    }
+
+    static void _update(node* root) {
+        root->height = 1 + std::max(height(root->left), height(root->right));
+        root->size = 1 + count(root->left) + count(root->right);
+    }
+
+    node* createNode(T info) { return _nodes().create(info); }
+
+    node* _copy(const node* t) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        node* nn = createNode(t->info);
+        nn->height = t->height;
+        nn->size = t->size;
+        nn->left = _copy(t->left);
+        nn->right = _copy(t->right);
         return nn;
     }
 
-    int64_t getBalance(std::shared_ptr<node> root) {
-        return height(root->left) - height(root->right);
+    void _destroy(node* t) {
+        if (t) {
+            _destroy(t->left);
+            _destroy(t->right);
+            _pool->destroy(t);
+        }
+    }
+
+    node* _build(const std::vector<T>& keys, size_t lo, size_t hi) {
+        if (lo == hi) {
+            return nullptr;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        node* nn = createNode(keys[mid]);
+        nn->left = _build(keys, lo, mid);
+        nn->right = _build(keys, mid + 1, hi);
+        _update(nn);
+        return nn;
     }
 
-    std::shared_ptr<node> rightRotate(std::shared_ptr<node> root) {
-        std::shared_ptr<node> t = root->left;
-        std::shared_ptr<node> u = t->right;
+    static int64_t getBalance(node* root) { return height(root->left) - height(root->right); }
+
+    static node* rightRotate(node* root) {
+        node* t = root->left;
+        node* u = t->right;
         t->right = root;
         root->left = u;
+        _update(root);
+        _update(t);
         return t;
     }
 
-    std::shared_ptr<node> leftRotate(std::shared_ptr<node> root) {
-        std::shared_ptr<node> t = root->right;
-        std::shared_ptr<node> u = t->left;
+    static node* leftRotate(node* root) {
+        node* t = root->right;
+        node* u = t->left;
         t->left = root;
         root->right = u;
+        _update(root);
+        _update(t);
         return t;
     }
 
-    std::shared_ptr<node> minValue(std::shared_ptr<node> root) {
-        if (root->left == nullptr)
-            return root;
-        return minValue(root->left);
-    }
-
-    std::shared_ptr<node> _insert(std::shared_ptr<node> root, T item) {
-        std::shared_ptr<node> nn = createNode(item);
-        if (root == nullptr)
-            return nn;
-        if (item < root->info) {
-            root->left = _insert(root->left, item);
-        } else if (item > root->info) {
-            root->right = _insert(root->right, item);
-        } else {
-            return root;
-        }
-        int b = getBalance(root);
+    static node* _balance(node* root) {
+        _update(root);
+        int64_t b = getBalance(root);
         if (b > 1) {
             if (getBalance(root->left) < 0)
                 root->left = leftRotate(root->left);
@@ -286,7 +595,36 @@ template <typename T> class avl_tree {
         return root;
     }
 
-    std::shared_ptr<node> _remove(std::shared_ptr<node> root, T key) {
+    static node* _min(node* root) {
+        while (root->left) {
+            root = root->left;
+        }
+        return root;
+    }
+
+    static node* _max(node* root) {
+        while (root->right) {
+            root = root->right;
+        }
+        return root;
+    }
+
+    node* minValue(node* root) { return _min(root); }
+
+    node* _insert(node* root, T item) {
+        if (root == nullptr)
+            return createNode(item);
+        if (item < root->info) {
+            root->left = _insert(root->left, item);
+        } else if (item > root->info) {
+            root->right = _insert(root->right, item);
+        } else {
+            return root;
+        }
+        return _balance(root);
+    }
+
+    node* _remove(node* root, T key) {
         if (root == nullptr)
             return root;
         if (key < root->info)
@@ -296,24 +634,111 @@ template <typename T> class avl_tree {
 
         else {
             if (!root->right) {
-                std::shared_ptr<node> temp = root->left;
-                root = nullptr;
-                _size--;
+                node* temp = root->left;
+                _pool->destroy(root);
                 return temp;
             } else if (!root->left) {
-                std::shared_ptr<node> temp = root->right;
-                root = nullptr;
-                _size--;
+                node* temp = root->right;
+                _pool->destroy(root);
                 return temp;
             }
-            std::shared_ptr<node> temp = minValue(root->right);
+            node* temp = minValue(root->right);
             root->info = temp->info;
             root->right = _remove(root->right, temp->info);
         }
-        return root;
+        return _balance(root);
     }
 
-    bool _search(std::shared_ptr<node> root, T key) {
+    /**
+     * @brief takes the nodes of other into the pool of this tree, by sharing or splicing
+     * the pool when possible and by copying the nodes otherwise
+     */
+    node* _take(avl_tree& other) {
+        node* r = std::exchange(other.root, nullptr);
+        if (_pool == other._pool) {
+            return r;
+        }
+        if (!_pool) {
+            _pool = other._pool;
+        } else if (other._pool.use_count() == 1) {
+            _pool->splice(*other._pool);
+        } else {
+            other.root = r;
+            r = _copy(r);
+            other.clear();
+        }
+        return r;
+    }
+
+    /**
+     * @brief joins l < mid < r, mid is a detached node. Walks down the spine of the
+     * taller tree to a subtree of about the height of the other, O(|height(l) -
+     * height(r)| + 1).
+     */
+    static node* _join(node* l, node* mid, node* r) {
+        if (height(l) > height(r) + 1) {
+            l->right = _join(l->right, mid, r);
+            return _balance(l);
+        }
+        if (height(r) > height(l) + 1) {
+            r->left = _join(l, mid, r->left);
+            return _balance(r);
+        }
+        mid->left = l;
+        mid->right = r;
+        _update(mid);
+        return mid;
+    }
+
+    static node* _detach_min(node* root, node*& min) {
+        if (!root->left) {
+            min = root;
+            return root->right;
+        }
+        root->left = _detach_min(root->left, min);
+        return _balance(root);
+    }
+
+    /**
+     * @brief splits root into the keys smaller than key, the node equal to key if any and
+     * the larger keys
+     */
+    static void _split(node* root, const T& key, node*& l, node*& eq, node*& r) {
+        if (root == nullptr) {
+            l = eq = r = nullptr;
+            return;
+        }
+        node *left = root->left, *right = root->right, *x;
+        if (root->info < key) {
+            _split(right, key, x, eq, r);
+            l = _join(left, root, x);
+        } else if (key < root->info) {
+            _split(left, key, l, eq, x);
+            r = _join(x, root, right);
+        } else {
+            l = left;
+            eq = root;
+            r = right;
+        }
+    }
+
+    node* _union(node* a, node* b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        node *l, *eq, *r;
+        _split(b, a->info, l, eq, r);
+        if (eq) {
+            _pool->destroy(eq);
+        }
+        node *left = a->left, *right = a->right;
+        return _join(_union(left, l), a, _union(right, r));
+    }
+
+    bool _search(node* root, T key) {
         while (root) {
             if (root->info < key) {
                 root = root->right;
@@ -326,8 +751,7 @@ template <typename T> class avl_tree {
         return false;
     }
 
-    void _inorder(std::function<void(std::shared_ptr<node>)> callback,
-                  std::shared_ptr<node> root) const {
+    void _inorder(std::function<void(node*)> callback, node* root) const {
         if (root) {
             _inorder(callback, root->left);
             callback(root);
@@ -335,8 +759,7 @@ template <typename T> class avl_tree {
         }
     }
 
-    void _postorder(std::function<void(std::shared_ptr<node>)> callback,
-                    std::shared_ptr<node> root) const {
+    void _postorder(std::function<void(node*)> callback, node* root) const {
         if (root) {
             _inorder(callback, root->left);
             _inorder(callback, root->right);
@@ -344,8 +767,7 @@ template <typename T> class avl_tree {
         }
     }
 
-    void _preorder(std::function<void(std::shared_ptr<node>)> callback,
-                   std::shared_ptr<node> root) const {
+    void _preorder(std::function<void(node*)> callback, node* root) const {
         if (root) {
             callback(root);
             _inorder(callback, root->left);
@@ -358,7 +780,7 @@ template <typename T> class avl_tree {
         return _generate;
     }
 
-    std::string _inorder_gen(std::shared_ptr<node> root) {
+    std::string _inorder_gen(node* root) {
         std::string _s;
         if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
             if (root->left) {
@@ -391,31 +813,27 @@ template <typename T> class avl_tree {
 
 /**
  * @brief Iterator class
+ * Bidirectional inorder iterator that walks the tree lazily: it keeps the path from the
+ * root to the current node, each step costs O(1) amortized and nothing is copied. Any
+ * insert or remove invalidates the iterators of the tree.
  */
 template <typename T> class avl_tree<T>::Iterator {
   private:
-    std::vector<T> elements;
-    int64_t index;
+    tree_path<node> _path;
 
   public:
-    /**
-     * @brief Construct a new Iterator object
-     *
-     * @param els vector<T> - the elements in inorder fashion
-     */
-    explicit Iterator(const int64_t& index, std::vector<T>& els) noexcept
-        : index(index), elements(els) {}
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
 
     /**
-     * @brief = operator for Iterator type
+     * @brief Construct a new Iterator object
      *
-     * @param index the current index
-     * @return Iterator&
+     * @param path the path from the root to the current node
      */
-    Iterator& operator=(int64_t index) {
-        this->index = index;
-        return *(this);
-    }
+    explicit Iterator(const tree_path<node>& path) : _path(path) {}
 
     /**
      * @brief operator ++ for type Iterator
@@ -423,9 +841,7 @@ template <typename T> class avl_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator++() {
-        if (this->index < elements.size()) {
-            this->index++;
-        }
+        _path.next();
         return *(this);
     }
 
@@ -446,9 +862,7 @@ template <typename T> class avl_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator--() {
-        if (this->index > 0) {
-            this->index--;
-        }
+        _path.prev();
         return *(this);
     }
 
@@ -463,24 +877,35 @@ template <typename T> class avl_tree<T>::Iterator {
         return it;
     }
 
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both iterators point to the same node
+     */
+    bool operator==(const Iterator& it) const { return _path == it._path; }
+
     /**
      * @brief operator != for type Iterator
      *
      * @param it const Iterator
-     * @return true if the current element that exist in the index is not equal to
-     * the it.element that exist in the it.index
-     * @return false otherwise
+     * @return true if the iterators point to different nodes
      */
-    bool operator!=(const Iterator& it) {
-        return index != it.index && elements[index] != it.elements[it.index];
-    }
+    bool operator!=(const Iterator& it) const { return _path != it._path; }
 
     /**
      * @brief operator * for type Iterator
      *
-     * @return T the value of the node
+     * @return const T& the element of the current node
+     */
+    const T& operator*() const { return _path.node()->info; }
+
+    /**
+     * @brief operator -> for type Iterator
+     *
+     * @return const T* the element of the current node
      */
-    T operator*() { return elements[index]; }
+    const T* operator->() const { return &_path.node()->info; }
 };
 
 #endif
@@ -0,0 +1,752 @@
+#ifndef B_PLUS_TREE_H
+#define B_PLUS_TREE_H
+
+#include "../../helpers/node_pool.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace _b_plus_tree_utils {
+/**
+ * @brief the key arrays of the nodes are padded to a multiple of PAD keys, so the SIMD
+ * search can always load whole vectors
+ */
+constexpr uint32_t PAD = 8;
+
+constexpr uint32_t padded(uint32_t n) { return (n + PAD - 1) / PAD * PAD; }
+
+template <typename Key>
+constexpr bool simd_key =
+    std::is_integral_v<Key> && std::is_signed_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8);
+
+#if defined(__AVX2__)
+/**
+ * @brief the number of keys among the first n for which the vector comparison holds,
+ * 8 int32 or 4 int64 keys per step. The lanes past n are masked out.
+ */
+template <typename Key, bool Greater>
+inline uint32_t count_simd(const Key* keys, uint32_t n, const Key& x) {
+    constexpr uint32_t lanes = 32 / sizeof(Key);
+    const __m256i vx = sizeof(Key) == 8 ? _mm256_set1_epi64x(static_cast<int64_t>(x))
+                                        : _mm256_set1_epi32(static_cast<int32_t>(x));
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < n; i += lanes) {
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i a = Greater ? k : vx, b = Greater ? vx : k;
+        __m256i gt = sizeof(Key) == 8 ? _mm256_cmpgt_epi64(a, b) : _mm256_cmpgt_epi32(a, b);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(gt));
+        if (n - i < lanes) {
+            mask &= (1u << ((n - i) * sizeof(Key))) - 1;
+        }
+        bits += static_cast<uint32_t>(std::popcount(mask));
+    }
+    return bits / sizeof(Key);
+}
+#endif
+
+/**
+ * @brief lower bound in a sorted node: the number of keys smaller than x
+ */
+template <typename Key> inline uint32_t count_less(const Key* keys, uint32_t n, const Key& x) {
+#if defined(__AVX2__)
+    if constexpr (simd_key<Key>) {
+        return count_simd<Key, false>(keys, n, x);
+    }
+#endif
+    if constexpr (std::is_arithmetic_v<Key>) {
+        // branch free, the compiler vectorizes it for the other arithmetic types
+        uint32_t c = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            c += keys[i] < x;
+        }
+        return c;
+    } else {
+        return static_cast<uint32_t>(std::lower_bound(keys, keys + n, x) - keys);
+    }
+}
+
+/**
+ * @brief upper bound in a sorted node: the number of keys not larger than x
+ */
+template <typename Key>
+inline uint32_t count_not_greater(const Key* keys, uint32_t n, const Key& x) {
+#if defined(__AVX2__)
+    if constexpr (simd_key<Key>) {
+        return n - count_simd<Key, true>(keys, n, x);
+    }
+#endif
+    if constexpr (std::is_arithmetic_v<Key>) {
+        uint32_t c = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            c += !(x < keys[i]);
+        }
+        return c;
+    } else {
+        return static_cast<uint32_t>(std::upper_bound(keys, keys + n, x) - keys);
+    }
+}
+} // namespace _b_plus_tree_utils
+
+/**
+ * @brief B+ tree class
+ * Ordered map with the entries kept sorted in leaves of a few cache lines each, the
+ * inner nodes holding only separator keys. The fan-out follows NodeBytes, so a lookup
+ * over 200M keys touches about 6 nodes instead of the ~28 of a binary tree, and inside
+ * a node the keys are searched with AVX2 comparisons for 32 and 64 bit signed integer
+ * keys, a branch-free scan for the other arithmetic keys and a binary search
+ * otherwise. The leaves are linked in key order, so a range scan descends once and
+ * then walks the leaves. Deletion is relaxed: a leaf is only unlinked once it runs
+ * empty, so the height never grows past the one of the largest size the tree had.
+ * Nodes come from a node_pool.
+ * @tparam Key the type of the keys, ordered by operator< and default constructible.
+ * @tparam Value the type of the values, default constructible.
+ * @tparam NodeBytes the target size of a node, a few cache lines for memory resident
+ * indexes or a page. Default = 512
+ */
+template <typename Key, typename Value, size_t NodeBytes = 512> class b_plus_tree {
+  private:
+    struct _node {
+        uint32_t count{0};
+        // 0 for the leaves
+        uint32_t level{0};
+    };
+
+  public:
+    /**
+     * @brief the largest number of entries of a leaf
+     */
+    static constexpr uint32_t LEAF_CAPACITY = static_cast<uint32_t>(
+        std::max<size_t>(4, (NodeBytes - sizeof(_node) - 2 * sizeof(void*)) /
+                                (sizeof(Key) + sizeof(Value))));
+
+    /**
+     * @brief the largest number of keys of an inner node, which has one child more
+     */
+    static constexpr uint32_t INNER_CAPACITY = static_cast<uint32_t>(std::max<size_t>(
+        4, (NodeBytes - sizeof(_node) - sizeof(void*)) / (sizeof(Key) + sizeof(void*))));
+
+    class Iterator;
+
+    /**
+     * @brief Construct a new b plus tree object
+     * @param v the initializer vector, bulk loaded if its keys are strictly increasing
+     */
+    inline explicit b_plus_tree(std::vector<std::pair<Key, Value>> v = {}) {
+        auto not_increasing = [](const std::pair<Key, Value>& a,
+                                 const std::pair<Key, Value>& b) { return !(a.first < b.first); };
+        if (std::adjacent_find(v.begin(), v.end(), not_increasing) == v.end()) {
+            bulk_load(v);
+            return;
+        }
+        for (auto& x : v) {
+            insert(x.first, x.second);
+        }
+    }
+
+    /**
+     * @brief Copy constructor for b plus tree class
+     * @param t the tree we want to copy, rebuilt with full nodes
+     */
+    inline b_plus_tree(const b_plus_tree& t) { bulk_load(t._entries()); }
+
+    inline b_plus_tree(b_plus_tree&& t) noexcept { _steal(t); }
+
+    /**
+     * @brief operator = for b plus tree class
+     * @param t the tree we want to copy
+     * @return b_plus_tree&
+     */
+    inline b_plus_tree& operator=(const b_plus_tree& t) {
+        if (this != &t) {
+            bulk_load(t._entries());
+        }
+        return *this;
+    }
+
+    inline b_plus_tree& operator=(b_plus_tree&& t) noexcept {
+        if (this != &t) {
+            clear();
+            _steal(t);
+        }
+        return *this;
+    }
+
+    inline ~b_plus_tree() { clear(); }
+
+    /**
+     * @brief insert function
+     * If the key already exists its value is replaced.
+     * @param key the key to insert
+     * @param value the value of the key
+     * @return true if the key was not in the tree
+     */
+    inline bool insert(const Key& key, const Value& value) {
+        if (_root == nullptr) {
+            _leaf* l = _leaves.create();
+            _root = _first = l;
+        }
+        _inner* path[MAX_DEPTH];
+        uint32_t slot[MAX_DEPTH];
+        _leaf* l = _descend(key, path, slot);
+        uint32_t i = _b_plus_tree_utils::count_less(l->keys, l->count, key);
+        if (i < l->count && !(key < l->keys[i])) {
+            l->values[i] = value;
+            return false;
+        }
+        _size++;
+        if (l->count < LEAF_CAPACITY) {
+            _leaf_insert(l, i, key, value);
+            return true;
+        }
+        // appending past the last key keeps the full leaf full, which makes ascending
+        // inserts fill every leaf
+        uint32_t mid = i == LEAF_CAPACITY && l->next == nullptr ? LEAF_CAPACITY
+                                                                : LEAF_CAPACITY / 2;
+        _leaf* r = _leaves.create();
+        for (uint32_t j = mid; j < l->count; j++) {
+            r->keys[j - mid] = std::move(l->keys[j]);
+            r->values[j - mid] = std::move(l->values[j]);
+        }
+        r->count = l->count - mid;
+        l->count = mid;
+        r->next = l->next;
+        r->prev = l;
+        if (l->next) {
+            l->next->prev = r;
+        }
+        l->next = r;
+        if (i < mid) {
+            _leaf_insert(l, i, key, value);
+        } else {
+            _leaf_insert(r, i - mid, key, value);
+        }
+        _insert_up(path, slot, _height, r->keys[0], r);
+        return true;
+    }
+
+    /**
+     * @brief remove function
+     * @param key the key to remove
+     * @return true if the key was in the tree
+     */
+    inline bool remove(const Key& key) {
+        if (_root == nullptr) {
+            return false;
+        }
+        _inner* path[MAX_DEPTH];
+        uint32_t slot[MAX_DEPTH];
+        _leaf* l = _descend(key, path, slot);
+        uint32_t i = _b_plus_tree_utils::count_less(l->keys, l->count, key);
+        if (i == l->count || key < l->keys[i]) {
+            return false;
+        }
+        for (uint32_t j = i + 1; j < l->count; j++) {
+            l->keys[j - 1] = std::move(l->keys[j]);
+            l->values[j - 1] = std::move(l->values[j]);
+        }
+        l->count--;
+        if (--_size == 0) {
+            clear();
+            return true;
+        }
+        if (l->count == 0) {
+            _unlink(l);
+            _remove_up(path, slot, _height);
+        }
+        return true;
+    }
+
+    /**
+     * @brief find function
+     * @param key the key we want to look up
+     * @return a pointer to the value of key, nullptr if the key does not exist. The pointer
+     * is invalidated by the next insertion or removal.
+     */
+    inline Value* find(const Key& key) {
+        return const_cast<Value*>(std::as_const(*this).find(key));
+    }
+
+    inline const Value* find(const Key& key) const {
+        if (_root == nullptr) {
+            return nullptr;
+        }
+        const _leaf* l = _find_leaf(key);
+        uint32_t i = _b_plus_tree_utils::count_less(l->keys, l->count, key);
+        return i < l->count && !(key < l->keys[i]) ? &l->values[i] : nullptr;
+    }
+
+    /**
+     * @brief retrieve function
+     * @param key the key we want to look up
+     * @return the value of key, std::nullopt if the key does not exist
+     */
+    inline std::optional<Value> retrieve(const Key& key) const {
+        const Value* v = find(key);
+        return v ? std::optional<Value>(*v) : std::nullopt;
+    }
+
+    /**
+     * @brief search function
+     * @param key the key we want to look up
+     * @return true if key exists in the tree
+     */
+    inline bool search(const Key& key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief range function
+     * Visits the entries with lo <= key < hi in key order.
+     * @param lo the smallest key of the range
+     * @param hi the first key past the range
+     * @param visit called as visit(key, value) for every entry of the range
+     * @return size_t the number of visited entries
+     */
+    template <typename F> inline size_t range(const Key& lo, const Key& hi, F&& visit) const {
+        size_t visited = 0;
+        for (Iterator it = lower_bound(lo); it != end() && (*it).first < hi; ++it) {
+            visit((*it).first, (*it).second);
+            visited++;
+        }
+        return visited;
+    }
+
+    /**
+     * @brief bulk_load function
+     * Replaces the contents with strictly increasing entries in O(n), the leaves and the
+     * inner nodes are filled level by level from the left.
+     * @param sorted the entries, sorted by key without duplicates
+     * @param fill the fraction of every node to fill in (0, 1], lower values leave room
+     * for inserts without splits. Default = 1
+     * Throws std::invalid_argument if the keys are not strictly increasing or fill is out
+     * of range.
+     */
+    inline void bulk_load(const std::vector<std::pair<Key, Value>>& sorted, double fill = 1.0) {
+        if (!(fill > 0.0 && fill <= 1.0)) {
+            throw std::invalid_argument("b_plus_tree::bulk_load: fill must be in (0, 1]");
+        }
+        for (size_t i = 1; i < sorted.size(); i++) {
+            if (!(sorted[i - 1].first < sorted[i].first)) {
+                throw std::invalid_argument("b_plus_tree::bulk_load: keys are not sorted");
+            }
+        }
+        clear();
+        if (sorted.empty()) {
+            return;
+        }
+        std::vector<_node*> level;
+        std::vector<const Key*> mins;
+        size_t per = std::max<size_t>(1, static_cast<size_t>(LEAF_CAPACITY * fill));
+        size_t leaves = (sorted.size() + per - 1) / per;
+        _leaves.reserve(leaves);
+        _leaf* prev = nullptr;
+        for (size_t b = 0, at = 0; b < leaves; b++) {
+            _leaf* l = _leaves.create();
+            size_t take = _share(sorted.size(), leaves, b);
+            for (size_t j = 0; j < take; j++, at++) {
+                l->keys[j] = sorted[at].first;
+                l->values[j] = sorted[at].second;
+            }
+            l->count = static_cast<uint32_t>(take);
+            l->prev = prev;
+            if (prev) {
+                prev->next = l;
+            } else {
+                _first = l;
+            }
+            prev = l;
+            level.push_back(l);
+            mins.push_back(&l->keys[0]);
+        }
+        size_t fan = std::max<size_t>(2, static_cast<size_t>((INNER_CAPACITY + 1) * fill));
+        while (level.size() > 1) {
+            size_t groups = (level.size() + fan - 1) / fan;
+            std::vector<_node*> up;
+            std::vector<const Key*> up_mins;
+            for (size_t g = 0, at = 0; g < groups; g++) {
+                _inner* n = _inners.create();
+                n->level = level[at]->level + 1;
+                size_t take = _share(level.size(), groups, g);
+                up_mins.push_back(mins[at]);
+                for (size_t j = 0; j < take; j++, at++) {
+                    n->child[j] = level[at];
+                    if (j > 0) {
+                        n->keys[j - 1] = *mins[at];
+                    }
+                }
+                n->count = static_cast<uint32_t>(take - 1);
+                up.push_back(n);
+            }
+            level.swap(up);
+            mins.swap(up_mins);
+        }
+        _root = level[0];
+        _height = _root->level;
+        _size = sorted.size();
+    }
+
+    /**
+     * @brief clear function
+     */
+    inline void clear() {
+        _leaves.clear(_first, [](_leaf* l, auto visit) { visit(l->next); });
+        _inners.clear(_height > 0 ? static_cast<_inner*>(_root) : nullptr,
+                      [](_inner* n, auto visit) {
+                          if (n->level > 1) {
+                              for (uint32_t c = 0; c <= n->count; c++) {
+                                  visit(static_cast<_inner*>(n->child[c]));
+                              }
+                          }
+                      });
+        _root = nullptr;
+        _first = nullptr;
+        _size = 0;
+        _height = 0;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of entries
+     */
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the entries, the rest of the leaves and the inner nodes, the
+     * tree and the slab tables of its pools, and the empty entries of the leaves and the free
+     * slots of the pools
+     */
+    inline MEMORY::footprint memory_usage() const {
+        constexpr size_t ENTRY = sizeof(Key) + sizeof(Value);
+        MEMORY::footprint f = _leaves.memory_usage(0) + _inners.memory_usage(0);
+        const size_t unused = (_leaves.size() * LEAF_CAPACITY - _size) * ENTRY;
+        f.node_overhead -= _size * ENTRY + unused;
+        f.payload = _size * ENTRY;
+        f.slack += unused;
+        if constexpr (MEMORY::may_own_heap_v<Key> || MEMORY::may_own_heap_v<Value>) {
+            for (const _leaf* l = _first; l != nullptr; l = l->next) {
+                for (uint32_t i = 0; i < l->count; i++) {
+                    f.payload += MEMORY::heap_bytes(l->keys[i]) + MEMORY::heap_bytes(l->values[i]);
+                }
+            }
+        }
+        f.control += sizeof(*this);
+        return f;
+    }
+
+    /**
+     * @brief empty function
+     * @return true if the tree has no entries
+     */
+    inline bool empty() const { return _size == 0; }
+
+    /**
+     * @brief height function
+     * @return size_t the number of levels, the leaves included, 0 for an empty tree
+     */
+    inline size_t height() const { return _root ? _height + 1 : 0; }
+
+    /**
+     * @brief pointer that points to the smallest entry
+     * @return Iterator
+     */
+    inline Iterator begin() const { return Iterator(_first, 0); }
+
+    /**
+     * @brief pointer that points past the largest entry
+     * @return Iterator
+     */
+    inline Iterator end() const { return Iterator(nullptr, 0); }
+
+    /**
+     * @brief lower_bound function
+     * @param key the key we want to look up
+     * @return Iterator to the first entry whose key is not smaller than key
+     */
+    inline Iterator lower_bound(const Key& key) const {
+        if (_root == nullptr) {
+            return end();
+        }
+        const _leaf* l = _find_leaf(key);
+        return Iterator(l, _b_plus_tree_utils::count_less(l->keys, l->count, key));
+    }
+
+    /**
+     * @brief upper_bound function
+     * @param key the key we want to look up
+     * @return Iterator to the first entry whose key is larger than key
+     */
+    inline Iterator upper_bound(const Key& key) const {
+        if (_root == nullptr) {
+            return end();
+        }
+        const _leaf* l = _find_leaf(key);
+        return Iterator(l, _b_plus_tree_utils::count_not_greater(l->keys, l->count, key));
+    }
+
+  private:
+    static constexpr size_t MAX_DEPTH = 48;
+
+    struct _leaf : _node {
+        Key keys[_b_plus_tree_utils::padded(LEAF_CAPACITY)]{};
+        Value values[LEAF_CAPACITY]{};
+        _leaf* next{nullptr};
+        _leaf* prev{nullptr};
+    };
+
+    // keys[i] is the smallest key child[i + 1] may hold
+    struct _inner : _node {
+        Key keys[_b_plus_tree_utils::padded(INNER_CAPACITY)]{};
+        _node* child[INNER_CAPACITY + 1]{};
+    };
+
+    node_pool<_leaf> _leaves;
+    node_pool<_inner> _inners;
+    _node* _root{nullptr};
+    _leaf* _first{nullptr};
+    size_t _size{0};
+    // the number of inner levels
+    uint32_t _height{0};
+
+    static size_t _share(size_t n, size_t parts, size_t i) {
+        return n / parts + (i < n % parts ? 1 : 0);
+    }
+
+    const _leaf* _find_leaf(const Key& key) const {
+        const _node* n = _root;
+        while (n->level > 0) {
+            const _inner* in = static_cast<const _inner*>(n);
+            n = in->child[_b_plus_tree_utils::count_not_greater(in->keys, in->count, key)];
+        }
+        return static_cast<const _leaf*>(n);
+    }
+
+    /**
+     * @brief walks from the root to the leaf of key, path[d] and slot[d] are the inner
+     * node of depth d and the child that was taken
+     */
+    _leaf* _descend(const Key& key, _inner** path, uint32_t* slot) {
+        _node* n = _root;
+        for (uint32_t d = 0; n->level > 0; d++) {
+            _inner* in = static_cast<_inner*>(n);
+            path[d] = in;
+            slot[d] = _b_plus_tree_utils::count_not_greater(in->keys, in->count, key);
+            n = in->child[slot[d]];
+        }
+        return static_cast<_leaf*>(n);
+    }
+
+    static void _leaf_insert(_leaf* l, uint32_t i, const Key& key, const Value& value) {
+        for (uint32_t j = l->count; j > i; j--) {
+            l->keys[j] = std::move(l->keys[j - 1]);
+            l->values[j] = std::move(l->values[j - 1]);
+        }
+        l->keys[i] = key;
+        l->values[i] = value;
+        l->count++;
+    }
+
+    /**
+     * @brief adds the separator sep and the new right sibling r of the child taken at
+     * depth d - 1, splitting the full inner nodes on the way up
+     */
+    void _insert_up(_inner** path, uint32_t* slot, uint32_t d, Key sep, _node* r) {
+        while (d > 0) {
+            d--;
+            _inner* p = path[d];
+            uint32_t i = slot[d];
+            if (p->count < INNER_CAPACITY) {
+                _inner_insert(p, i, std::move(sep), r);
+                return;
+            }
+            // split around the middle key, which moves up
+            Key keys[INNER_CAPACITY + 1];
+            _node* child[INNER_CAPACITY + 2];
+            for (uint32_t j = 0, k = 0; j <= INNER_CAPACITY; j++) {
+                keys[j] = j == i ? sep : std::move(p->keys[k++]);
+            }
+            for (uint32_t j = 0, k = 0; j <= INNER_CAPACITY + 1; j++) {
+                child[j] = j == i + 1 ? r : p->child[k++];
+            }
+            uint32_t mid = (INNER_CAPACITY + 1) / 2;
+            _inner* q = _inners.create();
+            q->level = p->level;
+            p->count = mid;
+            q->count = INNER_CAPACITY - mid;
+            for (uint32_t j = 0; j < mid; j++) {
+                p->keys[j] = std::move(keys[j]);
+            }
+            for (uint32_t j = 0; j <= mid; j++) {
+                p->child[j] = child[j];
+            }
+            for (uint32_t j = 0; j < q->count; j++) {
+                q->keys[j] = std::move(keys[mid + 1 + j]);
+            }
+            for (uint32_t j = 0; j <= q->count; j++) {
+                q->child[j] = child[mid + 1 + j];
+            }
+            sep = std::move(keys[mid]);
+            r = q;
+        }
+        _inner* root = _inners.create();
+        root->level = _root->level + 1;
+        root->count = 1;
+        root->keys[0] = std::move(sep);
+        root->child[0] = _root;
+        root->child[1] = r;
+        _root = root;
+        _height++;
+    }
+
+    static void _inner_insert(_inner* p, uint32_t i, Key sep, _node* r) {
+        for (uint32_t j = p->count; j > i; j--) {
+            p->keys[j] = std::move(p->keys[j - 1]);
+            p->child[j + 1] = p->child[j];
+        }
+        p->keys[i] = std::move(sep);
+        p->child[i + 1] = r;
+        p->count++;
+    }
+
+    void _unlink(_leaf* l) {
+        if (l->prev) {
+            l->prev->next = l->next;
+        } else {
+            _first = l->next;
+        }
+        if (l->next) {
+            l->next->prev = l->prev;
+        }
+        _leaves.destroy(l);
+    }
+
+    /**
+     * @brief drops the child taken at depth d - 1, which was destroyed, and the inner
+     * nodes that lose their last child, then shortens the tree while the root has a
+     * single child
+     */
+    void _remove_up(_inner** path, uint32_t* slot, uint32_t d) {
+        while (d > 0) {
+            d--;
+            _inner* p = path[d];
+            uint32_t i = slot[d];
+            if (p->count == 0) {
+                // p had this child only
+                _inners.destroy(p);
+                continue;
+            }
+            uint32_t k = i > 0 ? i - 1 : 0;
+            for (uint32_t j = k + 1; j < p->count; j++) {
+                p->keys[j - 1] = std::move(p->keys[j]);
+            }
+            for (uint32_t j = i + 1; j <= p->count; j++) {
+                p->child[j - 1] = p->child[j];
+            }
+            p->count--;
+            break;
+        }
+        while (_root->level > 0 && _root->count == 0) {
+            _inner* old = static_cast<_inner*>(_root);
+            _root = old->child[0];
+            _inners.destroy(old);
+            _height--;
+        }
+    }
+
+    std::vector<std::pair<Key, Value>> _entries() const {
+        std::vector<std::pair<Key, Value>> v;
+        v.reserve(_size);
+        for (Iterator it = begin(); it != end(); ++it) {
+            v.emplace_back((*it).first, (*it).second);
+        }
+        return v;
+    }
+
+    void _steal(b_plus_tree& t) noexcept {
+        _leaves = std::move(t._leaves);
+        _inners = std::move(t._inners);
+        _root = std::exchange(t._root, nullptr);
+        _first = std::exchange(t._first, nullptr);
+        _size = std::exchange(t._size, 0);
+        _height = std::exchange(t._height, 0);
+    }
+};
+
+/**
+ * @brief Iterator class
+ * Forward iterator over the entries in key order, invalidated by insertions and
+ * removals.
+ */
+template <typename Key, typename Value, size_t NodeBytes>
+class b_plus_tree<Key, Value, NodeBytes>::Iterator {
+  private:
+    const _leaf* _l;
+    uint32_t _i;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<Key, Value>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key&, const Value&>;
+
+    /**
+     * @brief Construct a new Iterator object
+     * @param l the leaf, nullptr for the end
+     * @param i the position in the leaf, past the last entry moves to the next leaf
+     */
+    Iterator(const _leaf* l, uint32_t i) : _l(l), _i(i) {
+        if (_l && _i == _l->count) {
+            _l = _l->next;
+            _i = 0;
+        }
+    }
+
+    /**
+     * @brief operator ++ for type Iterator
+     *
+     * @return Iterator&
+     */
+    Iterator& operator++() {
+        if (++_i == _l->count) {
+            _l = _l->next;
+            _i = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief operator ++ for type Iterator
+     *
+     * @return Iterator
+     */
+    Iterator operator++(int) {
+        Iterator it = *this;
+        ++*(this);
+        return it;
+    }
+
+    bool operator==(const Iterator& it) const { return _l == it._l && _i == it._i; }
+
+    bool operator!=(const Iterator& it) const { return !(*this == it); }
+
+    /**
+     * @brief operator * for type Iterator
+     *
+     * @return the key and the value of the current entry
+     */
+    reference operator*() const { return {_l->keys[_i], _l->values[_i]}; }
+};
+
+#endif
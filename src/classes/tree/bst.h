@@ -1,16 +1,22 @@
 #ifndef BST_H
 #define BST_H
 
+#include "../../helpers/node_pool.h"
+#include "../../helpers/tree_path.h"
+#include "frozen_set.h"
+
 #ifdef ENABLE_TREE_VISUALIZATION
 #include "../../visualization/tree_visual/tree_visualization.h"
 #endif
 
 #ifdef __cplusplus
 #include <functional>
-#include <memory>
+#include <iterator>
 #include <queue>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #endif
 
@@ -23,8 +29,13 @@ template <typename T> class bst {
      *@brief Contructor for BST tree class.
      *@param __elements: you can directly pass a vector<T> so you don't have to do
      *insert multiple times.
+     *@param resource: the memory resource the nodes come from. Default =
+     *std::pmr::get_default_resource()
      */
-    inline explicit bst(std::vector<T> _elements = {}) noexcept : root(nullptr) {
+    inline explicit bst(std::vector<T> _elements = {},
+                        std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource()) noexcept
+        : _pool(resource), root(nullptr) {
         if (!_elements.empty()) {
             for (T& x : _elements) {
                 this->insert(x);
@@ -36,7 +47,7 @@ template <typename T> class bst {
      * @brief Copy constructor for bst class
      * @param b the tree we want to copy
      */
-    inline explicit bst(const bst& b) : root(b.root), _size(b._size) {}
+    inline explicit bst(const bst& b) : root(_copy(b.root)), _size(b._size) {}
 
     /**
      * @brief operator = for bst class
@@ -44,17 +55,79 @@ template <typename T> class bst {
      * @return bst&
      */
     inline bst& operator=(const bst& b) {
-        root = b.root;
-        _size = b._size;
+        if (this != &b) {
+            clear();
+            root = _copy(b.root);
+            _size = b._size;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move constructor for bst class
+     * @param b the tree we want to move, it is left empty
+     */
+    inline bst(bst&& b) noexcept
+        : _pool(std::move(b._pool)), root(std::exchange(b.root, nullptr)),
+          _size(std::exchange(b._size, 0)) {}
+
+    /**
+     * @brief move assignment for bst class
+     * @param b the tree we want to move, it is left empty
+     * @return bst&
+     */
+    inline bst& operator=(bst&& b) noexcept {
+        if (this != &b) {
+            clear();
+            _pool = std::move(b._pool);
+            root = std::exchange(b.root, nullptr);
+            _size = std::exchange(b._size, 0);
+        }
         return *this;
     }
 
-    inline ~bst() noexcept { root = nullptr; }
+    inline ~bst() noexcept { clear(); }
+
+    /**
+     * @brief from_sorted function
+     * Builds a perfectly balanced tree in O(n) instead of n inserts.
+     * @param sorted: the elements in non decreasing order.
+     * @return bst the new tree
+     * Throws std::invalid_argument if the elements are not sorted.
+     */
+    static bst from_sorted(const std::vector<T>& sorted) {
+        for (size_t i = 1; i < sorted.size(); i++) {
+            if (sorted[i] < sorted[i - 1]) {
+                throw std::invalid_argument("bst::from_sorted: elements are not sorted");
+            }
+        }
+        bst b;
+        b._pool.reserve(sorted.size());
+        b.root = b._build(sorted, 0, sorted.size());
+        b._size = sorted.size();
+        return b;
+    }
+
+    /**
+     * @brief freeze function
+     * Copies the elements into an immutable implicit search tree, for the sets that are read
+     * far more often than they change.
+     * @param layout: the layout of the frozen tree. Default = frozen_layout::eytzinger
+     * @return frozen_set<T> the elements of the tree
+     */
+    frozen_set<T> freeze(frozen_layout layout = frozen_layout::eytzinger) const {
+        const std::vector<T> sorted = inorder();
+        return frozen_set<T>(sorted, layout);
+    }
 
     /**
      * @brief clear function
      */
     inline void clear() {
+        _pool.clear(root, [](node* n, auto visit) {
+            visit(n->left);
+            visit(n->right);
+        });
         root = nullptr;
         _size = 0;
     }
@@ -88,9 +161,10 @@ template <typename T> class bst {
      *
      * @return Iterator
      */
-    inline Iterator begin() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(0, ino);
+    inline Iterator begin() const {
+        tree_path<node> path(root);
+        path.first();
+        return Iterator(path);
     }
 
     /**
@@ -98,10 +172,7 @@ template <typename T> class bst {
      *
      * @return Iterator
      */
-    inline Iterator end() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(ino.size(), ino);
-    }
+    inline Iterator end() const { return Iterator(tree_path<node>(root)); }
 
     /**
      * @brief size function
@@ -110,13 +181,38 @@ template <typename T> class bst {
      */
     inline size_t size() { return _size; }
 
+    /**
+     * @brief resource function
+     *
+     * @return std::pmr::memory_resource* the resource the nodes come from
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _pool.resource(); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the elements, the links of the nodes, the tree and the
+     * slab table of its pool, and the free slots of the pool
+     */
+    MEMORY::footprint memory_usage() const {
+        size_t owned = MEMORY::owned(
+            root,
+            [](const node* n, auto visit) {
+                visit(n->left);
+                visit(n->right);
+            },
+            [](const node* n) -> const T& { return n->info; });
+        MEMORY::footprint f = _pool.memory_usage(sizeof(T), owned);
+        f.control += sizeof(*this);
+        return f;
+    }
+
     /**
      *@brief inorder function.
      *@returns vector<T>, the elements inorder.
      */
-    inline std::vector<T> inorder() {
+    inline std::vector<T> inorder() const {
         std::vector<T> path;
-        _inorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); }, root);
+        _inorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -126,8 +222,7 @@ template <typename T> class bst {
      */
     inline std::vector<T> preorder() {
         std::vector<T> path;
-        _preorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                  root);
+        _preorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -137,8 +232,7 @@ template <typename T> class bst {
      */
     inline std::vector<T> postorder() {
         std::vector<T> path;
-        _postorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                   root);
+        _postorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -148,13 +242,13 @@ template <typename T> class bst {
      */
     inline std::vector<std::vector<T>> level_order() {
         std::vector<std::vector<T>> path;
-        std::queue<std::shared_ptr<node>> q;
+        std::queue<node*> q;
         q.push(root);
         while (!q.empty()) {
             size_t size = q.size();
             std::vector<T> level;
             for (size_t i = 0; i < size; i++) {
-                std::shared_ptr<node> current = q.front();
+                node* current = q.front();
                 q.pop();
                 level.push_back(current->info);
                 if (current->left) {
@@ -204,20 +298,42 @@ template <typename T> class bst {
      */
     typedef struct node {
         T info;
-        std::shared_ptr<node> right;
-        std::shared_ptr<node> left;
+        node* right;
+        node* left;
         node(T key) : info(key), right(nullptr), left(nullptr) {}
     } node;
 
-    std::shared_ptr<node> root;
+    // declared before root, the copy constructor fills root from the pool
+    node_pool<node> _pool;
+    node* root;
     size_t _size{};
 
-    std::shared_ptr<node> new_node(T& key) {
-        std::shared_ptr<node> p = std::make_shared<node>(key);
-        return p;
+    node* new_node(T& key) { return _pool.create(key); }
+
+    node* _copy(const node* t) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        node* nn = _pool.create(t->info);
+        nn->left = _copy(t->left);
+        nn->right = _copy(t->right);
+        return nn;
+    }
+
+    node* _build(const std::vector<T>& sorted, size_t lo, size_t hi) {
+        if (lo == hi) {
+            return nullptr;
+        }
+        // duplicates may land on both sides of an equal key, search and remove stop at
+        // the first one they meet
+        size_t mid = lo + (hi - lo) / 2;
+        node* nn = _pool.create(sorted[mid]);
+        nn->left = _build(sorted, lo, mid);
+        nn->right = _build(sorted, mid + 1, hi);
+        return nn;
     }
 
-    std::shared_ptr<node> _insert(std::shared_ptr<node> root, T& key) {
+    node* _insert(node* root, T& key) {
         if (!root) {
             return new_node(key);
         } else {
@@ -230,7 +346,7 @@ template <typename T> class bst {
         return root;
     }
 
-    bool _search(std::shared_ptr<node> root, T& key) {
+    bool _search(node* root, T& key) {
         while (root) {
             if (root->info < key) {
                 root = root->right;
@@ -243,7 +359,7 @@ template <typename T> class bst {
         return false;
     }
 
-    std::shared_ptr<node> _remove(std::shared_ptr<node> root, T& key) {
+    node* _remove(node* root, T& key) {
         if (!root) {
             return root;
         }
@@ -254,18 +370,21 @@ template <typename T> class bst {
             root->left = _remove(root->left, key);
         } else {
             if (!root->left && !root->right) {
+                _pool.destroy(root);
                 root = nullptr;
                 _size--;
             } else if (!root->left) {
-                std::shared_ptr<node> temp = root->right;
+                node* temp = root->right;
+                _pool.destroy(root);
                 _size--;
                 return temp;
             } else if (!root->right) {
-                std::shared_ptr<node> temp = root->left;
+                node* temp = root->left;
+                _pool.destroy(root);
                 _size--;
                 return temp;
             } else {
-                std::shared_ptr<node> temp = root->right;
+                node* temp = root->right;
                 while (temp->left) {
                     temp = temp->left;
                 }
@@ -276,7 +395,7 @@ template <typename T> class bst {
         return root;
     }
 
-    void _inorder(std::function<void(std::shared_ptr<node>)> callback, std::shared_ptr<node> root) {
+    void _inorder(std::function<void(node*)> callback, node* root) const {
         if (root) {
             _inorder(callback, root->left);
             callback(root);
@@ -284,8 +403,7 @@ template <typename T> class bst {
         }
     }
 
-    void _postorder(std::function<void(std::shared_ptr<node>)> callback,
-                    std::shared_ptr<node> root) {
+    void _postorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             _postorder(callback, root->left);
             _postorder(callback, root->right);
@@ -293,8 +411,7 @@ template <typename T> class bst {
         }
     }
 
-    void _preorder(std::function<void(std::shared_ptr<node>)> callback,
-                   std::shared_ptr<node> root) {
+    void _preorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             callback(root);
             _preorder(callback, root->left);
@@ -307,7 +424,7 @@ template <typename T> class bst {
         return _generate;
     }
 
-    std::string _inorder_gen(std::shared_ptr<node> root) {
+    std::string _inorder_gen(node* root) {
         std::string _s;
         if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
             if (root->left) {
@@ -340,31 +457,27 @@ template <typename T> class bst {
 
 /**
  * @brief Iterator class
+ * Bidirectional inorder iterator that walks the tree lazily: it keeps the path from the
+ * root to the current node, each step costs O(1) amortized and nothing is copied. Any
+ * insert or remove invalidates the iterators of the tree.
  */
 template <typename T> class bst<T>::Iterator {
   private:
-    std::vector<T> elements;
-    int64_t index;
+    tree_path<node> _path;
 
   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
     /**
      * @brief Construct a new Iterator object
      *
-     * @param els vector<T> - the elements in inorder fashion
+     * @param path the path from the root to the current node
      */
-    explicit Iterator(const int64_t& index, std::vector<T>& els) noexcept
-        : index(index), elements(els) {}
-
-    /**
-     * @brief = operator for Iterator type
-     *
-     * @param index the current index
-     * @return Iterator&
-     */
-    Iterator& operator=(int64_t index) {
-        this->index = index;
-        return *(this);
-    }
+    explicit Iterator(const tree_path<node>& path) : _path(path) {}
 
     /**
      * @brief operator ++ for type Iterator
@@ -372,9 +485,7 @@ template <typename T> class bst<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator++() {
-        if (this->index < elements.size()) {
-            this->index++;
-        }
+        _path.next();
         return *(this);
     }
 
@@ -395,9 +506,7 @@ template <typename T> class bst<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator--() {
-        if (this->index > 0) {
-            this->index--;
-        }
+        _path.prev();
         return *(this);
     }
 
@@ -412,21 +521,35 @@ template <typename T> class bst<T>::Iterator {
         return it;
     }
 
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both iterators point to the same node
+     */
+    bool operator==(const Iterator& it) const { return _path == it._path; }
+
     /**
      * @brief operator != for type Iterator
      *
      * @param it const Iterator
-     * @return true if index == it.index
-     * @return false otherwise
+     * @return true if the iterators point to different nodes
      */
-    bool operator!=(const Iterator& it) { return index != it.index; }
+    bool operator!=(const Iterator& it) const { return _path != it._path; }
 
     /**
      * @brief operator * for type Iterator
      *
-     * @return T the value of the node
+     * @return const T& the element of the current node
+     */
+    const T& operator*() const { return _path.node()->info; }
+
+    /**
+     * @brief operator -> for type Iterator
+     *
+     * @return const T* the element of the current node
      */
-    T operator*() { return elements[index]; }
+    const T* operator->() const { return &_path.node()->info; }
 };
 
 #endif
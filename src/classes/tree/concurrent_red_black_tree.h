@@ -0,0 +1,576 @@
+#ifndef CONCURRENT_RED_BLACK_TREE_H
+#define CONCURRENT_RED_BLACK_TREE_H
+
+#include "../../helpers/node_pool.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief concurrent red black tree class
+ * Red black tree set for read-mostly workloads: readers traverse an immutable snapshot
+ * with no locks and never wait for a writer. The tree is persistent, an update copies
+ * the nodes it changes(the search path and the few siblings the fixups recolor or
+ * rotate), links the copies into a new version next to the untouched subtrees and
+ * publishes the new root with a single atomic store. Writers are serialized by a mutex.
+ * The replaced nodes are reclaimed by epochs: a reader announces the current epoch in a
+ * slot before it loads the root, every update bumps the epoch, and the nodes retired by
+ * an update are freed once no slot announces an epoch up to the one they were retired
+ * in. A snapshot pins the version it loaded until it is destroyed, so long lived
+ * snapshots hold back reclamation, not writers.
+ * @tparam T the type of the elements, ordered by operator <.
+ */
+template <typename T> class concurrent_red_black_tree {
+  private:
+    struct node {
+        T info;
+        node* left{nullptr};
+        node* right{nullptr};
+        size_t size{1};
+        bool is_red{true};
+        // the update that created the node, only read by the writer
+        uint64_t version;
+        node(const T& key, uint64_t version) : info(key), version(version) {}
+    };
+
+    struct alignas(64) _slot {
+        std::atomic<uint64_t> epoch{IDLE};
+    };
+
+    static constexpr uint64_t IDLE = UINT64_MAX;
+
+    std::atomic<node*> _root{nullptr};
+    std::atomic<uint64_t> _epoch{0};
+    std::unique_ptr<_slot[]> _slots;
+    size_t _readers;
+
+    // everything below belongs to the writer
+    mutable std::mutex _write;
+    node_pool<node> _pool;
+    uint64_t _version{0};
+    std::vector<node*> _retired;
+    std::deque<std::pair<uint64_t, std::vector<node*>>> _limbo;
+    size_t _pending{0};
+
+    static size_t count(const node* t) { return t ? t->size : 0; }
+
+    static bool red(const node* t) { return t && t->is_red; }
+
+    static void _update(node* t) { t->size = 1 + count(t->left) + count(t->right); }
+
+    // the writable copy of t for the current update, t itself if the update created it
+    node* _own(node* t) {
+        if (t == nullptr || t->version == _version) {
+            return t;
+        }
+        node* nn = _pool.create(t->info, _version);
+        nn->left = t->left;
+        nn->right = t->right;
+        nn->size = t->size;
+        nn->is_red = t->is_red;
+        _retired.push_back(t);
+        return nn;
+    }
+
+    static node* _rotate_left(node* t) {
+        node* x = t->right;
+        t->right = x->left;
+        x->left = t;
+        x->size = t->size;
+        _update(t);
+        return x;
+    }
+
+    static node* _rotate_right(node* t) {
+        node* x = t->left;
+        t->left = x->right;
+        x->right = t;
+        x->size = t->size;
+        _update(t);
+        return x;
+    }
+
+    // replaces the child from of path[i] with to, or the root if i is past the top
+    static void _link(std::vector<node*>& path, size_t i, node*& root, node* from, node* to) {
+        if (i == SIZE_MAX) {
+            root = to;
+        } else if (path[i]->left == from) {
+            path[i]->left = to;
+        } else {
+            path[i]->right = to;
+        }
+    }
+
+    static const node* _find(const node* t, const T& key) {
+        while (t && (key < t->info || t->info < key)) {
+            t = key < t->info ? t->left : t->right;
+        }
+        return t;
+    }
+
+    void _publish(node* root) {
+        _root.store(root, std::memory_order_seq_cst);
+        uint64_t tag = _epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (!_retired.empty()) {
+            _pending += _retired.size();
+            _limbo.emplace_back(tag, std::move(_retired));
+            _retired.clear();
+        }
+        _version++;
+        _reclaim();
+    }
+
+    void _reclaim() {
+        uint64_t oldest = IDLE;
+        for (size_t i = 0; i < _readers; i++) {
+            oldest = std::min(oldest, _slots[i].epoch.load(std::memory_order_seq_cst));
+        }
+        while (!_limbo.empty() && _limbo.front().first < oldest) {
+            for (node* t : _limbo.front().second) {
+                _pool.destroy(t);
+            }
+            _pending -= _limbo.front().second.size();
+            _limbo.pop_front();
+        }
+    }
+
+    _slot* _pin() const {
+        size_t i = std::hash<std::thread::id>()(std::this_thread::get_id()) % _readers;
+        for (size_t tries = 1;; tries++, i = (i + 1) % _readers) {
+            if (tries % _readers == 0) {
+                std::this_thread::yield();
+            }
+            uint64_t idle = IDLE;
+            uint64_t e = _epoch.load(std::memory_order_seq_cst);
+            if (_slots[i].epoch.compare_exchange_strong(idle, e, std::memory_order_seq_cst)) {
+                return &_slots[i];
+            }
+        }
+    }
+
+    void _insert_fixup(std::vector<node*>& path, node*& root) {
+        size_t i = path.size() - 1;
+        while (i >= 2 && path[i - 1]->is_red) {
+            node* p = path[i - 1];
+            node* g = path[i - 2];
+            bool left = g->left == p;
+            node* u = left ? g->right : g->left;
+            if (red(u)) {
+                u = _own(u);
+                (left ? g->right : g->left) = u;
+                p->is_red = false;
+                u->is_red = false;
+                g->is_red = true;
+                i -= 2;
+                continue;
+            }
+            node* x = path[i];
+            if (left && p->right == x) {
+                g->left = _rotate_left(p);
+                p = x;
+            } else if (!left && p->left == x) {
+                g->right = _rotate_right(p);
+                p = x;
+            }
+            node* top = left ? _rotate_right(g) : _rotate_left(g);
+            _link(path, i >= 3 ? i - 3 : SIZE_MAX, root, g, top);
+            top->is_red = false;
+            g->is_red = true;
+            break;
+        }
+        root->is_red = false;
+    }
+
+    // x, possibly null, is one black short and is a child of path.back()
+    void _remove_fixup(std::vector<node*>& path, node* x, node*& root) {
+        size_t j = path.size() - 1;
+        while (j != SIZE_MAX && !red(x)) {
+            node* p = path[j];
+            bool left = p->left == x;
+            node* w = _own(left ? p->right : p->left);
+            (left ? p->right : p->left) = w;
+            if (w->is_red) {
+                w->is_red = false;
+                p->is_red = true;
+                node* top = left ? _rotate_left(p) : _rotate_right(p);
+                _link(path, j - 1, root, p, top);
+                path.insert(path.begin() + j, top);
+                j++;
+                w = _own(left ? p->right : p->left);
+                (left ? p->right : p->left) = w;
+            }
+            if (!red(w->left) && !red(w->right)) {
+                w->is_red = true;
+                x = p;
+                j--;
+                continue;
+            }
+            if (left && !red(w->right)) {
+                w->left = _own(w->left);
+                w->left->is_red = false;
+                w->is_red = true;
+                w = p->right = _rotate_right(w);
+            } else if (!left && !red(w->left)) {
+                w->right = _own(w->right);
+                w->right->is_red = false;
+                w->is_red = true;
+                w = p->left = _rotate_left(w);
+            }
+            w->is_red = p->is_red;
+            p->is_red = false;
+            if (left) {
+                w->right = _own(w->right);
+                w->right->is_red = false;
+            } else {
+                w->left = _own(w->left);
+                w->left->is_red = false;
+            }
+            node* top = left ? _rotate_left(p) : _rotate_right(p);
+            _link(path, j - 1, root, p, top);
+            return;
+        }
+        // x is red, so it was copied on the way up
+        if (x) {
+            x->is_red = false;
+        }
+    }
+
+    template <typename Visit> static void _inorder(const node* t, Visit& visit) {
+        if (t) {
+            _inorder(t->left, visit);
+            visit(t->info);
+            _inorder(t->right, visit);
+        }
+    }
+
+    template <typename Visit>
+    static void _range(const node* t, const T& lo, const T& hi, Visit& visit) {
+        if (t == nullptr) {
+            return;
+        }
+        if (lo < t->info) {
+            _range(t->left, lo, hi, visit);
+        }
+        if (!(t->info < lo) && !(hi < t->info)) {
+            visit(t->info);
+        }
+        if (t->info < hi) {
+            _range(t->right, lo, hi, visit);
+        }
+    }
+
+    static size_t _height(const node* t) {
+        return t ? 1 + std::max(_height(t->left), _height(t->right)) : 0;
+    }
+
+    void _destroy_all() {
+        for (auto& batch : _limbo) {
+            for (node* t : batch.second) {
+                _pool.destroy(t);
+            }
+        }
+        _limbo.clear();
+        _pending = 0;
+        _pool.clear(_root.load(std::memory_order_relaxed), [](node* n, auto visit) {
+            visit(n->left);
+            visit(n->right);
+        });
+    }
+
+  public:
+    class snapshot;
+
+    /**
+     * @brief Construct a new concurrent red black tree object
+     * @param v: the elements to insert.
+     * @param readers: the number of reader slots, at most this many snapshots are pinned
+     * at once and further readers spin until one is released. Default = 64
+     */
+    explicit concurrent_red_black_tree(const std::vector<T>& v = {}, size_t readers = 64)
+        : _slots(std::make_unique<_slot[]>(std::max<size_t>(readers, 1))),
+          _readers(std::max<size_t>(readers, 1)) {
+        for (const T& x : v) {
+            insert(x);
+        }
+    }
+
+    concurrent_red_black_tree(const concurrent_red_black_tree&) = delete;
+    concurrent_red_black_tree& operator=(const concurrent_red_black_tree&) = delete;
+
+    /**
+     * @brief Destructor for concurrent red black tree class, no snapshot can outlive it
+     */
+    ~concurrent_red_black_tree() { _destroy_all(); }
+
+    /**
+     * @brief insert function
+     * @param key: the key to insert.
+     * @returns true if the key was not in the tree.
+     */
+    bool insert(const T& key) {
+        std::lock_guard lock(_write);
+        node* root = _root.load(std::memory_order_relaxed);
+        if (_find(root, key)) {
+            return false;
+        }
+        std::vector<node*> path;
+        node** link = &root;
+        while (*link) {
+            node* t = _own(*link);
+            *link = t;
+            t->size++;
+            path.push_back(t);
+            link = key < t->info ? &t->left : &t->right;
+        }
+        *link = _pool.create(key, _version);
+        path.push_back(*link);
+        _insert_fixup(path, root);
+        _publish(root);
+        return true;
+    }
+
+    /**
+     * @brief remove function
+     * @param key: the key to remove.
+     * @returns true if the key was in the tree.
+     */
+    bool remove(const T& key) {
+        std::lock_guard lock(_write);
+        node* root = _root.load(std::memory_order_relaxed);
+        if (!_find(root, key)) {
+            return false;
+        }
+        std::vector<node*> path;
+        node** link = &root;
+        for (;;) {
+            node* t = _own(*link);
+            *link = t;
+            t->size--;
+            path.push_back(t);
+            if (!(key < t->info) && !(t->info < key)) {
+                break;
+            }
+            link = key < t->info ? &t->left : &t->right;
+        }
+        node* z = path.back();
+        if (z->left && z->right) {
+            // z takes the element of its successor, which is removed instead
+            link = &z->right;
+            do {
+                node* t = _own(*link);
+                *link = t;
+                t->size--;
+                path.push_back(t);
+                link = &t->left;
+            } while (*link);
+            z->info = path.back()->info;
+        }
+        node* y = path.back();
+        path.pop_back();
+        node* child = y->left ? y->left : y->right;
+        bool black = !y->is_red;
+        if (black && red(child)) {
+            // a red child takes the black of y
+            child = _own(child);
+            child->is_red = false;
+            black = false;
+        }
+        _link(path, path.empty() ? SIZE_MAX : path.size() - 1, root, y, child);
+        // y was copied by this update, no reader has seen it
+        _pool.destroy(y);
+        if (black) {
+            _remove_fixup(path, child, root);
+        }
+        if (root) {
+            root->is_red = false;
+        }
+        _publish(root);
+        return true;
+    }
+
+    /**
+     * @brief clear function
+     * Publishes an empty tree, the old nodes are reclaimed like any other version.
+     */
+    void clear() {
+        std::lock_guard lock(_write);
+        std::vector<node*> stack;
+        if (node* root = _root.load(std::memory_order_relaxed)) {
+            stack.push_back(root);
+        }
+        while (!stack.empty()) {
+            node* t = stack.back();
+            stack.pop_back();
+            for (node* c : {t->left, t->right}) {
+                if (c) {
+                    stack.push_back(c);
+                }
+            }
+            _retired.push_back(t);
+        }
+        _publish(nullptr);
+    }
+
+    /**
+     * @brief read function
+     * Pins the current version, wait-free unless every reader slot is taken.
+     * @returns snapshot the current version of the tree.
+     */
+    snapshot read() const { return snapshot(this); }
+
+    /**
+     * @brief search function
+     * @param key: the key to search.
+     * @returns true if the key is in the current version.
+     */
+    bool search(const T& key) const { return read().search(key); }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of elements of the current version.
+     */
+    size_t size() const { return read().size(); }
+
+    /**
+     * @brief memory_usage function
+     * Takes the lock of the writers.
+     * @return MEMORY::footprint: the elements of the current version, the links, sizes and
+     * colors of its nodes, the tree with its reader slots and retire lists, and the free slots
+     * of the pool and the replaced nodes waiting for their readers
+     */
+    MEMORY::footprint memory_usage() const {
+        std::lock_guard lock(_write);
+        const node* root = _root.load(std::memory_order_acquire);
+        MEMORY::footprint f = _pool.memory_usage(
+            sizeof(T), MEMORY::owned(
+                           root,
+                           [](const node* n, auto visit) {
+                               visit(n->left);
+                               visit(n->right);
+                           },
+                           [](const node* n) -> const T& { return n->info; }));
+        // the replaced nodes hold no element of the current version
+        const size_t waiting = _pool.size() - count(root);
+        f.payload -= waiting * sizeof(T);
+        f.node_overhead -= waiting * (sizeof(node) - sizeof(T));
+        f.slack += waiting * sizeof(node);
+        f.control += sizeof(*this) + _readers * sizeof(_slot) + MEMORY::ALLOCATION_OVERHEAD +
+                     MEMORY::memory_usage(_retired).total() - sizeof(_retired);
+        for (const auto& [epoch, nodes] : _limbo) {
+            f.control += MEMORY::memory_usage(nodes).total();
+        }
+        return f;
+    }
+
+    /**
+     * @brief pending function
+     * @returns size_t the number of replaced nodes waiting for their readers to leave.
+     */
+    size_t pending() {
+        std::lock_guard lock(_write);
+        _reclaim();
+        return _pending;
+    }
+};
+
+/**
+ * @brief snapshot class
+ * One immutable version of a concurrent red black tree, any number of threads can read
+ * it while writers publish newer versions. Keeps its version alive until destroyed.
+ */
+template <typename T> class concurrent_red_black_tree<T>::snapshot {
+  private:
+    const node* _root;
+    _slot* _pinned;
+
+    friend class concurrent_red_black_tree;
+
+    explicit snapshot(const concurrent_red_black_tree* t) : _pinned(t->_pin()) {
+        _root = t->_root.load(std::memory_order_seq_cst);
+    }
+
+  public:
+    snapshot(const snapshot&) = delete;
+    snapshot& operator=(const snapshot&) = delete;
+
+    snapshot(snapshot&& s) noexcept
+        : _root(s._root), _pinned(std::exchange(s._pinned, nullptr)) {}
+
+    ~snapshot() {
+        if (_pinned) {
+            _pinned->epoch.store(IDLE, std::memory_order_seq_cst);
+        }
+    }
+
+    /**
+     * @brief search function
+     * @param key: the key to search.
+     * @returns true if the key is in this version.
+     */
+    bool search(const T& key) const { return _find(_root, key) != nullptr; }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of elements of this version.
+     */
+    size_t size() const { return count(_root); }
+
+    /**
+     * @brief height function
+     * @returns size_t the number of levels of this version.
+     */
+    size_t height() const { return _height(_root); }
+
+    /**
+     * @brief rank function
+     * @param key: the key we want to rank.
+     * @returns size_t the number of elements smaller than key, in O(log n).
+     */
+    size_t rank(const T& key) const {
+        size_t r = 0;
+        for (const node* t = _root; t != nullptr;) {
+            if (t->info < key) {
+                r += count(t->left) + 1;
+                t = t->right;
+            } else {
+                t = t->left;
+            }
+        }
+        return r;
+    }
+
+    /**
+     * @brief range function
+     * Visits the elements in [lo, hi] in order, in O(log n + k) for k elements.
+     * @param lo: the smallest key of the range.
+     * @param hi: the largest key of the range.
+     * @param visit: called with every element of the range.
+     */
+    template <typename Visit> void range(const T& lo, const T& hi, Visit visit) const {
+        _range(_root, lo, hi, visit);
+    }
+
+    /**
+     * @brief inorder function
+     * @returns vector<T> the elements of this version in order.
+     */
+    std::vector<T> inorder() const {
+        std::vector<T> path;
+        path.reserve(size());
+        auto push = [&](const T& x) { path.push_back(x); };
+        _inorder(_root, push);
+        return path;
+    }
+};
+
+#endif
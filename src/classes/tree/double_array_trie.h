@@ -0,0 +1,516 @@
+#ifndef DOUBLE_ARRAY_TRIE_H
+#define DOUBLE_ARRAY_TRIE_H
+
+#include "../../helpers/archive.h"
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief double array trie class
+ * Immutable trie for static dictionaries in two int32 arrays(Aoe's double array, the
+ * layout of DARTS). A state s moves on the byte c to t = base[s] + c + 1 when check[t]
+ * == s, and code 0 marks the end of a key, so a lookup costs one array probe per byte
+ * and no pointer is stored. Once a branch holds a single key its remaining bytes go to
+ * a shared tail pool instead of one state per byte, which keeps the arrays close to the
+ * number of branching nodes. Every key gets an id, its rank in sorted order. The arrays
+ * can be saved as an archive and mapped back, the lookups then read the file in place.
+ */
+class double_array_trie {
+  public:
+    /**
+     * @brief Construct a new double array trie object
+     * @param keys: the keys in any order, duplicates are dropped.
+     * Throws std::length_error if the arrays would outgrow int32 indexes.
+     */
+    inline explicit double_array_trie(std::vector<std::string> keys = {}) {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        _build(keys);
+        _attach();
+    }
+
+    /**
+     * @brief Copy constructor for double array trie class
+     * @param d the trie we want to copy, a mapped trie shares its mapping
+     */
+    inline double_array_trie(const double_array_trie& d)
+        : _base(d._base), _check(d._check), _tail(d._tail), _size(d._size), _archive(d._archive) {
+        _attach();
+    }
+
+    /**
+     * @brief Move constructor for double array trie class
+     * @param d the trie we want to move, it is left empty
+     */
+    inline double_array_trie(double_array_trie&& d) noexcept
+        : _base(std::move(d._base)), _check(std::move(d._check)), _tail(std::move(d._tail)),
+          _size(std::exchange(d._size, 0)), _archive(std::move(d._archive)) {
+        _attach();
+        d._attach();
+    }
+
+    /**
+     * @brief operator = for double array trie class
+     * @param d the trie we want to copy or move
+     * @return double_array_trie&
+     */
+    inline double_array_trie& operator=(double_array_trie d) noexcept {
+        _base.swap(d._base);
+        _check.swap(d._check);
+        _tail.swap(d._tail);
+        std::swap(_size, d._size);
+        _archive.swap(d._archive);
+        _attach();
+        return *this;
+    }
+
+    /**
+     * @brief save_archive function
+     * Writes the arrays and the tail pool as a double_array archive, which map_archive queries in
+     * place.
+     * @param path: the output file, overwritten.
+     * @param values: a value for every key id stored with the arrays, e.g. the weights of the
+     * words of a trie. Default = none
+     * Throws std::runtime_error if the file can not be written, std::invalid_argument if
+     * values is neither empty nor size() long.
+     */
+    inline void save_archive(const std::string& path, std::span<const double> values = {}) const {
+        if (!values.empty() && values.size() != _size) {
+            throw std::invalid_argument("double_array_trie::save_archive: one value per key");
+        }
+        archive_writer out(path, archive_kind::double_array, 0, _size);
+        out.add(std::span<const int32_t>(_b, _cells));
+        out.add(std::span<const int32_t>(_c, _cells));
+        out.add(std::span<const char>(_t));
+        out.add(values);
+        out.finish();
+    }
+
+    /**
+     * @brief map_archive function
+     * Maps an archive and answers the queries from the arrays of the file in place, with no
+     * build: the cells are checked in one pass and the pages are read as the lookups touch
+     * them. The file must not change while it is mapped.
+     * @param path: a file written by save_archive.
+     * @return double_array_trie the mapped trie
+     * Throws std::runtime_error like archive_view, or if the arrays are corrupted.
+     */
+    static double_array_trie map_archive(const std::string& path) {
+        double_array_trie d;
+        d._base = {};
+        d._check = {};
+        d._tail = {};
+        d._archive = std::make_shared<const archive_view>(path, archive_kind::double_array, 0);
+        d._size = d._archive->count();
+        d._attach();
+        std::span<const double> values = d.values();
+        bool valid = d._cells > 0 && d._archive->section<int32_t>(1).size() == d._cells &&
+                     (values.empty() || values.size() == d._size);
+        for (size_t s = 0; valid && s < d._cells; s++) {
+            if (d._c[s] < 0) {
+                continue;
+            }
+            if (size_t(d._c[s]) >= d._cells) {
+                valid = false;
+            } else if (d._b[s] < 0) {
+                size_t at = size_t(-(int64_t(d._b[s]) + 1));
+                uint32_t len = 0;
+                valid = at + 8 <= d._t.size();
+                if (valid) {
+                    std::memcpy(&len, d._t.data() + at, 4);
+                    valid = len <= d._t.size() - at - 8;
+                }
+            }
+        }
+        if (!valid) {
+            throw std::runtime_error("Archive " + path + " is corrupted");
+        }
+        return d;
+    }
+
+    /**
+     * @brief values function
+     * @return span the values stored with the archive of a mapped trie by key id, empty for a
+     * trie that is not mapped or an archive without values.
+     */
+    inline std::span<const double> values() const {
+        return _archive ? _archive->section<double>(3) : std::span<const double>();
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of keys.
+     */
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief empty function
+     * @return true if there are no keys.
+     */
+    inline bool empty() const { return _size == 0; }
+
+    /**
+     * @brief bytes function
+     * @return size_t the memory used by the arrays and the tail pool, 0 for a mapped trie.
+     */
+    inline size_t bytes() const {
+        return (_base.capacity() + _check.capacity()) * sizeof(int32_t) + _tail.capacity();
+    }
+
+    /**
+     * @brief find function
+     * @param key: the key to search.
+     * @return std::optional<size_t> the id of the key, std::nullopt if it is missing.
+     */
+    inline std::optional<size_t> find(std::string_view key) const {
+        int32_t s = 0;
+        for (size_t i = 0;; i++) {
+            if (_b[s] < 0) {
+                _tail_entry e = _tail_at(s);
+                if (e.suffix == key.substr(i)) {
+                    return e.id;
+                }
+                return std::nullopt;
+            }
+            int32_t t = i == key.size() ? _next(s, 0) : _next(s, _code(key[i]));
+            if (t < 0) {
+                return std::nullopt;
+            }
+            if (i == key.size()) {
+                return size_t(_b[t]);
+            }
+            s = t;
+        }
+    }
+
+    /**
+     * @brief search function
+     * @param key: the key to search.
+     * @return true if the key exists.
+     */
+    inline bool search(std::string_view key) const { return find(key).has_value(); }
+
+    /**
+     * @brief longest_prefix_match function
+     * @param text: the text to match.
+     * @return std::optional<size_t> the length of the longest key that is a prefix of text,
+     * std::nullopt if no key is.
+     */
+    inline std::optional<size_t> longest_prefix_match(std::string_view text) const {
+        std::optional<size_t> best;
+        int32_t s = 0;
+        for (size_t i = 0;; i++) {
+            if (_b[s] < 0) {
+                _tail_entry e = _tail_at(s);
+                if (text.substr(i, e.suffix.size()) == e.suffix) {
+                    best = i + e.suffix.size();
+                }
+                return best;
+            }
+            if (_next(s, 0) >= 0) {
+                best = i;
+            }
+            if (i == text.size() || (s = _next(s, _code(text[i]))) < 0) {
+                return best;
+            }
+        }
+    }
+
+    /**
+     * @brief with_prefix function
+     * Visits every key that starts with prefix in sorted order.
+     * @param prefix: the prefix.
+     * @param visit: called with every key and its id.
+     */
+    template <typename Visit> void with_prefix(std::string_view prefix, Visit visit) const {
+        int32_t s = 0;
+        for (size_t i = 0; i < prefix.size(); i++) {
+            if (_b[s] < 0) {
+                _tail_entry e = _tail_at(s);
+                if (e.suffix.substr(0, prefix.size() - i) == prefix.substr(i)) {
+                    visit(std::string(prefix.substr(0, i)) + std::string(e.suffix), e.id);
+                }
+                return;
+            }
+            if ((s = _next(s, _code(prefix[i]))) < 0) {
+                return;
+            }
+        }
+        std::string key(prefix);
+        _enumerate(s, key, visit);
+    }
+
+    /**
+     * @brief keys_with_prefix function
+     * @param prefix: the prefix.
+     * @return vector<string> every key that starts with prefix, sorted.
+     */
+    inline std::vector<std::string> keys_with_prefix(std::string_view prefix) const {
+        std::vector<std::string> keys;
+        with_prefix(prefix, [&](const std::string& k, size_t) { keys.push_back(k); });
+        return keys;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the tails of the keys with their lengths and ids, the base and
+     * check arrays as node overhead, their free cells as slack, the object with the headers of the
+     * arrays and their spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_tail);
+        MEMORY::footprint cells = MEMORY::heap_usage(_base) + MEMORY::heap_usage(_check);
+        size_t used = 0;
+        for (int32_t c : _check) {
+            used += c >= 0;
+        }
+        const size_t unused = (_check.size() - used) * 2 * sizeof(int32_t);
+        cells.slack += unused;
+        cells.payload -= unused;
+        f += MEMORY::as_overhead(cells);
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    // 256 bytes and the end of key
+    static constexpr int32_t CODES = 257;
+    // free cells that may fail in a row before the search for a base skips them for good
+    static constexpr size_t SKIP_AFTER = 64;
+
+    std::vector<int32_t> _base;
+    std::vector<int32_t> _check;
+    // every entry: uint32 length, uint32 id, then the bytes of the suffix
+    std::string _tail;
+    size_t _size{0};
+    // the queries read the cells through these: the arrays above, or the sections of a mapped
+    // archive, which the copies of a mapped trie share
+    std::shared_ptr<const archive_view> _archive;
+    const int32_t* _b{nullptr};
+    const int32_t* _c{nullptr};
+    size_t _cells{0};
+    std::string_view _t;
+
+    void _attach() {
+        if (_archive) {
+            std::span<const int32_t> base = _archive->section<int32_t>(0);
+            _b = base.data();
+            _c = _archive->section<int32_t>(1).data();
+            _cells = base.size();
+            std::span<const char> tail = _archive->section<char>(2);
+            _t = std::string_view(tail.data(), tail.size());
+        } else {
+            _b = _base.data();
+            _c = _check.data();
+            _cells = _check.size();
+            _t = _tail;
+        }
+    }
+
+    struct _tail_entry {
+        std::string_view suffix;
+        size_t id;
+    };
+
+    static int32_t _code(char c) { return int32_t(static_cast<unsigned char>(c)) + 1; }
+
+    int32_t _next(int32_t s, int32_t code) const {
+        int64_t t = int64_t(_b[s]) + code;
+        return t < int64_t(_cells) && _c[t] == s ? int32_t(t) : -1;
+    }
+
+    _tail_entry _tail_at(int32_t s) const {
+        size_t at = size_t(-(int64_t(_b[s]) + 1));
+        uint32_t len, id;
+        std::memcpy(&len, _t.data() + at, 4);
+        std::memcpy(&id, _t.data() + at + 4, 4);
+        return {_t.substr(at + 8, len), id};
+    }
+
+    template <typename Visit> void _enumerate(int32_t s, std::string& key, Visit& visit) const {
+        if (_b[s] < 0) {
+            _tail_entry e = _tail_at(s);
+            size_t n = key.size();
+            key.append(e.suffix);
+            visit(static_cast<const std::string&>(key), e.id);
+            key.resize(n);
+            return;
+        }
+        if (int32_t t = _next(s, 0); t >= 0) {
+            visit(static_cast<const std::string&>(key), size_t(_b[t]));
+        }
+        for (int32_t c = 1; c < CODES; c++) {
+            if (int32_t t = _next(s, c); t >= 0) {
+                key.push_back(char(c - 1));
+                _enumerate(t, key, visit);
+                key.pop_back();
+            }
+        }
+    }
+
+    // build state: the free cells form a circular list sorted by position, the search for a
+    // base starts at start, which moves forward past the stretches that are almost full
+    struct _builder {
+        std::vector<int32_t> next_free, prev_free;
+        int32_t head{-1};
+        int32_t start{-1};
+    };
+
+    void _grow(_builder& b, size_t n) {
+        size_t old = _check.size();
+        if (n <= old) {
+            return;
+        }
+        if (n > size_t(INT32_MAX)) {
+            throw std::length_error("double_array_trie: too many states");
+        }
+        n = std::min(std::max(n, old * 2), size_t(INT32_MAX));
+        _base.resize(n, 0);
+        _check.resize(n, -1);
+        b.next_free.resize(n, -1);
+        b.prev_free.resize(n, -1);
+        int32_t last = b.head < 0 ? -1 : b.prev_free[b.head];
+        for (size_t i = old; i < n; i++) {
+            if (last < 0) {
+                b.head = int32_t(i);
+            } else {
+                b.next_free[last] = int32_t(i);
+            }
+            b.prev_free[i] = last;
+            last = int32_t(i);
+        }
+        // circular, so the tail of the list is found from the head
+        b.next_free[last] = b.head;
+        b.prev_free[b.head] = last;
+    }
+
+    void _use(_builder& b, int32_t t, int32_t owner) {
+        _check[t] = owner;
+        int32_t p = b.prev_free[t], n = b.next_free[t];
+        if (n == t) {
+            b.head = b.start = -1;
+        } else {
+            b.next_free[p] = n;
+            b.prev_free[n] = p;
+            if (b.head == t) {
+                b.head = n;
+            }
+            if (b.start == t) {
+                b.start = n == b.head ? -1 : n;
+            }
+        }
+    }
+
+    int32_t _find_base(_builder& b, const std::vector<int32_t>& codes) {
+        for (;;) {
+            if (b.head < 0) {
+                _grow(b, _check.size() + CODES);
+            }
+            int32_t first = b.start < 0 ? b.head : b.start, f = first;
+            size_t failed = 0;
+            do {
+                int64_t base = int64_t(f) - codes[0];
+                if (base >= 1) {
+                    _grow(b, size_t(base + codes.back() + 1));
+                    bool fits = true;
+                    for (int32_t c : codes) {
+                        if (_check[base + c] >= 0) {
+                            fits = false;
+                            break;
+                        }
+                    }
+                    if (fits) {
+                        if (failed > SKIP_AFTER) {
+                            b.start = f;
+                        }
+                        return int32_t(base);
+                    }
+                }
+                failed++;
+                f = b.next_free[f];
+            } while (f != first);
+            _grow(b, _check.size() + CODES);
+        }
+    }
+
+    void _make_tail(int32_t s, std::string_view suffix, size_t id) {
+        _base[s] = -int32_t(_tail.size()) - 1;
+        uint32_t len = uint32_t(suffix.size()), id32 = uint32_t(id);
+        _tail.append(reinterpret_cast<const char*>(&len), 4);
+        _tail.append(reinterpret_cast<const char*>(&id32), 4);
+        _tail.append(suffix);
+    }
+
+    // keys[lo, hi) share their first depth bytes and lead to state s
+    void _insert(_builder& b, const std::vector<std::string>& keys, size_t lo, size_t hi,
+                 size_t depth, int32_t s) {
+        if (hi - lo == 1 && s != 0) {
+            _make_tail(s, std::string_view(keys[lo]).substr(depth), lo);
+            return;
+        }
+        std::vector<int32_t> codes;
+        std::vector<size_t> starts;
+        for (size_t i = lo; i < hi; i++) {
+            int32_t c = keys[i].size() == depth ? 0 : _code(keys[i][depth]);
+            if (codes.empty() || codes.back() != c) {
+                codes.push_back(c);
+                starts.push_back(i);
+            }
+        }
+        starts.push_back(hi);
+        if (codes.empty()) {
+            return;
+        }
+        int32_t base = _find_base(b, codes);
+        _base[s] = base;
+        for (int32_t c : codes) {
+            _use(b, base + c, s);
+        }
+        for (size_t g = 0; g < codes.size(); g++) {
+            int32_t t = base + codes[g];
+            if (codes[g] == 0) {
+                _base[t] = int32_t(starts[g]);
+            } else {
+                _insert(b, keys, starts[g], starts[g + 1], depth + 1, t);
+            }
+        }
+    }
+
+    void _build(const std::vector<std::string>& keys) {
+        if (keys.size() > size_t(INT32_MAX)) {
+            throw std::length_error("double_array_trie: too many keys");
+        }
+        _builder b;
+        _grow(b, CODES + 1);
+        _use(b, 0, 0);
+        // no transition can lead back to the root
+        _base[0] = 1;
+        _insert(b, keys, 0, keys.size(), 0, 0);
+        _size = keys.size();
+        // the free cells past the last used one are not needed
+        size_t end = _check.size();
+        while (end > 1 && _check[end - 1] < 0) {
+            end--;
+        }
+        _base.resize(end);
+        _check.resize(end);
+        _base.shrink_to_fit();
+        _check.shrink_to_fit();
+        _tail.shrink_to_fit();
+    }
+};
+
+#endif
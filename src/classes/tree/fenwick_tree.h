@@ -1,26 +1,36 @@
 #ifndef FENWICK_TREE_H
 #define FENWICK_TREE_H
 
+#include "../../helpers/archive.h"
+#include "../../helpers/memory_usage.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <iostream>
 #include <vector>
 #endif
 
 /**
  * @brief fenwick tree class
+ * tree[k] holds the sum of the range [k & (k + 1), k].
  */
 template <typename T> struct fenwick_tree {
     std::vector<T> tree;
     int n;
 
     /**
-     * @brief default constructor of fenwick tree class
+     * @brief default constructor of fenwick tree class, in O(n): every node hands its
+     * sum on to the next node that covers it
      * @param v: the input vector
      */
-    inline explicit fenwick_tree(const std::vector<T>& v) noexcept : n(int(v.size())) {
-        tree = std::vector<T>(n, 0);
+    inline explicit fenwick_tree(const std::vector<T>& v) : tree(v), n(int(v.size())) {
         for (int i = 0; i < n; i++) {
-            this->update(i, v[i]);
+            int j = i | (i + 1);
+            if (j < n) {
+                tree[j] += tree[i];
+            }
         }
     }
 
@@ -50,11 +60,321 @@ template <typename T> struct fenwick_tree {
      * @param k: the index
      * @param x: the value that will be added to data[k]
      */
-    inline void update(int k, int x) {
+    inline void update(int k, T x) {
         for (; k < n; k = k | (k + 1)) {
             tree[k] += x;
         }
     }
+
+    /**
+     * @brief lower_bound function
+     * Descends the implicit tree from the largest power of two in O(log n), so drawing
+     * index i with probability proportional to data[i] is lower_bound(U(0, sum(n - 1))).
+     * Needs non negative values.
+     * @param prefix_sum: the sum to reach
+     * @return int: the first index k with sum(k) >= prefix_sum, n if there is none
+     */
+    inline int lower_bound(T prefix_sum) const {
+        // pos counts the elements known to sum below prefix_sum, tree[pos + step - 1]
+        // holds the sum of the next step of them
+        int pos = 0;
+        for (int step = int(std::bit_floor(unsigned(n))); step > 0; step >>= 1) {
+            if (pos + step <= n && tree[pos + step - 1] < prefix_sum) {
+                pos += step;
+                prefix_sum -= tree[pos - 1];
+            }
+        }
+        return pos;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the partial sums, the object with the header of their array and
+     * its spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::memory_usage(tree);
+        f.control += sizeof(*this) - sizeof(tree);
+        return f;
+    }
+
+    /**
+     * @brief save_archive function
+     * @param path: the output file, overwritten, the partial sums are written as they are.
+     * Throws std::runtime_error if it can not be written.
+     */
+    inline void save_archive(const std::string& path) const {
+        archive_writer out(path, archive_kind::fenwick, _archive_utils::key_size<T>(), tree.size());
+        out.add(std::span<const T>(tree));
+        out.finish();
+    }
+
+    /**
+     * @brief load_archive function
+     * Copies the partial sums of an archive in bulk, with no rebuild.
+     * @param path: a file written by save_archive.
+     * @return fenwick_tree the tree
+     * Throws std::runtime_error like archive_view.
+     */
+    static fenwick_tree load_archive(const std::string& path) {
+        fenwick_tree f(std::vector<T>{});
+        archive_view archive(path, archive_kind::fenwick, _archive_utils::key_size<T>());
+        f.tree = archive.keys<T>(0);
+        f.n = int(f.tree.size());
+        return f;
+    }
+};
+
+/**
+ * @brief range update fenwick tree class
+ * Two fenwick trees over the differences d[i] = data[i] - data[i - 1], one holding d[i]
+ * and the other i * d[i], so that adding to a range and summing a range both cost
+ * O(log n): the sum of [0, k] is (k + 1) * sum(d[0..k]) - sum(i * d[i], i = 0..k).
+ */
+template <typename T> struct range_fenwick_tree {
+    fenwick_tree<T> d;
+    fenwick_tree<T> id;
+    int n;
+
+    /**
+     * @brief default constructor of range fenwick tree class, in O(n)
+     * @param v: the input vector
+     */
+    inline explicit range_fenwick_tree(const std::vector<T>& v)
+        : d(_differences(v, false)), id(_differences(v, true)), n(int(v.size())) {}
+
+    /**
+     * @brief update query function
+     * @param a: starting index
+     * @param b: ending index
+     * @param x: the value that will be added to data[a..b]
+     */
+    inline void update(int a, int b, T x) {
+        d.update(a, x);
+        d.update(b + 1, -x);
+        id.update(a, x * T(a));
+        id.update(b + 1, -x * T(b + 1));
+    }
+
+    /**
+     * @brief sum query function
+     * @param k: the ending index of the query
+     * @return T: the sum of range [0, k]
+     */
+    inline T sum(int k) { return k < 0 ? T(0) : d.sum(k) * T(k + 1) - id.sum(k); }
+
+    /**
+     * @brief sum query function(from index a to b)
+     * @param a: starting index
+     * @param b: ending index
+     * @returns T: the sum of range [a, b]
+     */
+    inline T sum(int a, int b) { return sum(b) - sum(a - 1); }
+
+    /**
+     * @brief get function
+     * @param k: the index
+     * @return T: data[k]
+     */
+    inline T get(int k) { return d.sum(k); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the differences and the weighted differences, the object with the
+     * headers of their arrays and their spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = d.memory_usage() + id.memory_usage();
+        f.control += sizeof(*this) - sizeof(d) - sizeof(id);
+        return f;
+    }
+
+  private:
+    static std::vector<T> _differences(const std::vector<T>& v, bool weighted) {
+        std::vector<T> diff(v.size());
+        for (size_t i = 0; i < v.size(); i++) {
+            diff[i] = i == 0 ? v[0] : v[i] - v[i - 1];
+            if (weighted) {
+                diff[i] = diff[i] * T(i);
+            }
+        }
+        return diff;
+    }
+};
+
+/**
+ * @brief 2D fenwick tree class
+ * Fenwick tree of fenwick trees over a grid in one row major array: point updates and
+ * sums of rectangles cost O(log rows * log cols). It builds in O(rows * cols) with the
+ * same hand on pass as fenwick_tree, first along the rows and then along the columns.
+ */
+template <typename T> struct fenwick_tree_2d {
+    std::vector<T> tree;
+    int rows;
+    int cols;
+
+    /**
+     * @brief constructor of 2D fenwick tree class for a grid of zeros
+     * @param rows: the number of rows
+     * @param cols: the number of columns
+     */
+    inline explicit fenwick_tree_2d(int rows, int cols)
+        : tree(size_t(rows) * size_t(cols), T(0)), rows(rows), cols(cols) {}
+
+    /**
+     * @brief default constructor of 2D fenwick tree class, in O(rows * cols)
+     * @param grid: the input grid, every row has the same length
+     */
+    inline explicit fenwick_tree_2d(const std::vector<std::vector<T>>& grid)
+        : fenwick_tree_2d(int(grid.size()), grid.empty() ? 0 : int(grid[0].size())) {
+        for (int r = 0; r < rows; r++) {
+            std::copy(grid[r].begin(), grid[r].end(), tree.begin() + _at(r, 0));
+        }
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                if (int j = c | (c + 1); j < cols) {
+                    tree[_at(r, j)] += tree[_at(r, c)];
+                }
+            }
+        }
+        for (int r = 0; r < rows; r++) {
+            if (int j = r | (r + 1); j < rows) {
+                for (int c = 0; c < cols; c++) {
+                    tree[_at(j, c)] += tree[_at(r, c)];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief update query function
+     * @param r: the row
+     * @param c: the column
+     * @param x: the value that will be added to grid[r][c]
+     */
+    inline void update(int r, int c, T x) {
+        for (; r < rows; r = r | (r + 1)) {
+            for (int j = c; j < cols; j = j | (j + 1)) {
+                tree[_at(r, j)] += x;
+            }
+        }
+    }
+
+    /**
+     * @brief sum query function
+     * @param r: the last row
+     * @param c: the last column
+     * @return T: the sum of the rectangle [0, r] x [0, c]
+     */
+    inline T sum(int r, int c) const {
+        T sum = 0;
+        for (; r >= 0; r = (r & (r + 1)) - 1) {
+            for (int j = c; j >= 0; j = (j & (j + 1)) - 1) {
+                sum += tree[_at(r, j)];
+            }
+        }
+        return sum;
+    }
+
+    /**
+     * @brief sum query function of a rectangle
+     * @param r1: the first row
+     * @param c1: the first column
+     * @param r2: the last row
+     * @param c2: the last column
+     * @return T: the sum of the rectangle [r1, r2] x [c1, c2]
+     */
+    inline T sum(int r1, int c1, int r2, int c2) const {
+        return sum(r2, c2) - sum(r1 - 1, c2) - sum(r2, c1 - 1) + sum(r1 - 1, c1 - 1);
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the partial sums of the grid, the object with the header of their
+     * array and its spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::memory_usage(tree);
+        f.control += sizeof(*this) - sizeof(tree);
+        return f;
+    }
+
+  private:
+    size_t _at(int r, int c) const { return size_t(r) * size_t(cols) + size_t(c); }
+};
+
+/**
+ * @brief static fenwick tree class
+ * fenwick_tree over a fixed array of N values in a std::array, with every function
+ * constexpr: a static constexpr static_fenwick_tree of a constant table holds its partial
+ * sums in the read only data, with no allocation and no build at startup, and a copy of it
+ * can be updated like a fenwick_tree.
+ * @tparam T the type of the values
+ * @tparam N the number of values
+ */
+template <typename T, size_t N> struct static_fenwick_tree {
+    std::array<T, N> tree;
+
+    /**
+     * @brief constructor of static fenwick tree class, in O(N) like fenwick_tree
+     * @param v: the input array
+     */
+    constexpr explicit static_fenwick_tree(const std::array<T, N>& v) : tree(v) {
+        for (int i = 0; i < int(N); i++) {
+            int j = i | (i + 1);
+            if (j < int(N)) {
+                tree[j] += tree[i];
+            }
+        }
+    }
+
+    /**
+     * @brief sum query function
+     * @param k: the ending index of the query
+     * @return T: the sum of range [0, k]
+     */
+    constexpr T sum(int k) const {
+        T sum = 0;
+        for (; k >= 0; k = (k & (k + 1)) - 1) {
+            sum += tree[k];
+        }
+        return sum;
+    }
+
+    /**
+     * @brief sum query function(from index a to b)
+     * @param a: starting index
+     * @param b: ending index
+     * @returns T: the sum of range [a, b]
+     */
+    constexpr T sum(int a, int b) const { return sum(b) - sum(a - 1); }
+
+    /**
+     * @brief update query function
+     * @param k: the index
+     * @param x: the value that will be added to data[k]
+     */
+    constexpr void update(int k, T x) {
+        for (; k < int(N); k = k | (k + 1)) {
+            tree[k] += x;
+        }
+    }
+
+    /**
+     * @brief lower_bound function
+     * @param prefix_sum: the sum to reach, the values are non negative
+     * @return int: the first index k with sum(k) >= prefix_sum, N if there is none
+     */
+    constexpr int lower_bound(T prefix_sum) const {
+        int pos = 0;
+        for (int step = int(std::bit_floor(N)); step > 0; step >>= 1) {
+            if (pos + step <= int(N) && tree[pos + step - 1] < prefix_sum) {
+                pos += step;
+                prefix_sum -= tree[pos - 1];
+            }
+        }
+        return pos;
+    }
 };
 
 #endif
@@ -0,0 +1,255 @@
+#ifndef FLAT_TREE_H
+#define FLAT_TREE_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief flat tree class
+ * Immutable binary tree in arrays, for trees that are built once and then walked many
+ * times(decision trees for example). The nodes are numbered in level order, so the
+ * children of a node are next to each other and right after the children of the nodes
+ * before it: every node keeps the index of its first child and two bits that say which
+ * children it has, and walking down the tree reads the arrays front to back. There are no
+ * pointers, so the tree is written and read back as three arrays with one read each and no
+ * allocation per node.
+ * @tparam T the type of the values, serialize and deserialize need it trivially copyable.
+ */
+template <typename T> class flat_tree {
+  public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    /**
+     * @brief Construct an empty flat tree object
+     */
+    flat_tree() = default;
+
+    /**
+     * @brief build function
+     * @param root: the root of a pointer tree, its nodes have info, left and right.
+     * @return flat_tree the same tree in level order, in O(n).
+     * Throws std::length_error if the tree has 2^32 - 1 nodes or more.
+     */
+    template <typename Node> static flat_tree build(const Node* root) {
+        flat_tree t;
+        if (root == nullptr) {
+            return t;
+        }
+        // the queue of the level order is the array of nodes itself
+        std::vector<const Node*> order = {root};
+        for (size_t i = 0; i < order.size(); i++) {
+            if (order.size() >= size_t(NONE)) {
+                throw std::length_error("flat_tree: too many nodes");
+            }
+            const Node* n = order[i];
+            t._info.push_back(n->info);
+            t._child.push_back(uint32_t(order.size()));
+            t._kids.push_back(uint8_t((n->left ? LEFT : 0) | (n->right ? RIGHT : 0)));
+            if (n->left) {
+                order.push_back(n->left);
+            }
+            if (n->right) {
+                order.push_back(n->right);
+            }
+        }
+        return t;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of nodes.
+     */
+    size_t size() const { return _info.size(); }
+
+    /**
+     * @brief empty function
+     * @return true if the tree has no nodes.
+     */
+    bool empty() const { return _info.empty(); }
+
+    /**
+     * @brief root function
+     * @return uint32_t the index of the root, NONE for an empty tree.
+     */
+    uint32_t root() const { return _info.empty() ? NONE : 0; }
+
+    /**
+     * @brief info function
+     * @param i: the index of a node.
+     * @return const T& the value of the node.
+     */
+    const T& info(uint32_t i) const { return _info[i]; }
+
+    /**
+     * @brief left function
+     * @param i: the index of a node.
+     * @return uint32_t the index of its left child, NONE if it has none.
+     */
+    uint32_t left(uint32_t i) const { return _kids[i] & LEFT ? _child[i] : NONE; }
+
+    /**
+     * @brief right function
+     * @param i: the index of a node.
+     * @return uint32_t the index of its right child, NONE if it has none.
+     */
+    uint32_t right(uint32_t i) const {
+        return _kids[i] & RIGHT ? _child[i] + (_kids[i] & LEFT) : NONE;
+    }
+
+    /**
+     * @brief descend function
+     * Walks down from the root, the way a decision tree is evaluated.
+     * @param go_right: called with the value of every node of the path, true to go right.
+     * @return uint32_t the index of the node where the path ends because the child it
+     * asks for is missing, NONE for an empty tree.
+     */
+    template <typename F> uint32_t descend(F go_right) const {
+        uint32_t i = root();
+        while (i != NONE) {
+            uint32_t next = go_right(static_cast<const T&>(_info[i])) ? right(i) : left(i);
+            if (next == NONE) {
+                return i;
+            }
+            i = next;
+        }
+        return i;
+    }
+
+    /**
+     * @brief inorder function
+     * @return vector<T> the inorder traversal of the tree.
+     */
+    std::vector<T> inorder() const {
+        std::vector<T> path;
+        std::vector<uint32_t> stack;
+        for (uint32_t i = root(); i != NONE || !stack.empty();) {
+            if (i != NONE) {
+                stack.push_back(i);
+                i = left(i);
+                continue;
+            }
+            i = stack.back();
+            stack.pop_back();
+            path.push_back(_info[i]);
+            i = right(i);
+        }
+        return path;
+    }
+
+    /**
+     * @brief level order function
+     * @return vector<vector<T>> the level order traversal of the tree, read off the
+     * arrays since they are in level order already.
+     */
+    std::vector<std::vector<T>> level_order() const {
+        std::vector<std::vector<T>> path;
+        for (size_t begin = 0, end = size() ? 1 : 0; begin < end;) {
+            path.emplace_back(_info.begin() + begin, _info.begin() + end);
+            // the children of this level are the next level
+            size_t next = end;
+            for (size_t i = begin; i < end; i++) {
+                next += (_kids[i] & LEFT ? 1 : 0) + (_kids[i] & RIGHT ? 1 : 0);
+            }
+            begin = end;
+            end = next;
+        }
+        return path;
+    }
+
+    /**
+     * @brief serialize function
+     * Writes a header(magic, format version, sizeof(T), byte order, n) and the arrays.
+     * @param out: the stream, open it in binary mode.
+     */
+    void serialize(std::ostream& out) const
+        requires std::is_trivially_copyable_v<T>
+    {
+        _header h{MAGIC, FORMAT, uint32_t(sizeof(T)), ENDIAN_MARK, uint64_t(size())};
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(_info.data()),
+                  std::streamsize(size() * sizeof(T)));
+        out.write(reinterpret_cast<const char*>(_child.data()), std::streamsize(size() * 4));
+        out.write(reinterpret_cast<const char*>(_kids.data()), std::streamsize(size()));
+    }
+
+    /**
+     * @brief deserialize function
+     * Reads a tree written by serialize in O(n), every array in one read.
+     * @param in: the stream, open it in binary mode.
+     * @return flat_tree the tree.
+     * Throws std::runtime_error if the data is not a tree of T written on a machine with
+     * the same byte order, or if it is cut short or inconsistent.
+     */
+    static flat_tree deserialize(std::istream& in)
+        requires std::is_trivially_copyable_v<T>
+    {
+        _header h;
+        if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)) || h.magic != MAGIC ||
+            h.format != FORMAT || h.value_size != sizeof(T) || h.byte_order != ENDIAN_MARK ||
+            h.n >= uint64_t(NONE)) {
+            throw std::runtime_error("flat_tree::deserialize: not a flat_tree of this type");
+        }
+        flat_tree t;
+        size_t n = size_t(h.n);
+        t._info.resize(n);
+        t._child.resize(n);
+        t._kids.resize(n);
+        in.read(reinterpret_cast<char*>(t._info.data()), std::streamsize(n * sizeof(T)));
+        in.read(reinterpret_cast<char*>(t._child.data()), std::streamsize(n * 4));
+        in.read(reinterpret_cast<char*>(t._kids.data()), std::streamsize(n));
+        if (!in) {
+            throw std::runtime_error("flat_tree::deserialize: the data is cut short");
+        }
+        // the children must come after their parent and stay inside the arrays
+        for (size_t i = 0; i < n; i++) {
+            size_t kids = (t._kids[i] & LEFT ? 1 : 0) + (t._kids[i] & RIGHT ? 1 : 0);
+            if (t._kids[i] > (LEFT | RIGHT) ||
+                (kids && (t._child[i] <= i || t._child[i] + kids > n))) {
+                throw std::runtime_error("flat_tree::deserialize: inconsistent data");
+            }
+        }
+        return t;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the values, the child indexes and the child flags as node overhead,
+     * the object with the headers of the arrays and their spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_info);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_child));
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_kids));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    static constexpr uint8_t LEFT = 1;
+    static constexpr uint8_t RIGHT = 2;
+    static constexpr uint32_t MAGIC = 0x54464c41; // "ALFT"
+    static constexpr uint32_t FORMAT = 1;
+    static constexpr uint32_t ENDIAN_MARK = 0x01020304;
+
+    struct _header {
+        uint32_t magic;
+        uint32_t format;
+        uint32_t value_size;
+        uint32_t byte_order;
+        uint64_t n;
+    };
+
+    std::vector<T> _info;
+    // the index of the first child, the right child is next to the left one
+    std::vector<uint32_t> _child;
+    std::vector<uint8_t> _kids;
+};
+
+#endif
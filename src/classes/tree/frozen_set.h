@@ -0,0 +1,278 @@
+#ifndef FROZEN_SET_H
+#define FROZEN_SET_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief the layouts of the implicit search tree of a frozen_set
+ * eytzinger: breadth first, the root at 1 and the children of k at 2k and 2k + 1.
+ * van_emde_boas: the tree is cut at half its height, the top tree is laid out first and the
+ * bottom trees after it from left to right, each of them cut the same way, so any subtree of
+ * height h fills about 2^h consecutive slots whatever the size of a cache line or a page.
+ */
+enum class frozen_layout { eytzinger, van_emde_boas };
+
+namespace _frozen_set_utils {
+// the number of searches a batched lookup interleaves by default
+constexpr size_t batch_group = 32;
+
+inline void prefetch(const void* p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+} // namespace _frozen_set_utils
+
+/**
+ * @brief frozen set class
+ * An immutable copy of sorted keys in the implicit binary search tree of their ranks, laid out
+ * in one array(Eytzinger or van Emde Boas), built by freeze() on bst, avl_tree and
+ * red_black_tree or straight from sorted keys. A search reads no pointer, goes down one level
+ * per comparison with a branch free step and only touches the nodes of its path, the batched
+ * searches interleave their paths so that their cache misses overlap. The van Emde Boas layout
+ * pads the last level to a complete tree, the padding is never read.
+ * @tparam T the type of the keys, default constructible and ordered by operator<.
+ */
+template <typename T> class frozen_set {
+  public:
+    /**
+     * @brief Construct a new frozen set object
+     * @param sorted: the keys, sorted in ascending order.
+     * @param layout: the layout of the tree. Default = frozen_layout::eytzinger
+     * Throws std::invalid_argument if the keys are not sorted.
+     */
+    explicit frozen_set(std::span<const T> sorted, frozen_layout layout = frozen_layout::eytzinger)
+        : _layout(layout), _size(sorted.size()), _height(unsigned(std::bit_width(sorted.size()))) {
+        for (size_t i = 1; i < sorted.size(); i++) {
+            if (sorted[i] < sorted[i - 1]) {
+                throw std::invalid_argument("frozen_set: keys are not sorted");
+            }
+        }
+        if (_layout == frozen_layout::eytzinger) {
+            _tree.resize(_size + 1);
+        } else {
+            _tree.resize((size_t(1) << _height) - 1);
+            _split(0, _height);
+        }
+        size_t next = 0;
+        std::array<size_t, 64> pos{};
+        _walk(1, 0, pos, [&](size_t p) { _tree[p] = sorted[next++]; });
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of keys.
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief empty function
+     * @return true if the set holds no key.
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief layout function
+     * @return frozen_layout the layout of the tree.
+     */
+    frozen_layout layout() const { return _layout; }
+
+    /**
+     * @brief lower_bound function
+     * @param x: the key to search.
+     * @return const T* the smallest key that is not less than x, nullptr if there is none.
+     */
+    const T* lower_bound(const T& x) const {
+        return _layout == frozen_layout::eytzinger ? _lower_bound<frozen_layout::eytzinger>(x)
+                                                   : _lower_bound<frozen_layout::van_emde_boas>(x);
+    }
+
+    /**
+     * @brief contains function
+     * @param x: the key to search.
+     * @return true if x is one of the keys.
+     */
+    bool contains(const T& x) const {
+        const T* p = lower_bound(x);
+        return p != nullptr && !(x < *p);
+    }
+
+    /**
+     * @brief batch_lower_bound function
+     * @param keys: the keys to search.
+     * @param group: the number of searches that are interleaved. Default = 32
+     * @return std::vector<const T*> lower_bound of every key.
+     * @details the searches of a group go down the tree in lockstep and prefetch their next
+     * node, so up to group cache misses are in flight at once instead of one.
+     */
+    std::vector<const T*> batch_lower_bound(std::span<const std::type_identity_t<T>> keys,
+                                            size_t group = _frozen_set_utils::batch_group) const {
+        std::vector<const T*> out(keys.size(), nullptr);
+        if (_layout == frozen_layout::eytzinger) {
+            _batch<frozen_layout::eytzinger>(keys, group, out);
+        } else {
+            _batch<frozen_layout::van_emde_boas>(keys, group, out);
+        }
+        return out;
+    }
+
+    /**
+     * @brief batch_contains function
+     * @param keys: the keys to search.
+     * @param group: the number of searches that are interleaved. Default = 32
+     * @return std::vector<bool> for every key, true if it is one of the keys of the set.
+     */
+    std::vector<bool> batch_contains(std::span<const std::type_identity_t<T>> keys,
+                                     size_t group = _frozen_set_utils::batch_group) const {
+        std::vector<const T*> found = batch_lower_bound(keys, group);
+        std::vector<bool> out(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            out[i] = found[i] != nullptr && !(keys[i] < *found[i]);
+        }
+        return out;
+    }
+
+    /**
+     * @brief keys function
+     * @return std::vector<T> the keys in ascending order.
+     */
+    std::vector<T> keys() const {
+        std::vector<T> out;
+        out.reserve(_size);
+        std::array<size_t, 64> pos{};
+        _walk(1, 0, pos, [&](size_t p) { out.push_back(_tree[p]); });
+        return out;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bytes of the set, the unused slots of the array are slack.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_tree);
+        const size_t unused = (_tree.size() - _size) * sizeof(T);
+        f.payload -= std::min(f.payload, unused);
+        f.slack += unused;
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    frozen_layout _layout;
+    size_t _size;
+    // the number of levels of the tree
+    unsigned _height;
+    std::vector<T> _tree;
+    // for the node i at depth d of the van Emde Boas layout: the depth of the root of the
+    // recursive subtree it is the root of a bottom tree of, the size of the top tree of that
+    // subtree(2^t - 1, also the mask of the bottom tree i is in) and of every bottom tree
+    std::array<unsigned, 64> _up{};
+    std::array<size_t, 64> _top{};
+    std::array<size_t, 64> _bottom{};
+
+    // cuts the subtree of height h rooted at depth d0, as the layout does
+    void _split(unsigned d0, unsigned h) {
+        if (h <= 1) {
+            return;
+        }
+        unsigned t = h / 2, d = d0 + t;
+        _up[d] = d0;
+        _top[d] = (size_t(1) << t) - 1;
+        _bottom[d] = (size_t(1) << (h - t)) - 1;
+        _split(d0, t);
+        _split(d, h - t);
+    }
+
+    /**
+     * @brief the slot of the node i(breadth first numbering) at depth d, pos holds the slots
+     * of its ancestors
+     */
+    template <frozen_layout L> size_t _slot(size_t i, unsigned d, const size_t* pos) const {
+        if constexpr (L == frozen_layout::eytzinger) {
+            return i;
+        } else {
+            return d == 0 ? 0 : pos[_up[d]] + _top[d] + (i & _top[d]) * _bottom[d];
+        }
+    }
+
+    // calls f with the slots of the nodes of the subtree of i in order
+    template <typename F>
+    void _walk(size_t i, unsigned d, std::array<size_t, 64>& pos, F&& f) const {
+        if (i > _size) {
+            return;
+        }
+        pos[d] = _layout == frozen_layout::eytzinger
+                     ? _slot<frozen_layout::eytzinger>(i, d, pos.data())
+                     : _slot<frozen_layout::van_emde_boas>(i, d, pos.data());
+        const size_t p = pos[d];
+        _walk(2 * i, d + 1, pos, f);
+        f(p);
+        _walk(2 * i + 1, d + 1, pos, f);
+    }
+
+    template <frozen_layout L> const T* _lower_bound(const T& x) const {
+        const T* best = nullptr;
+        size_t pos[64];
+        size_t i = 1;
+        for (unsigned d = 0; i <= _size; d++) {
+            const size_t p = pos[d] = _slot<L>(i, d, pos);
+            if constexpr (L == frozen_layout::eytzinger) {
+                // the 16 descendants four levels down share a cache line or two
+                _frozen_set_utils::prefetch(_tree.data() + std::min(16 * i, _size));
+            }
+            const bool less = _tree[p] < x;
+            best = less ? best : &_tree[p];
+            i = 2 * i + less;
+        }
+        return best;
+    }
+
+    template <frozen_layout L>
+    void _batch(std::span<const T> keys, size_t group, std::vector<const T*>& out) const {
+        group = std::max<size_t>(1, group);
+        std::vector<size_t> node(group), slot(group);
+        std::vector<std::array<size_t, 64>> pos(L == frozen_layout::eytzinger ? 0 : group);
+        for (size_t k0 = 0; k0 < keys.size() && _size > 0; k0 += group) {
+            const size_t g = std::min(group, keys.size() - k0);
+            std::fill(node.begin(), node.begin() + g, 1);
+            std::fill(slot.begin(), slot.begin() + g, _slot<L>(1, 0, nullptr));
+            for (unsigned d = 0; d < _height; d++) {
+                for (size_t q = 0; q < g; q++) {
+                    const size_t i = node[q];
+                    if (i > _size) {
+                        continue;
+                    }
+                    const T& v = _tree[slot[q]];
+                    const bool less = v < keys[k0 + q];
+                    out[k0 + q] = less ? out[k0 + q] : &v;
+                    const size_t next = 2 * i + less;
+                    node[q] = next;
+                    if (next <= _size) {
+                        if constexpr (L == frozen_layout::van_emde_boas) {
+                            pos[q][d] = slot[q];
+                            slot[q] = _slot<L>(next, d + 1, pos[q].data());
+                        } else {
+                            slot[q] = next;
+                        }
+                        _frozen_set_utils::prefetch(_tree.data() + slot[q]);
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef INTERVAL_TREE_H
 #define INTERVAL_TREE_H
 
+#include "../../helpers/archive.h"
+#include "../../helpers/node_pool.h"
+#include "../../helpers/tree_path.h"
+
 #ifdef ENABLE_TREE_VISUALIZATION
 #include "../../visualization/tree_visual/tree_visualization.h"
 #endif
@@ -8,8 +12,9 @@
 #ifdef __cplusplus
 #include <functional>
 #include <iostream>
-#include <memory>
+#include <iterator>
 #include <queue>
+#include <utility>
 #include <vector>
 #endif
 
@@ -36,7 +41,16 @@ template <typename T> class interval_tree {
      *
      * @param i the tree we want to copy
      */
-    inline explicit interval_tree(const interval_tree& i) : root(i.root), _size(i._size) {}
+    inline explicit interval_tree(const interval_tree& i) : root(_copy(i.root)), _size(i._size) {}
+
+    /**
+     * @brief Move constructor for interval tree class
+     *
+     * @param i the tree we want to move, it is left empty
+     */
+    inline interval_tree(interval_tree&& i) noexcept
+        : _pool(std::move(i._pool)), root(std::exchange(i.root, nullptr)),
+          _size(std::exchange(i._size, 0)) {}
 
     /**
      * @brief operator = for interval tree class
@@ -44,17 +58,39 @@ template <typename T> class interval_tree {
      * @return interval_tree&
      */
     inline interval_tree& operator=(const interval_tree& i) {
-        root = i.root;
-        _size = i._size;
+        if (this != &i) {
+            clear();
+            root = _copy(i.root);
+            _size = i._size;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief move assignment for interval tree class
+     * @param i the tree we want to move, it is left empty
+     * @return interval_tree&
+     */
+    inline interval_tree& operator=(interval_tree&& i) noexcept {
+        if (this != &i) {
+            clear();
+            _pool = std::move(i._pool);
+            root = std::exchange(i.root, nullptr);
+            _size = std::exchange(i._size, 0);
+        }
         return *this;
     }
 
-    inline ~interval_tree() { root = nullptr; }
+    inline ~interval_tree() { clear(); }
 
     /**
      * @brief clear function
      */
     inline void clear() {
+        _pool.clear(root, [](node* n, auto visit) {
+            visit(n->left);
+            visit(n->right);
+        });
         root = nullptr;
         _size = 0;
     }
@@ -78,7 +114,7 @@ template <typename T> class interval_tree {
             return false;
         }
         interval i = interval(p);
-        if (this->overlap({root->i->low, root->i->high}, p)) {
+        if (this->overlap({root->i.low, root->i.high}, p)) {
             return true;
         }
         return _search(root, i);
@@ -104,6 +140,31 @@ template <typename T> class interval_tree {
         return i1.high >= i2.low && i1.low <= i2.high;
     }
 
+    /**
+     *@brief query_overlapping function.
+     *@param p: the query interval.
+     *@returns vector<pair<T,T>>, every interval that overlaps p in inorder. The subtrees
+     *whose max ends before p and the right subtrees of the nodes that start after p are
+     *skipped.
+     */
+    inline std::vector<std::pair<T, T>> query_overlapping(std::pair<T, T> p) const {
+        std::vector<std::pair<T, T>> hits;
+        interval q = interval(p);
+        _query(root, q.low, q.high, hits);
+        return hits;
+    }
+
+    /**
+     *@brief query_overlapping function.
+     *@param point: the query point.
+     *@returns vector<pair<T,T>>, every interval that contains point in inorder.
+     */
+    inline std::vector<std::pair<T, T>> query_overlapping(const T& point) const {
+        std::vector<std::pair<T, T>> hits;
+        _query(root, point, point, hits);
+        return hits;
+    }
+
     class Iterator;
 
     /**
@@ -111,9 +172,10 @@ template <typename T> class interval_tree {
      *
      * @return Iterator
      */
-    inline Iterator begin() {
-        std::vector<std::pair<T, T>> ino = this->inorder();
-        return Iterator(0, ino);
+    inline Iterator begin() const {
+        tree_path<node> path(root);
+        path.first();
+        return Iterator(path);
     }
 
     /**
@@ -121,10 +183,7 @@ template <typename T> class interval_tree {
      *
      * @return Iterator
      */
-    inline Iterator end() {
-        std::vector<std::pair<T, T>> ino = this->inorder();
-        return Iterator(ino.size(), ino);
-    }
+    inline Iterator end() const { return Iterator(tree_path<node>(root)); }
 
     /**
      * @brief size function
@@ -133,15 +192,75 @@ template <typename T> class interval_tree {
      */
     inline size_t size() { return _size; }
 
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the intervals, the maxima and links of the nodes, the tree
+     * and the slab table of its pool, and the free slots of the pool
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = _pool.memory_usage(sizeof(interval));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+    /**
+     * @brief save_archive function
+     * Writes the intervals in order of low end as an intervals archive, the low ends in one
+     * array and the high ends in another.
+     * @param path: the output file, overwritten.
+     * Throws std::runtime_error if the file can not be written.
+     */
+    inline void save_archive(const std::string& path) const {
+        std::vector<T> lows, highs;
+        lows.reserve(_size);
+        highs.reserve(_size);
+        for (const auto& [low, high] : *this) {
+            lows.push_back(low);
+            highs.push_back(high);
+        }
+        archive_writer out(path, archive_kind::intervals, _archive_utils::key_size<T>(), _size);
+        out.add(std::span<const T>(lows));
+        out.add(std::span<const T>(highs));
+        out.finish();
+    }
+
+    /**
+     * @brief load_archive function
+     * Builds a balanced tree from an archive in O(n), instead of n inserts.
+     * @param path: a file written by save_archive.
+     * @return interval_tree the tree
+     * Throws std::runtime_error like archive_view, std::invalid_argument if the intervals are
+     * not sorted by low end.
+     */
+    static interval_tree load_archive(const std::string& path) {
+        static_assert(!_archive_utils::string_key<T>,
+                      "interval archives need trivially copyable ends");
+        archive_view archive(path, archive_kind::intervals, _archive_utils::key_size<T>());
+        std::span<const T> lows = archive.section<T>(0), highs = archive.section<T>(1);
+        if (lows.size() != archive.count() || highs.size() != archive.count()) {
+            throw std::runtime_error("Archive " + path + " is corrupted");
+        }
+        for (size_t i = 1; i < lows.size(); i++) {
+            if (lows[i] < lows[i - 1]) {
+                throw std::invalid_argument(
+                    "interval_tree::load_archive: intervals are not sorted");
+            }
+        }
+        interval_tree t;
+        t._pool.reserve(lows.size());
+        t.root = t._build(lows, highs, 0, lows.size());
+        t._size = lows.size();
+        return t;
+    }
+
     /**
      *@brief inorder function.
      *@returns vector<pair<T,T>>, the elements inorder.
      */
     inline std::vector<std::pair<T, T>> inorder() {
         std::vector<std::pair<T, T>> path;
-        _inorder(
-            [&](std::shared_ptr<node> callbacked) {
-                path.push_back({callbacked->i->low, callbacked->i->high});
+        _inorder([&](node* callbacked) {
+                path.push_back({callbacked->i.low, callbacked->i.high});
             },
             root);
         return path;
@@ -153,9 +272,8 @@ template <typename T> class interval_tree {
      */
     inline std::vector<std::pair<T, T>> preorder() {
         std::vector<std::pair<T, T>> path;
-        _preorder(
-            [&](std::shared_ptr<node> callbacked) {
-                path.push_back({callbacked->i->low, callbacked->i->high});
+        _preorder([&](node* callbacked) {
+                path.push_back({callbacked->i.low, callbacked->i.high});
             },
             root);
         return path;
@@ -167,9 +285,8 @@ template <typename T> class interval_tree {
      */
     inline std::vector<std::pair<T, T>> postorder() {
         std::vector<std::pair<T, T>> path;
-        _postorder(
-            [&](std::shared_ptr<node> callbacked) {
-                path.push_back({callbacked->i->low, callbacked->i->high});
+        _postorder([&](node* callbacked) {
+                path.push_back({callbacked->i.low, callbacked->i.high});
             },
             root);
         return path;
@@ -181,15 +298,15 @@ template <typename T> class interval_tree {
      */
     inline std::vector<std::vector<std::pair<T, T>>> level_order() {
         std::vector<std::vector<std::pair<T, T>>> path;
-        std::queue<std::shared_ptr<node>> q;
+        std::queue<node*> q;
         q.push(root);
         while (!q.empty()) {
             size_t size = q.size();
             std::vector<std::pair<T, T>> level;
             for (size_t i = 0; i < size; i++) {
-                std::shared_ptr<node> current = q.front();
+                node* current = q.front();
                 q.pop();
-                level.push_back({current->i->low, current->i->high});
+                level.push_back({current->i.low, current->i.high});
                 if (current->left) {
                     q.push(current->left);
                 }
@@ -248,29 +365,69 @@ template <typename T> class interval_tree {
      *
      */
     struct node {
-        interval* i;
-        int max;
-        std::shared_ptr<node> right;
-        std::shared_ptr<node> left;
-        node(interval n) : i(new interval(n)), max(n.high), right(nullptr), left(nullptr) {}
+        interval i;
+        T max;
+        node* right;
+        node* left;
+        node(interval n) : i(n), max(n.high), right(nullptr), left(nullptr) {}
     };
 
-    std::shared_ptr<node> root;
+    // declared before root, the copy constructor fills root from the pool
+    node_pool<node> _pool;
+    node* root{nullptr};
     size_t _size{};
 
-    std::shared_ptr<node> new_node(interval i) {
-        std::shared_ptr<node> p = std::make_shared<node>(i);
-        return p;
+    node* new_node(interval i) { return _pool.create(i); }
+
+    // the intervals [lo, hi) sorted by low end as a balanced subtree, equal low ends go to
+    // the right like insert puts them
+    node* _build(std::span<const T> lows, std::span<const T> highs, size_t lo, size_t hi) {
+        if (lo == hi) {
+            return nullptr;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        while (mid > lo && !(lows[mid - 1] < lows[mid])) {
+            mid--;
+        }
+        node* nn = new_node(std::pair<T, T>(lows[mid], highs[mid]));
+        nn->left = _build(lows, highs, lo, mid);
+        nn->right = _build(lows, highs, mid + 1, hi);
+        _update(nn);
+        return nn;
+    }
+
+    node* _copy(const node* t) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        node* nn = _pool.create(t->i);
+        nn->max = t->max;
+        nn->left = _copy(t->left);
+        nn->right = _copy(t->right);
+        return nn;
+    }
+
+    /**
+     *@brief recomputes the max of a node from its interval and its children
+     */
+    void _update(node* root) {
+        root->max = root->i.high;
+        if (root->left && root->max < root->left->max) {
+            root->max = root->left->max;
+        }
+        if (root->right && root->max < root->right->max) {
+            root->max = root->right->max;
+        }
     }
 
     /**
      *@brief helper function for insertion
      */
-    std::shared_ptr<node> _insert(std::shared_ptr<node> root, interval i) {
+    node* _insert(node* root, interval i) {
         if (!root) {
             return new_node(i);
         }
-        T l = root->i->low;
+        T l = root->i.low;
         if (i.low < l) {
             root->left = _insert(root->left, i);
         } else {
@@ -285,7 +442,7 @@ template <typename T> class interval_tree {
     /**
      *@brief helper function for search
      */
-    bool _search(std::shared_ptr<node> root, interval i) {
+    bool _search(node* root, interval i) {
         if (!root) {
             return false;
         }
@@ -298,43 +455,51 @@ template <typename T> class interval_tree {
     /**
      *@brief helper function for remove.
      */
-    std::shared_ptr<node> _remove(std::shared_ptr<node> root, interval i) {
+    node* _remove(node* root, interval i) {
         if (!root) {
             return nullptr;
         }
-        std::shared_ptr<node> p = root;
-        while (p) {
-            if (p->i->low > i.low) {
-                p = p->left;
-            } else if (p->i->low < i.low) {
-                p = p->right;
-            } else {
-                if (!p->right && !p->left) {
-                    _size--;
-                    return nullptr;
-                } else if (p->right && !p->left) {
-                    std::shared_ptr<node> temp = root->right;
-                    _size--;
-                    return temp;
-                } else if (p->left && !p->right) {
-                    std::shared_ptr<node> temp = p->left;
-                    _size--;
-                    return temp;
-                } else {
-                    std::shared_ptr<node> temp = root;
-                    while (temp && temp->left) {
-                        temp = temp->left;
-                    }
-                    p->i = temp->i;
-                    p->max = temp->max;
-                    p->right = _remove(p->right, *temp->i);
-                }
+        if (i.low < root->i.low) {
+            root->left = _remove(root->left, i);
+        } else if (root->i.low < i.low || root->i.high != i.high) {
+            // equal lows were inserted to the right
+            root->right = _remove(root->right, i);
+        } else if (!root->left || !root->right) {
+            node* temp = root->left ? root->left : root->right;
+            _pool.destroy(root);
+            _size--;
+            return temp;
+        } else {
+            node* temp = root->right;
+            while (temp->left) {
+                temp = temp->left;
             }
+            root->i = temp->i;
+            root->right = _remove(root->right, temp->i);
         }
+        _update(root);
         return root;
     }
 
-    void _inorder(std::function<void(std::shared_ptr<node>)> callback, std::shared_ptr<node> root) {
+    /**
+     *@brief helper function for query_overlapping
+     */
+    static void _query(const node* root, const T& lo, const T& hi,
+                       std::vector<std::pair<T, T>>& hits) {
+        if (!root || root->max < lo) {
+            return;
+        }
+        _query(root->left, lo, hi, hits);
+        if (hi < root->i.low) {
+            return;
+        }
+        if (!(root->i.high < lo)) {
+            hits.push_back({root->i.low, root->i.high});
+        }
+        _query(root->right, lo, hi, hits);
+    }
+
+    void _inorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             _inorder(callback, root->left);
             callback(root);
@@ -342,8 +507,7 @@ template <typename T> class interval_tree {
         }
     }
 
-    void _postorder(std::function<void(std::shared_ptr<node>)> callback,
-                    std::shared_ptr<node> root) {
+    void _postorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             _postorder(callback, root->left);
             _postorder(callback, root->right);
@@ -351,8 +515,7 @@ template <typename T> class interval_tree {
         }
     }
 
-    void _preorder(std::function<void(std::shared_ptr<node>)> callback,
-                   std::shared_ptr<node> root) {
+    void _preorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             callback(root);
             _preorder(callback, root->left);
@@ -365,35 +528,35 @@ template <typename T> class interval_tree {
         return _generate;
     }
 
-    std::string _inorder_gen(std::shared_ptr<node> root) {
+    std::string _inorder_gen(node* root) {
         std::string _s;
         if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
             if (root->left) {
                 _s += '"';
-                _s += root->i->low;
+                _s += root->i.low;
                 _s += ',';
-                _s += root->i->high;
+                _s += root->i.high;
                 _s += '"';
                 _s += "->";
                 _s += '"';
-                _s += root->left->i->low;
+                _s += root->left->i.low;
                 _s += ',';
-                _s += root->left->i->high;
+                _s += root->left->i.high;
                 _s += '"';
                 _s += "\n";
                 _s += _inorder_gen(root->left);
             }
             if (root->right) {
                 _s += '"';
-                _s += root->i->low;
+                _s += root->i.low;
                 _s += ',';
-                _s += root->i->high;
+                _s += root->i.high;
                 _s += '"';
                 _s += "->";
                 _s += '"';
-                _s += root->right->i->low;
+                _s += root->right->i.low;
                 _s += ',';
-                _s += root->right->i->high;
+                _s += root->right->i.high;
                 _s += '"';
                 _s += "\n";
                 _s += _inorder_gen(root->right);
@@ -401,30 +564,30 @@ template <typename T> class interval_tree {
         } else {
             if (root->left) {
                 _s += '"';
-                _s += std::to_string(root->i->low);
+                _s += std::to_string(root->i.low);
                 _s += ',';
-                _s += std::to_string(root->i->high);
+                _s += std::to_string(root->i.high);
                 _s += '"';
                 _s += "->";
                 _s += '"';
-                _s += std::to_string(root->left->i->low);
+                _s += std::to_string(root->left->i.low);
                 _s += ',';
-                _s += std::to_string(root->left->i->high);
+                _s += std::to_string(root->left->i.high);
                 _s += '"';
                 _s += "\n";
                 _s += _inorder_gen(root->left);
             }
             if (root->right) {
                 _s += '"';
-                _s += std::to_string(root->i->low);
+                _s += std::to_string(root->i.low);
                 _s += ',';
-                _s += std::to_string(root->i->high);
+                _s += std::to_string(root->i.high);
                 _s += '"';
                 _s += "->";
                 _s += '"';
-                _s += std::to_string(root->right->i->low);
+                _s += std::to_string(root->right->i.low);
                 _s += ',';
-                _s += std::to_string(root->right->i->high);
+                _s += std::to_string(root->right->i.high);
                 _s += '"';
                 _s += "\n";
                 _s += _inorder_gen(root->right);
@@ -436,31 +599,27 @@ template <typename T> class interval_tree {
 
 /**
  * @brief Iterator class
+ * Bidirectional inorder iterator that walks the tree lazily: it keeps the path from the
+ * root to the current node, each step costs O(1) amortized and nothing is copied. Any
+ * insert or remove invalidates the iterators of the tree.
  */
 template <typename T> class interval_tree<T>::Iterator {
   private:
-    std::vector<std::pair<T, T>> elements;
-    int64_t index;
+    tree_path<node> _path;
 
   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<T, T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::pair<T, T>;
+
     /**
      * @brief Construct a new Iterator object
      *
-     * @param els vector<pair<T,T>> - the elements in inorder fashion
+     * @param path the path from the root to the current node
      */
-    explicit Iterator(const int64_t& index, std::vector<std::pair<T, T>>& els) noexcept
-        : index(index), elements(els) {}
-
-    /**
-     * @brief = operator for Iterator type
-     *
-     * @param index the current index
-     * @return Iterator&
-     */
-    Iterator& operator=(int64_t index) {
-        this->index = index;
-        return *(this);
-    }
+    explicit Iterator(const tree_path<node>& path) : _path(path) {}
 
     /**
      * @brief operator ++ for type Iterator
@@ -468,9 +627,7 @@ template <typename T> class interval_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator++() {
-        if (this->index < elements.size()) {
-            this->index++;
-        }
+        _path.next();
         return *(this);
     }
 
@@ -491,9 +648,7 @@ template <typename T> class interval_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator--() {
-        if (this->index > 0) {
-            this->index--;
-        }
+        _path.prev();
         return *(this);
     }
 
@@ -508,21 +663,28 @@ template <typename T> class interval_tree<T>::Iterator {
         return it;
     }
 
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both iterators point to the same node
+     */
+    bool operator==(const Iterator& it) const { return _path == it._path; }
+
     /**
      * @brief operator != for type Iterator
      *
      * @param it const Iterator
-     * @return true if index == it.index
-     * @return false otherwise
+     * @return true if the iterators point to different nodes
      */
-    bool operator!=(const Iterator& it) { return index != it.index; }
+    bool operator!=(const Iterator& it) const { return _path != it._path; }
 
     /**
      * @brief operator * for type Iterator
      *
-     * @return std::pair<T,T> the value of the node
+     * @return std::pair<T, T> the element of the current node
      */
-    std::pair<T, T> operator*() { return {elements[index].first, elements[index].second}; }
+    std::pair<T, T> operator*() const { return {_path.node()->i.low, _path.node()->i.high}; }
 };
 
 #endif
@@ -0,0 +1,300 @@
+#ifndef LAZY_SEGMENT_TREE_H
+#define LAZY_SEGMENT_TREE_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#endif
+
+/**
+ * @brief sum monoid
+ * The monoids tell the tree how to combine two segments. repeat(x, len) is the value of
+ * a segment of len elements that all hold x, which the range assignments need.
+ */
+template <typename T> struct sum_monoid {
+    using value_type = T;
+    static T identity() { return T{}; }
+    static T combine(const T& a, const T& b) { return a + b; }
+    static T repeat(const T& x, size_t len) { return x * T(len); }
+};
+
+/**
+ * @brief min monoid
+ */
+template <typename T> struct min_monoid {
+    using value_type = T;
+    static T identity() { return std::numeric_limits<T>::max(); }
+    static T combine(const T& a, const T& b) { return std::min(a, b); }
+    static T repeat(const T& x, size_t) { return x; }
+};
+
+/**
+ * @brief max monoid
+ */
+template <typename T> struct max_monoid {
+    using value_type = T;
+    static T identity() { return std::numeric_limits<T>::lowest(); }
+    static T combine(const T& a, const T& b) { return std::max(a, b); }
+    static T repeat(const T& x, size_t) { return x; }
+};
+
+/**
+ * @brief range add policy
+ * The policies pair a monoid with a lazy tag: apply(f, x, len) is the value of a segment
+ * of len elements of value x after the update f, and compose(f, g) is the update that
+ * does g and then f. The tag of range_add is the number that is added.
+ * @tparam Monoid sum_monoid, min_monoid or max_monoid.
+ */
+template <typename Monoid> struct range_add : Monoid {
+    using value_type = typename Monoid::value_type;
+    using tag_type = value_type;
+    static tag_type tag_identity() { return tag_type{}; }
+    static tag_type compose(const tag_type& f, const tag_type& g) { return f + g; }
+    static value_type apply(const tag_type& f, const value_type& x, size_t len) {
+        return x + Monoid::repeat(f, len);
+    }
+};
+
+/**
+ * @brief range assign policy
+ * The tag of range_assign is the value every element gets, std::nullopt for none.
+ * @tparam Monoid sum_monoid, min_monoid or max_monoid.
+ */
+template <typename Monoid> struct range_assign : Monoid {
+    using value_type = typename Monoid::value_type;
+    using tag_type = std::optional<value_type>;
+    static tag_type tag_identity() { return std::nullopt; }
+    static tag_type compose(const tag_type& f, const tag_type& g) { return f ? f : g; }
+    static value_type apply(const tag_type& f, const value_type& x, size_t len) {
+        return f ? Monoid::repeat(*f, len) : x;
+    }
+};
+
+/**
+ * @brief range assign and add policy
+ * Both kinds of updates on one tree, the tag is an assignment(if any) followed by an
+ * addition. Make the tags with add(x) and assign(x).
+ * @tparam Monoid sum_monoid, min_monoid or max_monoid.
+ */
+template <typename Monoid> struct range_assign_add : Monoid {
+    using value_type = typename Monoid::value_type;
+    struct tag_type {
+        std::optional<value_type> assign;
+        value_type add{};
+    };
+    static tag_type add(const value_type& x) { return {std::nullopt, x}; }
+    static tag_type assign(const value_type& x) { return {x, value_type{}}; }
+    static tag_type tag_identity() { return {}; }
+    static tag_type compose(const tag_type& f, const tag_type& g) {
+        return f.assign ? f : tag_type{g.assign, g.add + f.add};
+    }
+    static value_type apply(const tag_type& f, const value_type& x, size_t len) {
+        value_type y = f.assign ? Monoid::repeat(*f.assign, len) : x;
+        return y + Monoid::repeat(f.add, len);
+    }
+};
+
+/**
+ * @brief lazy segment tree class
+ * Segment tree with lazy propagation over any monoid and update tag given by the Policy,
+ * for range updates and range queries in O(log n). The tree is an implicit array of 2m
+ * values for m the smallest power of two >= n, plus one tag per internal node, and the
+ * queries and updates are iterative: they push the tags down along the two boundary
+ * paths, work bottom-up between them and recompute the boundary paths on the way back,
+ * so they never recurse. Building from a vector costs O(n).
+ * @tparam Policy range_add, range_assign or range_assign_add over a monoid, or any type
+ * with the same members.
+ */
+template <typename Policy> class lazy_segment_tree {
+  public:
+    using value_type = typename Policy::value_type;
+    using tag_type = typename Policy::tag_type;
+
+    /**
+     * @brief Construct a new lazy segment tree object
+     * @param n: the number of elements, they all start as the identity of the monoid.
+     */
+    explicit lazy_segment_tree(size_t n = 0)
+        : _n(n), _size(std::bit_ceil(std::max<size_t>(n, 1))), _log(std::countr_zero(_size)),
+          _d(2 * _size, Policy::identity()), _lz(_size, Policy::tag_identity()) {}
+
+    /**
+     * @brief Construct a new lazy segment tree object, in O(n)
+     * @param v: the elements.
+     */
+    explicit lazy_segment_tree(const std::vector<value_type>& v) : lazy_segment_tree(v.size()) {
+        std::copy(v.begin(), v.end(), _d.begin() + _size);
+        for (size_t k = _size - 1; k >= 1; k--) {
+            _update(k);
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of elements.
+     */
+    size_t size() const { return _n; }
+
+    /**
+     * @brief set function
+     * @param i: the index.
+     * @param x: the new value of the element.
+     * Throws std::out_of_range if i >= size().
+     */
+    void set(size_t i, const value_type& x) {
+        _check(i, i);
+        i += _size;
+        for (int k = _log; k >= 1; k--) {
+            _push(i >> k);
+        }
+        _d[i] = x;
+        for (int k = 1; k <= _log; k++) {
+            _update(i >> k);
+        }
+    }
+
+    /**
+     * @brief get function
+     * @param i: the index.
+     * @return value_type the value of the element.
+     * Throws std::out_of_range if i >= size().
+     */
+    value_type get(size_t i) {
+        _check(i, i);
+        i += _size;
+        for (int k = _log; k >= 1; k--) {
+            _push(i >> k);
+        }
+        return _d[i];
+    }
+
+    /**
+     * @brief query function
+     * @param l: the first index.
+     * @param r: the last index.
+     * @return value_type the combination of the elements of [l, r].
+     * Throws std::out_of_range if l > r or r >= size().
+     */
+    value_type query(size_t l, size_t r) {
+        _check(l, r);
+        l += _size;
+        r += _size + 1;
+        _push_bounds(l, r);
+        value_type left = Policy::identity(), right = Policy::identity();
+        for (; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) {
+                left = Policy::combine(left, _d[l++]);
+            }
+            if (r & 1) {
+                right = Policy::combine(_d[--r], right);
+            }
+        }
+        return Policy::combine(left, right);
+    }
+
+    /**
+     * @brief all function
+     * @return value_type the combination of every element, in O(1).
+     */
+    value_type all() const { return _d[1]; }
+
+    /**
+     * @brief apply function
+     * @param l: the first index.
+     * @param r: the last index.
+     * @param f: the update for every element of [l, r].
+     * Throws std::out_of_range if l > r or r >= size().
+     */
+    void apply(size_t l, size_t r, const tag_type& f) {
+        _check(l, r);
+        l += _size;
+        r += _size + 1;
+        _push_bounds(l, r);
+        for (size_t a = l, b = r; a < b; a >>= 1, b >>= 1) {
+            if (a & 1) {
+                _all_apply(a++, f);
+            }
+            if (b & 1) {
+                _all_apply(--b, f);
+            }
+        }
+        for (int k = 1; k <= _log; k++) {
+            if (((l >> k) << k) != l) {
+                _update(l >> k);
+            }
+            if (((r >> k) << k) != r) {
+                _update((r - 1) >> k);
+            }
+        }
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the leaves that hold elements, the internal nodes, the padding
+     * leaves and the pending updates as node overhead, the object with the headers of the
+     * arrays and their spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_d);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_lz));
+        const size_t leaves = _n * sizeof(value_type);
+        f.node_overhead += f.payload - leaves;
+        f.payload = leaves;
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    size_t _n;
+    // the number of leaves, a power of two
+    size_t _size;
+    int _log;
+    std::vector<value_type> _d;
+    // the pending update of the children of every internal node
+    std::vector<tag_type> _lz;
+
+    void _check(size_t l, size_t r) const {
+        if (l > r || r >= _n) {
+            throw std::out_of_range("lazy_segment_tree: index out of range");
+        }
+    }
+
+    // the number of leaves below node k
+    size_t _width(size_t k) const { return _size >> (std::bit_width(k) - 1); }
+
+    void _update(size_t k) { _d[k] = Policy::combine(_d[2 * k], _d[2 * k + 1]); }
+
+    void _all_apply(size_t k, const tag_type& f) {
+        _d[k] = Policy::apply(f, _d[k], _width(k));
+        if (k < _size) {
+            _lz[k] = Policy::compose(f, _lz[k]);
+        }
+    }
+
+    void _push(size_t k) {
+        _all_apply(2 * k, _lz[k]);
+        _all_apply(2 * k + 1, _lz[k]);
+        _lz[k] = Policy::tag_identity();
+    }
+
+    // pushes the tags of the ancestors of the boundaries of the leaves [l, r)
+    void _push_bounds(size_t l, size_t r) {
+        for (int k = _log; k >= 1; k--) {
+            if (((l >> k) << k) != l) {
+                _push(l >> k);
+            }
+            if (((r >> k) << k) != r) {
+                _push((r - 1) >> k);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef PERSISTENT_SEGMENT_TREE_H
+#define PERSISTENT_SEGMENT_TREE_H
+
+#include "../../helpers/memory_usage.h"
+#include "lazy_segment_tree.h"
+
+#ifdef __cplusplus
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#endif
+
+/**
+ * @brief persistent segment tree class
+ * Segment tree that keeps every version: an update copies the O(log n) nodes on the path
+ * to its leaf and shares the rest with the version it came from, so every version stays
+ * queryable for O(log n) extra nodes per update. The nodes live in one arena vector and
+ * point at their children by 32 bit index, and a version is the index of its root.
+ * Version 0 is the tree built from the constructor.
+ * @tparam Monoid sum_monoid, min_monoid, max_monoid or any type with the same members.
+ */
+template <typename Monoid> class persistent_segment_tree {
+  public:
+    using value_type = typename Monoid::value_type;
+
+    /**
+     * @brief Construct a new persistent segment tree object, version 0 holds v
+     * @param v: the elements.
+     */
+    explicit persistent_segment_tree(const std::vector<value_type>& v = {}) : _n(v.size()) {
+        if (_n) {
+            _nodes.reserve(2 * _n - 1);
+            _roots.push_back(_build(v, 0, _n - 1));
+        } else {
+            _roots.push_back(NONE);
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of elements.
+     */
+    size_t size() const { return _n; }
+
+    /**
+     * @brief versions function
+     * @return size_t the number of versions, the latest one is versions() - 1.
+     */
+    size_t versions() const { return _roots.size(); }
+
+    /**
+     * @brief nodes function
+     * @return size_t the number of nodes of every version together.
+     */
+    size_t nodes() const { return _nodes.size(); }
+
+    /**
+     * @brief reserve function
+     * @param updates: the number of updates to come, so that the arena does not grow
+     * while they run.
+     */
+    void reserve(size_t updates) {
+        size_t depth = std::bit_width(_n) + 1;
+        _nodes.reserve(_nodes.size() + updates * depth);
+        _roots.reserve(_roots.size() + updates);
+    }
+
+    /**
+     * @brief update function
+     * @param version: the version the update starts from.
+     * @param i: the index.
+     * @param x: the new value of the element.
+     * @return size_t the new version.
+     * Throws std::out_of_range for a missing version or i >= size().
+     */
+    size_t update(size_t version, size_t i, const value_type& x) {
+        _check_version(version);
+        _check(i, i);
+        // the arena may move while the path is copied, so the parents are kept by index
+        uint32_t path[2 * sizeof(size_t) * 8];
+        size_t depth = 0, lo = 0, hi = _n - 1;
+        uint32_t old = _roots[version];
+        bool left = false;
+        for (;;) {
+            uint32_t copy = _add(_nodes[old]);
+            if (depth) {
+                node& p = _nodes[path[depth - 1]];
+                (left ? p.left : p.right) = copy;
+            }
+            path[depth++] = copy;
+            if (lo == hi) {
+                _nodes[copy].value = x;
+                break;
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            left = i <= mid;
+            if (left) {
+                old = _nodes[old].left;
+                hi = mid;
+            } else {
+                old = _nodes[old].right;
+                lo = mid + 1;
+            }
+        }
+        for (size_t d = depth - 1; d-- > 0;) {
+            node& p = _nodes[path[d]];
+            p.value = Monoid::combine(_nodes[p.left].value, _nodes[p.right].value);
+        }
+        _roots.push_back(path[0]);
+        return _roots.size() - 1;
+    }
+
+    /**
+     * @brief update function, from the latest version
+     * @param i: the index.
+     * @param x: the new value of the element.
+     * @return size_t the new version.
+     */
+    size_t update(size_t i, const value_type& x) { return update(versions() - 1, i, x); }
+
+    /**
+     * @brief query function
+     * @param version: the version to query.
+     * @param l: the first index.
+     * @param r: the last index.
+     * @return value_type the combination of the elements of [l, r] as of version.
+     * Throws std::out_of_range for a missing version, l > r or r >= size().
+     */
+    value_type query(size_t version, size_t l, size_t r) const {
+        _check_version(version);
+        _check(l, r);
+        return _query(_roots[version], 0, _n - 1, l, r);
+    }
+
+    /**
+     * @brief get function
+     * @param version: the version to query.
+     * @param i: the index.
+     * @return value_type the value of the element as of version.
+     */
+    value_type get(size_t version, size_t i) const { return query(version, i, i); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the values of the nodes, their links and the roots of the versions
+     * as node overhead, the object with the headers of the arrays and their spare capacity.
+     * Every version shares the nodes it did not change, so the payload grows with the updates.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_nodes);
+        const size_t values = _nodes.size() * sizeof(value_type);
+        f.node_overhead += f.payload - values;
+        f.payload = values;
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_roots));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct node {
+        value_type value;
+        uint32_t left{NONE};
+        uint32_t right{NONE};
+    };
+
+    size_t _n;
+    std::vector<node> _nodes;
+    std::vector<uint32_t> _roots;
+
+    void _check(size_t l, size_t r) const {
+        if (l > r || r >= _n) {
+            throw std::out_of_range("persistent_segment_tree: index out of range");
+        }
+    }
+
+    void _check_version(size_t version) const {
+        if (version >= _roots.size()) {
+            throw std::out_of_range("persistent_segment_tree: no such version");
+        }
+    }
+
+    uint32_t _add(const node& x) {
+        if (_nodes.size() >= size_t(NONE)) {
+            throw std::length_error("persistent_segment_tree: too many nodes");
+        }
+        // x may live in the arena itself
+        node copy = x;
+        _nodes.push_back(copy);
+        return uint32_t(_nodes.size() - 1);
+    }
+
+    uint32_t _build(const std::vector<value_type>& v, size_t lo, size_t hi) {
+        if (lo == hi) {
+            return _add({v[lo]});
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        uint32_t l = _build(v, lo, mid), r = _build(v, mid + 1, hi);
+        return _add({Monoid::combine(_nodes[l].value, _nodes[r].value), l, r});
+    }
+
+    value_type _query(uint32_t x, size_t lo, size_t hi, size_t l, size_t r) const {
+        if (l <= lo && hi <= r) {
+            return _nodes[x].value;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        if (r <= mid) {
+            return _query(_nodes[x].left, lo, mid, l, r);
+        }
+        if (l > mid) {
+            return _query(_nodes[x].right, mid + 1, hi, l, r);
+        }
+        return Monoid::combine(_query(_nodes[x].left, lo, mid, l, r),
+                               _query(_nodes[x].right, mid + 1, hi, l, r));
+    }
+};
+
+#endif
@@ -0,0 +1,378 @@
+#ifndef RADIX_TRIE_H
+#define RADIX_TRIE_H
+
+#include "../../helpers/node_pool.h"
+#include "double_array_trie.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief radix trie class
+ * Compressed(Patricia) trie over the bytes of the keys: the chains of nodes with a single
+ * child and no key are merged into one edge, so there are at most 2n nodes for n keys
+ * however long they are, and every node keeps its children sorted by their first byte.
+ * The nodes come from a node_pool. Lookups take string_views and allocate nothing.
+ * freeze() turns the trie into a double_array_trie for dictionaries that stop changing.
+ */
+class radix_trie {
+  public:
+    /**
+     * @brief Construct a new radix trie object
+     * @param v: the keys to insert.
+     */
+    inline explicit radix_trie(const std::vector<std::string>& v = {})
+        : _root(_pool.create()) {
+        for (const std::string& x : v) {
+            insert(x);
+        }
+    }
+
+    /**
+     * @brief Copy constructor for radix trie class
+     * @param t the trie we want to copy
+     */
+    inline radix_trie(const radix_trie& t) : _root(_copy(t._root)), _size(t._size) {}
+
+    /**
+     * @brief operator = for radix trie class
+     * @param t the trie we want to copy
+     * @return radix_trie&
+     */
+    inline radix_trie& operator=(const radix_trie& t) {
+        if (this != &t) {
+            _release();
+            _root = _copy(t._root);
+            _size = t._size;
+        }
+        return *this;
+    }
+
+    inline ~radix_trie() { _release(); }
+
+    /**
+     * @brief clear function
+     */
+    inline void clear() {
+        _release();
+        _root = _pool.create();
+        _size = 0;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of keys.
+     */
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief empty function
+     * @return true if the trie holds no keys.
+     */
+    inline bool empty() const { return _size == 0; }
+
+    /**
+     * @brief insert function
+     * @param key: the key to insert.
+     * @return true if the key was not in the trie.
+     */
+    inline bool insert(std::string_view key) {
+        node* n = _root;
+        size_t i = 0;
+        for (;;) {
+            if (i == key.size()) {
+                if (n->terminal) {
+                    return false;
+                }
+                n->terminal = true;
+                _size++;
+                return true;
+            }
+            auto it = _child(n, key[i]);
+            if (it == n->children.end() || (*it)->label[0] != key[i]) {
+                node* leaf = _pool.create();
+                leaf->label = key.substr(i);
+                leaf->terminal = true;
+                n->children.insert(it, leaf);
+                _size++;
+                return true;
+            }
+            node* c = *it;
+            size_t m = _common(c->label, key.substr(i));
+            if (m < c->label.size()) {
+                // the key leaves the edge halfway, split it
+                node* mid = _pool.create();
+                mid->label = c->label.substr(0, m);
+                c->label.erase(0, m);
+                mid->children.push_back(c);
+                *it = mid;
+                c = mid;
+            }
+            n = c;
+            i += m;
+        }
+    }
+
+    /**
+     * @brief remove function
+     * @param key: the key to remove.
+     * @return true if the key was in the trie.
+     */
+    inline bool remove(std::string_view key) {
+        node* parent = nullptr;
+        node* n = _root;
+        size_t i = 0;
+        while (i < key.size()) {
+            auto it = _child(n, key[i]);
+            if (it == n->children.end() || (*it)->label[0] != key[i] ||
+                key.substr(i, (*it)->label.size()) != (*it)->label) {
+                return false;
+            }
+            parent = n;
+            n = *it;
+            i += n->label.size();
+        }
+        if (!n->terminal) {
+            return false;
+        }
+        n->terminal = false;
+        _size--;
+        if (n == _root) {
+            return true;
+        }
+        if (n->children.empty()) {
+            parent->children.erase(_child(parent, n->label[0]));
+            _pool.destroy(n);
+            if (parent != _root && !parent->terminal && parent->children.size() == 1) {
+                _merge(parent);
+            }
+        } else if (n->children.size() == 1) {
+            _merge(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief search function
+     * @param key: the key to search.
+     * @return true if the key exists.
+     */
+    inline bool search(std::string_view key) const {
+        auto [n, matched] = _walk(key);
+        return n && n->terminal && matched == key.size();
+    }
+
+    /**
+     * @brief starts_with function
+     * @param prefix: the prefix.
+     * @return true if some key starts with prefix.
+     */
+    inline bool starts_with(std::string_view prefix) const {
+        return _walk(prefix).first != nullptr;
+    }
+
+    /**
+     * @brief longest_prefix_match function
+     * @param text: the text to match.
+     * @return std::optional<size_t> the length of the longest key that is a prefix of text,
+     * std::nullopt if no key is.
+     */
+    inline std::optional<size_t> longest_prefix_match(std::string_view text) const {
+        std::optional<size_t> best;
+        const node* n = _root;
+        size_t i = 0;
+        for (;;) {
+            if (n->terminal) {
+                best = i;
+            }
+            if (i == text.size()) {
+                return best;
+            }
+            auto it = _child(n, text[i]);
+            if (it == n->children.end() || (*it)->label[0] != text[i] ||
+                text.substr(i, (*it)->label.size()) != (*it)->label) {
+                return best;
+            }
+            n = *it;
+            i += n->label.size();
+        }
+    }
+
+    /**
+     * @brief with_prefix function
+     * Visits every key that starts with prefix in sorted order, the keys are built in one
+     * buffer that grows and shrinks with the depth.
+     * @param prefix: the prefix.
+     * @param visit: called with every key.
+     */
+    template <typename Visit> void with_prefix(std::string_view prefix, Visit visit) const {
+        auto [n, matched] = _walk(prefix);
+        if (n == nullptr) {
+            return;
+        }
+        // the walk may stop inside the label of n
+        std::string key(prefix.substr(0, matched - n->label.size()));
+        _enumerate(n, key, visit);
+    }
+
+    /**
+     * @brief keys_with_prefix function
+     * @param prefix: the prefix.
+     * @return vector<string> every key that starts with prefix, sorted.
+     */
+    inline std::vector<std::string> keys_with_prefix(std::string_view prefix) const {
+        std::vector<std::string> keys;
+        with_prefix(prefix, [&](const std::string& k) { keys.push_back(k); });
+        return keys;
+    }
+
+    /**
+     * @brief freeze function
+     * @return double_array_trie the keys of the trie in a double array, key ids are their
+     * ranks in sorted order.
+     */
+    inline double_array_trie freeze() const { return double_array_trie(keys_with_prefix("")); }
+
+    /**
+     * @brief nodes function
+     * @return size_t the number of nodes, the root included.
+     */
+    inline size_t nodes() const { return _pool.size(); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the bytes of the labels, the nodes with their child vectors,
+     * the trie, and the spare room of the labels and of the pool
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = _pool.memory_usage(0);
+        std::vector<const node*> stack = {_root};
+        while (!stack.empty()) {
+            const node* n = stack.back();
+            stack.pop_back();
+            // a short label is in the slot, a long one adds its block
+            MEMORY::footprint label = MEMORY::memory_usage(n->label);
+            f.payload += label.payload;
+            f.slack += label.slack;
+            f.node_overhead += label.control;
+            f.node_overhead -= sizeof(n->label);
+            f.node_overhead += MEMORY::memory_usage(n->children).total() - sizeof(n->children);
+            stack.insert(stack.end(), n->children.begin(), n->children.end());
+        }
+        f.control += sizeof(*this);
+        return f;
+    }
+
+    inline friend std::ostream& operator<<(std::ostream& out, const radix_trie& t) {
+        t.with_prefix("", [&](const std::string& k) { out << k << '\n'; });
+        return out;
+    }
+
+  private:
+    /**
+     * @brief struct for the node
+     * @param label: the bytes on the edge from the parent, empty for the root only
+     * @param children: the children sorted by the first byte of their label
+     * @param terminal: true if a key ends here
+     */
+    struct node {
+        std::string label;
+        std::vector<node*> children;
+        bool terminal{false};
+    };
+
+    node_pool<node> _pool;
+    node* _root;
+    size_t _size{0};
+
+    static bool _before(const node* c, char b) {
+        return static_cast<unsigned char>(c->label[0]) < static_cast<unsigned char>(b);
+    }
+
+    static std::vector<node*>::iterator _child(node* n, char b) {
+        return std::lower_bound(n->children.begin(), n->children.end(), b, _before);
+    }
+
+    static std::vector<node*>::const_iterator _child(const node* n, char b) {
+        return std::lower_bound(n->children.begin(), n->children.end(), b, _before);
+    }
+
+    static size_t _common(std::string_view a, std::string_view b) {
+        size_t n = std::min(a.size(), b.size()), i = 0;
+        while (i < n && a[i] == b[i]) {
+            i++;
+        }
+        return i;
+    }
+
+    // the first node whose path covers key, nullptr if no key starts with it, and the
+    // length of that path(past the end of key if it stops inside the label of the node)
+    std::pair<const node*, size_t> _walk(std::string_view key) const {
+        const node* n = _root;
+        size_t i = 0;
+        while (i < key.size()) {
+            auto it = _child(n, key[i]);
+            if (it == n->children.end() || (*it)->label[0] != key[i]) {
+                return {nullptr, 0};
+            }
+            n = *it;
+            size_t m = _common(n->label, key.substr(i));
+            if (m < n->label.size() && i + m < key.size()) {
+                return {nullptr, 0};
+            }
+            i += n->label.size();
+        }
+        return {n, i};
+    }
+
+    // n has a single child and no key, they become one node
+    void _merge(node* n) {
+        node* c = n->children[0];
+        n->label += c->label;
+        n->terminal = c->terminal;
+        n->children = std::move(c->children);
+        _pool.destroy(c);
+    }
+
+    template <typename Visit>
+    static void _enumerate(const node* n, std::string& key, Visit& visit) {
+        size_t len = key.size();
+        key += n->label;
+        if (n->terminal) {
+            visit(static_cast<const std::string&>(key));
+        }
+        for (const node* c : n->children) {
+            _enumerate(c, key, visit);
+        }
+        key.resize(len);
+    }
+
+    node* _copy(const node* t) {
+        node* nn = _pool.create();
+        nn->label = t->label;
+        nn->terminal = t->terminal;
+        nn->children.reserve(t->children.size());
+        for (const node* c : t->children) {
+            nn->children.push_back(_copy(c));
+        }
+        return nn;
+    }
+
+    void _release() {
+        _pool.clear(_root, [](node* n, auto visit) {
+            for (node* c : n->children) {
+                visit(c);
+            }
+        });
+        _root = nullptr;
+    }
+};
+
+#endif
@@ -1,6 +1,11 @@
 #ifndef RED_BLACK_TREE_H
 #define RED_BLACK_TREE_H
 
+#include "../../helpers/archive.h"
+#include "../../helpers/node_pool.h"
+#include "../../helpers/tree_path.h"
+#include "frozen_set.h"
+
 #ifdef ENABLE_TREE_VISUALIZATION
 #include "../../visualization/tree_visual/tree_visualization.h"
 #endif
@@ -8,8 +13,10 @@
 #ifdef __cplusplus
 #include <bitset>
 #include <functional>
-#include <memory>
+#include <iterator>
 #include <queue>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
@@ -22,6 +29,7 @@ template <typename T> class red_black_tree {
      *@brief Struct for the node type pointer.
      *@param info: the value of the node.
      *@param is_red: colour of the node, 1 if node is red, 0 if node is black.
+     *@param size: the number of nodes of its subtree.
      *@param parent: pointer to the parent.
      *@param left: pointer to the left.
      *@param right: pointer to the right.
@@ -29,18 +37,72 @@ template <typename T> class red_black_tree {
     typedef struct node {
         T info;
         std::bitset<1> is_red;
-        std::shared_ptr<node> parent;
-        std::shared_ptr<node> right;
-        std::shared_ptr<node> left;
-        node(T key, std::shared_ptr<node> p)
+        size_t size{1};
+        node* parent;
+        node* right;
+        node* left;
+        node(T key, node* p)
             : info(key), is_red(1), parent(p), right(nullptr), left(nullptr) {}
     } node;
 
-    std::shared_ptr<node> root;
+    // declared before root, the copy constructor fills root from the pool
+    node_pool<node> _pool;
+    node* root;
     size_t _size{};
 
-    void _left_rotate(std::shared_ptr<node> t_node) {
-        std::shared_ptr<node> x = t_node->right;
+    static size_t count(const node* t) { return t ? t->size : 0; }
+
+    static void _update(node* t) { t->size = 1 + count(t->left) + count(t->right); }
+
+    // one node below from was unlinked
+    static void _shrink(node* from) {
+        for (; from != nullptr; from = from->parent) {
+            from->size--;
+        }
+    }
+
+    // the number of elements smaller than key, or not greater than key if inclusive
+    size_t _rank(const T& key, bool inclusive) const {
+        size_t r = 0;
+        for (node* t = root; t != nullptr;) {
+            if (t->info < key || (inclusive && !(key < t->info))) {
+                r += count(t->left) + 1;
+                t = t->right;
+            } else {
+                t = t->left;
+            }
+        }
+        return r;
+    }
+
+    node* _build(const std::vector<T>& sorted, size_t lo, size_t hi, node* parent, size_t depth,
+                 size_t red) {
+        if (lo == hi) {
+            return nullptr;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        node* nn = _pool.create(sorted[mid], parent);
+        nn->is_red = depth == red;
+        nn->left = _build(sorted, lo, mid, nn, depth + 1, red);
+        nn->right = _build(sorted, mid + 1, hi, nn, depth + 1, red);
+        nn->size = hi - lo;
+        return nn;
+    }
+
+    node* _copy(const node* t, node* parent) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        node* nn = _pool.create(t->info, parent);
+        nn->is_red = t->is_red;
+        nn->size = t->size;
+        nn->left = _copy(t->left, nn);
+        nn->right = _copy(t->right, nn);
+        return nn;
+    }
+
+    void _left_rotate(node* t_node) {
+        node* x = t_node->right;
         x->parent = t_node->parent;
         if (t_node->parent == nullptr)
             this->root = x;
@@ -54,10 +116,12 @@ template <typename T> class red_black_tree {
             t_node->right->parent = t_node;
         x->left = t_node;
         t_node->parent = x;
+        x->size = t_node->size;
+        _update(t_node);
     }
 
-    void _right_rotate(std::shared_ptr<node> t_node) {
-        std::shared_ptr<node> x = t_node->left;
+    void _right_rotate(node* t_node) {
+        node* x = t_node->left;
         x->parent = t_node->parent;
         if (t_node->parent == nullptr)
             this->root = x;
@@ -71,13 +135,15 @@ template <typename T> class red_black_tree {
             t_node->left->parent = t_node;
         x->right = t_node;
         t_node->parent = x;
+        x->size = t_node->size;
+        _update(t_node);
     }
 
-    void _insert(std::shared_ptr<node> t_node) {
+    void _insert(node* t_node) {
         while (t_node->parent && t_node->parent->is_red == 1) {
-            std::shared_ptr<node> grand_parent = t_node->parent->parent;
+            node* grand_parent = t_node->parent->parent;
             if (t_node->parent == grand_parent->left) {
-                std::shared_ptr<node> uncle = grand_parent->right;
+                node* uncle = grand_parent->right;
                 if (uncle && uncle->is_red == 1) {
                     grand_parent->is_red = 1;
                     uncle->is_red = 0;
@@ -95,7 +161,7 @@ template <typename T> class red_black_tree {
                     _right_rotate(grand_parent);
                 }
             } else {
-                std::shared_ptr<node> uncle = grand_parent->left;
+                node* uncle = grand_parent->left;
                 if (uncle && uncle->is_red == 1) {
                     grand_parent->is_red = 1;
                     uncle->is_red = 0;
@@ -117,10 +183,10 @@ template <typename T> class red_black_tree {
         this->root->is_red = 0;
     }
 
-    void _remove_helper(std::shared_ptr<node> t_node) {
+    void _remove_helper(node* t_node) {
         if (t_node == this->root)
             return;
-        std::shared_ptr<node> sibling;
+        node* sibling;
         if (t_node->parent->left == t_node)
             sibling = t_node->parent->right;
         else
@@ -170,12 +236,12 @@ template <typename T> class red_black_tree {
         }
     }
 
-    void _remove(std::shared_ptr<node> t_node) {
+    void _remove(node* t_node) {
         if (t_node == nullptr)
             return;
-        std::shared_ptr<node> replace = nullptr;
+        node* replace = nullptr;
         if (t_node->left && t_node->right) {
-            std::shared_ptr<node> tmp = t_node->right;
+            node* tmp = t_node->right;
             while (tmp->left)
                 tmp = tmp->left;
             replace = tmp;
@@ -187,10 +253,13 @@ template <typename T> class red_black_tree {
             if (t_node == this->root)
                 this->root = nullptr;
             else {
+                // the leaf stays linked during the fixup, it counts for nothing already
+                t_node->size = 0;
+                _shrink(t_node->parent);
                 if (t_node->is_red == 0)
                     _remove_helper(t_node);
                 else {
-                    std::shared_ptr<node> sibling = nullptr;
+                    node* sibling = nullptr;
                     if (t_node->parent->left == t_node)
                         sibling = t_node->parent->right;
                     else
@@ -203,6 +272,8 @@ template <typename T> class red_black_tree {
                 else
                     t_node->parent->right = nullptr;
             }
+            _pool.destroy(t_node);
+            _size -= 1;
             return;
         }
         if (t_node->left == nullptr || t_node->right == nullptr) {
@@ -211,17 +282,22 @@ template <typename T> class red_black_tree {
                 t_node->left = nullptr;
                 t_node->right = nullptr;
                 t_node->is_red = 0;
+                t_node->size = 1;
+                _pool.destroy(replace);
             } else {
                 if (t_node->parent->left == t_node)
                     t_node->parent->left = replace;
                 else
                     t_node->parent->right = replace;
                 replace->parent = t_node->parent;
+                _shrink(replace->parent);
                 if (replace->is_red == 0 && t_node->is_red == 0)
                     _remove_helper(replace);
                 else
                     replace->is_red = 0;
+                _pool.destroy(t_node);
             }
+            _size -= 1;
             return;
         }
         t_node->info = replace->info;
@@ -229,7 +305,7 @@ template <typename T> class red_black_tree {
     }
 
     bool _search(T& key) {
-        std::shared_ptr<node> t_node = this->root;
+        node* t_node = this->root;
         while (t_node) {
             if (key < t_node->info)
                 t_node = t_node->left;
@@ -241,7 +317,7 @@ template <typename T> class red_black_tree {
         return false;
     }
 
-    void _inorder(std::function<void(T)> callback, std::shared_ptr<node> t_node) const {
+    void _inorder(std::function<void(T)> callback, node* t_node) const {
         if (t_node) {
             _inorder(callback, t_node->left);
             callback(t_node->info);
@@ -249,7 +325,7 @@ template <typename T> class red_black_tree {
         }
     }
 
-    void _postorder(std::function<void(T)> callback, std::shared_ptr<node> t_node) const {
+    void _postorder(std::function<void(T)> callback, node* t_node) const {
         if (t_node) {
             _postorder(callback, t_node->left);
             _postorder(callback, t_node->right);
@@ -257,7 +333,7 @@ template <typename T> class red_black_tree {
         }
     }
 
-    void _preorder(std::function<void(T)> callback, std::shared_ptr<node> t_node) const {
+    void _preorder(std::function<void(T)> callback, node* t_node) const {
         if (t_node) {
             callback(t_node->info);
             _preorder(callback, t_node->left);
@@ -265,7 +341,7 @@ template <typename T> class red_black_tree {
         }
     }
 
-    std::string _vis_gen(std::shared_ptr<node> t_node, T parent_info) {
+    std::string _vis_gen(node* t_node, T parent_info) {
         std::string _s = "";
         if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
             _s += t_node->info + " [shape=circle fontcolor=black color=";
@@ -296,8 +372,13 @@ template <typename T> class red_black_tree {
      *@brief Contructor for red black tree class.
      *@param _elements: you can directly pass a vector<T> so you don't have to do
      *insert multiple times.
+     *@param resource: the memory resource the nodes come from. Default =
+     *std::pmr::get_default_resource()
      */
-    inline explicit red_black_tree(std::vector<T> _elements = {}) noexcept : root(nullptr) {
+    inline explicit red_black_tree(std::vector<T> _elements = {},
+                                   std::pmr::memory_resource* resource =
+                                       std::pmr::get_default_resource()) noexcept
+        : _pool(resource), root(nullptr) {
         for (T& x : _elements) {
             this->insert(x);
         }
@@ -307,12 +388,98 @@ template <typename T> class red_black_tree {
      * @brief Copy constructor for red black tree class
      * @param rb the tree we want to copy
      */
-    inline explicit red_black_tree(const red_black_tree& rb) : root(rb.root), _size(rb._size) {}
+    inline explicit red_black_tree(const red_black_tree& rb)
+        : root(_copy(rb.root, nullptr)), _size(rb._size) {}
+
+    /**
+     * @brief Move constructor for red black tree class
+     * @param rb the tree we want to move, it is left empty
+     */
+    inline red_black_tree(red_black_tree&& rb) noexcept
+        : _pool(std::move(rb._pool)), root(std::exchange(rb.root, nullptr)),
+          _size(std::exchange(rb._size, 0)) {}
 
     /**
      * @brief Destructor for red black tree class
      */
-    inline ~red_black_tree() noexcept { root = nullptr; }
+    inline ~red_black_tree() noexcept { clear(); }
+
+    /**
+     * @brief move assignment for red black tree class
+     * @param rb the tree we want to move, it is left empty
+     * @return red_black_tree&
+     */
+    inline red_black_tree& operator=(red_black_tree&& rb) noexcept {
+        if (this != &rb) {
+            clear();
+            _pool = std::move(rb._pool);
+            root = std::exchange(rb.root, nullptr);
+            _size = std::exchange(rb._size, 0);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief from_sorted function
+     * Builds a perfectly balanced tree in O(n) instead of n inserts: every level is black
+     * except the deepest one, which is red when it is not full.
+     * @param sorted: the elements in non decreasing order.
+     * @return red_black_tree the new tree
+     * Throws std::invalid_argument if the elements are not sorted.
+     */
+    static red_black_tree from_sorted(const std::vector<T>& sorted) {
+        for (size_t i = 1; i < sorted.size(); i++) {
+            if (sorted[i] < sorted[i - 1]) {
+                throw std::invalid_argument(
+                    "red_black_tree::from_sorted: elements are not sorted");
+            }
+        }
+        red_black_tree rb;
+        size_t n = sorted.size(), depth = 0;
+        while ((size_t(2) << depth) - 1 < n) {
+            depth++;
+        }
+        // a perfect tree is black all the way down
+        size_t red = (size_t(2) << depth) - 1 == n ? depth + 1 : depth;
+        rb._pool.reserve(n);
+        rb.root = rb._build(sorted, 0, n, nullptr, 0, red);
+        rb._size = n;
+        return rb;
+    }
+
+    /**
+     * @brief save_archive function
+     * Writes the elements in order as a sorted_keys archive, which sorted_archive queries in place
+     * and load_archive turns back into a tree.
+     * @param path: the output file, overwritten.
+     * Throws std::runtime_error if the file can not be written.
+     */
+    inline void save_archive(const std::string& path) const {
+        save_sorted_archive(inorder(), path);
+    }
+
+    /**
+     * @brief load_archive function
+     * Builds the tree of an archive with from_sorted in O(n), instead of n inserts.
+     * @param path: a file written by save_archive.
+     * @return red_black_tree the tree
+     * Throws std::runtime_error like archive_view.
+     */
+    static red_black_tree load_archive(const std::string& path) {
+        return from_sorted(sorted_archive<T>(path).keys());
+    }
+
+    /**
+     * @brief freeze function
+     * Copies the elements into an immutable implicit search tree, for the sets that are read
+     * far more often than they change.
+     * @param layout: the layout of the frozen tree. Default = frozen_layout::eytzinger
+     * @return frozen_set<T> the elements of the tree
+     */
+    frozen_set<T> freeze(frozen_layout layout = frozen_layout::eytzinger) const {
+        const std::vector<T> sorted = inorder();
+        return frozen_set<T>(sorted, layout);
+    }
 
     /**
      * @brief operator = for red black tree class
@@ -320,17 +487,22 @@ template <typename T> class red_black_tree {
      * @return red_black_tree&
      */
     inline red_black_tree<T>& operator=(const red_black_tree<T>& rb) {
-        root = rb.root;
-        _size = rb._size;
+        if (this != &rb) {
+            clear();
+            root = _copy(rb.root, nullptr);
+            _size = rb._size;
+        }
         return *this;
     }
 
     /**
      * @brief operator == for red black tree class
      * @param rb the tree we want to compare
-     * @return true if they are same, false otherwise
+     * @return true if they hold the same elements, false otherwise
      */
-    inline bool operator==(const red_black_tree<T>& rb) const { return this->root == rb.root; }
+    inline bool operator==(const red_black_tree<T>& rb) const {
+        return _size == rb._size && inorder() == rb.inorder();
+    }
 
     /**
      *@brief search function.
@@ -344,16 +516,17 @@ template <typename T> class red_black_tree {
      *@param key: key to be inserted.
      */
     inline void insert(T key) {
-        std::shared_ptr<node> p = nullptr;
-        std::shared_ptr<node> x = this->root;
+        node* p = nullptr;
+        node* x = this->root;
         while (x) {
             p = x;
+            x->size++;
             if (key < x->info)
                 x = x->left;
             else
                 x = x->right;
         }
-        std::shared_ptr<node> t_node = std::make_shared<node>(key, p);
+        node* t_node = _pool.create(key, p);
         if (p == nullptr)
             this->root = t_node;
         else {
@@ -371,7 +544,7 @@ template <typename T> class red_black_tree {
      *@param key: key to be removed.
      */
     inline void remove(T key) {
-        std::shared_ptr<node> t_node = root;
+        node* t_node = root;
         while (t_node && t_node->info != key) {
             if (key < t_node->info)
                 t_node = t_node->left;
@@ -379,7 +552,6 @@ template <typename T> class red_black_tree {
                 t_node = t_node->right;
         }
         _remove(t_node);
-        _size -= 1;
     }
 
     /**
@@ -389,10 +561,39 @@ template <typename T> class red_black_tree {
      */
     inline size_t size() const { return _size; }
 
+    /**
+     * @brief resource function
+     *
+     * @return std::pmr::memory_resource* the resource the nodes come from
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _pool.resource(); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the elements, the colors, sizes and links of the nodes, the tree
+     * and the slab table of its pool, and the free slots of the pool
+     */
+    MEMORY::footprint memory_usage() const {
+        size_t owned = MEMORY::owned(
+            root,
+            [](const node* n, auto visit) {
+                visit(n->left);
+                visit(n->right);
+            },
+            [](const node* n) -> const T& { return n->info; });
+        MEMORY::footprint f = _pool.memory_usage(sizeof(T), owned);
+        f.control += sizeof(*this);
+        return f;
+    }
+
     /**
      * @brief clear function
      */
     inline void clear() {
+        _pool.clear(root, [](node* n, auto visit) {
+            visit(n->left);
+            visit(n->right);
+        });
         root = nullptr;
         _size = 0;
     }
@@ -433,13 +634,16 @@ template <typename T> class red_black_tree {
      */
     inline std::vector<std::vector<T>> level_order() const {
         std::vector<std::vector<T>> path;
-        std::queue<std::shared_ptr<node>> q;
+        if (root == nullptr) {
+            return path;
+        }
+        std::queue<node*> q;
         q.push(root);
         while (!q.empty()) {
             size_t size = q.size();
             std::vector<T> level;
             for (size_t i = 0; i < size; i++) {
-                std::shared_ptr<node> current = q.front();
+                node* current = q.front();
                 q.pop();
                 level.push_back(current->info);
                 if (current->left) {
@@ -474,18 +678,93 @@ template <typename T> class red_black_tree {
      * @brief pointer that points to begin
      * @return Iterator
      */
-    inline Iterator begin() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(0, ino);
+    inline Iterator begin() const {
+        tree_path<node> path(root);
+        path.first();
+        return Iterator(path);
     }
 
     /**
      * @brief pointer that points to end
      * @return Iterator
      */
-    inline Iterator end() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(ino.size(), ino);
+    inline Iterator end() const { return Iterator(tree_path<node>(root)); }
+
+    /**
+     * @brief rank function
+     * @param key: the key we want to rank.
+     * @return size_t the number of elements smaller than key, in O(log n).
+     */
+    inline size_t rank(const T& key) const { return _rank(key, false); }
+
+    /**
+     * @brief select function
+     * @param k: the position in sorted order, starting from 0.
+     * @return const T& the k-th smallest element, in O(log n).
+     * Throws std::out_of_range if k >= size().
+     */
+    inline const T& select(size_t k) const {
+        if (k >= count(root)) {
+            throw std::out_of_range("red_black_tree::select: k is out of range");
+        }
+        node* t = root;
+        while (count(t->left) != k) {
+            if (k < count(t->left)) {
+                t = t->left;
+            } else {
+                k -= count(t->left) + 1;
+                t = t->right;
+            }
+        }
+        return t->info;
+    }
+
+    /**
+     * @brief lower_bound function
+     * @param key: the key we want to search.
+     * @return Iterator to the first element that is not smaller than key, end() if none.
+     */
+    inline Iterator lower_bound(const T& key) const {
+        tree_path<node> path(root);
+        path.seek([&](const node* t) { return !(t->info < key); });
+        return Iterator(path);
+    }
+
+    /**
+     * @brief upper_bound function
+     * @param key: the key we want to search.
+     * @return Iterator to the first element that is greater than key, end() if none.
+     */
+    inline Iterator upper_bound(const T& key) const {
+        tree_path<node> path(root);
+        path.seek([&](const node* t) { return key < t->info; });
+        return Iterator(path);
+    }
+
+    /**
+     * @brief range_count function
+     * @param lo: the smallest key of the range.
+     * @param hi: the largest key of the range.
+     * @return size_t the number of elements in [lo, hi], in O(log n).
+     */
+    inline size_t range_count(const T& lo, const T& hi) const {
+        if (hi < lo) {
+            return 0;
+        }
+        return _rank(hi, true) - _rank(lo, false);
+    }
+
+    /**
+     * @brief range function
+     * Visits the elements in [lo, hi] in order, in O(log n + k) for k elements.
+     * @param lo: the smallest key of the range.
+     * @param hi: the largest key of the range.
+     * @param visit: called with every element of the range.
+     */
+    template <typename Visit> void range(const T& lo, const T& hi, Visit visit) const {
+        for (Iterator it = lower_bound(lo); it != end() && !(hi < *it); ++it) {
+            visit(*it);
+        }
     }
 
     /**
@@ -517,31 +796,27 @@ template <typename T> class red_black_tree {
 
 /**
  * @brief Iterator class
+ * Bidirectional inorder iterator that walks the tree lazily: it keeps the path from the
+ * root to the current node, each step costs O(1) amortized and nothing is copied. Any
+ * insert or remove invalidates the iterators of the tree.
  */
 template <typename T> class red_black_tree<T>::Iterator {
   private:
-    std::vector<T> elements;
-    int64_t index;
+    tree_path<node> _path;
 
   public:
-    /**
-     * @brief Construct a new Iterator object
-     *
-     * @param els vector<T> - the elements in inorder fashion
-     */
-    explicit Iterator(const int64_t& index, std::vector<T>& els) noexcept
-        : index(index), elements(els) {}
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
 
     /**
-     * @brief = operator for Iterator type
+     * @brief Construct a new Iterator object
      *
-     * @param index the current index
-     * @return Iterator&
+     * @param path the path from the root to the current node
      */
-    Iterator& operator=(int64_t index) {
-        this->index = index;
-        return *(this);
-    }
+    explicit Iterator(const tree_path<node>& path) : _path(path) {}
 
     /**
      * @brief operator ++ for type Iterator
@@ -549,9 +824,7 @@ template <typename T> class red_black_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator++() {
-        if (this->index < elements.size()) {
-            this->index++;
-        }
+        _path.next();
         return *(this);
     }
 
@@ -572,9 +845,7 @@ template <typename T> class red_black_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator--() {
-        if (this->index > 0) {
-            this->index--;
-        }
+        _path.prev();
         return *(this);
     }
 
@@ -589,21 +860,35 @@ template <typename T> class red_black_tree<T>::Iterator {
         return it;
     }
 
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both iterators point to the same node
+     */
+    bool operator==(const Iterator& it) const { return _path == it._path; }
+
     /**
      * @brief operator != for type Iterator
      *
      * @param it const Iterator
-     * @return true if index == it.index
-     * @return false otherwise
+     * @return true if the iterators point to different nodes
      */
-    bool operator!=(const Iterator& it) { return index != it.index; }
+    bool operator!=(const Iterator& it) const { return _path != it._path; }
 
     /**
      * @brief operator * for type Iterator
      *
-     * @return T the value of the node
+     * @return const T& the element of the current node
+     */
+    const T& operator*() const { return _path.node()->info; }
+
+    /**
+     * @brief operator -> for type Iterator
+     *
+     * @return const T* the element of the current node
      */
-    T operator*() { return elements[index]; }
+    const T* operator->() const { return &_path.node()->info; }
 };
 
 #endif
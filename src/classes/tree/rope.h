@@ -1,79 +1,381 @@
 #ifndef ROPE_H
 #define ROPE_H
 
+#include "../../helpers/memory_usage.h"
+
 #ifdef TREE_VISUALIZATION_H
 #include "../../visualization/tree_visual/tree_visualization.h"
 #endif
 
 #ifdef __cplusplus
-#include <cassert>
-#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <memory>
-#include <queue>
-#include <unordered_map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #endif
 
 /**
  * @brief rope's(chord's) data structure class
- * **************************WARNING*****************************
- * This is a class under current development, this implementation
- * doesn't comply with the implementations that you might've seen online.
- * Please read the code carefully if you plan to use this class
- * **************************************************************
- * This class needs a lot of optimizations, like the way it performs splitting.
- * Splitting right now keeps BFS'ing on all the nodes, but we always know that
- * only the leaf nodes will split. Also, at insertion we have to search for
- * already existing subtrees and point the new node there instead of creating
- * duplicates.
+ * Text as an AVL balanced concatenation tree: the leaves hold chunks of at most CHUNK
+ * bytes in order, every internal node holds the length of its text and the height of
+ * its subtree. split and concat are AVL joins, so they cost O(log n) and every edit is
+ * built from them: insert, erase, split, concat, substr and char_at all cost O(log n) on
+ * top of the bytes they copy. Edits that fit in a single leaf change it in place.
+ * The nodes are shared and copied on write: copying a rope costs O(1), and an edit
+ * copies only the nodes on its paths that another rope or view still holds, so many
+ * versions of a text share all the chunks they did not change. Distinct ropes can be
+ * used from distinct threads even when they share nodes.
  */
 class rope {
-    struct node {
-        int64_t len;
-        bool is_leaf;
-        std::shared_ptr<node> left;
-        std::shared_ptr<node> right;
-        std::string data;
+    struct node;
+
+  public:
+    // the largest leaf, the text is cut into chunks of about this size
+    static constexpr size_t CHUNK = 512;
+
+    /**
+     * @brief Construct a new rope object
+     * @param s: the text.
+     */
+    explicit rope(std::string_view s = "") : root(_build(s)) {}
+
+    /**
+     * @brief Copy constructor for rope class, O(1), the copies share every node until
+     * they are edited
+     * @param r the rope we want to copy
+     */
+    rope(const rope& r) = default;
+
+    rope(rope&& r) noexcept = default;
+
+    /**
+     * @brief operator = for rope class, O(1)
+     * @param r the rope we want to copy
+     * @return rope&
+     */
+    rope& operator=(const rope& r) = default;
+
+    rope& operator=(rope&& r) noexcept = default;
+
+    class view;
+
+    /**
+     * @brief chunk iterator class
+     * Forward iterator over the text of a range as string_views into the leaves, chunk
+     * by chunk in order. It keeps the rest of its walk in a fixed stack and allocates
+     * nothing. It borrows the nodes from the view it came from.
+     */
+    class chunk_iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        /**
+         * @brief Construct the iterator past the end of any range
+         */
+        chunk_iterator() = default;
+
+        reference operator*() const { return _chunk; }
+
+        pointer operator->() const { return &_chunk; }
+
+        chunk_iterator& operator++() {
+            if (_rest == 0) {
+                _chunk = {};
+                return *this;
+            }
+            const node* n = _stack[--_top];
+            while (!n->leaf()) {
+                _stack[_top++] = n->right.get();
+                n = n->left.get();
+            }
+            _chunk = std::string_view(n->data).substr(0, _rest);
+            _rest -= _chunk.size();
+            return *this;
+        }
 
-        explicit node(int64_t len, std::shared_ptr<node> left, std::shared_ptr<node> right) {
-            this->len = len;
-            this->is_leaf = false;
-            this->left = left;
-            this->right = right;
+        chunk_iterator operator++(int) {
+            chunk_iterator it = *this;
+            ++*this;
+            return it;
         }
 
-        explicit node(std::string s) {
-            this->len = s.size();
-            this->is_leaf = true;
-            this->left = nullptr;
-            this->right = nullptr;
-            this->data = s;
+        // iterators of one range are equal when as much of the range is left to both
+        bool operator==(const chunk_iterator& it) const {
+            return _rest + _chunk.size() == it._rest + it._chunk.size();
+        }
+
+        bool operator!=(const chunk_iterator& it) const { return !(*this == it); }
+
+      private:
+        friend class view;
+
+        // the height of an AVL tree over 2^64 leaves is below 93
+        static constexpr size_t STACK = 96;
+
+        const node* _stack[STACK];
+        size_t _top{0};
+        std::string_view _chunk;
+        size_t _rest{0};
+
+        chunk_iterator(const node* n, size_t pos, size_t len) {
+            if (len == 0) {
+                return;
+            }
+            while (!n->leaf()) {
+                if (pos < n->left->len) {
+                    _stack[_top++] = n->right.get();
+                    n = n->left.get();
+                } else {
+                    pos -= n->left->len;
+                    n = n->right.get();
+                }
+            }
+            _chunk = std::string_view(n->data).substr(pos, len);
+            _rest = len - _chunk.size();
         }
     };
 
-    void _inorder(std::function<void(std::shared_ptr<node>)> callback, std::shared_ptr<node> root) {
+    /**
+     * @brief view class
+     * A range of the text of a rope without a copy of its bytes. The view holds the
+     * nodes of the rope as they were when it was made, so it stays valid and unchanged
+     * whatever happens to the rope afterwards.
+     */
+    class view {
+      public:
+        /**
+         * @brief size function
+         * @return size_t the length of the range.
+         */
+        size_t size() const { return _len; }
+
+        /**
+         * @brief empty function
+         * @return true if the range is empty.
+         */
+        bool empty() const { return _len == 0; }
+
+        chunk_iterator begin() const {
+            return _len == 0 ? chunk_iterator() : chunk_iterator(_root.get(), _pos, _len);
+        }
+
+        chunk_iterator end() const { return chunk_iterator(); }
+
+        /**
+         * @brief str function
+         * @return std::string a copy of the text of the range.
+         */
+        std::string str() const {
+            std::string s;
+            s.reserve(_len);
+            for (std::string_view c : *this) {
+                s.append(c);
+            }
+            return s;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const view& v) {
+            for (std::string_view c : v) {
+                out << c;
+            }
+            return out;
+        }
+
+      private:
+        friend class rope;
+
+        std::shared_ptr<const node> _root;
+        size_t _pos;
+        size_t _len;
+
+        view(std::shared_ptr<const node> root, size_t pos, size_t len)
+            : _root(std::move(root)), _pos(pos), _len(len) {}
+    };
+
+    /**
+     * @brief chunks function
+     * @return view the whole text, to iterate over its chunks.
+     */
+    view chunks() const { return view(root, 0, size()); }
+
+    /**
+     * @brief substr_view function
+     * O(1), the view shares the nodes of the rope and copies no byte.
+     * @param pos: the first position.
+     * @param len: the length, clamped to the end of the text.
+     * @return view the text of [pos, pos + len).
+     * Throws std::out_of_range if pos > size().
+     */
+    view substr_view(size_t pos, size_t len = std::string::npos) const {
+        _check(pos, "rope::substr_view");
+        return view(root, pos, std::min(len, size() - pos));
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the length of the text.
+     */
+    size_t size() const { return root ? root->len : 0; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the characters, the lengths, heights and links of the nodes,
+     * the rope with the control blocks of the nodes, and the spare capacity of the chunks.
+     * The nodes shared with other ropes are counted by each of them.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.control = sizeof(*this);
+        std::vector<const node*> st;
         if (root) {
-            _inorder(callback, root->left);
-            callback(root);
-            _inorder(callback, root->right);
+            st.push_back(root.get());
+        }
+        while (!st.empty()) {
+            const node* n = st.back();
+            st.pop_back();
+            MEMORY::footprint chunk = MEMORY::memory_usage(n->data);
+            f.payload += chunk.payload;
+            f.slack += chunk.slack;
+            f.node_overhead += sizeof(node) - sizeof(n->data) + chunk.control;
+            f.control += MEMORY::SHARED_CONTROL + MEMORY::ALLOCATION_OVERHEAD;
+            if (!n->leaf()) {
+                st.push_back(n->left.get());
+                st.push_back(n->right.get());
+            }
         }
+        return f;
     }
 
-    std::vector<std::shared_ptr<node>> ropes;
-    std::shared_ptr<node> root;
-    int64_t _height;
+    /**
+     * @brief empty function
+     * @return true if the text is empty.
+     */
+    bool empty() const { return root == nullptr; }
 
-  public:
-    explicit rope(std::string s, int64_t splits = 2) : root(nullptr), _height(-1) {
-        this->create(s, splits);
+    /**
+     * @brief height function
+     * @return int64_t the height of the tree, -1 for an empty rope.
+     */
+    int64_t height() const { return root ? root->height : -1; }
+
+    /**
+     * @brief char_at function
+     * @param pos: the position.
+     * @return char the byte at pos.
+     * Throws std::out_of_range if pos >= size().
+     */
+    char char_at(size_t pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("rope::char_at: position out of range");
+        }
+        const node* n = root.get();
+        while (!n->leaf()) {
+            if (pos < n->left->len) {
+                n = n->left.get();
+            } else {
+                pos -= n->left->len;
+                n = n->right.get();
+            }
+        }
+        return n->data[pos];
     }
 
-    void create(std::string s, int64_t splits = 2);
+    /**
+     * @brief substr function
+     * @param pos: the first position.
+     * @param len: the length, clamped to the end of the text.
+     * @return std::string the text of [pos, pos + len).
+     * Throws std::out_of_range if pos > size().
+     */
+    std::string substr(size_t pos, size_t len = std::string::npos) const {
+        _check(pos, "rope::substr");
+        len = std::min(len, size() - pos);
+        std::string s;
+        s.reserve(len);
+        _append(root.get(), pos, len, s);
+        return s;
+    }
+
+    /**
+     * @brief inorder function
+     * @return std::string the whole text.
+     */
+    std::string inorder() const { return substr(0); }
+
+    /**
+     * @brief insert function
+     * @param pos: the position the text goes to.
+     * @param s: the text.
+     * Throws std::out_of_range if pos > size().
+     */
+    void insert(size_t pos, std::string_view s) {
+        _check(pos, "rope::insert");
+        if (s.empty()) {
+            return;
+        }
+        if (root && _room(root.get(), pos) >= s.size()) {
+            _insert_in_leaf(root, pos, s);
+            return;
+        }
+        auto [l, r] = _split(std::move(root), pos);
+        root = _join(_join(std::move(l), _build(s)), std::move(r));
+    }
+
+    /**
+     * @brief erase function
+     * @param pos: the first position.
+     * @param len: the length, clamped to the end of the text.
+     * Throws std::out_of_range if pos > size().
+     */
+    void erase(size_t pos, size_t len = std::string::npos) {
+        _check(pos, "rope::erase");
+        len = std::min(len, size() - pos);
+        if (len == 0) {
+            return;
+        }
+        if (_inside_leaf(root.get(), pos, len)) {
+            _erase_in_leaf(root, pos, len);
+            return;
+        }
+        auto [l, rest] = _split(std::move(root), pos);
+        auto [mid, r] = _split(std::move(rest), len);
+        root = _join(std::move(l), std::move(r));
+    }
 
-    std::string inorder();
+    /**
+     * @brief split function
+     * @param pos: the position to split at.
+     * @return rope the text of [pos, size()), this rope keeps [0, pos).
+     * Throws std::out_of_range if pos > size().
+     */
+    rope split(size_t pos) {
+        _check(pos, "rope::split");
+        auto [l, r] = _split(std::move(root), pos);
+        root = std::move(l);
+        return rope(std::move(r));
+    }
 
-    int64_t height() { return this->_height; }
+    /**
+     * @brief concat function
+     * @param r: the rope that goes to the end of this one, move it in to avoid the copy.
+     */
+    void concat(rope r) { root = _join(std::move(root), std::move(r.root)); }
+
+    friend std::ostream& operator<<(std::ostream& out, const rope& r) {
+        _write(r.root.get(), out);
+        return out;
+    }
 
 #ifdef TREE_VISUALIZATION_H
     void visualize() {
@@ -83,120 +385,276 @@ class rope {
 #endif
 
   private:
-    std::string generate_visualization() {
-        std::string _generate = _inorder_gen(root);
-        return _generate;
+    /**
+     * @brief struct for the node
+     * @param len: the length of the text of the subtree
+     * @param height: the height of the subtree, 0 for the leaves
+     * @param data: the chunk of a leaf, empty for the internal nodes
+     * An internal node always has both children.
+     */
+    struct node {
+        size_t len;
+        int64_t height;
+        std::shared_ptr<node> left;
+        std::shared_ptr<node> right;
+        std::string data;
+
+        explicit node(std::string_view s) : len(s.size()), height(0), data(s) {}
+
+        explicit node(std::shared_ptr<node> l, std::shared_ptr<node> r)
+            : len(0), height(0), left(std::move(l)), right(std::move(r)) {
+            _update(this);
+        }
+
+        bool leaf() const { return left == nullptr; }
+    };
+
+    using ptr = std::shared_ptr<node>;
+
+    ptr root;
+
+    explicit rope(ptr r) : root(std::move(r)) {}
+
+    void _check(size_t pos, const char* what) const {
+        if (pos > size()) {
+            throw std::out_of_range(std::string(what) + ": position out of range");
+        }
     }
 
-    std::shared_ptr<node> split_tree(std::shared_ptr<node> root, int64_t& splits) {
-        std::queue<std::shared_ptr<node>> q;
-        q.push(root);
-        while (splits) {
-            q = std::queue<std::shared_ptr<node>>{};
-            q.push(root);
-            int64_t count_height = -1;
-            while (!q.empty()) {
-                int64_t size = q.size();
-                for (int64_t i = 0; i < size; i++) {
-                    std::shared_ptr<node> curr = q.front();
-                    q.pop();
-                    if (splits <= 0) {
-                        q = std::queue<std::shared_ptr<node>>{};
-                        break;
-                    }
-                    if (curr->is_leaf == true) {
-                        std::string s1 = (curr->data).substr(0, int(curr->len) / 2 + 1);
-                        std::string s2 = (curr->data)
-                                             .substr(int(curr->len) / 2 + 1,
-                                                     int(curr->len) - int(curr->len) / 2);
-                        std::shared_ptr<node> split1 = std::make_shared<node>(s1);
-                        std::shared_ptr<node> split2 = std::make_shared<node>(s2);
-
-                        std::shared_ptr<node> block_node =
-                            std::make_shared<node>(curr->len, split1, split2);
-                        curr->data.clear();
-                        curr->is_leaf = block_node->is_leaf;
-                        curr->len = block_node->len;
-                        curr->left = block_node->left;
-                        curr->right = block_node->right;
-
-                        splits--;
-                    }
-
-                    if (curr->left != nullptr) {
-                        q.push(curr->left);
-                    }
-                    if (curr->right != nullptr) {
-                        q.push(curr->right);
-                    }
-                }
-                count_height++;
-                _height = std::max(_height, count_height);
-            }
+    // makes n a node that no other rope or view holds, copying it if needed
+    static void _own(ptr& n) {
+        if (n.use_count() > 1) {
+            n = std::make_shared<node>(*n);
         }
-        return root;
     }
 
-    std::string _inorder_gen(std::shared_ptr<node> root) {
-        std::string _s;
-        if (root->left) {
-            if (root->is_leaf) {
-                _s += '"' + std::to_string(root->len) + ',' + root->data + '"';
-            } else {
-                _s += '"' + std::to_string(root->len) + '"';
+    static int64_t _h(const ptr& n) { return n ? n->height : -1; }
+
+    static void _update(node* n) {
+        n->len = n->left->len + n->right->len;
+        n->height = 1 + std::max(n->left->height, n->right->height);
+    }
+
+    // the chunks of s in a perfectly balanced tree
+    static ptr _build(std::string_view s) {
+        if (s.empty()) {
+            return nullptr;
+        }
+        size_t chunks = (s.size() + CHUNK - 1) / CHUNK;
+        return _build(s, 0, chunks, chunks);
+    }
+
+    static ptr _build(std::string_view s, size_t lo, size_t hi, size_t chunks) {
+        // chunk i is [i * n / chunks, (i + 1) * n / chunks), so the sizes differ by 1 at most
+        auto at = [&](size_t i) { return size_t(uint64_t(i) * s.size() / chunks); };
+        if (hi - lo == 1) {
+            return std::make_shared<node>(s.substr(at(lo), at(hi) - at(lo)));
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        return std::make_shared<node>(_build(s, lo, mid, chunks), _build(s, mid, hi, chunks));
+    }
+
+    static ptr _rotate_left(ptr n) {
+        _own(n);
+        ptr r = std::move(n->right);
+        _own(r);
+        n->right = std::move(r->left);
+        _update(n.get());
+        r->left = std::move(n);
+        _update(r.get());
+        return r;
+    }
+
+    static ptr _rotate_right(ptr n) {
+        _own(n);
+        ptr l = std::move(n->left);
+        _own(l);
+        n->left = std::move(l->right);
+        _update(n.get());
+        l->right = std::move(n);
+        _update(l.get());
+        return l;
+    }
+
+    static ptr _balance(ptr n) {
+        _own(n);
+        _update(n.get());
+        int64_t b = _h(n->left) - _h(n->right);
+        if (b > 1) {
+            if (_h(n->left->left) < _h(n->left->right)) {
+                n->left = _rotate_left(std::move(n->left));
             }
-            _s += "->";
-            if (root->left->is_leaf) {
-                _s += '"' + std::to_string(root->left->len) + ',' + root->left->data + '"';
-            } else {
-                _s += '"' + std::to_string(root->left->len) + '"';
+            return _rotate_right(std::move(n));
+        }
+        if (b < -1) {
+            if (_h(n->right->right) < _h(n->right->left)) {
+                n->right = _rotate_right(std::move(n->right));
             }
-            _s += "\n";
-            _s += _inorder_gen(root->left);
+            return _rotate_left(std::move(n));
         }
-        if (root->right) {
-            if (root->is_leaf) {
-                _s += '"' + std::to_string(root->len) + ',' + root->data + '"';
+        return n;
+    }
+
+    // the text of l followed by the text of r, in O(|height(l) - height(r)| + 1)
+    static ptr _join(ptr l, ptr r) {
+        if (!l) {
+            return r;
+        }
+        if (!r) {
+            return l;
+        }
+        if (l->leaf() && r->leaf() && l->len + r->len <= CHUNK) {
+            _own(l);
+            l->data += r->data;
+            l->len = l->data.size();
+            return l;
+        }
+        if (l->height > r->height + 1) {
+            _own(l);
+            l->right = _join(std::move(l->right), std::move(r));
+            return _balance(std::move(l));
+        }
+        if (r->height > l->height + 1) {
+            _own(r);
+            r->left = _join(std::move(l), std::move(r->left));
+            return _balance(std::move(r));
+        }
+        return std::make_shared<node>(std::move(l), std::move(r));
+    }
+
+    // [0, pos) and [pos, len) of the text of n, the joins along the way telescope to
+    // O(log n) in total
+    static std::pair<ptr, ptr> _split(ptr n, size_t pos) {
+        if (!n) {
+            return {nullptr, nullptr};
+        }
+        if (pos == 0) {
+            return {nullptr, std::move(n)};
+        }
+        if (pos >= n->len) {
+            return {std::move(n), nullptr};
+        }
+        _own(n);
+        if (n->leaf()) {
+            ptr r = std::make_shared<node>(std::string_view(n->data).substr(pos));
+            n->data.resize(pos);
+            n->len = pos;
+            return {std::move(n), std::move(r)};
+        }
+        if (pos < n->left->len) {
+            auto [a, b] = _split(std::move(n->left), pos);
+            return {std::move(a), _join(std::move(b), std::move(n->right))};
+        }
+        auto [a, b] = _split(std::move(n->right), pos - n->left->len);
+        return {_join(std::move(n->left), std::move(a)), std::move(b)};
+    }
+
+    // the room left in the leaf that an insert at pos goes to
+    static size_t _room(const node* n, size_t pos) {
+        while (!n->leaf()) {
+            if (pos <= n->left->len) {
+                n = n->left.get();
             } else {
-                _s += '"' + std::to_string(root->len) + '"';
+                pos -= n->left->len;
+                n = n->right.get();
             }
-            _s += "->";
-            if (root->right->is_leaf) {
-                _s += '"' + std::to_string(root->right->len) + ',' + root->right->data + '"';
+        }
+        return CHUNK - n->len;
+    }
+
+    static void _insert_in_leaf(ptr& n, size_t pos, std::string_view s) {
+        _own(n);
+        n->len += s.size();
+        if (n->leaf()) {
+            n->data.insert(pos, s);
+        } else if (pos <= n->left->len) {
+            _insert_in_leaf(n->left, pos, s);
+        } else {
+            _insert_in_leaf(n->right, pos - n->left->len, s);
+        }
+    }
+
+    // true if [pos, pos + len) lies inside one leaf and leaves some of it
+    static bool _inside_leaf(const node* n, size_t pos, size_t len) {
+        while (!n->leaf()) {
+            if (pos + len <= n->left->len) {
+                n = n->left.get();
+            } else if (pos >= n->left->len) {
+                pos -= n->left->len;
+                n = n->right.get();
             } else {
-                _s += '"' + std::to_string(root->right->len) + '"';
+                return false;
             }
-            _s += "\n";
-            _s += _inorder_gen(root->right);
         }
-        return _s;
+        return len < n->len;
     }
-};
 
-void rope::create(std::string s, int64_t splits) {
-    assert(s.size() >= splits);
-
-    std::string s1 = s.substr(0, (int(s.size()) / 2) + 1);
-    std::string s2 = s.substr(int(s.size()) / 2 + 1, int(s.size()) - int(s.size() / 2));
-    std::shared_ptr<node> split1 = std::make_shared<node>(s1);
-    std::shared_ptr<node> split2 = std::make_shared<node>(s2);
-
-    std::shared_ptr<node> root_block = std::make_shared<node>(s.size(), split1, split2);
-    root = root_block;
-    splits--;
-    root = split_tree(root, splits);
-}
-
-std::string rope::inorder() {
-    std::string path;
-    _inorder(
-        [&](std::shared_ptr<node> callbacked) {
-            if (callbacked->is_leaf == true) {
-                path += callbacked->data;
+    static void _erase_in_leaf(ptr& n, size_t pos, size_t len) {
+        _own(n);
+        n->len -= len;
+        if (n->leaf()) {
+            n->data.erase(pos, len);
+        } else if (pos < n->left->len) {
+            _erase_in_leaf(n->left, pos, len);
+        } else {
+            _erase_in_leaf(n->right, pos - n->left->len, len);
+        }
+    }
+
+    static void _append(const node* n, size_t pos, size_t len, std::string& s) {
+        if (len == 0) {
+            return;
+        }
+        if (n->leaf()) {
+            s.append(n->data, pos, len);
+            return;
+        }
+        size_t l = n->left->len;
+        if (pos < l) {
+            size_t take = std::min(len, l - pos);
+            _append(n->left.get(), pos, take, s);
+            _append(n->right.get(), 0, len - take, s);
+        } else {
+            _append(n->right.get(), pos - l, len, s);
+        }
+    }
+
+    static void _write(const node* n, std::ostream& out) {
+        if (!n) {
+            return;
+        }
+        if (n->leaf()) {
+            out << n->data;
+            return;
+        }
+        _write(n->left.get(), out);
+        _write(n->right.get(), out);
+    }
+
+#ifdef TREE_VISUALIZATION_H
+    std::string generate_visualization() {
+        std::string _generate;
+        int64_t id = 0;
+        if (root) {
+            _generate_visualization(root.get(), id, _generate);
+        }
+        return _generate;
+    }
+
+    // the nodes are named by their preorder index, so equal lengths make distinct nodes
+    static int64_t _generate_visualization(const node* n, int64_t& id, std::string& s) {
+        int64_t me = id++;
+        s += std::to_string(me) + " [label=\"" + std::to_string(n->len);
+        s += n->leaf() ? "," + n->data + "\"]\n" : "\"]\n";
+        if (!n->leaf()) {
+            for (const node* c : {n->left.get(), n->right.get()}) {
+                int64_t child = _generate_visualization(c, id, s);
+                s += std::to_string(me) + "->" + std::to_string(child) + "\n";
             }
-        },
-        root);
-    return path;
-}
+        }
+        return me;
+    }
+#endif
+};
 
 #endif
@@ -19,7 +19,7 @@ class segment_tree {
      */
     inline explicit segment_tree(const std::vector<int>& v) noexcept : data(v) {
         int x = (int)(ceil(log2(v.size())));
-        int max_size = 2 * (int)(pow(2, x) - 1);
+        int max_size = 2 * (int)pow(2, x) - 1;
         this->root = std::vector<int>(max_size);
         _construct(0, v.size() - 1, 0);
     }
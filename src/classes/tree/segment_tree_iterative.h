@@ -1,9 +1,16 @@
 #ifndef SEGMENT_TREE_ITERATIVE_H
 #define SEGMENT_TREE_ITERATIVE_H
 
+#include "../../helpers/memory_usage.h"
+
+#include "../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <iostream>
+#include <utility>
 #include <vector>
 #endif
 
@@ -72,6 +79,136 @@ template <typename T> struct seg_tree {
             tree[idx] = tree[2 * idx] + tree[2 * idx + 1];
         }
     }
+
+    /**
+     * @brief batch update query
+     * Sets every leaf first and then recomputes the internal nodes above them from the
+     * bottom up, each of them once however many updates lie below it. The nodes are
+     * recomputed in decreasing index order, so children always come before parents, and a
+     * batch big enough to touch most of them rebuilds the whole tree in one pass instead.
+     * @param updates: pairs of (index, new value), if an index repeats the last one wins.
+     */
+    inline void update_batch(std::vector<std::pair<int, T>> updates) {
+        _sort_batch(updates);
+        for (auto& [idx, x] : updates) {
+            tree[idx + n] = x;
+        }
+        _recompute(updates);
+    }
+
+    /**
+     * @brief batch add query
+     * Like update_batch, but adds the values to the leaves.
+     * @param updates: pairs of (index, value to add), repeated indexes add up.
+     */
+    inline void add_batch(std::vector<std::pair<int, T>> updates) {
+        _sort_batch(updates);
+        for (auto& [idx, x] : updates) {
+            tree[idx + n] += x;
+        }
+        _recompute(updates);
+    }
+
+    /**
+     * @brief batch sum query
+     * Runs the queries side by side one tree level at a time, so every pass over the
+     * queries reads a single level of the tree and the upper levels stay in cache.
+     * @param queries: pairs of [a, b] like in sum.
+     * @param threads: number of worker threads that split the queries(0 means every
+     * hardware thread). Default = 1
+     * @return vector<T> the sum of every query.
+     */
+    inline std::vector<T> sum_batch(const std::vector<std::pair<int, int>>& queries,
+                                    size_t threads = 1) const {
+        std::vector<T> sums(queries.size(), T(0));
+        PARALLEL::parallel_for(0, queries.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            std::vector<std::pair<int, int>> at(queries.begin() + lo, queries.begin() + hi);
+            for (auto& [a, b] : at) {
+                assert(a >= 0 && a <= b && b < n);
+                a += n;
+                b += n;
+            }
+            for (bool active = true; active;) {
+                active = false;
+                for (size_t q = lo; q < hi; q++) {
+                    auto& [a, b] = at[q - lo];
+                    if (a > b) {
+                        continue;
+                    }
+                    if (a % 2 == 1) {
+                        sums[q] += tree[a++];
+                    }
+                    if (b % 2 == 0) {
+                        sums[q] += tree[b--];
+                    }
+                    a /= 2;
+                    b /= 2;
+                    active = active || a <= b;
+                }
+            }
+        });
+        return sums;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the elements, the sums of the tree as node overhead, the object
+     * with the headers of the arrays and their spare capacity
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(data);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(tree));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    void _sort_batch(std::vector<std::pair<int, T>>& updates) const {
+        auto by_index = [](const std::pair<int, T>& x, const std::pair<int, T>& y) {
+            return x.first < y.first;
+        };
+        if (!std::is_sorted(updates.begin(), updates.end(), by_index)) {
+            std::stable_sort(updates.begin(), updates.end(), by_index);
+        }
+        for ([[maybe_unused]] auto& [idx, x] : updates) {
+            assert(idx >= 0 && idx < n);
+        }
+    }
+
+    // merges the updated leaves(from the last) with the parents of the nodes done so far,
+    // which come out in non increasing order, so equal nodes meet and run once
+    void _recompute(const std::vector<std::pair<int, T>>& updates) {
+        // a dense batch touches most internal nodes, one sequential rebuild is cheaper
+        if (updates.size() * std::bit_width(unsigned(n)) >= size_t(n)) {
+            for (int i = n - 1; i >= 1; i--) {
+                tree[i] = tree[2 * i] + tree[2 * i + 1];
+            }
+            return;
+        }
+        std::vector<int> parents;
+        parents.reserve(2 * updates.size());
+        size_t leaf = updates.size(), next = 0;
+        int last = 0;
+        while (leaf > 0 || next < parents.size()) {
+            int x;
+            if (next == parents.size() ||
+                (leaf > 0 && updates[leaf - 1].first + n > parents[next])) {
+                x = updates[--leaf].first + n;
+            } else {
+                x = parents[next++];
+            }
+            if (x == last) {
+                continue;
+            }
+            last = x;
+            if (x < n) {
+                tree[x] = tree[2 * x] + tree[2 * x + 1];
+            }
+            if (x > 1) {
+                parents.push_back(x / 2);
+            }
+        }
+    }
 };
 
 #endif
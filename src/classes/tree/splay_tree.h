@@ -1,15 +1,21 @@
 #ifndef SPLAY_TREE_H
 #define SPLAY_TREE_H
 
+#include "../../helpers/node_pool.h"
+#include "../../helpers/tree_path.h"
+
 #ifdef ENABLE_TREE_VISUALIZATION
 #include "../../visualization/tree_visual/tree_visualization.h"
 #endif
 
 #ifdef __cplusplus
+#include <algorithm>
 #include <functional>
 #include <iostream>
-#include <memory>
+#include <iterator>
+#include <numeric>
 #include <queue>
+#include <utility>
 #include <vector>
 #endif
 
@@ -26,11 +32,13 @@ template <typename T> class splay_tree {
      */
     struct node {
         T info;
-        std::shared_ptr<node> right;
-        std::shared_ptr<node> left;
+        node* right;
+        node* left;
         node(T key = 0) : info(key), right(nullptr), left(nullptr) {}
     };
-    std::shared_ptr<node> root;
+    // declared before root, the copy constructor fills root from the pool
+    node_pool<node> _pool;
+    node* root;
     size_t _size{0};
 
   public:
@@ -38,8 +46,13 @@ template <typename T> class splay_tree {
      * @brief Construct a new splay tree object
      *
      * @param v vector<T> initializer vector
+     * @param resource the memory resource the nodes come from. Default =
+     * std::pmr::get_default_resource()
      */
-    inline explicit splay_tree(std::vector<T> v = {}) noexcept : root(nullptr) {
+    inline explicit splay_tree(std::vector<T> v = {},
+                               std::pmr::memory_resource* resource =
+                                   std::pmr::get_default_resource()) noexcept
+        : _pool(resource), root(nullptr) {
         if (!v.empty()) {
             for (T& x : v) {
                 this->insert(x);
@@ -51,7 +64,7 @@ template <typename T> class splay_tree {
      * @brief Copy constructor for splay tree class
      * @param s the tree we want to copy
      */
-    inline explicit splay_tree(const splay_tree& s) : root(s.root), _size(s._size) {}
+    inline explicit splay_tree(const splay_tree& s) : root(_copy(s.root)), _size(s._size) {}
 
     /**
      * @brief operator = for splay tree class
@@ -59,17 +72,24 @@ template <typename T> class splay_tree {
      * @return splay_tree&
      */
     inline splay_tree& operator=(const splay_tree& s) {
-        root = s.root;
-        _size = s._size;
+        if (this != &s) {
+            clear();
+            root = _copy(s.root);
+            _size = s._size;
+        }
         return *this;
     }
 
-    inline ~splay_tree() { root = nullptr; }
+    inline ~splay_tree() { clear(); }
 
     /**
      * @brief clear function
      */
     inline void clear() {
+        _pool.clear(root, [](node* n, auto visit) {
+            visit(n->left);
+            visit(n->right);
+        });
         root = nullptr;
         _size = 0;
     }
@@ -79,20 +99,14 @@ template <typename T> class splay_tree {
      *
      * @param key the key to be inserted
      */
-    inline void insert(T key) {
-        root = _insert(root, key);
-        _size++;
-    }
+    inline void insert(T key) { root = _insert(root, key); }
 
     /**
      * @brief remove function
      *
      * @param key the key to be removed
      */
-    inline void remove(T key) {
-        root = _remove(root, key);
-        _size--;
-    }
+    inline void remove(T key) { root = _remove(root, key); }
 
     /**
      * @brief search function
@@ -102,8 +116,46 @@ template <typename T> class splay_tree {
      * @return false otherwise
      */
     inline bool search(T key) {
-        std::shared_ptr<node> ans = splay(root, key);
-        return (ans && ans->info == key);
+        root = splay(root, key);
+        return (root && root->info == key);
+    }
+
+    /**
+     * @brief splay_to_root function
+     * Hint for an upcoming burst of accesses around key: brings key, or the last node on
+     * its search path if it is missing, to the root, so the next accesses start there.
+     * @param key the key to bring up
+     * @return true if key exists in the tree
+     */
+    inline bool splay_to_root(const T& key) {
+        root = splay(root, key);
+        return root && !(root->info < key) && !(key < root->info);
+    }
+
+    /**
+     * @brief search_batch function
+     * Looks the keys up in sorted order: every access starts next to the root left by the
+     * previous one, so the batch costs O(n + m) instead of O(m log n)(sequential access).
+     * @param keys the keys to search, in any order
+     * @return vector<bool> for every key, true if it exists in the tree
+     */
+    inline std::vector<bool> search_batch(const std::vector<T>& keys) {
+        std::vector<bool> found(keys.size());
+        for (size_t i : _sorted_order(keys)) {
+            found[i] = splay_to_root(keys[i]);
+        }
+        return found;
+    }
+
+    /**
+     * @brief insert_batch function
+     * Inserts the keys in sorted order, every insertion splits the tree next to the root.
+     * @param keys the keys to insert, in any order
+     */
+    inline void insert_batch(const std::vector<T>& keys) {
+        for (size_t i : _sorted_order(keys)) {
+            root = _insert(root, keys[i]);
+        }
     }
 
     /**
@@ -113,25 +165,48 @@ template <typename T> class splay_tree {
      */
     inline size_t size() { return _size; }
 
-    class Iterator;
+    /**
+     * @brief resource function
+     *
+     * @return std::pmr::memory_resource* the resource the nodes come from
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _pool.resource(); }
 
-    inline Iterator begin() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(0, ino);
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the elements, the links of the nodes, the tree and the
+     * slab table of its pool, and the free slots of the pool
+     */
+    MEMORY::footprint memory_usage() const {
+        size_t owned = MEMORY::owned(
+            root,
+            [](const node* n, auto visit) {
+                visit(n->left);
+                visit(n->right);
+            },
+            [](const node* n) -> const T& { return n->info; });
+        MEMORY::footprint f = _pool.memory_usage(sizeof(T), owned);
+        f.control += sizeof(*this);
+        return f;
     }
 
-    inline Iterator end() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(ino.size(), ino);
+    class Iterator;
+
+    inline Iterator begin() const {
+        tree_path<node> path(root);
+        path.first();
+        return Iterator(path);
     }
 
+    inline Iterator end() const { return Iterator(tree_path<node>(root)); }
+
     /**
      *@brief inorder function.
      *@returns vector<T>, the elements inorder.
      */
     inline std::vector<T> inorder() {
         std::vector<T> path;
-        _inorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); }, root);
+        _inorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -141,8 +216,7 @@ template <typename T> class splay_tree {
      */
     inline std::vector<T> preorder() {
         std::vector<T> path;
-        _preorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                  root);
+        _preorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -152,8 +226,7 @@ template <typename T> class splay_tree {
      */
     inline std::vector<T> postorder() {
         std::vector<T> path;
-        _postorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                   root);
+        _postorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -163,13 +236,13 @@ template <typename T> class splay_tree {
      */
     inline std::vector<std::vector<T>> level_order() {
         std::vector<std::vector<T>> path;
-        std::queue<std::shared_ptr<node>> q;
+        std::queue<node*> q;
         q.push(root);
         while (!q.empty()) {
             size_t size = q.size();
             std::vector<T> level;
             for (size_t i = 0; i < size; i++) {
-                std::shared_ptr<node> current = q.front();
+                node* current = q.front();
                 q.pop();
                 level.push_back(current->info);
                 if (current->left) {
@@ -211,62 +284,109 @@ template <typename T> class splay_tree {
     }
 
   private:
-    std::shared_ptr<node> rrotate(std::shared_ptr<node> _node) {
-        std::shared_ptr<node> y = _node->left;
+    static std::vector<size_t> _sorted_order(const std::vector<T>& keys) {
+        std::vector<size_t> order(keys.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+        return order;
+    }
+
+    node* _copy(const node* t) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        node* copy = _pool.create(t->info);
+        std::vector<std::pair<const node*, node*>> stack = {{t, copy}};
+        while (!stack.empty()) {
+            auto [from, to] = stack.back();
+            stack.pop_back();
+            if (from->left) {
+                to->left = _pool.create(from->left->info);
+                stack.push_back({from->left, to->left});
+            }
+            if (from->right) {
+                to->right = _pool.create(from->right->info);
+                stack.push_back({from->right, to->right});
+            }
+        }
+        return copy;
+    }
+
+    node* rrotate(node* _node) {
+        node* y = _node->left;
         _node->left = y->right;
         y->right = _node;
         return y;
     }
 
-    std::shared_ptr<node> lrotate(std::shared_ptr<node> _node) {
-        std::shared_ptr<node> y = _node->right;
+    node* lrotate(node* _node) {
+        node* y = _node->right;
         _node->right = y->left;
         y->left = _node;
         return y;
     }
 
-    std::shared_ptr<node> splay(std::shared_ptr<node> _node, T key) {
-        if (!_node || _node->info == key) {
+    /**
+     * @brief top-down splay(Sleator and Tarjan): one pass from the root with no recursion,
+     * the nodes left of the path hang under l and the ones right of it under r until the
+     * last node of the path takes them as its subtrees.
+     */
+    node* splay(node* _node, const T& key) {
+        if (!_node) {
             return _node;
         }
-        if (_node->info > key) {
-            if (_node->left == NULL)
-                return _node;
-            if (_node->left->info > key) {
-                _node->left->left = splay(_node->left->left, key);
-                _node = rrotate(_node);
-            } else if (_node->left->info < key) {
-                _node->left->right = splay(_node->left->right, key);
-                if (_node->left->right != NULL)
-                    _node->left = lrotate(_node->left);
-            }
-            return (_node->left == NULL) ? _node : rrotate(_node);
-        } else {
-            if (_node->right == NULL)
-                return _node;
-            if (_node->right->info > key) {
-                _node->right->left = splay(_node->right->left, key);
-                if (_node->right->left != NULL)
-                    _node->right = rrotate(_node->right);
-            } else if (_node->right->info < key) {
-                _node->right->right = splay(_node->right->right, key);
-                _node = lrotate(_node);
+        node* l = nullptr;
+        node* r = nullptr;
+        // where the next node of each side goes: under the max of l and the min of r
+        node** l_hook = &l;
+        node** r_hook = &r;
+        for (;;) {
+            if (key < _node->info) {
+                if (!_node->left)
+                    break;
+                if (key < _node->left->info) {
+                    _node = rrotate(_node);
+                    if (!_node->left)
+                        break;
+                }
+                *r_hook = _node;
+                r_hook = &_node->left;
+                _node = _node->left;
+            } else if (_node->info < key) {
+                if (!_node->right)
+                    break;
+                if (_node->right->info < key) {
+                    _node = lrotate(_node);
+                    if (!_node->right)
+                        break;
+                }
+                *l_hook = _node;
+                l_hook = &_node->right;
+                _node = _node->right;
+            } else {
+                break;
             }
-            return (_node->right == NULL) ? _node : lrotate(_node);
         }
+        *l_hook = _node->left;
+        *r_hook = _node->right;
+        _node->left = l;
+        _node->right = r;
+        return _node;
     }
 
-    std::shared_ptr<node> _insert(std::shared_ptr<node> root, T key) {
+    node* _insert(node* root, T key) {
         if (!root) {
-            std::shared_ptr<node> nn = std::make_shared<node>(key);
-            return nn;
+            _size++;
+            return _pool.create(key);
         }
         root = splay(root, key);
         if (root->info == key) {
             return root;
         }
 
-        std::shared_ptr<node> nn = std::make_shared<node>(key);
+        node* nn = _pool.create(key);
+        _size++;
         if (root->info > key) {
             nn->right = root;
             nn->left = root->left;
@@ -279,7 +399,7 @@ template <typename T> class splay_tree {
         return nn;
     }
 
-    std::shared_ptr<node> _remove(std::shared_ptr<node> root, T key) {
+    node* _remove(node* root, T key) {
         if (!root) {
             return nullptr;
         }
@@ -288,7 +408,7 @@ template <typename T> class splay_tree {
             return root;
         }
 
-        std::shared_ptr<node> temp;
+        node* temp;
         temp = root;
         if (!root->left) {
             root = root->right;
@@ -296,32 +416,58 @@ template <typename T> class splay_tree {
             root = splay(root->left, key);
             root->right = temp->right;
         }
+        _pool.destroy(temp);
+        _size--;
         return root;
     }
 
-    void _inorder(std::function<void(std::shared_ptr<node>)> callback, std::shared_ptr<node> root) {
-        if (root) {
-            _inorder(callback, root->left);
+    // the traversals keep their own stack, a splay tree can be as deep as it is large
+    void _inorder(std::function<void(node*)> callback, node* root) {
+        std::vector<node*> stack;
+        while (root || !stack.empty()) {
+            for (; root; root = root->left) {
+                stack.push_back(root);
+            }
+            root = stack.back();
+            stack.pop_back();
             callback(root);
-            _inorder(callback, root->right);
+            root = root->right;
         }
     }
 
-    void _postorder(std::function<void(std::shared_ptr<node>)> callback,
-                    std::shared_ptr<node> root) {
-        if (root) {
-            _postorder(callback, root->left);
-            _postorder(callback, root->right);
-            callback(root);
+    void _postorder(std::function<void(node*)> callback, node* root) {
+        std::vector<node*> stack;
+        node* last = nullptr;
+        while (root || !stack.empty()) {
+            for (; root; root = root->left) {
+                stack.push_back(root);
+            }
+            node* top = stack.back();
+            if (top->right && top->right != last) {
+                root = top->right;
+            } else {
+                callback(top);
+                last = top;
+                stack.pop_back();
+            }
         }
     }
 
-    void _preorder(std::function<void(std::shared_ptr<node>)> callback,
-                   std::shared_ptr<node> root) {
+    void _preorder(std::function<void(node*)> callback, node* root) {
+        std::vector<node*> stack;
         if (root) {
-            callback(root);
-            _preorder(callback, root->left);
-            _preorder(callback, root->right);
+            stack.push_back(root);
+        }
+        while (!stack.empty()) {
+            node* t = stack.back();
+            stack.pop_back();
+            callback(t);
+            if (t->right) {
+                stack.push_back(t->right);
+            }
+            if (t->left) {
+                stack.push_back(t->left);
+            }
         }
     }
 
@@ -330,7 +476,7 @@ template <typename T> class splay_tree {
         return _generate;
     }
 
-    std::string _inorder_gen(std::shared_ptr<node> root) {
+    std::string _inorder_gen(node* root) {
         std::string _s;
         if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
             if (root->left) {
@@ -363,31 +509,27 @@ template <typename T> class splay_tree {
 
 /**
  * @brief Iterator class
+ * Bidirectional inorder iterator that walks the tree lazily: it keeps the path from the
+ * root to the current node, each step costs O(1) amortized and nothing is copied. Any
+ * insert or remove invalidates the iterators of the tree.
  */
 template <typename T> class splay_tree<T>::Iterator {
   private:
-    std::vector<T> elements;
-    int64_t index;
+    tree_path<node> _path;
 
   public:
-    /**
-     * @brief Construct a new Iterator object
-     *
-     * @param els vector<T> - the elements in inorder fashion
-     */
-    explicit Iterator(const int64_t& index, std::vector<T>& els) noexcept
-        : index(index), elements(els) {}
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
 
     /**
-     * @brief = operator for Iterator type
+     * @brief Construct a new Iterator object
      *
-     * @param index the current index
-     * @return Iterator&
+     * @param path the path from the root to the current node
      */
-    Iterator& operator=(int64_t index) {
-        this->index = index;
-        return *(this);
-    }
+    explicit Iterator(const tree_path<node>& path) : _path(path) {}
 
     /**
      * @brief operator ++ for type Iterator
@@ -395,9 +537,7 @@ template <typename T> class splay_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator++() {
-        if (this->index < elements.size()) {
-            this->index++;
-        }
+        _path.next();
         return *(this);
     }
 
@@ -418,9 +558,7 @@ template <typename T> class splay_tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator--() {
-        if (this->index > 0) {
-            this->index--;
-        }
+        _path.prev();
         return *(this);
     }
 
@@ -435,21 +573,35 @@ template <typename T> class splay_tree<T>::Iterator {
         return it;
     }
 
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both iterators point to the same node
+     */
+    bool operator==(const Iterator& it) const { return _path == it._path; }
+
     /**
      * @brief operator != for type Iterator
      *
      * @param it const Iterator
-     * @return true if index == it.index
-     * @return false otherwise
+     * @return true if the iterators point to different nodes
      */
-    bool operator!=(const Iterator& it) { return index != it.index; }
+    bool operator!=(const Iterator& it) const { return _path != it._path; }
 
     /**
      * @brief operator * for type Iterator
      *
-     * @return T the value of the node
+     * @return const T& the element of the current node
+     */
+    const T& operator*() const { return _path.node()->info; }
+
+    /**
+     * @brief operator -> for type Iterator
+     *
+     * @return const T* the element of the current node
      */
-    T operator*() { return elements[index]; }
+    const T* operator->() const { return &_path.node()->info; }
 };
 
 #endif
@@ -0,0 +1,226 @@
+#ifndef STATIC_INTERVAL_INDEX_H
+#define STATIC_INTERVAL_INDEX_H
+
+#include "../../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief static interval index class
+ * Immutable index over a fixed set of closed intervals for overlap queries. The
+ * intervals are sorted by low end and stored in one array that doubles as an implicit
+ * balanced tree(the node of index i sits at the level of the number of trailing ones of
+ * i, so the sorted order is the inorder), every entry also stores the largest high end
+ * of its subtree. There are no pointers and no per node allocations: building costs one
+ * sort, O(n log n), and a query walks O(log n) entries plus the k hits, with the last
+ * few levels scanned linearly since they sit in the same cache lines anyway.
+ * @tparam T the type of the ends, ordered by operator <.
+ */
+template <typename T> class static_interval_index {
+  public:
+    /**
+     * @brief Construct a new static interval index object
+     * @param intervals: the intervals, the id of an interval is its position here. The
+     * ends of a pair can come in any order.
+     */
+    explicit static_interval_index(const std::vector<std::pair<T, T>>& intervals = {}) {
+        _a.reserve(intervals.size());
+        for (size_t i = 0; i < intervals.size(); i++) {
+            const auto& [x, y] = intervals[i];
+            _a.push_back({std::min(x, y), std::max(x, y), std::max(x, y), i});
+        }
+        std::sort(_a.begin(), _a.end(),
+                  [](const _entry& a, const _entry& b) { return a.low < b.low; });
+        _build();
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of intervals.
+     */
+    size_t size() const { return _a.size(); }
+
+    /**
+     * @brief empty function
+     * @return true if the index holds no intervals.
+     */
+    bool empty() const { return _a.empty(); }
+
+    /**
+     * @brief overlapping function
+     * Visits every interval that overlaps [lo, hi], in O(log n + k) for k hits.
+     * @param lo: the low end of the query.
+     * @param hi: the high end of the query.
+     * @param visit: called with the interval and its id for every hit, in order of low end.
+     */
+    template <typename Visit> void overlapping(const T& lo, const T& hi, Visit visit) const {
+        if (_a.empty() || hi < lo) {
+            return;
+        }
+        const size_t n = _a.size();
+        struct frame {
+            size_t x;
+            int k;
+            bool left_done;
+        };
+        frame stack[2 * sizeof(size_t) * 8];
+        size_t top = 0;
+        stack[top++] = {(size_t(1) << _levels) - 1, _levels, false};
+        while (top) {
+            frame z = stack[--top];
+            if (z.k <= LINEAR_LEVELS) {
+                size_t i0 = z.x >> z.k << z.k;
+                size_t i1 = std::min(n, i0 + (size_t(2) << z.k) - 1);
+                for (size_t i = i0; i < i1 && !(hi < _a[i].low); i++) {
+                    if (!(_a[i].high < lo)) {
+                        visit(std::pair<T, T>{_a[i].low, _a[i].high}, _a[i].id);
+                    }
+                }
+            } else if (!z.left_done) {
+                size_t y = z.x - (size_t(1) << (z.k - 1));
+                stack[top++] = {z.x, z.k, true};
+                // the left subtree can only be skipped if it has no entry past its root
+                if (y >= n || !(_a[y].max < lo)) {
+                    stack[top++] = {y, z.k - 1, false};
+                }
+            } else if (z.x < n && !(hi < _a[z.x].low)) {
+                if (!(_a[z.x].high < lo)) {
+                    visit(std::pair<T, T>{_a[z.x].low, _a[z.x].high}, _a[z.x].id);
+                }
+                stack[top++] = {z.x + (size_t(1) << (z.k - 1)), z.k - 1, false};
+            }
+        }
+    }
+
+    /**
+     * @brief query_overlapping function
+     * @param p: the query interval, its ends can come in any order.
+     * @return vector<pair<T,T>> every interval that overlaps p, in order of low end.
+     */
+    std::vector<std::pair<T, T>> query_overlapping(std::pair<T, T> p) const {
+        std::vector<std::pair<T, T>> hits;
+        overlapping(std::min(p.first, p.second), std::max(p.first, p.second),
+                    [&](const std::pair<T, T>& i, size_t) { hits.push_back(i); });
+        return hits;
+    }
+
+    /**
+     * @brief query_overlapping function
+     * @param point: the query point.
+     * @return vector<pair<T,T>> every interval that contains point, in order of low end.
+     */
+    std::vector<std::pair<T, T>> query_overlapping(const T& point) const {
+        return query_overlapping({point, point});
+    }
+
+    /**
+     * @brief count_overlapping function
+     * @param lo: the low end of the query.
+     * @param hi: the high end of the query.
+     * @return size_t the number of intervals that overlap [lo, hi].
+     */
+    size_t count_overlapping(const T& lo, const T& hi) const {
+        size_t c = 0;
+        overlapping(lo, hi, [&](const std::pair<T, T>&, size_t) { c++; });
+        return c;
+    }
+
+    /**
+     * @brief query_batch function
+     * Answers many queries at once. The queries run in order of low end, so consecutive
+     * queries walk mostly the same entries and find them in cache.
+     * @param queries: the query intervals, their ends can come in any order.
+     * @param visit: called with the index of the query and the id of the interval for
+     * every hit.
+     */
+    template <typename Visit>
+    void query_batch(const std::vector<std::pair<T, T>>& queries, Visit visit) const {
+        std::vector<size_t> order(queries.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        auto low = [&](size_t q) { return std::min(queries[q].first, queries[q].second); };
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return low(a) < low(b); });
+        for (size_t q : order) {
+            const auto& [x, y] = queries[q];
+            overlapping(std::min(x, y), std::max(x, y),
+                        [&](const std::pair<T, T>&, size_t id) { visit(q, id); });
+        }
+    }
+
+    /**
+     * @brief query_batch function
+     * @param queries: the query intervals.
+     * @return vector<vector<size_t>> the ids of the intervals that overlap each query.
+     */
+    std::vector<std::vector<size_t>>
+    query_batch(const std::vector<std::pair<T, T>>& queries) const {
+        std::vector<std::vector<size_t>> hits(queries.size());
+        query_batch(queries, [&](size_t q, size_t id) { hits[q].push_back(id); });
+        return hits;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the bounds of the intervals, the maxima of the subtrees and the ids
+     * as node overhead, the object with the header of the array and its spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_a);
+        const size_t bounds = _a.size() * 2 * sizeof(T);
+        f.node_overhead += f.payload - bounds;
+        f.payload = bounds;
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    // subtrees up to this level, 16 entries, are scanned instead of walked
+    static constexpr int LINEAR_LEVELS = 3;
+
+    struct _entry {
+        T low;
+        T high;
+        T max;
+        size_t id;
+    };
+
+    std::vector<_entry> _a;
+    int _levels{0};
+
+    // the max of every entry over its implicit subtree, the entries past the end of the
+    // array are stood in for by the largest high end among the last entries
+    void _build() {
+        const size_t n = _a.size();
+        if (n == 0) {
+            return;
+        }
+        size_t last_i = 0;
+        T last = _a[0].high;
+        for (size_t i = 0; i < n; i += 2) {
+            last_i = i;
+            last = _a[i].max = _a[i].high;
+        }
+        int k = 1;
+        for (; (size_t(1) << k) <= n; k++) {
+            size_t x = size_t(1) << (k - 1), i0 = (x << 1) - 1, step = x << 2;
+            for (size_t i = i0; i < n; i += step) {
+                T e = std::max(_a[i].high, _a[i - x].max);
+                _a[i].max = std::max(e, i + x < n ? _a[i + x].max : last);
+            }
+            last_i = (last_i >> k & 1) ? last_i - x : last_i + x;
+            if (last_i < n && last < _a[last_i].max) {
+                last = _a[last_i].max;
+            }
+        }
+        _levels = k - 1;
+    }
+};
+
+#endif
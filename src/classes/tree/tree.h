@@ -1,6 +1,10 @@
 #ifndef TREE_H
 #define TREE_H
 
+#include "../../helpers/node_pool.h"
+#include "../../helpers/tree_path.h"
+#include "flat_tree.h"
+
 #ifdef ENABLE_TREE_VISUALIZATION
 #include "../../visualization/tree_visual/tree_visualization.h"
 #endif
@@ -8,7 +12,7 @@
 #ifdef __cplusplus
 #include <functional>
 #include <iostream>
-#include <memory>
+#include <iterator>
 #include <queue>
 #endif
 
@@ -20,13 +24,33 @@ template <typename T> class tree {
   private:
     struct node {
         T info;
-        std::shared_ptr<node> right;
-        std::shared_ptr<node> left;
+        node* right;
+        node* left;
         node(T info) : info(info), left(nullptr), right(nullptr) {}
     };
 
     int64_t _size{};
-    std::shared_ptr<node> root;
+    node_pool<node> _pool;
+    node* root;
+
+    node* _copy(const node* t) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        node* nn = _pool.create(t->info);
+        nn->left = _copy(t->left);
+        nn->right = _copy(t->right);
+        return nn;
+    }
+
+    void _release(node* t) {
+        if (t) {
+            _release(t->left);
+            _release(t->right);
+            _pool.destroy(t);
+            _size--;
+        }
+    }
 
   public:
     /**
@@ -42,20 +66,72 @@ template <typename T> class tree {
         }
     }
 
+    /**
+     * @brief Copy constructor for tree class
+     * @param t the tree we want to copy
+     */
+    inline explicit tree(const tree& t) : _size(t._size), root(_copy(t.root)) {}
+
+    /**
+     * @brief operator = for tree class
+     * @param t the tree we want to copy
+     * @return tree&
+     */
+    inline tree& operator=(const tree& t) {
+        if (this != &t) {
+            clear();
+            root = _copy(t.root);
+            _size = t._size;
+        }
+        return *this;
+    }
+
+    inline ~tree() { clear(); }
+
+    /**
+     * @brief clear function
+     */
+    inline void clear() {
+        _pool.clear(root, [](node* n, auto visit) {
+            visit(n->left);
+            visit(n->right);
+        });
+        root = nullptr;
+        _size = 0;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the elements, the links of the nodes, the tree and the
+     * slab table of its pool, and the free slots of the pool
+     */
+    MEMORY::footprint memory_usage() const {
+        size_t owned = MEMORY::owned(
+            root,
+            [](const node* n, auto visit) {
+                visit(n->left);
+                visit(n->right);
+            },
+            [](const node* n) -> const T& { return n->info; });
+        MEMORY::footprint f = _pool.memory_usage(sizeof(T), owned);
+        f.control += sizeof(*this);
+        return f;
+    }
+
     /**
      * @brief insert function
      * @param direction: string, directions for the insertion of value info
      * @param info: the value of the new node
+     * The subtree that was at the end of the path is replaced by the new node.
      */
     inline void insert(std::string direction, T info) {
-        std::shared_ptr<node> nn = std::make_shared<node>(info);
         if (!root) {
             _size++;
-            root = nn;
+            root = _pool.create(info);
             return;
         }
         int64_t i = 0;
-        std::shared_ptr<node> head = root;
+        node* head = root;
         while (head && i < direction.size() - 1) {
             if (direction[i] == 'r') {
                 head = head->right;
@@ -64,12 +140,12 @@ template <typename T> class tree {
             }
             i++;
         }
-        if (head && direction[i] == 'r') {
-            head->right = nn;
-        } else if (head && direction[i] == 'l') {
-            head->left = nn;
+        if (head && (direction[i] == 'r' || direction[i] == 'l')) {
+            node*& child = direction[i] == 'r' ? head->right : head->left;
+            _release(child);
+            child = _pool.create(info);
+            _size++;
         }
-        _size++;
     }
 
     /**
@@ -79,12 +155,12 @@ template <typename T> class tree {
      * @return false: otherwise
      */
     inline bool search(T key) {
-        std::queue<std::shared_ptr<node>> q;
+        std::queue<node*> q;
         q.push(root);
         while (!q.empty()) {
             int64_t size = q.size();
             for (int64_t i = 0; i < size; ++i) {
-                std::shared_ptr<node> current = q.front();
+                node* current = q.front();
                 q.pop();
                 if (current->info == key) {
                     return true;
@@ -100,17 +176,22 @@ template <typename T> class tree {
         return false;
     }
 
+    /**
+     * @brief flatten function
+     * @return flat_tree<T>: the tree in the arrays of a flat_tree, in level order, to walk
+     * it faster or to serialize it.
+     */
+    inline flat_tree<T> flatten() const { return flat_tree<T>::build(root); }
+
     class Iterator;
 
-    inline Iterator begin() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(0, ino);
+    inline Iterator begin() const {
+        tree_path<node> path(root);
+        path.first();
+        return Iterator(path);
     }
 
-    inline Iterator end() {
-        std::vector<T> ino = this->inorder();
-        return Iterator(ino.size(), ino);
-    }
+    inline Iterator end() const { return Iterator(tree_path<node>(root)); }
 
     /**
      * @brief inorder traversal
@@ -118,7 +199,7 @@ template <typename T> class tree {
      */
     inline std::vector<T> inorder() {
         std::vector<T> ino;
-        _inorder([&](std::shared_ptr<node> callbacked) { ino.push_back(callbacked->info); }, root);
+        _inorder([&](node* callbacked) { ino.push_back(callbacked->info); }, root);
         return ino;
     }
 
@@ -128,8 +209,7 @@ template <typename T> class tree {
      */
     inline std::vector<T> postorder() {
         std::vector<T> path;
-        _postorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                   root);
+        _postorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -139,8 +219,7 @@ template <typename T> class tree {
      */
     inline std::vector<T> preorder() {
         std::vector<T> path;
-        _preorder([&](std::shared_ptr<node> callbacked) { path.push_back(callbacked->info); },
-                  root);
+        _preorder([&](node* callbacked) { path.push_back(callbacked->info); }, root);
         return path;
     }
 
@@ -150,13 +229,13 @@ template <typename T> class tree {
      */
     inline std::vector<std::vector<T>> level_order() {
         std::vector<std::vector<T>> path;
-        std::queue<std::shared_ptr<node>> q;
+        std::queue<node*> q;
         q.push(root);
         while (!q.empty()) {
             size_t size = q.size();
             std::vector<T> level;
             for (size_t i = 0; i < size; i++) {
-                std::shared_ptr<node> current = q.front();
+                node* current = q.front();
                 q.pop();
                 level.push_back(current->info);
                 if (current->left) {
@@ -198,7 +277,7 @@ template <typename T> class tree {
 #endif
 
   private:
-    void _inorder(std::function<void(std::shared_ptr<node>)> callback, std::shared_ptr<node> root) {
+    void _inorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             _inorder(callback, root->left);
             callback(root);
@@ -206,17 +285,15 @@ template <typename T> class tree {
         }
     }
 
-    void _preorder(std::function<void(std::shared_ptr<node>)> callback,
-                   std::shared_ptr<node> root) {
+    void _preorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             callback(root);
             _preorder(callback, root->left);
-            _preorder(callback, root->righ);
+            _preorder(callback, root->right);
         }
     }
 
-    void _postorder(std::function<void(std::shared_ptr<node>)> callback,
-                    std::shared_ptr<node> root) {
+    void _postorder(std::function<void(node*)> callback, node* root) {
         if (root) {
             _postorder(callback, root->right);
             callback(root);
@@ -229,7 +306,7 @@ template <typename T> class tree {
         return _generate;
     }
 
-    std::string _inorder_gen(std::shared_ptr<node> root) {
+    std::string _inorder_gen(node* root) {
         std::string _s;
         if (std::is_same_v<T, char> || std::is_same_v<T, std::string>) {
             if (root->left) {
@@ -260,30 +337,29 @@ template <typename T> class tree {
     }
 };
 
+/**
+ * @brief Iterator class
+ * Bidirectional inorder iterator that walks the tree lazily: it keeps the path from the
+ * root to the current node, each step costs O(1) amortized and nothing is copied. Any
+ * insert or remove invalidates the iterators of the tree.
+ */
 template <typename T> class tree<T>::Iterator {
   private:
-    std::vector<T> elements;
-    int64_t index;
+    tree_path<node> _path;
 
   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
     /**
      * @brief Construct a new Iterator object
      *
-     * @param els vector<T> - the elements in inorder fashion
+     * @param path the path from the root to the current node
      */
-    explicit Iterator(const int64_t& index, std::vector<T>& els) noexcept
-        : index(index), elements(els) {}
-
-    /**
-     * @brief = operator for Iterator type
-     *
-     * @param index the current index
-     * @return Iterator&
-     */
-    Iterator& operator=(int64_t index) {
-        this->index = index;
-        return *(this);
-    }
+    explicit Iterator(const tree_path<node>& path) : _path(path) {}
 
     /**
      * @brief operator ++ for type Iterator
@@ -291,9 +367,7 @@ template <typename T> class tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator++() {
-        if (this->index < elements.size()) {
-            this->index++;
-        }
+        _path.next();
         return *(this);
     }
 
@@ -314,9 +388,7 @@ template <typename T> class tree<T>::Iterator {
      * @return Iterator&
      */
     Iterator& operator--() {
-        if (this->index > 0) {
-            this->index--;
-        }
+        _path.prev();
         return *(this);
     }
 
@@ -331,21 +403,35 @@ template <typename T> class tree<T>::Iterator {
         return it;
     }
 
+    /**
+     * @brief operator == for type Iterator
+     *
+     * @param it const Iterator
+     * @return true if both iterators point to the same node
+     */
+    bool operator==(const Iterator& it) const { return _path == it._path; }
+
     /**
      * @brief operator != for type Iterator
      *
      * @param it const Iterator
-     * @return true if index == it.index
-     * @return false otherwise
+     * @return true if the iterators point to different nodes
      */
-    bool operator!=(const Iterator& it) { return index != it.index; }
+    bool operator!=(const Iterator& it) const { return _path != it._path; }
 
     /**
      * @brief operator * for type Iterator
      *
-     * @return T the value of the node
+     * @return const T& the element of the current node
+     */
+    const T& operator*() const { return _path.node()->info; }
+
+    /**
+     * @brief operator -> for type Iterator
+     *
+     * @return const T* the element of the current node
      */
-    T operator*() { return elements[index]; }
+    const T* operator->() const { return &_path.node()->info; }
 };
 
 #endif
@@ -1,23 +1,42 @@
 #ifndef TRIE_H
 #define TRIE_H
 
+#include "../../helpers/node_pool.h"
+#include "double_array_trie.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <memory>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #endif
 
 /**
  *@brief trie class
+ * Trie of lowercase words, every word carries a weight. Every node caches the largest
+ * weight of the words below it, so complete() finds the heaviest words under a prefix by
+ * a best-first walk that only expands the nodes on the way to its answers.
  */
 class trie {
   private:
     struct node {
-        std::shared_ptr<node> characters[26]{nullptr};
+        node* characters[26]{nullptr};
+        node* parent{nullptr};
+        // the largest weight of the words of the subtree, -inf if it has none
+        double best{-std::numeric_limits<double>::infinity()};
+        double weight{0};
+        char c{0};
         bool end_word{false};
     };
 
-    std::shared_ptr<node> root;
+    node_pool<node> _pool;
+    node* root;
     size_t _size{};
 
   public:
@@ -25,13 +44,15 @@ class trie {
      * @brief Construct a new trie object
      *
      * @param v : vector of strings for initializer.
+     * @param resource : the memory resource the nodes come from. Default =
+     * std::pmr::get_default_resource()
      */
-    inline explicit trie(std::vector<std::string> v = {}) noexcept
-        : root(std::make_shared<node>()) {
-        if (!v.empty()) {
-            for (auto& x : v) {
-                this->insert(x);
-            }
+    inline explicit trie(std::vector<std::string> v = {},
+                         std::pmr::memory_resource* resource =
+                             std::pmr::get_default_resource())
+        : _pool(resource), root(_pool.create()) {
+        for (auto& x : v) {
+            this->insert(x);
         }
     }
 
@@ -39,7 +60,15 @@ class trie {
      * @brief Copy constructor for trie class
      * @param t the tree we want to copy
      */
-    inline explicit trie(const trie& t) : root(t.root), _size(t._size) {}
+    inline explicit trie(const trie& t) : root(_copy(t.root, nullptr)), _size(t._size) {}
+
+    /**
+     * @brief Move constructor for trie class
+     * @param t the tree we want to move, it is left empty
+     */
+    inline trie(trie&& t)
+        : _pool(std::move(t._pool)), root(std::exchange(t.root, t._pool.create())),
+          _size(std::exchange(t._size, 0)) {}
 
     /**
      * @brief operator = for trie class
@@ -47,48 +76,140 @@ class trie {
      * @return trie&
      */
     inline trie& operator=(const trie& t) {
-        root = t.root;
-        _size = t._size;
+        if (this != &t) {
+            _release();
+            root = _copy(t.root, nullptr);
+            _size = t._size;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief move assignment for trie class
+     * @param t the tree we want to move, it is left empty
+     * @return trie&
+     */
+    inline trie& operator=(trie&& t) {
+        if (this != &t) {
+            _release();
+            _pool = std::move(t._pool);
+            root = std::exchange(t.root, t._pool.create());
+            _size = std::exchange(t._size, 0);
+        }
         return *this;
     }
 
+    inline ~trie() { _release(); }
+
     /**
      *@brief empty function.
      *@returns true if the trie is empty.
      */
-    inline bool empty() { return root == nullptr; }
+    inline bool empty() const { return _size == 0; }
+
     /**
      *@brief insert function.
      *@param key: the key to be inserted.
+     *@param weight: the weight of the key for complete(), replaces the old one if the key
+     *exists. Default = 0
+     *Throws std::invalid_argument if key has characters outside 'a'..'z'.
      */
-    inline void insert(std::string key);
+    inline void insert(std::string_view key, double weight = 0);
 
     /**
      * @brief size function
      *
      * @return size_t the size of the tree
      */
-    inline size_t size() { return _size; }
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief resource function
+     *
+     * @return std::pmr::memory_resource* the resource the nodes come from
+     */
+    inline std::pmr::memory_resource* resource() const noexcept { return _pool.resource(); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint: the characters and weights of the nodes, their links and
+     * cached weights, the trie and the slab table of its pool, and the free slots of the pool
+     */
+    inline MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = _pool.memory_usage(sizeof(char) + sizeof(double));
+        f.control += sizeof(*this);
+        return f;
+    }
+
     /**
      *@brief remove function.
      *@param key: the key to be removed.
      */
-    inline void remove(std::string key);
+    inline void remove(std::string_view key);
+
     /**
      *@brief search function.
      *@param key: the key to be searched.
      *@returns true if the word exist in the tree.
      */
-    inline bool search(std::string key);
+    inline bool search(std::string_view key) const {
+        const node* n = _walk(key);
+        return n && n->end_word;
+    }
+
+    /**
+     *@brief complete function.
+     *Best-first walk from the node of prefix: a heap holds subtrees by their cached best
+     *weight and words by their weight, and the next word popped is always the heaviest
+     *that is left. Only the nodes on the paths to the k answers are expanded and the heap
+     *is the only allocation besides the answers.
+     *@param prefix: the prefix of the words.
+     *@param k: the number of words to return.
+     *@returns vector<pair<string, double>>, the at most k heaviest words that start with
+     *prefix and their weights, heaviest first.
+     */
+    inline std::vector<std::pair<std::string, double>> complete(std::string_view prefix,
+                                                                size_t k) const;
+
+    /**
+     *@brief save_archive function.
+     *Writes the words as the archive of a double_array_trie with their weights as its values,
+     *so double_array_trie::map_archive answers lookups from the file in place.
+     *@param path: the output file, overwritten.
+     *Throws std::runtime_error if the file can not be written.
+     */
+    inline void save_archive(const std::string& path) const;
+
+    /**
+     *@brief load_archive function.
+     *@param path: a file written by save_archive.
+     *@returns trie the words of the archive with their weights, inserted in sorted order.
+     *Throws std::runtime_error like archive_view.
+     */
+    static inline trie load_archive(const std::string& path);
 
     inline friend std::ostream& operator<<(std::ostream& out, trie& t);
 
   private:
+    static int64_t _index(char c) { return c >= 'a' && c <= 'z' ? c - 'a' : -1; }
+
+    const node* _walk(std::string_view key) const {
+        const node* current = root;
+        for (char c : key) {
+            int64_t index = _index(c);
+            if (index < 0 || !current->characters[index]) {
+                return nullptr;
+            }
+            current = current->characters[index];
+        }
+        return current;
+    }
+
     /**
      *@brief __children function.
      *checks if a node has children or not.
      */
-    bool _children(std::shared_ptr<node> root) {
+    static bool _children(const node* root) {
         for (int64_t i = 0; i < 26; i++) {
             if (root->characters[i]) {
                 return true;
@@ -96,61 +217,161 @@ class trie {
         }
         return false;
     }
-    /**
-     *@brief __remove function.
-     *helper function of remove().
-     */
-    std::shared_ptr<node> _remove(std::shared_ptr<node> current, std::string word, int64_t index) {
-        if (word.size() == index) {
-            if (current->end_word) {
-                current->end_word = false;
-                _size--;
+
+    // recomputes the cached best weight from n up to the root, stops once it holds
+    static void _refresh(node* n) {
+        for (; n; n = n->parent) {
+            double best = n->end_word ? n->weight : -std::numeric_limits<double>::infinity();
+            for (const node* c : n->characters) {
+                if (c && best < c->best) {
+                    best = c->best;
+                }
             }
-            if (_children(current)) {
-                return current;
+            if (best == n->best) {
+                return;
             }
-            return nullptr;
+            n->best = best;
         }
+    }
 
-        int64_t i = word[index] - 'a';
-        if (!current->characters[i]) {
-            return nullptr;
+    static std::string _key(const node* n) {
+        std::string key;
+        for (; n->parent; n = n->parent) {
+            key.push_back(n->c);
         }
-        current->characters[i] = _remove(current->characters[i], word, index + 1);
-        if (current->characters[i] || _children(current)) {
-            return current;
+        std::reverse(key.begin(), key.end());
+        return key;
+    }
+
+    node* _copy(const node* t, node* parent) {
+        node* nn = _pool.create(*t);
+        nn->parent = parent;
+        for (int64_t i = 0; i < 26; i++) {
+            if (t->characters[i]) {
+                nn->characters[i] = _copy(t->characters[i], nn);
+            }
         }
-        return nullptr;
+        return nn;
+    }
+
+    void _release() {
+        _pool.clear(root, [](node* n, auto visit) {
+            for (node* c : n->characters) {
+                visit(c);
+            }
+        });
+        root = nullptr;
     }
 };
 
-void trie::insert(std::string key) {
-    std::shared_ptr<node> current = root;
-    for (auto& c : key) {
-        int64_t index = c - 'a';
+void trie::insert(std::string_view key, double weight) {
+    for (char c : key) {
+        if (_index(c) < 0) {
+            throw std::invalid_argument("trie::insert: keys are made of 'a'..'z'");
+        }
+    }
+    node* current = root;
+    for (char c : key) {
+        int64_t index = _index(c);
         if (!current->characters[index]) {
-            current->characters[index] = std::make_shared<node>();
+            node* nn = _pool.create();
+            nn->parent = current;
+            nn->c = c;
+            current->characters[index] = nn;
         }
         current = current->characters[index];
     }
-    current->end_word = true;
-    _size++;
+    if (!current->end_word) {
+        current->end_word = true;
+        _size++;
+    }
+    current->weight = weight;
+    _refresh(current);
 }
 
-void trie::remove(std::string key) {
-    root = _remove(root, key, 0);
+void trie::remove(std::string_view key) {
+    node* current = const_cast<node*>(_walk(key));
+    if (!current || !current->end_word) {
+        return;
+    }
+    current->end_word = false;
+    _size--;
+    // the nodes that lead to no word any more go back to the pool
+    while (current != root && !current->end_word && !_children(current)) {
+        node* parent = current->parent;
+        parent->characters[_index(current->c)] = nullptr;
+        _pool.destroy(current);
+        current = parent;
+    }
+    _refresh(current);
 }
 
-bool trie::search(std::string key) {
-    std::shared_ptr<node> current = root;
-    for (auto& c : key) {
-        int64_t index = c - 'a';
-        if (!current->characters[index]) {
-            return false;
+std::vector<std::pair<std::string, double>> trie::complete(std::string_view prefix,
+                                                           size_t k) const {
+    std::vector<std::pair<std::string, double>> words;
+    const node* start = _walk(prefix);
+    if (!start || k == 0 || start->best == -std::numeric_limits<double>::infinity()) {
+        return words;
+    }
+    struct entry {
+        double weight;
+        const node* n;
+        bool word;
+        bool operator<(const entry& e) const { return weight < e.weight; }
+    };
+    std::vector<entry> heap = {{start->best, start, false}};
+    while (!heap.empty() && words.size() < k) {
+        std::pop_heap(heap.begin(), heap.end());
+        entry e = heap.back();
+        heap.pop_back();
+        if (e.word) {
+            words.push_back({_key(e.n), e.weight});
+            continue;
         }
-        current = current->characters[index];
+        if (e.n->end_word) {
+            heap.push_back({e.n->weight, e.n, true});
+            std::push_heap(heap.begin(), heap.end());
+        }
+        for (const node* c : e.n->characters) {
+            if (c) {
+                heap.push_back({c->best, c, false});
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+    return words;
+}
+
+void trie::save_archive(const std::string& path) const {
+    std::vector<std::pair<std::string, double>> words = complete("", _size);
+    std::sort(words.begin(), words.end());
+    std::vector<std::string> keys;
+    std::vector<double> weights;
+    keys.reserve(words.size());
+    weights.reserve(words.size());
+    for (auto& [word, weight] : words) {
+        keys.push_back(std::move(word));
+        weights.push_back(weight);
+    }
+    // the ids of the double array are the ranks of the sorted words
+    double_array_trie(std::move(keys)).save_archive(path, weights);
+}
+
+trie trie::load_archive(const std::string& path) {
+    double_array_trie d = double_array_trie::map_archive(path);
+    std::span<const double> weights = d.values();
+    trie t;
+    d.with_prefix("", [&](const std::string& key, size_t id) {
+        t.insert(key, weights.empty() ? 0 : weights[id]);
+    });
+    return t;
+}
+
+std::ostream& operator<<(std::ostream& out, trie& t) {
+    for (auto& [word, weight] : t.complete("", t.size())) {
+        out << word << '\n';
     }
-    return current->end_word;
+    return out;
 }
 
 #endif
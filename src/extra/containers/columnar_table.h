@@ -0,0 +1,342 @@
+/**
+ * Please have in mind that this header is created for C++20 only
+ * This header file is not included at the core code of AlgoPlus
+ * as it was created for experimental purposes
+ */
+
+#ifndef COLUMNAR_TABLE_H
+#define COLUMNAR_TABLE_H
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief columnar table class
+ * A table whose rows are tuples of Cols, stored column by column: every run of group_rows
+ * rows(a row group) keeps one contiguous array per column, so a scan of one column reads
+ * only that column, the arrays are handed out as spans without copying, and the
+ * aggregates run tight loops over them that the compiler can vectorize. Appending only
+ * touches the last group, and the arrays of the full groups never move.
+ * @tparam Cols the types of the columns.
+ */
+template <typename... Cols> class columnar_table {
+    static_assert(sizeof...(Cols) > 0, "columnar_table needs at least one column");
+
+  public:
+    /**
+     * @brief the type of the column I
+     */
+    template <size_t I> using column_type = std::tuple_element_t<I, std::tuple<Cols...>>;
+
+    /**
+     * @brief the type sum() returns for a column of type T, 64 bit for the integers
+     */
+    template <typename T>
+    using sum_type = std::conditional_t<
+        std::is_integral_v<T>, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>, T>;
+
+    /**
+     * @brief Construct a new columnar table object
+     * @param group_rows: the number of rows per row group. Default = 65536
+     * Throws std::invalid_argument if group_rows is 0.
+     */
+    explicit columnar_table(size_t group_rows = 65536) : _group_rows(group_rows) {
+        if (group_rows == 0) {
+            throw std::invalid_argument("columnar_table: row groups need at least one row");
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of rows.
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief empty function
+     * @return true if the table has no rows.
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief groups function
+     * @return size_t the number of row groups, all but the last are full.
+     */
+    size_t groups() const { return _groups.size(); }
+
+    /**
+     * @brief group_rows function
+     * @return size_t the number of rows of a full row group.
+     */
+    size_t group_rows() const { return _group_rows; }
+
+    /**
+     * @brief clear function
+     */
+    void clear() {
+        _groups.clear();
+        _size = 0;
+    }
+
+    /**
+     * @brief push_back function
+     * @param values: the value of every column of the new row.
+     */
+    void push_back(Cols... values) {
+        group& g = _last();
+        _push(g, std::index_sequence_for<Cols...>{}, std::move(values)...);
+        _size++;
+    }
+
+    /**
+     * @brief append function
+     * Appends many rows given column by column, group by group.
+     * @param columns: one span per column, all of the same size.
+     * Throws std::invalid_argument if the spans have different sizes.
+     */
+    void append(std::span<const Cols>... columns) {
+        size_t n = std::get<0>(std::forward_as_tuple(columns...)).size();
+        if (((columns.size() != n) || ...)) {
+            throw std::invalid_argument("columnar_table: columns of different sizes");
+        }
+        for (size_t done = 0; done < n;) {
+            group& g = _last();
+            size_t k = std::min(n - done, _group_rows - g.rows);
+            _append(g, std::index_sequence_for<Cols...>{}, done, k, columns...);
+            g.rows += k;
+            done += k;
+            _size += k;
+        }
+    }
+
+    /**
+     * @brief column function
+     * @tparam I the index of the column.
+     * @param g: the index of the row group.
+     * @return std::span<const column_type<I>> the values of the column in the group.
+     */
+    template <size_t I> std::span<const column_type<I>> column(size_t g) const {
+        return std::get<I>(_groups[g].columns);
+    }
+
+    /**
+     * @brief get function
+     * @tparam I the index of the column.
+     * @param row: the index of the row.
+     * @return const column_type<I>& the value of the column in the row.
+     * Throws std::out_of_range if row is not less than size().
+     */
+    template <size_t I> const column_type<I>& get(size_t row) const {
+        _check(row);
+        return std::get<I>(_groups[row / _group_rows].columns)[row % _group_rows];
+    }
+
+    /**
+     * @brief set function
+     * @tparam I the index of the column.
+     * @param row: the index of the row.
+     * @param value: the new value of the column in the row.
+     * Throws std::out_of_range if row is not less than size().
+     */
+    template <size_t I> void set(size_t row, column_type<I> value) {
+        _check(row);
+        std::get<I>(_groups[row / _group_rows].columns)[row % _group_rows] = std::move(value);
+    }
+
+    /**
+     * @brief row function
+     * @param row: the index of the row.
+     * @return std::tuple<Cols...> a copy of the row.
+     * Throws std::out_of_range if row is not less than size().
+     */
+    std::tuple<Cols...> row(size_t row) const {
+        _check(row);
+        const group& g = _groups[row / _group_rows];
+        size_t i = row % _group_rows;
+        return std::apply([i](const auto&... c) { return std::tuple<Cols...>(c[i]...); },
+                          g.columns);
+    }
+
+    /**
+     * @brief scan function
+     * Calls f with the span of the column of every row group, in order.
+     * @tparam I the index of the column.
+     * @param f: f(std::span<const column_type<I>>).
+     */
+    template <size_t I, typename F> void scan(F f) const {
+        for (size_t g = 0; g < _groups.size(); g++) {
+            f(column<I>(g));
+        }
+    }
+
+    /**
+     * @brief sum function
+     * @tparam I the index of the column.
+     * @return sum_type<column_type<I>> the sum of the column, 0 for an empty table.
+     */
+    template <size_t I> auto sum() const {
+        using S = sum_type<column_type<I>>;
+        S total{};
+        scan<I>([&](auto values) {
+            // four partial sums so the additions do not wait for each other
+            S part[4]{};
+            size_t i = 0;
+            for (; i + 4 <= values.size(); i += 4) {
+                part[0] += S(values[i]);
+                part[1] += S(values[i + 1]);
+                part[2] += S(values[i + 2]);
+                part[3] += S(values[i + 3]);
+            }
+            for (; i < values.size(); i++) {
+                part[0] += S(values[i]);
+            }
+            total += (part[0] + part[1]) + (part[2] + part[3]);
+        });
+        return total;
+    }
+
+    /**
+     * @brief min function
+     * @tparam I the index of the column.
+     * @return std::optional<column_type<I>> the smallest value, std::nullopt if empty.
+     */
+    template <size_t I> std::optional<column_type<I>> min() const {
+        return _fold<I>([](const auto& a, const auto& b) { return b < a ? b : a; });
+    }
+
+    /**
+     * @brief max function
+     * @tparam I the index of the column.
+     * @return std::optional<column_type<I>> the largest value, std::nullopt if empty.
+     */
+    template <size_t I> std::optional<column_type<I>> max() const {
+        return _fold<I>([](const auto& a, const auto& b) { return a < b ? b : a; });
+    }
+
+    /**
+     * @brief count function
+     * @tparam I the index of the column.
+     * @param pred: pred(value) tells if a value counts.
+     * @return size_t the number of rows whose value of the column satisfies pred.
+     */
+    template <size_t I, typename P> size_t count(P pred) const {
+        size_t n = 0;
+        scan<I>([&](auto values) {
+            for (const auto& x : values) {
+                n += pred(x) ? 1 : 0;
+            }
+        });
+        return n;
+    }
+
+    /**
+     * @brief filter function
+     * @tparam I the index of the column.
+     * @param pred: pred(value) tells if a row is selected.
+     * @return std::vector<size_t> the indices of the selected rows, in order.
+     */
+    template <size_t I, typename P> std::vector<size_t> filter(P pred) const {
+        std::vector<size_t> rows(_size);
+        size_t n = 0, base = 0;
+        scan<I>([&](auto values) {
+            // every row is written and only the selected ones move n, so there is no branch
+            for (size_t i = 0; i < values.size(); i++) {
+                rows[n] = base + i;
+                n += pred(values[i]) ? 1 : 0;
+            }
+            base += values.size();
+        });
+        rows.resize(n);
+        return rows;
+    }
+
+    /**
+     * @brief sum function
+     * @tparam I the index of the column.
+     * @param rows: indices of rows in increasing order, like the ones filter() returns.
+     * @return sum_type<column_type<I>> the sum of the column over the rows.
+     */
+    template <size_t I> auto sum(const std::vector<size_t>& rows) const {
+        sum_type<column_type<I>> total{};
+        for (size_t r : rows) {
+            total += std::get<I>(_groups[r / _group_rows].columns)[r % _group_rows];
+        }
+        return total;
+    }
+
+    /**
+     * @brief vectorize function
+     * @tparam I the index of the column.
+     * @return std::vector<column_type<I>> a copy of the column.
+     */
+    template <size_t I> std::vector<column_type<I>> vectorize() const {
+        std::vector<column_type<I>> out;
+        out.reserve(_size);
+        scan<I>([&](auto values) { out.insert(out.end(), values.begin(), values.end()); });
+        return out;
+    }
+
+  private:
+    struct group {
+        std::tuple<std::vector<Cols>...> columns;
+        size_t rows{0};
+    };
+
+    size_t _group_rows;
+    size_t _size{0};
+    std::vector<group> _groups;
+
+    void _check(size_t row) const {
+        if (row >= _size) {
+            throw std::out_of_range("columnar_table: row out of range");
+        }
+    }
+
+    // the group rows go to, a new one when the last is full
+    group& _last() {
+        if (_groups.empty() || _groups.back().rows == _group_rows) {
+            group& g = _groups.emplace_back();
+            std::apply([this](auto&... c) { (c.reserve(_group_rows), ...); }, g.columns);
+        }
+        return _groups.back();
+    }
+
+    template <size_t... I, typename... V>
+    static void _push(group& g, std::index_sequence<I...>, V&&... values) {
+        (std::get<I>(g.columns).push_back(std::forward<V>(values)), ...);
+        g.rows++;
+    }
+
+    template <size_t... I>
+    static void _append(group& g, std::index_sequence<I...>, size_t from, size_t k,
+                        std::span<const Cols>... columns) {
+        (std::get<I>(g.columns).insert(std::get<I>(g.columns).end(), columns.begin() + from,
+                                       columns.begin() + from + k),
+         ...);
+    }
+
+    template <size_t I, typename F> std::optional<column_type<I>> _fold(F pick) const {
+        if (_size == 0) {
+            return std::nullopt;
+        }
+        column_type<I> best = column<I>(0)[0];
+        scan<I>([&](auto values) {
+            for (const auto& x : values) {
+                best = pick(best, x);
+            }
+        });
+        return best;
+    }
+};
+
+#endif
@@ -1,78 +1,220 @@
 #ifndef PARALLELIZED_MATRIX_H
 #define PARALLELIZED_MATRIX_H
 
+#include "../../helpers/thread_pool.h"
+
 #ifdef __cplusplus
-#include <cassert>
-#include <future>
-#include <iostream>
-#include <thread>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #endif
 
-int TOTAL_THREADS = 2;
+// the maximum number of chunks an operation is split in(0 means the concurrency of the pool)
+inline size_t TOTAL_THREADS = 0;
+
+namespace _parallelized_matrix_utils {
+// below this many elements(multiply-adds for mul) an operation runs on the calling thread:
+// handing chunks to the pool costs a few microseconds, about as much as adding that many
+constexpr size_t serial_threshold = size_t(1) << 16;
+
+template <typename T> using matrix = std::vector<std::vector<T>>;
+
+/**
+ * @brief runs f(lo, hi) over the rows [0, rows), on the shared pool when the work is above
+ * serial_threshold
+ * @param rows the number of rows
+ * @param work the number of elements or multiply-adds of the operation
+ * @param f callable invoked as f(lo, hi) once per row range
+ */
+template <typename F> void for_rows(size_t rows, size_t work, F&& f) {
+    if (work < serial_threshold) {
+        f(size_t(0), rows);
+        return;
+    }
+    PARALLEL::thread_pool& pool = PARALLEL::thread_pool::shared();
+    // no chunk gets less than serial_threshold elements' worth of rows
+    size_t chunks = std::min(TOTAL_THREADS == 0 ? pool.concurrency() : TOTAL_THREADS,
+                             work / serial_threshold);
+    pool.parallel_for(0, rows, chunks, [&](size_t lo, size_t hi, size_t) { f(lo, hi); });
+}
 
-namespace serial {
-std::vector<std::vector<int64_t>> add(std::vector<std::vector<int64_t>>& v1,
-                                      std::vector<std::vector<int64_t>>& v2) {
+/**
+ * @brief element wise op over the common rows and columns of v1 and v2, an empty operand
+ * gives the other one
+ */
+template <typename T, typename Op>
+matrix<T> element_wise(const matrix<T>& v1, const matrix<T>& v2, Op op) {
     if (v1.empty()) {
         return v2;
     }
     if (v2.empty()) {
         return v1;
     }
-
-    int64_t n = std::min(v1.size(), v2.size()), m = std::min(v1[0].size(), v2[0].size());
-
-    std::vector<std::vector<int64_t>> result(n, std::vector<int64_t>(m, 0));
-
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < m; j++) {
-            result[i][j] = v1[i][j] + v2[i][j];
+    size_t n = std::min(v1.size(), v2.size()), m = std::min(v1[0].size(), v2[0].size());
+    matrix<T> result(n, std::vector<T>(m));
+    for_rows(n, n * m, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; i++) {
+            const T* a = v1[i].data();
+            const T* b = v2[i].data();
+            T* c = result[i].data();
+            for (size_t j = 0; j < m; j++) {
+                c[j] = op(a[j], b[j]);
+            }
         }
-    }
-
+    });
     return result;
 }
-} // namespace serial
-
-namespace parallel {
-
-void compute(std::vector<std::vector<int64_t>>& result, std::vector<std::vector<int64_t>>& v1,
-             std::vector<std::vector<int64_t>>& v2, const int64_t i, const int64_t j) {
-    int64_t m = std::min(v1[0].size(), v2[0].size());
-
-    for (int k = i; k < j; k++) {
-        for (int w = 0; w < m; w++) {
-            result[k][w] = v1[k][w] + v2[k][w];
-        }
-    }
-}
+} // namespace _parallelized_matrix_utils
 
-std::vector<std::vector<int64_t>> add(std::vector<std::vector<int64_t>>& v1,
-                                      std::vector<std::vector<int64_t>>& v2) {
+namespace serial {
+/**
+ * @brief add function
+ * @param v1 the first matrix
+ * @param v2 the second matrix
+ * @return std::vector<std::vector<T>> the sum over the rows and columns both have, on the
+ * calling thread.
+ */
+template <typename T>
+std::vector<std::vector<T>> add(const std::vector<std::vector<T>>& v1,
+                                const std::vector<std::vector<T>>& v2) {
     if (v1.empty()) {
         return v2;
     }
     if (v2.empty()) {
         return v1;
     }
+    size_t n = std::min(v1.size(), v2.size()), m = std::min(v1[0].size(), v2[0].size());
+    std::vector<std::vector<T>> result(n, std::vector<T>(m));
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            result[i][j] = v1[i][j] + v2[i][j];
+        }
+    }
+    return result;
+}
+} // namespace serial
 
-    int64_t n = std::min(v1.size(), v2.size()), m = std::min(v1[0].size(), v2[0].size());
-
-    std::vector<std::vector<int64_t>> result(n, std::vector<int64_t>(m, 0));
+namespace parallel {
+/**
+ * @brief add function
+ * The operations of this namespace split the rows of the result in contiguous ranges run on
+ * the shared thread pool, and run on the calling thread below 2^16 elements.
+ * @param v1 the first matrix
+ * @param v2 the second matrix
+ * @return std::vector<std::vector<T>> the sum over the rows and columns both have, an empty
+ * matrix gives the other one.
+ */
+template <typename T>
+std::vector<std::vector<T>> add(const std::vector<std::vector<T>>& v1,
+                                const std::vector<std::vector<T>>& v2) {
+    return _parallelized_matrix_utils::element_wise(v1, v2, std::plus<T>());
+}
 
-    std::vector<std::future<void>> threads;
+/**
+ * @brief sub function
+ * @param v1 the first matrix
+ * @param v2 the second matrix
+ * @return std::vector<std::vector<T>> v1 - v2 over the rows and columns both have, an
+ * empty matrix gives the other one.
+ */
+template <typename T>
+std::vector<std::vector<T>> sub(const std::vector<std::vector<T>>& v1,
+                                const std::vector<std::vector<T>>& v2) {
+    return _parallelized_matrix_utils::element_wise(v1, v2, std::minus<T>());
+}
 
-    int batch_size = n / TOTAL_THREADS;
-    for (int i = 0; i < TOTAL_THREADS; i++) {
-        int start = i * batch_size;
-        int end = (i == TOTAL_THREADS - 1) ? n : start + batch_size;
-        threads.push_back(std::async(std::launch::async, compute, std::ref(result), std::ref(v1),
-                                     std::ref(v2), start, end));
+/**
+ * @brief mul function
+ * @param v1 the first matrix, n x m
+ * @param v2 the second matrix, m x p
+ * @return std::vector<std::vector<T>> the n x p product v1 v2. Throws
+ * std::invalid_argument if the columns of v1 are not the rows of v2.
+ */
+template <typename T>
+std::vector<std::vector<T>> mul(const std::vector<std::vector<T>>& v1,
+                                const std::vector<std::vector<T>>& v2) {
+    size_t n = v1.size(), m = n ? v1[0].size() : 0, p = v2.empty() ? 0 : v2[0].size();
+    if (m != v2.size()) {
+        throw std::invalid_argument("mul: the columns of v1 must be the rows of v2");
     }
+    std::vector<std::vector<T>> result(n, std::vector<T>(p, T(0)));
+    _parallelized_matrix_utils::for_rows(n, n * m * p, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; i++) {
+            T* c = result[i].data();
+            for (size_t k = 0; k < m; k++) {
+                const T x = v1[i][k];
+                const T* b = v2[k].data();
+                for (size_t j = 0; j < p; j++) {
+                    c[j] += x * b[j];
+                }
+            }
+        }
+    });
+    return result;
+}
 
+/**
+ * @brief transpose function
+ * @param v the matrix, n x m
+ * @return std::vector<std::vector<T>> the m x n transpose of v.
+ */
+template <typename T> std::vector<std::vector<T>> transpose(const std::vector<std::vector<T>>& v) {
+    size_t n = v.size(), m = n ? v[0].size() : 0;
+    std::vector<std::vector<T>> result(m, std::vector<T>(n));
+    _parallelized_matrix_utils::for_rows(m, n * m, [&](size_t lo, size_t hi) {
+        // blocks of 32 rows of v keep the rows written by this range in cache
+        for (size_t ii = 0; ii < n; ii += 32) {
+            for (size_t j = lo; j < hi; j++) {
+                for (size_t i = ii; i < std::min(n, ii + 32); i++) {
+                    result[j][i] = v[i][j];
+                }
+            }
+        }
+    });
     return result;
 }
+
+/**
+ * @brief reduce function
+ * @param v the matrix
+ * @param init the initial value
+ * @param op an associative operation. Default = std::plus<T>
+ * @return T the reduction of init and the elements of v in row major order by op: every
+ * row range is reduced on its own and the partial results are combined in order, so the
+ * result does not depend on the number of threads.
+ */
+template <typename T, typename Op = std::plus<T>>
+T reduce(const std::vector<std::vector<T>>& v, T init = T(), Op op = Op()) {
+    size_t elements = 0;
+    for (const std::vector<T>& row : v) {
+        elements += row.size();
+    }
+    std::mutex parts_mutex;
+    std::vector<std::pair<size_t, T>> parts;
+    _parallelized_matrix_utils::for_rows(v.size(), elements, [&](size_t lo, size_t hi) {
+        std::optional<T> acc;
+        for (size_t i = lo; i < hi; i++) {
+            for (const T& x : v[i]) {
+                acc = acc ? op(*acc, x) : x;
+            }
+        }
+        if (acc) {
+            std::lock_guard<std::mutex> lock(parts_mutex);
+            parts.emplace_back(lo, *acc);
+        }
+    });
+    std::sort(parts.begin(), parts.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto& part : parts) {
+        init = op(init, part.second);
+    }
+    return init;
+}
 } // namespace parallel
 
 #endif
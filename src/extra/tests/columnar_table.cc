@@ -0,0 +1,66 @@
+#include "../containers/columnar_table.h"
+#include "../../../third_party/catch.hpp"
+#include <numeric>
+#include <string>
+
+TEST_CASE("Testing push_back and row access for columnar_table class") {
+    columnar_table<int, double, std::string> t(2);
+    REQUIRE(t.empty() == true);
+    REQUIRE(t.min<0>() == std::nullopt);
+    t.push_back(1, 1.5, "a");
+    t.push_back(2, 2.5, "b");
+    t.push_back(3, 3.5, "c");
+
+    REQUIRE(t.size() == 3);
+    REQUIRE(t.groups() == 2);
+    REQUIRE(t.get<2>(1) == "b");
+    REQUIRE(t.row(2) == std::tuple<int, double, std::string>(3, 3.5, "c"));
+    t.set<0>(2, 30);
+    REQUIRE(t.get<0>(2) == 30);
+    REQUIRE_THROWS_AS(t.get<0>(3), std::out_of_range);
+
+    std::span<const int> first = t.column<0>(0);
+    REQUIRE(first.size() == 2);
+    REQUIRE(first[1] == 2);
+    REQUIRE(t.vectorize<2>() == std::vector<std::string>{"a", "b", "c"});
+    REQUIRE_THROWS_AS(columnar_table<int>(0), std::invalid_argument);
+}
+
+TEST_CASE("Testing aggregates for columnar_table class") {
+    columnar_table<int32_t, double> t(1000);
+    std::vector<int32_t> a(10007);
+    std::vector<double> b(10007);
+    std::iota(a.begin(), a.end(), -5000);
+    for (size_t i = 0; i < b.size(); i++) {
+        b[i] = double(i % 7);
+    }
+    t.append(a, b);
+    t.push_back(2000000000, 10.0);
+    t.push_back(2000000000, -1.0);
+
+    REQUIRE(t.size() == 10009);
+    REQUIRE(t.groups() == 11);
+    // the sum of an int32 column does not overflow
+    int64_t expected = std::accumulate(a.begin(), a.end(), int64_t(0)) + 4000000000ll;
+    REQUIRE(t.sum<0>() == expected);
+    REQUIRE(t.min<0>() == -5000);
+    REQUIRE(t.max<0>() == 2000000000);
+    REQUIRE(t.min<1>() == -1.0);
+    REQUIRE(t.max<1>() == 10.0);
+    REQUIRE(t.count<1>([](double x) { return x == 0.0; }) == 1430);
+
+    std::vector<size_t> rows = t.filter<0>([](int32_t x) { return x >= 0 && x < 10; });
+    REQUIRE(rows.size() == 10);
+    REQUIRE(rows.front() == 5000);
+    REQUIRE(t.sum<0>(rows) == 45);
+    double sb = 0;
+    for (size_t r : rows) {
+        sb += b[r];
+    }
+    REQUIRE(t.sum<1>(rows) == sb);
+
+    REQUIRE_THROWS_AS(t.append(std::span<const int32_t>(a), std::span<const double>(b).first(3)),
+                      std::invalid_argument);
+    t.clear();
+    REQUIRE(t.sum<0>() == 0);
+}
@@ -99,3 +99,68 @@ TEST_CASE("Testing time of parallel vs serial for addition [1]") {
     REQUIRE(result2 == check);
     REQUIRE(result == check);
 }
+
+TEST_CASE("Testing subtraction and templated elements for parallelized matrix") {
+    std::vector<std::vector<double>> v1(300, std::vector<double>(300, 2.5)),
+        v2(300, std::vector<double>(300, 1.0));
+    std::vector<std::vector<double>> diff(300, std::vector<double>(300, 1.5)),
+        sum(300, std::vector<double>(300, 3.5));
+    REQUIRE(parallel::sub(v1, v2) == diff);
+    REQUIRE(parallel::add(v1, v2) == sum);
+    REQUIRE(parallel::add(std::vector<std::vector<double>>(), v2) == v2);
+}
+
+TEST_CASE("Testing multiplication for parallelized matrix") {
+    std::vector<std::vector<int64_t>> a = {{1, 2, 3}, {4, 5, 6}};
+    std::vector<std::vector<int64_t>> b = {{7, 8}, {9, 10}, {11, 12}};
+    std::vector<std::vector<int64_t>> check = {{58, 64}, {139, 154}};
+    REQUIRE(parallel::mul(a, b) == check);
+    REQUIRE_THROWS_AS(parallel::mul(a, a), std::invalid_argument);
+
+    std::vector<std::vector<int64_t>> c(120, std::vector<int64_t>(90)),
+        d(90, std::vector<int64_t>(70));
+    for (size_t i = 0; i < 120; i++) {
+        for (size_t j = 0; j < 90; j++) {
+            c[i][j] = int64_t(i + j) % 7 - 3;
+        }
+    }
+    for (size_t i = 0; i < 90; i++) {
+        for (size_t j = 0; j < 70; j++) {
+            d[i][j] = int64_t(i * j) % 5 - 2;
+        }
+    }
+    std::vector<std::vector<int64_t>> e = parallel::mul(c, d);
+    for (size_t i = 0; i < 120; i++) {
+        for (size_t j = 0; j < 70; j++) {
+            int64_t sum = 0;
+            for (size_t k = 0; k < 90; k++) {
+                sum += c[i][k] * d[k][j];
+            }
+            REQUIRE(e[i][j] == sum);
+        }
+    }
+}
+
+TEST_CASE("Testing transpose and reduce for parallelized matrix") {
+    std::vector<std::vector<int64_t>> v(400, std::vector<int64_t>(300));
+    int64_t expected = 0;
+    for (size_t i = 0; i < 400; i++) {
+        for (size_t j = 0; j < 300; j++) {
+            v[i][j] = int64_t(i * 300 + j);
+            expected += v[i][j];
+        }
+    }
+    std::vector<std::vector<int64_t>> t = parallel::transpose(v);
+    REQUIRE(t.size() == 300);
+    REQUIRE(t[0].size() == 400);
+    for (size_t i = 0; i < 400; i++) {
+        for (size_t j = 0; j < 300; j++) {
+            REQUIRE(t[j][i] == v[i][j]);
+        }
+    }
+    REQUIRE(parallel::reduce(v) == expected);
+    REQUIRE(parallel::reduce(v, int64_t(10)) == expected + 10);
+    auto max = [](int64_t a, int64_t b) { return std::max(a, b); };
+    REQUIRE(parallel::reduce(v, int64_t(-1), max) == int64_t(400 * 300 - 1));
+    REQUIRE(parallel::reduce(std::vector<std::vector<int64_t>>(), int64_t(5)) == 5);
+}
@@ -0,0 +1,351 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#ifdef __cplusplus
+#include "../../third_party/json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#endif
+
+namespace ALLOC {
+/**
+ * @brief the allocations counted by a counting_resource or a tracker. operations is the
+ * number of operations the caller reported with add_operations, for the averages.
+ */
+struct alloc_stats {
+    uint64_t allocations{0}, deallocations{0};
+    uint64_t bytes_allocated{0}, bytes_freed{0};
+    uint64_t peak_bytes{0};
+    uint64_t operations{0};
+
+    /**
+     * @brief live_bytes function
+     * @return int64_t: the bytes allocated and not freed yet, negative if more was freed
+     * than allocated while counting
+     */
+    int64_t live_bytes() const { return int64_t(bytes_allocated) - int64_t(bytes_freed); }
+
+    /**
+     * @brief allocations_per_op function
+     * @return double: the allocations over the operations, 0 without operations
+     */
+    double allocations_per_op() const {
+        return operations ? double(allocations) / double(operations) : 0;
+    }
+
+    /**
+     * @brief bytes_per_op function
+     * @return double: the bytes allocated over the operations, 0 without operations
+     */
+    double bytes_per_op() const {
+        return operations ? double(bytes_allocated) / double(operations) : 0;
+    }
+
+    /**
+     * @brief to_json function
+     * @return nlohmann::json: the counters and the averages, for the benchmark results
+     */
+    nlohmann::json to_json() const {
+        return nlohmann::json{{"allocations", allocations},
+                              {"deallocations", deallocations},
+                              {"bytes_allocated", bytes_allocated},
+                              {"bytes_freed", bytes_freed},
+                              {"live_bytes", live_bytes()},
+                              {"peak_bytes", peak_bytes},
+                              {"operations", operations},
+                              {"allocations_per_op", allocations_per_op()},
+                              {"bytes_per_op", bytes_per_op()}};
+    }
+};
+
+/**
+ * @brief counting resource class
+ * A std::pmr::memory_resource that forwards to an upstream resource and counts what goes
+ * through it. Any thread may allocate from it, the counters are atomic. Hand it to a pmr
+ * container, or install it with std::pmr::set_default_resource to count the nodes of every
+ * container built on node_pool.
+ */
+class counting_resource : public std::pmr::memory_resource {
+  public:
+    /**
+     * @brief Construct a new counting resource object
+     * @param upstream the resource that allocates. Default = std::pmr::get_default_resource()
+     */
+    explicit counting_resource(std::pmr::memory_resource* upstream =
+                                   std::pmr::get_default_resource()) noexcept
+        : _upstream(upstream) {}
+
+    counting_resource(const counting_resource&) = delete;
+    counting_resource& operator=(const counting_resource&) = delete;
+
+    /**
+     * @brief upstream function
+     * @return std::pmr::memory_resource*: the resource that allocates
+     */
+    std::pmr::memory_resource* upstream() const noexcept { return _upstream; }
+
+    /**
+     * @brief stats function
+     * @return alloc_stats: the counters since the construction or the last reset
+     */
+    alloc_stats stats() const noexcept {
+        alloc_stats s;
+        s.allocations = _allocations.load(std::memory_order_relaxed);
+        s.deallocations = _deallocations.load(std::memory_order_relaxed);
+        s.bytes_allocated = _allocated.load(std::memory_order_relaxed);
+        s.bytes_freed = _freed.load(std::memory_order_relaxed);
+        s.peak_bytes = _peak.load(std::memory_order_relaxed);
+        s.operations = _operations.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief add_operations function
+     * @param n the number of operations done with the memory of this resource. Default = 1
+     */
+    void add_operations(uint64_t n = 1) noexcept {
+        _operations.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief reset function
+     * Zeroes the counters, the peak starts again from the bytes that are live now.
+     */
+    void reset() noexcept {
+        const uint64_t live = _live.load(std::memory_order_relaxed);
+        _allocations = _deallocations = _allocated = _freed = _operations = 0;
+        _peak = live;
+    }
+
+  private:
+    std::pmr::memory_resource* _upstream;
+    std::atomic<uint64_t> _allocations{0}, _deallocations{0}, _allocated{0}, _freed{0};
+    std::atomic<uint64_t> _live{0}, _peak{0}, _operations{0};
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = _upstream->allocate(bytes, alignment);
+        _allocations.fetch_add(1, std::memory_order_relaxed);
+        _allocated.fetch_add(bytes, std::memory_order_relaxed);
+        const uint64_t now = _live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        for (uint64_t peak = _peak.load(std::memory_order_relaxed);
+             now > peak && !_peak.compare_exchange_weak(peak, now, std::memory_order_relaxed);) {
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        _upstream->deallocate(p, bytes, alignment);
+        _deallocations.fetch_add(1, std::memory_order_relaxed);
+        _freed.fetch_add(bytes, std::memory_order_relaxed);
+        _live.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/**
+ * @brief tracker class
+ * Counts the heap allocations of the calling thread from its construction to its
+ * destruction, whatever container makes them. The counts come from the replaced global
+ * operator new and delete of ALGOPLUS_DEFINE_ALLOCATION_HOOKS(), without them a tracker
+ * counts nothing and hooks_installed() is false. Trackers nest: an allocation is counted by
+ * every tracker alive on its thread. A tracker must be destroyed on the thread that made it,
+ * in the reverse order of construction.
+ */
+class tracker {
+  public:
+    tracker() noexcept : _parent(_current()) { _current() = this; }
+    ~tracker() { _current() = _parent; }
+
+    tracker(const tracker&) = delete;
+    tracker& operator=(const tracker&) = delete;
+
+    /**
+     * @brief stats function
+     * @return alloc_stats: the allocations of this thread since the construction or the
+     * last reset
+     */
+    alloc_stats stats() const noexcept { return _stats; }
+
+    /**
+     * @brief add_operations function
+     * @param n the number of operations done while tracking. Default = 1
+     */
+    void add_operations(uint64_t n = 1) noexcept { _stats.operations += n; }
+
+    /**
+     * @brief reset function
+     * Zeroes the counters, e.g. at the end of a warmup, so that the allocations of the
+     * steady state can be checked to be 0.
+     */
+    void reset() noexcept {
+        _stats = alloc_stats{};
+        _live = 0;
+    }
+
+    /**
+     * @brief hooks_installed function
+     * @return true if a translation unit of the program expanded
+     * ALGOPLUS_DEFINE_ALLOCATION_HOOKS()
+     */
+    static bool hooks_installed() noexcept { return _hooks(); }
+
+    // called by the hooks on every allocation and deallocation of the thread
+    static void record_allocation(size_t bytes) noexcept {
+        for (tracker* t = _current(); t != nullptr; t = t->_parent) {
+            t->_stats.allocations++;
+            t->_stats.bytes_allocated += bytes;
+            t->_live += int64_t(bytes);
+            t->_stats.peak_bytes = std::max<uint64_t>(t->_stats.peak_bytes,
+                                                      uint64_t(std::max<int64_t>(t->_live, 0)));
+        }
+    }
+
+    static void record_deallocation(size_t bytes) noexcept {
+        for (tracker* t = _current(); t != nullptr; t = t->_parent) {
+            t->_stats.deallocations++;
+            t->_stats.bytes_freed += bytes;
+            t->_live -= int64_t(bytes);
+        }
+    }
+
+    static bool& _hooks() noexcept {
+        static bool installed = false;
+        return installed;
+    }
+
+  private:
+    tracker* _parent;
+    alloc_stats _stats;
+    int64_t _live{0};
+
+    static tracker*& _current() noexcept {
+        static thread_local tracker* current = nullptr;
+        return current;
+    }
+};
+
+namespace _hooks {
+// every block carries its size in front of it, so delete knows what it frees
+constexpr size_t HEADER = alignof(std::max_align_t);
+
+inline void* allocate(size_t n) {
+    void* p = std::malloc(n + HEADER);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(p) = n;
+    tracker::record_allocation(n);
+    return static_cast<char*>(p) + HEADER;
+}
+
+inline void* allocate(size_t n, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(n);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+inline void deallocate(void* p) noexcept {
+    if (p == nullptr) {
+        return;
+    }
+    void* base = static_cast<char*>(p) - HEADER;
+    tracker::record_deallocation(*static_cast<size_t*>(base));
+    std::free(base);
+}
+
+// the over-aligned blocks keep a whole alignment in front of them for the size
+inline void* allocate(size_t n, std::align_val_t al) {
+    const size_t a = std::max(size_t(al), HEADER);
+    void* p = std::aligned_alloc(a, (n + 2 * a - 1) / a * a);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(p) = n;
+    tracker::record_allocation(n);
+    return static_cast<char*>(p) + a;
+}
+
+inline void* allocate(size_t n, std::align_val_t al, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(n, al);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+inline void deallocate(void* p, std::align_val_t al) noexcept {
+    if (p == nullptr) {
+        return;
+    }
+    void* base = static_cast<char*>(p) - std::max(size_t(al), HEADER);
+    tracker::record_deallocation(*static_cast<size_t*>(base));
+    std::free(base);
+}
+} // namespace _hooks
+} // namespace ALLOC
+
+/**
+ * @brief replaces the global operator new and delete with ones that report to the trackers
+ * of the allocating thread, the aligned and nothrow forms included. Expand it at namespace
+ * scope in exactly one translation unit of the program.
+ */
+#define ALGOPLUS_DEFINE_ALLOCATION_HOOKS()                                                     \
+    void* operator new(size_t n) { return ALLOC::_hooks::allocate(n); }                        \
+    void* operator new[](size_t n) { return ALLOC::_hooks::allocate(n); }                      \
+    void* operator new(size_t n, const std::nothrow_t& t) noexcept {                           \
+        return ALLOC::_hooks::allocate(n, t);                                                  \
+    }                                                                                          \
+    void* operator new[](size_t n, const std::nothrow_t& t) noexcept {                         \
+        return ALLOC::_hooks::allocate(n, t);                                                  \
+    }                                                                                          \
+    void operator delete(void* p) noexcept { ALLOC::_hooks::deallocate(p); }                   \
+    void operator delete[](void* p) noexcept { ALLOC::_hooks::deallocate(p); }                 \
+    void operator delete(void* p, size_t) noexcept { ALLOC::_hooks::deallocate(p); }           \
+    void operator delete[](void* p, size_t) noexcept { ALLOC::_hooks::deallocate(p); }         \
+    void operator delete(void* p, const std::nothrow_t&) noexcept {                            \
+        ALLOC::_hooks::deallocate(p);                                                          \
+    }                                                                                          \
+    void operator delete[](void* p, const std::nothrow_t&) noexcept {                          \
+        ALLOC::_hooks::deallocate(p);                                                          \
+    }                                                                                          \
+    void* operator new(size_t n, std::align_val_t a) { return ALLOC::_hooks::allocate(n, a); } \
+    void* operator new[](size_t n, std::align_val_t a) {                                       \
+        return ALLOC::_hooks::allocate(n, a);                                                  \
+    }                                                                                          \
+    void* operator new(size_t n, std::align_val_t a, const std::nothrow_t& t) noexcept {       \
+        return ALLOC::_hooks::allocate(n, a, t);                                               \
+    }                                                                                          \
+    void* operator new[](size_t n, std::align_val_t a, const std::nothrow_t& t) noexcept {     \
+        return ALLOC::_hooks::allocate(n, a, t);                                               \
+    }                                                                                          \
+    void operator delete(void* p, std::align_val_t a) noexcept {                               \
+        ALLOC::_hooks::deallocate(p, a);                                                       \
+    }                                                                                          \
+    void operator delete[](void* p, std::align_val_t a) noexcept {                             \
+        ALLOC::_hooks::deallocate(p, a);                                                       \
+    }                                                                                          \
+    void operator delete(void* p, size_t, std::align_val_t a) noexcept {                       \
+        ALLOC::_hooks::deallocate(p, a);                                                       \
+    }                                                                                          \
+    void operator delete[](void* p, size_t, std::align_val_t a) noexcept {                     \
+        ALLOC::_hooks::deallocate(p, a);                                                       \
+    }                                                                                          \
+    void operator delete(void* p, std::align_val_t a, const std::nothrow_t&) noexcept {        \
+        ALLOC::_hooks::deallocate(p, a);                                                       \
+    }                                                                                          \
+    void operator delete[](void* p, std::align_val_t a, const std::nothrow_t&) noexcept {      \
+        ALLOC::_hooks::deallocate(p, a);                                                       \
+    }                                                                                          \
+    static const bool _algoplus_allocation_hooks = (ALLOC::tracker::_hooks() = true)
+
+#endif
@@ -21,6 +21,8 @@ if __name__ == "__main__":
             ending = max(ending, exec_time[i])
 
     print(f"Highest execution time is {ending}, starting form {starting}...")
+    if 'complexity' in file:
+        print(f"Best fit: {file['coefficient']} * O({file['complexity']})")
     print("Creating the graph...")
     xx, yy = [], []
     for i in range(len(input_size)):
@@ -0,0 +1,402 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "mapped_file.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief what an archive file holds, every kind has its own sections:
+ * sorted_keys: the keys in order(avl_tree, red_black_tree, skip_list).
+ * intervals: the low ends in order, then the high ends(interval_tree).
+ * double_array: base(int32_t[]), check(int32_t[]), the tail pool and optionally a double per
+ * key id(double_array_trie, trie).
+ * heap: the array of the heap(min_heap).
+ * fenwick: the array of the partial sums(fenwick_tree).
+ */
+enum class archive_kind : uint32_t { sorted_keys = 1, intervals, double_array, heap, fenwick };
+
+/**
+ * @brief fixed size header at the start of an archive file
+ * The file is native-endian and every section starts at a multiple of 8 bytes, so the
+ * arrays of a mapped archive are read in place. Keys take one section T[count] for trivially
+ * copyable types, or two for std::string: uint64_t[count + 1] offsets and the characters.
+ */
+struct archive_header {
+    static constexpr uint32_t MAGIC = 0x52415041; // "APAR" read as little endian
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t SECTIONS = 6;
+
+    uint32_t magic{MAGIC};
+    uint32_t version{VERSION};
+    uint32_t kind{0};
+    uint32_t key_size{0};
+    uint64_t count{0};
+    uint64_t sections{0};
+    uint64_t size{0};
+    uint64_t at[SECTIONS]{};
+    uint64_t bytes[SECTIONS]{};
+};
+
+namespace _archive_utils {
+template <typename T> constexpr bool string_key = std::is_same_v<T, std::string>;
+
+/**
+ * @brief key_size stored in the header, 0 for string keys
+ */
+template <typename T> constexpr uint32_t key_size() {
+    if constexpr (string_key<T>) {
+        return 0;
+    } else {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "archives need std::string or trivially copyable keys");
+        static_assert(alignof(T) <= 8, "the sections of an archive are aligned to 8 bytes");
+        return sizeof(T);
+    }
+}
+
+inline uint64_t align(uint64_t x) { return (x + 7) & ~uint64_t(7); }
+} // namespace _archive_utils
+
+/**
+ * @brief archive_writer class
+ * Writes an archive section by section straight to the file, nothing is buffered: the header
+ * is written last, over the room left for it.
+ */
+class archive_writer {
+  public:
+    /**
+     * @brief Construct a new archive writer object
+     * @param path: the output file, overwritten.
+     * @param kind: what the archive holds.
+     * @param key_size: sizeof of the keys, 0 for strings.
+     * @param count: the number of keys.
+     * Throws std::runtime_error if the file can not be opened.
+     */
+    archive_writer(const std::string& path, archive_kind kind, uint32_t key_size, uint64_t count)
+        : _path(path), _out(path, std::ios::binary | std::ios::trunc) {
+        if (!_out) {
+            throw std::runtime_error("Can't open file " + path);
+        }
+        _h.kind = uint32_t(kind);
+        _h.key_size = key_size;
+        _h.count = count;
+        _h.size = _archive_utils::align(sizeof(archive_header));
+        _write(&_h, sizeof(_h));
+        _pad(sizeof(_h));
+    }
+
+    /**
+     * @brief add function
+     * Appends a section.
+     * @param values: the array of the section.
+     */
+    template <typename U> void add(std::span<const U> values) {
+        static_assert(std::is_trivially_copyable_v<U>, "sections hold plain arrays");
+        _begin();
+        _write(values.data(), values.size_bytes());
+        _end();
+    }
+
+    /**
+     * @brief add_keys function
+     * Appends the keys, one section for trivially copyable keys and two for strings.
+     * @param keys: the keys.
+     */
+    template <typename T> void add_keys(const std::vector<T>& keys) {
+        if constexpr (_archive_utils::string_key<T>) {
+            std::vector<uint64_t> offsets(1, 0);
+            offsets.reserve(keys.size() + 1);
+            for (const std::string& key : keys) {
+                offsets.push_back(offsets.back() + key.size());
+            }
+            add(std::span<const uint64_t>(offsets));
+            _begin();
+            for (const std::string& key : keys) {
+                _write(key.data(), key.size());
+            }
+            _end();
+        } else {
+            add(std::span<const T>(keys));
+        }
+    }
+
+    /**
+     * @brief finish function
+     * Writes the header and flushes the file.
+     * Throws std::runtime_error if the file can not be written.
+     */
+    void finish() {
+        _out.seekp(0);
+        _write(&_h, sizeof(_h));
+        if (!_out.flush()) {
+            throw std::runtime_error("Can't write file " + _path);
+        }
+    }
+
+  private:
+    std::string _path;
+    std::ofstream _out;
+    archive_header _h;
+
+    void _write(const void* data, size_t bytes) {
+        _out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    }
+
+    void _pad(uint64_t written) {
+        static const char zeros[8] = {};
+        _write(zeros, _archive_utils::align(written) - written);
+    }
+
+    void _begin() {
+        if (_h.sections == archive_header::SECTIONS) {
+            throw std::logic_error("archive_writer: too many sections");
+        }
+        _h.at[_h.sections] = _h.size;
+    }
+
+    void _end() {
+        const uint64_t end = uint64_t(_out.tellp());
+        _h.bytes[_h.sections++] = end - _h.size;
+        _pad(end);
+        _h.size = _archive_utils::align(end);
+    }
+};
+
+/**
+ * @brief archive_view class
+ * Maps an archive file and reads its sections in place, nothing is parsed or copied. The
+ * header and the bounds of the sections are validated on construction.
+ */
+class archive_view {
+  public:
+    /**
+     * @brief Construct a new archive view object
+     * @param path: the archive file.
+     * @param kind: the kind the archive must have.
+     * @param key_size: the key size the archive must have, 0 for strings.
+     * Throws std::runtime_error if the file can not be read, is not an archive of this kind
+     * and key type, has a different version or is truncated.
+     */
+    archive_view(const std::string& path, archive_kind kind, uint32_t key_size)
+        : _file(std::make_unique<mapped_file>(path, file_access::random)) {
+        std::string_view data = _file->view();
+        if (data.size() < sizeof(archive_header)) {
+            throw std::runtime_error("Archive " + path + " is truncated");
+        }
+        std::memcpy(&_h, data.data(), sizeof(_h));
+        if (_h.magic != archive_header::MAGIC) {
+            throw std::runtime_error(path + " is not an archive");
+        }
+        if (_h.version != archive_header::VERSION) {
+            throw std::runtime_error("Archive " + path + " has unsupported version " +
+                                     std::to_string(_h.version));
+        }
+        if (_h.kind != uint32_t(kind) || _h.key_size != key_size) {
+            throw std::runtime_error("Archive " + path + " was written for another type");
+        }
+        if (_h.size != data.size()) {
+            throw std::runtime_error("Archive " + path + " is truncated");
+        }
+        if (_h.sections > archive_header::SECTIONS) {
+            throw std::runtime_error("Archive " + path + " is corrupted");
+        }
+        for (size_t i = 0; i < _h.sections; i++) {
+            if (_h.at[i] % 8 != 0 || _h.at[i] > _h.size || _h.bytes[i] > _h.size - _h.at[i]) {
+                throw std::runtime_error("Archive " + path + " is corrupted");
+            }
+        }
+        _base = data.data();
+    }
+
+    /**
+     * @brief count function
+     * @returns size_t the number of keys.
+     */
+    size_t count() const { return _h.count; }
+
+    /**
+     * @brief sections function
+     * @returns size_t the number of sections.
+     */
+    size_t sections() const { return _h.sections; }
+
+    /**
+     * @brief section function
+     * @param i: the index of the section, sections() or more gives an empty span.
+     * @returns span the array of the section.
+     */
+    template <typename U> std::span<const U> section(size_t i) const {
+        if (i >= _h.sections) {
+            return {};
+        }
+        return {reinterpret_cast<const U*>(_base + _h.at[i]), _h.bytes[i] / sizeof(U)};
+    }
+
+    /**
+     * @brief key function
+     * @param first: the section of the keys.
+     * @param i: the index of the key.
+     * @returns the key, a std::string_view into the mapping for strings.
+     */
+    template <typename T> auto key(size_t first, size_t i) const {
+        if constexpr (_archive_utils::string_key<T>) {
+            const uint64_t* o = section<uint64_t>(first).data();
+            return std::string_view(_base + _h.at[first + 1] + o[i], o[i + 1] - o[i]);
+        } else {
+            return section<T>(first)[i];
+        }
+    }
+
+    /**
+     * @brief check_keys function
+     * Checks that count() keys fit their sections, in O(1) for trivially copyable keys and
+     * with one pass over the offsets for strings.
+     * @param first: the section of the keys.
+     * Throws std::runtime_error if they do not.
+     */
+    template <typename T> void check_keys(size_t first) const {
+        bool fits;
+        if constexpr (_archive_utils::string_key<T>) {
+            std::span<const uint64_t> o = section<uint64_t>(first);
+            fits = o.size() == count() + 1 && std::is_sorted(o.begin(), o.end()) &&
+                   o.back() <= section<char>(first + 1).size();
+        } else {
+            fits = section<T>(first).size() == count();
+        }
+        if (!fits) {
+            throw std::runtime_error("Archive keys are corrupted");
+        }
+    }
+
+    /**
+     * @brief keys function
+     * @param first: the section of the keys, see check_keys.
+     * @returns vector<T> a copy of the keys, read in bulk.
+     */
+    template <typename T> std::vector<T> keys(size_t first) const {
+        check_keys<T>(first);
+        std::vector<T> keys;
+        if constexpr (_archive_utils::string_key<T>) {
+            keys.reserve(count());
+            for (size_t i = 0; i < count(); i++) {
+                keys.emplace_back(key<T>(first, i));
+            }
+        } else {
+            std::span<const T> s = section<T>(first);
+            keys.assign(s.begin(), s.end());
+        }
+        return keys;
+    }
+
+  private:
+    std::unique_ptr<mapped_file> _file;
+    archive_header _h;
+    const char* _base{nullptr};
+};
+
+/**
+ * @brief sorted_archive class
+ * Read-only queries on a sorted_keys archive in place: binary searches over the mapped array,
+ * nothing is loaded, so opening an archive of trivially copyable keys costs the same for any
+ * size and only the pages a search touches are read from the file.
+ * @tparam T the type of the keys, std::string or trivially copyable and ordered by <.
+ */
+template <typename T> class sorted_archive {
+  public:
+    using key_type = std::conditional_t<_archive_utils::string_key<T>, std::string_view, T>;
+
+    /**
+     * @brief Construct a new sorted archive object
+     * @param path: a file written by save_sorted_archive or by the save_archive of an ordered
+     * container.
+     * Throws std::runtime_error like archive_view.
+     */
+    explicit sorted_archive(const std::string& path)
+        : _archive(path, archive_kind::sorted_keys, _archive_utils::key_size<T>()) {
+        _archive.check_keys<T>(0);
+    }
+
+    /**
+     * @brief size function
+     * @returns size_t the number of keys.
+     */
+    size_t size() const { return _archive.count(); }
+
+    /**
+     * @brief empty function
+     * @returns true if the archive holds no key.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief operator []
+     * @param i: the rank of the key.
+     * @returns key_type the i-th smallest key.
+     */
+    key_type operator[](size_t i) const { return _archive.key<T>(0, i); }
+
+    /**
+     * @brief lower_bound function
+     * @param key: the key to search.
+     * @returns size_t the rank of the first key not smaller than key, size() if there is none.
+     */
+    size_t lower_bound(const key_type& key) const {
+        size_t lo = 0, hi = size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if ((*this)[mid] < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    /**
+     * @brief contains function
+     * @param key: the key to search.
+     * @returns true if the archive holds key.
+     */
+    bool contains(const key_type& key) const {
+        size_t i = lower_bound(key);
+        return i < size() && !(key < (*this)[i]);
+    }
+
+    /**
+     * @brief keys function
+     * @returns vector<T> a copy of the keys in order.
+     */
+    std::vector<T> keys() const { return _archive.keys<T>(0); }
+
+  private:
+    archive_view _archive;
+};
+
+/**
+ * @brief save_sorted_archive function
+ * @param keys: the keys in order.
+ * @param path: the output file, overwritten.
+ * Throws std::runtime_error if the file can not be written.
+ */
+template <typename T>
+void save_sorted_archive(const std::vector<T>& keys, const std::string& path) {
+    archive_writer out(path, archive_kind::sorted_keys, _archive_utils::key_size<T>(), keys.size());
+    out.add_keys(keys);
+    out.finish();
+}
+
+#endif
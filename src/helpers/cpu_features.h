@@ -0,0 +1,262 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#ifdef __cplusplus
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#endif
+
+// the x86 kernels are compiled for their instruction set with target attributes, whatever the
+// flags of the build, and only called once the cpu is known to run them
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ALGOPLUS_X86_DISPATCH 1
+#define ALGOPLUS_TARGET(isa) __attribute__((target(isa)))
+#ifdef __cplusplus
+#include <immintrin.h>
+#endif
+#else
+#define ALGOPLUS_TARGET(isa)
+#endif
+
+namespace SIMD {
+/**
+ * @brief the instruction sets the kernels are written for, sse2 < avx2 < avx512 on x86.
+ * avx512 stands for AVX-512 F and BW together.
+ */
+enum class isa : int { scalar, sse2, avx2, avx512, neon };
+
+/**
+ * @brief the features of the cpu the kernels look at
+ */
+struct cpu_features {
+    bool sse2{false};
+    bool sse42{false};
+    bool avx2{false};
+    bool fma{false};
+    bool avx512f{false};
+    bool avx512bw{false};
+    bool neon{false};
+};
+
+/**
+ * @brief features function
+ * @return const cpu_features&: the features of the cpu, detected once on first use. On x86
+ * cpuid is read through __builtin_cpu_supports, which also checks that the os saves the wide
+ * registers, NEON is part of every AArch64 cpu.
+ */
+inline const cpu_features& features() {
+    static const cpu_features f = []() {
+        cpu_features c;
+#if defined(ALGOPLUS_X86_DISPATCH)
+        __builtin_cpu_init();
+        c.sse2 = __builtin_cpu_supports("sse2");
+        c.sse42 = __builtin_cpu_supports("sse4.2");
+        c.avx2 = __builtin_cpu_supports("avx2");
+        c.fma = __builtin_cpu_supports("fma");
+        c.avx512f = __builtin_cpu_supports("avx512f");
+        c.avx512bw = __builtin_cpu_supports("avx512bw");
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+        c.neon = true;
+#endif
+        return c;
+    }();
+    return f;
+}
+
+/**
+ * @brief supported function
+ * @param i an instruction set
+ * @return true if the cpu runs the kernels written for i, scalar always
+ */
+inline bool supported(isa i) {
+    const cpu_features& f = features();
+    switch (i) {
+    case isa::scalar:
+        return true;
+    case isa::sse2:
+        return f.sse2;
+    case isa::avx2:
+        return f.avx2;
+    case isa::avx512:
+        return f.avx512f && f.avx512bw;
+    case isa::neon:
+        return f.neon;
+    }
+    return false;
+}
+
+/**
+ * @brief best function
+ * @return isa: the widest instruction set the cpu supports
+ */
+inline isa best() {
+    for (isa i : {isa::avx512, isa::avx2, isa::sse2, isa::neon}) {
+        if (supported(i)) {
+            return i;
+        }
+    }
+    return isa::scalar;
+}
+
+/**
+ * @brief name function
+ * @param i an instruction set
+ * @return const char*: its name, as ALGOPLUS_ISA spells it
+ */
+inline const char* name(isa i) {
+    switch (i) {
+    case isa::scalar:
+        return "scalar";
+    case isa::sse2:
+        return "sse2";
+    case isa::avx2:
+        return "avx2";
+    case isa::avx512:
+        return "avx512";
+    case isa::neon:
+        return "neon";
+    }
+    return "scalar";
+}
+
+/**
+ * @brief parse function
+ * @param s the name of an instruction set
+ * @return isa: the instruction set it names
+ * Throws std::invalid_argument for an unknown name.
+ */
+inline isa parse(std::string_view s) {
+    for (isa i : {isa::scalar, isa::sse2, isa::avx2, isa::avx512, isa::neon}) {
+        if (s == name(i)) {
+            return i;
+        }
+    }
+    throw std::invalid_argument("SIMD::parse: unknown instruction set " + std::string(s));
+}
+
+namespace _simd_utils {
+// the instruction set the kernels are selected for, -1 until the first call to active()
+inline std::atomic<int>& selected() {
+    static std::atomic<int> s{-1};
+    return s;
+}
+
+// best(), or the instruction set named by ALGOPLUS_ISA when the cpu supports it
+inline isa from_env() {
+    const char* env = std::getenv("ALGOPLUS_ISA");
+    if (env != nullptr) {
+        try {
+            isa i = parse(env);
+            if (supported(i)) {
+                return i;
+            }
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    return best();
+}
+} // namespace _simd_utils
+
+/**
+ * @brief active function
+ * @return isa: the instruction set the kernels are selected for: best(), unless
+ * ALGOPLUS_ISA names one the cpu supports or force() was called
+ */
+inline isa active() {
+    int s = _simd_utils::selected().load(std::memory_order_relaxed);
+    if (s < 0) {
+        s = int(_simd_utils::from_env());
+        int expected = -1;
+        if (!_simd_utils::selected().compare_exchange_strong(expected, s)) {
+            s = expected;
+        }
+    }
+    return isa(s);
+}
+
+/**
+ * @brief force function
+ * Selects the kernels of i from the next call on, e.g. to test the scalar fallback on a cpu
+ * with AVX2.
+ * @param i the instruction set
+ * Throws std::invalid_argument if the cpu does not support i.
+ */
+inline void force(isa i) {
+    if (!supported(i)) {
+        throw std::invalid_argument(std::string("SIMD::force: the cpu does not support ") +
+                                    name(i));
+    }
+    _simd_utils::selected().store(int(i), std::memory_order_relaxed);
+}
+
+/**
+ * @brief reset function
+ * Goes back to the instruction set of ALGOPLUS_ISA, or to best(), after force().
+ */
+inline void reset() { _simd_utils::selected().store(int(_simd_utils::from_env())); }
+
+/**
+ * @brief scoped isa class
+ * Forces an instruction set for the lifetime of the object and selects the previous one back
+ * when it is destroyed, for the tests that run a kernel on every instruction set.
+ */
+class scoped_isa {
+  public:
+    explicit scoped_isa(isa i) : _previous(active()) { force(i); }
+    ~scoped_isa() { _simd_utils::selected().store(int(_previous)); }
+    scoped_isa(const scoped_isa&) = delete;
+    scoped_isa& operator=(const scoped_isa&) = delete;
+
+  private:
+    isa _previous;
+};
+
+/**
+ * @brief kernels class
+ * The versions of one kernel, one per instruction set it is written for, scalar always. get()
+ * returns the widest version the active instruction set runs, so a kernel written for avx2
+ * only is also picked on a cpu with avx512, and the scalar one is the fallback of every
+ * instruction set. Built once, e.g.
+ * static const SIMD::kernels<size_t(const char*, size_t)> k{.scalar = &f, .avx2 = &f_avx2};
+ * @tparam Fn the function type of the kernel
+ */
+template <typename Fn> struct kernels {
+    Fn* scalar;
+    Fn* sse2{nullptr};
+    Fn* avx2{nullptr};
+    Fn* avx512{nullptr};
+    Fn* neon{nullptr};
+
+    /**
+     * @brief get function
+     * @param i the instruction set to select for. Default = active()
+     * @return Fn*: the widest version written for i or for a narrower instruction set
+     */
+    Fn* get(isa i = active()) const {
+        switch (i) {
+        case isa::avx512:
+            if (avx512 != nullptr) {
+                return avx512;
+            }
+            [[fallthrough]];
+        case isa::avx2:
+            if (avx2 != nullptr) {
+                return avx2;
+            }
+            [[fallthrough]];
+        case isa::sse2:
+            return sse2 != nullptr ? sse2 : scalar;
+        case isa::neon:
+            return neon != nullptr ? neon : scalar;
+        case isa::scalar:
+            break;
+        }
+        return scalar;
+    }
+};
+} // namespace SIMD
+
+#endif
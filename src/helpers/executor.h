@@ -0,0 +1,508 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace PARALLEL {
+/**
+ * @brief number of worker threads to use when the caller passes 0
+ * @return size_t std::thread::hardware_concurrency() or 1 if it is unknown
+ */
+inline size_t hardware_threads() {
+    size_t n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+/**
+ * @brief work stealing deque class
+ * The Chase-Lev deque of a worker: its owner pushes and pops pointers at the bottom without
+ * locks, and the other threads steal from the top with a compare-and-swap on the index of the
+ * top. The ring doubles when it is full, the old rings are kept until the deque is destroyed
+ * because a thief may still read from one.
+ */
+template <typename T> class work_stealing_deque {
+    static_assert(std::is_pointer_v<T>, "work_stealing_deque holds pointers");
+
+  public:
+    /**
+     * @brief Construct a new work stealing deque object
+     * @param capacity the slots of the first ring, rounded up to a power of two
+     */
+    explicit work_stealing_deque(size_t capacity = 64) {
+        size_t c = 1;
+        while (c < capacity) {
+            c *= 2;
+        }
+        _rings.push_back(std::make_unique<_ring>(c));
+        _array.store(_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    /**
+     * @brief push function, only for the owner
+     * @param x the pointer to push at the bottom
+     */
+    void push(T x) {
+        const int64_t b = _bottom.load(std::memory_order_relaxed);
+        const int64_t t = _top.load(std::memory_order_acquire);
+        _ring* a = _array.load(std::memory_order_relaxed);
+        if (b - t > int64_t(a->mask)) {
+            a = _grow(a, t, b);
+        }
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief pop function, only for the owner
+     * @return T the pointer pushed last, nullptr if the deque is empty
+     */
+    T pop() {
+        const int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        _ring* a = _array.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        if (t > b) {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T x = a->get(b);
+        if (t == b) {
+            // the last element, a thief may be taking it too
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                x = nullptr;
+            }
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    /**
+     * @brief steal function, for any thread
+     * @return T the oldest pointer, nullptr if the deque is empty or another thread took it
+     * first
+     */
+    T steal() {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        T x = _array.load(std::memory_order_acquire)->get(t);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return x;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of pointers, stale while other threads push or steal
+     */
+    size_t size() const {
+        const int64_t b = _bottom.load(std::memory_order_relaxed);
+        const int64_t t = _top.load(std::memory_order_relaxed);
+        return b > t ? size_t(b - t) : 0;
+    }
+
+    /**
+     * @brief empty function
+     * @return true if the deque looks empty
+     */
+    bool empty() const { return size() == 0; }
+
+  private:
+    struct _ring {
+        explicit _ring(size_t capacity)
+            : mask(capacity - 1), slots(std::make_unique<std::atomic<T>[]>(capacity)) {}
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        T get(int64_t i) const { return slots[size_t(i) & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T x) { slots[size_t(i) & mask].store(x, std::memory_order_relaxed); }
+    };
+
+    // the indexes on their own cache lines, the owner writes the bottom and the thieves the top
+    alignas(64) std::atomic<int64_t> _top{0};
+    alignas(64) std::atomic<int64_t> _bottom{0};
+    alignas(64) std::atomic<_ring*> _array;
+    std::vector<std::unique_ptr<_ring>> _rings;
+
+    _ring* _grow(_ring* a, int64_t t, int64_t b) {
+        _rings.push_back(std::make_unique<_ring>(2 * (a->mask + 1)));
+        _ring* bigger = _rings.back().get();
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, a->get(i));
+        }
+        _array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+};
+
+/**
+ * @brief the settings of the shared executor
+ * @param threads the threads that run a parallel_for, the workers and the caller. 0 reads the
+ * environment variable ALGOPLUS_THREADS, and takes every hardware thread without it
+ * @param pin pins worker i to the cpu i + 1(modulo the hardware threads), the caller is
+ * left where it is
+ */
+struct executor_options {
+    size_t threads{0};
+    bool pin{false};
+};
+
+/**
+ * @brief executor class
+ * The work stealing pool the parallel algorithms of the library run on, so that they share
+ * one set of threads instead of each starting its own. Every worker owns a Chase-Lev deque:
+ * it pushes and pops the tasks it makes at the bottom, and when it runs dry it takes the tasks
+ * submitted from outside the pool, then steals from the top of the deques of the others. A
+ * parallel_for is a task over its chunks that splits in halves, the stolen halves keep
+ * splitting, so the chunks spread over the idle workers in O(log chunks) steals. The caller of
+ * a parallel_for runs chunks and steals other tasks while it waits, so nested parallel_for
+ * calls cannot deadlock the pool and a pool without workers runs everything on the caller.
+ */
+class executor {
+  public:
+    /**
+     * @brief Construct a new executor object
+     * @param workers the number of worker threads. Default = every hardware thread but the
+     * one of the caller
+     * @param pin pins the workers to cpus(see executor_options)
+     */
+    explicit executor(size_t workers = hardware_threads() - 1, bool pin = false) {
+        _workers.reserve(workers);
+        for (size_t i = 0; i < workers; i++) {
+            _workers.push_back(std::make_unique<_worker>());
+        }
+        for (size_t i = 0; i < workers; i++) {
+            _workers[i]->thread = std::thread([this, i, pin]() {
+                if (pin) {
+                    _pin(i + 1);
+                }
+                _work(i);
+            });
+        }
+    }
+
+    executor(const executor&) = delete;
+    executor& operator=(const executor&) = delete;
+
+    /**
+     * @brief Destroy the executor object, after the parallel_for calls running on it
+     */
+    ~executor() {
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& w : _workers) {
+            w->thread.join();
+        }
+    }
+
+    /**
+     * @brief configure function
+     * Sets the threads and the pinning of shared(), before its first use. Throws
+     * std::logic_error once the shared executor runs.
+     * @param opt the settings
+     */
+    static void configure(const executor_options& opt) {
+        std::lock_guard<std::mutex> lock(_settings().mutex);
+        if (_settings().started) {
+            throw std::logic_error("executor: the shared executor is already running");
+        }
+        _settings().options = opt;
+    }
+
+    /**
+     * @brief shared function
+     * @return executor& the executor of the process, started on first use with the settings of
+     * configure()
+     */
+    static executor& shared() {
+        static executor pool = []() {
+            std::lock_guard<std::mutex> lock(_settings().mutex);
+            _settings().started = true;
+            const executor_options opt = _settings().options;
+            size_t threads = opt.threads;
+            if (threads == 0) {
+                const char* env = std::getenv("ALGOPLUS_THREADS");
+                threads = env ? size_t(std::strtoull(env, nullptr, 10)) : 0;
+            }
+            threads = threads == 0 ? hardware_threads() : threads;
+            return executor(threads - 1, opt.pin);
+        }();
+        return pool;
+    }
+
+    /**
+     * @brief concurrency function
+     * @return size_t the number of threads that run a parallel_for, the workers and the
+     * caller.
+     */
+    size_t concurrency() const { return _workers.size() + 1; }
+
+    /**
+     * @brief splits [begin, end) in contiguous chunks and runs them on the executor
+     * @param begin first index
+     * @param end one past the last index
+     * @param chunks the number of chunks(0 means concurrency()), no more than end - begin
+     * @param f callable invoked as f(lo, hi, chunk) once per chunk, chunk is in [0, chunks)
+     * Returns once every chunk is done. The first exception thrown by f is rethrown on the
+     * caller, after the other chunks have finished.
+     */
+    template <typename F> void parallel_for(size_t begin, size_t end, size_t chunks, F&& f) {
+        if (begin >= end) {
+            return;
+        }
+        size_t n = end - begin;
+        chunks = std::max<size_t>(1, std::min(chunks == 0 ? concurrency() : chunks, n));
+        if (chunks == 1) {
+            f(begin, end, size_t(0));
+            return;
+        }
+        const size_t step = (n + chunks - 1) / chunks;
+        chunks = (n + step - 1) / step;
+        auto chunk = [&](size_t c) {
+            const size_t lo = begin + c * step;
+            f(lo, std::min(end, lo + step), c);
+        };
+        _job job(this, chunks, &chunk, [](void* g, size_t c) {
+            (*static_cast<decltype(chunk)*>(g))(c);
+        });
+        job.ranges[0].c1 = chunks;
+        _run_range(&job.ranges[0]);
+        _wait(job);
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+  private:
+    struct _task {
+        void (*run)(_task*);
+    };
+
+    struct _job;
+
+    // the chunks [c0, c1) of a job, the range that starts at chunk c lives in ranges[c]
+    struct _range : _task {
+        _job* job{nullptr};
+        size_t c0{0}, c1{0};
+    };
+
+    struct _job {
+        _job(executor* pool, size_t chunks, void* f, void (*chunk)(void*, size_t))
+            : pool(pool), ranges(chunks), f(f), chunk(chunk), left(chunks) {
+            for (size_t c = 0; c < chunks; c++) {
+                ranges[c].run = &executor::_run_range;
+                ranges[c].job = this;
+                ranges[c].c0 = c;
+            }
+        }
+
+        executor* pool;
+        std::vector<_range> ranges;
+        void* f;
+        void (*chunk)(void*, size_t);
+        std::atomic<size_t> left;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done{false};
+    };
+
+    struct _worker {
+        work_stealing_deque<_task*> deque;
+        std::thread thread;
+    };
+
+    struct _shared_settings {
+        std::mutex mutex;
+        executor_options options;
+        bool started{false};
+    };
+
+    // the executor and the index of the worker that runs on this thread, if any
+    struct _current {
+        const executor* pool{nullptr};
+        size_t index{0};
+    };
+
+    std::vector<std::unique_ptr<_worker>> _workers;
+    // the tasks of the threads that are not workers
+    std::deque<_task*> _injected;
+    std::mutex _inject_mutex;
+    std::atomic<size_t> _injected_count{0};
+    // bumped on every push, a worker sleeps only if it did not change since it last looked
+    std::atomic<uint64_t> _epoch{0};
+    std::atomic<size_t> _sleepers{0};
+    std::mutex _sleep_mutex;
+    std::condition_variable _wake;
+    bool _stop{false};
+
+    static _shared_settings& _settings() {
+        static _shared_settings s;
+        return s;
+    }
+
+    static _current& _here() {
+        static thread_local _current c;
+        return c;
+    }
+
+    static void _pin([[maybe_unused]] size_t cpu) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu % hardware_threads(), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+
+    static void _run_range(_task* t) {
+        _range* r = static_cast<_range*>(t);
+        _job* job = r->job;
+        // keep the lower half, hand the upper half to the thieves
+        while (r->c1 - r->c0 > 1) {
+            const size_t mid = r->c0 + (r->c1 - r->c0) / 2;
+            job->ranges[mid].c1 = r->c1;
+            r->c1 = mid;
+            job->pool->_push(&job->ranges[mid]);
+        }
+        try {
+            job->chunk(job->f, r->c0);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (!job->error) {
+                job->error = std::current_exception();
+            }
+        }
+        if (job->left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->done = true;
+            job->finished.notify_all();
+        }
+    }
+
+    void _push(_task* t) {
+        _current& here = _here();
+        if (here.pool == this) {
+            _workers[here.index]->deque.push(t);
+        } else {
+            std::lock_guard<std::mutex> lock(_inject_mutex);
+            _injected.push_back(t);
+            _injected_count.fetch_add(1, std::memory_order_release);
+        }
+        _epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (_sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _wake.notify_one();
+        }
+    }
+
+    _task* _find() {
+        _current& here = _here();
+        const bool worker = here.pool == this;
+        if (worker) {
+            if (_task* t = _workers[here.index]->deque.pop()) {
+                return t;
+            }
+        }
+        if (_injected_count.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(_inject_mutex);
+            if (!_injected.empty()) {
+                _task* t = _injected.front();
+                _injected.pop_front();
+                _injected_count.fetch_sub(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        const size_t n = _workers.size();
+        const size_t first = worker ? here.index + 1 : 0;
+        for (size_t k = 0; k < n; k++) {
+            const size_t v = (first + k) % n;
+            if (worker && v == here.index) {
+                continue;
+            }
+            if (_task* t = _workers[v]->deque.steal()) {
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    void _wait(_job& job) {
+        size_t idle = 0;
+        while (job.left.load(std::memory_order_acquire) > 0) {
+            if (_task* t = _find()) {
+                t->run(t);
+                idle = 0;
+            } else if (++idle < 64) {
+                std::this_thread::yield();
+            } else {
+                // the chunks left run elsewhere, look for new tasks now and then
+                std::unique_lock<std::mutex> lock(job.mutex);
+                job.finished.wait_for(lock, std::chrono::microseconds(200),
+                                      [&]() { return job.done; });
+            }
+        }
+        // the last chunk signals under the lock, the job must outlive it
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.finished.wait(lock, [&]() { return job.done; });
+    }
+
+    void _work(size_t index) {
+        _here() = {this, index};
+        while (true) {
+            const uint64_t seen = _epoch.load(std::memory_order_seq_cst);
+            if (_task* t = _find()) {
+                t->run(t);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            if (_stop) {
+                return;
+            }
+            _sleepers.fetch_add(1, std::memory_order_seq_cst);
+            _wake.wait(lock, [&]() {
+                return _stop || _epoch.load(std::memory_order_seq_cst) != seen;
+            });
+            _sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+};
+} // namespace PARALLEL
+
+#endif
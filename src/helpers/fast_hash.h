@@ -0,0 +1,350 @@
+#ifndef FAST_HASH_H
+#define FAST_HASH_H
+
+#include "cpu_features.h"
+
+#ifdef __cplusplus
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#endif
+
+namespace HASHING {
+constexpr uint64_t GOLDEN = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * @brief mix function
+ * The finalizer of MurmurHash3 with the constants of splitmix64: every bit of x flips about
+ * half the bits of the result, and it is a bijection, so distinct integers never collide.
+ * std::hash is the identity for integers, whose low bits pick a bucket: sequential or
+ * strided ids all land in a few buckets or groups without it.
+ * @param x the value to mix
+ * @return uint64_t the mixed value
+ */
+constexpr uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief seeded mix function
+ * @param x the value to mix
+ * @param seed picks one of 2^64 bijections
+ * @return uint64_t mix(x ^ seed), mix(x) for the seed 0
+ */
+constexpr uint64_t mix(uint64_t x, uint64_t seed) { return mix(x ^ seed); }
+
+/**
+ * @brief combine function
+ * @param h the hash of the first fields of a value
+ * @param v the hash of the next field
+ * @return uint64_t a hash of both, that depends on their order
+ */
+constexpr uint64_t combine(uint64_t h, uint64_t v) { return mix(h * GOLDEN + v); }
+
+namespace _fast_hash_utils {
+// the secret of wyhash
+constexpr uint64_t P0 = 0xa0761d6478bd642fULL, P1 = 0xe7037ed1a0b428dbULL;
+constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ULL, P3 = 0x589965cc75374cc3ULL;
+
+// the two halves of the 128 bit product of a and b, xored
+constexpr uint64_t mum(uint64_t a, uint64_t b) {
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return uint64_t(r) ^ uint64_t(r >> 64);
+}
+
+// little endian reads, byte by byte where memcpy can not be used: in constant expressions,
+// so that a table hashed at compile time finds its keys at run time
+template <typename Byte> constexpr uint64_t read(const Byte* p, size_t bytes) {
+    if (std::is_constant_evaluated() || std::endian::native != std::endian::little) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            v |= uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return v;
+    }
+    uint64_t v = 0;
+    std::memcpy(&v, p, bytes);
+    return v;
+}
+
+template <typename Byte> constexpr uint64_t read64(const Byte* p) { return read(p, 8); }
+
+template <typename Byte> constexpr uint64_t read32(const Byte* p) { return read(p, 4); }
+
+template <typename Byte> constexpr uint64_t byte(const Byte* p, size_t i) {
+    return static_cast<unsigned char>(p[i]);
+}
+
+// lo(a) lo(c) + (hi(a) lo(c) + lo(a) hi(c)) 2^32, the 64 bit product of AVX2 and AVX-512F
+// which only multiply 32 bit halves
+#if defined(ALGOPLUS_X86_DISPATCH)
+ALGOPLUS_TARGET("avx2") inline __m256i mul64_avx2(__m256i a, __m256i c) {
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), c),
+                                           _mm256_mul_epu32(a, _mm256_srli_epi64(c, 32)));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, c), _mm256_slli_epi64(cross, 32));
+}
+
+ALGOPLUS_TARGET("avx2") inline __m256i mix_avx2(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 30));
+    x = mul64_avx2(x, _mm256_set1_epi64x(int64_t(0xBF58476D1CE4E5B9ULL)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 27));
+    x = mul64_avx2(x, _mm256_set1_epi64x(int64_t(0x94D049BB133111EBULL)));
+    return _mm256_xor_si256(x, _mm256_srli_epi64(x, 31));
+}
+
+// the masked forms with every lane set, the plain ones start from an undefined register that
+// gcc 12 reports as uninitialized
+ALGOPLUS_TARGET("avx512f,avx512bw") inline __m512i mul64_avx512(__m512i a, __m512i c) {
+    const __mmask8 all = 0xFF;
+    const __m512i cross =
+        _mm512_add_epi64(_mm512_maskz_mul_epu32(all, _mm512_maskz_srli_epi64(all, a, 32), c),
+                         _mm512_maskz_mul_epu32(all, a, _mm512_maskz_srli_epi64(all, c, 32)));
+    return _mm512_add_epi64(_mm512_maskz_mul_epu32(all, a, c),
+                            _mm512_maskz_slli_epi64(all, cross, 32));
+}
+
+ALGOPLUS_TARGET("avx512f,avx512bw") inline __m512i mix_avx512(__m512i x) {
+    const __mmask8 all = 0xFF;
+    x = _mm512_xor_si512(x, _mm512_maskz_srli_epi64(all, x, 30));
+    x = mul64_avx512(x, _mm512_set1_epi64(int64_t(0xBF58476D1CE4E5B9ULL)));
+    x = _mm512_xor_si512(x, _mm512_maskz_srli_epi64(all, x, 27));
+    x = mul64_avx512(x, _mm512_set1_epi64(int64_t(0x94D049BB133111EBULL)));
+    return _mm512_xor_si512(x, _mm512_maskz_srli_epi64(all, x, 31));
+}
+#endif
+
+inline void mix_batch_scalar(const uint64_t* keys, uint64_t* out, size_t n, uint64_t seed) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = mix(keys[i], seed);
+    }
+}
+
+#if defined(ALGOPLUS_X86_DISPATCH)
+ALGOPLUS_TARGET("avx2")
+inline void mix_batch_avx2(const uint64_t* keys, uint64_t* out, size_t n, uint64_t seed) {
+    const __m256i s = _mm256_set1_epi64x(int64_t(seed));
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        x = mix_avx2(_mm256_xor_si256(x, s));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+    }
+    mix_batch_scalar(keys + i, out + i, n - i, seed);
+}
+
+ALGOPLUS_TARGET("avx512f,avx512bw")
+inline void mix_batch_avx512(const uint64_t* keys, uint64_t* out, size_t n, uint64_t seed) {
+    const __m512i s = _mm512_set1_epi64(int64_t(seed));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512(keys + i);
+        _mm512_storeu_si512(out + i, mix_avx512(_mm512_xor_si512(x, s)));
+    }
+    mix_batch_scalar(keys + i, out + i, n - i, seed);
+}
+#endif
+
+inline const SIMD::kernels<void(const uint64_t*, uint64_t*, size_t, uint64_t)>& mix_batches() {
+    static const SIMD::kernels<void(const uint64_t*, uint64_t*, size_t, uint64_t)> k{
+        .scalar = &mix_batch_scalar,
+#if defined(ALGOPLUS_X86_DISPATCH)
+        .avx2 = &mix_batch_avx2,
+        .avx512 = &mix_batch_avx512,
+#endif
+    };
+    return k;
+}
+
+// the body of hash_bytes, for unsigned char and char bytes
+template <typename Byte> constexpr uint64_t wyhash(const Byte* p, size_t bytes, uint64_t seed) {
+    seed ^= mum(seed ^ P0, P1);
+    uint64_t a, b;
+    if (bytes <= 16) {
+        if (bytes >= 4) {
+            const size_t half = (bytes >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + half);
+            b = (read32(p + bytes - 4) << 32) | read32(p + bytes - 4 - half);
+        } else if (bytes > 0) {
+            a = (byte(p, 0) << 16) | (byte(p, bytes >> 1) << 8) | byte(p, bytes - 1);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = bytes;
+        if (i > 48) {
+            uint64_t s1 = seed, s2 = seed;
+            do {
+                seed = mum(read64(p) ^ P1, read64(p + 8) ^ seed);
+                s1 = mum(read64(p + 16) ^ P2, read64(p + 24) ^ s1);
+                s2 = mum(read64(p + 32) ^ P3, read64(p + 40) ^ s2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= s1 ^ s2;
+        }
+        while (i > 16) {
+            seed = mum(read64(p) ^ P1, read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // the last 16 bytes, overlapping the ones already hashed
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    const unsigned __int128 r = (unsigned __int128)(a ^ P1) * (b ^ seed);
+    return mum(uint64_t(r) ^ P0 ^ bytes, uint64_t(r >> 64) ^ P1);
+}
+} // namespace _fast_hash_utils
+
+/**
+ * @brief hash bytes function
+ * The algorithm of wyhash: 16 bytes per 64 x 64 -> 128 bit multiplication, 48 bytes at a time
+ * in three independent chains for long inputs, and reads of 4 or 8 bytes that overlap for
+ * short ones, so no input takes a byte loop. Not cryptographic, but a random seed keeps an
+ * attacker who does not know it from building keys that collide.
+ * @param data the bytes
+ * @param bytes the number of bytes
+ * @param seed picks the hash function. Default = 0
+ * @return uint64_t the hash of the bytes
+ */
+inline uint64_t hash_bytes(const void* data, size_t bytes, uint64_t seed = 0) {
+    return _fast_hash_utils::wyhash(static_cast<const unsigned char*>(data), bytes, seed);
+}
+
+/**
+ * @brief hash string function
+ * @param s the string
+ * @param seed picks the hash function. Default = 0
+ * @return uint64_t hash_bytes of the characters of s, in constant expressions too
+ */
+constexpr uint64_t hash_string(std::string_view s, uint64_t seed = 0) {
+    return _fast_hash_utils::wyhash(s.data(), s.size(), seed);
+}
+
+/**
+ * @brief hash batch function
+ * The hashes of many integer keys, 4 or 8 at a time with AVX2 or AVX-512 when the cpu has
+ * them(see SIMD::active), equal to those of hasher<uint64_t>(seed).
+ * @param keys the keys
+ * @param out the hashes, as many as keys
+ * @param seed picks the hash function. Default = 0
+ * Throws std::invalid_argument if out and keys differ in size.
+ */
+inline void hash_batch(std::span<const uint64_t> keys, std::span<uint64_t> out,
+                       uint64_t seed = 0) {
+    if (keys.size() != out.size()) {
+        throw std::invalid_argument("hash_batch: one output per key");
+    }
+    _fast_hash_utils::mix_batches().get()(keys.data(), out.data(), keys.size(), seed);
+}
+
+/**
+ * @brief random seed function
+ * @return uint64_t a seed drawn once per process from std::random_device and the clock,
+ * the seed of seeded_hasher
+ */
+inline uint64_t random_seed() {
+    static const uint64_t seed = []() {
+        std::random_device rd;
+        const uint64_t r = (uint64_t(rd()) << 32) ^ rd();
+        return mix(r ^ uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()));
+    }();
+    return seed;
+}
+
+/**
+ * @brief the types hashed as their bytes: strings and string views of char, not pointers
+ */
+template <typename T>
+concept string_like = std::is_convertible_v<const T&, std::string_view> && !std::is_pointer_v<T>;
+
+/**
+ * @brief hashers whose results have their bits well spread already, a container uses them
+ * as they are instead of mixing them again(see hash_of)
+ */
+template <typename Hash>
+concept avalanching = requires { typename Hash::is_avalanching; };
+
+/**
+ * @brief hasher class
+ * The default hash of the containers of the library: integers, enums and pointers go through
+ * mix, strings through hash_bytes, and other types through mix of their std::hash. A hasher of
+ * strings also takes any std::string_view(heterogeneous lookups) with the same result. Integers
+ * and strings hash in constant expressions too, with the same results as at run time.
+ * @tparam T the type of the keys
+ */
+template <typename T> struct hasher {
+    using is_avalanching = void;
+    using is_transparent = void;
+
+    uint64_t seed{0};
+
+    hasher() = default;
+
+    /**
+     * @brief Construct a new hasher object
+     * @param seed picks the hash function
+     */
+    constexpr explicit hasher(uint64_t seed) : seed(seed) {}
+
+    constexpr size_t operator()(const T& x) const {
+        if constexpr (string_like<T>) {
+            return size_t(hash_string(std::string_view(x), seed));
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return size_t(mix(uint64_t(x), seed));
+        } else if constexpr (std::is_pointer_v<T>) {
+            return size_t(mix(uint64_t(reinterpret_cast<uintptr_t>(x)), seed));
+        } else {
+            return size_t(mix(uint64_t(std::hash<T>()(x)), seed));
+        }
+    }
+
+    constexpr size_t operator()(std::string_view s) const
+        requires(string_like<T> && !std::is_same_v<T, std::string_view>)
+    {
+        return size_t(hash_string(s, seed));
+    }
+};
+
+/**
+ * @brief seeded hasher class
+ * hasher seeded with random_seed(): the same in the whole process, different in every run,
+ * so the keys that collide can not be known in advance(HashDoS).
+ * @tparam T the type of the keys
+ */
+template <typename T> struct seeded_hasher : hasher<T> {
+    seeded_hasher() : hasher<T>(random_seed()) {}
+};
+
+/**
+ * @brief hash of function
+ * @param hash a hash function
+ * @param key a key
+ * @return uint64_t hash(key), mixed unless the hash is avalanching: the one place the
+ * containers turn a hash into bits they can take buckets, fingerprints or shards from.
+ */
+template <typename Hash, typename Key>
+constexpr uint64_t hash_of(const Hash& hash, const Key& key) {
+    if constexpr (avalanching<Hash>) {
+        return uint64_t(hash(key));
+    } else {
+        return mix(uint64_t(hash(key)));
+    }
+}
+} // namespace HASHING
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP 1
+#endif
+
+/**
+ * @brief how a mapped_file will be read, a hint for the read-ahead of the kernel
+ */
+enum class file_access { sequential, random };
+
+/**
+ * @brief read-only view of a whole file, memory mapped where the platform allows it
+ * and read into memory otherwise. The mapping is read only, so every process mapping
+ * the same file shares the pages of the page cache.
+ */
+class mapped_file {
+  public:
+    /**
+     * @brief Construct a new mapped_file object
+     * @param path: the file to map.
+     * @param access: sequential for one pass parsers, random for lookups.
+     * Default = sequential
+     * Throws std::runtime_error if the file can not be opened.
+     */
+    explicit mapped_file(const std::string& path,
+                         file_access access = file_access::sequential) {
+#ifdef MAPPED_FILE_MMAP
+        _fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (_fd < 0 || ::fstat(_fd, &st) != 0) {
+            _close();
+            throw std::runtime_error("Can't open file " + path);
+        }
+        _size = static_cast<size_t>(st.st_size);
+        if (_size > 0) {
+            void* p = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+            if (p == MAP_FAILED) {
+                _close();
+                throw std::runtime_error("Can't map file " + path);
+            }
+            ::madvise(p, _size, access == file_access::random ? MADV_RANDOM
+                                                                : MADV_SEQUENTIAL);
+            _data = static_cast<const char*>(p);
+        }
+#else
+        (void)access;
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Can't open file " + path);
+        }
+        std::stringstream ss;
+        ss << in.rdbuf();
+        _buffer = ss.str();
+        _data = _buffer.data();
+        _size = _buffer.size();
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() { _close(); }
+
+    /**
+     * @brief view function
+     * @returns std::string_view the contents of the file.
+     */
+    std::string_view view() const { return {_data, _size}; }
+
+  private:
+    const char* _data{nullptr};
+    size_t _size{0};
+#ifdef MAPPED_FILE_MMAP
+    int _fd{-1};
+#else
+    std::string _buffer;
+#endif
+
+    void _close() {
+#ifdef MAPPED_FILE_MMAP
+        if (_data != nullptr) {
+            ::munmap(const_cast<char*>(_data), _size);
+            _data = nullptr;
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+#endif
+    }
+};
+
+#endif
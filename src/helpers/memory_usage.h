@@ -0,0 +1,273 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#ifdef __cplusplus
+#include <concepts>
+#include <cstddef>
+#include <iomanip>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+namespace MEMORY {
+/**
+ * @brief the bytes a container holds, split by what they are for. payload is the elements
+ * themselves with what they own on the heap(the characters of long strings), node_overhead
+ * what the nodes add to every element(links, colors, heights, cached hashes), control the
+ * container object, its bucket and slab tables, shared_ptr control blocks and the headers of
+ * the heap blocks, and slack the reserved room no element uses yet(spare capacity, free
+ * slots). The headers of the heap blocks are an estimate, ALLOCATION_OVERHEAD per block.
+ */
+struct footprint {
+    size_t payload{0};
+    size_t node_overhead{0};
+    size_t control{0};
+    size_t slack{0};
+
+    /**
+     * @brief total function
+     * @return size_t: the bytes of all four parts
+     */
+    size_t total() const { return payload + node_overhead + control + slack; }
+
+    /**
+     * @brief per_element function
+     * @param n the number of elements
+     * @return double: total() / n, 0 for no element
+     */
+    double per_element(size_t n) const { return n == 0 ? 0 : double(total()) / double(n); }
+
+    footprint& operator+=(const footprint& f) {
+        payload += f.payload;
+        node_overhead += f.node_overhead;
+        control += f.control;
+        slack += f.slack;
+        return *this;
+    }
+
+    friend footprint operator+(footprint a, const footprint& b) { return a += b; }
+};
+
+// the bookkeeping of the allocator for every heap block: its header and the rounding of the
+// size, about two words with glibc
+constexpr size_t ALLOCATION_OVERHEAD = 2 * sizeof(void*);
+
+// the control block std::make_shared puts next to the object: a vtable pointer and the two
+// reference counts
+constexpr size_t SHARED_CONTROL = sizeof(void*) + 2 * sizeof(int);
+
+namespace _memory_utils {
+template <typename T> struct is_vector : std::false_type {};
+template <typename T, typename A> struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template <typename T> struct is_string : std::false_type {};
+template <typename C, typename Tr, typename A>
+struct is_string<std::basic_string<C, Tr, A>> : std::true_type {};
+
+template <typename T> struct is_pair : std::false_type {};
+template <typename A, typename B> struct is_pair<std::pair<A, B>> : std::true_type {};
+} // namespace _memory_utils
+
+/**
+ * @brief false for the types that never own heap memory, so the containers skip the walk
+ * over their elements
+ */
+template <typename T> constexpr bool may_own_heap_v = !std::is_trivially_copyable_v<T>;
+
+/**
+ * @brief the types memory_usage measures: the ones with a memory_usage() member, the strings
+ * and the standard containers
+ */
+template <typename C>
+concept measurable = requires(const C& c) {
+    { c.memory_usage() } -> std::same_as<footprint>;
+} || _memory_utils::is_string<C>::value || requires(const C& c) {
+    typename C::value_type;
+    c.size();
+    c.begin();
+};
+
+template <typename T> size_t heap_bytes(const T& value);
+
+/**
+ * @brief memory_usage function
+ * The footprint of a container: its own memory_usage(), or an estimate of the node layout of
+ * libstdc++ for std::vector, std::basic_string, std::list, the ordered and the unordered
+ * sets and maps.
+ * @param c the container
+ * @return footprint: its bytes
+ */
+template <measurable C> footprint memory_usage(const C& c) {
+    footprint f;
+    if constexpr (requires { { c.memory_usage() } -> std::same_as<footprint>; }) {
+        return c.memory_usage();
+    } else if constexpr (_memory_utils::is_string<C>::value) {
+        using Ch = typename C::value_type;
+        f.payload = c.size() * sizeof(Ch);
+        // a short string lives in the object itself
+        const auto* p = reinterpret_cast<const unsigned char*>(c.data());
+        const auto* self = reinterpret_cast<const unsigned char*>(&c);
+        if (p >= self && p < self + sizeof(C)) {
+            f.control = sizeof(C) - f.payload;
+            return f;
+        }
+        f.slack = (c.capacity() + 1 - c.size()) * sizeof(Ch);
+        f.control = sizeof(C) + ALLOCATION_OVERHEAD;
+    } else if constexpr (_memory_utils::is_vector<C>::value) {
+        using T = typename C::value_type;
+        f.control = sizeof(C) + (c.capacity() > 0 ? ALLOCATION_OVERHEAD : 0);
+        f.payload = c.size() * sizeof(T);
+        f.slack = (c.capacity() - c.size()) * sizeof(T);
+        if constexpr (may_own_heap_v<T>) {
+            for (const T& x : c) {
+                f.payload += heap_bytes(x);
+            }
+        }
+    } else {
+        using T = typename C::value_type;
+        // the nodes: a color and three links for the trees, two links for std::list and one
+        // for the hash tables, which also keep an array of bucket pointers
+        size_t links = 0;
+        if constexpr (requires { c.bucket_count(); }) {
+            links = sizeof(void*);
+            f.control += c.bucket_count() * sizeof(void*) + ALLOCATION_OVERHEAD;
+        } else if constexpr (requires { c.key_comp(); }) {
+            links = 4 * sizeof(void*);
+        } else {
+            links = 2 * sizeof(void*);
+        }
+        f.control += sizeof(C) + c.size() * ALLOCATION_OVERHEAD;
+        f.payload = c.size() * sizeof(T);
+        f.node_overhead = c.size() * links;
+        if constexpr (may_own_heap_v<T>) {
+            for (const T& x : c) {
+                f.payload += heap_bytes(x);
+            }
+        }
+    }
+    return f;
+}
+
+/**
+ * @brief heap_bytes function
+ * @param value an element of a container
+ * @return size_t: the heap bytes it owns besides sizeof(T): the characters of a long string,
+ * the whole footprint of a container but its object, 0 for the other types
+ */
+template <typename T> size_t heap_bytes(const T& value) {
+    if constexpr (!may_own_heap_v<T>) {
+        return 0;
+    } else if constexpr (_memory_utils::is_pair<T>::value) {
+        return heap_bytes(value.first) + heap_bytes(value.second);
+    } else if constexpr (measurable<T>) {
+        return memory_usage(value).total() - sizeof(T);
+    } else {
+        return 0;
+    }
+}
+
+/**
+ * @brief heap_usage function
+ * @param c a container held by another one
+ * @return footprint: memory_usage(c) but the object of c, which is part of the object that
+ * holds it
+ */
+template <measurable C> footprint heap_usage(const C& c) {
+    footprint f = memory_usage(c);
+    if (f.total() <= sizeof(C)) {
+        return footprint{};
+    }
+    f.control -= sizeof(C);
+    return f;
+}
+
+/**
+ * @brief as_overhead function
+ * @param f the footprint of a part of a container that holds no element: an index, a table
+ * of links or of counts
+ * @return footprint: f with its payload counted as node overhead
+ */
+inline footprint as_overhead(footprint f) {
+    f.node_overhead += f.payload;
+    f.payload = 0;
+    return f;
+}
+
+/**
+ * @brief payload function
+ * @param first the first element of a range
+ * @param last the end of the range
+ * @return size_t: sizeof of the elements and the heap bytes they own, the range is walked
+ * only if the elements may own some
+ */
+template <typename It> size_t payload(It first, It last) {
+    using T = std::remove_cvref_t<decltype(*first)>;
+    if constexpr (!may_own_heap_v<T>) {
+        return size_t(std::distance(first, last)) * sizeof(T);
+    } else {
+        size_t bytes = 0;
+        for (; first != last; ++first) {
+            bytes += sizeof(T) + heap_bytes(*first);
+        }
+        return bytes;
+    }
+}
+
+/**
+ * @brief owned function
+ * @param root the root of a linked structure, may be null
+ * @param children children(n, visit) calls visit(child) for every child of n, null children
+ * are skipped
+ * @param value value(n) is the element of the node n
+ * @return size_t: the heap bytes the elements of all the nodes own, the nodes are walked only
+ * if the elements may own some
+ */
+template <typename Node, typename Children, typename Value>
+size_t owned(const Node* root, Children children, Value value) {
+    using T = std::remove_cvref_t<decltype(value(root))>;
+    size_t bytes = 0;
+    if constexpr (may_own_heap_v<T>) {
+        std::vector<const Node*> stack;
+        if (root != nullptr) {
+            stack.push_back(root);
+        }
+        while (!stack.empty()) {
+            const Node* n = stack.back();
+            stack.pop_back();
+            bytes += heap_bytes(value(n));
+            children(n, [&](const Node* c) {
+                if (c != nullptr) {
+                    stack.push_back(c);
+                }
+            });
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief print function
+ * Prints the bytes per element of a footprint and of its four parts, for the benchmarks.
+ * @param out the stream
+ * @param name the name of the container
+ * @param f its footprint
+ * @param n the number of elements it holds
+ */
+inline void print(std::ostream& out, const std::string& name, const footprint& f, size_t n) {
+    const double d = n == 0 ? 1 : double(n);
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1) << name << ": " << f.per_element(n)
+        << " bytes/elem (payload " << double(f.payload) / d << ", nodes "
+        << double(f.node_overhead) / d << ", control " << double(f.control) / d << ", slack "
+        << double(f.slack) / d << ")\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+} // namespace MEMORY
+
+#endif
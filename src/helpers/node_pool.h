@@ -0,0 +1,306 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#ifdef __cplusplus
+#include "memory_usage.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief node pool class
+ * Slab allocator for the nodes of the linked containers. The nodes are carved out of
+ * slabs that double in size up to MaxSlab nodes, so neighbours in allocation order are
+ * neighbours in memory, and a destroyed node goes to a free list that the next create
+ * reuses. A node costs sizeof(Node) rounded up to its alignment, with no control
+ * block and no reference count, and its address never changes until it is destroyed.
+ * The containers own their nodes through the pool with plain pointers: moving a pool
+ * keeps every node where it is, and destroying a pool releases the slabs without
+ * running the destructors of the nodes that are still alive, so a container tears
+ * its nodes down with clear(root, children) first. The slabs come from a
+ * std::pmr::memory_resource, the default resource unless the container is given one, so a
+ * counting resource sees the memory of every container built on a pool and a
+ * std::pmr::monotonic_buffer_resource holds all of it in one arena.
+ * @tparam Node the type of the nodes.
+ * @tparam MaxSlab the largest number of nodes in one slab. Default = 4096
+ */
+template <typename Node, size_t MaxSlab = 4096> class node_pool {
+    static_assert(MaxSlab > 0, "node_pool needs room for at least one node per slab");
+
+  public:
+    /**
+     * @brief Construct a new node pool object
+     * @param resource the resource of the slabs. Default = std::pmr::get_default_resource()
+     */
+    explicit node_pool(std::pmr::memory_resource* resource =
+                           std::pmr::get_default_resource()) noexcept
+        : _resource(resource) {}
+
+    node_pool(const node_pool&) = delete;
+    node_pool& operator=(const node_pool&) = delete;
+
+    /**
+     * @brief Move constructor for node pool class
+     * @param p the pool we want to move, it is left empty
+     */
+    node_pool(node_pool&& p) noexcept
+        : _resource(p._resource), _slabs(std::move(p._slabs)),
+          _free(std::exchange(p._free, nullptr)),
+          _used(std::exchange(p._used, 0)), _live(std::exchange(p._live, 0)),
+          _capacity(std::exchange(p._capacity, 0)) {
+        p._slabs.clear();
+    }
+
+    /**
+     * @brief move assignment for node pool class
+     * @param p the pool we want to move, it is left empty
+     * @return node_pool&
+     */
+    node_pool& operator=(node_pool&& p) noexcept {
+        if (this != &p) {
+            _resource = p._resource;
+            _slabs = std::move(p._slabs);
+            p._slabs.clear();
+            _free = std::exchange(p._free, nullptr);
+            _used = std::exchange(p._used, 0);
+            _live = std::exchange(p._live, 0);
+            _capacity = std::exchange(p._capacity, 0);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief create function
+     * Constructs a node in a free slot.
+     * @param args: the arguments of the constructor of Node.
+     * @returns Node* the new node.
+     */
+    template <typename... Args> Node* create(Args&&... args) {
+        _slot* s = _acquire();
+        Node* n;
+        try {
+            n = ::new (static_cast<void*>(s->storage)) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            s->next = _free;
+            _free = s;
+            throw;
+        }
+        _live++;
+        return n;
+    }
+
+    /**
+     * @brief destroy function
+     * Runs the destructor of a node of this pool and hands its slot to the free list.
+     * @param n: the node, nullptr is ignored.
+     */
+    void destroy(Node* n) noexcept {
+        if (n == nullptr) {
+            return;
+        }
+        n->~Node();
+        _slot* s = reinterpret_cast<_slot*>(n);
+        s->next = _free;
+        _free = s;
+        _live--;
+    }
+
+    /**
+     * @brief clear function
+     * Destroys every node of a tree and releases the slabs.
+     * @param root: the root of the tree, the only nodes alive in the pool.
+     * @param children: children(n, visit) calls visit(child) for every child of n, null
+     * children are skipped.
+     */
+    template <typename Children> void clear(Node* root, Children children) {
+        if constexpr (!std::is_trivially_destructible_v<Node>) {
+            std::vector<Node*> stack;
+            if (root != nullptr) {
+                stack.push_back(root);
+            }
+            while (!stack.empty()) {
+                Node* n = stack.back();
+                stack.pop_back();
+                children(n, [&](Node* c) {
+                    if (c != nullptr) {
+                        stack.push_back(c);
+                    }
+                });
+                n->~Node();
+            }
+        }
+        _slabs.clear();
+        _free = nullptr;
+        _used = _live = _capacity = 0;
+    }
+
+    /**
+     * @brief splice function
+     * Takes over every slab of another pool in O(slabs + free slots of p): its nodes stay
+     * where they are and from now on belong to this pool, p is left empty.
+     * @param p: the pool to take the nodes from.
+     */
+    void splice(node_pool& p) noexcept {
+        if (this == &p || p._slabs.empty()) {
+            return;
+        }
+        _retire_tail();
+        p._retire_tail();
+        if (p._free != nullptr) {
+            _slot* tail = p._free;
+            while (tail->next != nullptr) {
+                tail = tail->next;
+            }
+            tail->next = _free;
+            _free = p._free;
+        }
+        // the slabs of p are all retired, so the next slab is allocated fresh
+        for (_slab& s : p._slabs) {
+            _slabs.push_back(std::move(s));
+        }
+        _used = _slabs.back().size;
+        _live += p._live;
+        _capacity += p._capacity;
+        p._slabs.clear();
+        p._free = nullptr;
+        p._used = p._live = p._capacity = 0;
+    }
+
+    /**
+     * @brief reserve function
+     * Makes room for n nodes in total with at most one new slab.
+     * @param n: the number of nodes.
+     */
+    void reserve(size_t n) {
+        if (n <= _live) {
+            return;
+        }
+        size_t spare = _spare();
+        if (n - _live > spare) {
+            _grow(n - _live - spare);
+        }
+    }
+
+    /**
+     * @brief size function
+     * @return size_t the number of nodes alive.
+     */
+    size_t size() const noexcept { return _live; }
+
+    /**
+     * @brief capacity function
+     * @return size_t the number of slots over all the slabs.
+     */
+    size_t capacity() const noexcept { return _capacity; }
+
+    /**
+     * @brief resource function
+     * @return std::pmr::memory_resource* the resource the next slabs come from.
+     */
+    std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+    /**
+     * @brief memory_usage function
+     * @param element the bytes of the element in every node, sizeof of the value
+     * @param owned the heap bytes the elements of all the nodes own
+     * @return MEMORY::footprint: the elements, the rest of the slots of the live nodes, the
+     * free slots and the slab table, but not the pool object, which the container counts
+     */
+    MEMORY::footprint memory_usage(size_t element, size_t owned = 0) const noexcept {
+        MEMORY::footprint f;
+        f.payload = _live * element + owned;
+        f.node_overhead = _live * (sizeof(_slot) - std::min(element, sizeof(_slot)));
+        f.slack = (_capacity - _live) * sizeof(_slot);
+        f.control = _slabs.capacity() * sizeof(_slab) +
+                    (_slabs.size() + (_slabs.capacity() > 0)) * MEMORY::ALLOCATION_OVERHEAD;
+        return f;
+    }
+
+  private:
+    static constexpr size_t MIN_SLAB = std::min<size_t>(32, MaxSlab);
+
+    union _slot {
+        _slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    // a slab goes back to the resource it came from, also after a splice
+    struct _release {
+        std::pmr::memory_resource* resource;
+        size_t size;
+        void operator()(_slot* p) const noexcept {
+            resource->deallocate(p, size * sizeof(_slot), alignof(_slot));
+        }
+    };
+
+    struct _slab {
+        std::unique_ptr<_slot[], _release> slots;
+        size_t size;
+    };
+
+    std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
+    // the slab table comes from the resource as well, so an arena holds the whole pool
+    std::pmr::vector<_slab> _slabs{_resource};
+    _slot* _free{nullptr};
+    // slots of the last slab that were never handed out start at _used
+    size_t _used{0};
+    size_t _live{0};
+    size_t _capacity{0};
+
+    size_t _spare() const noexcept {
+        size_t spare = _slabs.empty() ? 0 : _slabs.back().size - _used;
+        for (_slot* s = _free; s != nullptr; s = s->next) {
+            spare++;
+        }
+        return spare;
+    }
+
+    void _grow(size_t at_least) {
+        size_t n = _slabs.empty() ? MIN_SLAB : std::min(_slabs.back().size * 2, MaxSlab);
+        n = std::max(n, at_least);
+        _retire_tail();
+        _slot* slots =
+            static_cast<_slot*>(_resource->allocate(n * sizeof(_slot), alignof(_slot)));
+        try {
+            _slabs.push_back({std::unique_ptr<_slot[], _release>(slots, _release{_resource, n}), n});
+        } catch (...) {
+            _resource->deallocate(slots, n * sizeof(_slot), alignof(_slot));
+            throw;
+        }
+        _used = 0;
+        _capacity += n;
+    }
+
+    // the slots never handed out of the last slab are not lost, they go to the free list
+    void _retire_tail() noexcept {
+        if (_slabs.empty()) {
+            return;
+        }
+        for (size_t i = _used; i < _slabs.back().size; i++) {
+            _slot* s = &_slabs.back().slots[i];
+            s->next = _free;
+            _free = s;
+        }
+        _used = _slabs.back().size;
+    }
+
+    _slot* _acquire() {
+        if (_free != nullptr) {
+            _slot* s = _free;
+            _free = s->next;
+            return s;
+        }
+        if (_slabs.empty() || _used == _slabs.back().size) {
+            _grow(1);
+        }
+        return &_slabs.back().slots[_used++];
+    }
+};
+
+#endif
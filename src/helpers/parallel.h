@@ -0,0 +1,148 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "executor.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#endif
+
+namespace PARALLEL {
+/**
+ * @brief execution policy class
+ * How an algorithm may run: seq on the calling thread, par on the threads of the shared
+ * executor, par(4) on at most 4 of them. par_unseq runs like par, the kernels of the library
+ * already vectorize what they can, it is there so that calls read as they do with
+ * std::execution. A policy converts to the number of threads it stands for(1 for seq, 0 for
+ * every thread), so every algorithm that takes a number of threads also takes a policy, e.g.
+ * merge_sort(v.begin(), v.end(), std::less<>(), PARALLEL::par).
+ */
+struct execution_policy {
+    enum class kind { seq, par, par_unseq };
+    kind type;
+    size_t threads;
+
+    /**
+     * @brief operator()
+     * @param t the most threads to run on(0 means every thread), ignored by seq
+     * @return execution_policy the same policy capped at t threads
+     */
+    constexpr execution_policy operator()(size_t t) const {
+        return {type, type == kind::seq ? size_t(1) : t};
+    }
+
+    constexpr operator size_t() const noexcept { return threads; }
+};
+
+inline constexpr execution_policy seq{execution_policy::kind::seq, 1};
+inline constexpr execution_policy par{execution_policy::kind::par, 0};
+inline constexpr execution_policy par_unseq{execution_policy::kind::par_unseq, 0};
+
+/**
+ * @brief resolves a requested thread count(0 means every hardware thread)
+ * @param threads the requested number of threads
+ * @param work the number of items to split, no more threads than items are used
+ * @return size_t the number of threads to spawn, at least 1
+ */
+inline size_t resolve_threads(size_t threads, size_t work) {
+    if (threads == 0) {
+        threads = hardware_threads();
+    }
+    return std::max<size_t>(1, std::min(threads, work));
+}
+
+/**
+ * @brief splits [begin, end) in contiguous chunks and runs them on executor::shared()
+ * @param begin first index
+ * @param end one past the last index
+ * @param threads number of chunks(0 means every hardware thread), at most that many run at
+ * once, and no more than the threads of the executor
+ * @param f callable invoked as f(lo, hi, tid) once per chunk, tid is in [0, threads), so
+ * per-chunk state can be indexed by tid
+ * The calling thread runs chunks too, so threads == 1 runs f on the caller. The first
+ * exception thrown by f is rethrown once every chunk is done.
+ */
+template <typename F> void parallel_for(size_t begin, size_t end, size_t threads, F&& f) {
+    if (begin >= end) {
+        return;
+    }
+    threads = resolve_threads(threads, end - begin);
+    if (threads == 1) {
+        f(begin, end, size_t(0));
+        return;
+    }
+    executor::shared().parallel_for(begin, end, threads, f);
+}
+
+/**
+ * @brief runs f on every index of [begin, end), workers take the next index from a
+ * shared counter, so items of very different cost still keep every thread busy
+ * @param begin first index
+ * @param end one past the last index
+ * @param threads number of threads(0 means every hardware thread)
+ * @param f callable invoked as f(i, tid) once per index, tid is in [0, threads), so
+ * per-thread state can be indexed by tid
+ */
+template <typename F>
+void parallel_for_dynamic(size_t begin, size_t end, size_t threads, F&& f) {
+    if (begin >= end) {
+        return;
+    }
+    threads = resolve_threads(threads, end - begin);
+    std::atomic<size_t> next{begin};
+    parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t tid = lo; tid < hi; tid++) {
+            for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < end;
+                 i = next.fetch_add(1, std::memory_order_relaxed)) {
+                f(i, tid);
+            }
+        }
+    });
+}
+
+/**
+ * @brief sorts [first, last) by sorting contiguous runs on worker threads and merging
+ * neighbouring runs pairwise, also in parallel
+ * @param first random access iterator to the first element
+ * @param last random access iterator one past the last element
+ * @param comp strict weak ordering, as for std::sort
+ * @param threads number of threads(0 means every hardware thread)
+ * The result is the same as std::sort, equal elements may end up in any order.
+ */
+template <typename It, typename Compare>
+void parallel_sort(It first, It last, Compare comp, size_t threads = 0) {
+    const size_t n = static_cast<size_t>(last - first);
+    threads = resolve_threads(threads, n / 4096 + 1);
+    if (threads == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    std::vector<size_t> bounds(threads + 1);
+    for (size_t t = 0; t <= threads; t++) {
+        bounds[t] = n * t / threads;
+    }
+    parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            std::sort(first + bounds[t], first + bounds[t + 1], comp);
+        }
+    });
+    for (size_t width = 1; width < threads; width *= 2) {
+        size_t pairs = (threads + 2 * width - 1) / (2 * width);
+        parallel_for(0, pairs, pairs, [&](size_t lo, size_t hi, size_t) {
+            for (size_t p = lo; p < hi; p++) {
+                size_t a = 2 * width * p, b = std::min(a + width, threads),
+                       c = std::min(a + 2 * width, threads);
+                if (b < c) {
+                    std::inplace_merge(first + bounds[a], first + bounds[b], first + bounds[c],
+                                       comp);
+                }
+            }
+        });
+    }
+}
+} // namespace PARALLEL
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#ifdef __cplusplus
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace PERF {
+/**
+ * @brief the hardware events counters can count, the cache and tlb events count the misses of
+ * reads
+ */
+enum class event { cycles, instructions, l1d_misses, llc_misses, branch_misses, dtlb_misses };
+
+constexpr size_t EVENTS = 6;
+
+/**
+ * @brief event_name function
+ * @param e the event
+ * @return std::string: its name in the benchmark results
+ */
+inline std::string event_name(event e) {
+    static const std::array<std::string, EVENTS> names = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"};
+    return names[size_t(e)];
+}
+
+/**
+ * @brief the counts of a measured region. An event the counters could not open, or that
+ * never got scheduled on the pmu, is not valid and reads 0.
+ */
+struct sample {
+    std::array<double, EVENTS> values{};
+    std::array<bool, EVENTS> valid{};
+
+    /**
+     * @brief has function
+     * @param e the event
+     * @return true if e was counted
+     */
+    bool has(event e) const { return valid[size_t(e)]; }
+
+    /**
+     * @brief operator[]
+     * @param e the event
+     * @return double: its count, scaled up when the kernel multiplexed the counters
+     */
+    double operator[](event e) const { return values[size_t(e)]; }
+
+    /**
+     * @brief ipc function
+     * @return double: instructions per cycle, 0 unless both were counted
+     */
+    double ipc() const {
+        return has(event::cycles) && has(event::instructions) && values[0] > 0
+                   ? values[1] / values[0]
+                   : 0;
+    }
+};
+
+/**
+ * @brief counters class
+ * The hardware counters of the calling thread through perf_event_open, user space only.
+ * Every event is opened on its own, so the events the cpu or the kernel do not offer are
+ * left out, and without any(other systems, containers, perf_event_paranoid) available() is
+ * false and read() gives no valid event. start() and stop() bracket the measured region.
+ */
+class counters {
+  public:
+    counters() {
+        _fds.fill(-1);
+#if defined(__linux__)
+        for (size_t e = 0; e < EVENTS; e++) {
+            _fds[e] = _open(event(e));
+        }
+#endif
+    }
+
+    counters(const counters&) = delete;
+    counters& operator=(const counters&) = delete;
+
+    counters(counters&& c) noexcept : _fds(std::exchange(c._fds, _closed())) {}
+
+    counters& operator=(counters&& c) noexcept {
+        if (this != &c) {
+            _close();
+            _fds = std::exchange(c._fds, _closed());
+        }
+        return *this;
+    }
+
+    ~counters() { _close(); }
+
+    /**
+     * @brief available function
+     * @return true if at least one event could be opened
+     */
+    bool available() const {
+        for (int fd : _fds) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief available function
+     * @param e the event
+     * @return true if e could be opened
+     */
+    bool available(event e) const { return _fds[size_t(e)] >= 0; }
+
+    /**
+     * @brief start function
+     * Zeroes the counters and starts counting.
+     */
+    void start() {
+#if defined(__linux__)
+        for (int fd : _fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief stop function
+     * Stops counting, read() gives the counts since start().
+     */
+    void stop() {
+#if defined(__linux__)
+        for (int fd : _fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief read function
+     * @return sample: the counts of the events since start()
+     */
+    sample read() const {
+        sample s;
+#if defined(__linux__)
+        for (size_t e = 0; e < EVENTS; e++) {
+            // the value, then the time the event was enabled and the time it ran
+            uint64_t v[3] = {0, 0, 0};
+            if (_fds[e] < 0 || ::read(_fds[e], v, sizeof(v)) != ssize_t(sizeof(v)) || v[2] == 0) {
+                continue;
+            }
+            s.values[e] = double(v[0]) * double(v[1]) / double(v[2]);
+            s.valid[e] = true;
+        }
+#endif
+        return s;
+    }
+
+  private:
+    std::array<int, EVENTS> _fds;
+
+    static std::array<int, EVENTS> _closed() {
+        std::array<int, EVENTS> fds;
+        fds.fill(-1);
+        return fds;
+    }
+
+    void _close() {
+#if defined(__linux__)
+        for (int& fd : _fds) {
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+#endif
+    }
+
+#if defined(__linux__)
+    static int _open(event e) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        auto cache = [&](uint64_t id) {
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = id | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        switch (e) {
+        case event::cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case event::instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case event::l1d_misses:
+            cache(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case event::llc_misses:
+            cache(PERF_COUNT_HW_CACHE_LL);
+            break;
+        case event::branch_misses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case event::dtlb_misses:
+            cache(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        }
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+};
+} // namespace PERF
+
+#endif
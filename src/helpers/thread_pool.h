@@ -0,0 +1,17 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "executor.h"
+#include "parallel.h"
+
+namespace PARALLEL {
+/**
+ * @brief thread pool class
+ * The work stealing executor under the name the library first gave its pool: thread_pool(n)
+ * starts a private one with n workers, and thread_pool::shared() is executor::shared(), the
+ * pool every parallel algorithm runs on.
+ */
+using thread_pool = executor;
+} // namespace PARALLEL
+
+#endif
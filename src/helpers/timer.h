@@ -5,13 +5,26 @@
 #include <utility>
 #ifdef __cplusplus
 #include "../../third_party/json.hpp"
+#include "perf_counters.h"
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
-#include <ctime>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <tuple>
+#include <vector>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
 #endif
 
 using nlohmann::json;
@@ -23,12 +36,17 @@ void invoke_tuple(Func&& func, Tuple&& tup, std::index_sequence<I...>) {
     std::invoke(std::forward<Func>(func), std::get<I>(std::forward<Tuple>(tup))...);
 }
 
+// the milliseconds of steady_clock since start
+inline double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
 // Function to measure execution time
 template <typename Func, typename... Args> double exec_time(Func&& callback, Args&&... args) {
-    auto start = clock();
+    auto start = std::chrono::steady_clock::now();
     std::invoke(std::forward<Func>(callback), std::forward<Args>(args)...);
-    auto end = clock();
-    double total = (end - start) / double(CLOCKS_PER_SEC) * 1000;
+    double total = elapsed_ms(start);
     if (total > 1.0) {
         std::cout << "\033[33m" << "Total execution time: " << total << " ms\n";
     } else {
@@ -42,18 +60,16 @@ template <typename Func1, typename Tuple1, typename Func2, typename Tuple2>
 int check_faster(Func1&& callback1, const Tuple1& args1, Func2&& callback2, const Tuple2& args2,
                  int verbose = 0) {
     // Run first function
-    auto start = clock();
+    auto start = std::chrono::steady_clock::now();
     invoke_tuple(std::forward<Func1>(callback1), args1,
                  std::make_index_sequence<std::tuple_size_v<Tuple1>>{});
-    auto end = clock();
-    auto total1 = (end - start) / double(CLOCKS_PER_SEC) * 1000;
+    auto total1 = elapsed_ms(start);
 
     // Run second function
-    start = clock();
+    start = std::chrono::steady_clock::now();
     invoke_tuple(std::forward<Func2>(callback2), args2,
                  std::make_index_sequence<std::tuple_size_v<Tuple2>>{});
-    end = clock();
-    auto total2 = (end - start) / double(CLOCKS_PER_SEC) * 1000;
+    auto total2 = elapsed_ms(start);
 
     if (verbose == 1) {
         std::cout << "Function 1 execution time: " << total1 << " ms\n";
@@ -65,12 +81,10 @@ int check_faster(Func1&& callback1, const Tuple1& args1, Func2&& callback2, cons
 
 template <typename Func, typename Tuple>
 double complexity_analyzer_tuples(Func&& callback, const Tuple& args) {
-    auto start = clock();
+    auto start = std::chrono::steady_clock::now();
     invoke_tuple(std::forward<Func>(callback), args,
                  std::make_index_sequence<std::tuple_size_v<Tuple>>{});
-    auto end = clock();
-    double total = (end - start) / double(CLOCKS_PER_SEC) * 1000;
-    return total;
+    return elapsed_ms(start);
 }
 
 template <typename Tuple> int sizeof_tuples(const Tuple args) {
@@ -81,22 +95,195 @@ template <typename Tuple> int sizeof_tuples(const Tuple args) {
     return std::tuple_size<decltype(args)>::value;
 }
 
+/**
+ * @brief the candidate models of fit_complexity, from the slowest growing
+ */
+enum class complexity { constant, logn, n, nlogn, n2, n3 };
+
+/**
+ * @brief complexity_name function
+ * @param c the model
+ * @return std::string: its name, as written in the json files
+ */
+inline std::string complexity_name(complexity c) {
+    static const std::array<std::string, 6> names = {"1", "log n", "n", "n log n", "n^2", "n^3"};
+    return names[size_t(c)];
+}
+
+/**
+ * @brief parse_complexity function
+ * @param name a name from complexity_name
+ * @return complexity: the model of that name. Throws std::invalid_argument for another name.
+ */
+inline complexity parse_complexity(const std::string& name) {
+    for (int c = 0; c < 6; c++) {
+        if (complexity_name(complexity(c)) == name) {
+            return complexity(c);
+        }
+    }
+    throw std::invalid_argument("parse_complexity: unknown complexity " + name);
+}
+
+/**
+ * @brief complexity_of function
+ * @param c the model
+ * @param n the input size
+ * @return double: the model at n, without its coefficient
+ */
+inline double complexity_of(complexity c, double n) {
+    const double lg = n > 1 ? std::log2(n) : 0;
+    switch (c) {
+    case complexity::constant:
+        return 1;
+    case complexity::logn:
+        return lg;
+    case complexity::n:
+        return n;
+    case complexity::nlogn:
+        return n * lg;
+    case complexity::n2:
+        return n * n;
+    default:
+        return n * n * n;
+    }
+}
+
+/**
+ * @brief a model fitted to measurements, time = coefficient * model(n), with the root mean
+ * square of the residuals relative to the mean time
+ */
+struct fit {
+    complexity model{complexity::constant};
+    double coefficient{0};
+    double rms{0};
+};
+
+/**
+ * @brief fit_complexity function
+ * @param sizes the input sizes
+ * @param times the time of every input size
+ * @return std::vector<fit>: the least squares fit of every model, the best one first.
+ * Throws std::invalid_argument if the vectors differ in size or hold less than 2 points.
+ */
+inline std::vector<fit> fit_complexity(const std::vector<double>& sizes,
+                                       const std::vector<double>& times) {
+    if (sizes.size() != times.size() || sizes.size() < 2) {
+        throw std::invalid_argument("fit_complexity: need at least 2 sizes with their times");
+    }
+    double mean = 0;
+    for (double t : times) {
+        mean += t;
+    }
+    mean /= double(times.size());
+    std::vector<fit> out;
+    for (int c = 0; c < 6; c++) {
+        fit f{complexity(c), 0, 0};
+        double tg = 0, gg = 0;
+        for (size_t i = 0; i < sizes.size(); i++) {
+            const double g = complexity_of(f.model, sizes[i]);
+            tg += times[i] * g;
+            gg += g * g;
+        }
+        f.coefficient = gg > 0 ? tg / gg : 0;
+        double squares = 0;
+        for (size_t i = 0; i < sizes.size(); i++) {
+            const double r = times[i] - f.coefficient * complexity_of(f.model, sizes[i]);
+            squares += r * r;
+        }
+        f.rms = mean > 0 ? std::sqrt(squares / double(sizes.size())) / mean : 0;
+        out.push_back(f);
+    }
+    // on a tie the slower growing model wins
+    std::stable_sort(out.begin(), out.end(),
+                     [](const fit& a, const fit& b) { return a.rms < b.rms; });
+    return out;
+}
+
+/**
+ * @brief the outcome of check_regression, with a message on why it failed
+ */
+struct regression {
+    bool passed{true};
+    std::string message;
+};
+
+/**
+ * @brief check_regression function
+ * @param name the name of the measured function in the baseline
+ * @param current its fit now
+ * @param baseline_path a json object of {name: {"complexity", "coefficient"}}, as
+ * save_baseline writes
+ * @param threshold the relative growth of the coefficient that is still accepted.
+ * Default = 0.25
+ * @return regression: failed if the model grows faster than in the baseline, or if it is the
+ * same and the coefficient grew by more than threshold. Passed if there is no baseline.
+ */
+inline regression check_regression(const std::string& name, const fit& current,
+                                   const std::string& baseline_path, double threshold = 0.25) {
+    std::ifstream file(baseline_path);
+    if (!file) {
+        return {true, "no baseline file " + baseline_path};
+    }
+    const json j = json::parse(file);
+    if (!j.contains(name)) {
+        return {true, "no baseline for " + name};
+    }
+    const complexity model = parse_complexity(j[name]["complexity"].get<std::string>());
+    const double coefficient = j[name]["coefficient"].get<double>();
+    if (current.model > model) {
+        return {false, name + " is O(" + complexity_name(current.model) + "), the baseline is O(" +
+                           complexity_name(model) + ")"};
+    }
+    if (current.model == model && current.coefficient > coefficient * (1 + threshold)) {
+        return {false, name + " has coefficient " + std::to_string(current.coefficient) +
+                           ", the baseline has " + std::to_string(coefficient)};
+    }
+    return {true, name + " is O(" + complexity_name(current.model) + ")"};
+}
+
+/**
+ * @brief save_baseline function
+ * @param name the name of the measured function
+ * @param current its fit, replacing the one of name in the baseline
+ * @param baseline_path the json file for check_regression, the other names in it are kept
+ */
+inline void save_baseline(const std::string& name, const fit& current,
+                          const std::string& baseline_path) {
+    json j = json::object();
+    if (std::ifstream in(baseline_path); in) {
+        j = json::parse(in);
+    }
+    j[name] = {{"complexity", complexity_name(current.model)},
+               {"coefficient", current.coefficient}};
+    std::ofstream out(baseline_path);
+    if (!out) {
+        throw std::runtime_error("save_baseline: can not open " + baseline_path);
+    }
+    out << j.dump(4);
+}
+
+// Function to fit the execution times of the tuples to a complexity, the best fit is
+// written to info.json with the measurements and returned
 template <typename Func, typename... Tuples>
-void time_complexity(Func&& callback, const Tuples&... tuples) {
+fit time_complexity(Func&& callback, const Tuples&... tuples) {
     if constexpr (sizeof...(tuples) < 5) {
         std::cout << "\033[34m" << "Data with size: " << (sizeof...(tuples))
                   << " are not enough to generate time complexity analysis" << '\n';
-        return;
+        return fit{};
     }
 
     std::array<int, sizeof...(tuples)> input_size = {sizeof_tuples(tuples)...};
     std::array<double, sizeof...(tuples)> exec_time = {
         complexity_analyzer_tuples(callback, tuples)...};
+    const fit best = fit_complexity(std::vector<double>(input_size.begin(), input_size.end()),
+                                    std::vector<double>(exec_time.begin(), exec_time.end()))[0];
 
     // write to file
     json j;
     j["input_size"] = input_size;
     j["execution_time"] = exec_time;
+    j["complexity"] = complexity_name(best.model);
+    j["coefficient"] = best.coefficient;
     std::ofstream file("info.json");
     file << j.dump(4);
     file.close();
@@ -105,6 +292,199 @@ void time_complexity(Func&& callback, const Tuples&... tuples) {
     std::filesystem::path script_path = header_path.parent_path() / "analyzer.py";
     std::string command = "python3 " + script_path.string();
     int rr = system(command.c_str());
+    return best;
+}
+
+/**
+ * @brief keeps the compiler from optimizing away the computation of value
+ * @param value the result of the benchmarked code
+ */
+template <typename T> inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief keeps the compiler from reordering or dropping the stores around it
+ */
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+/**
+ * @brief the time stamp counter of the cpu
+ * @return uint64_t: the cycles of rdtsc, 0 where there is none
+ */
+inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief how benchmark runs a function: warmup_ms of untimed calls, then samples batches of
+ * iterations calls each. With iterations = 0 the batch doubles until it takes at least
+ * min_time_ms / samples. With counters the hardware counters of PERF::counters are read
+ * around the samples, where the system offers them.
+ */
+struct options {
+    double warmup_ms{10};
+    double min_time_ms{100};
+    size_t samples{30};
+    uint64_t iterations{0};
+    bool counters{false};
+};
+
+/**
+ * @brief the statistics of a set of samples
+ */
+struct stats {
+    double min{0}, median{0}, mean{0}, p90{0}, p99{0}, max{0}, stddev{0};
+};
+
+/**
+ * @brief summarize function
+ * @param samples the samples
+ * @return stats: their statistics, the percentiles interpolated between the closest ranks
+ */
+inline stats summarize(std::vector<double> samples) {
+    stats out;
+    if (samples.empty()) {
+        return out;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+        const double rank = p * double(samples.size() - 1);
+        const size_t lo = size_t(rank), hi = std::min(lo + 1, samples.size() - 1);
+        return samples[lo] + (samples[hi] - samples[lo]) * (rank - double(lo));
+    };
+    out.min = samples.front();
+    out.max = samples.back();
+    out.median = percentile(0.5);
+    out.p90 = percentile(0.9);
+    out.p99 = percentile(0.99);
+    double sum = 0, squares = 0;
+    for (double x : samples) {
+        sum += x;
+    }
+    out.mean = sum / double(samples.size());
+    for (double x : samples) {
+        squares += (x - out.mean) * (x - out.mean);
+    }
+    out.stddev = samples.size() > 1 ? std::sqrt(squares / double(samples.size() - 1)) : 0;
+    return out;
+}
+
+/**
+ * @brief the result of benchmark: the nanoseconds of one call over the samples, the
+ * median cycles of one call(0 without rdtsc), and with options::counters every hardware
+ * event that could be counted per call, and "ipc" if cycles and instructions were counted
+ */
+struct result {
+    std::string name;
+    uint64_t iterations{0};
+    size_t samples{0};
+    stats ns;
+    double cycles{0};
+    std::map<std::string, double> counters;
+
+    /**
+     * @brief to_json function
+     * @return json: the result as an object, for write_json
+     */
+    json to_json() const {
+        json j{{"name", name},           {"iterations", iterations}, {"samples", samples},
+               {"min_ns", ns.min},       {"median_ns", ns.median},   {"mean_ns", ns.mean},
+               {"p90_ns", ns.p90},       {"p99_ns", ns.p99},         {"max_ns", ns.max},
+               {"stddev_ns", ns.stddev}, {"cycles", cycles}};
+        if (!counters.empty()) {
+            j["counters"] = counters;
+        }
+        return j;
+    }
+};
+
+/**
+ * @brief benchmark function
+ * @param name the name of the result
+ * @param f the code to time, called with no arguments. Its result should go through
+ * do_not_optimize.
+ * @param opt the warmup, the samples and their iterations
+ * @return result: the statistics of the time of one call of f
+ */
+template <typename F> result benchmark(const std::string& name, F&& f, const options& opt = {}) {
+    if (opt.samples == 0) {
+        throw std::invalid_argument("benchmark: samples must be positive");
+    }
+    using clock = std::chrono::steady_clock;
+    auto run = [&](uint64_t n) {
+        const auto start = clock::now();
+        for (uint64_t i = 0; i < n; i++) {
+            f();
+        }
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    };
+    for (const auto start = clock::now(); elapsed_ms(start) < opt.warmup_ms;) {
+        run(1);
+    }
+    uint64_t n = opt.iterations;
+    if (n == 0) {
+        const double target = opt.min_time_ms * 1e6 / double(opt.samples);
+        for (n = 1; n < (uint64_t(1) << 40) && run(n) < target; n *= 2) {
+        }
+    }
+    std::optional<PERF::counters> pmu;
+    if (opt.counters) {
+        pmu.emplace();
+        pmu->start();
+    }
+    std::vector<double> ns(opt.samples), cyc(opt.samples);
+    for (size_t s = 0; s < opt.samples; s++) {
+        const uint64_t c = cycles();
+        ns[s] = run(n) / double(n);
+        cyc[s] = double(cycles() - c) / double(n);
+    }
+    result out{name, n, opt.samples, summarize(std::move(ns)), 0, {}};
+    out.cycles = cycles() == 0 ? 0 : summarize(std::move(cyc)).median;
+    if (pmu) {
+        pmu->stop();
+        const PERF::sample counts = pmu->read();
+        const double calls = double(n) * double(opt.samples);
+        for (size_t e = 0; e < PERF::EVENTS; e++) {
+            if (counts.valid[e]) {
+                out.counters[PERF::event_name(PERF::event(e))] = counts.values[e] / calls;
+            }
+        }
+        if (counts.ipc() > 0) {
+            out.counters["ipc"] = counts.ipc();
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief write_json function
+ * @param results the results of benchmark
+ * @param path the file to write them to, as an array of to_json() objects
+ */
+inline void write_json(const std::vector<result>& results, const std::string& path) {
+    json j = json::array();
+    for (const result& r : results) {
+        j.push_back(r.to_json());
+    }
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("write_json: can not open " + path);
+    }
+    file << j.dump(4);
 }
 } // namespace TIMER
 
@@ -0,0 +1,231 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+#include "../../third_party/json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#endif
+
+/**
+ * The spans and counters of the library record only when ALGOPLUS_TRACE is defined, for every
+ * translation unit of the program, e.g. with -DALGOPLUS_TRACE. Without it
+ * ALGOPLUS_TRACE_SPAN and ALGOPLUS_TRACE_COUNTER expand to nothing and the algorithms carry
+ * no trace of them. The names must be string literals, only their address is recorded.
+ */
+#if defined(ALGOPLUS_TRACE)
+#define ALGOPLUS_TRACE_CONCAT_(a, b) a##b
+#define ALGOPLUS_TRACE_CONCAT(a, b) ALGOPLUS_TRACE_CONCAT_(a, b)
+#define ALGOPLUS_TRACE_SPAN(name) TRACE::span ALGOPLUS_TRACE_CONCAT(_algoplus_span_, __LINE__)(name)
+#define ALGOPLUS_TRACE_COUNTER(name, value) TRACE::counter(name, int64_t(value))
+#else
+#define ALGOPLUS_TRACE_SPAN(name) ((void)0)
+#define ALGOPLUS_TRACE_COUNTER(name, value) ((void)0)
+#endif
+
+#ifndef ALGOPLUS_TRACE_BUFFER
+// the events every thread keeps, the oldest are overwritten first
+#define ALGOPLUS_TRACE_BUFFER (1 << 14)
+#endif
+
+namespace TRACE {
+/**
+ * @brief a recorded event: a span of dur_ns nanoseconds from ts_ns, or a counter set to
+ * value at ts_ns, on the thread tid(numbered in the order threads first record)
+ */
+struct event {
+    const char* name;
+    uint32_t tid;
+    bool is_counter;
+    uint64_t ts_ns;
+    int64_t value;
+};
+
+namespace _trace_utils {
+constexpr size_t CAPACITY = std::bit_ceil(size_t(ALGOPLUS_TRACE_BUFFER));
+
+// the fields are atomic so that an export may read them while their thread writes
+struct slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> ts{0};
+    std::atomic<int64_t> value{0};
+    std::atomic<bool> is_counter{false};
+};
+
+// the ring of a thread: only its thread writes, and head counts every event it recorded
+struct ring {
+    explicit ring(uint32_t tid) : slots(CAPACITY), tid(tid) {}
+    std::vector<slot> slots;
+    std::atomic<uint64_t> head{0};
+    uint32_t tid;
+};
+
+struct registry {
+    std::mutex lock;
+    std::vector<std::shared_ptr<ring>> rings;
+
+    static registry& get() {
+        static registry r;
+        return r;
+    }
+};
+
+// the rings outlive their threads, the registry holds them until the end of the program
+inline ring& local() {
+    thread_local ring* mine = [] {
+        registry& r = registry::get();
+        std::lock_guard<std::mutex> guard(r.lock);
+        r.rings.push_back(std::make_shared<ring>(uint32_t(r.rings.size())));
+        return r.rings.back().get();
+    }();
+    return *mine;
+}
+
+inline uint64_t now_ns() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return uint64_t(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             epoch)
+            .count());
+}
+
+inline void record(const char* name, uint64_t ts, int64_t value, bool is_counter) noexcept {
+    ring& r = local();
+    const uint64_t h = r.head.load(std::memory_order_relaxed);
+    slot& s = r.slots[h & (CAPACITY - 1)];
+    s.name.store(name, std::memory_order_relaxed);
+    s.ts.store(ts, std::memory_order_relaxed);
+    s.value.store(value, std::memory_order_relaxed);
+    s.is_counter.store(is_counter, std::memory_order_relaxed);
+    r.head.store(h + 1, std::memory_order_release);
+}
+} // namespace _trace_utils
+
+/**
+ * @brief span class
+ * Records the time from its construction to its destruction as an event of the calling
+ * thread, use it through ALGOPLUS_TRACE_SPAN(name).
+ */
+class span {
+  public:
+    explicit span(const char* name) noexcept : _name(name), _start(_trace_utils::now_ns()) {}
+    ~span() {
+        _trace_utils::record(_name, _start, int64_t(_trace_utils::now_ns() - _start), false);
+    }
+
+    span(const span&) = delete;
+    span& operator=(const span&) = delete;
+
+  private:
+    const char* _name;
+    uint64_t _start;
+};
+
+/**
+ * @brief counter function
+ * Records the value of a counter now, use it through ALGOPLUS_TRACE_COUNTER(name, value).
+ * @param name the name of the counter, a string literal
+ * @param value its value
+ */
+inline void counter(const char* name, int64_t value) noexcept {
+    _trace_utils::record(name, _trace_utils::now_ns(), value, true);
+}
+
+/**
+ * @brief events function
+ * @return std::vector<event>: the events the buffers still hold, of every thread, ordered by
+ * time. The events a thread overwrites while they are read are left out.
+ */
+inline std::vector<event> events() {
+    std::vector<std::shared_ptr<_trace_utils::ring>> rings;
+    {
+        _trace_utils::registry& r = _trace_utils::registry::get();
+        std::lock_guard<std::mutex> guard(r.lock);
+        rings = r.rings;
+    }
+    constexpr uint64_t N = _trace_utils::CAPACITY;
+    std::vector<event> out;
+    for (const auto& r : rings) {
+        const uint64_t end = r->head.load(std::memory_order_acquire);
+        const uint64_t begin = end > N ? end - N : 0;
+        std::vector<event> mine;
+        for (uint64_t i = begin; i < end; i++) {
+            const _trace_utils::slot& s = r->slots[i & (N - 1)];
+            mine.push_back({s.name.load(std::memory_order_relaxed), r->tid,
+                            s.is_counter.load(std::memory_order_relaxed),
+                            s.ts.load(std::memory_order_relaxed),
+                            s.value.load(std::memory_order_relaxed)});
+        }
+        // the slot of index i is rewritten by the event of index i + N
+        const uint64_t after = r->head.load(std::memory_order_acquire);
+        const uint64_t valid = after >= N ? after - N + 1 : 0;
+        for (uint64_t i = begin; i < end; i++) {
+            if (i >= valid) {
+                out.push_back(mine[i - begin]);
+            }
+        }
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const event& a, const event& b) { return a.ts_ns < b.ts_ns; });
+    return out;
+}
+
+/**
+ * @brief clear function
+ * Drops the events of every thread. Threads that record meanwhile may keep some.
+ */
+inline void clear() {
+    _trace_utils::registry& r = _trace_utils::registry::get();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for (const auto& ring : r.rings) {
+        ring->head.store(0, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief chrome_json function
+ * @return nlohmann::json: the events in the trace event format of chrome://tracing and
+ * Perfetto, the spans as complete events and the counters as counter events
+ */
+inline nlohmann::json chrome_json() {
+    nlohmann::json trace = nlohmann::json::array();
+    for (const event& e : events()) {
+        nlohmann::json j = {{"name", e.name}, {"pid", 1}, {"tid", e.tid},
+                            {"ts", double(e.ts_ns) / 1e3}};
+        if (e.is_counter) {
+            j["ph"] = "C";
+            j["args"] = {{e.name, e.value}};
+        } else {
+            j["ph"] = "X";
+            j["dur"] = double(e.value) / 1e3;
+        }
+        trace.push_back(std::move(j));
+    }
+    return nlohmann::json{{"traceEvents", trace}, {"displayTimeUnit", "ns"}};
+}
+
+/**
+ * @brief write_chrome_json function
+ * @param path the file to write chrome_json() to. Throws std::runtime_error if it can not be
+ * opened.
+ */
+inline void write_chrome_json(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("write_chrome_json: can not open " + path);
+    }
+    file << chrome_json().dump();
+}
+} // namespace TRACE
+
+#endif
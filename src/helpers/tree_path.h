@@ -0,0 +1,179 @@
+#ifndef TREE_PATH_H
+#define TREE_PATH_H
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#endif
+
+/**
+ * @brief tree path class
+ * The path from the root of a binary tree to one of its nodes, the state of the lazy
+ * inorder iterators of the trees. Stepping to the next or the previous node costs O(1)
+ * amortized and only looks at the left and right pointers of the nodes, so the trees
+ * need no parent pointers. The first Inline nodes of the path live inside the object,
+ * which covers every balanced tree that fits in memory, only deeper paths of degenerate
+ * trees spill to the heap.
+ * @tparam Node the type of the nodes, with left and right pointers.
+ * @tparam Inline the number of nodes stored without allocation. Default = 48
+ */
+template <typename Node, size_t Inline = 48> class tree_path {
+  public:
+    /**
+     * @brief Construct a new tree path object that points past the last node
+     * @param root: the root of the tree.
+     */
+    explicit tree_path(Node* root = nullptr) noexcept : _root(root) {}
+
+    tree_path(const tree_path& p) : _root(p._root), _spill(p._spill), _depth(p._depth) {
+        std::copy(p._inline, p._inline + std::min(_depth, Inline), _inline);
+    }
+
+    tree_path& operator=(const tree_path& p) {
+        if (this != &p) {
+            _root = p._root;
+            _spill = p._spill;
+            _depth = p._depth;
+            std::copy(p._inline, p._inline + std::min(_depth, Inline), _inline);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief first function
+     * Points the path to the leftmost node, or past the end if the tree is empty.
+     */
+    void first() {
+        _depth = 0;
+        _spill.clear();
+        if (_root != nullptr) {
+            _push(_root);
+            _descend(&Node::left);
+        }
+    }
+
+    /**
+     * @brief last function
+     * Points the path to the rightmost node, or past the end if the tree is empty.
+     */
+    void last() {
+        _depth = 0;
+        _spill.clear();
+        if (_root != nullptr) {
+            _push(_root);
+            _descend(&Node::right);
+        }
+    }
+
+    /**
+     * @brief seek function
+     * Points the path to the first node in inorder for which pred holds, or past the end
+     * if there is none, in O(height). pred must be false on a prefix of the inorder and
+     * true on the rest, like !(n->info < key) for a lower bound.
+     * @param pred: pred(n) for the nodes of the search path.
+     */
+    template <typename Pred> void seek(Pred pred) {
+        _depth = 0;
+        _spill.clear();
+        size_t found = 0;
+        for (Node* n = _root; n != nullptr;) {
+            _push(n);
+            if (pred(static_cast<const Node*>(n))) {
+                found = _depth;
+                n = n->left;
+            } else {
+                n = n->right;
+            }
+        }
+        _truncate(found);
+    }
+
+    /**
+     * @brief next function
+     * Steps to the inorder successor, past the last node the path is empty. Stepping
+     * from past the end does nothing.
+     */
+    void next() { _step(&Node::right, &Node::left, true); }
+
+    /**
+     * @brief prev function
+     * Steps to the inorder predecessor, from past the end to the last node. Stepping
+     * from the first node does nothing.
+     */
+    void prev() {
+        if (_depth == 0) {
+            last();
+            return;
+        }
+        _step(&Node::left, &Node::right, false);
+    }
+
+    /**
+     * @brief node function
+     * @return Node* the node the path points to, nullptr past the end.
+     */
+    Node* node() const noexcept { return _depth == 0 ? nullptr : _at(_depth - 1); }
+
+    /**
+     * @brief operator == for tree path class
+     * @return true if both paths point to the same node.
+     */
+    bool operator==(const tree_path& p) const noexcept { return node() == p.node(); }
+
+    bool operator!=(const tree_path& p) const noexcept { return node() != p.node(); }
+
+  private:
+    Node* _root;
+    Node* _inline[Inline];
+    std::vector<Node*> _spill;
+    size_t _depth{0};
+
+    Node* _at(size_t i) const noexcept { return i < Inline ? _inline[i] : _spill[i - Inline]; }
+
+    void _push(Node* n) {
+        if (_depth < Inline) {
+            _inline[_depth] = n;
+        } else {
+            _spill.push_back(n);
+        }
+        _depth++;
+    }
+
+    void _truncate(size_t depth) {
+        _depth = depth;
+        _spill.resize(depth > Inline ? depth - Inline : 0);
+    }
+
+    void _descend(Node* Node::*side) {
+        for (Node* n = _at(_depth - 1)->*side; n != nullptr; n = n->*side) {
+            _push(n);
+        }
+    }
+
+    // down one step to the `down` side and all the way to the other side, or up to the
+    // first ancestor that was reached from its `up` child. Without one the path moves
+    // past the end if to_end is set and stays where it is otherwise
+    void _step(Node* Node::*down, Node* Node::*up, bool to_end) {
+        if (_depth == 0) {
+            return;
+        }
+        Node* cur = _at(_depth - 1);
+        if (cur->*down != nullptr) {
+            _push(cur->*down);
+            _descend(up);
+            return;
+        }
+        for (size_t i = _depth - 1; i > 0; i--) {
+            if (_at(i - 1)->*up == _at(i)) {
+                _truncate(i);
+                return;
+            }
+        }
+        if (to_end) {
+            _truncate(0);
+        }
+    }
+};
+
+#endif
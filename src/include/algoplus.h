@@ -7,55 +7,108 @@
 #include "../algorithms/dynamic_programming/knapsack_2d.h"
 #include "../algorithms/dynamic_programming/lcs.h"
 #include "../algorithms/dynamic_programming/lis.h"
+#include "../algorithms/dynamic_programming/sequence_alignment.h"
+#include "../algorithms/dynamic_programming/wavefront.h"
+
+#include "../algorithms/geometry/convex_hull.h"
+
+#include "../algorithms/math/big_uint.h"
+#include "../algorithms/math/multiply.h"
 
 #include "../algorithms/number_theory/eratosthenes_sieve.h"
+#include "../algorithms/number_theory/factorization.h"
 #include "../algorithms/number_theory/gcd.h"
 #include "../algorithms/number_theory/mersenne_primes.h"
+#include "../algorithms/number_theory/montgomery.h"
 
+#include "../algorithms/searching/batch_search.h"
 #include "../algorithms/searching/bfs.h"
 #include "../algorithms/searching/binary_search.h"
 #include "../algorithms/searching/dfs.h"
 #include "../algorithms/searching/exponential_search.h"
+#include "../algorithms/searching/graph_search.h"
 #include "../algorithms/searching/interpolation_search.h"
 #include "../algorithms/searching/jump_search.h"
+#include "../algorithms/searching/learned_index.h"
 #include "../algorithms/searching/linear_search.h"
 #include "../algorithms/searching/ternary_search.h"
 
 #include "../algorithms/sorting/bubble_sort.h"
 #include "../algorithms/sorting/bucket_sort.h"
 #include "../algorithms/sorting/counting_sort.h"
+#include "../algorithms/sorting/external_sort.h"
 #include "../algorithms/sorting/heap_sort.h"
 #include "../algorithms/sorting/insertion_sort.h"
 #include "../algorithms/sorting/merge_sort.h"
 #include "../algorithms/sorting/quick_sort.h"
 #include "../algorithms/sorting/radix_sort.h"
+#include "../algorithms/sorting/selection.h"
 #include "../algorithms/sorting/selection_sort.h"
+#include "../algorithms/sorting/sorting_network.h"
 
 #include "../algorithms/string/edit_distance.h"
 #include "../algorithms/string/find_and_replace.h"
 #include "../algorithms/string/kmp.h"
+#include "../algorithms/string/palindrome.h"
 #include "../algorithms/string/rabin_karp.h"
+#include "../algorithms/string/string_hashing.h"
+#include "../algorithms/string/substring_search.h"
+#include "../algorithms/string/suffix_array.h"
 
+#include "../classes/cache/cache.h"
+#include "../classes/cache/sharded_cache.h"
+#include "../classes/disjoint_set/concurrent_disjoint_set.h"
 #include "../classes/disjoint_set/disjoint_set.h"
 #include "../classes/graph/graph.h"
+#include "../classes/hash_table/bloom_filter.h"
+#include "../classes/hash_table/cuckoo_filter.h"
 #include "../classes/hash_table/hash_table.h"
+#include "../classes/hash_table/static_map.h"
+#include "../classes/heap/d_ary_heap.h"
+#include "../classes/heap/indexed_heap.h"
 #include "../classes/heap/min_heap.h"
+#include "../classes/heap/multi_queue.h"
+#include "../classes/heap/pairing_heap.h"
+#include "../classes/heap/radix_heap.h"
 
 #include "../classes/list/circular_linked_list.h"
+#include "../classes/list/concurrent_skip_list.h"
 #include "../classes/list/doubly_linked_list.h"
 #include "../classes/list/frequency_list.h"
+#include "../classes/list/intrusive_list.h"
 #include "../classes/list/linked_list.h"
 #include "../classes/list/skip_list.h"
+#include "../classes/list/unrolled_linked_list.h"
 
 #include "../classes/queue/dequeue_list.h"
+#include "../classes/queue/ring_buffer.h"
+
+#include "../classes/sketch/count_min_sketch.h"
+#include "../classes/sketch/hyperloglog.h"
+#include "../classes/sketch/space_saving.h"
+
+#include "../classes/spatial/grid_index.h"
+#include "../classes/spatial/kd_tree.h"
+
 #include "../classes/stack/stack_list.h"
 
 #include "../classes/tree/234_tree.h"
+#include "../classes/tree/aho_corasick.h"
 #include "../classes/tree/avl_tree.h"
+#include "../classes/tree/b_plus_tree.h"
 #include "../classes/tree/bst.h"
+#include "../classes/tree/concurrent_red_black_tree.h"
+#include "../classes/tree/double_array_trie.h"
+#include "../classes/tree/flat_tree.h"
+#include "../classes/tree/frozen_set.h"
 #include "../classes/tree/interval_tree.h"
+#include "../classes/tree/lazy_segment_tree.h"
+#include "../classes/tree/persistent_segment_tree.h"
+#include "../classes/tree/radix_trie.h"
 #include "../classes/tree/red_black_tree.h"
+#include "../classes/tree/rope.h"
 #include "../classes/tree/splay_tree.h"
+#include "../classes/tree/static_interval_index.h"
 #include "../classes/tree/tree.h"
 #include "../classes/tree/trie.h"
 
@@ -0,0 +1,496 @@
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include "mat_view.h"
+#include "matmul.h"
+#include "matrix.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+namespace _decomposition_utils {
+// the width of the panels of the blocked factorizations: the panel is factored by row
+// operations while it stays in cache, the rest of the matrix is updated by one GEMM
+constexpr size_t block = 64;
+
+/**
+ * @brief c -= a b on blocks of a matrix, through contiguous copies so that the product is
+ * the blocked GEMM of matmul
+ */
+template <typename T>
+void subtract_product(mat_view<const T> a, mat_view<const T> b, mat_view<T> c, size_t threads) {
+    if (c.rows() == 0 || c.cols() == 0 || a.cols() == 0) {
+        return;
+    }
+    auto copy = [](mat_view<const T> v) {
+        Matrix<T> m(v.rows(), v.cols());
+        for (size_t i = 0; i < v.rows(); i++) {
+            std::copy(v.row(i).begin(), v.row(i).end(), m.data() + i * v.cols());
+        }
+        return m;
+    };
+    Matrix<T> product = matmul(copy(a), copy(b), threads);
+    for (size_t i = 0; i < c.rows(); i++) {
+        T* out = &c(i, 0);
+        const T* in = product.data() + i * c.cols();
+        for (size_t j = 0; j < c.cols(); j++) {
+            out[j] -= in[j];
+        }
+    }
+}
+
+/**
+ * @brief solves L x = b in place for a lower triangular n x n L, on the diagonal or with a
+ * unit diagonal
+ */
+template <typename T> void forward(const Matrix<T>& l, std::span<T> x, bool unit) {
+    for (size_t i = 0; i < l.rows(); i++) {
+        const T* row = l.data() + i * l.cols();
+        T sum = x[i];
+        for (size_t j = 0; j < i; j++) {
+            sum -= row[j] * x[j];
+        }
+        x[i] = unit ? sum : sum / row[i];
+    }
+}
+
+/**
+ * @brief solves U x = b in place for the upper triangle of the first n rows of u
+ */
+template <typename T> void backward(const Matrix<T>& u, std::span<T> x, size_t n) {
+    for (size_t i = n; i-- > 0;) {
+        const T* row = u.data() + i * u.cols();
+        T sum = x[i];
+        for (size_t j = i + 1; j < n; j++) {
+            sum -= row[j] * x[j];
+        }
+        x[i] = sum / row[i];
+    }
+}
+
+/**
+ * @brief applies solve to every column of b
+ */
+template <typename T, typename F> Matrix<T> by_columns(const Matrix<T>& b, F&& solve) {
+    Matrix<T> x(b.rows(), b.cols());
+    std::vector<T> column(b.rows());
+    for (size_t j = 0; j < b.cols(); j++) {
+        std::copy(b.col(j).begin(), b.col(j).end(), column.begin());
+        std::vector<T> y = solve(std::span<const T>(column));
+        std::copy(y.begin(), y.end(), x.col(j).begin());
+    }
+    return x;
+}
+} // namespace _decomposition_utils
+
+/**
+ * @brief lu decomposition class
+ * P A = L U with partial pivoting, L unit lower triangular and U upper triangular, both
+ * kept in one matrix. It is blocked like LAPACK's getrf: a panel of 64 columns is factored
+ * with row operations, the rows to its right are solved against it and the rest of the
+ * matrix gets one GEMM update, so most of the O(n^3) work runs in the GEMM kernel. Rows are
+ * contiguous, so a pivot swaps two whole rows.
+ * @tparam T the type of the elements, float or double
+ */
+template <typename T> class lu_decomposition {
+  public:
+    /**
+     * @brief Construct a new lu decomposition object
+     * @param a the square matrix
+     * @param threads number of threads of the GEMM updates(0 means every hardware thread).
+     * Default = 1
+     * Throws std::invalid_argument if a is not square.
+     */
+    explicit lu_decomposition(Matrix<T> a, size_t threads = 1)
+        : _lu(std::move(a)), _perm(_lu.rows()) {
+        if (_lu.rows() != _lu.cols()) {
+            throw std::invalid_argument("lu_decomposition: the matrix must be square");
+        }
+        std::iota(_perm.begin(), _perm.end(), size_t(0));
+        const size_t n = _lu.rows();
+        for (size_t k = 0; k < n; k += _decomposition_utils::block) {
+            size_t kb = std::min(_decomposition_utils::block, n - k), end = k + kb;
+            _panel(k, end);
+            // U12 = L11^-1 A12
+            for (size_t j = k; j < end; j++) {
+                const T* pivot_row = _lu.data() + j * n;
+                for (size_t i = j + 1; i < end; i++) {
+                    T* row = _lu.data() + i * n;
+                    const T l = row[j];
+                    for (size_t c = end; c < n; c++) {
+                        row[c] -= l * pivot_row[c];
+                    }
+                }
+            }
+            // A22 -= L21 U12
+            _decomposition_utils::subtract_product<T>(
+                std::as_const(_lu).submatrix(end, k, n - end, kb),
+                std::as_const(_lu).submatrix(k, end, kb, n - end),
+                _lu.submatrix(end, end, n - end, n - end), threads);
+        }
+    }
+
+    /**
+     * @brief factors function
+     * @return const Matrix<T>& L below the diagonal(its unit diagonal is not stored) and U
+     * on and above it.
+     */
+    const Matrix<T>& factors() const { return _lu; }
+
+    /**
+     * @brief permutation function
+     * @return std::span<const size_t> row i of P A is row permutation()[i] of A.
+     */
+    std::span<const size_t> permutation() const { return _perm; }
+
+    /**
+     * @brief singular function
+     * @return true if a pivot is zero, the matrix has no inverse.
+     */
+    bool singular() const { return _singular; }
+
+    /**
+     * @brief determinant function
+     * @return T the determinant of A.
+     */
+    T determinant() const {
+        T det = _swaps % 2 ? T(-1) : T(1);
+        for (size_t i = 0; i < _lu.rows(); i++) {
+            det *= _lu(i, i);
+        }
+        return det;
+    }
+
+    /**
+     * @brief solve function
+     * @param b the right hand side, of size n
+     * @return std::vector<T> the x with A x = b. Throws std::invalid_argument if the size
+     * of b is not n, std::runtime_error if A is singular.
+     */
+    std::vector<T> solve(std::span<const T> b) const {
+        if (b.size() != _lu.rows()) {
+            throw std::invalid_argument("lu_decomposition: the size of b must be n");
+        }
+        if (_singular) {
+            throw std::runtime_error("lu_decomposition: the matrix is singular");
+        }
+        std::vector<T> x(b.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            x[i] = b[_perm[i]];
+        }
+        _decomposition_utils::forward(_lu, std::span<T>(x), true);
+        _decomposition_utils::backward(_lu, std::span<T>(x), x.size());
+        return x;
+    }
+
+    /**
+     * @brief solve function for several right hand sides
+     * @param b the right hand sides, n x k
+     * @return Matrix<T> the X with A X = b.
+     */
+    Matrix<T> solve(const Matrix<T>& b) const {
+        return _decomposition_utils::by_columns(b, [&](std::span<const T> c) { return solve(c); });
+    }
+
+  private:
+    Matrix<T> _lu;
+    std::vector<size_t> _perm;
+    size_t _swaps{0};
+    bool _singular{false};
+
+    // factors the columns [k, end) of the rows [k, n) with partial pivoting
+    void _panel(size_t k, size_t end) {
+        const size_t n = _lu.rows();
+        for (size_t j = k; j < end; j++) {
+            size_t p = j;
+            for (size_t i = j + 1; i < n; i++) {
+                if (std::abs(_lu(i, j)) > std::abs(_lu(p, j))) {
+                    p = i;
+                }
+            }
+            if (p != j) {
+                std::swap_ranges(_lu.row(p).begin(), _lu.row(p).end(), _lu.row(j).begin());
+                std::swap(_perm[p], _perm[j]);
+                _swaps++;
+            }
+            const T pivot = _lu(j, j);
+            if (pivot == T(0)) {
+                _singular = true;
+                continue;
+            }
+            const T* pivot_row = _lu.data() + j * n;
+            for (size_t i = j + 1; i < n; i++) {
+                T* row = _lu.data() + i * n;
+                const T l = row[j] /= pivot;
+                for (size_t c = j + 1; c < end; c++) {
+                    row[c] -= l * pivot_row[c];
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief cholesky decomposition class
+ * A = L L^T for a symmetric positive definite A, L lower triangular. Blocked like
+ * LAPACK's potrf: the columns of a panel of 64 are computed with dot products of
+ * contiguous rows, and the part of the matrix below and to the right of it gets one GEMM
+ * update. Only the lower triangle of A is read. It costs half of an LU and needs no
+ * pivoting, the natural solver of the normal equations.
+ * @tparam T the type of the elements, float or double
+ */
+template <typename T> class cholesky_decomposition {
+  public:
+    /**
+     * @brief Construct a new cholesky decomposition object
+     * @param a the symmetric positive definite matrix
+     * @param threads number of threads of the GEMM updates(0 means every hardware thread).
+     * Default = 1
+     * Throws std::invalid_argument if a is not square, std::runtime_error if it is not
+     * positive definite.
+     */
+    explicit cholesky_decomposition(Matrix<T> a, size_t threads = 1) : _l(std::move(a)) {
+        if (_l.rows() != _l.cols()) {
+            throw std::invalid_argument("cholesky_decomposition: the matrix must be square");
+        }
+        const size_t n = _l.rows();
+        for (size_t k = 0; k < n; k += _decomposition_utils::block) {
+            size_t kb = std::min(_decomposition_utils::block, n - k), end = k + kb;
+            for (size_t j = k; j < end; j++) {
+                T* row_j = _l.data() + j * n;
+                T d = row_j[j];
+                for (size_t c = k; c < j; c++) {
+                    d -= row_j[c] * row_j[c];
+                }
+                if (!(d > T(0))) {
+                    throw std::runtime_error(
+                        "cholesky_decomposition: the matrix is not positive definite");
+                }
+                row_j[j] = std::sqrt(d);
+                for (size_t i = j + 1; i < n; i++) {
+                    T* row_i = _l.data() + i * n;
+                    T s = row_i[j];
+                    for (size_t c = k; c < j; c++) {
+                        s -= row_i[c] * row_j[c];
+                    }
+                    row_i[j] = s / row_j[j];
+                }
+            }
+            // A22 -= L21 L21^T
+            Matrix<T> l21t(kb, n - end);
+            for (size_t i = end; i < n; i++) {
+                for (size_t c = k; c < end; c++) {
+                    l21t(c - k, i - end) = _l(i, c);
+                }
+            }
+            _decomposition_utils::subtract_product<T>(
+                std::as_const(_l).submatrix(end, k, n - end, kb), std::as_const(l21t).view(),
+                _l.submatrix(end, end, n - end, n - end), threads);
+        }
+        for (size_t i = 0; i < n; i++) {
+            std::fill(_l.data() + i * n + i + 1, _l.data() + (i + 1) * n, T(0));
+        }
+    }
+
+    /**
+     * @brief factor function
+     * @return const Matrix<T>& L, zero above the diagonal.
+     */
+    const Matrix<T>& factor() const { return _l; }
+
+    /**
+     * @brief solve function
+     * @param b the right hand side, of size n
+     * @return std::vector<T> the x with A x = b. Throws std::invalid_argument if the size
+     * of b is not n.
+     */
+    std::vector<T> solve(std::span<const T> b) const {
+        if (b.size() != _l.rows()) {
+            throw std::invalid_argument("cholesky_decomposition: the size of b must be n");
+        }
+        std::vector<T> x(b.begin(), b.end());
+        _decomposition_utils::forward(_l, std::span<T>(x), false);
+        // L^T x = y, by columns of L
+        for (size_t i = x.size(); i-- > 0;) {
+            x[i] /= _l(i, i);
+            for (size_t j = 0; j < i; j++) {
+                x[j] -= _l(i, j) * x[i];
+            }
+        }
+        return x;
+    }
+
+    /**
+     * @brief solve function for several right hand sides
+     * @param b the right hand sides, n x k
+     * @return Matrix<T> the X with A X = b.
+     */
+    Matrix<T> solve(const Matrix<T>& b) const {
+        return _decomposition_utils::by_columns(b, [&](std::span<const T> c) { return solve(c); });
+    }
+
+  private:
+    Matrix<T> _l;
+};
+
+/**
+ * @brief qr decomposition class
+ * A = Q R with Householder reflections for an m x n A, m >= n: R is n x n upper triangular
+ * and Q has orthonormal columns, kept as the reflectors below the diagonal. A reflector is
+ * applied to the columns to its right with two passes over contiguous rows. Its least
+ * squares solution does not square the condition number of A as the normal equations do,
+ * which is what high degree polynomial fits need.
+ * @tparam T the type of the elements, float or double
+ */
+template <typename T> class qr_decomposition {
+  public:
+    /**
+     * @brief Construct a new qr decomposition object
+     * @param a the m x n matrix, m >= n
+     * Throws std::invalid_argument if a has fewer rows than columns.
+     */
+    explicit qr_decomposition(Matrix<T> a) : _qr(std::move(a)), _tau(_qr.cols(), T(0)) {
+        if (_qr.rows() < _qr.cols()) {
+            throw std::invalid_argument("qr_decomposition: the matrix needs rows >= cols");
+        }
+        const size_t m = _qr.rows(), n = _qr.cols();
+        std::vector<T> w(n);
+        for (size_t j = 0; j < n; j++) {
+            T x0 = _qr(j, j), tail = T(0);
+            for (size_t i = j + 1; i < m; i++) {
+                tail += _qr(i, j) * _qr(i, j);
+            }
+            if (tail == T(0)) {
+                continue;
+            }
+            T beta = std::sqrt(x0 * x0 + tail);
+            beta = x0 >= T(0) ? -beta : beta;
+            _tau[j] = (beta - x0) / beta;
+            const T scale = T(1) / (x0 - beta);
+            for (size_t i = j + 1; i < m; i++) {
+                _qr(i, j) *= scale;
+            }
+            _qr(j, j) = beta;
+            // A(j:, j+1:) -= tau v (v^T A(j:, j+1:)), v = (1, A(j+1:, j))
+            std::fill(w.begin() + j + 1, w.end(), T(0));
+            for (size_t i = j; i < m; i++) {
+                const T* row = _qr.data() + i * n;
+                const T v = i == j ? T(1) : row[j];
+                for (size_t c = j + 1; c < n; c++) {
+                    w[c] += v * row[c];
+                }
+            }
+            for (size_t i = j; i < m; i++) {
+                T* row = _qr.data() + i * n;
+                const T v = (i == j ? T(1) : row[j]) * _tau[j];
+                for (size_t c = j + 1; c < n; c++) {
+                    row[c] -= v * w[c];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief factors function
+     * @return const Matrix<T>& R on and above the diagonal, the reflectors(their first
+     * element, 1, is not stored) below it.
+     */
+    const Matrix<T>& factors() const { return _qr; }
+
+    /**
+     * @brief r function
+     * @return Matrix<T> the n x n upper triangular R.
+     */
+    Matrix<T> r() const {
+        const size_t n = _qr.cols();
+        Matrix<T> r(n, n);
+        for (size_t i = 0; i < n; i++) {
+            std::copy(_qr.data() + i * n + i, _qr.data() + (i + 1) * n, r.data() + i * n + i);
+        }
+        return r;
+    }
+
+    /**
+     * @brief q function
+     * @return Matrix<T> the m x n Q with orthonormal columns.
+     */
+    Matrix<T> q() const {
+        const size_t m = _qr.rows(), n = _qr.cols();
+        Matrix<T> q(m, n);
+        std::vector<T> e(m);
+        for (size_t j = 0; j < n; j++) {
+            std::fill(e.begin(), e.end(), T(0));
+            e[j] = T(1);
+            // Q e_j = H_0 ... H_(n-1) e_j
+            for (size_t k = n; k-- > 0;) {
+                _reflect(k, std::span<T>(e));
+            }
+            std::copy(e.begin(), e.end(), q.col(j).begin());
+        }
+        return q;
+    }
+
+    /**
+     * @brief solve function, the least squares solution
+     * @param b the right hand side, of size m
+     * @return std::vector<T> the x of size n that minimizes |A x - b|. Throws
+     * std::invalid_argument if the size of b is not m, std::runtime_error if A does not
+     * have full column rank(up to m times the rounding error of its largest diagonal).
+     */
+    std::vector<T> solve(std::span<const T> b) const {
+        const size_t n = _qr.cols();
+        if (b.size() != _qr.rows()) {
+            throw std::invalid_argument("qr_decomposition: the size of b must be m");
+        }
+        // a diagonal element of R at rounding level of the largest one is a zero
+        T largest = T(0);
+        for (size_t i = 0; i < n; i++) {
+            largest = std::max(largest, std::abs(_qr(i, i)));
+        }
+        const T tolerance = largest * std::numeric_limits<T>::epsilon() * T(_qr.rows());
+        for (size_t i = 0; i < n; i++) {
+            if (!(std::abs(_qr(i, i)) > tolerance)) {
+                throw std::runtime_error("qr_decomposition: the matrix is rank deficient");
+            }
+        }
+        std::vector<T> x(b.begin(), b.end());
+        // Q^T b = H_(n-1) ... H_0 b
+        for (size_t k = 0; k < n; k++) {
+            _reflect(k, std::span<T>(x));
+        }
+        _decomposition_utils::backward(_qr, std::span<T>(x), n);
+        x.resize(n);
+        return x;
+    }
+
+  private:
+    Matrix<T> _qr;
+    std::vector<T> _tau;
+
+    // x = H_k x = x - tau_k v_k (v_k^T x)
+    void _reflect(size_t k, std::span<T> x) const {
+        if (_tau[k] == T(0)) {
+            return;
+        }
+        T s = x[k];
+        for (size_t i = k + 1; i < x.size(); i++) {
+            s += _qr(i, k) * x[i];
+        }
+        s *= _tau[k];
+        x[k] -= s;
+        for (size_t i = k + 1; i < x.size(); i++) {
+            x[i] -= s * _qr(i, k);
+        }
+    }
+};
+
+#endif
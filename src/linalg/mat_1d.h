@@ -1,6 +1,8 @@
 #ifndef MAT_1D_H
 #define MAT_1D_H
 
+#include "mat_expr.h"
+
 #ifdef __cplusplus
 #include <cassert>
 #include <climits>
@@ -14,29 +16,38 @@
 
 /**
  *@brief Class for 1-dimensional Matrix
- *
+ * The elements are inline and aligned up to 4KB, on the heap and aligned to a cache line
+ * above. The arithmetic operators build expressions that are evaluated in one pass when
+ * they are assigned to a matrix, with AVX2 or NEON kernels for float and double, e.g.
+ * a = b + c * 2 reads b and c once and creates no temporary. An expression keeps
+ * references to the matrices in it, so it must be assigned before they go away.
  */
 template <typename T, size_t SIZE> class Mat1d {
   private:
-    T* arr;
-    size_t _size;
+    _mat_utils::storage<T, SIZE> arr;
+    static constexpr size_t _size = SIZE;
 
   public:
+    using value_type = T;
+    static constexpr size_t expr_dims = 1;
+    static constexpr size_t expr_rows = 1;
+    static constexpr size_t expr_cols = SIZE;
+    static constexpr bool is_mat_expr = true;
+    static constexpr bool is_mat_leaf = true;
+    static constexpr bool is_mat_scalar = false;
+
     /**
      *@brief constructor for Mat1d class
      *
      */
-    explicit Mat1d(std::vector<T> v = {}) : _size(SIZE) {
-        arr = new T[_size];
+    explicit Mat1d(std::vector<T> v = {}) {
         if (!v.empty()) {
             try {
                 if (v.size() != _size) {
                     throw std::logic_error("Initializer array don't have the same size "
                                            "as the constructed array");
                 } else {
-                    for (size_t i = 0; i < _size; i++) {
-                        arr[i] = v[i];
-                    }
+                    std::copy(v.begin(), v.end(), data());
                 }
             } catch (std::logic_error& e) {
                 std::cerr << e.what() << '\n';
@@ -48,66 +59,120 @@ template <typename T, size_t SIZE> class Mat1d {
      *@brief constructor for Mat1d class with initializer list
      *@param il the initializer list that we want to use to initialize the array
      */
-    explicit Mat1d(std::initializer_list<T> il) : _size(SIZE) {
-        arr = new T[_size];
+    explicit Mat1d(std::initializer_list<T> il) {
         if (il.size() != _size) {
             throw std::logic_error("Initializer list doesn't have the same size as "
                                    "the constructed array");
         }
-        std::copy(il.begin(), il.end(), arr);
+        std::copy(il.begin(), il.end(), data());
     }
 
     /**
      *@brief constructor for Mat1d class with input value
      *@param val the value that we want all the elements of the array to have
      */
-    explicit Mat1d(const T val) noexcept : _size(SIZE) {
-        arr = new T[_size];
-        for (size_t i = 0; i < _size; ++i) {
-            arr[i] = val;
-        }
+    explicit Mat1d(const T val) noexcept {
+        std::fill(data(), data() + _size, val);
     }
 
     /**
      *@brief copy constructor for Mat1d class
      *@param mat the matrix we want to copy
-     *@return Mat1d
      */
-    explicit Mat1d(Mat1d& mat) : _size(SIZE) {
-        try {
-            if (mat.size() != _size) {
-                throw std::logic_error("Tried to copy matrices with different sizes");
-            }
-            this->arr = new T[_size];
-            for (size_t i = 0; i < _size; i++) {
-                this->arr[i] = mat.arr[i];
-            }
-        } catch (std::logic_error& e) {
-            std::cerr << e.what() << '\n';
-        }
+    Mat1d(const Mat1d& mat) = default;
+
+    /**
+     *@brief move constructor for Mat1d class, O(1) for the matrices on the heap
+     *@param mat the matrix we want to move
+     */
+    Mat1d(Mat1d&& mat) noexcept = default;
+
+    /**
+     *@brief constructor for Mat1d class from an expression
+     *@param e the expression, evaluated in one pass
+     */
+    template <typename E>
+        requires(_mat_utils::same_shape<E, Mat1d> && !E::is_mat_leaf)
+    Mat1d(const E& e) {
+        _mat_utils::assign(data(), e);
     }
 
     /**
-     *@brief copy constructor for Mat1d class
+     *@brief operator = for Mat1d class
      *@param mat the matrix we want to copy
      *@return Mat1d&
      */
-    Mat1d& operator=(Mat1d& mat) {
-        if (this == &mat) {
-            return *(this);
-        }
-        assert(mat.size() == this->_size);
-        for (size_t i = 0; i < _size; i++) {
-            this->arr[i] = mat.arr[i];
-        }
-        return *(this);
+    Mat1d& operator=(const Mat1d& mat) = default;
+
+    /**
+     *@brief move assignment for Mat1d class
+     *@param mat the matrix we want to move
+     *@return Mat1d&
+     */
+    Mat1d& operator=(Mat1d&& mat) noexcept = default;
+
+    /**
+     *@brief operator = for Mat1d class from an expression
+     *@param e the expression, evaluated in one pass, it may hold this matrix
+     *@return Mat1d&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Mat1d>
+    Mat1d& operator=(const E& e) {
+        _mat_utils::assign(data(), e);
+        return *this;
     }
 
     /**
-     *@brief destructor of Mat1d class
-     *
+     *@brief operator += for Mat1d class
+     *@param e a matrix or an expression of the same size
+     *@return Mat1d&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Mat1d>
+    Mat1d& operator+=(const E& e) {
+        _mat_utils::assign(data(), *this + e);
+        return *this;
+    }
+
+    /**
+     *@brief operator -= for Mat1d class
+     *@param e a matrix or an expression of the same size
+     *@return Mat1d&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Mat1d>
+    Mat1d& operator-=(const E& e) {
+        _mat_utils::assign(data(), *this - e);
+        return *this;
+    }
+
+    /**
+     *@brief operator *= for Mat1d class
+     *@param c the scalar
+     *@return Mat1d&
+     */
+    Mat1d& operator*=(const T& c) {
+        _mat_utils::assign(data(), *this * c);
+        return *this;
+    }
+
+    /**
+     *@brief data function
+     *@return T* the elements, aligned to at least 32 bytes
+     */
+    T* data() { return arr.data(); }
+    const T* data() const { return arr.data(); }
+
+    /**
+     *@brief eval function, the element i of the matrix as an expression
+     */
+    T eval(size_t i) const { return arr.data()[i]; }
+
+    /**
+     *@brief packet function, the elements [i, i + P::width) of the matrix as an expression
      */
-    ~Mat1d() { delete[] arr; }
+    template <typename P> P packet(size_t i) const { return P::load(arr.data() + i); }
 
     /**
      *@brief size function
@@ -116,19 +181,30 @@ template <typename T, size_t SIZE> class Mat1d {
      */
     size_t size() const { return this->_size; }
 
+    /**
+     *@brief memory_usage function
+     *@return MEMORY::footprint the elements, inline or on the heap above inline_bytes, and the
+     *padding of their alignment
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = arr.memory_usage();
+        f.control += sizeof(*this) - sizeof(arr);
+        return f;
+    }
+
     /**
      *@brief Iterator begin for Mat1d class
      *
      */
     typedef T* iterator;
-    T* begin() { return &arr[0]; }
+    T* begin() { return data(); }
     // Iterator begin() { return Iterator(0, _size, arr); }
 
     /**
      *@brief Iterator end for Mat1d class
      *
      */
-    T* end() { return &arr[0] + SIZE; }
+    T* end() { return data() + SIZE; }
     // Iterator end() { return Iterator(_size, _size, arr); }
 
     /**
@@ -137,7 +213,16 @@ template <typename T, size_t SIZE> class Mat1d {
      */
     T& operator[](const size_t index) {
         assert(index < _size);
-        return arr[index];
+        return data()[index];
+    }
+
+    /**
+     *@brief operator[] for Mat1d class
+     *@return const T& the value of the array to that index
+     */
+    const T& operator[](const size_t index) const {
+        assert(index < _size);
+        return data()[index];
     }
 
     /**
@@ -152,7 +237,7 @@ template <typename T, size_t SIZE> class Mat1d {
         }
 
         for (size_t i = 0; i < _size; i++) {
-            if (mat.arr[i] != this->arr[i]) {
+            if (mat[i] != (*this)[i]) {
                 return false;
             }
         }
@@ -175,7 +260,7 @@ template <typename T, size_t SIZE> class Mat1d {
     friend std::ostream& operator<<(std::ostream& out, const Mat1d& mat) {
         out << '[';
         for (size_t i = 0; i < mat.size(); i++) {
-            out << mat.arr[i];
+            out << mat[i];
             if (i != mat.size() - 1) {
                 out << " ";
             }
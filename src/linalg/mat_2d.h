@@ -1,33 +1,47 @@
 #ifndef MAT_2D_H
 #define MAT_2D_H
 
+#include "mat_1d.h"
+#include "mat_view.h"
+
 #ifdef __cplusplus
+#include <algorithm>
 #include <climits>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <vector>
-#include "mat_1d.h"
 #endif
 
 /**
  *@brief Class for 2-dimensional Matrix
- *
+ * The elements are kept in row major order, inline and aligned up to 4KB(a 4x4 or 8x8
+ * transform takes no allocation) and on the heap, aligned to a cache line, above. The
+ * arithmetic operators build expressions that are evaluated in one pass when they are
+ * assigned to a matrix, as for Mat1d.
  */
 
 template <typename T, size_t ROWS, size_t COLS> class Mat2d {
   private:
-    T* arr;
-    size_t _size;
-    size_t _cols;
-    size_t _rows;
-    Mat1d<T, COLS> mat;
+    _mat_utils::storage<T, ROWS * COLS> arr;
+    static constexpr size_t _size = ROWS * COLS;
+    static constexpr size_t _cols = COLS;
+    static constexpr size_t _rows = ROWS;
 
   public:
+    using value_type = T;
+    static constexpr size_t expr_dims = 2;
+    static constexpr size_t expr_rows = ROWS;
+    static constexpr size_t expr_cols = COLS;
+    static constexpr bool is_mat_expr = true;
+    static constexpr bool is_mat_leaf = true;
+    static constexpr bool is_mat_scalar = false;
+
     /**
      *@brief constructor for Mat2d class
      *
      */
-    explicit Mat2d(std::vector<std::vector<T>> v = {})
-        : arr(new T[ROWS * COLS]), _cols(COLS), _rows(ROWS), _size(ROWS * COLS) {
+    explicit Mat2d(std::vector<std::vector<T>> v = {}) {
 
         if (!v.empty()) {
             try {
@@ -37,7 +51,7 @@ template <typename T, size_t ROWS, size_t COLS> class Mat2d {
                 }
                 for (size_t i = 0; i < v.size(); i++) {
                     for (size_t j = 0; j < v[0].size(); j++) {
-                        arr[i * v[0].size() + j] = v[i][j];
+                        arr.data()[i * v[0].size() + j] = v[i][j];
                     }
                 }
             } catch (std::logic_error& e) {
@@ -46,35 +60,33 @@ template <typename T, size_t ROWS, size_t COLS> class Mat2d {
         }
     }
 
-    ~Mat2d() { delete[] arr; }
     /**
      *@brief constructor for Mat2d class with initializer value
      *@param val the value that we want all the index of the array to have
      */
-    explicit Mat2d(const T val) noexcept : _size(ROWS * COLS), _cols(COLS), _rows(ROWS) {
-        arr = new T[_size];
-        for (size_t i = 0; i < _size; i++) {
-            arr[i] = val;
-        }
-    }
+    explicit Mat2d(const T val) noexcept { std::fill(data(), data() + _size, val); }
 
     /**
      *@brief copy constructor for Mat2d class
      *@param mat the 2d matrix we want to copy
      *
      */
-    explicit Mat2d(const Mat2d& mat) : _size(ROWS * COLS), _cols(COLS), _rows(ROWS) {
-        try {
-            if (mat.size() != _size || mat.cols() != _cols || mat.rows() != _rows) {
-                throw std::logic_error("Tried to copy matrixes with different dimensions");
-            }
-            this->arr = new T[_size];
-            for (size_t i = 0; i < _size; i++) {
-                this->arr[i] = mat.arr[i];
-            }
-        } catch (std::logic_error& e) {
-            std::cerr << e.what() << '\n';
-        }
+    Mat2d(const Mat2d& mat) = default;
+
+    /**
+     *@brief move constructor for Mat2d class, O(1) for the matrices on the heap
+     *@param mat the 2d matrix we want to move
+     */
+    Mat2d(Mat2d&& mat) noexcept = default;
+
+    /**
+     *@brief constructor for Mat2d class from an expression
+     *@param e the expression, evaluated in one pass
+     */
+    template <typename E>
+        requires(_mat_utils::same_shape<E, Mat2d> && !E::is_mat_leaf)
+    Mat2d(const E& e) {
+        _mat_utils::assign(data(), e);
     }
 
     /**
@@ -82,51 +94,116 @@ template <typename T, size_t ROWS, size_t COLS> class Mat2d {
      *@param mat the matrix we want to copy
      *@return Mat2d&
      */
-    Mat2d& operator=(Mat2d& mat) {
-        if (this == &mat) {
-            return *(this);
-        }
-        try {
-            if (mat.size() != _size || mat.cols() != _cols || mat.rows() != _rows) {
-                throw std::logic_error("Tried to copy matrixes with different dimensions");
-            }
-            for (size_t i = 0; i < _size; i++) {
-                this->arr[i] = mat.arr[i];
-            }
-            return *(this);
-        } catch (std::logic_error& e) {
-            std::cerr << e.what() << '\n';
-        }
-        return *(this);
+    Mat2d& operator=(const Mat2d& mat) = default;
+
+    /**
+     *@brief move assignment for Mat2d class
+     *@param mat the matrix we want to move
+     *@return Mat2d&
+     */
+    Mat2d& operator=(Mat2d&& mat) noexcept = default;
+
+    /**
+     *@brief operator = for Mat2d class from an expression
+     *@param e the expression, evaluated in one pass, it may hold this matrix
+     *@return Mat2d&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Mat2d>
+    Mat2d& operator=(const E& e) {
+        _mat_utils::assign(data(), e);
+        return *this;
+    }
+
+    /**
+     *@brief operator += for Mat2d class
+     *@param e a matrix or an expression of the same shape
+     *@return Mat2d&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Mat2d>
+    Mat2d& operator+=(const E& e) {
+        _mat_utils::assign(data(), *this + e);
+        return *this;
+    }
+
+    /**
+     *@brief operator -= for Mat2d class
+     *@param e a matrix or an expression of the same shape
+     *@return Mat2d&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Mat2d>
+    Mat2d& operator-=(const E& e) {
+        _mat_utils::assign(data(), *this - e);
+        return *this;
+    }
+
+    /**
+     *@brief operator *= for Mat2d class
+     *@param c the scalar
+     *@return Mat2d&
+     */
+    Mat2d& operator*=(const T& c) {
+        _mat_utils::assign(data(), *this * c);
+        return *this;
     }
 
     /**
      *@brief operator (i, j) for Mat2d class
      *@param i index that's pointing to the row
      *@param j index that's pointing to the column
-     *@return T the element of arr[i][j]
+     *@return T& the element of arr[i][j]
      */
-    T& operator()(size_t i, size_t j) const { return arr[i * _cols + j]; }
+    T& operator()(size_t i, size_t j) { return arr.data()[i * _cols + j]; }
+    const T& operator()(size_t i, size_t j) const { return arr.data()[i * _cols + j]; }
 
     /**
      *@brief operator () for Mat2d class
      *@param i index that's pointing to the row
-     *@return std::vector<T> the array of index i
+     *@return Mat1d<T, COLS> a copy of the row i, row(i) is a view without a copy
      */
-    Mat1d<T, COLS>& operator()(size_t i) {
-        size_t index = 0;
-        for (size_t j = i * _cols; j < i * _cols + _rows; j++) {
-            mat[index++] = arr[j];
-        }
-        return mat;
+    Mat1d<T, COLS> operator()(size_t i) const {
+        Mat1d<T, COLS> row;
+        std::copy(data() + i * _cols, data() + (i + 1) * _cols, row.data());
+        return row;
     }
 
+    /**
+     *@brief data function
+     *@return T* the elements in row major order, aligned to at least 32 bytes
+     */
+    T* data() { return arr.data(); }
+    const T* data() const { return arr.data(); }
+
+    /**
+     *@brief eval function, the element i in row major order as an expression
+     */
+    T eval(size_t i) const { return arr.data()[i]; }
+
+    /**
+     *@brief packet function, the elements [i, i + P::width) in row major order as an
+     * expression
+     */
+    template <typename P> P packet(size_t i) const { return P::load(arr.data() + i); }
+
     /**
      *@brief size function
      *@return size_t the size of the matrix
      */
     size_t size() const { return _size; }
 
+    /**
+     *@brief memory_usage function
+     *@return MEMORY::footprint the elements, inline or on the heap above inline_bytes, and the
+     *padding of their alignment
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = arr.memory_usage();
+        f.control += sizeof(*this) - sizeof(arr);
+        return f;
+    }
+
     /**
      *@brief cols function
      *@return size_t the number of elements in each column
@@ -139,19 +216,64 @@ template <typename T, size_t ROWS, size_t COLS> class Mat2d {
      */
     size_t rows() const { return _rows; }
 
-    class Iterator;
+    /**
+     *@brief row function
+     *@param i index that's pointing to the row
+     *@return strided_span<T> a view of the row i, nothing is copied
+     */
+    strided_span<T> row(size_t i) { return strided_span<T>(data() + i * _cols, _cols); }
+    strided_span<const T> row(size_t i) const {
+        return strided_span<const T>(data() + i * _cols, _cols);
+    }
+
+    /**
+     *@brief col function
+     *@param j index that's pointing to the column
+     *@return strided_span<T> a view of the column j, nothing is copied
+     */
+    strided_span<T> col(size_t j) { return strided_span<T>(data() + j, _rows, _cols); }
+    strided_span<const T> col(size_t j) const {
+        return strided_span<const T>(data() + j, _rows, _cols);
+    }
+
+    /**
+     *@brief view function
+     *@return mat_view<T> a view of the whole matrix
+     */
+    mat_view<T> view() { return mat_view<T>(data(), _rows, _cols, _cols); }
+    mat_view<const T> view() const { return mat_view<const T>(data(), _rows, _cols, _cols); }
+
+    /**
+     *@brief submatrix function
+     *@param r the first row
+     *@param c the first column
+     *@param rows the number of rows
+     *@param cols the number of columns
+     *@return mat_view<T> a view of the block, nothing is copied. Throws std::out_of_range
+     * if the block does not fit in the matrix.
+     */
+    mat_view<T> submatrix(size_t r, size_t c, size_t rows, size_t cols) {
+        return view().submatrix(r, c, rows, cols);
+    }
+    mat_view<const T> submatrix(size_t r, size_t c, size_t rows, size_t cols) const {
+        return view().submatrix(r, c, rows, cols);
+    }
+
+    template <typename V> class Iterator;
     typedef T* iterator;
     /**
-     *@brief begin() Iterator for Mat2d class
+     *@brief begin() Iterator for Mat2d class, over the rows
      *@return Iterator
      */
-    Iterator begin() { return Iterator(arr, _rows, _cols, 0); }
+    Iterator<T> begin() { return Iterator<T>(data(), 0); }
+    Iterator<const T> begin() const { return Iterator<const T>(data(), 0); }
 
     /**
      *@brief end() Iterator for Mat2d class
      *@return Iterator
      */
-    Iterator end() { return Iterator(arr, _rows, _cols, _size); }
+    Iterator<T> end() { return Iterator<T>(data(), _rows); }
+    Iterator<const T> end() const { return Iterator<const T>(data(), _rows); }
 
     /**
      *@brief operator << for Mat2d class
@@ -161,7 +283,7 @@ template <typename T, size_t ROWS, size_t COLS> class Mat2d {
         for (size_t i = 0; i < mat.rows(); i++) {
             out << '[';
             for (size_t j = 0; j < mat.cols(); j++) {
-                out << mat.arr[i * mat.cols() + j];
+                out << mat(i, j);
                 if (j != mat.cols() - 1) {
                     out << " ";
                 }
@@ -178,61 +300,41 @@ template <typename T, size_t ROWS, size_t COLS> class Mat2d {
 
 /**
  *@brief Iterator for Mat2d class
+ * Walks over the rows of the matrix, every row is a view into its storage.
  */
-template <typename T, size_t ROWS, size_t COLS> class Mat2d<T, ROWS, COLS>::Iterator {
+template <typename T, size_t ROWS, size_t COLS>
+template <typename V>
+class Mat2d<T, ROWS, COLS>::Iterator {
   private:
-    T* arr;
-    size_t _rows;
-    size_t _cols;
+    V* arr;
     size_t _index;
-    size_t _size;
 
   public:
-    /**
-     *@brief constructor for Iterator class
-     *@param __arr the input array
-     *@param rows the number of rows of the matrix
-     *@param cols the number of columns of the matrix
-     *@param index the current index, if it's begin() then 0, if it's end() then
-     *__size
-     */
-    explicit Iterator(T* _arr, size_t rows, size_t cols, size_t index) noexcept
-        : _rows(rows), _cols(cols), _index(index), _size(rows * cols) {
-
-        arr = new T[_size];
-        for (size_t i = 0; i < _size; i++) {
-            arr[i] = _arr[i];
-        }
-    }
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = strided_span<V>;
+    using difference_type = std::ptrdiff_t;
 
     /**
-     *@brief operator = for Iterator class
-     *@param curr the current array
-     *@return Iterator&
+     *@brief constructor for Iterator class
+     *@param _arr the elements of the matrix
+     *@param index the current row, 0 for begin() and ROWS for end()
      */
-    Iterator& operator=(T* curr) {
-        for (size_t i = 0; i < _size; i++) {
-            arr[i] = curr[i];
-        }
-        return *(this);
-    }
+    explicit Iterator(V* _arr, size_t index) noexcept : arr(_arr), _index(index) {}
 
     /**
      *@brief operator ++ for Iterator class
      *@return Iterator&
      */
     Iterator& operator++() {
-        if (this->_index < _size) {
-            this->_index++;
-        }
+        this->_index++;
         return *(this);
     }
 
     /**
      *@param operator ++ for Iterator class
-     *@return Iterator&
+     *@return Iterator
      */
-    Iterator& operator++(int) {
+    Iterator operator++(int) {
         Iterator it = *(this);
         ++*(this);
         return it;
@@ -243,40 +345,30 @@ template <typename T, size_t ROWS, size_t COLS> class Mat2d<T, ROWS, COLS>::Iter
      *@return Iterator&
      */
     Iterator& operator--() {
-        if (this->_index > 0) {
-            this->_index--;
-        }
+        this->_index--;
         return *(this);
     }
 
     /**
      *@brief operator -- for Iterator class
-     *@return Iterator&
+     *@return Iterator
      */
-    Iterator& operator--(int) {
+    Iterator operator--(int) {
         Iterator it = *(this);
         --*(this);
         return it;
     }
 
     /**
-     *@brief operator != for Iterator class
-     *@return true if the elements of the array in the current index is not equal
-     *@return false otherwise
+     *@brief operator == for Iterator class
+     *@return true if both point to the same row
      */
-    bool operator!=(const Iterator& it) { return it.arr[it._index] != arr[this->_index]; }
+    bool operator==(const Iterator& it) const { return _index == it._index && arr == it.arr; }
 
     /**
      *@brief operator * for Iterator class
-     *@return Mat1d<T, COLS> the 1-Dimensional Matrix in the current row
+     *@return strided_span<V> a view of the current row
      */
-    template <typename A, size_t CCOLS> Mat1d<A, CCOLS>& operator*() {
-        Mat1d<T, COLS> mat(0);
-        size_t index = 0;
-        for (size_t j = this->_index * _cols; j < this->_index * _cols + _rows; ++j) {
-            mat[index++] = arr[j];
-        }
-        return mat;
-    }
+    strided_span<V> operator*() const { return strided_span<V>(arr + _index * COLS, COLS); }
 };
 #endif
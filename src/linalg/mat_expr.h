@@ -0,0 +1,503 @@
+#ifndef MAT_EXPR_H
+#define MAT_EXPR_H
+
+#include "../helpers/cpu_features.h"
+#include "../helpers/memory_usage.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace _mat_utils {
+// the matrices up to this many bytes keep their elements inline, the larger ones on the heap
+constexpr size_t inline_bytes = 4096;
+constexpr size_t heap_alignment = 64;
+// the rows and columns of a matrix whose shape is only known at run time
+constexpr size_t dynamic = size_t(-1);
+
+/**
+ * @brief the alignment of the inline elements: a cache line from 64 bytes on, the width of
+ * an AVX2 register below
+ */
+template <typename T, size_t N> constexpr size_t alignment() {
+    return std::max(alignof(T), N * sizeof(T) >= 64 ? size_t(64) : size_t(32));
+}
+
+/**
+ * @brief allocator of memory aligned to heap_alignment bytes
+ */
+template <typename T> struct aligned_allocator {
+    using value_type = T;
+
+    aligned_allocator() = default;
+    template <typename U> aligned_allocator(const aligned_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(heap_alignment)));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(heap_alignment));
+    }
+
+    template <typename U> bool operator==(const aligned_allocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+/**
+ * @brief the N elements of a matrix: inline and aligned up to inline_bytes, on the heap
+ * and aligned to a cache line above
+ */
+template <typename T, size_t N, bool Inline = (N * sizeof(T) <= inline_bytes)> class storage {
+  public:
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f;
+        f.payload = N * sizeof(T);
+        f.control = sizeof(*this) - f.payload;
+        return f;
+    }
+
+  private:
+    alignas(alignment<T, N>()) T _data[N == 0 ? 1 : N];
+};
+
+template <typename T, size_t N> class storage<T, N, false> {
+  public:
+    T* data() { return _data.data(); }
+    const T* data() const { return _data.data(); }
+    MEMORY::footprint memory_usage() const { return MEMORY::memory_usage(_data); }
+
+  private:
+    std::vector<T, aligned_allocator<T>> _data = std::vector<T, aligned_allocator<T>>(N);
+};
+
+/**
+ * @brief a register of elements for the explicit kernels, enabled for float and double
+ * with AVX2 or with NEON on AArch64
+ */
+template <typename T> struct simd {
+    static constexpr bool enabled = false;
+};
+
+#if defined(__AVX2__)
+template <> struct simd<float> {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 8;
+    __m256 v;
+    static simd load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static simd broadcast(float c) { return {_mm256_set1_ps(c)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+    friend simd operator+(simd a, simd b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend simd operator-(simd a, simd b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend simd operator*(simd a, simd b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend simd operator/(simd a, simd b) { return {_mm256_div_ps(a.v, b.v)}; }
+    friend simd operator-(simd a) { return {_mm256_sub_ps(_mm256_setzero_ps(), a.v)}; }
+    friend simd abs(simd a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+};
+
+template <> struct simd<double> {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 4;
+    __m256d v;
+    static simd load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    static simd broadcast(double c) { return {_mm256_set1_pd(c)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+    friend simd operator+(simd a, simd b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend simd operator-(simd a, simd b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend simd operator*(simd a, simd b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend simd operator/(simd a, simd b) { return {_mm256_div_pd(a.v, b.v)}; }
+    friend simd operator-(simd a) { return {_mm256_sub_pd(_mm256_setzero_pd(), a.v)}; }
+    friend simd abs(simd a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+};
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+template <> struct simd<float> {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 4;
+    float32x4_t v;
+    static simd load(const float* p) { return {vld1q_f32(p)}; }
+    static simd broadcast(float c) { return {vdupq_n_f32(c)}; }
+    void store(float* p) const { vst1q_f32(p, v); }
+    friend simd operator+(simd a, simd b) { return {vaddq_f32(a.v, b.v)}; }
+    friend simd operator-(simd a, simd b) { return {vsubq_f32(a.v, b.v)}; }
+    friend simd operator*(simd a, simd b) { return {vmulq_f32(a.v, b.v)}; }
+    friend simd operator/(simd a, simd b) { return {vdivq_f32(a.v, b.v)}; }
+    friend simd operator-(simd a) { return {vnegq_f32(a.v)}; }
+    friend simd abs(simd a) { return {vabsq_f32(a.v)}; }
+};
+
+template <> struct simd<double> {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 2;
+    float64x2_t v;
+    static simd load(const double* p) { return {vld1q_f64(p)}; }
+    static simd broadcast(double c) { return {vdupq_n_f64(c)}; }
+    void store(double* p) const { vst1q_f64(p, v); }
+    friend simd operator+(simd a, simd b) { return {vaddq_f64(a.v, b.v)}; }
+    friend simd operator-(simd a, simd b) { return {vsubq_f64(a.v, b.v)}; }
+    friend simd operator*(simd a, simd b) { return {vmulq_f64(a.v, b.v)}; }
+    friend simd operator/(simd a, simd b) { return {vdivq_f64(a.v, b.v)}; }
+    friend simd operator-(simd a) { return {vnegq_f64(a.v)}; }
+    friend simd abs(simd a) { return {vabsq_f64(a.v)}; }
+};
+#endif
+
+/**
+ * @brief an expression over the elements of matrices: it has the shape of a matrix
+ * (expr_dims, expr_rows and expr_cols, both dynamic when the shape is only known at run
+ * time, then expr_extent() gives it), eval(i) is its element i in row major order and
+ * packet<P>(i) the elements [i, i + P::width) in a register
+ */
+template <typename E>
+concept expression = requires { E::is_mat_expr; } && E::is_mat_expr;
+
+/**
+ * @brief the rows and columns of an expression, a constant unless they are dynamic
+ */
+template <typename E> std::pair<size_t, size_t> extent(const E& e) {
+    if constexpr (E::expr_rows == dynamic || E::expr_cols == dynamic) {
+        return e.expr_extent();
+    } else {
+        return {E::expr_rows, E::expr_cols};
+    }
+}
+
+template <typename L, typename R>
+concept same_shape = expression<L> && expression<R> && L::expr_dims == R::expr_dims &&
+                     L::expr_rows == R::expr_rows && L::expr_cols == R::expr_cols &&
+                     std::is_same_v<typename L::value_type, typename R::value_type>;
+
+// the matrices are held by reference in an expression, the nodes by value
+template <typename E>
+using operand_t = std::conditional_t<E::is_mat_leaf, const E&, const E>;
+
+struct plus {
+    template <typename A> A operator()(const A& a, const A& b) const { return a + b; }
+};
+
+struct minus {
+    template <typename A> A operator()(const A& a, const A& b) const { return a - b; }
+};
+
+struct multiplies {
+    template <typename A> A operator()(const A& a, const A& b) const { return a * b; }
+};
+
+struct divides {
+    template <typename A> A operator()(const A& a, const A& b) const { return a / b; }
+};
+
+struct negate {
+    template <typename A> A operator()(const A& a) const { return -a; }
+};
+
+/**
+ * @brief the shape of an expression, given to the nodes built on it
+ */
+template <typename E> struct shape_of {
+    using value_type = typename E::value_type;
+    static constexpr size_t expr_dims = E::expr_dims;
+    static constexpr size_t expr_rows = E::expr_rows;
+    static constexpr size_t expr_cols = E::expr_cols;
+    static constexpr bool is_mat_expr = true;
+    static constexpr bool is_mat_leaf = false;
+    static constexpr bool is_mat_scalar = false;
+};
+
+/**
+ * @brief a scalar broadcast to the shape of E, it takes the extent of the other operand
+ */
+template <typename E> class scalar_expr : public shape_of<E> {
+  public:
+    using value_type = typename E::value_type;
+    static constexpr bool is_mat_scalar = true;
+    explicit scalar_expr(const value_type& c) : _c(c) {}
+    value_type eval(size_t) const { return _c; }
+    template <typename P> P packet(size_t) const { return P::broadcast(_c); }
+
+  private:
+    value_type _c;
+};
+
+/**
+ * @brief Op of two expressions element by element. Throws std::invalid_argument if the
+ * shapes are dynamic and differ.
+ */
+template <typename Op, typename L, typename R> class binary_expr : public shape_of<L> {
+  public:
+    using value_type = typename L::value_type;
+    binary_expr(const L& l, const R& r) : _l(l), _r(r) {
+        if constexpr (L::expr_rows == dynamic && !L::is_mat_scalar && !R::is_mat_scalar) {
+            if (extent(l) != extent(r)) {
+                throw std::invalid_argument("matrix expression: the shapes differ");
+            }
+        }
+    }
+    std::pair<size_t, size_t> expr_extent() const {
+        if constexpr (L::is_mat_scalar) {
+            return extent(_r);
+        } else {
+            return extent(_l);
+        }
+    }
+    value_type eval(size_t i) const { return Op()(_l.eval(i), _r.eval(i)); }
+    template <typename P> P packet(size_t i) const {
+        return Op()(_l.template packet<P>(i), _r.template packet<P>(i));
+    }
+
+  private:
+    operand_t<L> _l;
+    operand_t<R> _r;
+};
+
+template <typename Op, typename E> class unary_expr : public shape_of<E> {
+  public:
+    using value_type = typename E::value_type;
+    explicit unary_expr(const E& e) : _e(e) {}
+    std::pair<size_t, size_t> expr_extent() const { return extent(_e); }
+    value_type eval(size_t i) const { return Op()(_e.eval(i)); }
+    template <typename P> P packet(size_t i) const { return Op()(_e.template packet<P>(i)); }
+
+  private:
+    operand_t<E> _e;
+};
+
+/**
+ * @brief writes the elements of e to out in one pass, a register at a time when the
+ * kernels are enabled for T. Every element only reads the same element of the operands, so
+ * out may be one of them.
+ */
+template <typename T, typename E> void assign(T* out, const E& e) {
+    auto [rows, cols] = extent(e);
+    const size_t n = rows * cols;
+    size_t body = 0;
+    if constexpr (simd<T>::enabled) {
+        using P = simd<T>;
+        body = n - n % P::width;
+        for (size_t i = 0; i < body; i += P::width) {
+            e.template packet<P>(i).store(out + i);
+        }
+    }
+    for (size_t i = body; i < n; i++) {
+        out[i] = e.eval(i);
+    }
+}
+
+/**
+ * @brief the sums over two arrays the distances and the dot products are made of:
+ * (a - b)^2, |a - b| and a * b
+ */
+enum class reduction { squared, absolute, product };
+
+template <reduction R, typename V> V term(V x, V y) {
+    if constexpr (R == reduction::product) {
+        return x * y;
+    } else if constexpr (R == reduction::squared) {
+        V t = x - y;
+        return t * t;
+    } else if constexpr (std::is_arithmetic_v<V>) {
+        return x > y ? x - y : y - x;
+    } else {
+        return abs(x - y);
+    }
+}
+
+/**
+ * @brief the sum of term<R> over the d elements of a and b, in the simd registers of the
+ * build when Packed
+ */
+template <reduction R, typename T, bool Packed = simd<T>::enabled>
+T reduce(const T* a, const T* b, size_t d) {
+    size_t j = 0;
+    T sum = 0;
+    if constexpr (Packed) {
+        using P = simd<T>;
+        constexpr size_t w = P::width;
+        if (d >= 2 * w) {
+            // two accumulators hide the latency of the additions
+            P acc0 = P::broadcast(T(0)), acc1 = P::broadcast(T(0));
+            for (; j + 2 * w <= d; j += 2 * w) {
+                acc0 = acc0 + term<R>(P::load(a + j), P::load(b + j));
+                acc1 = acc1 + term<R>(P::load(a + j + w), P::load(b + j + w));
+            }
+            T lanes[w];
+            (acc0 + acc1).store(lanes);
+            for (size_t l = 0; l < w; l++) {
+                sum += lanes[l];
+            }
+        }
+    }
+    for (; j < d; j++) {
+        sum += term<R>(a[j], b[j]);
+    }
+    return sum;
+}
+
+#if defined(ALGOPLUS_X86_DISPATCH)
+namespace avx2 {
+ALGOPLUS_TARGET("avx2") inline __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+ALGOPLUS_TARGET("avx2") inline __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+ALGOPLUS_TARGET("avx2") inline __m256 add(__m256 x, __m256 y) { return _mm256_add_ps(x, y); }
+ALGOPLUS_TARGET("avx2") inline __m256d add(__m256d x, __m256d y) { return _mm256_add_pd(x, y); }
+ALGOPLUS_TARGET("avx2") inline void store(float* p, __m256 x) { _mm256_storeu_ps(p, x); }
+ALGOPLUS_TARGET("avx2") inline void store(double* p, __m256d x) { _mm256_storeu_pd(p, x); }
+
+template <reduction R> ALGOPLUS_TARGET("avx2") __m256 term(__m256 x, __m256 y) {
+    if constexpr (R == reduction::product) {
+        return _mm256_mul_ps(x, y);
+    } else if constexpr (R == reduction::squared) {
+        __m256 t = _mm256_sub_ps(x, y);
+        return _mm256_mul_ps(t, t);
+    } else {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), _mm256_sub_ps(x, y));
+    }
+}
+
+template <reduction R> ALGOPLUS_TARGET("avx2") __m256d term(__m256d x, __m256d y) {
+    if constexpr (R == reduction::product) {
+        return _mm256_mul_pd(x, y);
+    } else if constexpr (R == reduction::squared) {
+        __m256d t = _mm256_sub_pd(x, y);
+        return _mm256_mul_pd(t, t);
+    } else {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(x, y));
+    }
+}
+
+/**
+ * @brief reduce with AVX2 registers, whatever the flags of the build, it sums the lanes in the
+ * same order as the simd<T> kernels
+ */
+template <reduction R, typename T>
+ALGOPLUS_TARGET("avx2") T reduce(const T* a, const T* b, size_t d) {
+    constexpr size_t w = 32 / sizeof(T);
+    size_t j = 0;
+    T sum = 0;
+    if (d >= 2 * w) {
+        auto acc0 = term<R>(load(a), load(b)), acc1 = term<R>(load(a + w), load(b + w));
+        for (j = 2 * w; j + 2 * w <= d; j += 2 * w) {
+            acc0 = add(acc0, term<R>(load(a + j), load(b + j)));
+            acc1 = add(acc1, term<R>(load(a + j + w), load(b + j + w)));
+        }
+        T lanes[w];
+        store(lanes, add(acc0, acc1));
+        for (size_t l = 0; l < w; l++) {
+            sum += lanes[l];
+        }
+    }
+    for (; j < d; j++) {
+        sum += _mat_utils::term<R>(a[j], b[j]);
+    }
+    return sum;
+}
+} // namespace avx2
+#endif
+
+/**
+ * @brief reduce with the kernel of the instruction set of the cpu for float and double: the
+ * AVX2 one on x86 whatever the flags of the build, the NEON one on AArch64, scalar otherwise.
+ * The arrays too short for two registers skip the dispatch.
+ */
+template <reduction R, typename T> T dispatch_reduce(const T* a, const T* b, size_t d) {
+    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+        if (d >= 64 / sizeof(T)) {
+            static const SIMD::kernels<T(const T*, const T*, size_t)> k{
+                .scalar = &reduce<R, T, false>,
+#if defined(ALGOPLUS_X86_DISPATCH)
+                .avx2 = &avx2::reduce<R, T>,
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+                .neon = &reduce<R, T>,
+#endif
+            };
+            return k.get()(a, b, d);
+        }
+    }
+    return reduce<R, T>(a, b, d);
+}
+
+/**
+ * @brief the squared euclidean distance of the d elements of a and b
+ */
+template <typename T> T squared_distance(const T* a, const T* b, size_t d) {
+    return dispatch_reduce<reduction::squared>(a, b, d);
+}
+
+/**
+ * @brief the sum of the absolute differences of the d elements of a and b
+ */
+template <typename T> T absolute_distance(const T* a, const T* b, size_t d) {
+    return dispatch_reduce<reduction::absolute>(a, b, d);
+}
+
+/**
+ * @brief the dot product of the d elements of a and b
+ */
+template <typename T> T dot(const T* a, const T* b, size_t d) {
+    return dispatch_reduce<reduction::product>(a, b, d);
+}
+} // namespace _mat_utils
+
+/**
+ * @brief element wise sum of two matrix expressions of the same shape
+ */
+template <typename L, typename R>
+    requires _mat_utils::same_shape<L, R>
+auto operator+(const L& l, const R& r) {
+    return _mat_utils::binary_expr<_mat_utils::plus, L, R>(l, r);
+}
+
+/**
+ * @brief element wise difference of two matrix expressions of the same shape
+ */
+template <typename L, typename R>
+    requires _mat_utils::same_shape<L, R>
+auto operator-(const L& l, const R& r) {
+    return _mat_utils::binary_expr<_mat_utils::minus, L, R>(l, r);
+}
+
+/**
+ * @brief negation of a matrix expression
+ */
+template <_mat_utils::expression E> auto operator-(const E& e) {
+    return _mat_utils::unary_expr<_mat_utils::negate, E>(e);
+}
+
+/**
+ * @brief product of a matrix expression and a scalar
+ */
+template <_mat_utils::expression E> auto operator*(const E& e, typename E::value_type c) {
+    using S = _mat_utils::scalar_expr<E>;
+    return _mat_utils::binary_expr<_mat_utils::multiplies, E, S>(e, S(c));
+}
+
+/**
+ * @brief product of a scalar and a matrix expression
+ */
+template <_mat_utils::expression E> auto operator*(typename E::value_type c, const E& e) {
+    using S = _mat_utils::scalar_expr<E>;
+    return _mat_utils::binary_expr<_mat_utils::multiplies, S, E>(S(c), e);
+}
+
+/**
+ * @brief quotient of a matrix expression and a scalar
+ */
+template <_mat_utils::expression E> auto operator/(const E& e, typename E::value_type c) {
+    using S = _mat_utils::scalar_expr<E>;
+    return _mat_utils::binary_expr<_mat_utils::divides, E, S>(e, S(c));
+}
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef MAT_VIEW_H
+#define MAT_VIEW_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#endif
+
+/**
+ * @brief strided span class
+ * Non owning view of size elements that are stride elements apart, e.g. a column of a row
+ * major matrix(stride = the number of columns) or a row(stride = 1). It does not copy
+ * anything and stays valid as long as the matrix it looks at.
+ * @tparam T the type of the elements, const T for a read only view
+ */
+template <typename T> class strided_span {
+  public:
+    using value_type = std::remove_cv_t<T>;
+
+    /**
+     * @brief iterator class of strided_span, a random access iterator
+     */
+    class iterator {
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() = default;
+        iterator(T* base, std::ptrdiff_t index, std::ptrdiff_t stride)
+            : _base(base), _index(index), _stride(stride) {}
+
+        T& operator*() const { return _base[_index * _stride]; }
+        T* operator->() const { return _base + _index * _stride; }
+        T& operator[](difference_type n) const { return _base[(_index + n) * _stride]; }
+
+        iterator& operator++() {
+            _index++;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator it = *this;
+            _index++;
+            return it;
+        }
+        iterator& operator--() {
+            _index--;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator it = *this;
+            _index--;
+            return it;
+        }
+        iterator& operator+=(difference_type n) {
+            _index += n;
+            return *this;
+        }
+        iterator& operator-=(difference_type n) {
+            _index -= n;
+            return *this;
+        }
+        friend iterator operator+(iterator it, difference_type n) { return it += n; }
+        friend iterator operator+(difference_type n, iterator it) { return it += n; }
+        friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator& a, const iterator& b) {
+            return a._index - b._index;
+        }
+        bool operator==(const iterator& it) const { return _index == it._index; }
+        auto operator<=>(const iterator& it) const { return _index <=> it._index; }
+
+      private:
+        // the position is kept as an index, the end of a column is past the matrix
+        T* _base{nullptr};
+        std::ptrdiff_t _index{0};
+        std::ptrdiff_t _stride{1};
+    };
+
+    /**
+     * @brief Construct a new strided span object
+     * @param data the first element
+     * @param size the number of elements
+     * @param stride the distance between two elements. Default = 1
+     */
+    strided_span(T* data, size_t size, size_t stride = 1)
+        : _data(data), _size(size), _stride(stride) {}
+
+    /**
+     * @brief a read only view from a view
+     */
+    template <typename U>
+        requires(std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+    strided_span(const strided_span<U>& s)
+        : _data(s.data()), _size(s.size()), _stride(s.stride()) {}
+
+    /**
+     * @brief size function
+     * @return size_t the number of elements.
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief stride function
+     * @return size_t the distance between two elements.
+     */
+    size_t stride() const { return _stride; }
+
+    /**
+     * @brief data function
+     * @return T* the first element.
+     */
+    T* data() const { return _data; }
+
+    /**
+     * @brief operator[] for strided_span class
+     * @param i the position of the element, i < size()
+     * @return T& the element
+     */
+    T& operator[](size_t i) const { return _data[i * _stride]; }
+
+    iterator begin() const { return iterator(_data, 0, std::ptrdiff_t(_stride)); }
+    iterator end() const { return iterator(_data, std::ptrdiff_t(_size), std::ptrdiff_t(_stride)); }
+
+  private:
+    T* _data;
+    size_t _size;
+    size_t _stride;
+};
+
+/**
+ * @brief mat view class
+ * Non owning view of a rows x cols block of a row major matrix whose rows are row_stride
+ * elements apart: a submatrix of a Mat2d or of another view, without copying it. Rows,
+ * columns and submatrices of the view are views too.
+ * @tparam T the type of the elements, const T for a read only view
+ */
+template <typename T> class mat_view {
+  public:
+    using value_type = std::remove_cv_t<T>;
+
+    /**
+     * @brief Construct a new mat view object
+     * @param data the first element of the block
+     * @param rows the number of rows
+     * @param cols the number of columns
+     * @param row_stride the distance between two rows, at least cols
+     */
+    mat_view(T* data, size_t rows, size_t cols, size_t row_stride)
+        : _data(data), _rows(rows), _cols(cols), _row_stride(row_stride) {}
+
+    /**
+     * @brief a read only view from a view
+     */
+    template <typename U>
+        requires(std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+    mat_view(const mat_view<U>& v)
+        : _data(v.data()), _rows(v.rows()), _cols(v.cols()), _row_stride(v.row_stride()) {}
+
+    size_t rows() const { return _rows; }
+    size_t cols() const { return _cols; }
+    size_t size() const { return _rows * _cols; }
+    size_t row_stride() const { return _row_stride; }
+    T* data() const { return _data; }
+
+    /**
+     * @brief operator (i, j) for mat_view class
+     * @return T& the element of row i and column j
+     */
+    T& operator()(size_t i, size_t j) const { return _data[i * _row_stride + j]; }
+
+    /**
+     * @brief row function
+     * @param i the row, i < rows()
+     * @return strided_span<T> a view of the row.
+     */
+    strided_span<T> row(size_t i) const {
+        return strided_span<T>(_data + i * _row_stride, _cols);
+    }
+
+    /**
+     * @brief col function
+     * @param j the column, j < cols()
+     * @return strided_span<T> a view of the column.
+     */
+    strided_span<T> col(size_t j) const {
+        return strided_span<T>(_data + j, _rows, _row_stride);
+    }
+
+    /**
+     * @brief submatrix function
+     * @param r the first row
+     * @param c the first column
+     * @param rows the number of rows
+     * @param cols the number of columns
+     * @return mat_view<T> a view of the block.
+     * Throws std::out_of_range if the block does not fit in the view.
+     */
+    mat_view submatrix(size_t r, size_t c, size_t rows, size_t cols) const {
+        if (r > _rows || rows > _rows - r || c > _cols || cols > _cols - c) {
+            throw std::out_of_range("mat_view: the submatrix does not fit");
+        }
+        return mat_view(_data + r * _row_stride + c, rows, cols, _row_stride);
+    }
+
+  private:
+    T* _data;
+    size_t _rows;
+    size_t _cols;
+    size_t _row_stride;
+};
+
+#endif
@@ -0,0 +1,223 @@
+#ifndef MATMUL_H
+#define MATMUL_H
+
+#include "../algorithms/math/multiply.h"
+#include "mat_1d.h"
+#include "mat_2d.h"
+#include "matrix.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#if defined(ENABLE_CBLAS)
+#include <cblas.h>
+#endif
+#endif
+
+namespace _matmul_utils {
+// the products of at most this many multiply-adds are loops specialized on their sizes, the
+// larger ones go through the blocked GEMM(or the BLAS): below, the packing costs more than
+// it saves
+constexpr size_t unrolled_volume = 64 * 64 * 64;
+
+/**
+ * @brief C(R x C) = A(R x K) B(K x C) with the bounds known at compile time: the two inner
+ * loops are unrolled(completely up to 16 x 16, so a 4x4 or 8x8 product is straight line
+ * code) and a row of C stays in registers
+ */
+template <typename T, size_t R, size_t K, size_t C>
+void unrolled(const T* __restrict a, const T* __restrict b, T* __restrict c) {
+    for (size_t i = 0; i < R; i++) {
+        T row[C] = {};
+#pragma GCC unroll 16
+        for (size_t k = 0; k < K; k++) {
+            T x = a[i * K + k];
+#pragma GCC unroll 16
+            for (size_t j = 0; j < C; j++) {
+                row[j] += x * b[k * C + j];
+            }
+        }
+        for (size_t j = 0; j < C; j++) {
+            c[i * C + j] = row[j];
+        }
+    }
+}
+
+/**
+ * @brief C(n x p) = A(n x m) B(m x p), row major and contiguous: the system BLAS for float
+ * and double when ENABLE_CBLAS is defined, the blocked GEMM of multiply.h otherwise
+ */
+template <typename T>
+void gemm(const T* a, const T* b, T* c, size_t n, size_t m, size_t p, size_t threads) {
+#if defined(ENABLE_CBLAS)
+    if constexpr (std::is_same_v<T, float>) {
+        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, int(n), int(p), int(m), 1.0f, a,
+                    int(m), b, int(p), 0.0f, c, int(p));
+        return;
+    } else if constexpr (std::is_same_v<T, double>) {
+        cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, int(n), int(p), int(m), 1.0, a,
+                    int(m), b, int(p), 0.0, c, int(p));
+        return;
+    }
+#endif
+    std::fill(c, c + n * p, T(0));
+    _gemm_utils::gemm(a, b, c, n, m, p, threads);
+}
+
+/**
+ * @brief C(n x p) = A(n x m) B(m x p) for the small products of run time sizes: a row of B
+ * scaled by an element of A is added to a row of C, the inner loop is vectorized
+ */
+template <typename T>
+void small_gemm(const T* __restrict a, const T* __restrict b, T* __restrict c, size_t n,
+                size_t m, size_t p) {
+    std::fill(c, c + n * p, T(0));
+    for (size_t i = 0; i < n; i++) {
+        T* row = c + i * p;
+        for (size_t k = 0; k < m; k++) {
+            T x = a[i * m + k];
+            const T* b_row = b + k * p;
+            for (size_t j = 0; j < p; j++) {
+                row[j] += x * b_row[j];
+            }
+        }
+    }
+}
+} // namespace _matmul_utils
+
+/**
+ * @brief matmul function
+ * The product of two matrices. The small ones(at most 64^3 multiply-adds) are computed by
+ * unrolled loops specialized on their sizes, the larger ones by the packed and cache
+ * blocked GEMM, on several threads, or by the system BLAS(cblas_sgemm/cblas_dgemm) for
+ * float and double when ENABLE_CBLAS is defined and it is linked.
+ * @param a the first matrix, R x K
+ * @param b the second matrix, K x C
+ * @param threads number of threads of the GEMM(0 means every hardware thread). Default = 1
+ * @return Mat2d<T, R, C> the product a b.
+ */
+template <typename T, size_t R, size_t K, size_t C>
+Mat2d<T, R, C> matmul(const Mat2d<T, R, K>& a, const Mat2d<T, K, C>& b, size_t threads = 1) {
+    Mat2d<T, R, C> c;
+    if constexpr (R * K * C <= _matmul_utils::unrolled_volume) {
+        _matmul_utils::unrolled<T, R, K, C>(a.data(), b.data(), c.data());
+    } else {
+        _matmul_utils::gemm(a.data(), b.data(), c.data(), R, K, C, threads);
+    }
+    return c;
+}
+
+/**
+ * @brief matmul function for a matrix and a vector
+ * @param a the matrix, R x C
+ * @param x the vector, of size C
+ * @return Mat1d<T, R> the product a x.
+ */
+template <typename T, size_t R, size_t C>
+Mat1d<T, R> matmul(const Mat2d<T, R, C>& a, const Mat1d<T, C>& x) {
+    Mat1d<T, R> y;
+    if constexpr (R * C <= _matmul_utils::unrolled_volume) {
+        _matmul_utils::unrolled<T, R, C, 1>(a.data(), x.data(), y.data());
+    } else {
+        for (size_t i = 0; i < R; i++) {
+            T sum = T(0);
+            const T* row = a.data() + i * C;
+            for (size_t j = 0; j < C; j++) {
+                sum += row[j] * x[j];
+            }
+            y[i] = sum;
+        }
+    }
+    return y;
+}
+
+/**
+ * @brief operator * for two matrices, matmul on one thread
+ */
+template <typename T, size_t R, size_t K, size_t C>
+Mat2d<T, R, C> operator*(const Mat2d<T, R, K>& a, const Mat2d<T, K, C>& b) {
+    return matmul(a, b);
+}
+
+/**
+ * @brief operator * for a matrix and a vector, matmul
+ */
+template <typename T, size_t R, size_t C>
+Mat1d<T, R> operator*(const Mat2d<T, R, C>& a, const Mat1d<T, C>& x) {
+    return matmul(a, x);
+}
+
+/**
+ * @brief matmul function for matrices of run time sizes
+ * The same kernels as for Mat2d: the small products(at most 64^3 multiply-adds) are a
+ * vectorized loop, the larger ones go through the blocked GEMM or the system BLAS.
+ * @param a the first matrix, n x m
+ * @param b the second matrix, m x p
+ * @param threads number of threads of the GEMM(0 means every hardware thread). Default = 1
+ * @return Matrix<T> the product a b. Throws std::invalid_argument if the columns of a are
+ * not the rows of b.
+ */
+template <typename T>
+Matrix<T> matmul(const Matrix<T>& a, const Matrix<T>& b, size_t threads = 1) {
+    Matrix<T> c;
+    matmul(a, b, c, threads);
+    return c;
+}
+
+/**
+ * @brief matmul function into a preallocated matrix, for the products repeated in a loop
+ * @param a the first matrix, n x m
+ * @param b the second matrix, m x p
+ * @param c resized to n x p and set to a b, its storage is reused when it is large enough.
+ * Must not be a or b
+ * @param threads number of threads of the GEMM(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the columns of a are not the rows of b.
+ */
+template <typename T>
+void matmul(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, size_t threads = 1) {
+    if (a.cols() != b.rows()) {
+        throw std::invalid_argument("matmul: the columns of a must be the rows of b");
+    }
+    c.resize(a.rows(), b.cols());
+    if (a.rows() * a.cols() * b.cols() <= _matmul_utils::unrolled_volume) {
+        _matmul_utils::small_gemm(a.data(), b.data(), c.data(), a.rows(), a.cols(), b.cols());
+    } else {
+        _matmul_utils::gemm(a.data(), b.data(), c.data(), a.rows(), a.cols(), b.cols(),
+                            threads);
+    }
+}
+
+/**
+ * @brief matmul function for a matrix of run time size and a vector
+ * @param a the matrix, n x m
+ * @param x the vector, of size m
+ * @return std::vector<T> the product a x. Throws std::invalid_argument if the sizes differ.
+ */
+template <typename T>
+std::vector<T> matmul(const Matrix<T>& a, std::span<const std::type_identity_t<T>> x) {
+    if (a.cols() != x.size()) {
+        throw std::invalid_argument("matmul: the columns of a must be the size of x");
+    }
+    std::vector<T> y(a.rows());
+    for (size_t i = 0; i < a.rows(); i++) {
+        T sum = T(0);
+        const T* row = a.data() + i * a.cols();
+        for (size_t j = 0; j < a.cols(); j++) {
+            sum += row[j] * x[j];
+        }
+        y[i] = sum;
+    }
+    return y;
+}
+
+/**
+ * @brief operator * for two matrices of run time sizes, matmul on one thread
+ */
+template <typename T> Matrix<T> operator*(const Matrix<T>& a, const Matrix<T>& b) {
+    return matmul(a, b);
+}
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "mat_expr.h"
+#include "mat_view.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ *@brief Class for a dense matrix whose shape is given at run time
+ * The elements are kept contiguous in row major order in one allocation aligned to a cache
+ * line, so a row is a contiguous range and the whole matrix can be handed to the GEMM
+ * kernels of matmul.h. The arithmetic operators build the same expressions as for Mat1d and
+ * Mat2d, evaluated in one pass when they are assigned to a matrix, the shapes are checked
+ * when the expression is built.
+ */
+template <typename T> class Matrix {
+  private:
+    size_t _rows{0};
+    size_t _cols{0};
+    std::vector<T, _mat_utils::aligned_allocator<T>> arr;
+
+  public:
+    using value_type = T;
+    static constexpr size_t expr_dims = 2;
+    static constexpr size_t expr_rows = _mat_utils::dynamic;
+    static constexpr size_t expr_cols = _mat_utils::dynamic;
+    static constexpr bool is_mat_expr = true;
+    static constexpr bool is_mat_leaf = true;
+    static constexpr bool is_mat_scalar = false;
+
+    /**
+     *@brief constructor for Matrix class, an empty 0 x 0 matrix
+     */
+    Matrix() = default;
+
+    /**
+     *@brief constructor for Matrix class with initializer value
+     *@param rows the number of rows
+     *@param cols the number of columns
+     *@param val the value of every element. Default = T()
+     */
+    Matrix(size_t rows, size_t cols, const T& val = T())
+        : _rows(rows), _cols(cols), arr(rows * cols, val) {}
+
+    /**
+     *@brief constructor for Matrix class from its rows
+     *@param v the rows, all of the same size. Throws std::invalid_argument otherwise
+     */
+    explicit Matrix(const std::vector<std::vector<T>>& v)
+        : _rows(v.size()), _cols(v.empty() ? 0 : v[0].size()), arr(_rows * _cols) {
+        for (size_t i = 0; i < _rows; i++) {
+            if (v[i].size() != _cols) {
+                throw std::invalid_argument("Matrix: the rows must have the same size");
+            }
+            std::copy(v[i].begin(), v[i].end(), data() + i * _cols);
+        }
+    }
+
+    Matrix(const Matrix& mat) = default;
+    Matrix(Matrix&& mat) noexcept = default;
+    Matrix& operator=(const Matrix& mat) = default;
+    Matrix& operator=(Matrix&& mat) noexcept = default;
+
+    /**
+     *@brief constructor for Matrix class from an expression
+     *@param e the expression, evaluated in one pass
+     */
+    template <typename E>
+        requires(_mat_utils::same_shape<E, Matrix> && !E::is_mat_leaf)
+    Matrix(const E& e) {
+        *this = e;
+    }
+
+    /**
+     *@brief operator = for Matrix class from an expression
+     *@param e the expression, evaluated in one pass, it may hold this matrix. The matrix
+     * takes the shape of e.
+     *@return Matrix&
+     */
+    template <typename E>
+        requires(_mat_utils::same_shape<E, Matrix> && !E::is_mat_leaf)
+    Matrix& operator=(const E& e) {
+        auto [rows, cols] = _mat_utils::extent(e);
+        if (rows != _rows || cols != _cols) {
+            // e cannot hold this matrix, its operands all have the shape of e
+            arr.resize(rows * cols);
+            _rows = rows;
+            _cols = cols;
+        }
+        _mat_utils::assign(data(), e);
+        return *this;
+    }
+
+    /**
+     *@brief operator += for Matrix class
+     *@param e a matrix or an expression of the same shape. Throws std::invalid_argument
+     * otherwise
+     *@return Matrix&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Matrix>
+    Matrix& operator+=(const E& e) {
+        _mat_utils::assign(data(), *this + e);
+        return *this;
+    }
+
+    /**
+     *@brief operator -= for Matrix class
+     *@param e a matrix or an expression of the same shape. Throws std::invalid_argument
+     * otherwise
+     *@return Matrix&
+     */
+    template <typename E>
+        requires _mat_utils::same_shape<E, Matrix>
+    Matrix& operator-=(const E& e) {
+        _mat_utils::assign(data(), *this - e);
+        return *this;
+    }
+
+    /**
+     *@brief operator *= for Matrix class
+     *@param c the scalar
+     *@return Matrix&
+     */
+    Matrix& operator*=(const T& c) {
+        _mat_utils::assign(data(), *this * c);
+        return *this;
+    }
+
+    /**
+     *@brief operator /= for Matrix class
+     *@param c the scalar
+     *@return Matrix&
+     */
+    Matrix& operator/=(const T& c) {
+        _mat_utils::assign(data(), *this / c);
+        return *this;
+    }
+
+    /**
+     *@brief operator (i, j) for Matrix class
+     *@param i index that's pointing to the row
+     *@param j index that's pointing to the column
+     *@return T& the element of row i and column j
+     */
+    T& operator()(size_t i, size_t j) { return arr[i * _cols + j]; }
+    const T& operator()(size_t i, size_t j) const { return arr[i * _cols + j]; }
+
+    /**
+     *@brief data function
+     *@return T* the elements in row major order, aligned to a cache line
+     */
+    T* data() { return arr.data(); }
+    const T* data() const { return arr.data(); }
+
+    /**
+     *@brief eval function, the element i in row major order as an expression
+     */
+    T eval(size_t i) const { return arr[i]; }
+
+    /**
+     *@brief packet function, the elements [i, i + P::width) in row major order as an
+     * expression
+     */
+    template <typename P> P packet(size_t i) const { return P::load(arr.data() + i); }
+
+    /**
+     *@brief expr_extent function, the shape as an expression
+     */
+    std::pair<size_t, size_t> expr_extent() const { return {_rows, _cols}; }
+
+    /**
+     *@brief size function
+     *@return size_t the number of elements
+     */
+    size_t size() const { return arr.size(); }
+
+    /**
+     *@brief empty function
+     *@return true if the matrix has no elements
+     */
+    bool empty() const { return arr.empty(); }
+
+    /**
+     *@brief memory_usage function
+     *@return MEMORY::footprint the elements, the matrix with the header of their array, and
+     *its spare capacity
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::memory_usage(arr);
+        f.control += sizeof(*this) - sizeof(arr);
+        return f;
+    }
+
+    /**
+     *@brief rows function
+     *@return size_t the number of rows
+     */
+    size_t rows() const { return _rows; }
+
+    /**
+     *@brief cols function
+     *@return size_t the number of columns
+     */
+    size_t cols() const { return _cols; }
+
+    /**
+     *@brief resize function, the elements are reset to val
+     *@param rows the number of rows
+     *@param cols the number of columns
+     *@param val the value of every element. Default = T()
+     */
+    void resize(size_t rows, size_t cols, const T& val = T()) {
+        arr.assign(rows * cols, val);
+        _rows = rows;
+        _cols = cols;
+    }
+
+    /**
+     *@brief row function
+     *@param i index that's pointing to the row
+     *@return strided_span<T> a view of the row i, nothing is copied
+     */
+    strided_span<T> row(size_t i) { return strided_span<T>(data() + i * _cols, _cols); }
+    strided_span<const T> row(size_t i) const {
+        return strided_span<const T>(data() + i * _cols, _cols);
+    }
+
+    /**
+     *@brief col function
+     *@param j index that's pointing to the column
+     *@return strided_span<T> a view of the column j, nothing is copied
+     */
+    strided_span<T> col(size_t j) { return strided_span<T>(data() + j, _rows, _cols); }
+    strided_span<const T> col(size_t j) const {
+        return strided_span<const T>(data() + j, _rows, _cols);
+    }
+
+    /**
+     *@brief view function
+     *@return mat_view<T> a view of the whole matrix
+     */
+    mat_view<T> view() { return mat_view<T>(data(), _rows, _cols, _cols); }
+    mat_view<const T> view() const { return mat_view<const T>(data(), _rows, _cols, _cols); }
+
+    /**
+     *@brief submatrix function
+     *@param r the first row
+     *@param c the first column
+     *@param rows the number of rows
+     *@param cols the number of columns
+     *@return mat_view<T> a view of the block, nothing is copied. Throws std::out_of_range
+     * if the block does not fit in the matrix.
+     */
+    mat_view<T> submatrix(size_t r, size_t c, size_t rows, size_t cols) {
+        return view().submatrix(r, c, rows, cols);
+    }
+    mat_view<const T> submatrix(size_t r, size_t c, size_t rows, size_t cols) const {
+        return view().submatrix(r, c, rows, cols);
+    }
+
+    /**
+     *@brief transpose function
+     *@return Matrix the cols x rows transpose, copied by blocks of 32 x 32
+     */
+    Matrix transpose() const {
+        Matrix t;
+        transpose(t);
+        return t;
+    }
+
+    /**
+     *@brief transpose function into a matrix whose storage is reused
+     *@param t resized to cols x rows and set to the transpose, must not be *this
+     */
+    void transpose(Matrix& t) const {
+        constexpr size_t block = 32;
+        t.resize(_cols, _rows);
+        for (size_t ii = 0; ii < _rows; ii += block) {
+            for (size_t jj = 0; jj < _cols; jj += block) {
+                for (size_t i = ii; i < std::min(ii + block, _rows); i++) {
+                    for (size_t j = jj; j < std::min(jj + block, _cols); j++) {
+                        t(j, i) = (*this)(i, j);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     *@brief operator == for Matrix class
+     *@return true if both have the same shape and elements
+     */
+    bool operator==(const Matrix& mat) const {
+        return _rows == mat._rows && _cols == mat._cols && arr == mat.arr;
+    }
+
+    /**
+     *@brief operator << for Matrix class
+     */
+    friend std::ostream& operator<<(std::ostream& out, const Matrix& mat) {
+        out << '[';
+        for (size_t i = 0; i < mat.rows(); i++) {
+            out << '[';
+            for (size_t j = 0; j < mat.cols(); j++) {
+                out << mat(i, j);
+                if (j != mat.cols() - 1) {
+                    out << " ";
+                }
+            }
+            out << ']';
+            if (i != mat.rows() - 1) {
+                out << '\n';
+            }
+        }
+        out << ']';
+        return out;
+    }
+};
+
+#endif
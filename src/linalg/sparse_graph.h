@@ -0,0 +1,81 @@
+#ifndef SPARSE_GRAPH_H
+#define SPARSE_GRAPH_H
+
+#include "../classes/graph/csr_graph.h"
+#include "sparse_matrix.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#endif
+
+/**
+ * @brief adjacency matrix function
+ * The n x n matrix of a csr_graph snapshot, the dense ids of the vertices being the rows
+ * and the columns: the value of (u, v) is the weight of the arc u -> v, or 1 for an
+ * unweighted graph, parallel arcs are summed. An undirected graph gives a symmetric matrix
+ * since its edges are stored both ways.
+ * @param g the snapshot(see graph<T>::csr_view())
+ * @return csr_matrix<double> the adjacency matrix of g.
+ */
+template <typename T> csr_matrix<double> adjacency_matrix(const csr_graph<T>& g) {
+    const size_t n = g.size();
+    std::vector<size_t> offsets(n + 1, 0);
+    std::vector<uint32_t> indices;
+    std::vector<double> values;
+    indices.reserve(g.arcs());
+    values.reserve(g.arcs());
+    std::vector<uint32_t> order;
+    for (size_t u = 0; u < n; u++) {
+        size_t lo = g.offsets()[u], hi = g.offsets()[u + 1];
+        // the arcs of u sorted by target, the snapshot keeps them in insertion order
+        order.resize(hi - lo);
+        std::iota(order.begin(), order.end(), uint32_t(lo));
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return g.targets()[a] < g.targets()[b];
+        });
+        size_t begin = indices.size();
+        for (uint32_t k : order) {
+            double w = g.weighted() ? g.weights()[k] : 1.0;
+            if (indices.size() > begin && indices.back() == g.targets()[k]) {
+                values.back() += w;
+            } else {
+                indices.push_back(g.targets()[k]);
+                values.push_back(w);
+            }
+        }
+        offsets[u + 1] = indices.size();
+    }
+    return csr_matrix<double>(n, n, std::move(offsets), std::move(indices), std::move(values));
+}
+
+/**
+ * @brief to graph function
+ * The snapshot of the graph whose adjacency matrix is a: vertex i is the integer i, every
+ * stored value of (u, v) is an arc u -> v weighted by it.
+ * @param a a square matrix
+ * @param directed true if the graph is directed, a should be symmetric otherwise. Default =
+ * true
+ * @return csr_graph<uint32_t> the weighted snapshot of a. Throws std::invalid_argument if a
+ * is not square.
+ */
+template <typename T> csr_graph<uint32_t> to_graph(const csr_matrix<T>& a, bool directed = true) {
+    if (a.rows() != a.cols()) {
+        throw std::invalid_argument("to_graph: the matrix must be square");
+    }
+    vertex_index<uint32_t> ids;
+    ids.reserve(a.rows());
+    for (size_t u = 0; u < a.rows(); u++) {
+        ids.intern(uint32_t(u));
+    }
+    std::vector<double> weights(a.values().begin(), a.values().end());
+    return csr_graph<uint32_t>(std::move(ids),
+                               std::vector<size_t>(a.offsets().begin(), a.offsets().end()),
+                               std::vector<uint32_t>(a.indices().begin(), a.indices().end()),
+                               std::move(weights), directed);
+}
+
+#endif
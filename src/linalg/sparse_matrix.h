@@ -0,0 +1,551 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include "../helpers/parallel.h"
+#include "matrix.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief coo matrix class
+ * Builder of a sparse matrix from (row, column, value) triplets in any order, duplicates
+ * included: they are summed when it is converted to a csr_matrix or a csc_matrix.
+ * @tparam T the type of the values
+ */
+template <typename T> class coo_matrix {
+  public:
+    /**
+     * @brief Construct a new coo matrix object
+     * @param rows the number of rows
+     * @param cols the number of columns
+     * Throws std::length_error if a dimension does not fit in 32 bits.
+     */
+    coo_matrix(size_t rows, size_t cols) : _rows(rows), _cols(cols) {
+        if (rows > size_t(UINT32_MAX) || cols > size_t(UINT32_MAX)) {
+            throw std::length_error("coo_matrix: the dimensions must fit in 32 bits");
+        }
+    }
+
+    /**
+     * @brief add function
+     * @param i the row
+     * @param j the column
+     * @param value the value, added to the other values of (i, j)
+     * Throws std::out_of_range if (i, j) is not in the matrix.
+     */
+    void add(size_t i, size_t j, const T& value) {
+        if (i >= _rows || j >= _cols) {
+            throw std::out_of_range("coo_matrix: the entry is not in the matrix");
+        }
+        _row.push_back(uint32_t(i));
+        _col.push_back(uint32_t(j));
+        _values.push_back(value);
+    }
+
+    /**
+     * @brief reserve function
+     * @param n the number of triplets we expect to add
+     */
+    void reserve(size_t n) {
+        _row.reserve(n);
+        _col.reserve(n);
+        _values.reserve(n);
+    }
+
+    size_t rows() const { return _rows; }
+    size_t cols() const { return _cols; }
+
+    /**
+     * @brief size function
+     * @return size_t the number of triplets, duplicates included.
+     */
+    size_t size() const { return _values.size(); }
+
+    std::span<const uint32_t> row_indices() const { return _row; }
+    std::span<const uint32_t> col_indices() const { return _col; }
+    std::span<const T> values() const { return _values; }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the values, their row and column indices as node overhead,
+     * the matrix with the headers of the arrays and their spare capacity.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_values);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_row) + MEMORY::heap_usage(_col));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    size_t _rows;
+    size_t _cols;
+    std::vector<uint32_t> _row;
+    std::vector<uint32_t> _col;
+    std::vector<T> _values;
+};
+
+namespace _sparse_matrix_utils {
+/**
+ * @brief compresses the triplets (major[k], minor[k], values[k]) into offsets over the
+ * major dimension, with the minor indices of every line sorted and the duplicates summed
+ */
+template <typename T>
+void compress(size_t majors, std::span<const uint32_t> major, std::span<const uint32_t> minor,
+              std::span<const T> values, std::vector<size_t>& offsets,
+              std::vector<uint32_t>& indices, std::vector<T>& out) {
+    // a counting sort by major index keeps the triplets of a line in insertion order
+    offsets.assign(majors + 1, 0);
+    for (uint32_t m : major) {
+        offsets[m + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    std::vector<uint32_t> order(major.size());
+    for (size_t k = 0; k < major.size(); k++) {
+        order[next[major[k]]++] = uint32_t(k);
+    }
+    indices.clear();
+    out.clear();
+    indices.reserve(major.size());
+    out.reserve(major.size());
+    size_t begin = 0;
+    for (size_t m = 0; m < majors; m++) {
+        auto lo = order.begin() + offsets[m], hi = order.begin() + offsets[m + 1];
+        std::stable_sort(lo, hi, [&](uint32_t a, uint32_t b) { return minor[a] < minor[b]; });
+        for (auto it = lo; it != hi; ++it) {
+            if (indices.size() > begin && indices.back() == minor[*it]) {
+                out.back() += values[*it];
+            } else {
+                indices.push_back(minor[*it]);
+                out.push_back(values[*it]);
+            }
+        }
+        offsets[m] = begin;
+        begin = indices.size();
+    }
+    offsets[majors] = begin;
+}
+
+/**
+ * @brief the first line of every one of parts ranges of lines with about the same number
+ * of stored values, parts + 1 bounds
+ */
+inline std::vector<size_t> balance(std::span<const size_t> offsets, size_t parts) {
+    size_t lines = offsets.size() - 1, nnz = offsets.back();
+    std::vector<size_t> bounds(parts + 1, lines);
+    bounds[0] = 0;
+    for (size_t t = 1; t < parts; t++) {
+        size_t target = nnz / parts * t + nnz % parts * t / parts;
+        bounds[t] = size_t(std::lower_bound(offsets.begin(), offsets.end(), target) -
+                           offsets.begin());
+        bounds[t] = std::clamp(bounds[t], bounds[t - 1], lines);
+    }
+    return bounds;
+}
+} // namespace _sparse_matrix_utils
+
+/**
+ * @brief csr matrix class
+ * Compressed sparse row matrix: the columns of the values of row i are
+ * indices()[offsets()[i] .. offsets()[i + 1]), sorted, and their values sit at the same
+ * positions in values(), so a row is two contiguous ranges. The products are split over
+ * ranges of rows with about the same number of values, on several threads.
+ * @tparam T the type of the values
+ */
+template <typename T> class csr_matrix {
+  public:
+    using value_type = T;
+
+    /**
+     * @brief Construct a new csr matrix object, rows x cols and without values
+     */
+    explicit csr_matrix(size_t rows = 0, size_t cols = 0)
+        : _rows(rows), _cols(cols), _offsets(rows + 1, 0) {}
+
+    /**
+     * @brief Construct a new csr matrix object from triplets, the duplicates are summed
+     */
+    explicit csr_matrix(const coo_matrix<T>& coo) : _rows(coo.rows()), _cols(coo.cols()) {
+        _sparse_matrix_utils::compress(_rows, coo.row_indices(), coo.col_indices(),
+                                       coo.values(), _offsets, _indices, _values);
+    }
+
+    /**
+     * @brief Construct a new csr matrix object from already built csr arrays
+     * @param rows the number of rows
+     * @param cols the number of columns
+     * @param offsets rows + 1 offsets
+     * @param indices the column of every value, sorted in every row
+     * @param values the values
+     * Throws std::invalid_argument if the arrays do not describe a rows x cols matrix.
+     */
+    csr_matrix(size_t rows, size_t cols, std::vector<size_t> offsets,
+               std::vector<uint32_t> indices, std::vector<T> values)
+        : _rows(rows), _cols(cols), _offsets(std::move(offsets)), _indices(std::move(indices)),
+          _values(std::move(values)) {
+        if (_offsets.size() != rows + 1 || _offsets[0] != 0 ||
+            _offsets.back() != _indices.size() || _indices.size() != _values.size()) {
+            throw std::invalid_argument("csr_matrix: the arrays do not match");
+        }
+        for (size_t i = 0; i < rows; i++) {
+            if (_offsets[i] > _offsets[i + 1]) {
+                throw std::invalid_argument("csr_matrix: the offsets must not decrease");
+            }
+            for (size_t k = _offsets[i]; k < _offsets[i + 1]; k++) {
+                if (_indices[k] >= cols || (k > _offsets[i] && _indices[k - 1] >= _indices[k])) {
+                    throw std::invalid_argument("csr_matrix: the columns must be sorted");
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief from dense function
+     * @param a a dense matrix
+     * @return csr_matrix the non zero elements of a.
+     */
+    static csr_matrix from_dense(const Matrix<T>& a) {
+        csr_matrix s(a.rows(), a.cols());
+        for (size_t i = 0; i < a.rows(); i++) {
+            for (size_t j = 0; j < a.cols(); j++) {
+                if (a(i, j) != T(0)) {
+                    s._indices.push_back(uint32_t(j));
+                    s._values.push_back(a(i, j));
+                }
+            }
+            s._offsets[i + 1] = s._indices.size();
+        }
+        return s;
+    }
+
+    size_t rows() const { return _rows; }
+    size_t cols() const { return _cols; }
+
+    /**
+     * @brief nnz function
+     * @return size_t the number of stored values.
+     */
+    size_t nnz() const { return _values.size(); }
+
+    std::span<const size_t> offsets() const { return _offsets; }
+    std::span<const uint32_t> indices() const { return _indices; }
+    std::span<const T> values() const { return _values; }
+
+    /**
+     * @brief mutable values, the structure of the matrix stays the same
+     */
+    std::span<T> values() { return _values; }
+
+    /**
+     * @brief row indices function
+     * @param i the row
+     * @return std::span<const uint32_t> the sorted columns of the values of row i.
+     */
+    std::span<const uint32_t> row_indices(size_t i) const {
+        return std::span<const uint32_t>(_indices).subspan(_offsets[i],
+                                                           _offsets[i + 1] - _offsets[i]);
+    }
+
+    /**
+     * @brief row values function
+     * @param i the row
+     * @return std::span<const T> the values of row i, in the order of row_indices(i).
+     */
+    std::span<const T> row_values(size_t i) const {
+        return std::span<const T>(_values).subspan(_offsets[i], _offsets[i + 1] - _offsets[i]);
+    }
+
+    /**
+     * @brief operator (i, j) for csr_matrix class
+     * @return T the element of row i and column j, 0 if it is not stored. O(log(nnz of row)).
+     */
+    T operator()(size_t i, size_t j) const {
+        std::span<const uint32_t> cols = row_indices(i);
+        auto it = std::lower_bound(cols.begin(), cols.end(), uint32_t(j));
+        return it != cols.end() && *it == j ? _values[_offsets[i] + (it - cols.begin())] : T(0);
+    }
+
+    /**
+     * @brief multiply function, the sparse matrix vector product
+     * @param x the vector, of size cols()
+     * @param threads number of threads(0 means every hardware thread). Default = 1
+     * @return std::vector<T> A x. Throws std::invalid_argument if the sizes differ.
+     */
+    std::vector<T> multiply(std::span<const T> x, size_t threads = 1) const {
+        if (x.size() != _cols) {
+            throw std::invalid_argument("csr_matrix: the size of x must be cols()");
+        }
+        std::vector<T> y(_rows, T(0));
+        _for_rows(threads, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; i++) {
+                T sum = T(0);
+                for (size_t k = _offsets[i]; k < _offsets[i + 1]; k++) {
+                    sum += _values[k] * x[_indices[k]];
+                }
+                y[i] = sum;
+            }
+        });
+        return y;
+    }
+
+    /**
+     * @brief multiply transposed function, the product of the transpose and a vector
+     * @param x the vector, of size rows()
+     * @param threads number of threads(0 means every hardware thread). Default = 1
+     * @return std::vector<T> A^T x, every thread scatters into a vector of its own. Throws
+     * std::invalid_argument if the sizes differ.
+     */
+    std::vector<T> multiply_transposed(std::span<const T> x, size_t threads = 1) const {
+        if (x.size() != _rows) {
+            throw std::invalid_argument("csr_matrix: the size of x must be rows()");
+        }
+        threads = PARALLEL::resolve_threads(threads, nnz() / 4096 + 1);
+        std::vector<std::vector<T>> partial(threads);
+        std::vector<size_t> bounds = _sparse_matrix_utils::balance(_offsets, threads);
+        PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t t = lo; t < hi; t++) {
+                std::vector<T>& y = partial[t];
+                y.assign(_cols, T(0));
+                for (size_t i = bounds[t]; i < bounds[t + 1]; i++) {
+                    for (size_t k = _offsets[i]; k < _offsets[i + 1]; k++) {
+                        y[_indices[k]] += _values[k] * x[i];
+                    }
+                }
+            }
+        });
+        for (size_t t = 1; t < threads; t++) {
+            for (size_t j = 0; j < _cols; j++) {
+                partial[0][j] += partial[t][j];
+            }
+        }
+        return std::move(partial[0]);
+    }
+
+    /**
+     * @brief multiply function, the product of the sparse matrix and a dense one
+     * @param b the dense matrix, cols() x p
+     * @param threads number of threads(0 means every hardware thread). Default = 1
+     * @return Matrix<T> the rows() x p product A b, a row of A adds the rows of b it
+     * selects. Throws std::invalid_argument if the sizes differ.
+     */
+    Matrix<T> multiply(const Matrix<T>& b, size_t threads = 1) const {
+        if (b.rows() != _cols) {
+            throw std::invalid_argument("csr_matrix: the rows of b must be cols()");
+        }
+        const size_t p = b.cols();
+        Matrix<T> c(_rows, p);
+        _for_rows(threads, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; i++) {
+                T* out = c.data() + i * p;
+                for (size_t k = _offsets[i]; k < _offsets[i + 1]; k++) {
+                    const T v = _values[k];
+                    const T* in = b.data() + size_t(_indices[k]) * p;
+                    for (size_t j = 0; j < p; j++) {
+                        out[j] += v * in[j];
+                    }
+                }
+            }
+        });
+        return c;
+    }
+
+    /**
+     * @brief transpose function
+     * @return csr_matrix the cols() x rows() transpose, in O(rows + cols + nnz).
+     */
+    csr_matrix transpose() const {
+        csr_matrix t(_cols, _rows);
+        for (uint32_t j : _indices) {
+            t._offsets[j + 1]++;
+        }
+        std::partial_sum(t._offsets.begin(), t._offsets.end(), t._offsets.begin());
+        std::vector<size_t> next(t._offsets.begin(), t._offsets.end() - 1);
+        t._indices.resize(nnz());
+        t._values.resize(nnz());
+        // the rows are visited in order, so the columns of t come out sorted
+        for (size_t i = 0; i < _rows; i++) {
+            for (size_t k = _offsets[i]; k < _offsets[i + 1]; k++) {
+                size_t at = next[_indices[k]]++;
+                t._indices[at] = uint32_t(i);
+                t._values[at] = _values[k];
+            }
+        }
+        return t;
+    }
+
+    /**
+     * @brief to dense function
+     * @return Matrix<T> the dense rows() x cols() matrix.
+     */
+    Matrix<T> to_dense() const {
+        Matrix<T> a(_rows, _cols);
+        for (size_t i = 0; i < _rows; i++) {
+            for (size_t k = _offsets[i]; k < _offsets[i + 1]; k++) {
+                a(i, _indices[k]) = _values[k];
+            }
+        }
+        return a;
+    }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the values, their column indices and the offsets of the rows
+     * as node overhead, the matrix with the headers of the arrays and their spare capacity.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = MEMORY::heap_usage(_values);
+        f += MEMORY::as_overhead(MEMORY::heap_usage(_indices) + MEMORY::heap_usage(_offsets));
+        f.control += sizeof(*this);
+        return f;
+    }
+
+  private:
+    size_t _rows;
+    size_t _cols;
+    std::vector<size_t> _offsets;
+    std::vector<uint32_t> _indices;
+    std::vector<T> _values;
+
+    // f(lo, hi) over ranges of rows with about the same number of values
+    template <typename F> void _for_rows(size_t threads, F&& f) const {
+        threads = PARALLEL::resolve_threads(threads, nnz() / 4096 + 1);
+        if (threads == 1) {
+            f(size_t(0), _rows);
+            return;
+        }
+        std::vector<size_t> bounds = _sparse_matrix_utils::balance(_offsets, threads);
+        PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t t = lo; t < hi; t++) {
+                f(bounds[t], bounds[t + 1]);
+            }
+        });
+    }
+};
+
+/**
+ * @brief csc matrix class
+ * Compressed sparse column matrix: the rows of the values of column j are
+ * indices()[offsets()[j] .. offsets()[j + 1]), sorted. It is stored as the csr_matrix of
+ * its transpose, so the two share their kernels and convert into each other with one
+ * transpose.
+ * @tparam T the type of the values
+ */
+template <typename T> class csc_matrix {
+  public:
+    using value_type = T;
+
+    /**
+     * @brief Construct a new csc matrix object, rows x cols and without values
+     */
+    explicit csc_matrix(size_t rows = 0, size_t cols = 0) : _t(cols, rows) {}
+
+    /**
+     * @brief Construct a new csc matrix object from triplets, the duplicates are summed
+     */
+    explicit csc_matrix(const coo_matrix<T>& coo) : _t(_transposed(coo)) {}
+
+    /**
+     * @brief Construct a new csc matrix object from a csr matrix
+     */
+    explicit csc_matrix(const csr_matrix<T>& a) : _t(a.transpose()) {}
+
+    size_t rows() const { return _t.cols(); }
+    size_t cols() const { return _t.rows(); }
+    size_t nnz() const { return _t.nnz(); }
+
+    std::span<const size_t> offsets() const { return _t.offsets(); }
+    std::span<const uint32_t> indices() const { return _t.indices(); }
+    std::span<const T> values() const { return _t.values(); }
+
+    /**
+     * @brief col indices function
+     * @param j the column
+     * @return std::span<const uint32_t> the sorted rows of the values of column j.
+     */
+    std::span<const uint32_t> col_indices(size_t j) const { return _t.row_indices(j); }
+
+    /**
+     * @brief col values function
+     * @param j the column
+     * @return std::span<const T> the values of column j, in the order of col_indices(j).
+     */
+    std::span<const T> col_values(size_t j) const { return _t.row_values(j); }
+
+    /**
+     * @brief operator (i, j) for csc_matrix class
+     * @return T the element of row i and column j, 0 if it is not stored.
+     */
+    T operator()(size_t i, size_t j) const { return _t(j, i); }
+
+    /**
+     * @brief multiply function, the sparse matrix vector product
+     * @param x the vector, of size cols()
+     * @param threads number of threads(0 means every hardware thread). Default = 1
+     * @return std::vector<T> A x.
+     */
+    std::vector<T> multiply(std::span<const T> x, size_t threads = 1) const {
+        return _t.multiply_transposed(x, threads);
+    }
+
+    /**
+     * @brief multiply transposed function
+     * @param x the vector, of size rows()
+     * @param threads number of threads(0 means every hardware thread). Default = 1
+     * @return std::vector<T> A^T x.
+     */
+    std::vector<T> multiply_transposed(std::span<const T> x, size_t threads = 1) const {
+        return _t.multiply(x, threads);
+    }
+
+    /**
+     * @brief transpose function
+     * @return csr_matrix<T> the transpose, which is the storage of this matrix.
+     */
+    const csr_matrix<T>& transpose() const { return _t; }
+
+    /**
+     * @brief to csr function
+     * @return csr_matrix<T> the same matrix in compressed sparse rows.
+     */
+    csr_matrix<T> to_csr() const { return _t.transpose(); }
+
+    /**
+     * @brief to dense function
+     * @return Matrix<T> the dense rows() x cols() matrix.
+     */
+    Matrix<T> to_dense() const { return _t.to_dense().transpose(); }
+
+    /**
+     * @brief memory_usage function
+     * @return MEMORY::footprint the footprint of the transpose it stores.
+     */
+    MEMORY::footprint memory_usage() const {
+        MEMORY::footprint f = _t.memory_usage();
+        f.control += sizeof(*this) - sizeof(_t);
+        return f;
+    }
+
+  private:
+    csr_matrix<T> _t;
+
+    static csr_matrix<T> _transposed(const coo_matrix<T>& coo) {
+        coo_matrix<T> t(coo.cols(), coo.rows());
+        t.reserve(coo.size());
+        for (size_t k = 0; k < coo.size(); k++) {
+            t.add(coo.col_indices()[k], coo.row_indices()[k], coo.values()[k]);
+        }
+        return csr_matrix<T>(t);
+    }
+};
+
+#endif
@@ -1,11 +1,176 @@
 #ifndef ACTIVATION_FUNCTIONS_H
 #define ACTIVATION_FUNCTIONS_H
 
+#include "../../linalg/mat_expr.h"
+
 #ifdef __cplusplus
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <limits>
+#include <span>
 #include <vector>
 #endif
 
+namespace _activation_utils {
+#if defined(__AVX2__)
+/**
+ * @brief exp of every lane: x = n ln2 + r with |r| <= ln2 / 2, a polynomial of r times the
+ * 2^n built in the exponent bits. Relative error about 1e-15, the inputs are clamped to the
+ * range where the result is finite and normal.
+ */
+inline _mat_utils::simd<double> exp(_mat_utils::simd<double> p) {
+    __m256d x = _mm256_min_pd(_mm256_max_pd(p.v, _mm256_set1_pd(-708.0)),
+                              _mm256_set1_pd(709.0));
+    __m256d n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    // ln2 in two parts, so n * ln2_hi is exact
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(6.93145751953125e-1)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(1.42860682030941723212e-6)));
+    // Taylor series to r^11 / 11!, below an ulp on [-ln2 / 2, ln2 / 2]
+    static constexpr double c[] = {1.0 / 39916800, 1.0 / 3628800, 1.0 / 362880, 1.0 / 40320,
+                                   1.0 / 5040,     1.0 / 720,     1.0 / 120,    1.0 / 24,
+                                   1.0 / 6,        0.5,           1.0,          1.0};
+    __m256d y = _mm256_set1_pd(c[0]);
+    for (size_t k = 1; k < std::size(c); k++) {
+        y = _mm256_add_pd(_mm256_mul_pd(y, r), _mm256_set1_pd(c[k]));
+    }
+    __m256i e = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+    e = _mm256_slli_epi64(_mm256_add_epi64(e, _mm256_set1_epi64x(1023)), 52);
+    return {_mm256_mul_pd(y, _mm256_castsi256_pd(e))};
+}
+
+/**
+ * @brief exp of every lane in float, relative error about 2e-7
+ */
+inline _mat_utils::simd<float> exp(_mat_utils::simd<float> p) {
+    __m256 x = _mm256_min_ps(_mm256_max_ps(p.v, _mm256_set1_ps(-87.0f)), _mm256_set1_ps(88.0f));
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+    static constexpr float c[] = {1.0f / 5040, 1.0f / 720, 1.0f / 120, 1.0f / 24,
+                                  1.0f / 6,    0.5f,       1.0f,       1.0f};
+    __m256 y = _mm256_set1_ps(c[0]);
+    for (size_t k = 1; k < std::size(c); k++) {
+        y = _mm256_add_ps(_mm256_mul_ps(y, r), _mm256_set1_ps(c[k]));
+    }
+    __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)),
+                                  23);
+    return {_mm256_mul_ps(y, _mm256_castsi256_ps(e))};
+}
+
+template <typename T> constexpr bool has_exp = _mat_utils::simd<T>::enabled;
+#else
+template <typename T> constexpr bool has_exp = false;
+#endif
+
+/**
+ * @brief x[i] = f(x[i]) over the registers of x with packet(P) and its tail with scalar(T)
+ */
+template <typename T, typename Packet, typename Scalar>
+void map(T* x, size_t n, Packet&& packet, Scalar&& scalar) {
+    size_t i = 0;
+    if constexpr (has_exp<T>) {
+        using P = _mat_utils::simd<T>;
+        for (; i + P::width <= n; i += P::width) {
+            packet(P::load(x + i)).store(x + i);
+        }
+    }
+    for (; i < n; i++) {
+        x[i] = scalar(x[i]);
+    }
+}
+
+/**
+ * @brief the sum of exp(x[i] - shift), stored back into x if store
+ */
+template <typename T> T exp_sum(T* x, size_t n, T shift, bool store) {
+    size_t i = 0;
+    T sum = 0;
+    if constexpr (has_exp<T>) {
+        using P = _mat_utils::simd<T>;
+        P acc = P::broadcast(T(0)), s = P::broadcast(shift);
+        for (; i + P::width <= n; i += P::width) {
+            P e = exp(P::load(x + i) - s);
+            acc = acc + e;
+            if (store) {
+                e.store(x + i);
+            }
+        }
+        T lanes[P::width];
+        acc.store(lanes);
+        for (size_t l = 0; l < P::width; l++) {
+            sum += lanes[l];
+        }
+    }
+    for (; i < n; i++) {
+        T e = std::exp(x[i] - shift);
+        sum += e;
+        if (store) {
+            x[i] = e;
+        }
+    }
+    return sum;
+}
+
+template <typename T> T max(const T* x, size_t n) {
+    T top = -std::numeric_limits<T>::infinity();
+    for (size_t i = 0; i < n; i++) {
+        top = std::max(top, x[i]);
+    }
+    return top;
+}
+
+template <typename T> void sigmoid(T* x, size_t n) {
+    map(
+        x, n,
+        [](auto p) {
+            using P = decltype(p);
+            return P::broadcast(T(1)) / (P::broadcast(T(1)) + exp(-p));
+        },
+        [](T v) { return T(1) / (T(1) + std::exp(-v)); });
+}
+
+template <typename T> void tanh(T* x, size_t n) {
+    // 1 - 2 / (exp(2x) + 1), within a few ulps of 1 of tanh
+    map(
+        x, n,
+        [](auto p) {
+            using P = decltype(p);
+            P one = P::broadcast(T(1));
+            return one - P::broadcast(T(2)) / (exp(p + p) + one);
+        },
+        [](T v) { return std::tanh(v); });
+}
+
+template <typename T> void relu(T* x, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        x[i] = x[i] > T(0) ? x[i] : T(0);
+    }
+}
+
+// returns the log of the sum of the exponentials, x set to its softmax
+template <typename T> T softmax(T* x, size_t n) {
+    const T top = max(x, n);
+    const T sum = exp_sum(x, n, top, true);
+    const T inv = T(1) / sum;
+    for (size_t i = 0; i < n; i++) {
+        x[i] *= inv;
+    }
+    return top + std::log(sum);
+}
+
+template <typename T> T log_softmax(T* x, size_t n) {
+    const T top = max(x, n);
+    const T lse = top + std::log(exp_sum(x, n, top, false));
+    for (size_t i = 0; i < n; i++) {
+        x[i] -= lse;
+    }
+    return lse;
+}
+} // namespace _activation_utils
+
 namespace activation {
 /**
  * @brief sigmoid activation function
@@ -16,6 +181,22 @@ inline double sigmoid(const double x) {
     return 1.0 / (1.0 + exp(-x));
 }
 
+/**
+ * @brief sigmoid activation function in place
+ * With AVX2 the exponentials are the polynomial approximations of _activation_utils::exp,
+ * within a few ulps of std::exp, four doubles or eight floats at a time.
+ * @param x: the values, set to their sigmoid
+ */
+inline void sigmoid(std::span<double> x) { _activation_utils::sigmoid(x.data(), x.size()); }
+inline void sigmoid(std::span<float> x) { _activation_utils::sigmoid(x.data(), x.size()); }
+
+/**
+ * @brief tanh activation function in place
+ * @param x: the values, set to their tanh, within a few ulps of 1 with AVX2
+ */
+inline void tanh(std::span<double> x) { _activation_utils::tanh(x.data(), x.size()); }
+inline void tanh(std::span<float> x) { _activation_utils::tanh(x.data(), x.size()); }
+
 /**
  * @brief ReLU activation function
  * @param x(double): the input value
@@ -24,6 +205,13 @@ inline double ReLU(const double x) {
     return std::fmax(0, x);
 }
 
+/**
+ * @brief ReLU activation function in place
+ * @param x: the values, the negative ones set to 0
+ */
+inline void ReLU(std::span<double> x) { _activation_utils::relu(x.data(), x.size()); }
+inline void ReLU(std::span<float> x) { _activation_utils::relu(x.data(), x.size()); }
+
 /**
  * @brief LeakyReLU activation function
  * @param x(double): the input value
@@ -36,23 +224,43 @@ inline double LeakyReLU(const double x, const double a = 0.01) {
     return x;
 }
 
+/**
+ * @brief softmax activation function in place
+ * The largest logit is subtracted before the exponentials, which are summed as they are
+ * stored, so no logit overflows and the values are read three times: for the largest, the
+ * exponentials and the scaling.
+ * @param logits: the logits, set to their probabilities
+ * @return the log of the sum of the exponentials of the logits, so the cross entropy of class
+ * c is the result minus the logit of c
+ */
+inline double softmax(std::span<double> logits) {
+    return _activation_utils::softmax(logits.data(), logits.size());
+}
+inline float softmax(std::span<float> logits) {
+    return _activation_utils::softmax(logits.data(), logits.size());
+}
+
 /**
  * @brief softmax activation function for multiclass classification
  * @param logits(vector<double>): A vector that holds the logits
  */
 inline std::vector<double> softmax(const std::vector<double>& logits) {
-    double sum_logits = 0;
-    for (const double& x : logits) {
-        sum_logits += exp(x);
-    }
-
-    std::vector<double> probs;
-    for (const double& x : logits) {
-        probs.push_back(exp(x) / sum_logits);
-    }
-
+    std::vector<double> probs = logits;
+    softmax(std::span<double>(probs));
     return probs;
 }
+
+/**
+ * @brief log softmax activation function in place
+ * @param logits: the logits, set to the logs of their probabilities
+ * @return the log of the sum of the exponentials of the logits
+ */
+inline double log_softmax(std::span<double> logits) {
+    return _activation_utils::log_softmax(logits.data(), logits.size());
+}
+inline float log_softmax(std::span<float> logits) {
+    return _activation_utils::log_softmax(logits.data(), logits.size());
+}
 } // namespace activation
 
 #endif
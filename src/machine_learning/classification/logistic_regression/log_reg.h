@@ -1,11 +1,21 @@
 #ifndef LOG_REG_H
 #define LOG_REG_H
 
+#include "../../../helpers/parallel.h"
+#include "../../../linalg/sparse_matrix.h"
+#include "../../dataset/dataset.h"
+
 #ifdef __cplusplus
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <random>
+#include <span>
+#include <stdexcept>
 #include <vector>
 #include "../../activation/activation_functions.h"
 #include "../../metrics/metrics.h"
@@ -22,20 +32,18 @@ class logistic_regression {
     double bias_;
     int epochs_;
     std::vector<double> predictors_;
-    std::vector<std::vector<double>> data_;
+    // the features of a row per row, without the labels
+    Matrix<double> data_;
     std::vector<double> labels_;
 
     /**
      * @brief returns h_theta(x), where x is the input
      * uses metric's sigmoid to compute that.
      */
-    double h_theta(const int index) {
-        double z = this->bias_;
-        for (int i = 0; i < this->predictors_.size(); i++) {
-            z += this->data_[index][i] * this->predictors_[i];
-        }
-
-        return activation::sigmoid(z);
+    double h_theta(const size_t index) {
+        const size_t d = this->predictors_.size();
+        const double* x = this->data_.data() + index * d;
+        return activation::sigmoid(this->bias_ + _mat_utils::dot(x, this->predictors_.data(), d));
     }
 
     /**
@@ -43,7 +51,7 @@ class logistic_regression {
      */
     void verbose_acc_step_() {
         std::vector<double> y_pred;
-        for (int i = 0; i < this->data_.size(); i++) {
+        for (size_t i = 0; i < this->data_.rows(); i++) {
             double h = h_theta(i);
 
             if (h < 0.5) {
@@ -53,10 +61,9 @@ class logistic_regression {
             }
         }
 
-        std::cout << "Accuracy: " << metrics::accuracy_score(this->labels_, y_pred)
-                  << " | f1_score: " << metrics::f1_score(this->labels_, y_pred)
-                  << " | Recall: " << metrics::recall(this->labels_, y_pred)
-                  << " | Precision: " << metrics::precision(this->labels_, y_pred) << '\n';
+        const metrics::confusion_matrix m(this->labels_, y_pred);
+        std::cout << "Accuracy: " << m.accuracy() << " | f1_score: " << m.f1_score()
+                  << " | Recall: " << m.recall() << " | Precision: " << m.precision() << '\n';
     }
 
   public:
@@ -82,10 +89,12 @@ class logistic_regression {
 
         this->learning_rate_ = lr;
         this->epochs_ = epochs;
-        this->data_ = data;
         this->bias_ = bias;
-        for (auto& x : data) {
-            this->labels_.push_back(x.back());
+        const size_t d = data[0].size() - 1;
+        this->data_.resize(data.size(), d);
+        for (size_t i = 0; i < data.size(); i++) {
+            std::copy(data[i].begin(), data[i].begin() + d, this->data_.data() + i * d);
+            this->labels_.push_back(data[i].back());
         }
 
         std::random_device rd;
@@ -103,12 +112,13 @@ class logistic_regression {
      * performs gradient descent using the predictors and learning rate.
      */
     inline void fit() {
+        const size_t d = this->predictors_.size();
         for (int epoch = 0; epoch < this->epochs_; epoch++) {
-            for (size_t j = 0; j < this->data_.size(); j++) {
-                double h = h_theta(j);
-                for (size_t k = 0; k < (this->data_[0].size() - 1); k++) {
-                    double gradient = (h - this->labels_[j]) * this->data_[j][k];
-                    this->predictors_[k] = this->predictors_[k] - (this->learning_rate_ * gradient);
+            for (size_t j = 0; j < this->data_.rows(); j++) {
+                const double step = this->learning_rate_ * (h_theta(j) - this->labels_[j]);
+                const double* x = this->data_.data() + j * d;
+                for (size_t k = 0; k < d; k++) {
+                    this->predictors_[k] -= step * x[k];
                 }
             }
 
@@ -118,4 +128,391 @@ class logistic_regression {
     }
 };
 
+/**
+ * @brief the solvers of logistic_regression_fit
+ * gradient_descent: a step along the gradient of the whole data per iteration
+ * minibatch: epochs of steps along the gradients of shuffled batches of rows
+ * lbfgs: limited memory BFGS with a backtracking line search, the default
+ */
+enum class logistic_solver { gradient_descent, minibatch, lbfgs };
+
+/**
+ * @brief the options of logistic_regression_fit
+ * @param solver: the solver(see logistic_solver). Default = lbfgs
+ * @param max_iterations: the largest number of iterations, epochs for minibatch. Default =
+ * 100
+ * @param tolerance: converged when no partial derivative of the objective is larger, or
+ * for minibatch when the loss of an epoch improves by less than this fraction. Default =
+ * 1e-6
+ * @param learning_rate: the step of gradient_descent and minibatch. Default = 0.1
+ * @param batch_size: the rows of a minibatch step. Default = 256
+ * @param history: the pairs of updates lbfgs keeps. Default = 10
+ * @param l2: the weight of the l2 penalty l2 / 2 * |w|^2, the bias is not penalized.
+ * Default = 0
+ * @param seed: seed of the shuffles of minibatch. Default = 0
+ * @param threads: number of threads(0 means every hardware thread). Default = 0
+ */
+struct logistic_regression_options {
+    logistic_solver solver{logistic_solver::lbfgs};
+    size_t max_iterations{100};
+    double tolerance{1e-6};
+    double learning_rate{0.1};
+    size_t batch_size{256};
+    size_t history{10};
+    double l2{0};
+    uint64_t seed{0};
+    size_t threads{0};
+};
+
+namespace _log_reg_utils {
+// the rows of a row major dense matrix or dataset
+struct dense_rows {
+    dataset_view x;
+
+    size_t rows() const { return x.rows(); }
+    size_t cols() const { return x.cols(); }
+    double dot(size_t i, const double* w) const {
+        return _mat_utils::dot(x.data() + i * x.cols(), w, x.cols());
+    }
+    // g += a * x_i
+    void axpy(size_t i, double a, double* g) const {
+        const double* row = x.data() + i * x.cols();
+        for (size_t j = 0; j < x.cols(); j++) {
+            g[j] += a * row[j];
+        }
+    }
+};
+
+// the rows of a csr matrix, the gradient of a row touches only its stored features
+struct sparse_rows {
+    const csr_matrix<double>& x;
+
+    size_t rows() const { return x.rows(); }
+    size_t cols() const { return x.cols(); }
+    double dot(size_t i, const double* w) const {
+        std::span<const uint32_t> cols = x.row_indices(i);
+        std::span<const double> values = x.row_values(i);
+        double sum = 0;
+        for (size_t k = 0; k < cols.size(); k++) {
+            sum += values[k] * w[cols[k]];
+        }
+        return sum;
+    }
+    void axpy(size_t i, double a, double* g) const {
+        std::span<const uint32_t> cols = x.row_indices(i);
+        std::span<const double> values = x.row_values(i);
+        for (size_t k = 0; k < cols.size(); k++) {
+            g[cols[k]] += a * values[k];
+        }
+    }
+};
+
+inline dense_rows rows_of(dataset_view x) {
+    return {_dataset_utils::row_major(x, "logistic_regression")};
+}
+inline sparse_rows rows_of(const csr_matrix<double>& x) { return {x}; }
+
+/**
+ * @brief the loss log(1 + exp(z)) - y z of a logit z and a label y, finite for any z
+ */
+inline double log_loss(double z, double y) {
+    return std::max(z, 0.0) - z * y + std::log1p(std::exp(-std::abs(z)));
+}
+
+/**
+ * @brief the buffers of a pass: a gradient and a loss per thread
+ */
+struct pass {
+    std::vector<std::vector<double>> partial;
+    std::vector<double> losses;
+};
+
+/**
+ * @brief the fused pass over the rows order[0, m), or [0, m) when order is empty: the
+ * logit, the loss and the gradient of every row in one read of it
+ * @param theta: the d weights then the bias
+ * @param grad: set to the sum of the gradients of the rows by theta, d + 1 values
+ * @return double: the sum of the losses of the rows
+ */
+template <typename X>
+double loss_gradient(const X& x, std::span<const double> y, std::span<const size_t> order,
+                     size_t m, const double* theta, double* grad, size_t threads, pass& p) {
+    const size_t d = x.cols();
+    threads = PARALLEL::resolve_threads(threads, m / 2048 + 1);
+    p.partial.resize(threads);
+    p.losses.assign(threads, 0.0);
+    auto run = [&](size_t lo, size_t hi, double* g, double& loss) {
+        std::fill(g, g + d + 1, 0.0);
+        for (size_t r = lo; r < hi; r++) {
+            const size_t i = order.empty() ? r : order[r];
+            const double z = x.dot(i, theta) + theta[d];
+            loss += log_loss(z, y[i]);
+            // the derivative of the loss by z, sigmoid(z) - y
+            const double e = 1.0 / (1.0 + std::exp(-z)) - y[i];
+            x.axpy(i, e, g);
+            g[d] += e;
+        }
+    };
+    if (threads == 1) {
+        run(0, m, grad, p.losses[0]);
+        return p.losses[0];
+    }
+    for (std::vector<double>& g : p.partial) {
+        g.assign(d + 1, 0.0);
+    }
+    PARALLEL::parallel_for(0, m, threads, [&](size_t lo, size_t hi, size_t t) {
+        run(lo, hi, p.partial[t].data(), p.losses[t]);
+    });
+    // every thread sums a range of the parameters over the gradients of the threads
+    PARALLEL::parallel_for(0, d + 1, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t j = lo; j < hi; j++) {
+            double sum = 0;
+            for (const std::vector<double>& g : p.partial) {
+                sum += g[j];
+            }
+            grad[j] = sum;
+        }
+    });
+    return std::accumulate(p.losses.begin(), p.losses.end(), 0.0);
+}
+
+/**
+ * @brief the objective: the mean loss of the rows and the l2 penalty, its gradient into grad
+ */
+template <typename X>
+double objective(const X& x, std::span<const double> y, std::span<const size_t> order,
+                 size_t m, const std::vector<double>& theta, std::vector<double>& grad,
+                 const logistic_regression_options& opt, pass& p) {
+    const size_t d = x.cols();
+    double f = loss_gradient(x, y, order, m, theta.data(), grad.data(), opt.threads, p) / double(m);
+    for (size_t j = 0; j < d; j++) {
+        grad[j] = grad[j] / double(m) + opt.l2 * theta[j];
+        f += 0.5 * opt.l2 * theta[j] * theta[j];
+    }
+    grad[d] /= double(m);
+    return f;
+}
+
+inline double max_abs(const std::vector<double>& v) {
+    double top = 0;
+    for (double x : v) {
+        top = std::max(top, std::abs(x));
+    }
+    return top;
+}
+
+inline double dot(const std::vector<double>& a, const std::vector<double>& b) {
+    return _mat_utils::dot(a.data(), b.data(), a.size());
+}
+} // namespace _log_reg_utils
+
+/**
+ * @brief the result of logistic_regression_fit
+ * @param weights: the weight of every feature
+ * @param bias: the bias
+ * @param loss: the objective of the result over every row, the mean loss and the penalty
+ * @param iterations: the iterations run, epochs for minibatch
+ * @param converged: true if the tolerance was met before max_iterations
+ */
+struct logistic_regression_result {
+    std::vector<double> weights;
+    double bias{0};
+    double loss{0};
+    size_t iterations{0};
+    bool converged{false};
+
+    /**
+     * @brief predict_proba function
+     * @param x: a Matrix<double>, a row major dataset_view or a csr_matrix<double>, a sample
+     * per row
+     * @param threads: number of threads(0 means every hardware thread). Default = 1
+     * @return std::vector<double>: the probability of the label 1 of every row. Throws
+     * std::invalid_argument if x does not have a column per weight.
+     */
+    template <typename X> std::vector<double> predict_proba(const X& x, size_t threads = 1) const {
+        auto rows = _log_reg_utils::rows_of(x);
+        if (rows.cols() != weights.size()) {
+            throw std::invalid_argument("logistic_regression: x must have a column per weight");
+        }
+        std::vector<double> p(rows.rows());
+        PARALLEL::parallel_for(0, rows.rows(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                p[i] = 1.0 / (1.0 + std::exp(-(rows.dot(i, weights.data()) + bias)));
+            }
+        });
+        return p;
+    }
+
+    /**
+     * @brief predict function
+     * @return std::vector<double>: the label, 0 or 1, of every row of x(see predict_proba)
+     */
+    template <typename X> std::vector<double> predict(const X& x, size_t threads = 1) const {
+        std::vector<double> p = predict_proba(x, threads);
+        for (double& v : p) {
+            v = v < 0.5 ? 0.0 : 1.0;
+        }
+        return p;
+    }
+};
+
+namespace _log_reg_utils {
+template <typename X>
+logistic_regression_result fit(const X& x, std::span<const double> y,
+                               const logistic_regression_options& opt) {
+    const size_t n = x.rows(), d = x.cols();
+    if (n == 0 || y.size() != n) {
+        throw std::invalid_argument("logistic_regression_fit: y must have a label per row");
+    }
+    for (double label : y) {
+        if (label != 0 && label != 1) {
+            throw std::invalid_argument("logistic_regression_fit: the labels must be 0 or 1");
+        }
+    }
+    logistic_regression_result res;
+    std::vector<double> theta(d + 1, 0.0), grad(d + 1);
+    pass p;
+    if (opt.solver == logistic_solver::gradient_descent) {
+        for (; res.iterations < opt.max_iterations; res.iterations++) {
+            objective(x, y, {}, n, theta, grad, opt, p);
+            if (max_abs(grad) <= opt.tolerance) {
+                res.converged = true;
+                break;
+            }
+            for (size_t j = 0; j <= d; j++) {
+                theta[j] -= opt.learning_rate * grad[j];
+            }
+        }
+    } else if (opt.solver == logistic_solver::minibatch) {
+        std::mt19937_64 gen(opt.seed);
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        const size_t batch = std::max<size_t>(1, std::min(opt.batch_size, n));
+        double last = std::numeric_limits<double>::infinity();
+        while (res.iterations < opt.max_iterations) {
+            std::shuffle(order.begin(), order.end(), gen);
+            double loss = 0;
+            for (size_t start = 0; start < n; start += batch) {
+                const size_t m = std::min(batch, n - start);
+                std::span<const size_t> rows(order.data() + start, m);
+                loss += objective(x, y, rows, m, theta, grad, opt, p) * double(m);
+                for (size_t j = 0; j <= d; j++) {
+                    theta[j] -= opt.learning_rate * grad[j];
+                }
+            }
+            res.iterations++;
+            loss /= double(n);
+            if (res.iterations > 1 && last - loss <= opt.tolerance * last) {
+                res.converged = true;
+                break;
+            }
+            last = loss;
+        }
+    } else {
+        // two-loop recursion over the last history pairs s = dtheta, t = dgrad
+        const size_t m = std::max<size_t>(1, opt.history);
+        std::vector<std::vector<double>> s(m), t(m);
+        std::vector<double> rho(m), alpha(m), dir(d + 1), next(d + 1), next_grad(d + 1);
+        std::vector<double> ds(d + 1), dt(d + 1);
+        size_t stored = 0, newest = 0;
+        double f = objective(x, y, {}, n, theta, grad, opt, p);
+        for (; res.iterations < opt.max_iterations; res.iterations++) {
+            if (max_abs(grad) <= opt.tolerance) {
+                res.converged = true;
+                break;
+            }
+            dir = grad;
+            for (size_t k = 0; k < stored; k++) {
+                size_t i = (newest + m - k) % m;
+                alpha[i] = rho[i] * dot(s[i], dir);
+                for (size_t j = 0; j <= d; j++) {
+                    dir[j] -= alpha[i] * t[i][j];
+                }
+            }
+            // the first step is scaled to the size of the gradient, the later ones by s.t / t.t
+            double gamma = stored ? dot(s[newest], t[newest]) / dot(t[newest], t[newest])
+                                  : 1.0 / std::max(1.0, std::sqrt(dot(grad, grad)));
+            for (double& v : dir) {
+                v *= gamma;
+            }
+            for (size_t k = stored; k-- > 0;) {
+                size_t i = (newest + m - k) % m;
+                double beta = rho[i] * dot(t[i], dir);
+                for (size_t j = 0; j <= d; j++) {
+                    dir[j] += s[i][j] * (alpha[i] - beta);
+                }
+            }
+            // backtracking along -dir until the Armijo condition holds
+            const double slope = -dot(grad, dir);
+            double step = 1.0, f_next = f;
+            bool moved = false;
+            for (int tries = 0; tries < 40; tries++, step *= 0.5) {
+                for (size_t j = 0; j <= d; j++) {
+                    next[j] = theta[j] - step * dir[j];
+                }
+                f_next = objective(x, y, {}, n, next, next_grad, opt, p);
+                if (f_next <= f + 1e-4 * step * slope) {
+                    moved = true;
+                    break;
+                }
+            }
+            if (!moved) {
+                // no decrease left in double precision
+                res.converged = true;
+                break;
+            }
+            for (size_t j = 0; j <= d; j++) {
+                ds[j] = next[j] - theta[j];
+                dt[j] = next_grad[j] - grad[j];
+            }
+            // a pair with no curvature would break the recursion, it is dropped
+            if (double st = dot(ds, dt); st > 1e-12) {
+                newest = stored ? (newest + 1) % m : 0;
+                std::swap(s[newest], ds);
+                std::swap(t[newest], dt);
+                ds.resize(d + 1);
+                dt.resize(d + 1);
+                rho[newest] = 1.0 / st;
+                stored = std::min(stored + 1, m);
+            }
+            std::swap(theta, next);
+            std::swap(grad, next_grad);
+            f = f_next;
+        }
+    }
+    res.loss = objective(x, y, {}, n, theta, grad, opt, p);
+    res.bias = theta[d];
+    theta.pop_back();
+    res.weights = std::move(theta);
+    return res;
+}
+} // namespace _log_reg_utils
+
+/**
+ * @brief logistic regression fit function
+ * Fits the weights and the bias of p(y = 1 | x) = sigmoid(w.x + b) by minimizing the mean
+ * log loss plus the l2 penalty. The rows are read in place, contiguous for a Matrix and as
+ * their stored values for a csr_matrix, every pass computing the logits, the losses and
+ * the gradient at once over ranges of rows on several threads, into a gradient per thread
+ * that the threads then sum by ranges of features.
+ * @param x: a Matrix<double>, a row major dataset_view or a csr_matrix<double>, a sample per
+ * row
+ * @param y: the label, 0 or 1, of every row
+ * @param opt: the options(see logistic_regression_options)
+ * @return logistic_regression_result: the weights, the bias and how the solver ended.
+ * Throws std::invalid_argument if y does not have a label per row or a label is not 0 or
+ * 1.
+ */
+inline logistic_regression_result
+logistic_regression_fit(dataset_view x, std::span<const double> y,
+                        const logistic_regression_options& opt = {}) {
+    return _log_reg_utils::fit(_log_reg_utils::rows_of(x), y, opt);
+}
+
+inline logistic_regression_result
+logistic_regression_fit(const csr_matrix<double>& x, std::span<const double> y,
+                        const logistic_regression_options& opt = {}) {
+    return _log_reg_utils::fit(_log_reg_utils::rows_of(x), y, opt);
+}
+
 #endif
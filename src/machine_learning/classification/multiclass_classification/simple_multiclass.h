@@ -2,11 +2,17 @@
 #define SIMPLE_MULTICLASS
 
 #ifdef __cplusplus
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <random>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #include "../../metrics/metrics.h"
+#include "../logistic_regression/log_reg.h"
 #endif
 
 class simple_multi_classification {
@@ -42,10 +48,9 @@ class simple_multi_classification {
             y_pred.push_back(pred_class);
         }
 
-        std::cout << "Accuracy: " << metrics::accuracy_score(this->labels_, y_pred)
-                  << " | F1 Score: " << metrics::f1_score(this->labels_, y_pred)
-                  << " | Recall: " << metrics::recall(this->labels_, y_pred)
-                  << " | Precision: " << metrics::precision(this->labels_, y_pred) << '\n';
+        const metrics::confusion_matrix m(this->labels_, y_pred);
+        std::cout << "Accuracy: " << m.accuracy() << " | F1 Score: " << m.f1_score()
+                  << " | Recall: " << m.recall() << " | Precision: " << m.precision() << '\n';
     }
 
   public:
@@ -124,4 +129,232 @@ class simple_multi_classification {
     }
 };
 
+/**
+ * @brief the ways of splitting a multiclass problem into binary ones
+ * one_vs_rest: a classifier per class, the class against every other one
+ * one_vs_one: a classifier per pair of classes, over the rows of the two classes only
+ */
+enum class multiclass_strategy { one_vs_rest, one_vs_one };
+
+/**
+ * @brief the options of multiclass_fit
+ * @param strategy: how the problem is split(see multiclass_strategy)
+ * @param binary: the options of every binary classifier(see logistic_regression_options),
+ * its threads are ignored, every classifier runs on one thread
+ * @param threads: number of threads the classifiers are trained on(0 means every hardware
+ * thread)
+ */
+struct multiclass_options {
+    multiclass_strategy strategy{multiclass_strategy::one_vs_rest};
+    logistic_regression_options binary{};
+    size_t threads{0};
+};
+
+namespace _multiclass_utils {
+// the rows idx of x, so a one vs one classifier reads the rows of its two classes in place
+template <typename X> struct subset_rows {
+    const X& x;
+    std::span<const size_t> idx;
+
+    size_t rows() const { return idx.size(); }
+    size_t cols() const { return x.cols(); }
+    double dot(size_t i, const double* w) const { return x.dot(idx[i], w); }
+    void axpy(size_t i, double a, double* g) const { x.axpy(idx[i], a, g); }
+};
+
+/**
+ * @brief the number of classes of the labels y, checked to be a label per row, integers
+ * from 0 and every class with a row
+ */
+inline size_t count_classes(std::span<const double> y, size_t rows) {
+    if (rows == 0 || y.size() != rows) {
+        throw std::invalid_argument("multiclass_fit: y must have a label per row");
+    }
+    double top = 0;
+    for (double label : y) {
+        if (!(label >= 0) || label != std::floor(label)) {
+            throw std::invalid_argument("multiclass_fit: the labels must be integers from 0");
+        }
+        top = std::max(top, label);
+    }
+    std::vector<bool> seen(size_t(top) + 1);
+    for (double label : y) {
+        seen[size_t(label)] = true;
+    }
+    if (std::find(seen.begin(), seen.end(), false) != seen.end()) {
+        throw std::invalid_argument("multiclass_fit: every class up to the largest label must "
+                                    "have a row");
+    }
+    return seen.size();
+}
+} // namespace _multiclass_utils
+
+/**
+ * @brief the result of multiclass_fit
+ * @param strategy: the strategy of the classifiers
+ * @param classes: the number of classes, the labels are 0 to classes - 1
+ * @param weights: the weights of a classifier per row, contiguous so a sample is scored by
+ * every classifier in one sweep of this matrix
+ * @param bias: the bias of every classifier
+ * @param pairs: one_vs_one only, the classes (a, b) of every classifier, a positive score
+ * votes for b
+ */
+struct multiclass_result {
+    multiclass_strategy strategy{multiclass_strategy::one_vs_rest};
+    size_t classes{0};
+    Matrix<double> weights;
+    std::vector<double> bias;
+    std::vector<std::pair<size_t, size_t>> pairs;
+
+    /**
+     * @brief decision_function function
+     * @param x: a Matrix<double>, a row major dataset_view or a csr_matrix<double>, a sample
+     * per row
+     * @param threads: number of threads(0 means every hardware thread). Default = 1
+     * @return Matrix<double>: the logit of every classifier for every row, a row per sample.
+     * Throws std::invalid_argument if x does not have a column per weight.
+     */
+    template <typename X> Matrix<double> decision_function(const X& x, size_t threads = 1) const {
+        auto rows = checked(x);
+        Matrix<double> scores(rows.rows(), weights.rows());
+        PARALLEL::parallel_for(0, rows.rows(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                score(rows, i, scores.data() + i * scores.cols());
+            }
+        });
+        return scores;
+    }
+
+    /**
+     * @brief predict function
+     * Every row is scored by all the classifiers while it is in cache, then the class is the
+     * largest score for one_vs_rest and the most votes for one_vs_one, the smallest class on
+     * a tie.
+     * @param x: a Matrix<double>, a row major dataset_view or a csr_matrix<double>, a sample
+     * per row
+     * @param threads: number of threads(0 means every hardware thread). Default = 1
+     * @return std::vector<double>: the class of every row. Throws std::invalid_argument if x
+     * does not have a column per weight.
+     */
+    template <typename X> std::vector<double> predict(const X& x, size_t threads = 1) const {
+        auto rows = checked(x);
+        std::vector<double> labels(rows.rows());
+        threads = PARALLEL::resolve_threads(threads, rows.rows());
+        PARALLEL::parallel_for(0, rows.rows(), threads, [&](size_t lo, size_t hi, size_t) {
+            std::vector<double> z(weights.rows());
+            std::vector<size_t> votes(classes);
+            for (size_t i = lo; i < hi; i++) {
+                score(rows, i, z.data());
+                if (strategy == multiclass_strategy::one_vs_rest) {
+                    labels[i] = double(std::max_element(z.begin(), z.end()) - z.begin());
+                    continue;
+                }
+                std::fill(votes.begin(), votes.end(), 0);
+                for (size_t c = 0; c < pairs.size(); c++) {
+                    votes[z[c] > 0 ? pairs[c].second : pairs[c].first]++;
+                }
+                labels[i] = double(std::max_element(votes.begin(), votes.end()) - votes.begin());
+            }
+        });
+        return labels;
+    }
+
+  private:
+    template <typename X> auto checked(const X& x) const {
+        auto rows = _log_reg_utils::rows_of(x);
+        if (rows.cols() != weights.cols()) {
+            throw std::invalid_argument("multiclass_result: x must have a column per weight");
+        }
+        return rows;
+    }
+
+    template <typename R> void score(const R& rows, size_t i, double* z) const {
+        for (size_t c = 0; c < weights.rows(); c++) {
+            z[c] = rows.dot(i, weights.data() + c * weights.cols()) + bias[c];
+        }
+    }
+};
+
+namespace _multiclass_utils {
+template <typename X>
+multiclass_result fit(const X& x, std::span<const double> y, const multiclass_options& opt) {
+    const size_t n = x.rows(), d = x.cols();
+    multiclass_result res;
+    res.strategy = opt.strategy;
+    res.classes = count_classes(y, n);
+    const size_t k = res.classes;
+    logistic_regression_options binary = opt.binary;
+    binary.threads = 1;
+
+    // the rows of every class, one_vs_one reads its pairs through them
+    std::vector<std::vector<size_t>> members(k);
+    size_t tasks = k;
+    if (opt.strategy == multiclass_strategy::one_vs_one) {
+        for (size_t i = 0; i < n; i++) {
+            members[size_t(y[i])].push_back(i);
+        }
+        for (size_t a = 0; a < k; a++) {
+            for (size_t b = a + 1; b < k; b++) {
+                res.pairs.emplace_back(a, b);
+            }
+        }
+        tasks = res.pairs.size();
+    }
+    res.weights.resize(tasks, d);
+    res.bias.resize(tasks);
+    const size_t threads = PARALLEL::resolve_threads(opt.threads, tasks);
+    // the labels and rows of a classifier, one set per thread, the features are shared
+    std::vector<std::vector<double>> labels(threads);
+    std::vector<std::vector<size_t>> idx(threads);
+    PARALLEL::parallel_for_dynamic(0, tasks, threads, [&](size_t c, size_t tid) {
+        std::vector<double>& t = labels[tid];
+        logistic_regression_result r;
+        if (opt.strategy == multiclass_strategy::one_vs_rest) {
+            t.resize(n);
+            for (size_t i = 0; i < n; i++) {
+                t[i] = y[i] == double(c) ? 1.0 : 0.0;
+            }
+            r = _log_reg_utils::fit(x, t, binary);
+        } else {
+            const std::vector<size_t>& a = members[res.pairs[c].first];
+            const std::vector<size_t>& b = members[res.pairs[c].second];
+            std::vector<size_t>& rows = idx[tid];
+            rows.assign(a.begin(), a.end());
+            rows.insert(rows.end(), b.begin(), b.end());
+            t.assign(a.size(), 0.0);
+            t.resize(rows.size(), 1.0);
+            r = _log_reg_utils::fit(subset_rows<X>{x, rows}, t, binary);
+        }
+        std::copy(r.weights.begin(), r.weights.end(), res.weights.data() + c * d);
+        res.bias[c] = r.bias;
+    });
+    return res;
+}
+} // namespace _multiclass_utils
+
+/**
+ * @brief multiclass fit function
+ * Trains the binary logistic regressions of a one vs rest or a one vs one split on several
+ * threads, each taking the next classifier when it is done with one, so 200 classes are
+ * trained as 200 tasks rather than 200 passes in a row. Every classifier reads the rows of
+ * x in place, only its labels, and for one vs one the indices of the rows of its two
+ * classes, are its own.
+ * @param x: a Matrix<double>, a row major dataset_view or a csr_matrix<double>, a sample per
+ * row
+ * @param y: the class of every row, integers from 0
+ * @param opt: the options(see multiclass_options)
+ * @return multiclass_result: the classifiers. Throws std::invalid_argument if y does not
+ * have a label per row, a label is not an integer from 0 or a class up to the largest
+ * label has no row.
+ */
+inline multiclass_result multiclass_fit(dataset_view x, std::span<const double> y,
+                                        const multiclass_options& opt = {}) {
+    return _multiclass_utils::fit(_log_reg_utils::rows_of(x), y, opt);
+}
+
+inline multiclass_result multiclass_fit(const csr_matrix<double>& x, std::span<const double> y,
+                                        const multiclass_options& opt = {}) {
+    return _multiclass_utils::fit(_log_reg_utils::rows_of(x), y, opt);
+}
+
 #endif
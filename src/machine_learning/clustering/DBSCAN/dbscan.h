@@ -1,11 +1,23 @@
 #ifndef DBSCAN_H
 #define DBSCAN_H
 
+#include "../../../classes/disjoint_set/concurrent_disjoint_set.h"
+#include "../../../classes/spatial/grid_index.h"
+#include "../../../helpers/parallel.h"
+#include "../../../linalg/matrix.h"
+#include "../../dataset/dataset.h"
+#include "../../metrics/metrics.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <iostream>
 #include <map>
 #include <math.h>
+#include <memory>
+#include <numeric>
+#include <span>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -13,14 +25,46 @@
 
 /**
  * @brief DBSCAN clustering algorithm class
+ * The neighbourhoods of the points of the dataset are found with a grid_index of cell Eps,
+ * so a query only looks at the points of the 9 cells around the point instead of the whole
+ * dataset. The points are handled by their position in the dataset: the labels live in an
+ * array indexed by it, and the expansion of a cluster keeps its seeds in one queue of
+ * positions reused by every cluster.
  */
 class DBSCAN {
   private:
+    // the label of the points no expansion has reached yet
+    static constexpr int64_t unclassified = -2;
+
     std::vector<std::pair<double, double>> setOfPoints;
     double Eps;
     int64_t MinPts;
     int64_t cluster_id{0};
-    std::map<std::pair<double, double>, int64_t> points;
+    // the cluster of every point of setOfPoints, -1 for noise
+    std::vector<int64_t> labels;
+    // the grid over setOfPoints, none if Eps is not positive
+    std::unique_ptr<grid_index<2>> index;
+    // the buffers of ExpandCluster
+    std::vector<size_t> seeds, neighbours;
+
+    // the positions of the points at distance at most Eps from setOfPoints[id]
+    void region(size_t id, std::vector<size_t>& out) {
+        out.clear();
+        std::pair<double, double> point = setOfPoints[id];
+        if (index) {
+            index->for_each_candidate({point.first, point.second}, Eps, [&](size_t i) {
+                if (dist(point, setOfPoints[i]) <= Eps) {
+                    out.push_back(i);
+                }
+            });
+            return;
+        }
+        for (size_t i = 0; i < setOfPoints.size(); i++) {
+            if (dist(point, setOfPoints[i]) <= Eps) {
+                out.push_back(i);
+            }
+        }
+    }
 
   public:
     /**
@@ -30,13 +74,21 @@ class DBSCAN {
      * @param MinPts: the minimum points that a cluster should have to exist
      */
     explicit DBSCAN(std::vector<std::pair<double, double>> setOfPoints, double Eps,
-                    int64_t MinPts) noexcept
-        : setOfPoints(setOfPoints), Eps(Eps), MinPts(MinPts) {
-        // cluster_id is by default noise
-
-        for (size_t i = 0; i < setOfPoints.size(); ++i) {
-            if (points.find(setOfPoints[i]) == points.end()) {
-                if (ExpandCluster(setOfPoints, setOfPoints[i], cluster_id, Eps, MinPts)) {
+                    int64_t MinPts)
+        : setOfPoints(std::move(setOfPoints)), Eps(Eps), MinPts(MinPts),
+          labels(this->setOfPoints.size(), unclassified) {
+        const size_t n = this->setOfPoints.size();
+        if (Eps > 0 && std::isfinite(Eps)) {
+            std::vector<std::array<double, 2>> grid(n);
+            for (size_t i = 0; i < n; ++i) {
+                grid[i] = {this->setOfPoints[i].first, this->setOfPoints[i].second};
+            }
+            index = std::make_unique<grid_index<2>>(grid, Eps);
+        }
+        seeds.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            if (labels[i] == unclassified) {
+                if (ExpandCluster(i, cluster_id)) {
                     cluster_id = nextId(cluster_id);
                 }
             }
@@ -51,27 +103,25 @@ class DBSCAN {
 
     /**
      * @brief ExpandCluster function
-     * @param setOfPoints: the input dataset
-     * @param point: the input point
+     * @param id: the position of the point in the dataset
      * @param cluster_id: the input cluster_id
-     * @param Eps: the input diameter
-     * @param MinPts: the minimum points that a cluster should have to exist
-     *
+     * @return true if the point is a core point, its cluster then holds every point
+     * density-reachable from it
      */
-    bool ExpandCluster(std::vector<std::pair<double, double>> setOfPoints,
-                       std::pair<double, double> point, int64_t cluster_id, double Eps,
-                       int64_t MinPts);
+    bool ExpandCluster(size_t id, int64_t cluster_id);
 
     /**
      * @brief get_query function
      * @param setOfPoints: the input dataset
      * @param point: the input point
      * @param Eps: the input diameter
-     *
+     * @return vector<pair<double,double>>: the points of setOfPoints at distance at most Eps
+     * from point, in the order of setOfPoints. The queries on the dataset of the object with
+     * its Eps go through the grid.
      */
     std::vector<std::pair<double, double>>
-    get_query(std::vector<std::pair<double, double>> setOfPoints, std::pair<double, double> point,
-              double Eps);
+    get_query(const std::vector<std::pair<double, double>>& setOfPoints,
+              std::pair<double, double> point, double Eps);
 
     /**
      * @brief dist function
@@ -81,6 +131,13 @@ class DBSCAN {
      */
     double dist(std::pair<double, double> a, std::pair<double, double> b);
 
+    /**
+     * @brief get_labels function
+     * @return const vector<int64_t>&: the cluster of every point of the dataset, in its
+     * order, -1 for noise
+     */
+    const std::vector<int64_t>& get_labels() const { return labels; }
+
     /**
      * @brief get_clusters function
      * @return map<pair<double,double>>: the points and their assignments
@@ -109,58 +166,60 @@ inline int64_t DBSCAN::nextId(int64_t cluster_id) {
     return cluster_id;
 }
 
-bool DBSCAN::ExpandCluster(std::vector<std::pair<double, double>> setOfPoints,
-                           std::pair<double, double> point, int64_t cluster_id, double Eps,
-                           int64_t MinPts) {
-    std::vector<std::pair<double, double>> seeds = get_query(setOfPoints, point, Eps);
-    if (seeds.size() < MinPts) {
+inline bool DBSCAN::ExpandCluster(size_t id, int64_t cluster_id) {
+    region(id, neighbours);
+    if (int64_t(neighbours.size()) < MinPts) {
         // no core point
-        points[point] = -1;
+        labels[id] = -1;
         return false;
-    } else {
-        // we have a core point
-        // all the points in seeds are density-reachable from point
-        for (auto& x : seeds) {
-            points[x] = cluster_id;
-        }
-        for (auto it = seeds.begin(); it != seeds.end(); it++) {
-            if ((*it).first == point.first && (*it).second == point.second) {
-                seeds.erase(it);
-                break;
-            }
+    }
+    // we have a core point
+    // all the points in its region are density-reachable from it, the unclassified ones
+    // are the seeds, the noise ones are border points
+    seeds.clear();
+    labels[id] = cluster_id;
+    for (size_t i : neighbours) {
+        if (labels[i] == unclassified) {
+            seeds.push_back(i);
         }
-
-        while (!seeds.empty()) {
-            auto current = seeds[0];
-            std::vector<std::pair<double, double>> result = get_query(setOfPoints, current, Eps);
-
-            if (result.size() >= MinPts) {
-                for (size_t i = 0; i < result.size(); i++) {
-                    std::pair<double, double> result_p = result[i];
-                    if (points.find(result_p) == points.end() || points[result_p] == -1) {
-                        if (points.find(result_p) == points.end()) {
-                            seeds.push_back(result_p);
-                        }
-                        points[result_p] = cluster_id;
-                    } // unclassified or noise
-                }
-            }
-            for (auto it = seeds.begin(); it != seeds.end(); it++) {
-                if ((*it).first == current.first && (*it).second == current.second) {
-                    seeds.erase(it);
-                    break;
+        if (labels[i] < 0) {
+            labels[i] = cluster_id;
+        }
+    }
+    // the seeds are taken in order, the ones before head are done
+    for (size_t head = 0; head < seeds.size(); head++) {
+        region(seeds[head], neighbours);
+        if (int64_t(neighbours.size()) >= MinPts) {
+            for (size_t i : neighbours) {
+                if (labels[i] == unclassified) {
+                    seeds.push_back(i);
+                    labels[i] = cluster_id;
+                } else if (labels[i] == -1) {
+                    labels[i] = cluster_id;
                 }
             }
         }
-        return true;
     }
-    return false;
+    return true;
 }
 
 inline std::vector<std::pair<double, double>>
-DBSCAN::get_query(std::vector<std::pair<double, double>> setOfPoints,
+DBSCAN::get_query(const std::vector<std::pair<double, double>>& setOfPoints,
                   std::pair<double, double> point, double Eps) {
     std::vector<std::pair<double, double>> ans;
+    if (index && &setOfPoints == &this->setOfPoints && Eps == this->Eps) {
+        std::vector<size_t> near;
+        index->for_each_candidate({point.first, point.second}, Eps, [&](size_t i) {
+            if (dist(point, setOfPoints[i]) <= Eps) {
+                near.push_back(i);
+            }
+        });
+        std::sort(near.begin(), near.end());
+        for (size_t i : near) {
+            ans.push_back(setOfPoints[i]);
+        }
+        return ans;
+    }
     for (size_t i = 0; i < setOfPoints.size(); i++) {
         std::pair<double, double> curr = setOfPoints[i];
         if (dist(point, curr) <= Eps) {
@@ -177,8 +236,8 @@ inline double DBSCAN::dist(std::pair<double, double> a, std::pair<double, double
 inline std::map<std::pair<double, double>, int64_t> DBSCAN::get_clusters() {
     std::map<std::pair<double, double>, int64_t> ans;
     for (size_t i = 0; i < setOfPoints.size(); i++) {
-        if (points[setOfPoints[i]] != -1) {
-            ans[setOfPoints[i]] = points[setOfPoints[i]];
+        if (labels[i] != -1) {
+            ans[setOfPoints[i]] = labels[i];
         }
     }
     return ans;
@@ -187,11 +246,207 @@ inline std::map<std::pair<double, double>, int64_t> DBSCAN::get_clusters() {
 inline std::vector<std::pair<double, double>> DBSCAN::get_noise() {
     std::vector<std::pair<double, double>> ans;
     for (size_t i = 0; i < setOfPoints.size(); i++) {
-        if (points[setOfPoints[i]] == -1) {
+        if (labels[i] == -1) {
             ans.push_back(setOfPoints[i]);
         }
     }
     return ans;
 }
 
+/**
+ * @brief options of dbscan_fit()
+ * @param eps: the radius of the neighbourhoods.
+ * @param min_points: the number of points within eps, the point itself included, that
+ * makes a core point.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @param coordinate_bound: true if the distance of two points is never below their
+ * difference on one coordinate, as for every Minkowski distance. The points are then
+ * sorted on their coordinate of largest variance and only compare to the points within
+ * eps on it, otherwise a point compares to all of them. Always true for the euclidean
+ * default.
+ */
+struct dbscan_options {
+    double eps{0.5};
+    size_t min_points{5};
+    size_t threads{0};
+    bool coordinate_bound{false};
+};
+
+/**
+ * @brief result of dbscan_fit()
+ * @param labels: the cluster of every point, -1 for noise.
+ * @param core: 1 for the core points.
+ * @param clusters: the number of clusters.
+ */
+struct dbscan_result {
+    std::vector<int64_t> labels;
+    std::vector<uint8_t> core;
+    size_t clusters{0};
+};
+
+namespace _dbscan_utils {
+/**
+ * @brief dbscan_fit with the neighbourhoods metric(x, y) <= radius, the sorted coordinate
+ * is compared to opt.eps
+ */
+template <typename Metric>
+dbscan_result fit(dataset_view points, const dbscan_options& opt, Metric& metric, double radius) {
+    const size_t n = points.rows(), d = points.cols();
+    const double eps = opt.eps;
+    if (!(eps >= 0)) {
+        throw std::invalid_argument("dbscan_fit: eps must not be negative");
+    }
+    if (n > size_t(UINT32_MAX)) {
+        throw std::length_error("dbscan_fit: too many points");
+    }
+    // the points are scanned by rank, in the order of their coordinate of largest variance
+    std::vector<uint32_t> order(n), rank(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<double> key;
+    const bool bounded = opt.coordinate_bound && d > 0 && n > 0;
+    if (bounded) {
+        size_t axis = 0;
+        double widest = -1;
+        for (size_t j = 0; j < d; j++) {
+            double mean = 0, sq = 0;
+            for (size_t i = 0; i < n; i++) {
+                mean += points(i, j);
+            }
+            mean /= double(n);
+            for (size_t i = 0; i < n; i++) {
+                sq += (points(i, j) - mean) * (points(i, j) - mean);
+            }
+            if (sq > widest) {
+                widest = sq;
+                axis = j;
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return points(a, axis) < points(b, axis);
+        });
+        key.resize(n);
+        for (size_t r = 0; r < n; r++) {
+            key[r] = points(order[r], axis);
+        }
+    }
+    Matrix<double> sorted(n, d);
+    for (size_t r = 0; r < n; r++) {
+        rank[order[r]] = uint32_t(r);
+        strided_span<const double> x = points.row(order[r]);
+        std::copy(x.begin(), x.end(), sorted.data() + r * d);
+    }
+    // calls f(s) on the ranks s within eps of rank r while f returns true
+    auto neighbours = [&](size_t r, auto&& f) {
+        std::span<const double> x(sorted.data() + r * d, d);
+        size_t lo = 0, hi = n;
+        if (bounded) {
+            lo = size_t(std::lower_bound(key.begin(), key.end(), key[r] - eps) - key.begin());
+            hi = size_t(std::upper_bound(key.begin(), key.end(), key[r] + eps) - key.begin());
+        }
+        for (size_t s = lo; s < hi; s++) {
+            if (metric(x, std::span<const double>(sorted.data() + s * d, d)) <= radius && !f(s)) {
+                return;
+            }
+        }
+    };
+
+    // blocks of points keep the shared counter of parallel_for_dynamic off the hot path
+    constexpr size_t block = 64;
+    const size_t blocks = (n + block - 1) / block;
+    std::vector<uint8_t> core(n, 0);
+    PARALLEL::parallel_for_dynamic(0, blocks, opt.threads, [&](size_t b, size_t) {
+        for (size_t r = b * block; r < std::min(n, (b + 1) * block); r++) {
+            size_t count = 0;
+            neighbours(r, [&](size_t) { return ++count < opt.min_points; });
+            core[r] = count >= opt.min_points;
+        }
+    });
+
+    concurrent_dsu dsu(static_cast<uint32_t>(n));
+    // the smallest rank of a core neighbour of every border point
+    std::vector<std::atomic<uint32_t>> border(n);
+    for (auto& b : border) {
+        b.store(UINT32_MAX, std::memory_order_relaxed);
+    }
+    PARALLEL::parallel_for_dynamic(0, blocks, opt.threads, [&](size_t b, size_t) {
+        for (size_t r = b * block; r < std::min(n, (b + 1) * block); r++) {
+            if (!core[r]) {
+                continue;
+            }
+            neighbours(r, [&](size_t s) {
+                if (core[s]) {
+                    if (s > r) {
+                        dsu.join(uint32_t(r), uint32_t(s));
+                    }
+                } else {
+                    uint32_t seen = border[s].load(std::memory_order_relaxed);
+                    while (r < seen && !border[s].compare_exchange_weak(
+                                           seen, uint32_t(r), std::memory_order_relaxed)) {
+                    }
+                }
+                return true;
+            });
+        }
+    });
+
+    dbscan_result result;
+    result.labels.assign(n, -1);
+    result.core.resize(n);
+    std::vector<int64_t> cluster_of(n, -1);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t r = rank[i];
+        result.core[i] = core[r];
+        uint32_t seed = core[r] ? r : border[r].load(std::memory_order_relaxed);
+        if (seed == UINT32_MAX) {
+            continue;
+        }
+        uint32_t root = dsu.find(seed);
+        if (cluster_of[root] == -1) {
+            cluster_of[root] = int64_t(result.clusters++);
+        }
+        result.labels[i] = cluster_of[root];
+    }
+    return result;
+}
+
+} // namespace _dbscan_utils
+
+/**
+ * @brief dbscan_fit function
+ * DBSCAN on the rows of a flat row major matrix in the manner of PDSDBSCAN: the core
+ * points are found by every thread for its own points, then every core point joins the
+ * core points of its neighbourhood in a concurrent_dsu, so the clusters are the sets of
+ * the union-find and no thread waits on another. A border point goes to the cluster of its
+ * core neighbour that comes first in the sorted order and the clusters are numbered by
+ * their first point, so the labels do not depend on the number of threads.
+ * @param points: n x d, a point per row, a Matrix or a dataset_view of either layout.
+ * @param opt: see dbscan_options.
+ * @param metric: a symmetric distance, called as metric(span<const double>,
+ * span<const double>), e.g. a wrapper of metrics::manhattan_distance.
+ * @return dbscan_result the labels and the core points. Throws std::invalid_argument if
+ * eps is negative or NaN, std::length_error past 2^32 - 1 points.
+ */
+template <typename Metric>
+dbscan_result dbscan_fit(dataset_view points, const dbscan_options& opt, Metric metric) {
+    return _dbscan_utils::fit(points, opt, metric, opt.eps);
+}
+
+/**
+ * @brief dbscan_fit function
+ * dbscan_fit with the euclidean distance, the points are always sorted on a coordinate
+ * and compared in simd registers.
+ * @param points: n x d, a point per row, a Matrix or a dataset_view of either layout.
+ * @param opt: see dbscan_options.
+ * @return dbscan_result the labels and the core points.
+ */
+inline dbscan_result dbscan_fit(dataset_view points, const dbscan_options& opt = {}) {
+    dbscan_options bounded = opt;
+    bounded.coordinate_bound = true;
+    // squared distances against eps^2 save the square roots
+    auto squared = [](std::span<const double> a, std::span<const double> b) {
+        return _mat_utils::squared_distance(a.data(), b.data(), a.size());
+    };
+    return _dbscan_utils::fit(points, bounded, squared, opt.eps * opt.eps);
+}
+
 #endif
@@ -1,19 +1,411 @@
 #ifndef KMEANS_H
 #define KMEANS_H
 
+#include "../../../classes/spatial/kd_tree.h"
+#include "../../../helpers/parallel.h"
+#include "../../../helpers/trace.h"
+#include "../../../linalg/matrix.h"
+#include "../../dataset/dataset.h"
+
 #ifdef __cplusplus
 #include "../../../../third_party/json.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
 #include <vector>
 #endif
 
 using json = nlohmann::json;
 
+/**
+ * @brief the assignment step of kmeans_fit(): lloyd compares every point to every centroid,
+ * hamerly keeps one lower bound per point and elkan k of them, and both skip the distances
+ * the triangle inequality shows cannot change the label. The labels are those of lloyd.
+ */
+enum class kmeans_algorithm { lloyd, hamerly, elkan };
+
+/**
+ * @brief options of kmeans_fit()
+ * @param max_iterations: upper bound on the number of Lloyd iterations.
+ * @param tolerance: the iteration stops once the squared movement of the centroids is below
+ * tolerance times the mean variance of the features, as in scikit-learn.
+ * @param seed: seed of the k-means++ draws.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ * @param algorithm: the assignment step, hamerly suits few clusters and elkan many, at the
+ * cost of n x k bounds.
+ */
+struct kmeans_options {
+    size_t max_iterations{300};
+    double tolerance{1e-4};
+    uint64_t seed{0};
+    size_t threads{0};
+    kmeans_algorithm algorithm{kmeans_algorithm::lloyd};
+};
+
+/**
+ * @brief result of kmeans_fit()
+ * @param centroids: k x d, row c is the centroid of cluster c.
+ * @param labels: the cluster of every point.
+ * @param inertia: the sum of the squared distances of the points to their centroids.
+ * @param iterations: the number of Lloyd iterations run.
+ * @param converged: true if the iteration stopped before max_iterations.
+ * @param distance_computations: the point to centroid distances computed.
+ * @param skipped_distances: the point to centroid distances a lloyd pass would have
+ * computed and the bounds skipped.
+ */
+struct kmeans_result {
+    Matrix<double> centroids;
+    std::vector<int32_t> labels;
+    double inertia{0};
+    size_t iterations{0};
+    bool converged{false};
+    size_t distance_computations{0};
+    size_t skipped_distances{0};
+};
+
+namespace _kmeans_utils {
+// the squared euclidean distance of the d elements of a and b
+inline double distance2(const double* a, const double* b, size_t d) {
+    return _mat_utils::squared_distance(a, b, d);
+}
+
+/**
+ * @brief the closest row of centroids to x
+ * @param best_d set to the squared distance of x to it
+ */
+inline int32_t nearest(const double* x, const Matrix<double>& centroids, double& best_d) {
+    const size_t k = centroids.rows(), d = centroids.cols();
+    int32_t best = 0;
+    best_d = distance2(x, centroids.data(), d);
+    for (size_t c = 1; c < k; c++) {
+        double dist = distance2(x, centroids.data() + c * d, d);
+        if (dist < best_d) {
+            best_d = dist;
+            best = int32_t(c);
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief the per thread accumulators of an assignment pass, one per thread so the pass
+ * needs no locks
+ */
+struct partial_sums {
+    std::vector<Matrix<double>> sums;
+    std::vector<std::vector<size_t>> counts;
+    std::vector<double> inertia;
+    std::vector<size_t> changed;
+    std::vector<size_t> computed;
+
+    partial_sums(size_t threads, size_t k, size_t d)
+        : sums(threads, Matrix<double>(k, d)), counts(threads, std::vector<size_t>(k)),
+          inertia(threads), changed(threads), computed(threads) {}
+
+    size_t threads() const { return sums.size(); }
+
+    // cleared before every pass since parallel_for may leave trailing thread ids without
+    // a chunk
+    void clear() {
+        for (size_t t = 0; t < threads(); t++) {
+            std::fill(sums[t].data(), sums[t].data() + sums[t].size(), 0.0);
+            std::fill(counts[t].begin(), counts[t].end(), 0);
+            inertia[t] = 0;
+            changed[t] = 0;
+            computed[t] = 0;
+        }
+    }
+
+    void add(size_t tid, const double* x, int32_t label) {
+        const size_t d = sums[tid].cols();
+        counts[tid][label]++;
+        double* s = sums[tid].data() + size_t(label) * d;
+        for (size_t j = 0; j < d; j++) {
+            s[j] += x[j];
+        }
+    }
+
+    // sums the accumulators of every thread into those of thread 0
+    void reduce() {
+        for (size_t t = 1; t < threads(); t++) {
+            sums[0] += sums[t];
+            for (size_t c = 0; c < counts[0].size(); c++) {
+                counts[0][c] += counts[t][c];
+            }
+            inertia[0] += inertia[t];
+            changed[0] += changed[t];
+            computed[0] += computed[t];
+        }
+    }
+};
+
+/**
+ * @brief assigns every row of points to its closest centroid, on p.threads() threads
+ * @param labels the label of every row, updated
+ * @param closest set to the squared distance of every row to its centroid
+ * @param p the accumulators, the sum and count of the points of every cluster end in
+ * p.sums[0] and p.counts[0]
+ * @return std::pair<size_t, double> the number of labels that changed and the inertia.
+ */
+inline std::pair<size_t, double> assign(dataset_view points, const Matrix<double>& centroids,
+                                        std::vector<int32_t>& labels,
+                                        std::vector<double>& closest, partial_sums& p) {
+    const size_t d = centroids.cols();
+    p.clear();
+    PARALLEL::parallel_for(0, points.rows(), p.threads(), [&](size_t lo, size_t hi, size_t tid) {
+        for (size_t i = lo; i < hi; i++) {
+            const double* x = points.data() + i * d;
+            int32_t best = nearest(x, centroids, closest[i]);
+            p.changed[tid] += labels[i] != best;
+            labels[i] = best;
+            p.inertia[tid] += closest[i];
+            p.add(tid, x, best);
+        }
+    });
+    p.reduce();
+    return {p.changed[0], p.inertia[0]};
+}
+
+/**
+ * @brief the bounds of the hamerly and elkan assignment steps, in distances(not squared)
+ * upper: of every point to its centroid. lower: hamerly keeps one per point, of its
+ * distance to any other centroid, elkan one per point and centroid. half: half the
+ * distance of every centroid to the closest other one. centers: elkan's half distances
+ * between the centroids, k x k. moved: how far every centroid moved since the last pass.
+ */
+struct bounds {
+    kmeans_algorithm algorithm;
+    size_t k;
+    std::vector<double> upper, lower, half, centers, moved;
+
+    bounds(kmeans_algorithm algorithm, size_t n, size_t k) : algorithm(algorithm), k(k) {
+        if (algorithm == kmeans_algorithm::lloyd) {
+            return;
+        }
+        // label 0 with an infinite upper bound makes the first pass compute every label
+        upper.assign(n, std::numeric_limits<double>::infinity());
+        lower.assign(algorithm == kmeans_algorithm::elkan ? n * k : n, 0.0);
+        half.assign(k, 0.0);
+        if (algorithm == kmeans_algorithm::elkan) {
+            centers.assign(k * k, 0.0);
+        }
+    }
+
+    void measure(const Matrix<double>& centroids, size_t threads) {
+        const size_t d = centroids.cols();
+        std::fill(half.begin(), half.end(), std::numeric_limits<double>::infinity());
+        PARALLEL::parallel_for(0, k, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t a = lo; a < hi; a++) {
+                for (size_t c = 0; c < k; c++) {
+                    if (c == a) {
+                        continue;
+                    }
+                    double h = 0.5 * std::sqrt(distance2(centroids.data() + a * d,
+                                                         centroids.data() + c * d, d));
+                    half[a] = std::min(half[a], h);
+                    if (!centers.empty()) {
+                        centers[a * k + c] = h;
+                    }
+                }
+            }
+        });
+    }
+
+    // loosens the bounds by how far every centroid moved
+    void move(const std::vector<int32_t>& labels, const std::vector<double>& movement,
+              size_t threads) {
+        // hamerly lowers every bound by the largest move of another centroid
+        size_t far = 0;
+        double first = 0, second = 0;
+        for (size_t c = 0; c < k; c++) {
+            if (movement[c] > first) {
+                second = first;
+                first = movement[c];
+                far = c;
+            } else if (movement[c] > second) {
+                second = movement[c];
+            }
+        }
+        PARALLEL::parallel_for(0, labels.size(), threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                upper[i] += movement[labels[i]];
+                if (algorithm == kmeans_algorithm::hamerly) {
+                    lower[i] -= size_t(labels[i]) == far ? second : first;
+                }
+            }
+        });
+        // elkan lowers the k bounds of a point in the next pass, while they are in cache
+        moved = movement;
+    }
+};
+
+/**
+ * @brief the assignment pass of hamerly or elkan: a point keeps its label without
+ * computing a distance when its upper bound is below half the distance of its centroid to
+ * the others or below its lower bounds, and only distances to the centroids the bounds
+ * cannot rule out are computed otherwise
+ * @return size_t the number of labels that changed, the computed distances are summed in
+ * p.computed[0].
+ */
+inline size_t bounded_assign(dataset_view points, const Matrix<double>& centroids,
+                             std::vector<int32_t>& labels, std::vector<double>& closest,
+                             partial_sums& p, bounds& b) {
+    const size_t d = centroids.cols(), k = centroids.rows();
+    p.clear();
+    b.measure(centroids, p.threads());
+    auto dist = [&](const double* x, size_t c) {
+        return std::sqrt(distance2(x, centroids.data() + c * d, d));
+    };
+    PARALLEL::parallel_for(0, points.rows(), p.threads(), [&](size_t lo, size_t hi, size_t tid) {
+        size_t computed = 0, changed = 0;
+        for (size_t i = lo; i < hi; i++) {
+            const double* x = points.data() + i * d;
+            int32_t a = labels[i];
+            double u = b.upper[i];
+            if (b.algorithm == kmeans_algorithm::hamerly) {
+                double m = std::max(b.half[a], b.lower[i]);
+                if (u > m) {
+                    u = dist(x, a);
+                    computed++;
+                    if (u > m) {
+                        // squared distances, only the two closest need a square root
+                        double first = std::numeric_limits<double>::infinity(), second = first;
+                        for (size_t c = 0; c < k; c++) {
+                            double e = distance2(x, centroids.data() + c * d, d);
+                            if (e < first) {
+                                second = first;
+                                first = e;
+                                a = int32_t(c);
+                            } else if (e < second) {
+                                second = e;
+                            }
+                        }
+                        computed += k;
+                        u = std::sqrt(first);
+                        b.lower[i] = std::sqrt(second);
+                    }
+                }
+            } else {
+                double* l = b.lower.data() + i * k;
+                if (!b.moved.empty()) {
+                    for (size_t c = 0; c < k; c++) {
+                        l[c] = std::max(0.0, l[c] - b.moved[c]);
+                    }
+                }
+                bool stale = true;
+                for (size_t c = 0; u > b.half[a] && c < k; c++) {
+                    if (c == size_t(a)) {
+                        continue;
+                    }
+                    double z = std::max(l[c], b.centers[size_t(a) * k + c]);
+                    if (u <= z) {
+                        continue;
+                    }
+                    if (stale) {
+                        u = l[a] = dist(x, a);
+                        computed++;
+                        stale = false;
+                        if (u <= z) {
+                            continue;
+                        }
+                    }
+                    double e = l[c] = dist(x, c);
+                    computed++;
+                    if (e < u) {
+                        a = int32_t(c);
+                        u = e;
+                    }
+                }
+            }
+            changed += labels[i] != a;
+            labels[i] = a;
+            b.upper[i] = u;
+            closest[i] = u * u;
+            p.add(tid, x, a);
+        }
+        p.computed[tid] = computed;
+        p.changed[tid] = changed;
+    });
+    p.reduce();
+    return p.changed[0];
+}
+
+/**
+ * @brief moves an empty cluster to the point farthest from its centroid, that point is
+ * not taken again
+ * @return double the squared distance the centroid moved.
+ */
+inline double reseed(dataset_view points, std::vector<double>& closest, double* centroid) {
+    const size_t d = points.cols();
+    size_t far = size_t(std::max_element(closest.begin(), closest.end()) - closest.begin());
+    closest[far] = 0;
+    double shift = distance2(centroid, points.data() + far * d, d);
+    std::copy(points.data() + far * d, points.data() + (far + 1) * d, centroid);
+    return shift;
+}
+
+/**
+ * @brief k-means++ seeding: the first centroid is a uniformly drawn point, every next one a
+ * point drawn with probability proportional to its squared distance to the closest
+ * centroid so far
+ */
+inline Matrix<double> plus_plus(dataset_view points, size_t k, std::mt19937_64& gen,
+                                size_t threads = 1) {
+    const size_t n = points.rows(), d = points.cols();
+    Matrix<double> centroids(k, d);
+    std::vector<double> closest(n, std::numeric_limits<double>::infinity());
+    size_t pick = std::uniform_int_distribution<size_t>(0, n - 1)(gen);
+    for (size_t c = 0; c < k; c++) {
+        std::copy(points.data() + pick * d, points.data() + (pick + 1) * d,
+                  centroids.data() + c * d);
+        if (c + 1 == k) {
+            break;
+        }
+        const double* centroid = centroids.data() + c * d;
+        PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t) {
+            for (size_t i = lo; i < hi; i++) {
+                closest[i] = std::min(closest[i], distance2(points.data() + i * d, centroid, d));
+            }
+        });
+        double total = 0;
+        for (double x : closest) {
+            total += x;
+        }
+        if (!(total > 0)) {
+            // fewer distinct points than clusters, the rest are duplicates
+            pick = std::uniform_int_distribution<size_t>(0, n - 1)(gen);
+            continue;
+        }
+        double target = std::uniform_real_distribution<double>(0, total)(gen);
+        pick = n - 1;
+        for (size_t i = 0; i < n; i++) {
+            target -= closest[i];
+            if (target < 0 && closest[i] > 0) {
+                pick = i;
+                break;
+            }
+        }
+    }
+    return centroids;
+}
+} // namespace _kmeans_utils
+
 /**
  * @ brief Class for the kmeans clustering algorithm
+ * Every iteration puts the centroids in a kd_tree, so a point finds its closest centroid in
+ * O(log(K)) instead of comparing it to all of them. The points are kept in an n x 2 Matrix
+ * and the centroids are summed in one pass over it, without copying the points into
+ * clusters, on several threads. The initial centroids are drawn by k-means++. See
+ * kmeans_fit and minibatch_kmeans for points of any dimension.
  */
 class kmeans {
   private:
@@ -27,7 +419,7 @@ class kmeans {
     double distance(std::vector<double>& a, std::vector<double>& b) {
         return sqrt(pow((a[0] - b[0]), 2) + pow((a[1] - b[1]), 2));
     }
-    std::vector<std::vector<double>> data;
+    Matrix<double> points;
     int K;
     std::vector<std::vector<double>> cluster_centers;
     std::map<std::vector<double>, int64_t> assignments;
@@ -38,31 +430,55 @@ class kmeans {
      * @param data: the input data(2D vector)
      * @param K: the number of clusters
      * @param MAX_ITER: default 500, maximum iterations till it converges
+     * @param threads: number of threads of the assignment step(0 means every hardware
+     * thread), every thread sums its points into its own centroid sums. Default = 0
      */
-    kmeans(std::vector<std::vector<double>> data, int K, int64_t MAX_ITER = 1500)
-        : data(data), K(K) {
+    kmeans(std::vector<std::vector<double>> data, int K, int64_t MAX_ITER = 1500,
+           size_t threads = 0)
+        : points(data.size(), 2), K(K) {
 
+        for (size_t i = 0; i < data.size(); i++) {
+            points(i, 0) = data[i][0];
+            points(i, 1) = data[i][1];
+        }
         std::random_device rd;
         std::mt19937_64 gen(rd());
-        std::uniform_real_distribution<double> distrib(std::numeric_limits<double>::min(),
-                                                       std::numeric_limits<double>::max());
+        Matrix<double> seeds = _kmeans_utils::plus_plus(points, K, gen);
         for (int i = 0; i < K; i++) {
-            double rand_num = distrib(gen);
-            this->cluster_centers.push_back(data[rand_num]);
+            this->cluster_centers.push_back({seeds(i, 0), seeds(i, 1)});
         }
-
+        std::vector<int64_t> labels(data.size());
         for (int ww = 0; ww < MAX_ITER; ww++) {
-            for (int64_t i = 0; i < data.size(); i++) {
-                assign_to_closest(data[i]);
+            std::vector<std::array<double, 2>> centers(K);
+            for (int i = 0; i < K; i++) {
+                centers[i] = {cluster_centers[i][0], cluster_centers[i][1]};
             }
-
-            std::vector<std::vector<std::vector<double>>> _clusters(K);
-            for (auto& x : assignments) {
-                _clusters[x.second].push_back(x.first);
+            kd_tree<2> index(centers);
+            size_t workers = PARALLEL::resolve_threads(threads, points.rows());
+            std::vector<Matrix<double>> partial(workers, Matrix<double>(K, 2));
+            std::vector<std::vector<size_t>> partial_counts(workers, std::vector<size_t>(K, 0));
+            auto step = [&](size_t lo, size_t hi, size_t tid) {
+                for (size_t i = lo; i < hi; i++) {
+                    labels[i] = int64_t(index.nearest({points(i, 0), points(i, 1)}));
+                    partial[tid](labels[i], 0) += points(i, 0);
+                    partial[tid](labels[i], 1) += points(i, 1);
+                    partial_counts[tid][labels[i]]++;
+                }
+            };
+            PARALLEL::parallel_for(0, points.rows(), workers, step);
+            Matrix<double>& sums = partial[0];
+            std::vector<size_t>& counts = partial_counts[0];
+            for (size_t t = 1; t < workers; t++) {
+                sums += partial[t];
+                for (int i = 0; i < K; i++) {
+                    counts[i] += partial_counts[t][i];
+                }
             }
+
             std::vector<std::vector<double>> new_centroids;
             for (int i = 0; i < K; i++) {
-                new_centroids.push_back(get_centroid(_clusters[i]));
+                double n = double(counts[i]);
+                new_centroids.push_back({sums(i, 0) / n, sums(i, 1) / n});
             }
 
             if (new_centroids == this->cluster_centers) {
@@ -71,6 +487,9 @@ class kmeans {
                 this->cluster_centers = new_centroids;
             }
         }
+        for (size_t i = 0; i < data.size(); i++) {
+            assignments[data[i]] = labels[i];
+        }
     }
 
     /**
@@ -89,9 +508,9 @@ class kmeans {
     inline void assign_to_closest(std::vector<double>& x) {
         std::vector<double> id = this->cluster_centers[0];
         int index = 0;
-        int min_dist = distance(x, id);
-        for (int j = 0; j < this->cluster_centers.size(); j++) {
-            int current_dist = distance(this->cluster_centers[j], x);
+        double min_dist = distance(x, id);
+        for (int j = 0; j < int(this->cluster_centers.size()); j++) {
+            double current_dist = distance(this->cluster_centers[j], x);
             if (current_dist < min_dist) {
                 min_dist = current_dist;
                 index = j;
@@ -129,4 +548,309 @@ class kmeans {
     }
 };
 
+/**
+ * @brief kmeans_fit function
+ * Lloyd's k-means on the rows of a flat row major matrix, seeded by k-means++. Every
+ * iteration assigns the points to their closest centroid on several threads, each thread
+ * summing its points into its own k x d accumulator, so the new centroids come out of the
+ * same pass without grouping the points. A cluster left empty takes the point farthest from
+ * its centroid. Labels are 32 bit cluster indices in point order.
+ * @param points: n x d, a point per row, a Matrix or a row major dataset_view read in
+ * place.
+ * @param k: the number of clusters.
+ * @param opt: see kmeans_options.
+ * @return kmeans_result the centroids and the labels of the last assignment. Throws
+ * std::invalid_argument unless 0 < k <= n.
+ */
+inline kmeans_result kmeans_fit(dataset_view points, size_t k, const kmeans_options& opt = {}) {
+    _dataset_utils::row_major(points, "kmeans_fit");
+    const size_t n = points.rows(), d = points.cols();
+    if (k == 0 || k > n || k > size_t(INT32_MAX)) {
+        throw std::invalid_argument("kmeans_fit: k must be in [1, number of points]");
+    }
+    std::mt19937_64 gen(opt.seed);
+    kmeans_result result;
+    result.centroids = _kmeans_utils::plus_plus(points, k, gen, opt.threads);
+    result.labels.assign(n, -1);
+
+    // the tolerance is relative to the mean variance of the features
+    double variance = 0;
+    for (size_t j = 0; j < d; j++) {
+        double mean = 0, sq = 0;
+        for (size_t i = 0; i < n; i++) {
+            mean += points(i, j);
+        }
+        mean /= double(n);
+        for (size_t i = 0; i < n; i++) {
+            sq += (points(i, j) - mean) * (points(i, j) - mean);
+        }
+        variance += sq / double(n);
+    }
+    const double tolerance = d ? opt.tolerance * variance / double(d) : 0.0;
+
+    _kmeans_utils::partial_sums p(PARALLEL::resolve_threads(opt.threads, n), k, d);
+    _kmeans_utils::bounds b(opt.algorithm, n, k);
+    std::vector<double> closest(n), movement(k);
+    const bool lloyd = opt.algorithm == kmeans_algorithm::lloyd;
+    if (!lloyd) {
+        result.labels.assign(n, 0);
+    }
+    // an assignment pass, returns the number of points whose label changed
+    auto pass = [&]() {
+        size_t changed;
+        if (lloyd) {
+            std::tie(changed, result.inertia) =
+                _kmeans_utils::assign(points, result.centroids, result.labels, closest, p);
+            result.distance_computations += n * k;
+        } else {
+            changed = _kmeans_utils::bounded_assign(points, result.centroids, result.labels,
+                                                    closest, p, b);
+            result.distance_computations += p.computed[0];
+            result.skipped_distances += n * k - p.computed[0];
+        }
+        return changed;
+    };
+    pass();
+    while (result.iterations < opt.max_iterations) {
+        ALGOPLUS_TRACE_SPAN("kmeans iteration");
+        result.iterations++;
+        double shift = 0;
+        for (size_t c = 0; c < k; c++) {
+            double* centroid = result.centroids.data() + c * d;
+            double moved = 0;
+            if (p.counts[0][c] == 0) {
+                moved = _kmeans_utils::reseed(points, closest, centroid);
+            } else {
+                const double* s = p.sums[0].data() + c * d;
+                for (size_t j = 0; j < d; j++) {
+                    double next = s[j] / double(p.counts[0][c]);
+                    moved += (next - centroid[j]) * (next - centroid[j]);
+                    centroid[j] = next;
+                }
+            }
+            shift += moved;
+            movement[c] = std::sqrt(moved);
+        }
+        if (!lloyd) {
+            b.move(result.labels, movement, p.threads());
+        }
+        const size_t changed = pass();
+        ALGOPLUS_TRACE_COUNTER("kmeans changed", changed);
+        if (changed == 0 || shift <= tolerance) {
+            result.converged = true;
+            break;
+        }
+    }
+    if (!lloyd) {
+        // the upper bounds are not the distances, the inertia takes one more pass over them
+        std::vector<double> part(p.threads(), 0.0);
+        PARALLEL::parallel_for(0, n, p.threads(), [&](size_t lo, size_t hi, size_t tid) {
+            for (size_t i = lo; i < hi; i++) {
+                part[tid] += _kmeans_utils::distance2(
+                    points.data() + i * d, result.centroids.data() + result.labels[i] * d, d);
+            }
+        });
+        result.inertia = 0;
+        for (double x : part) {
+            result.inertia += x;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief mini-batch k-means class
+ * Sculley's web-scale k-means for streams and data sets too large for Lloyd's iterations:
+ * every batch is assigned to the current centroids, then each centroid moves to the running
+ * mean of all the points it has been given, so a batch costs O(batch k d) and the state is
+ * the k centroids and their counts whatever the length of the stream.
+ */
+class minibatch_kmeans {
+  public:
+    /**
+     * @brief Construct a new minibatch kmeans object
+     * @param k: the number of clusters.
+     * @param seed: seed of the k-means++ draws on the first batch. Default = 0
+     * @param threads: number of worker threads(0 means every hardware thread). Default = 0
+     */
+    explicit minibatch_kmeans(size_t k, uint64_t seed = 0, size_t threads = 0)
+        : _k(k), _gen(seed), _threads(threads) {
+        if (k == 0 || k > size_t(INT32_MAX)) {
+            throw std::invalid_argument("minibatch_kmeans: k must be positive");
+        }
+    }
+
+    /**
+     * @brief partial_fit function
+     * Updates the centroids with a batch of points, the first batch seeds them by
+     * k-means++. A cluster that no batch has reached yet takes the point of the batch
+     * farthest from its centroid.
+     * @param batch: a point per row, at least k rows for the first batch, a Matrix or a row
+     * major dataset_view, e.g. a slice of a mapped dataset.
+     * @return double the inertia of the batch on the centroids before the update. Throws
+     * std::invalid_argument if the first batch has fewer than k rows or a later one does
+     * not have the columns of the first.
+     */
+    double partial_fit(dataset_view batch) {
+        _dataset_utils::row_major(batch, "minibatch_kmeans");
+        const size_t n = batch.rows(), d = batch.cols();
+        if (!fitted()) {
+            if (n < _k) {
+                throw std::invalid_argument("minibatch_kmeans: the first batch needs k points");
+            }
+            _centroids = _kmeans_utils::plus_plus(batch, _k, _gen, _threads);
+            _counts.assign(_k, 0);
+        } else if (d != _centroids.cols()) {
+            throw std::invalid_argument("minibatch_kmeans: the batch has the wrong dimension");
+        }
+        if (n == 0) {
+            return 0;
+        }
+        _kmeans_utils::partial_sums p(PARALLEL::resolve_threads(_threads, n), _k, d);
+        std::vector<int32_t> labels(n, -1);
+        std::vector<double> closest(n);
+        double inertia = _kmeans_utils::assign(batch, _centroids, labels, closest, p).second;
+        for (size_t c = 0; c < _k; c++) {
+            double* centroid = _centroids.data() + c * d;
+            size_t b = p.counts[0][c];
+            if (b == 0) {
+                if (_counts[c] == 0) {
+                    _kmeans_utils::reseed(batch, closest, centroid);
+                }
+                continue;
+            }
+            _counts[c] += b;
+            const double* s = p.sums[0].data() + c * d;
+            double rate = 1.0 / double(_counts[c]);
+            for (size_t j = 0; j < d; j++) {
+                centroid[j] += (s[j] - double(b) * centroid[j]) * rate;
+            }
+        }
+        return inertia;
+    }
+
+    /**
+     * @brief predict function
+     * @param points: a point per row, a Matrix or a row major dataset_view.
+     * @return std::vector<int32_t> the closest centroid of every point. Throws
+     * std::runtime_error before the first partial_fit and std::invalid_argument if the
+     * points do not have the dimension of the centroids.
+     */
+    std::vector<int32_t> predict(dataset_view points) const {
+        _dataset_utils::row_major(points, "minibatch_kmeans");
+        if (!fitted()) {
+            throw std::runtime_error("minibatch_kmeans: predict before partial_fit");
+        }
+        if (points.cols() != _centroids.cols()) {
+            throw std::invalid_argument("minibatch_kmeans: the points have the wrong dimension");
+        }
+        std::vector<int32_t> labels(points.rows());
+        PARALLEL::parallel_for(0, points.rows(), _threads, [&](size_t lo, size_t hi, size_t) {
+            double dist;
+            for (size_t i = lo; i < hi; i++) {
+                labels[i] = _kmeans_utils::nearest(points.data() + i * points.cols(),
+                                                   _centroids, dist);
+            }
+        });
+        return labels;
+    }
+
+    /**
+     * @brief centroids function
+     * @return const Matrix<double>& k x d, empty before the first partial_fit.
+     */
+    const Matrix<double>& centroids() const { return _centroids; }
+
+    /**
+     * @brief counts function
+     * @return const std::vector<size_t>& the number of points every cluster has been given.
+     */
+    const std::vector<size_t>& counts() const { return _counts; }
+
+    /**
+     * @brief fitted function
+     * @return true if a batch has seeded the centroids
+     */
+    bool fitted() const { return !_counts.empty(); }
+
+  private:
+    size_t _k;
+    std::mt19937_64 _gen;
+    size_t _threads;
+    Matrix<double> _centroids;
+    std::vector<size_t> _counts;
+};
+
+/**
+ * @brief options of minibatch_kmeans_fit()
+ * @param batch_size: the number of points drawn for every batch.
+ * @param max_iterations: upper bound on the number of batches.
+ * @param max_no_improvement: the iteration stops after this many batches without a lower
+ * smoothed batch inertia.
+ * @param seed: seed of the batch draws and of the k-means++ seeding.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ */
+struct minibatch_kmeans_options {
+    size_t batch_size{1024};
+    size_t max_iterations{100};
+    size_t max_no_improvement{10};
+    uint64_t seed{0};
+    size_t threads{0};
+};
+
+/**
+ * @brief minibatch_kmeans_fit function
+ * Mini-batch k-means on the rows of points: batches drawn uniformly with replacement feed
+ * a minibatch_kmeans until the inertia per point, smoothed over the batches, stops
+ * improving, then every point is labelled once by the final centroids.
+ * @param points: n x d, a point per row, a Matrix or a row major dataset_view read in
+ * place.
+ * @param k: the number of clusters.
+ * @param opt: see minibatch_kmeans_options.
+ * @return kmeans_result the centroids, the labels and inertia of every point, the number
+ * of batches as iterations. Throws std::invalid_argument unless 0 < k <= n.
+ */
+inline kmeans_result minibatch_kmeans_fit(dataset_view points, size_t k,
+                                          const minibatch_kmeans_options& opt = {}) {
+    _dataset_utils::row_major(points, "minibatch_kmeans_fit");
+    const size_t n = points.rows(), d = points.cols();
+    if (k == 0 || k > n) {
+        throw std::invalid_argument("minibatch_kmeans_fit: k must be in [1, number of points]");
+    }
+    minibatch_kmeans model(k, opt.seed, opt.threads);
+    std::mt19937_64 gen(opt.seed + 1);
+    std::uniform_int_distribution<size_t> draw(0, n - 1);
+    const size_t size = std::min(n, std::max(opt.batch_size, k));
+    // the weight of a batch in the running inertia, as in scikit-learn
+    const double alpha = std::min(1.0, 2.0 * double(size) / double(n + 1));
+    Matrix<double> batch(size, d);
+    kmeans_result result;
+    double smoothed = 0, best = std::numeric_limits<double>::infinity();
+    size_t stale = 0;
+    while (result.iterations < opt.max_iterations) {
+        ALGOPLUS_TRACE_SPAN("minibatch_kmeans batch");
+        for (size_t i = 0; i < size; i++) {
+            size_t row = draw(gen);
+            std::copy(points.data() + row * d, points.data() + (row + 1) * d,
+                      batch.data() + i * d);
+        }
+        double inertia = model.partial_fit(batch) / double(size);
+        smoothed = result.iterations++ == 0 ? inertia : smoothed * (1 - alpha) + inertia * alpha;
+        if (smoothed < best) {
+            best = smoothed;
+            stale = 0;
+        } else if (++stale >= opt.max_no_improvement) {
+            result.converged = true;
+            break;
+        }
+    }
+    result.centroids = model.centroids();
+    result.labels.assign(n, -1);
+    std::vector<double> closest(n);
+    _kmeans_utils::partial_sums p(PARALLEL::resolve_threads(opt.threads, n), k, d);
+    result.inertia = _kmeans_utils::assign(points, result.centroids, result.labels, closest, p)
+                         .second;
+    return result;
+}
+
 #endif
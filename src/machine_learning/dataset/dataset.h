@@ -0,0 +1,483 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "../../helpers/mapped_file.h"
+#include "../../helpers/parallel.h"
+#include "../../linalg/mat_view.h"
+#include "../../linalg/matrix.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief the order of the values of a dataset: the features of a sample next to each other
+ * (row_major), or the values of a feature next to each other(column_major)
+ */
+enum class dataset_layout { row_major, column_major };
+
+/**
+ * @brief dataset view class
+ * Non owning rows x cols view of a sample per row, over a Matrix, a mapped dataset file or
+ * any buffer of doubles, so the estimators read the samples where they are instead of taking
+ * a copy. It stays valid as long as the memory it looks at. A Matrix converts to it
+ * implicitly, so the estimators that take a dataset_view still take a Matrix.
+ */
+class dataset_view {
+  public:
+    dataset_view() = default;
+
+    /**
+     * @brief Construct a new dataset view object
+     * @param data the first value
+     * @param rows the number of samples
+     * @param cols the number of features
+     * @param layout the order of the values. Default = row_major
+     */
+    dataset_view(const double* data, size_t rows, size_t cols,
+                 dataset_layout layout = dataset_layout::row_major)
+        : _data(data), _rows(rows), _cols(cols), _layout(layout) {}
+
+    /**
+     * @brief a row major view of a Matrix
+     */
+    dataset_view(const Matrix<double>& m) : dataset_view(m.data(), m.rows(), m.cols()) {}
+
+    size_t rows() const { return _rows; }
+    size_t cols() const { return _cols; }
+    size_t size() const { return _rows * _cols; }
+    dataset_layout layout() const { return _layout; }
+    bool row_major() const { return _layout == dataset_layout::row_major; }
+    const double* data() const { return _data; }
+
+    /**
+     * @brief operator (i, j) for dataset_view class
+     * @return the feature j of the sample i
+     */
+    const double& operator()(size_t i, size_t j) const {
+        return row_major() ? _data[i * _cols + j] : _data[j * _rows + i];
+    }
+
+    /**
+     * @brief row function
+     * @return strided_span<const double>: the features of the sample i, contiguous in a row
+     * major view
+     */
+    strided_span<const double> row(size_t i) const {
+        return row_major() ? strided_span<const double>(_data + i * _cols, _cols)
+                           : strided_span<const double>(_data + i, _cols, _rows);
+    }
+
+    /**
+     * @brief col function
+     * @return strided_span<const double>: the feature j of every sample, contiguous in a
+     * column major view
+     */
+    strided_span<const double> col(size_t j) const {
+        return row_major() ? strided_span<const double>(_data + j, _rows, _cols)
+                           : strided_span<const double>(_data + j * _rows, _rows);
+    }
+
+    /**
+     * @brief slice function
+     * @param begin the first sample
+     * @param count the number of samples
+     * @return dataset_view: the samples [begin, begin + count) of a row major view, e.g. a
+     * chunk of a file too large to go through an estimator at once. Throws
+     * std::invalid_argument if the view is column major or the samples are out of it.
+     */
+    dataset_view slice(size_t begin, size_t count) const {
+        if (!row_major()) {
+            throw std::invalid_argument("dataset_view: only row major views can be sliced");
+        }
+        if (begin > _rows || count > _rows - begin) {
+            throw std::invalid_argument("dataset_view: the slice is out of the view");
+        }
+        return {_data + begin * _cols, count, _cols};
+    }
+
+    /**
+     * @brief to_matrix function
+     * @return Matrix<double>: a row major copy of the view
+     */
+    Matrix<double> to_matrix() const {
+        Matrix<double> m(_rows, _cols);
+        if (row_major()) {
+            std::copy(_data, _data + size(), m.data());
+            return m;
+        }
+        for (size_t j = 0; j < _cols; j++) {
+            for (size_t i = 0; i < _rows; i++) {
+                m(i, j) = _data[j * _rows + i];
+            }
+        }
+        return m;
+    }
+
+  private:
+    const double* _data{nullptr};
+    size_t _rows{0};
+    size_t _cols{0};
+    dataset_layout _layout{dataset_layout::row_major};
+};
+
+/**
+ * @brief fixed size header at the start of a dataset file
+ * The file is native-endian: the header, padded to 64 bytes, the rows x cols features as
+ * doubles in the layout of the header, then a label per row as doubles if the file is
+ * labeled.
+ */
+struct dataset_header {
+    static constexpr uint32_t MAGIC = 0x53445041; // "APDS" read as little endian
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic{MAGIC};
+    uint32_t version{VERSION};
+    uint32_t layout{0};
+    uint32_t flags{0};
+    uint64_t rows{0};
+    uint64_t cols{0};
+    uint64_t features_at{0};
+    uint64_t labels_at{0};
+    uint64_t size{0};
+
+    static constexpr uint32_t LABELED = 1;
+};
+
+/**
+ * @brief options of load_csv() / parse_csv()
+ * @param delimiter: the separator of the fields of a line.
+ * @param header: the first line holds the names of the columns and is skipped.
+ * @param label_column: the column that holds the label of the row, if any.
+ * @param layout: the layout of the features of the result.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ */
+struct csv_options {
+    char delimiter{','};
+    bool header{false};
+    std::optional<size_t> label_column{};
+    dataset_layout layout{dataset_layout::row_major};
+    size_t threads{0};
+};
+
+/**
+ * @brief dataset class
+ * The features and the labels of a set of samples, either mapped from a dataset file(see
+ * save_dataset) and read in place, or owned after parsing a csv(see load_csv). It is only
+ * moved, never copied, and its views stay valid as long as it lives.
+ */
+class dataset {
+  public:
+    /**
+     * @brief Construct a new dataset object over a dataset file
+     * Maps the file and checks its header, nothing is parsed or copied: the features and the
+     * labels are views of the pages of the mapping, read from disk as they are used.
+     * @param path: a file written by save_dataset.
+     * @param access: sequential for the estimators that sweep the samples, random for the
+     * ones that draw them. Default = sequential
+     * Throws std::runtime_error if the file can not be read or is not a valid dataset file.
+     */
+    explicit dataset(const std::string& path, file_access access = file_access::sequential)
+        : _file(std::make_unique<mapped_file>(path, access)) {
+        std::string_view data = _file->view();
+        dataset_header h;
+        if (data.size() < sizeof(h)) {
+            throw std::runtime_error("Dataset " + path + " is truncated");
+        }
+        std::memcpy(&h, data.data(), sizeof(h));
+        if (h.magic != dataset_header::MAGIC) {
+            throw std::runtime_error(path + " is not a dataset file");
+        }
+        if (h.version != dataset_header::VERSION) {
+            throw std::runtime_error("Dataset " + path + " has unsupported version " +
+                                     std::to_string(h.version));
+        }
+        const bool labeled = h.flags & dataset_header::LABELED;
+        const bool overflows = h.cols != 0 && h.rows > UINT64_MAX / 16 / h.cols;
+        if (h.layout > 1 || h.features_at % 8 != 0 || overflows ||
+            h.labels_at != h.features_at + 8 * h.rows * h.cols ||
+            h.size != h.labels_at + (labeled ? 8 * h.rows : 0)) {
+            throw std::runtime_error("Dataset " + path + " is corrupted");
+        }
+        if (data.size() < h.size) {
+            throw std::runtime_error("Dataset " + path + " is truncated");
+        }
+        auto at = [&](uint64_t offset) {
+            return reinterpret_cast<const double*>(data.data() + offset);
+        };
+        _features = dataset_view(at(h.features_at), h.rows, h.cols, dataset_layout(h.layout));
+        if (labeled) {
+            _labels = std::span<const double>(at(h.labels_at), h.rows);
+        }
+    }
+
+    /**
+     * @brief Construct a new dataset object that owns its values
+     * @param values: the rows x cols features in the order of layout
+     * @param rows: the number of samples
+     * @param cols: the number of features
+     * @param layout: the order of values
+     * @param labels: a label per sample, or none
+     * Throws std::invalid_argument if values does not have rows x cols values or labels
+     * does not have a label per sample.
+     */
+    dataset(std::vector<double> values, size_t rows, size_t cols, dataset_layout layout,
+            std::vector<double> labels = {})
+        : _values(std::move(values)), _owned_labels(std::move(labels)) {
+        if (_values.size() != rows * cols) {
+            throw std::invalid_argument("dataset: the values must be rows x cols");
+        }
+        if (!_owned_labels.empty() && _owned_labels.size() != rows) {
+            throw std::invalid_argument("dataset: there must be a label per sample");
+        }
+        _features = dataset_view(_values.data(), rows, cols, layout);
+        _labels = _owned_labels;
+    }
+
+    dataset(dataset&&) noexcept = default;
+    dataset& operator=(dataset&&) noexcept = default;
+
+    /**
+     * @brief features function
+     * @return dataset_view: the features, a sample per row
+     */
+    dataset_view features() const { return _features; }
+
+    /**
+     * @brief labels function
+     * @return std::span<const double>: the label of every sample, empty if unlabeled
+     */
+    std::span<const double> labels() const { return _labels; }
+
+    size_t rows() const { return _features.rows(); }
+    size_t cols() const { return _features.cols(); }
+
+    /**
+     * @brief mapped function
+     * @return true if the values are read from a mapped file
+     */
+    bool mapped() const { return _file != nullptr; }
+
+  private:
+    // a mapped_file can not move, the pointer keeps the mapping in place when this moves
+    std::unique_ptr<mapped_file> _file;
+    std::vector<double> _values, _owned_labels;
+    dataset_view _features;
+    std::span<const double> _labels;
+};
+
+/**
+ * @brief save_dataset function
+ * Writes the features, in their layout, and the labels in the dataset file format, see
+ * dataset(path) to map it back.
+ * @param path: the output file, overwritten.
+ * @param features: the samples.
+ * @param labels: a label per sample, or none.
+ * Throws std::invalid_argument if labels is neither empty nor a label per sample and
+ * std::runtime_error if the file can not be written.
+ */
+inline void save_dataset(const std::string& path, dataset_view features,
+                         std::span<const double> labels = {}) {
+    if (!labels.empty() && labels.size() != features.rows()) {
+        throw std::invalid_argument("save_dataset: there must be a label per sample");
+    }
+    dataset_header h;
+    h.layout = uint32_t(features.layout());
+    h.flags = labels.empty() ? 0 : dataset_header::LABELED;
+    h.rows = features.rows();
+    h.cols = features.cols();
+    h.features_at = 64;
+    h.labels_at = h.features_at + 8 * features.size();
+    h.size = h.labels_at + 8 * labels.size();
+    static_assert(sizeof(dataset_header) <= 64);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Can't open file " + path);
+    }
+    char head[64] = {};
+    std::memcpy(head, &h, sizeof(h));
+    out.write(head, sizeof(head));
+    out.write(reinterpret_cast<const char*>(features.data()),
+              std::streamsize(8 * features.size()));
+    out.write(reinterpret_cast<const char*>(labels.data()), std::streamsize(8 * labels.size()));
+    if (!out.flush()) {
+        throw std::runtime_error("Can't write file " + path);
+    }
+}
+
+namespace _dataset_utils {
+/**
+ * @brief the features, checked to be a row major view, for the estimators that read a
+ * sample as contiguous values
+ */
+inline dataset_view row_major(dataset_view x, const char* who) {
+    if (!x.row_major()) {
+        throw std::invalid_argument(std::string(who) + ": the samples must be a row major view");
+    }
+    return x;
+}
+
+/**
+ * @brief moves a chunk boundary forward to the start of the next line
+ */
+inline size_t align_to_line(std::string_view data, size_t pos) {
+    if (pos == 0 || pos >= data.size()) {
+        return std::min(pos, data.size());
+    }
+    size_t nl = data.find('\n', pos - 1);
+    return nl == std::string_view::npos ? data.size() : nl + 1;
+}
+
+inline bool blank(std::string_view line) {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+/**
+ * @brief calls f(line) for every line of data that is not blank
+ */
+template <typename F> void for_each_line(std::string_view data, F&& f) {
+    size_t p = 0;
+    while (p < data.size()) {
+        size_t e = std::min(data.find('\n', p), data.size());
+        std::string_view line = data.substr(p, e - p);
+        if (!blank(line)) {
+            f(line);
+        }
+        p = e + 1;
+    }
+}
+
+inline std::string_view trim(std::string_view s) {
+    size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string_view::npos) {
+        return {};
+    }
+    return s.substr(b, s.find_last_not_of(" \t\r") + 1 - b);
+}
+
+inline size_t fields(std::string_view line, char delimiter) {
+    return size_t(std::count(line.begin(), line.end(), delimiter)) + 1;
+}
+} // namespace _dataset_utils
+
+/**
+ * @brief parse_csv function
+ * Parses a csv of numbers into a dataset in two parallel passes over chunks of lines: the
+ * first counts the samples of every chunk, so every chunk knows the first sample it holds,
+ * the second parses the fields of its lines with std::from_chars straight into their place
+ * in the features and the labels, allocated once.
+ * @param data: the whole csv, blank lines are skipped.
+ * @param opt: delimiter, header, label column, layout and thread count.
+ * @returns dataset: the samples, a row per non blank line. Throws std::invalid_argument on a
+ * field that is not a number or a line that does not have the fields of the first one.
+ */
+inline dataset parse_csv(std::string_view data, const csv_options& opt = {}) {
+    using namespace _dataset_utils;
+    if (opt.header) {
+        size_t nl = data.find('\n');
+        data = nl == std::string_view::npos ? std::string_view() : data.substr(nl + 1);
+    }
+    // the first non blank line sets the number of fields of every line
+    size_t total = 0;
+    for (size_t p = 0; p < data.size() && total == 0;) {
+        size_t e = std::min(data.find('\n', p), data.size());
+        if (!blank(data.substr(p, e - p))) {
+            total = fields(data.substr(p, e - p), opt.delimiter);
+        }
+        p = e + 1;
+    }
+    if (opt.label_column && *opt.label_column >= total) {
+        throw std::invalid_argument("parse_csv: the label column is not a column of the csv");
+    }
+    const bool labeled = opt.label_column.has_value();
+    const size_t label = labeled ? *opt.label_column : total;
+    const size_t cols = total - (labeled ? 1 : 0);
+
+    // every chunk starts at the first line that begins inside its byte range
+    const size_t threads = PARALLEL::resolve_threads(opt.threads, data.size() / 4096 + 1);
+    std::vector<std::string_view> chunks(threads);
+    for (size_t t = 0; t < threads; t++) {
+        size_t b = align_to_line(data, data.size() * t / threads);
+        size_t e = align_to_line(data, data.size() * (t + 1) / threads);
+        chunks[t] = data.substr(b, e - b);
+    }
+    std::vector<size_t> first(threads + 1, 0);
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            for_each_line(chunks[t], [&](std::string_view) { first[t + 1]++; });
+        }
+    });
+    for (size_t t = 0; t < threads; t++) {
+        first[t + 1] += first[t];
+    }
+    const size_t rows = first.back();
+
+    std::vector<double> values(rows * cols), labels(labeled ? rows : 0);
+    std::vector<std::string> errors(threads);
+    const bool row_major = opt.layout == dataset_layout::row_major;
+    PARALLEL::parallel_for(0, threads, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t t = lo; t < hi; t++) {
+            size_t r = first[t];
+            for_each_line(chunks[t], [&](std::string_view line) {
+                if (!errors[t].empty()) {
+                    return;
+                }
+                size_t k = 0, j = 0, p = 0;
+                for (; p <= line.size() && k < total; k++) {
+                    size_t e = std::min(line.find(opt.delimiter, p), line.size());
+                    std::string_view tok = trim(line.substr(p, e - p));
+                    double v;
+                    auto [ptr, ec] = std::from_chars(tok.data(), tok.data() + tok.size(), v);
+                    if (tok.empty() || ec != std::errc() || ptr != tok.data() + tok.size()) {
+                        break;
+                    }
+                    if (k == label) {
+                        labels[r] = v;
+                    } else {
+                        values[row_major ? r * cols + j : j * rows + r] = v;
+                        j++;
+                    }
+                    p = e + 1;
+                }
+                if (k != total || p <= line.size()) {
+                    errors[t] = "Malformed csv line: " + std::string(trim(line));
+                }
+                r++;
+            });
+        }
+    });
+    for (const std::string& e : errors) {
+        if (!e.empty()) {
+            throw std::invalid_argument(e);
+        }
+    }
+    return dataset(std::move(values), rows, cols, opt.layout, std::move(labels));
+}
+
+/**
+ * @brief load_csv function
+ * Memory maps path and parses it with parse_csv().
+ * @param path: the csv file.
+ * @param opt: delimiter, header, label column, layout and thread count.
+ * @returns dataset: the samples. Throws std::runtime_error if the file can not be read and
+ * std::invalid_argument on malformed input.
+ */
+inline dataset load_csv(const std::string& path, const csv_options& opt = {}) {
+    mapped_file file(path);
+    return parse_csv(file.view(), opt);
+}
+
+#endif
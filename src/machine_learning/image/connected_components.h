@@ -0,0 +1,301 @@
+#ifndef CONNECTED_COMPONENTS_H
+#define CONNECTED_COMPONENTS_H
+
+#include "../../classes/disjoint_set/disjoint_set.h"
+#include "../../helpers/parallel.h"
+#include "image_buffer.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace connected_components {
+/**
+ * @brief the neighbors a pixel is connected to: the 4 sharing a side, or the 8 sharing a side
+ * or a corner
+ */
+enum class connectivity { four, eight };
+
+/**
+ * @brief the statistics of a component: its area in pixels, its bounding box(the region
+ * roi(y, x, height, width) of the image) and its centroid
+ */
+struct component {
+    uint64_t area{0};
+    size_t y{0}, x{0}, height{0}, width{0};
+    double cy{0}, cx{0};
+};
+} // namespace connected_components
+
+namespace _connected_components_utils {
+using connected_components::connectivity;
+
+// area, bounding box and coordinate sums of a set of pixels
+struct stats {
+    uint64_t area{0}, sum_y{0}, sum_x{0};
+    size_t y0{std::numeric_limits<size_t>::max()}, x0{std::numeric_limits<size_t>::max()};
+    size_t y1{0}, x1{0};
+
+    inline void add(size_t y, size_t x) {
+        area++;
+        sum_y += y;
+        sum_x += x;
+        y0 = std::min(y0, y);
+        x0 = std::min(x0, x);
+        y1 = std::max(y1, y);
+        x1 = std::max(x1, x);
+    }
+
+    void merge(const stats& o) {
+        area += o.area;
+        sum_y += o.sum_y;
+        sum_x += o.sum_x;
+        y0 = std::min(y0, o.y0);
+        x0 = std::min(x0, o.x0);
+        y1 = std::max(y1, o.y1);
+        x1 = std::max(x1, o.x1);
+    }
+};
+
+// the most provisional labels the first pass can make on a h x w image
+inline size_t bound(size_t h, size_t w, connectivity c) {
+    return c == connectivity::eight ? ((h + 1) / 2) * ((w + 1) / 2) : (h * w + 1) / 2;
+}
+
+/**
+ * @brief a strip of rows labeled on its own: the first pass leaves provisional labels in
+ * the image, resolved to the strip's own labels 1..count by local[]
+ */
+struct strip {
+    size_t y0{0}, y1{0};
+    std::vector<uint32_t> local;
+    uint32_t count{0};
+    std::vector<stats> found;
+};
+
+/**
+ * @brief the first pass on the rows of s with the decision tree of SAUF(Wu, Otoo and
+ * Suzuki): for 8 connectivity the pixel above decides alone when it is set, and the pixels
+ * above right, above left and left are only read when they can change the label. The
+ * equivalences go to a compact_dsu; the statistics are gathered per provisional label.
+ */
+template <typename T, connectivity C, bool Stats>
+void first_pass(image_view<const T> src, image_view<uint32_t> labels, strip& s) {
+    const size_t w = src.width();
+    compact_dsu<false> sets(uint32_t(bound(s.y1 - s.y0, w, C) + 1));
+    std::vector<stats> provisional(Stats ? 1 : 0);
+    uint32_t next = 0;
+    auto fresh = [&]() {
+        if constexpr (Stats) {
+            provisional.emplace_back();
+        }
+        return ++next;
+    };
+    auto merge = [&](uint32_t a, uint32_t b) {
+        sets.join(a, b);
+        return a;
+    };
+    for (size_t y = s.y0; y < s.y1; y++) {
+        const T* in = src.row(y);
+        uint32_t* out = labels.row(y);
+        const bool above = y > s.y0;
+        const T* up = above ? src.row(y - 1) : nullptr;
+        const uint32_t* lup = above ? labels.row(y - 1) : nullptr;
+        for (size_t x = 0; x < w; x++) {
+            if (in[x] == T(0)) {
+                out[x] = 0;
+                continue;
+            }
+            const bool left = x > 0 && in[x - 1] != T(0);
+            uint32_t l;
+            if constexpr (C == connectivity::four) {
+                const bool q = above && up[x] != T(0);
+                l = q ? (left ? merge(lup[x], out[x - 1]) : lup[x]) : (left ? out[x - 1] : fresh());
+            } else {
+                if (above && up[x] != T(0)) {
+                    l = lup[x];
+                } else if (above && x + 1 < w && up[x + 1] != T(0)) {
+                    if (x > 0 && up[x - 1] != T(0)) {
+                        l = merge(lup[x + 1], lup[x - 1]);
+                    } else if (left) {
+                        l = merge(lup[x + 1], out[x - 1]);
+                    } else {
+                        l = lup[x + 1];
+                    }
+                } else if (above && x > 0 && up[x - 1] != T(0)) {
+                    l = lup[x - 1];
+                } else if (left) {
+                    l = out[x - 1];
+                } else {
+                    l = fresh();
+                }
+            }
+            out[x] = l;
+            if constexpr (Stats) {
+                provisional[l].add(y, x);
+            }
+        }
+    }
+    // the labels of the strip, in the order of their first pixel
+    s.local.assign(next + 1, 0);
+    s.count = 0;
+    for (uint32_t l = 1; l <= next; l++) {
+        const uint32_t root = sets.find(l);
+        if (s.local[root] == 0) {
+            s.local[root] = ++s.count;
+        }
+        s.local[l] = s.local[root];
+    }
+    if constexpr (Stats) {
+        s.found.assign(s.count + 1, stats{});
+        for (uint32_t l = 1; l <= next; l++) {
+            s.found[s.local[l]].merge(provisional[l]);
+        }
+    }
+}
+
+template <typename T, connectivity C, bool Stats>
+uint32_t run(image_view<const T> src, image_view<uint32_t> labels, size_t threads,
+             std::vector<connected_components::component>* out) {
+    if (src.height() != labels.height() || src.width() != labels.width()) {
+        throw std::invalid_argument("connected_components: the images must have the same shape");
+    }
+    const size_t h = src.height(), w = src.width();
+    if (h == 0 || w == 0) {
+        return 0;
+    }
+    if (bound(h, w, C) >= size_t(std::numeric_limits<int32_t>::max())) {
+        throw std::length_error("connected_components: the image is too large");
+    }
+    // strips of rows labeled in parallel, then merged along the rows between them
+    const size_t n = PARALLEL::resolve_threads(threads, h), rows = (h + n - 1) / n;
+    std::vector<strip> strips;
+    for (size_t y = 0; y < h; y += rows) {
+        strips.push_back(strip{y, std::min(h, y + rows), {}, 0, {}});
+    }
+    PARALLEL::parallel_for(0, strips.size(), strips.size(), [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            first_pass<T, C, Stats>(src, labels, strips[i]);
+        }
+    });
+
+    std::vector<uint32_t> offset(strips.size() + 1, 0);
+    for (size_t i = 0; i < strips.size(); i++) {
+        offset[i + 1] = offset[i] + strips[i].count;
+    }
+    compact_dsu<false> sets(offset.back() + 1);
+    auto global = [&](size_t i, uint32_t provisional) {
+        return offset[i] + strips[i].local[provisional];
+    };
+    for (size_t i = 1; i < strips.size(); i++) {
+        const size_t y = strips[i].y0;
+        const uint32_t* up = labels.row(y - 1);
+        const uint32_t* cur = labels.row(y);
+        for (size_t x = 0; x < w; x++) {
+            if (cur[x] == 0) {
+                continue;
+            }
+            const size_t a = C == connectivity::eight && x > 0 ? x - 1 : x;
+            const size_t b = C == connectivity::eight && x + 1 < w ? x + 1 : x;
+            for (size_t k = a; k <= b; k++) {
+                if (up[k] != 0) {
+                    sets.join(global(i, cur[x]), global(i - 1, up[k]));
+                }
+            }
+        }
+    }
+    // the final labels, in the order of the first pixel of the components
+    std::vector<uint32_t> final_label(offset.back() + 1, 0);
+    uint32_t count = 0;
+    for (uint32_t g = 1; g <= offset.back(); g++) {
+        const uint32_t root = sets.find(g);
+        if (final_label[root] == 0) {
+            final_label[root] = ++count;
+        }
+        final_label[g] = final_label[root];
+    }
+    PARALLEL::parallel_for(0, strips.size(), strips.size(), [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            for (size_t y = strips[i].y0; y < strips[i].y1; y++) {
+                uint32_t* row = labels.row(y);
+                for (size_t x = 0; x < w; x++) {
+                    row[x] = row[x] != 0 ? final_label[global(i, row[x])] : 0;
+                }
+            }
+        }
+    });
+    if constexpr (Stats) {
+        std::vector<stats> merged(count + 1);
+        for (size_t i = 0; i < strips.size(); i++) {
+            for (uint32_t l = 1; l <= strips[i].count; l++) {
+                merged[final_label[offset[i] + l]].merge(strips[i].found[l]);
+            }
+        }
+        out->assign(count, connected_components::component{});
+        for (uint32_t l = 1; l <= count; l++) {
+            const stats& m = merged[l];
+            (*out)[l - 1] = connected_components::component{
+                m.area,
+                m.y0,
+                m.x0,
+                m.y1 - m.y0 + 1,
+                m.x1 - m.x0 + 1,
+                double(m.sum_y) / double(m.area),
+                double(m.sum_x) / double(m.area)};
+        }
+    }
+    return count;
+}
+
+template <typename T, bool Stats>
+uint32_t dispatch(image_view<const T> src, image_view<uint32_t> labels, connectivity c,
+                  size_t threads, std::vector<connected_components::component>* out) {
+    return c == connectivity::eight ? run<T, connectivity::eight, Stats>(src, labels, threads, out)
+                                    : run<T, connectivity::four, Stats>(src, labels, threads, out);
+}
+} // namespace _connected_components_utils
+
+namespace connected_components {
+/**
+ * @brief label function: labels the connected components of the pixels that are not 0, in
+ * two passes with the decision tree of SAUF and a compact_dsu of the label equivalences
+ * @param src the binary image
+ * @param labels set to 0 on the background and to the label, from 1, of the component of
+ * every other pixel, the components numbered in the order of their first pixel from the top
+ * left. Of the shape of src.
+ * @param conn the connectivity of the pixels. Default = eight
+ * @param threads number of threads(0 means every hardware thread), each labeling a strip of
+ * rows before the strips are merged; the labels do not depend on it. Default = 1
+ * @return uint32_t: the number of components
+ * Throws std::invalid_argument if the images have different shapes.
+ */
+template <typename T>
+uint32_t label(image_view<T> src, image_view<uint32_t> labels,
+               connectivity conn = connectivity::eight, size_t threads = 1) {
+    using P = std::remove_const_t<T>;
+    return _connected_components_utils::dispatch<P, false>(image_view<const P>(src), labels, conn,
+                                                           threads, nullptr);
+}
+
+/**
+ * @brief label_stats function: labels the connected components as label, and gathers their
+ * statistics in the same pass
+ * @return std::vector<component>: the statistics of every component, label l at l - 1
+ */
+template <typename T>
+std::vector<component> label_stats(image_view<T> src, image_view<uint32_t> labels,
+                                   connectivity conn = connectivity::eight, size_t threads = 1) {
+    using P = std::remove_const_t<T>;
+    std::vector<component> out;
+    _connected_components_utils::dispatch<P, true>(image_view<const P>(src), labels, conn,
+                                                   threads, &out);
+    return out;
+}
+} // namespace connected_components
+
+#endif
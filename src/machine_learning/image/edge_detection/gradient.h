@@ -0,0 +1,345 @@
+#ifndef GRADIENT_H
+#define GRADIENT_H
+
+#include "../../../helpers/parallel.h"
+#include "../../../linalg/mat_expr.h"
+#include "../image_buffer.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#endif
+
+/**
+ * @brief the 3x3 derivative kernels of a gradient: sobel(1 2 1 smoothing) or prewitt(1 1 1)
+ */
+enum class gradient_operator { sobel, prewitt };
+
+/**
+ * @brief how the gradient (gx, gy) becomes a magnitude: |gx| + |gy|(l1), sqrt(gx^2 + gy^2)
+ * (l2), or max + min / 2 - max / 16 - min / 32 of |gx| and |gy|(approximate), within 7% of
+ * l2 without a square root
+ */
+enum class gradient_norm { l1, l2, approximate };
+
+namespace _gradient_utils {
+// tan(22.5 degrees) in Q15, the bound between the direction bins
+constexpr int tan_22_5 = 13573;
+
+// the derivatives at x of the rows above(a), at(b) and below(c) x, replicated at the borders
+template <gradient_operator Op>
+inline void derivatives(const uint8_t* a, const uint8_t* b, const uint8_t* c, size_t x,
+                        size_t w, int& gx, int& gy) {
+    const size_t l = x > 0 ? x - 1 : 0, r = x + 1 < w ? x + 1 : w - 1;
+    constexpr int k = Op == gradient_operator::sobel ? 2 : 1;
+    gx = (a[r] - a[l]) + k * (b[r] - b[l]) + (c[r] - c[l]);
+    gy = (c[l] + k * c[x] + c[r]) - (a[l] + k * a[x] + a[r]);
+}
+
+template <gradient_norm N> inline uint16_t norm(int gx, int gy) {
+    const int ax = std::abs(gx), ay = std::abs(gy);
+    if constexpr (N == gradient_norm::l1) {
+        return uint16_t(ax + ay);
+    } else if constexpr (N == gradient_norm::l2) {
+        return uint16_t(std::lrint(std::sqrt(float(ax * ax + ay * ay))));
+    } else {
+        const int mx = std::max(ax, ay), mn = std::min(ax, ay);
+        return uint16_t(mx - (mx >> 4) + (mn >> 1) - (mn >> 5));
+    }
+}
+
+/**
+ * @brief the bin of the direction of (gx, gy): 0 horizontal, 1 along the diagonal to
+ * (x + 1, y + 1), 2 vertical, 3 along the diagonal to (x + 1, y - 1), each 45 degrees wide
+ */
+inline uint8_t direction(int gx, int gy) {
+    const int ax = std::abs(gx), ay = std::abs(gy);
+    const int t = (ax * tan_22_5 + (1 << 14)) >> 15;
+    if (ay < t) {
+        return 0;
+    }
+    if (ay > 2 * ax + t) {
+        return 2;
+    }
+    return (gx ^ gy) < 0 ? 3 : 1;
+}
+
+/**
+ * @brief the magnitudes, and the directions if dir is not null, of the row between a and c
+ * of a w wide image. AVX2 computes 16 pixels at a time in int16 lanes; the border pixels
+ * and the tail are scalar.
+ */
+template <gradient_operator Op, gradient_norm N>
+void row(const uint8_t* a, const uint8_t* b, const uint8_t* c, size_t w, uint16_t* mag,
+         uint8_t* dir) {
+    auto scalar = [&](size_t x) {
+        int gx, gy;
+        derivatives<Op>(a, b, c, x, w, gx, gy);
+        mag[x] = norm<N>(gx, gy);
+        if (dir != nullptr) {
+            dir[x] = direction(gx, gy);
+        }
+    };
+    size_t x = 0;
+    scalar(x++);
+#if defined(__AVX2__)
+    auto load = [](const uint8_t* p) {
+        return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    };
+    for (; x + 17 <= w; x += 16) {
+        const __m256i al = load(a + x - 1), am = load(a + x), ar = load(a + x + 1);
+        const __m256i bl = load(b + x - 1), br = load(b + x + 1);
+        const __m256i cl = load(c + x - 1), cm = load(c + x), cr = load(c + x + 1);
+        __m256i gx = _mm256_add_epi16(_mm256_sub_epi16(ar, al), _mm256_sub_epi16(cr, cl));
+        __m256i bx = _mm256_sub_epi16(br, bl);
+        __m256i top = _mm256_add_epi16(al, ar), bottom = _mm256_add_epi16(cl, cr);
+        if constexpr (Op == gradient_operator::sobel) {
+            bx = _mm256_slli_epi16(bx, 1);
+            top = _mm256_add_epi16(top, _mm256_slli_epi16(am, 1));
+            bottom = _mm256_add_epi16(bottom, _mm256_slli_epi16(cm, 1));
+        } else {
+            top = _mm256_add_epi16(top, am);
+            bottom = _mm256_add_epi16(bottom, cm);
+        }
+        gx = _mm256_add_epi16(gx, bx);
+        const __m256i gy = _mm256_sub_epi16(bottom, top);
+        const __m256i ax = _mm256_abs_epi16(gx), ay = _mm256_abs_epi16(gy);
+        __m256i m;
+        if constexpr (N == gradient_norm::l1) {
+            m = _mm256_add_epi16(ax, ay);
+        } else if constexpr (N == gradient_norm::l2) {
+            // gx^2 + gy^2 in int32 pairs; unpacklo and unpackhi split each 128 bit lane, and
+            // packus puts the halves back in order
+            const __m256i lo = _mm256_unpacklo_epi16(gx, gy), hi = _mm256_unpackhi_epi16(gx, gy);
+            auto root = [](__m256i v) {
+                return _mm256_cvtps_epi32(_mm256_sqrt_ps(_mm256_cvtepi32_ps(v)));
+            };
+            m = _mm256_packus_epi32(root(_mm256_madd_epi16(lo, lo)),
+                                    root(_mm256_madd_epi16(hi, hi)));
+        } else {
+            const __m256i mx = _mm256_max_epi16(ax, ay), mn = _mm256_min_epi16(ax, ay);
+            m = _mm256_add_epi16(_mm256_sub_epi16(mx, _mm256_srli_epi16(mx, 4)),
+                                 _mm256_sub_epi16(_mm256_srli_epi16(mn, 1),
+                                                  _mm256_srli_epi16(mn, 5)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(mag + x), m);
+        if (dir != nullptr) {
+            const __m256i t = _mm256_mulhrs_epi16(ax, _mm256_set1_epi16(tan_22_5));
+            const __m256i horizontal = _mm256_cmpgt_epi16(t, ay);
+            const __m256i vertical =
+                _mm256_cmpgt_epi16(ay, _mm256_add_epi16(_mm256_add_epi16(ax, ax), t));
+            // 1, or 3 where gx and gy have opposite signs
+            const __m256i opposite = _mm256_srai_epi16(_mm256_xor_si256(gx, gy), 15);
+            __m256i d =
+                _mm256_sub_epi16(_mm256_set1_epi16(1), _mm256_add_epi16(opposite, opposite));
+            d = _mm256_blendv_epi8(d, _mm256_set1_epi16(2), vertical);
+            d = _mm256_andnot_si256(horizontal, d);
+            const __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(d, d), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dir + x), _mm256_castsi256_si128(bytes));
+        }
+    }
+#endif
+    for (; x < w; x++) {
+        scalar(x);
+    }
+}
+
+template <gradient_operator Op, gradient_norm N>
+void rows(image_view<const uint8_t> src, image_view<uint16_t> mag, image_view<uint8_t> dir,
+          size_t lo, size_t hi) {
+    const size_t h = src.height(), w = src.width();
+    for (size_t y = lo; y < hi; y++) {
+        row<Op, N>(src.row(y > 0 ? y - 1 : 0), src.row(y), src.row(y + 1 < h ? y + 1 : h - 1), w,
+                   mag.row(y), dir.height() > 0 ? dir.row(y) : nullptr);
+    }
+}
+
+/**
+ * @brief emit(y, x, v) for the pixels of rows [lo, hi) of mag, v the magnitude of the pixels
+ * above their neighbor before and not below their neighbor after them along the direction of
+ * their gradient and 0 for the others
+ */
+template <typename F>
+void suppress(image_view<const uint16_t> mag, image_view<const uint8_t> directions, size_t lo,
+              size_t hi, F&& emit) {
+    const size_t h = mag.height(), w = mag.width();
+    const ptrdiff_t s = ptrdiff_t(mag.stride());
+    // the neighbor before each direction bin, the one after is opposite it
+    static constexpr int dy[4] = {0, -1, -1, 1}, dx[4] = {-1, -1, 0, -1};
+    const ptrdiff_t before[4] = {-1, -s - 1, -s, s - 1};
+    auto border = [&](size_t y, size_t x) {
+        const int b = directions(y, x) & 3;
+        auto at = [&](int sy, int sx) -> int {
+            const size_t ny = size_t(int64_t(y) + sy), nx = size_t(int64_t(x) + sx);
+            return ny < h && nx < w ? mag(ny, nx) : 0;
+        };
+        const int v = mag(y, x);
+        emit(y, x, v > at(dy[b], dx[b]) && v >= at(-dy[b], -dx[b]) ? uint16_t(v) : 0);
+    };
+    for (size_t y = lo; y < hi; y++) {
+        if (y == 0 || y + 1 == h || w < 3) {
+            for (size_t x = 0; x < w; x++) {
+                border(y, x);
+            }
+            continue;
+        }
+        const uint16_t* m = mag.row(y);
+        const uint8_t* d = directions.row(y);
+        border(y, 0);
+        for (size_t x = 1; x + 1 < w; x++) {
+            const ptrdiff_t o = before[d[x] & 3];
+            const uint16_t v = m[x];
+            // & rather than &&: the ridges of noisy images defeat the branch predictor
+            emit(y, x, uint16_t(v * ((v > m[x + o]) & (v >= m[x - o]))));
+        }
+        border(y, w - 1);
+    }
+}
+
+template <typename T, typename U>
+void same_shape(const image_view<T>& a, const image_view<U>& b, const char* what) {
+    if (a.height() != b.height() || a.width() != b.width()) {
+        throw std::invalid_argument(std::string(what) + ": the images must have the same shape");
+    }
+}
+} // namespace _gradient_utils
+
+/**
+ * @brief gradient namespace
+ * The gradient of 8 bit images from their 3x3 derivatives, gx and gy computed and combined
+ * in one pass, and the canny edge detector on top of it.
+ */
+namespace gradient {
+/**
+ * @brief magnitude function
+ * @param src the image, replicated at its borders
+ * @param mag set to the magnitude of the gradient of every pixel, of the shape of src
+ * @param op the derivative kernels. Default = sobel
+ * @param norm the magnitude of (gx, gy). Default = l2
+ * @param directions if not empty, set to the bin of the direction of the gradient of every
+ * pixel, of the shape of src: 0 horizontal, 1 along the diagonal to (x + 1, y + 1), 2
+ * vertical, 3 along the diagonal to (x + 1, y - 1), each 45 degrees wide. Default = empty
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the images have different shapes.
+ */
+inline void magnitude(image_view<const uint8_t> src, image_view<uint16_t> mag,
+                      gradient_operator op = gradient_operator::sobel,
+                      gradient_norm norm = gradient_norm::l2,
+                      image_view<uint8_t> directions = {}, size_t threads = 1) {
+    _gradient_utils::same_shape(src, mag, "gradient::magnitude");
+    if (directions.height() > 0) {
+        _gradient_utils::same_shape(src, directions, "gradient::magnitude");
+    }
+    if (src.height() == 0 || src.width() == 0) {
+        return;
+    }
+    auto run = [&](auto kernel) {
+        PARALLEL::parallel_for(0, src.height(), threads, [&](size_t lo, size_t hi, size_t) {
+            kernel(src, mag, directions, lo, hi);
+        });
+    };
+    const bool sobel = op == gradient_operator::sobel;
+    if (norm == gradient_norm::l1) {
+        sobel ? run(_gradient_utils::rows<gradient_operator::sobel, gradient_norm::l1>)
+              : run(_gradient_utils::rows<gradient_operator::prewitt, gradient_norm::l1>);
+    } else if (norm == gradient_norm::l2) {
+        sobel ? run(_gradient_utils::rows<gradient_operator::sobel, gradient_norm::l2>)
+              : run(_gradient_utils::rows<gradient_operator::prewitt, gradient_norm::l2>);
+    } else {
+        sobel ? run(_gradient_utils::rows<gradient_operator::sobel, gradient_norm::approximate>)
+              : run(_gradient_utils::rows<gradient_operator::prewitt, gradient_norm::approximate>);
+    }
+}
+
+/**
+ * @brief non_max_suppression function: thins the ridges of a gradient magnitude to a pixel,
+ * keeping the pixels above their neighbor before and not below their neighbor after them
+ * along the direction of their gradient, the others set to 0
+ * @param mag the magnitudes, see magnitude
+ * @param directions their direction bins, see magnitude
+ * @param dst set to the kept magnitudes, of the shape of mag. It must not be mag.
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the images have different shapes.
+ */
+inline void non_max_suppression(image_view<const uint16_t> mag,
+                                image_view<const uint8_t> directions, image_view<uint16_t> dst,
+                                size_t threads = 1) {
+    _gradient_utils::same_shape(mag, directions, "gradient::non_max_suppression");
+    _gradient_utils::same_shape(mag, dst, "gradient::non_max_suppression");
+    PARALLEL::parallel_for(0, mag.height(), threads, [&](size_t lo, size_t hi, size_t) {
+        _gradient_utils::suppress(mag, directions, lo, hi,
+                                  [&](size_t y, size_t x, uint16_t v) { dst(y, x) = v; });
+    });
+}
+
+/**
+ * @brief canny function: the edges of an image, the ridges of its gradient magnitude above
+ * high and those above low connected to them
+ * @param src the image, that is best smoothed first(see gaussian_filter::gaussian_blur)
+ * @param dst set to 255 on the edges and 0 elsewhere, of the shape of src. It may be src.
+ * @param low the magnitude an edge continues above
+ * @param high the magnitude an edge starts above, at least low
+ * @param op the derivative kernels. Default = sobel
+ * @param norm the magnitude of the gradient. Default = l2
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the images have different shapes or low > high.
+ */
+inline void canny(image_view<const uint8_t> src, image_view<uint8_t> dst, uint16_t low,
+                  uint16_t high, gradient_operator op = gradient_operator::sobel,
+                  gradient_norm norm = gradient_norm::l2, size_t threads = 1) {
+    _gradient_utils::same_shape(src, dst, "gradient::canny");
+    if (low > high) {
+        throw std::invalid_argument("gradient::canny: low must not be above high");
+    }
+    const size_t h = src.height(), w = src.width();
+    image_buffer<uint16_t> mag(h, w);
+    image_buffer<uint8_t> directions(h, w);
+    magnitude(src, mag.view(), op, norm, directions.view(), threads);
+
+    // the ridges classified in dst: 2 above high, 1 above low, 0 elsewhere
+    constexpr uint8_t weak = 1, strong = 2, edge = 255;
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        _gradient_utils::suppress(mag.view(), directions.view(), lo, hi,
+                                  [&](size_t y, size_t x, uint16_t v) {
+                                      dst(y, x) = uint8_t((v > low) + (v > high));
+                                  });
+    });
+
+    // hysteresis: the strong pixels are edges, and the weak ones 8 connected to edges
+    std::vector<size_t> stack;
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            if (dst(y, x) == strong) {
+                dst(y, x) = edge;
+                stack.push_back(y * w + x);
+            }
+        }
+    }
+    while (!stack.empty()) {
+        const size_t y = stack.back() / w, x = stack.back() % w;
+        stack.pop_back();
+        for (size_t ny = y > 0 ? y - 1 : 0; ny <= std::min(y + 1, h - 1); ny++) {
+            for (size_t nx = x > 0 ? x - 1 : 0; nx <= std::min(x + 1, w - 1); nx++) {
+                if (dst(ny, nx) == weak) {
+                    dst(ny, nx) = edge;
+                    stack.push_back(ny * w + nx);
+                }
+            }
+        }
+    }
+    for (size_t y = 0; y < h; y++) {
+        uint8_t* out = dst.row(y);
+        for (size_t x = 0; x < w; x++) {
+            out[x] = out[x] == edge ? edge : 0;
+        }
+    }
+}
+} // namespace gradient
+
+#endif
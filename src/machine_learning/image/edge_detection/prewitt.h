@@ -1,6 +1,8 @@
 #ifndef PREWITT_H
 #define PREWITT_H
 
+#include "gradient.h"
+
 #ifdef __cplusplus
 #include <cmath>
 #include <iostream>
@@ -55,6 +57,21 @@ inline std::vector<std::vector<int32_t>> Prewitt(const std::vector<std::vector<i
 
     return square(G.get_2d_array()); // result is: G = sqrt(G_x^2 + G_y^2)
 }
+
+/**
+ * @brief magnitude function: the prewitt gradient magnitude of an 8 bit image, gx and gy
+ * computed and combined in one pass(see gradient::magnitude)
+ * @param src the image, replicated at its borders
+ * @param mag set to the magnitudes, of the shape of src
+ * @param norm the magnitude of (gx, gy). Default = l2
+ * @param directions if not empty, set to the direction bins. Default = empty
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+inline void magnitude(image_view<const uint8_t> src, image_view<uint16_t> mag,
+                      gradient_norm norm = gradient_norm::l2,
+                      image_view<uint8_t> directions = {}, size_t threads = 1) {
+    gradient::magnitude(src, mag, gradient_operator::prewitt, norm, directions, threads);
+}
 } // namespace prewitt
 
 #endif
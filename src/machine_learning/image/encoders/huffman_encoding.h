@@ -1,17 +1,612 @@
 #ifndef HUFFMAN_ENCODING_H
 #define HUFFMAN_ENCODING_H
 
+#include "../../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <queue>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 #endif
 
+namespace _huffman_utils {
+inline uint64_t load(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+        v = __builtin_bswap64(v);
+    }
+    return v;
+}
+
+inline void store(uint8_t* p, uint64_t v) {
+    if constexpr (std::endian::native == std::endian::big) {
+        v = __builtin_bswap64(v);
+    }
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline uint32_t reverse(uint32_t code, unsigned length) {
+    uint32_t r = 0;
+    for (unsigned i = 0; i < length; i++) {
+        r = (r << 1) | ((code >> i) & 1);
+    }
+    return r;
+}
+
+/**
+ * @brief counts the symbols of data, every thread a contiguous chunk. The bytes are counted
+ * in 4 tables taken in turn, so a run of the same byte does not wait on the store of its
+ * previous count.
+ */
+template <typename T>
+std::vector<uint64_t> histogram(std::span<const T> data, size_t threads) {
+    constexpr size_t SYMBOLS = size_t(1) << (8 * sizeof(T));
+    constexpr size_t TABLES = sizeof(T) == 1 ? 4 : 1;
+    const size_t n = data.size();
+    threads = PARALLEL::resolve_threads(threads, n / 65536 + 1);
+    std::vector<std::vector<uint64_t>> counts(threads);
+    PARALLEL::parallel_for(0, n, threads, [&](size_t lo, size_t hi, size_t tid) {
+        std::vector<uint64_t>& local = counts[tid];
+        local.assign(TABLES * SYMBOLS, 0);
+        const T* p = data.data();
+        size_t i = lo;
+        for (; i + TABLES <= hi; i += TABLES) {
+            for (size_t t = 0; t < TABLES; t++) {
+                local[t * SYMBOLS + p[i + t]]++;
+            }
+        }
+        for (; i < hi; i++) {
+            local[p[i]]++;
+        }
+    });
+    std::vector<uint64_t> out(SYMBOLS, 0);
+    for (const std::vector<uint64_t>& local : counts) {
+        for (size_t i = 0; i < local.size(); i++) {
+            out[i % SYMBOLS] += local[i];
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief runs f(i) on every frame i < frames on worker threads, and rethrows on the calling
+ * thread the exception of the first frame that failed
+ */
+template <typename F> void for_each_frame(size_t frames, size_t threads, F&& f) {
+    std::vector<std::exception_ptr> errors(frames);
+    PARALLEL::parallel_for_dynamic(0, frames, threads, [&](size_t i, size_t) {
+        try {
+            f(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    });
+    for (const std::exception_ptr& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+/**
+ * @brief the lengths of the huffman code of frequencies, at most max_depth bits: the deepest
+ * codes are cut to max_depth, then the shallowest codes that can be deepened repay the
+ * excess of the kraft sum, and the codes of the most frequent symbols are shortened again as
+ * long as it allows
+ */
+inline std::vector<uint8_t> lengths(const std::vector<uint64_t>& frequencies,
+                                    unsigned max_depth) {
+    const size_t n = frequencies.size();
+    std::vector<uint8_t> out(n, 0);
+    std::vector<uint32_t> used;
+    for (uint32_t s = 0; s < n; s++) {
+        if (frequencies[s] != 0) {
+            used.push_back(s);
+        }
+    }
+    if (used.size() > (size_t(1) << max_depth)) {
+        throw std::invalid_argument("huffman_codec: too many symbols for MAX_DEPTH");
+    }
+    if (used.size() == 1) {
+        out[used[0]] = 1;
+    }
+    if (used.size() <= 1) {
+        return out;
+    }
+    // least frequent first: the leaves at 0..m - 1 and the inner nodes after them are both
+    // created in the order of their weight, so two queues replace the heap
+    const size_t m = used.size();
+    std::sort(used.begin(), used.end(), [&](uint32_t a, uint32_t b) {
+        return frequencies[a] != frequencies[b] ? frequencies[a] < frequencies[b] : a < b;
+    });
+    std::vector<uint64_t> weight(2 * m - 1, 0);
+    std::vector<uint32_t> parent(2 * m - 1, 0);
+    for (size_t i = 0; i < m; i++) {
+        weight[i] = frequencies[used[i]];
+    }
+    size_t leaf = 0, inner = m;
+    auto lightest = [&](size_t next) {
+        return leaf < m && (inner == next || weight[leaf] <= weight[inner]) ? leaf++ : inner++;
+    };
+    for (size_t next = m; next < 2 * m - 1; next++) {
+        const size_t a = lightest(next), b = lightest(next);
+        parent[a] = parent[b] = uint32_t(next);
+        weight[next] = weight[a] + weight[b];
+    }
+    std::vector<unsigned> depth(2 * m - 1, 0);
+    for (size_t i = 2 * m - 1; i-- > 0;) {
+        depth[i] = i == 2 * m - 2 ? 0 : depth[parent[i]] + 1;
+    }
+    for (uint32_t i = 0; i < m; i++) {
+        out[used[i]] = uint8_t(std::min(depth[i], max_depth));
+    }
+
+    // most frequent first, so the lengths do not decrease along used
+    std::sort(used.begin(), used.end(), [&](uint32_t a, uint32_t b) {
+        return frequencies[a] != frequencies[b] ? frequencies[a] > frequencies[b] : a < b;
+    });
+    std::vector<unsigned> length(m);
+    for (size_t i = 0; i < m; i++) {
+        length[i] = out[used[i]];
+    }
+    std::sort(length.begin(), length.end());
+    // the kraft sum in units of 2^-max_depth
+    const uint64_t one = uint64_t(1) << max_depth;
+    uint64_t kraft = 0;
+    for (unsigned l : length) {
+        kraft += one >> l;
+    }
+    while (kraft > one) {
+        size_t i = m;
+        while (length[i - 1] == max_depth) {
+            i--;
+        }
+        kraft -= (one >> length[i - 1]) >> 1;
+        length[i - 1]++;
+    }
+    for (size_t i = 0; i < m; i++) {
+        while (length[i] > 1 && kraft + (one >> length[i]) <= one) {
+            kraft += one >> length[i];
+            length[i]--;
+        }
+    }
+    for (size_t i = 0; i < m; i++) {
+        out[used[i]] = uint8_t(length[i]);
+    }
+    return out;
+}
+} // namespace _huffman_utils
+
+/**
+ * @brief huffman codec class
+ * A canonical huffman code of the symbols 0..n - 1, of codes at most MAX_DEPTH bits, that
+ * is known from its code lengths alone. The codes are packed least significant bit first in
+ * a 64 bit accumulator, and decoded with a table of the next TABLE_BITS bits, the longer
+ * codes through a second table under their first TABLE_BITS bits. encode_frames splits the
+ * data in frames that are encoded and decoded on their own, in parallel.
+ */
+class huffman_codec {
+  public:
+    static constexpr unsigned MAX_LENGTH = 20;
+    static constexpr unsigned TABLE_BITS = 11;
+
+    /**
+     * @brief Construct a new huffman codec object
+     * @param frequencies the number of times every symbol appears, 0 for the symbols that
+     * are never encoded
+     * @param MAX_DEPTH the longest code, at most MAX_LENGTH. Default = 12
+     * Throws std::invalid_argument if MAX_DEPTH is out of range or 2^MAX_DEPTH is less than
+     * the symbols that appear.
+     */
+    explicit huffman_codec(const std::vector<uint64_t>& frequencies, int64_t MAX_DEPTH = 12) {
+        if (MAX_DEPTH < 1 || MAX_DEPTH > int64_t(MAX_LENGTH)) {
+            throw std::invalid_argument("huffman_codec: MAX_DEPTH is out of range");
+        }
+        _build(_huffman_utils::lengths(frequencies, unsigned(MAX_DEPTH)));
+    }
+
+    /**
+     * @brief from_lengths function
+     * @param lengths the code length of every symbol, 0 for no code, as lengths() returns
+     * @return huffman_codec: the canonical code of these lengths. Throws
+     * std::invalid_argument if a length is over MAX_LENGTH or the lengths are no prefix code.
+     */
+    static huffman_codec from_lengths(std::vector<uint8_t> lengths) {
+        huffman_codec c;
+        c._build(std::move(lengths));
+        return c;
+    }
+
+    /**
+     * @brief lengths function
+     * @return const std::vector<uint8_t>&: the code length of every symbol, all the decoder
+     * needs to know about the code
+     */
+    const std::vector<uint8_t>& lengths() const { return _lengths; }
+
+    /**
+     * @brief code function
+     * @param symbol the symbol
+     * @return std::string: the code of symbol as '0' and '1', empty if it has none
+     */
+    std::string code(uint32_t symbol) const {
+        if (symbol >= _lengths.size()) {
+            return "";
+        }
+        std::string out;
+        for (unsigned i = 0; i < _lengths[symbol]; i++) {
+            out += char('0' + ((_codes[symbol].bits >> i) & 1));
+        }
+        return out;
+    }
+
+    /**
+     * @brief encoded_bits function
+     * @param symbols the data
+     * @return uint64_t: the size of the encoded data in bits. Throws std::invalid_argument if
+     * a symbol has no code.
+     */
+    uint64_t encoded_bits(std::span<const uint8_t> symbols) const { return _bits(symbols); }
+    uint64_t encoded_bits(std::span<const uint16_t> symbols) const { return _bits(symbols); }
+
+    /**
+     * @brief encode function
+     * @param symbols the data
+     * @return std::vector<uint8_t>: the codes of the symbols, the last byte padded with 0.
+     * Throws std::invalid_argument if a symbol has no code.
+     */
+    std::vector<uint8_t> encode(std::span<const uint8_t> symbols) const {
+        return _encode(symbols);
+    }
+    std::vector<uint8_t> encode(std::span<const uint16_t> symbols) const {
+        return _encode(symbols);
+    }
+
+    /**
+     * @brief decode function
+     * @param bits data from encode
+     * @param symbols filled with the first symbols.size() symbols of bits
+     * Throws std::invalid_argument if a symbol does not fit the type of symbols, and
+     * std::runtime_error if bits is corrupt or too short.
+     */
+    void decode(std::span<const uint8_t> bits, std::span<uint8_t> symbols) const {
+        _decode(bits, symbols);
+    }
+    void decode(std::span<const uint8_t> bits, std::span<uint16_t> symbols) const {
+        _decode(bits, symbols);
+    }
+
+    /**
+     * @brief histogram function
+     * @param data the data
+     * @param threads number of threads(0 means every hardware thread), each counting a
+     * contiguous chunk of data. Default = 1
+     * @return std::vector<uint64_t>: the number of times every symbol appears, the
+     * frequencies of the constructor
+     */
+    static std::vector<uint64_t> histogram(std::span<const uint8_t> data, size_t threads = 1) {
+        return _huffman_utils::histogram(data, threads);
+    }
+    static std::vector<uint64_t> histogram(std::span<const uint16_t> data, size_t threads = 1) {
+        return _huffman_utils::histogram(data, threads);
+    }
+
+    /**
+     * @brief encode_frames function
+     * @param symbols the data
+     * @param frame the number of symbols of every frame, the last one may be shorter.
+     * Default = 1 << 20
+     * @param threads number of threads(0 means every hardware thread). Default = 0
+     * @return std::vector<uint8_t>: a header of the number of symbols, the frame size and the
+     * end of every frame, as 64 bit little endian words, then the frames, each encoded on its
+     * own, so decode_frames can decode them in parallel. Throws std::invalid_argument if a
+     * symbol has no code or frame is 0.
+     */
+    std::vector<uint8_t> encode_frames(std::span<const uint8_t> symbols, size_t frame = 1 << 20,
+                                       size_t threads = 0) const {
+        return _encode_frames(symbols, frame, threads);
+    }
+    std::vector<uint8_t> encode_frames(std::span<const uint16_t> symbols, size_t frame = 1 << 20,
+                                       size_t threads = 0) const {
+        return _encode_frames(symbols, frame, threads);
+    }
+
+    /**
+     * @brief frames_size function
+     * @param bits data from encode_frames
+     * @return size_t: the number of symbols encoded in bits. Throws std::runtime_error if the
+     * header is corrupt.
+     */
+    static size_t frames_size(std::span<const uint8_t> bits) {
+        return size_t(_frames_header(bits)[0]);
+    }
+
+    /**
+     * @brief decode_frames function
+     * @param bits data from encode_frames
+     * @param symbols filled with the symbols of bits, frames_size(bits) of them
+     * @param threads number of threads(0 means every hardware thread). Default = 0
+     * Throws std::invalid_argument if symbols has another size or a symbol does not fit its
+     * type, and std::runtime_error if bits is corrupt.
+     */
+    void decode_frames(std::span<const uint8_t> bits, std::span<uint8_t> symbols,
+                       size_t threads = 0) const {
+        _decode_frames(bits, symbols, threads);
+    }
+    void decode_frames(std::span<const uint8_t> bits, std::span<uint16_t> symbols,
+                       size_t threads = 0) const {
+        _decode_frames(bits, symbols, threads);
+    }
+
+  private:
+    struct code_t {
+        uint32_t bits;
+        uint32_t length;
+    };
+    // an entry of the table: the length of the code and its symbol, the bits and the
+    // offset of a second table or an invalid code
+    static constexpr uint32_t LINK = 0x40, INVALID = 0x80 | 1;
+    std::vector<uint8_t> _lengths;
+    std::vector<code_t> _codes;
+    std::vector<uint32_t> _table;
+    unsigned _table_bits{0};
+
+    huffman_codec() = default;
+
+    void _build(std::vector<uint8_t> lengths) {
+        if (lengths.size() > (size_t(1) << 24)) {
+            throw std::invalid_argument("huffman_codec: too many symbols");
+        }
+        std::vector<uint32_t> count(MAX_LENGTH + 1, 0);
+        for (uint8_t l : lengths) {
+            if (l > MAX_LENGTH) {
+                throw std::invalid_argument("huffman_codec: a code is longer than MAX_LENGTH");
+            }
+            count[l]++;
+        }
+        count[0] = 0;
+        uint64_t kraft = 0;
+        unsigned longest = 0;
+        for (unsigned l = 1; l <= MAX_LENGTH; l++) {
+            kraft += uint64_t(count[l]) << (MAX_LENGTH - l);
+            longest = count[l] != 0 ? l : longest;
+        }
+        if (kraft > (uint64_t(1) << MAX_LENGTH)) {
+            throw std::invalid_argument("huffman_codec: the lengths are no prefix code");
+        }
+        // the canonical codes, in the order of their length, then of their symbol
+        std::vector<uint32_t> next(MAX_LENGTH + 2, 0);
+        for (unsigned l = 1; l <= MAX_LENGTH; l++) {
+            next[l + 1] = (next[l] + count[l]) << 1;
+        }
+        _codes.assign(lengths.size(), code_t{0, 0});
+        for (size_t s = 0; s < lengths.size(); s++) {
+            if (lengths[s] != 0) {
+                _codes[s] = {_huffman_utils::reverse(next[lengths[s]]++, lengths[s]), lengths[s]};
+            }
+        }
+        _lengths = std::move(lengths);
+
+        _table_bits = std::min(longest, TABLE_BITS);
+        const uint32_t size = uint32_t(1) << _table_bits, mask = size - 1;
+        _table.assign(size, INVALID);
+        std::vector<uint32_t> sub(size, 0);
+        for (const code_t& c : _codes) {
+            if (c.length > _table_bits) {
+                sub[c.bits & mask] = std::max(sub[c.bits & mask], c.length - _table_bits);
+            }
+        }
+        for (uint32_t prefix = 0; prefix < size; prefix++) {
+            if (sub[prefix] != 0) {
+                _table[prefix] = uint32_t(_table.size()) << 8 | LINK | sub[prefix];
+                _table.resize(_table.size() + (size_t(1) << sub[prefix]), INVALID);
+            }
+        }
+        for (uint32_t s = 0; s < _codes.size(); s++) {
+            const code_t c = _codes[s];
+            if (c.length == 0) {
+                continue;
+            }
+            const uint32_t entry = s << 8 | c.length;
+            if (c.length <= _table_bits) {
+                for (uint32_t i = c.bits; i < size; i += uint32_t(1) << c.length) {
+                    _table[i] = entry;
+                }
+            } else {
+                const uint32_t link = _table[c.bits & mask], width = uint32_t(1) << (link & 0x3f);
+                for (uint32_t i = c.bits >> _table_bits; i < width;
+                     i += uint32_t(1) << (c.length - _table_bits)) {
+                    _table[(link >> 8) + i] = entry;
+                }
+            }
+        }
+    }
+
+    template <typename T> uint64_t _bits(std::span<const T> symbols) const {
+        const size_t n = _lengths.size();
+        uint64_t total = 0;
+        bool missing = false;
+        for (const T s : symbols) {
+            const uint32_t l = size_t(s) < n ? _codes[s].length : 0;
+            total += l;
+            missing |= l == 0;
+        }
+        if (missing) {
+            throw std::invalid_argument("huffman_codec: a symbol has no code");
+        }
+        return total;
+    }
+
+    template <typename T> std::vector<uint8_t> _encode(std::span<const T> symbols) const {
+        const uint64_t total = _bits(symbols);
+        // the accumulator is stored whole after every code, over the 8 bytes at the end
+        std::vector<uint8_t> out(size_t((total + 7) / 8) + sizeof(uint64_t), 0);
+        uint8_t* dst = out.data();
+        const code_t* codes = _codes.data();
+        uint64_t acc = 0;
+        unsigned filled = 0;
+        for (const T s : symbols) {
+            const code_t c = codes[s];
+            acc |= uint64_t(c.bits) << filled;
+            filled += c.length;
+            _huffman_utils::store(dst, acc);
+            dst += filled >> 3;
+            acc >>= filled & ~7u;
+            filled &= 7;
+        }
+        out.resize(size_t((total + 7) / 8));
+        return out;
+    }
+
+    template <typename T> void _decode(std::span<const uint8_t> bits, std::span<T> symbols) const {
+        if (_lengths.size() > size_t(std::numeric_limits<T>::max()) + 1) {
+            throw std::invalid_argument("huffman_codec: the symbols do not fit the output");
+        }
+        if (symbols.empty()) {
+            return;
+        }
+        const uint8_t* src = bits.data();
+        const size_t n = bits.size();
+        const uint32_t* table = _table.data();
+        const uint64_t mask = (uint64_t(1) << _table_bits) - 1;
+        const unsigned table_bits = _table_bits;
+        uint64_t acc = 0;
+        unsigned filled = 0;
+        size_t pos = 0;
+        uint32_t invalid = 0;
+        auto refill = [&]() {
+            if (pos + sizeof(uint64_t) <= n) {
+                acc |= _huffman_utils::load(src + pos) << filled;
+                pos += (63 - filled) >> 3;
+                filled |= 56;
+            } else {
+                // past the end the stream reads as 0, and pos counts the bytes read
+                for (; filled <= 56; filled += 8, pos++) {
+                    acc |= uint64_t(pos < n ? src[pos] : 0) << filled;
+                }
+            }
+        };
+        auto next = [&]() {
+            uint32_t e = table[acc & mask];
+            if (e & LINK) {
+                e = table[(e >> 8) + ((acc >> table_bits) & ((uint64_t(1) << (e & 0x3f)) - 1))];
+            }
+            invalid |= e;
+            acc >>= e & 0x3f;
+            filled -= e & 0x3f;
+            return T(e >> 8);
+        };
+        // the refill leaves at least 56 bits, two codes of at most MAX_LENGTH
+        size_t i = 0;
+        for (; i + 2 <= symbols.size(); i += 2) {
+            refill();
+            symbols[i] = next();
+            symbols[i + 1] = next();
+        }
+        if (i < symbols.size()) {
+            refill();
+            symbols[i] = next();
+        }
+        if ((invalid & 0x80) != 0) {
+            throw std::runtime_error("huffman_codec: the data is corrupt");
+        }
+        if (8 * pos - filled > 8 * uint64_t(n)) {
+            throw std::runtime_error("huffman_codec: the data is too short");
+        }
+    }
+
+    // the number of symbols, the frame size, then the end of every frame after the header
+    static std::vector<uint64_t> _frames_header(std::span<const uint8_t> bits) {
+        constexpr size_t W = sizeof(uint64_t);
+        if (bits.size() < 2 * W) {
+            throw std::runtime_error("huffman_codec: the frame header is corrupt");
+        }
+        const uint64_t total = _huffman_utils::load(bits.data()),
+                       frame = _huffman_utils::load(bits.data() + W);
+        if (frame == 0 && total != 0) {
+            throw std::runtime_error("huffman_codec: the frame header is corrupt");
+        }
+        const uint64_t frames = total == 0 ? 0 : (total - 1) / frame + 1;
+        if (frames > (bits.size() - 2 * W) / W) {
+            throw std::runtime_error("huffman_codec: the frame header is corrupt");
+        }
+        std::vector<uint64_t> header = {total, frame};
+        uint64_t end = 0;
+        for (uint64_t f = 0; f < frames; f++) {
+            const uint64_t next = _huffman_utils::load(bits.data() + (2 + f) * W);
+            if (next < end) {
+                throw std::runtime_error("huffman_codec: the frame header is corrupt");
+            }
+            header.push_back(end = next);
+        }
+        if (end > bits.size() - (2 + frames) * W) {
+            throw std::runtime_error("huffman_codec: the data is too short");
+        }
+        return header;
+    }
+
+    template <typename T>
+    std::vector<uint8_t> _encode_frames(std::span<const T> symbols, size_t frame,
+                                        size_t threads) const {
+        if (frame == 0) {
+            throw std::invalid_argument("huffman_codec: the frame size must be positive");
+        }
+        constexpr size_t W = sizeof(uint64_t);
+        const size_t frames = (symbols.size() + frame - 1) / frame;
+        std::vector<std::vector<uint8_t>> encoded(frames);
+        _huffman_utils::for_each_frame(frames, threads, [&](size_t f) {
+            encoded[f] =
+                _encode(symbols.subspan(f * frame, std::min(frame, symbols.size() - f * frame)));
+        });
+        const size_t start = (2 + frames) * W;
+        size_t size = start;
+        for (const std::vector<uint8_t>& e : encoded) {
+            size += e.size();
+        }
+        std::vector<uint8_t> out(size);
+        _huffman_utils::store(out.data(), symbols.size());
+        _huffman_utils::store(out.data() + W, frame);
+        size_t end = 0;
+        for (size_t f = 0; f < frames; f++) {
+            std::copy(encoded[f].begin(), encoded[f].end(), out.begin() + start + end);
+            end += encoded[f].size();
+            _huffman_utils::store(out.data() + (2 + f) * W, end);
+        }
+        return out;
+    }
+
+    template <typename T>
+    void _decode_frames(std::span<const uint8_t> bits, std::span<T> symbols,
+                        size_t threads) const {
+        const std::vector<uint64_t> header = _frames_header(bits);
+        if (header[0] != symbols.size()) {
+            throw std::invalid_argument("huffman_codec: the output has the wrong size");
+        }
+        const size_t frame = size_t(header[1]), frames = header.size() - 2;
+        const std::span<const uint8_t> data = bits.subspan((2 + frames) * sizeof(uint64_t));
+        _huffman_utils::for_each_frame(frames, threads, [&](size_t f) {
+            const size_t begin = f == 0 ? 0 : size_t(header[f + 1]);
+            _decode(data.subspan(begin, size_t(header[f + 2]) - begin),
+                    symbols.subspan(f * frame, std::min(frame, symbols.size() - f * frame)));
+        });
+    }
+};
+
 /**
  * @brief class for huffman coding
  */
@@ -44,10 +639,18 @@ class huffman {
      */
     explicit huffman(std::vector<std::string> v = {}, int64_t MAX_DEPTH = 10)
         : root(nullptr), MAX_DEPTH(MAX_DEPTH) {
+        std::vector<uint64_t> counts(256, 0);
         for (std::string& x : v) {
-            for (char& y : x) {
-                appearances[y]++;
-                _size++;
+            const auto f = _huffman_utils::histogram(
+                std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(x.data()), x.size()), 1);
+            for (size_t c = 0; c < 256; c++) {
+                counts[c] += f[c];
+            }
+        }
+        for (size_t c = 0; c < 256; c++) {
+            if (counts[c] != 0) {
+                appearances[static_cast<char>(c)] = double(counts[c]);
+                _size += double(counts[c]);
             }
         }
     }
@@ -78,13 +681,25 @@ class huffman {
      * @return unordered_map<string, string>: the resulted encoding
      */
     inline std::unordered_map<std::string, std::string> decode() {
-        std::vector<int> v(MAX_DEPTH);
-        int top = 0;
+        std::string code;
         std::unordered_map<std::string, std::string> decoded;
-        _decode(root, v, top, decoded);
+        _decode(root, code, decoded);
         return decoded;
     }
 
+    /**
+     * @brief codec function
+     * @return huffman_codec: the canonical code of the characters of the text, of codes at
+     * most MAX_DEPTH bits, that encodes and decodes them as their unsigned char values
+     */
+    inline huffman_codec codec() const {
+        std::vector<uint64_t> frequencies(256, 0);
+        for (auto& x : appearances) {
+            frequencies[static_cast<unsigned char>(x.first)] = uint64_t(x.second);
+        }
+        return huffman_codec(frequencies, MAX_DEPTH);
+    }
+
   private:
     void compute_weights() {
         for (auto& x : appearances) {
@@ -96,22 +711,20 @@ class huffman {
         }
     }
 
-    void _decode(std::shared_ptr<node> root, std::vector<int> arr, int top,
+    void _decode(std::shared_ptr<node> root, std::string& code,
                  std::unordered_map<std::string, std::string>& decoded) {
         if (root->left) {
-            arr[top] = 0;
-            _decode(root->left, arr, top + 1, decoded);
+            code.push_back('0');
+            _decode(root->left, code, decoded);
+            code.pop_back();
         }
         if (root->right) {
-            arr[top] = 1;
-            _decode(root->right, arr, top + 1, decoded);
+            code.push_back('1');
+            _decode(root->right, code, decoded);
+            code.pop_back();
         }
         if (!root->left && !root->right) {
-            std::string ans = "";
-            for (int i = 0; i < top; i++) {
-                ans += std::to_string(arr[i]);
-            }
-            decoded[root->ID] = ans;
+            decoded[root->ID] = code;
         }
     }
 };
@@ -1,8 +1,14 @@
 #ifndef AVERAGE_FILTER_H
 #define AVERAGE_FILTER_H
 
+#include "../integral_image.h"
+#include "convolution.h"
+
 #ifdef __cplusplus
 #include <iostream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 #include "../image.h"
 #endif
 
@@ -11,6 +17,37 @@
  */
 namespace avg_filter {
 
+/**
+ * @brief box_filter function: replaces every pixel of src by the mean of the size x size
+ * pixels around it, as two 1D passes(see convolution::sep_filter2d). Large boxes over
+ * integer images with zero borders are summed from an integral_image instead, in O(1) per
+ * pixel whatever the size.
+ * @param src the image to filter
+ * @param dst set to the filtered image, of the shape of src. It may be src.
+ * @param size the side of the box, odd
+ * @param border the pixels read outside of the image. Default = zero
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if size is even.
+ */
+template <typename T, typename U>
+void box_filter(image_view<T> src, image_view<U> dst, size_t size,
+                convolution::border_mode border = convolution::border_mode::zero,
+                size_t threads = 1) {
+    if (size % 2 == 0) {
+        throw std::invalid_argument("box_filter: the size must be odd");
+    }
+    if constexpr (std::is_integral_v<std::remove_const_t<T>>) {
+        // about where the passes, linear in size, get slower than building the sums
+        if (border == convolution::border_mode::zero && size >= 41) {
+            integral_filter::box_blur(src, dst, size / 2, threads, false);
+            return;
+        }
+    }
+    const std::vector<float> taps(size, 1.0f / float(size));
+    convolution::sep_filter2d(src, dst, std::span<const float>(taps),
+                              std::span<const float>(taps), border, threads);
+}
+
 /**
  * @brief apply_avg_filter function: applies a 3x3 average filter to passed
  * image: image
@@ -20,10 +57,9 @@ namespace avg_filter {
  */
 inline std::vector<std::vector<int32_t>>
 apply_avg_filter(const std::vector<std::vector<int32_t>>& image) {
-    Image img(image);
-    std::vector<std::vector<float>> kernel = {
-        {1.0 / 9, 1.0 / 9, 1.0 / 9}, {1.0 / 9, 1.0 / 9, 1.0 / 9}, {1.0 / 9, 1.0 / 9, 1.0 / 9}};
-    return img.apply_filter2d(kernel).get_2d_array();
+    image_buffer<int32_t> img{Image(image)};
+    box_filter(img.view(), img.view(), 3);
+    return img.to_image().get_2d_array();
 }
 } // namespace avg_filter
 
@@ -0,0 +1,321 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include "../../../helpers/parallel.h"
+#include "../../../linalg/matrix.h"
+#include "../image_buffer.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief convolution namespace
+ */
+namespace convolution {
+/**
+ * @brief the pixels outside of the image a kernel reads: zero, or the closest pixel of the
+ * image(replicate)
+ */
+enum class border_mode { zero, replicate };
+} // namespace convolution
+
+namespace _convolution_utils {
+/**
+ * @brief out[x] = the sum of taps[i * cols + j] * rows[i][x + j] over the nrows x cols
+ * taps, for x in [0, w). The rows are read past w by cols - 1 values, every x of a register
+ * summing all its taps before it is stored, four registers at a time across the row.
+ */
+template <typename F>
+void correlate(const F* const* rows, size_t nrows, const F* taps, size_t cols, size_t w,
+               F* out) {
+    size_t x = 0;
+    if constexpr (_mat_utils::simd<F>::enabled) {
+        using P = _mat_utils::simd<F>;
+        constexpr size_t W = P::width;
+        for (; x + 4 * W <= w; x += 4 * W) {
+            P s0 = P::broadcast(F(0)), s1 = s0, s2 = s0, s3 = s0;
+            for (size_t i = 0; i < nrows; i++) {
+                const F* r = rows[i] + x;
+                for (size_t j = 0; j < cols; j++) {
+                    P c = P::broadcast(taps[i * cols + j]);
+                    s0 = s0 + c * P::load(r + j);
+                    s1 = s1 + c * P::load(r + j + W);
+                    s2 = s2 + c * P::load(r + j + 2 * W);
+                    s3 = s3 + c * P::load(r + j + 3 * W);
+                }
+            }
+            s0.store(out + x);
+            s1.store(out + x + W);
+            s2.store(out + x + 2 * W);
+            s3.store(out + x + 3 * W);
+        }
+        for (; x + W <= w; x += W) {
+            P s = P::broadcast(F(0));
+            for (size_t i = 0; i < nrows; i++) {
+                for (size_t j = 0; j < cols; j++) {
+                    s = s + P::broadcast(taps[i * cols + j]) * P::load(rows[i] + x + j);
+                }
+            }
+            s.store(out + x);
+        }
+    }
+    for (; x < w; x++) {
+        F s = 0;
+        for (size_t i = 0; i < nrows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                s += taps[i * cols + j] * rows[i][x + j];
+            }
+        }
+        out[x] = s;
+    }
+}
+
+/**
+ * @brief the pixels of src as floats, with rx pixels of border on both sides of every row
+ */
+template <typename T>
+image_buffer<float> pad(image_view<const T> src, size_t rx, convolution::border_mode border,
+                        size_t threads) {
+    const size_t w = src.width();
+    image_buffer<float> p(src.height(), w + 2 * rx);
+    PARALLEL::parallel_for(0, src.height(), threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t y = lo; y < hi; y++) {
+            const T* s = src.row(y);
+            float* d = p.row(y);
+            for (size_t x = 0; x < w; x++) {
+                d[rx + x] = float(s[x]);
+            }
+            if (border == convolution::border_mode::replicate) {
+                std::fill(d, d + rx, d[rx]);
+                std::fill(d + rx + w, d + w + 2 * rx, d[rx + w - 1]);
+            }
+        }
+    });
+    return p;
+}
+
+/**
+ * @brief the rows -ry to height + ry - 1 of p, the rows off the image being zeros or the
+ * closest row of the image, so the vertical taps need no bounds check
+ */
+inline std::vector<const float*> row_table(const image_buffer<float>& p, size_t ry,
+                                           convolution::border_mode border,
+                                           const std::vector<float>& zeros) {
+    const size_t h = p.height();
+    std::vector<const float*> rows(h + 2 * ry);
+    for (size_t k = 0; k < rows.size(); k++) {
+        const bool inside = k >= ry && k - ry < h;
+        if (inside) {
+            rows[k] = p.row(k - ry);
+        } else if (border == convolution::border_mode::zero) {
+            rows[k] = zeros.data();
+        } else {
+            rows[k] = p.row(k < ry ? 0 : h - 1);
+        }
+    }
+    return rows;
+}
+
+template <typename U> void store(const float* acc, size_t w, U* out) {
+    for (size_t x = 0; x < w; x++) {
+        out[x] = _image_buffer_utils::saturate<U>(acc[x]);
+    }
+}
+
+template <typename T, typename U> void same_shape(image_view<T> src, image_view<U> dst) {
+    if (src.height() != dst.height() || src.width() != dst.width()) {
+        throw std::invalid_argument("convolution: the images must have the same shape");
+    }
+}
+} // namespace _convolution_utils
+
+namespace convolution {
+/**
+ * @brief separable function
+ * Checks whether kernel is the outer product of a column and a row, in which case it splits
+ * it into those two 1D kernels.
+ * @param kernel the 2D kernel
+ * @param col set to the column kernel if kernel is separable
+ * @param row set to the row kernel if kernel is separable
+ * @return true if every tap is within 1e-6 of the largest tap of col[i] * row[j]
+ */
+inline bool separable(const Matrix<float>& kernel, std::vector<float>& col,
+                      std::vector<float>& row) {
+    const size_t kh = kernel.rows(), kw = kernel.cols();
+    size_t pi = 0, pj = 0;
+    for (size_t i = 0; i < kh; i++) {
+        for (size_t j = 0; j < kw; j++) {
+            if (std::abs(kernel(i, j)) > std::abs(kernel(pi, pj))) {
+                pi = i;
+                pj = j;
+            }
+        }
+    }
+    const float top = kh && kw ? kernel(pi, pj) : 0.0f;
+    if (top == 0) {
+        return false;
+    }
+    // the rank one kernel through the largest tap: its column, and its row over the tap
+    std::vector<float> c(kh), r(kw);
+    for (size_t i = 0; i < kh; i++) {
+        c[i] = kernel(i, pj);
+    }
+    for (size_t j = 0; j < kw; j++) {
+        r[j] = kernel(pi, j) / top;
+    }
+    for (size_t i = 0; i < kh; i++) {
+        for (size_t j = 0; j < kw; j++) {
+            if (std::abs(kernel(i, j) - c[i] * r[j]) > 1e-6f * std::abs(top)) {
+                return false;
+            }
+        }
+    }
+    col = std::move(c);
+    row = std::move(r);
+    return true;
+}
+
+/**
+ * @brief sep_filter2d function
+ * dst(y, x) = the sum of col[i] * row[j] * src(y + i - ry, x + j - rx), ry and rx the half
+ * sizes of the kernels, as a horizontal then a vertical 1D pass: O(kh + kw) instead of
+ * O(kh kw) per pixel. The source is first copied to float rows padded with the border, so
+ * neither pass checks bounds, and both run across the rows in SIMD registers(AVX2 or NEON)
+ * on ranges of rows on several threads. src and dst may be the same pixels.
+ * @param src the image to filter, of any pixel type
+ * @param dst set to the filtered image, saturated to its pixel type and rounded for
+ * integer pixels, of the shape of src
+ * @param col the vertical kernel, of odd size
+ * @param row the horizontal kernel, of odd size
+ * @param border the pixels read outside of the image. Default = zero
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if a kernel is empty or of even size, or the images have
+ * different shapes.
+ */
+template <typename T, typename U>
+void sep_filter2d(image_view<T> src, image_view<U> dst, std::span<const float> col,
+                  std::span<const float> row, border_mode border = border_mode::zero,
+                  size_t threads = 1) {
+    using namespace _convolution_utils;
+    static_assert(!std::is_const_v<U>, "sep_filter2d: dst must be writable");
+    same_shape(src, dst);
+    if (col.size() % 2 == 0 || row.size() % 2 == 0) {
+        throw std::invalid_argument("sep_filter2d: the kernels must have an odd size");
+    }
+    const size_t h = src.height(), w = src.width();
+    if (h == 0 || w == 0) {
+        return;
+    }
+    const size_t ry = col.size() / 2, rx = row.size() / 2;
+    image_view<const std::remove_const_t<T>> in = src;
+    image_buffer<float> p = pad(in, rx, border, threads);
+    image_buffer<float> horizontal(h, w);
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t y = lo; y < hi; y++) {
+            const float* r = p.row(y);
+            correlate(&r, 1, row.data(), row.size(), w, horizontal.row(y));
+        }
+    });
+    std::vector<float> zeros(w, 0.0f);
+    std::vector<const float*> rows = row_table(horizontal, ry, border, zeros);
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        std::vector<float> acc(w);
+        for (size_t y = lo; y < hi; y++) {
+            correlate(rows.data() + y, col.size(), col.data(), 1, w, acc.data());
+            store(acc.data(), w, dst.row(y));
+        }
+    });
+}
+
+/**
+ * @brief filter2d function
+ * dst(y, x) = the sum of kernel(i, j) * src(y + i - ry, x + j - rx) over the kh x kw taps,
+ * ry and rx the half sizes of the kernel, a correlation as Image::apply_filter2d. A
+ * separable kernel(see separable) runs as two 1D passes(see sep_filter2d), any other one in
+ * one pass over float rows padded with the border, so no tap checks bounds, every output
+ * register summing its kh x kw taps across the rows in SIMD registers.
+ * @param src the image to filter, of any pixel type
+ * @param dst set to the filtered image, saturated to its pixel type and rounded for
+ * integer pixels, of the shape of src. src and dst may be the same pixels.
+ * @param kernel the kh x kw taps, both of odd size
+ * @param border the pixels read outside of the image. Default = zero
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the kernel is empty or has a side of even size, or the
+ * images have different shapes.
+ */
+template <typename T, typename U>
+void filter2d(image_view<T> src, image_view<U> dst, const Matrix<float>& kernel,
+              border_mode border = border_mode::zero, size_t threads = 1) {
+    using namespace _convolution_utils;
+    static_assert(!std::is_const_v<U>, "filter2d: dst must be writable");
+    same_shape(src, dst);
+    const size_t kh = kernel.rows(), kw = kernel.cols();
+    if (kh % 2 == 0 || kw % 2 == 0) {
+        throw std::invalid_argument("filter2d: the kernel must have sides of odd size");
+    }
+    std::vector<float> col, row;
+    if (kh * kw > 1 && separable(kernel, col, row)) {
+        sep_filter2d(src, dst, std::span<const float>(col), std::span<const float>(row),
+                     border, threads);
+        return;
+    }
+    const size_t h = src.height(), w = src.width();
+    if (h == 0 || w == 0) {
+        return;
+    }
+    image_view<const std::remove_const_t<T>> in = src;
+    image_buffer<float> p = pad(in, kw / 2, border, threads);
+    std::vector<float> zeros(p.width(), 0.0f);
+    std::vector<const float*> rows = row_table(p, kh / 2, border, zeros);
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        std::vector<float> acc(w);
+        for (size_t y = lo; y < hi; y++) {
+            correlate(rows.data() + y, kh, kernel.data(), kw, w, acc.data());
+            store(acc.data(), w, dst.row(y));
+        }
+    });
+}
+
+/**
+ * @brief filter2d function over image buffers, see filter2d
+ */
+template <typename T, typename U>
+void filter2d(const image_buffer<T>& src, image_buffer<U>& dst, const Matrix<float>& kernel,
+              border_mode border = border_mode::zero, size_t threads = 1) {
+    filter2d(src.view(), dst.view(), kernel, border, threads);
+}
+
+/**
+ * @brief gaussian_kernel function
+ * @param sigma the standard deviation, in pixels
+ * @param radius the half size of the kernel, 0 for the smallest radius of at least 3 sigma
+ * @return std::vector<float>: the 2 radius + 1 taps of exp(-i^2 / (2 sigma^2)), normalized
+ * to a sum of 1. Throws std::invalid_argument unless sigma > 0.
+ */
+inline std::vector<float> gaussian_kernel(double sigma, size_t radius = 0) {
+    if (!(sigma > 0)) {
+        throw std::invalid_argument("gaussian_kernel: sigma must be positive");
+    }
+    if (radius == 0) {
+        radius = std::max<size_t>(1, size_t(std::ceil(3 * sigma)));
+    }
+    std::vector<float> taps(2 * radius + 1);
+    double sum = 0;
+    for (size_t i = 0; i < taps.size(); i++) {
+        const double d = double(i) - double(radius);
+        sum += taps[i] = float(std::exp(-d * d / (2 * sigma * sigma)));
+    }
+    for (float& t : taps) {
+        t = float(t / sum);
+    }
+    return taps;
+}
+} // namespace convolution
+
+#endif
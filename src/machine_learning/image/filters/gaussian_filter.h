@@ -1,8 +1,11 @@
 #ifndef GAUSSIAN_FILTER_H
 #define GAUSSIAN_FILTER_H
 
+#include "convolution.h"
+
 #ifdef __cplusplus
 #include <iostream>
+#include <span>
 #include "../image.h"
 #endif
 
@@ -20,11 +23,29 @@ namespace gaussian_filter {
  */
 inline std::vector<std::vector<int32_t>>
 apply_gaussian_filter(const std::vector<std::vector<int32_t>>& image) {
-    Image img(image);
-    std::vector<std::vector<float>> kernel = {{1.0 / 16, 2.0 / 16, 1.0 / 16},
-                                              {2.0 / 16, 4.0 / 16, 2.0 / 16},
-                                              {1.0 / 16, 2.0 / 16, 1.0 / 16}};
-    return img.apply_filter2d(kernel).get_2d_array();
+    image_buffer<int32_t> img{Image(image)};
+    const std::vector<float> taps = {1.0 / 4, 2.0 / 4, 1.0 / 4};
+    convolution::sep_filter2d(img.view(), img.view(), std::span<const float>(taps),
+                              std::span<const float>(taps));
+    return img.to_image().get_2d_array();
+}
+
+/**
+ * @brief gaussian_blur function: blurs src with a gaussian of standard deviation sigma, as
+ * two 1D passes of 2 ceil(3 sigma) + 1 taps(see convolution::sep_filter2d)
+ * @param src the image to blur
+ * @param dst set to the blurred image, of the shape of src. It may be src.
+ * @param sigma the standard deviation, in pixels
+ * @param border the pixels read outside of the image. Default = replicate
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T, typename U>
+void gaussian_blur(image_view<T> src, image_view<U> dst, double sigma,
+                   convolution::border_mode border = convolution::border_mode::replicate,
+                   size_t threads = 1) {
+    const std::vector<float> taps = convolution::gaussian_kernel(sigma);
+    convolution::sep_filter2d(src, dst, std::span<const float>(taps),
+                              std::span<const float>(taps), border, threads);
 }
 } // namespace gaussian_filter
 
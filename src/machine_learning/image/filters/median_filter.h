@@ -1,13 +1,322 @@
 #ifndef MEDIAN_FILTER_H
 #define MEDIAN_FILTER_H
 
+#include "../../../helpers/parallel.h"
+#include "../image_buffer.h"
+
 #ifdef __cplusplus
 #include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #include "../image.h"
 #endif
 
+namespace _median_filter_utils {
+/**
+ * @brief the two level histogram of the pixels of T: value v counts in the fine bin v and
+ * the coarse bin v >> shift, 16 x 16 bins for 8 bit pixels and 256 x 256 for 16 bit ones
+ */
+template <typename T> struct bins {
+    static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>,
+                  "median filters take 8 or 16 bit pixels");
+    static constexpr size_t shift = 4 * sizeof(T);
+    static constexpr size_t fine = size_t(1) << shift;
+    static constexpr size_t coarse = fine;
+    static constexpr size_t total = coarse * fine;
+};
+
+/**
+ * @brief the largest radius for which huang_median beats constant_time_median: the 16 x 16
+ * bins of 8 bit pixels leave little to the O(1) filter at any radius, while the 256 coarse
+ * bins of 16 bit pixels cost it more than Huang's O(radius) updates of small windows
+ */
+template <typename T> inline constexpr size_t huang_radius = sizeof(T) == 1 ? 0 : 48;
+
+inline size_t clamp(long i, size_t n) {
+    return i < 0 ? 0 : size_t(i) >= n ? n - 1 : size_t(i);
+}
+
+/**
+ * @brief the bin of bins[0, n) holding the value of the given rank, n a multiple of 16,
+ * rank set to the rank within that bin. AVX2 finds it 16 bins at a time from their prefix
+ * sums, without a branch per bin.
+ */
+template <typename K> inline size_t rank_bin(const K* bins, size_t n, size_t& rank) {
+    size_t b = 0;
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<K, uint16_t>) {
+        // the counts stay below 32768, so signed compares hold
+        const __m256i target = _mm256_set1_epi16(int16_t(rank));
+        const __m256i last = _mm256_set1_epi16(0x0f0e);
+        size_t before = 0;
+        for (; b < n; b += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bins + b));
+            v = _mm256_add_epi16(v, _mm256_slli_si256(v, 2));
+            v = _mm256_add_epi16(v, _mm256_slli_si256(v, 4));
+            v = _mm256_add_epi16(v, _mm256_slli_si256(v, 8));
+            // the sum of the low lane carried into the high one, and the bins before b
+            const __m256i low = _mm256_shuffle_epi8(v, last);
+            v = _mm256_add_epi16(v, _mm256_permute2x128_si256(low, low, 0x08));
+            v = _mm256_add_epi16(v, _mm256_set1_epi16(int16_t(before)));
+            const unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_cmpgt_epi16(v, target)));
+            if (mask) {
+                alignas(32) uint16_t prefix[16];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(prefix), v);
+                const size_t i = size_t(std::countr_zero(mask)) / 2;
+                rank -= i ? prefix[i - 1] : before;
+                return b + i;
+            }
+            before = size_t(uint16_t(_mm256_extract_epi16(v, 15)));
+        }
+    }
+#endif
+    for (b = 0; b + 1 < n && rank >= bins[b]; b++) {
+        rank -= bins[b];
+    }
+    return b;
+}
+
+/**
+ * @brief to[0, n) += from[0, n) and -=, n a multiple of 16
+ */
+template <typename K, typename C> inline void add(K* to, const C* from, size_t n) {
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<K, C>) {
+        for (size_t i = 0; i < n; i += 16) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(to + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i), _mm256_add_epi16(a, b));
+        }
+        return;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    if constexpr (std::is_same_v<K, C>) {
+        for (size_t i = 0; i < n; i += 8) {
+            vst1q_u16(to + i, vaddq_u16(vld1q_u16(to + i), vld1q_u16(from + i)));
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        to[i] = K(to[i] + from[i]);
+    }
+}
+
+template <typename K, typename C> inline void sub(K* to, const C* from, size_t n) {
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<K, C>) {
+        for (size_t i = 0; i < n; i += 16) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(to + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i), _mm256_sub_epi16(a, b));
+        }
+        return;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    if constexpr (std::is_same_v<K, C>) {
+        for (size_t i = 0; i < n; i += 8) {
+            vst1q_u16(to + i, vsubq_u16(vld1q_u16(to + i), vld1q_u16(from + i)));
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        to[i] = K(to[i] - from[i]);
+    }
+}
+
+/**
+ * @brief checks the shapes and the radius, and returns the pixels to read: src, or a copy of
+ * it if it shares memory with dst
+ */
+template <typename T>
+image_view<const T> source(image_view<const T> src, image_view<T> dst, size_t radius,
+                           image_buffer<T>& copy, const char* who) {
+    if (src.height() != dst.height() || src.width() != dst.width()) {
+        throw std::invalid_argument(std::string(who) + ": the images must have the same shape");
+    }
+    if (radius >= 32767) {
+        throw std::invalid_argument(std::string(who) + ": the radius must be below 32767");
+    }
+    if (src.height() == 0 || src.width() == 0) {
+        return src;
+    }
+    const T* s0 = src.data();
+    const T* s1 = src.row(src.height() - 1) + src.width();
+    const T* d0 = dst.data();
+    const T* d1 = dst.row(dst.height() - 1) + dst.width();
+    if (std::less<>()(s0, d1) && std::less<>()(d0, s1)) {
+        copy = image_buffer<T>(src);
+        return copy.view();
+    }
+    return src;
+}
+
+/**
+ * @brief huang_median on the rows [lo, hi), with window counts of type K
+ */
+template <typename T, typename K>
+void huang(image_view<const T> src, image_view<T> dst, size_t radius, size_t lo, size_t hi) {
+    using B = bins<T>;
+    const size_t h = src.height(), w = src.width(), k = 2 * radius + 1;
+    const long r = long(radius);
+    std::vector<K> coarse(B::coarse), fine(B::total);
+    std::vector<const T*> rows(k);
+    for (size_t y = lo; y < hi; y++) {
+        std::fill(coarse.begin(), coarse.end(), 0);
+        std::fill(fine.begin(), fine.end(), 0);
+        for (size_t i = 0; i < k; i++) {
+            rows[i] = src.row(clamp(long(y) + long(i) - r, h));
+            for (long j = -r; j <= r; j++) {
+                const T v = rows[i][clamp(j, w)];
+                coarse[v >> B::shift]++;
+                fine[v]++;
+            }
+        }
+        // the median m, below the count of the window under it, moved by whole coarse bins
+        // when it can
+        size_t m = 0, below = 0;
+        const size_t rank = k * k / 2;
+        T* out = dst.row(y);
+        for (size_t x = 0; x < w; x++) {
+            const size_t gone = clamp(long(x) - r - 1, w), next = clamp(long(x) + r, w);
+            if (x > 0 && gone != next) {
+                for (size_t i = 0; i < k; i++) {
+                    const T a = rows[i][gone], b = rows[i][next];
+                    coarse[a >> B::shift]--;
+                    fine[a]--;
+                    coarse[b >> B::shift]++;
+                    fine[b]++;
+                    below = below - (a < m) + (b < m);
+                }
+            }
+            while (below > rank) {
+                if (m % B::fine == 0 && below - coarse[m / B::fine - 1] > rank) {
+                    below -= coarse[m / B::fine - 1];
+                    m -= B::fine;
+                } else {
+                    below -= fine[--m];
+                }
+            }
+            while (below + fine[m] <= rank) {
+                if (m % B::fine == 0 && below + coarse[m / B::fine] <= rank) {
+                    below += coarse[m / B::fine];
+                    m += B::fine;
+                } else {
+                    below += fine[m++];
+                }
+            }
+            out[x] = T(m);
+        }
+    }
+}
+
+/**
+ * @brief constant_time_median on the rows [lo, hi), with window counts of type K
+ */
+template <typename T, typename K>
+void ctmf(image_view<const T> src, image_view<T> dst, size_t radius, size_t lo, size_t hi) {
+    using B = bins<T>;
+    const size_t h = src.height(), w = src.width(), k = 2 * radius + 1;
+    const long r = long(radius);
+    // about 512 KB of column histograms per strip
+    const size_t strip = std::max(k, (size_t(1) << 19) / (B::total * sizeof(uint16_t)));
+    std::vector<K> coarse(B::coarse), fine(B::total);
+    std::vector<long> updated(B::coarse);
+    std::vector<uint16_t> col_coarse, col_fine;
+    std::vector<size_t> held;
+    for (size_t x0 = 0; x0 < w; x0 += strip) {
+        const size_t x1 = std::min(w, x0 + strip);
+        const size_t c0 = x0 > radius ? x0 - radius - 1 : 0, c1 = std::min(w, x1 + radius);
+        col_coarse.assign((c1 - c0) * B::coarse, 0);
+        col_fine.assign((c1 - c0) * B::total, 0);
+        auto move = [&](size_t y, uint16_t by) {
+            const T* p = src.row(y);
+            for (size_t j = c0; j < c1; j++) {
+                col_coarse[(j - c0) * B::coarse + (p[j] >> B::shift)] += by;
+                col_fine[(j - c0) * B::total + p[j]] += by;
+            }
+        };
+        for (long i = -r; i <= r; i++) {
+            move(clamp(long(lo) + i, h), 1);
+        }
+        // the column held for every column x0 - r - 1 to x1 + r - 1 of the windows
+        held.resize(x1 - x0 + k);
+        for (size_t i = 0; i < held.size(); i++) {
+            held[i] = clamp(long(x0 + i) - r - 1, w) - c0;
+        }
+        const size_t* at = held.data() + r + 1 - long(x0);
+        auto col_c = [&](long j) { return col_coarse.data() + at[j] * B::coarse; };
+        auto col_f = [&](long j, size_t c) {
+            return col_fine.data() + at[j] * B::total + (c << B::shift);
+        };
+        for (size_t y = lo; y < hi; y++) {
+            const size_t gone = clamp(long(y) - r - 1, h), next = clamp(long(y) + r, h);
+            if (y > lo && gone != next) {
+                move(gone, uint16_t(-1));
+                move(next, 1);
+            }
+            // the window left of x0, the first step moving it onto x0
+            std::fill(coarse.begin(), coarse.end(), 0);
+            for (long j = -r - 1; j < r; j++) {
+                add(coarse.data(), col_c(long(x0) + j), B::coarse);
+            }
+            // no fine bin is up to date yet
+            std::fill(updated.begin(), updated.end(), std::numeric_limits<long>::min() / 2);
+            T* out = dst.row(y);
+            for (long x = long(x0); x < long(x1); x++) {
+                sub(coarse.data(), col_c(x - r - 1), B::coarse);
+                add(coarse.data(), col_c(x + r), B::coarse);
+                size_t rank = k * k / 2;
+                const size_t c = rank_bin(coarse.data(), B::coarse, rank);
+                K* f = fine.data() + (c << B::shift);
+                // the fine bins of c catch up with x, or start over if that is cheaper
+                if (x - updated[c] > r) {
+                    std::fill(f, f + B::fine, 0);
+                    for (long j = -r; j <= r; j++) {
+                        add(f, col_f(x + j, c), B::fine);
+                    }
+                } else {
+                    for (long j = updated[c] + 1; j <= x; j++) {
+                        sub(f, col_f(j - r - 1, c), B::fine);
+                        add(f, col_f(j + r, c), B::fine);
+                    }
+                }
+                updated[c] = x;
+                out[x] = T((c << B::shift) + rank_bin(f, B::fine, rank));
+            }
+        }
+    }
+}
+
+/**
+ * @brief runs huang or ctmf on bands of rows, with the smallest window counts that hold
+ * (2 radius + 1)^2 pixels
+ */
+template <typename T>
+void run(image_view<const T> src, image_view<T> dst, size_t radius, size_t threads,
+         bool constant_time, const char* who) {
+    image_buffer<T> copy;
+    src = source(src, dst, radius, copy, who);
+    const bool small = (2 * radius + 1) * (2 * radius + 1) < 32768;
+    PARALLEL::parallel_for(0, src.height(), threads, [&](size_t lo, size_t hi, size_t) {
+        if (constant_time) {
+            small ? ctmf<T, uint16_t>(src, dst, radius, lo, hi)
+                  : ctmf<T, uint32_t>(src, dst, radius, lo, hi);
+        } else {
+            small ? huang<T, uint16_t>(src, dst, radius, lo, hi)
+                  : huang<T, uint32_t>(src, dst, radius, lo, hi);
+        }
+    });
+}
+} // namespace _median_filter_utils
+
 /**
  * @brief median_filter namespace
  */
@@ -76,6 +385,63 @@ apply_median_filter(const std::vector<std::vector<int32_t>>& image) {
     }
     return resulted_img.get_2d_array();
 }
+
+/**
+ * @brief huang_median function: the median of the (2 radius + 1)^2 pixels around every pixel,
+ * borders replicated, by Huang's sliding histogram: every step along a row removes the
+ * column that leaves the window from a two level histogram and adds the one that enters it,
+ * O(radius) per pixel. Bands of rows run on several threads.
+ * @param src the image to filter
+ * @param dst set to the filtered image, of the shape of src. It may be src.
+ * @param radius the half size of the window
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the images have different shapes or radius >= 32767.
+ */
+template <typename T>
+void huang_median(std::type_identity_t<image_view<const T>> src, image_view<T> dst,
+                  size_t radius, size_t threads = 1) {
+    _median_filter_utils::run(src, dst, radius, threads, false, "huang_median");
+}
+
+/**
+ * @brief constant_time_median function: the median of the (2 radius + 1)^2 pixels around
+ * every pixel, borders replicated, by the O(1) filter of Perreault and Hebert. Every column
+ * keeps a histogram of its 2 radius + 1 pixels, moved down a row with one removal and one
+ * addition, and the window histogram moves right by adding and removing whole column
+ * histograms. The two levels of bins keep that cheap: the coarse bins always move, the fine
+ * bins of a coarse bin only catch up when the median falls in it, so the cost per pixel does
+ * not grow with the radius. Strips of columns keep the column histograms in cache, and bands
+ * of rows run on several threads.
+ * @param src the image to filter
+ * @param dst set to the filtered image, of the shape of src. It may be src.
+ * @param radius the half size of the window
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the images have different shapes or radius >= 32767.
+ */
+template <typename T>
+void constant_time_median(std::type_identity_t<image_view<const T>> src, image_view<T> dst,
+                          size_t radius, size_t threads = 1) {
+    _median_filter_utils::run(src, dst, radius, threads, true, "constant_time_median");
+}
+
+/**
+ * @brief median_blur function: the median of the (2 radius + 1)^2 pixels around every pixel,
+ * borders replicated, by whichever of huang_median and constant_time_median is faster for
+ * the pixel type and the radius
+ * @param src the image to filter
+ * @param dst set to the filtered image, of the shape of src. It may be src.
+ * @param radius the half size of the window
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T>
+void median_blur(std::type_identity_t<image_view<const T>> src, image_view<T> dst,
+                 size_t radius, size_t threads = 1) {
+    if (radius <= _median_filter_utils::huang_radius<T>) {
+        huang_median<T>(src, dst, radius, threads);
+    } else {
+        constant_time_median<T>(src, dst, radius, threads);
+    }
+}
 } // namespace median_filter
 
 #endif
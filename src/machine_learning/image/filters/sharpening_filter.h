@@ -1,6 +1,8 @@
 #ifndef SHARPENING_FILTER_H
 #define SHARPENING_FILTER_H
 
+#include "convolution.h"
+
 #ifdef __cplusplus
 #include <iostream>
 #include <vector>
@@ -11,6 +13,22 @@
  * @brief sharpening_filter namespace
  */
 namespace sharpening_filter {
+/**
+ * @brief sharpen function: applies a 3x3 laplacian filter to src(see convolution::filter2d)
+ * @param src the image to sharpen
+ * @param dst set to the sharpened image, of the shape of src. It may be src.
+ * @param border the pixels read outside of the image. Default = zero
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T, typename U>
+void sharpen(image_view<T> src, image_view<U> dst,
+             convolution::border_mode border = convolution::border_mode::zero,
+             size_t threads = 1) {
+    const Matrix<float> kernel(
+        std::vector<std::vector<float>>{{0, -1, 0}, {-1, 5, -1}, {0, -1, 0}});
+    convolution::filter2d(src, dst, kernel, border, threads);
+}
+
 /**
  * @brief apply_sharpening_filter function: applies a 3x3 laplacian filter to
  * image img
@@ -20,9 +38,9 @@ namespace sharpening_filter {
  */
 inline std::vector<std::vector<int32_t>>
 apply_sharpening_filter(const std::vector<std::vector<int32_t>>& image) {
-    Image img(image);
-    std::vector<std::vector<int32_t>> kernel = {{0, -1, 0}, {-1, 5, -1}, {0, -1, 0}};
-    return img.apply_filter2d(kernel).get_2d_array();
+    image_buffer<int32_t> img{Image(image)};
+    sharpen(img.view(), img.view());
+    return img.to_image().get_2d_array();
 }
 } // namespace sharpening_filter
 
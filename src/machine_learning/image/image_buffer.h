@@ -0,0 +1,440 @@
+#ifndef IMAGE_BUFFER_H
+#define IMAGE_BUFFER_H
+
+#include "../../linalg/mat_expr.h"
+#include "image.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace _image_buffer_utils {
+/**
+ * @brief the distance between two rows, in pixels, that starts every row of a buffer on a
+ * heap_alignment boundary
+ */
+template <typename T> size_t padded_stride(size_t width) {
+    constexpr size_t per_line = _mat_utils::heap_alignment / sizeof(T);
+    return (width + per_line - 1) / per_line * per_line;
+}
+
+// the type an operation on two pixels is computed in before it is saturated
+template <typename T>
+using wide_t = std::conditional_t<std::is_floating_point_v<T>, T,
+                                  std::conditional_t<(sizeof(T) < 4), int32_t, int64_t>>;
+
+/**
+ * @brief v clamped to the range of T and rounded to the nearest for an integer T
+ */
+template <typename T, typename V> T saturate(V v) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return T(v);
+    } else {
+        constexpr V lo = V(std::numeric_limits<T>::lowest()), hi = V(std::numeric_limits<T>::max());
+        v = v < lo ? lo : (v > hi ? hi : v);
+        if constexpr (std::is_floating_point_v<V>) {
+            return T(v + (v < 0 ? V(-0.5) : V(0.5)));
+        } else {
+            return T(v);
+        }
+    }
+}
+
+enum class op { add, sub, mul };
+
+template <typename T, op O> T apply(T a, T b) {
+    using W = wide_t<T>;
+    if constexpr (O == op::add) {
+        return saturate<T>(W(a) + W(b));
+    } else if constexpr (O == op::sub) {
+        return saturate<T>(W(a) - W(b));
+    } else {
+        return saturate<T>(W(a) * W(b));
+    }
+}
+
+/**
+ * @brief a[x] = a[x] O b[x] for the n pixels of a row
+ */
+template <typename T, op O> void apply_row_scalar(T* a, const T* b, size_t n) {
+    for (size_t x = 0; x < n; x++) {
+        a[x] = apply<T, O>(a[x], b[x]);
+    }
+}
+
+// the additions and subtractions of 8 and 16 bit pixels saturate in one instruction
+template <typename T, op O>
+constexpr bool saturating_simd =
+    (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>) && O != op::mul;
+
+#if defined(ALGOPLUS_X86_DISPATCH)
+/**
+ * @brief apply_row_scalar 32 or 16 pixels at a time with the saturating AVX2 instructions
+ */
+template <typename T, op O>
+ALGOPLUS_TARGET("avx2") void apply_row_avx2(T* a, const T* b, size_t n) {
+    size_t x = 0;
+    for (; x + 32 / sizeof(T) <= n; x += 32 / sizeof(T)) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + x));
+        __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x));
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            p = O == op::add ? _mm256_adds_epu8(p, q) : _mm256_subs_epu8(p, q);
+        } else {
+            p = O == op::add ? _mm256_adds_epu16(p, q) : _mm256_subs_epu16(p, q);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + x), p);
+    }
+    for (; x < n; x++) {
+        a[x] = apply<T, O>(a[x], b[x]);
+    }
+}
+#endif
+
+/**
+ * @brief a[x] = a[x] O b[x] for the n pixels of a row, with the AVX2 kernel when the cpu has
+ * it and the operation saturates in one instruction
+ */
+template <typename T, op O> void apply_row(T* a, const T* b, size_t n) {
+    if constexpr (saturating_simd<T, O>) {
+        static const SIMD::kernels<void(T*, const T*, size_t)> k{
+            .scalar = &apply_row_scalar<T, O>,
+#if defined(ALGOPLUS_X86_DISPATCH)
+            .avx2 = &apply_row_avx2<T, O>,
+#endif
+        };
+        k.get()(a, b, n);
+    } else {
+        apply_row_scalar<T, O>(a, b, n);
+    }
+}
+} // namespace _image_buffer_utils
+
+/**
+ * @brief image view class
+ * Non owning height x width view of pixels stored row after row, stride pixels apart, e.g.
+ * an image_buffer or a region of interest of one. It does not copy anything and stays valid
+ * as long as the pixels it looks at. A view of non const pixels changes them in place.
+ * @tparam T the type of the pixels, const T for a read only view
+ */
+template <typename T> class image_view {
+  public:
+    using value_type = std::remove_cv_t<T>;
+
+    image_view() = default;
+
+    /**
+     * @brief Construct a new image view object
+     * @param data the first pixel of the first row
+     * @param height the number of rows
+     * @param width the number of pixels of a row
+     * @param stride the distance between two rows, in pixels, at least width
+     */
+    image_view(T* data, size_t height, size_t width, size_t stride)
+        : _data(data), _height(height), _width(width), _stride(stride) {
+        assert(stride >= width);
+    }
+
+    /**
+     * @brief a read only view from a view
+     */
+    template <typename U>
+        requires(std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+    image_view(const image_view<U>& v)
+        : image_view(v.data(), v.height(), v.width(), v.stride()) {}
+
+    size_t height() const { return _height; }
+    size_t width() const { return _width; }
+    size_t stride() const { return _stride; }
+    T* data() const { return _data; }
+
+    /**
+     * @brief row function
+     * @return T*: the first pixel of the row y
+     */
+    T* row(size_t y) const { return _data + y * _stride; }
+
+    /**
+     * @brief operator (y, x) for image_view class
+     * @return T&: the pixel x of the row y
+     */
+    T& operator()(size_t y, size_t x) const { return _data[y * _stride + x]; }
+
+    /**
+     * @brief roi function
+     * @param y the first row of the region
+     * @param x the first column of the region
+     * @param height the number of rows of the region
+     * @param width the number of columns of the region
+     * @return image_view: the region, over the same pixels. Throws std::invalid_argument if
+     * the region is out of the view.
+     */
+    image_view roi(size_t y, size_t x, size_t height, size_t width) const {
+        if (y > _height || height > _height - y || x > _width || width > _width - x) {
+            throw std::invalid_argument("image_view: the region is out of the image");
+        }
+        return image_view(row(y) + x, height, width, _stride);
+    }
+
+    /**
+     * @brief fill function
+     * @param value the value every pixel is set to
+     */
+    void fill(value_type value) const {
+        for (size_t y = 0; y < _height; y++) {
+            std::fill(row(y), row(y) + _width, value);
+        }
+    }
+
+    /**
+     * @brief copy_to function
+     * @param dst the pixels to overwrite, of the shape of the view. Throws
+     * std::invalid_argument otherwise.
+     */
+    void copy_to(image_view<value_type> dst) const {
+        same_shape(dst);
+        for (size_t y = 0; y < _height; y++) {
+            std::copy(row(y), row(y) + _width, dst.row(y));
+        }
+    }
+
+    /**
+     * @brief add function
+     * adds the pixels of other to the pixels of the view in place, saturated to the range of
+     * T for integer pixels
+     * @param other the pixels to add, of the shape of the view. Throws
+     * std::invalid_argument otherwise.
+     */
+    void add(image_view<const value_type> other) const {
+        apply<_image_buffer_utils::op::add>(other);
+    }
+
+    /**
+     * @brief sub function
+     * subtracts the pixels of other from the pixels of the view in place, saturated
+     */
+    void sub(image_view<const value_type> other) const {
+        apply<_image_buffer_utils::op::sub>(other);
+    }
+
+    /**
+     * @brief mul function
+     * multiplies the pixels of the view by the pixels of other in place, saturated
+     */
+    void mul(image_view<const value_type> other) const {
+        apply<_image_buffer_utils::op::mul>(other);
+    }
+
+    /**
+     * @brief scale function
+     * p = p * factor + offset for every pixel p in place, computed in double then saturated
+     * and rounded for integer pixels
+     */
+    void scale(double factor, double offset = 0) const {
+        for (size_t y = 0; y < _height; y++) {
+            T* p = row(y);
+            for (size_t x = 0; x < _width; x++) {
+                p[x] = _image_buffer_utils::saturate<value_type>(double(p[x]) * factor + offset);
+            }
+        }
+    }
+
+    /**
+     * @brief operator == for image_view class, the pixels are compared, not the strides
+     */
+    template <typename U> bool operator==(const image_view<U>& v) const {
+        if (_height != v.height() || _width != v.width()) {
+            return false;
+        }
+        for (size_t y = 0; y < _height; y++) {
+            if (!std::equal(row(y), row(y) + _width, v.row(y))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    T* _data{nullptr};
+    size_t _height{0};
+    size_t _width{0};
+    size_t _stride{0};
+
+    template <typename U> void same_shape(const image_view<U>& v) const {
+        if (v.height() != _height || v.width() != _width) {
+            throw std::invalid_argument("image_view: the images must have the same shape");
+        }
+    }
+
+    template <_image_buffer_utils::op O> void apply(image_view<const value_type> other) const {
+        static_assert(!std::is_const_v<T>, "image_view: a read only view can't be changed");
+        same_shape(other);
+        for (size_t y = 0; y < _height; y++) {
+            _image_buffer_utils::apply_row<value_type, O>(row(y), other.row(y), _width);
+        }
+    }
+};
+
+/**
+ * @brief image buffer class
+ * Contiguous height x width image of T pixels, e.g. uint8_t, uint16_t or float, one
+ * allocation for the whole image. Every row starts on a 64 byte boundary, the rows being
+ * padded to a multiple of 64 bytes, so the row loops run on aligned vectors and a region of
+ * interest(see roi) is a view that copies nothing. The arithmetic is in place and
+ * saturates integer pixels instead of wrapping.
+ * @tparam T the type of the pixels
+ */
+template <typename T> class image_buffer {
+    static_assert(std::is_arithmetic_v<T> && (std::is_floating_point_v<T> || sizeof(T) <= 4),
+                  "image_buffer: the pixels must be floating point or integers up to 32 bits");
+
+  public:
+    image_buffer() = default;
+
+    /**
+     * @brief Construct a new image buffer object
+     * @param height the number of rows
+     * @param width the number of pixels of a row
+     * @param value the value of every pixel. Default = 0
+     */
+    image_buffer(size_t height, size_t width, T value = T())
+        : _height(height), _width(width),
+          _stride(_image_buffer_utils::padded_stride<T>(width)),
+          _pixels(height * _stride, T()) {
+        view().fill(value);
+    }
+
+    /**
+     * @brief Construct a new image buffer object with a copy of the pixels of a view
+     */
+    explicit image_buffer(image_view<const T> v) : image_buffer(v.height(), v.width()) {
+        v.copy_to(view());
+    }
+
+    /**
+     * @brief Construct a new image buffer object from an Image, every pixel saturated to
+     * the range of T
+     */
+    explicit image_buffer(const Image& img)
+        : image_buffer(size_t(img._height()), size_t(img._width())) {
+        for (size_t y = 0; y < _height; y++) {
+            for (size_t x = 0; x < _width; x++) {
+                (*this)(y, x) = _image_buffer_utils::saturate<T>(
+                    int64_t(img.get_point(int(y), int(x))));
+            }
+        }
+    }
+
+    size_t height() const { return _height; }
+    size_t width() const { return _width; }
+
+    /**
+     * @brief stride function
+     * @return size_t: the distance between two rows, in pixels
+     */
+    size_t stride() const { return _stride; }
+
+    /**
+     * @brief bytes function
+     * @return size_t: the memory of the pixels, the padding of the rows included
+     */
+    size_t bytes() const { return _pixels.size() * sizeof(T); }
+
+    T* data() { return _pixels.data(); }
+    const T* data() const { return _pixels.data(); }
+    T* row(size_t y) { return data() + y * _stride; }
+    const T* row(size_t y) const { return data() + y * _stride; }
+    T& operator()(size_t y, size_t x) { return _pixels[y * _stride + x]; }
+    const T& operator()(size_t y, size_t x) const { return _pixels[y * _stride + x]; }
+
+    /**
+     * @brief view function
+     * @return image_view: the whole image
+     */
+    image_view<T> view() { return image_view<T>(data(), _height, _width, _stride); }
+    image_view<const T> view() const {
+        return image_view<const T>(data(), _height, _width, _stride);
+    }
+    operator image_view<T>() { return view(); }
+    operator image_view<const T>() const { return view(); }
+
+    /**
+     * @brief roi function
+     * @return image_view: the region height x width from the pixel x of the row y, see
+     * image_view::roi
+     */
+    image_view<T> roi(size_t y, size_t x, size_t height, size_t width) {
+        return view().roi(y, x, height, width);
+    }
+    image_view<const T> roi(size_t y, size_t x, size_t height, size_t width) const {
+        return view().roi(y, x, height, width);
+    }
+
+    /**
+     * @brief add, sub, mul functions in place, see image_view
+     */
+    image_buffer& add(image_view<const T> other) {
+        view().add(other);
+        return *this;
+    }
+    image_buffer& sub(image_view<const T> other) {
+        view().sub(other);
+        return *this;
+    }
+    image_buffer& mul(image_view<const T> other) {
+        view().mul(other);
+        return *this;
+    }
+    image_buffer& scale(double factor, double offset = 0) {
+        view().scale(factor, offset);
+        return *this;
+    }
+
+    /**
+     * @brief convert function
+     * @return image_buffer<U>: the pixels as U, saturated to its range
+     */
+    template <typename U> image_buffer<U> convert() const {
+        image_buffer<U> out(_height, _width);
+        for (size_t y = 0; y < _height; y++) {
+            const T* p = row(y);
+            U* q = out.row(y);
+            for (size_t x = 0; x < _width; x++) {
+                q[x] = _image_buffer_utils::saturate<U>(std::conditional_t<
+                    std::is_floating_point_v<T> || std::is_floating_point_v<U>, double,
+                    int64_t>(p[x]));
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief to_image function
+     * @return Image: the pixels as an Image, rounded for floating point pixels
+     */
+    Image to_image() const {
+        Image img{int(_height), int(_width)};
+        for (size_t y = 0; y < _height; y++) {
+            for (size_t x = 0; x < _width; x++) {
+                img.set_point(int(y), int(x),
+                              _image_buffer_utils::saturate<int32_t>(double((*this)(y, x))));
+            }
+        }
+        return img;
+    }
+
+    bool operator==(const image_buffer& b) const { return view() == b.view(); }
+
+  private:
+    size_t _height{0};
+    size_t _width{0};
+    size_t _stride{0};
+    std::vector<T, _mat_utils::aligned_allocator<T>> _pixels;
+};
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef INTEGRAL_IMAGE_H
+#define INTEGRAL_IMAGE_H
+
+#include "../../helpers/parallel.h"
+#include "../../linalg/mat_expr.h"
+#include "image_buffer.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace _integral_image_utils {
+/**
+ * @brief the type of the sums of pixels of T: 64 bit integers of the signedness of T, or
+ * double for floating point pixels
+ */
+template <typename T>
+using sum_t = std::conditional_t<std::is_floating_point_v<T>, double,
+                                 std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+// the window [y - radius, y + radius] of a size image, clipped to it
+inline void window(size_t y, size_t radius, size_t size, size_t& lo, size_t& count) {
+    lo = y > radius ? y - radius : 0;
+    count = std::min(size, y + radius + 1) - lo;
+}
+
+// f(y, x, y0, x0, rows, cols) for every pixel of a h x w image and its clipped window
+template <typename F>
+void for_windows(size_t h, size_t w, size_t radius, size_t threads, F&& f) {
+    std::vector<size_t> x0(w), cols(w);
+    for (size_t x = 0; x < w; x++) {
+        window(x, radius, w, x0[x], cols[x]);
+    }
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t y = lo; y < hi; y++) {
+            size_t y0, rows;
+            window(y, radius, h, y0, rows);
+            for (size_t x = 0; x < w; x++) {
+                f(y, x, y0, x0[x], rows, cols[x]);
+            }
+        }
+    });
+}
+
+// the shape check of the integral filters
+template <typename T, typename U>
+void same_shape(const image_view<T>& a, const image_view<U>& b, const char* what) {
+    if (a.height() != b.height() || a.width() != b.width()) {
+        throw std::invalid_argument(std::string(what) + ": the images must have the same shape");
+    }
+}
+} // namespace _integral_image_utils
+
+/**
+ * @brief integral image class
+ * The summed-area table of an image: at(y, x) is the sum of the pixels [0, y) x [0, x), so
+ * the sum of any rectangle takes four lookups whatever its size. The table is built in one
+ * pass over the rows, each row a running sum along the pixels plus the row above it, added
+ * in a loop the compiler vectorizes. The squares of the pixels may be summed too, for the
+ * variance of rectangles.
+ * @tparam T the type of the pixels
+ */
+template <typename T> class integral_image {
+  public:
+    using sum_type = _integral_image_utils::sum_t<T>;
+
+    integral_image() = default;
+
+    /**
+     * @brief Construct a new integral image object
+     * @param img the image to sum
+     * @param squares whether to also sum the squares of the pixels, for square_sum and
+     * variance. Default = false
+     */
+    explicit integral_image(image_view<const T> img, bool squares = false)
+        : _height(img.height()), _width(img.width()), _stride(img.width() + 1),
+          _sums((_height + 1) * _stride, sum_type(0)) {
+        if (squares) {
+            _squares.assign(_sums.size(), sum_type(0));
+        }
+        for (size_t y = 0; y < _height; y++) {
+            _accumulate(img.row(y), y, _sums, [](sum_type v) { return v; });
+            if (squares) {
+                _accumulate(img.row(y), y, _squares, [](sum_type v) { return v * v; });
+            }
+        }
+    }
+
+    /**
+     * @brief Construct a new integral image object from an image buffer, see above
+     */
+    explicit integral_image(const image_buffer<T>& img, bool squares = false)
+        : integral_image(img.view(), squares) {}
+
+    size_t height() const { return _height; }
+    size_t width() const { return _width; }
+
+    /**
+     * @brief squares function
+     * @return true if the squares of the pixels are summed
+     */
+    bool squares() const { return !_squares.empty(); }
+
+    /**
+     * @brief at function
+     * @return sum_type: the sum of the pixels [0, y) x [0, x), for y <= height and x <= width
+     */
+    sum_type at(size_t y, size_t x) const {
+        assert(y <= _height && x <= _width);
+        return _sums[y * _stride + x];
+    }
+
+    /**
+     * @brief row function
+     * @return const sum_type*: the width + 1 sums at(y, 0) to at(y, width), for y <= height
+     */
+    const sum_type* row(size_t y) const {
+        assert(y <= _height);
+        return _sums.data() + y * _stride;
+    }
+
+    /**
+     * @brief sum function
+     * @param y the first row of the rectangle
+     * @param x the first column of the rectangle
+     * @param h the rows of the rectangle
+     * @param w the columns of the rectangle
+     * @return sum_type: the sum of the pixels [y, y + h) x [x, x + w), in O(1)
+     */
+    sum_type sum(size_t y, size_t x, size_t h, size_t w) const {
+        return _rect(_sums, y, x, h, w);
+    }
+
+    /**
+     * @brief square_sum function
+     * @return sum_type: the sum of the squares of the pixels [y, y + h) x [x, x + w). Throws
+     * std::logic_error if the squares are not summed.
+     */
+    sum_type square_sum(size_t y, size_t x, size_t h, size_t w) const {
+        if (_squares.empty()) {
+            throw std::logic_error("integral_image: the squares of the pixels are not summed");
+        }
+        return _rect(_squares, y, x, h, w);
+    }
+
+    /**
+     * @brief mean function
+     * @return double: the mean of the pixels [y, y + h) x [x, x + w), a rectangle that is not
+     * empty
+     */
+    double mean(size_t y, size_t x, size_t h, size_t w) const {
+        return double(sum(y, x, h, w)) / double(h * w);
+    }
+
+    /**
+     * @brief variance function
+     * @return double: the variance of the pixels [y, y + h) x [x, x + w), a rectangle that is
+     * not empty. Throws std::logic_error if the squares are not summed.
+     */
+    double variance(size_t y, size_t x, size_t h, size_t w) const {
+        const double n = double(h * w), m = double(sum(y, x, h, w)) / n;
+        return std::max(0.0, double(square_sum(y, x, h, w)) / n - m * m);
+    }
+
+  private:
+    size_t _height{0}, _width{0}, _stride{1};
+    std::vector<sum_type, _mat_utils::aligned_allocator<sum_type>> _sums, _squares;
+
+    // row y + 1 of table: the running sum of f(pixel) along row y, plus row y of table
+    template <typename F>
+    void _accumulate(const T* pixels,
+                     size_t y,
+                     std::vector<sum_type, _mat_utils::aligned_allocator<sum_type>>& table,
+                     F f) {
+        const sum_type* above = table.data() + y * _stride;
+        sum_type* cur = table.data() + (y + 1) * _stride;
+        sum_type run = 0;
+        for (size_t x = 0; x < _width; x++) {
+            run += f(sum_type(pixels[x]));
+            cur[x + 1] = run;
+        }
+        for (size_t x = 1; x <= _width; x++) {
+            cur[x] += above[x];
+        }
+    }
+
+    sum_type _rect(const std::vector<sum_type, _mat_utils::aligned_allocator<sum_type>>& table,
+                   size_t y, size_t x, size_t h, size_t w) const {
+        assert(y + h <= _height && x + w <= _width);
+        const sum_type* top = table.data() + y * _stride + x;
+        const sum_type* bottom = table.data() + (y + h) * _stride + x;
+        return bottom[w] - bottom[0] - top[w] + top[0];
+    }
+};
+
+/**
+ * @brief integral filter namespace
+ * Filters of windows of any size at O(1) per pixel, from an integral_image.
+ */
+namespace integral_filter {
+/**
+ * @brief box_blur function: the mean of the (2 radius + 1)^2 window around every pixel, the
+ * window clipped to the image, in O(1) per pixel whatever the radius
+ * @param src the image to blur
+ * @param dst set to the blurred image, of the shape of src, rounded and saturated to its
+ * pixels. It may be src.
+ * @param radius the half size of the window
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @param clip whether to average the pixels of the window inside of the image only, else the
+ * pixels outside of it count as zeros. Default = true
+ * Throws std::invalid_argument if the images have different shapes.
+ */
+template <typename T, typename U>
+void box_blur(image_view<T> src, image_view<U> dst, size_t radius, size_t threads = 1,
+              bool clip = true) {
+    using P = std::remove_const_t<T>;
+    _integral_image_utils::same_shape(src, dst, "box_blur");
+    const integral_image<P> sums{image_view<const P>(src)};
+    const size_t h = src.height(), w = src.width();
+    // the clipped windows of the columns, and the area the sums are divided by for clip
+    std::vector<size_t> x0(w), cols(w);
+    for (size_t x = 0; x < w; x++) {
+        _integral_image_utils::window(x, radius, w, x0[x], cols[x]);
+    }
+    const double area = double(2 * radius + 1) * double(2 * radius + 1);
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t y = lo; y < hi; y++) {
+            size_t y0, rows;
+            _integral_image_utils::window(y, radius, h, y0, rows);
+            const auto* top = sums.row(y0);
+            const auto* bottom = sums.row(y0 + rows);
+            U* out = dst.row(y);
+            const double n = clip ? double(rows) : area;
+            for (size_t x = 0; x < w; x++) {
+                const size_t a = x0[x], b = x0[x] + cols[x];
+                const double s = double(bottom[b] - bottom[a] - top[b] + top[a]);
+                out[x] = _image_buffer_utils::saturate<U>(s / (clip ? n * double(cols[x]) : n));
+            }
+        }
+    });
+}
+
+/**
+ * @brief local_statistics function: the mean and the standard deviation of the
+ * (2 radius + 1)^2 window around every pixel, the window clipped to the image
+ * @param src the image
+ * @param mean set to the means, of the shape of src
+ * @param deviation set to the standard deviations, of the shape of src
+ * @param radius the half size of the window
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the images have different shapes.
+ */
+template <typename T>
+void local_statistics(image_view<T> src, image_view<float> mean, image_view<float> deviation,
+                      size_t radius, size_t threads = 1) {
+    using P = std::remove_const_t<T>;
+    _integral_image_utils::same_shape(src, mean, "local_statistics");
+    _integral_image_utils::same_shape(src, deviation, "local_statistics");
+    const integral_image<P> sums(image_view<const P>(src), true);
+    _integral_image_utils::for_windows(
+        src.height(), src.width(), radius, threads,
+        [&](size_t y, size_t x, size_t y0, size_t x0, size_t rows, size_t cols) {
+            mean(y, x) = float(sums.mean(y0, x0, rows, cols));
+            deviation(y, x) = float(std::sqrt(sums.variance(y0, x0, rows, cols)));
+        });
+}
+
+/**
+ * @brief adaptive_threshold function: sets the pixels above the mean of their
+ * (2 radius + 1)^2 window minus offset, the window clipped to the image
+ * @param src the image
+ * @param dst set to above or below for every pixel, of the shape of src. It may be src.
+ * @param radius the half size of the window
+ * @param offset subtracted from the mean. Default = 0
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @param above the value of the pixels set. Default = 255
+ * @param below the value of the others. Default = 0
+ * Throws std::invalid_argument if the images have different shapes.
+ */
+template <typename T, typename U>
+void adaptive_threshold(image_view<T> src, image_view<U> dst, size_t radius, double offset = 0,
+                        size_t threads = 1, U above = U(255), U below = U(0)) {
+    using P = std::remove_const_t<T>;
+    _integral_image_utils::same_shape(src, dst, "adaptive_threshold");
+    const integral_image<P> sums{image_view<const P>(src)};
+    _integral_image_utils::for_windows(
+        src.height(), src.width(), radius, threads,
+        [&](size_t y, size_t x, size_t y0, size_t x0, size_t rows, size_t cols) {
+            const double level = sums.mean(y0, x0, rows, cols) - offset;
+            dst(y, x) = double(src(y, x)) > level ? above : below;
+        });
+}
+
+/**
+ * @brief sauvola_threshold function: sets the pixels above m(1 + k(s / range - 1)), m and s
+ * the mean and the standard deviation of their (2 radius + 1)^2 window clipped to the image,
+ * the threshold of Sauvola for documents of uneven lighting
+ * @param src the image
+ * @param dst set to above or below for every pixel, of the shape of src. It may be src.
+ * @param radius the half size of the window
+ * @param k the weight of the deviation. Default = 0.2
+ * @param range the largest deviation. Default = 128
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @param above the value of the pixels set. Default = 255
+ * @param below the value of the others. Default = 0
+ * Throws std::invalid_argument if the images have different shapes.
+ */
+template <typename T, typename U>
+void sauvola_threshold(image_view<T> src, image_view<U> dst, size_t radius, double k = 0.2,
+                       double range = 128, size_t threads = 1, U above = U(255),
+                       U below = U(0)) {
+    using P = std::remove_const_t<T>;
+    _integral_image_utils::same_shape(src, dst, "sauvola_threshold");
+    const integral_image<P> sums(image_view<const P>(src), true);
+    _integral_image_utils::for_windows(
+        src.height(), src.width(), radius, threads,
+        [&](size_t y, size_t x, size_t y0, size_t x0, size_t rows, size_t cols) {
+            const double m = sums.mean(y0, x0, rows, cols);
+            const double s = std::sqrt(sums.variance(y0, x0, rows, cols));
+            dst(y, x) = double(src(y, x)) > m * (1 + k * (s / range - 1)) ? above : below;
+        });
+}
+} // namespace integral_filter
+
+#endif
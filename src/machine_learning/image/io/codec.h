@@ -0,0 +1,288 @@
+#ifndef IMAGE_CODEC_H
+#define IMAGE_CODEC_H
+
+#include "../image_buffer.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief the shape of an encoded image: height rows of width pixels, each of channels
+ * samples(1 for gray, 3 for rgb...) of depth bits, 8 or 16
+ */
+struct image_info {
+    size_t height{0};
+    size_t width{0};
+    size_t channels{1};
+    unsigned depth{8};
+
+    /**
+     * @brief samples function
+     * @return size_t: the samples of a row, the width of the buffers the rows go through
+     */
+    size_t samples() const { return width * channels; }
+
+    bool operator==(const image_info&) const = default;
+};
+
+namespace _image_codec_utils {
+template <typename T>
+constexpr bool sample_type = std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>;
+
+// the samples of a row of depth bits can go through a buffer of T: the same depth, or 8 bit
+// samples widened to 16 bits
+template <typename T> void check_depth(unsigned depth, const char* what) {
+    static_assert(sample_type<T>, "the samples of an image are uint8_t or uint16_t");
+    if (depth > 8 * sizeof(T)) {
+        throw std::invalid_argument(std::string(what) + ": 16 bit samples need a uint16_t buffer");
+    }
+}
+
+inline void check_info(const image_info& info, const char* what) {
+    if (info.depth != 8 && info.depth != 16) {
+        throw std::invalid_argument(std::string(what) + ": the depth must be 8 or 16 bits");
+    }
+    if (info.channels == 0 || info.height == 0 || info.width == 0) {
+        throw std::invalid_argument(std::string(what) + ": an image has at least one sample");
+    }
+}
+} // namespace _image_codec_utils
+
+/**
+ * @brief image reader class
+ * Decodes an image a few rows at a time, straight into the rows of image views, so an image
+ * is never held whole in memory unless its format needs it. The rows are read from the top,
+ * row() being the next one; readers of seekable formats also decode regions anywhere in the
+ * image, e.g. the tiles of a scan too large to hold.
+ * A row holds info().samples() samples, the channels of a pixel next to each other, in the
+ * byte order of the machine. 8 bit samples may be read into uint16_t buffers.
+ */
+class image_reader {
+  public:
+    virtual ~image_reader() = default;
+
+    const image_info& info() const { return _info; }
+
+    /**
+     * @brief row function
+     * @return size_t: the next row read_rows decodes
+     */
+    size_t row() const { return _row; }
+
+    /**
+     * @brief seekable function
+     * @return true if read_region and skip_rows do not decode the rows they pass
+     */
+    virtual bool seekable() const { return false; }
+
+    /**
+     * @brief read_rows function: decodes the next dst.height() rows
+     * @param dst set to the rows, of info().samples() pixels each
+     * Throws std::invalid_argument if dst has the wrong width, more rows than are left, or 8
+     * bit pixels for 16 bit samples, and std::runtime_error if the image is corrupt.
+     */
+    template <typename T> void read_rows(image_view<T> dst) {
+        _image_codec_utils::check_depth<T>(_info.depth, "image_reader");
+        if (dst.width() != _info.samples() || dst.height() > _info.height - _row) {
+            throw std::invalid_argument("image_reader: the rows do not fit in the image");
+        }
+        for (size_t y = 0; y < dst.height(); y++, _row++) {
+            _read(_row, 0, _info.samples(), dst.row(y));
+        }
+    }
+
+    /**
+     * @brief skip_rows function: moves past the next rows without keeping them
+     * @param rows the rows to skip, at most those left
+     */
+    void skip_rows(size_t rows) {
+        if (rows > _info.height - _row) {
+            throw std::invalid_argument("image_reader: the rows do not fit in the image");
+        }
+        if (seekable()) {
+            _row += rows;
+            return;
+        }
+        _scratch.resize(_info.samples() * (_info.depth / 8));
+        for (; rows > 0; rows--, _row++) {
+            _decode(_row, 0, _info.samples(), _scratch.data());
+        }
+    }
+
+    /**
+     * @brief read_region function: decodes the dst.height() x dst.width() / channels pixels
+     * at (y, x), without moving row()
+     * @param y the first row of the region
+     * @param x the first pixel of the region
+     * @param dst set to the region, a multiple of info().channels wide
+     * Throws std::logic_error if the reader is not seekable, and std::invalid_argument if
+     * the region is out of the image.
+     */
+    template <typename T> void read_region(size_t y, size_t x, image_view<T> dst) {
+        _image_codec_utils::check_depth<T>(_info.depth, "image_reader");
+        if (!seekable()) {
+            throw std::logic_error("image_reader: the format can only be read from the top");
+        }
+        const size_t c = _info.channels;
+        if (dst.width() % c != 0 || y > _info.height || dst.height() > _info.height - y ||
+            x > _info.width || dst.width() / c > _info.width - x) {
+            throw std::invalid_argument("image_reader: the region is out of the image");
+        }
+        for (size_t i = 0; i < dst.height(); i++) {
+            _read(y + i, x * c, dst.width(), dst.row(i));
+        }
+    }
+
+  protected:
+    image_info _info;
+
+    /**
+     * @brief decodes the count samples from the sample begin of row y into out, samples of
+     * info().depth bits in the byte order of the machine. Sequential readers are only asked
+     * for whole rows, in order.
+     */
+    virtual void _decode(size_t y, size_t begin, size_t count, void* out) = 0;
+
+  private:
+    size_t _row{0};
+    std::vector<uint8_t> _scratch;
+
+    template <typename T> void _read(size_t y, size_t begin, size_t count, T* out) {
+        if (8 * sizeof(T) == _info.depth) {
+            _decode(y, begin, count, out);
+        } else {
+            // 8 bit samples widened to a uint16_t buffer
+            _scratch.resize(count);
+            _decode(y, begin, count, _scratch.data());
+            std::copy(_scratch.begin(), _scratch.end(), out);
+        }
+    }
+};
+
+/**
+ * @brief image writer class
+ * Encodes an image a few rows at a time from the top, the format finished when the last row
+ * is written. The rows are laid out as for image_reader; 8 bit pixels may be written to 16
+ * bit images.
+ */
+class image_writer {
+  public:
+    virtual ~image_writer() = default;
+
+    const image_info& info() const { return _info; }
+
+    /**
+     * @brief row function
+     * @return size_t: the next row write_rows encodes
+     */
+    size_t row() const { return _row; }
+
+    /**
+     * @brief write_rows function: encodes the next src.height() rows
+     * @param src the rows, of info().samples() pixels each
+     * Throws std::invalid_argument if src has the wrong width, more rows than are left or 16
+     * bit pixels for 8 bit samples, and std::runtime_error if the output fails.
+     */
+    template <typename T> void write_rows(image_view<const T> src) {
+        _image_codec_utils::check_depth<T>(_info.depth, "image_writer");
+        if (src.width() != _info.samples() || src.height() > _info.height - _row) {
+            throw std::invalid_argument("image_writer: the rows do not fit in the image");
+        }
+        for (size_t y = 0; y < src.height(); y++, _row++) {
+            const T* samples = src.row(y);
+            if (8 * sizeof(T) == _info.depth) {
+                _encode(samples);
+            } else {
+                // 8 bit pixels widened for a 16 bit image
+                _wide.assign(samples, samples + src.width());
+                _encode(_wide.data());
+            }
+        }
+        if (_row == _info.height && src.height() > 0) {
+            _finish();
+        }
+    }
+
+    template <typename T> void write_rows(image_view<T> src) {
+        write_rows(image_view<const T>(src));
+    }
+
+  protected:
+    image_info _info;
+
+    /**
+     * @brief encodes the next row, info().samples() samples of info().depth bits in the
+     * byte order of the machine
+     */
+    virtual void _encode(const void* samples) = 0;
+
+    /**
+     * @brief ends the image once its last row is encoded
+     */
+    virtual void _finish() {}
+
+  private:
+    size_t _row{0};
+    std::vector<uint16_t> _wide;
+};
+
+/**
+ * @brief codec class
+ * An image format: recognizes its files and makes their readers and writers. The formats
+ * image_io reads and writes are the codecs of a codec_registry.
+ */
+class codec {
+  public:
+    virtual ~codec() = default;
+
+    /**
+     * @brief name function
+     * @return std::string_view: the name of the format, e.g. "pnm"
+     */
+    virtual std::string_view name() const = 0;
+
+    /**
+     * @brief handles function
+     * @param extension the extension of a file name, lower case and without the dot
+     * @return true if files of that extension are written in the format
+     */
+    virtual bool handles(std::string_view extension) const = 0;
+
+    /**
+     * @brief recognizes function
+     * @param signature the first bytes of a file, up to 8
+     * @return true if the file is in the format
+     */
+    virtual bool recognizes(std::string_view signature) const = 0;
+
+    /**
+     * @brief reader function
+     * @param in the encoded image, from its first byte
+     * @return std::unique_ptr<image_reader>: a reader past the header of the image, that owns
+     * in. Throws std::runtime_error if the header is corrupt.
+     */
+    virtual std::unique_ptr<image_reader> reader(std::unique_ptr<std::istream> in) const = 0;
+
+    /**
+     * @brief writer function
+     * @param out where the image is encoded
+     * @param info the shape of the image
+     * @return std::unique_ptr<image_writer>: a writer that owns out. Throws
+     * std::invalid_argument if the format can not hold images of that shape.
+     */
+    virtual std::unique_ptr<image_writer> writer(std::unique_ptr<std::ostream> out,
+                                                 const image_info& info) const = 0;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef IMAGE_IO_H
+#define IMAGE_IO_H
+
+#include "codec.h"
+#include "jpeg_codec.h"
+#include "png_codec.h"
+#include "pnm.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#endif
+
+/**
+ * @brief codec registry class
+ * The image formats image_io reads and writes. shared() holds pnm, and png and jpeg when
+ * they are built(see png_codec.h and jpeg_codec.h); other formats are plugged in with add.
+ */
+class codec_registry {
+  public:
+    /**
+     * @brief shared function
+     * @return codec_registry&: the registry of image_io
+     */
+    static codec_registry& shared() {
+        static codec_registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Construct a new codec registry object with the built in formats
+     */
+    codec_registry() {
+        add(std::make_shared<pnm_codec>());
+#ifdef ALGOPLUS_WITH_PNG
+        add(std::make_shared<png_codec>());
+#endif
+#ifdef ALGOPLUS_WITH_JPEG
+        add(std::make_shared<jpeg_codec>());
+#endif
+    }
+
+    /**
+     * @brief add function
+     * @param format the codec to add, found before the codecs added earlier
+     */
+    void add(std::shared_ptr<const codec> format) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _codecs.insert(_codecs.begin(), std::move(format));
+    }
+
+    /**
+     * @brief by_extension function
+     * @param extension an extension of a file name, without the dot, in any case
+     * @return std::shared_ptr<const codec>: the codec that writes files of that extension,
+     * nullptr if there is none
+     */
+    std::shared_ptr<const codec> by_extension(std::string_view extension) const {
+        std::string lower(extension);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return char(std::tolower(c)); });
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& c : _codecs) {
+            if (c->handles(lower)) {
+                return c;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief by_signature function
+     * @param signature the first bytes of a file, up to 8
+     * @return std::shared_ptr<const codec>: the codec of the file, nullptr if there is none
+     */
+    std::shared_ptr<const codec> by_signature(std::string_view signature) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& c : _codecs) {
+            if (c->recognizes(signature)) {
+                return c;
+            }
+        }
+        return nullptr;
+    }
+
+  private:
+    mutable std::mutex _mutex;
+    std::vector<std::shared_ptr<const codec>> _codecs;
+};
+
+/**
+ * @brief image io namespace
+ * Reads and writes image files with the codecs of a codec_registry, streaming their rows
+ * through image_reader and image_writer or whole to image_buffers.
+ */
+namespace image_io {
+/**
+ * @brief open function
+ * @param path the file
+ * @param registry the formats the file may be in. Default = codec_registry::shared()
+ * @return std::unique_ptr<image_reader>: the reader of the file, found from its first bytes.
+ * Throws std::runtime_error if the file can not be opened, is in none of the formats or has
+ * a corrupt header.
+ */
+inline std::unique_ptr<image_reader>
+open(const std::string& path, const codec_registry& registry = codec_registry::shared()) {
+    auto in = std::make_unique<std::ifstream>(path, std::ios::binary);
+    if (!*in) {
+        throw std::runtime_error("Can't open file " + path);
+    }
+    char signature[8] = {};
+    in->read(signature, sizeof(signature));
+    const auto format = registry.by_signature(std::string_view(signature, size_t(in->gcount())));
+    if (format == nullptr) {
+        throw std::runtime_error("image_io: the format of " + path + " is unknown");
+    }
+    in->clear();
+    in->seekg(0);
+    return format->reader(std::move(in));
+}
+
+/**
+ * @brief create function
+ * @param path the file, overwritten
+ * @param info the shape of the image
+ * @param registry the formats the file may be written in. Default = codec_registry::shared()
+ * @return std::unique_ptr<image_writer>: the writer of the file, in the format of its
+ * extension. Throws std::runtime_error if the file can not be created or no format writes
+ * the extension, and std::invalid_argument if the format can not hold the image.
+ */
+inline std::unique_ptr<image_writer>
+create(const std::string& path, const image_info& info,
+       const codec_registry& registry = codec_registry::shared()) {
+    const size_t dot = path.find_last_of('.');
+    const auto format = dot == std::string::npos || path.find('/', dot) != std::string::npos
+                            ? nullptr
+                            : registry.by_extension(std::string_view(path).substr(dot + 1));
+    if (format == nullptr) {
+        throw std::runtime_error("image_io: no format writes " + path);
+    }
+    auto out = std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+    if (!*out) {
+        throw std::runtime_error("Can't create file " + path);
+    }
+    return format->writer(std::move(out), info);
+}
+
+/**
+ * @brief read function
+ * @param path the file
+ * @return image_buffer<T>: the image, of info().samples() pixels a row(see image_reader);
+ * T is uint8_t or uint16_t. Throws as open and image_reader::read_rows.
+ */
+template <typename T> image_buffer<T> read(const std::string& path) {
+    auto reader = open(path);
+    image_buffer<T> img(reader->info().height, reader->info().samples());
+    reader->read_rows(img.view());
+    return img;
+}
+
+/**
+ * @brief write function
+ * @param path the file, overwritten, in the format of its extension
+ * @param img the image, of channels samples a pixel, of uint8_t or uint16_t
+ * @param channels the samples of a pixel, that divide the width of img. Default = 1
+ * Throws as create and image_writer::write_rows.
+ */
+template <typename T> void write(const std::string& path, image_view<T> img, size_t channels = 1) {
+    if (channels == 0 || img.width() % channels != 0) {
+        throw std::invalid_argument("image_io: the width is not a whole number of pixels");
+    }
+    auto writer = create(path, image_info{img.height(), img.width() / channels, channels,
+                                          unsigned(8 * sizeof(std::remove_const_t<T>))});
+    writer->write_rows(img);
+}
+
+template <typename T> void write(const std::string& path, const image_buffer<T>& img,
+                                 size_t channels = 1) {
+    write(path, img.view(), channels);
+}
+} // namespace image_io
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef JPEG_CODEC_H
+#define JPEG_CODEC_H
+
+/**
+ * The jpeg backend of image_io, built with libjpeg(or libjpeg-turbo) when ALGOPLUS_WITH_JPEG
+ * is defined(link with -ljpeg). libjpeg reports errors with longjmp: every call into it is
+ * made after a setjmp in a function without locals to destroy, and the error becomes an
+ * exception there.
+ */
+#ifdef ALGOPLUS_WITH_JPEG
+
+#include "codec.h"
+
+#ifdef __cplusplus
+#include <csetjmp>
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <jerror.h>
+#include <jpeglib.h>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#endif
+
+namespace _jpeg_codec_utils {
+constexpr size_t buffer_size = 1 << 16;
+
+struct error {
+    jpeg_error_mgr pub;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+inline void error_exit(j_common_ptr info) {
+    error* e = reinterpret_cast<error*>(info->err);
+    (*info->err->format_message)(info, e->message);
+    std::longjmp(e->jump, 1);
+}
+
+inline void output_message(j_common_ptr) {}
+
+// the error manager of a (de)compressor, that jumps back to the last setjmp on e.jump
+inline jpeg_error_mgr* errors(error& e) {
+    jpeg_error_mgr* mgr = jpeg_std_error(&e.pub);
+    mgr->error_exit = error_exit;
+    mgr->output_message = output_message;
+    return mgr;
+}
+
+// the bytes of the image, read from a stream
+struct source {
+    jpeg_source_mgr pub;
+    std::istream* in;
+    JOCTET buffer[buffer_size];
+};
+
+inline void init_source(j_decompress_ptr) {}
+
+inline boolean fill_input_buffer(j_decompress_ptr info) {
+    source* s = reinterpret_cast<source*>(info->src);
+    s->in->read(reinterpret_cast<char*>(s->buffer), std::streamsize(buffer_size));
+    size_t n = size_t(s->in->gcount());
+    if (n == 0) {
+        // a truncated image ends as if it was complete, as libjpeg does for files
+        WARNMS(info, JWRN_JPEG_EOF);
+        s->buffer[0] = JOCTET(0xFF);
+        s->buffer[1] = JOCTET(JPEG_EOI);
+        n = 2;
+    }
+    s->pub.next_input_byte = s->buffer;
+    s->pub.bytes_in_buffer = n;
+    return TRUE;
+}
+
+inline void skip_input_data(j_decompress_ptr info, long bytes) {
+    source* s = reinterpret_cast<source*>(info->src);
+    for (; bytes > long(s->pub.bytes_in_buffer); bytes -= long(s->pub.bytes_in_buffer)) {
+        fill_input_buffer(info);
+    }
+    if (bytes > 0) {
+        s->pub.next_input_byte += bytes;
+        s->pub.bytes_in_buffer -= size_t(bytes);
+    }
+}
+
+inline void term_source(j_decompress_ptr) {}
+
+// the bytes of the image, written to a stream
+struct destination {
+    jpeg_destination_mgr pub;
+    std::ostream* out;
+    JOCTET buffer[buffer_size];
+};
+
+inline void init_destination(j_compress_ptr info) {
+    destination* d = reinterpret_cast<destination*>(info->dest);
+    d->pub.next_output_byte = d->buffer;
+    d->pub.free_in_buffer = buffer_size;
+}
+
+inline boolean empty_output_buffer(j_compress_ptr info) {
+    destination* d = reinterpret_cast<destination*>(info->dest);
+    if (!d->out->write(reinterpret_cast<const char*>(d->buffer), std::streamsize(buffer_size))) {
+        ERREXIT(info, JERR_FILE_WRITE);
+    }
+    init_destination(info);
+    return TRUE;
+}
+
+inline void term_destination(j_compress_ptr info) {
+    destination* d = reinterpret_cast<destination*>(info->dest);
+    const size_t n = buffer_size - d->pub.free_in_buffer;
+    if (!d->out->write(reinterpret_cast<const char*>(d->buffer), std::streamsize(n)) ||
+        !d->out->flush()) {
+        ERREXIT(info, JERR_FILE_WRITE);
+    }
+}
+} // namespace _jpeg_codec_utils
+
+/**
+ * @brief jpeg reader class
+ * Reads jpeg images a row at a time, gray images as 1 channel and the others as 3 channels
+ * of rgb(cmyk images as their 4 channels), of 8 bits.
+ */
+class jpeg_reader : public image_reader {
+  public:
+    /**
+     * @brief Construct a new jpeg reader object
+     * @param in the image, from its first byte
+     * Throws std::runtime_error if the header is corrupt.
+     */
+    explicit jpeg_reader(std::unique_ptr<std::istream> in)
+        : _in(std::move(in)), _source(std::make_unique<_jpeg_codec_utils::source>()) {
+        _jpeg.err = _jpeg_codec_utils::errors(_error);
+        if (setjmp(_error.jump)) {
+            jpeg_destroy_decompress(&_jpeg);
+            throw std::runtime_error(std::string("jpeg: ") + _error.message);
+        }
+        jpeg_create_decompress(&_jpeg);
+        _source->in = _in.get();
+        _source->pub.init_source = _jpeg_codec_utils::init_source;
+        _source->pub.fill_input_buffer = _jpeg_codec_utils::fill_input_buffer;
+        _source->pub.skip_input_data = _jpeg_codec_utils::skip_input_data;
+        _source->pub.resync_to_restart = jpeg_resync_to_restart;
+        _source->pub.term_source = _jpeg_codec_utils::term_source;
+        _source->pub.bytes_in_buffer = 0;
+        _source->pub.next_input_byte = nullptr;
+        _jpeg.src = &_source->pub;
+        jpeg_read_header(&_jpeg, TRUE);
+        jpeg_start_decompress(&_jpeg);
+        _info = image_info{_jpeg.output_height, _jpeg.output_width,
+                           size_t(_jpeg.output_components), 8};
+    }
+
+    jpeg_reader(const jpeg_reader&) = delete;
+    jpeg_reader& operator=(const jpeg_reader&) = delete;
+
+    ~jpeg_reader() override { jpeg_destroy_decompress(&_jpeg); }
+
+  protected:
+    void _decode(size_t, size_t, size_t, void* out) override {
+        if (setjmp(_error.jump)) {
+            throw std::runtime_error(std::string("jpeg: ") + _error.message);
+        }
+        JSAMPROW row = static_cast<JSAMPROW>(out);
+        jpeg_read_scanlines(&_jpeg, &row, 1);
+    }
+
+  private:
+    std::unique_ptr<std::istream> _in;
+    std::unique_ptr<_jpeg_codec_utils::source> _source;
+    jpeg_decompress_struct _jpeg{};
+    _jpeg_codec_utils::error _error{};
+};
+
+/**
+ * @brief jpeg writer class
+ * Writes jpeg images of 1(gray) or 3(rgb) channels of 8 bits, a row at a time.
+ */
+class jpeg_writer : public image_writer {
+  public:
+    /**
+     * @brief Construct a new jpeg writer object, and writes the header
+     * @param out where the image is written
+     * @param info the shape of the image, of 1 or 3 channels of 8 bits
+     * @param quality from 0 to 100. Default = 90
+     * Throws std::invalid_argument for other images, and std::runtime_error if the output
+     * fails.
+     */
+    jpeg_writer(std::unique_ptr<std::ostream> out, const image_info& info, int quality = 90)
+        : _out(std::move(out)), _destination(std::make_unique<_jpeg_codec_utils::destination>()) {
+        _image_codec_utils::check_info(info, "jpeg_writer");
+        if ((info.channels != 1 && info.channels != 3) || info.depth != 8) {
+            throw std::invalid_argument("jpeg_writer: jpeg images have 1 or 3 channels of 8 bits");
+        }
+        _info = info;
+        _jpeg.err = _jpeg_codec_utils::errors(_error);
+        if (setjmp(_error.jump)) {
+            jpeg_destroy_compress(&_jpeg);
+            throw std::runtime_error(std::string("jpeg: ") + _error.message);
+        }
+        jpeg_create_compress(&_jpeg);
+        _destination->out = _out.get();
+        _destination->pub.init_destination = _jpeg_codec_utils::init_destination;
+        _destination->pub.empty_output_buffer = _jpeg_codec_utils::empty_output_buffer;
+        _destination->pub.term_destination = _jpeg_codec_utils::term_destination;
+        _jpeg.dest = &_destination->pub;
+        _jpeg.image_width = JDIMENSION(info.width);
+        _jpeg.image_height = JDIMENSION(info.height);
+        _jpeg.input_components = int(info.channels);
+        _jpeg.in_color_space = info.channels == 1 ? JCS_GRAYSCALE : JCS_RGB;
+        jpeg_set_defaults(&_jpeg);
+        jpeg_set_quality(&_jpeg, quality, TRUE);
+        jpeg_start_compress(&_jpeg, TRUE);
+    }
+
+    jpeg_writer(const jpeg_writer&) = delete;
+    jpeg_writer& operator=(const jpeg_writer&) = delete;
+
+    ~jpeg_writer() override { jpeg_destroy_compress(&_jpeg); }
+
+  protected:
+    void _encode(const void* samples) override {
+        if (setjmp(_error.jump)) {
+            throw std::runtime_error(std::string("jpeg: ") + _error.message);
+        }
+        JSAMPROW row = const_cast<JSAMPROW>(static_cast<const JSAMPLE*>(samples));
+        jpeg_write_scanlines(&_jpeg, &row, 1);
+    }
+
+    void _finish() override {
+        if (setjmp(_error.jump)) {
+            throw std::runtime_error(std::string("jpeg: ") + _error.message);
+        }
+        jpeg_finish_compress(&_jpeg);
+    }
+
+  private:
+    std::unique_ptr<std::ostream> _out;
+    std::unique_ptr<_jpeg_codec_utils::destination> _destination;
+    jpeg_compress_struct _jpeg{};
+    _jpeg_codec_utils::error _error{};
+};
+
+/**
+ * @brief jpeg codec class
+ * jpeg images, files *.jpg and *.jpeg.
+ */
+class jpeg_codec : public codec {
+  public:
+    /**
+     * @brief Construct a new jpeg codec object
+     * @param quality of the images written, from 0 to 100. Default = 90
+     */
+    explicit jpeg_codec(int quality = 90) : _quality(quality) {}
+
+    std::string_view name() const override { return "jpeg"; }
+
+    bool handles(std::string_view extension) const override {
+        return extension == "jpg" || extension == "jpeg";
+    }
+
+    bool recognizes(std::string_view signature) const override {
+        return signature.size() >= 3 && static_cast<unsigned char>(signature[0]) == 0xFF &&
+               static_cast<unsigned char>(signature[1]) == 0xD8 &&
+               static_cast<unsigned char>(signature[2]) == 0xFF;
+    }
+
+    std::unique_ptr<image_reader> reader(std::unique_ptr<std::istream> in) const override {
+        return std::make_unique<jpeg_reader>(std::move(in));
+    }
+
+    std::unique_ptr<image_writer> writer(std::unique_ptr<std::ostream> out,
+                                         const image_info& info) const override {
+        return std::make_unique<jpeg_writer>(std::move(out), info, _quality);
+    }
+
+  private:
+    int _quality;
+};
+
+#endif
+
+#endif
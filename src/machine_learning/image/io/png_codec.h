@@ -0,0 +1,236 @@
+#ifndef PNG_CODEC_H
+#define PNG_CODEC_H
+
+/**
+ * The png backend of image_io, built with libpng when ALGOPLUS_WITH_PNG is defined(link
+ * with -lpng). libpng reports errors with longjmp: every call into it is made after a
+ * setjmp in a function without locals to destroy, and the error becomes an exception there.
+ */
+#ifdef ALGOPLUS_WITH_PNG
+
+#include "codec.h"
+
+#ifdef __cplusplus
+#include <bit>
+#include <csetjmp>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <png.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+namespace _png_codec_utils {
+inline void error(png_structp png, png_const_charp message) {
+    *static_cast<std::string*>(png_get_error_ptr(png)) = message;
+    png_longjmp(png, 1);
+}
+
+inline void warning(png_structp, png_const_charp) {}
+
+inline void read(png_structp png, png_bytep data, png_size_t n) {
+    auto* in = static_cast<std::istream*>(png_get_io_ptr(png));
+    if (!in->read(reinterpret_cast<char*>(data), std::streamsize(n))) {
+        png_error(png, "the image is truncated");
+    }
+}
+
+inline void write(png_structp png, png_bytep data, png_size_t n) {
+    auto* out = static_cast<std::ostream*>(png_get_io_ptr(png));
+    if (!out->write(reinterpret_cast<const char*>(data), std::streamsize(n))) {
+        png_error(png, "the image can not be written");
+    }
+}
+
+inline void flush(png_structp png) { static_cast<std::ostream*>(png_get_io_ptr(png))->flush(); }
+} // namespace _png_codec_utils
+
+/**
+ * @brief png reader class
+ * Reads png images a row at a time. Palettes are expanded to rgb, gray images of less than
+ * 8 bits to 8 bits and transparency to an alpha channel, so the images have 1 to 4 channels
+ * of 8 or 16 bits. Interlaced images can not be streamed, they are decoded whole at the
+ * first row.
+ */
+class png_reader : public image_reader {
+  public:
+    /**
+     * @brief Construct a new png reader object
+     * @param in the image, from its first byte
+     * Throws std::runtime_error if the header is corrupt.
+     */
+    explicit png_reader(std::unique_ptr<std::istream> in) : _in(std::move(in)) {
+        _png = png_create_read_struct(PNG_LIBPNG_VER_STRING, &_error, _png_codec_utils::error,
+                                      _png_codec_utils::warning);
+        _meta = _png != nullptr ? png_create_info_struct(_png) : nullptr;
+        if (_meta == nullptr) {
+            png_destroy_read_struct(&_png, nullptr, nullptr);
+            throw std::runtime_error("png: out of memory");
+        }
+        if (setjmp(png_jmpbuf(_png))) {
+            png_destroy_read_struct(&_png, &_meta, nullptr);
+            throw std::runtime_error("png: " + _error);
+        }
+        png_set_read_fn(_png, _in.get(), _png_codec_utils::read);
+        png_read_info(_png, _meta);
+        png_set_expand(_png);
+        if (png_get_bit_depth(_png, _meta) == 16 && std::endian::native == std::endian::little) {
+            png_set_swap(_png);
+        }
+        _passes = png_set_interlace_handling(_png);
+        png_read_update_info(_png, _meta);
+        _info = image_info{png_get_image_height(_png, _meta), png_get_image_width(_png, _meta),
+                           png_get_channels(_png, _meta), png_get_bit_depth(_png, _meta)};
+    }
+
+    png_reader(const png_reader&) = delete;
+    png_reader& operator=(const png_reader&) = delete;
+
+    ~png_reader() override { png_destroy_read_struct(&_png, &_meta, nullptr); }
+
+  protected:
+    void _decode(size_t y, size_t, size_t, void* out) override {
+        if (setjmp(png_jmpbuf(_png))) {
+            throw std::runtime_error("png: " + _error);
+        }
+        if (_passes == 1) {
+            png_read_row(_png, static_cast<png_bytep>(out), nullptr);
+            return;
+        }
+        const size_t bytes = _info.samples() * (_info.depth / 8);
+        if (_image.empty()) {
+            _image.resize(_info.height * bytes);
+            _rows.resize(_info.height);
+            for (size_t i = 0; i < _info.height; i++) {
+                _rows[i] = _image.data() + i * bytes;
+            }
+            png_read_image(_png, _rows.data());
+        }
+        std::memcpy(out, _rows[y], bytes);
+    }
+
+  private:
+    std::unique_ptr<std::istream> _in;
+    png_structp _png{nullptr};
+    png_infop _meta{nullptr};
+    std::string _error;
+    int _passes{1};
+    std::vector<png_byte> _image;
+    std::vector<png_bytep> _rows;
+};
+
+/**
+ * @brief png writer class
+ * Writes png images of 1(gray), 2(gray and alpha), 3(rgb) or 4(rgba) channels of 8 or 16
+ * bits, a row at a time.
+ */
+class png_writer : public image_writer {
+  public:
+    /**
+     * @brief Construct a new png writer object, and writes the header
+     * @param out where the image is written
+     * @param info the shape of the image, of 1 to 4 channels
+     * @param compression the zlib level, from 0(none) to 9. Default = 6
+     * Throws std::invalid_argument if the image has more channels, and std::runtime_error if
+     * the output fails.
+     */
+    png_writer(std::unique_ptr<std::ostream> out, const image_info& info, int compression = 6)
+        : _out(std::move(out)) {
+        _image_codec_utils::check_info(info, "png_writer");
+        if (info.channels > 4) {
+            throw std::invalid_argument("png_writer: png images have 1 to 4 channels");
+        }
+        _info = info;
+        _png = png_create_write_struct(PNG_LIBPNG_VER_STRING, &_error, _png_codec_utils::error,
+                                       _png_codec_utils::warning);
+        _meta = _png != nullptr ? png_create_info_struct(_png) : nullptr;
+        if (_meta == nullptr) {
+            png_destroy_write_struct(&_png, nullptr);
+            throw std::runtime_error("png: out of memory");
+        }
+        if (setjmp(png_jmpbuf(_png))) {
+            png_destroy_write_struct(&_png, &_meta);
+            throw std::runtime_error("png: " + _error);
+        }
+        static constexpr int colors[] = {PNG_COLOR_TYPE_GRAY, PNG_COLOR_TYPE_GRAY_ALPHA,
+                                         PNG_COLOR_TYPE_RGB, PNG_COLOR_TYPE_RGB_ALPHA};
+        png_set_write_fn(_png, _out.get(), _png_codec_utils::write, _png_codec_utils::flush);
+        png_set_IHDR(_png, _meta, png_uint_32(info.width), png_uint_32(info.height),
+                     int(info.depth), colors[info.channels - 1], PNG_INTERLACE_NONE,
+                     PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        png_set_compression_level(_png, compression);
+        png_write_info(_png, _meta);
+        if (info.depth == 16 && std::endian::native == std::endian::little) {
+            png_set_swap(_png);
+        }
+    }
+
+    png_writer(const png_writer&) = delete;
+    png_writer& operator=(const png_writer&) = delete;
+
+    ~png_writer() override { png_destroy_write_struct(&_png, &_meta); }
+
+  protected:
+    void _encode(const void* samples) override {
+        if (setjmp(png_jmpbuf(_png))) {
+            throw std::runtime_error("png: " + _error);
+        }
+        png_write_row(_png, static_cast<png_const_bytep>(samples));
+    }
+
+    void _finish() override {
+        if (setjmp(png_jmpbuf(_png))) {
+            throw std::runtime_error("png: " + _error);
+        }
+        png_write_end(_png, nullptr);
+    }
+
+  private:
+    std::unique_ptr<std::ostream> _out;
+    png_structp _png{nullptr};
+    png_infop _meta{nullptr};
+    std::string _error;
+};
+
+/**
+ * @brief png codec class
+ * png images, files *.png.
+ */
+class png_codec : public codec {
+  public:
+    /**
+     * @brief Construct a new png codec object
+     * @param compression the zlib level of the images written, from 0(none) to 9. Default = 6
+     */
+    explicit png_codec(int compression = 6) : _compression(compression) {}
+
+    std::string_view name() const override { return "png"; }
+
+    bool handles(std::string_view extension) const override { return extension == "png"; }
+
+    bool recognizes(std::string_view signature) const override {
+        return signature.size() >= 8 &&
+               png_sig_cmp(reinterpret_cast<png_const_bytep>(signature.data()), 0, 8) == 0;
+    }
+
+    std::unique_ptr<image_reader> reader(std::unique_ptr<std::istream> in) const override {
+        return std::make_unique<png_reader>(std::move(in));
+    }
+
+    std::unique_ptr<image_writer> writer(std::unique_ptr<std::ostream> out,
+                                         const image_info& info) const override {
+        return std::make_unique<png_writer>(std::move(out), info, _compression);
+    }
+
+  private:
+    int _compression;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,327 @@
+#ifndef PNM_H
+#define PNM_H
+
+#include "../../../helpers/mapped_file.h"
+#include "codec.h"
+
+#ifdef __cplusplus
+#include <bit>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace _pnm_utils {
+/**
+ * @brief the header of a pgm(P2 ascii, P5 binary) or ppm(P3, P6) image
+ */
+struct header {
+    image_info info;
+    unsigned maxval{255};
+    bool binary{true};
+    size_t data_at{0};
+};
+
+inline bool space(int c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief parses a header from its first byte, get() returning the next byte or a negative
+ * value at the end. Throws std::runtime_error if it is not one.
+ */
+template <typename Get> header parse(Get&& get) {
+    header h;
+    size_t read = 0;
+    auto next = [&]() {
+        read++;
+        return get();
+    };
+    const int p = next(), kind = next();
+    if (p != 'P' || (kind != '2' && kind != '3' && kind != '5' && kind != '6')) {
+        throw std::runtime_error("pnm: not a pgm or ppm image");
+    }
+    // a decimal number after whitespace and comments, and the whitespace ending it
+    auto number = [&]() {
+        int c = next();
+        while (space(c) || c == '#') {
+            if (c == '#') {
+                while (c >= 0 && c != '\n' && c != '\r') {
+                    c = next();
+                }
+            }
+            c = next();
+        }
+        if (c < '0' || c > '9') {
+            throw std::runtime_error("pnm: the header is corrupt");
+        }
+        size_t v = 0;
+        for (; c >= '0' && c <= '9'; c = next()) {
+            v = v * 10 + size_t(c - '0');
+            if (v > (size_t(1) << 40)) {
+                throw std::runtime_error("pnm: the header is corrupt");
+            }
+        }
+        if (!space(c)) {
+            throw std::runtime_error("pnm: the header is corrupt");
+        }
+        return v;
+    };
+    h.info.width = number();
+    h.info.height = number();
+    const size_t maxval = number();
+    if (h.info.width == 0 || h.info.height == 0 || maxval == 0 || maxval > 65535) {
+        throw std::runtime_error("pnm: the header is corrupt");
+    }
+    h.maxval = unsigned(maxval);
+    h.info.channels = kind == '3' || kind == '6' ? 3 : 1;
+    h.info.depth = maxval < 256 ? 8 : 16;
+    h.binary = kind == '5' || kind == '6';
+    h.data_at = read;
+    return h;
+}
+
+// the 16 bit samples of pnm files are big endian
+inline void swap_bytes(uint16_t* samples, size_t n) {
+    if constexpr (std::endian::native == std::endian::little) {
+        for (size_t i = 0; i < n; i++) {
+            samples[i] = uint16_t((samples[i] >> 8) | (samples[i] << 8));
+        }
+    }
+}
+} // namespace _pnm_utils
+
+/**
+ * @brief pnm reader class
+ * Reads pgm and ppm images, ascii or binary. The samples are the values stored, from 0 to
+ * maxval(), of 8 bits if maxval() < 256 and 16 bits otherwise. Binary images from seekable
+ * streams, e.g. files, are seekable: their regions are read straight from where they are.
+ */
+class pnm_reader : public image_reader {
+  public:
+    /**
+     * @brief Construct a new pnm reader object
+     * @param in the image, from its first byte
+     * Throws std::runtime_error if the header is corrupt.
+     */
+    explicit pnm_reader(std::unique_ptr<std::istream> in) : _in(std::move(in)) {
+        const _pnm_utils::header h = _pnm_utils::parse([this]() { return _in->get(); });
+        _info = h.info;
+        _maxval = h.maxval;
+        _binary = h.binary;
+        const std::streampos at = _in->tellg();
+        _seekable = _binary && at != std::streampos(-1);
+        _data_at = _seekable ? size_t(at) : 0;
+    }
+
+    bool seekable() const override { return _seekable; }
+
+    /**
+     * @brief maxval function
+     * @return unsigned: the largest value of a sample
+     */
+    unsigned maxval() const { return _maxval; }
+
+  protected:
+    void _decode(size_t y, size_t begin, size_t count, void* out) override {
+        const size_t bytes = _info.depth / 8;
+        if (!_binary) {
+            _decode_ascii(count, out);
+            return;
+        }
+        const size_t at = (y * _info.samples() + begin) * bytes;
+        if (_seekable && at != _at) {
+            _in->seekg(std::streamoff(_data_at + at));
+        }
+        _in->read(static_cast<char*>(out), std::streamsize(count * bytes));
+        if (!*_in) {
+            throw std::runtime_error("pnm: the image is truncated");
+        }
+        _at = at + count * bytes;
+        if (bytes == 2) {
+            _pnm_utils::swap_bytes(static_cast<uint16_t*>(out), count);
+        }
+    }
+
+  private:
+    std::unique_ptr<std::istream> _in;
+    unsigned _maxval{255};
+    bool _binary{true}, _seekable{false};
+    size_t _data_at{0}, _at{0};
+
+    void _decode_ascii(size_t count, void* out) {
+        for (size_t i = 0; i < count; i++) {
+            unsigned v = 0;
+            if (!(*_in >> v) || v > _maxval) {
+                throw std::runtime_error("pnm: the image is corrupt");
+            }
+            if (_info.depth == 8) {
+                static_cast<uint8_t*>(out)[i] = uint8_t(v);
+            } else {
+                static_cast<uint16_t*>(out)[i] = uint16_t(v);
+            }
+        }
+    }
+};
+
+/**
+ * @brief pnm writer class
+ * Writes binary pgm(1 channel) and ppm(3 channels) images of maxval 255 or 65535.
+ */
+class pnm_writer : public image_writer {
+  public:
+    /**
+     * @brief Construct a new pnm writer object, and writes the header
+     * @param out where the image is written
+     * @param info the shape of the image, of 1 or 3 channels
+     * Throws std::invalid_argument otherwise.
+     */
+    pnm_writer(std::unique_ptr<std::ostream> out, const image_info& info) : _out(std::move(out)) {
+        _image_codec_utils::check_info(info, "pnm_writer");
+        if (info.channels != 1 && info.channels != 3) {
+            throw std::invalid_argument("pnm_writer: pgm and ppm images have 1 or 3 channels");
+        }
+        _info = info;
+        *_out << (info.channels == 1 ? "P5" : "P6") << '\n'
+              << info.width << ' ' << info.height << '\n'
+              << (info.depth == 8 ? 255 : 65535) << '\n';
+    }
+
+  protected:
+    void _encode(const void* samples) override {
+        const size_t n = _info.samples();
+        if (_info.depth == 16) {
+            const uint16_t* s = static_cast<const uint16_t*>(samples);
+            _swapped.assign(s, s + n);
+            _pnm_utils::swap_bytes(_swapped.data(), n);
+            samples = _swapped.data();
+        }
+        _out->write(static_cast<const char*>(samples), std::streamsize(n * _info.depth / 8));
+        if (!*_out) {
+            throw std::runtime_error("pnm_writer: the image can not be written");
+        }
+    }
+
+    void _finish() override {
+        _out->flush();
+        if (!*_out) {
+            throw std::runtime_error("pnm_writer: the image can not be written");
+        }
+    }
+
+  private:
+    std::unique_ptr<std::ostream> _out;
+    std::vector<uint16_t> _swapped;
+};
+
+/**
+ * @brief pnm codec class
+ * pgm and ppm images, files *.pgm, *.ppm and *.pnm.
+ */
+class pnm_codec : public codec {
+  public:
+    std::string_view name() const override { return "pnm"; }
+
+    bool handles(std::string_view extension) const override {
+        return extension == "pgm" || extension == "ppm" || extension == "pnm";
+    }
+
+    bool recognizes(std::string_view signature) const override {
+        return signature.size() >= 2 && signature[0] == 'P' &&
+               std::string_view("2356").find(signature[1]) != std::string_view::npos;
+    }
+
+    std::unique_ptr<image_reader> reader(std::unique_ptr<std::istream> in) const override {
+        return std::make_unique<pnm_reader>(std::move(in));
+    }
+
+    std::unique_ptr<image_writer> writer(std::unique_ptr<std::ostream> out,
+                                         const image_info& info) const override {
+        return std::make_unique<pnm_writer>(std::move(out), info);
+    }
+};
+
+/**
+ * @brief mapped image class
+ * Read only view of an image file, memory mapped where the platform allows it(see
+ * mapped_file), so the pages of a scan larger than memory are only loaded when its pixels
+ * are read. The file is either raw pixels of T, in the byte order of the machine, or a
+ * binary pgm or ppm image of 8 bit samples, viewed as info().samples() pixels a row.
+ * @tparam T the type of the pixels
+ */
+template <typename T> class mapped_image {
+  public:
+    /**
+     * @brief Construct a new mapped image object over raw pixels
+     * @param path the file
+     * @param height the rows of the image
+     * @param width the pixels of a row
+     * @param offset the bytes before the first pixel. Default = 0
+     * Throws std::runtime_error if the file can not be mapped or is too short, and
+     * std::invalid_argument if the pixels are not aligned for T.
+     */
+    mapped_image(const std::string& path, size_t height, size_t width, size_t offset = 0)
+        : _file(std::make_unique<mapped_file>(path, file_access::random)) {
+        _info = image_info{height, width, 1, unsigned(8 * sizeof(T))};
+        _map(offset);
+    }
+
+    /**
+     * @brief Construct a new mapped image object over a binary pgm or ppm image
+     * @param path the file
+     * Throws std::runtime_error if the file can not be mapped, is not a binary image of 8
+     * bit samples or is too short.
+     */
+    explicit mapped_image(const std::string& path)
+        requires std::is_same_v<T, uint8_t>
+        : _file(std::make_unique<mapped_file>(path, file_access::random)) {
+        const std::string_view bytes = _file->view();
+        size_t i = 0;
+        const _pnm_utils::header h = _pnm_utils::parse([&]() {
+            return i < bytes.size() ? int(static_cast<unsigned char>(bytes[i++])) : -1;
+        });
+        if (!h.binary || h.info.depth != 8) {
+            throw std::runtime_error("mapped_image: " + path +
+                                     " is not a binary image of 8 bit samples");
+        }
+        _info = h.info;
+        _map(h.data_at);
+    }
+
+    const image_info& info() const { return _info; }
+    size_t height() const { return _info.height; }
+    size_t width() const { return _info.samples(); }
+
+    /**
+     * @brief view function
+     * @return image_view<const T>: the pixels, valid as long as the mapped image
+     */
+    image_view<const T> view() const { return _view; }
+
+  private:
+    std::unique_ptr<mapped_file> _file;
+    image_info _info;
+    image_view<const T> _view;
+
+    void _map(size_t offset) {
+        const std::string_view bytes = _file->view();
+        const size_t n = _info.height * _info.samples();
+        if (offset > bytes.size() || (bytes.size() - offset) / sizeof(T) < n) {
+            throw std::runtime_error("mapped_image: the file is too short for the image");
+        }
+        const char* data = bytes.data() + offset;
+        if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0) {
+            throw std::invalid_argument("mapped_image: the pixels are not aligned");
+        }
+        _view = image_view<const T>(reinterpret_cast<const T*>(data), _info.height,
+                                    _info.samples(), _info.samples());
+    }
+};
+
+#endif
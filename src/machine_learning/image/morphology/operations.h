@@ -1,12 +1,227 @@
 #ifndef DILATION_H
 #define DILATION_H
 
+#include "../../../helpers/parallel.h"
+#include "../image_buffer.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 #include "../image.h"
 #endif
 
+namespace _morphology_utils {
+template <typename T> struct min_op {
+    T operator()(T a, T b) const { return b < a ? b : a; }
+    static constexpr T neutral() { return std::numeric_limits<T>::max(); }
+};
+
+template <typename T> struct max_op {
+    T operator()(T a, T b) const { return a < b ? b : a; }
+    static constexpr T neutral() { return std::numeric_limits<T>::lowest(); }
+};
+
+/**
+ * @brief out[x] = op of f[x - anchor, x - anchor + k) for x in [0, n), the values off f
+ * being the neutral of op, by van Herk / Gil-Werman: the padded line is cut in blocks of k,
+ * g holds the op of every block up to each value and h from each value to the end of its
+ * block, and every window, which covers the end of one block and the start of the next, is
+ * op(h[x], g[x + k - 1]): three ops per value whatever k.
+ */
+template <typename T, typename Op>
+void van_herk(const T* f, size_t n, size_t k, size_t anchor, Op op, T* out, std::vector<T>& g,
+              std::vector<T>& h) {
+    const size_t m = n + k - 1;
+    g.resize(m);
+    h.resize(m);
+    std::fill(g.begin(), g.begin() + std::min(anchor, m), Op::neutral());
+    std::copy(f, f + n, g.begin() + anchor);
+    std::fill(g.begin() + anchor + n, g.end(), Op::neutral());
+    std::copy(g.begin(), g.end(), h.begin());
+    for (size_t start = 0; start < m; start += k) {
+        const size_t end = std::min(m, start + k);
+        for (size_t i = start + 1; i < end; i++) {
+            g[i] = op(g[i - 1], g[i]);
+        }
+        for (size_t i = end - 1; i-- > start;) {
+            h[i] = op(h[i + 1], h[i]);
+        }
+    }
+    for (size_t x = 0; x < n; x++) {
+        out[x] = op(h[x], g[x + k - 1]);
+    }
+}
+
+/**
+ * @brief van_herk down the columns [0, cols) of n rows, stride values apart: every row of out
+ * is op of the k rows of in from anchor rows above it. The ops run along whole rows, so they
+ * vectorize across the columns.
+ */
+template <typename T, typename Op>
+void van_herk_rows(const T* in, size_t in_stride, T* out, size_t out_stride, size_t n,
+                   size_t cols, size_t k, size_t anchor, Op op, std::vector<T>& g,
+                   std::vector<T>& h) {
+    const size_t m = n + k - 1;
+    g.resize(m * cols);
+    h.resize(m * cols);
+    for (size_t i = 0; i < m; i++) {
+        T* gi = g.data() + i * cols;
+        if (i < anchor || i - anchor >= n) {
+            std::fill(gi, gi + cols, Op::neutral());
+        } else {
+            std::copy(in + (i - anchor) * in_stride, in + (i - anchor) * in_stride + cols, gi);
+        }
+    }
+    std::copy(g.begin(), g.end(), h.begin());
+    for (size_t start = 0; start < m; start += k) {
+        const size_t end = std::min(m, start + k);
+        for (size_t i = start + 1; i < end; i++) {
+            T* gi = g.data() + i * cols;
+            const T* prev = gi - cols;
+            for (size_t x = 0; x < cols; x++) {
+                gi[x] = op(prev[x], gi[x]);
+            }
+        }
+        for (size_t i = end - 1; i-- > start;) {
+            T* hi = h.data() + i * cols;
+            const T* next = hi + cols;
+            for (size_t x = 0; x < cols; x++) {
+                hi[x] = op(next[x], hi[x]);
+            }
+        }
+    }
+    for (size_t y = 0; y < n; y++) {
+        const T* hy = h.data() + y * cols;
+        const T* gy = g.data() + (y + k - 1) * cols;
+        T* o = out + y * out_stride;
+        for (size_t x = 0; x < cols; x++) {
+            o[x] = op(hy[x], gy[x]);
+        }
+    }
+}
+
+// the columns of a strip of van_herk_rows, a few cache lines of every row
+template <typename T> constexpr size_t strip_cols = std::max<size_t>(16, 256 / sizeof(T));
+
+inline void check_element(size_t height, size_t width, const char* who) {
+    if (height == 0 || width == 0) {
+        throw std::invalid_argument(std::string(who) +
+                                    ": the structuring element must not be empty");
+    }
+}
+
+/**
+ * @brief op of the height x width rectangle around every pixel of src, its pixel (height / 2,
+ * width / 2) on the pixel, the pixels off the image left out: a van Herk pass along every
+ * row, then one down strips of columns, each on several threads
+ */
+template <typename T, typename Op>
+void rectangle(image_view<const T> src, image_view<T> dst, size_t height, size_t width,
+               size_t threads, const char* who) {
+    check_element(height, width, who);
+    if (src.height() != dst.height() || src.width() != dst.width()) {
+        throw std::invalid_argument(std::string(who) + ": the images must have the same shape");
+    }
+    const size_t h = src.height(), w = src.width();
+    if (h == 0 || w == 0) {
+        return;
+    }
+    image_buffer<T> rows(h, w);
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        std::vector<T> g, f;
+        for (size_t y = lo; y < hi; y++) {
+            van_herk(src.row(y), w, width, width / 2, Op(), rows.row(y), g, f);
+        }
+    });
+    const size_t strip = strip_cols<T>, strips = (w + strip - 1) / strip;
+    PARALLEL::parallel_for(0, strips, threads, [&](size_t lo, size_t hi, size_t) {
+        std::vector<T> g, f;
+        for (size_t s = lo; s < hi; s++) {
+            const size_t x = s * strip, cols = std::min(strip, w - x);
+            van_herk_rows(rows.row(0) + x, rows.stride(), dst.row(0) + x, dst.stride(), h,
+                          cols, height, height / 2, Op(), g, f);
+        }
+    });
+}
+
+struct and_op {
+    uint64_t operator()(uint64_t a, uint64_t b) const { return a & b; }
+    static constexpr uint64_t neutral() { return ~uint64_t(0); }
+};
+
+struct or_op {
+    uint64_t operator()(uint64_t a, uint64_t b) const { return a | b; }
+    static constexpr uint64_t neutral() { return 0; }
+};
+
+/**
+ * @brief bit x of out = bit x + s of the in_width bits of in(s may be negative), the bits
+ * off in being fill, for the out_width bits of out. Whole words are shifted at a time.
+ */
+inline void shift_bits(const uint64_t* in, size_t in_width, long s, bool fill, uint64_t* out,
+                       size_t out_width) {
+    const size_t in_words = (in_width + 63) / 64, out_words = (out_width + 63) / 64;
+    const uint64_t pad = fill ? ~uint64_t(0) : 0;
+    const uint64_t valid = in_width % 64 ? (uint64_t(1) << (in_width % 64)) - 1 : ~uint64_t(0);
+    auto word = [&](long j) {
+        if (j < 0 || j >= long(in_words)) {
+            return pad;
+        }
+        return j == long(in_words) - 1 ? (in[j] & valid) | (pad & ~valid) : in[j];
+    };
+    const long q = s >= 0 ? s / 64 : -((-s + 63) / 64), r = s - 64 * q;
+    for (size_t i = 0; i < out_words; i++) {
+        const long j = long(i) + q;
+        out[i] = r ? (word(j) >> r) | (word(j + 1) << (64 - r)) : word(j);
+    }
+}
+
+/**
+ * @brief op of the bits x - anchor to x - anchor + k - 1 of a row of width bits, into the
+ * width bits of out: the row, shifted by the anchor into a row of width + k - 1 bits padded
+ * with the neutral of op, is combined with itself shifted by 1, 2, 4... bits, and the
+ * windows of the powers of two in k with each other, O(log k) word ops per 64 pixels
+ */
+template <typename Op>
+void bit_window(const uint64_t* row, size_t width, size_t k, size_t anchor, Op op,
+                std::vector<uint64_t>& p, std::vector<uint64_t>& t, std::vector<uint64_t>& res,
+                uint64_t* out) {
+    const bool fill = Op::neutral() != 0;
+    const size_t ext = width + k - 1, words = (ext + 63) / 64;
+    p.resize(words);
+    t.resize(words);
+    res.assign(words, Op::neutral());
+    shift_bits(row, width, -long(anchor), fill, p.data(), ext);
+    size_t off = 0;
+    for (size_t m = 1, left = k; left; m *= 2, left /= 2) {
+        if (left & 1) {
+            shift_bits(p.data(), ext, long(off), fill, t.data(), ext);
+            for (size_t i = 0; i < words; i++) {
+                res[i] = op(res[i], t[i]);
+            }
+            off += m;
+        }
+        if (left > 1) {
+            shift_bits(p.data(), ext, long(m), fill, t.data(), ext);
+            for (size_t i = 0; i < words; i++) {
+                p[i] = op(p[i], t[i]);
+            }
+        }
+    }
+    shift_bits(res.data(), ext, 0, false, out, width);
+    if (width % 64) {
+        out[(width - 1) / 64] &= (uint64_t(1) << (width % 64)) - 1;
+    }
+}
+} // namespace _morphology_utils
+
 namespace morphology_operations {
 /**
  * @brief dilate function. Performs dilation to the passed image
@@ -85,6 +300,276 @@ inline std::vector<std::vector<int32_t>> close(const std::vector<std::vector<int
     resulted_img = erote(resulted_img);
     return resulted_img;
 }
+
+/**
+ * @brief erode function: the smallest pixel of the height x width rectangle around every
+ * pixel of src, by van Herk / Gil-Werman in O(1) per pixel whatever the rectangle. A 1 x n
+ * or n x 1 rectangle is a linear element. The pixels off the image are left out.
+ * @param src the image
+ * @param dst set to the eroded image, of the shape of src. It may be src.
+ * @param height the rows of the structuring element, centered on row height / 2
+ * @param width the columns of the structuring element, centered on column width / 2
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the images have different shapes or the element is empty.
+ */
+template <typename T>
+void erode(std::type_identity_t<image_view<const T>> src, image_view<T> dst, size_t height,
+           size_t width, size_t threads = 1) {
+    _morphology_utils::rectangle<T, _morphology_utils::min_op<T>>(src, dst, height, width,
+                                                                  threads, "erode");
+}
+
+/**
+ * @brief dilate function: the largest pixel of the height x width rectangle around every
+ * pixel of src, by van Herk / Gil-Werman in O(1) per pixel, see erode
+ * @param src the image
+ * @param dst set to the dilated image, of the shape of src. It may be src.
+ * @param height the rows of the structuring element, centered on row height / 2
+ * @param width the columns of the structuring element, centered on column width / 2
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T>
+void dilate(std::type_identity_t<image_view<const T>> src, image_view<T> dst, size_t height,
+            size_t width, size_t threads = 1) {
+    _morphology_utils::rectangle<T, _morphology_utils::max_op<T>>(src, dst, height, width,
+                                                                  threads, "dilate");
+}
+
+/**
+ * @brief opening function: the erosion then the dilation of src by the same rectangle, which
+ * removes the bright details smaller than it
+ * @param src the image
+ * @param dst set to the opened image, of the shape of src. It may be src.
+ * @param height the rows of the structuring element
+ * @param width the columns of the structuring element
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T>
+void opening(std::type_identity_t<image_view<const T>> src, image_view<T> dst, size_t height,
+             size_t width, size_t threads = 1) {
+    erode<T>(src, dst, height, width, threads);
+    dilate<T>(dst, dst, height, width, threads);
+}
+
+/**
+ * @brief closing function: the dilation then the erosion of src by the same rectangle, which
+ * fills the dark details smaller than it
+ * @param src the image
+ * @param dst set to the closed image, of the shape of src. It may be src.
+ * @param height the rows of the structuring element
+ * @param width the columns of the structuring element
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T>
+void closing(std::type_identity_t<image_view<const T>> src, image_view<T> dst, size_t height,
+             size_t width, size_t threads = 1) {
+    dilate<T>(src, dst, height, width, threads);
+    erode<T>(dst, dst, height, width, threads);
+}
+
+/**
+ * @brief top_hat function: src minus its opening, the bright details smaller than the
+ * rectangle
+ * @param src the image
+ * @param dst set to the top-hat of src, of the shape of src. It may be src.
+ * @param height the rows of the structuring element
+ * @param width the columns of the structuring element
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T>
+void top_hat(std::type_identity_t<image_view<const T>> src, image_view<T> dst, size_t height,
+             size_t width, size_t threads = 1) {
+    image_buffer<T> opened(src.height(), src.width());
+    opening<T>(src, opened.view(), height, width, threads);
+    if (src.data() != dst.data()) {
+        src.copy_to(dst);
+    }
+    dst.sub(opened.view());
+}
+
+/**
+ * @brief black_hat function: the closing of src minus src, the dark details smaller than the
+ * rectangle
+ * @param src the image
+ * @param dst set to the black-hat of src, of the shape of src. It may be src.
+ * @param height the rows of the structuring element
+ * @param width the columns of the structuring element
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ */
+template <typename T>
+void black_hat(std::type_identity_t<image_view<const T>> src, image_view<T> dst, size_t height,
+               size_t width, size_t threads = 1) {
+    image_buffer<T> closed(src.height(), src.width());
+    closing<T>(src, closed.view(), height, width, threads);
+    closed.sub(src);
+    closed.view().copy_to(dst);
+}
+/**
+ * @brief bit image class
+ * A height x width binary image packed 64 pixels to a word, pixel x of a row being bit
+ * x % 64 of its word x / 64, so that the binary morphology works on whole words. The bits
+ * past the width of a row are always 0.
+ */
+class bit_image {
+  public:
+    bit_image() = default;
+
+    /**
+     * @brief Construct a new bit image object, every pixel off
+     */
+    bit_image(size_t height, size_t width)
+        : _height(height), _width(width), _words((width + 63) / 64), _bits(height * _words) {}
+
+    /**
+     * @brief Construct a new bit image object
+     * @param img the image to binarize
+     * @param level the smallest value of the pixels set. Default = 1, every nonzero pixel
+     */
+    template <typename T>
+    explicit bit_image(image_view<T> img, double level = 1) : bit_image(img.height(), img.width()) {
+        for (size_t y = 0; y < _height; y++) {
+            const auto* s = img.row(y);
+            uint64_t* d = row(y);
+            for (size_t x = 0; x < _width; x++) {
+                d[x / 64] |= uint64_t(double(s[x]) >= level) << (x % 64);
+            }
+        }
+    }
+
+    size_t height() const { return _height; }
+    size_t width() const { return _width; }
+
+    /**
+     * @brief words function
+     * @return size_t: the words of a row
+     */
+    size_t words() const { return _words; }
+
+    uint64_t* row(size_t y) { return _bits.data() + y * _words; }
+    const uint64_t* row(size_t y) const { return _bits.data() + y * _words; }
+
+    bool operator()(size_t y, size_t x) const { return row(y)[x / 64] >> (x % 64) & 1; }
+
+    /**
+     * @brief set function
+     * @param y the row of the pixel
+     * @param x the column of the pixel
+     * @param on the value of the pixel. Default = true
+     */
+    void set(size_t y, size_t x, bool on = true) {
+        const uint64_t bit = uint64_t(1) << (x % 64);
+        row(y)[x / 64] = on ? row(y)[x / 64] | bit : row(y)[x / 64] & ~bit;
+    }
+
+    /**
+     * @brief count function
+     * @return size_t: the number of pixels set
+     */
+    size_t count() const {
+        size_t n = 0;
+        for (uint64_t w : _bits) {
+            n += size_t(std::popcount(w));
+        }
+        return n;
+    }
+
+    /**
+     * @brief to_buffer function
+     * @param on the value of the pixels set, the others being 0. Default = 255
+     * @return image_buffer<T>: the image of the pixels
+     */
+    template <typename T = uint8_t> image_buffer<T> to_buffer(T on = 255) const {
+        image_buffer<T> img(_height, _width);
+        for (size_t y = 0; y < _height; y++) {
+            for (size_t x = 0; x < _width; x++) {
+                img(y, x) = (*this)(y, x) ? on : T(0);
+            }
+        }
+        return img;
+    }
+
+    bool operator==(const bit_image& other) const = default;
+
+  private:
+    size_t _height{0}, _width{0}, _words{0};
+    std::vector<uint64_t> _bits;
+};
+} // namespace morphology_operations
+
+namespace _morphology_utils {
+/**
+ * @brief the height x width rectangle of op around every pixel of a bit_image: a pass of
+ * word shifts along every row, then a van Herk pass of whole words down the rows
+ */
+template <typename Op>
+morphology_operations::bit_image bit_rectangle(const morphology_operations::bit_image& src,
+                                               size_t height, size_t width, size_t threads,
+                                               const char* who) {
+    check_element(height, width, who);
+    const size_t h = src.height(), words = src.words();
+    morphology_operations::bit_image rows(h, src.width()), out(h, src.width());
+    if (h == 0 || words == 0) {
+        return out;
+    }
+    PARALLEL::parallel_for(0, h, threads, [&](size_t lo, size_t hi, size_t) {
+        std::vector<uint64_t> p, t, res;
+        for (size_t y = lo; y < hi; y++) {
+            bit_window(src.row(y), src.width(), width, width / 2, Op(), p, t, res, rows.row(y));
+        }
+    });
+    const size_t strip = strip_cols<uint64_t>, strips = (words + strip - 1) / strip;
+    PARALLEL::parallel_for(0, strips, threads, [&](size_t lo, size_t hi, size_t) {
+        std::vector<uint64_t> g, f;
+        for (size_t s = lo; s < hi; s++) {
+            const size_t x = s * strip, cols = std::min(strip, words - x);
+            van_herk_rows(rows.row(0) + x, words, out.row(0) + x, words, h, cols, height,
+                          height / 2, Op(), g, f);
+        }
+    });
+    return out;
+}
+} // namespace _morphology_utils
+
+namespace morphology_operations {
+/**
+ * @brief erode function for binary images: the pixels whose whole height x width rectangle
+ * is set, the pixels off the image left out, 64 pixels per word operation
+ * @param img the binary image
+ * @param height the rows of the structuring element, centered on row height / 2
+ * @param width the columns of the structuring element, centered on column width / 2
+ * @param threads number of threads(0 means every hardware thread). Default = 1
+ * @return bit_image: the eroded image. Throws std::invalid_argument if the element is empty.
+ */
+inline bit_image erode(const bit_image& img, size_t height, size_t width, size_t threads = 1) {
+    return _morphology_utils::bit_rectangle<_morphology_utils::and_op>(img, height, width,
+                                                                        threads, "erode");
+}
+
+/**
+ * @brief dilate function for binary images: the pixels with a pixel set in their height x
+ * width rectangle, see erode
+ * @return bit_image: the dilated image
+ */
+inline bit_image dilate(const bit_image& img, size_t height, size_t width, size_t threads = 1) {
+    return _morphology_utils::bit_rectangle<_morphology_utils::or_op>(img, height, width,
+                                                                       threads, "dilate");
+}
+
+/**
+ * @brief opening function for binary images: the erosion then the dilation of img
+ * @return bit_image: the opened image
+ */
+inline bit_image opening(const bit_image& img, size_t height, size_t width, size_t threads = 1) {
+    return dilate(erode(img, height, width, threads), height, width, threads);
+}
+
+/**
+ * @brief closing function for binary images: the dilation then the erosion of img
+ * @return bit_image: the closed image
+ */
+inline bit_image closing(const bit_image& img, size_t height, size_t width, size_t threads = 1) {
+    return erode(dilate(img, height, width, threads), height, width, threads);
+}
 } // namespace morphology_operations
 
 #endif
@@ -0,0 +1,479 @@
+#ifndef TILE_PIPELINE_H
+#define TILE_PIPELINE_H
+
+#include "../../helpers/thread_pool.h"
+#include "../../helpers/trace.h"
+#include "filters/convolution.h"
+#include "image_buffer.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * @brief options of tile_pipeline::run
+ * @param tile_height the rows of the output tiles. Default = 64
+ * @param tile_width the columns of the output tiles. Default = 256, so that the float
+ * intermediates of a tile stay in the L2 cache
+ * @param border the pixels every stage reads outside of the image. Default = replicate
+ * @param threads the number of chunks of tiles to run on PARALLEL::thread_pool::shared(),
+ * 0 for one per thread of the pool. Default = 0
+ */
+struct tile_options {
+    size_t tile_height = 64;
+    size_t tile_width = 256;
+    convolution::border_mode border = convolution::border_mode::replicate;
+    size_t threads = 0;
+};
+
+/**
+ * @brief one filter of a tile_pipeline
+ * apply(in, out) fills out from in, which has halo more pixels than out on every side:
+ * out(y, x) may read in(y + i, x + j) for i and j in [0, 2 halo]. The borders are not the
+ * stage's concern, the pipeline fills in the pixels off the image.
+ */
+struct tile_stage {
+    size_t halo = 0;
+    std::function<void(image_view<const float>, image_view<float>)> apply;
+};
+
+namespace _tile_pipeline_utils {
+inline long clamp(long i, long n) { return i < 0 ? 0 : i >= n ? n - 1 : i; }
+
+/**
+ * @brief a rectangle of the image, in the coordinates of the image
+ */
+struct region {
+    long y = 0, x = 0;
+    size_t height = 0, width = 0;
+
+    /**
+     * @brief the region grown by halo on every side, clipped to a height x width image
+     */
+    region grown(size_t halo, size_t h, size_t w) const {
+        const long hy = std::max(0L, y - long(halo)), hx = std::max(0L, x - long(halo));
+        const long ey = std::min(long(h), y + long(height + halo));
+        const long ex = std::min(long(w), x + long(width + halo));
+        return region{hy, hx, size_t(ey - hy), size_t(ex - hx)};
+    }
+};
+
+/**
+ * @brief a height x width view of buf, grown if it is smaller
+ */
+inline image_view<float> scratch(image_buffer<float>& buf, size_t height, size_t width) {
+    if (buf.height() < height || buf.width() < width) {
+        buf = image_buffer<float>(std::max(buf.height(), height), std::max(buf.width(), width));
+    }
+    return buf.roi(0, 0, height, width);
+}
+
+/**
+ * @brief copies the pixels of r to to, from the pixels of from that start at the pixel
+ * (fy, fx) of a h x w image, the pixels of r off the image given by border
+ */
+template <typename T>
+void gather(image_view<const T> from, long fy, long fx, const region& r, size_t h, size_t w,
+            convolution::border_mode border, image_view<float> to) {
+    const bool zero = border == convolution::border_mode::zero;
+    for (size_t i = 0; i < r.height; i++) {
+        float* d = to.row(i);
+        const long y = r.y + long(i);
+        if (zero && (y < 0 || y >= long(h))) {
+            std::fill(d, d + r.width, 0.0f);
+            continue;
+        }
+        const T* s = from.row(size_t(clamp(y, long(h)) - fy));
+        for (size_t j = 0; j < r.width; j++) {
+            const long x = r.x + long(j);
+            if (x < 0 || x >= long(w)) {
+                d[j] = zero ? 0.0f : float(s[clamp(x, long(w)) - fx]);
+            } else {
+                d[j] = float(s[x - fx]);
+            }
+        }
+    }
+}
+
+// rows[i] = in.row(y + i) + x for the kh rows of a kernel
+inline void rows_at(image_view<const float> in, size_t y, size_t x, size_t kh,
+                    std::vector<const float*>& rows) {
+    rows.resize(kh);
+    for (size_t i = 0; i < kh; i++) {
+        rows[i] = in.row(y + i) + x;
+    }
+}
+} // namespace _tile_pipeline_utils
+
+/**
+ * @brief tile stages namespace
+ * The stages a tile_pipeline chains. All of them take and give float pixels, the pipeline
+ * converting the source and saturating the result to the types of the images it runs on.
+ */
+namespace tile_stages {
+/**
+ * @brief separable function
+ * @param col the vertical kernel, of odd size
+ * @param row the horizontal kernel, of odd size
+ * @return tile_stage: the correlation with col[i] * row[j] as two 1D passes, as
+ * convolution::sep_filter2d. Throws std::invalid_argument if a kernel has an even size.
+ */
+inline tile_stage separable(std::vector<float> col, std::vector<float> row) {
+    if (col.size() % 2 == 0 || row.size() % 2 == 0) {
+        throw std::invalid_argument("tile_stages::separable: the kernels must have an odd size");
+    }
+    const size_t ry = col.size() / 2, rx = row.size() / 2, halo = std::max(ry, rx);
+    auto apply = [col = std::move(col), row = std::move(row), ry, rx,
+                  halo](image_view<const float> in, image_view<float> out) {
+        const size_t h = out.height(), w = out.width();
+        // the rows of out and the ry above and below it, filtered along the rows
+        image_buffer<float> horizontal(h + 2 * ry, w);
+        for (size_t y = 0; y < h + 2 * ry; y++) {
+            const float* r = in.row(halo - ry + y) + halo - rx;
+            _convolution_utils::correlate(&r, 1, row.data(), row.size(), w, horizontal.row(y));
+        }
+        std::vector<const float*> rows;
+        for (size_t y = 0; y < h; y++) {
+            _tile_pipeline_utils::rows_at(horizontal.view(), y, 0, col.size(), rows);
+            _convolution_utils::correlate(rows.data(), col.size(), col.data(), 1, w, out.row(y));
+        }
+    };
+    return tile_stage{halo, apply};
+}
+
+/**
+ * @brief filter function
+ * @param kernel the kh x kw taps, both of odd size
+ * @return tile_stage: the correlation with kernel, as convolution::filter2d, run as two 1D
+ * passes if kernel is separable. Throws std::invalid_argument if a side has an even size.
+ */
+inline tile_stage filter(const Matrix<float>& kernel) {
+    const size_t kh = kernel.rows(), kw = kernel.cols();
+    if (kh % 2 == 0 || kw % 2 == 0) {
+        throw std::invalid_argument("tile_stages::filter: the kernel must have sides of odd size");
+    }
+    std::vector<float> col, row;
+    if (kh * kw > 1 && convolution::separable(kernel, col, row)) {
+        return separable(std::move(col), std::move(row));
+    }
+    const size_t halo = std::max(kh, kw) / 2;
+    auto apply = [kernel, kh, kw, halo](image_view<const float> in, image_view<float> out) {
+        std::vector<const float*> rows;
+        for (size_t y = 0; y < out.height(); y++) {
+            _tile_pipeline_utils::rows_at(in, y + halo - kh / 2, halo - kw / 2, kh, rows);
+            _convolution_utils::correlate(rows.data(), kh, kernel.data(), kw, out.width(),
+                                          out.row(y));
+        }
+    };
+    return tile_stage{halo, apply};
+}
+
+/**
+ * @brief gaussian function
+ * @param sigma the standard deviation of the blur, in pixels
+ * @return tile_stage: the blur of convolution::gaussian_kernel(sigma) along both axes
+ */
+inline tile_stage gaussian(double sigma) {
+    std::vector<float> taps = convolution::gaussian_kernel(sigma);
+    return separable(taps, taps);
+}
+
+/**
+ * @brief box function
+ * @param size the side of the box, odd
+ * @return tile_stage: the mean of the size x size pixels around every pixel
+ */
+inline tile_stage box(size_t size) {
+    std::vector<float> taps(size, 1.0f / float(size));
+    return separable(taps, taps);
+}
+
+/**
+ * @brief gradient function
+ * @param gx the 3x3 horizontal derivative
+ * @param gy the 3x3 vertical derivative
+ * @return tile_stage: the magnitude sqrt(gx^2 + gy^2) of the two correlations
+ */
+inline tile_stage gradient(const Matrix<float>& gx, const Matrix<float>& gy) {
+    if (gx.rows() != 3 || gx.cols() != 3 || gy.rows() != 3 || gy.cols() != 3) {
+        throw std::invalid_argument("tile_stages::gradient: the kernels must be 3x3");
+    }
+    auto apply = [gx, gy](image_view<const float> in, image_view<float> out) {
+        const size_t w = out.width();
+        std::vector<const float*> rows;
+        std::vector<float> dy(w);
+        for (size_t y = 0; y < out.height(); y++) {
+            _tile_pipeline_utils::rows_at(in, y, 0, 3, rows);
+            float* dx = out.row(y);
+            _convolution_utils::correlate(rows.data(), 3, gx.data(), 3, w, dx);
+            _convolution_utils::correlate(rows.data(), 3, gy.data(), 3, w, dy.data());
+            for (size_t x = 0; x < w; x++) {
+                dx[x] = std::sqrt(dx[x] * dx[x] + dy[x] * dy[x]);
+            }
+        }
+    };
+    return tile_stage{1, apply};
+}
+
+/**
+ * @brief sobel function
+ * @return tile_stage: the gradient magnitude of the kernels of sobel::kernel()
+ */
+inline tile_stage sobel() {
+    return gradient(Matrix<float>(std::vector<std::vector<float>>{{1, 0, -1}, {2, 0, -2},
+                                                                  {1, 0, -1}}),
+                    Matrix<float>(std::vector<std::vector<float>>{{1, 2, 1}, {0, 0, 0},
+                                                                  {-1, -2, -1}}));
+}
+
+/**
+ * @brief prewitt function
+ * @return tile_stage: the gradient magnitude of the kernels of prewitt::Prewitt
+ */
+inline tile_stage prewitt() {
+    return gradient(Matrix<float>(std::vector<std::vector<float>>{{-1, -1, -1}, {0, 0, 0},
+                                                                  {1, 1, 1}}),
+                    Matrix<float>(std::vector<std::vector<float>>{{-1, 0, 1}, {-1, 0, 1},
+                                                                  {-1, 0, 1}}));
+}
+
+/**
+ * @brief laplacian function
+ * @return tile_stage: the correlation with the 3x3 laplacian mask of laplacian_detection
+ */
+inline tile_stage laplacian() {
+    return filter(Matrix<float>(
+        std::vector<std::vector<float>>{{-1, -1, -1}, {-1, 8, -1}, {-1, -1, -1}}));
+}
+
+/**
+ * @brief pointwise function
+ * @param f the callable giving every output pixel from its input pixel, f(float) -> float
+ * @return tile_stage: f on every pixel, without halo
+ */
+template <typename F> tile_stage pointwise(F f) {
+    auto apply = [f](image_view<const float> in, image_view<float> out) {
+        for (size_t y = 0; y < out.height(); y++) {
+            const float* s = in.row(y);
+            float* d = out.row(y);
+            for (size_t x = 0; x < out.width(); x++) {
+                d[x] = float(f(s[x]));
+            }
+        }
+    };
+    return tile_stage{0, apply};
+}
+
+/**
+ * @brief threshold function
+ * @param level the smallest value set to above
+ * @param below the value of the pixels under level. Default = 0
+ * @param above the value of the other pixels. Default = 255
+ * @return tile_stage: the binary image of the pixels of at least level
+ */
+inline tile_stage threshold(float level, float below = 0, float above = 255) {
+    return pointwise([=](float v) { return v >= level ? above : below; });
+}
+
+namespace _detail {
+// the largest(or smallest) of the (2 radius + 1)^2 pixels around every pixel, along the rows
+// then along the columns
+template <bool Max> tile_stage extremum(size_t radius) {
+    auto apply = [radius](image_view<const float> in, image_view<float> out) {
+        const size_t h = out.height(), w = out.width(), k = 2 * radius + 1;
+        auto pick = [](float a, float b) { return Max ? (a < b ? b : a) : (b < a ? b : a); };
+        image_buffer<float> horizontal(h + 2 * radius, w);
+        for (size_t y = 0; y < h + 2 * radius; y++) {
+            const float* s = in.row(y);
+            float* d = horizontal.row(y);
+            std::copy(s, s + w, d);
+            for (size_t j = 1; j < k; j++) {
+                for (size_t x = 0; x < w; x++) {
+                    d[x] = pick(d[x], s[x + j]);
+                }
+            }
+        }
+        for (size_t y = 0; y < h; y++) {
+            float* d = out.row(y);
+            std::copy(horizontal.row(y), horizontal.row(y) + w, d);
+            for (size_t i = 1; i < k; i++) {
+                const float* s = horizontal.row(y + i);
+                for (size_t x = 0; x < w; x++) {
+                    d[x] = pick(d[x], s[x]);
+                }
+            }
+        }
+    };
+    return tile_stage{radius, apply};
+}
+} // namespace _detail
+
+/**
+ * @brief dilate function
+ * @param radius the half size of the square structuring element
+ * @return tile_stage: the largest of the (2 radius + 1)^2 pixels around every pixel
+ */
+inline tile_stage dilate(size_t radius) { return _detail::extremum<true>(radius); }
+
+/**
+ * @brief erode function
+ * @param radius the half size of the square structuring element
+ * @return tile_stage: the smallest of the (2 radius + 1)^2 pixels around every pixel
+ */
+inline tile_stage erode(size_t radius) { return _detail::extremum<false>(radius); }
+} // namespace tile_stages
+
+/**
+ * @brief tile pipeline class
+ * A chain of filters run tile by tile: every tile of the output is computed through all the
+ * stages before the next one starts, out of buffers of a few tiles that stay in cache, so
+ * the intermediate images are never written out whole. A tile is read from the source with
+ * the halos of all the stages around it, every stage giving the next one the tile grown by
+ * what is left of the halos, and tiles run in parallel on PARALLEL::thread_pool::shared().
+ * The result is the one of running the stages one after the other over the whole image,
+ * each with the border of the options: the pixels a stage reads off the image are filled in
+ * from its own input, as a whole image filter would.
+ */
+class tile_pipeline {
+  public:
+    /**
+     * @brief Construct a new tile pipeline object, with no stage
+     */
+    tile_pipeline() = default;
+
+    /**
+     * @brief then function
+     * @param stage the stage to run after the ones already added
+     * @return tile_pipeline&: *this, to chain the stages
+     */
+    tile_pipeline& then(tile_stage stage) {
+        if (!stage.apply) {
+            throw std::invalid_argument("tile_pipeline::then: the stage has no filter");
+        }
+        _halo += stage.halo;
+        _stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    /**
+     * @brief size function
+     * @return size_t: the number of stages
+     */
+    size_t size() const { return _stages.size(); }
+
+    /**
+     * @brief halo function
+     * @return size_t: the pixels of source read around every tile, the halos of all stages
+     */
+    size_t halo() const { return _halo; }
+
+    /**
+     * @brief run function
+     * Runs the stages tile by tile from src into dst, converting the source to float and
+     * saturating the result to the pixels of dst, rounded for integer pixels.
+     * @param src the source image
+     * @param dst the result, of the shape of src. It may not share pixels with src.
+     * @param opt the tiles, border and threads
+     * Throws std::invalid_argument if the images have different shapes or a tile is empty.
+     */
+    template <typename T, typename U>
+    void run(image_view<T> src, image_view<U> dst, const tile_options& opt = {}) const {
+        static_assert(!std::is_const_v<U>, "tile_pipeline::run: dst must be writable");
+        if (src.height() != dst.height() || src.width() != dst.width()) {
+            throw std::invalid_argument("tile_pipeline::run: the images must have the same shape");
+        }
+        if (opt.tile_height == 0 || opt.tile_width == 0) {
+            throw std::invalid_argument("tile_pipeline::run: the tiles must not be empty");
+        }
+        const size_t h = src.height(), w = src.width();
+        if (h == 0 || w == 0) {
+            return;
+        }
+        image_view<const std::remove_const_t<T>> in = src;
+        const size_t rows = (h + opt.tile_height - 1) / opt.tile_height;
+        const size_t cols = (w + opt.tile_width - 1) / opt.tile_width;
+        PARALLEL::thread_pool::shared().parallel_for(
+            0, rows * cols, opt.threads, [&](size_t lo, size_t hi, size_t) {
+                ALGOPLUS_TRACE_SPAN("tile_pipeline tiles");
+                image_buffer<float> buffers[3];
+                for (size_t t = lo; t < hi; t++) {
+                    const size_t y = t / cols * opt.tile_height, x = t % cols * opt.tile_width;
+                    _run_tile(in, dst,
+                              _tile_pipeline_utils::region{long(y), long(x),
+                                                           std::min(opt.tile_height, h - y),
+                                                           std::min(opt.tile_width, w - x)},
+                              opt.border, buffers);
+                }
+            });
+    }
+
+    /**
+     * @brief run function over image buffers, see run
+     */
+    template <typename T, typename U>
+    void run(const image_buffer<T>& src, image_buffer<U>& dst,
+             const tile_options& opt = {}) const {
+        run(src.view(), dst.view(), opt);
+    }
+
+  private:
+    std::vector<tile_stage> _stages;
+    size_t _halo{0};
+
+    // the tile through every stage, buffers[0] and [1] holding the input and the output of
+    // a stage in turn and buffers[2] the input of a stage with its pixels off the image
+    template <typename T, typename U>
+    void _run_tile(image_view<const T> src, image_view<U> dst,
+                   const _tile_pipeline_utils::region& tile, convolution::border_mode border,
+                   image_buffer<float>* buffers) const {
+        using namespace _tile_pipeline_utils;
+        const size_t h = src.height(), w = src.width();
+        size_t left = _halo;
+        region at = tile.grown(left, h, w);
+        image_view<const float> cur;
+        if constexpr (std::is_same_v<T, float>) {
+            cur = src.roi(size_t(at.y), size_t(at.x), at.height, at.width);
+        } else {
+            image_view<float> first = scratch(buffers[0], at.height, at.width);
+            gather(src, 0, 0, at, h, w, border, first);
+            cur = first;
+        }
+        for (size_t i = 0; i < _stages.size(); i++) {
+            const size_t halo = _stages[i].halo;
+            left -= halo;
+            const region next = tile.grown(left, h, w);
+            const region needed{next.y - long(halo), next.x - long(halo),
+                                next.height + 2 * halo, next.width + 2 * halo};
+            image_view<const float> input;
+            if (needed.y >= 0 && needed.x >= 0 && needed.y + long(needed.height) <= long(h) &&
+                needed.x + long(needed.width) <= long(w)) {
+                input = cur.roi(size_t(needed.y - at.y), size_t(needed.x - at.x),
+                                needed.height, needed.width);
+            } else {
+                image_view<float> padded = scratch(buffers[2], needed.height, needed.width);
+                gather(cur, at.y, at.x, needed, h, w, border, padded);
+                input = padded;
+            }
+            image_view<float> out = scratch(buffers[(i + 1) % 2], next.height, next.width);
+            ALGOPLUS_TRACE_SPAN("tile_pipeline stage");
+            _stages[i].apply(input, out);
+            cur = out;
+            at = next;
+        }
+        for (size_t y = 0; y < tile.height; y++) {
+            const float* s = cur.row(y);
+            U* d = dst.row(size_t(tile.y) + y) + tile.x;
+            for (size_t x = 0; x < tile.width; x++) {
+                d[x] = _image_buffer_utils::saturate<U>(s[x]);
+            }
+        }
+    }
+};
+
+#endif
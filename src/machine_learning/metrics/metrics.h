@@ -1,33 +1,46 @@
 #ifndef MEAN_SQUARED_ERROR_H
 #define MEAN_SQUARED_ERROR_H
 
+#include "../../helpers/parallel.h"
+#include "../../linalg/matrix.h"
+#include "../activation/activation_functions.h"
+
 #ifdef __cplusplus
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <numbers>
 #include <numeric>
+#include <span>
+#include <stdexcept>
+#include <tuple>
 #include <vector>
 #endif
 
 namespace _metrics_utils {
-inline double sigmoid(const double x) {
-    return 1.0 / (1.0 + exp(-x));
-}
+inline double sigmoid(const double x) { return activation::sigmoid(x); }
 
 inline std::vector<double> softmax(const std::vector<double>& logits) {
-    double sum_logits = 0;
-    for (const double& x : logits) {
-        sum_logits += exp(x);
-    }
+    return activation::softmax(logits);
+}
 
-    std::vector<double> probs;
-    for (const double& x : logits) {
-        probs.push_back(exp(x) / sum_logits);
+// out[i] = dist(x, row i of points) for the rows of points, on several threads
+template <typename F>
+void one_to_many(std::span<const double> x, const Matrix<double>& points, std::span<double> out,
+                 size_t threads, F&& dist) {
+    const size_t d = points.cols();
+    if (x.size() != d || out.size() != points.rows()) {
+        throw std::invalid_argument(
+            "metrics: x must have a value per column of points and out one per row");
     }
-
-    return probs;
+    threads = PARALLEL::resolve_threads(threads, points.size() / 65536 + 1);
+    PARALLEL::parallel_for(0, points.rows(), threads, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            out[i] = dist(x.data(), points.data() + i * d, d);
+        }
+    });
 }
 } // namespace _metrics_utils
 
@@ -38,6 +51,120 @@ inline std::vector<double> softmax(const std::vector<double>& logits) {
  */
 namespace metrics {
 
+/**
+ * @brief confusion matrix class
+ * The counts of a binary classification, accumulated in one pass over the labels, that
+ * every metric below is read from: a label 1 predicted 1 is a true positive, a label 0
+ * predicted 0 a true negative, a label 1 predicted otherwise a false negative and a label 0
+ * predicted otherwise a false positive, the other labels are not counted. Two matrices merge
+ * into the one of the union of their samples, so an evaluation can be split over threads
+ * or shards(see confusion()).
+ */
+class confusion_matrix {
+  public:
+    confusion_matrix() = default;
+
+    /**
+     * @brief Construct a new confusion matrix object with the samples of y and y_pred
+     */
+    confusion_matrix(std::span<const double> y, std::span<const double> y_pred) {
+        update(y, y_pred);
+    }
+
+    /**
+     * @brief update function
+     * @param y: the ground truth of a sample
+     * @param y_pred: its prediction
+     */
+    void update(double y, double y_pred) {
+        const bool hit = y_pred == y;
+        const uint64_t pos = y == 1, neg = y == 0;
+        _tp += pos & hit;
+        _fn += pos & !hit;
+        _tn += neg & hit;
+        _fp += neg & !hit;
+    }
+
+    /**
+     * @brief update function for a batch of samples
+     * @param y: the ground truth(span<double>)
+     * @param y_pred: the predictions, of the length of y
+     */
+    void update(std::span<const double> y, std::span<const double> y_pred) {
+        assert(y.size() == y_pred.size());
+        for (size_t i = 0; i < y.size(); i++) {
+            update(y[i], y_pred[i]);
+        }
+    }
+
+    /**
+     * @brief merge function
+     * @param other: the confusion matrix of other samples
+     * @return confusion_matrix&: this, with the counts of other added
+     */
+    confusion_matrix& merge(const confusion_matrix& other) {
+        _tp += other._tp;
+        _tn += other._tn;
+        _fp += other._fp;
+        _fn += other._fn;
+        return *this;
+    }
+
+    uint64_t true_positives() const { return _tp; }
+    uint64_t true_negatives() const { return _tn; }
+    uint64_t false_positives() const { return _fp; }
+    uint64_t false_negatives() const { return _fn; }
+
+    /**
+     * @brief accuracy function[(tp + tn) / (tp + tn + fp + fn)]
+     */
+    double accuracy() const { return double(_tp + _tn) / double(_tp + _tn + _fp + _fn); }
+
+    /**
+     * @brief precision function[tp / tp + fp]
+     */
+    double precision() const { return double(_tp) / double(_tp + _fp); }
+
+    /**
+     * @brief recall function[tp / tp + fn]
+     */
+    double recall() const { return double(_tp) / double(_tp + _fn); }
+
+    /**
+     * @brief f1 score function: [2 * precision * recall / precision + recall]
+     */
+    double f1_score() const {
+        double prec = precision(), rec = recall();
+        return 2.0 * (prec * rec) / (prec + rec);
+    }
+
+  private:
+    uint64_t _tp{0}, _tn{0}, _fp{0}, _fn{0};
+};
+
+/**
+ * @brief confusion function
+ * The confusion matrix of the samples, over ranges of them on several threads merged at the
+ * end.
+ * @param y: the ground truth(span<double>)
+ * @param y_pred: the predictions, of the length of y
+ * @param threads: number of threads(0 means every hardware thread). Default = 1
+ * @return confusion_matrix
+ */
+inline confusion_matrix confusion(std::span<const double> y, std::span<const double> y_pred,
+                                  size_t threads = 1) {
+    assert(y.size() == y_pred.size());
+    threads = PARALLEL::resolve_threads(threads, y.size() / 65536 + 1);
+    std::vector<confusion_matrix> part(threads);
+    PARALLEL::parallel_for(0, y.size(), threads, [&](size_t lo, size_t hi, size_t t) {
+        part[t].update(y.subspan(lo, hi - lo), y_pred.subspan(lo, hi - lo));
+    });
+    for (size_t t = 1; t < threads; t++) {
+        part[0].merge(part[t]);
+    }
+    return part[0];
+}
+
 namespace multi_metrics_ {
 /**
  * @brief multi metrics function. Returns tp, tn, fp, fn
@@ -47,21 +174,9 @@ namespace multi_metrics_ {
  */
 inline std::tuple<int, int, int, int> all_metrics_(const std::vector<double>& y,
                                                    const std::vector<double>& y_pred) {
-    assert(y.size() == y_pred.size());
-    int tp = 0, tn = 0, fp = 0, fn = 0;
-    for (size_t i = 0; i < y.size(); i++) {
-        if (y_pred[i] == y[i] && y[i] == 1) {
-            tp += 1;
-        } else if (y_pred[i] == y[i] && y[i] == 0) {
-            tn += 1;
-        } else if (y_pred[i] != y[i] && y[i] == 1) {
-            fn += 1;
-        } else if (y_pred[i] != y[i] && y[i] == 0) {
-            fp += 1;
-        }
-    }
-
-    return {tp, tn, fp, fn};
+    confusion_matrix m(y, y_pred);
+    return {int(m.true_positives()), int(m.true_negatives()), int(m.false_positives()),
+            int(m.false_negatives())};
 }
 } // namespace multi_metrics_
 
@@ -70,8 +185,7 @@ inline std::tuple<int, int, int, int> all_metrics_(const std::vector<double>& y,
  * @return double
  */
 inline double recall(const std::vector<double>& y, const std::vector<double>& y_pred) {
-    auto [tp, tn, fp, fn] = multi_metrics_::all_metrics_(y, y_pred);
-    return 1.0 * (tp) / (tp + fn);
+    return confusion_matrix(y, y_pred).recall();
 }
 
 /**
@@ -79,8 +193,7 @@ inline double recall(const std::vector<double>& y, const std::vector<double>& y_
  * @return double
  */
 inline double accuracy_score(const std::vector<double>& y, const std::vector<double>& y_pred) {
-    auto [tp, tn, fp, fn] = multi_metrics_::all_metrics_(y, y_pred);
-    return 1.0 * (tp + tn) / (tp + tn + fp + fn);
+    return confusion_matrix(y, y_pred).accuracy();
 }
 
 /**
@@ -88,8 +201,7 @@ inline double accuracy_score(const std::vector<double>& y, const std::vector<dou
  * @return double
  */
 inline double precision(const std::vector<double>& y, const std::vector<double>& y_pred) {
-    auto [tp, tn, fp, fn] = multi_metrics_::all_metrics_(y, y_pred);
-    return 1.0 * tp / (tp + fp);
+    return confusion_matrix(y, y_pred).precision();
 }
 
 /**
@@ -97,9 +209,18 @@ inline double precision(const std::vector<double>& y, const std::vector<double>&
  * @return double
  */
 inline double f1_score(const std::vector<double>& y, const std::vector<double>& y_pred) {
-    auto [tp, tn, fp, fn] = multi_metrics_::all_metrics_(y, y_pred);
-    double prec = precision(y, y_pred), rec = recall(y, y_pred);
-    return 2.0 * (prec * rec) / (prec + rec);
+    return confusion_matrix(y, y_pred).f1_score();
+}
+
+/**
+ * @brief euclidean distance function
+ * @param x(span<const double>): the first passed vector
+ * @param y(span<const double>): the second passed vector, of the length of x
+ * @return double
+ */
+inline double euclidean_distance(std::span<const double> x, std::span<const double> y) {
+    assert(x.size() == y.size());
+    return std::sqrt(_mat_utils::squared_distance(x.data(), y.data(), x.size()));
 }
 
 /**
@@ -109,14 +230,18 @@ inline double f1_score(const std::vector<double>& y, const std::vector<double>&
  * @return double
  */
 inline double euclidean_distance(const std::vector<double>& x, const std::vector<double>& y) {
-    assert(x.size() == y.size());
-
-    double _dist = 0.0;
-    for (size_t i = 0; i < x.size(); i++) {
-        _dist += std::pow(y[i] - x[i], 2);
-    }
+    return euclidean_distance(std::span<const double>(x), std::span<const double>(y));
+}
 
-    return std::sqrt(_dist);
+/**
+ * @brief manhattan distance function
+ * @param x(span<const double>): the first passed vector
+ * @param y(span<const double>): the second passed vector, of the length of x
+ * @return double
+ */
+inline double manhattan_distance(std::span<const double> x, std::span<const double> y) {
+    assert(x.size() == y.size());
+    return _mat_utils::absolute_distance(x.data(), y.data(), x.size());
 }
 
 /**
@@ -126,14 +251,61 @@ inline double euclidean_distance(const std::vector<double>& x, const std::vector
  * @return double
  */
 inline double manhattan_distance(const std::vector<double>& x, const std::vector<double>& y) {
-    assert(x.size() == y.size());
+    return manhattan_distance(std::span<const double>(x), std::span<const double>(y));
+}
 
-    double _dist = 0.0;
-    for (size_t i = 0; i < x.size(); i++) {
-        _dist += std::abs(y[i] - x[i]);
-    }
+/**
+ * @brief euclidean distances function, from one point to each row of a matrix
+ * @param x(span<const double>): the point
+ * @param points(Matrix<double>): a point per row, of the length of x
+ * @param out(span<double>): set to the distance of x to every row of points
+ * @param threads: number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the sizes differ.
+ */
+inline void euclidean_distances(std::span<const double> x, const Matrix<double>& points,
+                                std::span<double> out, size_t threads = 1) {
+    _metrics_utils::one_to_many(x, points, out, threads,
+                                [](const double* a, const double* b, size_t d) {
+                                    return std::sqrt(_mat_utils::squared_distance(a, b, d));
+                                });
+}
+
+/**
+ * @brief euclidean distances function
+ * @return vector<double>: the distance of x to every row of points(see above)
+ */
+inline std::vector<double> euclidean_distances(std::span<const double> x,
+                                               const Matrix<double>& points, size_t threads = 1) {
+    std::vector<double> out(points.rows());
+    euclidean_distances(x, points, out, threads);
+    return out;
+}
 
-    return _dist;
+/**
+ * @brief manhattan distances function, from one point to each row of a matrix
+ * @param x(span<const double>): the point
+ * @param points(Matrix<double>): a point per row, of the length of x
+ * @param out(span<double>): set to the distance of x to every row of points
+ * @param threads: number of threads(0 means every hardware thread). Default = 1
+ * Throws std::invalid_argument if the sizes differ.
+ */
+inline void manhattan_distances(std::span<const double> x, const Matrix<double>& points,
+                                std::span<double> out, size_t threads = 1) {
+    _metrics_utils::one_to_many(x, points, out, threads, [](const double* a, const double* b,
+                                                            size_t d) {
+        return _mat_utils::absolute_distance(a, b, d);
+    });
+}
+
+/**
+ * @brief manhattan distances function
+ * @return vector<double>: the distance of x to every row of points(see above)
+ */
+inline std::vector<double> manhattan_distances(std::span<const double> x,
+                                               const Matrix<double>& points, size_t threads = 1) {
+    std::vector<double> out(points.rows());
+    manhattan_distances(x, points, out, threads);
+    return out;
 }
 
 /**
@@ -0,0 +1,354 @@
+#pragma once
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "mlp.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#endif
+
+/**
+ * @brief the precision of the weights of a frozen_mlp
+ * float32: the weights and the activations as floats
+ * int8: the weights quantized per output with a scale each, the input of every layer
+ * quantized per sample, the products summed in int32
+ */
+enum class frozen_precision { float32, int8 };
+
+namespace _frozen_mlp_utils {
+// the samples a batch goes through the layers by, their activations stay in the cache
+constexpr size_t block = 64;
+// the samples of a pass over the weights of a layer
+constexpr size_t tile = 4;
+
+/**
+ * @brief y = x * w + bias for float rows and the in x out weights w, the ReLU applied on
+ * the way out if relu
+ * A register tile of tile samples by two vectors of outputs is accumulated along in, so
+ * every vector of w is loaded once for the tile.
+ */
+template <typename T>
+void linear(const T* x, size_t rows, size_t in, const T* w, const T* bias, size_t out, bool relu,
+            T* y) {
+    for (size_t r0 = 0; r0 < rows; r0 += tile) {
+        const size_t rn = std::min(tile, rows - r0);
+        size_t j0 = 0;
+        if constexpr (_mat_utils::simd<T>::enabled) {
+            using P = _mat_utils::simd<T>;
+            for (; j0 + 2 * P::width <= out; j0 += 2 * P::width) {
+                P acc[tile][2];
+                for (size_t r = 0; r < tile; r++) {
+                    acc[r][0] = P::load(bias + j0);
+                    acc[r][1] = P::load(bias + j0 + P::width);
+                }
+                for (size_t k = 0; k < in; k++) {
+                    P b0 = P::load(w + k * out + j0), b1 = P::load(w + k * out + j0 + P::width);
+                    for (size_t r = 0; r < rn; r++) {
+                        P a = P::broadcast(x[(r0 + r) * in + k]);
+                        acc[r][0] = acc[r][0] + a * b0;
+                        acc[r][1] = acc[r][1] + a * b1;
+                    }
+                }
+                for (size_t r = 0; r < rn; r++) {
+                    T* row = y + (r0 + r) * out + j0;
+                    acc[r][0].store(row);
+                    acc[r][1].store(row + P::width);
+                    if (relu) {
+                        for (size_t j = 0; j < 2 * P::width; j++) {
+                            row[j] = std::max(row[j], T(0));
+                        }
+                    }
+                }
+            }
+        }
+        for (size_t r = 0; r < rn; r++) {
+            const T* xr = x + (r0 + r) * in;
+            T* row = y + (r0 + r) * out;
+            for (size_t j = j0; j < out; j++) {
+                row[j] = bias[j];
+            }
+            for (size_t k = 0; k < in; k++) {
+                for (size_t j = j0; j < out; j++) {
+                    row[j] += xr[k] * w[k * out + j];
+                }
+            }
+            if (relu) {
+                for (size_t j = j0; j < out; j++) {
+                    row[j] = std::max(row[j], T(0));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief the nearest int8 of v, v being in [-127, 127]
+ */
+inline int8_t round_int8(float v) { return int8_t(int(v + (v < 0 ? -0.5f : 0.5f))); }
+
+/**
+ * @brief quantizes every row of x to int8 with the scale max|x| / 127 of the row
+ */
+inline void quantize(const float* x, size_t rows, size_t in, int8_t* q, float* scale) {
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = x + r * in;
+        float top = 0;
+        for (size_t k = 0; k < in; k++) {
+            top = std::max(top, std::abs(row[k]));
+        }
+        float s = top > 0 ? top / 127.0f : 1.0f, inv = 1.0f / s;
+        scale[r] = s;
+        for (size_t k = 0; k < in; k++) {
+            q[r * in + k] = round_int8(std::clamp(row[k] * inv, -127.0f, 127.0f));
+        }
+    }
+}
+
+/**
+ * @brief the int32 dot products of the row w with the rows x[0, rn) of length in
+ */
+inline void dot_int8(const int8_t* w, const int8_t* x, size_t rn, size_t in, int32_t* acc) {
+    size_t k = 0;
+    for (size_t r = 0; r < rn; r++) {
+        acc[r] = 0;
+    }
+#if defined(__AVX2__)
+    __m256i s[tile];
+    for (size_t r = 0; r < tile; r++) {
+        s[r] = _mm256_setzero_si256();
+    }
+    for (; k + 16 <= in; k += 16) {
+        // 16 int8 widened to int16, multiplied and summed by pairs into 8 int32
+        __m256i wv = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(w + k)));
+        for (size_t r = 0; r < rn; r++) {
+            __m256i xv =
+                _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(x + r * in + k)));
+            s[r] = _mm256_add_epi32(s[r], _mm256_madd_epi16(wv, xv));
+        }
+    }
+    for (size_t r = 0; r < rn; r++) {
+        __m128i h =
+            _mm_add_epi32(_mm256_castsi256_si128(s[r]), _mm256_extracti128_si256(s[r], 1));
+        h = _mm_add_epi32(h, _mm_shuffle_epi32(h, 0x4e));
+        h = _mm_add_epi32(h, _mm_shuffle_epi32(h, 0xb1));
+        acc[r] = _mm_cvtsi128_si32(h);
+    }
+#endif
+    for (; k < in; k++) {
+        for (size_t r = 0; r < rn; r++) {
+            acc[r] += int32_t(w[k]) * int32_t(x[r * in + k]);
+        }
+    }
+}
+
+/**
+ * @brief y = x * wT + bias for int8 rows and the out x in weights w: the int32 sums of
+ * products scaled back by the scale of the row of x and of the output, the ReLU applied on
+ * the way out if relu
+ */
+inline void linear(const int8_t* x, const float* x_scale, size_t rows, size_t in,
+                   const int8_t* w, const float* w_scale, const float* bias, size_t out,
+                   bool relu, float* y) {
+    for (size_t r0 = 0; r0 < rows; r0 += tile) {
+        const size_t rn = std::min(tile, rows - r0);
+        for (size_t j = 0; j < out; j++) {
+            int32_t acc[tile];
+            dot_int8(w + j * in, x + r0 * in, rn, in, acc);
+            for (size_t r = 0; r < rn; r++) {
+                float v = float(acc[r]) * w_scale[j] * x_scale[r0 + r] + bias[j];
+                y[(r0 + r) * out + j] = relu ? std::max(v, 0.0f) : v;
+            }
+        }
+    }
+}
+} // namespace _frozen_mlp_utils
+
+/**
+ * @brief frozen_mlp class
+ * The inference model of a trained MLP: its layers copied in float32 or quantized to int8
+ * (see frozen_precision), each fused with the ReLU that follows it. The samples go through
+ * the layers by blocks, their activations in an arena allocated once by the constructor, so
+ * a prediction allocates nothing and reads a half(float32) or an eighth(int8) of the bytes
+ * of the weights of the MLP. The model is not shared by threads, since the arena is not.
+ */
+class frozen_mlp {
+  public:
+    /**
+     * @brief Construct a new frozen mlp object
+     * @param mlp: the trained network, later training does not change the copy
+     * @param precision: the precision of the weights. Default = float32
+     */
+    explicit frozen_mlp(const MLP& mlp, frozen_precision precision = frozen_precision::float32);
+
+    /**
+     * @brief performs inference
+     * @param input: the features of a sample
+     * @return double: the label, 1 or -1 with a single output, the index of the class
+     * otherwise, as MLP::predict. Throws std::invalid_argument if the size of input is not
+     * the number of features.
+     */
+    double predict(std::span<const double> input);
+
+    /**
+     * @brief performs inference on a batch
+     * @param inputs: a sample per row
+     * @param labels: set to the label of every row, as predict. Throws std::invalid_argument
+     * if inputs does not have a column per feature or labels a value per row.
+     */
+    void predict_batch(const Matrix<double>& inputs, std::span<double> labels);
+
+    /**
+     * @brief performs inference on a batch
+     * @param inputs: a sample per row
+     * @return std::vector<double>: the labels of the rows, as predict
+     */
+    std::vector<double> predict_batch(const Matrix<double>& inputs) {
+        std::vector<double> labels(inputs.rows());
+        predict_batch(inputs, labels);
+        return labels;
+    }
+
+    frozen_precision precision() const { return _precision; }
+    size_t in_features() const { return _layers.front().in; }
+
+    /**
+     * @brief weight_bytes function
+     * @return size_t: the bytes of the weights, the scales and the biases of the layers
+     */
+    size_t weight_bytes() const;
+
+  private:
+    struct layer {
+        size_t in, out;
+        bool relu;
+        std::vector<float> weight;
+        std::vector<int8_t> qweight;
+        std::vector<float> scale, bias;
+    };
+
+    // runs the rows [0, rows) of the block staged in _act[0], returns the output rows
+    const float* _run(size_t rows);
+
+    double _label(const float* z) const;
+
+    frozen_precision _precision;
+    std::vector<layer> _layers;
+    std::vector<float> _act[2];
+    std::vector<int8_t> _quantized;
+    std::vector<float> _row_scale;
+};
+
+inline frozen_mlp::frozen_mlp(const MLP& mlp, frozen_precision precision)
+    : _precision(precision) {
+    const std::vector<nn::Linear>& seq = mlp.layers();
+    size_t width = 0;
+    for (size_t l = 0; l < seq.size(); l++) {
+        const nn::Linear& linear = seq[l];
+        layer f{size_t(linear.in_features()), size_t(linear.out_features()), l + 1 < seq.size(),
+                {}, {}, {}, {}};
+        const double* w = linear.weights().data();
+        f.bias.assign(f.out, 0.0f);
+        std::copy(linear.biases().begin(), linear.biases().end(), f.bias.begin());
+        if (precision == frozen_precision::float32) {
+            // in x out, the outputs of a feature contiguous for the register tile
+            f.weight.resize(f.in * f.out);
+            for (size_t j = 0; j < f.out; j++) {
+                for (size_t k = 0; k < f.in; k++) {
+                    f.weight[k * f.out + j] = float(w[j * f.in + k]);
+                }
+            }
+        } else {
+            // symmetric per output: the largest weight of the row maps to 127
+            f.qweight.resize(f.in * f.out);
+            f.scale.resize(f.out);
+            for (size_t j = 0; j < f.out; j++) {
+                double top = 0;
+                for (size_t k = 0; k < f.in; k++) {
+                    top = std::max(top, std::abs(w[j * f.in + k]));
+                }
+                double s = top > 0 ? top / 127.0 : 1.0;
+                f.scale[j] = float(s);
+                for (size_t k = 0; k < f.in; k++) {
+                    f.qweight[j * f.in + k] =
+                        _frozen_mlp_utils::round_int8(float(w[j * f.in + k] / s));
+                }
+            }
+        }
+        width = std::max({width, f.in, f.out});
+        _layers.push_back(std::move(f));
+    }
+    for (std::vector<float>& a : _act) {
+        a.resize(_frozen_mlp_utils::block * width);
+    }
+    if (precision == frozen_precision::int8) {
+        _quantized.resize(_frozen_mlp_utils::block * width);
+        _row_scale.resize(_frozen_mlp_utils::block);
+    }
+}
+
+inline const float* frozen_mlp::_run(size_t rows) {
+    size_t cur = 0;
+    for (const layer& f : _layers) {
+        const float* x = _act[cur].data();
+        float* y = _act[cur ^ 1].data();
+        if (_precision == frozen_precision::float32) {
+            _frozen_mlp_utils::linear(x, rows, f.in, f.weight.data(), f.bias.data(), f.out,
+                                      f.relu, y);
+        } else {
+            _frozen_mlp_utils::quantize(x, rows, f.in, _quantized.data(), _row_scale.data());
+            _frozen_mlp_utils::linear(_quantized.data(), _row_scale.data(), rows, f.in,
+                                      f.qweight.data(), f.scale.data(), f.bias.data(), f.out,
+                                      f.relu, y);
+        }
+        cur ^= 1;
+    }
+    return _act[cur].data();
+}
+
+inline double frozen_mlp::_label(const float* z) const {
+    const size_t classes = _layers.back().out;
+    if (classes == 1) {
+        return z[0] > 0.0f ? 1.0 : -1.0;
+    }
+    return double(std::max_element(z, z + classes) - z);
+}
+
+inline double frozen_mlp::predict(std::span<const double> input) {
+    if (input.size() != in_features()) {
+        throw std::invalid_argument("frozen_mlp: the input must have a value per feature");
+    }
+    std::copy(input.begin(), input.end(), _act[0].begin());
+    return _label(_run(1));
+}
+
+inline void frozen_mlp::predict_batch(const Matrix<double>& inputs, std::span<double> labels) {
+    const size_t in = in_features(), classes = _layers.back().out;
+    if (inputs.cols() != in || labels.size() != inputs.rows()) {
+        throw std::invalid_argument(
+            "frozen_mlp: the inputs must have a column per feature and labels a value per row");
+    }
+    for (size_t start = 0; start < inputs.rows(); start += _frozen_mlp_utils::block) {
+        const size_t rows = std::min(_frozen_mlp_utils::block, inputs.rows() - start);
+        const double* src = inputs.data() + start * in;
+        std::copy(src, src + rows * in, _act[0].begin());
+        const float* out = _run(rows);
+        for (size_t r = 0; r < rows; r++) {
+            labels[start + r] = _label(out + r * classes);
+        }
+    }
+}
+
+inline size_t frozen_mlp::weight_bytes() const {
+    size_t bytes = 0;
+    for (const layer& f : _layers) {
+        bytes += (f.weight.size() + f.scale.size() + f.bias.size()) * sizeof(float) +
+                 f.qweight.size();
+    }
+    return bytes;
+}
@@ -1,121 +1,517 @@
 #pragma once
 
 #ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <thread>
 #include <vector>
+#include "../../classes/queue/ring_buffer.h"
+#include "../../helpers/thread_pool.h"
 #include "../activation/activation_functions.h"
+#include "../dataset/dataset.h"
 #include "../metrics/metrics.h"
 #include "nn.h"
 #endif
 
+/**
+ * @brief the options of MLP::fit
+ * @param batch_size: the number of samples of a gradient step. Default = 32
+ * @param threads: the number of threads of the training, 0 for every thread of the shared
+ * pool. Default = 0
+ * @param hogwild: when false, every batch is split in a shard per thread, the gradients of
+ * the shards are reduced by pairs and the step is taken once for the batch, so the result
+ * depends only on the seed and the number of threads. When true, every thread trains on
+ * its own batches and steps the shared layers without locks(Hogwild!), trading the
+ * determinism for no barrier per batch. Default = false
+ * @param prefetch: the number of batches a loader thread gathers ahead of the synchronous
+ * training, 0 gathers each batch when it is trained on. Hogwild threads gather their own
+ * batches. Default = 2
+ * @param verbose: prints the loss and the accuracy of every epoch. Default = false
+ */
+struct mlp_train_options {
+    size_t batch_size{32};
+    size_t threads{0};
+    bool hogwild{false};
+    size_t prefetch{2};
+    bool verbose{false};
+};
+
 /**
  * @brief Multilayer Perceptron class. Performs binary and categorical
  * classification Uses nn::Linear as a sequential model, follows PyTorch's
- * implementation.
+ * implementation: ReLU between the layers, a sigmoid with the binary cross entropy on a
+ * single output and a softmax with the cross entropy on several. fit trains it by mini-batch
+ * gradient descent, every layer forwarding and backwarding a whole batch as GEMMs into
+ * activation buffers allocated once, on as many threads as asked(see mlp_train_options).
  * TODO: Addition of Conv1d layers
  */
 class MLP {
-    std::vector<std::vector<double>> data_;
     std::vector<double> labels_;
     std::vector<nn::Linear> seq_;
     double binary_;
     int epochs_;
     double learning_rate_;
+    std::mt19937_64 gen_;
+    // the training data as a matrix, or the view of the caller's data it was given
+    Matrix<double> inputs_;
+    dataset_view view_;
+
+    // the buffers of a thread of the training: the input of every layer then the output of
+    // the last one, the gradients flowing back, the gradients of the layers and their
+    // scratch matrices, and the loss and the right guesses of the epoch so far
+    struct shard {
+        std::vector<Matrix<double>> acts;
+        Matrix<double> grad, grad_prev;
+        std::vector<double> targets;
+        std::vector<nn::Linear::gradients> grads;
+        std::vector<nn::Linear::workspace> ws;
+        double loss{0};
+        size_t correct{0};
+    };
+    std::vector<shard> shards_;
+
+    /**
+     * @brief keeps at least count shards, with no snapshot of the layers and no loss
+     */
+    void prepare(size_t count);
+
+    /**
+     * @brief the training samples, a row per sample
+     */
+    dataset_view samples() const { return view_.data() ? view_ : dataset_view(inputs_); }
+
+    /**
+     * @brief copies the samples order[start, start + rows) to x and their targets to t
+     */
+    void gather(const std::vector<size_t>& order, size_t start, size_t rows, Matrix<double>& x,
+                std::vector<double>& t) const;
+
+    /**
+     * @brief forwards s.acts[0] through the network, s.acts[l] is the input of layer l
+     */
+    void forward_batch(shard& s) const;
+
+    /**
+     * @brief sets s.grad to the gradient of the loss of the samples of s, divided by batch,
+     * by the output of the last layer, and adds their loss and right guesses to s
+     */
+    void loss_gradient(shard& s, double batch) const;
+
+    /**
+     * @brief forwards and backwards the samples of s, into the gradients of s.grads
+     */
+    void train(shard& s, double batch) const;
+
+    /**
+     * @brief a synchronous step on the batch x: the shards of its rows trained in parallel,
+     * their gradients reduced by pairs, then one step of every layer
+     */
+    void sync_step(const Matrix<double>& x, const std::vector<double>& t, size_t workers);
+
+    /**
+     * @brief an epoch of Hogwild!: workers threads take the batches in turn, each stepping the
+     * layers with the gradients of its batch
+     */
+    void hogwild_epoch(const std::vector<size_t>& order, size_t batch_size, size_t workers);
 
   public:
     /**
      * @brief default constructor for MLP class
      * @param data: 2D vector, The input data. As usual, the last element of each
-     * sub-vector represents the label of the row
+     * sub-vector represents the label of the row: positive or not with a single output, the
+     * index of the class with several
      * @param arch: 1D vector of pairs. Represents the [in_features, out_features]
      * of each layer in the network
      * @param epochs(int): The number of epochs
      * @param learning_rate(double): The learning rate
+     * @param seed: seed of the initialization and of the shuffles, a random device when not
+     * given
      */
     explicit MLP(std::vector<std::vector<double>> const&, std::vector<std::pair<int, int>> const,
-                 const int epochs = 100, const double learning_rate = 0.001);
+                 const int epochs = 100, const double learning_rate = 0.001,
+                 std::optional<uint64_t> seed = std::nullopt);
+
+    /**
+     * @brief constructor for MLP class over the samples of the caller
+     * The samples are read in place for the whole life of the MLP, nothing is copied but
+     * the labels, so they must outlive it(see dataset).
+     * @param inputs: a row major view of the samples, a sample per row
+     * @param labels: the label of every sample, as the last element of the rows of data
+     * @param arch, epochs, learning_rate, seed: as the default constructor
+     * Throws std::invalid_argument if inputs is column major or labels does not have a
+     * label per sample.
+     */
+    MLP(dataset_view inputs, std::span<const double> labels,
+        std::vector<std::pair<int, int>> const arch, const int epochs = 100,
+        const double learning_rate = 0.001, std::optional<uint64_t> seed = std::nullopt);
 
     /**
      * @brief fit an MLP on the input data
+     * @param opt: the options of the training(see mlp_train_options)
+     * Throws std::invalid_argument if a label is not a class of the output.
+     */
+    void fit(const mlp_train_options& opt);
+
+    /**
+     * @brief fit an MLP on the input data, synchronously and without prefetch
+     * @param batch_size: the number of samples of a gradient step. Default = 32
+     * @param verbose: prints the loss and the accuracy of every epoch. Default = true
+     * @param threads: number of threads each batch is split over. Default = 1
+     * Throws std::invalid_argument if a label is not a class of the output.
      */
-    void fit();
+    void fit(size_t batch_size = 32, bool verbose = true, size_t threads = 1) {
+        fit(mlp_train_options{batch_size, std::max<size_t>(1, threads), false, 0, verbose});
+    }
 
     /**
      * @brief performs inference
      * @param input: 1D vector, the passed validation data
-     * @return double: The classified label
+     * @return double: The classified label, 1 or -1 with a single output, the index of the
+     * class otherwise
      */
     double predict(std::vector<double> const&);
+
+    /**
+     * @brief performs inference on a batch
+     * @param inputs: a sample per row, a Matrix or a dataset_view of either layout
+     * @return vector<double>: the labels of the samples, as predict
+     */
+    std::vector<double> predict(dataset_view inputs);
+
+    /**
+     * @brief layers function
+     * @return std::vector<nn::Linear>&: the layers of the network
+     */
+    std::vector<nn::Linear>& layers() { return seq_; }
+    const std::vector<nn::Linear>& layers() const { return seq_; }
 };
 
 inline MLP::MLP(std::vector<std::vector<double>> const& data,
                 std::vector<std::pair<int, int>> const arch, const int epochs,
-                const double learning_rate) {
+                const double learning_rate, std::optional<uint64_t> seed)
+    : gen_(seed ? *seed : std::random_device()()) {
     assert(data.size() > 0);
     assert(epochs > 0);
     assert(learning_rate > 0);
     assert(arch.size() > 0);
     this->epochs_ = epochs;
-    this->data_ = data;
     this->learning_rate_ = learning_rate;
     this->binary_ = (arch.back().second == 1) ? true : false;
-    for (std::vector<double>& row : this->data_) {
-        this->labels_.push_back(row.back());
-        row.pop_back();
+    const size_t in = data[0].size() - 1;
+    this->inputs_.resize(data.size(), in);
+    for (size_t i = 0; i < data.size(); i++) {
+        std::copy(data[i].begin(), data[i].begin() + in, this->inputs_.data() + i * in);
+        this->labels_.push_back(data[i].back());
     }
 
     for (auto [in_features_, out_features_] : arch) {
         assert(in_features_ > 0);
         assert(out_features_ > 0);
-        this->seq_.push_back(nn::Linear(in_features_, out_features_, true));
+        this->seq_.push_back(nn::Linear(in_features_, out_features_, true, gen_()));
+    }
+}
+
+inline MLP::MLP(dataset_view inputs, std::span<const double> labels,
+                std::vector<std::pair<int, int>> const arch, const int epochs,
+                const double learning_rate, std::optional<uint64_t> seed)
+    : labels_(labels.begin(), labels.end()), gen_(seed ? *seed : std::random_device()()),
+      view_(_dataset_utils::row_major(inputs, "MLP")) {
+    if (inputs.rows() == 0 || labels.size() != inputs.rows()) {
+        throw std::invalid_argument("MLP: there must be a label per sample");
+    }
+    assert(epochs > 0);
+    assert(learning_rate > 0);
+    assert(arch.size() > 0);
+    this->epochs_ = epochs;
+    this->learning_rate_ = learning_rate;
+    this->binary_ = arch.back().second == 1;
+    for (auto [in_features_, out_features_] : arch) {
+        assert(in_features_ > 0);
+        assert(out_features_ > 0);
+        this->seq_.push_back(nn::Linear(in_features_, out_features_, true, gen_()));
     }
 }
 
-inline void MLP::fit() {
-    for (int epoch = 0; epoch < this->epochs_; epoch++) {
-        std::vector<double> y_pred;
-        for (size_t i = 0; i < this->data_.size(); i++) {
-            std::vector<double> out_ = this->data_[i];
-            for (nn::Linear& layer : this->seq_) {
-                out_ = layer.forward(out_);
+inline void MLP::prepare(size_t count) {
+    if (shards_.size() < count) {
+        shards_.resize(count);
+    }
+    for (shard& s : shards_) {
+        s.acts.resize(seq_.size() + 1);
+        s.grads.resize(seq_.size());
+        s.ws.resize(seq_.size());
+        for (nn::Linear::workspace& w : s.ws) {
+            w.snapshot = false;
+        }
+        s.loss = 0;
+        s.correct = 0;
+    }
+}
+
+inline void MLP::gather(const std::vector<size_t>& order, size_t start, size_t rows,
+                        Matrix<double>& x, std::vector<double>& t) const {
+    const dataset_view samples = this->samples();
+    const size_t in = samples.cols();
+    x.resize(rows, in);
+    t.resize(rows);
+    for (size_t i = 0; i < rows; i++) {
+        size_t row = order[start + i];
+        std::copy(samples.data() + row * in, samples.data() + (row + 1) * in, x.data() + i * in);
+        double label = labels_[row];
+        t[i] = binary_ ? double(label > 0) : label;
+    }
+}
+
+inline void MLP::forward_batch(shard& s) const {
+    for (size_t l = 0; l < seq_.size(); l++) {
+        seq_[l].forward(s.acts[l], s.acts[l + 1], s.ws[l]);
+        if (l + 1 < seq_.size()) {
+            activation::ReLU(std::span<double>(s.acts[l + 1].data(), s.acts[l + 1].size()));
+        }
+    }
+}
+
+inline void MLP::loss_gradient(shard& s, double batch) const {
+    const Matrix<double>& out = s.acts.back();
+    const size_t rows = out.rows(), classes = out.cols();
+    s.grad = out;
+    if (binary_) {
+        activation::sigmoid(std::span<double>(s.grad.data(), rows));
+    }
+    for (size_t i = 0; i < rows; i++) {
+        const double* z = out.data() + i * classes;
+        double* g = s.grad.data() + i * classes;
+        if (binary_) {
+            double t = s.targets[i];
+            // log(1 + exp(-|z|)) keeps the loss finite for large logits
+            s.loss += std::max(z[0], 0.0) - z[0] * t + std::log1p(std::exp(-std::abs(z[0])));
+            s.correct += double(z[0] > 0) == t;
+            g[0] = (g[0] - t) / batch;
+            continue;
+        }
+        // g is the softmax of z, lse the log of its normalizer
+        double lse = activation::softmax(std::span<double>(g, classes));
+        size_t t = size_t(s.targets[i]);
+        s.loss += lse - z[t];
+        s.correct += size_t(std::max_element(z, z + classes) - z) == t;
+        for (size_t c = 0; c < classes; c++) {
+            g[c] = (g[c] - (c == t ? 1.0 : 0.0)) / batch;
+        }
+    }
+}
+
+inline void MLP::train(shard& s, double batch) const {
+    forward_batch(s);
+    loss_gradient(s, batch);
+    for (size_t l = seq_.size(); l-- > 0;) {
+        seq_[l].backward(s.acts[l], s.grad, l > 0 ? &s.grad_prev : nullptr, s.grads[l], s.ws[l]);
+        if (l > 0) {
+            // through the ReLU: no gradient where its output was 0
+            const Matrix<double>& a = s.acts[l];
+            for (size_t i = 0; i < a.size(); i++) {
+                if (!(a.data()[i] > 0)) {
+                    s.grad_prev.data()[i] = 0;
+                }
+            }
+            std::swap(s.grad, s.grad_prev);
+        }
+    }
+}
+
+inline void MLP::sync_step(const Matrix<double>& x, const std::vector<double>& t,
+                           size_t workers) {
+    PARALLEL::thread_pool& pool = PARALLEL::thread_pool::shared();
+    const size_t rows = x.rows(), in = x.cols();
+    size_t parts = std::min(workers, rows);
+    const size_t step = (rows + parts - 1) / parts;
+    parts = (rows + step - 1) / step;
+    pool.parallel_for(0, parts, parts, [&](size_t lo, size_t hi, size_t) {
+        for (size_t p = lo; p < hi; p++) {
+            shard& s = shards_[p];
+            const size_t a = p * step, b = std::min(rows, a + step);
+            s.acts[0].resize(b - a, in);
+            std::copy(x.data() + a * in, x.data() + b * in, s.acts[0].data());
+            s.targets.assign(t.begin() + a, t.begin() + b);
+            train(s, double(rows));
+        }
+    });
+    // tree reduction: after the round of stride r, shard i holds the sum of [i, i + 2r)
+    for (size_t stride = 1; stride < parts; stride *= 2) {
+        const size_t pairs = (parts - stride + 2 * stride - 1) / (2 * stride);
+        pool.parallel_for(0, pairs, pairs, [&](size_t lo, size_t hi, size_t) {
+            for (size_t k = lo; k < hi; k++) {
+                shard &a = shards_[2 * stride * k], &b = shards_[2 * stride * k + stride];
+                for (size_t l = 0; l < seq_.size(); l++) {
+                    a.grads[l] += b.grads[l];
+                }
+            }
+        });
+    }
+    for (size_t l = 0; l < seq_.size(); l++) {
+        seq_[l].step(shards_[0].grads[l], learning_rate_);
+    }
+}
+
+inline void MLP::hogwild_epoch(const std::vector<size_t>& order, size_t batch_size,
+                               size_t workers) {
+    const size_t n = order.size(), batches = (n + batch_size - 1) / batch_size;
+    std::atomic<size_t> next{0};
+    PARALLEL::thread_pool::shared().parallel_for(0, workers, workers, [&](size_t lo, size_t hi,
+                                                                          size_t) {
+        for (size_t p = lo; p < hi; p++) {
+            shard& s = shards_[p];
+            for (size_t b; (b = next.fetch_add(1, std::memory_order_relaxed)) < batches;) {
+                const size_t start = b * batch_size, rows = std::min(batch_size, n - start);
+                gather(order, start, rows, s.acts[0], s.targets);
+                for (size_t l = 0; l < seq_.size(); l++) {
+                    seq_[l].snapshot(s.ws[l]);
+                }
+                train(s, double(rows));
+                for (size_t l = 0; l < seq_.size(); l++) {
+                    seq_[l].hogwild_step(s.grads[l], learning_rate_);
+                }
             }
+        }
+    });
+}
 
-            // double y_pred;
-            double y_pred_ = (out_[0] > 0.0) ? 1.0 : -1.0;
-            y_pred.push_back(y_pred_);
-            // TODO: Perform multiclass classification
-            // else {
-            //     std::vector<double> logits = activation::softmax(out_);
-            //     y_pred = std::max_element(logits.begin(), logits.end()) -
-            //     logits.begin(); std::cout << y_pred << '\n';
-            // }
-            double err = y_pred_ - this->labels_[i];
-
-            if (err != 0) {
-                for (nn::Linear& layer : this->seq_) {
-                    layer.update_weights(this->data_[i], err, this->learning_rate_);
+inline void MLP::fit(const mlp_train_options& opt) {
+    const size_t n = this->samples().rows();
+    const size_t classes = size_t(this->seq_.back().out_features());
+    for (double label : this->labels_) {
+        if (!binary_ && (label < 0 || label >= double(classes) || label != std::floor(label))) {
+            throw std::invalid_argument("MLP: a label is not the index of a class");
+        }
+    }
+    const size_t batch_size = std::max<size_t>(1, std::min(opt.batch_size, n));
+    const size_t workers =
+        std::min(opt.threads == 0 ? PARALLEL::thread_pool::shared().concurrency() : opt.threads,
+                 opt.hogwild ? (n + batch_size - 1) / batch_size : batch_size);
+    prepare(workers);
+    auto report = [&](int epoch) {
+        double loss = 0;
+        size_t correct = 0;
+        for (shard& s : shards_) {
+            loss += s.loss;
+            correct += s.correct;
+            s.loss = 0;
+            s.correct = 0;
+        }
+        if (opt.verbose) {
+            std::cout << "Epoch: " << epoch + 1 << ": "
+                      << "Loss: " << loss / double(n)
+                      << " | Accuracy: " << double(correct) / double(n) << '\n';
+        }
+    };
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (opt.hogwild || opt.prefetch == 0) {
+        Matrix<double> x;
+        std::vector<double> t;
+        for (int epoch = 0; epoch < this->epochs_; epoch++) {
+            std::shuffle(order.begin(), order.end(), gen_);
+            if (opt.hogwild) {
+                hogwild_epoch(order, batch_size, workers);
+            } else {
+                for (size_t start = 0; start < n; start += batch_size) {
+                    gather(order, start, std::min(batch_size, n - start), x, t);
+                    sync_step(x, t, workers);
                 }
             }
+            report(epoch);
         }
-        std::cout << "Epoch: " << epoch + 1 << ": "
-                  << "Accuracy: " << metrics::accuracy_score(this->labels_, y_pred)
-                  << " | f1_score: " << metrics::f1_score(this->labels_, y_pred)
-                  << " | Recall: " << metrics::recall(this->labels_, y_pred)
-                  << " | Precision: " << metrics::precision(this->labels_, y_pred) << '\n';
+        prepare(workers);
+        return;
+    }
+
+    // the loader fills the idle slots with the next batches and passes them on through
+    // loaded, the training gives every slot back through idle once its step is taken
+    struct slot {
+        Matrix<double> x;
+        std::vector<double> t;
+    };
+    std::vector<slot> slots(opt.prefetch + 1);
+    spsc_ring_buffer<size_t> idle(slots.size()), loaded(slots.size());
+    for (size_t k = 0; k < slots.size(); k++) {
+        idle.try_push(k);
     }
+    std::atomic<bool> stop{false};
+    std::thread loader([&]() {
+        for (int epoch = 0; epoch < this->epochs_; epoch++) {
+            std::shuffle(order.begin(), order.end(), gen_);
+            for (size_t start = 0; start < n; start += batch_size) {
+                std::optional<size_t> k;
+                while (!(k = idle.try_pop())) {
+                    if (stop.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+                gather(order, start, std::min(batch_size, n - start), slots[*k].x, slots[*k].t);
+                loaded.try_push(*k);
+            }
+        }
+    });
+    try {
+        for (int epoch = 0; epoch < this->epochs_; epoch++) {
+            for (size_t start = 0; start < n; start += batch_size) {
+                std::optional<size_t> k;
+                while (!(k = loaded.try_pop())) {
+                    std::this_thread::yield();
+                }
+                sync_step(slots[*k].x, slots[*k].t, workers);
+                idle.try_push(*k);
+            }
+            report(epoch);
+        }
+    } catch (...) {
+        stop.store(true, std::memory_order_relaxed);
+        loader.join();
+        throw;
+    }
+    loader.join();
 }
 
 inline double MLP::predict(std::vector<double> const& input) {
-    assert(input.size() == this->data_[0].size());
+    assert(input.size() == this->samples().cols());
     std::vector<double> out_ = input;
-    for (nn::Linear& layer : this->seq_) {
-        out_ = layer.forward(out_);
+    for (size_t l = 0; l < this->seq_.size(); l++) {
+        out_ = this->seq_[l].forward(out_);
+        if (l + 1 < this->seq_.size()) {
+            activation::ReLU(std::span<double>(out_));
+        }
+    }
+
+    if (binary_) {
+        return (out_[0] > 0.0) ? 1.0 : -1.0;
     }
+    return double(std::max_element(out_.begin(), out_.end()) - out_.begin());
+}
 
-    return (out_[0] > 0.0) ? 1.0 : -1.0;
-    // else {
-    //     std::vector<double> logits = activation::softmax(out_);
-    //     return std::max_element(logits.begin(), logits.end()) - logits.begin();
-    // }
+inline std::vector<double> MLP::predict(dataset_view inputs) {
+    prepare(1);
+    shard& s = this->shards_[0];
+    s.acts[0].resize(inputs.rows(), inputs.cols());
+    for (size_t i = 0; i < inputs.rows(); i++) {
+        strided_span<const double> x = inputs.row(i);
+        std::copy(x.begin(), x.end(), s.acts[0].data() + i * inputs.cols());
+    }
+    forward_batch(s);
+    const Matrix<double>& out = s.acts.back();
+    std::vector<double> labels(out.rows());
+    for (size_t i = 0; i < out.rows(); i++) {
+        const double* z = out.data() + i * out.cols();
+        labels[i] = binary_ ? (z[0] > 0.0 ? 1.0 : -1.0)
+                            : double(std::max_element(z, z + out.cols()) - z);
+    }
+    return labels;
 }
@@ -1,26 +1,64 @@
 #pragma once
 
+#include "../../linalg/matmul.h"
+
 #ifdef __cplusplus
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <random>
+#include <stdexcept>
 #include <vector>
-#include "../../algorithms/math/multiply.h"
 #endif
 
 namespace nn {
 
 /**
  * @brief Linear module. This implementation mostly follows PyTorch's
- * implementation
+ * implementation. The weights are an out_features x in_features Matrix, contiguous in
+ * row major order, and the bias has one value per output. A batch of samples goes through
+ * the layer as one GEMM, into matrices the caller keeps from one batch to the next, so a
+ * training loop allocates nothing once the first batch is done.
  */
 class Linear {
+  public:
+    /**
+     * @brief the gradients of the parameters of a Linear layer, of the shape of the weight
+     * and of the bias
+     */
+    struct gradients {
+        Matrix<double> weight;
+        std::vector<double> bias;
+
+        gradients& operator+=(const gradients& g) {
+            weight += g.weight;
+            for (size_t j = 0; j < bias.size(); j++) {
+                bias[j] += g.bias[j];
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief the scratch matrices of a forward and a backward pass, one per thread that
+     * runs them: the transpose of the weights and of grad_output, and with snapshot set the
+     * copy of the parameters taken by snapshot(), used instead of those of the layer
+     */
+    struct workspace {
+        Matrix<double> weight, weight_t, grad_t;
+        std::vector<double> bias;
+        bool snapshot{false};
+    };
+
   private:
-    std::vector<std::vector<double>> weight;
-    std::optional<double> bias;
+    Matrix<double> weight;
+    std::vector<double> bias;
     int in_features_;
     int out_features_;
+    workspace ws_;
+    gradients grad_;
 
   public:
     /**
@@ -29,8 +67,9 @@ class Linear {
      * @param out_features(int): The output features
      * @param bias(bool): If set to true, then bias will be initialized
      *                    with a uniform distribution on U(-1.0, 1.0)
+     * @param seed: seed of the initialization, a random device when not given
      */
-    explicit Linear(int, int, bool bias = false);
+    explicit Linear(int, int, bool bias = false, std::optional<uint64_t> seed = std::nullopt);
 
     /**
      * @brief forward function: Forwards an input 1D tensor to the network
@@ -39,6 +78,114 @@ class Linear {
      */
     std::vector<double> forward(std::vector<double> const&);
 
+    /**
+     * @brief forward function for a batch, the samples are the rows of input
+     * @param input: batch x in_features
+     * @param output: set to the batch x out_features input * wT + bias, its storage is
+     * reused
+     * @param threads: number of threads of the GEMM. Default = 1
+     * Throws std::invalid_argument if input does not have in_features columns.
+     */
+    void forward(const Matrix<double>& input, Matrix<double>& output, size_t threads = 1) {
+        forward(input, output, ws_, threads);
+    }
+
+    /**
+     * @brief forward function for a batch with the scratch matrices of the caller, so
+     * several threads can forward their own batches through the layer at once
+     */
+    void forward(const Matrix<double>& input, Matrix<double>& output, workspace& ws,
+                 size_t threads = 1) const;
+
+    /**
+     * @brief backward function for a batch
+     * @param input: the input of the forward pass, batch x in_features
+     * @param grad_output: the gradient of the loss by the output, batch x out_features
+     * @param grad_input: if not null, set to the gradient of the loss by input
+     * @param grad: set to the gradients of the loss by the parameters
+     * @param threads: number of threads of the GEMMs. Default = 1
+     */
+    void backward(const Matrix<double>& input, const Matrix<double>& grad_output,
+                  Matrix<double>* grad_input, gradients& grad, size_t threads = 1) {
+        backward(input, grad_output, grad_input, grad, ws_, threads);
+    }
+
+    /**
+     * @brief backward function for a batch into the gradients of the layer(see grad())
+     */
+    void backward(const Matrix<double>& input, const Matrix<double>& grad_output,
+                  Matrix<double>* grad_input = nullptr, size_t threads = 1) {
+        backward(input, grad_output, grad_input, grad_, ws_, threads);
+    }
+
+    /**
+     * @brief backward function for a batch with the scratch matrices of the caller
+     */
+    void backward(const Matrix<double>& input, const Matrix<double>& grad_output,
+                  Matrix<double>* grad_input, gradients& grad, workspace& ws,
+                  size_t threads = 1) const;
+
+    /**
+     * @brief snapshot function
+     * Copies the parameters into ws with relaxed atomic loads and sets ws.snapshot, for
+     * the passes that run while other threads step the layer(see hogwild_step).
+     */
+    void snapshot(workspace& ws);
+
+    /**
+     * @brief step function: a gradient descent step
+     * @param grad: the gradients, of the shape of the parameters
+     * @param learning_rate: the size of the step
+     */
+    void step(const gradients& grad, double learning_rate);
+
+    /**
+     * @brief step function with the gradients of the layer
+     */
+    void step(double learning_rate) { step(grad_, learning_rate); }
+
+    /**
+     * @brief hogwild_step function
+     * A gradient descent step that may run while other threads step the layer or take
+     * snapshots of it: every parameter is read and written with relaxed atomic operations
+     * and no lock, so concurrent steps may overwrite each other's update of a parameter, as
+     * Hogwild! accepts.
+     * @param grad: the gradients, of the shape of the parameters
+     * @param learning_rate: the size of the step
+     */
+    void hogwild_step(const gradients& grad, double learning_rate);
+
+    /**
+     * @brief grad function
+     * @return gradients&: the gradients of the last backward pass into the layer
+     */
+    gradients& grad() { return grad_; }
+
+    /**
+     * @brief zero_gradients function
+     * @return gradients: zero gradients of the shape of the parameters
+     */
+    gradients zero_gradients() const {
+        return {Matrix<double>(out_features_, in_features_), std::vector<double>(bias.size())};
+    }
+
+    /**
+     * @brief weights function
+     * @return Matrix<double>&: the out_features x in_features weights
+     */
+    Matrix<double>& weights() { return weight; }
+    const Matrix<double>& weights() const { return weight; }
+
+    /**
+     * @brief biases function
+     * @return std::vector<double>&: the bias of every output, empty without bias
+     */
+    std::vector<double>& biases() { return bias; }
+    const std::vector<double>& biases() const { return bias; }
+
+    int in_features() const { return in_features_; }
+    int out_features() const { return out_features_; }
+
     /**
      * @brief updates the weight vector by value
      * @param value: double, the value that will be added to weight vector
@@ -47,53 +194,124 @@ class Linear {
 };
 } // namespace nn
 
-inline nn::Linear::Linear(int in_features, int out_features, bool bias)
-    : in_features_(in_features), out_features_(out_features) {
+inline nn::Linear::Linear(int in_features, int out_features, bool bias,
+                          std::optional<uint64_t> seed)
+    : weight(out_features, in_features), in_features_(in_features),
+      out_features_(out_features) {
     assert(in_features != 0);
     assert(out_features != 0);
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(seed ? std::mt19937::result_type(*seed) : std::random_device()());
     std::uniform_real_distribution<double> dist(-1.0, 1.0);
-    this->weight =
-        std::vector<std::vector<double>>(out_features, std::vector<double>(in_features, 0.0));
-    for (auto& w_vec : this->weight) {
-        for (auto& w : w_vec) {
-            w = dist(gen);
-        }
+    for (size_t i = 0; i < this->weight.size(); i++) {
+        this->weight.data()[i] = dist(gen);
     }
 
     if (bias) {
-        this->bias = dist(gen);
-    } else {
-        this->bias = std::nullopt;
+        this->bias.resize(out_features);
+        for (double& b : this->bias) {
+            b = dist(gen);
+        }
     }
 }
 
 inline std::vector<double> nn::Linear::forward(std::vector<double> const& input_tensor) {
-    std::vector<double> output(out_features_, 0.0);
+    std::vector<double> output = matmul(this->weight, std::span<const double>(input_tensor));
+    for (size_t i = 0; i < bias.size(); i++) {
+        output[i] += bias[i];
+    }
 
-    for (int i = 0; i < this->out_features_; i++) {
-        for (int j = 0; j < this->in_features_; j++) {
-            output[i] += weight[i][j] * input_tensor[j];
+    return output;
+}
+
+inline void nn::Linear::forward(const Matrix<double>& input, Matrix<double>& output,
+                                workspace& ws, size_t threads) const {
+    if (input.cols() != size_t(in_features_)) {
+        throw std::invalid_argument("Linear: the input must have in_features columns");
+    }
+    if (!ws.snapshot) {
+        weight.transpose(ws.weight_t);
+    }
+    matmul(input, ws.weight_t, output, threads);
+    const std::vector<double>& b = ws.snapshot ? ws.bias : bias;
+    if (!b.empty()) {
+        for (size_t i = 0; i < output.rows(); i++) {
+            double* row = output.data() + i * output.cols();
+            for (size_t j = 0; j < output.cols(); j++) {
+                row[j] += b[j];
+            }
         }
+    }
+}
 
-        if (bias.has_value()) {
-            output[i] += bias.value();
+inline void nn::Linear::backward(const Matrix<double>& input, const Matrix<double>& grad_output,
+                                 Matrix<double>* grad_input, gradients& grad, workspace& ws,
+                                 size_t threads) const {
+    // weight: grad_output^T input, input: grad_output weight, bias: the sums of the columns
+    grad_output.transpose(ws.grad_t);
+    matmul(ws.grad_t, input, grad.weight, threads);
+    if (grad_input) {
+        matmul(grad_output, ws.snapshot ? ws.weight : weight, *grad_input, threads);
+    }
+    grad.bias.assign(bias.size(), 0.0);
+    if (!bias.empty()) {
+        for (size_t i = 0; i < grad_output.rows(); i++) {
+            const double* row = grad_output.data() + i * grad_output.cols();
+            for (size_t j = 0; j < grad_output.cols(); j++) {
+                grad.bias[j] += row[j];
+            }
         }
     }
+}
 
-    return output;
+inline void nn::Linear::snapshot(workspace& ws) {
+    ws.weight.resize(weight.rows(), weight.cols());
+    for (size_t i = 0; i < weight.size(); i++) {
+        ws.weight.data()[i] = std::atomic_ref<double>(weight.data()[i]).load(
+            std::memory_order_relaxed);
+    }
+    ws.weight.transpose(ws.weight_t);
+    ws.bias.resize(bias.size());
+    for (size_t j = 0; j < bias.size(); j++) {
+        ws.bias[j] = std::atomic_ref<double>(bias[j]).load(std::memory_order_relaxed);
+    }
+    ws.snapshot = true;
+}
+
+inline void nn::Linear::hogwild_step(const gradients& grad, double learning_rate) {
+    auto update = [&](double& x, double g) {
+        std::atomic_ref<double> a(x);
+        a.store(a.load(std::memory_order_relaxed) - learning_rate * g, std::memory_order_relaxed);
+    };
+    for (size_t i = 0; i < weight.size(); i++) {
+        update(weight.data()[i], grad.weight.data()[i]);
+    }
+    for (size_t j = 0; j < bias.size(); j++) {
+        update(bias[j], grad.bias[j]);
+    }
+}
+
+inline void nn::Linear::step(const gradients& grad, double learning_rate) {
+    double* w = weight.data();
+    const double* g = grad.weight.data();
+    for (size_t i = 0; i < weight.size(); i++) {
+        w[i] -= learning_rate * g[i];
+    }
+    for (size_t j = 0; j < bias.size(); j++) {
+        bias[j] -= learning_rate * grad.bias[j];
+    }
 }
 
 inline void nn::Linear::update_weights(std::vector<double> const& input, double error,
                                        double learning_rate) {
+    const double step = learning_rate * error;
     for (int i = 0; i < this->out_features_; i++) {
+        double* row = this->weight.data() + size_t(i) * this->in_features_;
         for (int j = 0; j < this->in_features_; j++) {
-            weight[i][j] -= learning_rate * error * input[j];
+            row[j] -= step * input[j];
         }
 
-        if (bias.has_value()) {
-            bias = bias.value() - learning_rate * error;
+        if (!bias.empty()) {
+            bias[i] -= learning_rate * error;
         }
     }
 }
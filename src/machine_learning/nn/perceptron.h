@@ -71,11 +71,10 @@ inline void perceptron::fit() {
             }
         }
 
+        const metrics::confusion_matrix m(this->labels_, y_pred);
         std::cout << "Epoch: " << epoch + 1 << ": "
-                  << "Accuracy: " << metrics::accuracy_score(this->labels_, y_pred)
-                  << " | f1_score: " << metrics::f1_score(this->labels_, y_pred)
-                  << " | Recall: " << metrics::recall(this->labels_, y_pred)
-                  << " | Precision: " << metrics::precision(this->labels_, y_pred) << '\n';
+                  << "Accuracy: " << m.accuracy() << " | f1_score: " << m.f1_score()
+                  << " | Recall: " << m.recall() << " | Precision: " << m.precision() << '\n';
     }
 }
 
@@ -1,9 +1,14 @@
 #ifndef LIN_REG_H
 #define LIN_REG_H
 
+#include "../../../helpers/parallel.h"
+
 #ifdef __cplusplus
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <span>
+#include <stdexcept>
 #include <vector>
 #endif
 
@@ -43,11 +48,14 @@ class linear_regression {
 
     /**
      * @brief get_results function
+     * The two pass centered sums are what a QR least squares fit of [1, x] reduces to for a
+     * single feature, so they are kept instead of a decomposition. Every call starts over.
      * @return pair<double,double> the values of a and b
      *
      */
     inline std::pair<double, double> get_results() {
         int64_t n = this->data.size();
+        x_mean = y_mean = Sxy = Sxx = 0.0;
         for (auto& x : data) {
             x_mean += x[0];
             y_mean += x[1];
@@ -76,4 +84,167 @@ class linear_regression {
     }
 };
 
+/**
+ * @brief online linear regression class
+ * The fit of y = a + b*x over a stream of points, kept as running statistics of constant
+ * size: the total weight, the means and the centered sums of squares and products, updated
+ * per point the way Welford updates a variance, so nothing cancels however long the stream.
+ * Two estimators merge into the one of the union of their points(Chan et al.), so a fit
+ * can be split over threads or shards and reduced. With a forgetting factor f < 1 every new
+ * point first scales the weight of the older ones by f, the fit following drifting data with
+ * an effective memory of about 1 / (1 - f) points.
+ */
+class online_linear_regression {
+  public:
+    /**
+     * @brief Construct a new online linear regression object, with no points
+     * @param forgetting: the factor the weight of the older points is scaled by at every new
+     * one, in (0, 1]. Default = 1, nothing is forgotten
+     * Throws std::invalid_argument if forgetting is not in (0, 1].
+     */
+    explicit online_linear_regression(double forgetting = 1.0) : _forgetting(forgetting) {
+        if (!(forgetting > 0.0 && forgetting <= 1.0)) {
+            throw std::invalid_argument("online_linear_regression: forgetting must be in (0, 1]");
+        }
+    }
+
+    /**
+     * @brief update function
+     * @param x: the x of the point
+     * @param y: the y of the point
+     * @param weight: the weight of the point, positive. Default = 1
+     */
+    void update(double x, double y, double weight = 1.0) {
+        if (_forgetting < 1.0) {
+            _weight *= _forgetting;
+            _sxx *= _forgetting;
+            _sxy *= _forgetting;
+            _syy *= _forgetting;
+        }
+        _count++;
+        _weight += weight;
+        const double dx = x - _mean_x, dy = y - _mean_y, share = weight / _weight;
+        _mean_x += dx * share;
+        _mean_y += dy * share;
+        // the deviation before times the one after the mean moved
+        _sxx += weight * dx * (x - _mean_x);
+        _sxy += weight * dx * (y - _mean_y);
+        _syy += weight * dy * (y - _mean_y);
+    }
+
+    /**
+     * @brief update function for a batch of points, in order
+     * Throws std::invalid_argument if x and y differ in size.
+     */
+    void update(std::span<const double> x, std::span<const double> y) {
+        if (x.size() != y.size()) {
+            throw std::invalid_argument("online_linear_regression: x and y must have one size");
+        }
+        for (size_t i = 0; i < x.size(); i++) {
+            update(x[i], y[i]);
+        }
+    }
+
+    /**
+     * @brief merge function
+     * Adds the points of other to this, as if they had come before the next point with
+     * their weights as they are now.
+     * @param other: the estimator of other points
+     * @return online_linear_regression&: this
+     */
+    online_linear_regression& merge(const online_linear_regression& other) {
+        if (other._weight == 0) {
+            _count += other._count;
+            return *this;
+        }
+        const double total = _weight + other._weight;
+        const double dx = other._mean_x - _mean_x, dy = other._mean_y - _mean_y;
+        const double cross = _weight * other._weight / total;
+        _sxx += other._sxx + dx * dx * cross;
+        _sxy += other._sxy + dx * dy * cross;
+        _syy += other._syy + dy * dy * cross;
+        _mean_x += dx * other._weight / total;
+        _mean_y += dy * other._weight / total;
+        _weight = total;
+        _count += other._count;
+        return *this;
+    }
+
+    /**
+     * @brief slope function
+     * @return double: b, 0 while the points have a single x
+     */
+    double slope() const { return _sxx > 0 ? _sxy / _sxx : 0.0; }
+
+    /**
+     * @brief intercept function
+     * @return double: a, the mean of y while the points have a single x
+     */
+    double intercept() const { return _mean_y - slope() * _mean_x; }
+
+    /**
+     * @brief get_results function
+     * @return pair<double,double> the values of a and b, as linear_regression::get_results
+     */
+    std::pair<double, double> get_results() const { return {intercept(), slope()}; }
+
+    /**
+     * @brief predict function
+     * @param x: the value of x which we want to predict y
+     * @return double: the predicted value of y
+     */
+    double predict(double x) const { return intercept() + slope() * x; }
+
+    /**
+     * @brief r squared function
+     * @return double: the fraction of the weighted variance of y the fit explains, 1 when y
+     * does not vary
+     */
+    double r_squared() const {
+        if (_syy <= 0) {
+            return 1.0;
+        }
+        return _sxx > 0 ? std::min(1.0, _sxy * _sxy / (_sxx * _syy)) : 0.0;
+    }
+
+    uint64_t count() const { return _count; }
+    double weight() const { return _weight; }
+    double mean_x() const { return _mean_x; }
+    double mean_y() const { return _mean_y; }
+
+  private:
+    double _forgetting;
+    uint64_t _count{0};
+    double _weight{0};
+    double _mean_x{0}, _mean_y{0};
+    double _sxx{0}, _sxy{0}, _syy{0};
+};
+
+/**
+ * @brief linear regression fit function
+ * Fits y = a + b*x over ranges of the points on several threads, an online estimator per
+ * range, and merges the estimators.
+ * @param x: the x of every point
+ * @param y: the y of every point
+ * @param threads: number of threads(0 means every hardware thread). Default = 0
+ * @return online_linear_regression: the estimator of the points, without forgetting.
+ * Throws std::invalid_argument if x and y differ in size.
+ */
+inline online_linear_regression linear_regression_fit(std::span<const double> x,
+                                                      std::span<const double> y,
+                                                      size_t threads = 0) {
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("linear_regression_fit: x and y must have one size");
+    }
+    threads = PARALLEL::resolve_threads(threads, x.size() / 65536 + 1);
+    std::vector<online_linear_regression> part(threads);
+    PARALLEL::parallel_for(0, x.size(), threads, [&](size_t lo, size_t hi, size_t t) {
+        part[t].update(x.subspan(lo, hi - lo), y.subspan(lo, hi - lo));
+    });
+    for (size_t t = 1; t < threads; t++) {
+        part[0].merge(part[t]);
+    }
+    return part[0];
+}
+
 #endif
@@ -1,12 +1,24 @@
 #ifndef POLY_REG_H
 #define POLY_REG_H
 
+#include "../../../linalg/decomposition.h"
+#include "../../../linalg/matmul.h"
+
 #ifdef __cplusplus
 #include <cmath>
 #include <iostream>
+#include <span>
+#include <utility>
 #include <vector>
 #endif
 
+/**
+ * @brief polynomial regression class
+ * Least squares fit of a polynomial of degree n: the m x (n + 1) Vandermonde matrix V of the
+ * points is factored by Householder QR and V b = y is solved in the least squares sense,
+ * without forming the normal equations V^T V b = V^T y whose condition number is the
+ * square of the one of V(calculate_matrix and calculate_vector still build them).
+ */
 class polynomial_regression {
   private:
     std::vector<double> X;
@@ -18,79 +30,54 @@ class polynomial_regression {
         : X(X), Y(Y), n(n) {}
 
     inline std::vector<double> get_coeffs() {
-        std::vector<std::vector<double>> k = calculate_matrix(this->X, this->n);
-        std::vector<double> l = calculate_vector(this->X, this->Y, this->n);
-        std::vector<double> b_coeffs = solve_linear_system(k, l);
-        return b_coeffs;
+        qr_decomposition<double> qr(vandermonde(this->X, this->n));
+        return qr.solve(this->Y);
     }
 
-    inline std::vector<std::vector<double>> create_matrix(int64_t rows, int64_t cols) {
-        return std::vector<std::vector<double>>(rows, std::vector<double>(cols, 0.0));
+    inline Matrix<double> create_matrix(int64_t rows, int64_t cols) {
+        return Matrix<double>(rows, cols, 0.0);
     }
 
-    inline std::vector<std::vector<double>> calculate_matrix(const std::vector<double>& x,
-                                                             int64_t n) {
-        int64_t m = x.size();
-        auto matrix = create_matrix(n + 1, n + 1);
-        for (int64_t i = 0; i <= n; ++i) {
-            for (int64_t j = 0; j <= n; ++j) {
-                for (int64_t k = 0; k < m; ++k) {
-                    matrix[i][j] += pow(x[k], i + j);
-                }
+    /**
+     * @brief vandermonde function
+     * @param x the points
+     * @param n the degree
+     * @return Matrix<double> the x.size() x (n + 1) matrix of the powers x[k]^i.
+     */
+    inline Matrix<double> vandermonde(const std::vector<double>& x, int64_t n) {
+        Matrix<double> v = create_matrix(x.size(), n + 1);
+        for (size_t k = 0; k < x.size(); ++k) {
+            for (int64_t i = 0; i <= n; ++i) {
+                v(k, i) = pow(x[k], i);
             }
         }
-        return matrix;
+        return v;
     }
 
+    /**
+     * @brief calculate_matrix function
+     * @return Matrix<double> the (n + 1) x (n + 1) matrix of the sums of x[k]^(i + j).
+     */
+    inline Matrix<double> calculate_matrix(const std::vector<double>& x, int64_t n) {
+        Matrix<double> v = vandermonde(x, n);
+        return matmul(v.transpose(), v);
+    }
+
+    /**
+     * @brief calculate_vector function
+     * @return std::vector<double> the n + 1 sums of y[k] x[k]^i.
+     */
     inline std::vector<double> calculate_vector(const std::vector<double>& x,
                                                 const std::vector<double>& y, int64_t n) {
-        int64_t m = x.size();
-        std::vector<double> vector(n + 1, 0.0);
-        for (int64_t i = 0; i <= n; ++i) {
-            for (int64_t k = 0; k < m; ++k) {
-                vector[i] += y[k] * pow(x[k], i);
-            }
-        }
-        return vector;
+        return matmul(vandermonde(x, n).transpose(), std::span<const double>(y));
     }
 
-    // Gaussian elimination
-    inline std::vector<double> solve_linear_system(std::vector<std::vector<double>> A,
-                                                   std::vector<double> b) {
-        int64_t n = A.size();
-        for (int64_t i = 0; i < n; ++i) {
-
-            int64_t maxRow = i;
-            for (int64_t k = i + 1; k < n; ++k) {
-                if (std::abs(A[k][i]) > std::abs(A[maxRow][i])) {
-                    maxRow = k;
-                }
-            }
-
-            std::swap(A[maxRow], A[i]);
-            std::swap(b[maxRow], b[i]);
-
-            for (int64_t k = i + 1; k < n; ++k) {
-                double c = -A[k][i] / A[i][i];
-                for (int64_t j = i; j < n; ++j) {
-                    if (i == j) {
-                        A[k][j] = 0;
-                    } else {
-                        A[k][j] += c * A[i][j];
-                    }
-                }
-                b[k] += c * b[i];
-            }
-        }
-
-        std::vector<double> x(n);
-        for (int64_t i = n - 1; i >= 0; --i) {
-            x[i] = b[i] / A[i][i];
-            for (int64_t k = i - 1; k >= 0; --k) {
-                b[k] -= A[k][i] * x[i];
-            }
-        }
-        return x;
+    /**
+     * @brief solve_linear_system function
+     * @return std::vector<double> the x with A x = b, by LU with partial pivoting.
+     */
+    inline std::vector<double> solve_linear_system(Matrix<double> A, std::vector<double> b) {
+        return lu_decomposition<double>(std::move(A)).solve(b);
     }
 
     /**
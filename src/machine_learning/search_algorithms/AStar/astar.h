@@ -1,23 +1,71 @@
-#include <queue>
 #ifndef ASTAR_H
 #define ASTAR_H
 
+#include "../../../classes/graph/vertex_index.h"
+#include "../../../helpers/parallel.h"
+#include "../../../classes/heap/indexed_heap.h"
+
 #ifdef __cplusplus
 #include <algorithm>
-#include <climits>
+#include <cstdint>
 #include <iostream>
-#include <queue>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 #endif
 
 /**
  * @ brief A* Class
+ * Nodes are interned to dense ids, so the scores of a search live in flat arrays.
  */
 template <typename T> class AStar {
+  public:
+    static constexpr uint32_t npos = vertex_index<T>::npos;
+
+    /**
+     * @brief search_context class
+     * Scratch state of one search: scores, parents and the open set. Kept between
+     * queries so that a query allocates nothing once the buffers have grown, and only
+     * the nodes touched by the previous query are reset. A context is not shared, use
+     * one per thread.
+     */
+    class search_context {
+      private:
+        friend class AStar;
+        std::vector<double> g_score;
+        std::vector<uint32_t> came_from;
+        std::vector<uint32_t> touched;
+        indexed_heap<double> open;
+
+        void prepare(size_t n) {
+            for (uint32_t u : touched) {
+                g_score[u] = std::numeric_limits<double>::infinity();
+                came_from[u] = npos;
+            }
+            touched.clear();
+            open.clear();
+            if (g_score.size() < n) {
+                g_score.resize(n, std::numeric_limits<double>::infinity());
+                came_from.resize(n, npos);
+                open.resize(n);
+            }
+        }
+    };
+
   private:
-    std::unordered_map<T, std::vector<std::pair<T, double>>> adj;
-    std::unordered_map<T, double> nodes;
+    vertex_index<T> ids;
+    std::vector<double> heuristic;
+    std::vector<std::vector<std::pair<uint32_t, double>>> adj;
+    search_context context;
+
+    uint32_t node(const T& u) {
+        uint32_t id = ids.intern(u);
+        if (id == heuristic.size()) {
+            heuristic.push_back(0);
+            adj.emplace_back();
+        }
+        return id;
+    }
 
   public:
     /**
@@ -33,9 +81,15 @@ template <typename T> class AStar {
             if ((!v.empty() && nodes.empty()) || (!nodes.empty() && v.empty())) {
                 throw std::logic_error("you have to provide two non empty maps");
             }
-            if (!v.empty() && !nodes.empty()) {
-                this->adj = v;
-                this->nodes = nodes;
+            for (auto& x : nodes) {
+                insert_node(x.first, x.second);
+            }
+            for (auto& x : v) {
+                uint32_t u = node(x.first);
+                for (auto& y : x.second) {
+                    uint32_t w = node(y.first);
+                    adj[u].push_back(std::make_pair(w, y.second));
+                }
             }
         } catch (std::logic_error& e) {
             std::cerr << e.what() << '\n';
@@ -47,7 +101,7 @@ template <typename T> class AStar {
      * @param u: the node ID
      * @val: the heuristic value of node u
      */
-    inline void insert_node(T u, double val) { nodes[u] = val; }
+    inline void insert_node(T u, double val) { heuristic[node(u)] = val; }
 
     /**
      * @brief has_edge function
@@ -57,11 +111,13 @@ template <typename T> class AStar {
      * @return false otherwise
      */
     inline bool has_edge(T u, T v) {
-        if (adj.find(u) != adj.end()) {
-            for (std::pair<T, double>& x : adj[u]) {
-                if (x.first == v) {
-                    return true;
-                }
+        uint32_t a = ids.id(u), b = ids.id(v);
+        if (a == npos || b == npos) {
+            return false;
+        }
+        for (std::pair<uint32_t, double>& x : adj[a]) {
+            if (x.first == b) {
+                return true;
             }
         }
         return false;
@@ -75,8 +131,9 @@ template <typename T> class AStar {
      */
     inline void add_edge(T u, T v, double dist) {
         try {
-            if (nodes.find(u) != nodes.end() && nodes.find(v) != nodes.end()) {
-                adj[u].push_back(std::make_pair(v, dist));
+            uint32_t a = ids.id(u), b = ids.id(v);
+            if (a != npos && b != npos) {
+                adj[a].push_back(std::make_pair(b, dist));
             } else {
                 throw std::logic_error("One of the two nodes that passed to the "
                                        "function do not exist in the graph");
@@ -93,50 +150,72 @@ template <typename T> class AStar {
      * @return vector<T>: the shortest path from start to end
      */
     inline std::vector<T> shortest_path(T start, T end) {
-        auto reconstruct_path = [&](std::unordered_map<T, T> cameFrom, T curr) {
-            std::vector<T> path = {curr};
-            while (cameFrom.find(curr) != cameFrom.end()) {
-                curr = cameFrom[curr];
-                path.push_back(curr);
-            }
-            std::reverse(path.begin(), path.end());
-            return path;
-        };
-        std::priority_queue<std::pair<double, T>, std::vector<std::pair<double, T>>,
-                            std::greater<std::pair<double, T>>>
-            pq;
-        std::unordered_map<T, bool> visited;
-        std::unordered_map<T, T> cameFrom;
-        std::unordered_map<T, double> gScore;
-        std::unordered_map<T, double> fScore;
-        for (auto& x : nodes) {
-            gScore[x.first] = INT_MAX;
-            fScore[x.first] = INT_MAX;
+        return shortest_path(start, end, context);
+    }
+
+    /**
+     * @brief shortest_path function
+     * Same search with a caller owned context, so concurrent queries can run with one
+     * context per thread.
+     * @param start: starting node
+     * @param end: end node
+     * @param ctx: the scratch state reused by the search
+     * @return vector<T>: the shortest path from start to end
+     */
+    std::vector<T> shortest_path(const T& start, const T& end, search_context& ctx) const {
+        uint32_t s = ids.id(start), t = ids.id(end);
+        ctx.prepare(ids.size());
+        if (s == npos || t == npos) {
+            return {};
         }
-        gScore[start] = 0;
-        fScore[start] = nodes[start];
-        pq.push(std::make_pair(0, start));
-        visited[start] = true;
-        while (!pq.empty()) {
-            auto current = pq.top();
-            if (current.second == end) {
-                return reconstruct_path(cameFrom, current.second);
+        ctx.g_score[s] = 0;
+        ctx.touched.push_back(s);
+        ctx.open.push(s, heuristic[s]);
+        while (!ctx.open.empty()) {
+            uint32_t u = ctx.open.pop();
+            if (u == t) {
+                std::vector<T> path;
+                for (; u != npos; u = ctx.came_from[u]) {
+                    path.push_back(ids.vertex(u));
+                }
+                std::reverse(path.begin(), path.end());
+                return path;
             }
-            pq.pop();
-            for (auto& x : adj[current.second]) {
-                double tentative_gscore = gScore[current.second] + x.second;
-                if (tentative_gscore < gScore[x.first]) {
-                    cameFrom[x.first] = current.second;
-                    gScore[x.first] = tentative_gscore;
-                    fScore[x.first] = tentative_gscore + nodes[x.first];
-                    if (visited.find(x.first) == visited.end()) {
-                        pq.push(std::make_pair(tentative_gscore + nodes[x.first], x.first));
+            for (const std::pair<uint32_t, double>& x : adj[u]) {
+                uint32_t v = x.first;
+                double tentative_gscore = ctx.g_score[u] + x.second;
+                if (tentative_gscore < ctx.g_score[v]) {
+                    if (ctx.g_score[v] == std::numeric_limits<double>::infinity()) {
+                        ctx.touched.push_back(v);
                     }
+                    ctx.came_from[v] = u;
+                    ctx.g_score[v] = tentative_gscore;
+                    // decrease-key if v is open, reopened if an inadmissible heuristic
+                    // closed it too early
+                    ctx.open.push(v, tentative_gscore + heuristic[v]);
                 }
             }
         }
         return {};
     }
+
+    /**
+     * @brief shortest_path_batch function
+     * Answers independent queries on worker threads, the graph is shared read-only and
+     * every worker owns a search_context.
+     * @param queries: the (start, end) pairs
+     * @param threads: number of worker threads(0 means every hardware thread)
+     * @return vector<vector<T>>: the shortest path of every query, in query order
+     */
+    std::vector<std::vector<T>> shortest_path_batch(const std::vector<std::pair<T, T>>& queries,
+                                                    size_t threads = 0) const {
+        std::vector<std::vector<T>> paths(queries.size());
+        std::vector<search_context> contexts(PARALLEL::resolve_threads(threads, queries.size()));
+        PARALLEL::parallel_for_dynamic(0, queries.size(), threads, [&](size_t i, size_t tid) {
+            paths[i] = shortest_path(queries[i].first, queries[i].second, contexts[tid]);
+        });
+        return paths;
+    }
 };
 
 #endif
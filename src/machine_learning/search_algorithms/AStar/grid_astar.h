@@ -0,0 +1,355 @@
+#ifndef GRID_ASTAR_H
+#define GRID_ASTAR_H
+
+#include "../../../classes/heap/indexed_heap.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#endif
+
+/**
+ * @brief occupancy_grid class
+ * 2D obstacle map packed one bit per cell(a 4096x4096 map takes 2MB). Cells outside
+ * the map count as blocked.
+ */
+class occupancy_grid {
+  public:
+    /**
+     * @brief Construct a new occupancy_grid object, every cell is free
+     * @param width: the number of columns.
+     * @param height: the number of rows.
+     */
+    occupancy_grid(int32_t width = 0, int32_t height = 0) : _width(width), _height(height) {
+        if (width < 0 || height < 0 || int64_t(width) * height > UINT32_MAX) {
+            throw std::invalid_argument("occupancy_grid: invalid dimensions");
+        }
+        _stride = (static_cast<size_t>(width) + 63) / 64;
+        _bits.assign(_stride * height, 0);
+    }
+
+    int32_t width() const { return _width; }
+
+    int32_t height() const { return _height; }
+
+    /**
+     * @brief blocked function
+     * @returns true if (x, y) is an obstacle or outside the map.
+     */
+    bool blocked(int32_t x, int32_t y) const {
+        if (x < 0 || y < 0 || x >= _width || y >= _height) {
+            return true;
+        }
+        return (_bits[y * _stride + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    /**
+     * @brief free function
+     * @returns true if (x, y) is inside the map and not an obstacle.
+     */
+    bool free(int32_t x, int32_t y) const { return !blocked(x, y); }
+
+    /**
+     * @brief set_blocked function
+     * @param x: the column of the cell.
+     * @param y: the row of the cell.
+     * @param value: true for an obstacle, false for a free cell. Default = true
+     */
+    void set_blocked(int32_t x, int32_t y, bool value = true) {
+        if (x < 0 || y < 0 || x >= _width || y >= _height) {
+            throw std::out_of_range("occupancy_grid: cell outside the map");
+        }
+        uint64_t& word = _bits[y * _stride + (x >> 6)];
+        uint64_t mask = uint64_t(1) << (x & 63);
+        word = value ? word | mask : word & ~mask;
+    }
+
+    /**
+     * @brief bytes function
+     * @returns size_t the memory used by the obstacle bits.
+     */
+    size_t bytes() const { return _bits.size() * sizeof(uint64_t); }
+
+  private:
+    int32_t _width, _height;
+    size_t _stride;
+    std::vector<uint64_t> _bits;
+};
+
+/**
+ * @brief a cell of an occupancy_grid
+ */
+struct grid_point {
+    int32_t x{0}, y{0};
+
+    bool operator==(const grid_point&) const = default;
+};
+
+/**
+ * @brief allowed moves: four(orthogonal, cost 1) or eight(plus diagonals, cost sqrt(2),
+ * a diagonal is only allowed if both orthogonal cells next to it are free)
+ */
+enum class grid_connectivity { four, eight };
+
+/**
+ * @brief distance estimate of grid_astar: manhattan(exact on four connected grids) or
+ * octile(exact on eight connected grids)
+ */
+enum class grid_heuristic { manhattan, octile };
+
+/**
+ * @brief options of grid_astar
+ * @param connectivity: four or eight.
+ * @param heuristic: manhattan or octile, use the one matching the connectivity to get
+ * shortest paths(manhattan overestimates diagonal moves).
+ * @param jump_points: prune the search with Jump Point Search(eight connectivity only,
+ * ignored otherwise).
+ */
+struct grid_search_options {
+    grid_connectivity connectivity{grid_connectivity::eight};
+    grid_heuristic heuristic{grid_heuristic::octile};
+    bool jump_points{true};
+};
+
+/**
+ * @brief grid_astar class
+ * A* on an occupancy_grid with implicit neighbors: no node or edge is materialized.
+ * With jump_points the open set only holds jump points: straight and diagonal runs are
+ * followed until a forced neighbor appears(Harabor and Grastien, no corner cutting),
+ * which removes most of the symmetric paths of open areas. The search state is kept
+ * only for the touched cells and reused between queries. The grid must outlive the
+ * object.
+ */
+class grid_astar {
+  public:
+    /**
+     * @brief Construct a new grid_astar object
+     * @param grid: the obstacle map.
+     * @param opt: connectivity, heuristic and pruning.
+     */
+    explicit grid_astar(const occupancy_grid& grid, grid_search_options opt = {})
+        : _grid(grid), _opt(opt) {}
+
+    /**
+     * @brief shortest_path function
+     * @param start: the first cell.
+     * @param goal: the last cell.
+     * @returns vector<grid_point> every cell of the path from start to goal, empty if
+     * goal is unreachable or one of the cells is blocked.
+     */
+    std::vector<grid_point> shortest_path(grid_point start, grid_point goal);
+
+    /**
+     * @brief cost function
+     * @returns double the length of the last path found, -1 if there was none.
+     */
+    double cost() const { return _cost; }
+
+    /**
+     * @brief expanded function
+     * @returns size_t the number of nodes popped from the open set by the last search.
+     */
+    size_t expanded() const { return _expanded; }
+
+  private:
+    struct _node {
+        uint32_t cell;
+        uint32_t parent;
+        double g;
+    };
+
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    const occupancy_grid& _grid;
+    grid_search_options _opt;
+    std::unordered_map<uint32_t, uint32_t> _slot;
+    std::vector<_node> _nodes;
+    indexed_heap<double> _open;
+    grid_point _goal;
+    double _cost{-1};
+    size_t _expanded{0};
+
+    uint32_t _cell(int32_t x, int32_t y) const {
+        return static_cast<uint32_t>(y) * static_cast<uint32_t>(_grid.width()) +
+               static_cast<uint32_t>(x);
+    }
+
+    grid_point _point(uint32_t cell) const {
+        return {static_cast<int32_t>(cell % _grid.width()),
+                static_cast<int32_t>(cell / _grid.width())};
+    }
+
+    double _h(int32_t x, int32_t y) const {
+        double dx = std::abs(x - _goal.x), dy = std::abs(y - _goal.y);
+        if (_opt.heuristic == grid_heuristic::manhattan) {
+            return dx + dy;
+        }
+        return std::max(dx, dy) + (std::sqrt(2.0) - 1) * std::min(dx, dy);
+    }
+
+    static double _octile(grid_point a, grid_point b) {
+        double dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+        return std::max(dx, dy) + (std::sqrt(2.0) - 1) * std::min(dx, dy);
+    }
+
+    bool _can_move(int32_t x, int32_t y, int32_t dx, int32_t dy) const {
+        if (!_grid.free(x + dx, y + dy)) {
+            return false;
+        }
+        return dx == 0 || dy == 0 || (_grid.free(x + dx, y) && _grid.free(x, y + dy));
+    }
+
+    void _relax(uint32_t from, int32_t x, int32_t y, double g) {
+        auto [it, inserted] = _slot.try_emplace(_cell(x, y), static_cast<uint32_t>(_nodes.size()));
+        uint32_t i = it->second;
+        if (inserted) {
+            _nodes.push_back({it->first, from, g});
+            _open.resize(_nodes.size());
+        } else if (g < _nodes[i].g) {
+            _nodes[i].parent = from;
+            _nodes[i].g = g;
+        } else {
+            return;
+        }
+        _open.push(i, g + _h(x, y));
+    }
+
+    /**
+     * @brief follows direction (dx, dy) from the cell after (x, y) until a jump point,
+     * returns false if the run hits an obstacle first
+     */
+    bool _jump(int32_t& x, int32_t& y, int32_t dx, int32_t dy) const {
+        while (_can_move(x, y, dx, dy)) {
+            x += dx, y += dy;
+            if (x == _goal.x && y == _goal.y) {
+                return true;
+            }
+            if (dx != 0 && dy != 0) {
+                int32_t hx = x, hy = y, vx = x, vy = y;
+                if (_jump(hx, hy, dx, 0) || _jump(vx, vy, 0, dy)) {
+                    return true;
+                }
+            } else if (dx != 0) {
+                if ((_grid.free(x, y - 1) && _grid.blocked(x - dx, y - 1)) ||
+                    (_grid.free(x, y + 1) && _grid.blocked(x - dx, y + 1))) {
+                    return true;
+                }
+            } else if ((_grid.free(x - 1, y) && _grid.blocked(x - 1, y - dy)) ||
+                       (_grid.free(x + 1, y) && _grid.blocked(x + 1, y - dy))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief the directions worth following from a cell reached with (dx, dy), every
+     * direction for the start
+     */
+    void _directions(int32_t x, int32_t y, int32_t dx, int32_t dy,
+                     std::vector<std::pair<int32_t, int32_t>>& out) const {
+        out.clear();
+        if (dx == 0 && dy == 0) {
+            for (int32_t a = -1; a <= 1; a++) {
+                for (int32_t b = -1; b <= 1; b++) {
+                    if (a != 0 || b != 0) {
+                        out.push_back({a, b});
+                    }
+                }
+            }
+        } else if (dx != 0 && dy != 0) {
+            out.push_back({dx, 0});
+            out.push_back({0, dy});
+            out.push_back({dx, dy});
+        } else if (dx != 0) {
+            out.push_back({dx, 0});
+            for (int32_t side : {-1, 1}) {
+                if (_grid.free(x, y + side)) {
+                    out.push_back({0, side});
+                    out.push_back({dx, side});
+                }
+            }
+        } else {
+            out.push_back({0, dy});
+            for (int32_t side : {-1, 1}) {
+                if (_grid.free(x + side, y)) {
+                    out.push_back({side, 0});
+                    out.push_back({side, dy});
+                }
+            }
+        }
+    }
+};
+
+inline std::vector<grid_point> grid_astar::shortest_path(grid_point start, grid_point goal) {
+    _slot.clear();
+    _nodes.clear();
+    _open.clear();
+    _cost = -1;
+    _expanded = 0;
+    if (_grid.blocked(start.x, start.y) || _grid.blocked(goal.x, goal.y)) {
+        return {};
+    }
+    _goal = goal;
+    const bool eight = _opt.connectivity == grid_connectivity::eight;
+    const bool jps = eight && _opt.jump_points;
+    const double diagonal = std::sqrt(2.0);
+    const uint32_t target = _cell(goal.x, goal.y);
+    std::vector<std::pair<int32_t, int32_t>> dirs;
+    _relax(npos, start.x, start.y, 0);
+
+    while (!_open.empty()) {
+        uint32_t i = _open.pop();
+        _expanded++;
+        const _node n = _nodes[i];
+        grid_point p = _point(n.cell);
+        if (n.cell == target) {
+            _cost = n.g;
+            std::vector<grid_point> path = {p};
+            for (uint32_t j = n.parent; j != npos; j = _nodes[j].parent) {
+                // jump points are joined by straight or diagonal runs
+                grid_point q = _point(_nodes[j].cell), c = path.back();
+                int32_t sx = (q.x > c.x) - (q.x < c.x), sy = (q.y > c.y) - (q.y < c.y);
+                while (!(c == q)) {
+                    c.x += sx, c.y += sy;
+                    path.push_back(c);
+                }
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+        if (!jps) {
+            for (int32_t dy = -1; dy <= 1; dy++) {
+                for (int32_t dx = -1; dx <= 1; dx++) {
+                    if ((dx == 0 && dy == 0) || (!eight && dx != 0 && dy != 0) ||
+                        !_can_move(p.x, p.y, dx, dy)) {
+                        continue;
+                    }
+                    _relax(i, p.x + dx, p.y + dy, n.g + (dx != 0 && dy != 0 ? diagonal : 1));
+                }
+            }
+            continue;
+        }
+        int32_t dx = 0, dy = 0;
+        if (n.parent != npos) {
+            grid_point q = _point(_nodes[n.parent].cell);
+            dx = (p.x > q.x) - (p.x < q.x), dy = (p.y > q.y) - (p.y < q.y);
+        }
+        _directions(p.x, p.y, dx, dy, dirs);
+        for (auto [ax, ay] : dirs) {
+            int32_t x = p.x, y = p.y;
+            if (_jump(x, y, ax, ay)) {
+                _relax(i, x, y, n.g + _octile(p, {x, y}));
+            }
+        }
+    }
+    return {};
+}
+
+#endif
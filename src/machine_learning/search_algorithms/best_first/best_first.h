@@ -1,20 +1,112 @@
 #ifndef BEST_FIRST_H
 #define BEST_FIRST_H
 
+#include "../../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <algorithm>
+#include <chrono>
 #include <climits>
+#include <cstdint>
+#include <functional>
 #include <iostream>
-#include <queue>
+#include <limits>
 #include <unordered_map>
+#include <vector>
 #endif
 
+/**
+ * @brief options of best_first::beam_search
+ * @param width: the number of nodes kept per level(the beam).
+ * @param max_expansions: expansion budget, 0 means no budget.
+ * @param time_budget: wall clock budget, 0 means no budget.
+ * @param anytime: if a level had to drop candidates and the goal was not reached, search
+ * again with a doubled width until the goal is found, a budget runs out or nothing is
+ * dropped anymore.
+ */
+struct beam_options {
+    size_t width{64};
+    size_t max_expansions{0};
+    std::chrono::milliseconds time_budget{0};
+    bool anytime{false};
+};
+
 /**
  * @brief best first class
  */
 template <typename T> class best_first {
+  public:
+    /**
+     * @brief search_context class
+     * Visited set and queue of one search, kept between queries so that their memory is
+     * reused. A context is not shared, use one per thread.
+     */
+    class search_context {
+      private:
+        friend class best_first;
+        std::unordered_map<T, bool> visited;
+        std::vector<std::pair<T, double>> q;
+    };
+
+    /**
+     * @brief result of beam_search
+     * @param found: true if path ends at the end node.
+     * @param path: the path to the end node, otherwise the path to the node with the
+     * lowest heuristic value that was reached.
+     * @param expanded: the number of nodes expanded by every run.
+     */
+    struct beam_result {
+        bool found{false};
+        std::vector<T> path;
+        size_t expanded{0};
+    };
+
   private:
     std::unordered_map<T, std::vector<std::pair<T, double>>> adj;
     std::unordered_map<T, double> nodes;
+    search_context context;
+
+    /**
+     * @brief the k candidates with the lowest heuristic value, a max-heap whose capacity
+     * is fixed by reset()
+     */
+    struct top_k {
+        struct item {
+            double h;
+            T node;
+            uint32_t parent;
+            bool operator<(const item& other) const { return h < other.h; }
+        };
+        std::vector<item> heap;
+        size_t capacity{0};
+        bool dropped{false};
+
+        void reset(size_t k) {
+            heap.clear();
+            heap.reserve(k);
+            capacity = k;
+            dropped = false;
+        }
+
+        void offer(double h, const T& node, uint32_t parent) {
+            if (heap.size() < capacity) {
+                heap.push_back({h, node, parent});
+                std::push_heap(heap.begin(), heap.end());
+                return;
+            }
+            dropped = true;
+            if (h < heap.front().h) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = {h, node, parent};
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    };
+
+    double heuristic(const T& u) const {
+        auto it = nodes.find(u);
+        return it == nodes.end() ? 0 : it->second;
+    }
 
   public:
     /**
@@ -90,35 +182,168 @@ template <typename T> class best_first {
      * @return true if search found the end node.
      * @return false otherwise
      */
-    inline bool search(T start, T end) {
+    inline bool search(T start, T end) { return search(start, end, context); }
+
+    /**
+     * @brief search function
+     * Same search with a caller owned context, the object is only read.
+     * @param start: starting node
+     * @param end: end node
+     * @param ctx: the scratch state reused by the search
+     * @return true if search found the end node.
+     * @return false otherwise
+     */
+    bool search(const T& start, const T& end, search_context& ctx) const {
         if (adj.empty()) {
             return false;
         }
-        std::unordered_map<T, bool> visited;
-        std::priority_queue<std::pair<T, double>, std::vector<std::pair<T, double>>,
-                            std::greater<std::pair<T, double>>>
-            q;
-        q.push({start, nodes[start]});
+        using entry = std::pair<T, double>;
+        std::unordered_map<T, bool>& visited = ctx.visited;
+        std::vector<entry>& q = ctx.q;
+        visited.clear();
+        q.clear();
+        q.push_back({start, heuristic(start)});
         visited[start] = true;
         while (!q.empty()) {
             int64_t size = q.size();
-            for (int64_t i = 0; i < size; i++) {
-                std::pair<T, double> current = q.top();
+            for (int64_t i = 0; i < size && !q.empty(); i++) {
+                std::pair<T, double> current = q.front();
                 if (current.first == end) {
                     return true;
                 }
-                q.pop();
-                for (std::pair<T, double>& x : adj[current.first]) {
+                std::pop_heap(q.begin(), q.end(), std::greater<entry>());
+                q.pop_back();
+                auto it = adj.find(current.first);
+                if (it == adj.end()) {
+                    continue;
+                }
+                for (const std::pair<T, double>& x : it->second) {
                     if (visited.find(x.first) == visited.end() &&
-                        x.second <= nodes[current.first]) {
+                        x.second <= heuristic(current.first)) {
                         visited[x.first] = true;
-                        q.push({x.first, nodes[x.first]});
+                        q.push_back({x.first, heuristic(x.first)});
+                        std::push_heap(q.begin(), q.end(), std::greater<entry>());
                     }
                 }
             }
         }
         return false;
     }
+
+    /**
+     * @brief beam_search function
+     * Level by level search that keeps only the opt.width candidates with the lowest
+     * heuristic value of every level in a fixed size heap, so the open set never grows
+     * beyond the beam and the memory is bounded by width times the depth reached.
+     * Unlike search() the heuristic does not have to decrease along the path.
+     * @param start: starting node
+     * @param end: end node
+     * @param opt: beam width, budgets and anytime mode
+     * @return beam_result: the path to end, or the most promising path found so far.
+     */
+    beam_result beam_search(const T& start, const T& end, const beam_options& opt = {}) const;
+
+    /**
+     * @brief search_batch function
+     * Answers independent queries on worker threads, the graph is shared read-only and
+     * every worker owns a search_context.
+     * @param queries: the (start, end) pairs
+     * @param threads: number of worker threads(0 means every hardware thread)
+     * @return vector<bool>: whether the end node of every query was found, in query order
+     */
+    std::vector<bool> search_batch(const std::vector<std::pair<T, T>>& queries,
+                                   size_t threads = 0) const {
+        std::vector<uint8_t> found(queries.size(), 0);
+        std::vector<search_context> contexts(PARALLEL::resolve_threads(threads, queries.size()));
+        PARALLEL::parallel_for_dynamic(0, queries.size(), threads, [&](size_t i, size_t tid) {
+            found[i] = search(queries[i].first, queries[i].second, contexts[tid]);
+        });
+        return std::vector<bool>(found.begin(), found.end());
+    }
 };
 
+template <typename T>
+typename best_first<T>::beam_result best_first<T>::beam_search(const T& start, const T& end,
+                                                               const beam_options& opt) const {
+    constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+    const auto deadline = std::chrono::steady_clock::now() + opt.time_budget;
+    beam_result result;
+    result.path = {start};
+    if (start == end) {
+        result.found = true;
+        return result;
+    }
+    double best_h = heuristic(start);
+    // trail holds every node that entered a beam with the index of its parent
+    std::vector<std::pair<T, uint32_t>> trail;
+    std::vector<uint32_t> beam, next;
+    std::unordered_map<T, bool> visited;
+    top_k candidates;
+    auto path_to = [&](uint32_t i, const T* last) {
+        std::vector<T> path;
+        if (last != nullptr) {
+            path.push_back(*last);
+        }
+        for (; i != npos; i = trail[i].second) {
+            path.push_back(trail[i].first);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    };
+    bool out_of_budget = false;
+
+    for (size_t width = std::max<size_t>(1, opt.width);; width *= 2) {
+        trail.assign(1, {start, npos});
+        visited.clear();
+        visited[start] = true;
+        beam.assign(1, 0);
+        bool dropped = false;
+        while (!beam.empty() && !out_of_budget) {
+            candidates.reset(width);
+            for (uint32_t i : beam) {
+                if ((opt.max_expansions != 0 && result.expanded >= opt.max_expansions) ||
+                    (opt.time_budget.count() != 0 &&
+                     std::chrono::steady_clock::now() >= deadline)) {
+                    out_of_budget = true;
+                    break;
+                }
+                result.expanded++;
+                auto it = adj.find(trail[i].first);
+                if (it == adj.end()) {
+                    continue;
+                }
+                for (const std::pair<T, double>& x : it->second) {
+                    if (x.first == end) {
+                        result.found = true;
+                        result.path = path_to(i, &end);
+                        return result;
+                    }
+                    if (visited.find(x.first) == visited.end()) {
+                        candidates.offer(heuristic(x.first), x.first, i);
+                    }
+                }
+            }
+            dropped |= candidates.dropped;
+            next.clear();
+            std::sort_heap(candidates.heap.begin(), candidates.heap.end());
+            for (auto& c : candidates.heap) {
+                // two nodes of the beam may offer the same neighbor
+                if (!visited.emplace(c.node, true).second) {
+                    continue;
+                }
+                trail.push_back({c.node, c.parent});
+                next.push_back(static_cast<uint32_t>(trail.size() - 1));
+                if (c.h < best_h) {
+                    best_h = c.h;
+                    result.path = path_to(next.back(), nullptr);
+                }
+            }
+            beam.swap(next);
+        }
+        if (!opt.anytime || !dropped || out_of_budget) {
+            return result;
+        }
+    }
+}
+
 #endif
@@ -1,14 +1,43 @@
 #ifndef HILL_CLIMBING_H
 #define HILL_CLIMBING_H
 
+#include "../../../helpers/parallel.h"
+
 #ifdef __cplusplus
+#include <atomic>
 #include <climits>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <queue>
+#include <random>
 #include <unordered_map>
+#include <vector>
 #endif
 
+/**
+ * @brief options of hill_climbing::random_restart
+ * @param restarts: the number of independent climbs, each from a random node.
+ * @param max_steps: upper bound on the moves of one climb.
+ * @param temperature: starting temperature of the simulated annealing acceptance, 0
+ * means a greedy climb that moves to the best neighbor while it improves.
+ * @param cooling: factor applied to the temperature after every move.
+ * @param target: every climber stops once a node with a value at most target is found.
+ * @param seed: seed of the random generators, restart i always uses the same sequence.
+ * @param threads: number of worker threads(0 means every hardware thread).
+ */
+struct climb_options {
+    size_t restarts{64};
+    size_t max_steps{1000};
+    double temperature{0};
+    double cooling{0.995};
+    double target{-std::numeric_limits<double>::infinity()};
+    uint64_t seed{0};
+    size_t threads{0};
+};
+
 /**
  * @brief hill climbing class
  */
@@ -17,7 +46,28 @@ template <typename T> class hill_climbing {
     std::unordered_map<T, std::vector<std::pair<T, double>>> adj;
     std::unordered_map<T, double> nodes;
 
+    double value(const T& u) const {
+        auto it = nodes.find(u);
+        return it == nodes.end() ? std::numeric_limits<double>::infinity() : it->second;
+    }
+
+    template <typename Rng>
+    std::pair<T, double> climb(T current, const climb_options& opt, Rng& rng,
+                               const std::atomic<double>& best) const;
+
   public:
+    /**
+     * @brief result of random_restart
+     * @param found: false if the graph has no nodes.
+     * @param node: the node with the lowest value reached by any climb.
+     * @param value: the value of node.
+     */
+    struct climb_result {
+        bool found{false};
+        T node{};
+        double value{std::numeric_limits<double>::infinity()};
+    };
+
     /**
      * @brief hill_climbing constructor
      * @param v: unordered_map<T, pair<T, double> > initializer vector. Default =
@@ -119,6 +169,95 @@ template <typename T> class hill_climbing {
         }
         return false;
     }
+
+    /**
+     * @brief random_restart function
+     * Runs opt.restarts independent climbs towards the node with the lowest value on
+     * worker threads. Every thread owns its random generator, the best value found so
+     * far is shared through an atomic so that a climb only locks when it improves it.
+     * @param opt: restarts, step limit, annealing schedule, target and threads.
+     * @return climb_result: the best node found.
+     */
+    climb_result random_restart(const climb_options& opt = {}) const;
 };
 
+template <typename T>
+template <typename Rng>
+std::pair<T, double> hill_climbing<T>::climb(T current, const climb_options& opt, Rng& rng,
+                                             const std::atomic<double>& best) const {
+    double current_value = value(current), temperature = opt.temperature;
+    std::pair<T, double> found = {current, current_value};
+    std::uniform_real_distribution<double> uniform(0, 1);
+    for (size_t step = 0; step < opt.max_steps; step++) {
+        if (best.load(std::memory_order_relaxed) <= opt.target) {
+            break;
+        }
+        auto it = adj.find(current);
+        if (it == adj.end() || it->second.empty()) {
+            break;
+        }
+        const std::vector<std::pair<T, double>>& neighbors = it->second;
+        if (temperature <= 0) {
+            const T* next = nullptr;
+            double next_value = current_value;
+            for (const std::pair<T, double>& x : neighbors) {
+                double v = value(x.first);
+                if (v < next_value) {
+                    next = &x.first, next_value = v;
+                }
+            }
+            if (next == nullptr) {
+                break;
+            }
+            current = *next, current_value = next_value;
+        } else {
+            const T& next = neighbors[rng() % neighbors.size()].first;
+            double delta = value(next) - current_value;
+            if (delta <= 0 || uniform(rng) < std::exp(-delta / temperature)) {
+                current = next, current_value += delta;
+            }
+            temperature *= opt.cooling;
+        }
+        if (current_value < found.second) {
+            found = {current, current_value};
+        }
+    }
+    return found;
+}
+
+template <typename T>
+typename hill_climbing<T>::climb_result
+hill_climbing<T>::random_restart(const climb_options& opt) const {
+    climb_result result;
+    if (nodes.empty() || opt.restarts == 0) {
+        return result;
+    }
+    std::vector<T> keys;
+    keys.reserve(nodes.size());
+    for (auto& x : nodes) {
+        keys.push_back(x.first);
+    }
+    const size_t threads = PARALLEL::resolve_threads(opt.threads, opt.restarts);
+    std::vector<std::mt19937_64> rngs(threads);
+    std::atomic<double> best{std::numeric_limits<double>::infinity()};
+    size_t best_restart = SIZE_MAX;
+    std::mutex lock;
+    PARALLEL::parallel_for_dynamic(0, opt.restarts, threads, [&](size_t i, size_t tid) {
+        std::mt19937_64& rng = rngs[tid];
+        rng.seed(opt.seed + 0x9E3779B97F4A7C15ULL * (i + 1));
+        std::pair<T, double> found = climb(keys[rng() % keys.size()], opt, rng, best);
+        if (found.second > best.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        // ties go to the lowest restart, so the result does not depend on scheduling
+        if (found.second < result.value || (found.second == result.value && i < best_restart)) {
+            result = {true, found.first, found.second};
+            best_restart = i;
+            best.store(found.second, std::memory_order_relaxed);
+        }
+    });
+    return result;
+}
+
 #endif
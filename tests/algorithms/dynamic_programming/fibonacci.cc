@@ -25,4 +25,43 @@ TEST_CASE("testing fibonacci functions") {
     REQUIRE(fibonacci_dp(n4) == ans4);
     REQUIRE(fibonacci_bottom_up(n4) == ans4);
     REQUIRE(fibonacci_binet(n4) == ans4);
-}
\ No newline at end of file
+}
+
+TEST_CASE("testing fast doubling fibonacci") {
+    static_assert(fibonacci_doubling(10) == 55);
+    static_assert(fib_mod(10, 7) == 55 % 7);
+    for (int64_t n = 0; n <= 92; n++) {
+        REQUIRE(fibonacci_doubling(n) == fibonacci_bottom_up(n));
+    }
+    REQUIRE(fibonacci_doubling(92) == 7540113804746346429);
+    REQUIRE_THROWS_AS(fibonacci_doubling(93), std::out_of_range);
+    REQUIRE_THROWS_AS(fibonacci_doubling(-1), std::out_of_range);
+}
+
+TEST_CASE("testing fibonacci modulo m") {
+    for (uint64_t m : {1ULL, 2ULL, 10ULL, 1000000007ULL, 18446744073709551557ULL}) {
+        uint64_t a = 0, b = 1 % m;
+        for (uint64_t n = 0; n < 200; n++) {
+            REQUIRE(fib_mod(n, m) == a);
+            uint64_t c = uint64_t(((unsigned __int128)a + b) % m);
+            a = b;
+            b = c;
+        }
+    }
+    // the Pisano period of 10 is 60
+    REQUIRE(fib_mod(1000000000000000000ULL, 10) == fib_mod(1000000000000000000ULL % 60, 10));
+    REQUIRE_THROWS_AS(fib_mod(5, 0), std::invalid_argument);
+}
+
+TEST_CASE("testing fibonacci with big integers") {
+    REQUIRE(fibonacci_big(0).to_string() == "0");
+    REQUIRE(fibonacci_big(1).to_string() == "1");
+    for (uint64_t n = 0; n <= 92; n++) {
+        REQUIRE(fibonacci_big(n) == big_uint(uint64_t(fibonacci_doubling(int64_t(n)))));
+    }
+    REQUIRE(fibonacci_big(100).to_string() == "354224848179261915075");
+    // F(1000) has 209 digits, F(2n) = F(n)(F(n - 1) + F(n + 1))
+    big_uint f = fibonacci_big(1000);
+    REQUIRE(f.to_string().size() == 209);
+    REQUIRE(f * (fibonacci_big(999) + fibonacci_big(1001)) == fibonacci_big(2000));
+}
@@ -12,4 +12,102 @@ TEST_CASE("testing kadane's algo") {
     v.clear();
     v = {1, 4, 5, 6, 7, 8};
     REQUIRE(kadane(v) == 31);
-}
\ No newline at end of file
+}
+
+TEST_CASE("testing kadane's subarray bounds") {
+    std::vector<int> v = {1, 4, 5, -5, -6, 4, 10, 15, -10};
+    REQUIRE(kadane_subarray(std::span<const int>(v)) == max_subarray<int64_t>{29, 5, 7});
+
+    v = {-3, -1, -2};
+    REQUIRE(kadane_subarray(std::span<const int>(v)) == max_subarray<int64_t>{-1, 1, 1});
+
+    std::vector<double> d = {-1.5, 2.5, -0.5, 1.0, -4.0};
+    auto s = kadane_subarray(std::span<const double>(d));
+    REQUIRE(s.sum == 3.0);
+    REQUIRE(s.start == 1);
+    REQUIRE(s.end == 3);
+
+    REQUIRE_THROWS_AS(kadane_subarray(std::span<const int>()), std::invalid_argument);
+    REQUIRE(kadane(std::vector<int>()) == INT_MIN);
+}
+
+TEST_CASE("testing parallel kadane") {
+    std::vector<int> v(300000);
+    uint64_t x = 12345;
+    for (int& e : v) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        e = int(x >> 33) % 2001 - 1000;
+    }
+    auto serial = kadane_subarray(std::span<const int>(v));
+    for (size_t threads : {1, 2, 3, 8}) {
+        auto p = kadane_parallel(std::span<const int>(v), threads);
+        REQUIRE(p.sum == serial.sum);
+        int64_t sum = 0;
+        for (size_t i = p.start; i <= p.end; i++) {
+            sum += v[i];
+        }
+        REQUIRE(sum == p.sum);
+    }
+    // the best subarray crosses every part
+    std::vector<int> all(200000, 1);
+    all[0] = -5;
+    REQUIRE(kadane_parallel(std::span<const int>(all), 4) ==
+            max_subarray<int64_t>{199999, 1, 199999});
+    REQUIRE_THROWS_AS(kadane_parallel(std::span<const int>()), std::invalid_argument);
+}
+
+TEST_CASE("testing maximum sum submatrix") {
+    std::vector<std::vector<int>> grid = {{1, 2, -1, -4, -20},
+                                          {-8, -3, 4, 2, 1},
+                                          {3, 8, 10, 1, 3},
+                                          {-4, -1, 1, 7, -6}};
+    REQUIRE(maximum_submatrix(grid) == max_submatrix<int64_t>{29, 1, 1, 3, 3});
+
+    std::vector<std::vector<int>> tall = {{-1}, {3}, {-2}, {4}, {-7}};
+    REQUIRE(maximum_submatrix(tall) == max_submatrix<int64_t>{5, 1, 0, 3, 0});
+
+    std::vector<std::vector<int>> negative = {{-5, -2}, {-3, -4}};
+    REQUIRE(maximum_submatrix(negative) == max_submatrix<int64_t>{-2, 0, 1, 0, 1});
+
+    // against brute force on random grids, wide and tall
+    uint64_t x = 7;
+    for (auto [r, c] : {std::pair<size_t, size_t>{6, 9}, {9, 6}, {1, 7}, {7, 1}}) {
+        std::vector<std::vector<int>> g(r, std::vector<int>(c));
+        for (auto& row : g) {
+            for (int& e : row) {
+                x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                e = int(x >> 33) % 21 - 10;
+            }
+        }
+        int64_t best = INT64_MIN;
+        for (size_t t = 0; t < r; t++) {
+            for (size_t b = t; b < r; b++) {
+                for (size_t l = 0; l < c; l++) {
+                    for (size_t rr = l; rr < c; rr++) {
+                        int64_t s = 0;
+                        for (size_t i = t; i <= b; i++) {
+                            for (size_t j = l; j <= rr; j++) {
+                                s += g[i][j];
+                            }
+                        }
+                        best = std::max(best, s);
+                    }
+                }
+            }
+        }
+        auto one = maximum_submatrix(g);
+        REQUIRE(one.sum == best);
+        int64_t s = 0;
+        for (size_t i = one.top; i <= one.bottom; i++) {
+            for (size_t j = one.left; j <= one.right; j++) {
+                s += g[i][j];
+            }
+        }
+        REQUIRE(s == best);
+        REQUIRE(maximum_submatrix(g, 4) == one);
+    }
+
+    REQUIRE_THROWS_AS(maximum_submatrix(std::vector<std::vector<int>>()), std::invalid_argument);
+    std::vector<std::vector<int>> ragged = {{1, 2}, {3}};
+    REQUIRE_THROWS_AS(maximum_submatrix(ragged), std::invalid_argument);
+}
@@ -1,5 +1,9 @@
 #include "../../../src/algorithms/dynamic_programming/knapsack_2d.h"
 #include "../../../third_party/catch.hpp"
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 TEST_CASE("Testing knapsack 0/1 [1]") {
     std::vector<std::pair<int, int>> v = {{10, 60}, {20, 100}, {30, 120}};
@@ -10,3 +14,51 @@ TEST_CASE("Testing knapsack 0/1 [1]") {
 
     REQUIRE(knapsack(v, 10) == 70);
 }
+
+TEST_CASE("Testing knapsack items and threads") {
+    std::vector<std::pair<int, int>> v = {{5, 40}, {3, 20}, {6, 10}, {3, 30}};
+    REQUIRE(knapsack_max_value(v, 10) == 70);
+    REQUIRE(knapsack_items(v, 10) == std::vector<size_t>{0, 3});
+    REQUIRE(knapsack_items(v, 2).empty());
+    REQUIRE(knapsack_items({}, 5).empty());
+    REQUIRE_THROWS_AS(knapsack_max_value({{-1, 3}}, 5), std::invalid_argument);
+
+    std::mt19937 rng(90);
+    for (size_t rep = 0; rep < 20; rep++) {
+        std::vector<std::pair<int, int>> items(1 + rng() % 12);
+        for (auto& [w, value] : items) {
+            w = int(rng() % 40);
+            value = int(rng() % 100) - 10;
+        }
+        size_t capacity = rng() % 150;
+        // every subset, for the reference
+        int64_t best = 0;
+        for (size_t mask = 0; mask < (size_t(1) << items.size()); mask++) {
+            int64_t weight = 0, value = 0;
+            for (size_t i = 0; i < items.size(); i++) {
+                if (mask >> i & 1) {
+                    weight += items[i].first;
+                    value += items[i].second;
+                }
+            }
+            if (weight <= int64_t(capacity)) {
+                best = std::max(best, value);
+            }
+        }
+        REQUIRE(knapsack_max_value(items, capacity) == best);
+        std::vector<size_t> chosen = knapsack_items(items, capacity, 1 + rep % 3);
+        int64_t weight = 0, value = 0;
+        for (size_t i : chosen) {
+            weight += items[i].first;
+            value += items[i].second;
+        }
+        REQUIRE(weight <= int64_t(capacity));
+        REQUIRE(value == best);
+    }
+    // a capacity large enough for the parallel rows
+    std::vector<std::pair<int, int>> big;
+    for (int i = 1; i <= 30; i++) {
+        big.push_back({i * 7919, i * 13 % 97 + 1});
+    }
+    REQUIRE(knapsack_max_value(big, 300000, 3) == knapsack_max_value(big, 300000));
+}
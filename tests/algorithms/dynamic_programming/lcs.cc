@@ -1,5 +1,37 @@
 #include "../../../src/algorithms/dynamic_programming/lcs.h"
 #include "../../../third_party/catch.hpp"
+#include <random>
+
+namespace {
+size_t dp_lcs(const std::string& a, const std::string& b) {
+    std::vector<size_t> row(b.size() + 1, 0);
+    for (size_t i = 1; i <= a.size(); i++) {
+        size_t diag = 0;
+        for (size_t j = 1; j <= b.size(); j++) {
+            size_t up = row[j];
+            row[j] = a[i - 1] == b[j - 1] ? diag + 1 : std::max(up, row[j - 1]);
+            diag = up;
+        }
+    }
+    return row[b.size()];
+}
+
+bool is_subsequence(const std::string& s, const std::string& of) {
+    size_t j = 0;
+    for (char c : of) {
+        j += j < s.size() && s[j] == c;
+    }
+    return j == s.size();
+}
+
+std::string random_string(size_t n, size_t alphabet, std::mt19937& rng) {
+    std::string s(n, 'a');
+    for (char& c : s) {
+        c = char('a' + rng() % alphabet);
+    }
+    return s;
+}
+} // namespace
 
 TEST_CASE("testing longest common subsequence") {
     std::string a = "AGGTAB", b = "GXTXAYB";
@@ -7,4 +39,89 @@ TEST_CASE("testing longest common subsequence") {
     a = "BD";
     b = "ABCD";
     REQUIRE(lcs(a, b) == 2);
-}
\ No newline at end of file
+    REQUIRE(lcs("", "abc") == 0);
+    REQUIRE(lcs_string("AGGTAB", "GXTXAYB") == "GTAB");
+    REQUIRE(lcs_string("", "") == "");
+}
+
+TEST_CASE("testing lcs length and string against the dp") {
+    std::mt19937 rng(84);
+    for (size_t rep = 0; rep < 40; rep++) {
+        size_t alphabet = rep % 2 ? 2 : 26;
+        std::string a = random_string(rng() % 700, alphabet, rng);
+        std::string b = random_string(rng() % 700, alphabet, rng);
+        size_t d = dp_lcs(a, b);
+        REQUIRE(lcs_length(a, b) == d);
+        std::string s = lcs_string(a, b);
+        REQUIRE(s.size() == d);
+        REQUIRE(is_subsequence(s, a));
+        REQUIRE(is_subsequence(s, b));
+    }
+}
+
+TEST_CASE("testing lcs on long inputs") {
+    // a mutated copy, past the size where the quadratic table would be used
+    std::mt19937 rng(85);
+    std::string a = random_string(20000, 4, rng), b = a;
+    for (size_t k = 0; k < 300; k++) {
+        b[rng() % b.size()] = char('a' + rng() % 4);
+    }
+    b.erase(5000, 100);
+    std::string s = lcs_string(a, b);
+    REQUIRE(s.size() == lcs_length(a, b));
+    REQUIRE(s.size() == dp_lcs(a, b));
+    REQUIRE(is_subsequence(s, a));
+    REQUIRE(is_subsequence(s, b));
+}
+
+TEST_CASE("testing lcs pairs on a large alphabet") {
+    // more distinct symbols than the dense masks take, with long unmatched stretches
+    std::mt19937 rng(86);
+    std::vector<int> x(3000), y(2500);
+    for (int& v : x) {
+        v = int(rng() % 500);
+    }
+    for (int& v : y) {
+        v = int(rng() % 500);
+    }
+    std::vector<std::pair<size_t, size_t>> p =
+        lcs_pairs(std::span<const int>(x), std::span<const int>(y));
+    for (size_t k = 0; k < p.size(); k++) {
+        REQUIRE(x[p[k].first] == y[p[k].second]);
+        if (k > 0) {
+            REQUIRE(p[k - 1].first < p[k].first);
+            REQUIRE(p[k - 1].second < p[k].second);
+        }
+    }
+    std::vector<size_t> row(y.size() + 1, 0);
+    for (size_t i = 1; i <= x.size(); i++) {
+        size_t diag = 0;
+        for (size_t j = 1; j <= y.size(); j++) {
+            size_t up = row[j];
+            row[j] = x[i - 1] == y[j - 1] ? diag + 1 : std::max(up, row[j - 1]);
+            diag = up;
+        }
+    }
+    REQUIRE(p.size() == row[y.size()]);
+}
+
+TEST_CASE("testing lcs diff") {
+    std::vector<std::string> a = {"a", "b", "c", "d", "e", "f", "g", "h", "i", "j"};
+    std::vector<std::string> b = {"a", "b", "x", "d", "e", "f", "g", "h", "i", "j", "k"};
+    std::vector<diff_edit> e =
+        lcs_diff(std::span<const std::string>(a), std::span<const std::string>(b));
+    REQUIRE(e.size() == 12);
+    REQUIRE(e[2] == diff_edit{diff_op::remove, 2, 2});
+    REQUIRE(e[3] == diff_edit{diff_op::insert, 3, 2});
+    REQUIRE(e[11] == diff_edit{diff_op::insert, 10, 10});
+    REQUIRE(unified_diff(a, b, 1) ==
+            "@@ -2,3 +2,3 @@\n b\n-c\n+x\n d\n@@ -10 +10,2 @@\n j\n+k\n");
+    REQUIRE(unified_diff(a, a).empty());
+    std::vector<std::string> none;
+    REQUIRE(unified_diff(none, {"x"}) == "@@ -0,0 +1 @@\n+x\n");
+
+    std::vector<int> x = {1, 2, 3, 4}, y = {2, 4, 5};
+    std::vector<std::pair<size_t, size_t>> p =
+        lcs_pairs(std::span<const int>(x), std::span<const int>(y));
+    REQUIRE(p == std::vector<std::pair<size_t, size_t>>{{1, 0}, {3, 1}});
+}
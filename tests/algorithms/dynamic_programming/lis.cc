@@ -1,5 +1,10 @@
 #include "../../../src/algorithms/dynamic_programming/lis.h"
 #include "../../../third_party/catch.hpp"
+#include <functional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
 
 TEST_CASE("testing longest increasing subsequence") {
     std::vector<int> v = {1, 5, 6, 7};
@@ -14,4 +19,54 @@ TEST_CASE("testing longest increasing subsequence") {
     v.clear();
     v = {};
     REQUIRE(lis(v) == 0);
-}
\ No newline at end of file
+}
+TEST_CASE("testing lis indices") {
+    std::vector<int> v = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9};
+    std::vector<size_t> at = lis_indices(std::span<const int>(v));
+    REQUIRE(int64_t(at.size()) == lis(v));
+    for (size_t k = 1; k < at.size(); k++) {
+        REQUIRE(at[k - 1] < at[k]);
+        REQUIRE(v[at[k - 1]] < v[at[k]]);
+    }
+    std::vector<int> d = {5, 4, 4, 2};
+    REQUIRE(lis_indices(std::span<const int>(d), std::greater<int>()).size() == 3);
+    REQUIRE(lis_indices(std::span<const int>(d), std::greater_equal<int>()).size() == 4);
+    REQUIRE(lis_indices(std::span<const int>()).empty());
+}
+
+TEST_CASE("testing lis stream") {
+    lis_stream<int> s;
+    REQUIRE(s.length() == 0);
+    REQUIRE(s.sequence().empty());
+    std::vector<int> v = {10, 9, 2, 5, 3, 7, 101, 18};
+    std::vector<size_t> ends;
+    for (int x : v) {
+        ends.push_back(s.push(x));
+    }
+    REQUIRE(ends == std::vector<size_t>{1, 1, 1, 2, 2, 3, 4, 4});
+    REQUIRE(s.length() == 4);
+    REQUIRE(s.sequence() == std::vector<int>{2, 3, 7, 18});
+    REQUIRE(s.indices() == std::vector<size_t>{2, 4, 5, 7});
+
+    lis_stream<int, std::less_equal<int>> nd;
+    for (int x : {1, 1, 1, 0, 1}) {
+        nd.push(x);
+    }
+    REQUIRE(nd.length() == 4);
+    nd.clear();
+    REQUIRE(nd.size() == 0);
+
+    std::mt19937 rng(90);
+    std::vector<int> r(2000);
+    lis_stream<int> rs;
+    for (int& x : r) {
+        x = int(rng() % 500);
+        rs.push(x);
+        if (rs.size() % 97 == 0) {
+            std::vector<int> prefix(r.begin(), r.begin() + rs.size());
+            REQUIRE(int64_t(rs.length()) == lis(prefix));
+        }
+    }
+    REQUIRE(int64_t(rs.length()) == lis(r));
+    REQUIRE(rs.indices() == lis_indices(std::span<const int>(r)));
+}
@@ -1,5 +1,8 @@
 #include "../../../src/algorithms/dynamic_programming/partitions.h"
 #include "../../../third_party/catch.hpp"
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 TEST_CASE("Testing partition with 0") {
     std::vector<std::vector<long long>> part{partitions(0)};
@@ -15,3 +18,62 @@ TEST_CASE("Testing partition with 1") {
     std::vector<std::vector<long long>> part{partitions(1)};
     REQUIRE(part.size() == 1);
 }
+
+TEST_CASE("Testing partition generator") {
+    partition_generator g(4);
+    std::vector<std::vector<long long>> seen;
+    for (std::span<const long long> p : g) {
+        seen.emplace_back(p.begin(), p.end());
+    }
+    REQUIRE(seen == partitions(4));
+    REQUIRE(seen.front() == std::vector<long long>{1, 1, 1, 1});
+    REQUIRE(seen.back() == std::vector<long long>{4});
+
+    std::vector<std::vector<long long>> reference;
+    iterate(12, reference);
+    REQUIRE(partitions(12) == reference);
+
+    partition_generator bounded(6, 2);
+    size_t count = 1;
+    while (bounded.next()) {
+        REQUIRE(bounded.current()[0] <= 2);
+        count++;
+    }
+    REQUIRE(count == 4);
+    REQUIRE_THROWS_AS(partition_generator(-1), std::invalid_argument);
+
+    size_t total = 0;
+    for_each_partition(30, [&](std::span<const long long>) { total++; });
+    REQUIRE(total == partition_count(30));
+}
+
+TEST_CASE("Testing parallel partitions") {
+    for (size_t threads : {1, 3}) {
+        std::vector<size_t> per_thread(threads, 0);
+        std::vector<uint64_t> sums(threads, 0);
+        parallel_for_each_partition(40, threads, [&](std::span<const long long> p, size_t tid) {
+            per_thread[tid]++;
+            for (long long x : p) {
+                sums[tid] += uint64_t(x);
+            }
+        });
+        size_t total = 0;
+        uint64_t sum = 0;
+        for (size_t t = 0; t < threads; t++) {
+            total += per_thread[t];
+            sum += sums[t];
+        }
+        REQUIRE(total == 37338);
+        REQUIRE(sum == 37338 * 40);
+    }
+}
+
+TEST_CASE("Testing partition count") {
+    REQUIRE(partition_count(0) == 1);
+    REQUIRE(partition_count(4) == 5);
+    REQUIRE(partition_count(100) == 190569292);
+    REQUIRE(partition_count(416) == 17873792969689876004ull);
+    REQUIRE_THROWS_AS(partition_count(417), std::overflow_error);
+    REQUIRE(partition_count(100, 1000000007) == 190569292);
+    REQUIRE(partition_count(1000, 1000000007) == 709496666);
+}
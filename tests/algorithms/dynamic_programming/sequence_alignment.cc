@@ -0,0 +1,30 @@
+#include "../../../src/algorithms/dynamic_programming/sequence_alignment.h"
+#include "../../../third_party/catch.hpp"
+
+TEST_CASE("testing global alignment") {
+    REQUIRE(global_alignment_score("GATTACA", "GCATGCU") == 0);
+    REQUIRE(global_alignment_score("", "ACG") == -3);
+    REQUIRE(global_alignment_score("ACGT", "ACGT", {2, -1, -2}) == 8);
+    // one substitution against two gaps
+    REQUIRE(global_alignment_score("ACGT", "AGGT", {1, -1, -2}) == 2);
+
+    std::string a(700, 'A'), b(650, 'A');
+    for (size_t i = 0; i < a.size(); i += 7) {
+        a[i] = 'C';
+    }
+    int64_t serial = global_alignment_score(a, b);
+    REQUIRE(global_alignment_score(a, b, {}, {64, 4}) == serial);
+    REQUIRE(global_alignment_score(a, b, {}, {1000, 1}) == serial);
+
+    std::vector<std::string> candidates = {"GCATGCU", "GATTACA", ""};
+    REQUIRE(global_alignment_scores("GATTACA", candidates, {}, 2) ==
+            std::vector<int64_t>{0, 7, -7});
+}
+
+TEST_CASE("testing local alignment") {
+    REQUIRE(local_alignment_score("TGTTACGG", "GGTTGACTA", {3, -3, -2}) == 13);
+    REQUIRE(local_alignment_score("AAAA", "TTTT") == 0);
+    REQUIRE(local_alignment_score("", "") == 0);
+    std::string a(500, 'G'), b = "xxxx" + std::string(300, 'G') + "yyyy";
+    REQUIRE(local_alignment_score(a, b, {}, {32, 4}) == 300);
+}
@@ -1,5 +1,8 @@
 #include "../../../src/algorithms/dynamic_programming/subset_sum.h"
 #include "../../../third_party/catch.hpp"
+#include <random>
+#include <stdexcept>
+#include <vector>
 
 TEST_CASE("Testing subset sum [1]") {
     std::vector<int> v{4, 2, 1, 5, 7};
@@ -21,3 +24,33 @@ TEST_CASE("Testing subset sum [2]") {
     B = 9;
     REQUIRE(subset_sum(v, B) == 1);
 }
+
+TEST_CASE("Testing subset sums with bitsets") {
+    std::vector<int> v{1, 4, 6, 9};
+    std::vector<bool> s = subset_sums(v, 21);
+    std::vector<size_t> reachable;
+    for (size_t j = 0; j < s.size(); j++) {
+        if (s[j]) {
+            reachable.push_back(j);
+        }
+    }
+    REQUIRE(reachable == std::vector<size_t>{0, 1, 4, 5, 6, 7, 9, 10, 11, 13, 14, 15, 16, 19, 20});
+    REQUIRE(subset_sum_exists(v, 20));
+    REQUIRE(!subset_sum_exists(v, 18));
+    REQUIRE(subset_sum_exists({}, 0));
+    REQUIRE_THROWS_AS(subset_sums({1, -2}, 5), std::invalid_argument);
+
+    // random elements across word boundaries, against the counting dp
+    std::mt19937 rng(89);
+    for (size_t rep = 0; rep < 20; rep++) {
+        std::vector<int> w(1 + rng() % 15);
+        for (int& x : w) {
+            x = int(rng() % 300);
+        }
+        size_t B = 1 + rng() % 1000;
+        std::vector<bool> bits = subset_sums(w, B);
+        for (size_t j = 0; j <= B; j++) {
+            REQUIRE(bits[j] == (j == 0 || subset_sum(w, int(j)) > 0));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "../../../src/algorithms/dynamic_programming/wavefront.h"
+#include "../../../src/algorithms/string/edit_distance.h"
+#include "../../../third_party/catch.hpp"
+
+#include <string>
+
+namespace {
+std::string random_text(size_t n, uint64_t seed, int alphabet) {
+    std::string s(n, 'a');
+    for (char& c : s) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        c = char('a' + int(seed >> 33) % alphabet);
+    }
+    return s;
+}
+} // namespace
+
+TEST_CASE("testing the wavefront table against a serial fill") {
+    std::string a = random_text(137, 1, 4), b = random_text(301, 2, 4);
+    size_t n = a.size(), m = b.size();
+    std::vector<int32_t> expected((n + 1) * (m + 1), 0);
+    for (size_t i = 1; i <= n; i++) {
+        for (size_t j = 1; j <= m; j++) {
+            expected[i * (m + 1) + j] =
+                a[i - 1] == b[j - 1]
+                    ? expected[(i - 1) * (m + 1) + j - 1] + 1
+                    : std::max(expected[(i - 1) * (m + 1) + j], expected[i * (m + 1) + j - 1]);
+        }
+    }
+    auto edge = [](size_t, size_t) { return int32_t(0); };
+    auto cell = [&](size_t i, size_t j, int32_t n, int32_t w, int32_t nw) {
+        return a[i - 1] == b[j - 1] ? nw + 1 : std::max(n, w);
+    };
+    for (size_t tile : {1, 7, 64, 1000}) {
+        for (size_t threads : {1, 3}) {
+            wavefront_options opt{tile, threads};
+            REQUIRE(wavefront_table<int32_t>(n, m, edge, cell, opt) == expected);
+            auto edges = wavefront_rolling<int32_t>(n, m, edge, cell, opt);
+            REQUIRE(edges.last_row ==
+                    std::vector<int32_t>(expected.end() - int64_t(m + 1), expected.end()));
+            REQUIRE(edges.last_column.size() == n + 1);
+            for (size_t i = 0; i <= n; i++) {
+                REQUIRE(edges.last_column[i] == expected[i * (m + 1) + m]);
+            }
+        }
+    }
+    REQUIRE_THROWS_AS(wavefront_table<int32_t>(n, m, edge, cell, {0, 1}), std::invalid_argument);
+}
+
+TEST_CASE("testing the wavefront edges and edit distance") {
+    auto edge = [](size_t i, size_t j) { return int64_t(i + j); };
+    for (auto [n, m] : {std::pair<size_t, size_t>{0, 0}, {0, 5}, {4, 0}, {1, 1}, {50, 3}}) {
+        std::string a = random_text(n, 3, 3), b = random_text(m, 4, 3);
+        auto cell = [&](size_t i, size_t j, int64_t up, int64_t w, int64_t nw) {
+            return std::min({up + 1, w + 1, nw + (a[i - 1] != b[j - 1])});
+        };
+        auto edges = wavefront_rolling<int64_t>(n, m, edge, cell, {2, 2});
+        REQUIRE(edges.last_row.size() == m + 1);
+        REQUIRE(edges.last_column.size() == n + 1);
+        REQUIRE(edges.last_row[0] == int64_t(n));
+        REQUIRE(edges.last_column[0] == int64_t(m));
+        REQUIRE(edges.last_row.back() == min_dist(a, b));
+    }
+}
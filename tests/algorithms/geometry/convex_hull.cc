@@ -1,6 +1,9 @@
 #include "../../../src/algorithms/geometry/convex_hull.h"
 #include "../../../third_party/catch.hpp"
 
+#include <limits>
+#include <random>
+
 TEST_CASE("Testing convex hull with graham's scan [1]") {
     std::vector<std::pair<int, int>> points = {{0, 3}, {1, 1}, {2, 2}, {4, 4}, {0, 0},
                                                {1, 2}, {3, 1}, {3, 3}, {2, 4}, {4, 0}};
@@ -29,3 +32,104 @@ TEST_CASE("Testing convex hull with graham's scan [2]") {
     check.pop_back();
     REQUIRE(convex2 == check);
 }
+
+TEST_CASE("Testing orientation with large coordinates") {
+    int big = std::numeric_limits<int>::max(), small = std::numeric_limits<int>::min();
+    REQUIRE(helpers::orientation({small, small}, {big, big}, {small + 1, small + 1}) == 0);
+    REQUIRE(helpers::orientation({small, small}, {big, small}, {big, big}) == 1);
+    REQUIRE(helpers::orientation({small, small}, {big, big}, {big, small}) == -1);
+}
+
+TEST_CASE("Testing the hull engines on small inputs") {
+    std::vector<hull_point> empty;
+    REQUIRE(monotone_chain(empty).empty());
+    REQUIRE(chan_hull(empty).empty());
+    REQUIRE(convex_hull(empty).empty());
+
+    std::vector<hull_point> one = {{5, 5}, {5, 5}, {5, 5}};
+    std::vector<hull_point> check = {{5, 5}};
+    REQUIRE(monotone_chain(one) == check);
+    REQUIRE(chan_hull(one) == check);
+    REQUIRE(convex_hull(one) == check);
+
+    std::vector<hull_point> line = {{3, 3}, {0, 0}, {1, 1}, {2, 2}, {1, 1}};
+    check = {{0, 0}, {3, 3}};
+    REQUIRE(monotone_chain(line) == check);
+    REQUIRE(chan_hull(line) == check);
+    REQUIRE(convex_hull(line) == check);
+
+    std::vector<hull_point> square = {{1, 1}, {2, 2}, {0, 3}, {3, 0}, {0, 0}, {3, 3},
+                                      {3, 1}, {1, 3}, {0, 1}, {2, 0}, {1, 1}};
+    check = {{0, 0}, {3, 0}, {3, 3}, {0, 3}};
+    REQUIRE(monotone_chain(square) == check);
+    REQUIRE(chan_hull(square) == check);
+    REQUIRE(convex_hull(square) == check);
+    REQUIRE(akl_toussaint_filter(square).size() < square.size());
+}
+
+TEST_CASE("Testing the hull engines with large coordinates") {
+    int64_t l = int64_t(1) << 62;
+    std::vector<hull_point> points = {{-l, -l}, {l, -l}, {l, l}, {-l, l}, {0, 0},
+                                      {l - 1, 0}, {0, l}, {l, l - 1}, {-l + 1, -l + 1}};
+    std::vector<hull_point> check = {{-l, -l}, {l, -l}, {l, l}, {-l, l}};
+    REQUIRE(monotone_chain(points) == check);
+    REQUIRE(chan_hull(points) == check);
+    REQUIRE(convex_hull(points) == check);
+}
+
+TEST_CASE("Testing the hull engines against each other") {
+    std::mt19937_64 rng(99);
+    for (int round = 0; round < 60; round++) {
+        size_t n = rng() % 3000 + 1;
+        int64_t range = round % 3 == 0 ? 10 : round % 3 == 1 ? 1000 : int64_t(1) << 40;
+        std::vector<hull_point> points(n);
+        for (hull_point& p : points) {
+            p = {int64_t(rng() % uint64_t(2 * range + 1)) - range,
+                 int64_t(rng() % uint64_t(2 * range + 1)) - range};
+            if (round % 4 == 0) {
+                // points on a circle, most of them on the hull
+                double a = double(rng() % 100000) / 100000 * 6.283185307179586;
+                p = {int64_t(std::cos(a) * 1e6), int64_t(std::sin(a) * 1e6)};
+            }
+        }
+        std::vector<hull_point> check = monotone_chain(points);
+        REQUIRE(monotone_chain(points, 3) == check);
+        REQUIRE(chan_hull(points) == check);
+        REQUIRE(chan_hull(points, 3) == check);
+        REQUIRE(convex_hull(points, 2) == check);
+        std::vector<hull_point> kept = akl_toussaint_filter(points, 2);
+        REQUIRE(monotone_chain(kept) == check);
+
+        online_hull online;
+        for (const hull_point& p : points) {
+            online.insert(p);
+        }
+        REQUIRE(online.hull() == check);
+        for (size_t i = 0; i < 20; i++) {
+            const hull_point& p = points[rng() % n];
+            REQUIRE(online.contains(p));
+        }
+    }
+}
+
+TEST_CASE("Testing online hull") {
+    online_hull h;
+    REQUIRE(h.empty());
+    REQUIRE(!h.contains({0, 0}));
+    REQUIRE(h.insert({0, 0}));
+    REQUIRE(!h.insert({0, 0}));
+    REQUIRE(h.insert({4, 0}));
+    REQUIRE(h.insert({4, 4}));
+    REQUIRE(h.insert({0, 4}));
+    REQUIRE(!h.insert({2, 2}));
+    REQUIRE(!h.insert({2, 0}));
+    REQUIRE(h.contains({2, 2}));
+    REQUIRE(h.contains({4, 2}));
+    REQUIRE(!h.contains({5, 2}));
+    std::vector<hull_point> check = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+    REQUIRE(h.hull() == check);
+    REQUIRE(h.insert({2, -2}));
+    REQUIRE(h.insert({10, 10}));
+    check = {{0, 0}, {2, -2}, {4, 0}, {10, 10}, {0, 4}};
+    REQUIRE(h.hull() == check);
+}
@@ -0,0 +1,39 @@
+#include "../../../third_party/catch.hpp"
+#include "../../../src/algorithms/math/big_uint.h"
+
+TEST_CASE("testing big_uint construction and printing") {
+    REQUIRE(big_uint().to_string() == "0");
+    REQUIRE(big_uint(uint64_t(0)).limbs().empty());
+    REQUIRE(big_uint(18446744073709551615ULL).to_string() == "18446744073709551615");
+    REQUIRE(big_uint("000123").to_string() == "123");
+    std::string digits = "123456789012345678901234567890123456789012345678901234567890";
+    REQUIRE(big_uint(digits).to_string() == digits);
+    REQUIRE(big_uint("1000000000").to_string() == "1000000000");
+    REQUIRE_THROWS_AS(big_uint(std::string_view("")), std::invalid_argument);
+    REQUIRE_THROWS_AS(big_uint(std::string_view("12a")), std::invalid_argument);
+}
+
+TEST_CASE("testing big_uint arithmetic") {
+    big_uint a("340282366920938463463374607431768211455"); // 2^128 - 1
+    REQUIRE(a.bits() == 128);
+    REQUIRE((a + big_uint(1)).to_string() == "340282366920938463463374607431768211456");
+    REQUIRE((a + big_uint(1) - big_uint(1)) == a);
+    REQUIRE((a - a).limbs().empty());
+    REQUIRE((big_uint(1) << 128) == a + big_uint(1));
+    REQUIRE((a * a).to_string() ==
+            "115792089237316195423570985008687907852589419931798687112530834793049593217025");
+    REQUIRE(a * big_uint() == big_uint());
+    REQUIRE(big_uint(3) < big_uint(5));
+    REQUIRE(a > big_uint(18446744073709551615ULL));
+    REQUIRE_THROWS_AS(big_uint(3) - big_uint(5), std::underflow_error);
+
+    big_uint x("98765432109876543210"), y("12345678901234567890");
+    REQUIRE((x * y).to_string() == "1219326311370217952237463801111263526900");
+    big_uint z = x;
+    z -= y;
+    REQUIRE(z.to_string() == "86419753208641975320");
+    z += y;
+    REQUIRE(z == x);
+    z *= y;
+    REQUIRE(z == x * y);
+}
@@ -0,0 +1,120 @@
+#include "../../../src/algorithms/math/multiply.h"
+#include "../../../third_party/catch.hpp"
+
+#include <tuple>
+
+namespace {
+std::vector<uint32_t> random_limbs(size_t n, uint64_t& seed) {
+    std::vector<uint32_t> v(n);
+    for (uint32_t& x : v) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        x = uint32_t(seed >> 32);
+    }
+    return v;
+}
+} // namespace
+
+TEST_CASE("testing matrix multiplication") {
+    std::vector<std::vector<int>> a = {{1, 2}, {3, 4}}, b = {{5, 6}, {7, 8}};
+    REQUIRE(multiply(a, b) == std::vector<std::vector<int>>{{19, 22}, {43, 50}});
+
+    std::vector<std::vector<int>> row = {{1, 2, 3}}, column = {{4}, {5}, {6}};
+    REQUIRE(multiply(row, column) == std::vector<std::vector<int>>{{32}});
+    REQUIRE(multiply(column, row) ==
+            std::vector<std::vector<int>>{{4, 8, 12}, {5, 10, 15}, {6, 12, 18}});
+}
+
+TEST_CASE("testing blocked matrix multiplication against the triple loop") {
+    uint64_t seed = 9;
+    // sizes around the tiles(4 x 16) and the blocks(64 x 256, 2048 columns)
+    for (auto [n, m, p] : {std::tuple<size_t, size_t, size_t>{1, 1, 1},
+                           {5, 17, 3},
+                           {67, 300, 33},
+                           {130, 257, 2100}}) {
+        std::vector<std::vector<int64_t>> x(n, std::vector<int64_t>(m)),
+            y(m, std::vector<int64_t>(p));
+        for (auto& r : x) {
+            for (auto& v : r) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                v = int64_t(seed >> 54) - 512;
+            }
+        }
+        for (auto& r : y) {
+            for (auto& v : r) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                v = int64_t(seed >> 54) - 512;
+            }
+        }
+        std::vector<std::vector<int64_t>> expected(n, std::vector<int64_t>(p, 0));
+        for (size_t i = 0; i < n; i++) {
+            for (size_t k = 0; k < m; k++) {
+                for (size_t j = 0; j < p; j++) {
+                    expected[i][j] += x[i][k] * y[k][j];
+                }
+            }
+        }
+        REQUIRE(multiply(x, y) == expected);
+        REQUIRE(multiply(x, y, 3) == expected);
+    }
+
+    std::vector<std::vector<double>> a = {{0.5, 1.5}, {2.0, -1.0}}, b = {{2.0, 0.0}, {1.0, 4.0}};
+    REQUIRE(multiply(a, b) == std::vector<std::vector<double>>{{2.5, 6.0}, {3.0, -4.0}});
+}
+
+TEST_CASE("testing limb multiplication against the schoolbook product") {
+    uint64_t seed = 5;
+    for (auto [n, m] : {std::pair<size_t, size_t>{0, 5},
+                        {1, 1},
+                        {31, 33},
+                        {32, 32},
+                        {100, 100},
+                        {257, 64},
+                        {64, 1000},
+                        {333, 200}}) {
+        std::vector<uint32_t> a = random_limbs(n, seed), b = random_limbs(m, seed);
+        std::vector<uint32_t> expected(n + m, 0);
+        _multiply_utils::schoolbook(a, b, expected.data());
+        REQUIRE(multiply_limbs(a, b) == expected);
+        REQUIRE(multiply_limbs(b, a) == expected);
+    }
+    // every limb at its maximum, the carries run through the whole product
+    std::vector<uint32_t> ones(150, ~uint32_t(0));
+    std::vector<uint32_t> expected(300, 0);
+    _multiply_utils::schoolbook(ones, ones, expected.data());
+    REQUIRE(multiply_limbs(ones, ones) == expected);
+}
+
+
+TEST_CASE("testing NTT limb multiplication") {
+    uint64_t seed = 17;
+    for (auto [n, m] : {std::pair<size_t, size_t>{1024, 1024}, {3000, 1500}, {5000, 1100}}) {
+        std::vector<uint32_t> a = random_limbs(n, seed), b = random_limbs(m, seed);
+        std::vector<uint32_t> expected(n + m, 0);
+        _multiply_utils::schoolbook(a, b, expected.data());
+        REQUIRE(multiply_limbs(a, b) == expected);
+    }
+    // the largest coefficients: every limb at its maximum
+    std::vector<uint32_t> ones(4096, ~uint32_t(0));
+    std::vector<uint32_t> expected(8192, 0);
+    _multiply_utils::schoolbook(ones, ones, expected.data());
+    REQUIRE(multiply_limbs(ones, ones) == expected);
+}
+
+TEST_CASE("testing polynomial multiplication modulo 998244353") {
+    const uint64_t p = 998244353;
+    REQUIRE(multiply_polynomials_mod(std::vector<uint32_t>{1, 1}, std::vector<uint32_t>{1, 1}) ==
+            std::vector<uint32_t>{1, 2, 1});
+    REQUIRE(multiply_polynomials_mod(std::vector<uint32_t>{}, std::vector<uint32_t>{1}).empty());
+    uint64_t seed = 23;
+    for (auto [n, m] : {std::pair<size_t, size_t>{10, 70}, {300, 200}, {1000, 1}}) {
+        std::vector<uint32_t> a = random_limbs(n, seed), b = random_limbs(m, seed);
+        std::vector<uint64_t> expected(n + m - 1, 0);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < m; j++) {
+                expected[i + j] = (expected[i + j] + (a[i] % p) * (b[j] % p)) % p;
+            }
+        }
+        REQUIRE(multiply_polynomials_mod(a, b) ==
+                std::vector<uint32_t>(expected.begin(), expected.end()));
+    }
+}
@@ -16,3 +16,90 @@ TEST_CASE("Testing eratosthenes sieve for large numbers [1]") {
     REQUIRE(v[7349] == true);
     REQUIRE(v[7236] == false);
 }
+
+
+TEST_CASE("Testing eratosthenes sieve for 0 and 1") {
+    std::vector<bool> v = soe(10);
+
+    REQUIRE(v[0] == false);
+    REQUIRE(v[1] == false);
+    REQUIRE(v[2] == true);
+}
+
+TEST_CASE("Testing the segmented sieve against the plain one") {
+    const int64_t n = 3000000;
+    std::vector<bool> v = soe(n);
+    std::vector<uint64_t> expected;
+    for (int64_t i = 0; i <= n; i++) {
+        if (v[i]) {
+            expected.push_back(uint64_t(i));
+        }
+    }
+    for (size_t threads : {1, 3}) {
+        REQUIRE(primes_in_range(0, n + 1, threads) == expected);
+        REQUIRE(count_primes(0, n + 1, threads) == expected.size());
+    }
+    // ranges that start and end anywhere
+    for (auto [lo, hi] : {std::pair<uint64_t, uint64_t>{0, 0},
+                          {0, 2},
+                          {2, 3},
+                          {1, 10},
+                          {524287, 524301},
+                          {1000000, 2500001},
+                          {7, 7}}) {
+        std::vector<uint64_t> part;
+        for (uint64_t p : expected) {
+            if (p >= lo && p < hi) {
+                part.push_back(p);
+            }
+        }
+        REQUIRE(primes_in_range(lo, hi) == part);
+        REQUIRE(primes_in_range(lo, hi, 4) == part);
+        REQUIRE(count_primes(lo, hi, 2) == part.size());
+    }
+}
+
+TEST_CASE("Testing segmented sieve counts and the prime generator") {
+    REQUIRE(count_primes(0, 100000000, 2) == 5761455);
+    // the primes right above 10^12
+    REQUIRE(primes_in_range(1000000000000ULL, 1000000000100ULL) ==
+            std::vector<uint64_t>{1000000000039ULL, 1000000000061ULL, 1000000000063ULL,
+                                  1000000000091ULL});
+    REQUIRE(count_primes(1000000000000ULL, 1000000100000ULL, 2) == 3614);
+
+    prime_generator g(0, 30);
+    std::vector<uint64_t> got;
+    for (std::optional<uint64_t> p = g.next(); p; p = g.next()) {
+        got.push_back(*p);
+    }
+    REQUIRE(got == std::vector<uint64_t>{2, 3, 5, 7, 11, 13, 17, 19, 23, 29});
+    REQUIRE(!g.next());
+
+    uint64_t count = 0, last = 0;
+    for_each_prime(1000000, 5000000, [&](uint64_t p) {
+        REQUIRE(p > last);
+        last = p;
+        count++;
+    });
+    REQUIRE(count == count_primes(1000000, 5000000));
+
+    REQUIRE_THROWS_AS(count_primes(0, (uint64_t(1) << 62) + 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(prime_generator(0, ~uint64_t(0)), std::invalid_argument);
+}
+
+TEST_CASE("Testing the compile time sieve") {
+    static constexpr static_sieve<100000> sieve;
+    static_assert(sieve.count() == 9592);
+    static_assert(sieve.is_prime(99991) && !sieve.is_prime(99993));
+    static_assert(static_sieve<0>().count() == 0 && static_sieve<1>().count() == 0);
+    static_assert(static_sieve<2>().count() == 1 && static_sieve<9>().count() == 4);
+    std::vector<bool> v = soe(100000);
+    for (uint64_t n = 0; n <= 100000; n++) {
+        REQUIRE(sieve.is_prime(n) == v[n]);
+    }
+    REQUIRE_THROWS_AS(sieve.is_prime(100001), std::out_of_range);
+
+    static constexpr auto primes = small_primes<1000>();
+    static_assert(primes.size() == 168 && primes.front() == 2 && primes.back() == 997);
+    REQUIRE(std::vector<uint64_t>(primes.begin(), primes.end()) == primes_in_range(0, 1001));
+}
@@ -0,0 +1,55 @@
+#include "../../../src/algorithms/number_theory/factorization.h"
+#include "../../../third_party/catch.hpp"
+
+#include <numeric>
+
+TEST_CASE("testing miller rabin") {
+    std::vector<char> prime(100000, 1);
+    prime[0] = prime[1] = 0;
+    for (size_t p = 2; p * p < prime.size(); p++) {
+        for (size_t q = p * p; prime[p] && q < prime.size(); q += p) {
+            prime[q] = 0;
+        }
+    }
+    for (uint64_t n = 0; n < prime.size(); n++) {
+        REQUIRE(miller_rabin(n) == bool(prime[n]));
+    }
+    REQUIRE(miller_rabin(18446744073709551557ULL));
+    REQUIRE(!miller_rabin(18446744073709551615ULL));
+    // strong pseudoprimes to several small bases
+    REQUIRE(!miller_rabin(3215031751ULL));
+    REQUIRE(!miller_rabin(3825123056546413051ULL));
+    REQUIRE(!miller_rabin(4294967291ULL * 4294967279ULL));
+    REQUIRE(miller_rabin(1000000000039ULL));
+}
+
+TEST_CASE("testing factorization") {
+    REQUIRE(factorize(1).empty());
+    REQUIRE(factorize(0).empty());
+    REQUIRE(factorize(360) == std::vector<uint64_t>{2, 2, 2, 3, 3, 5});
+    REQUIRE(factorize(4294967291ULL * 4294967279ULL) ==
+            std::vector<uint64_t>{4294967279ULL, 4294967291ULL});
+    REQUIRE(factorize(18446744073709551615ULL) ==
+            std::vector<uint64_t>{3, 5, 17, 257, 641, 65537, 6700417});
+    REQUIRE(factorize(1000000007ULL * 1000000007ULL) ==
+            std::vector<uint64_t>{1000000007ULL, 1000000007ULL});
+    REQUIRE(factorize(uint64_t(1) << 63) == std::vector<uint64_t>(63, 2));
+    REQUIRE(factorize(101ULL * 101 * 103) == std::vector<uint64_t>{101, 101, 103});
+
+    std::vector<uint64_t> values;
+    uint64_t seed = 11;
+    for (int i = 0; i < 300; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        values.push_back(seed | 1);
+    }
+    auto all = factorize_all(values, 3);
+    for (size_t i = 0; i < values.size(); i++) {
+        REQUIRE(std::is_sorted(all[i].begin(), all[i].end()));
+        uint64_t product = 1;
+        for (uint64_t p : all[i]) {
+            REQUIRE(miller_rabin(p));
+            product *= p;
+        }
+        REQUIRE(product == values[i]);
+    }
+}
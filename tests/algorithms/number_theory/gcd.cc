@@ -14,4 +14,33 @@ TEST_CASE("testing binary gcd") {
     b = 85430;
     REQUIRE(binary_gcd(a, b) == 10);
     REQUIRE(euclidean_gcd(a, b) == 10);
-}
\ No newline at end of file
+}
+
+TEST_CASE("testing binary gcd edge cases") {
+    REQUIRE(binary_gcd(0, 0) == 0);
+    REQUIRE(binary_gcd(0, 12) == 12);
+    REQUIRE(binary_gcd(-12, 18) == 6);
+    REQUIRE(binary_gcd(int64_t(1) << 62, int64_t(3) << 40) == int64_t(1) << 40);
+    REQUIRE(binary_gcd(1000000007LL * 998244353LL, 998244353LL * 3) == 998244353LL);
+    for (int64_t a = 0; a < 60; a++) {
+        for (int64_t b = 0; b < 60; b++) {
+            REQUIRE(binary_gcd(a, b) == euclidean_gcd(a, b));
+        }
+    }
+}
+
+TEST_CASE("testing gcd of arrays") {
+    std::vector<int64_t> v(20000);
+    for (size_t i = 0; i < v.size(); i++) {
+        v[i] = int64_t(i + 1) * 36;
+    }
+    REQUIRE(gcd_all(v) == 36);
+    REQUIRE(gcd_all(v, 4) == 36);
+    v.push_back(35);
+    REQUIRE(gcd_all(v, 3) == 1);
+    REQUIRE(gcd_all(std::vector<int64_t>()) == 0);
+
+    std::vector<int64_t> a = {12, 7, 0, 100}, b = {18, 5, 9, 75};
+    REQUIRE(gcd_pairs(a, b, 2) == std::vector<int64_t>{6, 1, 9, 25});
+    REQUIRE_THROWS_AS(gcd_pairs(a, std::vector<int64_t>{1}), std::invalid_argument);
+}
@@ -14,3 +14,23 @@ TEST_CASE("Testing big mersennse primes [1]") {
 
     REQUIRE(m == check);
 }
+
+
+TEST_CASE("Testing lucas lehmer") {
+    REQUIRE(lucas_lehmer(2));
+    REQUIRE(lucas_lehmer(31));
+    REQUIRE(lucas_lehmer(61));
+    REQUIRE(lucas_lehmer(521));
+    REQUIRE(!lucas_lehmer(11));
+    REQUIRE(!lucas_lehmer(67));
+    REQUIRE(!lucas_lehmer(1));
+    REQUIRE(!lucas_lehmer(64));
+
+    std::vector<uint32_t> expected = {2,   3,   5,   7,    13,   17,   19,   31,
+                                      61,  89,  107, 127,  521,  607,  1279, 2203,
+                                      2281};
+    REQUIRE(mersenne_exponents(2300) == expected);
+    REQUIRE(mersenne_exponents(2300, 3) == expected);
+    REQUIRE(mersenne_exponents(1).empty());
+    REQUIRE(mersenne(int64_t(1) << 62) == std::vector<int64_t>{2, 3, 5, 7, 13, 17, 19, 31, 61});
+}
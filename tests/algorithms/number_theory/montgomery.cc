@@ -0,0 +1,38 @@
+#include "../../../src/algorithms/number_theory/montgomery.h"
+#include "../../../third_party/catch.hpp"
+
+TEST_CASE("testing montgomery arithmetic") {
+    static_assert(mod_pow(3, 200, 1000000007) == 136318165);
+    uint64_t seed = 3;
+    for (uint64_t n : {3ULL, 1000000007ULL, 998244353ULL * 3, 18446744073709551557ULL,
+                       18446744073709551615ULL}) {
+        montgomery mg(n);
+        REQUIRE(mg.modulus() == n);
+        for (int i = 0; i < 200; i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint64_t a = seed;
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint64_t b = seed;
+            REQUIRE(mg.from(mg.to(a)) == a % n);
+            REQUIRE(mg.from(mg.mul(mg.to(a), mg.to(b))) == mod_mul(a, b, n));
+        }
+    }
+    REQUIRE_THROWS_AS(montgomery(10), std::invalid_argument);
+}
+
+TEST_CASE("testing modular exponentiation") {
+    REQUIRE(mod_pow(2, 10, 1000) == 24);
+    REQUIRE(mod_pow(2, 10, 1024) == 0);
+    REQUIRE(mod_pow(7, 0, 13) == 1);
+    REQUIRE(mod_pow(7, 5, 1) == 0);
+    // Fermat
+    REQUIRE(mod_pow(123456789, 18446744073709551557ULL - 1, 18446744073709551557ULL) == 1);
+    for (uint64_t m : {1000ULL, 1001ULL}) {
+        uint64_t r = 1;
+        for (uint64_t e = 0; e < 50; e++) {
+            REQUIRE(mod_pow(3, e, m) == r);
+            r = r * 3 % m;
+        }
+    }
+    REQUIRE_THROWS_AS(mod_pow(2, 3, 0), std::invalid_argument);
+}
@@ -0,0 +1,44 @@
+#include "../../../src/algorithms/rmq/rmq_linear.h"
+#include "../../../src/algorithms/rmq/rmq_sparse_table.h"
+#include "../../../third_party/catch.hpp"
+#include <random>
+#include <vector>
+
+TEST_CASE("Testing linear rmq 1") {
+    std::vector<int> v{1, 5, 4, 2, 3, 7};
+    linear_RMQ<int> rr(v);
+
+    REQUIRE(rr.query_value(0, 4) == 1);
+    REQUIRE(rr.query_value(1, 4) == 2);
+    REQUIRE(rr.query_value(4, 6) == 3);
+    REQUIRE(rr.query_index(1, 3) == 2);
+
+    linear_RMQ<int, true> mx(v);
+    REQUIRE(mx.query_value(0, 4) == 5);
+    REQUIRE(mx.query_value(2, 6) == 7);
+}
+
+TEST_CASE("Testing linear rmq against the sparse table") {
+    std::mt19937 rng(9);
+    for (size_t n : {1, 63, 64, 65, 200, 1000, 5000}) {
+        std::vector<int> v(n);
+        for (auto& x : v) {
+            // few distinct values, so ties are everywhere
+            x = int(rng() % 20);
+        }
+        RMQ<int> sparse(v);
+        RMQ<int, true> sparse_max(v);
+        linear_RMQ<int> linear(v, n % 3 + 1);
+        linear_RMQ<int, true> linear_max(v);
+        for (int i = 0; i < 3000; i++) {
+            size_t a = rng() % n, b = rng() % n;
+            if (a > b) {
+                std::swap(a, b);
+            }
+            b++;
+            REQUIRE(linear.query_index(a, b) == size_t(sparse.query_index(int(a), int(b))));
+            REQUIRE(linear_max.query_index(a, b) ==
+                    size_t(sparse_max.query_index(int(a), int(b))));
+        }
+    }
+}
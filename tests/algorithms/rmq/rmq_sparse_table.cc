@@ -18,3 +18,23 @@ TEST_CASE("Testing rmq 2") {
     REQUIRE(rr.query_value(0, 2) == -2);
     REQUIRE(rr.query_value(0, 3) == -3);
 }
+
+TEST_CASE("Testing the compile time rmq") {
+    static constexpr static_rmq<int, 6> rr(std::array<int, 6>{1, 5, 4, 2, 3, 7});
+    static_assert(rr.query_value(0, 4) == 1 && rr.query_value(1, 4) == 2);
+    static_assert(rr.query_index(1, 3) == 2 && rr.query_value(5, 6) == 7);
+    static constexpr static_rmq<int, 6, true> mx(std::array<int, 6>{1, 5, 4, 2, 3, 7});
+    static_assert(mx.query_value(0, 5) == 5 && mx.query_value(0, 6) == 7);
+
+    std::array<int, 37> v{};
+    for (int i = 0; i < 37; i++) {
+        v[i] = (i * 17) % 11;
+    }
+    static_rmq<int, 37> s(v);
+    RMQ<int> r(std::vector<int>(v.begin(), v.end()));
+    for (int a = 0; a < 37; a++) {
+        for (int b = a + 1; b <= 37; b++) {
+            REQUIRE(s.query_index(a, b) == r.query_index(a, b));
+        }
+    }
+}
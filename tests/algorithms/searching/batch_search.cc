@@ -0,0 +1,33 @@
+#include "../../../src/algorithms/searching/batch_search.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+#include <span>
+#include <vector>
+
+TEST_CASE("testing batch_lower_bound and batch_search") {
+    std::mt19937 rng(8);
+    for (size_t n : {0, 1, 2, 5, 64, 1000, 33333}) {
+        std::vector<int> v(n);
+        for (auto& x : v) {
+            x = int(rng() % (3 * n + 1));
+        }
+        std::sort(v.begin(), v.end());
+        std::vector<int> keys(777);
+        for (auto& x : keys) {
+            x = int(rng() % (3 * n + 3)) - 1;
+        }
+        for (size_t group : {1, 7, 32}) {
+            std::span<const int> arr(v), q(keys);
+            auto pos = batch_lower_bound(arr, q, group);
+            auto found = batch_search(arr, q, group);
+            REQUIRE(pos.size() == keys.size());
+            for (size_t i = 0; i < keys.size(); i++) {
+                auto it = std::lower_bound(v.begin(), v.end(), keys[i]);
+                REQUIRE(pos[i] == size_t(it - v.begin()));
+                bool there = it != v.end() && *it == keys[i];
+                REQUIRE(found[i] == (there ? int64_t(it - v.begin()) : -1));
+            }
+        }
+    }
+}
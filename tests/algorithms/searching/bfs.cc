@@ -1,4 +1,5 @@
 #include "../../../src/algorithms/searching/bfs.h"
+#include "../../../src/classes/graph/graph.h"
 #include "../../../third_party/catch.hpp"
 
 TEST_CASE("testing breadth first search") {
@@ -19,3 +20,48 @@ TEST_CASE("testing breadth first search 2") {
     adj['g'] = {'f'};
     REQUIRE(bfs(adj, 'a', 'f') == false);
 }
+
+TEST_CASE("testing breadth first search on a snapshot") {
+    graph<int> g("directed");
+    for (int i = 0; i < 5; i++) {
+        g.add_edge(i, i + 1);
+    }
+    g.add_edge(0, 3);
+    g.add_edge(7, 0);
+    const csr_graph<int>& c = g.csr_view();
+    REQUIRE(bfs(c, 0, 5) == true);
+    REQUIRE(bfs(c, 0, 7) == false);
+    REQUIRE(bfs(c, 0, 42) == false);
+    REQUIRE(bfs(c, 0, 4, {.max_depth = 2}) == true);
+    REQUIRE(bfs(c, 0, 5, {.max_depth = 2}) == false);
+    REQUIRE(bfs(c, 0, 0, {.max_depth = 0}) == true);
+
+    graph_workspace ws;
+    std::vector<std::pair<int, size_t>> seen;
+    auto record = [&](uint32_t u, size_t depth) {
+        seen.push_back({c.vertex(u), depth});
+        return true;
+    };
+    REQUIRE(bfs(c, c.id(0), record, {.workspace = &ws}) == false);
+    std::vector<std::pair<int, size_t>> want = {{0, 0}, {1, 1}, {3, 1}, {2, 2}, {4, 2}, {5, 3}};
+    REQUIRE(seen == want);
+
+    // the visitor stops the search
+    size_t calls = 0;
+    REQUIRE(bfs(c, c.id(0), [&](uint32_t, size_t) { return ++calls < 3; }) == true);
+    REQUIRE(calls == 3);
+}
+
+TEST_CASE("testing multi source breadth first search on an adjacency list") {
+    std::vector<std::vector<uint32_t>> adj = {{1}, {2}, {3}, {}, {3}, {4}};
+    std::vector<uint32_t> sources = {0, 5, 99};
+    std::vector<size_t> depth(adj.size(), 100);
+    auto record = [&](uint32_t u, size_t d) {
+        depth[u] = d;
+        return true;
+    };
+    REQUIRE(bfs(adj, std::span<const uint32_t>(sources), record, {.max_depth = 1}) == false);
+    REQUIRE(depth == std::vector<size_t>{0, 1, 100, 100, 1, 0});
+    bfs(adj, std::span<const uint32_t>(sources), record);
+    REQUIRE(depth == std::vector<size_t>{0, 1, 2, 2, 1, 0});
+}
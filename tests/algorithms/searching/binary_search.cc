@@ -1,5 +1,9 @@
 #include "../../../src/algorithms/searching/binary_search.h"
 #include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+#include <span>
+#include <vector>
 
 TEST_CASE("testing binary search") {
     std::vector<int> v = {-10, 10, 20, 30, 100};
@@ -24,3 +28,41 @@ TEST_CASE("testing upper_bound search") {
     REQUIRE(upper_bound(v, 0, v.size(), -20) == 0);
     REQUIRE(upper_bound(v, 0, v.size(), 100) == v.size());
 }
+
+TEST_CASE("testing the span searches") {
+    std::vector<int> v = {10, 10, 20, 30, 30, 30, 30, 100};
+    std::span<const int> s(v);
+    for (int x : {-5, 10, 15, 20, 30, 35, 100, 105}) {
+        size_t lo = size_t(std::lower_bound(v.begin(), v.end(), x) - v.begin());
+        size_t hi = size_t(std::upper_bound(v.begin(), v.end(), x) - v.begin());
+        REQUIRE(lower_bound(s, x) == lo);
+        REQUIRE(branchless_lower_bound(s, x) == lo);
+        REQUIRE(upper_bound(s, x) == hi);
+        REQUIRE(lower_bound(v, x) == lo);
+        REQUIRE(upper_bound(v, x) == hi);
+        REQUIRE((bin_search(s, x) >= 0) == (lo < hi));
+    }
+    REQUIRE(bin_search(v, 20) == 2);
+    std::vector<int> empty;
+    REQUIRE(lower_bound(empty, 1) == 0);
+    REQUIRE(upper_bound(empty, 1) == 0);
+    REQUIRE(bin_search(empty, 1) == -1);
+}
+
+TEST_CASE("testing eytzinger_index") {
+    std::mt19937 rng(5);
+    for (size_t n : {0, 1, 2, 3, 7, 8, 100, 4097}) {
+        std::vector<int> v(n);
+        for (auto& x : v) {
+            x = int(rng() % (2 * n + 1));
+        }
+        std::sort(v.begin(), v.end());
+        eytzinger_index<int> e{std::span<const int>(v)};
+        REQUIRE(e.size() == n);
+        for (int x = -1; x <= int(2 * n + 2); x++) {
+            auto it = std::lower_bound(v.begin(), v.end(), x);
+            REQUIRE(e.lower_bound(x) == size_t(it - v.begin()));
+            REQUIRE(e.contains(x) == std::binary_search(v.begin(), v.end(), x));
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "../../../src/algorithms/searching/dfs.h"
+#include "../../../src/classes/graph/graph.h"
 #include "../../../third_party/catch.hpp"
 
 TEST_CASE("testing depth first search") {
@@ -22,3 +23,49 @@ TEST_CASE("testing depth first search 2") {
     adj['g'] = {'f'};
     REQUIRE(dfs(adj, 'a', 'f') == false);
 }
+
+TEST_CASE("testing depth first search on a snapshot") {
+    graph<int> g("directed");
+    for (int i = 0; i < 5; i++) {
+        g.add_edge(i, i + 1);
+    }
+    g.add_edge(0, 3);
+    g.add_edge(7, 0);
+    const csr_graph<int>& c = g.csr_view();
+    REQUIRE(dfs(c, 0, 5) == true);
+    REQUIRE(dfs(c, 0, 7) == false);
+    REQUIRE(dfs(c, 0, 42) == false);
+    // 4 is first reached at depth 4 through 1, 2, 3 and must go through 0 -> 3 instead
+    REQUIRE(dfs(c, 0, 4, {.max_depth = 2}) == true);
+    REQUIRE(dfs(c, 0, 5, {.max_depth = 2}) == false);
+
+    std::vector<std::pair<int, size_t>> seen;
+    auto record = [&](uint32_t u, size_t depth) {
+        seen.push_back({c.vertex(u), depth});
+        return true;
+    };
+    REQUIRE(dfs(c, c.id(0), record, {.max_depth = 3}) == false);
+    std::vector<std::pair<int, size_t>> want = {{0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 2}, {5, 3}};
+    REQUIRE(seen == want);
+
+    size_t calls = 0;
+    REQUIRE(dfs(c, c.id(0), [&](uint32_t, size_t) { return ++calls < 2; }) == true);
+    REQUIRE(calls == 2);
+}
+
+TEST_CASE("testing multi source depth first search on an adjacency list") {
+    std::vector<std::vector<uint32_t>> adj = {{1}, {2}, {0}, {1}, {}};
+    std::vector<uint32_t> sources = {3, 4, 0};
+    std::vector<uint32_t> order;
+    graph_workspace ws;
+    for (int rep = 0; rep < 2; rep++) {
+        order.clear();
+        auto record = [&](uint32_t u, size_t) {
+            order.push_back(u);
+            return true;
+        };
+        REQUIRE(dfs(adj, std::span<const uint32_t>(sources), record, {.workspace = &ws}) ==
+                false);
+        REQUIRE(order == std::vector<uint32_t>{3, 1, 2, 0, 4});
+    }
+}
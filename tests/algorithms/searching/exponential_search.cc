@@ -6,4 +6,11 @@ TEST_CASE("testing exponential search") {
     REQUIRE(exponential_search(v, 15) == 1);
     REQUIRE(exponential_search(v, 60) == 2);
     REQUIRE(exponential_search(v, -10) == -1);
-}
\ No newline at end of file
+}
+
+TEST_CASE("testing exponential search at the ends") {
+    std::vector<int> v = {1, 15, 60, 100, 150, 300};
+    REQUIRE(exponential_search(v, 1) == 0);
+    REQUIRE(exponential_search(v, 300) == 5);
+    REQUIRE(exponential_search(std::vector<int>{}, 3) == -1);
+}
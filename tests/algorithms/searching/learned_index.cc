@@ -0,0 +1,143 @@
+#include "../../../src/algorithms/searching/learned_index.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+template <typename T>
+void check_every_lookup(const learned_index<T>& index, const std::vector<T>& v) {
+    for (const T& x : v) {
+        const size_t expected = size_t(std::lower_bound(v.begin(), v.end(), x) - v.begin());
+        REQUIRE(index.lower_bound(x) == expected);
+        REQUIRE(index.find(x) == int64_t(expected));
+    }
+}
+} // namespace
+
+TEST_CASE("testing the learned index on small inputs") {
+    std::vector<int> v = {-10, 4, 7, 10, 14, 18, 25};
+    learned_index<int> index(v, 1, 1);
+    REQUIRE(index.size() == 7);
+    REQUIRE(index.find(7) == 2);
+    REQUIRE(index.find(3) == -1);
+    REQUIRE(index.lower_bound(-100) == 0);
+    REQUIRE(index.lower_bound(100) == 7);
+    REQUIRE(index.lower_bound(15) == 5);
+    REQUIRE(index.contains(25));
+    REQUIRE(!index.contains(26));
+
+    std::vector<int> empty;
+    learned_index<int> none(empty);
+    REQUIRE(none.lower_bound(3) == 0);
+    REQUIRE(!none.contains(3));
+    REQUIRE(none.segments() == 0);
+
+    std::vector<int> unsorted = {1, 3, 2};
+    REQUIRE_THROWS_AS(learned_index<int>(unsorted), std::invalid_argument);
+}
+
+TEST_CASE("testing the learned index on narrow signed keys") {
+    std::vector<int16_t> s = {-5, -3, 1, 3, 7};
+    learned_index<int16_t> small(s, 1, 1);
+    check_every_lookup(small, s);
+    REQUIRE(small.lower_bound(-4) == 1);
+    REQUIRE(small.find(0) == -1);
+
+    std::vector<int8_t> c;
+    for (int x = -128; x < 128; x += 3) {
+        c.push_back(int8_t(x));
+    }
+    learned_index<int8_t> index(c, 2, 1);
+    REQUIRE(index.segments() < c.size());
+    check_every_lookup(index, c);
+    for (int x = -128; x < 128; x++) {
+        REQUIRE(index.lower_bound(int8_t(x)) ==
+                size_t(std::lower_bound(c.begin(), c.end(), int8_t(x)) - c.begin()));
+    }
+}
+
+TEST_CASE("testing the learned index on skewed keys") {
+    // timestamps in bursts: interpolation over the whole range is far off, lines per
+    // segment are not
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> v;
+    uint64_t t = uint64_t(1) << 60;
+    for (int burst = 0; burst < 50; burst++) {
+        t += rng() % 1000000000;
+        for (int i = 0; i < 2000; i++) {
+            t += rng() % (burst % 3 == 0 ? 3 : 100);
+            v.push_back(t);
+        }
+    }
+    for (size_t epsilon : {0, 4, 32, 128}) {
+        learned_index<uint64_t> index(v, epsilon);
+        REQUIRE(index.epsilon() == epsilon);
+        REQUIRE(index.segments() < v.size());
+        check_every_lookup(index, v);
+        for (int i = 0; i < 10000; i++) {
+            uint64_t x = v.front() - 5 + rng() % (v.back() - v.front() + 10);
+            REQUIRE(index.lower_bound(x) ==
+                    size_t(std::lower_bound(v.begin(), v.end(), x) - v.begin()));
+        }
+    }
+    // a few bytes per segment, nothing per key
+    learned_index<uint64_t> index(v);
+    REQUIRE(index.height() >= 1);
+    REQUIRE(index.memory_usage().total() < v.size() * sizeof(uint64_t) / 4);
+}
+
+TEST_CASE("testing the learned index with repeated and floating point keys") {
+    std::vector<int> runs;
+    for (int k = 0; k < 300; k++) {
+        runs.insert(runs.end(), size_t(k % 7 == 0 ? 500 : 1 + k % 5), k * 3);
+    }
+    learned_index<int> index(runs, 2);
+    check_every_lookup(index, runs);
+    for (int x = -2; x < 905; x++) {
+        REQUIRE(index.lower_bound(x) ==
+                size_t(std::lower_bound(runs.begin(), runs.end(), x) - runs.begin()));
+    }
+
+    std::vector<double> d(20000);
+    for (size_t i = 0; i < d.size(); i++) {
+        d[i] = std::exp(double(i) / 1000.0);
+    }
+    learned_index<double> exp_index(d, 8);
+    check_every_lookup(exp_index, d);
+    REQUIRE(exp_index.lower_bound(1.5) ==
+            size_t(std::lower_bound(d.begin(), d.end(), 1.5) - d.begin()));
+}
+
+TEST_CASE("testing that the learned index extends with appended keys") {
+    std::mt19937 rng(3);
+    std::vector<int64_t> v = {5};
+    learned_index<int64_t> index(v, 4, 2);
+    for (int round = 0; round < 200; round++) {
+        size_t more = 1 + rng() % 300;
+        for (size_t i = 0; i < more; i++) {
+            v.push_back(v.back() + int64_t(rng() % (round % 2 ? 1000 : 4)));
+        }
+        index.extend(v);
+        REQUIRE(index.size() == v.size());
+    }
+    check_every_lookup(index, v);
+    learned_index<int64_t> rebuilt(v, 4, 2);
+    REQUIRE(index.height() >= 2);
+    REQUIRE(index.segments() <= 2 * rebuilt.segments());
+
+    std::vector<int64_t> fewer(v.begin(), v.end() - 1);
+    REQUIRE_THROWS_AS(index.extend(fewer), std::invalid_argument);
+    std::vector<int64_t> bad = v;
+    bad.push_back(v.back() - 1);
+    REQUIRE_THROWS_AS(index.extend(bad), std::invalid_argument);
+    REQUIRE(index.find(v.back()) == int64_t(v.size()) - 1);
+
+    std::vector<int64_t> grown;
+    learned_index<int64_t> from_empty(grown);
+    grown = {1, 2, 3};
+    from_empty.extend(grown);
+    REQUIRE(from_empty.find(3) == 2);
+}
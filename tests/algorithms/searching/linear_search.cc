@@ -1,8 +1,48 @@
 #include "../../../src/algorithms/searching/linear_search.h"
 #include "../../../third_party/catch.hpp"
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
 
 TEST_CASE("testing linear search") {
     std::vector<int> v = {1, 5, 3, 1, 2, 3, -41, -20};
     REQUIRE(linear_search(v, 5) == true);
     REQUIRE(linear_search(v, -40) == false);
-}
\ No newline at end of file
+}
+template <typename T> static void check_find(size_t threads) {
+    std::mt19937 rng(6);
+    for (size_t n : {0, 1, 31, 32, 129, 1000, 300000}) {
+        std::vector<T> v(n);
+        for (auto& x : v) {
+            x = T(rng() % 50);
+        }
+        for (int key : {0, 7, 49, 50}) {
+            std::vector<size_t> want;
+            for (size_t i = 0; i < n; i++) {
+                if (v[i] == T(key)) {
+                    want.push_back(i);
+                }
+            }
+            std::span<const T> s(v);
+            REQUIRE(linear_find_all(s, T(key), threads) == want);
+            REQUIRE(linear_find(s, T(key), threads) == (want.empty() ? -1 : int64_t(want[0])));
+        }
+    }
+}
+
+TEST_CASE("testing linear_find and linear_find_all") {
+    for (size_t threads : {1, 4}) {
+        check_find<int8_t>(threads);
+        check_find<int16_t>(threads);
+        check_find<int32_t>(threads);
+        check_find<uint64_t>(threads);
+        check_find<float>(threads);
+        check_find<double>(threads);
+    }
+    std::vector<std::string> words = {"a", "b", "c", "b"};
+    REQUIRE(linear_find(std::span<const std::string>(words), "b") == 1);
+    REQUIRE(linear_find_all(std::span<const std::string>(words), "b") ==
+            std::vector<size_t>{1, 3});
+}
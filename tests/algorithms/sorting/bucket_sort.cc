@@ -1,5 +1,6 @@
 #include "../../../src/algorithms/sorting/bucket_sort.h"
 #include "../../../third_party/catch.hpp"
+#include <algorithm>
 #include <random>
 #include <string>
 
@@ -8,3 +9,37 @@ TEST_CASE("testing radix sort") {
     bucket_sort(v);
     REQUIRE(std::is_sorted(v.begin(), v.end()) == true);
 }
+
+TEST_CASE("Test bucket_sort on skewed values and many threads") {
+    std::mt19937_64 rng(9);
+    std::vector<double> v(200000);
+    for (auto& x : v) {
+        // most values are tiny, a few are huge and a lot are the same
+        uint64_t r = rng() % 100;
+        x = r < 40 ? 1.0 : r < 99 ? double(rng() % 1000) / 1e6 : double(rng());
+    }
+    auto want = v;
+    std::sort(want.begin(), want.end());
+    for (size_t threads : {1, 4}) {
+        auto w = v;
+        bucket_sort(w, threads);
+        REQUIRE(w == want);
+    }
+
+    std::vector<int> same(50000, 7);
+    same[123] = -1;
+    bucket_sort(same, 0);
+    REQUIRE(std::is_sorted(same.begin(), same.end()));
+    REQUIRE(same[0] == -1);
+}
+
+TEST_CASE("Test bucket_sort on strings") {
+    std::vector<std::string> v;
+    for (int i = 0; i < 20000; i++) {
+        v.push_back(std::to_string((i * 7919) % 20011));
+    }
+    auto want = v;
+    std::sort(want.begin(), want.end());
+    bucket_sort(v, 3);
+    REQUIRE(v == want);
+}
@@ -1,6 +1,7 @@
 #include "../../../src/algorithms/sorting/counting_sort.h"
 #include "../../../third_party/catch.hpp"
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 
 TEST_CASE("Test counting_sort function with integer vector") {
@@ -18,3 +19,23 @@ TEST_CASE("Test counting_sort function with another integer vector") {
     counting_sort(v);
     REQUIRE(std::is_sorted(v.begin(), v.end()) == true);
 }
+
+TEST_CASE("Test counting_sort with negative keys and one outlier") {
+    std::vector<int> v = {3, -2, 7, -2, 0, 3, 3};
+    counting_sort(v);
+    REQUIRE(v == std::vector<int>{-2, -2, 0, 3, 3, 3, 7});
+
+    // the range spans the whole type, the vector is radix sorted instead
+    std::vector<int64_t> w = {5, INT64_MAX, 1, INT64_MIN, 2, 5, 0};
+    counting_sort(w);
+    REQUIRE(w == std::vector<int64_t>{INT64_MIN, 0, 1, 2, 5, 5, INT64_MAX});
+
+    std::vector<uint32_t> u(10000);
+    for (size_t i = 0; i < u.size(); i++) {
+        u[i] = uint32_t((i * 7919) % 1000);
+    }
+    u.push_back(4000000000u);
+    counting_sort(u, 2000);
+    REQUIRE(std::is_sorted(u.begin(), u.end()));
+    REQUIRE(u.back() == 4000000000u);
+}
@@ -0,0 +1,107 @@
+#include "../../../src/algorithms/sorting/external_sort.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <vector>
+
+template <typename T> static std::string to_bytes(const std::vector<T>& v) {
+    return std::string(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+template <typename T> static std::vector<T> from_bytes(const std::string& s) {
+    std::vector<T> v(s.size() / sizeof(T));
+    std::copy(s.begin(), s.end(), reinterpret_cast<char*>(v.data()));
+    return v;
+}
+
+TEST_CASE("Test external_sort in one run") {
+    std::vector<int32_t> v = {5, -1, 3, 9, 0, 2};
+    std::stringstream in(to_bytes(v)), out;
+    REQUIRE(external_sort<int32_t>(in, out) == v.size());
+    std::sort(v.begin(), v.end());
+    REQUIRE(from_bytes<int32_t>(out.str()) == v);
+
+    std::stringstream empty, empty_out;
+    REQUIRE(external_sort<int32_t>(empty, empty_out) == 0);
+    REQUIRE(empty_out.str().empty());
+}
+
+TEST_CASE("Test external_sort with many runs and merge passes") {
+    std::mt19937_64 rng(11);
+    std::vector<uint64_t> v(50000);
+    for (auto& x : v) {
+        x = rng();
+    }
+    external_sort_options opt;
+    opt.run_bytes = 1000 * sizeof(uint64_t);
+    opt.buffer_bytes = 64 * sizeof(uint64_t);
+    opt.threads = 2;
+    for (size_t fan_in : {2, 3, 7, 128}) {
+        opt.fan_in = fan_in;
+        std::stringstream in(to_bytes(v)), out;
+        REQUIRE(external_sort<uint64_t>(in, out, std::less<>(), opt) == v.size());
+        auto want = v;
+        std::sort(want.begin(), want.end());
+        REQUIRE(from_bytes<uint64_t>(out.str()) == want);
+    }
+    // the run files are gone
+    for (const auto& e : std::filesystem::directory_iterator(opt.temp_dir)) {
+        REQUIRE(e.path().filename().string().rfind("algoplus_sort_", 0) != 0);
+    }
+}
+
+TEST_CASE("Test external_sort is stable") {
+    struct record {
+        int32_t key;
+        int32_t order;
+    };
+    std::vector<record> v;
+    for (int32_t i = 0; i < 20000; i++) {
+        v.push_back({(i * 7919) % 13, i});
+    }
+    external_sort_options opt;
+    opt.run_bytes = 777 * sizeof(record);
+    opt.buffer_bytes = 10 * sizeof(record);
+    opt.fan_in = 4;
+    std::stringstream in(to_bytes(v)), out;
+    external_sort<record>(in, out, [](const record& a, const record& b) { return a.key < b.key; },
+                          opt);
+    auto got = from_bytes<record>(out.str());
+    REQUIRE(got.size() == v.size());
+    for (size_t i = 1; i < got.size(); i++) {
+        REQUIRE(got[i - 1].key <= got[i].key);
+        if (got[i - 1].key == got[i].key) {
+            REQUIRE(got[i - 1].order < got[i].order);
+        }
+    }
+}
+
+TEST_CASE("Test external_sort on files and errors") {
+    auto dir = std::filesystem::temp_directory_path();
+    auto input = dir / "algoplus_external_in.bin", output = dir / "algoplus_external_out.bin";
+    std::vector<double> v = {2.5, -1.0, 3.25, 0.0, -7.5};
+    {
+        std::ofstream f(input, std::ios::binary);
+        f << to_bytes(v);
+    }
+    external_sort_options opt;
+    opt.run_bytes = 2 * sizeof(double);
+    REQUIRE(external_sort<double>(input, output, std::less<>(), opt) == v.size());
+    std::ifstream f(output, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    std::sort(v.begin(), v.end());
+    REQUIRE(from_bytes<double>(bytes) == v);
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+
+    REQUIRE_THROWS_AS(external_sort<double>(dir / "algoplus_missing.bin", output),
+                      std::runtime_error);
+    std::stringstream truncated(std::string(6, 'x')), out;
+    REQUIRE_THROWS_AS(external_sort<int32_t>(truncated, out), std::runtime_error);
+    opt.fan_in = 1;
+    std::stringstream in(to_bytes(v));
+    REQUIRE_THROWS_AS(external_sort<double>(in, out, std::less<>(), opt), std::invalid_argument);
+}
@@ -12,3 +12,11 @@ TEST_CASE("testing heap sort") {
     heap_sort(v);
     REQUIRE(std::is_sorted(v.begin(), v.end()) == true);
 }
+
+TEST_CASE("testing heap sort on a range") {
+    std::vector<std::string> v = {"d", "a", "c", "b", "e", "a"};
+    heap_sort(v.begin(), v.end(), std::greater<>());
+    REQUIRE(v == std::vector<std::string>{"e", "d", "c", "b", "a", "a"});
+    heap_sort(v.begin() + 1, v.end());
+    REQUIRE(v == std::vector<std::string>{"e", "a", "a", "b", "c", "d"});
+}
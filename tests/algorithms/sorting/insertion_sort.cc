@@ -2,6 +2,7 @@
 #include "../../../third_party/catch.hpp"
 #include <random>
 #include <string>
+#include <vector>
 
 TEST_CASE("testing insertion sort") {
     std::vector<int64_t> v;
@@ -19,3 +20,9 @@ TEST_CASE("testing insertion sort v2") {
     insertion_sort(v);
     REQUIRE(std::is_sorted(v.begin(), v.end()) == true);
 }
+
+TEST_CASE("testing insertion sort keeps every value") {
+    std::vector<int> v = {5, 1, 4, 1, 3, 9, 2};
+    insertion_sort(v);
+    REQUIRE(v == std::vector<int>{1, 1, 2, 3, 4, 5, 9});
+}
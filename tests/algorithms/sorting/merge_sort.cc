@@ -1,6 +1,8 @@
 #include "../../../src/algorithms/sorting/merge_sort.h"
 #include "../../../third_party/catch.hpp"
+#include <algorithm>
 #include <random>
+#include <string>
 #include <vector>
 
 TEST_CASE("testing merge sort") {
@@ -12,3 +14,42 @@ TEST_CASE("testing merge sort") {
     merge_sort(v.begin(), v.end());
     REQUIRE(std::is_sorted(v.begin(), v.end()) == true);
 }
+
+TEST_CASE("testing merge sort is stable") {
+    std::mt19937 rng(5);
+    for (size_t n : {0, 1, 2, 31, 32, 33, 100, 1000, 70000}) {
+        std::vector<std::pair<int, int>> v(n);
+        for (size_t i = 0; i < n; i++) {
+            v[i] = {int(rng() % 50), int(i)};
+        }
+        std::vector<std::pair<int, int>> expected = v;
+        auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+        std::stable_sort(expected.begin(), expected.end(), by_key);
+        for (size_t threads : {1, 2, 3, 4}) {
+            std::vector<std::pair<int, int>> w = v;
+            merge_sort(w.begin(), w.end(), by_key, threads);
+            REQUIRE(w == expected);
+        }
+    }
+}
+
+TEST_CASE("testing parallel merge sort") {
+    std::mt19937 rng(9);
+    std::vector<std::string> v(50000);
+    for (auto& s : v) {
+        s = std::to_string(rng() % 100000);
+    }
+    std::vector<std::string> expected = v;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    parallel_merge_sort(v.begin(), v.end(), std::greater<>());
+    REQUIRE(v == expected);
+
+    std::vector<int> a(200000);
+    for (int& x : a) {
+        x = int(rng());
+    }
+    std::vector<int> b = a;
+    merge_sort(a.begin(), a.end(), std::less<>(), 8);
+    std::sort(b.begin(), b.end());
+    REQUIRE(a == b);
+}
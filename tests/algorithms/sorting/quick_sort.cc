@@ -1,6 +1,8 @@
 #include "../../../src/algorithms/sorting/quick_sort.h"
 #include "../../../third_party/catch.hpp"
+#include <algorithm>
 #include <random>
+#include <string>
 #include <vector>
 
 TEST_CASE("testing quick sort") {
@@ -25,3 +27,39 @@ TEST_CASE("testing quick sort 2") {
     quick_sort(v.begin(), v.end());
     REQUIRE(std::is_sorted(v.begin(), v.end()) == true);
 }
+
+TEST_CASE("testing quick sort on patterns") {
+    std::mt19937 rng(13);
+    for (size_t n : {0, 1, 2, 3, 24, 25, 100, 129, 1000, 100000}) {
+        std::vector<std::vector<int>> inputs(6, std::vector<int>(n));
+        for (size_t i = 0; i < n; i++) {
+            inputs[0][i] = int(i);                              // sorted
+            inputs[1][i] = int(n - i);                          // reversed
+            inputs[2][i] = int(std::min(i, n - i));             // organ pipe
+            inputs[3][i] = 7;                                   // all equal
+            inputs[4][i] = int(rng() % 4);                      // few distinct
+            inputs[5][i] = i % 100 == 0 ? int(rng()) : int(i); // almost sorted
+        }
+        for (auto& v : inputs) {
+            std::vector<int> expected = v;
+            std::sort(expected.begin(), expected.end());
+            for (size_t threads : {1, 4}) {
+                std::vector<int> w = v;
+                quick_sort(w.begin(), w.end(), std::less<>(), threads);
+                REQUIRE(w == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("testing quick sort with a comparator and threads") {
+    std::mt19937 rng(17);
+    std::vector<std::string> v(100000);
+    for (auto& s : v) {
+        s = std::to_string(rng() % 1000);
+    }
+    std::vector<std::string> expected = v;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    quick_sort(v.begin(), v.end(), std::greater<>(), 3);
+    REQUIRE(v == expected);
+}
@@ -1,6 +1,9 @@
 #include "../../../src/algorithms/sorting/radix_sort.h"
 #include "../../../third_party/catch.hpp"
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
 #include <vector>
 
 TEST_CASE("Test radix_sort function with integer vector") {
@@ -14,3 +17,67 @@ TEST_CASE("Test radix_sort function with an already sorted vector") {
     radix_sort(v);
     REQUIRE(std::is_sorted(v.begin(), v.end()) == true);
 }
+
+TEST_CASE("Test radix_sort with negative and 64 bit integers") {
+    std::vector<int64_t> v = {5, -3, 0, INT64_MIN, INT64_MAX, -1, 42, -42, 1LL << 40};
+    std::vector<int64_t> want = v;
+    std::sort(want.begin(), want.end());
+    radix_sort(v);
+    REQUIRE(v == want);
+
+    std::vector<int8_t> small = {-128, 127, 0, -1, 1, 5, -5};
+    radix_sort(small);
+    REQUIRE(std::is_sorted(small.begin(), small.end()));
+}
+
+TEST_CASE("Test radix_sort with floating point keys") {
+    std::vector<double> v = {3.5, -0.0, 0.0, -2.25, 1e300, -1e300, 1e-300, -1e-300, 0.5};
+    radix_sort(v);
+    REQUIRE(std::is_sorted(v.begin(), v.end()));
+    REQUIRE(std::signbit(v[3]));
+    REQUIRE(!std::signbit(v[4]));
+
+    std::vector<float> f = {2.0f, -1.0f, 0.25f, -0.75f, 100.0f, -100.0f};
+    radix_sort(f);
+    REQUIRE(f == std::vector<float>{-100.0f, -1.0f, -0.75f, 0.25f, 2.0f, 100.0f});
+}
+
+TEST_CASE("Test radix_sort with a key, it is stable") {
+    struct item {
+        int key;
+        int order;
+    };
+    std::vector<item> v;
+    for (int i = 0; i < 1000; i++) {
+        v.push_back({(i * 37) % 11 - 5, i});
+    }
+    radix_sort(v.begin(), v.end(), &item::key);
+    for (size_t i = 1; i < v.size(); i++) {
+        REQUIRE(v[i - 1].key <= v[i].key);
+        if (v[i - 1].key == v[i].key) {
+            REQUIRE(v[i - 1].order < v[i].order);
+        }
+    }
+}
+
+TEST_CASE("Test radix_sort on many threads") {
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> v(300000);
+    for (auto& x : v) {
+        x = rng() >> (rng() % 64);
+    }
+    std::vector<uint64_t> want = v;
+    std::sort(want.begin(), want.end());
+    radix_sort(v.begin(), v.end(), std::identity(), 4);
+    REQUIRE(v == want);
+
+    std::vector<std::pair<int32_t, size_t>> p(200000);
+    for (size_t i = 0; i < p.size(); i++) {
+        p[i] = {int32_t(rng() % 1000) - 500, i};
+    }
+    auto serial = p;
+    radix_sort(serial.begin(), serial.end(), [](const auto& x) { return x.first; });
+    radix_sort(p.begin(), p.end(), [](const auto& x) { return x.first; }, 0);
+    REQUIRE(p == serial);
+    REQUIRE(std::is_sorted(p.begin(), p.end()));
+}
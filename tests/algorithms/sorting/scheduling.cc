@@ -1,5 +1,6 @@
 #include "../../../src/algorithms/sorting/scheduling.h"
 #include "../../../third_party/catch.hpp"
+#include <random>
 
 TEST_CASE("Testing scheduling [1]") {
     std::vector<std::pair<int, int>> v = {{0, 1}, {0, 2}, {1, 2}, {2, 4}};
@@ -26,3 +27,92 @@ TEST_CASE("Testing scheduling [1]") {
 
     REQUIRE(scheduling(v) == 2);
 }
+
+TEST_CASE("Testing interval scheduling without a copy") {
+    std::vector<std::pair<int, int>> v = {{0, 3}, {2, 5}, {3, 9}, {7, 8}, {8, 10}};
+    std::vector<size_t> kept = interval_scheduling(std::span<const std::pair<int, int>>(v));
+    REQUIRE(kept == std::vector<size_t>{0, 3, 4});
+    REQUIRE(v[1] == std::pair<int, int>(2, 5)); // untouched
+
+    std::vector<std::pair<double, double>> sorted = {{0, 1}, {0.5, 1.5}, {1, 2}, {1.5, 3}};
+    auto s = std::span<const std::pair<double, double>>(sorted);
+    REQUIRE(sorted_interval_scheduling(s) == std::vector<size_t>{0, 2});
+    std::swap(sorted[0], sorted[3]);
+    REQUIRE_THROWS_AS(sorted_interval_scheduling(s), std::invalid_argument);
+
+    interval_scheduler<long> stream;
+    REQUIRE(stream.offer(0, 2));
+    REQUIRE(!stream.offer(1, 3));
+    REQUIRE(stream.offer(2, 4));
+    REQUIRE(stream.count() == 2);
+    REQUIRE(interval_scheduling(std::span<const std::pair<int, int>>()).empty());
+}
+
+TEST_CASE("Testing weighted interval scheduling") {
+    std::vector<std::pair<int, int>> v = {{0, 3}, {1, 4}, {3, 6}, {4, 7}, {6, 9}};
+    std::vector<int> w = {2, 4, 4, 7, 2};
+    auto jobs = std::span<const std::pair<int, int>>(v);
+    weighted_schedule<int> best = weighted_interval_scheduling(jobs, std::span<const int>(w));
+    REQUIRE(best.weight == 11);
+    REQUIRE(best.jobs == std::vector<size_t>{1, 3});
+
+    // against every subset of random jobs
+    std::mt19937 rng(5);
+    for (int round = 0; round < 50; round++) {
+        size_t n = rng() % 12;
+        std::vector<std::pair<int, int>> r(n);
+        std::vector<double> rw(n);
+        for (size_t i = 0; i < n; i++) {
+            int a = int(rng() % 20), b = a + 1 + int(rng() % 6);
+            r[i] = {a, b};
+            rw[i] = double(rng() % 10);
+        }
+        double expected = 0;
+        for (size_t mask = 0; mask < (size_t(1) << n); mask++) {
+            bool ok = true;
+            double total = 0;
+            for (size_t i = 0; i < n && ok; i++) {
+                if (!(mask >> i & 1)) {
+                    continue;
+                }
+                total += rw[i];
+                for (size_t j = i + 1; j < n; j++) {
+                    if ((mask >> j & 1) && r[i].first < r[j].second && r[j].first < r[i].second) {
+                        ok = false;
+                    }
+                }
+            }
+            if (ok) {
+                expected = std::max(expected, total);
+            }
+        }
+        auto result = weighted_interval_scheduling(std::span<const std::pair<int, int>>(r),
+                                                   std::span<const double>(rw));
+        REQUIRE(result.weight == expected);
+        double total = 0;
+        for (size_t k = 0; k < result.jobs.size(); k++) {
+            total += rw[result.jobs[k]];
+            if (k > 0) {
+                REQUIRE(r[result.jobs[k - 1]].second <= r[result.jobs[k]].first);
+            }
+        }
+        REQUIRE(total == expected);
+    }
+    REQUIRE_THROWS_AS(weighted_interval_scheduling(jobs, std::span<const int>(w).first(2)),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Testing interval partitioning") {
+    std::vector<std::pair<int, int>> v = {{0, 3}, {1, 4}, {2, 5}, {3, 6}, {4, 7}, {5, 8}, {9, 10}};
+    machine_assignment a = interval_partitioning(std::span<const std::pair<int, int>>(v));
+    REQUIRE(a.machines == 3);
+    for (size_t i = 0; i < v.size(); i++) {
+        REQUIRE(a.machine[i] < a.machines);
+        for (size_t j = i + 1; j < v.size(); j++) {
+            if (a.machine[i] == a.machine[j]) {
+                REQUIRE((v[i].second <= v[j].first || v[j].second <= v[i].first));
+            }
+        }
+    }
+    REQUIRE(interval_partitioning(std::span<const std::pair<int, int>>()).machines == 0);
+}
@@ -0,0 +1,85 @@
+#include "../../../src/algorithms/sorting/selection.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("Test quick_select on random and repeated values") {
+    std::mt19937_64 rng(1);
+    for (size_t n : {1, 2, 10, 25, 100, 1000, 50000}) {
+        for (uint64_t mod : {3, 1000000}) {
+            std::vector<int> v(n);
+            for (auto& x : v) {
+                x = int(rng() % mod);
+            }
+            auto want = v;
+            std::sort(want.begin(), want.end());
+            for (size_t nth : {size_t(0), n / 3, n - 1}) {
+                auto w = v;
+                quick_select(w.begin(), w.begin() + nth, w.end());
+                REQUIRE(w[nth] == want[nth]);
+                int m = w[nth];
+                REQUIRE(std::all_of(w.begin(), w.begin() + nth, [&](int x) { return x <= m; }));
+                REQUIRE(std::all_of(w.begin() + nth, w.end(), [&](int x) { return x >= m; }));
+            }
+        }
+    }
+}
+
+TEST_CASE("Test quick_select with a comparator and on sorted input") {
+    std::vector<int> v(100000);
+    for (size_t i = 0; i < v.size(); i++) {
+        v[i] = int(i);
+    }
+    quick_select(v.begin(), v.begin() + 10, v.end(), std::greater<>());
+    REQUIRE(v[10] == 99989);
+
+    std::vector<std::string> s = {"pear", "apple", "fig", "kiwi", "banana"};
+    quick_select(s.begin(), s.begin() + 2, s.end());
+    REQUIRE(s[2] == "fig");
+}
+
+TEST_CASE("Test partial_quick_sort") {
+    std::mt19937_64 rng(2);
+    std::vector<double> v(30000);
+    for (auto& x : v) {
+        x = double(rng() % 100000) / 7;
+    }
+    auto want = v;
+    std::sort(want.begin(), want.end());
+    partial_quick_sort(v.begin(), v.begin() + 500, v.end());
+    REQUIRE(std::equal(v.begin(), v.begin() + 500, want.begin()));
+    auto all = v;
+    partial_quick_sort(all.begin(), all.end(), all.end());
+    REQUIRE(all == want);
+}
+
+TEST_CASE("Test top_k and top_k_heap") {
+    std::mt19937_64 rng(3);
+    std::vector<float> scores(1000000);
+    for (auto& x : scores) {
+        x = float(rng() % 10000000) / 100;
+    }
+    auto want = scores;
+    std::sort(want.begin(), want.end(), std::greater<>());
+    for (size_t threads : {1, 4}) {
+        auto top = top_k(scores.begin(), scores.end(), 100, std::less<>(), threads);
+        REQUIRE(top == std::vector<float>(want.begin(), want.begin() + 100));
+    }
+    // a large k takes the quick_select path
+    auto big = top_k(scores.begin(), scores.end(), 200000);
+    REQUIRE(big == std::vector<float>(want.begin(), want.begin() + 200000));
+    REQUIRE(top_k(scores.begin(), scores.begin() + 3, 10).size() == 3);
+    REQUIRE(top_k(scores.begin(), scores.end(), 0).empty());
+
+    // the smallest ones with std::greater
+    top_k_heap<int, std::greater<>> h(3);
+    std::vector<int> stream = {9, 4, 7, 1, 8, 2, 6};
+    h.push(stream.begin(), stream.end());
+    h.push(0);
+    REQUIRE(h.size() == 3);
+    REQUIRE(h.threshold() == 2);
+    REQUIRE(h.sorted() == std::vector<int>{0, 1, 2});
+}
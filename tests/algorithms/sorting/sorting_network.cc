@@ -0,0 +1,66 @@
+#include "../../../src/algorithms/sorting/sorting_network.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+template <typename T> static void check_every_size(std::mt19937_64& rng) {
+    for (size_t n = 0; n <= network_sort_max + 3; n++) {
+        for (int round = 0; round < 20; round++) {
+            std::vector<T> v(n);
+            for (auto& x : v) {
+                x = T(int64_t(rng() % 200) - 100) / T(round % 2 ? 1 : 3);
+            }
+            std::vector<T> want = v;
+            std::sort(want.begin(), want.end());
+            network_sort(v.begin(), v.end());
+            REQUIRE(v == want);
+        }
+    }
+}
+
+TEST_CASE("Test network_sort on every size of the SIMD types") {
+    std::mt19937_64 rng(3);
+    check_every_size<int32_t>(rng);
+    check_every_size<float>(rng);
+    check_every_size<int64_t>(rng);
+    check_every_size<double>(rng);
+}
+
+TEST_CASE("Test network_sort on the other arithmetic types") {
+    std::mt19937_64 rng(4);
+    check_every_size<int16_t>(rng);
+    check_every_size<uint32_t>(rng);
+    check_every_size<char>(rng);
+}
+
+TEST_CASE("Test network_sort with extreme values") {
+    std::vector<int32_t> v = {INT32_MAX, INT32_MIN, 0, INT32_MAX, -1, INT32_MIN, 7};
+    network_sort(v.begin(), v.end());
+    REQUIRE(v == std::vector<int32_t>{INT32_MIN, INT32_MIN, -1, 0, 7, INT32_MAX, INT32_MAX});
+
+    std::vector<double> d = {1.0, -std::numeric_limits<double>::infinity(), 0.5,
+                             std::numeric_limits<double>::infinity(), -3.0};
+    network_sort(d.begin(), d.end());
+    REQUIRE(std::is_sorted(d.begin(), d.end()));
+    REQUIRE(d.back() == std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("Test network_sort_each") {
+    std::mt19937_64 rng(5);
+    std::vector<std::vector<int64_t>> lists(5000);
+    for (auto& l : lists) {
+        l.resize(rng() % 100);
+        for (auto& x : l) {
+            x = int64_t(rng());
+        }
+    }
+    auto want = lists;
+    for (auto& l : want) {
+        std::sort(l.begin(), l.end());
+    }
+    network_sort_each(lists, 4);
+    REQUIRE(lists == want);
+}
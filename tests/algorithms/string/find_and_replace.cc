@@ -1,6 +1,9 @@
 #include "../../../src/algorithms/string/find_and_replace.h"
 #include "../../../third_party/catch.hpp"
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 TEST_CASE("testing find_and_replace") {
     std::string str = "abcllllabc";
@@ -24,4 +27,47 @@ TEST_CASE("testing removing substring for find_and_replace_regex") {
     std::string str = "abcbca";
     find_and_replace_regex(str, "(a.*?b.*?c)", "");
     REQUIRE(str == "bca");
-}
\ No newline at end of file
+}
+TEST_CASE("testing replace_all") {
+    REQUIRE(replace_all("abcllllabc", "abc", "xy") == "xyllllxy");
+    REQUIRE(replace_all("aaaa", "aa", "b") == "bb");
+    REQUIRE(replace_all("aaa", "aa", "b") == "ba");
+    REQUIRE(replace_all("abc", "", "x") == "abc");
+    REQUIRE(replace_all("", "a", "x") == "");
+    std::string big;
+    for (int i = 0; i < 10000; i++) {
+        big += "{x}.";
+    }
+    std::string out = replace_all(big, "{x}", "value");
+    REQUIRE(out.size() == 10000 * 6);
+    REQUIRE(out.substr(0, 12) == "value.value.");
+
+    std::string streamed;
+    replace_all("a-b-c", "-", "+", [&](std::string_view piece) { streamed += piece; });
+    REQUIRE(streamed == "a+b+c");
+
+    std::string str = "aaa";
+    find_and_replace(str, "a", "aa");
+    REQUIRE(str == "aaaaaa");
+}
+
+TEST_CASE("testing string_replacer") {
+    std::map<std::string, std::string> m = {
+        {"{name}", "world"}, {"{n}", "N"}, {"he", "HE"}, {"hers", "HERS"}, {"she", "SHE"}};
+    string_replacer r(m);
+    REQUIRE(r.replace("hello {name}, {n}!") == "HEllo world, N!");
+    // leftmost first, then longest
+    REQUIRE(r.replace("ushers") == "uSHErs");
+    REQUIRE(r.replace("hers") == "HERS");
+    REQUIRE(r.replace("") == "");
+    REQUIRE(replace_all("abc", std::vector<std::pair<std::string, std::string>>{
+                                   {"ab", "1"}, {"c", "2"}, {"xxxxxxx", "3"}}) == "12");
+    REQUIRE(replace_all("abcd", std::vector<std::pair<std::string, std::string>>{
+                                    {"bcd", "1"}, {"abc", "2"}}) == "2d");
+
+    std::string streamed;
+    r.replace("she said {name}", [&](std::string_view piece) { streamed += piece; });
+    REQUIRE(streamed == "SHE said world");
+    REQUIRE_THROWS_AS(string_replacer(std::map<std::string, std::string>{{"", "x"}}),
+                      std::invalid_argument);
+}
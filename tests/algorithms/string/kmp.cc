@@ -1,9 +1,67 @@
 #include "../../../src/algorithms/string/kmp.h"
 #include "../../../third_party/catch.hpp"
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 TEST_CASE("testing kmp") {
     std::string a = "ababcabcababababd", b = "ababd";
     REQUIRE(kmp(b, a) == true);
     REQUIRE(kmp("elo", a) == false);
-}
\ No newline at end of file
+}
+static std::vector<size_t> naive_find_all(const std::string& text, const std::string& pattern) {
+    std::vector<size_t> v;
+    for (size_t i = 0; i + pattern.size() <= text.size(); i++) {
+        if (text.compare(i, pattern.size(), pattern) == 0) {
+            v.push_back(i);
+        }
+    }
+    return v;
+}
+
+TEST_CASE("testing kmp_matcher") {
+    kmp_matcher m("aba");
+    REQUIRE(m.find_all("abababa") == std::vector<size_t>{0, 2, 4});
+    REQUIRE(m.find("xxabababa") == 2);
+    REQUIRE(m.find("xxabababa", 3) == 4);
+    REQUIRE(m.find("xxabababa", 7) == kmp_matcher::npos);
+    REQUIRE(m.contains("cabac"));
+    REQUIRE(!m.contains("abba"));
+    REQUIRE(kmp_matcher("").find_all("ab") == std::vector<size_t>{0, 1, 2});
+
+    std::mt19937 rng(79);
+    for (std::string pattern : {"a", "aa", "abab", "aabaa", "abcab", "bbbbbb"}) {
+        std::string text(5000, 'a');
+        for (char& c : text) {
+            c = char('a' + rng() % 3);
+        }
+        REQUIRE(kmp_matcher(pattern).find_all(text) == naive_find_all(text, pattern));
+    }
+}
+
+TEST_CASE("testing kmp_stream") {
+    std::mt19937 rng(80);
+    std::string text(20000, 'a');
+    for (char& c : text) {
+        c = char('a' + rng() % 2);
+    }
+    for (std::string pattern : {"a", "abba", "aaaaaa", "abaababa"}) {
+        kmp_matcher m(pattern);
+        kmp_stream s(m);
+        std::vector<size_t> found;
+        for (size_t pos = 0; pos < text.size();) {
+            size_t len = std::min<size_t>(rng() % 10, text.size() - pos);
+            std::vector<size_t> part = s.feed(std::string_view(text).substr(pos, len));
+            found.insert(found.end(), part.begin(), part.end());
+            pos += len;
+        }
+        REQUIRE(s.offset() == text.size());
+        REQUIRE(found == naive_find_all(text, pattern));
+        s.reset();
+        REQUIRE(s.feed(pattern) == std::vector<size_t>{0});
+    }
+    kmp_matcher empty("");
+    REQUIRE_THROWS_AS(kmp_stream(empty), std::invalid_argument);
+}
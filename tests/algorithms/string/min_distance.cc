@@ -1,7 +1,36 @@
 #include "../../../third_party/catch.hpp"
+#include <random>
 #include <string>
+#include <vector>
 #include "../../../src/algorithms/string/edit_distance.h"
 
+namespace {
+size_t dp_distance(const std::string& a, const std::string& b) {
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        size_t diag = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            size_t up = row[j];
+            row[j] = std::min({up + 1, row[j - 1] + 1, diag + (a[i - 1] != b[j - 1])});
+            diag = up;
+        }
+    }
+    return row[b.size()];
+}
+
+std::string random_string(size_t n, size_t alphabet, std::mt19937& rng) {
+    std::string s(n, 'a');
+    for (char& c : s) {
+        c = char('a' + rng() % alphabet);
+    }
+    return s;
+}
+} // namespace
+
 TEST_CASE("testing min distance function") {
     std::string a = "hello", b = "world";
     REQUIRE(min_dist(a, b) == 4);
@@ -12,4 +41,52 @@ TEST_CASE("testing min distance function") {
     a = "HellOThere";
     b = "hellothere";
     REQUIRE(min_dist(a, b) == 3);
+    REQUIRE(min_dist("", "abc") == 3);
+    REQUIRE(min_dist("abc", "") == 3);
+    REQUIRE(min_dist("", "") == 0);
+}
+
+TEST_CASE("testing myers distance against the dp") {
+    std::mt19937 rng(83);
+    for (size_t m : {1, 5, 63, 64, 65, 130, 300}) {
+        std::string p_query = random_string(m, 4, rng);
+        myers_pattern p(p_query);
+        for (size_t rep = 0; rep < 30; rep++) {
+            // close candidates: a few edits of the query, and random ones
+            std::string q = random_string(m, 4, rng);
+            std::string t = rep % 2 ? random_string(m + rng() % 20, 4, rng) : q;
+            if (rep % 2 == 0) {
+                for (size_t e = rng() % 6; e > 0; e--) {
+                    t[rng() % t.size()] = char('a' + rng() % 4);
+                }
+                t.insert(rng() % t.size(), 1, 'b');
+            }
+            myers_pattern pq(q);
+            size_t d = dp_distance(q, t);
+            REQUIRE(pq.distance(t) == d);
+            for (size_t k : {size_t(0), size_t(1), size_t(3), size_t(10), d, d + 1}) {
+                REQUIRE(pq.distance(t, k) == (d <= k ? d : k + 1));
+            }
+            REQUIRE(p.distance(t) == dp_distance(p_query, t));
+        }
+    }
+}
+
+TEST_CASE("testing batch edit distances") {
+    std::mt19937 rng(84);
+    std::string query = random_string(40, 3, rng);
+    std::vector<std::string> candidates;
+    for (size_t i = 0; i < 500; i++) {
+        candidates.push_back(random_string(rng() % 60, 3, rng));
+    }
+    candidates.push_back(query);
+    for (size_t threads : {1, 3}) {
+        std::vector<size_t> got = edit_distances(query, candidates, 20, threads);
+        REQUIRE(got.back() == 0);
+        for (size_t i = 0; i < candidates.size(); i++) {
+            size_t d = dp_distance(query, candidates[i]);
+            REQUIRE(got[i] == (d <= 20 ? d : 21));
+        }
+    }
+    REQUIRE(edit_distances(query, candidates)[7] == dp_distance(query, candidates[7]));
 }
@@ -1,6 +1,9 @@
 #include "../../../src/algorithms/string/palindrome.h"
 #include "../../../third_party/catch.hpp"
+#include <random>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 TEST_CASE("Testing palindrome function") {
@@ -10,3 +13,79 @@ TEST_CASE("Testing palindrome function") {
     REQUIRE(is_palindrome("csrt") == false);
     REQUIRE(is_palindrome("w") == true);
 }
+
+TEST_CASE("Testing manacher") {
+    std::string s = "abacabadabacaba";
+    manacher m(s);
+    REQUIRE(m.size() == s.size());
+    REQUIRE(m.odd_radius(7) == 8);
+    REQUIRE(m.longest() == std::pair<size_t, size_t>{0, 15});
+    REQUIRE(longest_palindrome("forgeeksskeegfor") == "geeksskeeg");
+    REQUIRE(longest_palindrome("abcd") == "a");
+    REQUIRE(longest_palindrome("") == "");
+    REQUIRE(count_palindromes("aaa") == 6);
+    REQUIRE(count_palindromes("abc") == 3);
+
+    std::mt19937 rng(87);
+    for (size_t rep = 0; rep < 30; rep++) {
+        std::string t(rng() % 60, 'a');
+        for (char& c : t) {
+            c = char('a' + rng() % 3);
+        }
+        manacher mt(t);
+        uint64_t count = 0;
+        size_t best = 0;
+        for (size_t l = 0; l <= t.size(); l++) {
+            for (size_t r = l; r <= t.size(); r++) {
+                bool p = is_palindrome(std::string_view(t).substr(l, r - l));
+                REQUIRE(mt.is_palindrome(l, r) == p);
+                if (p && r > l) {
+                    count++;
+                    best = std::max(best, r - l);
+                }
+            }
+        }
+        REQUIRE(mt.count() == count);
+        REQUIRE(mt.longest().second == best);
+    }
+}
+
+TEST_CASE("Testing eertree") {
+    eertree t("eertree");
+    // e, r, t, ee, rtr, ertre, eertree
+    REQUIRE(t.size() == 7);
+    std::vector<std::pair<size_t, size_t>> d = t.distinct();
+    REQUIRE(d[0] == std::pair<size_t, size_t>{0, 1});
+    REQUIRE(d[1] == std::pair<size_t, size_t>{0, 2});
+    REQUIRE(d.back() == std::pair<size_t, size_t>{0, 7});
+    std::vector<uint64_t> occ = t.occurrences();
+    REQUIRE(occ[0] == 4); // e
+    REQUIRE(occ[1] == 2); // ee
+
+    std::mt19937 rng(88);
+    for (size_t rep = 0; rep < 30; rep++) {
+        std::string s(rng() % 80, 'a');
+        for (char& c : s) {
+            c = char('a' + rng() % 3);
+        }
+        eertree e;
+        for (char c : s) {
+            e.push_back(c);
+        }
+        std::set<std::string> distinct;
+        for (size_t l = 0; l < s.size(); l++) {
+            for (size_t r = l + 1; r <= s.size(); r++) {
+                if (is_palindrome(std::string_view(s).substr(l, r - l))) {
+                    distinct.insert(s.substr(l, r - l));
+                }
+            }
+        }
+        REQUIRE(e.size() == distinct.size());
+        std::vector<uint64_t> counts = e.occurrences();
+        uint64_t total = 0;
+        for (uint64_t c : counts) {
+            total += c;
+        }
+        REQUIRE(total == count_palindromes(s));
+    }
+}
@@ -1,5 +1,7 @@
 #include "../../../src/algorithms/string/rabin_karp.h"
 #include "../../../third_party/catch.hpp"
+#include <random>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -97,3 +99,51 @@ TEST_CASE("Testing Rabin Karp with multiple occurrences of duplicate characters"
     REQUIRE(result[4] == 10);
     REQUIRE(result[5] == 11);
 }
+
+TEST_CASE("Testing rolling_hash") {
+    rolling_hash h(5, 42);
+    std::string text = "the quick brown fox jumps over the lazy dog, the quick one";
+    std::vector<uint64_t> hashes = h.window_hashes(text);
+    REQUIRE(hashes.size() == text.size() - 4);
+    for (size_t i = 0; i < hashes.size(); i++) {
+        REQUIRE(hashes[i] == h.hash(text.substr(i, 5)));
+    }
+    REQUIRE(hashes[0] == hashes[45]);
+    REQUIRE(rolling_hash(5, 43).hash("abcde") != h.hash("abcde"));
+    REQUIRE(h.window_hashes("abcd").empty());
+    REQUIRE(rolling_hash(1).window_hashes("ab").size() == 2);
+    REQUIRE_THROWS_AS(rolling_hash(0), std::invalid_argument);
+}
+
+TEST_CASE("Testing rabin_karp_set") {
+    std::mt19937 rng(81);
+    std::string text(20000, 'a');
+    for (char& c : text) {
+        c = char('a' + rng() % 3);
+    }
+    std::vector<std::string> patterns;
+    for (size_t i = 0; i < 200; i++) {
+        size_t at = rng() % (text.size() - 6);
+        patterns.push_back(i % 2 ? text.substr(at, 6) : std::string("zzzzz") + char('a' + i));
+    }
+    patterns.push_back(patterns[1]);
+    rabin_karp_set set(patterns, 7);
+    REQUIRE(set.size() == patterns.size());
+    REQUIRE(set.window() == 6);
+
+    std::vector<rabin_karp_match> want;
+    for (size_t i = 0; i + 6 <= text.size(); i++) {
+        for (size_t id = 0; id < patterns.size(); id++) {
+            if (text.compare(i, 6, patterns[id]) == 0) {
+                want.push_back({id, i});
+            }
+        }
+    }
+    REQUIRE(set.find_all(text) == want);
+    REQUIRE(set.find_all(text, set.hasher().window_hashes(text)) == want);
+    REQUIRE(set.find(patterns[3]) == 3);
+    REQUIRE(set.find("zzzzzz") == -1);
+    REQUIRE(set.find("short") == -1);
+    REQUIRE_THROWS_AS(rabin_karp_set({"abc", "ab"}), std::invalid_argument);
+    REQUIRE_THROWS_AS(rabin_karp_set({}), std::invalid_argument);
+}
@@ -1,5 +1,6 @@
 #include "../../../src/algorithms/string/string_hashing.h"
 #include "../../../third_party/catch.hpp"
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -27,3 +28,48 @@ TEST_CASE("Testing string hasher size function") {
 
     REQUIRE(hash.size() == 6);
 }
+
+TEST_CASE("Testing prefix hash") {
+    std::string s = "abracadabra";
+    prefix_hash p(s, 7);
+    REQUIRE(p.size() == s.size());
+    REQUIRE(p.hash() == rolling_hash(s.size(), 7).hash(s));
+    for (size_t l = 0; l <= s.size(); l++) {
+        for (size_t r = l; r <= s.size(); r++) {
+            REQUIRE(p.substring_hash(l, r) == rolling_hash(1, 7).hash(s.substr(l, r - l)));
+        }
+    }
+    REQUIRE(p.equal(0, 7, 4));
+    REQUIRE(!p.equal(0, 1, 4));
+    REQUIRE(p.common_prefix(0, 7) == 4);
+    REQUIRE(p.common_prefix(3, 5) == 1);
+    REQUIRE(p.common_prefix(1, 2) == 0);
+    REQUIRE(prefix_hash("").hash() == 0);
+}
+
+TEST_CASE("Testing prefix hash set") {
+    std::vector<std::string> v = {"hello world", "", "say hello", "world"};
+    for (size_t threads : {1, 3}) {
+        prefix_hash_set hs(v, 3, threads);
+        REQUIRE(hs.count() == 4);
+        REQUIRE(hs.size(1) == 0);
+        REQUIRE(hs.size(2) == 9);
+        REQUIRE(hs.hash(3) == prefix_hash("world", 3).hash());
+        REQUIRE(hs.substring_hash(0, 0, 5) == hs.substring_hash(2, 4, 9));
+        REQUIRE(hs.substring_hash(0, 6, 11) == hs.hash(3));
+        REQUIRE(hs.substring_hash(0, 0, 5) != hs.substring_hash(3, 0, 5));
+    }
+}
+
+TEST_CASE("Testing unique strings") {
+    std::vector<std::string> v = {"b", "a", "b", "", "c", "a", "", "b"};
+    REQUIRE(unique_strings(v) == std::vector<size_t>{0, 1, 3, 4});
+    std::vector<std::string> many;
+    for (size_t i = 0; i < 20000; i++) {
+        many.push_back(std::to_string(i % 1234));
+    }
+    std::vector<size_t> expected(1234);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(unique_strings(many, 0, 4) == expected);
+    REQUIRE(unique_strings(std::vector<std::string>{}).empty());
+}
@@ -0,0 +1,64 @@
+#include "../../../src/algorithms/string/substring_search.h"
+#include "../../../third_party/catch.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<size_t> naive_all(const std::string& text, const std::string& pattern) {
+    std::vector<size_t> at;
+    for (size_t i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1)) {
+        at.push_back(i);
+    }
+    return at;
+}
+} // namespace
+
+TEST_CASE("testing substring_searcher") {
+    substring_searcher s("needle");
+    REQUIRE(s.find("haystack with a needle and another needle") == 16);
+    REQUIRE(s.find("haystack with a needle and another needle", 17) == 35);
+    REQUIRE(s.find("no match") == substring_searcher::npos);
+    REQUIRE(s.contains("needle"));
+    REQUIRE(!s.contains("needl"));
+    REQUIRE(substring_find_all("aaaaa", "aa") == std::vector<size_t>{0, 1, 2, 3});
+    REQUIRE(substring_find_all("abc", "") == std::vector<size_t>{0, 1, 2, 3});
+    REQUIRE(substring_find("abc", "c") == 2);
+    REQUIRE(substring_find("abc", "abcd") == substring_searcher::npos);
+    REQUIRE(substring_find("abc", "a", 4) == substring_searcher::npos);
+}
+
+TEST_CASE("testing substring_searcher against std::string::find") {
+    std::mt19937 rng(88);
+    for (size_t rep = 0; rep < 400; rep++) {
+        size_t alphabet = 1 + rep % 4;
+        std::string text(rng() % 3000, 'a'), pattern(1 + rng() % 12, 'a');
+        for (char& c : text) {
+            c = char('a' + rng() % alphabet);
+        }
+        for (char& c : pattern) {
+            c = char('a' + rng() % alphabet);
+        }
+        if (rep % 3 == 0 && text.size() > pattern.size()) {
+            text.replace(rng() % (text.size() - pattern.size()), pattern.size(), pattern);
+        }
+        REQUIRE(substring_find_all(text, pattern) == naive_all(text, pattern));
+        size_t pos = text.empty() ? 0 : rng() % text.size();
+        REQUIRE(substring_find(text, pattern, pos) == text.find(pattern, pos));
+    }
+}
+
+TEST_CASE("testing substring_searcher on inputs that defeat the filter") {
+    // every position passes the first and last byte filter, Two-Way takes over
+    std::string text(200000, 'a');
+    text[150000] = 'b';
+    std::string pattern = std::string(40, 'a') + "b" + std::string(40, 'a');
+    REQUIRE(substring_find_all(text, pattern) == std::vector<size_t>{149960});
+    std::string periodic = "ab" + std::string(30, 'a') + "b";
+    std::string t2;
+    for (size_t i = 0; i < 20000; i++) {
+        t2 += i % 7 == 0 ? periodic : "a";
+    }
+    REQUIRE(substring_find_all(t2, periodic) == naive_all(t2, periodic));
+    REQUIRE(substring_find_all(std::string(100000, 'a'), std::string(50, 'a')).size() == 99951);
+}
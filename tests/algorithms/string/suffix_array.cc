@@ -0,0 +1,74 @@
+#include "../../../src/algorithms/string/suffix_array.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<int32_t> naive_sa(const std::string& s) {
+    std::vector<int32_t> sa(s.size());
+    std::iota(sa.begin(), sa.end(), 0);
+    std::sort(sa.begin(), sa.end(),
+              [&](int32_t a, int32_t b) { return s.compare(a, s.npos, s, b, s.npos) < 0; });
+    return sa;
+}
+
+size_t naive_lce(const std::string& s, size_t i, size_t j) {
+    size_t l = 0;
+    while (i + l < s.size() && j + l < s.size() && s[i + l] == s[j + l]) {
+        l++;
+    }
+    return l;
+}
+} // namespace
+
+TEST_CASE("testing suffix array on banana") {
+    suffix_array sa("banana");
+    std::vector<int32_t> want = {5, 3, 1, 0, 4, 2};
+    REQUIRE(std::vector<int32_t>(sa.sa().begin(), sa.sa().end()) == want);
+    std::vector<int32_t> lcp = {0, 1, 3, 0, 0, 2};
+    REQUIRE(std::vector<int32_t>(sa.lcp().begin(), sa.lcp().end()) == lcp);
+    REQUIRE(sa.count("ana") == 2);
+    REQUIRE(sa.locate("ana") == std::vector<size_t>{1, 3});
+    REQUIRE(sa.locate("a") == std::vector<size_t>{1, 3, 5});
+    REQUIRE(sa.count("nab") == 0);
+    REQUIRE(!sa.contains("bananas"));
+    REQUIRE(sa.count("") == 6);
+    REQUIRE(sa.lce(1, 3) == 3);
+    REQUIRE(sa.lce(2, 2) == 4);
+    REQUIRE(suffix_array("").size() == 0);
+    REQUIRE(suffix_array("").count("a") == 0);
+}
+
+TEST_CASE("testing suffix array against naive construction") {
+    std::mt19937 rng(82);
+    for (size_t alphabet : {1, 2, 4, 256}) {
+        for (size_t n : {1, 2, 3, 17, 500, 3000}) {
+            std::string s(n, 'a');
+            for (char& c : s) {
+                c = char('a' + rng() % alphabet);
+            }
+            suffix_array sa(s, 3);
+            std::vector<int32_t> want = naive_sa(s);
+            REQUIRE(std::vector<int32_t>(sa.sa().begin(), sa.sa().end()) == want);
+            for (size_t r = 1; r < n; r++) {
+                REQUIRE(size_t(sa.lcp()[r]) == naive_lce(s, want[r - 1], want[r]));
+            }
+            for (size_t q = 0; q < 50; q++) {
+                size_t i = rng() % n, j = rng() % n;
+                REQUIRE(sa.lce(i, j) == naive_lce(s, i, j));
+                std::string p = s.substr(i, 1 + rng() % 4);
+                std::vector<size_t> at;
+                for (size_t k = 0; k + p.size() <= n; k++) {
+                    if (s.compare(k, p.size(), p) == 0) {
+                        at.push_back(k);
+                    }
+                }
+                REQUIRE(sa.locate(p) == at);
+                REQUIRE(sa.count(p) == at.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,217 @@
+#include "../../src/classes/cache/cache.h"
+#include "../../third_party/catch.hpp"
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("Testing get() and put() lru_cache") {
+    lru_cache<int, std::string> c(2);
+
+    REQUIRE(c.empty() == true);
+    REQUIRE(c.put(1, "one") == true);
+    REQUIRE(c.put(2, "two") == true);
+    REQUIRE(c.get(1) == "one");
+    REQUIRE(c.get(3) == std::nullopt);
+    c.put(3, "three");
+    REQUIRE(c.contains(2) == false);
+    REQUIRE(c.contains(1) == true);
+    REQUIRE(c.keys() == std::vector<int>{3, 1});
+
+    cache_stats s = c.stats();
+    REQUIRE(s.hits == 1);
+    REQUIRE(s.misses == 1);
+    REQUIRE(s.evictions == 1);
+    REQUIRE(s.size == 2);
+}
+
+TEST_CASE("Testing put() of an existing key lru_cache") {
+    lru_cache<int, int> c(2);
+
+    c.put(1, 10);
+    c.put(2, 20);
+    c.put(1, 11);
+    c.put(3, 30);
+    REQUIRE(c.size() == 2);
+    REQUIRE(*c.find(1) == 11);
+    REQUIRE(c.contains(2) == false);
+}
+
+TEST_CASE("Testing erase() and clear() lru_cache") {
+    lru_cache<int, int> c(4);
+
+    for (int i = 0; i < 4; i++) {
+        c.put(i, i);
+    }
+    REQUIRE(c.erase(2) == true);
+    REQUIRE(c.erase(2) == false);
+    REQUIRE(c.keys() == std::vector<int>{3, 1, 0});
+    c.clear();
+    REQUIRE(c.empty() == true);
+    REQUIRE(c.get(1) == std::nullopt);
+    c.put(5, 5);
+    REQUIRE(c.keys() == std::vector<int>{5});
+}
+
+TEST_CASE("Testing the byte limit of lru_cache") {
+    lru_cache<int, std::string> c(cache_limits{SIZE_MAX, 3 * 100});
+    size_t overhead = sizeof(int) + sizeof(std::string);
+
+    c.put(1, std::string(100 - overhead, 'a'));
+    c.put(2, std::string(100 - overhead, 'b'));
+    c.put(3, std::string(100 - overhead, 'c'));
+    REQUIRE(c.bytes() == 300);
+    c.put(4, std::string(150 - overhead, 'd'));
+    REQUIRE(c.keys() == std::vector<int>{4, 3});
+    REQUIRE(c.bytes() == 250);
+
+    // an entry heavier than the limit is not stored and does not evict anything
+    REQUIRE(c.put(5, std::string(400, 'e')) == false);
+    REQUIRE(c.contains(5) == false);
+    REQUIRE(c.size() == 2);
+    // and replacing a key with one removes it
+    REQUIRE(c.put(3, std::string(400, 'e')) == false);
+    REQUIRE(c.keys() == std::vector<int>{4});
+}
+
+TEST_CASE("Testing move of lru_cache") {
+    lru_cache<int, int> c(3);
+    c.put(1, 1);
+    c.put(2, 2);
+
+    lru_cache<int, int> d(std::move(c));
+    REQUIRE(c.empty() == true);
+    REQUIRE(d.keys() == std::vector<int>{2, 1});
+    c = std::move(d);
+    REQUIRE(d.empty() == true);
+    REQUIRE(c.get(1) == 1);
+    c.put(3, 3);
+    c.put(4, 4);
+    REQUIRE(c.keys() == std::vector<int>{4, 3, 1});
+}
+
+TEST_CASE("Testing eviction of lfu_cache") {
+    lfu_cache<int, int> c(3);
+
+    c.put(1, 1);
+    c.put(2, 2);
+    c.put(3, 3);
+    c.get(1);
+    c.get(1);
+    c.get(2);
+    c.put(4, 4);
+    REQUIRE(c.contains(3) == false);
+    REQUIRE(c.keys() == std::vector<int>{1, 2, 4});
+
+    // ties go to the least recent
+    c.get(4);
+    c.put(5, 5);
+    REQUIRE(c.contains(2) == false);
+}
+
+TEST_CASE("Testing aging of lfu_cache") {
+    lfu_cache<int, int> c(2);
+
+    c.put(1, 1);
+    for (int i = 0; i < 3; i++) {
+        c.get(1);
+    }
+    // priority of 1 is 4, every new key starts above the last evicted one
+    for (int k = 2; k < 8; k++) {
+        c.put(k, k);
+        c.get(k);
+    }
+    REQUIRE(c.contains(1) == false);
+    REQUIRE(c.contains(7) == true);
+}
+
+TEST_CASE("Testing lru_cache against a reference") {
+    const size_t cap = 50;
+    lru_cache<int, int> c(cap);
+    std::list<std::pair<int, int>> order;
+    std::unordered_map<int, std::list<std::pair<int, int>>::iterator> index;
+    std::mt19937 rng(7);
+
+    for (int i = 0; i < 20000; i++) {
+        int key = int(rng() % 120);
+        if (rng() % 3 == 0) {
+            auto it = index.find(key);
+            std::optional<int> got = c.get(key);
+            if (it == index.end()) {
+                REQUIRE(got == std::nullopt);
+            } else {
+                REQUIRE(got == it->second->second);
+                order.splice(order.begin(), order, it->second);
+            }
+        } else if (rng() % 10 == 0) {
+            auto it = index.find(key);
+            REQUIRE(c.erase(key) == (it != index.end()));
+            if (it != index.end()) {
+                order.erase(it->second);
+                index.erase(it);
+            }
+        } else {
+            auto it = index.find(key);
+            if (it != index.end()) {
+                it->second->second = i;
+                order.splice(order.begin(), order, it->second);
+            } else {
+                order.emplace_front(key, i);
+                index[key] = order.begin();
+                if (order.size() > cap) {
+                    index.erase(order.back().first);
+                    order.pop_back();
+                }
+            }
+            c.put(key, i);
+        }
+        REQUIRE(c.size() == order.size());
+    }
+    std::vector<int> keys;
+    for (auto& [k, v] : order) {
+        keys.push_back(k);
+    }
+    REQUIRE(c.keys() == keys);
+}
+
+TEST_CASE("Testing lfu_cache against a reference") {
+    const size_t cap = 40;
+    lfu_cache<int, int> c(cap);
+    // key -> {priority, last use}
+    std::unordered_map<int, std::pair<int64_t, int>> ref;
+    int64_t age = 0;
+    std::mt19937 rng(11);
+
+    for (int i = 0; i < 20000; i++) {
+        int key = int(rng() % 100);
+        auto it = ref.find(key);
+        if (rng() % 2 == 0) {
+            REQUIRE(c.get(key).has_value() == (it != ref.end()));
+            if (it != ref.end()) {
+                it->second = {it->second.first + 1, i};
+            }
+            continue;
+        }
+        if (it != ref.end()) {
+            it->second = {it->second.first + 1, i};
+        } else {
+            if (ref.size() == cap) {
+                auto victim = ref.begin();
+                for (auto j = ref.begin(); j != ref.end(); j++) {
+                    if (j->second < victim->second) {
+                        victim = j;
+                    }
+                }
+                age = victim->second.first;
+                ref.erase(victim);
+            }
+            ref[key] = {age + 1, i};
+        }
+        c.put(key, i);
+        REQUIRE(c.size() == ref.size());
+    }
+    for (auto& [k, v] : ref) {
+        REQUIRE(c.contains(k) == true);
+    }
+}
@@ -0,0 +1,65 @@
+#include "../../src/classes/cache/sharded_cache.h"
+#include "../../third_party/catch.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Testing get() and put() sharded_cache") {
+    sharded_cache<lru_cache<int, std::string>> c(cache_limits{64, SIZE_MAX}, 4);
+
+    REQUIRE(c.shards() == 4);
+    REQUIRE(c.put(1, "one") == true);
+    REQUIRE(c.get(1) == "one");
+    REQUIRE(c.get(2) == std::nullopt);
+    REQUIRE(c.contains(1) == true);
+    REQUIRE(c.erase(1) == true);
+    REQUIRE(c.contains(1) == false);
+
+    cache_stats s = c.stats();
+    REQUIRE(s.hits == 1);
+    REQUIRE(s.misses == 1);
+    REQUIRE(s.size == 0);
+}
+
+TEST_CASE("Testing the limits of sharded_cache") {
+    sharded_cache<lfu_cache<int, int>> c(cache_limits{64, SIZE_MAX}, 8);
+
+    for (int i = 0; i < 1000; i++) {
+        c.put(i, i);
+    }
+    REQUIRE(c.size() <= 64);
+    for (size_t i = 0; i < c.shards(); i++) {
+        REQUIRE(c.stats(i).size <= 8);
+    }
+    c.clear();
+    REQUIRE(c.size() == 0);
+    REQUIRE_THROWS_AS((sharded_cache<lru_cache<int, int>>({}, 0)), std::invalid_argument);
+}
+
+TEST_CASE("Testing sharded_cache with many threads") {
+    sharded_cache<lru_cache<int, int>> c(cache_limits{256, SIZE_MAX}, 8);
+    const int threads = 4, ops = 20000;
+    std::atomic<size_t> wrong{0};
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            for (int i = 0; i < ops; i++) {
+                int key = (i * 7 + t * 13) % 512;
+                if (i % 3 == 0) {
+                    c.put(key, key * 2);
+                } else if (std::optional<int> v = c.get(key); v && *v != key * 2) {
+                    wrong++;
+                }
+            }
+        });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    REQUIRE(wrong == 0);
+    cache_stats s = c.stats();
+    REQUIRE(s.hits + s.misses == size_t(threads) * (ops - (ops + 2) / 3));
+    REQUIRE(s.size <= 256);
+}
@@ -0,0 +1,59 @@
+#include "../../src/classes/disjoint_set/concurrent_disjoint_set.h"
+#include "../../src/classes/disjoint_set/disjoint_set.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST_CASE("testing concurrent dsu basics") {
+    concurrent_dsu d(6);
+    REQUIRE(d.size() == 6);
+    REQUIRE(d.sets() == 6);
+    REQUIRE(d.join(4, 2));
+    REQUIRE(d.join(2, 5));
+    REQUIRE(!d.join(5, 4));
+    REQUIRE(d.same(4, 5));
+    REQUIRE(!d.same(0, 5));
+    // the root of a set is its smallest element
+    REQUIRE(d.find(5) == 2);
+    REQUIRE(d.find(1) == 1);
+    REQUIRE(d.sets() == 4);
+}
+
+TEST_CASE("testing concurrent dsu against dsu with many threads") {
+    const uint32_t n = 20000;
+    std::mt19937 rng(35);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(30000);
+    for (auto& [a, b] : pairs) {
+        a = rng() % n, b = rng() % n;
+    }
+    dsu expected(n);
+    for (auto [a, b] : pairs) {
+        expected.join(a, b);
+    }
+
+    concurrent_dsu d(n);
+    const size_t threads = 4;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = t; i < pairs.size(); i += threads) {
+                d.join(pairs[i].first, pairs[i].second);
+                d.same(pairs[i].first, pairs[(i * 7) % pairs.size()].second);
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    uint32_t roots = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        roots += expected.find(v) == v;
+        REQUIRE(d.find(v) == expected.get_min(v));
+    }
+    REQUIRE(d.sets() == roots);
+    for (int i = 0; i < 5000; i++) {
+        uint32_t a = rng() % n, b = rng() % n;
+        REQUIRE(d.same(a, b) == expected.same(a, b));
+    }
+}
@@ -0,0 +1,122 @@
+#include "../../src/classes/disjoint_set/disjoint_set.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("testing compact dsu against dsu") {
+    const uint32_t n = 5000;
+    std::mt19937 rng(36);
+    dsu expected(n);
+    compact_dsu<true> bounded(n);
+    compact_dsu<> plain(n);
+    REQUIRE(sizeof(plain) <= sizeof(bounded));
+    for (int i = 0; i < 4000; i++) {
+        uint32_t a = rng() % n, b = rng() % n;
+        bool joined = !expected.same(a, b);
+        expected.join(a, b);
+        REQUIRE(bounded.join(a, b) == joined);
+        REQUIRE(plain.join(a, b) == joined);
+    }
+    uint32_t roots = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        roots += expected.find(v) == v;
+        REQUIRE(bounded.size(v) == expected.size(v));
+        REQUIRE(bounded.get_min(v) == expected.get_min(v));
+        REQUIRE(bounded.get_max(v) == expected.get_max(v));
+        REQUIRE(plain.size(v) == expected.size(v));
+    }
+    REQUIRE(plain.sets() == roots);
+    for (int i = 0; i < 5000; i++) {
+        uint32_t a = rng() % n, b = rng() % n;
+        REQUIRE(plain.same(a, b) == expected.same(a, b));
+    }
+}
+
+TEST_CASE("testing rollback dsu") {
+    rollback_dsu d(8);
+    d.join(0, 1);
+    d.join(2, 3);
+    size_t before = d.snapshot();
+    REQUIRE(d.sets() == 6);
+    d.join(1, 3);
+    d.join(4, 5);
+    REQUIRE(!d.join(0, 2));
+    d.join(5, 0);
+    REQUIRE(d.size(4) == 6);
+    REQUIRE(d.same(4, 3));
+    REQUIRE(d.sets() == 3);
+    REQUIRE(d.undo());
+    REQUIRE(!d.same(4, 3));
+    REQUIRE(d.size(4) == 2);
+    d.rollback(before);
+    REQUIRE(d.snapshot() == before);
+    REQUIRE(d.sets() == 6);
+    REQUIRE(!d.same(1, 3));
+    REQUIRE(d.same(0, 1));
+    REQUIRE(d.size(0) == 2);
+    REQUIRE(d.size(3) == 2);
+    d.rollback(0);
+    REQUIRE(d.sets() == 8);
+    REQUIRE(!d.undo());
+}
+
+TEST_CASE("testing rollback dsu against rebuilding") {
+    const uint32_t n = 300;
+    std::mt19937 rng(37);
+    rollback_dsu d(n);
+    std::vector<std::pair<uint32_t, uint32_t>> applied;
+    std::vector<size_t> marks;
+    for (int step = 0; step < 2000; step++) {
+        if (rng() % 4 == 0 && !marks.empty()) {
+            d.rollback(marks.back());
+            applied.resize(marks.back());
+            marks.pop_back();
+            continue;
+        }
+        if (rng() % 10 == 0) {
+            marks.push_back(d.snapshot());
+        }
+        uint32_t a = rng() % n, b = rng() % n;
+        if (d.join(a, b)) {
+            applied.push_back({a, b});
+        }
+        REQUIRE(d.snapshot() == applied.size());
+    }
+    compact_dsu<> fresh(n);
+    for (auto [a, b] : applied) {
+        fresh.join(a, b);
+    }
+    REQUIRE(d.sets() == fresh.sets());
+    for (uint32_t v = 0; v < n; v++) {
+        REQUIRE(d.size(v) == fresh.size(v));
+        REQUIRE(d.same(v, (v * 17) % n) == fresh.same(v, (v * 17) % n));
+    }
+}
+
+TEST_CASE("testing dsu member enumeration") {
+    const int64_t n = 2000;
+    std::mt19937 rng(37);
+    dsu d(n);
+    for (int i = 0; i < 1500; i++) {
+        d.join(rng() % n, rng() % n);
+    }
+    for (int k = 0; k < 200; k++) {
+        int64_t v = rng() % n;
+        std::vector<int64_t> members = d.members(v);
+        REQUIRE(members.front() == v);
+        REQUIRE(int64_t(members.size()) == d.size(v));
+        std::sort(members.begin(), members.end());
+        REQUIRE(std::adjacent_find(members.begin(), members.end()) == members.end());
+        REQUIRE(members.front() == d.get_min(v));
+        REQUIRE(members.back() == d.get_max(v));
+        size_t visited = 0;
+        d.for_each_member(v, [&](int64_t u) {
+            REQUIRE(d.same(u, v));
+            visited++;
+        });
+        REQUIRE(visited == members.size());
+    }
+    dsu single(3);
+    REQUIRE(single.members(2) == std::vector<int64_t>{2});
+}
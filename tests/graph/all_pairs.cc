@@ -0,0 +1,55 @@
+#include "../../src/classes/graph/all_pairs.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing all pairs shortest paths") {
+    weighted_graph<int> g("directed");
+    g.add_edge(0, 1, 3);
+    g.add_edge(1, 2, -2);
+    g.add_edge(0, 2, 4);
+    g.add_edge(2, 3, 2);
+    g.add_edge(3, 0, 1);
+    g.add_edge(4, 4, 1);
+
+    const csr_graph<int>& c = g.csr_view();
+    for (size_t threads : {1, 3}) {
+        for (const distance_matrix& d : {floyd_warshall(c, threads), johnson(c, threads),
+                                         g.all_pairs_shortest_paths(threads)}) {
+            REQUIRE(d.n == 5);
+            REQUIRE(!d.negative_cycle);
+            REQUIRE(d.at(c.id(0), c.id(2)) == 1);
+            REQUIRE(d.at(c.id(0), c.id(3)) == 3);
+            REQUIRE(d.at(c.id(3), c.id(2)) == 2);
+            REQUIRE(d.at(c.id(2), c.id(1)) == 6);
+            REQUIRE(d.at(c.id(4), c.id(4)) == 0);
+            REQUIRE(d.at(c.id(0), c.id(4)) == std::numeric_limits<double>::infinity());
+        }
+    }
+
+    g.add_edge(3, 1, -3);
+    REQUIRE(floyd_warshall(g.csr_view()).negative_cycle);
+    REQUIRE(johnson(g.csr_view()).negative_cycle);
+    REQUIRE(floyd_warshall(weighted_graph<int>("directed").csr_view()).n == 0);
+}
+
+TEST_CASE("testing floyd warshall against johnson and dijkstra") {
+    std::mt19937 rng(4);
+    for (const char* type : {"directed", "undirected"}) {
+        const int n = 150;
+        weighted_graph<int> g(type);
+        std::uniform_int_distribution<int> pick(0, n - 1), weight(0, 40);
+        for (int i = 0; i < 1200; i++) {
+            g.add_edge(pick(rng), pick(rng), weight(rng));
+        }
+        const csr_graph<int>& c = g.csr_view();
+        distance_matrix fw = floyd_warshall(c, 4), jo = johnson(c, 4);
+        REQUIRE(fw.dist == jo.dist);
+        for (uint32_t s = 0; s < c.size(); s += 17) {
+            sssp_tree tree = sssp(c, s);
+            for (uint32_t v = 0; v < c.size(); v++) {
+                REQUIRE(fw.at(s, v) == tree.dist[v]);
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "../../src/classes/graph/bellman_ford.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing spfa and parallel bellman ford") {
+    const double inf = std::numeric_limits<double>::infinity();
+    weighted_graph<int> g("directed");
+    g.add_edge(0, 1, 4);
+    g.add_edge(0, 2, 5);
+    g.add_edge(2, 1, -3);
+    g.add_edge(1, 3, 2);
+    g.add_edge(4, 0, 1);
+    const csr_graph<int>& c = g.csr_view();
+    for (bellman_ford_mode mode : {bellman_ford_mode::spfa, bellman_ford_mode::parallel}) {
+        for (size_t threads : {1, 3}) {
+            bellman_ford_result r = bellman_ford(c, c.id(0), mode, threads);
+            REQUIRE(!r.negative_cycle);
+            REQUIRE(r.dist[c.id(1)] == 2);
+            REQUIRE(r.dist[c.id(3)] == 4);
+            REQUIRE(r.dist[c.id(4)] == inf);
+            REQUIRE(g.bellman_ford(0, mode, threads).dist == r.dist);
+        }
+    }
+    REQUIRE(g.bellman_ford(42, bellman_ford_mode::spfa).dist.empty());
+
+    // 5 -> 6 -> 7 -> 5 is negative, 8 hangs behind it and 3 does not
+    g.add_edge(3, 5, 1);
+    g.add_edge(5, 6, 1);
+    g.add_edge(6, 7, -4);
+    g.add_edge(7, 5, 1);
+    g.add_edge(7, 8, 1);
+    g.add_edge(3, 9, 1);
+    const csr_graph<int>& d = g.csr_view();
+    for (bellman_ford_mode mode : {bellman_ford_mode::spfa, bellman_ford_mode::parallel}) {
+        bellman_ford_result r = bellman_ford(d, d.id(0), mode, 2);
+        REQUIRE(r.negative_cycle);
+        for (int v : {5, 6, 7, 8}) {
+            REQUIRE(r.dist[d.id(v)] == -inf);
+        }
+        REQUIRE(r.dist[d.id(9)] == 5);
+        REQUIRE(r.dist[d.id(3)] == 4);
+    }
+    REQUIRE(g.bellman_ford(0)[8] == -inf);
+}
+
+TEST_CASE("testing bellman ford against dijkstra and with random negative cycles") {
+    std::mt19937 rng(15);
+    const int n = 300;
+    weighted_graph<int> g("directed");
+    for (int i = 0; i < 1500; i++) {
+        g.add_edge(rng() % n, rng() % n, rng() % 50);
+    }
+    const csr_graph<int>& c = g.csr_view();
+    std::vector<double> expected = sssp(c, c.id(0)).dist;
+    REQUIRE(bellman_ford(c, c.id(0)).dist == expected);
+    REQUIRE(bellman_ford(c, c.id(0), bellman_ford_mode::parallel, 4).dist == expected);
+
+    for (int trial = 0; trial < 5; trial++) {
+        weighted_graph<int> h("directed");
+        for (int i = 0; i < 600; i++) {
+            h.add_edge(rng() % n, rng() % n, static_cast<double>(rng() % 40) - 3);
+        }
+        const csr_graph<int>& hc = h.csr_view();
+        bellman_ford_result a = bellman_ford(hc, 0);
+        bellman_ford_result b = bellman_ford(hc, 0, bellman_ford_mode::parallel, 3);
+        REQUIRE(a.negative_cycle == b.negative_cycle);
+        REQUIRE(a.dist == b.dist);
+    }
+}
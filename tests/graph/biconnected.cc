@@ -0,0 +1,130 @@
+#include "../../src/classes/graph/biconnected.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+#include <set>
+
+namespace {
+// components of the graph without vertex `skip` and without edge `skip_edge`
+size_t count_components(int n, const std::vector<std::pair<int, int>>& edges, int skip,
+                        size_t skip_edge) {
+    std::vector<int> label(n, -1);
+    size_t count = 0;
+    for (int r = 0; r < n; r++) {
+        if (r == skip || label[r] != -1) {
+            continue;
+        }
+        count++;
+        std::vector<int> st = {r};
+        label[r] = r;
+        while (!st.empty()) {
+            int u = st.back();
+            st.pop_back();
+            for (size_t i = 0; i < edges.size(); i++) {
+                auto [a, b] = edges[i];
+                if (i == skip_edge || a == skip || b == skip || (a != u && b != u)) {
+                    continue;
+                }
+                int v = a == u ? b : a;
+                if (label[v] == -1) {
+                    label[v] = r;
+                    st.push_back(v);
+                }
+            }
+        }
+    }
+    return count;
+}
+} // namespace
+
+TEST_CASE("testing biconnected components") {
+    graph<int> g("undirected");
+    // two triangles joined at 2, a bridge 4 - 5, a doubled edge 5 = 6, a self loop on 6
+    // and a separate bridge 8 - 9
+    for (auto [u, v] : std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {2, 0}, {2, 3},
+                                                          {3, 4}, {4, 2}, {4, 5}, {5, 6},
+                                                          {6, 5}, {6, 6}, {8, 9}}) {
+        g.add_edge(u, v);
+    }
+    const csr_graph<int>& c = g.csr_view();
+    for (size_t threads : {1, 2, 4}) {
+        biconnected_result r = g.biconnected_components(threads);
+        REQUIRE(r.count == 5);
+        std::vector<std::pair<uint32_t, uint32_t>> bridges = {
+            {std::min(c.id(4), c.id(5)), std::max(c.id(4), c.id(5))},
+            {std::min(c.id(8), c.id(9)), std::max(c.id(8), c.id(9))}};
+        std::sort(bridges.begin(), bridges.end());
+        REQUIRE(r.bridges == bridges);
+        std::vector<uint32_t> points = {c.id(2), c.id(4), c.id(5)};
+        std::sort(points.begin(), points.end());
+        REQUIRE(r.articulation_points == points);
+        REQUIRE(r.arc_component == biconnected_components(c, 1).arc_component);
+    }
+    uint32_t six = c.id(6);
+    for (size_t e = c.offsets()[six]; e < c.offsets()[six + 1]; e++) {
+        if (c.targets()[e] == six) {
+            REQUIRE(g.biconnected_components().arc_component[e] == csr_graph<int>::npos);
+        }
+    }
+    REQUIRE(biconnected_components(graph<int>("undirected").csr_view()).count == 0);
+}
+
+TEST_CASE("testing biconnected components against brute force") {
+    std::mt19937 rng(18);
+    for (int trial = 0; trial < 20; trial++) {
+        const int n = 30;
+        bool directed = trial % 2;
+        graph<int> g(directed ? "directed" : "undirected");
+        std::vector<std::pair<int, int>> edges;
+        for (int u = 0; u < n; u++) {
+            g.add_edge(u, u);
+        }
+        for (int i = 0; i < 25 + trial * 2; i++) {
+            int u = rng() % n, v = rng() % n;
+            g.add_edge(u, v);
+            if (u != v) {
+                edges.push_back({u, v});
+            }
+        }
+        const csr_graph<int>& c = g.csr_view();
+        size_t base = count_components(n, edges, -1, edges.size());
+
+        std::set<std::pair<uint32_t, uint32_t>> bridges;
+        for (size_t i = 0; i < edges.size(); i++) {
+            if (count_components(n, edges, -1, i) > base) {
+                uint32_t a = c.id(edges[i].first), b = c.id(edges[i].second);
+                bridges.insert({std::min(a, b), std::max(a, b)});
+            }
+        }
+        std::vector<uint32_t> points;
+        for (int u = 0; u < n; u++) {
+            if (count_components(n, edges, u, edges.size()) > base) {
+                points.push_back(c.id(u));
+            }
+        }
+        std::sort(points.begin(), points.end());
+
+        biconnected_result serial = biconnected_components(c, 1);
+        biconnected_result parallel = biconnected_components(c, 3);
+        REQUIRE(std::vector<std::pair<uint32_t, uint32_t>>(bridges.begin(), bridges.end()) ==
+                serial.bridges);
+        REQUIRE(serial.articulation_points == points);
+        REQUIRE(parallel.bridges == serial.bridges);
+        REQUIRE(parallel.articulation_points == serial.articulation_points);
+        REQUIRE(parallel.arc_component == serial.arc_component);
+        REQUIRE(parallel.count == serial.count);
+    }
+}
+
+TEST_CASE("testing bridges on a long path without recursion") {
+    graph<int> g("undirected");
+    const int n = 300000;
+    for (int i = 0; i + 1 < n; i++) {
+        g.add_edge(i, i + 1);
+    }
+    REQUIRE(g.bridge(0).size() == n - 1);
+    biconnected_result r = g.biconnected_components();
+    REQUIRE(r.bridges.size() == n - 1);
+    REQUIRE(r.articulation_points.size() == n - 2);
+    REQUIRE(g.biconnected_components(2).count == n - 1);
+}
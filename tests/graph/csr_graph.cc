@@ -0,0 +1,128 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/heap/pairing_heap.h"
+#include "../../src/classes/heap/radix_heap.h"
+#include "../../third_party/catch.hpp"
+#include <string>
+
+TEST_CASE("testing csr snapshot layout") {
+    graph<int> g("directed");
+    g.add_edge(1, 2);
+    g.add_edge(1, 3);
+    g.add_edge(3, 4);
+    csr_graph<int> c = g.freeze();
+    REQUIRE(c.size() == 4);
+    REQUIRE(c.arcs() == 3);
+    REQUIRE(c.directed() == true);
+    REQUIRE(c.weighted() == false);
+    REQUIRE(c.id(42) == csr_graph<int>::npos);
+    REQUIRE(c.degree(c.id(1)) == 2);
+    REQUIRE(c.degree(c.id(4)) == 0);
+    std::vector<int> neigh;
+    for (uint32_t v : c.neighbors(c.id(1))) {
+        neigh.push_back(c.vertex(v));
+    }
+    REQUIRE(neigh == std::vector<int>{2, 3});
+
+    graph<int> empty("undirected");
+    REQUIRE(empty.freeze().empty() == true);
+}
+
+TEST_CASE("testing csr traversals match graph traversals") {
+    graph<int> g("undirected");
+    g.add_edge(1, 2);
+    g.add_edge(2, 4);
+    g.add_edge(4, 8);
+    g.add_edge(1, 5);
+    g.add_edge(5, 6);
+    g.add_edge(7, 9);
+    const csr_graph<int>& c = g.csr_view();
+    REQUIRE(c.dfs(1) == g.dfs(1));
+    REQUIRE(c.bfs(1) == g.bfs(1));
+    REQUIRE(c.bfs(100).empty() == true);
+    REQUIRE(c.connected_components() == g.connected_components());
+    REQUIRE(c.connected_components() == 2);
+}
+
+TEST_CASE("testing csr_view is refreshed after add_edge") {
+    graph<char> g("directed");
+    g.add_edge('a', 'b');
+    REQUIRE(g.csr_view().size() == 2);
+    g.add_edge('b', 'c');
+    REQUIRE(g.csr_view().size() == 3);
+    REQUIRE(g.csr_view().bfs('a') == std::vector<char>{'a', 'b', 'c'});
+    g.clear();
+    REQUIRE(g.csr_view().empty() == true);
+}
+
+TEST_CASE("testing csr scc and bridges") {
+    graph<int> g("directed");
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(2, 0);
+    g.add_edge(1, 3);
+    g.add_edge(3, 4);
+    g.add_edge(4, 5);
+    g.add_edge(5, 3);
+    g.add_edge(3, 6);
+    g.add_edge(6, 7);
+    g.add_edge(6, 8);
+    g.add_edge(8, 6);
+    REQUIRE(g.freeze().scc() == 4);
+
+    graph<int> u("undirected");
+    u.add_edge(1, 0);
+    u.add_edge(0, 2);
+    u.add_edge(2, 1);
+    u.add_edge(0, 3);
+    u.add_edge(3, 4);
+    REQUIRE(u.freeze().bridge(0) == u.bridge(0));
+
+    weighted_graph<int> w("undirected");
+    w.add_edge(1, 0, 5);
+    w.add_edge(0, 2, 10);
+    w.add_edge(1, 2, 3);
+    w.add_edge(0, 3, 9);
+    w.add_edge(3, 4, 11);
+    std::vector<std::vector<int>> bridges = {{4, 3}, {3, 0}};
+    REQUIRE(w.freeze().bridge(0) == bridges);
+}
+
+TEST_CASE("testing csr shortest path and prim") {
+    weighted_graph<int> g("undirected");
+    g.add_edge(0, 1, 1);
+    g.add_edge(1, 2, 2);
+    g.add_edge(0, 2, 5);
+    g.add_edge(2, 3, 1);
+    g.add_edge(4, 5, 1);
+    const csr_graph<int>& c = g.csr_view();
+    REQUIRE(c.weighted() == true);
+    REQUIRE(c.shortest_path(0, 3) == 4);
+    REQUIRE(c.shortest_path(0, 3) == g.shortest_path(0, 3));
+    REQUIRE(c.shortest_path(0, 5) == -1);
+    REQUIRE(c.prim(0) == 4);
+    REQUIRE(c.prim<pairing_heap<double>>(0) == 4);
+    REQUIRE(c.shortest_path<radix_heap<uint64_t>>(0, 3) == 4);
+
+    graph<std::string> h("undirected");
+    h.add_edge("a", "b");
+    h.add_edge("b", "c");
+    h.add_edge("a", "d");
+    REQUIRE(h.freeze().shortest_path("d", "c") == 3);
+}
+
+TEST_CASE("testing csr max flow") {
+    weighted_graph<int> g("directed");
+    g.add_edge(0, 1, 16);
+    g.add_edge(0, 2, 13);
+    g.add_edge(1, 2, 10);
+    g.add_edge(2, 1, 4);
+    g.add_edge(1, 3, 12);
+    g.add_edge(3, 2, 9);
+    g.add_edge(2, 4, 14);
+    g.add_edge(4, 3, 7);
+    g.add_edge(3, 5, 20);
+    g.add_edge(4, 5, 4);
+    REQUIRE(g.freeze().max_flow(0, 5) == 23);
+    REQUIRE(g.freeze().max_flow(5, 0) == 0);
+    REQUIRE(g.freeze().max_flow(0, 42) == 0);
+}
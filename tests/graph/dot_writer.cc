@@ -0,0 +1,80 @@
+#include "../../src/classes/graph/dot_writer.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <filesystem>
+#include <sstream>
+
+TEST_CASE("testing streaming dot output") {
+    weighted_graph<std::string> g("directed");
+    g.add_edge("a", "b", 2);
+    g.add_edge("b", "say \"hi\"", 3);
+    std::ostringstream out;
+    REQUIRE(g.write_dot(out) == 2);
+    REQUIRE(out.str() == "digraph G {\n"
+                         "    \"a\";\n"
+                         "    \"b\";\n"
+                         "    \"say \\\"hi\\\"\";\n"
+                         "    \"a\" -> \"b\" [label=2];\n"
+                         "    \"b\" -> \"say \\\"hi\\\"\" [label=3];\n"
+                         "}\n");
+
+    graph<int> u("undirected");
+    u.add_edge(1, 2);
+    u.add_edge(2, 2);
+    u.add_edge(2, 3);
+    std::ostringstream plain;
+    REQUIRE(u.write_dot(plain) == 3);
+    REQUIRE(plain.str() == "graph G {\n    \"1\";\n    \"2\";\n    \"3\";\n"
+                           "    \"1\" -- \"2\";\n    \"2\" -- \"2\";\n    \"2\" -- \"3\";\n}\n");
+}
+
+TEST_CASE("testing sampled dot output") {
+    graph<int> g("undirected");
+    for (int i = 0; i < 1000; i++) {
+        g.add_edge(i, (i + 1) % 1000);
+    }
+    dot_options<int> ego;
+    ego.sampling = dot_sampling::ego;
+    ego.seed = 500;
+    ego.radius = 2;
+    std::ostringstream out;
+    REQUIRE(g.write_dot(out, ego) == 4);
+    REQUIRE(out.str().find("\"498\" -- \"499\"") != std::string::npos);
+    REQUIRE(out.str().find("\"497\"") == std::string::npos);
+
+    ego.max_vertices = 2;
+    std::ostringstream capped;
+    REQUIRE(g.write_dot(capped, ego) == 1);
+
+    dot_options<int> uniform;
+    uniform.sampling = dot_sampling::uniform;
+    uniform.max_vertices = 100;
+    std::ostringstream a, b;
+    g.write_dot(a, uniform);
+    g.write_dot(b, uniform);
+    REQUIRE(a.str() == b.str());
+    size_t nodes = 0;
+    std::istringstream lines(a.str());
+    for (std::string line; std::getline(lines, line);) {
+        nodes += line.find(" -- ") == std::string::npos && line.front() == ' ';
+    }
+    REQUIRE(nodes == 100);
+
+    ego.seed = -1;
+    std::ostringstream missing;
+    REQUIRE(g.write_dot(missing, ego) == 0);
+}
+
+TEST_CASE("testing asynchronous dot rendering") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_render.dot";
+    graph<int> g("directed");
+    g.add_edge(1, 2);
+    std::ofstream out(path);
+    g.write_dot(out);
+    out.close();
+    std::future<int> status = render_dot(path.string());
+    REQUIRE(status.valid());
+    status.get();
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".svg");
+}
@@ -0,0 +1,112 @@
+#include "../../src/classes/graph/edge_list.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace {
+template <typename T> std::vector<T> sorted_neighbors(const csr_graph<T>& c, const T& u) {
+    std::vector<T> result;
+    for (uint32_t v : c.neighbors(c.id(u))) {
+        result.push_back(c.vertex(v));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+} // namespace
+
+TEST_CASE("testing text edge lists") {
+    std::string text = "# comment\n"
+                       "1 2\n"
+                       "\n"
+                       "2\t3\r\n"
+                       "% another comment\n"
+                       "3,1\n"
+                       "4 4 ignored columns\n"
+                       "1 2";
+    for (size_t threads : {1, 3, 8}) {
+        csr_graph<int> c = parse_edge_list<int>(text, {edge_list_format::text, false, false,
+                                                       false, threads});
+        REQUIRE(c.size() == 4);
+        REQUIRE(c.vertices() == std::vector<int>{1, 2, 3, 4});
+        REQUIRE(c.arcs() == 10);
+        REQUIRE(sorted_neighbors(c, 1) == std::vector<int>{2, 2, 3});
+        REQUIRE(sorted_neighbors(c, 4) == std::vector<int>{4, 4});
+        REQUIRE(!c.directed());
+        REQUIRE(!c.weighted());
+
+        csr_graph<int> d = parse_edge_list<int>(text, {edge_list_format::text, true, false,
+                                                       true, threads});
+        REQUIRE(d.arcs() == 4);
+        REQUIRE(sorted_neighbors(d, 1) == std::vector<int>{2});
+        REQUIRE(sorted_neighbors(d, 4) == std::vector<int>{4});
+        REQUIRE(d.scc() == 2);
+    }
+
+    csr_graph<std::string> s =
+        parse_edge_list<std::string>("a b 2.5\nb c 1\na c 4\na b 1.5\n",
+                                     {edge_list_format::text, true, true, true, 2});
+    REQUIRE(s.weighted());
+    REQUIRE(s.arcs() == 3);
+    REQUIRE(s.shortest_path("a", "c") == 2.5);
+
+    REQUIRE_THROWS_AS(parse_edge_list<int>("1 2\n3\n"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_edge_list<int>("1 x\n"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_edge_list<int>("1 2\n", {edge_list_format::text, false, true}),
+                      std::invalid_argument);
+    REQUIRE(parse_edge_list<int>("").empty());
+}
+
+TEST_CASE("testing edge list files against add_edge") {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> pick(0, 999), weight(1, 50);
+    weighted_graph<int> g("undirected");
+    std::string text;
+    std::vector<char> binary;
+    for (int i = 0; i < 5000; i++) {
+        int u = pick(rng), v = pick(rng);
+        double w = weight(rng);
+        g.add_edge(u, v, w);
+        text += std::to_string(u) + ' ' + std::to_string(v) + ' ' + std::to_string(w) + '\n';
+        const char* p = reinterpret_cast<const char*>(&u);
+        binary.insert(binary.end(), p, p + sizeof(int));
+        p = reinterpret_cast<const char*>(&v);
+        binary.insert(binary.end(), p, p + sizeof(int));
+        p = reinterpret_cast<const char*>(&w);
+        binary.insert(binary.end(), p, p + sizeof(double));
+    }
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::filesystem::path text_path = dir / "algoplus_edge_list.txt";
+    std::filesystem::path binary_path = dir / "algoplus_edge_list.bin";
+    std::ofstream(text_path) << text;
+    std::ofstream(binary_path, std::ios::binary).write(binary.data(), binary.size());
+
+    const csr_graph<int>& expected = g.csr_view();
+    for (size_t threads : {1, 4}) {
+        csr_graph<int> from_text = load_edge_list<int>(
+            text_path.string(), {edge_list_format::text, false, true, false, threads});
+        csr_graph<int> from_binary = load_edge_list<int>(
+            binary_path.string(), {edge_list_format::binary, false, true, false, threads});
+        for (const csr_graph<int>* c : {&from_text, &from_binary}) {
+            REQUIRE(c->vertices() == expected.vertices());
+            REQUIRE(c->arcs() == expected.arcs());
+            for (int u : expected.vertices()) {
+                REQUIRE(sorted_neighbors(*c, u) == sorted_neighbors(expected, u));
+            }
+            REQUIRE(c->connected_components() == expected.connected_components());
+            REQUIRE(c->shortest_path(0, 999) == g.shortest_path(0, 999));
+        }
+        REQUIRE(from_text.targets() == from_binary.targets());
+        REQUIRE(from_text.weights() == from_binary.weights());
+    }
+
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(binary_path);
+    REQUIRE_THROWS_AS(load_edge_list<int>(text_path.string()), std::runtime_error);
+    REQUIRE_THROWS_AS(parse_edge_list<int>(std::string_view(binary.data(), 7),
+                                           {edge_list_format::binary}),
+                      std::invalid_argument);
+}
@@ -0,0 +1,74 @@
+#include "../../src/classes/graph/flow_network.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+namespace {
+double cut_capacity(const csr_graph<int>& c, const std::vector<uint8_t>& side) {
+    double capacity = 0;
+    for (uint32_t u = 0; u < c.size(); u++) {
+        for (size_t e = c.offsets()[u]; e < c.offsets()[u + 1]; e++) {
+            if (side[u] && !side[c.targets()[e]]) {
+                capacity += c.weight(e);
+            }
+        }
+    }
+    return capacity;
+}
+} // namespace
+
+TEST_CASE("testing max flow and min cut") {
+    weighted_graph<char> g("directed");
+    g.add_edge('s', 'A', 7);
+    g.add_edge('s', 'D', 4);
+    g.add_edge('A', 'B', 5);
+    g.add_edge('A', 'C', 3);
+    g.add_edge('D', 'A', 3);
+    g.add_edge('D', 'C', 2);
+    g.add_edge('B', 't', 8);
+    g.add_edge('C', 't', 5);
+    g.add_edge('C', 'B', 3);
+
+    REQUIRE(g.max_flow('s', 't') == 10);
+    REQUIRE(g.max_flow('t', 's') == 0);
+    REQUIRE(g.max_flow('s', 's') == 0);
+    REQUIRE(g.max_flow('s', 'x') == 0);
+    const csr_graph<char>& c = g.csr_view();
+    for (flow_algorithm algo : {flow_algorithm::dinic, flow_algorithm::push_relabel}) {
+        flow_result cut = g.min_cut('s', 't', algo);
+        REQUIRE(cut.value == 10);
+        REQUIRE(cut.source_side[c.id('s')] == 1);
+        REQUIRE(cut.source_side[c.id('D')] == 1);
+        REQUIRE(cut.source_side[c.id('A')] == 1);
+        REQUIRE(cut.source_side[c.id('C')] == 0);
+        REQUIRE(cut.source_side[c.id('t')] == 0);
+    }
+}
+
+TEST_CASE("testing dinic against push relabel") {
+    std::mt19937 rng(17);
+    for (const char* type : {"directed", "undirected"}) {
+        const int n = 300;
+        weighted_graph<int> g(type);
+        std::uniform_int_distribution<int> pick(0, n - 1), capacity(1, 100);
+        for (int i = 0; i < 3000; i++) {
+            g.add_edge(pick(rng), pick(rng), capacity(rng));
+        }
+        const csr_graph<int>& c = g.csr_view();
+        flow_network network(c.size(), c.offsets(), c.targets(), c.weights());
+        REQUIRE(network.arcs() <= 2 * c.arcs());
+        for (int i = 0; i < 10; i++) {
+            uint32_t s = pick(rng) % c.size(), t = pick(rng) % c.size();
+            flow_result a = network.solve(s, t, flow_algorithm::dinic);
+            flow_result b = network.solve(s, t, flow_algorithm::push_relabel);
+            REQUIRE(a.value == b.value);
+            REQUIRE(a.source_side == b.source_side);
+            if (s != t) {
+                REQUIRE(a.source_side[s] == 1);
+                REQUIRE(a.source_side[t] == 0);
+                // max flow = min cut certifies both engines
+                REQUIRE(cut_capacity(c, a.source_side) == a.value);
+            }
+        }
+    }
+}
@@ -344,3 +344,21 @@ TEST_CASE("Testing visualize for graph class") {
     g.add_edge(3, 4);
     CHECK_NOTHROW(g.visualize());
 }
+
+TEST_CASE("Testing compile time direction policies for graph class") {
+    directed_graph<int> d({{1, {2}}, {2, {3}}});
+    undirected_graph<int> u({{1, {2}}, {2, {3}}});
+    graph<int> r("directed", {{1, {2}}, {2, {3}}});
+    REQUIRE(d.has_edge(1, 2));
+    REQUIRE(!d.has_edge(2, 1));
+    REQUIRE(u.has_edge(2, 1));
+    REQUIRE(d.topological_sort() == r.topological_sort());
+    REQUIRE(d.csr_view().directed());
+    REQUIRE(!u.csr_view().directed());
+    REQUIRE(u.csr_view().arcs() == 2 * d.csr_view().arcs());
+
+    directed_graph<int> copy(d);
+    copy.add_edge(3, 1);
+    REQUIRE(copy.cycle());
+    REQUIRE(!d.cycle());
+}
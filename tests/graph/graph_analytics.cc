@@ -0,0 +1,120 @@
+#include "../../src/classes/graph/graph_analytics.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing pagerank") {
+    graph<int> g("directed");
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(2, 0);
+    g.add_edge(3, 0);
+    const csr_graph<int>& c = g.csr_view();
+    for (size_t threads : {1, 3}) {
+        std::vector<double> rank = pagerank(c, {0.85, 1e-12, 200, threads});
+        double sum = 0;
+        for (double r : rank) {
+            sum += r;
+        }
+        REQUIRE(std::abs(sum - 1) < 1e-9);
+        REQUIRE(std::abs(rank[c.id(3)] - 0.15 / 4) < 1e-9);
+        REQUIRE(rank[c.id(0)] > rank[c.id(1)]);
+        REQUIRE(rank[c.id(1)] > rank[c.id(3)]);
+    }
+
+    // a cycle is uniform, a dangling vertex gives its rank to everyone
+    graph<int> ring("undirected");
+    for (int i = 0; i < 10; i++) {
+        ring.add_edge(i, (i + 1) % 10);
+    }
+    for (double r : pagerank(ring.csr_view())) {
+        REQUIRE(std::abs(r - 0.1) < 1e-9);
+    }
+    graph<int> pair("directed");
+    pair.add_edge(0, 1);
+    std::vector<double> rank = pagerank(pair.csr_view(), {0.85, 1e-12, 500, 1});
+    REQUIRE(std::abs(rank[0] + rank[1] - 1) < 1e-9);
+    REQUIRE(rank[1] > rank[0]);
+    REQUIRE(pagerank(graph<int>("directed").csr_view()).empty());
+}
+
+TEST_CASE("testing triangle counting and k-core") {
+    graph<int> g("undirected");
+    // K4 on 0..3 plus a triangle 3 4 5 sharing a vertex and a tail 5 6
+    for (int u = 0; u < 4; u++) {
+        for (int v = u + 1; v < 4; v++) {
+            g.add_edge(u, v);
+        }
+    }
+    g.add_edge(3, 4);
+    g.add_edge(4, 5);
+    g.add_edge(5, 3);
+    g.add_edge(5, 6);
+    g.add_edge(6, 6);
+    g.add_edge(0, 1);
+    const csr_graph<int>& c = g.csr_view();
+    REQUIRE(triangle_count(c, 1) == 5);
+    REQUIRE(triangle_count(c, 3) == 5);
+    std::vector<uint32_t> core = core_numbers(c);
+    for (int v : {0, 1, 2, 3}) {
+        REQUIRE(core[c.id(v)] == 3);
+    }
+    REQUIRE(core[c.id(4)] == 2);
+    REQUIRE(core[c.id(5)] == 2);
+    REQUIRE(core[c.id(6)] == 1);
+}
+
+TEST_CASE("testing triangle counting and k-core against brute force") {
+    std::mt19937 rng(16);
+    const int n = 120;
+    graph<int> g("directed");
+    std::vector<std::vector<uint8_t>> adj(n, std::vector<uint8_t>(n, 0));
+    for (int u = 0; u < n; u++) {
+        g.add_edge(u, u);
+    }
+    for (int i = 0; i < 1500; i++) {
+        int u = rng() % n, v = rng() % n;
+        g.add_edge(u, v);
+        if (u != v) {
+            adj[u][v] = adj[v][u] = 1;
+        }
+    }
+    size_t expected = 0;
+    for (int a = 0; a < n; a++) {
+        for (int b = a + 1; b < n; b++) {
+            for (int d = b + 1; d < n; d++) {
+                expected += adj[a][b] && adj[b][d] && adj[a][d];
+            }
+        }
+    }
+    const csr_graph<int>& c = g.csr_view();
+    REQUIRE(triangle_count(c, 4) == expected);
+
+    // peel naively: the core number is the largest k whose k-core still holds the vertex
+    std::vector<uint32_t> core = core_numbers(c);
+    for (uint32_t k = 0;; k++) {
+        std::vector<uint8_t> alive(n, 1);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int u = 0; u < n; u++) {
+                uint32_t d = 0;
+                for (int v = 0; v < n; v++) {
+                    d += alive[u] && alive[v] && adj[u][v];
+                }
+                if (alive[u] && d < k) {
+                    alive[u] = 0;
+                    changed = true;
+                }
+            }
+        }
+        bool any = false;
+        for (int u = 0; u < n; u++) {
+            REQUIRE((core[c.id(u)] >= k) == (alive[u] == 1));
+            any |= alive[u] == 1;
+        }
+        if (!any) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include "../../src/classes/graph/graph_snapshot.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../third_party/catch.hpp"
+#include <filesystem>
+#include <random>
+
+TEST_CASE("testing graph snapshot round trip") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_snapshot.bin";
+    std::mt19937 rng(14);
+    weighted_graph<int> g("directed");
+    for (int i = 0; i < 500; i++) {
+        g.add_edge(rng() % 120, rng() % 120, (rng() % 100) / 4.0);
+    }
+    const csr_graph<int>& c = g.csr_view();
+    save_snapshot(c, path.string());
+
+    snapshot_view<int> view(path.string());
+    REQUIRE(view.size() == c.size());
+    REQUIRE(view.arcs() == c.arcs());
+    REQUIRE(view.directed());
+    REQUIRE(view.weighted());
+    for (uint32_t u = 0; u < c.size(); u++) {
+        REQUIRE(view.vertex(u) == c.vertex(u));
+        REQUIRE(std::equal(view.neighbors(u).begin(), view.neighbors(u).end(),
+                           c.neighbors(u).begin(), c.neighbors(u).end()));
+    }
+    REQUIRE(std::equal(view.weights().begin(), view.weights().end(), c.weights().begin()));
+
+    csr_graph<int> loaded = load_snapshot<int>(path.string());
+    REQUIRE(loaded.vertices() == c.vertices());
+    REQUIRE(loaded.offsets() == c.offsets());
+    REQUIRE(loaded.targets() == c.targets());
+    REQUIRE(loaded.shortest_path(c.vertex(0), c.vertex(5)) ==
+            c.shortest_path(c.vertex(0), c.vertex(5)));
+    REQUIRE_THROWS_AS(snapshot_view<long long>(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("testing graph snapshot with string vertices") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_snapshot.str";
+    graph<std::string> g("undirected");
+    g.add_edge("a", "bb");
+    g.add_edge("bb", "");
+    g.add_edge("ccc", "a");
+    save_snapshot(g.csr_view(), path.string());
+
+    snapshot_view<std::string> view(path.string());
+    REQUIRE(!view.directed());
+    REQUIRE(!view.weighted());
+    REQUIRE(view.weights().empty());
+    csr_graph<std::string> loaded = view.to_csr();
+    REQUIRE(loaded.vertices() == g.csr_view().vertices());
+    REQUIRE(loaded.id("ccc") == g.csr_view().id("ccc"));
+    REQUIRE(loaded.bfs("a") == g.csr_view().bfs("a"));
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    REQUIRE_THROWS_AS(snapshot_view<std::string>(path.string()), std::runtime_error);
+    std::ofstream(path) << "not a snapshot at all, just some text padding the header size";
+    REQUIRE_THROWS_AS(snapshot_view<std::string>(path.string()), std::runtime_error);
+    REQUIRE_THROWS_AS(snapshot_view<std::string>("/nonexistent/snapshot"), std::runtime_error);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,66 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/incremental_dag.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing incremental dag") {
+    incremental_dag<char> g;
+    REQUIRE(g.add_edge('c', 'd'));
+    REQUIRE(g.add_edge('b', 'c'));
+    REQUIRE(g.add_edge('a', 'b'));
+    REQUIRE(g.topological_sort() == std::vector<char>{'a', 'b', 'c', 'd'});
+    REQUIRE(!g.add_edge('d', 'a'));
+    REQUIRE(!g.has_edge('d', 'a'));
+    REQUIRE(!g.add_edge('e', 'e'));
+    REQUIRE(g.size() == 5);
+    REQUIRE(!g.cycle());
+    REQUIRE(g.position('a') < g.position('d'));
+    REQUIRE(g.position('z') == -1);
+
+    incremental_dag<int> f(cycle_policy::flag);
+    REQUIRE(f.add_edge(1, 2));
+    REQUIRE(!f.add_edge(2, 1));
+    REQUIRE(f.has_edge(2, 1));
+    REQUIRE(f.cycle());
+    REQUIRE(f.topological_sort().empty());
+    f.clear();
+    REQUIRE(f.empty());
+    REQUIRE(f.add_edge(2, 1));
+    REQUIRE(!f.cycle());
+}
+
+TEST_CASE("testing incremental dag against a full recomputation") {
+    std::mt19937 rng(8);
+    const int n = 60;
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    incremental_dag<int> dag;
+    graph<int> g("directed");
+    for (int v = 0; v < n; v++) {
+        dag.add_vertex(v);
+    }
+    size_t accepted = 0;
+    for (int i = 0; i < 600; i++) {
+        int u = pick(rng), v = pick(rng);
+        // u -> v closes a cycle iff v already reaches u
+        std::vector<int> reach = g.dfs(v);
+        bool closes = u == v || std::find(reach.begin(), reach.end(), u) != reach.end();
+        REQUIRE(dag.add_edge(u, v) == !closes);
+        if (!closes) {
+            g.add_edge(u, v);
+            accepted++;
+        }
+        std::vector<int> order = dag.topological_sort();
+        REQUIRE(order.size() == size_t(n));
+        for (int x = 0; x < n; x++) {
+            REQUIRE(order[dag.position(x)] == x);
+        }
+    }
+    for (int x = 0; x < n; x++) {
+        for (int y : g.dfs(x)) {
+            if (g.has_edge(x, y)) {
+                REQUIRE(dag.position(x) < dag.position(y));
+            }
+        }
+    }
+    REQUIRE(accepted > 0);
+}
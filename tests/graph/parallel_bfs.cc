@@ -0,0 +1,71 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/parallel_bfs.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+namespace {
+std::vector<int64_t> serial_depths(const csr_graph<int>& c, uint32_t s) {
+    std::vector<int64_t> depth(c.size(), -1);
+    std::vector<uint32_t> q = {s};
+    depth[s] = 0;
+    for (size_t head = 0; head < q.size(); head++) {
+        for (uint32_t v : c.neighbors(q[head])) {
+            if (depth[v] == -1) {
+                depth[v] = depth[q[head]] + 1;
+                q.push_back(v);
+            }
+        }
+    }
+    return depth;
+}
+
+void check_tree(const csr_graph<int>& c, uint32_t s, const bfs_tree& tree) {
+    REQUIRE(tree.depth == serial_depths(c, s));
+    for (uint32_t v = 0; v < c.size(); v++) {
+        if (tree.depth[v] <= 0) {
+            continue;
+        }
+        uint32_t p = tree.parent[v];
+        REQUIRE(tree.depth[p] == tree.depth[v] - 1);
+        auto neigh = c.neighbors(p);
+        REQUIRE(std::find(neigh.begin(), neigh.end(), v) != neigh.end());
+    }
+}
+} // namespace
+
+TEST_CASE("testing parallel bfs on a path") {
+    graph<int> g("undirected");
+    g.add_edge(1, 2);
+    g.add_edge(2, 3);
+    g.add_edge(3, 4);
+    g.add_edge(7, 8);
+    const csr_graph<int>& c = g.csr_view();
+    bfs_tree tree = parallel_bfs(c, 1, 2);
+    REQUIRE(tree.depth[c.id(4)] == 3);
+    REQUIRE(tree.depth[c.id(7)] == -1);
+    REQUIRE(tree.parent[c.id(1)] == c.id(1));
+    REQUIRE(tree.parent[c.id(8)] == csr_graph<int>::npos);
+    REQUIRE(tree.order.size() == 4);
+    REQUIRE(parallel_bfs(c, 42).depth.empty() == true);
+}
+
+TEST_CASE("testing parallel bfs against a serial bfs") {
+    std::mt19937 rng(7);
+    for (std::string type : {"undirected", "directed"}) {
+        graph<int> g(type);
+        std::uniform_int_distribution<int> pick(0, 499);
+        for (int i = 0; i < 2000; i++) {
+            g.add_edge(pick(rng), pick(rng));
+        }
+        const csr_graph<int>& c = g.csr_view();
+        uint32_t s = static_cast<uint32_t>(c.size() / 2);
+        for (size_t threads : {1, 4}) {
+            // alpha = 1e9 forces bottom-up steps early, alpha = 1e-9 keeps top-down
+            for (double alpha : {15.0, 1e9, 1e-9}) {
+                direction_optimizing_bfs<int> engine(c, threads, alpha);
+                check_tree(c, s, engine.run_id(s));
+                check_tree(c, 0, engine.run_id(0));
+            }
+        }
+    }
+}
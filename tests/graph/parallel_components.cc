@@ -0,0 +1,66 @@
+#include "../../src/classes/disjoint_set/disjoint_set.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/parallel_components.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing parallel connected components on small graphs") {
+    graph<int> g("undirected");
+    g.add_edge(1, 2);
+    g.add_edge(2, 3);
+    g.add_edge(4, 5);
+    g.add_edge(7, 7);
+    const csr_graph<int>& c = g.csr_view();
+    for (size_t threads : {1, 4}) {
+        component_labels labels = parallel_connected_components(c, threads);
+        REQUIRE(labels.count == 3);
+        REQUIRE(labels.count == size_t(g.connected_components()));
+        REQUIRE(labels.component[c.id(1)] == 0);
+        REQUIRE(labels.component[c.id(3)] == 0);
+        REQUIRE(labels.component[c.id(4)] == 1);
+        REQUIRE(labels.component[c.id(5)] == 1);
+        REQUIRE(labels.component[c.id(7)] == 2);
+    }
+
+    graph<int> empty("undirected");
+    REQUIRE(parallel_connected_components(empty.freeze()).count == 0);
+
+    // directed graphs are labeled by their weak components
+    graph<int> d("directed");
+    d.add_edge(1, 0);
+    d.add_edge(2, 0);
+    d.add_edge(3, 4);
+    component_labels weak = parallel_connected_components(d.freeze(), 2);
+    REQUIRE(weak.count == 2);
+}
+
+TEST_CASE("testing parallel connected components against dsu") {
+    std::mt19937 rng(11);
+    for (const char* type : {"undirected", "directed"}) {
+        const int n = 2000;
+        graph<int> g(type);
+        for (int v = 0; v < n; v++) {
+            g.add_edge(v, v);
+        }
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        dsu d(n);
+        for (int i = 0; i < 1500; i++) {
+            int u = pick(rng), v = pick(rng);
+            g.add_edge(u, v);
+            d.join(u, v);
+        }
+        csr_graph<int> c = g.freeze();
+        for (size_t threads : {1, 4}) {
+            component_labels labels = parallel_connected_components(c, threads);
+            size_t roots = 0;
+            for (int v = 0; v < n; v++) {
+                roots += d.find(v) == v;
+            }
+            REQUIRE(labels.count == roots);
+            for (int i = 0; i < 5000; i++) {
+                int u = pick(rng), v = pick(rng);
+                REQUIRE((labels.component[c.id(u)] == labels.component[c.id(v)]) == d.same(u, v));
+            }
+        }
+    }
+}
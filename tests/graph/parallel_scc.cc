@@ -0,0 +1,65 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/parallel_scc.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing scc labels") {
+    graph<int> g("directed");
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(2, 0);
+    g.add_edge(1, 3);
+    g.add_edge(3, 4);
+    g.add_edge(4, 3);
+    g.add_edge(5, 5);
+
+    const csr_graph<int>& c = g.csr_view();
+    for (size_t threads : {1, 0, 4}) {
+        component_labels labels = g.scc_labels(threads);
+        REQUIRE(labels.count == 3);
+        REQUIRE(labels.component == std::vector<uint32_t>{0, 0, 0, 1, 1, 2});
+    }
+    REQUIRE(c.scc_labels().component == g.scc_labels().component);
+    REQUIRE(graph<int>("directed").scc_labels().count == 0);
+
+    weighted_graph<char> w("directed");
+    w.add_edge('a', 'b', 1);
+    w.add_edge('b', 'c', 2);
+    w.add_edge('c', 'b', 3);
+    REQUIRE(w.scc_labels().count == 2);
+    REQUIRE(w.scc_labels(2).component == w.scc_labels().component);
+}
+
+TEST_CASE("testing scc on long chains") {
+    const int n = 1000000;
+    graph<int> chain("directed");
+    for (int i = 0; i + 1 < n; i++) {
+        chain.add_edge(i, i + 1);
+    }
+    REQUIRE(chain.scc() == n);
+    REQUIRE(chain.scc_labels(4).count == size_t(n));
+
+    // closing the chain makes a single cycle the trimming step can't peel
+    chain.add_edge(n - 1, 0);
+    REQUIRE(chain.scc() == 1);
+    REQUIRE(chain.scc_labels(4).count == 1);
+    REQUIRE(chain.csr_view().scc() == 1);
+}
+
+TEST_CASE("testing parallel scc against tarjan") {
+    std::mt19937 rng(21);
+    for (int edges : {3000, 6000, 20000}) {
+        const int n = 5000;
+        graph<int> g("directed");
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        for (int i = 0; i < edges; i++) {
+            g.add_edge(pick(rng), pick(rng));
+        }
+        component_labels expected = g.scc_labels();
+        for (size_t threads : {2, 4}) {
+            component_labels labels = parallel_scc(g.csr_view(), threads);
+            REQUIRE(labels.count == expected.count);
+            REQUIRE(labels.component == expected.component);
+        }
+    }
+}
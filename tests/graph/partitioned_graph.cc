@@ -0,0 +1,72 @@
+#include "../../src/classes/graph/partitioned_graph.h"
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/sssp.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing partitioned graph shards") {
+    graph<int> g("undirected");
+    for (int i = 0; i < 9; i++) {
+        g.add_edge(i, i + 1);
+    }
+    const csr_graph<int>& c = g.csr_view();
+    for (partition_method m : {partition_method::hash, partition_method::greedy}) {
+        partitioned_graph<int> pg(c, 3, m);
+        REQUIRE(pg.shards() == 3);
+        size_t owned = 0, arcs = 0;
+        for (size_t p = 0; p < pg.shards(); p++) {
+            const graph_shard& s = pg.shard(p);
+            owned += s.owned;
+            arcs += s.targets.size();
+            REQUIRE(s.ghost_owner.size() == s.ghosts());
+            for (uint32_t i = 0; i < s.owned; i++) {
+                REQUIRE(pg.owner(s.global[i]) == p);
+            }
+            for (size_t i = 0; i < s.ghosts(); i++) {
+                REQUIRE(s.ghost_owner[i] != p);
+                REQUIRE(pg.owner(s.global[s.owned + i]) == s.ghost_owner[i]);
+            }
+        }
+        REQUIRE(owned == 10);
+        REQUIRE(arcs == c.arcs());
+    }
+    // a path splits into contiguous runs, 2 cut edges in each direction
+    REQUIRE(partitioned_graph<int>(c, 3, partition_method::greedy).edge_cut() == 4);
+}
+
+TEST_CASE("testing partitioned bfs and sssp") {
+    std::mt19937 rng(13);
+    for (const char* type : {"directed", "undirected"}) {
+        weighted_graph<int> g(type);
+        graph<int> h(type);
+        const int n = 400;
+        for (int i = 0; i < 1600; i++) {
+            int u = rng() % n, v = rng() % n;
+            g.add_edge(u, v, 1 + rng() % 20);
+            h.add_edge(u, v);
+        }
+        const csr_graph<int>& c = g.csr_view();
+        const csr_graph<int>& hc = h.csr_view();
+        std::vector<double> expected = sssp(c, c.id(0)).dist;
+        std::vector<double> hops = sssp(hc, hc.id(0)).dist;
+        for (partition_method m : {partition_method::hash, partition_method::greedy}) {
+            for (size_t k : {1, 4, 7}) {
+                partitioned_graph<int> pg(c, k, m);
+                local_transport transport(k);
+                REQUIRE(pg.sssp(0, transport, 2) == expected);
+                REQUIRE((k == 1) == (transport.messages() == 0));
+
+                partitioned_graph<int> ph(hc, k, m);
+                local_transport bfs_transport(k);
+                std::vector<int64_t> depth = ph.bfs(0, bfs_transport, 2);
+                for (uint32_t u = 0; u < hc.size(); u++) {
+                    double d = hops[u] == std::numeric_limits<double>::infinity() ? -1 : hops[u];
+                    REQUIRE(depth[u] == d);
+                }
+            }
+        }
+        partitioned_graph<int> pg(c, 2);
+        local_transport transport(2);
+        REQUIRE(pg.bfs(-5, transport) == std::vector<int64_t>(c.size(), -1));
+    }
+}
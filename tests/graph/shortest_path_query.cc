@@ -0,0 +1,83 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/shortest_path_query.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+namespace {
+double path_cost(const csr_graph<int>& c, const std::vector<int>& path) {
+    double cost = 0;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        uint32_t u = c.id(path[i]), v = c.id(path[i + 1]);
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t e = c.offsets()[u]; e < c.offsets()[u + 1]; e++) {
+            if (c.targets()[e] == v) {
+                best = std::min(best, c.weight(e));
+            }
+        }
+        cost += best;
+    }
+    return cost;
+}
+} // namespace
+
+TEST_CASE("testing shortest path query") {
+    weighted_graph<int> g("undirected");
+    g.add_edge(1, 2, 5);
+    g.add_edge(3, 4, 1);
+    g.add_edge(2, 5, 10);
+    g.add_edge(5, 8, 10);
+    g.add_edge(4, 8, 5);
+    g.add_edge(2, 3, 1);
+    g.add_edge(9, 10, 1);
+
+    shortest_path_query<int> q(g.csr_view());
+    REQUIRE(q.distance(1, 8) == 12);
+    REQUIRE(q.path() == std::vector<int>{1, 2, 3, 4, 8});
+    REQUIRE(q.distance(8, 1) == 12);
+    REQUIRE(q.path() == std::vector<int>{8, 4, 3, 2, 1});
+    REQUIRE(q.distance(1, 9) == -1);
+    REQUIRE(q.path().empty());
+    REQUIRE(q.distance(5, 5) == 0);
+    REQUIRE(q.path() == std::vector<int>{5});
+    REQUIRE(q.distance(1, 42) == -1);
+    REQUIRE(q.distance(2, 5) == 10);
+
+    // the graph keeps its own query and drops it once the graph changes
+    REQUIRE(g.shortest_path(1, 8) == 12);
+    g.add_edge(1, 8, 3);
+    REQUIRE(g.shortest_path(1, 8) == 3);
+    REQUIRE(g.shortest_path(1, 9) == -1);
+}
+
+TEST_CASE("testing shortest path query against dijkstra") {
+    std::mt19937 rng(9);
+    for (const char* type : {"undirected", "directed"}) {
+        const int n = 800;
+        weighted_graph<int> g(type);
+        std::uniform_int_distribution<int> pick(0, n - 1), weight(0, 30);
+        for (int i = 0; i < 2500; i++) {
+            g.add_edge(pick(rng), pick(rng), weight(rng));
+        }
+        const csr_graph<int>& c = g.csr_view();
+        shortest_path_query<int> q(c);
+        std::uniform_int_distribution<uint32_t> vertex(0, c.size() - 1);
+        for (int i = 0; i < 20; i++) {
+            uint32_t s = vertex(rng);
+            sssp_tree expected = sssp(c, s);
+            for (int j = 0; j < 20; j++) {
+                uint32_t t = vertex(rng);
+                double d = q.distance_id(s, t);
+                if (expected.dist[t] == std::numeric_limits<double>::infinity()) {
+                    REQUIRE(d == -1);
+                    REQUIRE(q.path().empty());
+                } else {
+                    REQUIRE(d == expected.dist[t]);
+                    std::vector<int> path = q.path();
+                    REQUIRE(path.front() == c.vertex(s));
+                    REQUIRE(path.back() == c.vertex(t));
+                    REQUIRE(path_cost(c, path) == d);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/spanning_forest.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing minimum spanning forest") {
+    weighted_graph<int> g("undirected");
+    g.add_edge(0, 1, 4);
+    g.add_edge(0, 7, 8);
+    g.add_edge(1, 2, 8);
+    g.add_edge(1, 7, 11);
+    g.add_edge(2, 3, 7);
+    g.add_edge(2, 8, 2);
+    g.add_edge(2, 5, 4);
+    g.add_edge(3, 4, 9);
+    g.add_edge(3, 5, 14);
+    g.add_edge(4, 5, 10);
+    g.add_edge(5, 6, 2);
+    g.add_edge(6, 7, 1);
+    g.add_edge(6, 8, 6);
+    g.add_edge(7, 8, 7);
+    g.add_edge(10, 11, 3);
+    g.add_edge(11, 11, 1);
+
+    for (mst_algorithm algo : {mst_algorithm::kruskal, mst_algorithm::boruvka}) {
+        for (size_t threads : {1, 4}) {
+            std::vector<std::tuple<int, int, double>> edges =
+                g.minimum_spanning_forest(algo, threads);
+            REQUIRE(edges.size() == 9);
+            double total = 0;
+            for (auto& [u, v, w] : edges) {
+                REQUIRE(g.has_edge(u, v));
+                total += w;
+            }
+            REQUIRE(total == 40);
+        }
+    }
+    REQUIRE(g.prim(0) == 37);
+    REQUIRE(weighted_graph<int>("directed").minimum_spanning_forest().empty());
+}
+
+TEST_CASE("testing kruskal against boruvka") {
+    std::mt19937 rng(13);
+    for (const char* type : {"undirected", "directed"}) {
+        const int n = 2000;
+        weighted_graph<int> g(type);
+        std::uniform_int_distribution<int> pick(0, n - 1), weight(1, 25);
+        for (int i = 0; i < 5000; i++) {
+            g.add_edge(pick(rng), pick(rng), weight(rng));
+        }
+        const csr_graph<int>& c = g.csr_view();
+        spanning_forest expected = minimum_spanning_forest(c, mst_algorithm::kruskal, 1);
+        dsu d(c.size());
+        for (const forest_edge& e : expected.edges) {
+            REQUIRE(!d.same(e.u, e.v));
+            d.join(e.u, e.v);
+        }
+        size_t components = 0;
+        for (uint32_t u = 0; u < c.size(); u++) {
+            components += d.find(u) == u;
+        }
+        REQUIRE(expected.edges.size() + components == c.size());
+        for (size_t threads : {1, 4}) {
+            for (mst_algorithm algo : {mst_algorithm::kruskal, mst_algorithm::boruvka}) {
+                spanning_forest forest = minimum_spanning_forest(c, algo, threads);
+                REQUIRE(forest.edges.size() == expected.edges.size());
+                REQUIRE(forest.weight == expected.weight);
+            }
+        }
+    }
+}
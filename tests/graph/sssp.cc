@@ -0,0 +1,104 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/sssp.h"
+#include "../../src/classes/heap/pairing_heap.h"
+#include "../../src/classes/heap/radix_heap.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+namespace {
+void check_parents(const csr_graph<int>& c, uint32_t s, const sssp_tree& tree) {
+    REQUIRE(tree.parent.size() == c.size());
+    REQUIRE(tree.parent[s] == s);
+    for (uint32_t v = 0; v < c.size(); v++) {
+        if (v == s) {
+            continue;
+        }
+        if (tree.dist[v] == std::numeric_limits<double>::infinity()) {
+            REQUIRE(tree.parent[v] == csr_graph<int>::npos);
+            continue;
+        }
+        uint32_t p = tree.parent[v];
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t e = c.offsets()[p]; e < c.offsets()[p + 1]; e++) {
+            if (c.targets()[e] == v) {
+                best = std::min(best, c.weight(e));
+            }
+        }
+        REQUIRE(tree.dist[p] + best == tree.dist[v]);
+    }
+}
+} // namespace
+
+TEST_CASE("testing sssp in weighted graph") {
+    weighted_graph<int> g("undirected");
+    g.add_edge(1, 2, 5);
+    g.add_edge(3, 4, 1);
+    g.add_edge(2, 5, 10);
+    g.add_edge(5, 8, 10);
+    g.add_edge(4, 8, 5);
+    g.add_edge(2, 3, 1);
+    g.add_edge(9, 10, 1);
+
+    const csr_graph<int>& c = g.csr_view();
+    for (sssp_options opt :
+         {sssp_options{}, sssp_options{4, 0, true}, sssp_options{2, 2.5, true}}) {
+        sssp_tree tree = g.sssp(1, opt);
+        REQUIRE(tree.dist[c.id(8)] == 12);
+        REQUIRE(tree.dist[c.id(5)] == 15);
+        REQUIRE(tree.dist[c.id(9)] == std::numeric_limits<double>::infinity());
+        REQUIRE(tree.parent[c.id(8)] == c.id(4));
+        check_parents(c, c.id(1), tree);
+    }
+    REQUIRE(g.sssp(1, {1, 0, false}).parent.empty());
+    REQUIRE(g.sssp(42).dist.empty());
+}
+
+TEST_CASE("testing delta stepping against dijkstra") {
+    std::mt19937 rng(5);
+    for (const char* type : {"undirected", "directed"}) {
+        const int n = 1500;
+        weighted_graph<int> g(type);
+        std::uniform_int_distribution<int> pick(0, n - 1), weight(0, 20);
+        for (int i = 0; i < 6000; i++) {
+            g.add_edge(pick(rng), pick(rng), weight(rng));
+        }
+        const csr_graph<int>& c = g.csr_view();
+        uint32_t s = c.id(0) == csr_graph<int>::npos ? 0 : c.id(0);
+        sssp_tree expected = sssp(c, s);
+        for (size_t threads : {1, 4}) {
+            for (double delta : {0.0, 0.5, 7.0, 1000.0}) {
+                sssp_tree tree = sssp(c, s, {threads, delta, true});
+                REQUIRE(tree.dist == expected.dist);
+                check_parents(c, s, tree);
+            }
+        }
+    }
+}
+
+TEST_CASE("testing sssp heap policies") {
+    std::mt19937 rng(33);
+    const int n = 2000;
+    weighted_graph<int> g("directed");
+    std::uniform_int_distribution<int> pick(0, n - 1), weight(0, 1000);
+    for (int i = 0; i < 10000; i++) {
+        g.add_edge(pick(rng), pick(rng), weight(rng));
+    }
+    const csr_graph<int>& c = g.csr_view();
+    uint32_t s = c.id(0) == csr_graph<int>::npos ? 0 : c.id(0);
+    sssp_tree expected = sssp(c, s);
+    sssp_tree radix = sssp<radix_heap<uint64_t>>(c, s);
+    sssp_tree pairing = sssp<pairing_heap<double>>(c, s);
+    REQUIRE(radix.dist == expected.dist);
+    REQUIRE(pairing.dist == expected.dist);
+    check_parents(c, s, radix);
+    check_parents(c, s, pairing);
+    for (int t = 0; t < 50; t++) {
+        int a = pick(rng), b = pick(rng);
+        if (c.id(a) == csr_graph<int>::npos || c.id(b) == csr_graph<int>::npos) {
+            continue;
+        }
+        double d = c.shortest_path(a, b);
+        REQUIRE(c.shortest_path<radix_heap<uint32_t>>(a, b) == d);
+        REQUIRE(c.shortest_path<pairing_heap<double>>(a, b) == d);
+    }
+}
@@ -0,0 +1,80 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/traversal.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+
+TEST_CASE("testing lazy bfs and dfs") {
+    graph<int> g("directed");
+    g.add_edge(1, 2);
+    g.add_edge(1, 3);
+    g.add_edge(2, 4);
+    g.add_edge(3, 4);
+    g.add_edge(4, 5);
+    g.add_edge(6, 1);
+
+    std::vector<int> order;
+    for (int v : g.traverse(1)) {
+        order.push_back(v);
+    }
+    REQUIRE(order == g.bfs(1));
+
+    const csr_graph<int>& c = g.csr_view();
+    std::vector<int> discovered, finished;
+    lazy_traversal<int> dfs(c, 1, traversal_order::dfs);
+    dfs.on_discover([&](uint32_t u) { discovered.push_back(c.vertex(u)); })
+        .on_finish([&](uint32_t u) { finished.push_back(c.vertex(u)); });
+    order.clear();
+    std::vector<size_t> depth;
+    while (dfs.next()) {
+        order.push_back(c.vertex(dfs.current()));
+        depth.push_back(dfs.depth());
+    }
+    REQUIRE(order == std::vector<int>{1, 2, 4, 5, 3});
+    REQUIRE(depth == std::vector<size_t>{0, 1, 2, 3, 1});
+    REQUIRE(discovered == order);
+    REQUIRE(finished == std::vector<int>{5, 4, 2, 3, 1});
+    REQUIRE(!dfs.next());
+
+    dfs.restart(6);
+    REQUIRE(dfs.next());
+    REQUIRE(c.vertex(dfs.current()) == 6);
+    REQUIRE(g.traverse(42).begin() == std::default_sentinel);
+}
+
+TEST_CASE("testing early termination of lazy traversals") {
+    graph<int> g("undirected");
+    const int n = 100000;
+    for (int i = 0; i + 1 < n; i++) {
+        g.add_edge(i, i + 1);
+        g.add_edge(i, (i * 7919) % n);
+    }
+    size_t discovered = 0;
+    lazy_traversal<int> bfs = g.traverse(0);
+    bfs.on_discover([&](uint32_t) { discovered++; });
+    size_t seen = 0;
+    for ([[maybe_unused]] int v : bfs) {
+        if (++seen == 10) {
+            break;
+        }
+    }
+    // only the vertices yielded so far were expanded
+    REQUIRE(discovered < 40);
+
+    std::mt19937 rng(19);
+    graph<int> r("undirected");
+    for (int i = 0; i < 3000; i++) {
+        r.add_edge(rng() % 500, rng() % 500);
+    }
+    std::vector<int> all;
+    for (int v : r.traverse(r.bfs(0).front())) {
+        all.push_back(v);
+    }
+    REQUIRE(all == r.bfs(0));
+    std::vector<int> dfs;
+    for (int v : r.traverse(0, traversal_order::dfs)) {
+        dfs.push_back(v);
+    }
+    std::sort(dfs.begin(), dfs.end());
+    std::sort(all.begin(), all.end());
+    REQUIRE(dfs == all);
+}
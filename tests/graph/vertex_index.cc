@@ -0,0 +1,46 @@
+#include "../../src/classes/graph/graph.h"
+#include "../../src/classes/graph/vertex_index.h"
+#include "../../third_party/catch.hpp"
+#include <string>
+
+TEST_CASE("testing vertex interning") {
+    vertex_index<std::string> ids;
+    REQUIRE(ids.intern("a") == 0);
+    REQUIRE(ids.intern("b") == 1);
+    REQUIRE(ids.intern("a") == 0);
+    REQUIRE(ids.size() == 2);
+    REQUIRE(ids.id("b") == 1);
+    REQUIRE(ids.id("c") == vertex_index<std::string>::npos);
+    REQUIRE(ids.contains("c") == false);
+    REQUIRE(ids.vertex(1) == "b");
+    ids.clear();
+    REQUIRE(ids.size() == 0);
+}
+
+TEST_CASE("testing graph workspace epochs") {
+    graph_workspace ws;
+    ws.begin(4);
+    REQUIRE(ws.try_visit(2) == true);
+    REQUIRE(ws.try_visit(2) == false);
+    REQUIRE(ws.visited(2) == true);
+    ws.begin(6);
+    REQUIRE(ws.visited(2) == false);
+    REQUIRE(ws.in().size() == 6);
+    REQUIRE(ws.frontier().empty() == true);
+}
+
+TEST_CASE("testing repeated traversals reuse the workspace") {
+    graph<int> g("undirected");
+    g.add_edge(1, 2);
+    g.add_edge(2, 3);
+    g.add_edge(4, 5);
+    std::vector<int> first = g.bfs(1);
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(g.bfs(1) == first);
+        REQUIRE(g.dfs(4) == std::vector<int>{4, 5});
+        REQUIRE(g.connected_components() == 2);
+    }
+    g.add_edge(3, 4);
+    REQUIRE(g.connected_components() == 1);
+    REQUIRE(g.bfs(1).size() == 5);
+}
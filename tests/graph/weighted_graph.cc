@@ -372,6 +372,17 @@ TEST_CASE("Testing scc function for weighted graph class") {
 //     }
 // }
 
+TEST_CASE("Testing compile time direction policies for weighted graph class") {
+    directed_weighted_graph<int> d({{{1, 2}, 4}, {{2, 3}, -1}});
+    undirected_weighted_graph<int> u({{{1, 2}, 4}, {{2, 3}, 1}});
+    REQUIRE(d.shortest_path(1, 3) == 3);
+    REQUIRE(d.shortest_path(3, 1) == -1);
+    REQUIRE(u.shortest_path(3, 1) == 5);
+    REQUIRE(d.csr_view().directed());
+    REQUIRE(!u.csr_view().directed());
+    REQUIRE(u.bellman_ford(3)[1] == 5);
+}
+
 #define GRAPH_VISUALIZATION_H
 
 #ifdef GRAPH_VISUALIZATION_H
@@ -0,0 +1,89 @@
+#include "../../src/classes/hash_table/bloom_filter.h"
+#include "../../third_party/catch.hpp"
+#include <numeric>
+#include <string>
+#include <vector>
+
+TEST_CASE("testing the sizing helpers of the bloom filters") {
+    REQUIRE(bloom_bits_per_key(0.01) == Approx(9.585).epsilon(0.001));
+    REQUIRE(bloom_hashes(bloom_bits_per_key(0.01)) == 7);
+    REQUIRE(bloom_false_positive_rate(9586, 1000, 7) == Approx(0.01).epsilon(0.05));
+    REQUIRE(bloom_false_positive_rate(0, 10, 3) == 1);
+    REQUIRE_THROWS_AS(bloom_bits_per_key(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(blocked_bloom_blocks(10, 1.5), std::invalid_argument);
+    for (double fpr : {0.1, 0.01, 0.001}) {
+        size_t blocks = blocked_bloom_blocks(100000, fpr);
+        REQUIRE(blocked_bloom_false_positive_rate(blocks, 100000) <= fpr);
+        REQUIRE(blocked_bloom_false_positive_rate(blocks - 1, 100000) > fpr);
+        // a few more bits than the classic filter, not many more
+        REQUIRE(double(blocks) * 256 >= 100000 * bloom_bits_per_key(fpr));
+        REQUIRE(double(blocks) * 256 <= 1.6 * 100000 * bloom_bits_per_key(fpr));
+    }
+    REQUIRE(blocked_bloom_blocks(0, 0.01) == 1);
+}
+
+TEST_CASE("testing bloom_filter") {
+    std::vector<uint64_t> keys(20000);
+    std::iota(keys.begin(), keys.end(), 0);
+    bloom_filter<uint64_t> f = bloom_filter<uint64_t>::build(keys, 0.01);
+    REQUIRE(f.size() == keys.size());
+    REQUIRE(f.hashes() == 7);
+    for (uint64_t k : keys) {
+        REQUIRE(f.contains(k));
+    }
+    size_t false_positives = 0;
+    for (uint64_t k = 1000000; k < 1100000; k++) {
+        false_positives += f.contains(k);
+    }
+    REQUIRE(double(false_positives) / 100000 < 0.015);
+    REQUIRE(f.false_positive_rate() == Approx(0.01).epsilon(0.1));
+    REQUIRE(f.memory_usage().node_overhead == f.bits() / 8);
+    f.clear();
+    REQUIRE(f.size() == 0);
+    REQUIRE(!f.contains(1));
+
+    bloom_filter<std::string> words(3, 0.001);
+    words.insert(std::string("apple"));
+    words.insert(std::string("fig"));
+    REQUIRE(words.contains("apple"));
+    REQUIRE(words.contains("fig"));
+}
+
+TEST_CASE("testing blocked_bloom_filter on every instruction set") {
+    std::vector<uint64_t> keys(50000), others(100000);
+    std::iota(keys.begin(), keys.end(), 7);
+    std::iota(others.begin(), others.end(), 10000000);
+    for (SIMD::isa i : {SIMD::isa::scalar, SIMD::isa::avx2}) {
+        if (!SIMD::supported(i)) {
+            continue;
+        }
+        SIMD::scoped_isa forced(i);
+        auto f = blocked_bloom_filter<uint64_t>::build(keys, 0.01);
+        REQUIRE(f.size() == keys.size());
+        REQUIRE(f.blocks() == blocked_bloom_blocks(keys.size(), 0.01));
+        for (uint64_t k : keys) {
+            REQUIRE(f.contains(k));
+        }
+        std::vector<bool> all = f.contains(keys);
+        REQUIRE(std::count(all.begin(), all.end(), true) == long(keys.size()));
+        std::vector<bool> found = f.contains(others);
+        size_t false_positives = 0;
+        for (size_t j = 0; j < others.size(); j++) {
+            REQUIRE(found[j] == f.contains(others[j]));
+            false_positives += found[j];
+        }
+        REQUIRE(double(false_positives) / double(others.size()) < 0.015);
+
+        // the kernels of every instruction set set the same bits
+        blocked_bloom_filter<uint64_t> g(keys.size(), 0.01);
+        {
+            SIMD::scoped_isa scalar(SIMD::isa::scalar);
+            for (uint64_t k : keys) {
+                g.insert(k);
+            }
+        }
+        for (uint64_t k : others) {
+            REQUIRE(g.contains(k) == f.contains(k));
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "../../src/classes/hash_table/concurrent_hash_table.h"
+#include "../../third_party/catch.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+
+TEST_CASE("checking insertions, retrievals and removals in concurrent hash table") {
+    concurrent_hash_table<std::string, int> table(5);
+    REQUIRE(table.shards() == 8);
+    table.insert("abc", 1);
+    table.insert("abc", 2);
+    table.insert("def", 3);
+    REQUIRE(table.retrieve("abc") == 2);
+    REQUIRE(table.retrieve("ghi") == std::nullopt);
+    REQUIRE(table.size() == 2);
+
+    int seen = 0;
+    REQUIRE(table.visit("def", [&](const int& v) { seen = v; }));
+    REQUIRE(seen == 3);
+    REQUIRE(!table.visit("xyz", [&](const int&) { seen = -1; }));
+    REQUIRE(table.upsert("abc", [](int& v) { v += 40; }) == false);
+    REQUIRE(table.upsert("new", [](int& v) { v += 1; }) == true);
+    REQUIRE(table.retrieve("abc") == 42);
+    REQUIRE(table.retrieve("new") == 1);
+    table.remove("abc");
+    REQUIRE(!table.contains("abc"));
+    int total = 0;
+    table.for_each([&](const std::string&, const int& v) { total += v; });
+    REQUIRE(total == 4);
+    table.clear();
+    REQUIRE(table.size() == 0);
+    REQUIRE(concurrent_hash_table<int, int>(1).shards() == 1);
+}
+
+TEST_CASE("checking concurrent upserts and reads in concurrent hash table") {
+    concurrent_hash_table<int, int64_t> table;
+    const int threads = 8, keys = 1000, rounds = 20;
+    std::vector<std::thread> workers;
+    std::atomic<bool> bad_read{false};
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (int r = 0; r < rounds; r++) {
+                for (int k = 0; k < keys; k++) {
+                    table.upsert(k, [](int64_t& v) { v++; });
+                    std::optional<int64_t> v = table.retrieve((k + t) % keys);
+                    if (v && (*v < 1 || *v > threads * rounds)) {
+                        bad_read = true;
+                    }
+                }
+                table.insert(keys + t, r);
+                table.remove(keys + t);
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    REQUIRE(!bad_read);
+    REQUIRE(table.size() == size_t(keys));
+    for (int k = 0; k < keys; k++) {
+        REQUIRE(table.retrieve(k) == threads * rounds);
+    }
+}
@@ -0,0 +1,60 @@
+#include "../../src/classes/hash_table/cuckoo_filter.h"
+#include "../../third_party/catch.hpp"
+#include <numeric>
+#include <vector>
+
+TEST_CASE("testing cuckoo_filter inserts, lookups and removals") {
+    std::vector<uint64_t> keys(30000);
+    std::iota(keys.begin(), keys.end(), 1);
+    cuckoo_filter<uint64_t> f = cuckoo_filter<uint64_t>::build(keys);
+    REQUIRE(f.size() == keys.size());
+    REQUIRE(f.load_factor() <= 0.95);
+    for (uint64_t k : keys) {
+        REQUIRE(f.contains(k));
+    }
+    size_t false_positives = 0;
+    for (uint64_t k = 1000000; k < 1200000; k++) {
+        false_positives += f.contains(k);
+    }
+    REQUIRE(double(false_positives) / 200000 < 0.001);
+    REQUIRE(cuckoo_false_positive_rate(16) < 0.0002);
+    REQUIRE(cuckoo_false_positive_rate(8) == Approx(0.0294).epsilon(0.01));
+
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        REQUIRE(f.remove(keys[i]));
+    }
+    REQUIRE(f.size() == keys.size() / 2);
+    for (size_t i = 1; i < keys.size(); i += 2) {
+        REQUIRE(f.contains(keys[i]));
+    }
+    size_t still = 0;
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        still += f.contains(keys[i]);
+    }
+    REQUIRE(still < 20);
+    f.clear();
+    REQUIRE(f.size() == 0);
+    REQUIRE(!f.contains(2));
+    REQUIRE(!f.remove(2));
+}
+
+TEST_CASE("testing a full cuckoo_filter") {
+    cuckoo_filter<uint32_t, std::hash<uint32_t>, uint8_t> f(100);
+    size_t inserted = 0;
+    uint32_t k = 0;
+    while (f.insert(k)) {
+        inserted++;
+        k++;
+    }
+    REQUIRE(inserted == f.size());
+    REQUIRE(f.load_factor() > 0.8);
+    REQUIRE(f.load_factor() <= 1.0);
+    // no key that went in is lost, the one kicked out last included
+    for (uint32_t x = 0; x < k; x++) {
+        REQUIRE(f.contains(x));
+    }
+    REQUIRE(f.remove(0));
+    REQUIRE(f.insert(k));
+    REQUIRE(f.contains(k));
+    REQUIRE(f.memory_usage().node_overhead == f.capacity());
+}
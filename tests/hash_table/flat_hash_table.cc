@@ -0,0 +1,86 @@
+#include "../../src/classes/hash_table/flat_hash_table.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+#include <string>
+#include <unordered_map>
+
+TEST_CASE("checking insertions, overriding insertions and retrievals in flat hash table") {
+    flat_hash_table<std::string, int> table;
+    REQUIRE(table.retrieve("abc") == std::nullopt);
+
+    table.insert("abc", 1);
+    table.insert("abc", 2);
+    table.insert("def", 3);
+
+    REQUIRE(table.retrieve("abc") == 2);
+    REQUIRE(table.retrieve("ghi") == std::nullopt);
+    REQUIRE(table.size() == 2);
+
+    table.remove("abc");
+    table.remove("xyz");
+    REQUIRE(table.retrieve("abc") == std::nullopt);
+    REQUIRE(table.retrieve("def") == 3);
+    REQUIRE(table.size() == 1);
+}
+
+TEST_CASE("checking flat hash table against unordered_map") {
+    std::mt19937 rng(26);
+    flat_hash_table<uint64_t, uint64_t> table;
+    std::unordered_map<uint64_t, uint64_t> expected;
+    for (int op = 0; op < 200000; op++) {
+        // few distinct keys so that removals leave many tombstones behind
+        uint64_t key = (rng() % 5000) << 20;
+        switch (rng() % 3) {
+        case 0:
+            table.insert(key, op);
+            expected[key] = op;
+            break;
+        case 1:
+            table.remove(key);
+            expected.erase(key);
+            break;
+        default:
+            auto it = expected.find(key);
+            REQUIRE(table.retrieve(key) ==
+                    (it == expected.end() ? std::nullopt : std::optional<uint64_t>(it->second)));
+        }
+    }
+    REQUIRE(table.size() == expected.size());
+    size_t seen = 0;
+    for (auto& [key, value] : table) {
+        REQUIRE(expected.at(key) == value);
+        seen++;
+    }
+    REQUIRE(seen == expected.size());
+    REQUIRE(table.capacity() <= 4 * 8192);
+}
+
+TEST_CASE("testing copies, moves and reserve in flat hash table") {
+    flat_hash_table<int, std::string> table({{1, "abc"}, {2, "bcd"}, {3, "cba"}});
+    flat_hash_table<int, std::string> copy(table);
+    flat_hash_table<int, std::string> assigned;
+    assigned = table;
+    for (int i = 1; i <= 3; i++) {
+        REQUIRE(copy.retrieve(i) == table.retrieve(i));
+        REQUIRE(assigned.retrieve(i) == table.retrieve(i));
+    }
+    flat_hash_table<int, std::string> moved(std::move(copy));
+    REQUIRE(moved.retrieve(2) == "bcd");
+    REQUIRE(copy.empty());
+
+    flat_hash_table<int, int> big;
+    big.reserve(100000);
+    size_t slots = big.capacity();
+    for (int i = 0; i < 100000; i++) {
+        big.insert(i, -i);
+    }
+    REQUIRE(big.capacity() == slots);
+    REQUIRE(big.size() == 100000);
+    REQUIRE(big.retrieve(4242) == -4242);
+    big.clear();
+    REQUIRE(big.empty());
+    REQUIRE(!big.contains(4242));
+    for (auto& x : big) {
+        FAIL(x.first);
+    }
+}
@@ -0,0 +1,89 @@
+#include "../../src/classes/hash_table/hash_snapshot.h"
+#include "../../third_party/catch.hpp"
+#include <filesystem>
+#include <random>
+#include <unordered_map>
+
+namespace {
+struct record {
+    uint32_t id;
+    double score;
+};
+} // namespace
+
+TEST_CASE("testing hash snapshot round trip") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_hash.bin";
+    std::mt19937_64 rng(30);
+    std::unordered_map<uint64_t, record> expected;
+    std::vector<std::pair<uint64_t, record>> pairs;
+    while (pairs.size() < 20000) {
+        uint64_t key = rng();
+        if (expected.emplace(key, record{uint32_t(pairs.size()), key / 3.0}).second) {
+            pairs.emplace_back(key, expected[key]);
+        }
+    }
+    save_hash_snapshot(pairs, path.string());
+    // one key and one value per pair, plus a 4 byte pilot per 4 pairs
+    REQUIRE(std::filesystem::file_size(path) <= 20000 * (8 + sizeof(record) + 1) + 128);
+
+    hash_snapshot_view<uint64_t, record> view(path.string());
+    REQUIRE(view.size() == 20000);
+    REQUIRE(view.capacity() == 20000);
+    for (const auto& [key, value] : expected) {
+        const record* found = view.find(key);
+        REQUIRE(found != nullptr);
+        REQUIRE(found->id == value.id);
+        REQUIRE(found->score == value.score);
+        REQUIRE(view.find(key) == found);
+    }
+    for (int i = 0; i < 20000; i++) {
+        uint64_t key = rng();
+        REQUIRE(view.contains(key) == expected.count(key));
+    }
+    REQUIRE(view.retrieve(pairs[7].first)->id == 7);
+    REQUIRE_THROWS_AS((hash_snapshot_view<uint64_t, uint64_t>(path.string())),
+                      std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("testing hash snapshot with free slots") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_hash.sparse";
+    flat_hash_table<int32_t, int32_t> table;
+    for (int32_t i = 1; i <= 1000; i++) {
+        table.insert(i * 7, -i);
+    }
+    save_hash_snapshot(table, path.string(), 0.5);
+    {
+        hash_snapshot_view<int32_t, int32_t> view(path.string());
+        REQUIRE(view.size() == 1000);
+        REQUIRE(view.capacity() == 2000);
+        for (int32_t i = 1; i <= 1000; i++) {
+            REQUIRE(view.retrieve(i * 7) == -i);
+            REQUIRE(!view.contains(i * 7 + 1));
+        }
+        // free slots hold a copy of a stored key, which must not match there
+        REQUIRE(!view.contains(0));
+    }
+    REQUIRE_THROWS_AS(save_hash_snapshot(table, path.string(), 0.0), std::invalid_argument);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("testing hash snapshot edge cases") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_hash.edge";
+    save_hash_snapshot(std::vector<std::pair<int, char>>{}, path.string());
+    {
+        hash_snapshot_view<int, char> view(path.string());
+        REQUIRE(view.empty());
+        REQUIRE(view.find(0) == nullptr);
+    }
+    save_hash_snapshot(std::vector<std::pair<int, char>>{{5, 'a'}}, path.string());
+    {
+        hash_snapshot_view<int, char> view(path.string());
+        REQUIRE(view.retrieve(5) == 'a');
+        REQUIRE(!view.contains(6));
+    }
+    std::vector<std::pair<int, char>> dup = {{1, 'a'}, {2, 'b'}, {1, 'c'}};
+    REQUIRE_THROWS_AS(save_hash_snapshot(dup, path.string()), std::invalid_argument);
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS((hash_snapshot_view<int, char>(path.string())), std::runtime_error);
+}
@@ -1,6 +1,7 @@
 #include "../../src/classes/hash_table/hash_table.h"
 #include "../../third_party/catch.hpp"
 #include <list>
+#include <sstream>
 #include <string>
 
 TEST_CASE("checking insertions, overriding insertions and retrievals in hash table") {
@@ -146,3 +147,125 @@ TEST_CASE("Testing iterator -- for hash table class") {
     CHECK_NOTHROW(it--);
     CHECK_NOTHROW(it--);
 }
+
+TEST_CASE("checking non mutating and heterogeneous lookups in hash table") {
+    hash_table<std::string, int> table;
+    table.insert("abc", 1);
+    table.insert("def", 2);
+    std::ostringstream before;
+    before << table;
+
+    for (int i = 0; i < 1000; i++) {
+        std::string miss = "miss" + std::to_string(i);
+        REQUIRE(table.find(std::string_view(miss)) == nullptr);
+        REQUIRE(!table.retrieve(miss));
+        table.remove(miss);
+    }
+    std::ostringstream after;
+    after << table;
+    REQUIRE(before.str() == after.str());
+
+    std::string_view key = "abc";
+    int* value = table.find(key);
+    REQUIRE(value != nullptr);
+    *value = 10;
+    REQUIRE(table.retrieve("abc") == 10);
+    REQUIRE(table.contains("def"));
+    const hash_table<std::string, int>& view = table;
+    REQUIRE(*view.find(std::string("def")) == 2);
+    table.remove(std::string_view("def"));
+    REQUIRE(!table.contains("def"));
+
+    hash_table<int64_t, std::string> numbers;
+    numbers.insert(5, "five");
+    REQUIRE(numbers.retrieve(5) == "five");
+    REQUIRE(numbers.find(6) == nullptr);
+}
+
+TEST_CASE("checking reserve, load factor and incremental rehash in hash table") {
+    hash_table<int, int> table;
+    table.max_load_factor(2.0);
+    REQUIRE(table.max_load_factor() == 2.0);
+    REQUIRE_THROWS(table.max_load_factor(0));
+    table.reserve(1000);
+    size_t buckets = table.bucket_count();
+    REQUIRE(buckets * 2 >= 1000);
+    const int limit = static_cast<int>(buckets * 2);
+    for (int i = 0; i < limit; i++) {
+        table.insert(i, i);
+    }
+    REQUIRE(table.bucket_count() == buckets);
+    REQUIRE(!table.rehashing());
+
+    // the next insertion starts an incremental rehash, lookups see both arrays
+    bool started = false;
+    for (int i = limit; i < limit + 10; i++) {
+        table.insert(i, i);
+        started |= table.rehashing();
+        for (int k = 0; k <= i; k += 97) {
+            REQUIRE(table.retrieve(k) == k);
+        }
+    }
+    REQUIRE(started);
+    REQUIRE(table.bucket_count() == 2 * buckets);
+    int* stable = table.find(5);
+    for (int i = limit + 10; i < 3000; i++) {
+        table.insert(i, i);
+        if (i % 3 == 0) {
+            table.remove(i / 3);
+        }
+    }
+    REQUIRE(stable == table.find(5));
+    std::vector<int> keys;
+    for (auto it = table.begin(); it != table.end(); it++) {
+        keys.push_back((*it).first);
+    }
+    REQUIRE(keys.size() == table.size());
+    REQUIRE(table.load_factor() <= 2.0);
+
+    table.rehash(4096);
+    REQUIRE(!table.rehashing());
+    REQUIRE(table.bucket_count() == 4096);
+    hash_table_stats s = table.stats();
+    REQUIRE(s.size == table.size());
+    REQUIRE(s.buckets == 4096);
+    size_t in_buckets = 0, total = 0;
+    for (size_t k = 0; k < s.occupancy.size(); k++) {
+        in_buckets += k * s.occupancy[k];
+        total += s.occupancy[k];
+    }
+    REQUIRE(in_buckets == table.size());
+    REQUIRE(total == 4096);
+    REQUIRE(s.empty_buckets == s.occupancy[0]);
+    size_t found = 0;
+    for (size_t p : s.probes) {
+        found += p;
+    }
+    REQUIRE(found == table.size());
+    REQUIRE(s.average_probes >= 1);
+}
+
+namespace {
+struct constant_key {
+    int v;
+    bool operator==(const constant_key& o) const { return v == o.v; }
+    friend std::ostream& operator<<(std::ostream& out, const constant_key& k) { return out << k.v; }
+};
+} // namespace
+
+template <> struct std::hash<constant_key> {
+    size_t operator()(const constant_key&) const { return 7; }
+};
+
+TEST_CASE("checking that stats expose a bad hash function in hash table") {
+    hash_table<constant_key, int> table;
+    for (int i = 0; i < 100; i++) {
+        table.insert({i}, i);
+    }
+    hash_table_stats s = table.stats();
+    REQUIRE(s.occupancy.size() == 101);
+    REQUIRE(s.occupancy[100] == 1);
+    REQUIRE(s.probes.size() == 100);
+    REQUIRE(s.average_probes == 50.5);
+    REQUIRE(table.retrieve({42}) == 42);
+}
@@ -0,0 +1,68 @@
+#include "../../src/classes/hash_table/static_map.h"
+#include "../../third_party/catch.hpp"
+#include <array>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+enum class keyword { IF, ELSE, WHILE, FOR, RETURN, BREAK, CONTINUE, SWITCH, CASE };
+
+constexpr auto keywords = make_static_map<std::string_view, keyword>(
+    {{"if", keyword::IF}, {"else", keyword::ELSE}, {"while", keyword::WHILE},
+     {"for", keyword::FOR}, {"return", keyword::RETURN}, {"break", keyword::BREAK},
+     {"continue", keyword::CONTINUE}, {"switch", keyword::SWITCH}, {"case", keyword::CASE}});
+
+constexpr std::array<std::pair<uint64_t, uint64_t>, 1000> squares() {
+    std::array<std::pair<uint64_t, uint64_t>, 1000> a{};
+    for (uint64_t i = 0; i < 1000; i++) {
+        a[i] = {i * 1000003, i * i};
+    }
+    return a;
+}
+} // namespace
+
+TEST_CASE("testing a keyword table built at compile time") {
+    static_assert(keywords.size() == 9);
+    static_assert(keywords.at("while") == keyword::WHILE);
+    static_assert(keywords.contains("case") && !keywords.contains("do"));
+    static_assert(keywords.find("") == nullptr);
+
+    const std::string word = "continue";
+    REQUIRE(*keywords.find(word) == keyword::CONTINUE);
+    REQUIRE(keywords.find("els") == nullptr);
+    REQUIRE(keywords.find("elsewhere") == nullptr);
+    REQUIRE_THROWS_AS(keywords.at("goto"), std::out_of_range);
+    std::set<std::string_view> seen;
+    for (const auto& [key, value] : keywords) {
+        REQUIRE(keywords.at(key) == value);
+        seen.insert(key);
+    }
+    REQUIRE(seen.size() == 9);
+}
+
+TEST_CASE("testing a larger static map") {
+    static constexpr static_map<uint64_t, uint64_t, 1000> map(squares());
+    static_assert(map.at(7 * 1000003) == 49);
+    for (uint64_t i = 0; i < 1000; i++) {
+        REQUIRE(map.at(i * 1000003) == i * i);
+        REQUIRE(!map.contains(i * 1000003 + 1));
+    }
+
+    // a map can also be built at run time, from keys known only then
+    std::array<std::pair<std::string, int>, 300> words;
+    for (int i = 0; i < 300; i++) {
+        words[i] = {"word" + std::to_string(i), i};
+    }
+    static_map<std::string, int, 300> runtime(words);
+    for (int i = 0; i < 300; i++) {
+        REQUIRE(runtime.at("word" + std::to_string(i)) == i);
+    }
+    REQUIRE(!runtime.contains("word300"));
+
+    std::array<std::pair<int, int>, 3> duplicates{{{1, 1}, {2, 2}, {1, 3}}};
+    REQUIRE_THROWS_AS((static_map<int, int, 3>(duplicates)), std::invalid_argument);
+    static constexpr static_map<int, int, 0> empty(std::array<std::pair<int, int>, 0>{});
+    static_assert(!empty.contains(1) && empty.size() == 0);
+}
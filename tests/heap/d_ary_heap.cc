@@ -0,0 +1,67 @@
+#include "../../src/classes/heap/d_ary_heap.h"
+#include "../../src/classes/heap/min_heap.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+
+TEST_CASE("testing d-ary heap ordering and growth") {
+    std::mt19937 rng(31);
+    std::vector<int> values(5000);
+    for (int& x : values) {
+        x = static_cast<int>(rng() % 1000);
+    }
+    d_ary_heap<int> heap;
+    for (int x : values) {
+        heap.push(x);
+    }
+    REQUIRE(heap.size() == values.size());
+    std::sort(values.begin(), values.end());
+    for (int x : values) {
+        REQUIRE(heap.top() == x);
+        REQUIRE(heap.pop() == x);
+    }
+    REQUIRE(heap.empty());
+    REQUIRE_THROWS_AS(heap.top(), std::out_of_range);
+    REQUIRE_THROWS_AS(heap.pop(), std::out_of_range);
+}
+
+TEST_CASE("testing d-ary heap comparator, arity and bulk construction") {
+    std::mt19937 rng(32);
+    std::vector<double> values(3001);
+    for (double& x : values) {
+        x = (rng() % 100000) / 7.0;
+    }
+    d_ary_heap<double, std::greater<double>, 8> heap(values);
+    REQUIRE(heap.size() == values.size());
+    for (size_t i = 1; i < heap.data().size(); i++) {
+        REQUIRE(heap.data()[(i - 1) / 8] >= heap.data()[i]);
+    }
+    std::sort(values.begin(), values.end(), std::greater<double>());
+    for (double x : values) {
+        REQUIRE(heap.pop() == x);
+    }
+
+    d_ary_heap<std::pair<int, std::string>, std::less<>, 2> jobs;
+    jobs.make_heap(std::vector<std::pair<int, std::string>>{{3, "c"}, {1, "a"}});
+    jobs.emplace(2, "b");
+    REQUIRE(jobs.pop().second == "a");
+    REQUIRE(jobs.pop().second == "b");
+    REQUIRE(jobs.pop().second == "c");
+}
+
+TEST_CASE("testing min heap growth and removal") {
+    min_heap<double> heap(2);
+    for (double x : {5.5, 1.25, 9.0, 3.0, 7.75}) {
+        heap.insert(x);
+    }
+    REQUIRE(heap.size() == 5);
+    REQUIRE(heap.min() == 1.25);
+    heap.remove(0);
+    REQUIRE(heap._min() == 3.0);
+    REQUIRE(heap._min() == 5.5);
+    REQUIRE(heap._min() == 7.75);
+    REQUIRE(heap._min() == 9.0);
+    REQUIRE(heap._min() == std::numeric_limits<double>::max());
+    REQUIRE_THROWS_AS(heap.remove(0), std::out_of_range);
+}
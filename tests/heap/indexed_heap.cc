@@ -0,0 +1,82 @@
+#include "../../src/classes/heap/indexed_heap.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+
+TEST_CASE("testing indexed heap decrease key") {
+    indexed_heap<double> h(5);
+    REQUIRE(h.empty());
+    h.push(0, 5);
+    h.push(1, 3);
+    h.push(2, 4);
+    REQUIRE(h.top() == 1);
+    REQUIRE(h.push(0, 1) == true);
+    REQUIRE(h.push(2, 10) == false);
+    REQUIRE(h.size() == 3);
+    REQUIRE(h.key(2) == 4);
+    REQUIRE(h.pop() == 0);
+    REQUIRE(h.pop() == 1);
+    REQUIRE(h.contains(2));
+    REQUIRE(!h.contains(1));
+    h.clear();
+    REQUIRE(h.empty());
+    REQUIRE(!h.contains(2));
+    h.push(2, 7);
+    REQUIRE(h.top_key() == 7);
+}
+
+TEST_CASE("testing indexed heap against sorting") {
+    const size_t n = 2000;
+    std::mt19937 rng(21);
+    std::vector<double> key(n);
+    indexed_heap<double> h(n);
+    for (uint32_t i = 0; i < n; i++) {
+        key[i] = rng() % 100000;
+        h.push(i, key[i]);
+    }
+    for (int k = 0; k < 5000; k++) {
+        uint32_t i = rng() % n;
+        double lower = key[i] - rng() % 1000;
+        h.push(i, lower);
+        key[i] = std::min(key[i], lower);
+    }
+    std::vector<double> popped;
+    while (!h.empty()) {
+        popped.push_back(key[h.top()]);
+        REQUIRE(h.top_key() == key[h.top()]);
+        h.pop();
+    }
+    std::sort(key.begin(), key.end());
+    REQUIRE(popped == key);
+}
+
+TEST_CASE("testing indexed heap erase by handle") {
+    const size_t n = 1000;
+    std::mt19937 rng(32);
+    std::vector<double> key(n);
+    std::vector<uint8_t> erased(n, 0);
+    indexed_heap<double> h(n);
+    for (uint32_t i = 0; i < n; i++) {
+        key[i] = rng() % 10000;
+        h.push(i, key[i]);
+    }
+    for (uint32_t i = 0; i < n; i += 3) {
+        REQUIRE(h.erase(i));
+        erased[i] = 1;
+    }
+    REQUIRE(!h.erase(0));
+    REQUIRE(!h.contains(3));
+    std::vector<double> expected, popped;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!erased[i]) {
+            expected.push_back(key[i]);
+        }
+    }
+    while (!h.empty()) {
+        uint32_t i = h.pop();
+        REQUIRE(!erased[i]);
+        popped.push_back(key[i]);
+    }
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(popped == expected);
+}
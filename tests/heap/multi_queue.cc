@@ -0,0 +1,83 @@
+#include "../../src/classes/heap/multi_queue.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+#include <thread>
+
+TEST_CASE("testing multi queue with one heap is exact") {
+    multi_queue<int> q({1, 1, 2});
+    REQUIRE(q.queues() == 1);
+    REQUIRE(q.empty());
+    REQUIRE(!q.pop().has_value());
+    std::mt19937 rng(34);
+    std::vector<int> values(1000);
+    for (int& x : values) {
+        x = static_cast<int>(rng() % 500);
+        q.push(x);
+    }
+    REQUIRE(q.size() == values.size());
+    std::sort(values.begin(), values.end());
+    for (int x : values) {
+        REQUIRE(q.pop() == x);
+    }
+    multi_queue_stats s = q.stats();
+    REQUIRE(s.pushes == 1000);
+    REQUIRE(s.pops == 1000);
+    REQUIRE(s.empty_pops == 1);
+    REQUIRE(s.contention == 0);
+}
+
+TEST_CASE("testing multi queue relaxed order") {
+    multi_queue<int, std::greater<int>> q({4, 2, 2});
+    REQUIRE(q.queues() == 8);
+    for (int i = 0; i < 4000; i++) {
+        q.push(i);
+    }
+    // a relaxed pop still comes from the top of one of the heaps
+    long long first = 0;
+    for (int k = 0; k < 100; k++) {
+        first += *q.pop();
+    }
+    REQUIRE(first / 100 > 3500);
+    q.clear();
+    REQUIRE(q.empty());
+    REQUIRE(!q.pop().has_value());
+}
+
+TEST_CASE("testing multi queue under concurrent pushes and pops") {
+    const int threads = 4, per_thread = 20000;
+    multi_queue<int> q({threads});
+    std::vector<std::vector<int>> popped(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < per_thread; i++) {
+                q.push(t * per_thread + i);
+                if (i % 2 == 1) {
+                    int x;
+                    if (q.try_pop(x)) {
+                        popped[t].push_back(x);
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    std::vector<int> all;
+    for (const auto& p : popped) {
+        all.insert(all.end(), p.begin(), p.end());
+    }
+    for (std::optional<int> x = q.pop(); x; x = q.pop()) {
+        all.push_back(*x);
+    }
+    std::sort(all.begin(), all.end());
+    REQUIRE(all.size() == size_t(threads * per_thread));
+    for (int i = 0; i < threads * per_thread; i++) {
+        REQUIRE(all[i] == i);
+    }
+    multi_queue_stats s = q.stats();
+    REQUIRE(s.pushes == uint64_t(threads * per_thread));
+    REQUIRE(s.pops == s.pushes);
+}
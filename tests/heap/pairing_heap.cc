@@ -0,0 +1,54 @@
+#include "../../src/classes/heap/pairing_heap.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+
+TEST_CASE("testing pairing heap decrease key") {
+    pairing_heap<double> h(5);
+    REQUIRE(h.empty());
+    h.push(0, 5);
+    h.push(1, 3);
+    h.push(2, 4);
+    REQUIRE(h.top() == 1);
+    REQUIRE(h.push(0, 1) == true);
+    REQUIRE(h.push(2, 10) == false);
+    REQUIRE(h.size() == 3);
+    REQUIRE(h.key(2) == 4);
+    REQUIRE(h.pop() == 0);
+    REQUIRE(h.pop() == 1);
+    REQUIRE(h.contains(2));
+    REQUIRE(!h.contains(1));
+    h.clear();
+    REQUIRE(h.empty());
+    REQUIRE(!h.contains(2));
+    h.push(2, 7);
+    REQUIRE(h.top_key() == 7);
+}
+
+TEST_CASE("testing pairing heap against sorting") {
+    const size_t n = 2000;
+    std::mt19937 rng(34);
+    std::vector<long long> key(n);
+    pairing_heap<long long, std::greater<long long>> h(n);
+    for (uint32_t i = 0; i < n; i++) {
+        key[i] = rng() % 100000;
+        h.push(i, key[i]);
+        if (i % 7 == 0) {
+            uint32_t j = h.pop();
+            h.push(j, key[j]);
+        }
+    }
+    for (int k = 0; k < 5000; k++) {
+        uint32_t i = rng() % n;
+        long long higher = key[i] + rng() % 1000;
+        h.push(i, higher);
+        key[i] = std::max(key[i], higher);
+    }
+    std::vector<long long> popped;
+    while (!h.empty()) {
+        REQUIRE(h.top_key() == key[h.top()]);
+        popped.push_back(key[h.pop()]);
+    }
+    std::sort(key.begin(), key.end(), std::greater<long long>());
+    REQUIRE(popped == key);
+}
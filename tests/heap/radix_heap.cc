@@ -0,0 +1,57 @@
+#include "../../src/classes/heap/radix_heap.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+
+TEST_CASE("testing radix heap decrease key") {
+    radix_heap<uint32_t> h(6);
+    REQUIRE(h.empty());
+    h.push(0, 50);
+    h.push(1, 30);
+    h.push(2, 40);
+    REQUIRE(h.top_key() == 30);
+    REQUIRE(h.push(0, 10));
+    REQUIRE(!h.push(2, 45));
+    REQUIRE(h.key(2) == 40);
+    REQUIRE(h.size() == 3);
+    REQUIRE(h.pop() == 0);
+    REQUIRE(h.top() == 1);
+    REQUIRE_THROWS_AS(h.push(3, 5), std::invalid_argument);
+    REQUIRE(h.pop() == 1);
+    REQUIRE(h.contains(2));
+    REQUIRE(!h.contains(1));
+    h.clear();
+    REQUIRE(h.empty());
+    REQUIRE(!h.contains(2));
+    h.push(4, 3);
+    REQUIRE(h.top_key() == 3);
+}
+
+TEST_CASE("testing radix heap on a monotone workload") {
+    const size_t n = 3000;
+    std::mt19937 rng(33);
+    std::vector<uint64_t> key(n, 0);
+    std::vector<uint8_t> done(n, 0);
+    radix_heap<uint64_t> h(n);
+    h.push(0, 0);
+    uint64_t last = 0;
+    size_t pops = 0;
+    // dijkstra-like: every popped key spawns larger keys for random ids
+    while (!h.empty()) {
+        REQUIRE(h.top_key() == key[h.top()]);
+        uint32_t u = h.pop();
+        REQUIRE(key[u] >= last);
+        last = key[u];
+        done[u] = 1;
+        pops++;
+        for (int k = 0; k < 4; k++) {
+            uint32_t v = rng() % n;
+            uint64_t candidate = last + rng() % (uint64_t(1) << (rng() % 40));
+            if (!done[v] && (!h.contains(v) || candidate < key[v])) {
+                key[v] = candidate;
+                h.push(v, candidate);
+            }
+        }
+    }
+    REQUIRE(pops == static_cast<size_t>(std::count(done.begin(), done.end(), 1)));
+}
@@ -0,0 +1,185 @@
+#include "../../src/helpers/alloc_tracker.h"
+#include "../../src/classes/hash_table/hash_table.h"
+#include "../../src/classes/list/frequency_list.h"
+#include "../../src/classes/list/linked_list.h"
+#include "../../src/classes/list/skip_list.h"
+#include "../../src/classes/queue/dequeue_list.h"
+#include "../../src/classes/stack/stack_list.h"
+#include "../../src/classes/tree/avl_tree.h"
+#include "../../src/classes/tree/red_black_tree.h"
+#include "../../src/classes/tree/trie.h"
+#include "../../src/helpers/node_pool.h"
+#include "../../third_party/catch.hpp"
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+ALGOPLUS_DEFINE_ALLOCATION_HOOKS();
+
+TEST_CASE("testing the counting resource") {
+    ALLOC::counting_resource counting;
+    {
+        std::pmr::vector<int> v(&counting);
+        v.reserve(100);
+        REQUIRE(counting.stats().allocations == 1);
+        REQUIRE(counting.stats().bytes_allocated == 100 * sizeof(int));
+        v.resize(1000);
+        counting.add_operations(2);
+    }
+    ALLOC::alloc_stats s = counting.stats();
+    REQUIRE(s.allocations == 2);
+    REQUIRE(s.deallocations == 2);
+    REQUIRE(s.live_bytes() == 0);
+    REQUIRE(s.peak_bytes == 1100 * sizeof(int));
+    REQUIRE(s.allocations_per_op() == 1);
+    REQUIRE(s.bytes_per_op() == 550 * sizeof(int));
+    REQUIRE(s.to_json()["peak_bytes"] == 1100 * sizeof(int));
+    counting.reset();
+    REQUIRE(counting.stats().allocations == 0);
+    REQUIRE(counting.stats().peak_bytes == 0);
+}
+
+TEST_CASE("testing the counting resource under a node pool") {
+    ALLOC::counting_resource counting;
+    {
+        node_pool<std::string, 64> pool(&counting);
+        REQUIRE(pool.resource() == &counting);
+        for (int i = 0; i < 100; i++) {
+            pool.create("node");
+        }
+        // slabs of 32, 64 and 64 nodes, and the slab table of 1, 2 and 4 slabs
+        REQUIRE(counting.stats().allocations == 6);
+        REQUIRE(counting.stats().live_bytes() >= int64_t(100 * sizeof(std::string)));
+        // the slab table is kept for the next slabs
+        pool.clear(static_cast<std::string*>(nullptr), [](std::string*, auto) {});
+        REQUIRE(counting.stats().deallocations == 5);
+        REQUIRE(counting.stats().live_bytes() < int64_t(100 * sizeof(std::string)));
+    }
+    REQUIRE(counting.stats().live_bytes() == 0);
+
+    // the containers on a node pool take their slabs from the default resource
+    std::pmr::memory_resource* old = std::pmr::set_default_resource(&counting);
+    {
+        avl_tree<int> t;
+        for (int i = 0; i < 1000; i++) {
+            t.insert(i);
+        }
+        std::pmr::set_default_resource(old);
+        REQUIRE(counting.stats().allocations > 0);
+        REQUIRE(counting.stats().bytes_allocated >= 1000 * sizeof(int));
+    }
+    std::pmr::set_default_resource(old);
+    REQUIRE(counting.stats().live_bytes() == 0);
+}
+
+TEST_CASE("testing the containers on a memory resource") {
+    ALLOC::counting_resource counting;
+    {
+        linked_list<int> l({}, &counting);
+        skip_list<int> s(8, 0.5, &counting);
+        avl_tree<int> a({}, &counting);
+        red_black_tree<int> rb({}, &counting);
+        trie t({}, &counting);
+        hash_table<int, int> h({}, &counting);
+        dequeue_list<int> d({}, &counting);
+        stack_list<int, 4> st({}, &counting);
+        frequency_list<int> f({}, &counting);
+        REQUIRE(l.resource() == &counting);
+        REQUIRE(s.resource() == &counting);
+        REQUIRE(a.resource() == &counting);
+        REQUIRE(rb.resource() == &counting);
+        REQUIRE(t.resource() == &counting);
+        REQUIRE(h.resource() == &counting);
+        REQUIRE(d.resource() == &counting);
+        REQUIRE(st.resource() == &counting);
+        REQUIRE(f.resource() == &counting);
+        for (int i = 0; i < 1000; i++) {
+            l.push_back(i);
+            s.insert(i);
+            a.insert(i);
+            rb.insert(i);
+            h.insert(i, i);
+            d.push_back(i);
+            st.push(i);
+            f.push_back(i % 10);
+        }
+        t.insert("arena");
+        avl_tree<int> right = a.split(500);
+        REQUIRE(right.resource() == &counting);
+        REQUIRE(right.size() == 500);
+        REQUIRE(h.find(999) != nullptr);
+        REQUIRE(counting.stats().live_bytes() > int64_t(8 * 1000 * sizeof(int)));
+
+        // a copy takes the default resource, a move keeps the memory where it is
+        linked_list<int> copy(l);
+        REQUIRE(copy.resource() == std::pmr::get_default_resource());
+        dequeue_list<int> moved(std::move(d));
+        REQUIRE(moved.resource() == &counting);
+        REQUIRE(moved.size() == 1000);
+        stack_list<int, 4> moved_stack({}, std::pmr::get_default_resource());
+        moved_stack = std::move(st);
+        REQUIRE(moved_stack.resource() == &counting);
+        REQUIRE(moved_stack.top() == 999);
+    }
+    REQUIRE(counting.stats().live_bytes() == 0);
+
+    // a monotonic arena on a buffer holds whole structures, with no other allocation
+    std::vector<std::byte> buffer(1 << 20);
+    ALLOC::tracker tracker;
+    {
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                                  std::pmr::null_memory_resource());
+        red_black_tree<int> rb({}, &arena);
+        hash_table<int, int> h({}, &arena);
+        skip_list<int> s(8, 0.5, &arena);
+        frequency_list<int> f({}, &arena);
+        for (int i = 0; i < 1000; i++) {
+            rb.insert(i);
+            h.insert(i, i);
+            s.insert(i);
+            f.push_back(i % 10);
+        }
+        REQUIRE(rb.size() == 1000);
+        REQUIRE(h.find(500) != nullptr);
+        REQUIRE(s.search(500));
+    }
+    REQUIRE(tracker.stats().allocations == 0);
+}
+
+TEST_CASE("testing the allocation tracker") {
+    REQUIRE(ALLOC::tracker::hooks_installed());
+    ALLOC::tracker outer;
+    {
+        ALLOC::tracker inner;
+        std::vector<int> v(256);
+        inner.add_operations();
+        REQUIRE(inner.stats().allocations == 1);
+        REQUIRE(inner.stats().bytes_allocated == 256 * sizeof(int));
+        REQUIRE(inner.stats().allocations_per_op() == 1);
+    }
+    // the inner allocations count for the outer tracker too
+    REQUIRE(outer.stats().allocations == 1);
+    REQUIRE(outer.stats().deallocations == 1);
+    REQUIRE(outer.stats().peak_bytes == 256 * sizeof(int));
+
+    // the allocations of the other threads are not counted
+    outer.reset();
+    std::thread([] { std::vector<int> v(1000); }).join();
+    std::vector<int> v(8);
+    REQUIRE(outer.stats().allocations <= 2);
+
+    // zero allocations after the warmup
+    std::vector<int> buffer;
+    outer.reset();
+    for (int round = 0; round < 100; round++) {
+        buffer.clear();
+        for (int i = 0; i < 64; i++) {
+            buffer.push_back(i);
+        }
+        if (round == 0) {
+            outer.reset();
+        }
+    }
+    REQUIRE(outer.stats().allocations == 0);
+}
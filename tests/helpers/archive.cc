@@ -0,0 +1,129 @@
+#include "../../src/helpers/archive.h"
+#include "../../src/classes/heap/min_heap.h"
+#include "../../src/classes/list/skip_list.h"
+#include "../../src/classes/tree/avl_tree.h"
+#include "../../src/classes/tree/double_array_trie.h"
+#include "../../src/classes/tree/fenwick_tree.h"
+#include "../../src/classes/tree/interval_tree.h"
+#include "../../src/classes/tree/red_black_tree.h"
+#include "../../src/classes/tree/trie.h"
+#include "../../third_party/catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("testing sorted archives of the ordered containers") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_archive.bin";
+    std::mt19937 rng(7);
+    avl_tree<int> a;
+    for (int i = 0; i < 2000; i++) {
+        a.insert(int(rng() % 10000));
+    }
+    a.save_archive(path.string());
+
+    sorted_archive<int> view(path.string());
+    REQUIRE(view.size() == a.size());
+    std::vector<int> keys = a.inorder();
+    for (int x = -1; x <= 10000; x += 7) {
+        REQUIRE(view.contains(x) == a.search(x));
+        REQUIRE(view.lower_bound(x) ==
+                size_t(std::lower_bound(keys.begin(), keys.end(), x) - keys.begin()));
+    }
+    REQUIRE(view[0] == keys[0]);
+    REQUIRE(view.keys() == keys);
+
+    avl_tree<int> loaded = avl_tree<int>::load_archive(path.string());
+    REQUIRE(loaded.inorder() == keys);
+    red_black_tree<int> rb = red_black_tree<int>::load_archive(path.string());
+    REQUIRE(rb.inorder() == keys);
+    skip_list<int> s = skip_list<int>::load_archive(path.string(), 16, 0.5);
+    REQUIRE(s.size() == keys.size());
+    std::vector<int> linked;
+    for (int x : s) {
+        linked.push_back(x);
+    }
+    REQUIRE(linked == keys);
+    s.insert(-5);
+    REQUIRE(s.search(-5));
+    s.save_archive(path.string());
+    REQUIRE(sorted_archive<int>(path.string())[0] == -5);
+
+    REQUIRE_THROWS_AS(sorted_archive<long long>(path.string()), std::runtime_error);
+    REQUIRE_THROWS_AS(min_heap<int>::load_archive(path.string()), std::runtime_error);
+    // a truncated file is rejected
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    REQUIRE_THROWS_AS(sorted_archive<int>(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("testing sorted archives of strings") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_archive.str";
+    red_black_tree<std::string> rb({"pear", "apple", "fig", "", "banana"});
+    rb.save_archive(path.string());
+    sorted_archive<std::string> view(path.string());
+    REQUIRE(view.size() == 5);
+    REQUIRE(view[0] == "");
+    REQUIRE(view[1] == "apple");
+    REQUIRE(view.contains("fig"));
+    REQUIRE(!view.contains("grape"));
+    REQUIRE(view.lower_bound("c") == 3);
+    REQUIRE(avl_tree<std::string>::load_archive(path.string()).inorder() == rb.inorder());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("testing archives of tries, intervals, heaps and fenwick trees") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_archive.misc";
+
+    trie t({"car", "card", "care", "dog"});
+    t.insert("cart", 5);
+    t.save_archive(path.string());
+    double_array_trie mapped = double_array_trie::map_archive(path.string());
+    REQUIRE(mapped.size() == 5);
+    REQUIRE(mapped.search("care"));
+    REQUIRE(!mapped.search("ca"));
+    REQUIRE(mapped.keys_with_prefix("car") ==
+            std::vector<std::string>{"car", "card", "care", "cart"});
+    REQUIRE(mapped.values()[*mapped.find("cart")] == 5);
+    double_array_trie copy = mapped;
+    REQUIRE(copy.longest_prefix_match("cards") == 4);
+    trie loaded = trie::load_archive(path.string());
+    REQUIRE(loaded.size() == 5);
+    REQUIRE(loaded.complete("ca", 1)[0] == std::pair<std::string, double>("cart", 5));
+
+    double_array_trie d({"she", "sells", "sea", "shells"});
+    d.save_archive(path.string());
+    double_array_trie md = double_array_trie::map_archive(path.string());
+    REQUIRE(md.keys_with_prefix("") == d.keys_with_prefix(""));
+    REQUIRE(md.values().empty());
+
+    interval_tree<int> it({{1, 5}, {3, 4}, {10, 12}, {3, 9}, {20, 21}, {7, 8}});
+    it.save_archive(path.string());
+    interval_tree<int> li = interval_tree<int>::load_archive(path.string());
+    REQUIRE(li.inorder() == it.inorder());
+    REQUIRE(li.query_overlapping(8) == it.query_overlapping(8));
+    li.remove({3, 9});
+    it.remove({3, 9});
+    REQUIRE(li.size() == 5);
+    REQUIRE(li.inorder() == it.inorder());
+
+    min_heap<int> h(8);
+    for (int x : {9, 4, 7, 1, 8, 2}) {
+        h.insert(x);
+    }
+    h.save_archive(path.string());
+    min_heap<int> lh = min_heap<int>::load_archive(path.string());
+    REQUIRE(lh.size() == 6);
+    for (int x : {1, 2, 4, 7, 8, 9}) {
+        REQUIRE(lh._min() == x);
+    }
+
+    fenwick_tree<long long> f({3, 1, 4, 1, 5, 9, 2, 6});
+    f.save_archive(path.string());
+    fenwick_tree<long long> lf = fenwick_tree<long long>::load_archive(path.string());
+    REQUIRE(lf.tree == f.tree);
+    REQUIRE(lf.sum(2, 5) == 19);
+    REQUIRE_THROWS_AS(fenwick_tree<int>::load_archive(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+}
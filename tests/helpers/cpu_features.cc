@@ -0,0 +1,119 @@
+#include "../../src/helpers/cpu_features.h"
+#include "../../src/algorithms/searching/linear_search.h"
+#include "../../src/algorithms/string/substring_search.h"
+#include "../../src/linalg/mat_expr.h"
+#include "../../src/machine_learning/image/image_buffer.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+int first_kernel() { return 0; }
+int second_kernel() { return 2; }
+int third_kernel() { return 3; }
+} // namespace
+
+TEST_CASE("testing cpu feature detection") {
+    REQUIRE(SIMD::supported(SIMD::isa::scalar));
+    REQUIRE(SIMD::supported(SIMD::best()));
+    REQUIRE(SIMD::supported(SIMD::active()));
+    for (SIMD::isa i : {SIMD::isa::scalar, SIMD::isa::sse2, SIMD::isa::avx2, SIMD::isa::avx512,
+                        SIMD::isa::neon}) {
+        REQUIRE(SIMD::parse(SIMD::name(i)) == i);
+    }
+    REQUIRE_THROWS_AS(SIMD::parse("mmx"), std::invalid_argument);
+    const SIMD::cpu_features& f = SIMD::features();
+    REQUIRE(SIMD::supported(SIMD::isa::avx512) == (f.avx512f && f.avx512bw));
+    REQUIRE(!(f.neon && f.avx2));
+
+    {
+        SIMD::scoped_isa forced(SIMD::isa::scalar);
+        REQUIRE(SIMD::active() == SIMD::isa::scalar);
+    }
+    REQUIRE(SIMD::supported(SIMD::active()));
+    SIMD::isa missing = f.neon ? SIMD::isa::avx2 : SIMD::isa::neon;
+    REQUIRE_THROWS_AS(SIMD::force(missing), std::invalid_argument);
+}
+
+TEST_CASE("testing the selection of kernels") {
+    const SIMD::kernels<int()> k{.scalar = &first_kernel, .avx2 = &second_kernel};
+    REQUIRE(k.get(SIMD::isa::scalar)() == 0);
+    REQUIRE(k.get(SIMD::isa::sse2)() == 0);
+    REQUIRE(k.get(SIMD::isa::avx2)() == 2);
+    REQUIRE(k.get(SIMD::isa::avx512)() == 2);
+    REQUIRE(k.get(SIMD::isa::neon)() == 0);
+
+    const SIMD::kernels<int()> n{.scalar = &first_kernel, .neon = &third_kernel};
+    REQUIRE(n.get(SIMD::isa::avx512)() == 0);
+    REQUIRE(n.get(SIMD::isa::neon)() == 3);
+    {
+        SIMD::scoped_isa forced(SIMD::isa::scalar);
+        REQUIRE(k.get()() == 0);
+    }
+}
+
+TEST_CASE("testing that every instruction set gives the same results") {
+    std::mt19937 rng(7);
+    std::vector<int16_t> values(3000);
+    for (auto& v : values) {
+        v = int16_t(rng() % 11);
+    }
+    std::string text;
+    for (size_t i = 0; i < 5000; i++) {
+        text += char('a' + rng() % 3);
+    }
+    std::vector<double> a(203), b(203);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = double(rng() % 100) / 7;
+        b[i] = double(rng() % 100) / 3;
+    }
+    image_buffer<uint8_t> p(3, 100), q(3, 100);
+    for (size_t y = 0; y < 3; y++) {
+        for (size_t x = 0; x < 100; x++) {
+            p(y, x) = uint8_t(rng());
+            q(y, x) = uint8_t(rng());
+        }
+    }
+
+    std::vector<size_t> expected_values, expected_text;
+    double expected_dot = 0, expected_squared = 0, expected_absolute = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (values[i] == 4) {
+            expected_values.push_back(i);
+        }
+    }
+    for (size_t i = 0; i + 4 <= text.size(); i++) {
+        if (text.compare(i, 4, "abca") == 0) {
+            expected_text.push_back(i);
+        }
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        expected_dot += a[i] * b[i];
+        expected_squared += (a[i] - b[i]) * (a[i] - b[i]);
+        expected_absolute += std::abs(a[i] - b[i]);
+    }
+
+    for (SIMD::isa i : {SIMD::isa::scalar, SIMD::isa::sse2, SIMD::isa::avx2, SIMD::isa::avx512,
+                        SIMD::isa::neon}) {
+        if (!SIMD::supported(i)) {
+            continue;
+        }
+        SIMD::scoped_isa forced(i);
+        REQUIRE(linear_find_all(std::span<const int16_t>(values), 4) == expected_values);
+        REQUIRE(linear_find(std::span<const int16_t>(values), 4) == int64_t(expected_values[0]));
+        REQUIRE(substring_find_all(text, "abca") == expected_text);
+        REQUIRE(_mat_utils::dot(a.data(), b.data(), a.size()) == Approx(expected_dot));
+        REQUIRE(_mat_utils::squared_distance(a.data(), b.data(), a.size()) ==
+                Approx(expected_squared));
+        REQUIRE(_mat_utils::absolute_distance(a.data(), b.data(), a.size()) ==
+                Approx(expected_absolute));
+        image_buffer<uint8_t> sum = p;
+        sum.add(q);
+        for (size_t y = 0; y < 3; y++) {
+            for (size_t x = 0; x < 100; x++) {
+                REQUIRE(sum(y, x) == std::min(255, int(p(y, x)) + int(q(y, x))));
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include "../../src/algorithms/sorting/merge_sort.h"
+#include "../../src/helpers/executor.h"
+#include "../../src/helpers/parallel.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("testing work stealing deque") {
+    PARALLEL::work_stealing_deque<int*> d(2);
+    std::vector<int> v(100);
+    REQUIRE(d.pop() == nullptr);
+    REQUIRE(d.steal() == nullptr);
+    for (int& x : v) {
+        d.push(&x);
+    }
+    REQUIRE(d.size() == 100);
+    // the owner takes the newest, the thieves the oldest
+    REQUIRE(d.pop() == &v[99]);
+    REQUIRE(d.steal() == &v[0]);
+    REQUIRE(d.size() == 98);
+
+    // every element is taken once while three thieves race the owner
+    PARALLEL::work_stealing_deque<int*> q;
+    const size_t n = 20000;
+    std::vector<int> items(n, 0);
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; t++) {
+        thieves.emplace_back([&]() {
+            while (!stop.load()) {
+                if (int* x = q.steal()) {
+                    (*x)++;
+                }
+            }
+        });
+    }
+    for (size_t i = 0; i < n; i++) {
+        q.push(&items[i]);
+        if (i % 3 == 0) {
+            if (int* x = q.pop()) {
+                (*x)++;
+            }
+        }
+    }
+    while (int* x = q.pop()) {
+        (*x)++;
+    }
+    stop = true;
+    for (std::thread& t : thieves) {
+        t.join();
+    }
+    REQUIRE(std::count(items.begin(), items.end(), 1) == int64_t(n));
+}
+
+TEST_CASE("testing executor parallel_for") {
+    PARALLEL::executor pool(3);
+    REQUIRE(pool.concurrency() == 4);
+    for (int round = 0; round < 50; round++) {
+        std::vector<int> hits(10000, 0);
+        std::vector<std::atomic<int>> chunks(64);
+        pool.parallel_for(0, hits.size(), 64, [&](size_t lo, size_t hi, size_t c) {
+            for (size_t i = lo; i < hi; i++) {
+                hits[i]++;
+            }
+            chunks[c]++;
+        });
+        REQUIRE(std::count(hits.begin(), hits.end(), 1) == 10000);
+        REQUIRE(std::all_of(chunks.begin(), chunks.end(), [](auto& c) { return c == 1; }));
+    }
+
+    // nested loops steal from each other instead of blocking the workers
+    std::atomic<size_t> sum = 0;
+    pool.parallel_for(0, 16, 16, [&](size_t, size_t, size_t) {
+        pool.parallel_for(0, 16, 16, [&](size_t, size_t, size_t) {
+            pool.parallel_for(0, 100, 4, [&](size_t a, size_t b, size_t) { sum += b - a; });
+        });
+    });
+    REQUIRE(sum == 16 * 16 * 100);
+
+    REQUIRE_THROWS_AS(pool.parallel_for(0, 100, 10,
+                                        [&](size_t lo, size_t, size_t) {
+                                            if (lo == 50) {
+                                                throw std::logic_error("chunk 5");
+                                            }
+                                        }),
+                      std::logic_error);
+}
+
+TEST_CASE("testing execution policies") {
+    REQUIRE(size_t(PARALLEL::seq) == 1);
+    REQUIRE(size_t(PARALLEL::par) == 0);
+    REQUIRE(size_t(PARALLEL::par(4)) == 4);
+    REQUIRE(size_t(PARALLEL::seq(4)) == 1);
+    REQUIRE(PARALLEL::par_unseq(2).type == PARALLEL::execution_policy::kind::par_unseq);
+
+    std::mt19937 rng(3);
+    std::vector<int> v(50000);
+    for (int& x : v) {
+        x = int(rng() % 1000);
+    }
+    std::vector<int> expected = v;
+    std::sort(expected.begin(), expected.end());
+    for (auto policy : {PARALLEL::seq, PARALLEL::par, PARALLEL::par(3), PARALLEL::par_unseq}) {
+        std::vector<int> w = v;
+        merge_sort(w.begin(), w.end(), std::less<int>(), policy);
+        REQUIRE(w == expected);
+    }
+
+    // the shared executor is set up before its first use only
+    PARALLEL::executor::shared();
+    REQUIRE_THROWS_AS(PARALLEL::executor::configure({2, false}), std::logic_error);
+}
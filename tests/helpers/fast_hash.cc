@@ -0,0 +1,113 @@
+#include "../../src/helpers/fast_hash.h"
+#include "../../src/classes/hash_table/flat_hash_table.h"
+#include "../../src/classes/hash_table/hash_table.h"
+#include "../../third_party/catch.hpp"
+#include <bit>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST_CASE("testing the integer mixer") {
+    REQUIRE(HASHING::mix(1) != 1);
+    REQUIRE(HASHING::mix(7, 0) == HASHING::mix(7));
+    REQUIRE(HASHING::mix(7, 1) != HASHING::mix(7));
+    // flipping one input bit flips about half of the output bits
+    std::mt19937_64 rng(1);
+    double flipped = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t x = rng();
+        int bit = int(rng() % 64);
+        flipped += std::popcount(HASHING::mix(x) ^ HASHING::mix(x ^ (uint64_t(1) << bit)));
+    }
+    REQUIRE(flipped / 1000 == Approx(32).margin(1));
+    REQUIRE(HASHING::combine(1, 2) != HASHING::combine(2, 1));
+}
+
+TEST_CASE("testing the byte hash") {
+    std::string text;
+    for (int i = 0; i < 200; i++) {
+        text += char('a' + i % 26);
+    }
+    std::set<uint64_t> seen;
+    for (size_t n = 0; n <= text.size(); n++) {
+        const uint64_t h = HASHING::hash_string(std::string_view(text).substr(0, n));
+        REQUIRE(seen.insert(h).second);
+        REQUIRE(HASHING::hash_bytes(text.data(), n) == h);
+        REQUIRE(HASHING::hash_string(std::string(text, 0, n)) == h);
+        REQUIRE(HASHING::hash_string(std::string_view(text).substr(0, n), 42) != h);
+    }
+    // every byte of every length matters, the last one included
+    for (size_t n = 1; n <= 100; n++) {
+        std::string s(text, 0, n);
+        const uint64_t h = HASHING::hash_string(s);
+        for (size_t i = 0; i < n; i++) {
+            std::string t = s;
+            t[i] ^= 1;
+            REQUIRE(HASHING::hash_string(t) != h);
+        }
+    }
+}
+
+TEST_CASE("testing that strings and integers hash the same at compile time") {
+    static constexpr uint64_t short_text = HASHING::hash_string("apple");
+    static constexpr uint64_t long_text =
+        HASHING::hash_string("a string that is longer than the 48 bytes of one round", 3);
+    static_assert(HASHING::mix(7) != 7 && HASHING::hasher<int>()(5) == HASHING::mix(5));
+    const std::string s = "a string that is longer than the 48 bytes of one round";
+    REQUIRE(short_text == HASHING::hash_bytes("apple", 5));
+    REQUIRE(long_text == HASHING::hash_bytes(s.data(), s.size(), 3));
+    REQUIRE(HASHING::hasher<std::string_view>()("apple") == short_text);
+}
+
+TEST_CASE("testing hasher and seeded_hasher") {
+    HASHING::hasher<std::string> h;
+    REQUIRE(h(std::string("apple")) == h(std::string_view("apple")));
+    REQUIRE(h(std::string("apple")) == HASHING::hash_string("apple"));
+    REQUIRE(HASHING::hasher<int>()(5) == HASHING::mix(5));
+    REQUIRE(HASHING::hasher<uint64_t>(9)(5) == HASHING::mix(5, 9));
+    REQUIRE(HASHING::seeded_hasher<int>().seed == HASHING::random_seed());
+    REQUIRE(HASHING::hash_of(h, std::string("fig")) == h(std::string("fig")));
+    REQUIRE(HASHING::hash_of(std::hash<uint64_t>(), 3) == HASHING::mix(3));
+    static_assert(HASHING::avalanching<HASHING::seeded_hasher<int>>);
+    static_assert(!HASHING::avalanching<std::hash<int>>);
+
+    flat_hash_table<uint64_t, int, HASHING::seeded_hasher<uint64_t>> seeded;
+    hash_table<std::string, int, HASHING::seeded_hasher<std::string>> words;
+    for (uint64_t i = 0; i < 1000; i++) {
+        seeded.insert(i << 20, int(i));
+        words.insert(std::to_string(i), int(i));
+    }
+    REQUIRE(seeded.retrieve(uint64_t(7) << 20) == 7);
+    REQUIRE(words.find(std::string_view("42")) != nullptr);
+}
+
+TEST_CASE("testing that strided ids spread over the buckets") {
+    hash_table<uint64_t, int> ht;
+    for (uint64_t i = 0; i < 4096; i++) {
+        ht.insert(i * 1024, 0);
+    }
+    hash_table_stats s = ht.stats();
+    // with the identity, every key would share one bucket out of 64
+    REQUIRE(s.average_probes < 2);
+}
+
+TEST_CASE("testing batch hashing on every instruction set") {
+    std::mt19937_64 rng(3);
+    std::vector<uint64_t> keys(1003), out(1003);
+    for (auto& k : keys) {
+        k = rng();
+    }
+    for (SIMD::isa i : {SIMD::isa::scalar, SIMD::isa::avx2, SIMD::isa::avx512}) {
+        if (!SIMD::supported(i)) {
+            continue;
+        }
+        SIMD::scoped_isa forced(i);
+        HASHING::hash_batch(keys, out, 17);
+        for (size_t k = 0; k < keys.size(); k++) {
+            REQUIRE(out[k] == HASHING::hasher<uint64_t>(17)(keys[k]));
+        }
+    }
+    std::vector<uint64_t> short_out(3);
+    REQUIRE_THROWS_AS(HASHING::hash_batch(keys, short_out), std::invalid_argument);
+}
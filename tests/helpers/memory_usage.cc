@@ -0,0 +1,76 @@
+#include "../../src/classes/list/doubly_linked_list.h"
+#include "../../src/classes/list/linked_list.h"
+#include "../../src/classes/tree/avl_tree.h"
+#include "../../src/helpers/memory_usage.h"
+#include "../../third_party/catch.hpp"
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("testing memory usage of the standard containers") {
+    std::vector<int> v;
+    v.reserve(10);
+    v.push_back(1);
+    v.push_back(2);
+    MEMORY::footprint f = MEMORY::memory_usage(v);
+    REQUIRE(f.payload == 2 * sizeof(int));
+    REQUIRE(f.slack == 8 * sizeof(int));
+    REQUIRE(f.control == sizeof(v) + MEMORY::ALLOCATION_OVERHEAD);
+    REQUIRE(f.total() == f.payload + f.node_overhead + f.control + f.slack);
+
+    // a short string lives in the object, a long one adds its characters
+    std::string s = "abc";
+    REQUIRE(MEMORY::memory_usage(s).total() == sizeof(std::string));
+    std::string l(200, 'x');
+    REQUIRE(MEMORY::memory_usage(l).payload == 200);
+    REQUIRE(MEMORY::memory_usage(l).total() > 200 + sizeof(std::string));
+
+    std::vector<std::string> strings = {l, l};
+    REQUIRE(MEMORY::memory_usage(strings).payload >= 2 * (sizeof(std::string) + 200));
+
+    std::set<int> set = {1, 2, 3};
+    f = MEMORY::memory_usage(set);
+    REQUIRE(f.payload == 3 * sizeof(int));
+    REQUIRE(f.node_overhead > 0);
+    REQUIRE(MEMORY::memory_usage(std::set<int>()).total() == sizeof(std::set<int>));
+}
+
+TEST_CASE("testing memory usage of the containers") {
+    avl_tree<int> t;
+    REQUIRE(MEMORY::memory_usage(t).payload == 0);
+    for (int i = 0; i < 1000; i++) {
+        t.insert(i);
+    }
+    MEMORY::footprint f = MEMORY::memory_usage(t);
+    REQUIRE(f.payload == 1000 * sizeof(int));
+    REQUIRE(f.node_overhead >= 1000 * 2 * sizeof(void*));
+    REQUIRE(f.control >= sizeof(t));
+    REQUIRE(f.per_element(1000) == Approx(double(f.total()) / 1000));
+
+    avl_tree<std::string> words({std::string(100, 'a'), std::string(100, 'b')});
+    REQUIRE(MEMORY::memory_usage(words).payload >= 2 * (sizeof(std::string) + 100));
+
+    // the nodes of a pooled list carry one link, the ones of a shared_ptr list two links, a
+    // control block and the header of their own heap block
+    linked_list<int> single;
+    doubly_linked_list<int> doubly;
+    for (int i = 0; i < 100; i++) {
+        single.push_back(i);
+        doubly.push_back(i);
+    }
+    REQUIRE(MEMORY::memory_usage(single).payload == MEMORY::memory_usage(doubly).payload);
+    REQUIRE(MEMORY::memory_usage(single).per_element(100) <
+            MEMORY::memory_usage(doubly).per_element(100));
+}
+
+TEST_CASE("testing memory usage print") {
+    MEMORY::footprint f{800, 400, 200, 100};
+    std::ostringstream out;
+    out.precision(3);
+    MEMORY::print(out, "c", f, 100);
+    REQUIRE(out.str() ==
+            "c: 15.0 bytes/elem (payload 8.0, nodes 4.0, control 2.0, slack 1.0)\n");
+    REQUIRE(out.precision() == 3);
+    REQUIRE(MEMORY::footprint{}.per_element(0) == 0);
+}
@@ -0,0 +1,167 @@
+#include "../../src/helpers/node_pool.h"
+#include "../../src/classes/tree/234_tree.h"
+#include "../../src/classes/tree/avl_tree.h"
+#include "../../src/classes/tree/bst.h"
+#include "../../src/classes/tree/interval_tree.h"
+#include "../../src/classes/tree/red_black_tree.h"
+#include "../../src/classes/tree/splay_tree.h"
+#include "../../third_party/catch.hpp"
+#include <set>
+#include <string>
+
+namespace {
+struct counted {
+    static inline int alive = 0;
+    std::string s;
+    counted* left{nullptr};
+    counted* right{nullptr};
+    explicit counted(std::string s) : s(std::move(s)) { alive++; }
+    ~counted() { alive--; }
+};
+} // namespace
+
+TEST_CASE("testing create and destroy in node pool") {
+    node_pool<counted, 8> pool;
+    std::vector<counted*> nodes;
+    for (int i = 0; i < 100; i++) {
+        nodes.push_back(pool.create(std::to_string(i)));
+    }
+    REQUIRE(pool.size() == 100);
+    REQUIRE(counted::alive == 100);
+    REQUIRE(pool.capacity() >= 100);
+    REQUIRE(std::set<counted*>(nodes.begin(), nodes.end()).size() == 100);
+    for (int i = 0; i < 100; i++) {
+        REQUIRE(nodes[i]->s == std::to_string(i));
+    }
+
+    counted* freed = nodes[42];
+    pool.destroy(freed);
+    REQUIRE(counted::alive == 99);
+    size_t capacity = pool.capacity();
+    counted* reused = pool.create("again");
+    REQUIRE(reused == freed);
+    REQUIRE(pool.capacity() == capacity);
+    pool.destroy(nullptr);
+    REQUIRE(pool.size() == 100);
+
+    for (counted* n : nodes) {
+        pool.destroy(n);
+    }
+    REQUIRE(pool.size() == 0);
+    REQUIRE(counted::alive == 0);
+}
+
+TEST_CASE("testing clear, reserve and move in node pool") {
+    node_pool<counted> pool;
+    pool.reserve(1000);
+    size_t capacity = pool.capacity();
+    REQUIRE(capacity >= 1000);
+
+    counted* root = pool.create("root");
+    root->left = pool.create("l");
+    root->right = pool.create("r");
+    root->left->right = pool.create("lr");
+    REQUIRE(pool.capacity() == capacity);
+
+    node_pool<counted> moved(std::move(pool));
+    REQUIRE(pool.size() == 0);
+    REQUIRE(moved.size() == 4);
+    REQUIRE(root->left->right->s == "lr");
+
+    moved.clear(root, [](counted* n, auto visit) {
+        visit(n->left);
+        visit(n->right);
+    });
+    REQUIRE(counted::alive == 0);
+    REQUIRE(moved.size() == 0);
+    REQUIRE(moved.capacity() == 0);
+}
+
+TEST_CASE("testing that copies of pooled trees own their nodes") {
+    avl_tree<int> a({5, 2, 8, 1, 9});
+    avl_tree<int> a2(a);
+    a2.remove(5);
+    a2.insert(7);
+    REQUIRE(a.inorder() == std::vector<int>{1, 2, 5, 8, 9});
+    REQUIRE(a2.inorder() == std::vector<int>{1, 2, 7, 8, 9});
+
+    bst<int> b({5, 2, 8});
+    bst<int> b2;
+    b2 = b;
+    b.clear();
+    REQUIRE(b.inorder().empty());
+    REQUIRE(b2.inorder() == std::vector<int>{2, 5, 8});
+
+    red_black_tree<int> rb({1, 2, 3, 4, 5, 6});
+    red_black_tree<int> rb2(rb);
+    REQUIRE(rb2 == rb);
+    rb2.remove(4);
+    REQUIRE(rb2.size() == 5);
+    REQUIRE(rb.size() == 6);
+    REQUIRE(!(rb2 == rb));
+    REQUIRE(rb.search(4));
+
+    splay_tree<int> s({4, 1, 3});
+    splay_tree<int> s2(s);
+    s2.remove(3);
+    s2.remove(30);
+    REQUIRE(s.search(3));
+    REQUIRE(!s2.search(3));
+    REQUIRE(s2.size() == 2);
+
+    interval_tree<int> it({{1, 5}, {3, 9}, {0, 2}});
+    interval_tree<int> it2(it);
+    it2.remove({3, 9});
+    REQUIRE(it2.size() == 2);
+    REQUIRE(it.inorder().size() == 3);
+
+    ttf_tree<int> t({30, 99, 70, 60, 40});
+    ttf_tree<int> t2(t);
+    t.clear();
+    REQUIRE(!t.search(60));
+    std::vector<std::vector<std::vector<int>>> levels = {{{70}}, {{30, 40, 60}, {99}}};
+    REQUIRE(t2.level_order() == levels);
+}
+
+TEST_CASE("testing removals return nodes to the pool of the tree") {
+    red_black_tree<int> rb;
+    avl_tree<int> a;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 500; i++) {
+            rb.insert(i);
+            a.insert(i);
+        }
+        for (int i = 0; i < 500; i++) {
+            rb.remove(i);
+            a.remove(i);
+        }
+        REQUIRE(rb.size() == 0);
+        REQUIRE(a.size() == 0);
+    }
+    rb.insert(3);
+    REQUIRE(rb.inorder() == std::vector<int>{3});
+}
+
+TEST_CASE("testing splice in node pool") {
+    node_pool<counted, 8> a, b;
+    counted* ra = a.create("a");
+    counted* rb = b.create("b");
+    rb->left = b.create("bl");
+    b.destroy(b.create("freed"));
+    a.splice(b);
+    REQUIRE(b.size() == 0);
+    REQUIRE(b.capacity() == 0);
+    REQUIRE(a.size() == 3);
+    REQUIRE(rb->left->s == "bl");
+    ra->left = rb;
+    size_t capacity = a.capacity();
+    for (int i = 0; i < 10; i++) {
+        a.destroy(a.create("x"));
+    }
+    REQUIRE(a.capacity() == capacity);
+    a.clear(ra, [](counted* n, auto visit) {
+        visit(n->left);
+        visit(n->right);
+    });
+    REQUIRE(counted::alive == 0);
+}
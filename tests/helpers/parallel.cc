@@ -0,0 +1,57 @@
+#include "../../src/helpers/parallel.h"
+#include "../../third_party/catch.hpp"
+#include <atomic>
+#include <numeric>
+#include <random>
+
+TEST_CASE("testing parallel_for") {
+    for (size_t threads : {0, 1, 3, 16}) {
+        std::vector<int> hits(1000, 0);
+        std::atomic<size_t> max_tid = 0;
+        PARALLEL::parallel_for(0, hits.size(), threads, [&](size_t lo, size_t hi, size_t tid) {
+            for (size_t i = lo; i < hi; i++) {
+                hits[i]++;
+            }
+            size_t seen = max_tid.load();
+            while (tid > seen && !max_tid.compare_exchange_weak(seen, tid)) {
+            }
+        });
+        REQUIRE(std::count(hits.begin(), hits.end(), 1) == 1000);
+        REQUIRE(max_tid < PARALLEL::resolve_threads(threads, hits.size()));
+    }
+    bool called = false;
+    PARALLEL::parallel_for(5, 5, 4, [&](size_t, size_t, size_t) { called = true; });
+    REQUIRE(!called);
+    REQUIRE(PARALLEL::resolve_threads(8, 3) == 3);
+    REQUIRE(PARALLEL::resolve_threads(8, 0) == 1);
+}
+
+TEST_CASE("testing parallel_sort") {
+    std::mt19937 rng(1);
+    for (size_t n : {0, 1, 100, 5000, 100000}) {
+        std::vector<int> v(n);
+        for (int& x : v) {
+            x = static_cast<int>(rng() % 1000);
+        }
+        std::vector<int> expected = v;
+        std::sort(expected.begin(), expected.end());
+        for (size_t threads : {1, 3, 8}) {
+            std::vector<int> w = v;
+            PARALLEL::parallel_sort(w.begin(), w.end(), std::less<int>(), threads);
+            REQUIRE(w == expected);
+        }
+    }
+}
+
+TEST_CASE("testing parallel_for_dynamic") {
+    for (size_t threads : {1, 2, 5}) {
+        std::vector<std::atomic<int>> hits(777);
+        std::vector<size_t> per_thread(PARALLEL::resolve_threads(threads, hits.size()), 0);
+        PARALLEL::parallel_for_dynamic(0, hits.size(), threads, [&](size_t i, size_t tid) {
+            hits[i]++;
+            per_thread[tid]++;
+        });
+        REQUIRE(std::count(hits.begin(), hits.end(), 1) == 777);
+        REQUIRE(std::accumulate(per_thread.begin(), per_thread.end(), size_t(0)) == 777);
+    }
+}
@@ -0,0 +1,59 @@
+#include "../../src/helpers/perf_counters.h"
+#include "../../src/helpers/timer.h"
+#include "../../third_party/catch.hpp"
+#include <numeric>
+#include <vector>
+
+TEST_CASE("testing the hardware counters") {
+    REQUIRE(PERF::event_name(PERF::event::llc_misses) == "llc_misses");
+    PERF::counters pmu;
+    std::vector<int> v(1 << 16, 1);
+    pmu.start();
+    int64_t sum = 0;
+    for (int round = 0; round < 10; round++) {
+        sum += std::accumulate(v.begin(), v.end(), int64_t(0));
+    }
+    TIMER::do_not_optimize(sum);
+    pmu.stop();
+    PERF::sample s = pmu.read();
+    for (size_t e = 0; e < PERF::EVENTS; e++) {
+        // an event that could not be opened is never valid, where the system offers none
+        // every event reads 0
+        if (!pmu.available(PERF::event(e))) {
+            REQUIRE(!s.valid[e]);
+            REQUIRE(s.values[e] == 0);
+        }
+    }
+    if (s.has(PERF::event::instructions)) {
+        REQUIRE(s[PERF::event::instructions] > 10 * v.size());
+    }
+    if (!pmu.available()) {
+        REQUIRE(s.ipc() == 0);
+    }
+
+    PERF::counters moved = std::move(pmu);
+    REQUIRE(!pmu.available());
+    REQUIRE(pmu.read().ipc() == 0);
+}
+
+TEST_CASE("testing the benchmark runner with hardware counters") {
+    std::vector<int> v(4096, 1);
+    TIMER::options opt;
+    opt.warmup_ms = 0;
+    opt.iterations = 10;
+    opt.samples = 5;
+    opt.counters = true;
+    TIMER::result r = TIMER::benchmark(
+        "sum", [&]() { TIMER::do_not_optimize(std::accumulate(v.begin(), v.end(), 0)); }, opt);
+    if (PERF::counters().available(PERF::event::instructions)) {
+        REQUIRE(r.counters.count("instructions") == 1);
+        REQUIRE(r.counters["instructions"] > 4096);
+        REQUIRE(r.to_json().contains("counters"));
+    } else {
+        REQUIRE(r.counters.count("instructions") == 0);
+    }
+    opt.counters = false;
+    r = TIMER::benchmark("sum", [&]() { TIMER::do_not_optimize(v[0]); }, opt);
+    REQUIRE(r.counters.empty());
+    REQUIRE(!r.to_json().contains("counters"));
+}
@@ -0,0 +1,54 @@
+#include "../../src/helpers/thread_pool.h"
+#include "../../third_party/catch.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("testing thread_pool parallel_for") {
+    for (size_t workers : {0, 1, 3}) {
+        PARALLEL::thread_pool pool(workers);
+        REQUIRE(pool.concurrency() == workers + 1);
+        for (size_t chunks : {0, 1, 2, 7, 5000}) {
+            std::vector<int> hits(1000, 0);
+            std::atomic<size_t> calls = 0, max_chunk = 0;
+            pool.parallel_for(0, hits.size(), chunks, [&](size_t lo, size_t hi, size_t c) {
+                for (size_t i = lo; i < hi; i++) {
+                    hits[i]++;
+                }
+                calls++;
+                size_t seen = max_chunk.load();
+                while (c > seen && !max_chunk.compare_exchange_weak(seen, c)) {
+                }
+            });
+            REQUIRE(std::count(hits.begin(), hits.end(), 1) == 1000);
+            REQUIRE(max_chunk < calls);
+            REQUIRE(calls <= std::max<size_t>(1, chunks == 0 ? pool.concurrency() : chunks));
+        }
+        bool called = false;
+        pool.parallel_for(5, 5, 4, [&](size_t, size_t, size_t) { called = true; });
+        REQUIRE(!called);
+    }
+}
+
+TEST_CASE("testing nested thread_pool parallel_for and exceptions") {
+    PARALLEL::thread_pool pool(2);
+    std::atomic<size_t> sum = 0;
+    pool.parallel_for(0, 8, 8, [&](size_t lo, size_t hi, size_t) {
+        for (size_t i = lo; i < hi; i++) {
+            pool.parallel_for(0, 100, 4, [&](size_t a, size_t b, size_t) { sum += b - a; });
+        }
+    });
+    REQUIRE(sum == 800);
+
+    std::atomic<size_t> done = 0;
+    REQUIRE_THROWS_AS(pool.parallel_for(0, 8, 8,
+                                        [&](size_t lo, size_t, size_t) {
+                                            if (lo == 3) {
+                                                throw std::runtime_error("chunk 3");
+                                            }
+                                            done++;
+                                        }),
+                      std::runtime_error);
+    REQUIRE(done == 7);
+    REQUIRE(PARALLEL::thread_pool::shared().concurrency() >= 1);
+}
@@ -1,6 +1,7 @@
 #include "../../src/helpers/timer.h"
 #include "../../third_party/catch.hpp"
 #include "../../src/classes/graph/graph.h"
+#include <numeric>
 
 TEST_CASE("Testing execution time for timer namespcae") {
     weighted_graph<int> g("directed");
@@ -54,3 +55,96 @@ TEST_CASE("Testing check faster for timer namespace") {
     CHECK_NOTHROW(
         TIMER::check_faster(shortest_path, std::make_tuple(0, 1), dfs, std::make_tuple(0)));
 }
+
+TEST_CASE("Testing the statistics of the benchmark runner") {
+    TIMER::stats s = TIMER::summarize({5, 1, 4, 2, 3});
+    REQUIRE(s.min == 1);
+    REQUIRE(s.max == 5);
+    REQUIRE(s.median == 3);
+    REQUIRE(s.mean == 3);
+    REQUIRE(s.p90 == Approx(4.6));
+    REQUIRE(s.stddev == Approx(std::sqrt(2.5)));
+    REQUIRE(TIMER::summarize({}).median == 0);
+    REQUIRE(TIMER::summarize({7}).stddev == 0);
+}
+
+TEST_CASE("Testing the benchmark runner") {
+    std::vector<int> v(1000);
+    std::iota(v.begin(), v.end(), 0);
+    size_t calls = 0;
+    TIMER::options opt;
+    opt.warmup_ms = 1;
+    opt.min_time_ms = 5;
+    opt.samples = 10;
+    TIMER::result r = TIMER::benchmark("sum", [&]() {
+        calls++;
+        TIMER::do_not_optimize(std::accumulate(v.begin(), v.end(), 0));
+    }, opt);
+    REQUIRE(r.name == "sum");
+    REQUIRE(r.samples == 10);
+    REQUIRE(r.iterations >= 1);
+    REQUIRE(calls >= r.iterations * r.samples);
+    REQUIRE(r.ns.min > 0);
+    REQUIRE(r.ns.min <= r.ns.median);
+    REQUIRE(r.ns.median <= r.ns.p90);
+    REQUIRE(r.ns.p90 <= r.ns.p99);
+    REQUIRE(r.ns.p99 <= r.ns.max);
+
+    // a fixed iteration count skips the calibration
+    opt.iterations = 3;
+    opt.warmup_ms = 0;
+    calls = 0;
+    r = TIMER::benchmark("fixed", [&]() { calls++; }, opt);
+    REQUIRE(r.iterations == 3);
+    REQUIRE(calls == 30);
+
+    const std::string path = "benchmark_results.json";
+    TIMER::write_json({r}, path);
+    std::ifstream file(path);
+    json j = json::parse(file);
+    REQUIRE(j.size() == 1);
+    REQUIRE(j[0]["name"] == "fixed");
+    REQUIRE(j[0]["iterations"] == 3);
+    REQUIRE(j[0].contains("p99_ns"));
+    file.close();
+    std::filesystem::remove(path);
+
+    opt.samples = 0;
+    REQUIRE_THROWS_AS(TIMER::benchmark("none", []() {}, opt), std::invalid_argument);
+}
+
+TEST_CASE("Testing the complexity fit and the regression check") {
+    std::vector<double> sizes = {100, 1000, 10000, 100000, 1000000};
+    for (int c = 0; c < 6; c++) {
+        const auto model = TIMER::complexity(c);
+        std::vector<double> times;
+        for (double n : sizes) {
+            times.push_back(3e-6 * TIMER::complexity_of(model, n));
+        }
+        const auto fits = TIMER::fit_complexity(sizes, times);
+        REQUIRE(fits.size() == 6);
+        REQUIRE(fits[0].model == model);
+        REQUIRE(fits[0].coefficient == Approx(3e-6));
+        REQUIRE(fits[0].rms == Approx(0).margin(1e-9));
+        REQUIRE(TIMER::parse_complexity(TIMER::complexity_name(model)) == model);
+    }
+    REQUIRE_THROWS_AS(TIMER::fit_complexity({1}, {1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(TIMER::fit_complexity({1, 2}, {1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(TIMER::parse_complexity("n!"), std::invalid_argument);
+
+    const std::string path = "complexity_baseline.json";
+    std::filesystem::remove(path);
+    const TIMER::fit linear{TIMER::complexity::n, 2.0, 0};
+    REQUIRE(TIMER::check_regression("scan", linear, path).passed);
+    TIMER::save_baseline("scan", linear, path);
+    TIMER::save_baseline("lookup", {TIMER::complexity::logn, 1.0, 0}, path);
+    REQUIRE(TIMER::check_regression("scan", linear, path).passed);
+    REQUIRE(TIMER::check_regression("scan", {TIMER::complexity::n, 2.4, 0}, path).passed);
+    REQUIRE(!TIMER::check_regression("scan", {TIMER::complexity::n, 2.6, 0}, path).passed);
+    REQUIRE(TIMER::check_regression("scan", {TIMER::complexity::n, 2.6, 0}, path, 0.5).passed);
+    REQUIRE(!TIMER::check_regression("scan", {TIMER::complexity::nlogn, 0.1, 0}, path).passed);
+    REQUIRE(TIMER::check_regression("scan", {TIMER::complexity::logn, 50, 0}, path).passed);
+    REQUIRE(!TIMER::check_regression("lookup", {TIMER::complexity::n, 1, 0}, path).passed);
+    REQUIRE(TIMER::check_regression("insert", linear, path).passed);
+    std::filesystem::remove(path);
+}
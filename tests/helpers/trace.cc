@@ -0,0 +1,86 @@
+#define ALGOPLUS_TRACE
+#include "../../src/helpers/trace.h"
+#include "../../third_party/catch.hpp"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+
+TEST_CASE("testing trace spans and counters") {
+    TRACE::clear();
+    {
+        ALGOPLUS_TRACE_SPAN("outer");
+        {
+            ALGOPLUS_TRACE_SPAN("inner");
+            ALGOPLUS_TRACE_COUNTER("items", 42);
+        }
+    }
+    std::vector<TRACE::event> e = TRACE::events();
+    REQUIRE(e.size() == 3);
+    // ordered by start: outer, inner, then the counter
+    REQUIRE(std::string(e[0].name) == "outer");
+    REQUIRE(std::string(e[1].name) == "inner");
+    REQUIRE(e[2].is_counter);
+    REQUIRE(e[2].value == 42);
+    REQUIRE(e[0].ts_ns <= e[1].ts_ns);
+    REQUIRE(e[0].ts_ns + uint64_t(e[0].value) >= e[1].ts_ns + uint64_t(e[1].value));
+
+    TRACE::clear();
+    REQUIRE(TRACE::events().empty());
+}
+
+TEST_CASE("testing trace buffers of several threads") {
+    TRACE::clear();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 100; i++) {
+                ALGOPLUS_TRACE_SPAN("work");
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::vector<TRACE::event> e = TRACE::events();
+    REQUIRE(e.size() == 400);
+    std::set<uint32_t> tids;
+    for (const auto& x : e) {
+        tids.insert(x.tid);
+    }
+    REQUIRE(tids.size() == 4);
+
+    // the oldest events are overwritten
+    TRACE::clear();
+    for (int i = 0; i < ALGOPLUS_TRACE_BUFFER + 10; i++) {
+        ALGOPLUS_TRACE_COUNTER("i", i);
+    }
+    e = TRACE::events();
+    REQUIRE(e.size() <= size_t(ALGOPLUS_TRACE_BUFFER));
+    REQUIRE(e.back().value == ALGOPLUS_TRACE_BUFFER + 9);
+    TRACE::clear();
+}
+
+TEST_CASE("testing the chrome trace export") {
+    TRACE::clear();
+    {
+        ALGOPLUS_TRACE_SPAN("span");
+        ALGOPLUS_TRACE_COUNTER("counter", 7);
+    }
+    nlohmann::json j = TRACE::chrome_json();
+    REQUIRE(j["traceEvents"].size() == 2);
+    REQUIRE(j["traceEvents"][0]["ph"] == "X");
+    REQUIRE(j["traceEvents"][0]["name"] == "span");
+    REQUIRE(j["traceEvents"][0].contains("dur"));
+    REQUIRE(j["traceEvents"][1]["ph"] == "C");
+    REQUIRE(j["traceEvents"][1]["args"]["counter"] == 7);
+
+    TRACE::write_chrome_json("trace_test.json");
+    std::ifstream file("trace_test.json");
+    REQUIRE(nlohmann::json::parse(file)["traceEvents"].size() == 2);
+    file.close();
+    std::remove("trace_test.json");
+    REQUIRE_THROWS(TRACE::write_chrome_json("/nonexistent/dir/trace.json"));
+    TRACE::clear();
+}
@@ -0,0 +1,125 @@
+#include "../../../src/linalg/decomposition.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+Matrix<double> random_matrix(size_t rows, size_t cols, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    Matrix<double> a(rows, cols);
+    for (size_t i = 0; i < a.size(); i++) {
+        a.data()[i] = dist(rng);
+    }
+    return a;
+}
+
+double max_error(const Matrix<double>& a, const Matrix<double>& b) {
+    double err = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        err = std::max(err, std::abs(a.data()[i] - b.data()[i]));
+    }
+    return err;
+}
+} // namespace
+
+TEST_CASE("testing lu_decomposition") {
+    std::mt19937_64 rng(1);
+    for (size_t n : {1, 3, 64, 150}) {
+        Matrix<double> a = random_matrix(n, n, rng);
+        lu_decomposition<double> lu(a);
+        REQUIRE(!lu.singular());
+        // P A = L U
+        Matrix<double> l(n, n), u(n, n), pa(n, n);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                if (j < i) {
+                    l(i, j) = lu.factors()(i, j);
+                } else {
+                    u(i, j) = lu.factors()(i, j);
+                }
+                pa(i, j) = a(lu.permutation()[i], j);
+            }
+            l(i, i) = 1;
+        }
+        REQUIRE(max_error(matmul(l, u), pa) < 1e-10);
+
+        std::vector<double> x(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = double(i % 5) - 2.0;
+        }
+        std::vector<double> b = matmul(a, std::span<const double>(x));
+        std::vector<double> y = lu.solve(b);
+        for (size_t i = 0; i < n; i++) {
+            REQUIRE(std::abs(y[i] - x[i]) < 1e-8);
+        }
+        Matrix<double> rhs = random_matrix(n, 3, rng);
+        REQUIRE(max_error(matmul(a, lu.solve(rhs)), rhs) < 1e-8);
+    }
+    Matrix<double> a({{2, 1}, {4, 3}});
+    REQUIRE(std::abs(lu_decomposition<double>(a).determinant() - 2.0) < 1e-12);
+    lu_decomposition<double> singular(Matrix<double>({{1, 2}, {2, 4}}));
+    REQUIRE(singular.singular());
+    REQUIRE(singular.determinant() == 0.0);
+    REQUIRE_THROWS_AS(singular.solve(std::vector<double>{1, 1}), std::runtime_error);
+    REQUIRE_THROWS_AS(lu_decomposition<double>(Matrix<double>(2, 3)), std::invalid_argument);
+}
+
+TEST_CASE("testing cholesky_decomposition") {
+    std::mt19937_64 rng(2);
+    for (size_t n : {1, 5, 64, 140}) {
+        Matrix<double> m = random_matrix(n, n, rng);
+        Matrix<double> a = matmul(m, m.transpose());
+        for (size_t i = 0; i < n; i++) {
+            a(i, i) += double(n);
+        }
+        cholesky_decomposition<double> c(a);
+        const Matrix<double>& l = c.factor();
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = i + 1; j < n; j++) {
+                REQUIRE(l(i, j) == 0.0);
+            }
+        }
+        REQUIRE(max_error(matmul(l, l.transpose()), a) < 1e-9);
+        std::vector<double> x(n, 1.0);
+        std::vector<double> y = c.solve(matmul(a, std::span<const double>(x)));
+        for (double v : y) {
+            REQUIRE(std::abs(v - 1.0) < 1e-9);
+        }
+    }
+    REQUIRE_THROWS_AS(cholesky_decomposition<double>(Matrix<double>({{1, 2}, {2, 1}})),
+                      std::runtime_error);
+}
+
+TEST_CASE("testing qr_decomposition") {
+    std::mt19937_64 rng(3);
+    for (auto [m, n] : {std::pair<size_t, size_t>{1, 1}, std::pair<size_t, size_t>{6, 4},
+                        std::pair<size_t, size_t>{120, 30}}) {
+        Matrix<double> a = random_matrix(m, n, rng);
+        qr_decomposition<double> qr(a);
+        Matrix<double> q = qr.q(), r = qr.r();
+        REQUIRE(max_error(matmul(q, r), a) < 1e-10);
+        Matrix<double> identity(n, n);
+        for (size_t i = 0; i < n; i++) {
+            identity(i, i) = 1;
+        }
+        REQUIRE(max_error(matmul(q.transpose(), q), identity) < 1e-10);
+
+        // the residual of the least squares solution is orthogonal to the columns of a
+        std::vector<double> b(m);
+        for (size_t i = 0; i < m; i++) {
+            b[i] = std::sin(double(i));
+        }
+        std::vector<double> x = qr.solve(b);
+        std::vector<double> res = matmul(a, std::span<const double>(x));
+        for (size_t i = 0; i < m; i++) {
+            res[i] -= b[i];
+        }
+        std::vector<double> g = matmul(a.transpose(), std::span<const double>(res));
+        for (double v : g) {
+            REQUIRE(std::abs(v) < 1e-10);
+        }
+    }
+    REQUIRE_THROWS_AS(qr_decomposition<double>(Matrix<double>(2, 3)), std::invalid_argument);
+    qr_decomposition<double> rank(Matrix<double>({{1, 2}, {2, 4}, {3, 6}}));
+    REQUIRE_THROWS_AS(rank.solve(std::vector<double>{1, 2, 3}), std::runtime_error);
+}
@@ -1,5 +1,6 @@
 #include "../../../src/linalg/mat_1d.h"
 #include "../../../third_party/catch.hpp"
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -126,3 +127,47 @@ TEST_CASE("Testing operator << for Mat1d class") {
 //         REQUIRE(*(it) == 5);
 //     }
 // }
+
+TEST_CASE("testing storage of Mat1d class") {
+    Mat1d<float, 4> small(1.0f);
+    REQUIRE(reinterpret_cast<uintptr_t>(small.data()) % 32 == 0);
+    REQUIRE(sizeof(small) <= 32);
+    Mat1d<double, 100000> large(2.0);
+    REQUIRE(reinterpret_cast<uintptr_t>(large.data()) % 64 == 0);
+    Mat1d<double, 100000> moved(std::move(large));
+    REQUIRE(moved[99999] == 2.0);
+}
+
+TEST_CASE("testing expressions of Mat1d class") {
+    Mat1d<float, 11> a, b;
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = float(i);
+        b[i] = float(2 * i + 1);
+    }
+    Mat1d<float, 11> c = a + b * 2.0f;
+    for (size_t i = 0; i < c.size(); i++) {
+        REQUIRE(c[i] == float(i) + float(2 * i + 1) * 2);
+    }
+    c = -(a - b) / 2.0f;
+    for (size_t i = 0; i < c.size(); i++) {
+        REQUIRE(c[i] == float(i + 1) / 2);
+    }
+    // the result may be an operand
+    a = a + a * 3.0f;
+    a += b;
+    a -= c;
+    a *= 2.0f;
+    for (size_t i = 0; i < a.size(); i++) {
+        REQUIRE(a[i] == (float(4 * i) + float(2 * i + 1) - float(i + 1) / 2) * 2);
+    }
+
+    Mat1d<int, 5> x({1, 2, 3, 4, 5}), y({5, 4, 3, 2, 1});
+    Mat1d<int, 5> z = 2 * x - y + x;
+    REQUIRE(z == Mat1d<int, 5>({-2, 2, 6, 10, 14}));
+
+    Mat1d<double, 1000> p(1.5), q(0.5);
+    Mat1d<double, 1000> r = p * 2.0 + q - p / 3.0;
+    for (size_t i = 0; i < r.size(); i++) {
+        REQUIRE(r[i] == Approx(3.0));
+    }
+}
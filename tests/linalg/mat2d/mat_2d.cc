@@ -1,5 +1,8 @@
 #include "../../../src/linalg/mat_2d.h"
 #include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -76,3 +79,104 @@ TEST_CASE("testing operator = for Mat2d class") {
         REQUIRE(mat(i) == mat2(i));
     }
 }
+
+TEST_CASE("testing storage of Mat2d class") {
+    Mat2d<float, 4, 4> small(1.0f);
+    REQUIRE(reinterpret_cast<uintptr_t>(small.data()) % 64 == 0);
+    REQUIRE(sizeof(small) == 64);
+    Mat2d<double, 300, 300> large(2.0);
+    REQUIRE(reinterpret_cast<uintptr_t>(large.data()) % 64 == 0);
+    REQUIRE(large(299, 299) == 2.0);
+}
+
+TEST_CASE("testing expressions of Mat2d class") {
+    Mat2d<double, 3, 5> a, b;
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            a(i, j) = double(i * 5 + j);
+            b(i, j) = double(i) - double(j);
+        }
+    }
+    Mat2d<double, 3, 5> c = a + b * 0.5 - (-a) / 4.0;
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            REQUIRE(c(i, j) == Approx(a(i, j) * 1.25 + b(i, j) * 0.5));
+        }
+    }
+    c = c - c;
+    c += a;
+    c *= 2.0;
+    c -= a;
+    for (size_t i = 0; i < 3; i++) {
+        REQUIRE(c(i) == a(i));
+    }
+
+    Mat2d<int, 2, 3> x({{1, 2, 3}, {4, 5, 6}});
+    Mat2d<int, 2, 3> y = x * 3 - x;
+    REQUIRE(y(1) == Mat1d<int, 3>({8, 10, 12}));
+}
+
+TEST_CASE("testing move operations for Mat2d class") {
+    Mat2d<int, 200, 200> mat(7);
+    const int* storage = mat.data();
+    Mat2d<int, 200, 200> mat2(std::move(mat));
+    REQUIRE(mat2.data() == storage);
+    Mat2d<int, 200, 200> mat3;
+    mat3 = std::move(mat2);
+    REQUIRE(mat3.data() == storage);
+    REQUIRE(mat3(199, 199) == 7);
+}
+
+TEST_CASE("testing views of Mat2d class") {
+    Mat2d<int, 4, 5> mat;
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            mat(i, j) = int(i * 10 + j);
+        }
+    }
+    strided_span<int> row = mat.row(2);
+    REQUIRE(row.size() == 5);
+    REQUIRE(row.data() == &mat(2, 0));
+    REQUIRE(std::vector<int>(row.begin(), row.end()) == std::vector<int>{20, 21, 22, 23, 24});
+    strided_span<int> col = mat.col(3);
+    REQUIRE(col.size() == 4);
+    REQUIRE(std::vector<int>(col.begin(), col.end()) == std::vector<int>{3, 13, 23, 33});
+    col[1] = -1;
+    REQUIRE(mat(1, 3) == -1);
+    std::sort(col.begin(), col.end(), std::greater<int>());
+    REQUIRE(mat(0, 3) == 33);
+    REQUIRE(mat(3, 3) == -1);
+    REQUIRE(col.end() - col.begin() == 4);
+
+    mat_view<int> sub = mat.submatrix(1, 1, 2, 3);
+    REQUIRE(sub.rows() == 2);
+    REQUIRE(sub.cols() == 3);
+    REQUIRE(sub(0, 0) == 11);
+    REQUIRE(sub(1, 2) == 3);
+    sub(1, 0) = 100;
+    REQUIRE(mat(2, 1) == 100);
+    REQUIRE(sub.col(1)[1] == 22);
+    REQUIRE(sub.submatrix(1, 1, 1, 2)(0, 1) == 3);
+    REQUIRE_THROWS_AS(mat.submatrix(3, 0, 2, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(sub.submatrix(0, 2, 1, 2), std::out_of_range);
+
+    const Mat2d<int, 4, 5>& cmat = mat;
+    mat_view<const int> cview = cmat.view();
+    strided_span<const int> crow = cview.row(0);
+    REQUIRE(crow[4] == 4);
+}
+
+TEST_CASE("testing row iterators for Mat2d class") {
+    Mat2d<int, 3, 2> mat({{1, 2}, {3, 4}, {5, 6}});
+    std::vector<int> sums;
+    for (strided_span<int> row : mat) {
+        sums.push_back(row[0] + row[1]);
+        row[0] = 0;
+    }
+    REQUIRE(sums == std::vector<int>{3, 7, 11});
+    REQUIRE(mat(2, 0) == 0);
+    auto it = mat.end();
+    --it;
+    REQUIRE((*it)[1] == 6);
+    REQUIRE(std::distance(mat.begin(), mat.end()) == 3);
+}
@@ -0,0 +1,81 @@
+#include "../../../src/linalg/matmul.h"
+#include "../../../third_party/catch.hpp"
+#include <random>
+
+namespace {
+template <typename T, size_t R, size_t K, size_t C>
+void check_product(const Mat2d<T, R, K>& a, const Mat2d<T, K, C>& b, const Mat2d<T, R, C>& c) {
+    for (size_t i = 0; i < R; i++) {
+        for (size_t j = 0; j < C; j++) {
+            T sum = 0;
+            for (size_t k = 0; k < K; k++) {
+                sum += a(i, k) * b(k, j);
+            }
+            REQUIRE(c(i, j) == sum);
+        }
+    }
+}
+
+template <typename T, size_t R, size_t C> void fill(Mat2d<T, R, C>& m, std::mt19937_64& rng) {
+    for (size_t i = 0; i < R * C; i++) {
+        m.data()[i] = T(int64_t(rng() % 21) - 10);
+    }
+}
+} // namespace
+
+TEST_CASE("testing matmul for small matrices") {
+    Mat2d<int, 2, 3> a({{1, 2, 3}, {4, 5, 6}});
+    Mat2d<int, 3, 2> b({{7, 8}, {9, 10}, {11, 12}});
+    Mat2d<int, 2, 2> c = matmul(a, b);
+    REQUIRE(c(0) == Mat1d<int, 2>({58, 64}));
+    REQUIRE(c(1) == Mat1d<int, 2>({139, 154}));
+    Mat2d<int, 3, 3> d = b * a;
+    check_product(b, a, d);
+
+    Mat1d<int, 3> x({1, 0, -1});
+    REQUIRE(a * x == Mat1d<int, 2>({-2, -2}));
+
+    std::mt19937_64 rng(103);
+    Mat2d<float, 4, 4> f, g;
+    fill(f, rng);
+    fill(g, rng);
+    check_product(f, g, matmul(f, g));
+    Mat2d<double, 8, 8> h, k;
+    fill(h, rng);
+    fill(k, rng);
+    // an expression of products
+    Mat2d<double, 8, 8> e = matmul(h, k) + (h * k) * 2.0;
+    Mat2d<double, 8, 8> hk = h * k;
+    for (size_t i = 0; i < 64; i++) {
+        REQUIRE(e.data()[i] == 3 * hk.data()[i]);
+    }
+}
+
+TEST_CASE("testing matmul for large matrices") {
+    std::mt19937_64 rng(103);
+    Mat2d<double, 70, 90> a;
+    Mat2d<double, 90, 130> b;
+    fill(a, rng);
+    fill(b, rng);
+    check_product(a, b, matmul(a, b));
+    check_product(a, b, matmul(a, b, 3));
+
+    Mat2d<int64_t, 300, 65> x;
+    Mat2d<int64_t, 65, 17> y;
+    fill(x, rng);
+    fill(y, rng);
+    check_product(x, y, matmul(x, y, 2));
+
+    Mat1d<int64_t, 65> v;
+    for (size_t i = 0; i < 65; i++) {
+        v[i] = int64_t(i) - 30;
+    }
+    Mat1d<int64_t, 300> w = x * v;
+    for (size_t i = 0; i < 300; i++) {
+        int64_t sum = 0;
+        for (size_t k = 0; k < 65; k++) {
+            sum += x(i, k) * v[k];
+        }
+        REQUIRE(w[i] == sum);
+    }
+}
@@ -0,0 +1,125 @@
+#include "../../../src/linalg/matmul.h"
+#include "../../../src/linalg/matrix.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+
+TEST_CASE("testing the constructors of Matrix") {
+    Matrix<int> a;
+    REQUIRE(a.empty());
+    REQUIRE(a.rows() == 0);
+
+    Matrix<int> b(3, 4, 7);
+    REQUIRE(b.rows() == 3);
+    REQUIRE(b.cols() == 4);
+    REQUIRE(b.size() == 12);
+    REQUIRE(std::all_of(b.data(), b.data() + b.size(), [](int x) { return x == 7; }));
+    REQUIRE(reinterpret_cast<uintptr_t>(b.data()) % _mat_utils::heap_alignment == 0);
+
+    Matrix<int> c({{1, 2, 3}, {4, 5, 6}});
+    REQUIRE(c(1, 2) == 6);
+    REQUIRE(c.data()[3] == 4);
+    REQUIRE_THROWS_AS(Matrix<int>({{1, 2}, {3}}), std::invalid_argument);
+
+    Matrix<int> d = c;
+    d(0, 0) = 10;
+    REQUIRE(c(0, 0) == 1);
+    REQUIRE(d != c);
+    Matrix<int> e = std::move(d);
+    REQUIRE(e(0, 0) == 10);
+}
+
+TEST_CASE("testing the expressions of Matrix") {
+    Matrix<double> a(5, 7), b(5, 7);
+    for (size_t i = 0; i < a.size(); i++) {
+        a.data()[i] = double(i);
+        b.data()[i] = 2.0 * double(i) + 1.0;
+    }
+    Matrix<double> c = a + b * 2.0 - a / 2.0;
+    REQUIRE(c.rows() == 5);
+    REQUIRE(c.cols() == 7);
+    for (size_t i = 0; i < c.size(); i++) {
+        REQUIRE(c.data()[i] == a.data()[i] + b.data()[i] * 2.0 - a.data()[i] / 2.0);
+    }
+
+    Matrix<double> d;
+    d = -a;
+    REQUIRE(d.rows() == 5);
+    REQUIRE(d(4, 6) == -34.0);
+
+    a += a;
+    REQUIRE(a(4, 6) == 68.0);
+    a -= b;
+    REQUIRE(a(4, 6) == -1.0);
+    a *= 3.0;
+    REQUIRE(a(4, 6) == -3.0);
+    a /= 3.0;
+    REQUIRE(a(4, 6) == -1.0);
+
+    Matrix<double> e(7, 5);
+    REQUIRE_THROWS_AS(a + e, std::invalid_argument);
+    REQUIRE_THROWS_AS(a += e, std::invalid_argument);
+}
+
+TEST_CASE("testing the views of Matrix") {
+    Matrix<int> a(3, 4);
+    for (size_t i = 0; i < a.size(); i++) {
+        a.data()[i] = int(i);
+    }
+    REQUIRE(a.row(1)[2] == 6);
+    REQUIRE(a.col(3)[2] == 11);
+    a.col(0)[1] = 40;
+    REQUIRE(a(1, 0) == 40);
+
+    mat_view<int> s = a.submatrix(1, 1, 2, 2);
+    REQUIRE(s(0, 0) == 5);
+    REQUIRE(s(1, 1) == 10);
+    REQUIRE_THROWS_AS(a.submatrix(2, 2, 2, 2), std::out_of_range);
+
+    const Matrix<int>& b = a;
+    int sum = 0;
+    for (int x : b.row(2)) {
+        sum += x;
+    }
+    REQUIRE(sum == 8 + 9 + 10 + 11);
+
+    Matrix<int> t = a.transpose();
+    REQUIRE(t.rows() == 4);
+    REQUIRE(t.cols() == 3);
+    for (size_t i = 0; i < a.rows(); i++) {
+        for (size_t j = 0; j < a.cols(); j++) {
+            REQUIRE(t(j, i) == a(i, j));
+        }
+    }
+}
+
+TEST_CASE("testing matmul for Matrix") {
+    std::mt19937_64 rng(7);
+    for (auto [n, m, p] : {std::array<size_t, 3>{2, 3, 2}, std::array<size_t, 3>{1, 17, 9},
+                           std::array<size_t, 3>{70, 65, 80}}) {
+        Matrix<double> a(n, m), b(m, p);
+        for (double& x : std::span<double>(a.data(), a.size())) {
+            x = double(int64_t(rng() % 21) - 10);
+        }
+        for (double& x : std::span<double>(b.data(), b.size())) {
+            x = double(int64_t(rng() % 21) - 10);
+        }
+        Matrix<double> c = a * b;
+        REQUIRE(c.rows() == n);
+        REQUIRE(c.cols() == p);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < p; j++) {
+                double sum = 0;
+                for (size_t k = 0; k < m; k++) {
+                    sum += a(i, k) * b(k, j);
+                }
+                REQUIRE(c(i, j) == sum);
+            }
+        }
+    }
+    Matrix<int> a({{1, 2, 3}, {4, 5, 6}});
+    std::vector<int> x = {1, 0, -1};
+    REQUIRE(matmul(a, std::span<const int>(x)) == std::vector<int>{-2, -2});
+    REQUIRE_THROWS_AS(matmul(a, a), std::invalid_argument);
+    REQUIRE_THROWS_AS(matmul(a, std::span<const int>(a.data(), 2)), std::invalid_argument);
+}
@@ -0,0 +1,45 @@
+#include "../../../src/classes/graph/graph.h"
+#include "../../../src/linalg/sparse_graph.h"
+#include "../../../third_party/catch.hpp"
+
+TEST_CASE("testing the adjacency matrix of a graph") {
+    weighted_graph<char> g("directed");
+    g.add_edge('a', 'c', 2);
+    g.add_edge('a', 'b', 1);
+    g.add_edge('b', 'c', 4);
+    g.add_edge('a', 'c', 3);
+    const csr_graph<char>& c = g.csr_view();
+    csr_matrix<double> a = adjacency_matrix(c);
+    REQUIRE(a.rows() == c.size());
+    REQUIRE(a.nnz() == 3);
+    uint32_t u = c.id('a'), v = c.id('b'), w = c.id('c');
+    REQUIRE(a(u, w) == 5);
+    REQUIRE(a(u, v) == 1);
+    REQUIRE(a(v, w) == 4);
+    REQUIRE(a(w, u) == 0);
+
+    graph<int> h("undirected");
+    h.add_edge(0, 1);
+    h.add_edge(1, 2);
+    csr_matrix<double> b = adjacency_matrix(h.csr_view());
+    REQUIRE(b.to_dense() == b.transpose().to_dense());
+    REQUIRE(b.nnz() == 4);
+    // the degrees of the vertices
+    std::vector<double> degrees = b.multiply(std::vector<double>(3, 1.0));
+    REQUIRE(degrees[h.csr_view().id(1)] == 2);
+}
+
+TEST_CASE("testing the graph of a sparse matrix") {
+    coo_matrix<double> coo(3, 3);
+    coo.add(0, 1, 2.5);
+    coo.add(1, 2, 1.0);
+    coo.add(2, 0, 4.0);
+    csr_graph<uint32_t> g = to_graph(csr_matrix<double>(coo));
+    REQUIRE(g.size() == 3);
+    REQUIRE(g.arcs() == 3);
+    REQUIRE(g.directed());
+    REQUIRE(g.weighted());
+    REQUIRE(g.neighbors(g.id(1))[0] == g.id(2));
+    REQUIRE(adjacency_matrix(g).to_dense() == csr_matrix<double>(coo).to_dense());
+    REQUIRE_THROWS_AS(to_graph(csr_matrix<double>(2, 3)), std::invalid_argument);
+}
@@ -0,0 +1,89 @@
+#include "../../../src/linalg/matmul.h"
+#include "../../../src/linalg/sparse_matrix.h"
+#include "../../../third_party/catch.hpp"
+#include <random>
+
+namespace {
+Matrix<double> random_sparse(size_t rows, size_t cols, double density, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    Matrix<double> a(rows, cols);
+    for (size_t i = 0; i < a.size(); i++) {
+        if (coin(rng) < density) {
+            a.data()[i] = double(int64_t(rng() % 19) - 9);
+        }
+    }
+    return a;
+}
+} // namespace
+
+TEST_CASE("testing coo to csr and csc") {
+    coo_matrix<int> coo(3, 4);
+    coo.add(2, 1, 5);
+    coo.add(0, 3, 1);
+    coo.add(0, 0, 2);
+    coo.add(2, 1, -1);
+    coo.add(1, 2, 7);
+    REQUIRE(coo.size() == 5);
+    REQUIRE_THROWS_AS(coo.add(3, 0, 1), std::out_of_range);
+
+    csr_matrix<int> a(coo);
+    REQUIRE(a.rows() == 3);
+    REQUIRE(a.cols() == 4);
+    REQUIRE(a.nnz() == 4);
+    REQUIRE(std::vector<size_t>(a.offsets().begin(), a.offsets().end()) ==
+            std::vector<size_t>{0, 2, 3, 4});
+    REQUIRE(std::vector<uint32_t>(a.indices().begin(), a.indices().end()) ==
+            std::vector<uint32_t>{0, 3, 2, 1});
+    REQUIRE(a(2, 1) == 4);
+    REQUIRE(a(0, 3) == 1);
+    REQUIRE(a(1, 1) == 0);
+
+    csc_matrix<int> b(coo);
+    REQUIRE(b.rows() == 3);
+    REQUIRE(b.cols() == 4);
+    REQUIRE(b.nnz() == 4);
+    REQUIRE(b(2, 1) == 4);
+    REQUIRE(b.col_indices(1)[0] == 2);
+    REQUIRE(b.to_dense() == a.to_dense());
+    REQUIRE(b.to_csr().to_dense() == a.to_dense());
+    REQUIRE(csc_matrix<int>(a).to_dense() == a.to_dense());
+
+    REQUIRE_THROWS_AS(csr_matrix<int>(2, 2, {0, 1, 2}, {1, 2}, {1, 1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(csr_matrix<int>(1, 3, {0, 2}, {1, 0}, {1, 1}), std::invalid_argument);
+    REQUIRE_NOTHROW(csr_matrix<int>(1, 3, {0, 2}, {0, 2}, {1, 1}));
+}
+
+TEST_CASE("testing sparse matrix products") {
+    std::mt19937_64 rng(3);
+    for (auto [n, m, density] : {std::tuple<size_t, size_t, double>{1, 1, 1.0},
+                                 std::tuple<size_t, size_t, double>{40, 70, 0.1},
+                                 std::tuple<size_t, size_t, double>{300, 200, 0.3}}) {
+        Matrix<double> dense = random_sparse(n, m, density, rng);
+        csr_matrix<double> a = csr_matrix<double>::from_dense(dense);
+        csc_matrix<double> c(a);
+        REQUIRE(a.to_dense() == dense);
+        REQUIRE(a.transpose().to_dense() == dense.transpose());
+
+        std::vector<double> x(m), z(n);
+        for (double& v : x) {
+            v = double(int64_t(rng() % 7) - 3);
+        }
+        for (double& v : z) {
+            v = double(int64_t(rng() % 7) - 3);
+        }
+        std::vector<double> y = matmul(dense, std::span<const double>(x));
+        std::vector<double> w = matmul(dense.transpose(), std::span<const double>(z));
+        Matrix<double> b = random_sparse(m, 5, 1.0, rng);
+        Matrix<double> ab = matmul(dense, b);
+        for (size_t threads : {1, 3, 0}) {
+            REQUIRE(a.multiply(x, threads) == y);
+            REQUIRE(c.multiply(x, threads) == y);
+            REQUIRE(a.multiply_transposed(z, threads) == w);
+            REQUIRE(c.multiply_transposed(z, threads) == w);
+            REQUIRE(a.multiply(b, threads) == ab);
+        }
+    }
+    csr_matrix<double> a(2, 3);
+    REQUIRE_THROWS_AS(a.multiply(std::vector<double>(2)), std::invalid_argument);
+    REQUIRE_THROWS_AS(a.multiply(Matrix<double>(2, 2)), std::invalid_argument);
+}
@@ -0,0 +1,129 @@
+#include "../../src/classes/list/concurrent_skip_list.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("testing insert and remove in concurrent skip list") {
+    concurrent_skip_list<int> l;
+    std::set<int> ref;
+    uint32_t state = 57;
+    for (int step = 0; step < 20000; step++) {
+        state = state * 1103515245u + 12345u;
+        int x = int((state >> 8) % 2000);
+        if (step % 5 < 3) {
+            REQUIRE(l.insert(x) == ref.insert(x).second);
+        } else if (step % 5 == 3) {
+            REQUIRE(l.remove(x) == (ref.erase(x) == 1));
+        } else {
+            REQUIRE(l.search(x) == (ref.count(x) == 1));
+        }
+    }
+    REQUIRE(l.size() == ref.size());
+    REQUIRE(l.elements() == std::vector<int>(ref.begin(), ref.end()));
+    for (int x : std::vector<int>(ref.begin(), ref.end())) {
+        REQUIRE(l.remove(x));
+    }
+    REQUIRE(l.empty());
+    REQUIRE(!l.remove(3));
+    REQUIRE(l.pending() < 32);
+}
+
+TEST_CASE("testing strings in concurrent skip list") {
+    concurrent_skip_list<std::string> l({"delta", "alpha", "charlie", "bravo", "alpha"});
+    REQUIRE(l.size() == 4);
+    REQUIRE(l.elements() == std::vector<std::string>{"alpha", "bravo", "charlie", "delta"});
+    REQUIRE(l.remove("charlie"));
+    REQUIRE(!l.search("charlie"));
+    REQUIRE(l.search("delta"));
+}
+
+TEST_CASE("testing concurrent inserts and removes in concurrent skip list") {
+    concurrent_skip_list<int> l;
+    const int threads = 4, n = 4000;
+    std::atomic<int> inserted{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            // every thread inserts the whole range, so each key is raced for
+            for (int i = 0; i < n; i++) {
+                int x = (i * 7 + t * 13) % n;
+                if (l.insert(x)) {
+                    inserted++;
+                }
+            }
+        });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    pool.clear();
+    REQUIRE(inserted == n);
+    REQUIRE(l.size() == size_t(n));
+
+    std::atomic<int> removed{0};
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            for (int i = 0; i < n; i++) {
+                int x = (i * 11 + t * 5) % n;
+                if (x % 2 == 0 && l.remove(x)) {
+                    removed++;
+                }
+                // readers run next to the removers and every odd key stays
+                if (x % 2 == 1 && !l.search(x)) {
+                    removed += n;
+                }
+            }
+        });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    REQUIRE(removed == n / 2);
+    std::vector<int> odd;
+    for (int i = 1; i < n; i += 2) {
+        odd.push_back(i);
+    }
+    REQUIRE(l.elements() == odd);
+}
+
+TEST_CASE("testing mixed traffic in concurrent skip list") {
+    concurrent_skip_list<int> l;
+    const int threads = 4, keys = 256;
+    std::vector<std::thread> pool;
+    std::vector<int> balance(keys * threads, 0);
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            uint32_t state = 91 + t;
+            for (int step = 0; step < 20000; step++) {
+                state = state * 1103515245u + 12345u;
+                int x = int((state >> 8) % keys);
+                if (state & 1) {
+                    balance[t * keys + x] += l.insert(x);
+                } else {
+                    balance[t * keys + x] -= l.remove(x);
+                }
+            }
+        });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    // a key is in the list iff its successful inserts outnumber its successful removes
+    std::vector<int> expected;
+    for (int x = 0; x < keys; x++) {
+        int b = 0;
+        for (int t = 0; t < threads; t++) {
+            b += balance[t * keys + x];
+        }
+        REQUIRE((b == 0 || b == 1));
+        if (b == 1) {
+            expected.push_back(x);
+        }
+    }
+    REQUIRE(l.elements() == expected);
+    REQUIRE(l.size() == expected.size());
+}
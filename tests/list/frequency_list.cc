@@ -82,3 +82,95 @@ TEST_CASE("Testing frequency list visualization") {
     frequency_list<char> flist({'a', 'b', 'c', 'd', 'e', 'f'});
     CHECK_NOTHROW(flist.visualize());
 }
+
+TEST_CASE("Testing the order of the frequency list") {
+    frequency_list<int> flist({1, 2, 3, 4});
+    flist.search(3);
+    flist.search(3);
+    flist.search(2);
+    flist.push_back(5);
+    flist.push_front(6);
+    std::vector<std::pair<int, int64_t>> v = {{3, 3}, {2, 2}, {6, 1}, {1, 1},
+                                              {4, 1}, {5, 1}};
+    REQUIRE(flist.elements() == v);
+    REQUIRE(flist.size() == 6);
+
+    std::vector<int> back;
+    auto it = flist.begin();
+    for (int i = 0; i < 5; i++) {
+        it++;
+    }
+    for (int i = 0; i < 6; i++) {
+        back.push_back(*it);
+        it--;
+    }
+    REQUIRE(back == std::vector<int>{5, 4, 1, 6, 2, 3});
+
+    flist.reset_frequency();
+    v = {{3, 1}, {2, 1}, {6, 1}, {1, 1}, {4, 1}, {5, 1}};
+    REQUIRE(flist.elements() == v);
+    REQUIRE(flist.touch(4) == 2);
+    REQUIRE(*flist.begin() == 4);
+}
+
+TEST_CASE("Testing evictions and aging in frequency list") {
+    frequency_list<std::string> flist;
+    REQUIRE(!flist.evict_least_frequent().has_value());
+    for (int i = 0; i < 5; i++) {
+        flist.touch("old");
+    }
+    flist.touch("a");
+    flist.touch("b");
+    flist.touch("b");
+    // the least frequent elements go first, the oldest first among equals
+    REQUIRE(flist.least_frequent() == "a");
+    REQUIRE(flist.evict_least_frequent() == "a");
+    REQUIRE(flist.age() == 1);
+    REQUIRE(flist.evict_least_frequent() == "b");
+    REQUIRE(flist.age() == 2);
+
+    // a new element starts above the age, so a few accesses beat an old popular one
+    for (int i = 0; i < 3; i++) {
+        flist.touch("new");
+    }
+    REQUIRE(flist.get_frequency("new") == 3);
+    REQUIRE(*flist.begin() == "old");
+    flist.touch("new");
+    REQUIRE(*flist.begin() == "new");
+    REQUIRE(flist.evict_least_frequent() == "old");
+    REQUIRE(flist.size() == 1);
+
+    frequency_list<std::string> copy(flist);
+    copy.touch("c");
+    REQUIRE(flist.size() == 1);
+    REQUIRE(copy.elements() == std::vector<std::pair<std::string, int64_t>>{{"new", 4}, {"c", 1}});
+    frequency_list<std::string> moved(std::move(copy));
+    REQUIRE(moved.size() == 2);
+    REQUIRE(copy.empty());
+}
+
+TEST_CASE("Testing frequency list against a reference") {
+    frequency_list<int> flist;
+    std::vector<int64_t> freq(200, 0);
+    uint32_t state = 60;
+    for (int step = 0; step < 20000; step++) {
+        state = state * 1103515245u + 12345u;
+        int x = int((state >> 8) % 200);
+        if (step % 7 == 0) {
+            flist.erase(x);
+            freq[x] = 0;
+        } else {
+            REQUIRE(flist.touch(x) == ++freq[x]);
+        }
+    }
+    // no eviction happened, so the order is by frequency
+    int64_t last = INT64_MAX;
+    size_t n = 0;
+    for (auto& [x, f] : flist.elements()) {
+        REQUIRE(f == freq[x]);
+        REQUIRE(f <= last);
+        last = f;
+        n++;
+    }
+    REQUIRE(n == size_t(200 - std::count(freq.begin(), freq.end(), 0)));
+}
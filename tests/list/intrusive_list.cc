@@ -0,0 +1,142 @@
+#include "../../src/classes/list/intrusive_list.h"
+#include "../../third_party/catch.hpp"
+#include <string>
+#include <vector>
+
+namespace {
+struct lru_tag;
+struct tenant_tag;
+
+struct item : intrusive_list_hook<lru_tag>, intrusive_list_hook<tenant_tag> {
+    int id;
+    explicit item(int id) : id(id) {}
+};
+
+struct value : intrusive_list_hook<> {
+    int x;
+    explicit value(int x) : x(x) {}
+};
+
+template <typename L> std::vector<int> ids(const L& l) {
+    std::vector<int> v;
+    for (const auto& x : l) {
+        v.push_back(x.id);
+    }
+    return v;
+}
+} // namespace
+
+TEST_CASE("Testing push_back() and push_front() intrusive_list") {
+    value a(1), b(2), c(3);
+    intrusive_list<value> l;
+
+    REQUIRE(l.empty() == true);
+    l.push_back(b);
+    l.push_front(a);
+    l.push_back(c);
+    REQUIRE(l.size() == 3);
+    REQUIRE(l.front().x == 1);
+    REQUIRE(l.back().x == 3);
+    REQUIRE(a.is_linked() == true);
+
+    std::vector<int> v;
+    for (auto it = l.end(); it != l.begin();) {
+        v.push_back((--it)->x);
+    }
+    REQUIRE(v == std::vector<int>{3, 2, 1});
+    l.clear();
+    REQUIRE(l.empty() == true);
+    REQUIRE(a.is_linked() == false);
+}
+
+TEST_CASE("Testing erase() by reference intrusive_list") {
+    std::vector<item> items;
+    for (int i = 0; i < 5; i++) {
+        items.emplace_back(i);
+    }
+    intrusive_list<item, lru_tag> l;
+    for (item& x : items) {
+        l.push_back(x);
+    }
+
+    l.erase(items[2]);
+    REQUIRE(ids(l) == std::vector<int>{0, 1, 3, 4});
+    l.erase(items[0]);
+    l.erase(items[4]);
+    REQUIRE(ids(l) == std::vector<int>{1, 3});
+    REQUIRE(l.pop_front().id == 1);
+    REQUIRE(l.pop_back().id == 3);
+    REQUIRE(l.empty() == true);
+}
+
+TEST_CASE("Testing insert() and erase() by iterator intrusive_list") {
+    std::vector<item> items{item(0), item(1), item(2)};
+    intrusive_list<item, lru_tag> l;
+
+    l.push_back(items[0]);
+    l.push_back(items[2]);
+    auto it = l.insert(l.iterator_to(items[2]), items[1]);
+    REQUIRE(it->id == 1);
+    REQUIRE(ids(l) == std::vector<int>{0, 1, 2});
+    it = l.erase(it);
+    REQUIRE(it->id == 2);
+    REQUIRE(ids(l) == std::vector<int>{0, 2});
+    l.clear();
+}
+
+TEST_CASE("Testing splice() intrusive_list") {
+    std::vector<item> items;
+    for (int i = 0; i < 6; i++) {
+        items.emplace_back(i);
+    }
+    intrusive_list<item, lru_tag> a, b;
+    for (int i = 0; i < 3; i++) {
+        a.push_back(items[i]);
+        b.push_back(items[i + 3]);
+    }
+
+    a.splice(a.iterator_to(items[1]), b);
+    REQUIRE(ids(a) == std::vector<int>{0, 3, 4, 5, 1, 2});
+    REQUIRE(b.empty() == true);
+    REQUIRE(a.size() == 6);
+
+    // move to the front, as an lru does on a hit
+    a.splice(a.begin(), a, items[2]);
+    REQUIRE(ids(a) == std::vector<int>{2, 0, 3, 4, 5, 1});
+    b.splice(b.end(), a, items[4]);
+    REQUIRE(ids(b) == std::vector<int>{4});
+    REQUIRE(a.size() == 5);
+
+    intrusive_list<item, lru_tag> c(std::move(a));
+    REQUIRE(a.empty() == true);
+    REQUIRE(ids(c) == std::vector<int>{2, 0, 3, 5, 1});
+    b.erase(items[4]);
+    c.push_front(items[4]);
+    REQUIRE(c.front().id == 4);
+    c.clear();
+}
+
+TEST_CASE("Testing objects in many intrusive_lists") {
+    std::vector<item> items;
+    for (int i = 0; i < 6; i++) {
+        items.emplace_back(i);
+    }
+    intrusive_list<item, lru_tag> lru;
+    intrusive_list<item, tenant_tag> even, odd;
+    for (item& x : items) {
+        lru.push_front(x);
+        (x.id % 2 == 0 ? even : odd).push_back(x);
+    }
+
+    // evicting from the lru also takes the item out of its tenant queue
+    item& victim = lru.pop_back();
+    REQUIRE(victim.id == 0);
+    even.erase(victim);
+    REQUIRE(ids(lru) == std::vector<int>{5, 4, 3, 2, 1});
+    REQUIRE(ids(even) == std::vector<int>{2, 4});
+    REQUIRE(ids(odd) == std::vector<int>{1, 3, 5});
+    REQUIRE(static_cast<intrusive_list_hook<lru_tag>&>(items[3]).is_linked() == true);
+    lru.clear();
+    even.clear();
+    odd.clear();
+}
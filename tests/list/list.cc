@@ -120,3 +120,39 @@ TEST_CASE("Testing linked list visualization") {
 
     CHECK_NOTHROW(l.visualize());
 }
+
+TEST_CASE("testing erase of the first and the last element in single list") {
+    linked_list<int> l({1, 2, 3, 1});
+    l.erase(1);
+    REQUIRE(l.elements() == std::vector<int>{2, 3, 1});
+    REQUIRE(l.search(1) == true);
+    l.erase(1);
+    REQUIRE(l.elements() == std::vector<int>{2, 3});
+    l.push_back(4);
+    REQUIRE(l.elements() == std::vector<int>{2, 3, 4});
+    REQUIRE(l.size() == 3);
+    l.erase(2);
+    l.erase(3);
+    l.erase(4);
+    REQUIRE(l.empty());
+    l.push_front(5);
+    l.push_back(6);
+    REQUIRE(l.elements() == std::vector<int>{5, 6});
+}
+
+TEST_CASE("testing deep copies and tail after reverse in single list") {
+    linked_list<std::string> l({"a", "b", "c"});
+    linked_list<std::string> l2(l);
+    l2.erase("b");
+    REQUIRE(l.elements() == std::vector<std::string>{"a", "b", "c"});
+    REQUIRE(l2.elements() == std::vector<std::string>{"a", "c"});
+    l2 = l;
+    l.erase("a");
+    REQUIRE(l2.size() == 3);
+    l2.reverse();
+    l2.push_back("z");
+    REQUIRE(l2.elements() == std::vector<std::string>{"c", "b", "a", "z"});
+    linked_list<std::string> l3(std::move(l2));
+    REQUIRE(l3.size() == 4);
+    REQUIRE(l2.empty());
+}
@@ -1,5 +1,8 @@
 #include "../../src/classes/list/skip_list.h"
 #include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <set>
+#include <sstream>
 #include <string>
 
 TEST_CASE("testing search in skip list") {
@@ -69,3 +72,132 @@ TEST_CASE("testing copy constructors in skip list") {
 
     REQUIRE(v1 == v2);
 }
+
+TEST_CASE("testing skip list against std::set") {
+    skip_list<int> s(16, 0.5);
+    std::set<int> ref;
+    uint32_t state = 58;
+    for (int step = 0; step < 20000; step++) {
+        state = state * 1103515245u + 12345u;
+        int x = int((state >> 8) % 3000);
+        if (step % 4 < 2) {
+            s.insert(x);
+            ref.insert(x);
+        } else if (step % 4 == 2) {
+            s.remove(x);
+            ref.erase(x);
+        } else {
+            REQUIRE(s.search(x) == (ref.count(x) == 1));
+        }
+    }
+    REQUIRE(s.size() == ref.size());
+    std::vector<int> v;
+    for (auto it = s.begin(); it != s.end(); it++) {
+        v.push_back(*it);
+    }
+    REQUIRE(v == std::vector<int>(ref.begin(), ref.end()));
+}
+
+TEST_CASE("testing deep copies and moves in skip list") {
+    skip_list<std::string> s(8, 0.25);
+    for (std::string x : {"delta", "alpha", "charlie", "bravo"}) {
+        s.insert(x);
+    }
+    skip_list<std::string> s2(s);
+    s2.remove("alpha");
+    s2.insert("echo");
+    REQUIRE(s.search("alpha"));
+    REQUIRE(!s.search("echo"));
+    REQUIRE(s2.search("echo"));
+    REQUIRE(s2.size() == 4);
+
+    s2 = s;
+    REQUIRE(s2.search("alpha"));
+    skip_list<std::string> s3(std::move(s2));
+    REQUIRE(s3.size() == 4);
+    REQUIRE(s2.empty());
+    std::vector<std::string> v;
+    for (auto it = s3.begin(); it != s3.end(); it++) {
+        v.push_back(*it);
+    }
+    REQUIRE(v == std::vector<std::string>{"alpha", "bravo", "charlie", "delta"});
+}
+
+TEST_CASE("testing the levels of skip list") {
+    // every level holds about PROB of the one below it
+    skip_list<int> s(20, 0.5);
+    for (int i = 0; i < 1 << 14; i++) {
+        s.insert(i);
+    }
+    std::ostringstream out;
+    out << s;
+    std::string str = out.str();
+    size_t levels = std::count(str.begin(), str.end(), '\n') - 1;
+    REQUIRE(levels >= 10);
+    REQUIRE(levels <= 21);
+
+    skip_list<int> s2(4, 0.3f);
+    for (int i = 0; i < 1000; i++) {
+        s2.insert(i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        s2.remove(i);
+    }
+    REQUIRE(s2.size() == 500);
+    REQUIRE(s2.search(999));
+    REQUIRE(!s2.search(998));
+}
+
+TEST_CASE("testing lower_bound and range in skip list") {
+    skip_list<int> s(16, 0.5);
+    for (int i = 0; i < 100; i += 3) {
+        s.insert(i);
+    }
+    REQUIRE(*s.lower_bound(10) == 12);
+    REQUIRE(*s.lower_bound(12) == 12);
+    REQUIRE(*s.lower_bound(-5) == 0);
+    REQUIRE(!(s.lower_bound(100) != s.end()));
+
+    std::vector<int> v;
+    for (int x : s.range(10, 30)) {
+        v.push_back(x);
+    }
+    REQUIRE(v == std::vector<int>{12, 15, 18, 21, 24, 27, 30});
+    v.clear();
+    for (int x : s.range(13, 14)) {
+        v.push_back(x);
+    }
+    REQUIRE(v.empty());
+    for (int x : s.range(90, 1000)) {
+        v.push_back(x);
+    }
+    REQUIRE(v == std::vector<int>{90, 93, 96, 99});
+}
+
+TEST_CASE("testing insert_sorted_batch in skip list") {
+    skip_list<int> s(20, 0.5);
+    std::set<int> ref;
+    uint32_t state = 59;
+    for (int batch = 0; batch < 20; batch++) {
+        std::vector<int> keys;
+        int x = int((state >> 8) % 1000);
+        for (int i = 0; i < 500; i++) {
+            state = state * 1103515245u + 12345u;
+            // mostly sorted: small steps forward, now and then a step back
+            x += state % 16 == 0 ? -int((state >> 8) % 50) : int((state >> 8) % 7);
+            keys.push_back(x);
+        }
+        size_t before = ref.size();
+        ref.insert(keys.begin(), keys.end());
+        REQUIRE(s.insert_sorted_batch(keys) == ref.size() - before);
+    }
+    REQUIRE(s.size() == ref.size());
+    std::vector<int> v;
+    for (auto it = s.begin(); it != s.end(); it++) {
+        v.push_back(*it);
+    }
+    REQUIRE(v == std::vector<int>(ref.begin(), ref.end()));
+    for (int x : ref) {
+        REQUIRE(s.search(x));
+    }
+}
@@ -0,0 +1,83 @@
+#include "../../third_party/catch.hpp"
+#include "../../src/classes/list/unrolled_linked_list.h"
+#include <list>
+#include <random>
+#include <string>
+
+TEST_CASE("testing push back and push front in unrolled list") {
+    unrolled_linked_list<int, 4> l;
+    for (int i = 0; i < 10; i++) {
+        l.push_back(i);
+    }
+    l.push_front(-1);
+    l.push_front(-2);
+    std::vector<int> v = {-2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    REQUIRE(l.elements() == v);
+    REQUIRE(l.size() == 12);
+    REQUIRE(l.chunks() == 4);
+}
+
+TEST_CASE("testing search and erase in unrolled list") {
+    unrolled_linked_list<std::string, 2> l({"hello", "world", "check", "world"});
+    REQUIRE(l.search("check") == true);
+    REQUIRE(l.search("chec") == false);
+    l.erase("world");
+    REQUIRE(l.elements() == std::vector<std::string>{"hello", "check", "world"});
+    l.erase("missing");
+    REQUIRE(l.size() == 3);
+    l.erase("hello");
+    l.erase("check");
+    l.erase("world");
+    REQUIRE(l.empty());
+    REQUIRE(l.chunks() == 0);
+    l.push_back("again");
+    REQUIRE(l.elements() == std::vector<std::string>{"again"});
+}
+
+TEST_CASE("testing iterators, copies and reverse in unrolled list") {
+    unrolled_linked_list<int, 3> l({4, 7, 1, 2, 3, 41, 32});
+    std::vector<int> v;
+    for (auto it = l.begin(); it != l.end(); it++) {
+        v.push_back(*(it));
+    }
+    REQUIRE(v == l.elements());
+
+    unrolled_linked_list<int, 3> l2(l);
+    l2.erase(4);
+    REQUIRE(l.elements() == v);
+    l2 = l;
+    l2.reverse();
+    l2.push_back(100);
+    REQUIRE(l2.elements() == std::vector<int>{32, 41, 3, 2, 1, 7, 4, 100});
+    unrolled_linked_list<int, 3> l3(std::move(l2));
+    REQUIRE(l3.size() == 8);
+    REQUIRE(l2.empty());
+}
+
+TEST_CASE("testing unrolled list against std::list") {
+    std::mt19937 rng(56);
+    unrolled_linked_list<int, 8> l;
+    std::list<int> ref;
+    for (int i = 0; i < 5000; i++) {
+        int op = rng() % 4, x = rng() % 64;
+        if (op == 0) {
+            l.push_back(x);
+            ref.push_back(x);
+        } else if (op == 1) {
+            l.push_front(x);
+            ref.push_front(x);
+        } else if (op == 2) {
+            l.erase(x);
+            auto it = std::find(ref.begin(), ref.end(), x);
+            if (it != ref.end()) {
+                ref.erase(it);
+            }
+        } else {
+            REQUIRE(l.search(x) == (std::find(ref.begin(), ref.end(), x) != ref.end()));
+        }
+    }
+    REQUIRE(l.elements() == std::vector<int>(ref.begin(), ref.end()));
+    REQUIRE(l.size() == ref.size());
+    // every chunk but the ones erases left behind holds at least half of K
+    REQUIRE(l.chunks() <= ref.size() / 4 + 1 + ref.size() / 8 + 1);
+}
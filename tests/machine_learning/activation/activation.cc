@@ -1,5 +1,8 @@
 #include "../../../third_party/catch.hpp"
 #include "../../../src/machine_learning/activation/activation_functions.h"
+#include <cmath>
+#include <span>
+#include <vector>
 
 TEST_CASE("Testing ReLU activation function") {
     double x = 0.01;
@@ -29,3 +32,49 @@ TEST_CASE("Testing softmax activation function") {
         REQUIRE(check[i] == Approx(probs[i]).epsilon(1e-1));
     }
 }
+
+TEST_CASE("Testing the activation functions in place") {
+    std::vector<double> x;
+    for (int i = -40; i <= 40; i++) {
+        x.push_back(i * 0.77);
+    }
+    std::vector<double> s = x, t = x, r = x;
+    std::vector<float> f(x.begin(), x.end());
+    activation::sigmoid(std::span<double>(s));
+    activation::tanh(std::span<double>(t));
+    activation::ReLU(std::span<double>(r));
+    activation::sigmoid(std::span<float>(f));
+    for (size_t i = 0; i < x.size(); i++) {
+        REQUIRE(s[i] == Approx(activation::sigmoid(x[i])).epsilon(1e-12));
+        REQUIRE(std::abs(t[i] - std::tanh(x[i])) < 1e-13);
+        REQUIRE(r[i] == activation::ReLU(x[i]));
+        REQUIRE(f[i] == Approx(activation::sigmoid(x[i])).epsilon(1e-5));
+    }
+}
+
+TEST_CASE("Testing softmax and log softmax in place") {
+    // logits whose exponentials overflow a double
+    std::vector<double> logits = {1000.0, 1001.0, 998.0,  1000.5, 990.0,
+                                  1002.0, 999.0,  1001.5, 997.0};
+    std::vector<double> probs = logits, logs = logits;
+    double lse = activation::softmax(std::span<double>(probs));
+    REQUIRE(activation::log_softmax(std::span<double>(logs)) == Approx(lse));
+    double sum = 0;
+    for (size_t i = 0; i < logits.size(); i++) {
+        double expected = 0;
+        for (double l : logits) {
+            expected += std::exp(l - logits[i]);
+        }
+        REQUIRE(probs[i] == Approx(1.0 / expected).epsilon(1e-12));
+        REQUIRE(logs[i] == Approx(std::log(probs[i])).epsilon(1e-12));
+        REQUIRE(lse - logits[i] == Approx(-std::log(probs[i])).epsilon(1e-12));
+        sum += probs[i];
+    }
+    REQUIRE(sum == Approx(1.0).epsilon(1e-12));
+
+    std::vector<float> f(logits.begin(), logits.end());
+    activation::softmax(std::span<float>(f));
+    for (size_t i = 0; i < logits.size(); i++) {
+        REQUIRE(f[i] == Approx(probs[i]).epsilon(1e-4));
+    }
+}
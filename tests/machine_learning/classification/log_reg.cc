@@ -0,0 +1,112 @@
+#include "../../../src/machine_learning/classification/logistic_regression/log_reg.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+// rows whose label is drawn from sigmoid(w.x + 0.5), half of the features left at zero
+void draw_dataset(size_t n, size_t d, Matrix<double>& x, std::vector<double>& y) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> u(-1, 1);
+    std::vector<double> w(d);
+    for (double& v : w) {
+        v = 3 * u(rng);
+    }
+    x.resize(n, d);
+    y.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        double z = 0.5;
+        for (size_t j = 0; j < d; j++) {
+            x(i, j) = (i + j) % 2 ? u(rng) : 0.0;
+            z += w[j] * x(i, j);
+        }
+        y[i] = u(rng) < std::tanh(z / 2) ? 1.0 : 0.0;
+    }
+}
+
+double accuracy(const std::vector<double>& guess, const std::vector<double>& y) {
+    size_t right = 0;
+    for (size_t i = 0; i < y.size(); i++) {
+        right += guess[i] == y[i];
+    }
+    return double(right) / double(y.size());
+}
+} // namespace
+
+TEST_CASE("Testing the solvers of logistic_regression_fit") {
+    Matrix<double> x;
+    std::vector<double> y;
+    draw_dataset(4000, 12, x, y);
+
+    logistic_regression_options opt;
+    logistic_regression_result lbfgs = logistic_regression_fit(x, y, opt);
+    REQUIRE(lbfgs.converged);
+    REQUIRE(lbfgs.weights.size() == 12);
+    REQUIRE(accuracy(lbfgs.predict(x), y) > 0.75);
+
+    opt.solver = logistic_solver::gradient_descent;
+    opt.learning_rate = 2.0;
+    opt.max_iterations = 500;
+    logistic_regression_result gd = logistic_regression_fit(x, y, opt);
+    REQUIRE(gd.loss >= lbfgs.loss - 1e-9);
+    REQUIRE(gd.loss - lbfgs.loss < 1e-3);
+
+    opt.solver = logistic_solver::minibatch;
+    opt.learning_rate = 0.5;
+    opt.batch_size = 64;
+    opt.max_iterations = 30;
+    logistic_regression_result sgd = logistic_regression_fit(x, y, opt);
+    REQUIRE(sgd.loss - lbfgs.loss < 1e-2);
+
+    std::vector<double> p = lbfgs.predict_proba(x, 3);
+    for (size_t i = 0; i < p.size(); i++) {
+        REQUIRE(p[i] > 0.0);
+        REQUIRE(p[i] < 1.0);
+    }
+
+    // the penalty pulls the weights in
+    opt = logistic_regression_options{};
+    opt.l2 = 1.0;
+    logistic_regression_result ridge = logistic_regression_fit(x, y, opt);
+    double a = 0, b = 0;
+    for (size_t j = 0; j < 12; j++) {
+        a += lbfgs.weights[j] * lbfgs.weights[j];
+        b += ridge.weights[j] * ridge.weights[j];
+    }
+    REQUIRE(b < a);
+}
+
+TEST_CASE("Testing logistic_regression_fit on sparse rows and several threads") {
+    Matrix<double> x;
+    std::vector<double> y;
+    draw_dataset(3000, 20, x, y);
+    coo_matrix<double> coo(x.rows(), x.cols());
+    for (size_t i = 0; i < x.rows(); i++) {
+        for (size_t j = 0; j < x.cols(); j++) {
+            if (x(i, j) != 0) {
+                coo.add(i, j, x(i, j));
+            }
+        }
+    }
+    csr_matrix<double> sparse(coo);
+
+    logistic_regression_options opt;
+    opt.threads = 1;
+    logistic_regression_result dense = logistic_regression_fit(x, y, opt);
+    opt.threads = 4;
+    logistic_regression_result csr = logistic_regression_fit(sparse, y, opt);
+    REQUIRE(csr.converged);
+    REQUIRE(std::abs(csr.bias - dense.bias) < 1e-4);
+    for (size_t j = 0; j < 20; j++) {
+        REQUIRE(std::abs(csr.weights[j] - dense.weights[j]) < 1e-4);
+    }
+    REQUIRE(csr.predict(sparse) == dense.predict(x));
+
+    std::vector<double> bad = y;
+    bad[0] = 2;
+    REQUIRE_THROWS_AS(logistic_regression_fit(x, bad, opt), std::invalid_argument);
+    REQUIRE_THROWS_AS(logistic_regression_fit(x, std::vector<double>(3), opt),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(dense.predict(Matrix<double>(2, 3)), std::invalid_argument);
+}
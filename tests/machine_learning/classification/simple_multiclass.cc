@@ -0,0 +1,106 @@
+#include "../../../src/machine_learning/classification/multiclass_classification/simple_multiclass.h"
+#include "../../../third_party/catch.hpp"
+#include <random>
+#include <vector>
+
+namespace {
+// gaussian blobs around a center per class, far enough apart to be separable
+void blobs(size_t n, size_t d, size_t classes, Matrix<double>& x, std::vector<double>& y) {
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> noise(0, 0.3);
+    std::uniform_real_distribution<double> u(-4, 4);
+    Matrix<double> centers(classes, d);
+    for (size_t i = 0; i < centers.size(); i++) {
+        centers.data()[i] = u(rng);
+    }
+    x.resize(n, d);
+    y.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        y[i] = double(i % classes);
+        for (size_t j = 0; j < d; j++) {
+            x(i, j) = centers(i % classes, j) + noise(rng);
+        }
+    }
+}
+
+double accuracy(const std::vector<double>& a, const std::vector<double>& b) {
+    size_t same = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        same += a[i] == b[i];
+    }
+    return double(same) / double(a.size());
+}
+} // namespace
+
+TEST_CASE("Testing one vs rest and one vs one multiclass_fit") {
+    Matrix<double> x;
+    std::vector<double> y;
+    blobs(600, 5, 6, x, y);
+
+    for (multiclass_strategy s :
+         {multiclass_strategy::one_vs_rest, multiclass_strategy::one_vs_one}) {
+        multiclass_options opt;
+        opt.strategy = s;
+        opt.threads = 1;
+        multiclass_result serial = multiclass_fit(x, y, opt);
+        REQUIRE(serial.classes == 6);
+        REQUIRE(serial.weights.rows() == (s == multiclass_strategy::one_vs_rest ? 6 : 15));
+        REQUIRE(serial.pairs.size() == (s == multiclass_strategy::one_vs_rest ? 0 : 15));
+        REQUIRE(accuracy(serial.predict(x), y) > 0.97);
+
+        // the classifiers are independent, so the threads change nothing
+        opt.threads = 4;
+        multiclass_result parallel = multiclass_fit(x, y, opt);
+        for (size_t i = 0; i < serial.weights.size(); i++) {
+            REQUIRE(parallel.weights.data()[i] == serial.weights.data()[i]);
+        }
+        REQUIRE(parallel.bias == serial.bias);
+        REQUIRE(parallel.predict(x, 3) == serial.predict(x));
+
+        // the batched prediction agrees with the scores of every classifier
+        Matrix<double> z = serial.decision_function(x, 2);
+        REQUIRE(z.rows() == x.rows());
+        REQUIRE(z.cols() == serial.weights.rows());
+        std::vector<double> pred = serial.predict(x);
+        if (s == multiclass_strategy::one_vs_rest) {
+            for (size_t i = 0; i < x.rows(); i++) {
+                size_t best = 0;
+                for (size_t c = 1; c < z.cols(); c++) {
+                    best = z(i, c) > z(i, best) ? c : best;
+                }
+                REQUIRE(pred[i] == double(best));
+            }
+        }
+    }
+}
+
+TEST_CASE("Testing multiclass_fit on sparse rows and bad labels") {
+    Matrix<double> x;
+    std::vector<double> y;
+    blobs(300, 4, 3, x, y);
+    coo_matrix<double> coo(x.rows(), x.cols());
+    for (size_t i = 0; i < x.rows(); i++) {
+        for (size_t j = 0; j < x.cols(); j++) {
+            coo.add(i, j, x(i, j));
+        }
+    }
+    csr_matrix<double> sparse(coo);
+    multiclass_options opt;
+    opt.strategy = multiclass_strategy::one_vs_one;
+    multiclass_result dense = multiclass_fit(x, y, opt);
+    multiclass_result csr = multiclass_fit(sparse, y, opt);
+    for (size_t i = 0; i < dense.weights.size(); i++) {
+        REQUIRE(csr.weights.data()[i] == Approx(dense.weights.data()[i]).margin(1e-4));
+    }
+    REQUIRE(accuracy(csr.predict(sparse), dense.predict(x)) > 0.99);
+
+    REQUIRE_THROWS_AS(multiclass_fit(x, std::vector<double>(5, 0.0)), std::invalid_argument);
+    std::vector<double> bad = y;
+    bad[0] = 0.5;
+    REQUIRE_THROWS_AS(multiclass_fit(x, bad), std::invalid_argument);
+    // class 3 is missing below class 4
+    bad = y;
+    bad[0] = 4;
+    REQUIRE_THROWS_AS(multiclass_fit(x, bad), std::invalid_argument);
+    REQUIRE_THROWS_AS(dense.predict(Matrix<double>(2, 3)), std::invalid_argument);
+}
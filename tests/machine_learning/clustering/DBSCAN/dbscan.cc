@@ -1,5 +1,6 @@
 #include "../../../../src/machine_learning/clustering/DBSCAN/dbscan.h"
 #include "../../../../third_party/catch.hpp"
+#include <random>
 #include <vector>
 
 TEST_CASE("Testing clustering [1] DBSCAN") {
@@ -36,3 +37,144 @@ TEST_CASE("Testing noise in [1] DBSCAN") {
         REQUIRE(x.second == check[x.first]);
     }
 }
+
+TEST_CASE("Testing DBSCAN clusters against their definition") {
+    std::mt19937_64 rng(100);
+    std::uniform_real_distribution<double> u(0, 20);
+    std::vector<std::pair<double, double>> v(600);
+    for (auto& p : v) {
+        p = {u(rng), u(rng)};
+    }
+    double eps = 0.7;
+    int64_t min_pts = 4;
+    DBSCAN a(v, eps, min_pts);
+    std::map<std::pair<double, double>, int64_t> clusters = a.get_clusters();
+    REQUIRE(clusters.size() + a.get_noise().size() == v.size());
+    // the queries on another dataset than the one of the object scan it
+    std::vector<std::vector<size_t>> near(v.size());
+    for (size_t i = 0; i < v.size(); i++) {
+        for (size_t j = 0; j < v.size(); j++) {
+            if (a.dist(v[i], v[j]) <= eps) {
+                near[i].push_back(j);
+            }
+        }
+        REQUIRE(a.get_query(v, v[i], eps).size() == near[i].size());
+    }
+    for (size_t i = 0; i < v.size(); i++) {
+        bool core = int64_t(near[i].size()) >= min_pts;
+        if (core) {
+            // a core point and its neighbours are in its cluster
+            REQUIRE(clusters.count(v[i]) == 1);
+            for (size_t j : near[i]) {
+                REQUIRE(clusters.count(v[j]) == 1);
+                if (int64_t(near[j].size()) >= min_pts) {
+                    REQUIRE(clusters[v[j]] == clusters[v[i]]);
+                }
+            }
+        } else if (clusters.count(v[i]) == 1) {
+            // a border point is next to a core point of its cluster
+            bool found = false;
+            for (size_t j : near[i]) {
+                found = found || (int64_t(near[j].size()) >= min_pts &&
+                                  clusters[v[j]] == clusters[v[i]]);
+            }
+            REQUIRE(found);
+        }
+    }
+}
+
+TEST_CASE("Testing the labels of DBSCAN") {
+    // duplicates get the label of their copies, a border point joins the first cluster
+    // that reaches it
+    std::vector<std::pair<double, double>> v = {{0, 0}, {0, 0},   {0.5, 0}, {1, 0},
+                                                {9, 9}, {9, 9.5}, {9.5, 9}, {30, 30}};
+    DBSCAN a(v, 0.6, 3);
+    const std::vector<int64_t>& labels = a.get_labels();
+    REQUIRE(labels.size() == v.size());
+    REQUIRE(labels == std::vector<int64_t>{0, 0, 0, 0, 1, 1, 1, -1});
+    REQUIRE(a.get_noise() == std::vector<std::pair<double, double>>{{30, 30}});
+
+    // Eps without a grid scans the dataset
+    DBSCAN b(v, 0, 2);
+    REQUIRE(b.get_labels() == std::vector<int64_t>{0, 0, -1, -1, -1, -1, -1, -1});
+
+    DBSCAN empty({}, 1, 1);
+    REQUIRE(empty.get_labels().empty());
+    REQUIRE(empty.get_clusters().empty());
+}
+
+TEST_CASE("Testing dbscan_fit against DBSCAN") {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> u(0, 20);
+    std::vector<std::pair<double, double>> v(800);
+    Matrix<double> points(v.size(), 2);
+    for (size_t i = 0; i < v.size(); i++) {
+        v[i] = {u(rng), u(rng)};
+        points(i, 0) = v[i].first;
+        points(i, 1) = v[i].second;
+    }
+    DBSCAN serial(v, 0.8, 5);
+    dbscan_options opt;
+    opt.eps = 0.8;
+    opt.min_points = 5;
+    opt.threads = 1;
+    dbscan_result one = dbscan_fit(points, opt);
+    opt.threads = 4;
+    dbscan_result four = dbscan_fit(points, opt);
+    REQUIRE(one.labels == four.labels);
+    REQUIRE(one.core == four.core);
+
+    // the same noise, and the core points split into the same clusters
+    const std::vector<int64_t>& expected = serial.get_labels();
+    std::map<int64_t, int64_t> rename;
+    for (size_t i = 0; i < v.size(); i++) {
+        REQUIRE((one.labels[i] == -1) == (expected[i] == -1));
+        bool core = int64_t(serial.get_query(v, v[i], 0.8).size()) >= 5;
+        REQUIRE(bool(one.core[i]) == core);
+        if (core) {
+            auto [it, inserted] = rename.emplace(one.labels[i], expected[i]);
+            REQUIRE(it->second == expected[i]);
+        }
+    }
+    REQUIRE(one.clusters == rename.size());
+}
+
+TEST_CASE("Testing dbscan_fit in 32 dimensions with a metric") {
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> noise(0, 0.05);
+    const size_t d = 32, per = 100;
+    Matrix<double> points(3 * per + 1, d);
+    for (size_t c = 0; c < 3; c++) {
+        for (size_t i = 0; i < per; i++) {
+            for (size_t j = 0; j < d; j++) {
+                points(c * per + i, j) = (j % 3 == c ? 5.0 : 0.0) + noise(rng);
+            }
+        }
+    }
+    for (size_t j = 0; j < d; j++) {
+        points(3 * per, j) = 100;
+    }
+    auto manhattan = [](std::span<const double> a, std::span<const double> b) {
+        return metrics::manhattan_distance(a, b);
+    };
+    dbscan_options opt;
+    opt.eps = 3;
+    opt.min_points = 4;
+    opt.threads = 3;
+    dbscan_result scan = dbscan_fit(points, opt, manhattan);
+    opt.coordinate_bound = true;
+    dbscan_result sorted = dbscan_fit(points, opt, manhattan);
+    REQUIRE(scan.labels == sorted.labels);
+    REQUIRE(scan.clusters == 3);
+    for (size_t c = 0; c < 3; c++) {
+        for (size_t i = 0; i < per; i++) {
+            REQUIRE(scan.labels[c * per + i] == int64_t(c));
+        }
+    }
+    REQUIRE(scan.labels.back() == -1);
+    REQUIRE(dbscan_fit(points, {1.0, 4, 2}).labels == scan.labels);
+
+    opt.eps = -1;
+    REQUIRE_THROWS_AS(dbscan_fit(points, opt), std::invalid_argument);
+    REQUIRE(dbscan_fit(Matrix<double>(0, 3)).labels.empty());
+}
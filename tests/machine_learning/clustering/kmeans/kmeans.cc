@@ -1,8 +1,212 @@
 #include "../../../../src/machine_learning/clustering/kmeans/kmeans.h"
 #include "../../../../third_party/catch.hpp"
+#include <cstdint>
+#include <random>
+#include <stdexcept>
 #include <vector>
 
-// TODO: fill test cases for kmeans clustering
+namespace {
+// n points around each of the centers, with a unit spread
+Matrix<double> blobs(const std::vector<std::vector<double>>& centers, size_t n, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    size_t d = centers[0].size();
+    Matrix<double> points(centers.size() * n, d);
+    for (size_t c = 0; c < centers.size(); c++) {
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < d; j++) {
+                points(c * n + i, j) = centers[c][j] + noise(gen);
+            }
+        }
+    }
+    return points;
+}
+} // namespace
+
 TEST_CASE("Testing clustering [1] kmeans") {
-    REQUIRE(true == true);
-}
\ No newline at end of file
+    std::vector<std::vector<double>> data = {{1, 1}, {1.5, 2}, {1, 1.5}, {9, 9}, {9.5, 8}, {8, 9}};
+    kmeans km(data, 2);
+    auto [centers, assignments] = km.fit();
+    REQUIRE(centers.size() == 2);
+    REQUIRE(assignments.size() == data.size());
+    // the two groups of the data end up in different clusters
+    REQUIRE(assignments[data[0]] == assignments[data[1]]);
+    REQUIRE(assignments[data[3]] == assignments[data[4]]);
+    REQUIRE(assignments[data[0]] != assignments[data[3]]);
+}
+
+TEST_CASE("Testing kmeans_fit on separated blobs") {
+    std::vector<std::vector<double>> centers = {{0, 0, 0}, {50, 0, 0}, {0, 50, 0}, {0, 0, 50}};
+    Matrix<double> points = blobs(centers, 200, 7);
+    kmeans_options opt;
+    opt.seed = 3;
+    opt.threads = 3;
+    kmeans_result result = kmeans_fit(points, 4, opt);
+    REQUIRE(result.converged);
+    REQUIRE(result.centroids.rows() == 4);
+    REQUIRE(result.labels.size() == points.rows());
+    // every blob is one cluster, and the clusters of the blobs differ
+    std::vector<int32_t> seen;
+    for (size_t c = 0; c < centers.size(); c++) {
+        int32_t label = result.labels[c * 200];
+        for (size_t i = 0; i < 200; i++) {
+            REQUIRE(result.labels[c * 200 + i] == label);
+        }
+        for (int32_t other : seen) {
+            REQUIRE(other != label);
+        }
+        seen.push_back(label);
+        for (size_t j = 0; j < 3; j++) {
+            REQUIRE(std::abs(result.centroids(label, j) - centers[c][j]) < 0.5);
+        }
+    }
+    REQUIRE(result.inertia > 0);
+}
+
+TEST_CASE("Testing kmeans_fit does not depend on the threads") {
+    Matrix<double> points = blobs({{0, 0}, {10, 10}, {-10, 10}}, 100, 11);
+    kmeans_options opt;
+    opt.seed = 5;
+    opt.threads = 1;
+    kmeans_result a = kmeans_fit(points, 3, opt);
+    opt.threads = 4;
+    kmeans_result b = kmeans_fit(points, 3, opt);
+    REQUIRE(a.labels == b.labels);
+    REQUIRE(a.iterations == b.iterations);
+    for (size_t c = 0; c < 3; c++) {
+        for (size_t j = 0; j < 2; j++) {
+            REQUIRE(a.centroids(c, j) == Approx(b.centroids(c, j)));
+        }
+    }
+}
+
+TEST_CASE("Testing kmeans_fit edge cases") {
+    Matrix<double> points(std::vector<std::vector<double>>{{1, 1}, {1, 1}, {1, 1}, {4, 4}});
+    REQUIRE_THROWS_AS(kmeans_fit(points, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(kmeans_fit(points, 5), std::invalid_argument);
+
+    kmeans_result one = kmeans_fit(points, 1);
+    REQUIRE(one.centroids(0, 0) == Approx(1.75));
+    REQUIRE(one.inertia == Approx(13.5));
+
+    // as many clusters as points, with duplicates
+    kmeans_result all = kmeans_fit(points, 4);
+    REQUIRE(all.labels.size() == 4);
+    REQUIRE(all.inertia == Approx(0).margin(1e-12));
+    for (int32_t label : all.labels) {
+        REQUIRE(label >= 0);
+        REQUIRE(label < 4);
+    }
+}
+
+TEST_CASE("Testing the kmeans distance kernel") {
+    std::vector<double> a(37), b(37);
+    double expected = 0;
+    for (size_t j = 0; j < a.size(); j++) {
+        a[j] = double(j) * 0.5;
+        b[j] = double(j * j % 7);
+        expected += (a[j] - b[j]) * (a[j] - b[j]);
+    }
+    for (size_t d : {0, 1, 3, 8, 9, 37}) {
+        double sum = 0;
+        for (size_t j = 0; j < d; j++) {
+            sum += (a[j] - b[j]) * (a[j] - b[j]);
+        }
+        REQUIRE(_kmeans_utils::distance2(a.data(), b.data(), d) == Approx(sum));
+    }
+    REQUIRE(_kmeans_utils::distance2(a.data(), b.data(), 37) == Approx(expected));
+}
+
+TEST_CASE("Testing minibatch_kmeans_fit on separated blobs") {
+    std::vector<std::vector<double>> centers = {{0, 0}, {40, 0}, {0, 40}};
+    Matrix<double> points = blobs(centers, 500, 13);
+    minibatch_kmeans_options opt;
+    opt.batch_size = 64;
+    opt.seed = 2;
+    opt.threads = 2;
+    kmeans_result result = minibatch_kmeans_fit(points, 3, opt);
+    REQUIRE(result.labels.size() == points.rows());
+    REQUIRE(result.iterations > 0);
+    for (size_t c = 0; c < centers.size(); c++) {
+        int32_t label = result.labels[c * 500];
+        for (size_t i = 0; i < 500; i++) {
+            REQUIRE(result.labels[c * 500 + i] == label);
+        }
+        for (size_t j = 0; j < 2; j++) {
+            REQUIRE(std::abs(result.centroids(label, j) - centers[c][j]) < 0.5);
+        }
+    }
+    REQUIRE_THROWS_AS(minibatch_kmeans_fit(points, 0), std::invalid_argument);
+}
+
+TEST_CASE("Testing minibatch_kmeans on a stream") {
+    minibatch_kmeans model(2, 1, 2);
+    REQUIRE(!model.fitted());
+    REQUIRE_THROWS_AS(model.predict(Matrix<double>(1, 2)), std::runtime_error);
+    REQUIRE_THROWS_AS(model.partial_fit(Matrix<double>(1, 2)), std::invalid_argument);
+    // a stream of batches from two blobs, each batch holds points of both
+    for (uint64_t s = 0; s < 20; s++) {
+        model.partial_fit(blobs({{-20, -20}, {20, 20}}, 16, s));
+    }
+    REQUIRE(model.fitted());
+    REQUIRE(model.counts()[0] + model.counts()[1] == 20 * 32);
+    REQUIRE_THROWS_AS(model.partial_fit(Matrix<double>(4, 3)), std::invalid_argument);
+    std::vector<int32_t> labels = model.predict(
+        Matrix<double>(std::vector<std::vector<double>>{{-19, -21}, {21, 19}, {-20, -18}}));
+    REQUIRE(labels[0] == labels[2]);
+    REQUIRE(labels[0] != labels[1]);
+    int32_t low = labels[0];
+    REQUIRE(model.centroids()(low, 0) == Approx(-20).margin(1));
+    REQUIRE(model.centroids()(1 - low, 1) == Approx(20).margin(1));
+}
+
+TEST_CASE("Testing kmeans with several threads") {
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < 50; i++) {
+        data.push_back({double(i % 5), double(i / 5 % 3)});
+        data.push_back({100 + double(i % 5), 100 + double(i / 5 % 3)});
+    }
+    kmeans km(data, 2, 100, 4);
+    auto [centers, assignments] = km.fit();
+    REQUIRE(centers.size() == 2);
+    REQUIRE(assignments[data[0]] != assignments[data[1]]);
+    REQUIRE(assignments[data[0]] == assignments[data[2]]);
+}
+
+TEST_CASE("Testing kmeans_fit with the hamerly and elkan bounds") {
+    std::vector<std::vector<double>> centers;
+    std::mt19937_64 gen(17);
+    std::uniform_real_distribution<double> spread(-100, 100);
+    for (size_t c = 0; c < 12; c++) {
+        centers.push_back({spread(gen), spread(gen), spread(gen), spread(gen), spread(gen)});
+    }
+    Matrix<double> points = blobs(centers, 60, 19);
+    kmeans_options opt;
+    opt.seed = 23;
+    opt.threads = 3;
+    opt.tolerance = 0;
+    kmeans_result lloyd = kmeans_fit(points, 20, opt);
+    REQUIRE(lloyd.skipped_distances == 0);
+    REQUIRE(lloyd.distance_computations == points.rows() * 20 * (lloyd.iterations + 1));
+    for (kmeans_algorithm algorithm : {kmeans_algorithm::hamerly, kmeans_algorithm::elkan}) {
+        opt.algorithm = algorithm;
+        kmeans_result bounded = kmeans_fit(points, 20, opt);
+        REQUIRE(bounded.labels == lloyd.labels);
+        REQUIRE(bounded.iterations == lloyd.iterations);
+        REQUIRE(bounded.converged == lloyd.converged);
+        REQUIRE(bounded.inertia == Approx(lloyd.inertia));
+        for (size_t i = 0; i < lloyd.centroids.size(); i++) {
+            REQUIRE(bounded.centroids.data()[i] == Approx(lloyd.centroids.data()[i]));
+        }
+        REQUIRE(bounded.distance_computations + bounded.skipped_distances ==
+                lloyd.distance_computations);
+        REQUIRE(bounded.skipped_distances > bounded.distance_computations);
+    }
+
+    // a single cluster needs no distance at all
+    opt.algorithm = kmeans_algorithm::elkan;
+    kmeans_result one = kmeans_fit(points, 1, opt);
+    REQUIRE(one.distance_computations == 0);
+    opt.algorithm = kmeans_algorithm::lloyd;
+    REQUIRE(one.inertia == Approx(kmeans_fit(points, 1, opt).inertia));
+}
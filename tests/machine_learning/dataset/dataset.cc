@@ -0,0 +1,186 @@
+#include "../../../src/machine_learning/dataset/dataset.h"
+#include "../../../src/machine_learning/classification/logistic_regression/log_reg.h"
+#include "../../../src/machine_learning/clustering/DBSCAN/dbscan.h"
+#include "../../../src/machine_learning/clustering/kmeans/kmeans.h"
+#include "../../../src/machine_learning/nn/mlp.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+// n x d points around two centers, labeled by their center
+void points(size_t n, size_t d, Matrix<double>& x, std::vector<double>& y) {
+    std::mt19937_64 rng(5);
+    std::normal_distribution<double> noise(0, 0.5);
+    x.resize(n, d);
+    y.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        y[i] = double(i % 2);
+        for (size_t j = 0; j < d; j++) {
+            x(i, j) = (i % 2 ? 3.0 : -3.0) + noise(rng);
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("testing dataset_view layouts") {
+    Matrix<double> m(3, 2);
+    for (size_t i = 0; i < 6; i++) {
+        m.data()[i] = double(i);
+    }
+    dataset_view rows = m;
+    REQUIRE(rows.row_major());
+    REQUIRE(rows.data() == m.data());
+    REQUIRE(rows(2, 1) == 5);
+    REQUIRE(rows.col(1)[2] == 5);
+    REQUIRE(rows.row(1)[0] == 2);
+
+    // the same samples feature by feature
+    std::vector<double> t = {0, 2, 4, 1, 3, 5};
+    dataset_view cols(t.data(), 3, 2, dataset_layout::column_major);
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            REQUIRE(cols(i, j) == m(i, j));
+            REQUIRE(cols.row(i)[j] == m(i, j));
+            REQUIRE(cols.col(j)[i] == m(i, j));
+        }
+    }
+    REQUIRE(cols.to_matrix() == m);
+    REQUIRE(rows.to_matrix() == m);
+
+    dataset_view tail = rows.slice(1, 2);
+    REQUIRE(tail.rows() == 2);
+    REQUIRE(tail(0, 0) == 2);
+    REQUIRE_THROWS_AS(rows.slice(2, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(cols.slice(0, 1), std::invalid_argument);
+}
+
+TEST_CASE("testing dataset files are mapped in place") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_dataset.bin";
+    Matrix<double> x;
+    std::vector<double> y;
+    points(400, 3, x, y);
+    save_dataset(path.string(), x, y);
+
+    dataset data(path.string());
+    REQUIRE(data.mapped());
+    REQUIRE(data.rows() == 400);
+    REQUIRE(data.cols() == 3);
+    REQUIRE(data.features().to_matrix() == x);
+    REQUIRE(std::equal(data.labels().begin(), data.labels().end(), y.begin(), y.end()));
+
+    // the estimators read the mapping as they read a Matrix
+    kmeans_options opt;
+    opt.threads = 1;
+    kmeans_result mapped = kmeans_fit(data.features(), 2, opt);
+    kmeans_result copied = kmeans_fit(x, 2, opt);
+    REQUIRE(mapped.labels == copied.labels);
+    REQUIRE(mapped.centroids == copied.centroids);
+
+    logistic_regression_result a = logistic_regression_fit(data.features(), data.labels());
+    logistic_regression_result b = logistic_regression_fit(x, y);
+    REQUIRE(a.weights == b.weights);
+    REQUIRE(a.bias == b.bias);
+
+    dataset moved = std::move(data);
+    MLP net(moved.features(), moved.labels(), {{3, 4}, {4, 1}}, 5, 0.05, 1);
+    net.fit(16, false);
+    MLP reference(x, y, {{3, 4}, {4, 1}}, 5, 0.05, 1);
+    reference.fit(16, false);
+    REQUIRE(net.predict(x) == reference.predict(moved.features()));
+    REQUIRE(net.layers()[0].weights() == reference.layers()[0].weights());
+
+    // a column major file, for the estimators that read it by rows anyway
+    std::vector<double> t(x.size());
+    for (size_t i = 0; i < x.rows(); i++) {
+        for (size_t j = 0; j < x.cols(); j++) {
+            t[j * x.rows() + i] = x(i, j);
+        }
+    }
+    save_dataset(path.string(), dataset_view(t.data(), x.rows(), x.cols(),
+                                             dataset_layout::column_major));
+    dataset columns(path.string(), file_access::random);
+    REQUIRE(columns.labels().empty());
+    REQUIRE(!columns.features().row_major());
+    REQUIRE(columns.features().to_matrix() == x);
+    dbscan_options eps;
+    eps.eps = 1.5;
+    REQUIRE(dbscan_fit(columns.features(), eps).labels == dbscan_fit(x, eps).labels);
+    REQUIRE_THROWS_AS(kmeans_fit(columns.features(), 2), std::invalid_argument);
+
+    REQUIRE_THROWS_AS(save_dataset(path.string(), x, std::vector<double>(3)),
+                      std::invalid_argument);
+    std::filesystem::resize_file(path, 100);
+    REQUIRE_THROWS_AS(dataset(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(dataset(path.string()), std::runtime_error);
+}
+
+TEST_CASE("testing parse_csv") {
+    std::string csv = "a,b,label\r\n1.5, -2,1\r\n\r\n3,4e2,0\n  5 ,6,1\n";
+    csv_options opt;
+    opt.header = true;
+    opt.label_column = 2;
+    dataset data = parse_csv(csv, opt);
+    REQUIRE(!data.mapped());
+    REQUIRE(data.rows() == 3);
+    REQUIRE(data.cols() == 2);
+    REQUIRE(data.features()(0, 0) == 1.5);
+    REQUIRE(data.features()(0, 1) == -2);
+    REQUIRE(data.features()(1, 1) == 400);
+    REQUIRE(data.features()(2, 0) == 5);
+    REQUIRE(std::vector<double>(data.labels().begin(), data.labels().end()) ==
+            std::vector<double>{1, 0, 1});
+
+    opt.label_column = 0;
+    opt.layout = dataset_layout::column_major;
+    dataset first = parse_csv(csv, opt);
+    REQUIRE(!first.features().row_major());
+    REQUIRE(first.features()(1, 0) == 400);
+    REQUIRE(first.features().col(1)[2] == 1);
+    REQUIRE(first.labels()[2] == 5);
+
+    // the chunks of the threads give the samples of one pass
+    std::mt19937_64 rng(9);
+    std::uniform_real_distribution<double> u(-100, 100);
+    std::string big;
+    std::vector<double> values;
+    for (size_t i = 0; i < 20000; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            values.push_back(std::round(u(rng) * 1000) / 1000);
+            big += std::to_string(values.back()) + (j < 3 ? "\t" : "\n");
+        }
+    }
+    csv_options tabs;
+    tabs.delimiter = '\t';
+    tabs.threads = 1;
+    dataset serial = parse_csv(big, tabs);
+    tabs.threads = 7;
+    dataset parallel = parse_csv(big, tabs);
+    REQUIRE(serial.rows() == 20000);
+    REQUIRE(serial.cols() == 4);
+    REQUIRE(std::equal(values.begin(), values.end(), serial.features().data()));
+    REQUIRE(parallel.features().to_matrix() == serial.features().to_matrix());
+
+    REQUIRE_THROWS_AS(parse_csv("1,2\n3,x\n"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_csv("1,2\n3\n"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_csv("1,2\n3,4,5\n"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_csv("1,2,\n"), std::invalid_argument);
+    csv_options bad;
+    bad.label_column = 2;
+    REQUIRE_THROWS_AS(parse_csv("1,2\n", bad), std::invalid_argument);
+    REQUIRE(parse_csv("").rows() == 0);
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "algoplus_dataset.csv";
+    {
+        std::ofstream out(path);
+        out << "1,2\n3,4\n";
+    }
+    REQUIRE(load_csv(path.string()).features().to_matrix() ==
+            Matrix<double>(std::vector<std::vector<double>>{{1, 2}, {3, 4}}));
+    std::filesystem::remove(path);
+}
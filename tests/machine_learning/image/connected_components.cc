@@ -0,0 +1,129 @@
+#include "../../../src/machine_learning/image/connected_components.h"
+#include "../../../third_party/catch.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+image_buffer<uint8_t> blobs(size_t h, size_t w, double density, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution set(density);
+    image_buffer<uint8_t> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = set(gen) ? 255 : 0;
+        }
+    }
+    return img;
+}
+
+// the components numbered in the order of their first pixel, by flood fill
+uint32_t flood(const image_buffer<uint8_t>& img, image_buffer<uint32_t>& labels, bool eight) {
+    const long h = long(img.height()), w = long(img.width());
+    labels.view().fill(0);
+    uint32_t count = 0;
+    std::vector<std::pair<long, long>> stack;
+    for (long y = 0; y < h; y++) {
+        for (long x = 0; x < w; x++) {
+            if (img(y, x) == 0 || labels(y, x) != 0) {
+                continue;
+            }
+            labels(y, x) = ++count;
+            stack.push_back({y, x});
+            while (!stack.empty()) {
+                auto [i, j] = stack.back();
+                stack.pop_back();
+                for (long di = -1; di <= 1; di++) {
+                    for (long dj = -1; dj <= 1; dj++) {
+                        const long a = i + di, b = j + dj;
+                        if ((!eight && di != 0 && dj != 0) || a < 0 || b < 0 || a >= h ||
+                            b >= w || img(a, b) == 0 || labels(a, b) != 0) {
+                            continue;
+                        }
+                        labels(a, b) = count;
+                        stack.push_back({a, b});
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+} // namespace
+
+TEST_CASE("Testing connected component labeling on shapes") {
+    // two diagonal pixels, a ring, and a U whose arms meet only at its bottom
+    image_buffer<uint8_t> img(8, 12, 0);
+    img(0, 0) = img(1, 1) = 1;
+    img.roi(2, 4, 4, 4).fill(1);
+    img.roi(3, 5, 2, 2).fill(0);
+    img.roi(0, 9, 5, 1).fill(1);
+    img.roi(0, 11, 5, 1).fill(1);
+    img.roi(5, 9, 1, 3).fill(1);
+    image_buffer<uint32_t> labels(8, 12);
+
+    using connected_components::connectivity;
+    REQUIRE(connected_components::label(img.view(), labels.view(), connectivity::eight) == 3);
+    REQUIRE(labels(0, 0) == 1);
+    REQUIRE(labels(1, 1) == 1);
+    REQUIRE(labels(2, 4) == 3);
+    REQUIRE(labels(0, 9) == 2);
+    REQUIRE(labels(0, 11) == 2);
+    REQUIRE(labels(3, 5) == 0);
+    REQUIRE(connected_components::label(img.view(), labels.view(), connectivity::four) == 4);
+    REQUIRE(labels(1, 1) == 3);
+    REQUIRE(labels(0, 11) == 2);
+
+    const auto stats = connected_components::label_stats(img.view(), labels.view());
+    REQUIRE(stats.size() == 3);
+    REQUIRE(stats[0].area == 2);
+    REQUIRE(stats[0].cy == Approx(0.5));
+    REQUIRE(stats[0].cx == Approx(0.5));
+    REQUIRE(stats[1].area == 13);
+    REQUIRE(stats[1].y == 0);
+    REQUIRE(stats[1].x == 9);
+    REQUIRE(stats[1].height == 6);
+    REQUIRE(stats[1].width == 3);
+    REQUIRE(stats[2].area == 12);
+    REQUIRE(stats[2].cy == Approx(3.5));
+    REQUIRE(stats[2].cx == Approx(5.5));
+
+    image_buffer<uint8_t> empty(0, 5);
+    image_buffer<uint32_t> none(0, 5);
+    REQUIRE(connected_components::label(empty.view(), none.view()) == 0);
+    REQUIRE_THROWS_AS(connected_components::label(img.view(), labels.roi(0, 0, 7, 12)),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Testing connected component labeling against a flood fill") {
+    using connected_components::connectivity;
+    for (double density : {0.3, 0.5, 0.7}) {
+        image_buffer<uint8_t> img = blobs(61, 47, density, unsigned(density * 10));
+        image_buffer<uint32_t> expected(61, 47), labels(61, 47);
+        for (bool eight : {false, true}) {
+            const auto conn = eight ? connectivity::eight : connectivity::four;
+            const uint32_t count = flood(img, expected, eight);
+            // the strips, merged, label as one pass over the image
+            for (size_t threads : {1, 2, 3, 7, 61}) {
+                const auto stats =
+                    connected_components::label_stats(img.view(), labels.view(), conn, threads);
+                REQUIRE(stats.size() == count);
+                REQUIRE(labels.view() == expected.view());
+                uint64_t area = 0;
+                for (const auto& c : stats) {
+                    area += c.area;
+                }
+                size_t set = 0;
+                for (size_t y = 0; y < 61; y++) {
+                    for (size_t x = 0; x < 47; x++) {
+                        set += img(y, x) != 0;
+                    }
+                }
+                REQUIRE(area == set);
+                REQUIRE(connected_components::label(img.view(), labels.view(), conn, threads) ==
+                        count);
+                REQUIRE(labels.view() == expected.view());
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+#include "../../../src/machine_learning/image/filters/convolution.h"
+#include "../../../src/machine_learning/image/filters/average_filter.h"
+#include "../../../src/machine_learning/image/filters/gaussian_filter.h"
+#include "../../../src/machine_learning/image/filters/sharpening_filter.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+// the correlation of src with kernel, one tap at a time
+image_buffer<float> reference(const image_buffer<float>& src, const Matrix<float>& kernel,
+                              convolution::border_mode border) {
+    const long h = long(src.height()), w = long(src.width());
+    const long ry = long(kernel.rows() / 2), rx = long(kernel.cols() / 2);
+    image_buffer<float> out(src.height(), src.width());
+    for (long y = 0; y < h; y++) {
+        for (long x = 0; x < w; x++) {
+            float s = 0;
+            for (long i = -ry; i <= ry; i++) {
+                for (long j = -rx; j <= rx; j++) {
+                    long yy = y + i, xx = x + j;
+                    if (border == convolution::border_mode::replicate) {
+                        yy = std::clamp(yy, 0L, h - 1);
+                        xx = std::clamp(xx, 0L, w - 1);
+                    } else if (yy < 0 || yy >= h || xx < 0 || xx >= w) {
+                        continue;
+                    }
+                    s += kernel(size_t(i + ry), size_t(j + rx)) * src(size_t(yy), size_t(xx));
+                }
+            }
+            out(size_t(y), size_t(x)) = s;
+        }
+    }
+    return out;
+}
+
+image_buffer<float> noise(size_t h, size_t w) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> u(0, 255);
+    image_buffer<float> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = u(rng);
+        }
+    }
+    return img;
+}
+
+bool close(const image_buffer<float>& a, const image_buffer<float>& b) {
+    for (size_t y = 0; y < a.height(); y++) {
+        for (size_t x = 0; x < a.width(); x++) {
+            if (std::abs(a(y, x) - b(y, x)) > 1e-3f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST_CASE("Testing separable kernels") {
+    std::vector<float> col, row;
+    Matrix<float> outer(3, 5);
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            outer(i, j) = float(i + 1) * (float(j) - 2);
+        }
+    }
+    REQUIRE(convolution::separable(outer, col, row));
+    REQUIRE(col.size() == 3);
+    REQUIRE(row.size() == 5);
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            REQUIRE(std::abs(col[i] * row[j] - outer(i, j)) < 1e-5f);
+        }
+    }
+    Matrix<float> laplace(std::vector<std::vector<float>>{{0, -1, 0}, {-1, 5, -1}, {0, -1, 0}});
+    REQUIRE(!convolution::separable(laplace, col, row));
+    REQUIRE(!convolution::separable(Matrix<float>(3, 3), col, row));
+
+    std::vector<float> g = convolution::gaussian_kernel(2.0);
+    REQUIRE(g.size() == 13);
+    float sum = 0;
+    for (float t : g) {
+        sum += t;
+    }
+    REQUIRE(std::abs(sum - 1) < 1e-5f);
+    REQUIRE(g[6] > g[5]);
+    REQUIRE(g[0] == g[12]);
+    REQUIRE_THROWS_AS(convolution::gaussian_kernel(0), std::invalid_argument);
+}
+
+TEST_CASE("Testing filter2d against the correlation") {
+    using convolution::border_mode;
+    Matrix<float> separable(5, 7), dense(5, 3);
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> u(-1, 1);
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < 7; j++) {
+            separable(i, j) = float(i + 1) * float(7 - j) / 40;
+        }
+        for (size_t j = 0; j < 3; j++) {
+            dense(i, j) = u(rng);
+        }
+    }
+    // widths for the unrolled registers, one register, the scalar tail and kernels wider than
+    // the image, on several threads
+    for (size_t w : {1, 3, 9, 37, 70}) {
+        image_buffer<float> src = noise(11, w);
+        for (border_mode border : {border_mode::zero, border_mode::replicate}) {
+            for (const Matrix<float>* k : {&separable, &dense}) {
+                image_buffer<float> dst(11, w);
+                convolution::filter2d(src, dst, *k, border, 3);
+                REQUIRE(close(dst, reference(src, *k, border)));
+            }
+        }
+    }
+
+    // in place, on a region of interest, into integer pixels
+    image_buffer<float> src = noise(20, 30);
+    image_buffer<float> in = src;
+    convolution::filter2d(in.roi(2, 3, 10, 20), in.roi(2, 3, 10, 20), dense);
+    image_buffer<float> expected = reference(image_buffer<float>(src.roi(2, 3, 10, 20)), dense,
+                                             border_mode::zero);
+    REQUIRE(close(image_buffer<float>(in.roi(2, 3, 10, 20)), expected));
+    REQUIRE(in(1, 3) == src(1, 3));
+    REQUIRE(in(2, 23) == src(2, 23));
+
+    image_buffer<uint8_t> bytes(4, 40, 200);
+    Matrix<float> twice(1, 1, 2.0f);
+    convolution::filter2d(bytes, bytes, twice);
+    REQUIRE(bytes(3, 39) == 255);
+
+    image_buffer<float> other(3, 3);
+    REQUIRE_THROWS_AS(convolution::filter2d(src, other, dense), std::invalid_argument);
+    REQUIRE_THROWS_AS(convolution::filter2d(src, src, Matrix<float>(2, 3)),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Testing the filters on the convolution") {
+    std::vector<std::vector<int32_t>> pixels(9, std::vector<int32_t>(13));
+    std::mt19937 rng(1);
+    for (auto& row : pixels) {
+        for (int32_t& p : row) {
+            p = int32_t(rng() % 256);
+        }
+    }
+    Image img(pixels);
+    std::vector<std::vector<float>> gauss = {{1.0 / 16, 2.0 / 16, 1.0 / 16},
+                                             {2.0 / 16, 4.0 / 16, 2.0 / 16},
+                                             {1.0 / 16, 2.0 / 16, 1.0 / 16}};
+    std::vector<std::vector<float>> avg(3, std::vector<float>(3, 1.0 / 9));
+    std::vector<std::vector<int32_t>> sharp = {{0, -1, 0}, {-1, 5, -1}, {0, -1, 0}};
+
+    // the same pixels as Image::apply_filter2d, up to a rounding of float sums at .5
+    auto near = [](const std::vector<std::vector<int32_t>>& a,
+                   const std::vector<std::vector<int32_t>>& b) {
+        for (size_t y = 0; y < a.size(); y++) {
+            for (size_t x = 0; x < a[y].size(); x++) {
+                if (std::abs(a[y][x] - b[y][x]) > 1) {
+                    return false;
+                }
+            }
+        }
+        return a.size() == b.size();
+    };
+    REQUIRE(near(gaussian_filter::apply_gaussian_filter(pixels),
+                 img.apply_filter2d(gauss).get_2d_array()));
+    REQUIRE(near(avg_filter::apply_avg_filter(pixels), img.apply_filter2d(avg).get_2d_array()));
+    REQUIRE(sharpening_filter::apply_sharpening_filter(pixels) ==
+            img.apply_filter2d(sharp).get_2d_array());
+
+    // a flat image stays flat under a blur of any size with replicated borders
+    image_buffer<uint8_t> flat(40, 50, 77), blurred(40, 50);
+    gaussian_filter::gaussian_blur(flat.view(), blurred.view(), 4.0);
+    REQUIRE(blurred == flat);
+    avg_filter::box_filter(flat.view(), blurred.view(), 9, convolution::border_mode::replicate);
+    REQUIRE(blurred == flat);
+    REQUIRE_THROWS_AS(avg_filter::box_filter(flat.view(), blurred.view(), 4),
+                      std::invalid_argument);
+}
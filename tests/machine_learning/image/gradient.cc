@@ -0,0 +1,151 @@
+#include "../../../src/machine_learning/image/edge_detection/gradient.h"
+#include "../../../src/machine_learning/image/edge_detection/prewitt.h"
+#include "../../../src/machine_learning/image/edge_detection/sobel_operator.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace {
+image_buffer<uint8_t> noise(size_t h, size_t w, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    image_buffer<uint8_t> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = uint8_t(dist(gen));
+        }
+    }
+    return img;
+}
+
+// gx and gy of the 3x3 kernels, the image replicated at its borders
+void naive(const image_buffer<uint8_t>& img, size_t y, size_t x, int k, int& gx, int& gy) {
+    auto at = [&](long i, long j) {
+        i = std::clamp(i, 0L, long(img.height()) - 1);
+        j = std::clamp(j, 0L, long(img.width()) - 1);
+        return int(img(size_t(i), size_t(j)));
+    };
+    const long i = long(y), j = long(x);
+    gx = at(i - 1, j + 1) - at(i - 1, j - 1) + k * (at(i, j + 1) - at(i, j - 1)) +
+         at(i + 1, j + 1) - at(i + 1, j - 1);
+    gy = at(i + 1, j - 1) + k * at(i + 1, j) + at(i + 1, j + 1) - at(i - 1, j - 1) -
+         k * at(i - 1, j) - at(i - 1, j + 1);
+}
+} // namespace
+
+TEST_CASE("Testing the fused gradient magnitude") {
+    // widths around the 16 pixels of the vector loop
+    for (size_t w : {1, 2, 16, 17, 18, 33, 70}) {
+        image_buffer<uint8_t> img = noise(9, w, unsigned(w));
+        // extreme gradients, that saturate an int16 sum of squares
+        img(4, 0) = 255;
+        for (auto op : {gradient_operator::sobel, gradient_operator::prewitt}) {
+            const int k = op == gradient_operator::sobel ? 2 : 1;
+            for (auto norm : {gradient_norm::l1, gradient_norm::l2, gradient_norm::approximate}) {
+                image_buffer<uint16_t> mag(9, w);
+                image_buffer<uint8_t> dir(9, w);
+                gradient::magnitude(img.view(), mag.view(), op, norm, dir.view(), 2);
+                for (size_t y = 0; y < 9; y++) {
+                    for (size_t x = 0; x < w; x++) {
+                        int gx, gy;
+                        naive(img, y, x, k, gx, gy);
+                        const double l2 = std::hypot(gx, gy);
+                        if (norm == gradient_norm::l1) {
+                            REQUIRE(mag(y, x) == std::abs(gx) + std::abs(gy));
+                        } else if (norm == gradient_norm::l2) {
+                            REQUIRE(std::abs(mag(y, x) - l2) <= 0.5);
+                        } else {
+                            REQUIRE(std::abs(mag(y, x) - l2) <= 0.07 * l2 + 1);
+                        }
+                        // the bins are 45 degrees around 0, 45, 90 and 135 degrees
+                        if (gx != 0 || gy != 0) {
+                            double angle = std::atan2(gy, gx) * 180 / M_PI;
+                            angle = std::fmod(angle + 180 + 22.5, 180.0);
+                            const int bin = int(angle / 45);
+                            if (std::abs(std::fmod(angle, 45.0)) > 0.1 &&
+                                std::abs(std::fmod(angle, 45.0) - 45) > 0.1) {
+                                REQUIRE(int(dir(y, x)) == bin);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // the namespaces of the operators forward to it
+    image_buffer<uint8_t> img = noise(5, 40, 3);
+    image_buffer<uint16_t> a(5, 40), b(5, 40);
+    sobel::magnitude(img.view(), a.view());
+    gradient::magnitude(img.view(), b.view());
+    REQUIRE(a.view() == b.view());
+    prewitt::magnitude(img.view(), a.view(), gradient_norm::l1);
+    gradient::magnitude(img.view(), b.view(), gradient_operator::prewitt, gradient_norm::l1);
+    REQUIRE(a.view() == b.view());
+    REQUIRE_THROWS_AS(gradient::magnitude(img.view(), a.roi(0, 0, 4, 40)),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Testing non max suppression and canny") {
+    // a bright disc on a dark background, edges only on its border
+    const size_t n = 64;
+    image_buffer<uint8_t> img(n, n, 20);
+    for (size_t y = 0; y < n; y++) {
+        for (size_t x = 0; x < n; x++) {
+            const double dy = double(y) - 31.5, dx = double(x) - 31.5;
+            if (dx * dx + dy * dy < 20.0 * 20.0) {
+                img(y, x) = 220;
+            }
+        }
+    }
+    image_buffer<uint8_t> edges(n, n);
+    gradient::canny(img.view(), edges.view(), 100, 300);
+    size_t count = 0;
+    for (size_t y = 0; y < n; y++) {
+        for (size_t x = 0; x < n; x++) {
+            if (edges(y, x) != 0) {
+                count++;
+                const double r = std::hypot(double(y) - 31.5, double(x) - 31.5);
+                REQUIRE(std::abs(r - 20) < 2);
+            }
+        }
+    }
+    // about the circumference, a pixel thick
+    REQUIRE(count > 100);
+    REQUIRE(count < 200);
+    REQUIRE(edges(31, 31) == 0);
+    REQUIRE(edges(0, 0) == 0);
+
+    // a vertical step is thinned to one column of every row
+    image_buffer<uint8_t> step(6, 10, 0);
+    step.roi(0, 5, 6, 5).fill(200);
+    image_buffer<uint16_t> mag(6, 10), thin(6, 10);
+    image_buffer<uint8_t> dir(6, 10);
+    gradient::magnitude(step.view(), mag.view(), gradient_operator::sobel, gradient_norm::l1,
+                        dir.view());
+    REQUIRE(dir(2, 4) == 0);
+    gradient::non_max_suppression(mag.view(), dir.view(), thin.view());
+    for (size_t y = 0; y < 6; y++) {
+        size_t kept = 0;
+        for (size_t x = 0; x < 10; x++) {
+            kept += thin(y, x) != 0;
+        }
+        REQUIRE(kept == 1);
+    }
+
+    // hysteresis keeps the weak pixels connected to strong ones
+    image_buffer<uint8_t> faint(8, 20, 0);
+    faint.roi(0, 10, 8, 10).fill(60);
+    faint.roi(0, 10, 2, 10).fill(250);
+    gradient::canny(faint.view(), edges.roi(0, 0, 8, 20), 100, 500, gradient_operator::sobel,
+                    gradient_norm::l1);
+    for (size_t y = 0; y < 8; y++) {
+        REQUIRE((edges(y, 9) != 0 || edges(y, 10) != 0));
+    }
+    gradient::canny(faint.view(), edges.roi(0, 0, 8, 20), 300, 500, gradient_operator::sobel,
+                    gradient_norm::l1);
+    REQUIRE((edges(6, 9) == 0 && edges(6, 10) == 0));
+    REQUIRE_THROWS_AS(gradient::canny(faint.view(), edges.roi(0, 0, 8, 20), 5, 4),
+                      std::invalid_argument);
+}
@@ -0,0 +1,154 @@
+#include "../../../src/machine_learning/image/encoders/huffman_encoding.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+template <typename T> std::vector<T> skewed(size_t n, double mean, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::geometric_distribution<int> dist(1 / mean);
+    std::vector<T> v(n);
+    for (auto& x : v) {
+        x = T(std::min(dist(gen), int(std::numeric_limits<T>::max())));
+    }
+    return v;
+}
+
+template <typename T> std::vector<uint64_t> histogram(const std::vector<T>& v, size_t n) {
+    std::vector<uint64_t> f(n, 0);
+    for (T x : v) {
+        f[x]++;
+    }
+    return f;
+}
+} // namespace
+
+TEST_CASE("Testing the canonical huffman code") {
+    // fibonacci frequencies make a huffman tree as deep as the symbols
+    std::vector<uint64_t> fib = {1, 1};
+    while (fib.size() < 30) {
+        fib.push_back(fib[fib.size() - 1] + fib[fib.size() - 2]);
+    }
+    for (int64_t depth : {5, 8, 12, 20}) {
+        huffman_codec c(fib, depth);
+        double kraft = 0;
+        for (uint8_t l : c.lengths()) {
+            REQUIRE(l >= 1);
+            REQUIRE(l <= depth);
+            kraft += std::ldexp(1.0, -int(l));
+        }
+        REQUIRE(kraft == Approx(1.0));
+        // no code is the prefix of another
+        for (uint32_t a = 0; a < 30; a++) {
+            for (uint32_t b = 0; b < 30; b++) {
+                if (a != b) {
+                    REQUIRE(c.code(b).rfind(c.code(a), 0) == std::string::npos);
+                }
+            }
+        }
+    }
+    REQUIRE_THROWS_AS(huffman_codec(fib, 4), std::invalid_argument);
+    REQUIRE_THROWS_AS(huffman_codec(fib, 21), std::invalid_argument);
+
+    // canonical: the codes of the same length count up in the order of the symbols
+    huffman_codec c = huffman_codec::from_lengths({2, 1, 3, 0, 3});
+    REQUIRE(c.code(1) == "0");
+    REQUIRE(c.code(0) == "10");
+    REQUIRE(c.code(2) == "110");
+    REQUIRE(c.code(4) == "111");
+    REQUIRE(c.code(3).empty());
+    REQUIRE_THROWS_AS(huffman_codec::from_lengths({1, 1, 1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(huffman_codec::from_lengths({21}), std::invalid_argument);
+}
+
+TEST_CASE("Testing huffman encoding and decoding") {
+    for (size_t n : {0, 1, 2, 3, 1000, 100001}) {
+        const auto data = skewed<uint8_t>(n, 6, unsigned(n));
+        huffman_codec c(histogram(data, 256));
+        const auto bits = c.encode(data);
+        REQUIRE(bits.size() == (c.encoded_bits(data) + 7) / 8);
+        // the decoder needs only the lengths
+        std::vector<uint8_t> back(n);
+        huffman_codec::from_lengths(c.lengths()).decode(bits, back);
+        REQUIRE(back == data);
+    }
+
+    // 16 bit symbols, codes through the second table
+    const auto wide = skewed<uint16_t>(50000, 400, 7);
+    huffman_codec c(histogram(wide, 65536), 16);
+    const auto bits = c.encode(wide);
+    std::vector<uint16_t> back(wide.size());
+    c.decode(bits, back);
+    REQUIRE(back == wide);
+    std::vector<uint8_t> narrow(wide.size());
+    REQUIRE_THROWS_AS(c.decode(bits, narrow), std::invalid_argument);
+    back.push_back(0);
+    REQUIRE_THROWS_AS(c.decode(bits, back), std::runtime_error);
+
+    // one symbol still takes a bit; an incomplete code rejects what it can not decode
+    huffman_codec one(std::vector<uint64_t>{0, 0, 5});
+    const std::vector<uint8_t> twos(9, 2);
+    REQUIRE(one.encode(twos).size() == 2);
+    REQUIRE_THROWS_AS(one.encode(std::vector<uint8_t>{1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(one.encode(std::vector<uint8_t>{7}), std::invalid_argument);
+    std::vector<uint8_t> out(8);
+    REQUIRE_THROWS_AS(one.decode(std::vector<uint8_t>{0xff}, out), std::runtime_error);
+}
+
+TEST_CASE("Testing the huffman tree of a text") {
+    huffman h({"aaaabbc", "ad"}, 10);
+    h.create_tree();
+    auto codes = h.decode();
+    REQUIRE(codes.size() == 4);
+    REQUIRE(codes["a"].size() == 1);
+    REQUIRE(codes["d"].size() == 3);
+
+    huffman_codec c = h.codec();
+    const std::string text = "abacabad";
+    const std::vector<uint8_t> symbols(text.begin(), text.end());
+    const auto bits = c.encode(symbols);
+    std::vector<uint8_t> back(symbols.size());
+    c.decode(bits, back);
+    REQUIRE(back == symbols);
+    REQUIRE(c.code('a').size() == 1);
+}
+
+TEST_CASE("Testing the parallel histogram and framed huffman encoding") {
+    const auto data = skewed<uint8_t>(300001, 10, 3);
+    const auto counts = histogram(data, 256);
+    for (size_t threads : {1, 3, 0}) {
+        REQUIRE(huffman_codec::histogram(data, threads) == counts);
+    }
+    const auto wide = skewed<uint16_t>(70001, 300, 5);
+    REQUIRE(huffman_codec::histogram(wide, 4) == histogram(wide, 65536));
+    REQUIRE(huffman_codec::histogram(std::vector<uint8_t>{}) == std::vector<uint64_t>(256, 0));
+
+    huffman_codec c(counts);
+    for (size_t frame : {1000, 65536, 1000000}) {
+        const auto bits = c.encode_frames(data, frame, 4);
+        REQUIRE(huffman_codec::frames_size(bits) == data.size());
+        for (size_t threads : {1, 4}) {
+            std::vector<uint8_t> back(data.size());
+            c.decode_frames(bits, back, threads);
+            REQUIRE(back == data);
+        }
+    }
+    // the frames do not depend on the number of threads
+    REQUIRE(c.encode_frames(data, 4096, 1) == c.encode_frames(data, 4096, 8));
+
+    const auto empty = c.encode_frames(std::vector<uint8_t>{});
+    REQUIRE(huffman_codec::frames_size(empty) == 0);
+    REQUIRE_THROWS_AS(c.encode_frames(data, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(c.encode_frames(std::vector<uint8_t>{255}), std::invalid_argument);
+
+    auto bits = c.encode_frames(data, 10000, 2);
+    std::vector<uint8_t> back(data.size() - 1);
+    REQUIRE_THROWS_AS(c.decode_frames(bits, back), std::invalid_argument);
+    back.resize(data.size());
+    bits.resize(bits.size() - 1);
+    REQUIRE_THROWS_AS(c.decode_frames(bits, back), std::runtime_error);
+    REQUIRE_THROWS_AS(huffman_codec::frames_size(std::vector<uint8_t>(5)), std::runtime_error);
+}
@@ -0,0 +1,108 @@
+#include "../../../src/machine_learning/image/image_buffer.h"
+#include "../../../third_party/catch.hpp"
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Testing the layout of image_buffer") {
+    image_buffer<uint8_t> gray(2160, 3840);
+    REQUIRE(gray.stride() == 3840);
+    REQUIRE(gray.bytes() == 2160 * 3840);
+
+    // the rows of every pixel type start on a cache line
+    image_buffer<uint8_t> a(3, 70, 7);
+    image_buffer<uint16_t> b(3, 70);
+    image_buffer<float> c(3, 70);
+    REQUIRE(a.stride() == 128);
+    REQUIRE(b.stride() == 96);
+    REQUIRE(c.stride() == 80);
+    for (size_t y = 0; y < 3; y++) {
+        REQUIRE(reinterpret_cast<uintptr_t>(a.row(y)) % 64 == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(b.row(y)) % 64 == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(c.row(y)) % 64 == 0);
+    }
+    REQUIRE(a(2, 69) == 7);
+    REQUIRE(a.row(1)[70] == 0);
+}
+
+TEST_CASE("Testing regions of interest of image_buffer") {
+    image_buffer<uint16_t> img(6, 8);
+    for (size_t y = 0; y < 6; y++) {
+        for (size_t x = 0; x < 8; x++) {
+            img(y, x) = uint16_t(10 * y + x);
+        }
+    }
+    image_view<uint16_t> roi = img.roi(2, 3, 3, 4);
+    REQUIRE(roi.height() == 3);
+    REQUIRE(roi.width() == 4);
+    REQUIRE(roi(0, 0) == 23);
+    REQUIRE(roi.roi(1, 1, 2, 2)(1, 1) == 45);
+
+    // the region writes through to the image and nothing else
+    roi.fill(1);
+    REQUIRE(img(2, 3) == 1);
+    REQUIRE(img(4, 6) == 1);
+    REQUIRE(img(2, 2) == 22);
+    REQUIRE(img(5, 3) == 53);
+
+    image_buffer<uint16_t> copy(img.roi(1, 2, 2, 2));
+    REQUIRE(copy.height() == 2);
+    REQUIRE(copy(0, 0) == 12);
+    REQUIRE(copy(1, 1) == 1);
+    REQUIRE(copy.view() == static_cast<const image_buffer<uint16_t>&>(img).roi(1, 2, 2, 2));
+
+    REQUIRE_THROWS_AS(img.roi(4, 0, 3, 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(img.roi(0, 5, 1, 4), std::invalid_argument);
+    REQUIRE_THROWS_AS(copy.add(img), std::invalid_argument);
+}
+
+TEST_CASE("Testing in place arithmetic of image_buffer") {
+    // wide enough for the vector loop and its tail
+    image_buffer<uint8_t> a(2, 45), b(2, 45);
+    for (size_t x = 0; x < 45; x++) {
+        a(0, x) = uint8_t(6 * x);
+        b(0, x) = uint8_t(200 - x);
+        a(1, x) = uint8_t(x);
+        b(1, x) = 3;
+    }
+    image_buffer<uint8_t> sum = a;
+    sum.add(b);
+    image_buffer<uint8_t> diff = a;
+    diff.sub(b);
+    image_buffer<uint8_t> prod = a;
+    prod.mul(b);
+    for (size_t y = 0; y < 2; y++) {
+        for (size_t x = 0; x < 45; x++) {
+            int p = a(y, x), q = b(y, x);
+            REQUIRE(sum(y, x) == std::min(255, p + q));
+            REQUIRE(diff(y, x) == std::max(0, p - q));
+            REQUIRE(prod(y, x) == std::min(255, p * q));
+        }
+    }
+
+    image_buffer<uint16_t> wide(1, 40, 65000);
+    wide.add(image_buffer<uint16_t>(1, 40, 1000));
+    REQUIRE(wide(0, 39) == 65535);
+
+    image_buffer<float> f(2, 3, 1.5f);
+    f.mul(image_buffer<float>(2, 3, -2.0f)).scale(2, 1);
+    REQUIRE(f(1, 2) == -5.0f);
+    image_buffer<uint8_t> g = f.convert<uint8_t>();
+    REQUIRE(g(0, 0) == 0);
+    a.scale(0.5, 0.25);
+    REQUIRE(a(0, 3) == 9);
+    REQUIRE(image_buffer<float>(1, 1, 300.6f).convert<uint8_t>()(0, 0) == 255);
+    REQUIRE(image_buffer<float>(1, 1, 3.6f).convert<uint8_t>()(0, 0) == 4);
+}
+
+TEST_CASE("Testing image_buffer and Image") {
+    std::vector<std::vector<int32_t>> pixels = {{0, 128, 300}, {-4, 255, 17}};
+    Image img(pixels);
+    image_buffer<uint8_t> buf(img);
+    REQUIRE(buf(0, 2) == 255);
+    REQUIRE(buf(1, 0) == 0);
+    REQUIRE(buf(1, 2) == 17);
+    REQUIRE(buf.to_image().get_2d_array() ==
+            std::vector<std::vector<int32_t>>{{0, 128, 255}, {0, 255, 17}});
+    image_buffer<float> exact(img);
+    REQUIRE(exact.to_image().get_2d_array() == pixels);
+}
@@ -0,0 +1,213 @@
+#include "../../../src/machine_learning/image/io/image_io.h"
+#include "../../../third_party/catch.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace {
+std::string temp(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("algoplus_" + name)).string();
+}
+
+template <typename T> image_buffer<T> pattern(size_t h, size_t w, unsigned step) {
+    image_buffer<T> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = T((y * w + x) * step);
+        }
+    }
+    return img;
+}
+} // namespace
+
+TEST_CASE("Testing the pnm reader") {
+    // ascii, with comments anywhere in the header
+    auto ascii = std::make_unique<std::istringstream>("P2 # gray\n3 # width\n2\n15\n"
+                                                      "0 1 2\n13 14 15\n");
+    pnm_reader gray(std::move(ascii));
+    REQUIRE(gray.info() == image_info{2, 3, 1, 8});
+    REQUIRE(gray.maxval() == 15);
+    REQUIRE_FALSE(gray.seekable());
+    image_buffer<uint8_t> rows(1, 3);
+    gray.read_rows(rows.view());
+    REQUIRE(rows(0, 2) == 2);
+    REQUIRE(gray.row() == 1);
+    gray.read_rows(rows.view());
+    REQUIRE(rows(0, 0) == 13);
+    REQUIRE_THROWS_AS(gray.read_rows(rows.view()), std::invalid_argument);
+    REQUIRE_THROWS_AS(gray.read_region(0, 0, rows.view()), std::logic_error);
+
+    // binary, 16 bit big endian samples of 3 channels
+    std::string bytes = "P6\n2 1\n1000\n";
+    for (int v : {1, 2, 3, 256, 999, 0}) {
+        bytes += char(v >> 8);
+        bytes += char(v & 255);
+    }
+    pnm_reader color(std::make_unique<std::istringstream>(bytes));
+    REQUIRE(color.info() == image_info{1, 2, 3, 16});
+    REQUIRE(color.seekable());
+    image_buffer<uint16_t> px(1, 6);
+    REQUIRE_THROWS_AS(color.read_rows(image_buffer<uint8_t>(1, 6).view()), std::invalid_argument);
+    color.read_rows(px.view());
+    REQUIRE(px(0, 3) == 256);
+    REQUIRE(px(0, 4) == 999);
+
+    REQUIRE_THROWS_AS(pnm_reader(std::make_unique<std::istringstream>("P7\n1 1\n255\n")),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(pnm_reader(std::make_unique<std::istringstream>("P5\n1 x\n255\n")),
+                      std::runtime_error);
+    pnm_reader truncated(std::make_unique<std::istringstream>("P5\n4 1\n255\nab"));
+    REQUIRE_THROWS_AS(truncated.read_rows(image_buffer<uint8_t>(1, 4).view()),
+                      std::runtime_error);
+}
+
+TEST_CASE("Testing pnm files through image_io") {
+    const std::string path = temp("io.pgm");
+    image_buffer<uint8_t> img = pattern<uint8_t>(37, 53, 3);
+    image_io::write(path, img);
+    image_buffer<uint8_t> back = image_io::read<uint8_t>(path);
+    REQUIRE(back.view() == img.view());
+    REQUIRE(image_io::read<uint16_t>(path)(36, 52) == img(36, 52));
+
+    // streamed a few rows at a time, and tiles decoded where they are
+    auto reader = image_io::open(path);
+    REQUIRE(reader->info() == image_info{37, 53, 1, 8});
+    REQUIRE(reader->seekable());
+    image_buffer<uint8_t> strip(5, 53), tile(8, 9);
+    reader->skip_rows(10);
+    reader->read_rows(strip.view());
+    REQUIRE(strip.view() == img.roi(10, 0, 5, 53));
+    reader->read_region(29, 44, tile.view());
+    REQUIRE(tile.view() == img.roi(29, 44, 8, 9));
+    REQUIRE(reader->row() == 15);
+    reader->read_rows(strip.view());
+    REQUIRE(strip.view() == img.roi(15, 0, 5, 53));
+    REQUIRE_THROWS_AS(reader->read_region(30, 44, tile.view()), std::invalid_argument);
+
+    // 16 bit rgb, written a row at a time
+    const std::string ppm = temp("io.ppm");
+    image_buffer<uint16_t> color = pattern<uint16_t>(6, 3 * 7, 1000);
+    auto writer = image_io::create(ppm, image_info{6, 7, 3, 16});
+    for (size_t y = 0; y < 6; y++) {
+        writer->write_rows(color.roi(y, 0, 1, 21));
+    }
+    writer.reset();
+    auto rgb = image_io::open(ppm);
+    REQUIRE(rgb->info() == image_info{6, 7, 3, 16});
+    image_buffer<uint16_t> region(2, 6);
+    rgb->read_region(4, 5, region.view());
+    REQUIRE(region.view() == color.roi(4, 15, 2, 6));
+
+    REQUIRE_THROWS_AS(image_io::create(temp("io.bmp"), image_info{1, 1, 1, 8}),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(image_io::create(path, image_info{1, 1, 2, 8}), std::invalid_argument);
+    REQUIRE_THROWS_AS(image_io::open(temp("missing.pgm")), std::runtime_error);
+    std::filesystem::remove(path);
+    std::filesystem::remove(ppm);
+}
+
+TEST_CASE("Testing mapped_image") {
+    const std::string path = temp("mapped.pgm");
+    image_buffer<uint8_t> img = pattern<uint8_t>(20, 31, 7);
+    image_io::write(path, img);
+    mapped_image<uint8_t> pgm(path);
+    REQUIRE(pgm.info() == image_info{20, 31, 1, 8});
+    REQUIRE(pgm.view() == img.view());
+
+    // raw 16 bit pixels after a header of 64 bytes
+    const std::string raw = temp("mapped.raw");
+    image_buffer<uint16_t> wide = pattern<uint16_t>(9, 12, 300);
+    {
+        std::ofstream out(raw, std::ios::binary);
+        out << std::string(64, '\0');
+        for (size_t y = 0; y < 9; y++) {
+            out.write(reinterpret_cast<const char*>(wide.row(y)), 12 * sizeof(uint16_t));
+        }
+    }
+    mapped_image<uint16_t> pixels(raw, 9, 12, 64);
+    REQUIRE(pixels.height() == 9);
+    REQUIRE(pixels.width() == 12);
+    REQUIRE(pixels.view() == wide.view());
+    REQUIRE_THROWS_AS(mapped_image<uint16_t>(raw, 10, 12, 64), std::runtime_error);
+    REQUIRE_THROWS_AS(mapped_image<uint16_t>(raw, 1, 1, 3), std::invalid_argument);
+    std::filesystem::remove(path);
+    std::filesystem::remove(raw);
+}
+
+TEST_CASE("Testing a codec plugged into a codec_registry") {
+    // pgm images under another extension
+    struct renamed : pnm_codec {
+        bool handles(std::string_view extension) const override { return extension == "gray"; }
+    };
+    codec_registry registry;
+    REQUIRE(registry.by_extension("PGM")->name() == "pnm");
+    REQUIRE(registry.by_extension("gray") == nullptr);
+    registry.add(std::make_shared<renamed>());
+    REQUIRE(registry.by_extension("gray") != nullptr);
+    REQUIRE(registry.by_signature("P5\n") != nullptr);
+    REQUIRE(registry.by_signature("BM") == nullptr);
+
+    const std::string path = temp("io.gray");
+    image_buffer<uint8_t> img = pattern<uint8_t>(3, 4, 9);
+    auto writer = image_io::create(path, image_info{3, 4, 1, 8}, registry);
+    writer->write_rows(img.view());
+    writer.reset();
+    auto reader = image_io::open(path, registry);
+    image_buffer<uint8_t> back(3, 4);
+    reader->read_rows(back.view());
+    REQUIRE(back.view() == img.view());
+    std::filesystem::remove(path);
+}
+
+#ifdef ALGOPLUS_WITH_PNG
+TEST_CASE("Testing png files through image_io") {
+    const std::string path = temp("io.png");
+    image_buffer<uint16_t> rgba = pattern<uint16_t>(17, 4 * 13, 611);
+    image_io::write(path, rgba, 4);
+    auto reader = image_io::open(path);
+    REQUIRE(reader->info() == image_info{17, 13, 4, 16});
+    image_buffer<uint16_t> back(17, 52);
+    reader->read_rows(back.view());
+    REQUIRE(back.view() == rgba.view());
+
+    image_buffer<uint8_t> gray = pattern<uint8_t>(40, 33, 5);
+    image_io::write(path, gray);
+    REQUIRE(image_io::read<uint8_t>(path).view() == gray.view());
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string("\x89PNG\r\n\x1a\n", 8) << "broken";
+    }
+    REQUIRE_THROWS_AS(image_io::open(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+#endif
+
+#ifdef ALGOPLUS_WITH_JPEG
+TEST_CASE("Testing jpeg files through image_io") {
+    const std::string path = temp("io.jpg");
+    image_buffer<uint8_t> flat(24, 3 * 40, 128);
+    for (size_t x = 0; x < 120; x += 3) {
+        flat(5, x) = 200;
+    }
+    image_io::write(path, flat, 3);
+    auto reader = image_io::open(path);
+    REQUIRE(reader->info() == image_info{24, 40, 3, 8});
+    REQUIRE_FALSE(reader->seekable());
+    image_buffer<uint8_t> back(24, 120);
+    reader->read_rows(back.view());
+    // lossy, but close on a smooth image
+    REQUIRE(int(back(20, 61)) == Approx(128).margin(4));
+
+    REQUIRE_THROWS_AS(image_io::create(path, image_info{2, 2, 1, 16}), std::invalid_argument);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "\xFF\xD8\xFF" << "broken";
+    }
+    REQUIRE_THROWS_AS(image_io::open(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+#endif
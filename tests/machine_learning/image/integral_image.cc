@@ -0,0 +1,128 @@
+#include "../../../src/machine_learning/image/filters/average_filter.h"
+#include "../../../src/machine_learning/image/integral_image.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace {
+image_buffer<uint8_t> noise(size_t h, size_t w, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    image_buffer<uint8_t> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = uint8_t(dist(gen));
+        }
+    }
+    return img;
+}
+
+double naive_sum(const image_buffer<uint8_t>& img, size_t y, size_t x, size_t h, size_t w,
+                 bool squares) {
+    double s = 0;
+    for (size_t i = y; i < y + h; i++) {
+        for (size_t j = x; j < x + w; j++) {
+            s += squares ? double(img(i, j)) * img(i, j) : img(i, j);
+        }
+    }
+    return s;
+}
+} // namespace
+
+TEST_CASE("Testing rectangle sums of integral_image") {
+    image_buffer<uint8_t> img = noise(23, 37, 1);
+    integral_image<uint8_t> sums(img, true);
+    REQUIRE(sums.height() == 23);
+    REQUIRE(sums.width() == 37);
+    REQUIRE(sums.squares());
+    REQUIRE(sums.at(0, 5) == 0);
+    REQUIRE(sums.at(23, 37) == uint64_t(naive_sum(img, 0, 0, 23, 37, false)));
+    for (size_t y = 0; y < 23; y += 4) {
+        for (size_t x = 0; x < 37; x += 5) {
+            const size_t h = 23 - y > 7 ? 7 : 23 - y, w = 37 - x > 9 ? 9 : 37 - x;
+            REQUIRE(sums.sum(y, x, h, w) == uint64_t(naive_sum(img, y, x, h, w, false)));
+            REQUIRE(sums.square_sum(y, x, h, w) == uint64_t(naive_sum(img, y, x, h, w, true)));
+            const double n = double(h * w), m = naive_sum(img, y, x, h, w, false) / n;
+            REQUIRE(sums.mean(y, x, h, w) == Approx(m));
+            REQUIRE(sums.variance(y, x, h, w) ==
+                    Approx(naive_sum(img, y, x, h, w, true) / n - m * m));
+        }
+    }
+    REQUIRE(sums.sum(3, 4, 0, 6) == 0);
+
+    // without the squares, and over a region of interest
+    integral_image<uint8_t> roi{image_view<const uint8_t>(img.roi(2, 3, 10, 11))};
+    REQUIRE_FALSE(roi.squares());
+    REQUIRE(roi.sum(1, 1, 4, 4) == sums.sum(3, 4, 4, 4));
+    REQUIRE_THROWS_AS(roi.square_sum(0, 0, 1, 1), std::logic_error);
+
+    image_buffer<float> f(2, 3, -0.5f);
+    REQUIRE(integral_image<float>(f).sum(0, 0, 2, 3) == -3.0);
+    image_buffer<int16_t> s(2, 2, -300);
+    REQUIRE(integral_image<int16_t>(s, true).variance(0, 0, 2, 2) == 0.0);
+}
+
+TEST_CASE("Testing box_blur of integral_filter") {
+    image_buffer<uint8_t> img = noise(19, 25, 2);
+    image_buffer<uint8_t> out(19, 25);
+    const size_t radius = 3;
+    integral_filter::box_blur(img.view(), out.view(), radius, 2);
+    for (size_t y = 0; y < 19; y++) {
+        for (size_t x = 0; x < 25; x++) {
+            const size_t y0 = y > radius ? y - radius : 0, x0 = x > radius ? x - radius : 0;
+            const size_t y1 = std::min<size_t>(19, y + radius + 1);
+            const size_t x1 = std::min<size_t>(25, x + radius + 1);
+            const double m =
+                naive_sum(img, y0, x0, y1 - y0, x1 - x0, false) / double((y1 - y0) * (x1 - x0));
+            REQUIRE(out(y, x) == uint8_t(std::lround(m)));
+        }
+    }
+
+    // a radius larger than the image averages all of it
+    image_buffer<uint8_t> flat(4, 5, 0);
+    flat(0, 0) = 200;
+    integral_filter::box_blur(flat.view(), flat.view(), 100);
+    REQUIRE(flat(3, 4) == 10);
+
+    // the zero bordered box_filter of avg_filter sums integer images the same way
+    image_buffer<int32_t> wide = img.convert<int32_t>();
+    image_buffer<float> a(19, 25), b(19, 25);
+    avg_filter::box_filter(wide.view(), a.view(), 45);
+    avg_filter::box_filter(img.convert<float>().view(), b.view(), 45);
+    for (size_t y = 0; y < 19; y++) {
+        for (size_t x = 0; x < 25; x++) {
+            REQUIRE(a(y, x) == Approx(b(y, x)).margin(1e-3));
+        }
+    }
+    REQUIRE_THROWS_AS(integral_filter::box_blur(img.view(), a.roi(0, 0, 3, 3), 1),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Testing local statistics and adaptive thresholds of integral_filter") {
+    // a gradient of lighting under a bright square
+    image_buffer<uint8_t> img(20, 30);
+    for (size_t y = 0; y < 20; y++) {
+        for (size_t x = 0; x < 30; x++) {
+            img(y, x) = uint8_t(2 * x + ((y >= 5 && y < 10 && x >= 20 && x < 25) ? 100 : 0));
+        }
+    }
+    image_buffer<float> mean(20, 30), deviation(20, 30);
+    integral_filter::local_statistics(img.view(), mean.view(), deviation.view(), 2);
+    REQUIRE(mean(15, 10) == Approx(20.0));
+    REQUIRE(deviation(15, 10) == Approx(std::sqrt(8.0)));
+    REQUIRE(mean(0, 0) == Approx(2.0));
+
+    image_buffer<uint8_t> out(20, 30);
+    integral_filter::adaptive_threshold(img.view(), out.view(), 3, 10.0);
+    REQUIRE(out(7, 22) == 255);
+    REQUIRE(out(15, 22) == 255);
+    REQUIRE(out(7, 27) == 0);
+
+    integral_filter::sauvola_threshold(img.view(), out.view(), 3, 0.2, 128.0, 2);
+    REQUIRE(out(7, 22) == 255);
+    REQUIRE(out(7, 26) == 0);
+    REQUIRE_THROWS_AS(
+        integral_filter::local_statistics(img.view(), mean.view(), deviation.roi(0, 0, 2, 2), 1),
+        std::invalid_argument);
+}
@@ -1,5 +1,9 @@
 #include "../../../src/machine_learning/image/filters/median_filter.h"
 #include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
 
 using namespace median_filter;
 
@@ -14,3 +18,72 @@ TEST_CASE("Testing median filter application with empty image") {
     std::vector<std::vector<int32_t>> image;
     CHECK_THROWS(apply_median_filter(image));
 }
+
+namespace {
+// the median of every window, sorted pixel by pixel
+template <typename T> image_buffer<T> sorted_median(const image_buffer<T>& src, size_t radius) {
+    const long h = long(src.height()), w = long(src.width()), r = long(radius);
+    image_buffer<T> out(src.height(), src.width());
+    std::vector<T> window;
+    for (long y = 0; y < h; y++) {
+        for (long x = 0; x < w; x++) {
+            window.clear();
+            for (long i = -r; i <= r; i++) {
+                for (long j = -r; j <= r; j++) {
+                    window.push_back(src(size_t(std::clamp(y + i, 0L, h - 1)),
+                                         size_t(std::clamp(x + j, 0L, w - 1))));
+                }
+            }
+            std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+            out(size_t(y), size_t(x)) = window[window.size() / 2];
+        }
+    }
+    return out;
+}
+
+template <typename T> image_buffer<T> noise(size_t h, size_t w, unsigned bits) {
+    std::mt19937 rng(7);
+    image_buffer<T> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = T(rng() >> (32 - bits));
+        }
+    }
+    return img;
+}
+
+template <typename T> void check_median(size_t h, size_t w, size_t radius, unsigned bits) {
+    const image_buffer<T> src = noise<T>(h, w, bits);
+    const image_buffer<T> expected = sorted_median(src, radius);
+    image_buffer<T> huang(h, w), constant(h, w), blurred(h, w);
+    median_filter::huang_median<T>(src.view(), huang.view(), radius, 3);
+    median_filter::constant_time_median<T>(src.view(), constant.view(), radius, 3);
+    median_filter::median_blur<T>(src.view(), blurred.view(), radius);
+    REQUIRE(huang == expected);
+    REQUIRE(constant == expected);
+    REQUIRE(blurred == expected);
+}
+} // namespace
+
+TEST_CASE("Testing the histogram median filters") {
+    for (size_t radius : {0, 1, 3, 9}) {
+        check_median<uint8_t>(23, 31, radius, 8);
+        check_median<uint16_t>(17, 29, radius, 16);
+    }
+    // few distinct values, and several strips of 8 bit columns
+    check_median<uint8_t>(5, 1100, 2, 3);
+    check_median<uint16_t>(9, 40, 4, 9);
+    // windows wider than the image
+    check_median<uint8_t>(3, 4, 6, 8);
+
+    image_buffer<uint8_t> img = noise<uint8_t>(12, 15, 8);
+    const image_buffer<uint8_t> expected = sorted_median(img, 2);
+    median_filter::constant_time_median<uint8_t>(img.view(), img.view(), 2);
+    REQUIRE(img == expected);
+
+    image_buffer<uint8_t> other(12, 14);
+    REQUIRE_THROWS_AS(median_filter::huang_median<uint8_t>(img.view(), other.view(), 1),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(median_filter::constant_time_median<uint8_t>(img.view(), img.view(), 40000),
+                      std::invalid_argument);
+}
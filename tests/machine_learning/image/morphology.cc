@@ -0,0 +1,115 @@
+#include "../../../src/machine_learning/image/morphology/operations.h"
+#include "../../../third_party/catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+// the extreme of the pixels of the rectangle around every pixel, one by one
+template <typename T>
+image_buffer<T> scan(const image_buffer<T>& src, size_t height, size_t width, bool largest) {
+    const long h = long(src.height()), w = long(src.width());
+    const long ay = long(height / 2), ax = long(width / 2);
+    image_buffer<T> out(src.height(), src.width());
+    for (long y = 0; y < h; y++) {
+        for (long x = 0; x < w; x++) {
+            T v = largest ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+            for (long i = y - ay; i < y - ay + long(height); i++) {
+                for (long j = x - ax; j < x - ax + long(width); j++) {
+                    if (i >= 0 && i < h && j >= 0 && j < w) {
+                        const T p = src(size_t(i), size_t(j));
+                        v = largest ? std::max(v, p) : std::min(v, p);
+                    }
+                }
+            }
+            out(size_t(y), size_t(x)) = v;
+        }
+    }
+    return out;
+}
+
+image_buffer<uint8_t> noise(size_t h, size_t w, unsigned modulo) {
+    std::mt19937 rng(4);
+    image_buffer<uint8_t> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = uint8_t(rng() % modulo);
+        }
+    }
+    return img;
+}
+} // namespace
+
+TEST_CASE("Testing van Herk erosion and dilation") {
+    using namespace morphology_operations;
+    const image_buffer<uint8_t> src = noise(29, 41, 256);
+    // squares, even and linear elements, and elements larger than the image
+    const std::vector<std::pair<size_t, size_t>> elements = {
+        {1, 1}, {3, 3}, {5, 2}, {1, 7}, {9, 1}, {31, 31}, {4, 50}};
+    for (auto [eh, ew] : elements) {
+        image_buffer<uint8_t> eroded(29, 41), dilated(29, 41);
+        erode<uint8_t>(src.view(), eroded.view(), eh, ew, 3);
+        dilate<uint8_t>(src.view(), dilated.view(), eh, ew, 3);
+        REQUIRE(eroded == scan(src, eh, ew, false));
+        REQUIRE(dilated == scan(src, eh, ew, true));
+    }
+
+    image_buffer<float> f(12, 70);
+    std::mt19937 rng(2);
+    for (size_t y = 0; y < 12; y++) {
+        for (size_t x = 0; x < 70; x++) {
+            f(y, x) = float(rng() % 1000) - 500.0f;
+        }
+    }
+    image_buffer<float> in_place = f;
+    dilate<float>(in_place.view(), in_place.view(), 3, 5);
+    REQUIRE(in_place == scan(f, 3, 5, true));
+
+    image_buffer<uint8_t> opened(29, 41), closed(29, 41), top(29, 41), black(29, 41);
+    opening<uint8_t>(src.view(), opened.view(), 3, 3);
+    closing<uint8_t>(src.view(), closed.view(), 3, 3);
+    top_hat<uint8_t>(src.view(), top.view(), 3, 3);
+    black_hat<uint8_t>(src.view(), black.view(), 3, 3);
+    REQUIRE(opened == scan(scan(src, 3, 3, false), 3, 3, true));
+    REQUIRE(closed == scan(scan(src, 3, 3, true), 3, 3, false));
+    for (size_t y = 0; y < 29; y++) {
+        for (size_t x = 0; x < 41; x++) {
+            REQUIRE(top(y, x) == src(y, x) - opened(y, x));
+            REQUIRE(black(y, x) == closed(y, x) - src(y, x));
+        }
+    }
+
+    image_buffer<uint8_t> other(2, 2);
+    REQUIRE_THROWS_AS(erode<uint8_t>(src.view(), other.view(), 3, 3), std::invalid_argument);
+    REQUIRE_THROWS_AS(dilate<uint8_t>(src.view(), opened.view(), 0, 3), std::invalid_argument);
+}
+
+TEST_CASE("Testing bit packed binary morphology") {
+    using namespace morphology_operations;
+    // widths on, around and across whole words
+    for (size_t w : {5, 64, 130, 200}) {
+        const image_buffer<uint8_t> gray = noise(37, w, 5);
+        const bit_image bits(gray.view(), 1);
+        REQUIRE(bits.words() == (w + 63) / 64);
+        const image_buffer<uint8_t> mask = bits.to_buffer<uint8_t>(1);
+        for (auto [eh, ew] : std::vector<std::pair<size_t, size_t>>{
+                 {1, 1}, {3, 3}, {2, 6}, {1, 31}, {31, 31}, {5, 70}}) {
+            REQUIRE(erode(bits, eh, ew, 2).to_buffer<uint8_t>(1) == scan(mask, eh, ew, false));
+            REQUIRE(dilate(bits, eh, ew, 2).to_buffer<uint8_t>(1) == scan(mask, eh, ew, true));
+        }
+        REQUIRE(opening(bits, 3, 3) == dilate(erode(bits, 3, 3), 3, 3));
+        REQUIRE(closing(bits, 3, 3) == erode(dilate(bits, 3, 3), 3, 3));
+    }
+
+    bit_image b(3, 70);
+    b.set(1, 65);
+    REQUIRE(b(1, 65));
+    REQUIRE(b.count() == 1);
+    REQUIRE(dilate(b, 3, 3).count() == 9);
+    REQUIRE(erode(b, 1, 2).count() == 0);
+    b.set(1, 65, false);
+    REQUIRE(b.count() == 0);
+    REQUIRE_THROWS_AS(erode(b, 0, 1), std::invalid_argument);
+}
@@ -0,0 +1,170 @@
+#include "../../../src/machine_learning/image/tile_pipeline.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+image_buffer<float> noise(size_t h, size_t w) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> u(0, 255);
+    image_buffer<float> img(h, w);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            img(y, x) = u(rng);
+        }
+    }
+    return img;
+}
+
+// the pixel (y, x) of img, or of its border off the image
+float at(const image_buffer<float>& img, long y, long x, convolution::border_mode border) {
+    const long h = long(img.height()), w = long(img.width());
+    if (y < 0 || y >= h || x < 0 || x >= w) {
+        if (border == convolution::border_mode::zero) {
+            return 0;
+        }
+        y = std::clamp(y, 0L, h - 1);
+        x = std::clamp(x, 0L, w - 1);
+    }
+    return img(size_t(y), size_t(x));
+}
+
+// the sobel magnitude of the whole image
+image_buffer<float> sobel(const image_buffer<float>& img, convolution::border_mode border) {
+    const int gx[3][3] = {{1, 0, -1}, {2, 0, -2}, {1, 0, -1}};
+    const int gy[3][3] = {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}};
+    image_buffer<float> out(img.height(), img.width());
+    for (long y = 0; y < long(img.height()); y++) {
+        for (long x = 0; x < long(img.width()); x++) {
+            float dx = 0, dy = 0;
+            for (long i = 0; i < 3; i++) {
+                for (long j = 0; j < 3; j++) {
+                    const float v = at(img, y + i - 1, x + j - 1, border);
+                    dx += float(gx[i][j]) * v;
+                    dy += float(gy[i][j]) * v;
+                }
+            }
+            out(size_t(y), size_t(x)) = std::sqrt(dx * dx + dy * dy);
+        }
+    }
+    return out;
+}
+
+bool close(const image_buffer<float>& a, const image_buffer<float>& b, float tolerance) {
+    for (size_t y = 0; y < a.height(); y++) {
+        for (size_t x = 0; x < a.width(); x++) {
+            if (std::abs(a(y, x) - b(y, x)) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST_CASE("Testing tile_pipeline against whole image filters") {
+    using convolution::border_mode;
+    const image_buffer<float> src = noise(70, 101);
+    for (border_mode border : {border_mode::replicate, border_mode::zero}) {
+        // blur then sobel, one whole image after the other
+        image_buffer<float> blurred(70, 101);
+        const std::vector<float> taps = convolution::gaussian_kernel(1.5);
+        convolution::sep_filter2d(src.view(), blurred.view(), std::span<const float>(taps),
+                                  std::span<const float>(taps), border);
+        const image_buffer<float> expected = sobel(blurred, border);
+
+        tile_pipeline pipeline;
+        pipeline.then(tile_stages::gaussian(1.5)).then(tile_stages::sobel());
+        REQUIRE(pipeline.size() == 2);
+        REQUIRE(pipeline.halo() == 6);
+        // tiles smaller than the halo, tiles that do not divide the image, a single tile
+        for (auto [th, tw] : {std::pair<size_t, size_t>{4, 5}, {16, 24}, {70, 101}}) {
+            tile_options opt;
+            opt.tile_height = th;
+            opt.tile_width = tw;
+            opt.border = border;
+            opt.threads = 3;
+            image_buffer<float> out(70, 101);
+            pipeline.run(src, out, opt);
+            REQUIRE(close(out, expected, 1e-2f));
+        }
+    }
+}
+
+TEST_CASE("Testing tile_pipeline stages") {
+    const image_buffer<float> src = noise(33, 47);
+    tile_options opt;
+    opt.tile_height = 8;
+    opt.tile_width = 16;
+
+    // a 3x3 box and two dense kernels with different halos per axis
+    Matrix<float> wide(std::vector<std::vector<float>>{{1, -2, 3, 0, 1}, {0, 1, 0, 2, -1},
+                                                       {1, 0, 0, 0, 2}});
+    for (const Matrix<float>& k :
+         {Matrix<float>(3, 3, 1.0f / 9), wide,
+          Matrix<float>(std::vector<std::vector<float>>{{-1, -1, -1}, {-1, 8, -1},
+                                                        {-1, -1, -1}})}) {
+        tile_pipeline one;
+        one.then(tile_stages::filter(k));
+        image_buffer<float> out(33, 47), expected(33, 47);
+        one.run(src, out, opt);
+        convolution::filter2d(src, expected, k, convolution::border_mode::replicate);
+        REQUIRE(close(out, expected, 1e-3f));
+    }
+
+    // dilation and erosion against the extremes of every window
+    tile_pipeline morph;
+    morph.then(tile_stages::dilate(2));
+    image_buffer<float> grown(33, 47);
+    morph.run(src, grown, opt);
+    tile_pipeline shrink;
+    shrink.then(tile_stages::erode(1));
+    image_buffer<float> shrunk(33, 47);
+    shrink.run(src, shrunk, opt);
+    const convolution::border_mode replicate = convolution::border_mode::replicate;
+    for (long y = 0; y < 33; y++) {
+        for (long x = 0; x < 47; x++) {
+            float hi = 0, lo = 255;
+            for (long i = -2; i <= 2; i++) {
+                for (long j = -2; j <= 2; j++) {
+                    hi = std::max(hi, at(src, y + i, x + j, replicate));
+                    if (std::abs(i) <= 1 && std::abs(j) <= 1) {
+                        lo = std::min(lo, at(src, y + i, x + j, replicate));
+                    }
+                }
+            }
+            REQUIRE(grown(size_t(y), size_t(x)) == hi);
+            REQUIRE(shrunk(size_t(y), size_t(x)) == lo);
+        }
+    }
+
+    // blur, edges and threshold into bytes, from bytes
+    image_buffer<uint8_t> bytes = src.convert<uint8_t>();
+    image_buffer<uint8_t> edges(33, 47);
+    tile_pipeline chain;
+    chain.then(tile_stages::box(3)).then(tile_stages::prewitt()).then(tile_stages::threshold(60));
+    chain.run(bytes, edges, opt);
+    size_t set = 0;
+    for (size_t y = 0; y < 33; y++) {
+        for (size_t x = 0; x < 47; x++) {
+            REQUIRE((edges(y, x) == 0 || edges(y, x) == 255));
+            set += edges(y, x) == 255;
+        }
+    }
+    REQUIRE(set > 0);
+    REQUIRE(set < 33 * 47);
+
+    tile_pipeline copy;
+    image_buffer<uint8_t> same(33, 47);
+    copy.run(bytes, same, opt);
+    REQUIRE(same == bytes);
+
+    image_buffer<float> other(3, 3);
+    REQUIRE_THROWS_AS(chain.run(src, other), std::invalid_argument);
+    opt.tile_width = 0;
+    REQUIRE_THROWS_AS(chain.run(src, grown, opt), std::invalid_argument);
+    REQUIRE_THROWS_AS(tile_stages::separable({1, 2}, {1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(chain.then(tile_stage{}), std::invalid_argument);
+}
@@ -1,5 +1,9 @@
 #include "../../../src/machine_learning/metrics/metrics.h"
 #include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <random>
+#include <span>
+#include <vector>
 
 using namespace metrics;
 using namespace metrics::losses;
@@ -77,3 +81,58 @@ TEST_CASE("Testing minkowski distance") {
     REQUIRE(metrics::minkowski_distance(x, y, 2) == Approx(1.4142135623730951));
     REQUIRE(metrics::minkowski_distance(x, y, 3) == Approx(1.2599210498948732));
 }
+
+TEST_CASE("Testing the confusion matrix") {
+    std::vector<double> y{1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 2};
+    std::vector<double> y_pred{1, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2};
+    confusion_matrix m(y, y_pred);
+    REQUIRE(m.true_positives() == 5);
+    REQUIRE(m.true_negatives() == 3);
+    REQUIRE(m.false_positives() == 1);
+    REQUIRE(m.false_negatives() == 1);
+    REQUIRE(m.accuracy() == accuracy_score(y, y_pred));
+    REQUIRE(m.precision() == Approx(5.0 / 6.0));
+    REQUIRE(m.recall() == recall(y, y_pred));
+    REQUIRE(m.f1_score() == f1_score(y, y_pred));
+
+    std::mt19937_64 rng(1);
+    std::vector<double> a(300000), b(300000);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = double(rng() % 2);
+        b[i] = rng() % 4 ? a[i] : 1 - a[i];
+    }
+    confusion_matrix serial(a, b), parallel = confusion(a, b, 4);
+    REQUIRE(parallel.true_positives() == serial.true_positives());
+    REQUIRE(parallel.true_negatives() == serial.true_negatives());
+    REQUIRE(parallel.false_positives() == serial.false_positives());
+    REQUIRE(parallel.false_negatives() == serial.false_negatives());
+    REQUIRE(serial.accuracy() == Approx(0.75).margin(0.01));
+}
+
+TEST_CASE("Testing the distances from a point to many") {
+    std::mt19937_64 rng(2);
+    std::uniform_real_distribution<double> u(-1, 1);
+    Matrix<double> points(100, 37);
+    for (size_t i = 0; i < points.size(); i++) {
+        points.data()[i] = u(rng);
+    }
+    std::vector<double> x(37);
+    for (double& v : x) {
+        v = u(rng);
+    }
+    std::vector<double> e = euclidean_distances(x, points, 3);
+    std::vector<double> m = manhattan_distances(x, points);
+    for (size_t i = 0; i < points.rows(); i++) {
+        double sq = 0, abs = 0;
+        for (size_t j = 0; j < 37; j++) {
+            sq += (x[j] - points(i, j)) * (x[j] - points(i, j));
+            abs += std::abs(x[j] - points(i, j));
+        }
+        REQUIRE(e[i] == Approx(std::sqrt(sq)));
+        REQUIRE(m[i] == Approx(abs));
+        std::span<const double> row(points.data() + i * 37, 37);
+        REQUIRE(e[i] == metrics::euclidean_distance(x, row));
+        REQUIRE(m[i] == metrics::manhattan_distance(x, row));
+    }
+    REQUIRE_THROWS_AS(euclidean_distances(std::vector<double>(3), points), std::invalid_argument);
+}
@@ -0,0 +1,60 @@
+#include "../../../src/machine_learning/nn/frozen_mlp.h"
+#include "../../../third_party/catch.hpp"
+#include <random>
+#include <vector>
+
+TEST_CASE("Testing frozen_mlp against the MLP it is exported from") {
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> u(-1, 1);
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < 400; i++) {
+        double a = u(rng), b = u(rng);
+        data.push_back({a, b, (a > 0) == (b > 0) ? 1.0 : -1.0});
+    }
+    MLP mlp(data, {{2, 16}, {16, 16}, {16, 1}}, 200, 0.05, 11);
+    mlp.fit(16, false);
+    Matrix<double> batch(data.size(), 2);
+    for (size_t i = 0; i < data.size(); i++) {
+        batch(i, 0) = data[i][0];
+        batch(i, 1) = data[i][1];
+    }
+    std::vector<double> expected = mlp.predict(batch);
+
+    frozen_mlp f32(mlp);
+    frozen_mlp i8(mlp, frozen_precision::int8);
+    REQUIRE(f32.precision() == frozen_precision::float32);
+    REQUIRE(i8.weight_bytes() < f32.weight_bytes());
+    std::vector<double> a = f32.predict_batch(batch), b = i8.predict_batch(batch);
+    size_t same_f32 = 0, same_i8 = 0;
+    for (size_t i = 0; i < data.size(); i++) {
+        same_f32 += a[i] == expected[i];
+        same_i8 += b[i] == expected[i];
+        REQUIRE(a[i] == f32.predict(std::vector<double>{data[i][0], data[i][1]}));
+        REQUIRE(b[i] == i8.predict(std::vector<double>{data[i][0], data[i][1]}));
+    }
+    REQUIRE(same_f32 >= 398);
+    REQUIRE(same_i8 >= 388);
+
+    std::vector<double> short_labels(3);
+    REQUIRE_THROWS_AS(f32.predict_batch(batch, short_labels), std::invalid_argument);
+    REQUIRE_THROWS_AS(f32.predict(std::vector<double>{1.0}), std::invalid_argument);
+}
+
+TEST_CASE("Testing frozen_mlp with several classes") {
+    std::mt19937_64 rng(9);
+    std::normal_distribution<double> noise(0, 0.3);
+    std::vector<std::vector<double>> centers = {{0, 3}, {3, 0}, {-3, -3}};
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < 300; i++) {
+        size_t c = i % 3;
+        data.push_back({centers[c][0] + noise(rng), centers[c][1] + noise(rng), double(c)});
+    }
+    MLP mlp(data, {{2, 8}, {8, 3}}, 50, 0.05, 3);
+    mlp.fit(32, false);
+    for (frozen_precision p : {frozen_precision::float32, frozen_precision::int8}) {
+        frozen_mlp f(mlp, p);
+        for (size_t c = 0; c < 3; c++) {
+            REQUIRE(f.predict(centers[c]) == double(c));
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include "../../../src/machine_learning/nn/mlp.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+TEST_CASE("Testing MLP on a binary problem that is not linearly separable") {
+    // xor of the signs of the two features
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> u(-1, 1);
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < 400; i++) {
+        double a = u(rng), b = u(rng);
+        data.push_back({a, b, (a > 0) == (b > 0) ? 1.0 : -1.0});
+    }
+    MLP mlp(data, {{2, 16}, {16, 1}}, 300, 0.05, 11);
+    mlp.fit(16, false);
+    size_t correct = 0;
+    Matrix<double> batch(data.size(), 2);
+    for (size_t i = 0; i < data.size(); i++) {
+        batch(i, 0) = data[i][0];
+        batch(i, 1) = data[i][1];
+        correct += mlp.predict(std::vector<double>{data[i][0], data[i][1]}) == data[i][2];
+    }
+    REQUIRE(correct > 360);
+    std::vector<double> labels = mlp.predict(batch);
+    for (size_t i = 0; i < data.size(); i++) {
+        REQUIRE(labels[i] == mlp.predict(std::vector<double>{data[i][0], data[i][1]}));
+    }
+}
+
+TEST_CASE("Testing the multi-threaded training of MLP") {
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> u(-1, 1);
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < 400; i++) {
+        double a = u(rng), b = u(rng);
+        data.push_back({a, b, (a > 0) == (b > 0) ? 1.0 : -1.0});
+    }
+    auto accuracy = [&](MLP& mlp) {
+        size_t correct = 0;
+        for (const std::vector<double>& row : data) {
+            correct += mlp.predict(std::vector<double>{row[0], row[1]}) == row[2];
+        }
+        return correct;
+    };
+    auto weights = [](MLP& mlp) {
+        std::vector<double> w;
+        for (nn::Linear& layer : mlp.layers()) {
+            w.insert(w.end(), layer.weights().data(),
+                     layer.weights().data() + layer.weights().size());
+            w.insert(w.end(), layer.biases().begin(), layer.biases().end());
+        }
+        return w;
+    };
+
+    // the same steps with the shards reduced in any order, and with or without the loader
+    MLP serial(data, {{2, 16}, {16, 1}}, 100, 0.05, 11);
+    serial.fit(16, false, 1);
+    MLP sharded(data, {{2, 16}, {16, 1}}, 100, 0.05, 11);
+    sharded.fit(mlp_train_options{16, 4, false, 0, false});
+    MLP prefetched(data, {{2, 16}, {16, 1}}, 100, 0.05, 11);
+    prefetched.fit(mlp_train_options{16, 4, false, 3, false});
+    std::vector<double> a = weights(serial), b = weights(sharded), c = weights(prefetched);
+    REQUIRE(b == c);
+    for (size_t i = 0; i < a.size(); i++) {
+        REQUIRE(std::abs(a[i] - b[i]) < 1e-6);
+    }
+
+    MLP trained(data, {{2, 16}, {16, 1}}, 300, 0.05, 11);
+    trained.fit(mlp_train_options{16, 3, false, 2, false});
+    REQUIRE(accuracy(trained) > 360);
+
+    MLP hogwild(data, {{2, 16}, {16, 1}}, 300, 0.05, 11);
+    hogwild.fit(mlp_train_options{16, 4, true, 0, false});
+    REQUIRE(accuracy(hogwild) > 360);
+}
+
+TEST_CASE("Testing MLP with several classes") {
+    std::mt19937_64 rng(9);
+    std::normal_distribution<double> noise(0, 0.3);
+    std::vector<std::vector<double>> centers = {{0, 3}, {3, 0}, {-3, -3}};
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < 300; i++) {
+        size_t c = i % 3;
+        data.push_back({centers[c][0] + noise(rng), centers[c][1] + noise(rng), double(c)});
+    }
+    MLP mlp(data, {{2, 8}, {8, 3}}, 50, 0.05, 3);
+    mlp.fit(32, false);
+    for (size_t c = 0; c < 3; c++) {
+        REQUIRE(mlp.predict(centers[c]) == double(c));
+    }
+
+    std::vector<std::vector<double>> bad = {{0, 0, 5}};
+    MLP wrong(bad, {{2, 3}}, 1, 0.1, 1);
+    REQUIRE_THROWS_AS(wrong.fit(1, false), std::invalid_argument);
+}
@@ -0,0 +1,77 @@
+#include "../../../src/machine_learning/nn/nn.h"
+#include "../../../third_party/catch.hpp"
+#include <vector>
+
+TEST_CASE("Testing the batch forward of nn::Linear") {
+    nn::Linear layer(3, 2, true, 1);
+    Matrix<double> input(std::vector<std::vector<double>>{{1, 2, 3}, {-1, 0, 0.5}});
+    Matrix<double> output;
+    layer.forward(input, output);
+    REQUIRE(output.rows() == 2);
+    REQUIRE(output.cols() == 2);
+    for (size_t i = 0; i < 2; i++) {
+        std::vector<double> one = layer.forward(std::vector<double>(input.row(i).begin(),
+                                                                    input.row(i).end()));
+        for (size_t j = 0; j < 2; j++) {
+            REQUIRE(output(i, j) == Approx(one[j]));
+        }
+    }
+    REQUIRE_THROWS_AS(layer.forward(Matrix<double>(2, 4), output), std::invalid_argument);
+}
+
+TEST_CASE("Testing the batch backward of nn::Linear against finite differences") {
+    nn::Linear layer(4, 3, true, 2);
+    Matrix<double> input(5, 4);
+    for (size_t i = 0; i < input.size(); i++) {
+        input.data()[i] = double(int(i * 7 % 11) - 5) / 4;
+    }
+    // the loss is the sum of the outputs weighted by w
+    Matrix<double> w(5, 3);
+    for (size_t i = 0; i < w.size(); i++) {
+        w.data()[i] = double(int(i * 5 % 7) - 3) / 2;
+    }
+    auto loss = [&]() {
+        Matrix<double> out;
+        layer.forward(input, out);
+        double sum = 0;
+        for (size_t i = 0; i < out.size(); i++) {
+            sum += out.data()[i] * w.data()[i];
+        }
+        return sum;
+    };
+    Matrix<double> grad_input;
+    layer.backward(input, w, &grad_input);
+    const double h = 1e-6;
+    for (size_t k = 0; k < layer.weights().size(); k++) {
+        double& x = layer.weights().data()[k];
+        x += h;
+        double up = loss();
+        x -= 2 * h;
+        double down = loss();
+        x += h;
+        REQUIRE(layer.grad().weight.data()[k] == Approx((up - down) / (2 * h)).epsilon(1e-6));
+    }
+    for (size_t j = 0; j < layer.biases().size(); j++) {
+        double& b = layer.biases()[j];
+        b += h;
+        double up = loss();
+        b -= 2 * h;
+        double down = loss();
+        b += h;
+        REQUIRE(layer.grad().bias[j] == Approx((up - down) / (2 * h)).epsilon(1e-6));
+    }
+    for (size_t k = 0; k < input.size(); k++) {
+        double& x = input.data()[k];
+        x += h;
+        double up = loss();
+        x -= 2 * h;
+        double down = loss();
+        x += h;
+        REQUIRE(grad_input.data()[k] == Approx((up - down) / (2 * h)).epsilon(1e-6));
+    }
+
+    // a step against the gradient lowers the loss
+    double before = loss();
+    layer.step(1e-3);
+    REQUIRE(loss() < before);
+}
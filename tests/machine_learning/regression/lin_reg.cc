@@ -1,6 +1,10 @@
 #include "../../../src/machine_learning/regression/linear_regression/lin_reg.h"
 #include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <random>
+#include <span>
 #include <string>
+#include <vector>
 
 TEST_CASE("Testing linear regression [1]") {
     std::vector<std::vector<double>> data = {
@@ -69,3 +73,61 @@ TEST_CASE("Testing linear regression [1]") {
     double prediction = lin_reg.predict(2.2);
     REQUIRE(prediction - 12 <= 1);
 }
+
+TEST_CASE("Testing online linear regression") {
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> noise(0, 0.5);
+    std::vector<double> x(20000), y(20000);
+    std::vector<std::vector<double>> points;
+    for (size_t i = 0; i < x.size(); i++) {
+        // far from the origin, where naive sums of squares lose their digits
+        x[i] = 1e6 + double(i % 1000) / 10.0;
+        y[i] = 3.0 - 2.0 * x[i] + noise(rng);
+        points.push_back({x[i], y[i]});
+    }
+    online_linear_regression online;
+    online.update(x, y);
+    REQUIRE(online.count() == x.size());
+    linear_regression batch(points);
+    auto [a, b] = batch.get_results();
+    REQUIRE(std::abs(online.slope() - b) < 1e-9);
+    REQUIRE(std::abs(online.intercept() - a) < 1e-3);
+    REQUIRE(std::abs(online.slope() + 2.0) < 1e-3);
+    REQUIRE(online.r_squared() > 0.99);
+
+    // shards merged in any grouping, and the parallel fit, give the same estimator
+    std::span<const double> xs(x), ys(y);
+    online_linear_regression left, right;
+    left.update(xs.first(7000), ys.first(7000));
+    right.update(xs.subspan(7000), ys.subspan(7000));
+    left.merge(right);
+    REQUIRE(left.count() == online.count());
+    REQUIRE(std::abs(left.slope() - online.slope()) < 1e-9);
+    REQUIRE(std::abs(left.mean_y() - online.mean_y()) < 1e-6);
+    online_linear_regression parallel = linear_regression_fit(x, y, 4);
+    REQUIRE(std::abs(parallel.slope() - online.slope()) < 1e-9);
+    REQUIRE(std::abs(parallel.predict(1e6) - online.predict(1e6)) < 1e-6);
+
+    REQUIRE_THROWS_AS(online_linear_regression(0.0), std::invalid_argument);
+    REQUIRE_THROWS_AS(linear_regression_fit(x, std::vector<double>(3)), std::invalid_argument);
+}
+
+TEST_CASE("Testing online linear regression with forgetting") {
+    online_linear_regression drifting(0.99), everything;
+    // the slope changes from 1 to -1 halfway
+    for (int i = 0; i < 4000; i++) {
+        double x = double(i % 50), slope = i < 2000 ? 1.0 : -1.0;
+        drifting.update(x, slope * x + 5);
+        everything.update(x, slope * x + 5);
+    }
+    REQUIRE(std::abs(drifting.slope() + 1.0) < 1e-6);
+    REQUIRE(std::abs(drifting.intercept() - 5.0) < 1e-4);
+    REQUIRE(std::abs(everything.slope()) < 0.1);
+    REQUIRE(drifting.weight() < 101);
+
+    online_linear_regression flat;
+    flat.update(2.0, 7.0);
+    flat.update(2.0, 9.0);
+    REQUIRE(flat.slope() == 0.0);
+    REQUIRE(flat.predict(10.0) == 8.0);
+}
@@ -61,3 +61,62 @@ TEST_CASE("Testing shortest path with non admissible heuristic") {
     std::vector<std::string> check = {"A", "B", "C", "D"};
     REQUIRE(path == check);
 }
+
+TEST_CASE("Testing A* with a reused search context") {
+    const int w = 60;
+    AStar<int> a;
+    for (int i = 0; i < w * w; i++) {
+        a.insert_node(i, 0);
+    }
+    auto cell = [&](int x, int y) { return y * w + x; };
+    for (int y = 0; y < w; y++) {
+        for (int x = 0; x < w; x++) {
+            if (x + 1 < w) {
+                a.add_edge(cell(x, y), cell(x + 1, y), 1);
+                a.add_edge(cell(x + 1, y), cell(x, y), 1);
+            }
+            if (y + 1 < w) {
+                a.add_edge(cell(x, y), cell(x, y + 1), 1);
+                a.add_edge(cell(x, y + 1), cell(x, y), 1);
+            }
+        }
+    }
+    AStar<int>::search_context ctx;
+    for (int k = 0; k < w; k++) {
+        std::vector<int> path = a.shortest_path(cell(0, k), cell(w - 1, w - 1 - k), ctx);
+        REQUIRE(path.size() == size_t(w - 1 + std::abs(w - 1 - 2 * k) + 1));
+        REQUIRE(path.front() == cell(0, k));
+        REQUIRE(path.back() == cell(w - 1, w - 1 - k));
+        for (size_t i = 1; i < path.size(); i++) {
+            REQUIRE(a.has_edge(path[i - 1], path[i]));
+        }
+    }
+    REQUIRE(a.shortest_path(0, 0) == std::vector<int>{0});
+    REQUIRE(a.shortest_path(0, -5).empty());
+    a.insert_node(-5, 0);
+    REQUIRE(a.shortest_path(0, -5, ctx).empty());
+}
+
+TEST_CASE("Testing batched A* queries") {
+    AStar<int> a;
+    const int n = 300;
+    for (int i = 0; i < n; i++) {
+        a.insert_node(i, 0);
+    }
+    for (int i = 0; i < n; i++) {
+        a.add_edge(i, (i + 1) % n, 1);
+        a.add_edge(i, (i + 7) % n, 5);
+    }
+    std::vector<std::pair<int, int>> queries;
+    for (int i = 0; i < 400; i++) {
+        queries.push_back({(i * 31) % n, (i * 17) % n});
+    }
+    queries.push_back({0, -1});
+    for (size_t threads : {1, 3}) {
+        std::vector<std::vector<int>> paths = a.shortest_path_batch(queries, threads);
+        REQUIRE(paths.size() == queries.size());
+        for (size_t i = 0; i < queries.size(); i++) {
+            REQUIRE(paths[i] == a.shortest_path(queries[i].first, queries[i].second));
+        }
+    }
+}
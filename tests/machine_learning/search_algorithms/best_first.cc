@@ -83,3 +83,102 @@ TEST_CASE("Testing throws on add_edge for best first function") {
     CHECK_NOTHROW(h.add_edge(10, 20));
     CHECK_NOTHROW(h.add_edge(0, 1));
 }
+
+TEST_CASE("Testing batched best first search") {
+    best_first<int> h;
+    for (int i = 0; i < 200; i++) {
+        h.insert_node(i, 200 - i);
+    }
+    for (int i = 0; i + 1 < 200; i++) {
+        if (i % 50 != 49) {
+            h.add_edge(i, i + 1);
+        }
+    }
+    std::vector<std::pair<int, int>> queries;
+    for (int i = 0; i < 500; i++) {
+        queries.push_back({(i * 7) % 200, (i * 13) % 200});
+    }
+    for (size_t threads : {1, 4}) {
+        std::vector<bool> found = h.search_batch(queries, threads);
+        REQUIRE(found.size() == queries.size());
+        for (size_t i = 0; i < queries.size(); i++) {
+            REQUIRE(found[i] == h.search(queries[i].first, queries[i].second));
+        }
+    }
+    REQUIRE(h.search_batch({}).empty());
+}
+
+TEST_CASE("Testing beam search of best first") {
+    best_first<std::string> h;
+    for (auto [node, value] : std::vector<std::pair<std::string, double>>{
+             {"s", 10}, {"trap", 1}, {"t1", 2}, {"g1", 5}, {"g2", 4}, {"G", 0}}) {
+        h.insert_node(node, value);
+    }
+    h.add_edge("s", "trap");
+    h.add_edge("s", "g1");
+    h.add_edge("trap", "t1");
+    h.add_edge("g1", "g2");
+    h.add_edge("g2", "G");
+
+    beam_options narrow;
+    narrow.width = 1;
+    best_first<std::string>::beam_result r = h.beam_search("s", "G", narrow);
+    REQUIRE(r.found == false);
+    REQUIRE(r.path == std::vector<std::string>{"s", "trap"});
+
+    narrow.anytime = true;
+    r = h.beam_search("s", "G", narrow);
+    REQUIRE(r.found == true);
+    REQUIRE(r.path == std::vector<std::string>{"s", "g1", "g2", "G"});
+
+    beam_options wide;
+    wide.width = 2;
+    r = h.beam_search("s", "G", wide);
+    REQUIRE(r.found == true);
+    REQUIRE(r.expanded == 5);
+    REQUIRE(h.beam_search("s", "s").path == std::vector<std::string>{"s"});
+}
+
+TEST_CASE("Testing beam search budgets of best first") {
+    // a complete 4-ary tree of depth 8, the heuristic leads towards the goal leaf
+    best_first<int> h;
+    const int depth = 8, leaves = 1 << (2 * depth);
+    int goal = (leaves - 1) / 3 + 12345;
+    std::vector<int> level(goal + leaves, 0);
+    h.insert_node(0, depth);
+    for (int u = 0; u < (leaves - 1) / 3; u++) {
+        for (int c = 1; c <= 4; c++) {
+            int v = 4 * u + c;
+            int w = goal;
+            while (w > v) {
+                w = (w - 1) / 4;
+            }
+            level[v] = level[u] + 1;
+            h.insert_node(v, w == v ? depth - level[v] : depth + 1);
+            h.add_edge(u, v);
+        }
+    }
+    beam_options opt;
+    opt.width = 1;
+    best_first<int>::beam_result r = h.beam_search(0, goal, opt);
+    REQUIRE(r.found == true);
+    REQUIRE(r.path.size() == size_t(depth + 1));
+    REQUIRE(r.expanded == size_t(depth));
+
+    opt.max_expansions = 3;
+    r = h.beam_search(0, goal, opt);
+    REQUIRE(r.found == false);
+    REQUIRE(r.expanded == 3);
+    REQUIRE(r.path.size() == 4);
+    int w = goal;
+    while (w > r.path.back()) {
+        w = (w - 1) / 4;
+    }
+    REQUIRE(w == r.path.back());
+
+    opt.max_expansions = 0;
+    opt.time_budget = std::chrono::milliseconds(1);
+    opt.width = 1 << 20;
+    r = h.beam_search(0, -1, opt);
+    REQUIRE(r.found == false);
+}
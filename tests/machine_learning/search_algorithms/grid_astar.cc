@@ -0,0 +1,116 @@
+#include "../../../src/machine_learning/search_algorithms/AStar/grid_astar.h"
+#include "../../../third_party/catch.hpp"
+#include <cmath>
+#include <queue>
+#include <random>
+
+namespace {
+double path_length(const occupancy_grid& g, const std::vector<grid_point>& path, bool eight) {
+    double total = 0;
+    for (size_t i = 1; i < path.size(); i++) {
+        int32_t dx = path[i].x - path[i - 1].x, dy = path[i].y - path[i - 1].y;
+        REQUIRE(std::abs(dx) <= 1);
+        REQUIRE(std::abs(dy) <= 1);
+        REQUIRE(g.free(path[i].x, path[i].y));
+        if (dx != 0 && dy != 0) {
+            REQUIRE(eight);
+            REQUIRE(g.free(path[i - 1].x + dx, path[i - 1].y));
+            REQUIRE(g.free(path[i - 1].x, path[i - 1].y + dy));
+            total += std::sqrt(2.0);
+        } else {
+            total += 1;
+        }
+    }
+    return total;
+}
+
+int bfs_distance(const occupancy_grid& g, grid_point s, grid_point t) {
+    std::vector<int> dist(g.width() * g.height(), -1);
+    std::queue<grid_point> q;
+    dist[s.y * g.width() + s.x] = 0;
+    q.push(s);
+    while (!q.empty()) {
+        grid_point p = q.front();
+        q.pop();
+        const int32_t moves[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        for (auto& m : moves) {
+            int32_t x = p.x + m[0], y = p.y + m[1];
+            if (g.free(x, y) && dist[y * g.width() + x] == -1) {
+                dist[y * g.width() + x] = dist[p.y * g.width() + p.x] + 1;
+                q.push({x, y});
+            }
+        }
+    }
+    return dist[t.y * g.width() + t.x];
+}
+} // namespace
+
+TEST_CASE("testing bit packed occupancy grid") {
+    occupancy_grid g(4096, 4096);
+    REQUIRE(g.bytes() == 4096 * 4096 / 8);
+    g.set_blocked(100, 7);
+    REQUIRE(g.blocked(100, 7));
+    REQUIRE(g.free(101, 7));
+    REQUIRE(g.blocked(-1, 0));
+    REQUIRE(g.blocked(0, 4096));
+    g.set_blocked(100, 7, false);
+    REQUIRE(g.free(100, 7));
+    REQUIRE_THROWS(g.set_blocked(4096, 0));
+}
+
+TEST_CASE("testing jump point search against plain grid A*") {
+    std::mt19937 rng(22);
+    for (int round = 0; round < 20; round++) {
+        occupancy_grid g(48, 40);
+        for (int32_t y = 0; y < g.height(); y++) {
+            for (int32_t x = 0; x < g.width(); x++) {
+                if (rng() % 100 < 30) {
+                    g.set_blocked(x, y);
+                }
+            }
+        }
+        grid_point s{0, 0}, t{47, 39};
+        g.set_blocked(s.x, s.y, false);
+        g.set_blocked(t.x, t.y, false);
+
+        grid_astar jps(g);
+        grid_astar plain(g, {grid_connectivity::eight, grid_heuristic::octile, false});
+        std::vector<grid_point> a = jps.shortest_path(s, t), b = plain.shortest_path(s, t);
+        REQUIRE(a.empty() == b.empty());
+        if (!a.empty()) {
+            REQUIRE(a.front() == s);
+            REQUIRE(a.back() == t);
+            REQUIRE(std::abs(jps.cost() - plain.cost()) < 1e-9);
+            REQUIRE(std::abs(path_length(g, a, true) - jps.cost()) < 1e-9);
+            REQUIRE(std::abs(path_length(g, b, true) - plain.cost()) < 1e-9);
+        } else {
+            REQUIRE(jps.cost() == -1);
+        }
+
+        grid_astar four(g, {grid_connectivity::four, grid_heuristic::manhattan, true});
+        std::vector<grid_point> c = four.shortest_path(s, t);
+        int expected = bfs_distance(g, s, t);
+        REQUIRE(int(c.size()) - 1 == (c.empty() ? -1 : expected));
+        if (!c.empty()) {
+            REQUIRE(path_length(g, c, false) == expected);
+        }
+    }
+}
+
+TEST_CASE("testing jump point search on an open map") {
+    occupancy_grid g(512, 512);
+    for (int32_t y = 0; y < 400; y++) {
+        g.set_blocked(256, y);
+    }
+    grid_astar jps(g);
+    grid_astar plain(g, {grid_connectivity::eight, grid_heuristic::octile, false});
+    std::vector<grid_point> a = jps.shortest_path({0, 0}, {511, 0});
+    std::vector<grid_point> b = plain.shortest_path({0, 0}, {511, 0});
+    REQUIRE(!a.empty());
+    REQUIRE(std::abs(jps.cost() - plain.cost()) < 1e-9);
+    REQUIRE(jps.expanded() * 10 < plain.expanded());
+
+    REQUIRE(jps.shortest_path({0, 0}, {256, 0}).empty());
+    REQUIRE(jps.cost() == -1);
+    REQUIRE(jps.shortest_path({3, 3}, {3, 3}).size() == 1);
+}
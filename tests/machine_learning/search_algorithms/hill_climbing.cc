@@ -66,3 +66,49 @@ TEST_CASE("testing search function for hill climbing class") {
 
     REQUIRE(h2.search('s', 'G') == false);
 }
+
+TEST_CASE("testing parallel random restart hill climbing") {
+    // a ring of valleys: every multiple of 25 is a local minimum, 250 is the global one
+    hill_climbing<int> h;
+    const int n = 1000;
+    auto f = [](int u) {
+        int m = (u + 12) / 25 % 40;
+        return std::abs(u - (u + 12) / 25 * 25) + (m == 10 ? -10.0 : 1.0 + m % 7);
+    };
+    for (int u = 0; u < n; u++) {
+        h.insert_node(u, f(u));
+    }
+    for (int u = 0; u < n; u++) {
+        h.add_edge(u, (u + 1) % n);
+        h.add_edge(u, (u + n - 1) % n);
+    }
+
+    climb_options opt;
+    opt.restarts = 1;
+    opt.threads = 1;
+    hill_climbing<int>::climb_result one = h.random_restart(opt);
+    REQUIRE(one.found);
+    REQUIRE(one.node % 25 == 0);
+
+    opt.restarts = 400;
+    hill_climbing<int>::climb_result serial = h.random_restart(opt);
+    opt.threads = 4;
+    hill_climbing<int>::climb_result parallel = h.random_restart(opt);
+    REQUIRE(serial.node == 250);
+    REQUIRE(serial.value == -10.0);
+    REQUIRE(parallel.node == serial.node);
+
+    opt.target = -10;
+    REQUIRE(h.random_restart(opt).value == -10.0);
+
+    climb_options annealing;
+    annealing.restarts = 32;
+    annealing.temperature = 5;
+    annealing.max_steps = 5000;
+    annealing.seed = 7;
+    hill_climbing<int>::climb_result hot = h.random_restart(annealing);
+    REQUIRE(hot.found);
+    REQUIRE(hot.value <= 1.0);
+
+    REQUIRE(!hill_climbing<int>().random_restart().found);
+}
@@ -1,5 +1,7 @@
 #include "../../src/classes/queue/dequeue_list.h"
 #include "../../third_party/catch.hpp"
+#include <deque>
+#include <random>
 #include <string>
 
 TEST_CASE("testing push in dequeue") {
@@ -95,3 +97,71 @@ TEST_CASE("testing operator = for dequeue list class") {
 
     REQUIRE(v1 == v2);
 }
+
+TEST_CASE("testing pop to empty and random access in dequeue") {
+    dequeue_list<int, 4> q;
+    q.push_back(1);
+    q.pop_front();
+    REQUIRE(q.empty() == true);
+    q.push_front(2);
+    q.pop_back();
+    REQUIRE(q.empty() == true);
+
+    for (int i = 0; i < 10; i++) {
+        q.push_back(i);
+        q.push_front(-i - 1);
+    }
+    REQUIRE(q.size() == 20);
+    for (int i = 0; i < 20; i++) {
+        REQUIRE(q[i] == i - 10);
+    }
+    REQUIRE(q.at(19) == 9);
+    REQUIRE_THROWS_AS(q.at(20), std::out_of_range);
+    q[0] = 100;
+    REQUIRE(q.front() == 100);
+    REQUIRE(*(q.begin() + 5) == -5);
+    REQUIRE(q.end() - q.begin() == 20);
+}
+
+TEST_CASE("testing dequeue against std::deque") {
+    dequeue_list<std::string, 8> q;
+    std::deque<std::string> ref;
+    std::mt19937 rng(3);
+
+    for (int i = 0; i < 20000; i++) {
+        int op = int(rng() % 5);
+        std::string s = std::to_string(i) + std::string(20, 'x');
+        if (op == 0) {
+            q.push_back(s);
+            ref.push_back(s);
+        } else if (op == 1) {
+            q.push_front(s);
+            ref.push_front(s);
+        } else if (op == 2 && !ref.empty()) {
+            q.pop_back();
+            ref.pop_back();
+        } else if (op == 3 && !ref.empty()) {
+            q.pop_front();
+            ref.pop_front();
+        } else if (!ref.empty()) {
+            size_t k = rng() % ref.size();
+            REQUIRE(q[k] == ref[k]);
+        }
+        REQUIRE(q.size() == ref.size());
+        if (!ref.empty()) {
+            REQUIRE(q.front() == ref.front());
+            REQUIRE(q.back() == ref.back());
+        }
+    }
+    REQUIRE(std::equal(q.begin(), q.end(), ref.begin(), ref.end()));
+
+    dequeue_list<std::string, 8> moved(std::move(q));
+    REQUIRE(q.empty() == true);
+    REQUIRE(moved.size() == ref.size());
+    q = moved;
+    REQUIRE(std::equal(q.begin(), q.end(), ref.begin(), ref.end()));
+    q.clear();
+    q.shrink_to_fit();
+    q.push_back("a");
+    REQUIRE(q.front() == "a");
+}
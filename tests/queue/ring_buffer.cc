@@ -0,0 +1,169 @@
+#include "../../src/classes/queue/ring_buffer.h"
+#include "../../third_party/catch.hpp"
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Testing try_push() and try_pop() spsc_ring_buffer") {
+    spsc_ring_buffer<int> r(3);
+
+    REQUIRE(r.capacity() == 4);
+    REQUIRE(r.empty() == true);
+    REQUIRE(r.try_pop() == std::nullopt);
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(r.try_push(i) == true);
+    }
+    REQUIRE(r.try_push(4) == false);
+    REQUIRE(r.size() == 4);
+    for (int lap = 0; lap < 10; lap++) {
+        REQUIRE(r.try_pop() == lap);
+        REQUIRE(r.try_push(lap + 4) == true);
+    }
+    REQUIRE(r.size() == 4);
+    REQUIRE_THROWS_AS(spsc_ring_buffer<int>(0), std::invalid_argument);
+}
+
+TEST_CASE("Testing push_n() and pop_n() spsc_ring_buffer") {
+    spsc_ring_buffer<std::string> r(8);
+    std::vector<std::string> in;
+    for (int i = 0; i < 12; i++) {
+        in.push_back(std::string(20, char('a' + i)));
+    }
+
+    REQUIRE(r.push_n(in.begin(), 5) == 5);
+    std::vector<std::string> out;
+    REQUIRE(r.pop_n(std::back_inserter(out), 3) == 3);
+    REQUIRE(r.push_n(in.begin() + 5, 7) == 6);
+    REQUIRE(r.size() == 8);
+    REQUIRE(r.pop_n(std::back_inserter(out), 100) == 8);
+    REQUIRE(out.size() == 11);
+    for (int i = 0; i < 11; i++) {
+        REQUIRE(out[i] == std::string(20, char('a' + i)));
+    }
+    // what is left is destroyed with the buffer
+    r.try_emplace(30, 'z');
+}
+
+TEST_CASE("Testing spsc_ring_buffer with two threads") {
+    spsc_ring_buffer<std::unique_ptr<int>> r(64);
+    const int n = 100000;
+    long long sum = 0;
+    bool ordered = true;
+
+    std::thread consumer([&] {
+        int expected = 0;
+        std::vector<std::unique_ptr<int>> batch;
+        while (expected < n) {
+            batch.clear();
+            if (r.pop_n(std::back_inserter(batch), 16) == 0) {
+                if (auto p = r.try_pop()) {
+                    batch.push_back(std::move(*p));
+                }
+            }
+            for (auto& p : batch) {
+                ordered = ordered && *p == expected++;
+                sum += *p;
+            }
+        }
+    });
+    for (int i = 0; i < n;) {
+        if (i % 2 == 0) {
+            std::vector<std::unique_ptr<int>> batch;
+            for (int j = 0; j < 8 && i + j < n; j++) {
+                batch.push_back(std::make_unique<int>(i + j));
+            }
+            i += int(r.push_n(batch.begin(), batch.size()));
+        } else if (r.try_push(std::make_unique<int>(i))) {
+            i++;
+        }
+    }
+    consumer.join();
+    REQUIRE(ordered == true);
+    REQUIRE(sum == (long long)n * (n - 1) / 2);
+}
+
+TEST_CASE("Testing try_push() and try_pop() mpmc_ring_buffer") {
+    mpmc_ring_buffer<std::string> r(1);
+
+    REQUIRE(r.capacity() == 2);
+    REQUIRE(r.try_push("a") == true);
+    REQUIRE(r.try_emplace(3, 'b') == true);
+    REQUIRE(r.try_push("c") == false);
+    REQUIRE(r.try_pop() == "a");
+    REQUIRE(r.try_push("c") == true);
+    REQUIRE(r.try_pop() == "bbb");
+    REQUIRE(r.try_pop() == "c");
+    REQUIRE(r.try_pop() == std::nullopt);
+    REQUIRE(r.empty() == true);
+    REQUIRE_THROWS_AS(mpmc_ring_buffer<int>(0), std::invalid_argument);
+}
+
+TEST_CASE("Testing push_n() and pop_n() mpmc_ring_buffer") {
+    mpmc_ring_buffer<int> r(8);
+    std::vector<int> in(20);
+    std::iota(in.begin(), in.end(), 0);
+
+    REQUIRE(r.push_n(in.begin(), 20) == 8);
+    std::vector<int> out;
+    REQUIRE(r.pop_n(std::back_inserter(out), 5) == 5);
+    REQUIRE(r.push_n(in.begin() + 8, 12) == 5);
+    REQUIRE(r.pop_n(std::back_inserter(out), 20) == 8);
+    REQUIRE(out == std::vector<int>(in.begin(), in.begin() + 13));
+    REQUIRE(r.pop_n(std::back_inserter(out), 1) == 0);
+}
+
+TEST_CASE("Testing mpmc_ring_buffer with many threads") {
+    mpmc_ring_buffer<int> r(128);
+    const int producers = 3, consumers = 3, per = 30000;
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+    std::vector<std::atomic<int>> seen(producers * per);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            std::vector<int> batch;
+            for (int i = 0; i < per;) {
+                batch.clear();
+                for (int j = 0; j < 4 && i + j < per; j++) {
+                    batch.push_back(p * per + i + j);
+                }
+                i += int(r.push_n(batch.begin(), batch.size()));
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c] {
+            std::vector<int> batch;
+            while (received.load() < producers * per) {
+                batch.clear();
+                if (c == 0) {
+                    if (auto x = r.try_pop()) {
+                        batch.push_back(*x);
+                    }
+                } else {
+                    r.pop_n(std::back_inserter(batch), 8);
+                }
+                for (int x : batch) {
+                    seen[x]++;
+                    sum += x;
+                }
+                received += int(batch.size());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    long long n = producers * per;
+    REQUIRE(sum == n * (n - 1) / 2);
+    bool once = true;
+    for (auto& s : seen) {
+        once = once && s == 1;
+    }
+    REQUIRE(once == true);
+    REQUIRE(r.empty() == true);
+}
@@ -0,0 +1,91 @@
+#include "../../src/classes/sketch/count_min_sketch.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+// a skewed stream: key i occurs about n / (i + 1) times
+std::vector<uint64_t> zipf_stream(size_t n, size_t keys, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<double> weights(keys);
+    for (size_t i = 0; i < keys; i++) {
+        weights[i] = 1.0 / double(i + 1);
+    }
+    std::discrete_distribution<uint64_t> pick(weights.begin(), weights.end());
+    std::vector<uint64_t> out(n);
+    for (auto& x : out) {
+        x = pick(rng);
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("testing count_min_sketch") {
+    std::vector<uint64_t> stream = zipf_stream(200000, 5000, 3);
+    std::unordered_map<uint64_t, uint32_t> exact;
+    auto cms = count_min_sketch<uint64_t>::with_error(0.001, 0.01);
+    REQUIRE(cms.width() == 2719);
+    REQUIRE(cms.depth() == 5);
+    for (uint64_t x : stream) {
+        cms.add(x);
+        exact[x]++;
+    }
+    REQUIRE(cms.total() == stream.size());
+    size_t over = 0;
+    for (auto [key, count] : exact) {
+        REQUIRE(cms.estimate(key) >= count);
+        over += cms.estimate(key) > count + cms.error_bound();
+    }
+    REQUIRE(over <= exact.size() / 50);
+
+    // two halves merged give the sketch of the whole stream
+    count_min_sketch<uint64_t> a(2719, 5), b(2719, 5);
+    for (size_t i = 0; i < stream.size(); i++) {
+        (i % 2 ? a : b).add(stream[i]);
+    }
+    a.merge(b);
+    REQUIRE(a.total() == cms.total());
+    for (uint64_t key = 0; key < 5000; key++) {
+        REQUIRE(a.estimate(key) == cms.estimate(key));
+    }
+    count_min_sketch<uint64_t> narrow(100, 5);
+    REQUIRE_THROWS_AS(a.merge(narrow), std::invalid_argument);
+    REQUIRE_THROWS_AS(count_min_sketch<int>(0, 3), std::invalid_argument);
+    REQUIRE_THROWS_AS(count_min_sketch<int>::with_error(0, 0.1), std::invalid_argument);
+    REQUIRE(a.memory_usage().node_overhead == 2719 * 5 * sizeof(uint32_t));
+    a.clear();
+    REQUIRE(a.total() == 0);
+    REQUIRE(a.estimate(0) == 0);
+
+    count_min_sketch<std::string> words(64, 3);
+    words.add("apple", 3);
+    REQUIRE(words.estimate("apple") >= 3);
+}
+
+TEST_CASE("testing count_sketch") {
+    std::vector<uint64_t> stream = zipf_stream(200000, 5000, 5);
+    std::unordered_map<uint64_t, int32_t> exact;
+    auto cs = count_sketch<uint64_t>::with_error(0.01, 0.01);
+    REQUIRE(cs.depth() % 2 == 1);
+    for (uint64_t x : stream) {
+        cs.add(x);
+        exact[x]++;
+    }
+    // the heaviest keys are estimated within a few percent
+    for (uint64_t key = 0; key < 10; key++) {
+        REQUIRE(std::abs(cs.estimate(key) - exact[key]) <= exact[key] / 20);
+    }
+    count_sketch<uint64_t> a(cs.width(), cs.depth()), b(cs.width(), cs.depth());
+    for (size_t i = 0; i < stream.size(); i++) {
+        (i % 3 ? a : b).add(stream[i]);
+    }
+    a.merge(b);
+    for (uint64_t key = 0; key < 100; key++) {
+        REQUIRE(a.estimate(key) == cs.estimate(key));
+    }
+    // counts can be taken back
+    a.add(0, -exact[0]);
+    REQUIRE(std::abs(a.estimate(0)) <= exact[0] / 20);
+}
@@ -0,0 +1,61 @@
+#include "../../src/classes/sketch/hyperloglog.h"
+#include "../../third_party/catch.hpp"
+#include <string>
+
+TEST_CASE("testing hyperloglog at every cardinality") {
+    hyperloglog<uint64_t> h;
+    REQUIRE(h.estimate() == 0);
+    REQUIRE(h.sparse());
+    uint64_t added = 0;
+    for (uint64_t n : {10, 100, 1000, 5000, 20000, 100000, 1000000}) {
+        for (; added < n; added++) {
+            h.add(added);
+            h.add(added / 2); // duplicates do not count
+        }
+        const double e = h.estimate();
+        // four standard errors once the registers are used, the sparse list is nearly exact
+        REQUIRE(std::abs(e - double(n)) <= 4 * h.relative_error() * double(n) + 1);
+        if (n <= 1000) {
+            REQUIRE(h.sparse());
+        }
+    }
+    REQUIRE(!h.sparse());
+    REQUIRE(h.memory_usage().node_overhead == 16384);
+    h.clear();
+    REQUIRE(h.sparse());
+    REQUIRE(h.estimate() == 0);
+    REQUIRE_THROWS_AS(hyperloglog<int>(3), std::invalid_argument);
+}
+
+TEST_CASE("testing hyperloglog merges") {
+    for (uint64_t n : {300, 3000, 300000}) {
+        hyperloglog<uint64_t> whole(12), a(12), b(12);
+        for (uint64_t i = 0; i < n; i++) {
+            whole.add(i);
+            // the halves overlap on a third of the keys
+            if (i < 2 * n / 3) {
+                a.add(i);
+            }
+            if (i >= n / 3) {
+                b.add(i);
+            }
+        }
+        hyperloglog<uint64_t> sparse_first = a;
+        a.merge(b);
+        b.merge(sparse_first);
+        REQUIRE(a.estimate() == Approx(whole.estimate()));
+        REQUIRE(b.estimate() == Approx(whole.estimate()));
+        REQUIRE(std::abs(a.estimate() - double(n)) <= 4 * a.relative_error() * double(n) + 1);
+    }
+    hyperloglog<uint64_t> other(10), dense(12);
+    for (uint64_t i = 0; i < 100000; i++) {
+        dense.add(i);
+    }
+    REQUIRE_THROWS_AS(dense.merge(other), std::invalid_argument);
+
+    hyperloglog<std::string> words;
+    words.add("apple");
+    words.add("apple");
+    words.add("fig");
+    REQUIRE(words.estimate() == Approx(2).epsilon(0.01));
+}
@@ -0,0 +1,83 @@
+#include "../../src/classes/sketch/space_saving.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("testing space_saving heavy hitters") {
+    std::mt19937_64 rng(9);
+    std::vector<double> weights(10000);
+    for (size_t i = 0; i < weights.size(); i++) {
+        weights[i] = 1.0 / double(i + 1);
+    }
+    std::discrete_distribution<uint64_t> pick(weights.begin(), weights.end());
+    std::unordered_map<uint64_t, uint64_t> exact;
+    space_saving<uint64_t> s(100), a(100), b(100);
+    for (size_t i = 0; i < 200000; i++) {
+        const uint64_t x = pick(rng);
+        exact[x]++;
+        s.add(x);
+        (i % 2 ? a : b).add(x);
+    }
+    REQUIRE(s.total() == 200000);
+    REQUIRE(s.size() == 100);
+    for (const auto& e : s.top()) {
+        REQUIRE(e.count >= exact[e.key]);
+        REQUIRE(e.count - e.error <= exact[e.key]);
+        REQUIRE(e.error <= s.total() / s.capacity());
+    }
+    std::vector<space_saving<uint64_t>::entry> top = s.top(5);
+    REQUIRE(top.size() == 5);
+    for (uint64_t key = 0; key < 5; key++) {
+        REQUIRE(top[key].key == key);
+    }
+    // no key above 1% of the stream is missed
+    std::vector<space_saving<uint64_t>::entry> heavy = s.heavy_hitters(0.01);
+    for (auto [key, count] : exact) {
+        if (count > 2000) {
+            REQUIRE(std::any_of(heavy.begin(), heavy.end(),
+                                [&](const auto& e) { return e.key == key; }));
+        }
+    }
+    REQUIRE(s.estimate(9999) <= s.total() / s.capacity());
+    REQUIRE_THROWS_AS(s.heavy_hitters(0), std::invalid_argument);
+
+    a.merge(b);
+    REQUIRE(a.total() == 200000);
+    REQUIRE(a.size() == 100);
+    for (const auto& e : a.top()) {
+        REQUIRE(e.count >= exact[e.key]);
+        REQUIRE(e.count - e.error <= exact[e.key]);
+    }
+    for (auto [key, count] : exact) {
+        if (count > 2 * a.total() / a.capacity()) {
+            REQUIRE(a.estimate(key) >= count);
+        }
+    }
+    std::vector<space_saving<uint64_t>::entry> merged = a.top(3);
+    for (uint64_t key = 0; key < 3; key++) {
+        REQUIRE(merged[key].key == key);
+    }
+}
+
+TEST_CASE("testing space_saving with weights and few keys") {
+    space_saving<std::string> s(3);
+    s.add("apple", 5);
+    s.add("fig", 2);
+    s.add("kiwi");
+    REQUIRE(s.estimate("apple") == 5);
+    REQUIRE(s.estimate("lime") == 1);
+    s.add("lime", 10);
+    REQUIRE(s.size() == 3);
+    REQUIRE(s.estimate("kiwi") == 2);
+    std::vector<space_saving<std::string>::entry> top = s.top();
+    REQUIRE(top[0].key == "lime");
+    REQUIRE(top[0].count == 11);
+    REQUIRE(top[0].error == 1);
+    REQUIRE(top[1].key == "apple");
+    s.clear();
+    REQUIRE(s.size() == 0);
+    REQUIRE(s.estimate("apple") == 0);
+    REQUIRE_THROWS_AS(space_saving<int>(0), std::invalid_argument);
+}
@@ -0,0 +1,46 @@
+#include "../../src/classes/spatial/grid_index.h"
+#include "../../third_party/catch.hpp"
+
+#include <random>
+
+TEST_CASE("Testing grid index") {
+    REQUIRE_THROWS_AS(grid_index<2>({}, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(grid_index<2>({}, -1), std::invalid_argument);
+
+    std::vector<std::array<double, 2>> points = {{0, 0}, {1, 0}, {0, 1}, {5, 5}, {-1, -1}};
+    grid_index<2> g(points, 1.5);
+    REQUIRE(g.size() == 5);
+    REQUIRE(g.cell() == 1.5);
+    REQUIRE(g.cube_of({-0.1, 1.6}) == std::array<int64_t, 2>{-1, 1});
+    REQUIRE(g.radius({0, 0}, 1) == std::vector<size_t>{0, 1, 2});
+    REQUIRE(g.radius({0, 0}, 1.5) == std::vector<size_t>{0, 1, 2, 4});
+    REQUIRE(g.radius({5, 5}, 0) == std::vector<size_t>{3});
+    REQUIRE(g.radius({5, 5}, 10) == std::vector<size_t>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("Testing grid index against a linear scan") {
+    std::mt19937_64 rng(100);
+    std::uniform_real_distribution<double> u(-50, 50);
+    std::vector<std::array<double, 3>> points(4000);
+    for (auto& p : points) {
+        p = {u(rng), u(rng), u(rng) / 10};
+    }
+    for (double cell : {0.5, 3.0, 20.0}) {
+        grid_index<3> g(points, cell);
+        for (int i = 0; i < 50; i++) {
+            std::array<double, 3> q = {u(rng), u(rng), u(rng)};
+            double r = cell * (rng() % 3 + 1) / 2;
+            std::vector<size_t> check;
+            for (size_t j = 0; j < points.size(); j++) {
+                double d = 0;
+                for (size_t k = 0; k < 3; k++) {
+                    d += (points[j][k] - q[k]) * (points[j][k] - q[k]);
+                }
+                if (d <= r * r) {
+                    check.push_back(j);
+                }
+            }
+            REQUIRE(g.radius(q, r) == check);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include "../../src/classes/spatial/kd_tree.h"
+#include "../../third_party/catch.hpp"
+
+#include <random>
+
+namespace {
+template <size_t D>
+std::vector<size_t> brute_knn(const std::vector<std::array<double, D>>& points,
+                              const std::array<double, D>& q, size_t k) {
+    std::vector<std::pair<double, size_t>> all;
+    for (size_t i = 0; i < points.size(); i++) {
+        all.push_back({kd_tree<D>::distance2(points[i], q), i});
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<size_t> out;
+    for (size_t i = 0; i < std::min(k, all.size()); i++) {
+        out.push_back(all[i].second);
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("Testing kd tree on small inputs") {
+    kd_tree<2> empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty.nearest({0, 0}, 3).empty());
+    REQUIRE(empty.radius({0, 0}, 1).empty());
+    REQUIRE_THROWS_AS(empty.nearest({0, 0}), std::out_of_range);
+
+    std::vector<std::array<double, 2>> points = {{0, 0}, {1, 0}, {0, 1}, {5, 5}, {1, 0}};
+    kd_tree<2> t(points);
+    REQUIRE(t.size() == 5);
+    REQUIRE(t.nearest({0.9, 0.1}) == 1);
+    REQUIRE(t.nearest({4, 4}) == 3);
+    REQUIRE(t.nearest({0, 0}, 3) == std::vector<size_t>{0, 1, 2});
+    REQUIRE(t.nearest({0, 0}, 10).size() == 5);
+    REQUIRE(t.radius({0, 0}, 1) == std::vector<size_t>{0, 1, 2, 4});
+    REQUIRE(t.radius({0, 0}, 0.5) == std::vector<size_t>{0});
+    REQUIRE(t.radius({0, 0}, -1).empty());
+}
+
+TEST_CASE("Testing kd tree against a linear scan") {
+    std::mt19937_64 rng(100);
+    std::uniform_real_distribution<double> u(-100, 100);
+    for (size_t n : {1, 17, 100, 5000}) {
+        std::vector<std::array<double, 3>> points(n);
+        for (auto& p : points) {
+            // a few duplicates and a flat dimension
+            p = {u(rng), std::round(u(rng) / 10), 0};
+        }
+        points.push_back(points[0]);
+        kd_tree<3> t(points);
+        for (int i = 0; i < 50; i++) {
+            std::array<double, 3> q = {u(rng), u(rng) / 10, u(rng) / 100};
+            size_t k = rng() % 20 + 1;
+            REQUIRE(t.nearest(q, k) == brute_knn(points, q, k));
+            double r = std::abs(u(rng)) / 4;
+            std::vector<size_t> check;
+            for (size_t j = 0; j < points.size(); j++) {
+                if (kd_tree<3>::distance2(points[j], q) <= r * r) {
+                    check.push_back(j);
+                }
+            }
+            REQUIRE(t.radius(q, r) == check);
+        }
+    }
+}
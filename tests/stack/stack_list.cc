@@ -88,4 +88,53 @@ TEST_CASE("testing operator = for stack list class") {
     }
 
     REQUIRE(v1 == v2);
-}
\ No newline at end of file
+}
+TEST_CASE("testing growth past the inline buffer in stack") {
+    stack_list<std::string, 2> s;
+    REQUIRE(s.capacity() == 2);
+    for (int i = 0; i < 100; i++) {
+        s.push(std::to_string(i) + std::string(30, 'x'));
+    }
+    REQUIRE(s.size() == 100);
+    REQUIRE(s.capacity() >= 100);
+    // emplace from a value of the stack while it grows
+    while (s.size() < s.capacity()) {
+        s.push("y");
+    }
+    s.emplace(s.top());
+    REQUIRE(s.top() == "y");
+    while (s.size() > 1) {
+        s.pop();
+    }
+    REQUIRE(s.top() == "0" + std::string(30, 'x'));
+
+    stack_list<std::string, 2> moved(std::move(s));
+    REQUIRE(s.empty() == true);
+    REQUIRE(moved.size() == 1);
+    s = std::move(moved);
+    REQUIRE(s.top() == "0" + std::string(30, 'x'));
+    s.clear();
+    REQUIRE(s.empty() == true);
+}
+
+TEST_CASE("testing emplace and reserve in stack") {
+    stack_list<std::pair<int, int>> s;
+    s.reserve(1000);
+    REQUIRE(s.capacity() == 1000);
+    for (int i = 0; i < 1000; i++) {
+        s.emplace(i, -i).second--;
+    }
+    REQUIRE(s.top() == std::pair<int, int>(999, -1000));
+
+    stack_list<std::pair<int, int>> copy(s);
+    REQUIRE(copy.size() == 1000);
+    REQUIRE(std::equal(copy.begin(), copy.end(), s.begin()));
+
+    // small stacks stay inline, and moving them moves the values
+    stack_list<int> a;
+    a.push(1);
+    a.push(2);
+    stack_list<int> b(std::move(a));
+    REQUIRE(b.top() == 2);
+    REQUIRE(a.empty() == true);
+}
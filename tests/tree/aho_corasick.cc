@@ -0,0 +1,87 @@
+#include "../../src/classes/tree/aho_corasick.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+// every occurrence of every pattern, by end position then longest first
+std::vector<aho_corasick_match> naive_matches(const std::vector<std::string>& patterns,
+                                              const std::string& text) {
+    std::vector<aho_corasick_match> v;
+    for (size_t id = 0; id < patterns.size(); id++) {
+        const std::string& p = patterns[id];
+        for (size_t i = 0; i + p.size() <= text.size(); i++) {
+            if (text.compare(i, p.size(), p) == 0) {
+                v.push_back({id, i});
+            }
+        }
+    }
+    std::sort(v.begin(), v.end(), [&](const auto& a, const auto& b) {
+        size_t ea = a.position + patterns[a.pattern].size();
+        size_t eb = b.position + patterns[b.pattern].size();
+        return ea != eb ? ea < eb : a.position != b.position ? a.position < b.position
+                                                             : a.pattern < b.pattern;
+    });
+    return v;
+}
+
+std::string random_text(size_t n, size_t alphabet, std::mt19937& rng) {
+    std::string s(n, 'a');
+    for (char& c : s) {
+        c = char('a' + rng() % alphabet);
+    }
+    return s;
+}
+} // namespace
+
+TEST_CASE("testing aho corasick on the classic example") {
+    std::vector<std::string> patterns = {"he", "she", "his", "hers"};
+    aho_corasick ac(patterns);
+    REQUIRE(ac.size() == 4);
+    std::vector<aho_corasick_match> want = {{1, 1}, {0, 2}, {3, 2}};
+    REQUIRE(ac.find_all("ushers") == want);
+    REQUIRE(ac.contains_any("ahisa"));
+    REQUIRE(!ac.contains_any("hhhsss"));
+    REQUIRE(aho_corasick().find_all("abc").empty());
+    REQUIRE_THROWS_AS(aho_corasick({"a", ""}), std::invalid_argument);
+}
+
+TEST_CASE("testing aho corasick against a naive search") {
+    std::mt19937 rng(80);
+    for (size_t alphabet : {2, 4, 26}) {
+        std::vector<std::string> patterns;
+        for (size_t i = 0; i < 300; i++) {
+            patterns.push_back(random_text(1 + rng() % 6, alphabet, rng));
+        }
+        // duplicates are reported under each id
+        patterns.push_back(patterns[0]);
+        patterns.push_back(std::string("\xff\x00\x80", 3));
+        aho_corasick ac(patterns);
+        std::string text = random_text(3000, alphabet, rng) + std::string("\xff\x00\x80", 3);
+        REQUIRE(ac.find_all(text) == naive_matches(patterns, text));
+    }
+}
+
+TEST_CASE("testing aho corasick stream") {
+    std::mt19937 rng(81);
+    std::vector<std::string> patterns = {"abab", "ba", "bbbbbbbb", "aab", "b"};
+    aho_corasick ac(patterns);
+    std::string text = random_text(20000, 2, rng);
+    aho_corasick_stream s(ac);
+    std::vector<aho_corasick_match> found;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t len = std::min<size_t>(rng() % 12, text.size() - pos);
+        for (const aho_corasick_match& m : s.feed(std::string_view(text).substr(pos, len))) {
+            found.push_back(m);
+        }
+        pos += len;
+    }
+    REQUIRE(s.offset() == text.size());
+    REQUIRE(found == ac.find_all(text));
+    s.reset();
+    std::vector<aho_corasick_match> want = {{3, 0}, {4, 2}};
+    REQUIRE(s.feed("aab") == want);
+}
@@ -1,5 +1,7 @@
 #include "../../third_party/catch.hpp"
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <string>
 
 #define ENABLE_TREE_VISUALIZATION
@@ -188,3 +190,176 @@ TEST_CASE("Testing avl tree visualization") {
     avl_tree<char> a({'g', 'w', 'h', 'p', 'u'});
     CHECK_NOTHROW(a.visualize());
 }
+
+TEST_CASE("testing from_sorted in avl tree") {
+    std::vector<int> v;
+    for (int i = 0; i < 1000; i++) {
+        v.push_back(i / 2);
+    }
+    avl_tree<int> t = avl_tree<int>::from_sorted(v);
+    REQUIRE(t.size() == 500);
+    REQUIRE(t.level_order().size() == 9);
+    std::vector<int> expected;
+    for (int i = 0; i < 500; i++) {
+        expected.push_back(i);
+    }
+    REQUIRE(t.inorder() == expected);
+    t.insert(1000);
+    t.remove(0);
+    REQUIRE(t.size() == 500);
+    REQUIRE(avl_tree<int>::from_sorted({}).size() == 0);
+    REQUIRE_THROWS_AS(avl_tree<int>::from_sorted({2, 1}), std::invalid_argument);
+}
+
+TEST_CASE("testing split and join in avl tree") {
+    avl_tree<int> t;
+    for (int i = 0; i < 1000; i++) {
+        t.insert(i);
+    }
+    avl_tree<int> right = t.split(600);
+    REQUIRE(t.size() == 600);
+    REQUIRE(right.size() == 400);
+    REQUIRE(t.inorder().back() == 599);
+    REQUIRE(right.inorder().front() == 600);
+    // both halves stay balanced: height <= 1.44 log2(n)
+    REQUIRE(t.level_order().size() <= 14);
+    REQUIRE(right.level_order().size() <= 13);
+
+    avl_tree<int> empty = right.split(5000);
+    REQUIRE(empty.size() == 0);
+    REQUIRE(right.size() == 400);
+
+    right.insert(1500);
+    t.remove(0);
+    REQUIRE_THROWS_AS(right.join(t), std::invalid_argument);
+    t.join(right);
+    REQUIRE(right.size() == 0);
+    REQUIRE(t.size() == 1000);
+    std::vector<int> in = t.inorder();
+    REQUIRE(std::is_sorted(in.begin(), in.end()));
+    REQUIRE(in.front() == 1);
+    REQUIRE(in.back() == 1500);
+
+    // joining trees with their own pools splices the pools
+    avl_tree<int> a = avl_tree<int>::from_sorted({1, 2, 3});
+    avl_tree<int> b = avl_tree<int>::from_sorted({10, 20, 30, 40, 50, 60, 70});
+    a.join(b);
+    REQUIRE(a.inorder() == std::vector<int>{1, 2, 3, 10, 20, 30, 40, 50, 60, 70});
+    REQUIRE(a.level_order().size() <= 4);
+    b.insert(5);
+    REQUIRE(b.inorder() == std::vector<int>{5});
+}
+
+TEST_CASE("testing merge in avl tree") {
+    avl_tree<int> evens, odds;
+    for (int i = 0; i < 300; i++) {
+        evens.insert(2 * i);
+        odds.insert(2 * i + 1);
+    }
+    avl_tree<int> tail = odds.split(301);
+    evens.merge(odds);
+    REQUIRE(odds.size() == 0);
+    REQUIRE(evens.size() == 450);
+    // tail still shares a pool with odds, its nodes are copied
+    evens.merge(tail);
+    REQUIRE(evens.size() == 600);
+    REQUIRE(tail.size() == 0);
+    std::vector<int> in = evens.inorder();
+    for (int i = 0; i < 600; i++) {
+        REQUIRE(in[i] == i);
+    }
+    REQUIRE(evens.level_order().size() <= 13);
+
+    avl_tree<int> dup({5, 7, 9});
+    avl_tree<int> other({7, 8});
+    dup.merge(other);
+    REQUIRE(dup.inorder() == std::vector<int>{5, 7, 8, 9});
+    dup.merge(dup);
+    REQUIRE(dup.size() == 4);
+}
+
+TEST_CASE("testing lazy iterators in avl tree") {
+    avl_tree<int> t = avl_tree<int>::from_sorted([] {
+        std::vector<int> v(100000);
+        std::iota(v.begin(), v.end(), 0);
+        return v;
+    }());
+    std::vector<int> first;
+    for (const int& x : t) {
+        if (first.size() == 10) {
+            break;
+        }
+        first.push_back(x);
+    }
+    REQUIRE(first == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    REQUIRE(std::distance(t.begin(), t.end()) == 100000);
+    REQUIRE(*std::prev(t.end()) == 99999);
+    REQUIRE(std::find(t.begin(), t.end(), 4242) != t.end());
+
+    auto it = t.begin();
+    --it;
+    REQUIRE(it == t.begin());
+    it = t.end();
+    ++it;
+    REQUIRE(it == t.end());
+
+    const avl_tree<int>& c = t;
+    int64_t sum = 0, back = 0;
+    for (auto rit = c.end(); rit != c.begin();) {
+        back += *--rit;
+    }
+    for (int x : c) {
+        sum += x;
+    }
+    REQUIRE(sum == back);
+
+    avl_tree<int> empty;
+    REQUIRE(empty.begin() == empty.end());
+}
+
+TEST_CASE("testing order statistics in avl_tree") {
+    avl_tree<int> t;
+    std::vector<int> ref;
+    uint32_t state = 12345;
+    auto rnd = [&]() {
+        state = state * 1103515245u + 12345u;
+        return int((state >> 8) % 400);
+    };
+    for (int step = 0; step < 3000; step++) {
+        int x = rnd();
+        auto pos = std::lower_bound(ref.begin(), ref.end(), x);
+        if (step % 3 == 2) {
+            if (pos != ref.end() && *pos == x) {
+                ref.erase(pos);
+            }
+            t.remove(x);
+        } else if (pos == ref.end() || *pos != x) {
+            ref.insert(pos, x);
+            t.insert(x);
+        }
+        if (step % 100 == 0) {
+            REQUIRE(t.size() == ref.size());
+            for (size_t k = 0; k < ref.size(); k++) {
+                REQUIRE(t.select(k) == ref[k]);
+            }
+        }
+        int lo = rnd(), hi = lo + rnd() / 4;
+        size_t below = std::lower_bound(ref.begin(), ref.end(), lo) - ref.begin();
+        size_t upto = std::upper_bound(ref.begin(), ref.end(), hi) - ref.begin();
+        REQUIRE(t.rank(lo) == below);
+        REQUIRE(t.range_count(lo, hi) == upto - below);
+        std::vector<int> visited;
+        t.range(lo, hi, [&](const int& v) { visited.push_back(v); });
+        REQUIRE(visited == std::vector<int>(ref.begin() + below, ref.begin() + upto));
+        auto lb = t.lower_bound(lo);
+        REQUIRE((lb == t.end()) == (below == ref.size()));
+        if (lb != t.end()) {
+            REQUIRE(*lb == ref[below]);
+        }
+        size_t above = std::upper_bound(ref.begin(), ref.end(), lo) - ref.begin();
+        auto ub = t.upper_bound(lo);
+        REQUIRE(static_cast<size_t>(std::distance(t.begin(), ub)) == above);
+    }
+    REQUIRE(t.range_count(10, 5) == 0);
+    REQUIRE_THROWS_AS(t.select(t.size()), std::out_of_range);
+}
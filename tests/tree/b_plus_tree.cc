@@ -0,0 +1,161 @@
+#include "../../src/classes/tree/b_plus_tree.h"
+#include "../../third_party/catch.hpp"
+#include <map>
+#include <random>
+#include <string>
+
+TEST_CASE("testing insert, search and remove in b plus tree") {
+    b_plus_tree<int, int> t;
+    REQUIRE(t.empty());
+    REQUIRE(t.find(3) == nullptr);
+    REQUIRE(t.insert(3, 30));
+    REQUIRE(t.insert(1, 10));
+    REQUIRE(!t.insert(3, 33));
+    REQUIRE(t.size() == 2);
+    REQUIRE(*t.find(3) == 33);
+    REQUIRE(t.retrieve(1) == 10);
+    REQUIRE(t.retrieve(2) == std::nullopt);
+    REQUIRE(t.search(1));
+    REQUIRE(t.remove(1));
+    REQUIRE(!t.remove(1));
+    REQUIRE(!t.search(1));
+    REQUIRE(t.remove(3));
+    REQUIRE(t.empty());
+    REQUIRE(t.height() == 0);
+    REQUIRE(t.begin() == t.end());
+}
+
+TEST_CASE("testing b plus tree against std::map") {
+    // small nodes, so the tree gets several levels
+    b_plus_tree<int64_t, int64_t, 96> t;
+    std::map<int64_t, int64_t> m;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int64_t> key(-5000, 5000);
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 6000; i++) {
+            int64_t k = key(rng);
+            REQUIRE(t.insert(k, k * 3) == m.insert_or_assign(k, k * 3).second);
+        }
+        REQUIRE(t.height() >= 3);
+        for (int i = 0; i < 5000; i++) {
+            int64_t k = key(rng);
+            REQUIRE(t.remove(k) == (m.erase(k) == 1));
+        }
+        REQUIRE(t.size() == m.size());
+        auto mit = m.begin();
+        for (auto it = t.begin(); it != t.end(); ++it, ++mit) {
+            REQUIRE((*it).first == mit->first);
+            REQUIRE((*it).second == mit->second);
+        }
+        REQUIRE(mit == m.end());
+        for (int i = 0; i < 500; i++) {
+            int64_t k = key(rng);
+            auto lb = t.lower_bound(k);
+            auto mlb = m.lower_bound(k);
+            REQUIRE((lb == t.end()) == (mlb == m.end()));
+            if (mlb != m.end()) {
+                REQUIRE((*lb).first == mlb->first);
+            }
+            auto ub = t.upper_bound(k);
+            auto mub = m.upper_bound(k);
+            REQUIRE((ub == t.end()) == (mub == m.end()));
+            if (mub != m.end()) {
+                REQUIRE((*ub).first == mub->first);
+            }
+            REQUIRE((t.find(k) != nullptr) == m.count(k));
+        }
+    }
+    for (auto& [k, v] : m) {
+        REQUIRE(t.remove(k));
+    }
+    REQUIRE(t.empty());
+    REQUIRE(t.height() == 0);
+}
+
+TEST_CASE("testing bulk load and range in b plus tree") {
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < 10000; i++) {
+        v.push_back({2 * i, i});
+    }
+    b_plus_tree<int, int, 128> t(v);
+    REQUIRE(t.size() == 10000);
+    for (int i = 0; i < 10000; i++) {
+        REQUIRE(t.retrieve(2 * i) == i);
+        REQUIRE(!t.search(2 * i + 1));
+    }
+    std::vector<int> seen;
+    size_t n = t.range(11, 31, [&](int k, int value) {
+        REQUIRE(k == 2 * value);
+        seen.push_back(k);
+    });
+    REQUIRE(n == 10);
+    REQUIRE(seen == std::vector<int>{12, 14, 16, 18, 20, 22, 24, 26, 28, 30});
+    REQUIRE(t.range(5, 5, [](int, int) {}) == 0);
+
+    // inserts into a half full tree do not split
+    b_plus_tree<int, int, 128> half;
+    half.bulk_load(v, 0.5);
+    size_t height = half.height();
+    REQUIRE(height >= t.height());
+    for (int i = 0; i < 100; i++) {
+        half.insert(2 * i + 1, -i);
+    }
+    REQUIRE(half.height() == height);
+    REQUIRE(half.size() == 10100);
+
+    REQUIRE_THROWS_AS(t.bulk_load({{2, 0}, {1, 0}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.bulk_load({{1, 0}, {1, 0}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.bulk_load(v, 0.0), std::invalid_argument);
+    REQUIRE(t.size() == 10000);
+
+    // unsorted input goes through insert
+    b_plus_tree<int, int> u({{3, 1}, {1, 2}, {2, 3}, {1, 4}});
+    REQUIRE(u.size() == 3);
+    REQUIRE(u.retrieve(1) == 4);
+}
+
+TEST_CASE("testing ascending inserts fill the leaves of b plus tree") {
+    b_plus_tree<int32_t, int32_t, 128> t;
+    for (int i = 0; i < 20000; i++) {
+        t.insert(i, i);
+    }
+    b_plus_tree<int32_t, int32_t, 128> loaded;
+    std::vector<std::pair<int32_t, int32_t>> v;
+    for (int i = 0; i < 20000; i++) {
+        v.push_back({i, i});
+    }
+    loaded.bulk_load(v);
+    REQUIRE(t.height() <= loaded.height() + 1);
+    int expected = 0;
+    for (auto it = t.begin(); it != t.end(); it++) {
+        REQUIRE((*it).first == expected++);
+    }
+    REQUIRE(expected == 20000);
+}
+
+TEST_CASE("testing string keys, copy and move in b plus tree") {
+    b_plus_tree<std::string, std::string, 256> t;
+    for (int i = 0; i < 2000; i++) {
+        t.insert("key" + std::to_string(i), std::to_string(i));
+    }
+    b_plus_tree<std::string, std::string, 256> copy(t);
+    for (int i = 0; i < 2000; i += 2) {
+        REQUIRE(t.remove("key" + std::to_string(i)));
+    }
+    REQUIRE(t.size() == 1000);
+    REQUIRE(copy.size() == 2000);
+    REQUIRE(*copy.find("key10") == "10");
+    REQUIRE(t.find("key10") == nullptr);
+    // "key100" and "key1000" were removed
+    REQUIRE((*t.lower_bound("key10")).first == "key1001");
+    REQUIRE((*t.lower_bound("key10")).second == "1001");
+
+    b_plus_tree<std::string, std::string, 256> moved(std::move(copy));
+    REQUIRE(copy.empty());
+    REQUIRE(moved.size() == 2000);
+    copy = moved;
+    moved = std::move(t);
+    REQUIRE(moved.size() == 1000);
+    REQUIRE(copy.size() == 2000);
+    REQUIRE(*moved.find("key11") == "11");
+}
@@ -196,3 +196,34 @@ TEST_CASE("Testing binary search tree visualization") {
 }
 
 #endif
+
+TEST_CASE("checking from_sorted in bst") {
+    std::vector<int> v = {1, 2, 2, 3, 5, 8, 13};
+    bst<int> b = bst<int>::from_sorted(v);
+    REQUIRE(b.size() == 7);
+    REQUIRE(b.inorder() == v);
+    REQUIRE(b.level_order().size() == 3);
+    REQUIRE(b.search(2));
+    b.remove(2);
+    REQUIRE(b.search(2));
+    b.remove(2);
+    REQUIRE(!b.search(2));
+    REQUIRE_THROWS_AS(bst<int>::from_sorted({3, 1}), std::invalid_argument);
+}
+
+TEST_CASE("checking iterators over a degenerate bst") {
+    // sorted inserts give a path of 300 nodes, deeper than the inline part of the iterator
+    bst<int> b;
+    for (int i = 0; i < 300; i++) {
+        b.insert(i);
+    }
+    int expected = 0;
+    for (auto it = b.begin(); it != b.end(); ++it) {
+        REQUIRE(*it == expected++);
+    }
+    REQUIRE(expected == 300);
+    for (auto it = b.end(); it != b.begin();) {
+        REQUIRE(*--it == --expected);
+    }
+    REQUIRE(expected == 0);
+}
@@ -0,0 +1,100 @@
+#include "../../src/classes/tree/concurrent_red_black_tree.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("testing insert and remove in concurrent red black tree") {
+    concurrent_red_black_tree<int> t;
+    std::set<int> ref;
+    uint32_t state = 7;
+    for (int step = 0; step < 20000; step++) {
+        state = state * 1103515245u + 12345u;
+        int x = int((state >> 8) % 2000);
+        if (step % 5 < 3) {
+            REQUIRE(t.insert(x) == ref.insert(x).second);
+        } else {
+            REQUIRE(t.remove(x) == (ref.erase(x) == 1));
+        }
+        if (step % 1000 == 0) {
+            auto s = t.read();
+            REQUIRE(s.size() == ref.size());
+            REQUIRE(s.inorder() == std::vector<int>(ref.begin(), ref.end()));
+            REQUIRE(s.height() <= 2 * std::log2(ref.size() + 1) + 1);
+            REQUIRE(s.rank(1000) == size_t(std::distance(ref.begin(), ref.lower_bound(1000))));
+        }
+    }
+    for (int x : std::vector<int>(ref.begin(), ref.end())) {
+        REQUIRE(t.search(x));
+        REQUIRE(t.remove(x));
+    }
+    REQUIRE(t.size() == 0);
+    REQUIRE(!t.remove(3));
+    // no snapshot is alive, so every replaced node was freed
+    REQUIRE(t.pending() == 0);
+}
+
+TEST_CASE("testing snapshots of concurrent red black tree") {
+    concurrent_red_black_tree<std::string> t({"b", "d", "f"});
+    auto before = t.read();
+    t.insert("a");
+    t.remove("d");
+    REQUIRE(t.pending() > 0);
+    REQUIRE(before.inorder() == std::vector<std::string>{"b", "d", "f"});
+    REQUIRE(before.search("d"));
+    REQUIRE(!before.search("a"));
+    REQUIRE(t.read().inorder() == std::vector<std::string>{"a", "b", "f"});
+
+    std::vector<std::string> visited;
+    t.read().range("b", "z", [&](const std::string& s) { visited.push_back(s); });
+    REQUIRE(visited == std::vector<std::string>{"b", "f"});
+
+    t.clear();
+    REQUIRE(t.size() == 0);
+    REQUIRE(before.size() == 3);
+    { auto moved = std::move(before); }
+    REQUIRE(t.pending() == 0);
+}
+
+TEST_CASE("testing concurrent readers and a writer in concurrent red black tree") {
+    concurrent_red_black_tree<int> t({}, 8);
+    const int n = 4000;
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; r++) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto s = t.read();
+                std::vector<int> in = s.inorder();
+                // the writer inserts the evens before it removes them, odd keys stay
+                if (in.size() != s.size() || !std::is_sorted(in.begin(), in.end()) ||
+                    std::adjacent_find(in.begin(), in.end()) != in.end()) {
+                    bad++;
+                }
+                for (int x : in) {
+                    if (!s.search(x)) {
+                        bad++;
+                    }
+                }
+            }
+        });
+    }
+    for (int i = 0; i < n; i++) {
+        t.insert(i);
+    }
+    for (int i = 0; i < n; i += 2) {
+        t.remove(i);
+    }
+    done = true;
+    for (std::thread& r : readers) {
+        r.join();
+    }
+    REQUIRE(bad == 0);
+    REQUIRE(t.size() == n / 2);
+    REQUIRE(t.pending() == 0);
+}
@@ -1,5 +1,9 @@
 #include "../../src/classes/tree/fenwick_tree.h"
 #include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
 
 TEST_CASE("Testing fenwick tree default constructor") {
     std::vector<int> v = {1, 4, 5, 6, 7};
@@ -34,3 +38,136 @@ TEST_CASE("Testing update query [1]") {
     f.update(0, -5);
     REQUIRE(f.sum(0, 2) == 3);
 }
+
+TEST_CASE("Testing fenwick tree linear build and wide updates") {
+    std::mt19937 rng(1);
+    std::vector<long long> v(1000);
+    for (auto& x : v) {
+        x = rng() % 1000;
+    }
+    fenwick_tree<long long> f(v);
+    long long prefix = 0;
+    for (int i = 0; i < int(v.size()); i++) {
+        prefix += v[i];
+        REQUIRE(f.sum(i) == prefix);
+    }
+    f.update(3, 10000000000LL);
+    REQUIRE(f.sum(3, 3) == v[3] + 10000000000LL);
+}
+
+TEST_CASE("Testing fenwick tree lower_bound") {
+    std::vector<int> v = {2, 0, 3, 1, 0, 4};
+    fenwick_tree<int> f(v);
+    REQUIRE(f.lower_bound(0) == 0);
+    REQUIRE(f.lower_bound(1) == 0);
+    REQUIRE(f.lower_bound(2) == 0);
+    REQUIRE(f.lower_bound(3) == 2);
+    REQUIRE(f.lower_bound(5) == 2);
+    REQUIRE(f.lower_bound(6) == 3);
+    REQUIRE(f.lower_bound(7) == 5);
+    REQUIRE(f.lower_bound(10) == 5);
+    REQUIRE(f.lower_bound(11) == 6);
+
+    std::mt19937 rng(2);
+    std::vector<int> w(777);
+    for (auto& x : w) {
+        x = rng() % 4;
+    }
+    fenwick_tree<int> g(w);
+    for (int target = 0; target <= g.sum(776) + 1; target++) {
+        int expected = 0, s = 0;
+        while (expected < 777 && s + w[expected] < target) {
+            s += w[expected++];
+        }
+        REQUIRE(g.lower_bound(target) == expected);
+    }
+}
+
+TEST_CASE("Testing range fenwick tree against a vector") {
+    std::mt19937 rng(3);
+    std::vector<long long> v(200);
+    for (auto& x : v) {
+        x = rng() % 100;
+    }
+    range_fenwick_tree<long long> f(v);
+    for (int i = 0; i < 2000; i++) {
+        int a = rng() % 200, b = rng() % 200;
+        if (a > b) {
+            std::swap(a, b);
+        }
+        if (i % 2) {
+            long long x = (long long)(rng() % 100) - 50;
+            f.update(a, b, x);
+            for (int j = a; j <= b; j++) {
+                v[j] += x;
+            }
+        } else {
+            REQUIRE(f.sum(a, b) == std::accumulate(v.begin() + a, v.begin() + b + 1, 0LL));
+            REQUIRE(f.get(a) == v[a]);
+        }
+    }
+}
+
+TEST_CASE("Testing 2D fenwick tree against a grid") {
+    std::mt19937 rng(4);
+    int rows = 23, cols = 17;
+    std::vector<std::vector<long long>> grid(rows, std::vector<long long>(cols));
+    for (auto& row : grid) {
+        for (auto& x : row) {
+            x = rng() % 10;
+        }
+    }
+    fenwick_tree_2d<long long> f(grid);
+    auto brute = [&](int r1, int c1, int r2, int c2) {
+        long long s = 0;
+        for (int r = r1; r <= r2; r++) {
+            for (int c = c1; c <= c2; c++) {
+                s += grid[r][c];
+            }
+        }
+        return s;
+    };
+    for (int i = 0; i < 1000; i++) {
+        int r1 = rng() % rows, r2 = rng() % rows, c1 = rng() % cols, c2 = rng() % cols;
+        if (r1 > r2) {
+            std::swap(r1, r2);
+        }
+        if (c1 > c2) {
+            std::swap(c1, c2);
+        }
+        if (i % 3 == 0) {
+            long long x = rng() % 10;
+            f.update(r1, c1, x);
+            grid[r1][c1] += x;
+        } else {
+            REQUIRE(f.sum(r1, c1, r2, c2) == brute(r1, c1, r2, c2));
+        }
+    }
+    fenwick_tree_2d<int> z(3, 4);
+    z.update(1, 2, 5);
+    REQUIRE(z.sum(2, 3) == 5);
+    REQUIRE(z.sum(0, 0, 1, 1) == 0);
+}
+
+TEST_CASE("Testing the compile time fenwick tree") {
+    static constexpr static_fenwick_tree<int, 5> f(std::array<int, 5>{1, 2, 3, 4, 5});
+    static_assert(f.sum(2) == 6 && f.sum(1, 3) == 9 && f.sum(-1) == 0);
+    static_assert(f.lower_bound(7) == 3 && f.lower_bound(16) == 5);
+
+    std::mt19937 rng(4);
+    std::array<long long, 100> v{};
+    for (long long& x : v) {
+        x = rng() % 50;
+    }
+    static_fenwick_tree<long long, 100> s(v);
+    fenwick_tree<long long> d(std::vector<long long>(v.begin(), v.end()));
+    for (int i = 0; i < 200; i++) {
+        int k = int(rng() % 100);
+        s.update(k, 3);
+        d.update(k, 3);
+        int a = int(rng() % 100), b = int(rng() % 100);
+        REQUIRE(s.sum(std::min(a, b), std::max(a, b)) == d.sum(std::min(a, b), std::max(a, b)));
+        long long target = rng() % (d.sum(99) + 2);
+        REQUIRE(s.lower_bound(target) == d.lower_bound(target));
+    }
+}
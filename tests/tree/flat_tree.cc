@@ -0,0 +1,71 @@
+#include "../../src/classes/tree/flat_tree.h"
+#include "../../src/classes/tree/tree.h"
+#include "../../third_party/catch.hpp"
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("testing flatten of tree class") {
+    tree<int> t;
+    t.insert("", 1);
+    t.insert("l", 2);
+    t.insert("r", 3);
+    t.insert("lr", 4);
+    t.insert("rr", 5);
+    t.insert("lrl", 6);
+    flat_tree<int> f = t.flatten();
+    REQUIRE(f.size() == 6);
+    REQUIRE(f.inorder() == t.inorder());
+    REQUIRE(f.level_order() == t.level_order());
+    uint32_t r = f.root();
+    REQUIRE(f.info(r) == 1);
+    REQUIRE(f.info(f.left(r)) == 2);
+    REQUIRE(f.left(f.left(r)) == flat_tree<int>::NONE);
+    REQUIRE(f.info(f.right(f.left(r))) == 4);
+    REQUIRE(f.info(f.right(r)) == 3);
+    // left, right, left down to 6, and right at 4 stops there as it has no right child
+    REQUIRE(f.info(f.descend([](int x) { return x == 2; })) == 6);
+    REQUIRE(f.info(f.descend([](int x) { return x % 2 == 0; })) == 4);
+    REQUIRE(f.info(f.descend([](int) { return true; })) == 5);
+
+    flat_tree<int> empty = tree<int>().flatten();
+    REQUIRE(empty.empty());
+    REQUIRE(empty.root() == flat_tree<int>::NONE);
+    REQUIRE(empty.descend([](int) { return true; }) == flat_tree<int>::NONE);
+    REQUIRE(empty.inorder().empty());
+    REQUIRE(empty.level_order().empty());
+}
+
+TEST_CASE("testing serialize and deserialize of flat tree") {
+    std::mt19937 rng(6);
+    tree<double> t;
+    t.insert("", 0.5);
+    std::vector<std::string> paths = {""};
+    for (int i = 0; i < 2000; i++) {
+        // grow the tree at the end of a random existing path
+        std::string p = paths[rng() % paths.size()] + (rng() % 2 ? 'l' : 'r');
+        t.insert(p, double(i));
+        paths.push_back(p);
+    }
+    flat_tree<double> f = t.flatten();
+    std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+    f.serialize(buffer);
+    flat_tree<double> g = flat_tree<double>::deserialize(buffer);
+    REQUIRE(g.size() == f.size());
+    REQUIRE(g.inorder() == t.inorder());
+    REQUIRE(g.level_order() == t.level_order());
+
+    std::string bytes;
+    {
+        std::stringstream out(std::ios::out | std::ios::binary);
+        f.serialize(out);
+        bytes = out.str();
+    }
+    std::stringstream cut(bytes.substr(0, bytes.size() - 1));
+    REQUIRE_THROWS_AS(flat_tree<double>::deserialize(cut), std::runtime_error);
+    std::stringstream other_type(bytes);
+    REQUIRE_THROWS_AS(flat_tree<int>::deserialize(other_type), std::runtime_error);
+    std::stringstream garbage("not a tree at all, not at all");
+    REQUIRE_THROWS_AS(flat_tree<double>::deserialize(garbage), std::runtime_error);
+}
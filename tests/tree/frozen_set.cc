@@ -0,0 +1,69 @@
+#include "../../src/classes/tree/frozen_set.h"
+#include "../../src/classes/tree/avl_tree.h"
+#include "../../src/classes/tree/bst.h"
+#include "../../src/classes/tree/red_black_tree.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+
+TEST_CASE("testing the lookups of frozen_set in both layouts") {
+    std::mt19937 rng(11);
+    for (frozen_layout layout : {frozen_layout::eytzinger, frozen_layout::van_emde_boas}) {
+        for (size_t n : {0, 1, 2, 3, 5, 7, 8, 15, 16, 100, 1023, 1025, 5000}) {
+            std::vector<int> v(n);
+            for (auto& x : v) {
+                x = int(rng() % (3 * n + 1));
+            }
+            std::sort(v.begin(), v.end());
+            frozen_set<int> s(v, layout);
+            REQUIRE(s.size() == n);
+            REQUIRE(s.layout() == layout);
+            REQUIRE(s.keys() == v);
+            std::vector<int> queries;
+            for (int x = -1; x <= int(3 * n + 2); x++) {
+                queries.push_back(x);
+            }
+            std::vector<const int*> batch = s.batch_lower_bound(queries, 7);
+            std::vector<bool> found = s.batch_contains(queries);
+            for (size_t q = 0; q < queries.size(); q++) {
+                const int x = queries[q];
+                auto it = std::lower_bound(v.begin(), v.end(), x);
+                const int* p = s.lower_bound(x);
+                REQUIRE((p == nullptr) == (it == v.end()));
+                if (p != nullptr) {
+                    REQUIRE(*p == *it);
+                }
+                REQUIRE(batch[q] == p);
+                REQUIRE(s.contains(x) == std::binary_search(v.begin(), v.end(), x));
+                REQUIRE(found[q] == s.contains(x));
+            }
+        }
+    }
+    std::vector<int> unsorted = {3, 1, 2};
+    REQUIRE_THROWS_AS(frozen_set<int>(unsorted), std::invalid_argument);
+}
+
+TEST_CASE("testing freeze on the ordered trees") {
+    std::vector<std::string> words = {"kiwi", "apple", "fig", "banana", "cherry", "lime", "date"};
+    bst<std::string> b;
+    avl_tree<std::string> a;
+    red_black_tree<std::string> r;
+    for (const auto& w : words) {
+        b.insert(w);
+        a.insert(w);
+        r.insert(w);
+    }
+    std::sort(words.begin(), words.end());
+    for (frozen_layout layout : {frozen_layout::eytzinger, frozen_layout::van_emde_boas}) {
+        for (const frozen_set<std::string>& s : {b.freeze(layout), a.freeze(layout),
+                                                 r.freeze(layout)}) {
+            REQUIRE(s.keys() == words);
+            REQUIRE(s.contains("fig"));
+            REQUIRE(!s.contains("grape"));
+            REQUIRE(*s.lower_bound("grape") == "kiwi");
+            REQUIRE(s.lower_bound("mango") == nullptr);
+            REQUIRE(s.memory_usage().payload >= words.size() * sizeof(std::string));
+        }
+    }
+}
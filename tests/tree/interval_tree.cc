@@ -1,6 +1,7 @@
 #define ENABLE_TREE_VISUALIZATION
 #include "../../src/classes/tree/interval_tree.h"
 #include "../../third_party/catch.hpp"
+#include <algorithm>
 #include <string>
 
 TEST_CASE("testing insertion in interval tree") {
@@ -100,3 +101,36 @@ TEST_CASE("Testing interval tree visualization") {
 }
 
 #endif
+
+TEST_CASE("testing query_overlapping in interval tree") {
+    std::vector<std::pair<int, int>> v;
+    uint32_t state = 99;
+    auto rnd = [&](int m) {
+        state = state * 1103515245u + 12345u;
+        return int((state >> 8) % m);
+    };
+    interval_tree<int> t;
+    for (int i = 0; i < 500; i++) {
+        int lo = rnd(1000);
+        v.push_back({lo, lo + rnd(50)});
+        t.insert(v.back());
+    }
+    for (int q = 0; q < 200; q++) {
+        int lo = rnd(1100), hi = lo + rnd(30);
+        std::vector<std::pair<int, int>> expected;
+        for (auto& x : v) {
+            if (x.second >= lo && x.first <= hi) {
+                expected.push_back(x);
+            }
+        }
+        std::vector<std::pair<int, int>> got = t.query_overlapping({hi, lo});
+        std::sort(expected.begin(), expected.end());
+        std::sort(got.begin(), got.end());
+        REQUIRE(got == expected);
+    }
+    interval_tree<int> small({{1, 3}, {5, 6}, {2, 4}, {9, 10}});
+    REQUIRE(small.query_overlapping(3) == std::vector<std::pair<int, int>>{{1, 3}, {2, 4}});
+    REQUIRE(small.query_overlapping(7).empty());
+    small.remove({2, 4});
+    REQUIRE(small.query_overlapping({4, 9}) == std::vector<std::pair<int, int>>{{5, 6}, {9, 10}});
+}
@@ -0,0 +1,125 @@
+#include "../../src/classes/tree/lazy_segment_tree.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+TEST_CASE("Testing lazy segment tree with range add and range max") {
+    lazy_segment_tree<range_add<max_monoid<int64_t>>> t(std::vector<int64_t>{3, 1, 4, 1, 5});
+    REQUIRE(t.size() == 5);
+    REQUIRE(t.query(0, 4) == 5);
+    REQUIRE(t.query(1, 3) == 4);
+    t.apply(0, 1, 10);
+    REQUIRE(t.query(0, 4) == 13);
+    REQUIRE(t.query(2, 4) == 5);
+    REQUIRE(t.get(1) == 11);
+    t.set(4, 20);
+    REQUIRE(t.all() == 20);
+    REQUIRE_THROWS_AS(t.query(3, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(t.query(3, 2), std::out_of_range);
+    REQUIRE_THROWS_AS(t.apply(0, 5, 1), std::out_of_range);
+}
+
+TEST_CASE("Testing lazy segment tree with range assign and range sum") {
+    lazy_segment_tree<range_assign<sum_monoid<int64_t>>> t(6);
+    REQUIRE(t.query(0, 5) == 0);
+    t.apply(1, 4, 2);
+    REQUIRE(t.query(0, 5) == 8);
+    t.apply(3, 5, 1);
+    REQUIRE(t.query(0, 5) == 7);
+    REQUIRE(t.query(2, 3) == 3);
+}
+
+template <typename Monoid, typename Ref> void check_against_vector(Ref combine) {
+    using policy = range_assign_add<Monoid>;
+    std::mt19937 rng(11);
+    for (size_t n : {1, 2, 7, 64, 100}) {
+        std::vector<int64_t> v(n);
+        for (auto& x : v) {
+            x = int64_t(rng() % 100) - 50;
+        }
+        lazy_segment_tree<policy> t(v);
+        for (int i = 0; i < 2000; i++) {
+            size_t l = rng() % n, r = rng() % n;
+            if (l > r) {
+                std::swap(l, r);
+            }
+            int64_t x = int64_t(rng() % 100) - 50;
+            switch (rng() % 4) {
+            case 0:
+                t.apply(l, r, policy::add(x));
+                for (size_t j = l; j <= r; j++) {
+                    v[j] += x;
+                }
+                break;
+            case 1:
+                t.apply(l, r, policy::assign(x));
+                std::fill(v.begin() + l, v.begin() + r + 1, x);
+                break;
+            case 2:
+                t.set(l, x);
+                v[l] = x;
+                break;
+            default: {
+                int64_t expected = v[l];
+                for (size_t j = l + 1; j <= r; j++) {
+                    expected = combine(expected, v[j]);
+                }
+                REQUIRE(t.query(l, r) == expected);
+                REQUIRE(t.get(r) == v[r]);
+            }
+            }
+        }
+        int64_t all = v[0];
+        for (size_t j = 1; j < n; j++) {
+            all = combine(all, v[j]);
+        }
+        REQUIRE(t.all() == all);
+    }
+}
+
+TEST_CASE("Testing lazy segment tree with range assign and add against a vector") {
+    check_against_vector<sum_monoid<int64_t>>([](int64_t a, int64_t b) { return a + b; });
+    check_against_vector<min_monoid<int64_t>>(
+        [](int64_t a, int64_t b) { return std::min(a, b); });
+    check_against_vector<max_monoid<int64_t>>(
+        [](int64_t a, int64_t b) { return std::max(a, b); });
+}
+
+namespace {
+// a non commutative monoid, the affine maps x -> a * x + b under composition, with
+// updates that set a single element
+struct affine_policy {
+    struct value_type {
+        int64_t a, b;
+        bool operator==(const value_type& o) const { return a == o.a && b == o.b; }
+    };
+    using tag_type = int;
+    static value_type identity() { return {1, 0}; }
+    static value_type combine(const value_type& f, const value_type& g) {
+        return {g.a * f.a % 1000003, (g.a * f.b + g.b) % 1000003};
+    }
+    static tag_type tag_identity() { return 0; }
+    static tag_type compose(tag_type, tag_type) { return 0; }
+    static value_type apply(tag_type, const value_type& x, size_t) { return x; }
+};
+} // namespace
+
+TEST_CASE("Testing lazy segment tree keeps the order of the monoid") {
+    std::vector<affine_policy::value_type> v;
+    for (int64_t i = 0; i < 37; i++) {
+        v.push_back({i % 5 + 1, i});
+    }
+    lazy_segment_tree<affine_policy> t(v);
+    for (size_t l = 0; l < v.size(); l += 3) {
+        for (size_t r = l; r < v.size(); r += 5) {
+            affine_policy::value_type expected = affine_policy::identity();
+            for (size_t j = l; j <= r; j++) {
+                expected = affine_policy::combine(expected, v[j]);
+            }
+            REQUIRE(t.query(l, r) == expected);
+        }
+    }
+}
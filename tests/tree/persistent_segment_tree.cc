@@ -0,0 +1,62 @@
+#include "../../src/classes/tree/persistent_segment_tree.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+TEST_CASE("Testing persistent segment tree versions") {
+    persistent_segment_tree<sum_monoid<int64_t>> t(std::vector<int64_t>{1, 2, 3, 4, 5});
+    REQUIRE(t.versions() == 1);
+    REQUIRE(t.query(0, 0, 4) == 15);
+    size_t v1 = t.update(0, 2, 10);
+    size_t v2 = t.update(v1, 0, 0);
+    // branching off an old version
+    size_t v3 = t.update(0, 4, 100);
+    REQUIRE(t.query(0, 0, 4) == 15);
+    REQUIRE(t.query(v1, 0, 4) == 22);
+    REQUIRE(t.query(v2, 0, 4) == 21);
+    REQUIRE(t.query(v3, 0, 4) == 110);
+    REQUIRE(t.query(v2, 1, 2) == 12);
+    REQUIRE(t.get(v1, 0) == 1);
+    REQUIRE(t.get(v2, 0) == 0);
+    REQUIRE(t.update(3, 7) == 4);
+    REQUIRE(t.get(4, 3) == 7);
+    REQUIRE(t.get(4, 4) == 100);
+    REQUIRE_THROWS_AS(t.query(5, 0, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(t.query(0, 2, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(t.update(0, 5, 1), std::out_of_range);
+}
+
+TEST_CASE("Testing persistent segment tree against every version") {
+    std::mt19937 rng(8);
+    size_t n = 300;
+    std::vector<int64_t> v(n);
+    for (auto& x : v) {
+        x = int64_t(rng() % 1000);
+    }
+    persistent_segment_tree<min_monoid<int64_t>> t(v);
+    std::vector<std::vector<int64_t>> history = {v};
+    t.reserve(2000);
+    size_t before = t.nodes();
+    for (int i = 0; i < 2000; i++) {
+        size_t from = rng() % history.size(), idx = rng() % n;
+        int64_t x = int64_t(rng() % 1000);
+        std::vector<int64_t> next = history[from];
+        next[idx] = x;
+        REQUIRE(t.update(from, idx, x) == history.size());
+        history.push_back(next);
+    }
+    // at most one node per level of the tree for every update
+    REQUIRE(t.nodes() - before <= 2000 * (std::bit_width(n - 1) + 1));
+    for (int i = 0; i < 5000; i++) {
+        size_t version = rng() % history.size(), l = rng() % n, r = rng() % n;
+        if (l > r) {
+            std::swap(l, r);
+        }
+        const auto& h = history[version];
+        REQUIRE(t.query(version, l, r) == *std::min_element(h.begin() + l, h.begin() + r + 1));
+    }
+}
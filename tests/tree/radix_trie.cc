@@ -0,0 +1,109 @@
+#include "../../src/classes/tree/radix_trie.h"
+#include "../../third_party/catch.hpp"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<std::string> random_words(size_t n, uint32_t seed) {
+    std::vector<std::string> words;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t len = (seed >> 8) % 9;
+        std::string w;
+        for (size_t j = 0; j < len; j++) {
+            seed = seed * 1103515245u + 12345u;
+            // a small alphabet gives long shared prefixes, byte 0xff checks unsigned order
+            const char alphabet[] = {'a', 'b', 'c', char(0xff)};
+            w += alphabet[(seed >> 8) % 4];
+        }
+        words.push_back(w);
+    }
+    return words;
+}
+} // namespace
+
+TEST_CASE("testing insert, remove and search in radix trie") {
+    radix_trie t;
+    std::set<std::string> ref;
+    std::vector<std::string> words = random_words(3000, 1);
+    for (size_t i = 0; i < words.size(); i++) {
+        if (i % 4 == 3) {
+            REQUIRE(t.remove(words[i]) == (ref.erase(words[i]) == 1));
+        } else {
+            REQUIRE(t.insert(words[i]) == ref.insert(words[i]).second);
+        }
+    }
+    REQUIRE(t.size() == ref.size());
+    REQUIRE(t.keys_with_prefix("") == std::vector<std::string>(ref.begin(), ref.end()));
+    // path compression: two nodes per key at most, the root included
+    REQUIRE(t.nodes() <= 2 * t.size() + 1);
+    for (const std::string& w : random_words(500, 2)) {
+        REQUIRE(t.search(w) == (ref.count(w) == 1));
+    }
+    for (const std::string& w : ref) {
+        REQUIRE(t.remove(w));
+    }
+    REQUIRE(t.empty());
+    REQUIRE(t.nodes() == 1);
+}
+
+TEST_CASE("testing prefix queries in radix trie") {
+    radix_trie t({"romane", "romanus", "romulus", "rubens", "ruber", "rubicon", "rubicundus"});
+    REQUIRE(t.search("ruber"));
+    REQUIRE(!t.search("rube"));
+    REQUIRE(!t.search("rubers"));
+    REQUIRE(t.starts_with("rube"));
+    REQUIRE(t.starts_with("rom"));
+    REQUIRE(!t.starts_with("rot"));
+    REQUIRE(t.keys_with_prefix("rubic") == std::vector<std::string>{"rubicon", "rubicundus"});
+    REQUIRE(t.keys_with_prefix("ro") == std::vector<std::string>{"romane", "romanus", "romulus"});
+    REQUIRE(t.keys_with_prefix("romanes").empty());
+
+    t.insert("rom");
+    REQUIRE(t.longest_prefix_match("romanesque") == 6);
+    REQUIRE(t.longest_prefix_match("romance") == 3);
+    REQUIRE(!t.longest_prefix_match("rubbish").has_value());
+    std::string_view view = "xx-rubens-xx";
+    REQUIRE(t.search(view.substr(3, 6)));
+
+    radix_trie copy(t);
+    t.clear();
+    REQUIRE(!t.search("rom"));
+    REQUIRE(copy.search("rom"));
+    REQUIRE(copy.size() == 8);
+}
+
+TEST_CASE("testing double array trie") {
+    std::vector<std::string> words = random_words(5000, 3);
+    words.push_back("");
+    std::set<std::string> ref(words.begin(), words.end());
+    std::vector<std::string> sorted(ref.begin(), ref.end());
+    radix_trie r(words);
+    double_array_trie d = r.freeze();
+    REQUIRE(d.size() == ref.size());
+    for (size_t i = 0; i < sorted.size(); i++) {
+        REQUIRE(d.find(sorted[i]) == i);
+    }
+    for (const std::string& w : random_words(1000, 4)) {
+        REQUIRE(d.search(w) == (ref.count(w) == 1));
+        REQUIRE(d.longest_prefix_match(w) == r.longest_prefix_match(w));
+        REQUIRE(d.keys_with_prefix(w) == r.keys_with_prefix(w));
+    }
+    REQUIRE(d.keys_with_prefix("") == sorted);
+
+    double_array_trie small({"she", "sells", "sea", "shells", "by", "the", "sea", "shore"});
+    REQUIRE(small.size() == 7);
+    REQUIRE(small.find("by") == 0);
+    REQUIRE(small.find("the") == 6);
+    REQUIRE(!small.find("shell").has_value());
+    REQUIRE(small.longest_prefix_match("shellfish") == 3);
+    REQUIRE(small.longest_prefix_match("shells and") == 6);
+    REQUIRE(small.keys_with_prefix("sh") ==
+            std::vector<std::string>{"she", "shells", "shore"});
+    std::vector<size_t> ids;
+    small.with_prefix("se", [&](const std::string&, size_t id) { ids.push_back(id); });
+    REQUIRE(ids == std::vector<size_t>{1, 2});
+    REQUIRE(double_array_trie().find("").has_value() == false);
+    REQUIRE(double_array_trie({""}).find("") == 0);
+}
@@ -174,3 +174,76 @@ TEST_CASE("Testing red black tree visualization") {
 }
 
 #endif
+
+TEST_CASE("Testing from_sorted in red black tree") {
+    for (int n : {0, 1, 2, 7, 8, 100, 1023}) {
+        std::vector<int> v;
+        for (int i = 0; i < n; i++) {
+            v.push_back(i);
+        }
+        red_black_tree<int> rb = red_black_tree<int>::from_sorted(v);
+        REQUIRE(rb.size() == size_t(n));
+        REQUIRE(rb.inorder() == v);
+        size_t depth = 0;
+        while ((size_t(1) << depth) <= size_t(n)) {
+            depth++;
+        }
+        REQUIRE(rb.level_order().size() == depth);
+        // the colors are valid, so inserts and removes keep working
+        for (int i = 0; i < n; i += 3) {
+            rb.remove(i);
+            rb.insert(n + i);
+        }
+        std::vector<int> in = rb.inorder();
+        REQUIRE(std::is_sorted(in.begin(), in.end()));
+        REQUIRE(rb.size() == size_t(n));
+    }
+    REQUIRE_THROWS_AS(red_black_tree<int>::from_sorted({3, 1}), std::invalid_argument);
+}
+
+TEST_CASE("testing order statistics in red_black_tree") {
+    red_black_tree<int> t;
+    std::vector<int> ref;
+    uint32_t state = 12345;
+    auto rnd = [&]() {
+        state = state * 1103515245u + 12345u;
+        return int((state >> 8) % 400);
+    };
+    for (int step = 0; step < 3000; step++) {
+        int x = rnd();
+        auto pos = std::lower_bound(ref.begin(), ref.end(), x);
+        if (step % 3 == 2) {
+            if (pos != ref.end() && *pos == x) {
+                ref.erase(pos);
+            }
+            t.remove(x);
+        } else if (true) {
+            ref.insert(pos, x);
+            t.insert(x);
+        }
+        if (step % 100 == 0) {
+            REQUIRE(t.size() == ref.size());
+            for (size_t k = 0; k < ref.size(); k++) {
+                REQUIRE(t.select(k) == ref[k]);
+            }
+        }
+        int lo = rnd(), hi = lo + rnd() / 4;
+        size_t below = std::lower_bound(ref.begin(), ref.end(), lo) - ref.begin();
+        size_t upto = std::upper_bound(ref.begin(), ref.end(), hi) - ref.begin();
+        REQUIRE(t.rank(lo) == below);
+        REQUIRE(t.range_count(lo, hi) == upto - below);
+        std::vector<int> visited;
+        t.range(lo, hi, [&](const int& v) { visited.push_back(v); });
+        REQUIRE(visited == std::vector<int>(ref.begin() + below, ref.begin() + upto));
+        auto lb = t.lower_bound(lo);
+        REQUIRE((lb == t.end()) == (below == ref.size()));
+        if (lb != t.end()) {
+            REQUIRE(*lb == ref[below]);
+        }
+        size_t above = std::upper_bound(ref.begin(), ref.end(), lo) - ref.begin();
+        auto ub = t.upper_bound(lo);
+        REQUIRE(static_cast<size_t>(std::distance(t.begin(), ub)) == above);
+    }
+    REQUIRE(t.range_count(10, 5) == 0);
+    REQUIRE_THROWS_AS(t.select(t.size()), std::out_of_range);
+}
@@ -1,20 +1,184 @@
 #define ENABLE_TREE_VISUALIZATION
 #include "../../src/classes/tree/rope.h"
 #include "../../third_party/catch.hpp"
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
 
 TEST_CASE("Testing rope constructor [1]") {
     rope r("hello world");
-    REQUIRE(r.height() == 1);
+    REQUIRE(r.height() == 0);
+    REQUIRE(r.size() == 11);
     REQUIRE(r.inorder() == "hello world");
+
+    rope e;
+    REQUIRE(e.empty());
+    REQUIRE(e.height() == -1);
+    REQUIRE(e.inorder() == "");
 }
 
 TEST_CASE("Testing rope constructor [2]") {
-    rope r("import numpy as np", 2);
-    REQUIRE(r.height() == 1);
-    REQUIRE(r.inorder() == "import numpy as np");
-
-    rope rr("import numpy as np", 3);
-    REQUIRE(r.height() <= 2);
-    REQUIRE(r.inorder() == "import numpy as np");
-    // CHECK_NOTHROW(rr.visualize());
+    std::string s;
+    for (int i = 0; i < 10000; i++) {
+        s.push_back(char('a' + i % 26));
+    }
+    rope r(s);
+    REQUIRE(r.inorder() == s);
+    // 20 chunks of about 500 bytes in a perfectly balanced tree
+    REQUIRE(r.height() == 5);
+    for (size_t i = 0; i < s.size(); i += 97) {
+        REQUIRE(r.char_at(i) == s[i]);
+    }
+    REQUIRE_THROWS_AS(r.char_at(s.size()), std::out_of_range);
+}
+
+TEST_CASE("Testing rope insert and erase") {
+    rope r("hello world");
+    r.insert(5, ",");
+    r.insert(r.size(), "!");
+    r.insert(0, ">> ");
+    REQUIRE(r.inorder() == ">> hello, world!");
+    r.erase(0, 3);
+    r.erase(5, 1);
+    REQUIRE(r.inorder() == "hello world!");
+    r.erase(5);
+    REQUIRE(r.inorder() == "hello");
+    REQUIRE_THROWS_AS(r.insert(6, "x"), std::out_of_range);
+    REQUIRE_THROWS_AS(r.erase(6, 1), std::out_of_range);
+    r.erase(0);
+    REQUIRE(r.empty());
+}
+
+TEST_CASE("Testing rope split, concat and substr") {
+    std::string s(5000, 'x');
+    for (size_t i = 0; i < s.size(); i++) {
+        s[i] = char('a' + i * 7 % 26);
+    }
+    rope r(s);
+    rope tail = r.split(1234);
+    REQUIRE(r.inorder() == s.substr(0, 1234));
+    REQUIRE(tail.inorder() == s.substr(1234));
+    REQUIRE(tail.substr(100, 900) == s.substr(1334, 900));
+    REQUIRE(tail.substr(3700) == s.substr(4934));
+    tail.concat(std::move(r));
+    REQUIRE(tail.inorder() == s.substr(1234) + s.substr(0, 1234));
+    rope copy(tail);
+    copy.erase(0, 10);
+    REQUIRE(tail.size() == 5000);
+    REQUIRE(copy.size() == 4990);
+    std::ostringstream out;
+    out << copy;
+    REQUIRE(out.str() == tail.inorder().substr(10));
+}
+
+TEST_CASE("Testing rope against std::string") {
+    std::mt19937 rng(3);
+    std::string s;
+    rope r;
+    auto text = [&](size_t n) {
+        std::string t;
+        for (size_t i = 0; i < n; i++) {
+            t.push_back(char('a' + rng() % 26));
+        }
+        return t;
+    };
+    for (int i = 0; i < 3000; i++) {
+        size_t op = rng() % 5, pos = rng() % (s.size() + 1);
+        if (op <= 1) {
+            // mostly short edits that land in one leaf, sometimes long ones
+            std::string t = text(rng() % 8 == 0 ? rng() % 3000 : rng() % 20);
+            r.insert(pos, t);
+            s.insert(pos, t);
+        } else if (op == 2) {
+            size_t len = rng() % 8 == 0 ? rng() % 3000 : rng() % 20;
+            r.erase(pos, len);
+            s.erase(pos, len);
+        } else if (op == 3) {
+            rope tail = r.split(pos);
+            r.concat(std::move(tail));
+        } else if (!s.empty()) {
+            size_t at = rng() % s.size();
+            REQUIRE(r.char_at(at) == s[at]);
+            REQUIRE(r.substr(pos, 50) == s.substr(pos, 50));
+        }
+        REQUIRE(r.size() == s.size());
+        // AVL height bound over leaves of at least one byte
+        REQUIRE(double(r.height()) <= 1.45 * std::log2(double(s.size()) + 2) + 2);
+    }
+    REQUIRE(r.inorder() == s);
+}
+
+TEST_CASE("Testing rope chunks and substr_view") {
+    std::string s(3000, 'x');
+    for (size_t i = 0; i < s.size(); i++) {
+        s[i] = char('a' + i * 11 % 26);
+    }
+    rope r(s);
+    std::string joined;
+    size_t chunks = 0;
+    for (std::string_view c : r.chunks()) {
+        REQUIRE(c.size() <= rope::CHUNK);
+        joined.append(c);
+        chunks++;
+    }
+    REQUIRE(joined == s);
+    REQUIRE(chunks == 6);
+
+    rope::view v = r.substr_view(700, 1500);
+    REQUIRE(v.size() == 1500);
+    REQUIRE(v.str() == s.substr(700, 1500));
+    REQUIRE(r.substr_view(2990).str() == s.substr(2990));
+    REQUIRE(r.substr_view(3000).empty());
+    REQUIRE(r.substr_view(3000).begin() == r.substr_view(3000).end());
+    REQUIRE_THROWS_AS(r.substr_view(3001), std::out_of_range);
+
+    // the view keeps the text it was made from
+    r.erase(0, 2000);
+    r.insert(0, "changed");
+    REQUIRE(v.str() == s.substr(700, 1500));
+    std::ostringstream out;
+    out << v;
+    REQUIRE(out.str() == s.substr(700, 1500));
+}
+
+TEST_CASE("Testing rope copies share their chunks") {
+    std::string s(5000, 'x');
+    for (size_t i = 0; i < s.size(); i++) {
+        s[i] = char('a' + i * 5 % 26);
+    }
+    rope r(s);
+    std::vector<rope> versions;
+    std::vector<std::string> texts;
+    for (int i = 0; i < 100; i++) {
+        versions.push_back(r);
+        texts.push_back(r.inorder());
+        r.insert(size_t(i * 37) % r.size(), "edit");
+        if (i % 3 == 0) {
+            r.erase(size_t(i * 53) % r.size(), 3);
+        }
+    }
+    for (size_t i = 0; i < versions.size(); i++) {
+        REQUIRE(versions[i].inorder() == texts[i]);
+    }
+
+    // the last chunk was never edited, every version points at the same bytes
+    auto last = [](const rope& x) {
+        const char* p = nullptr;
+        for (std::string_view c : x.chunks()) {
+            p = c.data();
+        }
+        return p;
+    };
+    rope a(s), b(a);
+    b.insert(0, "x");
+    REQUIRE(last(a) == last(b));
+    REQUIRE(a.inorder() == s);
+    REQUIRE(b.inorder() == "x" + s);
+    b.erase(4000, 10);
+    REQUIRE(a.inorder() == s);
+    rope tail = b.split(2500);
+    REQUIRE(a.inorder() == s);
+    REQUIRE(tail.inorder() == ("x" + s).substr(2500, 1500) + ("x" + s).substr(4010));
 }
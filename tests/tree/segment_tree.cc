@@ -1,6 +1,10 @@
 #include "../../src/classes/tree/segment_tree.h"
 #include "../../third_party/catch.hpp"
 #include "../../src/classes/tree/segment_tree_iterative.h"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
 
 TEST_CASE("Testing default constructor of the segment tree") {
     std::vector<int> v = {1, 5, 2, 4};
@@ -53,3 +57,43 @@ TEST_CASE("Testing segment tree queries [2]") {
     REQUIRE(t.sum(0, 4) == (4 * 5) / 2);
     REQUIRE(tt.sum(0, 4) == (4 * 5) / 2);
 }
+
+TEST_CASE("Testing batch updates and queries of the iterative segment tree") {
+    std::mt19937 rng(5);
+    for (int n : {1, 2, 3, 7, 100, 1000}) {
+        std::vector<long long> v(n);
+        for (auto& x : v) {
+            x = rng() % 100;
+        }
+        seg_tree<long long> batched(v), single(v);
+        for (int round = 0; round < 20; round++) {
+            std::vector<std::pair<int, long long>> updates;
+            for (int i = 0; i < 50; i++) {
+                updates.push_back({int(rng() % n), (long long)(rng() % 100)});
+            }
+            if (round % 2) {
+                batched.update_batch(updates);
+                for (auto& [idx, x] : updates) {
+                    single.update(idx, x);
+                }
+            } else {
+                batched.add_batch(updates);
+                for (auto& [idx, x] : updates) {
+                    single.update(idx, single.sum(idx, idx) + x);
+                }
+            }
+            std::vector<std::pair<int, int>> queries;
+            for (int i = 0; i < 50; i++) {
+                int a = rng() % n, b = rng() % n;
+                queries.push_back({std::min(a, b), std::max(a, b)});
+            }
+            std::vector<long long> sums = batched.sum_batch(queries, round % 3 + 1);
+            for (size_t q = 0; q < queries.size(); q++) {
+                REQUIRE(sums[q] == single.sum(queries[q].first, queries[q].second));
+            }
+            for (int i = 1; i < n; i++) {
+                REQUIRE(batched.tree[i] == single.tree[i]);
+            }
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #define ENABLE_TREE_VISUALIZATION
 #include "../../src/classes/tree/splay_tree.h"
 #include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <set>
 #include <string>
 
 TEST_CASE("testing insertion in splay tree") {
@@ -157,3 +159,49 @@ TEST_CASE("Testing splay tree visualization") {
 }
 
 #endif
+
+TEST_CASE("testing top-down splay on a deep splay tree") {
+    // increasing inserts leave a path of n nodes, a recursive splay would overflow the stack
+    splay_tree<int> s;
+    const int n = 200000;
+    for (int i = 0; i < n; i++) {
+        s.insert(i);
+    }
+    REQUIRE(s.search(0));
+    REQUIRE(s.preorder()[0] == 0);
+    REQUIRE(s.search(n / 2));
+    REQUIRE(!s.search(n));
+    REQUIRE(s.size() == n);
+    REQUIRE(s.splay_to_root(777));
+    REQUIRE(s.preorder()[0] == 777);
+    REQUIRE(!s.splay_to_root(-5));
+    REQUIRE(s.preorder()[0] == 0);
+    std::vector<int> in = s.inorder();
+    REQUIRE(in.size() == n);
+    REQUIRE(std::is_sorted(in.begin(), in.end()));
+}
+
+TEST_CASE("testing batch operations in splay tree") {
+    splay_tree<int> s;
+    std::set<int> ref;
+    uint32_t state = 3;
+    std::vector<int> batch;
+    for (int i = 0; i < 3000; i++) {
+        state = state * 1103515245u + 12345u;
+        batch.push_back(int((state >> 8) % 5000));
+        ref.insert(batch.back());
+    }
+    s.insert_batch(batch);
+    REQUIRE(s.size() == ref.size());
+    REQUIRE(s.inorder() == std::vector<int>(ref.begin(), ref.end()));
+
+    std::vector<int> keys = {4999, -1, batch[0], 2500, batch[17], 6000};
+    std::vector<bool> found = s.search_batch(keys);
+    for (size_t i = 0; i < keys.size(); i++) {
+        REQUIRE(found[i] == (ref.count(keys[i]) == 1));
+    }
+    for (int x : batch) {
+        s.remove(x);
+    }
+    REQUIRE(s.size() == 0);
+}
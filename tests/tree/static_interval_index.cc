@@ -0,0 +1,64 @@
+#include "../../src/classes/tree/static_interval_index.h"
+#include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+std::vector<size_t> brute(const std::vector<std::pair<int, int>>& v, int lo, int hi) {
+    std::vector<size_t> ids;
+    for (size_t i = 0; i < v.size(); i++) {
+        if (std::max(v[i].first, v[i].second) >= lo && std::min(v[i].first, v[i].second) <= hi) {
+            ids.push_back(i);
+        }
+    }
+    return ids;
+}
+} // namespace
+
+TEST_CASE("testing queries in static interval index") {
+    uint32_t state = 5;
+    auto rnd = [&](int m) {
+        state = state * 1103515245u + 12345u;
+        return int((state >> 8) % m);
+    };
+    for (size_t n : {0, 1, 2, 3, 15, 16, 17, 100, 1000, 4097}) {
+        std::vector<std::pair<int, int>> v;
+        for (size_t i = 0; i < n; i++) {
+            int lo = rnd(5000);
+            // a few long intervals, so the max of a subtree matters
+            int len = i % 50 == 0 ? rnd(3000) : rnd(40);
+            v.push_back(i % 2 ? std::make_pair(lo, lo + len) : std::make_pair(lo + len, lo));
+        }
+        static_interval_index<int> index(v);
+        REQUIRE(index.size() == n);
+        std::vector<std::pair<int, int>> queries;
+        for (int q = 0; q < 100; q++) {
+            int lo = rnd(5500) - 200, hi = lo + rnd(60);
+            queries.push_back({lo, hi});
+            std::vector<size_t> got;
+            index.overlapping(lo, hi, [&](const std::pair<int, int>& i, size_t id) {
+                REQUIRE(i.first == std::min(v[id].first, v[id].second));
+                got.push_back(id);
+            });
+            std::sort(got.begin(), got.end());
+            REQUIRE(got == brute(v, lo, hi));
+            REQUIRE(index.count_overlapping(lo, hi) == got.size());
+            REQUIRE(index.query_overlapping({hi, lo}).size() == got.size());
+            REQUIRE(index.query_overlapping(lo).size() == brute(v, lo, lo).size());
+        }
+        std::vector<std::vector<size_t>> batch = index.query_batch(queries);
+        for (size_t q = 0; q < queries.size(); q++) {
+            std::sort(batch[q].begin(), batch[q].end());
+            REQUIRE(batch[q] == brute(v, queries[q].first, queries[q].second));
+        }
+    }
+}
+
+TEST_CASE("testing the order of hits in static interval index") {
+    static_interval_index<double> index({{5, 9}, {1, 2}, {4, 6}, {0, 10}, {7, 7}});
+    std::vector<std::pair<double, double>> hits = index.query_overlapping({5.5, 7});
+    std::vector<std::pair<double, double>> expected = {{0, 10}, {4, 6}, {5, 9}, {7, 7}};
+    REQUIRE(hits == expected);
+    REQUIRE(index.count_overlapping(3, 2) == 0);
+    REQUIRE(static_interval_index<int>().query_overlapping(3).empty());
+}
@@ -1,6 +1,10 @@
 #include "../../src/classes/tree/trie.h"
 #include "../../third_party/catch.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
 #include <string>
+#include <vector>
 
 TEST_CASE("testing insertion in trie") {
     trie t;
@@ -38,4 +42,90 @@ TEST_CASE("testing operator = for trie class") {
     for (auto& x : v) {
         REQUIRE(t2.search(x) == true);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("testing copies of trie are deep") {
+    trie t({"abc", "abd"});
+    trie t2(t);
+    t2.remove("abc");
+    t2.insert("xyz");
+    REQUIRE(t.search("abc") == true);
+    REQUIRE(t.search("xyz") == false);
+    REQUIRE(t2.search("abc") == false);
+    REQUIRE(t2.search("abd") == true);
+    REQUIRE(t.size() == 2);
+    REQUIRE(t2.size() == 2);
+}
+
+TEST_CASE("testing remove of every word in trie") {
+    trie t({"a", "ab", "abc"});
+    t.remove("ab");
+    REQUIRE(t.search("abc") == true);
+    REQUIRE(t.search("a") == true);
+    t.remove("a");
+    t.remove("abc");
+    REQUIRE(t.empty());
+    t.insert("b");
+    REQUIRE(t.search("b") == true);
+    REQUIRE(t.search("a") == false);
+    REQUIRE_THROWS_AS(t.insert("Hello"), std::invalid_argument);
+}
+
+TEST_CASE("testing complete for trie class") {
+    trie t;
+    t.insert("car", 5);
+    t.insert("care", 9);
+    t.insert("cart", 2);
+    t.insert("cat", 7);
+    t.insert("dog", 10);
+    using words = std::vector<std::pair<std::string, double>>;
+    REQUIRE(t.complete("ca", 3) == words{{"care", 9}, {"cat", 7}, {"car", 5}});
+    REQUIRE(t.complete("car", 10) == words{{"care", 9}, {"car", 5}, {"cart", 2}});
+    REQUIRE(t.complete("", 1) == words{{"dog", 10}});
+    REQUIRE(t.complete("cab", 3).empty());
+    REQUIRE(t.complete("ca", 0).empty());
+
+    // a new weight replaces the old one and the cached maxima follow
+    t.insert("care", 1);
+    t.remove("cat");
+    REQUIRE(t.complete("ca", 2) == words{{"car", 5}, {"cart", 2}});
+    t.remove("car");
+    t.remove("cart");
+    t.remove("care");
+    REQUIRE(t.complete("c", 5).empty());
+    REQUIRE(t.complete("", 5) == words{{"dog", 10}});
+}
+
+TEST_CASE("testing complete against sorting every match") {
+    std::mt19937 rng(7);
+    trie t;
+    std::map<std::string, double> words;
+    for (int i = 0; i < 3000; i++) {
+        std::string w;
+        for (size_t len = 1 + rng() % 6; len; len--) {
+            w.push_back(char('a' + rng() % 4));
+        }
+        if (rng() % 5 == 0) {
+            t.remove(w);
+            words.erase(w);
+        } else {
+            // distinct weights keep the order of the answers unique
+            double weight = double(i);
+            t.insert(w, weight);
+            words[w] = weight;
+        }
+    }
+    for (std::string prefix : {"", "a", "ab", "dcb", "bbbb"}) {
+        std::vector<std::pair<std::string, double>> expected;
+        for (auto& [w, weight] : words) {
+            if (w.compare(0, prefix.size(), prefix) == 0) {
+                expected.push_back({w, weight});
+            }
+        }
+        std::sort(expected.begin(), expected.end(),
+                  [](auto& a, auto& b) { return a.second > b.second; });
+        expected.resize(std::min<size_t>(expected.size(), 20));
+        REQUIRE(t.complete(prefix, 20) == expected);
+    }
+    REQUIRE(t.size() == words.size());
+}